@@ -38,6 +38,13 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct LRUCacheOptions, low_pri_pool_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"numa_aware",
+         {offsetof(struct LRUCacheOptions, numa_aware), OptionType::kBoolean,
+          OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+        {"shared_lookups",
+         {offsetof(struct LRUCacheOptions, shared_lookups),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -64,6 +71,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    enable_custom_split_merge),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"min_compression_ratio",
+         {offsetof(struct CompressedSecondaryCacheOptions,
+                   min_compression_ratio),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 namespace {
@@ -174,6 +186,12 @@ void Cache::StartAsyncLookup(AsyncLookupHandle& async_handle) {
              async_handle.priority, async_handle.stats);
 }
 
+void Cache::MultiLookup(AsyncLookupHandle* async_handles, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    StartAsyncLookup(async_handles[i]);
+  }
+}
+
 Cache::Handle* Cache::Wait(AsyncLookupHandle& async_handle) {
   WaitAll(&async_handle, 1);
   return async_handle.Result();
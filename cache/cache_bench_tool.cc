@@ -5,6 +5,7 @@
 
 #ifdef GFLAGS
 #include <cinttypes>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <limits>
@@ -22,6 +23,8 @@
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/perf_level.h"
 #include "rocksdb/secondary_cache.h"
 #include "rocksdb/system_clock.h"
 #include "rocksdb/table_properties.h"
@@ -64,7 +67,19 @@ DEFINE_uint32(value_bytes_estimate, 0,
 DEFINE_int32(
     degenerate_hash_bits, 0,
     "With HCC, fix this many hash bits to increase table hash collisions");
+DEFINE_string(key_distribution, "skew",
+              "How the keys are picked: skew (see --skew), zipf (see "
+              "--zipf_theta) or hotspot (see --hotspot_key_fraction).");
 DEFINE_uint32(skew, 5, "Degree of skew in key selection. 0 = no skew");
+DEFINE_double(zipf_theta, 0.99,
+              "With --key_distribution=zipf, the exponent of the Zipfian "
+              "distribution of the keys, in (0, 1).");
+DEFINE_double(hotspot_key_fraction, 0.01,
+              "With --key_distribution=hotspot, the fraction of the keys that "
+              "are hot.");
+DEFINE_double(hotspot_access_fraction, 0.9,
+              "With --key_distribution=hotspot, the fraction of the operations "
+              "on the hot keys.");
 DEFINE_bool(populate_cache, true, "Populate cache before operations");
 
 DEFINE_double(pinned_ratio, 0.25,
@@ -87,6 +102,13 @@ DEFINE_uint32(lookup_percent, 10,
               "Ratio of lookup to total workload (expressed as a percentage)");
 DEFINE_uint32(erase_percent, 1,
               "Ratio of erase to total workload (expressed as a percentage)");
+DEFINE_uint32(lookup_batch_size, 1,
+              "Number of keys looked up together by each lookup, with "
+              "MultiLookup() and WaitAll() like MultiGet when greater than 1.");
+DEFINE_bool(tier_stats, false,
+            "Whether to report the hit ratio of the primary and secondary "
+            "cache and the CPU time per key of the lookups served by each, "
+            "which adds reading the thread CPU time to each lookup.");
 DEFINE_bool(gather_stats, false,
             "Whether to periodically simulate gathering block cache stats, "
             "using one more thread.");
@@ -240,28 +262,160 @@ class SharedState {
   size_t pinned_count_ = 0;
 };
 
+// The lookups of a thread by the cache tier that served them, with
+// --tier_stats.
+struct TierStats {
+  enum Tier { kPrimary, kSecondary, kMiss, kNumTiers };
+
+  // The keys served by each tier.
+  uint64_t keys[kNumTiers] = {};
+  // The keys of the lookups, and their thread CPU time, by the slowest tier
+  // that served one of their keys.
+  uint64_t lookup_keys[kNumTiers] = {};
+  uint64_t lookup_cpu_nanos[kNumTiers] = {};
+
+  void Add(size_t num_keys, size_t num_hits, uint64_t secondary_hits,
+           uint64_t cpu_nanos) {
+    secondary_hits = std::min(secondary_hits, uint64_t{num_hits});
+    keys[kPrimary] += num_hits - secondary_hits;
+    keys[kSecondary] += secondary_hits;
+    keys[kMiss] += num_keys - num_hits;
+    Tier tier = kPrimary;
+    if (num_hits < num_keys) {
+      tier = kMiss;
+    } else if (secondary_hits > 0) {
+      tier = kSecondary;
+    }
+    lookup_keys[tier] += num_keys;
+    lookup_cpu_nanos[tier] += cpu_nanos;
+  }
+
+  void Merge(const TierStats& other) {
+    for (int i = 0; i < kNumTiers; i++) {
+      keys[i] += other.keys[i];
+      lookup_keys[i] += other.lookup_keys[i];
+      lookup_cpu_nanos[i] += other.lookup_cpu_nanos[i];
+    }
+  }
+};
+
 // Per-thread state for concurrent executions of the same benchmark.
 struct ThreadState {
   uint32_t tid;
   Random64 rnd;
   SharedState* shared;
   HistogramImpl latency_ns_hist;
+  TierStats tier_stats;
   uint64_t duration_us = 0;
+  // For lookups of more than one key
+  std::vector<std::string> batch_keys;
+  std::unique_ptr<Cache::AsyncLookupHandle[]> async_handles;
+  std::vector<Cache::Handle*> batch_handles;
 
   ThreadState(uint32_t index, SharedState* _shared)
       : tid(index), rnd(FLAGS_seed + 1 + index), shared(_shared) {}
 };
 
+// Picks the keys in [0, max_key) following --key_distribution.
+class KeyDistribution {
+ public:
+  explicit KeyDistribution(uint64_t max_key) : max_key_(max_key) {
+    if (FLAGS_key_distribution == "skew") {
+      type_ = kSkew;
+    } else if (FLAGS_key_distribution == "zipf") {
+      if (!(FLAGS_zipf_theta > 0.0 && FLAGS_zipf_theta < 1.0)) {
+        fprintf(stderr, "zipf_theta must be in (0, 1).\n");
+        exit(1);
+      }
+      // As in "Quickly Generating Billion-Record Synthetic Databases", Gray
+      // et al., SIGMOD 1994.
+      type_ = kZipf;
+      theta_ = FLAGS_zipf_theta;
+      for (uint64_t i = 1; i <= max_key_; i++) {
+        zetan_ += 1.0 / std::pow(static_cast<double>(i), theta_);
+      }
+      alpha_ = 1.0 / (1.0 - theta_);
+      const double zeta2 = 1.0 + std::pow(0.5, theta_);
+      eta_ = (1.0 - std::pow(2.0 / max_key_, 1.0 - theta_)) /
+             (1.0 - zeta2 / zetan_);
+    } else if (FLAGS_key_distribution == "hotspot") {
+      if (!(FLAGS_hotspot_key_fraction > 0.0 &&
+            FLAGS_hotspot_key_fraction <= 1.0) ||
+          !(FLAGS_hotspot_access_fraction >= 0.0 &&
+            FLAGS_hotspot_access_fraction <= 1.0)) {
+        fprintf(stderr,
+                "hotspot_key_fraction must be in (0, 1] and "
+                "hotspot_access_fraction in [0, 1].\n");
+        exit(1);
+      }
+      type_ = kHotspot;
+      hot_keys_ = std::max(
+          uint64_t{1},
+          static_cast<uint64_t>(max_key_ * FLAGS_hotspot_key_fraction));
+      hot_keys_ = std::min(hot_keys_, max_key_);
+    } else {
+      fprintf(stderr, "Key distribution not supported.\n");
+      exit(1);
+    }
+  }
+
+  uint64_t Next(Random64& rnd) const {
+    switch (type_) {
+      case kSkew: {
+        uint64_t raw = rnd.Next();
+        // Skew according to setting
+        for (uint32_t i = 0; i < FLAGS_skew; ++i) {
+          raw = std::min(raw, rnd.Next());
+        }
+        return FastRange64(raw, max_key_);
+      }
+      case kZipf: {
+        const double u = NextDouble(rnd);
+        const double uz = u * zetan_;
+        if (uz < 1.0) {
+          return 0;
+        }
+        if (uz < 1.0 + std::pow(0.5, theta_)) {
+          return std::min(uint64_t{1}, max_key_ - 1);
+        }
+        const uint64_t key = static_cast<uint64_t>(
+            max_key_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return std::min(key, max_key_ - 1);
+      }
+      case kHotspot:
+        if (hot_keys_ == max_key_ ||
+            NextDouble(rnd) < FLAGS_hotspot_access_fraction) {
+          return FastRange64(rnd.Next(), hot_keys_);
+        }
+        return hot_keys_ + FastRange64(rnd.Next(), max_key_ - hot_keys_);
+    }
+    return 0;
+  }
+
+ private:
+  enum Type { kSkew, kZipf, kHotspot };
+
+  // In [0, 1)
+  static double NextDouble(Random64& rnd) {
+    return static_cast<double>(rnd.Next() >> 11) * (1.0 / (uint64_t{1} << 53));
+  }
+
+  const uint64_t max_key_;
+  Type type_ = kSkew;
+  // For kZipf
+  double theta_ = 0.0;
+  double zetan_ = 0.0;
+  double alpha_ = 0.0;
+  double eta_ = 0.0;
+  // For kHotspot, the keys in [0, hot_keys_) are hot
+  uint64_t hot_keys_ = 0;
+};
+
 struct KeyGen {
   char key_data[27];
 
-  Slice GetRand(Random64& rnd, uint64_t max_key, uint32_t skew) {
-    uint64_t raw = rnd.Next();
-    // Skew according to setting
-    for (uint32_t i = 0; i < skew; ++i) {
-      raw = std::min(raw, rnd.Next());
-    }
-    uint64_t key = FastRange64(raw, max_key);
+  Slice GetRand(Random64& rnd, const KeyDistribution& key_dist) {
+    uint64_t key = key_dist.Next(rnd);
     if (FLAGS_degenerate_hash_bits) {
       uint64_t key_hash =
           Hash64(reinterpret_cast<const char*>(&key), sizeof(key));
@@ -362,6 +516,7 @@ class CacheBench {
   CacheBench()
       : max_key_(static_cast<uint64_t>(FLAGS_cache_size / FLAGS_resident_ratio /
                                        FLAGS_value_bytes)),
+        key_dist_(max_key_),
         lookup_insert_threshold_(kHundredthUint64 *
                                  FLAGS_lookup_insert_percent),
         insert_threshold_(lookup_insert_threshold_ +
@@ -438,7 +593,7 @@ class CacheBench {
     // it becomes difficult to find keys not already inserted.
     while (inserts_since_max_occ_increase < 100 &&
            keys_since_last_not_found < 100) {
-      Slice key = keygen.GetRand(rnd, max_key_, FLAGS_skew);
+      Slice key = keygen.GetRand(rnd, key_dist_);
 
       Cache::Handle* handle = cache_->Lookup(key);
       if (handle != nullptr) {
@@ -538,6 +693,25 @@ class CacheBench {
 
     printf("Final pinned count: %zu\n", shared.GetPinnedCount());
 
+    if (FLAGS_tier_stats) {
+      TierStats tier_stats;
+      for (uint32_t i = 0; i < FLAGS_threads; i++) {
+        tier_stats.Merge(threads[i]->tier_stats);
+      }
+      const uint64_t total_keys = tier_stats.keys[TierStats::kPrimary] +
+                                  tier_stats.keys[TierStats::kSecondary] +
+                                  tier_stats.keys[TierStats::kMiss];
+      const char* tier_names[TierStats::kNumTiers] = {
+          "Primary cache", "Secondary cache", "Miss"};
+      printf("\nTier: ratio of keys, CPU ns/key of the lookups it served\n");
+      for (int i = 0; i < TierStats::kNumTiers; i++) {
+        printf("%-16s: %g, %.1f\n", tier_names[i],
+               1.0 * tier_stats.keys[i] / total_keys,
+               1.0 * tier_stats.lookup_cpu_nanos[i] /
+                   std::max(tier_stats.lookup_keys[i], uint64_t{1}));
+      }
+    }
+
     if (FLAGS_histograms) {
       printf("\nOperation latency (ns):\n");
       HistogramImpl combined;
@@ -566,6 +740,7 @@ class CacheBench {
  private:
   std::shared_ptr<Cache> cache_;
   const uint64_t max_key_;
+  const KeyDistribution key_dist_;
   // Cumulative thresholds in the space of a random uint64_t
   const uint64_t lookup_insert_threshold_;
   const uint64_t insert_threshold_;
@@ -693,13 +868,23 @@ class CacheBench {
 
     KeyGen gen;
     const auto clock = SystemClock::Default().get();
+    if (FLAGS_lookup_batch_size > 1) {
+      thread->batch_keys.resize(FLAGS_lookup_batch_size);
+      thread->async_handles.reset(
+          new Cache::AsyncLookupHandle[FLAGS_lookup_batch_size]);
+      thread->batch_handles.resize(FLAGS_lookup_batch_size);
+    }
+    if (FLAGS_tier_stats) {
+      // For PerfContext::secondary_cache_hit_count
+      SetPerfLevel(PerfLevel::kEnableCount);
+    }
     uint64_t start_time = clock->NowMicros();
     StopWatchNano timer(clock);
     auto system_clock = SystemClock::Default();
     size_t steps_to_next_capacity_change = 0;
 
     for (uint64_t i = 0; i < FLAGS_ops_per_thread; i++) {
-      Slice key = gen.GetRand(thread->rnd, max_key_, FLAGS_skew);
+      Slice key = gen.GetRand(thread->rnd, key_dist_);
       uint64_t random_op = thread->rnd.Next();
 
       if (FLAGS_vary_capacity_ratio > 0.0 && thread->tid == 0) {
@@ -720,25 +905,9 @@ class CacheBench {
       }
 
       if (random_op < lookup_insert_threshold_) {
-        // do lookup
-        auto handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
-                                     Cache::Priority::LOW);
-        if (handle) {
-          ++lookup_hits;
-          if (!FLAGS_lean) {
-            // do something with the data
-            result += NPHash64(static_cast<char*>(cache_->Value(handle)),
-                               FLAGS_value_bytes);
-          }
-          pinned.push_back(handle);
-        } else {
-          ++lookup_misses;
-          // do insert
-          Status s = cache_->Insert(
-              key, createValue(thread->rnd, cache_->memory_allocator()),
-              &helper2, FLAGS_value_bytes, &pinned.emplace_back());
-          assert(s.ok());
-        }
+        // do lookup, and insert on not found
+        LookupKeys(thread, gen, key, /*insert_misses=*/true, &pinned, &result,
+                   &lookup_hits, &lookup_misses);
       } else if (random_op < insert_threshold_) {
         // do insert
         Status s = cache_->Insert(
@@ -753,19 +922,8 @@ class CacheBench {
         assert(s.ok());
       } else if (random_op < lookup_threshold_) {
         // do lookup
-        auto handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
-                                     Cache::Priority::LOW);
-        if (handle) {
-          ++lookup_hits;
-          if (!FLAGS_lean) {
-            // do something with the data
-            result += NPHash64(static_cast<char*>(cache_->Value(handle)),
-                               FLAGS_value_bytes);
-          }
-          pinned.push_back(handle);
-        } else {
-          ++lookup_misses;
-        }
+        LookupKeys(thread, gen, key, /*insert_misses=*/false, &pinned,
+                   &result, &lookup_hits, &lookup_misses);
       } else if (random_op < erase_threshold_) {
         // do erase
         cache_->Erase(key);
@@ -805,6 +963,82 @@ class CacheBench {
     thread->duration_us = clock->NowMicros() - start_time;
   }
 
+  // Looks up `key`, and the next --lookup_batch_size - 1 keys of `gen` along
+  // with it, pins the hits and inserts the misses if `insert_misses`.
+  void LookupKeys(ThreadState* thread, KeyGen& gen, const Slice& key,
+                  bool insert_misses, std::deque<Cache::Handle*>* pinned,
+                  uint64_t* result, uint64_t* lookup_hits,
+                  uint64_t* lookup_misses) {
+    const size_t num_keys = std::max(FLAGS_lookup_batch_size, uint32_t{1});
+    Cache::Handle* single_handle = nullptr;
+    Cache::Handle** handles = &single_handle;
+    Cache::AsyncLookupHandle* async_handles = thread->async_handles.get();
+    if (num_keys > 1) {
+      thread->batch_keys[0].assign(key.data(), key.size());
+      for (size_t i = 1; i < num_keys; i++) {
+        Slice batch_key = gen.GetRand(thread->rnd, key_dist_);
+        thread->batch_keys[i].assign(batch_key.data(), batch_key.size());
+      }
+      for (size_t i = 0; i < num_keys; i++) {
+        async_handles[i].key = thread->batch_keys[i];
+        async_handles[i].helper = &helper2;
+      }
+      handles = thread->batch_handles.data();
+    }
+
+    SystemClock* clock = SystemClock::Default().get();
+    uint64_t start_cpu_nanos = 0;
+    uint64_t start_secondary_hits = 0;
+    if (FLAGS_tier_stats) {
+      start_secondary_hits = get_perf_context()->secondary_cache_hit_count;
+      start_cpu_nanos = clock->CPUNanos();
+    }
+    if (num_keys == 1) {
+      single_handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
+                                     Cache::Priority::LOW);
+    } else {
+      cache_->MultiLookup(async_handles, num_keys);
+      cache_->WaitAll(async_handles, num_keys);
+      for (size_t i = 0; i < num_keys; i++) {
+        handles[i] = async_handles[i].Result();
+      }
+    }
+    uint64_t cpu_nanos = 0;
+    uint64_t secondary_hits = 0;
+    if (FLAGS_tier_stats) {
+      cpu_nanos = clock->CPUNanos() - start_cpu_nanos;
+      secondary_hits =
+          get_perf_context()->secondary_cache_hit_count - start_secondary_hits;
+    }
+
+    size_t num_hits = 0;
+    for (size_t i = 0; i < num_keys; i++) {
+      if (handles[i]) {
+        ++*lookup_hits;
+        ++num_hits;
+        if (!FLAGS_lean) {
+          // do something with the data
+          *result += NPHash64(static_cast<char*>(cache_->Value(handles[i])),
+                              FLAGS_value_bytes);
+        }
+        pinned->push_back(handles[i]);
+      } else {
+        ++*lookup_misses;
+        if (insert_misses) {
+          // do insert
+          Status s = cache_->Insert(
+              num_keys == 1 ? key : Slice(thread->batch_keys[i]),
+              createValue(thread->rnd, cache_->memory_allocator()), &helper2,
+              FLAGS_value_bytes, &pinned->emplace_back());
+          assert(s.ok());
+        }
+      }
+    }
+    if (FLAGS_tier_stats) {
+      thread->tier_stats.Add(num_keys, num_hits, secondary_hits, cpu_nanos);
+    }
+  }
+
   void PrintEnv() const {
 #if defined(__GNUC__) && !defined(__OPTIMIZE__)
     printf(
@@ -825,12 +1059,14 @@ class CacheBench {
            AsShardedCache(cache_.get())->GetNumShardBits());
     printf("Max key             : %" PRIu64 "\n", max_key_);
     printf("Resident ratio      : %g\n", FLAGS_resident_ratio);
+    printf("Key distribution    : %s\n", FLAGS_key_distribution.c_str());
     printf("Skew degree         : %u\n", FLAGS_skew);
     printf("Populate cache      : %d\n", int{FLAGS_populate_cache});
     printf("Lookup+Insert pct   : %u%%\n", FLAGS_lookup_insert_percent);
     printf("Insert percentage   : %u%%\n", FLAGS_insert_percent);
     printf("Lookup percentage   : %u%%\n", FLAGS_lookup_percent);
     printf("Erase percentage    : %u%%\n", FLAGS_erase_percent);
+    printf("Lookup batch size   : %u\n", FLAGS_lookup_batch_size);
     std::ostringstream stats;
     if (FLAGS_gather_stats) {
       stats << "enabled (" << FLAGS_gather_stats_sleep_ms << "ms, "
@@ -25,6 +25,8 @@ std::array<std::string, kNumCacheEntryRoles> kCacheEntryRoleToCamelString{{
     "FileMetadata",
     "BlobValue",
     "BlobCache",
+    "CompactionBuffer",
+    "BottommostHashIndex",
     "Misc",
 }};
 
@@ -42,6 +44,8 @@ std::array<std::string, kNumCacheEntryRoles> kCacheEntryRoleToHyphenString{{
     "file-metadata",
     "blob-value",
     "blob-cache",
+    "compaction-buffer",
+    "bottommost-hash-index",
     "misc",
 }};
 
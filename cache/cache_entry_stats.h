@@ -35,6 +35,9 @@ namespace ROCKSDB_NAMESPACE {
 // * The most recent gathered stats are saved and simply copied to
 // satisfy requests within a time window (default: 3 minutes) of
 // completion of the most recent stat gathering.
+// * Stats that the Cache maintains itself as entries are inserted and
+// removed (see Cache::GetChargesByRole()) are read without iterating, and
+// so are never stale.
 //
 // Template parameter Stats must be copyable and trivially constructable,
 // as well as...
@@ -49,6 +52,9 @@ namespace ROCKSDB_NAMESPACE {
 //   // Notification that a collection was skipped because of
 //   // sufficiently recent saved results.
 //   void SkippedCollection();
+//   // Gathers the stats from counters maintained by the Cache, in place
+//   // of a collection, returning false if the Cache does not maintain them
+//   bool CollectFromCache(Cache*, SystemClock*, uint64_t time_micros);
 // }
 template <class Stats>
 class CacheEntryStatsCollector {
@@ -79,7 +85,10 @@ class CacheEntryStatsCollector {
     }
 
     uint64_t start_time_micros = clock_->NowMicros();
-    if ((start_time_micros - last_end_time_micros_) > max_age_micros) {
+    if (working_stats_.CollectFromCache(cache_, clock_, start_time_micros)) {
+      last_start_time_micros_ = start_time_micros;
+      last_end_time_micros_ = start_time_micros;
+    } else if ((start_time_micros - last_end_time_micros_) > max_age_micros) {
       last_start_time_micros_ = start_time_micros;
       working_stats_.BeginCollection(cache_, clock_, start_time_micros);
 
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
 
 #include "rocksdb/advanced_cache.h"
 #include "rocksdb/rocksdb_namespace.h"
@@ -26,6 +27,20 @@ Slice GetSliceForKey(const T* t) {
   return Slice(reinterpret_cast<const char*>(t), sizeof(T));
 }
 
+// The key of the reader of a file, like a table or blob file, in the table
+// cache. It is as long as a block cache key, the only size that
+// HyperClockCache supports.
+struct FileNumberCacheKey {
+  explicit FileNumberCacheKey(uint64_t _file_number)
+      : file_number(_file_number) {}
+
+  Slice AsSlice() const { return GetSliceForKey(this); }
+
+  uint64_t file_number;
+  uint64_t reserved = 0;
+};
+static_assert(sizeof(FileNumberCacheKey) == 16);
+
 void ReleaseCacheHandleCleanup(void* arg1, void* arg2);
 
 // Generic resource management object for cache handles that releases the handle
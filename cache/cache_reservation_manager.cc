@@ -181,4 +181,8 @@ template class CacheReservationManagerImpl<CacheEntryRole::kMisc>;
 template class CacheReservationManagerImpl<CacheEntryRole::kWriteBuffer>;
 template class CacheReservationManagerImpl<CacheEntryRole::kFileMetadata>;
 template class CacheReservationManagerImpl<CacheEntryRole::kBlobCache>;
+template class CacheReservationManagerImpl<
+    CacheEntryRole::kCompactionBuffer>;
+template class CacheReservationManagerImpl<
+    CacheEntryRole::kBottommostHashIndex>;
 }  // namespace ROCKSDB_NAMESPACE
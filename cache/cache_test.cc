@@ -9,10 +9,12 @@
 
 #include "rocksdb/cache.h"
 
+#include <array>
 #include <forward_list>
 #include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "cache/lru_cache.h"
@@ -748,6 +750,87 @@ TEST_P(LRUCacheTest, SetStrictCapacityLimit) {
   }
 }
 
+TEST_P(LRUCacheTest, NumaAware) {
+  auto cache = NewCache(1000, [](ShardedCacheOptions& opts) {
+    opts.num_shard_bits = 2;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    opts.numa_aware = true;
+  });
+  auto sc = dynamic_cast<ShardedCacheBase*>(cache.get());
+  ASSERT_EQ(2 + GetNumaShardGroupBits(), sc->GetNumShardBits());
+
+  // Behaves the same from any single node
+  for (int key = 0; key < 50; key++) {
+    Insert(cache, key, key + 1000);
+  }
+  for (int key = 0; key < 50; key++) {
+    ASSERT_EQ(key + 1000, Lookup(cache, key));
+  }
+  for (int key = 0; key < 50; key += 2) {
+    Erase(cache, key);
+  }
+  for (int key = 0; key < 50; key++) {
+    ASSERT_EQ(key % 2 == 0 ? -1 : key + 1000, Lookup(cache, key));
+  }
+  ASSERT_EQ(25U, cache->GetUsage());
+}
+
+TEST_P(LRUCacheTest, SharedLookups) {
+  auto cache = NewCache(100000, [](ShardedCacheOptions& opts) {
+    opts.num_shard_bits = 0;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    static_cast<LRUCacheOptions&>(opts).shared_lookups = true;
+  });
+  for (int key = 0; key < 10; key++) {
+    Insert(cache, key, key + 1000);
+  }
+
+  // The first hit updates the LRU list, holding on to it makes later hits
+  // take the shared path
+  std::vector<Cache::Handle*> pinned;
+  for (int key = 0; key < 10; key++) {
+    pinned.push_back(cache->Lookup(EncodeKey(key)));
+    ASSERT_NE(pinned.back(), nullptr);
+  }
+  ASSERT_EQ(10U, cache->GetPinnedUsage());
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 10000; i++) {
+        int key = i % 12;
+        Cache::Handle* h = cache->Lookup(EncodeKey(key));
+        if (key < 10) {
+          ASSERT_NE(h, nullptr);
+          ASSERT_EQ(key + 1000, DecodeValue(cache->Value(h)));
+          ASSERT_TRUE(cache->Ref(h));
+          cache->Release(h);
+          cache->Release(h);
+        } else {
+          ASSERT_EQ(h, nullptr);
+        }
+      }
+    });
+  }
+  // Exclusive operations in parallel
+  for (int key = 100; key < 1100; key++) {
+    Insert(cache, key, key);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  ASSERT_EQ(10U, cache->GetPinnedUsage());
+  for (Cache::Handle* h : pinned) {
+    cache->Release(h);
+  }
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+  ASSERT_EQ(1010U, cache->GetUsage());
+  for (int key = 0; key < 10; key++) {
+    ASSERT_EQ(key + 1000, Lookup(cache, key));
+  }
+}
+
 TEST_P(CacheTest, OverCapacity) {
   size_t n = 10;
 
@@ -838,6 +921,67 @@ TEST_P(CacheTest, ApplyToAllEntriesTest) {
   }
 }
 
+TEST_P(CacheTest, GetChargesByRole) {
+  static const Cache::CacheItemHelper kDataHelper{CacheEntryRole::kDataBlock,
+                                                  &CacheTest::Deleter};
+  std::array<size_t, kNumCacheEntryRoles> charges;
+  std::array<size_t, kNumCacheEntryRoles> counts;
+  // The counters must agree with a scan of the cache
+  const auto check = [&]() {
+    std::array<size_t, kNumCacheEntryRoles> scan_charges{};
+    std::array<size_t, kNumCacheEntryRoles> scan_counts{};
+    cache_->ApplyToAllEntries(
+        [&](const Slice& /*key*/, Cache::ObjectPtr /*value*/, size_t charge,
+            const Cache::CacheItemHelper* helper) {
+          size_t role_idx = static_cast<size_t>(helper->role);
+          scan_charges[role_idx] += charge;
+          scan_counts[role_idx]++;
+        },
+        /*opts*/ {});
+    ASSERT_TRUE(cache_->GetChargesByRole(&charges, &counts));
+    EXPECT_EQ(scan_charges, charges);
+    EXPECT_EQ(scan_counts, counts);
+  };
+  const size_t misc_idx = static_cast<size_t>(CacheEntryRole::kMisc);
+  const size_t data_idx = static_cast<size_t>(CacheEntryRole::kDataBlock);
+
+  check();
+  EXPECT_EQ(0, counts[misc_idx]);
+
+  for (int i = 0; i < 10; ++i) {
+    Insert(i, i, i + 1);
+    ASSERT_OK(cache_->Insert(EncodeKey(100 + i), EncodeValue(i), &kDataHelper,
+                             10));
+  }
+  check();
+  EXPECT_EQ(10, counts[misc_idx]);
+  EXPECT_EQ(55, charges[misc_idx]);
+  EXPECT_EQ(10, counts[data_idx]);
+  EXPECT_EQ(100, charges[data_idx]);
+
+  Erase(0);
+  Erase(100);
+  Cache::Handle* h = cache_->Lookup(EncodeKey(101));
+  ASSERT_NE(h, nullptr);
+  cache_->Release(h, /*erase_if_last_ref=*/true);
+  check();
+  EXPECT_EQ(9, counts[misc_idx]);
+  EXPECT_EQ(8, counts[data_idx]);
+
+  // Evictions
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_OK(cache_->Insert(EncodeKey(1000 + i), EncodeValue(i), &kDataHelper,
+                             10));
+  }
+  check();
+  EXPECT_LE(charges[misc_idx] + charges[data_idx], cache_->GetUsage());
+
+  cache_->EraseUnRefEntries();
+  check();
+  EXPECT_EQ(0, counts[misc_idx]);
+  EXPECT_EQ(0, counts[data_idx]);
+}
+
 TEST_P(CacheTest, ApplyToAllEntriesDuringResize) {
   // This is a mini-stress test of ApplyToAllEntries, to ensure
   // items in the cache that are neither added nor removed
@@ -948,6 +1092,84 @@ TEST_P(CacheTest, GetChargeAndDeleter) {
   cache_->Release(h1);
 }
 
+TEST_P(CacheTest, MultiLookup) {
+  // More than one batch, spread over the shards, odd keys missing
+  constexpr int kNumKeys = 70;
+  for (int key = 0; key < kNumKeys; key += 2) {
+    Insert(key, key + 1000);
+  }
+  std::vector<std::string> keys;
+  for (int key = 0; key < kNumKeys; key++) {
+    keys.push_back(EncodeKey(key));
+  }
+  std::array<Cache::AsyncLookupHandle, kNumKeys> async_handles;
+  for (int key = 0; key < kNumKeys; key++) {
+    async_handles[key].key = keys[key];
+  }
+  cache_->MultiLookup(async_handles.data(), kNumKeys);
+  cache_->WaitAll(async_handles.data(), kNumKeys);
+  for (int key = 0; key < kNumKeys; key++) {
+    Cache::Handle* h = async_handles[key].Result();
+    if (key % 2 == 0) {
+      ASSERT_NE(nullptr, h);
+      ASSERT_EQ(key + 1000, DecodeValue(cache_->Value(h)));
+      cache_->Release(h);
+    } else {
+      ASSERT_EQ(nullptr, h);
+    }
+  }
+}
+
+TEST_P(CacheTest, TinyLfuAdmission) {
+  TinyLfuAdmissionPolicyOptions policy_opts;
+  policy_opts.expected_entries = 100;
+  auto cache = NewCache(3, [&](ShardedCacheOptions& opts) {
+    opts.num_shard_bits = 0;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    opts.admission_policy = NewTinyLfuAdmissionPolicy(policy_opts);
+  });
+  static const Cache::CacheItemHelper kDataHelper{CacheEntryRole::kDataBlock,
+                                                  &CacheTest::Deleter};
+  auto insert_data = [&](int key) {
+    ASSERT_OK(cache->Insert(EncodeKey(key), EncodeValue(key + 100),
+                            &kDataHelper, /*charge*/ 1));
+  };
+
+  // Admitted regardless of lookups while there is room
+  for (int key = 1; key <= 3; key++) {
+    insert_data(key);
+  }
+  ASSERT_EQ(3U, cache->GetUsage());
+  ASSERT_TRUE(deleted_values_.empty());
+
+  // Never looked up: deleted right away
+  insert_data(4);
+  ASSERT_EQ(3U, cache->GetUsage());
+  ASSERT_EQ(std::vector<int>({104}), deleted_values_);
+  ASSERT_EQ(-1, Lookup(cache, 4));
+
+  // Also with a handle, which is then standalone
+  Cache::Handle* h = nullptr;
+  ASSERT_OK(cache->Insert(EncodeKey(4), EncodeValue(104), &kDataHelper,
+                          /*charge*/ 1, &h));
+  ASSERT_NE(nullptr, h);
+  cache->Release(h);
+  ASSERT_EQ(3U, cache->GetUsage());
+  ASSERT_EQ(std::vector<int>({104, 104}), deleted_values_);
+
+  // Looked up twice
+  ASSERT_EQ(-1, Lookup(cache, 4));
+  insert_data(4);
+  ASSERT_EQ(104, Lookup(cache, 4));
+
+  // Not subject to admission
+  Insert(cache, 5, 105);
+  ASSERT_EQ(105, Lookup(cache, 5));
+
+  ASSERT_NE(std::string::npos,
+            cache->GetPrintableOptions().find("TinyLfuAdmissionPolicy"));
+}
+
 namespace {
 bool AreTwoCacheKeysOrdered(Cache* cache) {
   std::vector<std::string> keys;
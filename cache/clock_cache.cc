@@ -553,6 +553,7 @@ inline bool BaseClockTable::ChargeUsageMaybeEvictNonStrict(
 }
 
 void BaseClockTable::TrackAndReleaseEvictedEntry(ClockHandle* h) {
+  TrackEntryRemoved(*h);
   bool took_value_ownership = false;
   if (eviction_callback_) {
     // For key reconstructed from hash
@@ -643,6 +644,8 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
     uint64_t initial_countdown = GetInitialCountdown(priority);
     assert(initial_countdown > 0);
 
+    // Tracked ahead of the insertion, which makes the entry evictable
+    TrackEntryAdded(proto);
     HandleImpl* e =
         derived.DoInsert(proto, initial_countdown, handle != nullptr, state);
 
@@ -654,8 +657,9 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
       return Status::OK();
     }
     // Not inserted
-    // Revert occupancy
+    // Revert occupancy and role charges
     occupancy_.FetchSubRelaxed(1);
+    TrackEntryRemoved(proto);
     // Maybe fall back on standalone insert
     if (handle == nullptr) {
       // Revert usage
@@ -828,6 +832,10 @@ FixedHyperClockTable::HandleImpl* FixedHyperClockTable::DoInsert(
   return nullptr;
 }
 
+void FixedHyperClockTable::Prefetch(const UniqueId64x2& hashed_key) const {
+  PREFETCH(&array_[BitwiseAnd(hashed_key[1], length_bits_mask_)], 0, 3);
+}
+
 FixedHyperClockTable::HandleImpl* FixedHyperClockTable::Lookup(
     const UniqueId64x2& hashed_key) {
   HandleImpl* e = FindSlot(
@@ -954,6 +962,7 @@ bool FixedHyperClockTable::Release(HandleImpl* h, bool useful,
       usage_.FetchSubRelaxed(total_charge);
     } else {
       Rollback(h->hashed_key, h);
+      TrackEntryRemoved(*h);
       FreeDataMarkEmpty(*h, allocator_);
       ReclaimEntryUsage(total_charge);
     }
@@ -1010,6 +1019,7 @@ void FixedHyperClockTable::Erase(const UniqueId64x2& hashed_key) {
                 // Took ownership
                 assert(hashed_key == h->hashed_key);
                 size_t total_charge = h->GetTotalCharge();
+                TrackEntryRemoved(*h);
                 FreeDataMarkEmpty(*h, allocator_);
                 ReclaimEntryUsage(total_charge);
                 // We already have a copy of hashed_key in this case, so OK to
@@ -1049,6 +1059,7 @@ void FixedHyperClockTable::EraseUnRefEntries() {
       // Took ownership
       size_t total_charge = h.GetTotalCharge();
       Rollback(h.hashed_key, &h);
+      TrackEntryRemoved(h);
       FreeDataMarkEmpty(h, allocator_);
       ReclaimEntryUsage(total_charge);
     }
@@ -1171,10 +1182,16 @@ ClockCacheShard<Table>::ClockCacheShard(
              hash_seed, opts),
       capacity_(capacity),
       eec_and_scl_(SanitizeEncodeEecAndScl(opts.eviction_effort_cap,
-                                           strict_capacity_limit)) {
+                                           strict_capacity_limit)),
+      min_admission_frequency_(std::min(opts.min_admission_frequency,
+                                        FrequencySketch::kMaxFrequency)) {
   // Initial charge metadata should not exceed capacity
   assert(table_.GetUsage() <= capacity_.LoadRelaxed() ||
          capacity_.LoadRelaxed() < sizeof(HandleImpl));
+  if (opts.track_access_frequency || min_admission_frequency_ > 0) {
+    frequency_sketch_.reset(new FrequencySketch(
+        capacity / std::max(opts.estimated_entry_charge, size_t{1})));
+  }
 }
 
 template <class Table>
@@ -1271,8 +1288,21 @@ Status ClockCacheShard<Table>::Insert(const Slice& key,
   proto.value = value;
   proto.helper = helper;
   proto.total_charge = charge;
-  return table_.template Insert<Table>(proto, handle, priority,
-                                       capacity_.LoadRelaxed(),
+  const size_t capacity = capacity_.LoadRelaxed();
+  if (min_admission_frequency_ > 0 &&
+      table_.GetUsage() + charge > capacity &&
+      frequency_sketch_->Estimate(hashed_key[1]) < min_admission_frequency_) {
+    // Not admitted: as if inserted and evicted right away
+    if (handle == nullptr) {
+      proto.FreeData(table_.GetAllocator());
+    } else {
+      *handle = table_.template CreateStandalone<Table>(
+          proto, capacity, eec_and_scl_.LoadRelaxed(),
+          /*allow_uncharged=*/true);
+    }
+    return Status::OK();
+  }
+  return table_.template Insert<Table>(proto, handle, priority, capacity,
                                        eec_and_scl_.LoadRelaxed());
 }
 
@@ -1299,9 +1329,30 @@ typename ClockCacheShard<Table>::HandleImpl* ClockCacheShard<Table>::Lookup(
   if (UNLIKELY(key.size() != kCacheKeySize)) {
     return nullptr;
   }
+  if (frequency_sketch_) {
+    frequency_sketch_->Add(hashed_key[1]);
+  }
   return table_.Lookup(hashed_key);
 }
 
+template <class Table>
+void ClockCacheShard<Table>::MultiLookup(const Slice* keys,
+                                         const UniqueId64x2* hashed_keys,
+                                         HandleImpl** results, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    table_.Prefetch(hashed_keys[i]);
+  }
+  for (size_t i = 0; i < count; i++) {
+    results[i] = Lookup(keys[i], hashed_keys[i]);
+  }
+}
+
+template <class Table>
+uint32_t ClockCacheShard<Table>::GetAccessFrequency(
+    const UniqueId64x2& hashed_key) const {
+  return frequency_sketch_ ? frequency_sketch_->Estimate(hashed_key[1]) : 0;
+}
+
 template <class Table>
 bool ClockCacheShard<Table>::Ref(HandleImpl* h) {
   if (h == nullptr) {
@@ -1406,6 +1457,13 @@ size_t ClockCacheShard<Table>::GetTableAddressCount() const {
   return table_.GetTableSize();
 }
 
+template <class Table>
+void ClockCacheShard<Table>::AddChargesByRole(
+    std::array<size_t, kNumCacheEntryRoles>* charges,
+    std::array<size_t, kNumCacheEntryRoles>* counts) const {
+  table_.AddChargesByRole(charges, counts);
+}
+
 // Explicit instantiation
 template class ClockCacheShard<FixedHyperClockTable>;
 template class ClockCacheShard<AutoHyperClockTable>;
@@ -1431,6 +1489,16 @@ Cache::ObjectPtr BaseHyperClockCache<Table>::Value(Handle* handle) {
   return static_cast<const typename Table::HandleImpl*>(handle)->value;
 }
 
+template <class Table>
+uint32_t BaseHyperClockCache<Table>::GetAccessFrequency(
+    const Slice& key) const {
+  if (key.size() != kCacheKeySize) {
+    return 0;
+  }
+  const auto hashed_key = Shard::ComputeHash(key, this->hash_seed_);
+  return this->GetShard(hashed_key).GetAccessFrequency(hashed_key);
+}
+
 template <class Table>
 size_t BaseHyperClockCache<Table>::GetCharge(Handle* handle) const {
   return static_cast<const typename Table::HandleImpl*>(handle)
@@ -3088,6 +3156,14 @@ AutoHyperClockTable::HandleImpl* AutoHyperClockTable::DoInsert(
   }
 }
 
+void AutoHyperClockTable::Prefetch(const UniqueId64x2& hashed_key) const {
+  size_t home;
+  int home_shift;
+  GetHomeIndexAndShift(length_info_.LoadRelaxed(), hashed_key[1], &home,
+                       &home_shift);
+  PREFETCH(&array_.Get()[home], 0, 3);
+}
+
 AutoHyperClockTable::HandleImpl* AutoHyperClockTable::Lookup(
     const UniqueId64x2& hashed_key) {
   // Lookups are wait-free with low occurrence of retries, back-tracking,
@@ -3372,6 +3448,7 @@ bool AutoHyperClockTable::TryEraseHandle(HandleImpl* h, bool holding_ref,
     delete h;
     standalone_usage_.FetchSubRelaxed(total_charge);
   } else {
+    TrackEntryRemoved(*h);
     Remove(h);
     MarkEmpty(*h);
     occupancy_.FetchSub(1U);
@@ -3458,6 +3535,7 @@ void AutoHyperClockTable::EraseUnRefEntries() {
       // Took ownership
       h.FreeData(allocator_);
       usage_.FetchSubRelaxed(h.total_charge);
+      TrackEntryRemoved(h);
       // NOTE: could be more efficient with a dedicated variant of
       // PurgeImpl, but this is not a common operation
       Remove(&h);
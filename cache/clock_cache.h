@@ -18,6 +18,7 @@
 #include <string>
 
 #include "cache/cache_key.h"
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/malloc.h"
@@ -379,8 +380,20 @@ class BaseClockTable {
     explicit BaseOpts(int _eviction_effort_cap)
         : eviction_effort_cap(_eviction_effort_cap) {}
     explicit BaseOpts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {}
+        : BaseOpts(opts.eviction_effort_cap) {
+      track_access_frequency =
+          opts.track_access_frequency || opts.min_admission_frequency > 0;
+      min_admission_frequency = opts.min_admission_frequency;
+      estimated_entry_charge = opts.estimated_entry_charge > 0
+                                   ? opts.estimated_entry_charge
+                                   : opts.min_avg_entry_charge;
+    }
     int eviction_effort_cap;
+    // See HyperClockCacheOptions
+    bool track_access_frequency = false;
+    uint32_t min_admission_frequency = 0;
+    // For sizing the access frequency sketch
+    size_t estimated_entry_charge = 0;
   };
 
   BaseClockTable(CacheMetadataChargePolicy metadata_charge_policy,
@@ -419,6 +432,17 @@ class BaseClockTable {
     return eviction_effort_exceeded_count_.LoadRelaxed();
   }
 
+  MemoryAllocator* GetAllocator() const { return allocator_; }
+
+  // Adds the charge and count of the entries in the table by CacheEntryRole
+  void AddChargesByRole(std::array<size_t, kNumCacheEntryRoles>* charges,
+                        std::array<size_t, kNumCacheEntryRoles>* counts) const {
+    for (size_t i = 0; i < kNumCacheEntryRoles; ++i) {
+      (*charges)[i] += role_charges_[i].LoadRelaxed();
+      (*counts)[i] += role_counts_[i].LoadRelaxed();
+    }
+  }
+
   struct EvictionData {
     size_t freed_charge = 0;
     size_t freed_count = 0;
@@ -427,6 +451,19 @@ class BaseClockTable {
 
   void TrackAndReleaseEvictedEntry(ClockHandle* h);
 
+  // Maintain `role_charges_` and `role_counts_` as an entry enters or leaves
+  // the table. The caller must own the entry (or its proto, before insertion).
+  void TrackEntryAdded(const ClockHandleBasicData& h) {
+    size_t role_idx = GetRoleIndex(h);
+    role_charges_[role_idx].FetchAddRelaxed(h.GetTotalCharge());
+    role_counts_[role_idx].FetchAddRelaxed(1);
+  }
+  void TrackEntryRemoved(const ClockHandleBasicData& h) {
+    size_t role_idx = GetRoleIndex(h);
+    role_charges_[role_idx].FetchSubRelaxed(h.GetTotalCharge());
+    role_counts_[role_idx].FetchSubRelaxed(1);
+  }
+
 #ifndef NDEBUG
   // Acquire N references
   void TEST_RefN(ClockHandle& handle, size_t n);
@@ -441,6 +478,11 @@ class BaseClockTable {
   template <class HandleImpl>
   HandleImpl* StandaloneInsert(const ClockHandleBasicData& proto);
 
+  static size_t GetRoleIndex(const ClockHandleBasicData& h) {
+    return static_cast<size_t>(h.helper ? h.helper->role
+                                        : CacheEntryRole::kMisc);
+  }
+
   // Helper for updating `usage_` for new entry with given `total_charge`
   // and evicting if needed under strict_capacity_limit=true rules. This
   // means the operation might fail with Status::MemoryLimit. If
@@ -497,6 +539,11 @@ class BaseClockTable {
   // Part of usage by standalone entries (not in table)
   AcqRelAtomic<size_t> standalone_usage_{};
 
+  // Charge and number of the entries in the table, by CacheEntryRole.
+  // (Relaxed: only needs to be consistent with itself.)
+  std::array<RelaxedAtomic<size_t>, kNumCacheEntryRoles> role_charges_;
+  std::array<RelaxedAtomic<size_t>, kNumCacheEntryRoles> role_counts_;
+
   ALIGN_AS(CACHE_LINE_SIZE)
   const CacheMetadataChargePolicy metadata_charge_policy_;
 
@@ -543,8 +590,7 @@ class FixedHyperClockTable : public BaseClockTable {
     explicit Opts(size_t _estimated_value_size, int _eviction_effort_cap)
         : BaseOpts(_eviction_effort_cap),
           estimated_value_size(_estimated_value_size) {}
-    explicit Opts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {
+    explicit Opts(const HyperClockCacheOptions& opts) : BaseOpts(opts) {
       assert(opts.estimated_entry_charge > 0);
       estimated_value_size = opts.estimated_entry_charge;
     }
@@ -578,6 +624,9 @@ class FixedHyperClockTable : public BaseClockTable {
 
   HandleImpl* Lookup(const UniqueId64x2& hashed_key);
 
+  // Brings into CPU cache the first slot Lookup() would probe
+  void Prefetch(const UniqueId64x2& hashed_key) const;
+
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref);
 
   void Erase(const UniqueId64x2& hashed_key);
@@ -653,8 +702,6 @@ class FixedHyperClockTable : public BaseClockTable {
   // before releasing it so that it can be provided to this function.
   inline void ReclaimEntryUsage(size_t total_charge);
 
-  MemoryAllocator* GetAllocator() const { return allocator_; }
-
   // Returns the number of bits used to hash an element in the hash
   // table.
   static int CalcHashBits(size_t capacity, size_t estimated_value_size,
@@ -833,8 +880,7 @@ class AutoHyperClockTable : public BaseClockTable {
         : BaseOpts(_eviction_effort_cap),
           min_avg_value_size(_min_avg_value_size) {}
 
-    explicit Opts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {
+    explicit Opts(const HyperClockCacheOptions& opts) : BaseOpts(opts) {
       assert(opts.estimated_entry_charge == 0);
       min_avg_value_size = opts.min_avg_entry_charge;
     }
@@ -873,6 +919,9 @@ class AutoHyperClockTable : public BaseClockTable {
 
   HandleImpl* Lookup(const UniqueId64x2& hashed_key);
 
+  // Brings into CPU cache the first slot Lookup() would probe
+  void Prefetch(const UniqueId64x2& hashed_key) const;
+
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref);
 
   void Erase(const UniqueId64x2& hashed_key);
@@ -1071,6 +1120,12 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
 
   size_t GetTableAddressCount() const;
 
+  void AddChargesByRole(std::array<size_t, kNumCacheEntryRoles>* charges,
+                        std::array<size_t, kNumCacheEntryRoles>* counts) const;
+
+  // See Cache::GetAccessFrequency()
+  uint32_t GetAccessFrequency(const UniqueId64x2& hashed_key) const;
+
   void ApplyToSomeEntries(
       const std::function<void(const Slice& key, Cache::ObjectPtr obj,
                                size_t charge,
@@ -1087,6 +1142,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
                      Cache::Priority /*priority*/, Statistics* /*stats*/) {
     return Lookup(key, hashed_key);
   }
+  // Prefetches all the first probes before any of the Lookups
+  void MultiLookup(const Slice* keys, const UniqueId64x2* hashed_keys,
+                   HandleImpl** results, size_t count);
+
 
   Table& GetTable() { return table_; }
   const Table& GetTable() const { return table_; }
@@ -1111,6 +1170,13 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
   // (top bit). See HyperClockCacheOptions::eviction_effort_cap etc.
   // (Relaxed: eventual consistency/update is OK)
   RelaxedAtomic<uint32_t> eec_and_scl_;
+
+  // Counts the lookups of each key, if HyperClockCacheOptions::
+  // track_access_frequency, else null.
+  std::unique_ptr<FrequencySketch> frequency_sketch_;
+
+  // See HyperClockCacheOptions::min_admission_frequency
+  const uint32_t min_admission_frequency_;
 };  // class ClockCacheShard
 
 template <class Table>
@@ -1128,6 +1194,8 @@ class BaseHyperClockCache : public ShardedCache<ClockCacheShard<Table>> {
 
   const CacheItemHelper* GetCacheItemHelper(Handle* handle) const override;
 
+  uint32_t GetAccessFrequency(const Slice& key) const override;
+
   void ApplyToHandle(
       Cache* cache, Handle* handle,
       const std::function<void(const Slice& key, Cache::ObjectPtr obj,
@@ -27,10 +27,31 @@ CompressedSecondaryCache::CompressedSecondaryCache(
       disable_cache_(opts.capacity == 0) {
   auto mgr =
       GetBuiltinCompressionManager(cache_options_.compress_format_version);
-  compressor_ = mgr->GetCompressor(cache_options_.compression_opts,
-                                   cache_options_.compression_type);
-  decompressor_ =
-      mgr->GetDecompressorOptimizeFor(cache_options_.compression_type);
+  for (uint32_t i = 0; i < kNumCacheEntryRoles; ++i) {
+    const CacheEntryRole role = static_cast<CacheEntryRole>(i);
+    CompressionType type = cache_options_.compression_type;
+    auto it = cache_options_.compression_type_overrides.find(role);
+    if (it != cache_options_.compression_type_overrides.end()) {
+      type = it->second;
+    }
+    if (cache_options_.do_not_compress_roles.Contains(role)) {
+      type = kNoCompression;
+    }
+    if (type != kNoCompression) {
+      role_compressors_[i] =
+          mgr->GetCompressor(cache_options_.compression_opts, type);
+    }
+    role_compression_types_[i] =
+        role_compressors_[i]
+            ? role_compressors_[i]->GetPreferredCompressionType()
+            : kNoCompression;
+  }
+  if (cache_options_.compression_type_overrides.empty()) {
+    decompressor_ =
+        mgr->GetDecompressorOptimizeFor(cache_options_.compression_type);
+  } else {
+    decompressor_ = mgr->GetDecompressor();
+  }
 }
 
 CompressedSecondaryCache::~CompressedSecondaryCache() = default;
@@ -67,7 +88,9 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   size_t handle_value_charge{0};
   const char* data_ptr = nullptr;
   CacheTier source = CacheTier::kVolatileCompressedTier;
-  CompressionType type = cache_options_.compression_type;
+  // Split values are always compressed the way their role is
+  CompressionType type =
+      role_compression_types_[static_cast<size_t>(helper->role)];
   if (cache_options_.enable_custom_split_merge) {
     CacheValueChunk* value_chunk_ptr =
         reinterpret_cast<CacheValueChunk*>(handle_value);
@@ -98,8 +121,7 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   Cache::ObjectPtr value{nullptr};
   size_t charge{0};
   if (source == CacheTier::kVolatileCompressedTier) {
-    if (cache_options_.compression_type == kNoCompression ||
-        cache_options_.do_not_compress_roles.Contains(helper->role)) {
+    if (type == kNoCompression) {
       s = helper->create_cb(Slice(data_ptr, handle_value_charge),
                             kNoCompression, CacheTier::kVolatileTier,
                             create_context, allocator, &value, &charge);
@@ -108,7 +130,7 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
       // custom compression, to decompress without an extra copy in create_cb?
       Decompressor::Args args;
       args.compressed_data = Slice(data_ptr, handle_value_charge);
-      args.compression_type = cache_options_.compression_type;
+      args.compression_type = type;
       s = decompressor_->ExtractUncompressedSize(args);
       assert(s.ok());
       if (s.ok()) {
@@ -184,7 +206,6 @@ Status CompressedSecondaryCache::InsertInternal(
   payload = EncodeVarint32(payload, static_cast<uint32_t>(type));
   payload = EncodeVarint32(payload, static_cast<uint32_t>(source));
   size_t data_size = (*helper->size_cb)(value);
-  char* data_size_ptr = payload;
   payload = EncodeVarint64(payload, data_size);
 
   size_t header_size = payload - header;
@@ -200,42 +221,53 @@ Status CompressedSecondaryCache::InsertInternal(
   Slice val(data_ptr, data_size);
 
   std::string compressed_val;
-  if (cache_options_.compression_type != kNoCompression &&
-      type == kNoCompression &&
-      !cache_options_.do_not_compress_roles.Contains(helper->role)) {
+  CompressionType stored_type = type;
+  Compressor* compressor =
+      role_compressors_[static_cast<size_t>(helper->role)].get();
+  if (compressor != nullptr && type == kNoCompression) {
     PERF_COUNTER_ADD(compressed_sec_cache_uncompressed_bytes, data_size);
 
     CompressionType to_type = kNoCompression;
-    s = compressor_->CompressBlock(val, &compressed_val, &to_type,
-                                   nullptr /*working_area*/);
+    s = compressor->CompressBlock(val, &compressed_val, &to_type,
+                                  nullptr /*working_area*/);
     if (!s.ok()) {
       return s;
     }
-    // TODO: allow values not compressed when there's no size savings?
-    assert(to_type == cache_options_.compression_type);
-    if (to_type != cache_options_.compression_type) {
-      return Status::Corruption("Failed to compress value.");
+    if (cache_options_.enable_custom_split_merge) {
+      // Lookup of split values relies on them being compressed
+      assert(to_type == compressor->GetPreferredCompressionType());
+      if (to_type != compressor->GetPreferredCompressionType()) {
+        return Status::Corruption("Failed to compress value.");
+      }
+    } else if (IsPoorCompressionRatio(data_size, compressed_val.size())) {
+      // Keep it uncompressed, as already saved in ptr
+      to_type = kNoCompression;
     }
 
-    val = Slice(compressed_val);
-    data_size = compressed_val.size();
-    payload = EncodeVarint64(data_size_ptr, data_size);
-    header_size = payload - header;
-    total_size = header_size + data_size;
-    PERF_COUNTER_ADD(compressed_sec_cache_compressed_bytes, data_size);
-
-    if (!cache_options_.enable_custom_split_merge) {
-      ptr = AllocateBlock(total_size, cache_options_.memory_allocator.get());
-      data_ptr = ptr.get() + header_size;
-      memcpy(data_ptr, compressed_val.data(), data_size);
+    if (to_type != kNoCompression) {
+      stored_type = to_type;
+      val = Slice(compressed_val);
+      data_size = compressed_val.size();
+      payload = EncodeVarint32(header, static_cast<uint32_t>(stored_type));
+      payload = EncodeVarint32(payload, static_cast<uint32_t>(source));
+      payload = EncodeVarint64(payload, data_size);
+      header_size = payload - header;
+      total_size = header_size + data_size;
+      PERF_COUNTER_ADD(compressed_sec_cache_compressed_bytes, data_size);
+
+      if (!cache_options_.enable_custom_split_merge) {
+        ptr = AllocateBlock(total_size, cache_options_.memory_allocator.get());
+        data_ptr = ptr.get() + header_size;
+        memcpy(data_ptr, compressed_val.data(), data_size);
+      }
     }
   }
 
   PERF_COUNTER_ADD(compressed_sec_cache_insert_real_count, 1);
   if (cache_options_.enable_custom_split_merge) {
     size_t split_charge{0};
-    CacheValueChunk* value_chunks_head = SplitValueIntoChunks(
-        val, cache_options_.compression_type, split_charge);
+    CacheValueChunk* value_chunks_head =
+        SplitValueIntoChunks(val, stored_type, split_charge);
     return cache_->Insert(key, value_chunks_head, internal_helper,
                           split_charge);
   } else {
@@ -317,9 +349,25 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  for (const auto& role_type : cache_options_.compression_type_overrides) {
+    snprintf(buffer, kBufferSize, "    compression_type[%s] : %s\n",
+             GetCacheEntryRoleName(role_type.first).c_str(),
+             CompressionTypeToString(role_type.second).c_str());
+    ret.append(buffer);
+  }
+  snprintf(buffer, kBufferSize, "    min_compression_ratio : %f\n",
+           cache_options_.min_compression_ratio);
+  ret.append(buffer);
   return ret;
 }
 
+bool CompressedSecondaryCache::IsPoorCompressionRatio(
+    size_t uncompressed_size, size_t compressed_size) const {
+  return static_cast<double>(compressed_size) *
+             cache_options_.min_compression_ratio >
+         static_cast<double>(uncompressed_size);
+}
+
 CompressedSecondaryCache::CacheValueChunk*
 CompressedSecondaryCache::SplitValueIntoChunks(const Slice& value,
                                                CompressionType compression_type,
@@ -139,13 +139,22 @@ class CompressedSecondaryCache : public SecondaryCache {
                         const Cache::CacheItemHelper* helper,
                         CompressionType type, CacheTier source);
 
+  // Whether compressing `uncompressed_size` bytes to `compressed_size` saves
+  // too little to be worth decompressing on lookup.
+  bool IsPoorCompressionRatio(size_t uncompressed_size,
+                              size_t compressed_size) const;
+
   size_t TEST_GetCharge(const Slice& key);
 
   // TODO: clean up to use cleaner interfaces in typed_cache.h
   const Cache::CacheItemHelper* GetHelper(bool enable_custom_split_merge) const;
   std::shared_ptr<Cache> cache_;
   CompressedSecondaryCacheOptions cache_options_;
-  std::unique_ptr<Compressor> compressor_;
+  // How entries of each role are compressed, with a null compressor for
+  // kNoCompression
+  std::array<CompressionType, kNumCacheEntryRoles> role_compression_types_;
+  std::array<std::unique_ptr<Compressor>, kNumCacheEntryRoles>
+      role_compressors_;
   std::shared_ptr<Decompressor> decompressor_;
   mutable port::Mutex capacity_mutex_;
   std::shared_ptr<ConcurrentCacheReservationManager> cache_res_mgr_;
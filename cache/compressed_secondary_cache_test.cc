@@ -940,6 +940,66 @@ TEST_P(CompressedSecondaryCacheTestWithCompressionParam, EntryRoles) {
   }
 }
 
+TEST_P(CompressedSecondaryCacheTest, PerRoleCompressionAndMinRatio) {
+  if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+    return;
+  }
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 16 << 10;
+  opts.num_shard_bits = 0;
+  opts.compression_type = kLZ4Compression;
+  opts.compression_type_overrides[CacheEntryRole::kIndexBlock] =
+      kNoCompression;
+  opts.min_compression_ratio = 1.5;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  std::string compressible(1000, 'a');
+  std::string junk(Random(301).RandomString(1000));
+  struct {
+    std::string* str;
+    CacheEntryRole role;
+    bool compressed;
+  } cases[] = {{&compressible, CacheEntryRole::kDataBlock, true},
+               {&junk, CacheEntryRole::kDataBlock, false},
+               {&compressible, CacheEntryRole::kIndexBlock, false}};
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    std::string& str = *cases[i].str;
+    str[0] = static_cast<char>('0' + i);
+    TestItem item{str.data(), str.length()};
+    std::string key = "key" + std::to_string(i);
+    const Cache::CacheItemHelper* helper = GetHelper(cases[i].role);
+
+    get_perf_context()->Reset();
+    ASSERT_OK(sec_cache->Insert(key, &item, helper, /*force_insert=*/true));
+    ASSERT_EQ(get_perf_context()->compressed_sec_cache_insert_real_count, 1U);
+    if (cases[i].role == CacheEntryRole::kIndexBlock) {
+      ASSERT_EQ(get_perf_context()->compressed_sec_cache_uncompressed_bytes, 0);
+    } else {
+      ASSERT_EQ(get_perf_context()->compressed_sec_cache_uncompressed_bytes,
+                1000);
+    }
+    if (cases[i].compressed) {
+      ASSERT_GT(get_perf_context()->compressed_sec_cache_compressed_bytes, 0);
+      ASSERT_LT(get_perf_context()->compressed_sec_cache_compressed_bytes,
+                1000);
+    } else {
+      // Poor ratio or not compressed for the role
+      ASSERT_EQ(get_perf_context()->compressed_sec_cache_compressed_bytes, 0);
+    }
+
+    bool kept_in_sec_cache{false};
+    std::unique_ptr<SecondaryCacheResultHandle> handle = sec_cache->Lookup(
+        key, helper, this, true, /*advise_erase=*/false, /*stats=*/nullptr,
+        kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(val->Size(), str.size());
+    ASSERT_EQ(memcmp(val->Buf(), str.data(), str.size()), 0);
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(CompressedSecCacheTests,
                         CompressedSecondaryCacheTestWithCompressionParam,
                         testing::Combine(testing::Bool(),
@@ -1236,6 +1296,65 @@ TEST_P(CompressedSecCacheTestWithTiered, DynamicUpdate) {
   ASSERT_EQ(sec_capacity, (30 << 20));
 }
 
+TEST_P(CompressedSecCacheTestWithTiered, AdaptiveRatio) {
+  LRUCacheOptions lru_opts;
+  lru_opts.num_shard_bits = 0;
+  HyperClockCacheOptions hcc_opts(
+      /*_capacity=*/0,
+      /*_estimated_entry_charge=*/256 << 10,
+      /*_num_shard_bits=*/0);
+  TieredCacheOptions opts;
+  opts.cache_type = std::get<0>(GetParam());
+  if (opts.cache_type == PrimaryCacheType::kCacheTypeLRU) {
+    opts.cache_opts = &lru_opts;
+  } else {
+    opts.cache_opts = &hcc_opts;
+  }
+  opts.adm_policy = std::get<1>(GetParam());
+  opts.comp_cache_opts.num_shard_bits = 0;
+  opts.total_capacity = 100 << 20;
+  opts.compressed_secondary_ratio = 0.3;
+  opts.adaptive_ratio_window = 4;
+  opts.adaptive_ratio_step = 0.1;
+  opts.min_compressed_secondary_ratio = 0.1;
+  opts.max_compressed_secondary_ratio = 0.5;
+
+  // Bounds must include the initial ratio and exclude 0
+  opts.max_compressed_secondary_ratio = 0.2;
+  ASSERT_EQ(NewTieredCache(opts), nullptr);
+  opts.max_compressed_secondary_ratio = 0.5;
+  opts.min_compressed_secondary_ratio = 0.0;
+  ASSERT_EQ(NewTieredCache(opts), nullptr);
+  opts.min_compressed_secondary_ratio = 0.1;
+
+  std::shared_ptr<Cache> tiered_cache = NewTieredCache(opts);
+  ASSERT_NE(tiered_cache, nullptr);
+  SecondaryCache* sec_cache =
+      static_cast_with_check<CacheWithSecondaryAdapter, Cache>(
+          tiered_cache.get())
+          ->TEST_GetSecondaryCache();
+  size_t sec_capacity;
+  ASSERT_OK(sec_cache->GetCapacity(sec_capacity));
+  ASSERT_EQ(sec_capacity, 30 << 20);
+
+  // The first window always moves towards a larger secondary cache
+  for (int i = 0; i < 4; ++i) {
+    CacheKey key = CacheKey::CreateUniqueForCacheLifetime(tiered_cache.get());
+    ASSERT_EQ(tiered_cache->Lookup(key.AsSlice(), GetHelper(), this), nullptr);
+  }
+  ASSERT_OK(sec_cache->GetCapacity(sec_capacity));
+  ASSERT_GT(sec_capacity, 30 << 20);
+
+  // Then it stays within bounds
+  for (int i = 0; i < 100; ++i) {
+    CacheKey key = CacheKey::CreateUniqueForCacheLifetime(tiered_cache.get());
+    ASSERT_EQ(tiered_cache->Lookup(key.AsSlice(), GetHelper(), this), nullptr);
+    ASSERT_OK(sec_cache->GetCapacity(sec_capacity));
+    ASSERT_GE(sec_capacity, GetPercent(100 << 20, 10) - 1);
+    ASSERT_LE(sec_capacity, GetPercent(100 << 20, 50));
+  }
+}
+
 TEST_P(CompressedSecCacheTestWithTiered, DynamicUpdateWithReservation) {
   CompressedSecondaryCache* sec_cache =
       static_cast<CompressedSecondaryCache*>(GetSecondaryCache());
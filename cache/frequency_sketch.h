@@ -0,0 +1,116 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "util/atomic.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Approximate count of the recent occurrences of well-mixed 64-bit hashes,
+// as used for TinyLFU-style cache admission, see
+// HyperClockCacheOptions::track_access_frequency. A count-min sketch with
+// kDepth rows of 4-bit saturating counters, sixteen to a word. All counters
+// are halved every `sample_size` additions, so that the estimates favor
+// recent occurrences. Thread-safe; an estimate racing with the halving may
+// see some counters halved and others not.
+class FrequencySketch {
+ public:
+  static constexpr uint32_t kMaxFrequency = 15;
+
+  // Sized for telling apart the frequencies of about `expected_entries`
+  // distinct hashes.
+  explicit FrequencySketch(size_t expected_entries)
+      : row_mask_(RowWords(expected_entries) - 1),
+        sample_size_(uint64_t{10} * RowWords(expected_entries) *
+                     kCountersPerWord),
+        words_(new RelaxedAtomic<uint64_t>[kDepth * (row_mask_ + 1)]) {}
+
+  // Returns true if this addition triggered halving all the counters.
+  bool Add(uint64_t hash) {
+    for (int row = 0; row < kDepth; row++) {
+      RelaxedAtomic<uint64_t>& word = Word(row, hash);
+      const int shift = Shift(row, hash);
+      uint64_t old_word = word.LoadRelaxed();
+      while (((old_word >> shift) & kCounterMask) < kMaxFrequency &&
+             !word.CasWeakRelaxed(old_word,
+                                  old_word + (uint64_t{1} << shift))) {
+      }
+    }
+    if (additions_.FetchAddRelaxed(1) + 1 == sample_size_) {
+      Halve();
+      return true;
+    }
+    return false;
+  }
+
+  uint32_t Estimate(uint64_t hash) const {
+    uint64_t min_count = kMaxFrequency;
+    for (int row = 0; row < kDepth; row++) {
+      const uint64_t count =
+          (Word(row, hash).LoadRelaxed() >> Shift(row, hash)) & kCounterMask;
+      min_count = count < min_count ? count : min_count;
+    }
+    return static_cast<uint32_t>(min_count);
+  }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) +
+           kDepth * (row_mask_ + 1) * sizeof(RelaxedAtomic<uint64_t>);
+  }
+
+ private:
+  static constexpr int kDepth = 4;
+  static constexpr int kCountersPerWord = 16;
+  static constexpr uint64_t kCounterMask = 0xf;
+
+  static size_t RowWords(size_t expected_entries) {
+    const size_t words = expected_entries / kCountersPerWord;
+    // Power of two, at least 16 words
+    return words <= 16 ? size_t{16} : size_t{1} << (FloorLog2(words - 1) + 1);
+  }
+
+  // Each row picks the word from the low bits and the counter in it from the
+  // top four bits of the upper half of its own multiple of the hash.
+  static uint64_t RowHash(int row, uint64_t hash) {
+    static constexpr uint64_t kRowSeeds[kDepth] = {
+        0x9e3779b97f4a7c15U, 0xc2b2ae3d27d4eb4fU, 0x165667b19e3779f9U,
+        0xd6e8feb86659fd93U};
+    return (hash * kRowSeeds[row]) >> 32;
+  }
+
+  RelaxedAtomic<uint64_t>& Word(int row, uint64_t hash) {
+    return words_[row * (row_mask_ + 1) + (RowHash(row, hash) & row_mask_)];
+  }
+  const RelaxedAtomic<uint64_t>& Word(int row, uint64_t hash) const {
+    return words_[row * (row_mask_ + 1) + (RowHash(row, hash) & row_mask_)];
+  }
+
+  static int Shift(int row, uint64_t hash) {
+    return static_cast<int>((RowHash(row, hash) >> 28) & 0xf) * 4;
+  }
+
+  void Halve() {
+    for (size_t i = 0; i < kDepth * (row_mask_ + 1); i++) {
+      uint64_t old_word = words_[i].LoadRelaxed();
+      while (!words_[i].CasWeakRelaxed(
+          old_word, (old_word >> 1) & 0x7777777777777777U)) {
+      }
+    }
+    additions_.StoreRelaxed(sample_size_ / 2);
+  }
+
+  const size_t row_mask_;
+  const uint64_t sample_size_;
+  RelaxedAtomic<uint64_t> additions_{};
+  std::unique_ptr<RelaxedAtomic<uint64_t>[]> words_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -19,6 +19,7 @@
 #include "monitoring/statistics_impl.h"
 #include "port/lang.h"
 #include "util/distributed_mutex.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace lru_cache {
@@ -119,7 +120,8 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              CacheMetadataChargePolicy metadata_charge_policy,
                              int max_upper_hash_bits,
                              MemoryAllocator* allocator,
-                             const Cache::EvictionCallback* eviction_callback)
+                             const Cache::EvictionCallback* eviction_callback,
+                             bool shared_lookups)
     : CacheShardBase(metadata_charge_policy),
       capacity_(0),
       high_pri_pool_usage_(0),
@@ -133,6 +135,7 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
       usage_(0),
       lru_usage_(0),
       mutex_(use_adaptive_mutex),
+      shared_lookups_(shared_lookups),
       eviction_callback_(*eviction_callback) {
   // Make empty circular linked list.
   lru_.next = &lru_;
@@ -145,7 +148,7 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
 void LRUCacheShard::EraseUnRefEntries() {
   autovector<LRUHandle*> last_reference_list;
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
     while (lru_.next != &lru_) {
       LRUHandle* old = lru_.next;
       // LRU list contains only elements which can be evicted.
@@ -153,6 +156,7 @@ void LRUCacheShard::EraseUnRefEntries() {
       LRU_Remove(old);
       table_.Remove(old->key(), old->hash);
       old->SetInCache(false);
+      RemoveFromRoleCharges(old);
       assert(usage_ >= old->total_charge);
       usage_ -= old->total_charge;
       last_reference_list.push_back(old);
@@ -172,7 +176,7 @@ void LRUCacheShard::ApplyToSomeEntries(
   // The state is essentially going to be the starting hash, which works
   // nicely even if we resize between calls because we use upper-most
   // hash bits for table indexes.
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   int length_bits = table_.GetLengthBits();
   size_t length = size_t{1} << length_bits;
 
@@ -202,14 +206,14 @@ void LRUCacheShard::ApplyToSomeEntries(
 
 void LRUCacheShard::TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
                                     LRUHandle** lru_bottom_pri) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   *lru = &lru_;
   *lru_low_pri = lru_low_pri_;
   *lru_bottom_pri = lru_bottom_pri_;
 }
 
 size_t LRUCacheShard::TEST_GetLRUSize() {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   LRUHandle* lru_handle = lru_.next;
   size_t lru_size = 0;
   while (lru_handle != &lru_) {
@@ -220,12 +224,12 @@ size_t LRUCacheShard::TEST_GetLRUSize() {
 }
 
 double LRUCacheShard::GetHighPriPoolRatio() {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return high_pri_pool_ratio_;
 }
 
 double LRUCacheShard::GetLowPriPoolRatio() {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return low_pri_pool_ratio_;
 }
 
@@ -329,6 +333,7 @@ void LRUCacheShard::EvictFromLRU(size_t charge,
     LRU_Remove(old);
     table_.Remove(old->key(), old->hash);
     old->SetInCache(false);
+    RemoveFromRoleCharges(old);
     assert(usage_ >= old->total_charge);
     usage_ -= old->total_charge;
     deleted->push_back(old);
@@ -354,7 +359,7 @@ void LRUCacheShard::NotifyEvicted(
 void LRUCacheShard::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
     capacity_ = capacity;
     high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
     low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
@@ -365,7 +370,7 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
 }
 
 void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   strict_capacity_limit_ = strict_capacity_limit;
 }
 
@@ -374,7 +379,7 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
   autovector<LRUHandle*> last_reference_list;
 
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
 
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty.
@@ -398,10 +403,12 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
       // capacity if not enough space was freed up.
       LRUHandle* old = table_.Insert(e);
       usage_ += e->total_charge;
+      AddToRoleCharges(e);
       if (old != nullptr) {
         s = Status::OkOverwritten();
         assert(old->InCache());
         old->SetInCache(false);
+        RemoveFromRoleCharges(old);
         if (!old->HasRefs()) {
           // old is on LRU because it's in cache and its reference count is 0.
           LRU_Remove(old);
@@ -432,7 +439,40 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
                                  Cache::CreateContext* /*create_context*/,
                                  Cache::Priority /*priority*/,
                                  Statistics* /*stats*/) {
-  DMutexLock l(mutex_);
+  if (shared_lookups_) {
+    ReadLock rl(&rw_mutex_);
+    LRUHandle* e = table_.Lookup(key, hash);
+    if (e == nullptr) {
+      return nullptr;
+    }
+    // Already off the LRU list and marked as hit, so only the reference
+    // count changes, which no other holder of the read lock can drop to 0
+    if (e->HasRefs() && e->HasHit()) {
+      e->Ref();
+      return e;
+    }
+  }
+  ExclusiveLock l(*this);
+  return LookupLocked(key, hash);
+}
+
+void LRUCacheShard::MultiLookup(const Slice* keys, const uint32_t* hashes,
+                                LRUHandle** results, size_t count) {
+  if (shared_lookups_) {
+    for (size_t i = 0; i < count; ++i) {
+      results[i] = Lookup(keys[i], hashes[i], /*helper=*/nullptr,
+                          /*create_context=*/nullptr, Cache::Priority::LOW,
+                          /*stats=*/nullptr);
+    }
+    return;
+  }
+  ExclusiveLock l(*this);
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = LookupLocked(keys[i], hashes[i]);
+  }
+}
+
+LRUHandle* LRUCacheShard::LookupLocked(const Slice& key, uint32_t hash) {
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->InCache());
@@ -448,7 +488,13 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
 }
 
 bool LRUCacheShard::Ref(LRUHandle* e) {
-  DMutexLock l(mutex_);
+  if (shared_lookups_) {
+    // No change of state, see UnrefIfNotLast()
+    assert(e->HasRefs());
+    e->Ref();
+    return true;
+  }
+  ExclusiveLock l(*this);
   // To create another reference - entry must be already externally referenced.
   assert(e->HasRefs());
   e->Ref();
@@ -456,14 +502,14 @@ bool LRUCacheShard::Ref(LRUHandle* e) {
 }
 
 void LRUCacheShard::SetHighPriorityPoolRatio(double high_pri_pool_ratio) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   high_pri_pool_ratio_ = high_pri_pool_ratio;
   high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
   MaintainPoolSize();
 }
 
 void LRUCacheShard::SetLowPriorityPoolRatio(double low_pri_pool_ratio) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   low_pri_pool_ratio_ = low_pri_pool_ratio;
   low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
   MaintainPoolSize();
@@ -474,10 +520,13 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
   if (e == nullptr) {
     return false;
   }
+  if (shared_lookups_ && e->UnrefIfNotLast()) {
+    return false;
+  }
   bool must_free;
   bool was_in_cache;
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
     must_free = e->Unref();
     was_in_cache = e->InCache();
     if (must_free && was_in_cache) {
@@ -488,6 +537,7 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
         // Take this opportunity and remove the item.
         table_.Remove(e->key(), e->hash);
         e->SetInCache(false);
+        RemoveFromRoleCharges(e);
       } else {
         // Put the item back on the LRU list, and don't free it.
         LRU_Insert(e);
@@ -537,7 +587,7 @@ LRUHandle* LRUCacheShard::CreateHandle(const Slice& key, uint32_t hash,
   e->helper = helper;
   e->key_length = key.size();
   e->hash = hash;
-  e->refs = 0;
+  e->refs.StoreRelaxed(0);
   e->next = e->prev = nullptr;
   memcpy(e->key_data, key.data(), key.size());
   e->CalcTotalCharge(charge, metadata_charge_policy_);
@@ -568,7 +618,7 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
   autovector<LRUHandle*> last_reference_list;
 
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
 
     EvictFromLRU(e->total_charge, &last_reference_list);
 
@@ -592,11 +642,12 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
     e = table_.Remove(key, hash);
     if (e != nullptr) {
       assert(e->InCache());
       e->SetInCache(false);
+      RemoveFromRoleCharges(e);
       if (!e->HasRefs()) {
         // The entry is in LRU since it's in hash and has no external references
         LRU_Remove(e);
@@ -615,31 +666,58 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
 }
 
 size_t LRUCacheShard::GetUsage() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return usage_;
 }
 
 size_t LRUCacheShard::GetPinnedUsage() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   assert(usage_ >= lru_usage_);
   return usage_ - lru_usage_;
 }
 
 size_t LRUCacheShard::GetOccupancyCount() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return table_.GetOccupancyCount();
 }
 
 size_t LRUCacheShard::GetTableAddressCount() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return size_t{1} << table_.GetLengthBits();
 }
 
+void LRUCacheShard::AddChargesByRole(
+    std::array<size_t, kNumCacheEntryRoles>* charges,
+    std::array<size_t, kNumCacheEntryRoles>* counts) const {
+  ExclusiveLock l(*this);
+  for (size_t i = 0; i < kNumCacheEntryRoles; ++i) {
+    (*charges)[i] += role_charges_[i];
+    (*counts)[i] += role_counts_[i];
+  }
+}
+
+void LRUCacheShard::AddToRoleCharges(const LRUHandle* e) {
+  size_t role_idx =
+      static_cast<size_t>(e->helper ? e->helper->role : CacheEntryRole::kMisc);
+  role_charges_[role_idx] += e->GetCharge(metadata_charge_policy_);
+  role_counts_[role_idx]++;
+}
+
+void LRUCacheShard::RemoveFromRoleCharges(const LRUHandle* e) {
+  size_t role_idx =
+      static_cast<size_t>(e->helper ? e->helper->role : CacheEntryRole::kMisc);
+  size_t charge = e->GetCharge(metadata_charge_policy_);
+  assert(role_charges_[role_idx] >= charge);
+  assert(role_counts_[role_idx] > 0);
+  role_charges_[role_idx] -= charge;
+  role_counts_[role_idx]--;
+}
+
 void LRUCacheShard::AppendPrintableOptions(std::string& str) const {
   const int kBufferSize = 200;
   char buffer[kBufferSize];
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
     snprintf(buffer, kBufferSize, "    high_pri_pool_ratio: %.3lf\n",
              high_pri_pool_ratio_);
     snprintf(buffer + strlen(buffer), kBufferSize - strlen(buffer),
@@ -656,7 +734,7 @@ LRUCache::LRUCache(const LRUCacheOptions& opts) : ShardedCache(opts) {
                            opts.high_pri_pool_ratio, opts.low_pri_pool_ratio,
                            opts.use_adaptive_mutex, opts.metadata_charge_policy,
                            /* max_upper_hash_bits */ 32 - opts.num_shard_bits,
-                           alloc, &eviction_callback_);
+                           alloc, &eviction_callback_, opts.shared_lookups);
   });
 }
 
@@ -718,6 +796,11 @@ std::shared_ptr<Cache> LRUCacheOptions::MakeSharedCache() const {
   if (opts.num_shard_bits < 0) {
     opts.num_shard_bits = GetDefaultCacheShardBits(capacity);
   }
+  if (opts.numa_aware) {
+    // A group of shards per NUMA node
+    opts.num_shard_bits =
+        std::min(opts.num_shard_bits + GetNumaShardGroupBits(), 19);
+  }
   std::shared_ptr<Cache> cache = std::make_shared<LRUCache>(opts);
   if (secondary_cache) {
     cache = std::make_shared<CacheWithSecondaryAdapter>(cache, secondary_cache);
@@ -8,7 +8,9 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <array>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "cache/sharded_cache.h"
@@ -16,6 +18,7 @@
 #include "port/likely.h"
 #include "port/malloc.h"
 #include "port/port.h"
+#include "util/atomic.h"
 #include "util/autovector.h"
 #include "util/distributed_mutex.h"
 
@@ -58,7 +61,9 @@ struct LRUHandle : public Cache::Handle {
   // The hash of key(). Used for fast sharding and comparisons.
   uint32_t hash;
   // The number of external refs to this entry. The cache itself is not counted.
-  uint32_t refs;
+  // Modified under the shard mutex, except as noted for
+  // LRUCacheOptions::shared_lookups.
+  AcqRelAtomic<uint32_t> refs;
 
   // Mutable flags - access controlled by mutex
   // The m_ and M_ prefixes (and im_ and IM_ later) are to hopefully avoid
@@ -96,17 +101,29 @@ struct LRUHandle : public Cache::Handle {
   uint32_t GetHash() const { return hash; }
 
   // Increase the reference count by 1.
-  void Ref() { refs++; }
+  void Ref() { refs.FetchAddRelaxed(1); }
 
   // Just reduce the reference count by 1. Return true if it was last reference.
   bool Unref() {
-    assert(refs > 0);
-    refs--;
-    return refs == 0;
+    assert(refs.LoadRelaxed() > 0);
+    return refs.FetchSub(1) == 1;
+  }
+
+  // Reduce the reference count by 1 unless it is the last reference, which
+  // is then left alone. Safe without the shard mutex, as it never changes
+  // the state of the entry.
+  bool UnrefIfNotLast() {
+    uint32_t old_refs = refs.Load();
+    while (old_refs > 1) {
+      if (refs.CasWeak(old_refs, old_refs - 1)) {
+        return true;
+      }
+    }
+    return false;
   }
 
   // Return true if there are external refs, false otherwise.
-  bool HasRefs() const { return refs > 0; }
+  bool HasRefs() const { return refs.LoadRelaxed() > 0; }
 
   bool InCache() const { return m_flags & M_IN_CACHE; }
   bool IsHighPri() const { return im_flags & IM_IS_HIGH_PRI; }
@@ -164,7 +181,7 @@ struct LRUHandle : public Cache::Handle {
   }
 
   void Free(MemoryAllocator* allocator) {
-    assert(refs == 0);
+    assert(refs.LoadRelaxed() == 0);
     assert(helper);
     if (helper->del_cb) {
       helper->del_cb(value, allocator);
@@ -271,7 +288,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                 bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits, MemoryAllocator* allocator,
-                const Cache::EvictionCallback* eviction_callback);
+                const Cache::EvictionCallback* eviction_callback,
+                bool shared_lookups = false);
 
  public:  // Type definitions expected as parameter to ShardedCache
   using HandleImpl = LRUHandle;
@@ -283,6 +301,14 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
     return Lower32of64(GetSliceNPHash64(key, seed));
   }
 
+  // Entries are identified by key, so sharding bits can be overwritten
+  static constexpr bool kSupportsShardGroups = true;
+  static inline HashVal WithShardGroup(HashCref hash, int shift, int bits,
+                                       uint32_t group) {
+    const uint32_t mask = ((uint32_t{1} << bits) - 1) << shift;
+    return (hash & ~mask) | ((group << shift) & mask);
+  }
+
   // Separate from constructor so caller can easily make an array of LRUCache
   // if current usage is more than new capacity, the function will attempt to
   // free the needed space.
@@ -312,6 +338,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                     Cache::CreateContext* create_context,
                     Cache::Priority priority, Statistics* stats);
 
+  // Holds mutex_ once for all the keys
+  void MultiLookup(const Slice* keys, const uint32_t* hashes,
+                   LRUHandle** results, size_t count);
+
   bool Release(LRUHandle* handle, bool useful, bool erase_if_last_ref);
   bool Ref(LRUHandle* handle);
   void Erase(const Slice& key, uint32_t hash);
@@ -325,6 +355,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   size_t GetOccupancyCount() const;
   size_t GetTableAddressCount() const;
 
+  void AddChargesByRole(std::array<size_t, kNumCacheEntryRoles>* charges,
+                        std::array<size_t, kNumCacheEntryRoles>* counts) const;
+
   void ApplyToSomeEntries(
       const std::function<void(const Slice& key, Cache::ObjectPtr value,
                                size_t charge,
@@ -359,6 +392,34 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
 
+  // Lookup() while holding mutex_
+  LRUHandle* LookupLocked(const Slice& key, uint32_t hash);
+
+  // Exclusive lock on the shard, which is the write side of rw_mutex_ with
+  // shared_lookups_ and mutex_ otherwise
+  class ExclusiveLock {
+   public:
+    explicit ExclusiveLock(const LRUCacheShard& shard)
+        : rw_mutex_(shard.shared_lookups_ ? &shard.rw_mutex_ : nullptr) {
+      if (rw_mutex_ != nullptr) {
+        rw_mutex_->WriteLock();
+      } else {
+        mutex_lock_.emplace(shard.mutex_);
+      }
+    }
+    ~ExclusiveLock() {
+      if (rw_mutex_ != nullptr) {
+        rw_mutex_->WriteUnlock();
+      }
+    }
+    ExclusiveLock(const ExclusiveLock&) = delete;
+    ExclusiveLock& operator=(const ExclusiveLock&) = delete;
+
+   private:
+    port::RWMutex* const rw_mutex_;
+    std::optional<DMutexLock> mutex_lock_;
+  };
+
   // Overflow the last entry in high-pri pool to low-pri pool until size of
   // high-pri pool is no larger than the size specify by high_pri_pool_pct.
   void MaintainPoolSize();
@@ -371,6 +432,11 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   void NotifyEvicted(const autovector<LRUHandle*>& evicted_handles);
 
+  // Maintain role_charges_ and role_counts_ as `e` enters or leaves the
+  // table. Must be called while holding the mutex_.
+  void AddToRoleCharges(const LRUHandle* e);
+  void RemoveFromRoleCharges(const LRUHandle* e);
+
   LRUHandle* CreateHandle(const Slice& key, uint32_t hash,
                           Cache::ObjectPtr value,
                           const Cache::CacheItemHelper* helper, size_t charge);
@@ -431,11 +497,19 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Memory size for entries residing only in the LRU list.
   size_t lru_usage_;
 
+  // Charge and number of the entries in the table, by CacheEntryRole.
+  std::array<size_t, kNumCacheEntryRoles> role_charges_{};
+  std::array<size_t, kNumCacheEntryRoles> role_counts_{};
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
   mutable DMutex mutex_;
 
+  // Used instead of mutex_ with shared_lookups_, see ExclusiveLock
+  mutable port::RWMutex rw_mutex_;
+  const bool shared_lookups_;
+
   // A reference to Cache::eviction_callback_
   const Cache::EvictionCallback& eviction_callback_;
 };
@@ -393,11 +393,15 @@ class ClockCacheTest : public testing::Test {
   }
 
   void NewShard(size_t capacity, bool strict_capacity_limit = true,
-                int eviction_effort_cap = 30) {
+                int eviction_effort_cap = 30,
+                uint32_t min_admission_frequency = 0) {
     DeleteShard();
     shard_ = static_cast<Shard*>(port::cacheline_aligned_alloc(sizeof(Shard)));
 
     TableOpts opts{1 /*value_size*/, eviction_effort_cap};
+    opts.track_access_frequency = true;
+    opts.min_admission_frequency = min_admission_frequency;
+    opts.estimated_entry_charge = 1;
     new (shard_)
         Shard(capacity, strict_capacity_limit, kDontChargeCacheMetadata,
               /*allocator*/ nullptr, &eviction_callback_, &hash_seed_, opts);
@@ -1024,6 +1028,44 @@ TYPED_TEST(ClockCacheTest, TableSizesTest) {
   }
 }
 
+TYPED_TEST(ClockCacheTest, AccessFrequencyAdmissionTest) {
+  this->NewShard(3, /*strict_capacity_limit=*/false, 30,
+                 /*min_admission_frequency=*/2);
+  auto& shard = *this->shard_;
+  auto hkey = [this](int i) { return this->CheapHash(i); };
+
+  // Admitted regardless of frequency while there is room
+  for (int i = 0; i < 3; i++) {
+    ASSERT_OK(this->Insert(hkey(i)));
+  }
+  ASSERT_EQ(shard.GetUsage(), 3U);
+  ASSERT_TRUE(this->Lookup(hkey(0)));
+  ASSERT_TRUE(this->Lookup(hkey(0)));
+  ASSERT_GE(shard.GetAccessFrequency(hkey(0)), 2U);
+
+  // Cache full and key 3 never looked up: silently not admitted
+  ASSERT_EQ(shard.GetAccessFrequency(hkey(3)), 0U);
+  ASSERT_OK(this->Insert(hkey(3)));
+  ASSERT_EQ(shard.GetUsage(), 3U);
+  ASSERT_FALSE(this->Lookup(hkey(3)));
+
+  // Also with a handle, which is then standalone
+  typename TypeParam::Shard::HandleImpl* h = nullptr;
+  ASSERT_OK(shard.Insert(this->TestKey(hkey(4)), hkey(4), nullptr /*value*/,
+                         &kNoopCacheItemHelper, 1 /*charge*/, &h,
+                         Cache::Priority::LOW));
+  ASSERT_NE(h, nullptr);
+  shard.Release(h, /*useful*/ true, /*erase_if_last_ref*/ false);
+  ASSERT_EQ(shard.GetUsage(), 3U);
+
+  // Second miss on key 3 reaches the admission frequency
+  ASSERT_EQ(shard.GetAccessFrequency(hkey(3)), 1U);
+  ASSERT_FALSE(this->Lookup(hkey(3)));
+  ASSERT_OK(this->Insert(hkey(3)));
+  ASSERT_TRUE(this->Lookup(hkey(3)));
+  ASSERT_GE(shard.GetAccessFrequency(hkey(3)), 3U);
+}
+
 }  // namespace clock_cache
 
 class TestSecondaryCache : public SecondaryCache {
@@ -2413,6 +2455,122 @@ TEST_P(DBSecondaryCacheTest, LRUCacheDumpLoadWithFilter) {
 }
 
 // Test the option not to use the secondary cache in a certain DB.
+TEST_P(DBSecondaryCacheTest, LRUCacheDumpHotEntries) {
+  std::shared_ptr<Cache> cache =
+      NewCache(1024 * 1024 /* capacity */, 0 /* num_shard_bits */,
+               false /* strict_capacity_limit */);
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = cache;
+  table_options.block_size = 4 * 1024;
+  table_options.cache_index_and_filter_blocks = true;
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.env = fault_env_.get();
+  DestroyAndReopen(options);
+  fault_fs_->SetFailGetUniqueId(true);
+
+  const int N = 256;
+  std::string value(1000, 'a');
+  for (int i = 0; i < N; i++) {
+    ASSERT_OK(Put(Key(i), value));
+  }
+  ASSERT_OK(Flush());
+
+  // Trace the reads, the last quarter of the keys being the hottest
+  std::string trace_path = db_->GetName() + "/block_cache_trace";
+  std::unique_ptr<TraceWriter> trace_writer;
+  ASSERT_OK(
+      NewFileTraceWriter(env_, EnvOptions(), trace_path, &trace_writer));
+  ASSERT_OK(db_->StartBlockCacheTrace(TraceOptions(), std::move(trace_writer)));
+  for (int i = 0; i < N; i++) {
+    ASSERT_EQ(value, Get(Key(i)));
+  }
+  for (int round = 0; round < 3; round++) {
+    for (int i = N * 3 / 4; i < N; i++) {
+      ASSERT_EQ(value, Get(Key(i)));
+    }
+  }
+  ASSERT_OK(db_->EndBlockCacheTrace());
+  auto access_counts = std::make_shared<CacheEntryAccessCounts>();
+  ASSERT_OK(CountCacheEntryAccesses(env_, trace_path, access_counts.get()));
+  auto count_of = [&](const std::string& key) -> uint64_t {
+    auto it = access_counts->find(key);
+    return it == access_counts->end() ? 0 : it->second;
+  };
+
+  size_t num_entries = 0;
+  cache->ApplyToAllEntries(
+      [&](const Slice& /*key*/, Cache::ObjectPtr /*value*/, size_t /*charge*/,
+          const Cache::CacheItemHelper* helper) {
+        if (helper != nullptr &&
+            (helper->role == CacheEntryRole::kDataBlock ||
+             helper->role == CacheEntryRole::kIndexBlock)) {
+          num_entries++;
+        }
+      },
+      {});
+
+  CacheDumpOptions cd_options;
+  cd_options.clock = fault_env_->GetSystemClock().get();
+  cd_options.hot_entries_ratio = 0.25;
+  std::string dump_path = db_->GetName() + "/cache_dump";
+  std::unique_ptr<CacheDumpWriter> dump_writer;
+  ASSERT_OK(NewToFileCacheDumpWriter(fault_fs_, FileOptions(), dump_path,
+                                     &dump_writer));
+  std::unique_ptr<CacheDumper> cache_dumper;
+  ASSERT_OK(NewDefaultCacheDumper(cd_options, cache, std::move(dump_writer),
+                                  &cache_dumper));
+  ASSERT_OK(cache_dumper->SetDumpFilter({db_}));
+  // The access counts are required
+  ASSERT_TRUE(cache_dumper->DumpCacheEntriesToWriter().IsInvalidArgument());
+
+  cd_options.access_counts = access_counts;
+  ASSERT_OK(NewToFileCacheDumpWriter(fault_fs_, FileOptions(), dump_path,
+                                     &dump_writer));
+  ASSERT_OK(NewDefaultCacheDumper(cd_options, cache, std::move(dump_writer),
+                                  &cache_dumper));
+  ASSERT_OK(cache_dumper->SetDumpFilter({db_}));
+  ASSERT_OK(cache_dumper->DumpCacheEntriesToWriter());
+  cache_dumper.reset();
+
+  std::unique_ptr<CacheDumpReader> dump_reader;
+  ASSERT_OK(NewFromFileCacheDumpReader(fault_fs_, FileOptions(), dump_path,
+                                       &dump_reader));
+  CacheDumpedLoaderImpl loader(cd_options, table_options,
+                               /*secondary_cache=*/nullptr,
+                               std::move(dump_reader));
+  std::vector<std::pair<std::string, CacheEntryRole>> restored;
+  ASSERT_OK(loader.RestoreCacheEntries(
+      [&](const Slice& key, CacheEntryRole role, const Slice& /*saved*/) {
+        restored.emplace_back(key.ToString(), role);
+        return Status::OK();
+      }));
+
+  // Only the most accessed quarter of the entries is dumped, the index block
+  // first.
+  ASSERT_EQ((num_entries + 3) / 4, restored.size());
+  ASSERT_EQ(CacheEntryRole::kIndexBlock, restored[0].second);
+  std::set<std::string> dumped;
+  uint64_t min_dumped_count = std::numeric_limits<uint64_t>::max();
+  for (const auto& key_and_role : restored) {
+    dumped.insert(key_and_role.first);
+    min_dumped_count = std::min(min_dumped_count, count_of(key_and_role.first));
+  }
+  cache->ApplyToAllEntries(
+      [&](const Slice& key, Cache::ObjectPtr /*value*/, size_t /*charge*/,
+          const Cache::CacheItemHelper* helper) {
+        if (helper != nullptr && helper->role == CacheEntryRole::kDataBlock &&
+            dumped.count(key.ToString()) == 0) {
+          ASSERT_LE(count_of(key.ToString()), min_dumped_count);
+        }
+      },
+      {});
+
+  fault_fs_->SetFailGetUniqueId(false);
+  Destroy(options);
+}
+
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheOptionBasic) {
   std::shared_ptr<TestSecondaryCache> secondary_cache(
       new TestSecondaryCache(2048 * 1024));
@@ -5,10 +5,12 @@
 
 #include "cache/secondary_cache_adapter.h"
 
+#include <algorithm>
 #include <atomic>
 
 #include "cache/tiered_secondary_cache.h"
 #include "monitoring/perf_context_imp.h"
+#include "rocksdb/system_clock.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 
@@ -306,17 +308,86 @@ Cache::Handle* CacheWithSecondaryAdapter::Lookup(const Slice& key,
     // Try our secondary cache
     bool kept_in_sec_cache = false;
     std::unique_ptr<SecondaryCacheResultHandle> secondary_handle =
-        secondary_cache_->Lookup(key, helper, create_context, /*wait*/ true,
-                                 found_dummy_entry, stats,
-                                 /*out*/ kept_in_sec_cache);
+        LookupMySecondary(key, helper, create_context, /*wait*/ true,
+                          found_dummy_entry, stats,
+                          /*out*/ kept_in_sec_cache);
     if (secondary_handle) {
       result = Promote(std::move(secondary_handle), key, helper, priority,
                        stats, found_dummy_entry, kept_in_sec_cache);
     }
+    RecordTieredLookup(/*miss=*/result == nullptr);
+  } else if (secondary_compatible) {
+    RecordTieredLookup(/*miss=*/false);
   }
   return result;
 }
 
+std::unique_ptr<SecondaryCacheResultHandle>
+CacheWithSecondaryAdapter::LookupMySecondary(
+    const Slice& key, const CacheItemHelper* helper,
+    CreateContext* create_context, bool wait, bool advise_erase,
+    Statistics* stats, bool& kept_in_sec_cache) {
+  if (adaptive_window_ == 0) {
+    return secondary_cache_->Lookup(key, helper, create_context, wait,
+                                    advise_erase, stats, kept_in_sec_cache);
+  }
+  SystemClock* clock = SystemClock::Default().get();
+  const uint64_t start = clock->NowNanos();
+  std::unique_ptr<SecondaryCacheResultHandle> secondary_handle =
+      secondary_cache_->Lookup(key, helper, create_context, wait,
+                               advise_erase, stats, kept_in_sec_cache);
+  window_sec_nanos_.FetchAddRelaxed(clock->NowNanos() - start);
+  return secondary_handle;
+}
+
+void CacheWithSecondaryAdapter::RecordTieredLookup(bool miss) {
+  if (adaptive_window_ == 0) {
+    return;
+  }
+  if (miss) {
+    window_misses_.FetchAddRelaxed(1);
+  }
+  if (window_lookups_.FetchAddRelaxed(1) + 1 == adaptive_window_) {
+    AdaptRatio();
+  }
+}
+
+// Hill climbing on the estimated cost per lookup, which takes one step on
+// the ratio per window. A window costing more than the one before it
+// reverses the direction of the steps, as does reaching a bound.
+void CacheWithSecondaryAdapter::AdaptRatio() {
+  MutexLock l(&adapt_mutex_);
+  const uint64_t lookups = window_lookups_.ExchangeRelaxed(0);
+  const uint64_t misses = window_misses_.ExchangeRelaxed(0);
+  const uint64_t sec_nanos = window_sec_nanos_.ExchangeRelaxed(0);
+  if (lookups == 0) {
+    return;
+  }
+  const double cost = (static_cast<double>(sec_nanos) +
+                       static_cast<double>(misses) * miss_cost_nanos_) /
+                      static_cast<double>(lookups);
+  if (last_window_cost_ >= 0.0 && cost > last_window_cost_) {
+    growing_secondary_ = !growing_secondary_;
+  }
+  last_window_cost_ = cost;
+
+  double ratio;
+  {
+    MutexLock m(&cache_res_mutex_);
+    ratio = sec_cache_res_ratio_;
+  }
+  const double step = growing_secondary_ ? adaptive_step_ : -adaptive_step_;
+  const double new_ratio =
+      std::min(max_ratio_, std::max(min_ratio_, ratio + step));
+  if (new_ratio == ratio) {
+    growing_secondary_ = !growing_secondary_;
+    return;
+  }
+  Status s = UpdateCacheReservationRatio(new_ratio);
+  assert(s.ok());
+  s.PermitUncheckedError();
+}
+
 bool CacheWithSecondaryAdapter::Release(Handle* handle,
                                         bool erase_if_last_ref) {
   if (erase_if_last_ref) {
@@ -362,7 +433,7 @@ void CacheWithSecondaryAdapter::StartAsyncLookupOnMySecondary(
   assert(async_handle.result_handle == nullptr);
 
   std::unique_ptr<SecondaryCacheResultHandle> secondary_handle =
-      secondary_cache_->Lookup(
+      LookupMySecondary(
           async_handle.key, async_handle.helper, async_handle.create_context,
           /*wait*/ false, async_handle.found_dummy_entry, async_handle.stats,
           /*out*/ async_handle.kept_in_sec_cache);
@@ -370,12 +441,27 @@ void CacheWithSecondaryAdapter::StartAsyncLookupOnMySecondary(
     // TODO with stacked secondaries: Check & process if already ready?
     async_handle.pending_handle = secondary_handle.release();
     async_handle.pending_cache = secondary_cache_.get();
+  } else {
+    RecordTieredLookup(/*miss=*/true);
   }
 }
 
 void CacheWithSecondaryAdapter::StartAsyncLookup(
     AsyncLookupHandle& async_handle) {
   target_->StartAsyncLookup(async_handle);
+  ContinueAsyncLookup(async_handle);
+}
+
+void CacheWithSecondaryAdapter::MultiLookup(AsyncLookupHandle* async_handles,
+                                            size_t count) {
+  target_->MultiLookup(async_handles, count);
+  for (size_t i = 0; i < count; ++i) {
+    ContinueAsyncLookup(async_handles[i]);
+  }
+}
+
+void CacheWithSecondaryAdapter::ContinueAsyncLookup(
+    AsyncLookupHandle& async_handle) {
   if (!async_handle.IsPending()) {
     bool secondary_compatible =
         async_handle.helper &&
@@ -386,6 +472,8 @@ void CacheWithSecondaryAdapter::StartAsyncLookup(
     if (async_handle.Result() == nullptr && secondary_compatible) {
       // Not found and not pending on another secondary cache
       StartAsyncLookupOnMySecondary(async_handle);
+    } else if (secondary_compatible) {
+      RecordTieredLookup(/*miss=*/false);
     }
   }
 }
@@ -463,6 +551,7 @@ void CacheWithSecondaryAdapter::WaitAll(AsyncLookupHandle* async_handles,
     cur->result_handle = Promote(
         std::move(secondary_handle), cur->key, cur->helper, cur->priority,
         cur->stats, cur->found_dummy_entry, cur->kept_in_sec_cache);
+    RecordTieredLookup(/*miss=*/cur->result_handle == nullptr);
     assert(cur->pending_cache == nullptr);
   }
 }
@@ -549,6 +638,14 @@ Status CacheWithSecondaryAdapter::GetSecondaryCacheCapacity(
   return secondary_cache_->GetCapacity(size);
 }
 
+Status CacheWithSecondaryAdapter::InsertIntoSecondaryCache(
+    const Slice& key, ObjectPtr value, const CacheItemHelper* helper) {
+  if (helper == nullptr || !helper->IsSecondaryCacheCompatible()) {
+    return Status::InvalidArgument("Not secondary cache compatible");
+  }
+  return secondary_cache_->Insert(key, value, helper, /*force_insert=*/true);
+}
+
 Status CacheWithSecondaryAdapter::GetSecondaryCachePinnedUsage(
     size_t& size) const {
   Status s;
@@ -652,6 +749,16 @@ Status CacheWithSecondaryAdapter::UpdateAdmissionPolicy(
   return Status::OK();
 }
 
+void CacheWithSecondaryAdapter::SetAdaptiveRatio(
+    const TieredCacheOptions& opts) {
+  assert(distribute_cache_res_);
+  adaptive_step_ = opts.adaptive_ratio_step;
+  min_ratio_ = opts.min_compressed_secondary_ratio;
+  max_ratio_ = opts.max_compressed_secondary_ratio;
+  miss_cost_nanos_ = opts.miss_cost_nanos;
+  adaptive_window_ = opts.adaptive_ratio_window;
+}
+
 std::shared_ptr<Cache> NewTieredCache(const TieredCacheOptions& _opts) {
   if (!_opts.cache_opts) {
     return nullptr;
@@ -691,6 +798,16 @@ std::shared_ptr<Cache> NewTieredCache(const TieredCacheOptions& _opts) {
       return nullptr;
     }
   }
+  if (opts.adaptive_ratio_window > 0 &&
+      !(opts.adaptive_ratio_step > 0.0 &&
+        opts.min_compressed_secondary_ratio > 0.0 &&
+        opts.min_compressed_secondary_ratio <=
+            opts.compressed_secondary_ratio &&
+        opts.compressed_secondary_ratio <=
+            opts.max_compressed_secondary_ratio &&
+        opts.max_compressed_secondary_ratio <= 1.0)) {
+    return nullptr;
+  }
 
   std::shared_ptr<Cache> cache;
   if (opts.cache_type == PrimaryCacheType::kCacheTypeLRU) {
@@ -725,8 +842,12 @@ std::shared_ptr<Cache> NewTieredCache(const TieredCacheOptions& _opts) {
     }
   }
 
-  return std::make_shared<CacheWithSecondaryAdapter>(
+  auto tiered_cache = std::make_shared<CacheWithSecondaryAdapter>(
       cache, sec_cache, opts.adm_policy, /*distribute_cache_res=*/true);
+  if (opts.adaptive_ratio_window > 0) {
+    tiered_cache->SetAdaptiveRatio(opts);
+  }
+  return tiered_cache;
 }
 
 Status UpdateTieredCache(const std::shared_ptr<Cache>& cache,
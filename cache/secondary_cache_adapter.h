@@ -7,6 +7,7 @@
 
 #include "cache/cache_reservation_manager.h"
 #include "rocksdb/secondary_cache.h"
+#include "util/atomic.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -39,6 +40,8 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
 
   void StartAsyncLookup(AsyncLookupHandle& async_handle) override;
 
+  void MultiLookup(AsyncLookupHandle* async_handles, size_t count) override;
+
   void WaitAll(AsyncLookupHandle* async_handles, size_t count) override;
 
   std::string GetPrintableOptions() const override;
@@ -51,10 +54,17 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
 
   Status GetSecondaryCachePinnedUsage(size_t& size) const override;
 
+  Status InsertIntoSecondaryCache(const Slice& key, ObjectPtr value,
+                                  const CacheItemHelper* helper) override;
+
   Status UpdateCacheReservationRatio(double ratio);
 
   Status UpdateAdmissionPolicy(TieredAdmissionPolicy adm_policy);
 
+  // Start adapting the secondary/primary allocation ratio as described for
+  // TieredCacheOptions::adaptive_ratio_window
+  void SetAdaptiveRatio(const TieredCacheOptions& opts);
+
   Cache* TEST_GetCache() { return target_.get(); }
 
   SecondaryCache* TEST_GetSecondaryCache() { return secondary_cache_.get(); }
@@ -66,6 +76,9 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
 
   void StartAsyncLookupOnMySecondary(AsyncLookupHandle& async_handle);
 
+  // The rest of StartAsyncLookup() after the lookup in target_
+  void ContinueAsyncLookup(AsyncLookupHandle& async_handle);
+
   Handle* Promote(
       std::unique_ptr<SecondaryCacheResultHandle>&& secondary_handle,
       const Slice& key, const CacheItemHelper* helper, Priority priority,
@@ -75,6 +88,17 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
 
   void CleanupCacheObject(ObjectPtr obj, const CacheItemHelper* helper);
 
+  // Looks up secondary_cache_, timing it for the adaptive ratio
+  std::unique_ptr<SecondaryCacheResultHandle> LookupMySecondary(
+      const Slice& key, const CacheItemHelper* helper,
+      CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache);
+
+  // Accounts for a finished lookup of a secondary cache compatible entry
+  void RecordTieredLookup(bool miss);
+
+  void AdaptRatio();
+
   std::shared_ptr<SecondaryCache> secondary_cache_;
   TieredAdmissionPolicy adm_policy_;
   // Whether to proportionally distribute cache memory reservations, i.e
@@ -98,6 +122,21 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
   // Amount of memory reserved in the secondary cache. This should be
   // reserved_usage_ * sec_cache_res_ratio_ in steady state.
   size_t sec_reserved_;
+
+  // Adaptive ratio settings, disabled with a zero window
+  uint64_t adaptive_window_ = 0;
+  double adaptive_step_ = 0.0;
+  double min_ratio_ = 0.0;
+  double max_ratio_ = 0.0;
+  uint64_t miss_cost_nanos_ = 0;
+  // Accounting for the current window
+  RelaxedAtomic<uint64_t> window_lookups_{};
+  RelaxedAtomic<uint64_t> window_misses_{};
+  RelaxedAtomic<uint64_t> window_sec_nanos_{};
+  // Protects the hill climbing state below
+  port::Mutex adapt_mutex_;
+  double last_window_cost_ = -1.0;
+  bool growing_secondary_ = true;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -9,6 +9,11 @@
 
 #include "cache/sharded_cache.h"
 
+#ifdef NUMA
+#include <numa.h>
+#include <sched.h>
+#endif
+
 #include <algorithm>
 #include <cstdint>
 #include <memory>
@@ -57,13 +62,19 @@ uint32_t DetermineSeed(int32_t hash_seed_option) {
 }
 }  // namespace
 
-ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts)
+ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts,
+                                   bool numa_aware)
     : Cache(opts.memory_allocator),
       last_id_(1),
       shard_mask_((uint32_t{1} << opts.num_shard_bits) - 1),
       hash_seed_(DetermineSeed(opts.hash_seed)),
+      numa_node_bits_(
+          numa_aware ? std::min(GetNumaShardGroupBits(), opts.num_shard_bits)
+                     : 0),
       strict_capacity_limit_(opts.strict_capacity_limit),
-      capacity_(opts.capacity) {}
+      capacity_(opts.capacity),
+      admission_policy_(opts.admission_policy),
+      per_shard_capacity_(ComputePerShardCapacity(opts.capacity)) {}
 
 size_t ShardedCacheBase::ComputePerShardCapacity(size_t capacity) const {
   uint32_t num_shards = GetNumShards();
@@ -74,6 +85,36 @@ size_t ShardedCacheBase::GetPerShardCapacity() const {
   return ComputePerShardCapacity(GetCapacity());
 }
 
+uint32_t ShardedCacheBase::GetCurrentShardGroup() const {
+#ifdef NUMA
+  int cpu = sched_getcpu();
+  int node = cpu < 0 ? 0 : numa_node_of_cpu(cpu);
+  if (node > 0) {
+    return static_cast<uint32_t>(node) &
+           ((uint32_t{1} << numa_node_bits_) - 1);
+  }
+#endif
+  return 0;
+}
+
+void ShardedCacheBase::SetPreferredShardGroup(uint32_t group) const {
+#ifdef NUMA
+  if (numa_node_bits_ > 0) {
+    numa_set_preferred(static_cast<int>(group));
+  }
+#else
+  (void)group;
+#endif
+}
+
+void ShardedCacheBase::ResetPreferredShardGroup() const {
+#ifdef NUMA
+  if (numa_node_bits_ > 0) {
+    numa_set_localalloc();
+  }
+#endif
+}
+
 uint64_t ShardedCacheBase::NewId() {
   return last_id_.fetch_add(1, std::memory_order_relaxed);
 }
@@ -122,6 +163,9 @@ std::string ShardedCacheBase::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    memory_allocator : %s\n",
            memory_allocator() ? memory_allocator()->Name() : "None");
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    admission_policy : %s\n",
+           admission_policy_ ? admission_policy_->Name() : "None");
+  ret.append(buffer);
   AppendPrintableOptions(ret);
   return ret;
 }
@@ -138,6 +182,15 @@ int GetDefaultCacheShardBits(size_t capacity, size_t min_shard_size) {
   return num_shard_bits;
 }
 
+int GetNumaShardGroupBits() {
+#ifdef NUMA
+  if (numa_available() >= 0 && numa_max_node() > 0) {
+    return FloorLog2(numa_max_node()) + 1;
+  }
+#endif
+  return 0;
+}
+
 int ShardedCacheBase::GetNumShardBits() const {
   return BitsSetToOne(shard_mask_);
 }
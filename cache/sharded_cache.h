@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <string>
@@ -16,6 +18,7 @@
 #include "port/lang.h"
 #include "port/port.h"
 #include "rocksdb/advanced_cache.h"
+#include "util/atomic.h"
 #include "util/hash.h"
 #include "util/mutexlock.h"
 
@@ -40,6 +43,13 @@ class CacheShardBase {
   static inline uint32_t HashPieceForSharding(HashCref hash) {
     return Lower32of64(hash);
   }
+  // For ShardedCacheOptions::numa_aware, whether the sharding bits of the
+  // hash may be overwritten, with a
+  //   static HashVal WithShardGroup(HashCref hash, int shift, int bits,
+  //                                 uint32_t group)
+  // setting `bits` bits of HashPieceForSharding() from `shift` up to
+  // `group`. Only for shards that do not identify entries by hash alone.
+  static constexpr bool kSupportsShardGroups = false;
   void AppendPrintableOptions(std::string& /*str*/) const {}
 
   // Must be provided for concept CacheShard (TODO with C++20 support)
@@ -61,6 +71,9 @@ class CacheShardBase {
                         Cache::CreateContext* create_context,
                         Cache::Priority priority,
                         Statistics* stats) = 0;
+  // Lookup() of `count` keys, all of this shard, into `results`
+  void MultiLookup(const Slice* keys, const HashVal* hashes,
+                   HandleImpl** results, size_t count) = 0;
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref) = 0;
   bool Ref(HandleImpl* handle) = 0;
   void Erase(const Slice& key, HashCref hash) = 0;
@@ -70,6 +83,9 @@ class CacheShardBase {
   size_t GetPinnedUsage() const = 0;
   size_t GetOccupancyCount() const = 0;
   size_t GetTableAddressCount() const = 0;
+  // Adds the charge and count of the entries in the shard by CacheEntryRole
+  void AddChargesByRole(std::array<size_t, kNumCacheEntryRoles>* charges,
+                        std::array<size_t, kNumCacheEntryRoles>* counts) const;
   // Handles iterating over roughly `average_entries_per_lock` entries, using
   // `state` to somehow record where it last ended up. Caller initially uses
   // *state == 0 and implementation sets *state = SIZE_MAX to indicate
@@ -89,7 +105,7 @@ class CacheShardBase {
 // Portions of ShardedCache that do not depend on the template parameter
 class ShardedCacheBase : public Cache {
  public:
-  explicit ShardedCacheBase(const ShardedCacheOptions& opts);
+  ShardedCacheBase(const ShardedCacheOptions& opts, bool numa_aware);
   virtual ~ShardedCacheBase() = default;
 
   int GetNumShardBits() const;
@@ -113,15 +129,31 @@ class ShardedCacheBase : public Cache {
   size_t GetPerShardCapacity() const;
   size_t ComputePerShardCapacity(size_t capacity) const;
 
+  // The NUMA node group of the calling thread, see
+  // ShardedCacheOptions::numa_aware
+  uint32_t GetCurrentShardGroup() const;
+  // While constructing the shards of a group, allocate memory on its node.
+  // No-op unless numa_aware.
+  void SetPreferredShardGroup(uint32_t group) const;
+  void ResetPreferredShardGroup() const;
+
  protected:                        // data
   std::atomic<uint64_t> last_id_;  // For NewId
   const uint32_t shard_mask_;
   const uint32_t hash_seed_;
+  // log2 of the number of NUMA node groups of shards, 0 if not numa_aware
+  const int numa_node_bits_;
 
   // Dynamic configuration parameters, guarded by config_mutex_
   bool strict_capacity_limit_;
   size_t capacity_;
   mutable port::Mutex config_mutex_;
+
+  // See ShardedCacheOptions::admission_policy
+  const std::shared_ptr<CacheAdmissionPolicy> admission_policy_;
+  // Copy of GetPerShardCapacity() readable without config_mutex_, for
+  // admission_policy_
+  RelaxedAtomic<size_t> per_shard_capacity_;
 };
 
 // Generic cache interface that shards cache by hash of keys. 2^num_shard_bits
@@ -138,7 +170,8 @@ class ShardedCache : public ShardedCacheBase {
   using HandleImpl = typename CacheShard::HandleImpl;
 
   explicit ShardedCache(const ShardedCacheOptions& opts)
-      : ShardedCacheBase(opts),
+      : ShardedCacheBase(opts,
+                         CacheShard::kSupportsShardGroups && opts.numa_aware),
         shards_(static_cast<CacheShard*>(port::cacheline_aligned_alloc(
             sizeof(CacheShard) * GetNumShards()))),
         destroy_shards_in_dtor_(false) {}
@@ -158,10 +191,25 @@ class ShardedCache : public ShardedCacheBase {
     return shards_[CacheShard::HashPieceForSharding(hash) & shard_mask_];
   }
 
+  // Hash of `key` for the shards of the calling thread's NUMA node group, if
+  // numa_aware
+  HashVal ComputeLocalHash(const Slice& key) const {
+    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if constexpr (CacheShard::kSupportsShardGroups) {
+      if (numa_node_bits_ > 0) {
+        hash = CacheShard::WithShardGroup(
+            hash, GetNumShardBits() - numa_node_bits_, numa_node_bits_,
+            GetCurrentShardGroup());
+      }
+    }
+    return hash;
+  }
+
   void SetCapacity(size_t capacity) override {
     MutexLock l(&config_mutex_);
     capacity_ = capacity;
     auto per_shard = ComputePerShardCapacity(capacity);
+    per_shard_capacity_.StoreRelaxed(per_shard);
     ForEachShard([=](CacheShard* cs) { cs->SetCapacity(per_shard); });
   }
 
@@ -179,17 +227,29 @@ class ShardedCache : public ShardedCacheBase {
       const Slice& /*compressed_value*/ = Slice(),
       CompressionType /*type*/ = CompressionType::kNoCompression) override {
     assert(helper);
-    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    HashVal hash = ComputeLocalHash(key);
     auto h_out = reinterpret_cast<HandleImpl**>(handle);
-    return GetShard(hash).Insert(key, hash, obj, helper, charge, h_out,
-                                 priority);
+    CacheShard& shard = GetShard(hash);
+    if (admission_policy_ &&
+        shard.GetUsage() + charge > per_shard_capacity_.LoadRelaxed() &&
+        !admission_policy_->Admit(key, helper->role, charge)) {
+      // Not admitted: as if inserted and evicted right away
+      if (h_out) {
+        *h_out = shard.CreateStandalone(key, hash, obj, helper, charge,
+                                        /*allow_uncharged=*/true);
+      } else if (helper->del_cb) {
+        helper->del_cb(obj, memory_allocator());
+      }
+      return Status::OK();
+    }
+    return shard.Insert(key, hash, obj, helper, charge, h_out, priority);
   }
 
   Handle* CreateStandalone(const Slice& key, ObjectPtr obj,
                            const CacheItemHelper* helper, size_t charge,
                            bool allow_uncharged) override {
     assert(helper);
-    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    HashVal hash = ComputeLocalHash(key);
     HandleImpl* result = GetShard(hash).CreateStandalone(
         key, hash, obj, helper, charge, allow_uncharged);
     return static_cast<Handle*>(result);
@@ -199,14 +259,75 @@ class ShardedCache : public ShardedCacheBase {
                  CreateContext* create_context = nullptr,
                  Priority priority = Priority::LOW,
                  Statistics* stats = nullptr) override {
-    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if (admission_policy_) {
+      admission_policy_->RecordAccess(key);
+    }
+    HashVal hash = ComputeLocalHash(key);
     HandleImpl* result = GetShard(hash).Lookup(key, hash, helper,
                                                create_context, priority, stats);
     return static_cast<Handle*>(result);
   }
 
+  void MultiLookup(AsyncLookupHandle* async_handles, size_t count) override {
+    // In batches of the MultiGet batch size, hash all the keys first and then
+    // look up the keys of each shard together
+    constexpr size_t kBatchSize = 32;
+    std::array<HashVal, kBatchSize> hashes;
+    std::array<uint32_t, kBatchSize> order;
+    std::array<Slice, kBatchSize> sorted_keys;
+    std::array<HashVal, kBatchSize> sorted_hashes;
+    std::array<HandleImpl*, kBatchSize> results;
+    for (size_t begin = 0; begin < count; begin += kBatchSize) {
+      AsyncLookupHandle* batch = async_handles + begin;
+      const size_t n = std::min(count - begin, kBatchSize);
+      for (size_t i = 0; i < n; i++) {
+        assert(!batch[i].IsPending());
+        batch[i].found_dummy_entry = false;  // in case re-used
+        if (admission_policy_) {
+          admission_policy_->RecordAccess(batch[i].key);
+        }
+        hashes[i] = ComputeLocalHash(batch[i].key);
+        order[i] = static_cast<uint32_t>(i);
+      }
+      auto shard_index = [&](uint32_t i) {
+        return CacheShard::HashPieceForSharding(hashes[i]) & shard_mask_;
+      };
+      std::sort(order.begin(), order.begin() + n,
+                [&](uint32_t a, uint32_t b) {
+                  return shard_index(a) < shard_index(b);
+                });
+      for (size_t i = 0; i < n; i++) {
+        sorted_keys[i] = batch[order[i]].key;
+        sorted_hashes[i] = hashes[order[i]];
+      }
+      for (size_t i = 0, j; i < n; i = j) {
+        for (j = i + 1; j < n && shard_index(order[j]) == shard_index(order[i]);
+             j++) {
+        }
+        shards_[shard_index(order[i])].MultiLookup(
+            &sorted_keys[i], &sorted_hashes[i], &results[i], j - i);
+      }
+      for (size_t i = 0; i < n; i++) {
+        batch[order[i]].result_handle = static_cast<Handle*>(results[i]);
+      }
+    }
+  }
+
   void Erase(const Slice& key) override {
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if constexpr (CacheShard::kSupportsShardGroups) {
+      if (numa_node_bits_ > 0) {
+        // From the copies of all the NUMA nodes
+        int shift = GetNumShardBits() - numa_node_bits_;
+        for (uint32_t group = 0; group < (uint32_t{1} << numa_node_bits_);
+             group++) {
+          HashVal group_hash =
+              CacheShard::WithShardGroup(hash, shift, numa_node_bits_, group);
+          GetShard(group_hash).Erase(key, group_hash);
+        }
+        return;
+      }
+    }
     GetShard(hash).Erase(key, hash);
   }
 
@@ -235,6 +356,16 @@ class ShardedCache : public ShardedCacheBase {
   size_t GetTableAddressCount() const override {
     return SumOverShards2(&CacheShard::GetTableAddressCount);
   }
+  bool GetChargesByRole(
+      std::array<size_t, kNumCacheEntryRoles>* charges,
+      std::array<size_t, kNumCacheEntryRoles>* counts) const override {
+    charges->fill(0);
+    counts->fill(0);
+    ForEachShard([charges, counts](const CacheShard* cs) {
+      cs->AddChargesByRole(charges, counts);
+    });
+    return true;
+  }
   void ApplyToAllEntries(
       const std::function<void(const Slice& key, ObjectPtr value, size_t charge,
                                const CacheItemHelper* helper)>& callback,
@@ -302,7 +433,15 @@ class ShardedCache : public ShardedCacheBase {
 
   // Must be called exactly once by derived class constructor
   void InitShards(const std::function<void(CacheShard*)>& placement_new) {
-    ForEachShard(placement_new);
+    uint32_t num_shards = GetNumShards();
+    int group_shift = GetNumShardBits() - numa_node_bits_;
+    for (uint32_t i = 0; i < num_shards; i++) {
+      if (numa_node_bits_ > 0 && (i >> group_shift << group_shift) == i) {
+        SetPreferredShardGroup(i >> group_shift);
+      }
+      placement_new(shards_ + i);
+    }
+    ResetPreferredShardGroup();
     destroy_shards_in_dtor_ = true;
   }
 
@@ -319,4 +458,8 @@ class ShardedCache : public ShardedCacheBase {
 int GetDefaultCacheShardBits(size_t capacity,
                              size_t min_shard_size = 512U * 1024U);
 
+// log2 of the number of NUMA node groups of shards for
+// ShardedCacheOptions::numa_aware, rounded up; 0 without NUMA support.
+int GetNumaShardGroupBits();
+
 }  // namespace ROCKSDB_NAMESPACE
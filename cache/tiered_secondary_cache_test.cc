@@ -592,6 +592,22 @@ TEST_F(DBTieredSecondaryCacheTest, WaitAllTest) {
   ASSERT_EQ(nvm_sec_cache()->num_misses(), 10u);
   ASSERT_EQ(nvm_sec_cache()->num_hits(), 4u);
 
+  // Mix blocks not cached anywhere with ones in the tiers. The file reads
+  // for 40 and 44 are not held back by the lookups still pending, if any.
+  keys.clear();
+  values.clear();
+  keys.push_back(Key(24));
+  keys.push_back(Key(40));
+  keys.push_back(Key(32));
+  keys.push_back(Key(44));
+  values = MultiGet(keys, /*snapshot=*/nullptr, /*async=*/true);
+  ASSERT_EQ(values.size(), keys.size());
+  ASSERT_EQ(nvm_sec_cache()->num_insert_saved(), 12u);
+  ASSERT_EQ(nvm_sec_cache()->num_misses(), 12u);
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(Get(keys[i]), values[i]);
+  }
+
   Destroy(options);
 }
 
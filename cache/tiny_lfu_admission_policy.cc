@@ -0,0 +1,94 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <cstdint>
+#include <memory>
+
+#include "cache/frequency_sketch.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/slice.h"
+#include "util/atomic.h"
+#include "util/hash.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+class TinyLfuAdmissionPolicy : public CacheAdmissionPolicy {
+ public:
+  explicit TinyLfuAdmissionPolicy(const TinyLfuAdmissionPolicyOptions& opts)
+      : min_frequency_(opts.min_frequency),
+        admission_roles_(opts.admission_roles),
+        sketch_(opts.expected_entries),
+        doorkeeper_mask_(DoorkeeperWords(opts.expected_entries) - 1),
+        doorkeeper_(new RelaxedAtomic<uint64_t>[doorkeeper_mask_ + 1]) {}
+
+  const char* Name() const override { return "TinyLfuAdmissionPolicy"; }
+
+  void RecordAccess(const Slice& key) override {
+    const uint64_t hash = GetSliceNPHash64(key, kSeed);
+    RelaxedAtomic<uint64_t>& word = DoorkeeperWord(hash);
+    const uint64_t bits = DoorkeeperBits(hash);
+    // First lookup since the last reset only goes to the doorkeeper
+    if ((word.FetchOrRelaxed(bits) & bits) != bits) {
+      return;
+    }
+    if (sketch_.Add(hash)) {
+      for (size_t i = 0; i <= doorkeeper_mask_; i++) {
+        doorkeeper_[i].StoreRelaxed(0);
+      }
+    }
+  }
+
+  bool Admit(const Slice& key, CacheEntryRole role,
+             size_t /*charge*/) override {
+    if (!admission_roles_.Contains(role)) {
+      return true;
+    }
+    const uint64_t hash = GetSliceNPHash64(key, kSeed);
+    const uint64_t bits = DoorkeeperBits(hash);
+    uint32_t frequency = sketch_.Estimate(hash);
+    if ((DoorkeeperWord(hash).LoadRelaxed() & bits) == bits) {
+      frequency++;
+    }
+    return frequency >= min_frequency_;
+  }
+
+ private:
+  // Independent of the cache's own hashing of keys
+  static constexpr uint64_t kSeed = 0x7a3c5e9b;
+
+  // One byte per expected entry, power of two words
+  static size_t DoorkeeperWords(size_t expected_entries) {
+    const size_t words = expected_entries / 8;
+    return words <= 16 ? size_t{16} : size_t{1} << (FloorLog2(words - 1) + 1);
+  }
+
+  RelaxedAtomic<uint64_t>& DoorkeeperWord(uint64_t hash) {
+    return doorkeeper_[hash & doorkeeper_mask_];
+  }
+
+  // Two probes in the same word, from the upper bits of the hash
+  static uint64_t DoorkeeperBits(uint64_t hash) {
+    return (uint64_t{1} << (hash >> 58)) | (uint64_t{1} << ((hash >> 52) & 63));
+  }
+
+  const uint32_t min_frequency_;
+  const CacheEntryRoleSet admission_roles_;
+  FrequencySketch sketch_;
+  const size_t doorkeeper_mask_;
+  std::unique_ptr<RelaxedAtomic<uint64_t>[]> doorkeeper_;
+};
+
+}  // namespace
+
+std::shared_ptr<CacheAdmissionPolicy> NewTinyLfuAdmissionPolicy(
+    const TinyLfuAdmissionPolicyOptions& opts) {
+  return std::make_shared<TinyLfuAdmissionPolicy>(opts);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
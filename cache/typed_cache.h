@@ -177,6 +177,13 @@ class BasicTypedCacheInterface : public BaseCacheInterface<CachePtr>,
     this->cache_->StartAsyncLookup(async_handle);
   }
 
+  inline void MultiLookup(TypedAsyncLookupHandle* async_handles,
+                          size_t count) {
+    static_assert(sizeof(TypedAsyncLookupHandle) ==
+                  sizeof(Cache::AsyncLookupHandle));
+    this->cache_->MultiLookup(async_handles, count);
+  }
+
   inline CacheHandleGuard<TValue> Guard(TypedHandle* handle) {
     if (handle) {
       return CacheHandleGuard<TValue>(&*this->cache_, handle);
@@ -365,6 +372,19 @@ class FullTypedCacheInterface
           async_handle);
     }
   }
+
+  // Batched StartAsyncLookupFull(), see Cache::MultiLookup()
+  inline void MultiLookupFull(
+      TypedAsyncLookupHandle* async_handles, size_t count,
+      CacheTier lowest_used_cache_tier = CacheTier::kNonVolatileBlockTier) {
+    if (lowest_used_cache_tier > CacheTier::kVolatileTier) {
+      for (size_t i = 0; i < count; ++i) {
+        async_handles[i].helper = GetFullHelper();
+      }
+    }
+    BasicTypedCacheInterface<TValue, kRole, CachePtr>::MultiLookup(
+        async_handles, count);
+  }
 };
 
 // FullTypedSharedCacheInterface - Like FullTypedCacheInterface but with a
@@ -133,6 +133,7 @@ void ArenaWrappedDBIter::MaybeAutoRefresh(bool is_seek,
           assert(direction == DBIter::kReverse);
           db_iter_->SeekForPrev(key);
         }
+        ClearFileIteratorStash();
       }
     }
   }
@@ -150,7 +151,14 @@ void ArenaWrappedDBIter::DoRefresh(const Snapshot* snapshot,
   // present in the error log, but won't be reflected in the iterator status.
   // This is by design as we expect compaction to clean up those obsolete files
   // eventually.
+  //
+  // The table iterators of the files below L0 are kept in file_iter_stash_,
+  // so that the new iterator tree continues with them for the files that are
+  // still in the new Version.
+  file_iter_stash_.Clear();
+  file_iter_stash_.set_accepting(true);
   db_iter_->~DBIter();
+  file_iter_stash_.set_accepting(false);
 
   arena_.~Arena();
   new (&arena_) Arena();
@@ -59,19 +59,30 @@ class ArenaWrappedDBIter : public Iterator {
     memtable_range_tombstone_iter_ = iter;
   }
 
+  // The table iterators kept for the refreshed iterator, see DoRefresh()
+  FileIteratorStash* GetFileIteratorStash() { return &file_iter_stash_; }
+
   bool Valid() const override { return db_iter_->Valid(); }
-  void SeekToFirst() override { db_iter_->SeekToFirst(); }
-  void SeekToLast() override { db_iter_->SeekToLast(); }
+  void SeekToFirst() override {
+    db_iter_->SeekToFirst();
+    ClearFileIteratorStash();
+  }
+  void SeekToLast() override {
+    db_iter_->SeekToLast();
+    ClearFileIteratorStash();
+  }
   // 'target' does not contain timestamp, even if user timestamp feature is
   // enabled.
   void Seek(const Slice& target) override {
     MaybeAutoRefresh(true /* is_seek */, DBIter::kForward);
     db_iter_->Seek(target);
+    ClearFileIteratorStash();
   }
 
   void SeekForPrev(const Slice& target) override {
     MaybeAutoRefresh(true /* is_seek */, DBIter::kReverse);
     db_iter_->SeekForPrev(target);
+    ClearFileIteratorStash();
   }
 
   void Next() override {
@@ -86,6 +97,7 @@ class ArenaWrappedDBIter : public Iterator {
 
   Slice key() const override { return db_iter_->key(); }
   Slice value() const override { return db_iter_->value(); }
+  void PinValue(PinnableSlice* value) override { db_iter_->PinValue(value); }
   const WideColumns& columns() const override { return db_iter_->columns(); }
   Status status() const override { return db_iter_->status(); }
   Slice timestamp() const override { return db_iter_->timestamp(); }
@@ -124,6 +136,13 @@ class ArenaWrappedDBIter : public Iterator {
  private:
   void DoRefresh(const Snapshot* snapshot, uint64_t sv_number);
   void MaybeAutoRefresh(bool is_seek, DBIter::Direction direction);
+  // The first seek after a refresh takes the table iterators it needs from
+  // the stash, and the rest are not kept any longer.
+  void ClearFileIteratorStash() {
+    if (!file_iter_stash_.empty()) {
+      file_iter_stash_.Clear();
+    }
+  }
 
   DBIter* db_iter_ = nullptr;
   Arena arena_;
@@ -138,6 +157,7 @@ class ArenaWrappedDBIter : public Iterator {
   // tombstone when added under this DBIter.
   std::unique_ptr<TruncatedRangeDelIterator>* memtable_range_tombstone_iter_ =
       nullptr;
+  FileIteratorStash file_iter_stash_;
 };
 
 ArenaWrappedDBIter* NewArenaWrappedDbIterator(
@@ -31,4 +31,10 @@ Status BlobFetcher::FetchBlob(const Slice& user_key,
                            blob_value, bytes_read);
 }
 
+bool BlobFetcher::IsBlobInCache(const BlobIndex& blob_index) const {
+  assert(version_);
+
+  return version_->IsBlobInCache(blob_index);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -30,6 +30,8 @@ class BlobFetcher {
                    FilePrefetchBuffer* prefetch_buffer,
                    PinnableSlice* blob_value, uint64_t* bytes_read) const;
 
+  bool IsBlobInCache(const BlobIndex& blob_index) const;
+
  private:
   const Version* version_;
   ReadOptions read_options_;
@@ -97,7 +97,7 @@ BlobFileBuilder::BlobFileBuilder(
 BlobFileBuilder::~BlobFileBuilder() = default;
 
 Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
-                            std::string* blob_index) {
+                            std::string* blob_index, bool warm_cache) {
   assert(blob_index);
   assert(blob_index->empty());
 
@@ -141,8 +141,8 @@ Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
   }
 
   {
-    const Status s =
-        PutBlobIntoCacheIfNeeded(value, blob_file_number, blob_offset);
+    const Status s = PutBlobIntoCacheIfNeeded(value, blob_file_number,
+                                              blob_offset, warm_cache);
     if (!s.ok()) {
       ROCKS_LOG_WARN(immutable_options_->info_log,
                      "Failed to pre-populate the blob into blob cache: %s",
@@ -398,14 +398,15 @@ void BlobFileBuilder::Abandon(const Status& s) {
 
 Status BlobFileBuilder::PutBlobIntoCacheIfNeeded(const Slice& blob,
                                                  uint64_t blob_file_number,
-                                                 uint64_t blob_offset) const {
+                                                 uint64_t blob_offset,
+                                                 bool warm_cache) const {
   Status s = Status::OK();
 
   BlobSource::SharedCacheInterface blob_cache{immutable_options_->blob_cache};
   auto statistics = immutable_options_->statistics.get();
-  bool warm_cache =
-      prepopulate_blob_cache_ == PrepopulateBlobCache::kFlushOnly &&
-      creation_reason_ == BlobFileCreationReason::kFlush;
+  warm_cache = warm_cache ||
+               (prepopulate_blob_cache_ == PrepopulateBlobCache::kFlushOnly &&
+                creation_reason_ == BlobFileCreationReason::kFlush);
 
   if (blob_cache && warm_cache) {
     const OffsetableCacheKey base_cache_key(db_id_, db_session_id_,
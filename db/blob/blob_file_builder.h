@@ -69,7 +69,10 @@ class BlobFileBuilder {
 
   ~BlobFileBuilder();
 
-  Status Add(const Slice& key, const Slice& value, std::string* blob_index);
+  // If `warm_cache`, the blob is inserted into the blob cache whatever the
+  // prepopulate_blob_cache option, e.g. for a hot blob that is relocated.
+  Status Add(const Slice& key, const Slice& value, std::string* blob_index,
+             bool warm_cache = false);
   Status Finish();
   void Abandon(const Status& s);
 
@@ -83,7 +86,7 @@ class BlobFileBuilder {
   Status CloseBlobFileIfNeeded();
 
   Status PutBlobIntoCacheIfNeeded(const Slice& blob, uint64_t blob_file_number,
-                                  uint64_t blob_offset) const;
+                                  uint64_t blob_offset, bool warm_cache) const;
 
   std::function<uint64_t()> file_number_generator_;
   FileSystem* fs_;
@@ -43,7 +43,8 @@ Status BlobFileCache::GetBlobFileReader(
   assert(blob_file_reader->IsEmpty());
 
   // NOTE: sharing same Cache with table_cache
-  const Slice key = GetSliceForKey(&blob_file_number);
+  const FileNumberCacheKey key_data(blob_file_number);
+  const Slice key = key_data.AsSlice();
 
   assert(cache_);
 
@@ -101,11 +102,11 @@ Status BlobFileCache::GetBlobFileReader(
 
 void BlobFileCache::Evict(uint64_t blob_file_number) {
   // NOTE: sharing same Cache with table_cache
-  const Slice key = GetSliceForKey(&blob_file_number);
+  const FileNumberCacheKey key(blob_file_number);
 
   assert(cache_);
 
-  cache_.get()->Erase(key);
+  cache_.get()->Erase(key.AsSlice());
 }
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -314,9 +314,10 @@ Status BlobFileReader::GetBlob(
   // Note: if verify_checksum is set, we read the entire blob record to be able
   // to perform the verification; otherwise, we just read the blob itself. Since
   // the offset in BlobIndex actually points to the blob value, we need to make
-  // an adjustment in the former case.
+  // an adjustment in the former case. Reads through a prefetch buffer also
+  // take entire records, so that reading consecutive blobs is sequential.
   const uint64_t adjustment =
-      read_options.verify_checksums
+      (read_options.verify_checksums || prefetch_buffer)
           ? BlobLogRecord::CalculateAdjustmentForRecordHeader(key_size)
           : 0;
   assert(offset >= adjustment);
@@ -394,6 +395,19 @@ void BlobFileReader::MultiGetBlob(
     autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>&
         blob_reqs,
     uint64_t* bytes_read) const {
+  MultiGetBlobReads reads;
+  SubmitMultiGetBlob(read_options, blob_reqs, /*async=*/false, &reads);
+  assert(reads.io_handles.empty());
+  FinishMultiGetBlob(read_options, allocator, blob_reqs, &reads, bytes_read);
+}
+
+void BlobFileReader::SubmitMultiGetBlob(
+    const ReadOptions& read_options,
+    autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>&
+        blob_reqs,
+    bool async, MultiGetBlobReads* reads) const {
+  assert(reads);
+
   const size_t num_blobs = blob_reqs.size();
   assert(num_blobs > 0);
   assert(num_blobs <= MultiGetContext::MAX_BATCH_SIZE);
@@ -404,8 +418,8 @@ void BlobFileReader::MultiGetBlob(
   }
 #endif  // !NDEBUG
 
-  std::vector<FSReadRequest> read_reqs;
-  autovector<uint64_t> adjustments;
+  std::vector<FSReadRequest>& read_reqs = reads->read_reqs;
+  autovector<uint64_t>& adjustments = reads->adjustments;
   uint64_t total_len = 0;
   read_reqs.reserve(num_blobs);
   for (size_t i = 0; i < num_blobs; ++i) {
@@ -444,20 +458,16 @@ void BlobFileReader::MultiGetBlob(
 
   RecordTick(statistics_, BLOB_DB_BLOB_FILE_BYTES_READ, total_len);
 
-  Buffer buf;
-  AlignedBuf aligned_buf;
-
-  Status s;
   bool direct_io = file_reader_->use_direct_io();
   if (direct_io) {
     for (size_t i = 0; i < read_reqs.size(); ++i) {
       read_reqs[i].scratch = nullptr;
     }
   } else {
-    buf.reset(new char[total_len]);
+    reads->buf.reset(new char[total_len]);
     std::ptrdiff_t pos = 0;
     for (size_t i = 0; i < read_reqs.size(); ++i) {
-      read_reqs[i].scratch = buf.get() + pos;
+      read_reqs[i].scratch = reads->buf.get() + pos;
       pos += read_reqs[i].len;
     }
   }
@@ -466,11 +476,55 @@ void BlobFileReader::MultiGetBlob(
   PERF_COUNTER_ADD(blob_read_byte, total_len);
   IOOptions opts;
   IODebugContext dbg;
-  s = file_reader_->PrepareIOOptions(read_options, opts, &dbg);
-  if (s.ok()) {
-    s = file_reader_->MultiRead(opts, read_reqs.data(), read_reqs.size(),
-                                direct_io ? &aligned_buf : nullptr, &dbg);
+  Status s = file_reader_->PrepareIOOptions(read_options, opts, &dbg);
+  size_t num_submitted = 0;
+  if (s.ok() && async && !direct_io) {
+    for (; num_submitted < read_reqs.size(); ++num_submitted) {
+      FSReadRequest& read_req = read_reqs[num_submitted];
+      void* io_handle = nullptr;
+      IOHandleDeleter del_fn;
+      const IOStatus io_s = file_reader_->ReadAsync(
+          read_req, opts, &BlobFileReader::OnMultiGetBlobRead, &read_req,
+          &io_handle, &del_fn, /*aligned_buf=*/nullptr);
+      if (!io_s.ok()) {
+        // Leave the rest of the reads to MultiRead()
+        io_s.PermitUncheckedError();
+        break;
+      }
+      if (io_handle != nullptr) {
+        reads->io_handles.push_back(io_handle);
+        reads->del_fns.push_back(std::move(del_fn));
+      }
+    }
   }
+  if (s.ok() && num_submitted < read_reqs.size()) {
+    s = file_reader_->MultiRead(opts, read_reqs.data() + num_submitted,
+                                read_reqs.size() - num_submitted,
+                                direct_io ? &reads->aligned_buf : nullptr,
+                                &dbg);
+  }
+  reads->status = s;
+}
+
+void BlobFileReader::OnMultiGetBlobRead(FSReadRequest& req, void* cb_arg) {
+  FSReadRequest* const read_req = static_cast<FSReadRequest*>(cb_arg);
+  assert(read_req);
+  if (read_req != &req) {
+    read_req->status = req.status;
+    read_req->result = req.result;
+  }
+}
+
+void BlobFileReader::FinishMultiGetBlob(
+    const ReadOptions& read_options, MemoryAllocator* allocator,
+    autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>&
+        blob_reqs,
+    MultiGetBlobReads* reads, uint64_t* bytes_read) const {
+  assert(reads);
+  assert(reads->io_handles.empty());
+
+  std::vector<FSReadRequest>& read_reqs = reads->read_reqs;
+  const Status& s = reads->status;
   if (!s.ok()) {
     for (auto& req : read_reqs) {
       req.status.PermitUncheckedError();
@@ -488,10 +542,8 @@ void BlobFileReader::MultiGetBlob(
     return;
   }
 
-  assert(s.ok());
-
   uint64_t total_bytes = 0;
-  for (size_t i = 0, j = 0; i < num_blobs; ++i) {
+  for (size_t i = 0, j = 0; i < blob_reqs.size(); ++i) {
     BlobReadRequest* const req = blob_reqs[i].first;
     assert(req);
     assert(req->user_key);
@@ -502,6 +554,7 @@ void BlobFileReader::MultiGetBlob(
     }
 
     assert(j < read_reqs.size());
+    const uint64_t adjustment = reads->adjustments[j];
     auto& read_req = read_reqs[j++];
     const auto& record_slice = read_req.result;
     if (read_req.status.ok() && record_slice.size() != read_req.len) {
@@ -523,7 +576,7 @@ void BlobFileReader::MultiGetBlob(
     }
 
     // Uncompress blob if needed
-    Slice value_slice(record_slice.data() + adjustments[i], req->len);
+    Slice value_slice(record_slice.data() + adjustment, req->len);
     *req->status =
         UncompressBlobIfNeeded(value_slice, compression_type_, allocator,
                                clock_, statistics_, &blob_reqs[i].second);
@@ -7,6 +7,7 @@
 
 #include <cinttypes>
 #include <memory>
+#include <vector>
 
 #include "db/blob/blob_read_request.h"
 #include "file/random_access_file_reader.h"
@@ -57,6 +58,37 @@ class BlobFileReader {
           blob_reqs,
       uint64_t* bytes_read) const;
 
+  // The reads from the file of a MultiGetBlob() batch
+  struct MultiGetBlobReads {
+    std::vector<FSReadRequest> read_reqs;
+    autovector<uint64_t> adjustments;
+    std::unique_ptr<char[]> buf;
+    AlignedBuf aligned_buf;
+    // The handles of the reads in flight, which the caller polls with
+    // FileSystem::Poll() and releases with their deleters before
+    // FinishMultiGetBlob()
+    std::vector<void*> io_handles;
+    std::vector<IOHandleDeleter> del_fns;
+    Status status;
+  };
+
+  // The two halves of MultiGetBlob(), so that the reads of several blob files
+  // can be in flight at once. SubmitMultiGetBlob() issues the reads of
+  // `blob_reqs`, with ReadAsync() if `async` is set and the file is not read
+  // with direct I/O, and FinishMultiGetBlob() verifies and uncompresses the
+  // blobs once the reads have completed.
+  void SubmitMultiGetBlob(
+      const ReadOptions& read_options,
+      autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>&
+          blob_reqs,
+      bool async, MultiGetBlobReads* reads) const;
+
+  void FinishMultiGetBlob(
+      const ReadOptions& read_options, MemoryAllocator* allocator,
+      autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>&
+          blob_reqs,
+      MultiGetBlobReads* reads, uint64_t* bytes_read) const;
+
   CompressionType GetCompressionType() const { return compression_type_; }
 
   uint64_t GetFileSize() const { return file_size_; }
@@ -91,6 +123,8 @@ class BlobFileReader {
                              Statistics* statistics, Slice* slice, Buffer* buf,
                              AlignedBuf* aligned_buf);
 
+  static void OnMultiGetBlobRead(FSReadRequest& req, void* cb_arg);
+
   static Status VerifyBlob(const Slice& record_slice, const Slice& user_key,
                            uint64_t value_size);
 
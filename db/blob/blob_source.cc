@@ -17,6 +17,7 @@
 #include "options/cf_options.h"
 #include "table/get_context.h"
 #include "table/multiget_context.h"
+#include "util/stop_watch.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -28,6 +29,8 @@ BlobSource::BlobSource(const ImmutableOptions& immutable_options,
     : db_id_(db_id),
       db_session_id_(db_session_id),
       statistics_(immutable_options.statistics.get()),
+      fs_(immutable_options.fs.get()),
+      clock_(immutable_options.clock),
       blob_file_cache_(blob_file_cache),
       blob_cache_(immutable_options.blob_cache),
       lowest_used_cache_tier_(immutable_options.lowest_used_cache_tier) {
@@ -257,6 +260,15 @@ Status BlobSource::GetBlob(const ReadOptions& read_options,
   return s;
 }
 
+// The blobs of one blob file that are read from the file
+struct BlobSource::BlobFileReads {
+  autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>
+      blob_reqs;
+  CacheHandleGuard<BlobFileReader> blob_file_reader;
+  MemoryAllocator* allocator = nullptr;
+  BlobFileReader::MultiGetBlobReads reads;
+};
+
 void BlobSource::MultiGetBlob(const ReadOptions& read_options,
                               autovector<BlobFileReadRequests>& blob_reqs,
                               uint64_t* bytes_read) {
@@ -272,11 +284,45 @@ void BlobSource::MultiGetBlob(const ReadOptions& read_options,
         [](const BlobReadRequest& lhs, const BlobReadRequest& rhs) -> bool {
           return lhs.offset < rhs.offset;
         });
+  }
+
+  if (!read_options.async_io || blob_reqs.size() == 1) {
+    for (auto& [file_number, file_size, blob_reqs_in_file] : blob_reqs) {
+      MultiGetBlobFromOneFile(read_options, file_number, file_size,
+                              blob_reqs_in_file, &bytes_read_in_file);
+
+      total_bytes_read += bytes_read_in_file;
+    }
+  } else {
+    // Issue the reads of all the blob files before waiting for any of them
+    std::vector<BlobFileReads> files(blob_reqs.size());
+    for (size_t i = 0; i < blob_reqs.size(); ++i) {
+      auto& [file_number, file_size, blob_reqs_in_file] = blob_reqs[i];
+      BlobFileReads& file_reads = files[i];
+      if (PrepareBlobFileReads(read_options, file_number, blob_reqs_in_file,
+                               &file_reads, &bytes_read_in_file)) {
+        file_reads.blob_file_reader.GetValue()->SubmitMultiGetBlob(
+            read_options, file_reads.blob_reqs, /*async=*/true,
+            &file_reads.reads);
+      }
+      total_bytes_read += bytes_read_in_file;
+    }
 
-    MultiGetBlobFromOneFile(read_options, file_number, file_size,
-                            blob_reqs_in_file, &bytes_read_in_file);
+    PollBlobFileReads(files);
 
-    total_bytes_read += bytes_read_in_file;
+    for (size_t i = 0; i < blob_reqs.size(); ++i) {
+      BlobFileReads& file_reads = files[i];
+      if (file_reads.blob_file_reader.IsEmpty()) {
+        continue;
+      }
+      bytes_read_in_file = 0;
+      file_reads.blob_file_reader.GetValue()->FinishMultiGetBlob(
+          read_options, file_reads.allocator, file_reads.blob_reqs,
+          &file_reads.reads, &bytes_read_in_file);
+      FinishBlobFileReads(read_options, std::get<0>(blob_reqs[i]),
+                          &file_reads);
+      total_bytes_read += bytes_read_in_file;
+    }
   }
 
   if (bytes_read) {
@@ -289,6 +335,31 @@ void BlobSource::MultiGetBlobFromOneFile(const ReadOptions& read_options,
                                          uint64_t /*file_size*/,
                                          autovector<BlobReadRequest>& blob_reqs,
                                          uint64_t* bytes_read) {
+  BlobFileReads file_reads;
+  uint64_t total_bytes = 0;
+  if (PrepareBlobFileReads(read_options, file_number, blob_reqs, &file_reads,
+                           &total_bytes)) {
+    uint64_t bytes_read_from_file = 0;
+    file_reads.blob_file_reader.GetValue()->MultiGetBlob(
+        read_options, file_reads.allocator, file_reads.blob_reqs,
+        &bytes_read_from_file);
+    FinishBlobFileReads(read_options, file_number, &file_reads);
+    total_bytes += bytes_read_from_file;
+  }
+
+  if (bytes_read) {
+    *bytes_read = total_bytes;
+  }
+}
+
+bool BlobSource::PrepareBlobFileReads(const ReadOptions& read_options,
+                                      uint64_t file_number,
+                                      autovector<BlobReadRequest>& blob_reqs,
+                                      BlobFileReads* file_reads,
+                                      uint64_t* bytes_read) {
+  assert(file_reads);
+  assert(bytes_read);
+
   const size_t num_blobs = blob_reqs.size();
   assert(num_blobs > 0);
   assert(num_blobs <= MultiGetContext::MAX_BATCH_SIZE);
@@ -340,13 +411,13 @@ void BlobSource::MultiGetBlobFromOneFile(const ReadOptions& read_options,
 
     // All blobs were read from the cache.
     if (cached_blob_count == num_blobs) {
-      if (bytes_read) {
-        *bytes_read = total_bytes;
-      }
-      return;
+      *bytes_read = total_bytes;
+      return false;
     }
   }
 
+  *bytes_read = total_bytes;
+
   const bool no_io = read_options.read_tier == kBlockCacheTier;
   if (no_io) {
     for (size_t i = 0; i < num_blobs; ++i) {
@@ -358,78 +429,123 @@ void BlobSource::MultiGetBlobFromOneFile(const ReadOptions& read_options,
             Status::Incomplete("Cannot read blob(s): no disk I/O allowed");
       }
     }
-    return;
+    return false;
   }
 
-  {
-    // Find the rest of blobs from the file since I/O is allowed.
-    autovector<std::pair<BlobReadRequest*, std::unique_ptr<BlobContents>>>
-        _blob_reqs;
-    uint64_t _bytes_read = 0;
-
-    for (size_t i = 0; i < num_blobs; ++i) {
-      if (!(cache_hit_mask & (Mask{1} << i))) {
-        _blob_reqs.emplace_back(&blob_reqs[i], std::unique_ptr<BlobContents>());
-      }
+  // Find the rest of blobs from the file since I/O is allowed.
+  for (size_t i = 0; i < num_blobs; ++i) {
+    if (!(cache_hit_mask & (Mask{1} << i))) {
+      file_reads->blob_reqs.emplace_back(&blob_reqs[i],
+                                         std::unique_ptr<BlobContents>());
     }
+  }
 
-    CacheHandleGuard<BlobFileReader> blob_file_reader;
-    Status s = blob_file_cache_->GetBlobFileReader(read_options, file_number,
-                                                   &blob_file_reader);
-    if (!s.ok()) {
-      for (size_t i = 0; i < _blob_reqs.size(); ++i) {
-        BlobReadRequest* const req = _blob_reqs[i].first;
-        assert(req);
-        assert(req->status);
+  const Status s = blob_file_cache_->GetBlobFileReader(
+      read_options, file_number, &file_reads->blob_file_reader);
+  if (!s.ok()) {
+    for (size_t i = 0; i < file_reads->blob_reqs.size(); ++i) {
+      BlobReadRequest* const req = file_reads->blob_reqs[i].first;
+      assert(req);
+      assert(req->status);
 
-        *req->status = s;
-      }
-      return;
+      *req->status = s;
     }
+    return false;
+  }
 
-    assert(blob_file_reader.GetValue());
+  assert(file_reads->blob_file_reader.GetValue());
 
-    MemoryAllocator* const allocator =
-        (blob_cache_ && read_options.fill_cache)
-            ? blob_cache_.get()->memory_allocator()
-            : nullptr;
+  file_reads->allocator = (blob_cache_ && read_options.fill_cache)
+                              ? blob_cache_.get()->memory_allocator()
+                              : nullptr;
+  return true;
+}
 
-    blob_file_reader.GetValue()->MultiGetBlob(read_options, allocator,
-                                              _blob_reqs, &_bytes_read);
-
-    if (blob_cache_ && read_options.fill_cache) {
-      // If filling cache is allowed and a cache is configured, try to put
-      // the blob(s) to the cache.
-      for (auto& [req, blob_contents] : _blob_reqs) {
-        assert(req);
-
-        if (req->status->ok()) {
-          CacheHandleGuard<BlobContents> blob_handle;
-          const CacheKey cache_key = base_cache_key.WithOffset(req->offset);
-          const Slice key = cache_key.AsSlice();
-          s = PutBlobIntoCache(key, &blob_contents, &blob_handle);
-          if (!s.ok()) {
-            *req->status = s;
-          } else {
-            PinCachedBlob(&blob_handle, req->result);
-          }
+void BlobSource::FinishBlobFileReads(const ReadOptions& read_options,
+                                     uint64_t file_number,
+                                     BlobFileReads* file_reads) {
+  assert(file_reads);
+
+  if (blob_cache_ && read_options.fill_cache) {
+    // If filling cache is allowed and a cache is configured, try to put
+    // the blob(s) to the cache.
+    const OffsetableCacheKey base_cache_key(db_id_, db_session_id_,
+                                            file_number);
+    for (auto& [req, blob_contents] : file_reads->blob_reqs) {
+      assert(req);
+
+      if (req->status->ok()) {
+        CacheHandleGuard<BlobContents> blob_handle;
+        const CacheKey cache_key = base_cache_key.WithOffset(req->offset);
+        const Slice key = cache_key.AsSlice();
+        const Status s = PutBlobIntoCache(key, &blob_contents, &blob_handle);
+        if (!s.ok()) {
+          *req->status = s;
+        } else {
+          PinCachedBlob(&blob_handle, req->result);
         }
       }
-    } else {
-      for (auto& [req, blob_contents] : _blob_reqs) {
-        assert(req);
+    }
+  } else {
+    for (auto& [req, blob_contents] : file_reads->blob_reqs) {
+      assert(req);
 
-        if (req->status->ok()) {
-          PinOwnedBlob(&blob_contents, req->result);
-        }
+      if (req->status->ok()) {
+        PinOwnedBlob(&blob_contents, req->result);
       }
     }
+  }
+}
 
-    total_bytes += _bytes_read;
-    if (bytes_read) {
-      *bytes_read = total_bytes;
+void BlobSource::PollBlobFileReads(std::vector<BlobFileReads>& files) const {
+  std::vector<void*> io_handles;
+  for (const auto& file_reads : files) {
+    io_handles.insert(io_handles.end(), file_reads.reads.io_handles.begin(),
+                      file_reads.reads.io_handles.end());
+  }
+  if (io_handles.empty()) {
+    return;
+  }
+
+  IOStatus s;
+  {
+    StopWatch sw(clock_, statistics_, POLL_WAIT_MICROS);
+    s = fs_->Poll(io_handles, io_handles.size());
+  }
+  if (!s.ok()) {
+    // Make sure that none of the reads completes after the buffers are gone
+    fs_->AbortIO(io_handles).PermitUncheckedError();
+  }
+
+  for (auto& file_reads : files) {
+    BlobFileReader::MultiGetBlobReads& reads = file_reads.reads;
+    for (size_t i = 0; i < reads.io_handles.size(); ++i) {
+      if (reads.del_fns[i] != nullptr) {
+        reads.del_fns[i](reads.io_handles[i]);
+      }
     }
+    reads.io_handles.clear();
+    reads.del_fns.clear();
+    if (!s.ok() && reads.status.ok()) {
+      reads.status = s;
+    }
+  }
+}
+
+bool BlobSource::IsBlobInCache(uint64_t file_number, uint64_t offset) const {
+  if (!blob_cache_) {
+    return false;
+  }
+  const CacheKey cache_key =
+      GetCacheKey(file_number, /*file_size=*/0, offset);
+  Cache* const cache = blob_cache_.get();
+  Cache::Handle* const handle =
+      cache->BasicLookup(cache_key.AsSlice(), /*stats=*/nullptr);
+  if (handle == nullptr) {
+    return false;
   }
+  cache->Release(handle);
+  return true;
 }
 
 bool BlobSource::TEST_BlobInCache(uint64_t file_number, uint64_t file_size,
@@ -7,6 +7,7 @@
 
 #include <cinttypes>
 #include <memory>
+#include <vector>
 
 #include "cache/cache_key.h"
 #include "cache/typed_cache.h"
@@ -24,7 +25,9 @@ struct ImmutableOptions;
 struct MutableCFOptions;
 class Status;
 class FilePrefetchBuffer;
+class FileSystem;
 class Slice;
+class SystemClock;
 
 // BlobSource is a class that provides universal access to blobs, regardless of
 // whether they are in the blob cache, secondary cache, or (remote) storage.
@@ -69,6 +72,8 @@ class BlobSource {
   // Note:
   //  - The main difference between this function and MultiGetBlobFromOneFile is
   //    that this function can read multiple blobs from multiple blob files.
+  //    With read_options.async_io, the reads of all the blob files are issued
+  //    before waiting for any of them.
   //
   //  - For consistency, whether the blob is found in the cache or on disk, sets
   //  "*bytes_read" to the total size of on-disk (possibly compressed) blob
@@ -107,6 +112,10 @@ class BlobSource {
 
   inline Cache* GetBlobCache() const { return blob_cache_.get(); }
 
+  // Whether the blob at `offset` of the blob file is in the primary tier of
+  // the blob cache. Does not count as a lookup of the blob.
+  bool IsBlobInCache(uint64_t file_number, uint64_t offset) const;
+
   bool TEST_BlobInCache(uint64_t file_number, uint64_t file_size,
                         uint64_t offset, size_t* charge = nullptr) const;
 
@@ -119,6 +128,23 @@ class BlobSource {
   using TypedHandle = SharedCacheInterface::TypedHandle;
 
  private:
+  struct BlobFileReads;
+
+  // Looks the blobs of `blob_reqs` from blob file `file_number` up in the
+  // cache, and sets `file_reads` up for the rest of them. Returns whether there
+  // are blobs to read from the file.
+  bool PrepareBlobFileReads(const ReadOptions& read_options,
+                            uint64_t file_number,
+                            autovector<BlobReadRequest>& blob_reqs,
+                            BlobFileReads* file_reads, uint64_t* bytes_read);
+
+  // Puts the blobs read from the file into the cache if needed, and pins them
+  void FinishBlobFileReads(const ReadOptions& read_options,
+                           uint64_t file_number, BlobFileReads* file_reads);
+
+  // Waits for the reads in flight of `files` and releases their handles
+  void PollBlobFileReads(std::vector<BlobFileReads>& files) const;
+
   Status GetBlobFromCache(const Slice& cache_key,
                           CacheHandleGuard<BlobContents>* cached_blob) const;
 
@@ -148,6 +174,8 @@ class BlobSource {
   const std::string& db_session_id_;
 
   Statistics* statistics_;
+  FileSystem* fs_;
+  SystemClock* clock_;
 
   // A cache to store blob file reader.
   BlobFileCache* blob_file_cache_;
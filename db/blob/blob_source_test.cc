@@ -773,6 +773,126 @@ TEST_F(BlobSourceTest, MultiGetBlobsFromMultiFiles) {
   }
 }
 
+TEST_F(BlobSourceTest, MultiGetBlobsFromMultiFilesAsync) {
+  options_.cf_paths.emplace_back(
+      test::PerThreadDBPath(env_,
+                            "BlobSourceTest_MultiGetBlobsFromMultiFilesAsync"),
+      0);
+
+  DestroyAndReopen(options_);
+
+  ImmutableOptions immutable_options(options_);
+  MutableCFOptions mutable_cf_options(options_);
+
+  constexpr uint32_t column_family_id = 1;
+  constexpr bool has_ttl = false;
+  constexpr ExpirationRange expiration_range;
+  constexpr uint64_t blob_files = 3;
+  constexpr size_t num_blobs = 16;
+
+  std::vector<std::string> key_strs;
+  std::vector<std::string> blob_strs;
+
+  // Keys of different sizes, so that the records have different headers
+  for (size_t i = 0; i < num_blobs; ++i) {
+    key_strs.push_back("key" + std::to_string(i * 7));
+    blob_strs.push_back("blob" + std::to_string(i));
+  }
+
+  std::vector<Slice> keys;
+  std::vector<Slice> blobs;
+
+  uint64_t file_size = BlobLogHeader::kSize;
+  for (size_t i = 0; i < num_blobs; ++i) {
+    keys.emplace_back(key_strs[i]);
+    blobs.emplace_back(blob_strs[i]);
+    file_size += BlobLogRecord::kHeaderSize + keys[i].size() + blobs[i].size();
+  }
+  file_size += BlobLogFooter::kSize;
+  const uint64_t blob_records_bytes =
+      file_size - BlobLogHeader::kSize - BlobLogFooter::kSize;
+
+  std::vector<uint64_t> blob_offsets(keys.size());
+  std::vector<uint64_t> blob_sizes(keys.size());
+
+  for (size_t i = 0; i < blob_files; ++i) {
+    const uint64_t file_number = i + 1;
+    WriteBlobFile(immutable_options, column_family_id, has_ttl,
+                  expiration_range, expiration_range, file_number, keys, blobs,
+                  kNoCompression, blob_offsets, blob_sizes);
+  }
+
+  constexpr size_t capacity = 10;
+  std::shared_ptr<Cache> backing_cache = NewLRUCache(capacity);
+
+  FileOptions file_options;
+  constexpr HistogramImpl* blob_file_read_hist = nullptr;
+
+  std::unique_ptr<BlobFileCache> blob_file_cache =
+      std::make_unique<BlobFileCache>(
+          backing_cache.get(), &immutable_options, &file_options,
+          column_family_id, blob_file_read_hist, nullptr /*IOTracer*/);
+
+  BlobSource blob_source(immutable_options, mutable_cf_options, db_id_,
+                         db_session_id_, blob_file_cache.get());
+
+  ReadOptions read_options;
+  read_options.verify_checksums = true;
+  read_options.fill_cache = false;
+  read_options.async_io = true;
+
+  autovector<BlobFileReadRequests> blob_reqs;
+  std::array<autovector<BlobReadRequest>, blob_files> blob_reqs_in_file;
+  std::array<PinnableSlice, num_blobs * blob_files> value_buf;
+  std::array<Status, num_blobs * blob_files> statuses_buf;
+  PinnableSlice invalid_value;
+  Status invalid_status;
+
+  for (size_t i = 0; i < blob_files; ++i) {
+    for (size_t j = 0; j < num_blobs; ++j) {
+      blob_reqs_in_file[i].emplace_back(
+          keys[j], blob_offsets[j], blob_sizes[j], kNoCompression,
+          &value_buf[i * num_blobs + j], &statuses_buf[i * num_blobs + j]);
+    }
+  }
+  // A blob at an invalid offset, which comes first in its file
+  blob_reqs_in_file[0].emplace_back(keys[0], /*offset=*/0, blob_sizes[0],
+                                    kNoCompression, &invalid_value,
+                                    &invalid_status);
+  for (size_t i = 0; i < blob_files; ++i) {
+    blob_reqs.emplace_back(i + 1, file_size, blob_reqs_in_file[i]);
+  }
+
+  autovector<BlobReadRequest> fake_blob_reqs_in_file;
+  std::array<PinnableSlice, num_blobs> fake_value_buf;
+  std::array<Status, num_blobs> fake_statuses_buf;
+  const uint64_t fake_file_number = 100;
+  for (size_t i = 0; i < num_blobs; ++i) {
+    fake_blob_reqs_in_file.emplace_back(keys[i], blob_offsets[i],
+                                        blob_sizes[i], kNoCompression,
+                                        &fake_value_buf[i],
+                                        &fake_statuses_buf[i]);
+  }
+  blob_reqs.emplace_back(fake_file_number, file_size, fake_blob_reqs_in_file);
+
+  uint64_t bytes_read = 0;
+  blob_source.MultiGetBlob(read_options, blob_reqs, &bytes_read);
+
+  for (size_t i = 0; i < blob_files; ++i) {
+    for (size_t j = 0; j < num_blobs; ++j) {
+      ASSERT_OK(statuses_buf[i * num_blobs + j]);
+      ASSERT_EQ(value_buf[i * num_blobs + j], blobs[j]);
+    }
+  }
+  ASSERT_TRUE(invalid_status.IsCorruption());
+  ASSERT_TRUE(invalid_value.empty());
+  for (size_t i = 0; i < num_blobs; ++i) {
+    ASSERT_TRUE(fake_statuses_buf[i].IsIOError());
+    ASSERT_TRUE(fake_value_buf[i].empty());
+  }
+  ASSERT_EQ(bytes_read, blob_records_bytes * blob_files);
+}
+
 TEST_F(BlobSourceTest, MultiGetBlobsFromCache) {
   options_.cf_paths.emplace_back(
       test::PerThreadDBPath(env_, "BlobSourceTest_MultiGetBlobsFromCache"), 0);
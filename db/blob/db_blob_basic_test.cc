@@ -483,6 +483,72 @@ TEST_F(DBBlobBasicTest, IterateBlobsAllowUnpreparedValue) {
   }
 }
 
+TEST_F(DBBlobBasicTest, IterateBlobsWithReadahead) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+
+  Reopen(options);
+
+  constexpr size_t num_blobs = 64;
+  std::vector<std::string> keys;
+  std::vector<std::string> blobs;
+
+  for (size_t i = 0; i < num_blobs; ++i) {
+    keys.emplace_back("key" + std::to_string(1000 + i));
+    blobs.emplace_back(1000, static_cast<char>('a' + i % 26));
+    ASSERT_OK(Put(keys[i], blobs[i]));
+  }
+
+  ASSERT_OK(Flush());
+
+  SetPerfLevel(kEnableCount);
+
+  for (bool verify_checksums : {true, false}) {
+    ReadOptions read_options;
+    read_options.verify_checksums = verify_checksums;
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+
+    get_perf_context()->Reset();
+
+    size_t i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(iter->key(), keys[i]);
+      ASSERT_EQ(iter->value(), blobs[i]);
+      ++i;
+    }
+
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, num_blobs);
+
+    // Past the first reads, the blobs come from the readahead
+    ASSERT_LT(get_perf_context()->blob_read_count, num_blobs / 4);
+  }
+
+  {
+    // Key-only scans do not read the blob files
+    ReadOptions read_options;
+    read_options.allow_unprepared_value = true;
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+
+    get_perf_context()->Reset();
+
+    size_t i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(iter->key(), keys[i]);
+      ++i;
+    }
+
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, num_blobs);
+    ASSERT_EQ(get_perf_context()->blob_read_count, 0);
+  }
+
+  SetPerfLevel(kDisable);
+}
+
 TEST_F(DBBlobBasicTest, MultiGetBlobs) {
   constexpr size_t min_blob_size = 6;
 
@@ -775,6 +775,57 @@ TEST_F(DBBlobCompactionTest, CompactionReadaheadGarbageCollection) {
   Close();
 }
 
+TEST_F(DBBlobCompactionTest, AdaptiveMinBlobSize) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.blob_separation_percent = 50;
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  options.disable_auto_compactions = true;
+
+  Reopen(options);
+
+  // Flushes separate all the values, as min_blob_size is 0
+  constexpr int kNumKeys = 100;
+  for (int i = 0; i < kNumKeys; i++) {
+    const size_t value_size = (i % 2 == 0) ? 10 : 1000;
+    ASSERT_OK(Put(Key(i), std::string(value_size, 'a' + i % 26)));
+  }
+  ASSERT_OK(Flush());
+
+  auto num_live_blobs = [&]() {
+    ColumnFamilyData* const cfd =
+        dbfull()->GetVersionSet()->GetColumnFamilySet()->GetDefault();
+    const VersionStorageInfo* const storage_info =
+        cfd->current()->storage_info();
+    uint64_t count = 0;
+    for (const auto& meta : storage_info->GetBlobFiles()) {
+      count += meta->GetTotalBlobCount() - meta->GetGarbageBlobCount();
+    }
+    return count;
+  };
+  ASSERT_EQ(num_live_blobs(), kNumKeys);
+
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+
+  // Without value sizes recorded yet, the compaction uses min_blob_size
+  ASSERT_OK(db_->CompactRange(cro, /*begin=*/nullptr, /*end=*/nullptr));
+  ASSERT_EQ(num_live_blobs(), kNumKeys);
+
+  // Garbage collection inlines the smaller half of the relocated values
+  ASSERT_OK(db_->CompactRange(cro, /*begin=*/nullptr, /*end=*/nullptr));
+  ASSERT_EQ(num_live_blobs(), kNumKeys / 2);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    const size_t value_size = (i % 2 == 0) ? 10 : 1000;
+    ASSERT_EQ(Get(Key(i)), std::string(value_size, 'a' + i % 26));
+  }
+
+  Close();
+}
+
 TEST_F(DBBlobCompactionTest, CompactionReadaheadFilter) {
   Options options = GetDefaultOptions();
 
@@ -889,6 +940,106 @@ TEST_F(DBBlobCompactionTest, CompactionDoNotFillCache) {
   Close();
 }
 
+TEST_F(DBBlobCompactionTest, WarmRelocatedBlobs) {
+  Options options = GetDefaultOptions();
+
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  options.disable_auto_compactions = true;
+  options.compaction_warmup_policy.warm_relocated_blobs = true;
+  options.statistics = CreateDBStatistics();
+
+  LRUCacheOptions cache_options;
+  cache_options.capacity = 1 << 20;
+  cache_options.metadata_charge_policy = kDontChargeCacheMetadata;
+
+  options.blob_cache = NewLRUCache(cache_options);
+
+  Reopen(options);
+
+  ASSERT_OK(Put("cold", "lime"));
+  ASSERT_OK(Put("hot", "pie"));
+  ASSERT_OK(Flush());
+
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+
+  // Only the blob of "hot" is cached
+  ASSERT_EQ(Get("hot"), "pie");
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 1);
+
+  constexpr Slice* begin = nullptr;
+  constexpr Slice* end = nullptr;
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), begin, end));
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_NUM_KEYS_RELOCATED),
+            3);
+  ASSERT_EQ(
+      options.statistics->getTickerCount(WARMUP_RELOCATED_BLOBS_INSERTED), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 2);
+
+  // The relocated blob is read from the cache
+  const uint64_t misses =
+      options.statistics->getTickerCount(BLOB_DB_CACHE_MISS);
+  ASSERT_EQ(Get("hot"), "pie");
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_MISS), misses);
+  ASSERT_EQ(Get("cold"), "lime");
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_MISS),
+            misses + 1);
+
+  Close();
+}
+
+TEST_F(DBBlobCompactionTest, GarbageCollectByGarbageRatio) {
+  Options options = GetDefaultOptions();
+
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 0.0;
+  options.blob_garbage_collection_file_threshold = 0.5;
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+
+  Reopen(options);
+
+  for (const char* key : {"k1", "k2", "k3", "k4"}) {
+    ASSERT_OK(Put(key, "lime"));
+  }
+  ASSERT_OK(Flush());
+
+  for (const char* key : {"k1", "k2", "k3"}) {
+    ASSERT_OK(Put(key, "pie"));
+  }
+  ASSERT_OK(Flush());
+
+  CompactRangeOptions compact_range_options;
+  compact_range_options.bottommost_level_compaction =
+      BottommostLevelCompaction::kForce;
+  constexpr Slice* begin = nullptr;
+  constexpr Slice* end = nullptr;
+
+  // The first blob file is garbage for 3/4 once the overwritten values are
+  // compacted away, but no blob file is old enough for the age cutoff
+  ASSERT_OK(db_->CompactRange(compact_range_options, begin, end));
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_NUM_KEYS_RELOCATED),
+            0);
+  ASSERT_EQ(GetBlobFileNumbers().size(), 2);
+
+  ASSERT_OK(db_->CompactRange(compact_range_options, begin, end));
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_NUM_KEYS_RELOCATED),
+            1);
+  ASSERT_EQ(GetBlobFileNumbers().size(), 2);
+
+  ASSERT_EQ(Get("k1"), "pie");
+  ASSERT_EQ(Get("k4"), "lime");
+
+  Close();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -16,21 +16,28 @@
 namespace ROCKSDB_NAMESPACE {
 
 // A class that owns a collection of FilePrefetchBuffers using the file number
-// as key. Used for implementing compaction readahead for blob files. Designed
-// to be accessed by a single thread only: every (sub)compaction needs its own
-// buffers since they are guaranteed to read different blobs from different
-// positions even when reading the same file.
+// as key. Used for implementing compaction and iterator readahead for blob
+// files. Designed to be accessed by a single thread only: every (sub)compaction
+// or iterator needs its own buffers since they are guaranteed to read different
+// blobs from different positions even when reading the same file.
 class PrefetchBufferCollection {
  public:
-  explicit PrefetchBufferCollection(uint64_t readahead_size)
-      : readahead_size_(readahead_size) {
-    assert(readahead_size_ > 0);
+  explicit PrefetchBufferCollection(uint64_t readahead_size) {
+    assert(readahead_size > 0);
+    readahead_params_.initial_readahead_size =
+        static_cast<size_t>(readahead_size);
+    readahead_params_.max_readahead_size = static_cast<size_t>(readahead_size);
+  }
+
+  explicit PrefetchBufferCollection(const ReadaheadParams& readahead_params)
+      : readahead_params_(readahead_params) {
+    assert(readahead_params_.initial_readahead_size > 0);
   }
 
   FilePrefetchBuffer* GetOrCreatePrefetchBuffer(uint64_t file_number);
 
  private:
-  uint64_t readahead_size_;
+  ReadaheadParams readahead_params_;
   std::unordered_map<uint64_t, std::unique_ptr<FilePrefetchBuffer>>
       prefetch_buffers_;  // maps file number to prefetch buffer
 };
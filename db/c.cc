@@ -1652,6 +1652,52 @@ void rocksdb_batched_multi_get_cf(rocksdb_t* db,
   delete[] statuses;
 }
 
+size_t rocksdb_batched_multi_get_cf_into_buffer(
+    rocksdb_t* db, const rocksdb_readoptions_t* options,
+    rocksdb_column_family_handle_t* column_family, size_t num_keys,
+    const char* const* keys_list, const size_t* keys_list_sizes,
+    unsigned char sorted_input, char* values_buffer, size_t values_buffer_size,
+    size_t* values_offsets, size_t* values_sizes, unsigned char* statuses,
+    char** errptr) {
+  std::vector<Slice> key_slices(num_keys);
+  std::vector<PinnableSlice> value_slices(num_keys);
+  std::vector<Status> key_statuses(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    key_slices[i] = Slice(keys_list[i], keys_list_sizes[i]);
+  }
+
+  db->rep->MultiGet(options->rep, column_family->rep, num_keys,
+                    key_slices.data(), value_slices.data(),
+                    key_statuses.data(), sorted_input);
+
+  size_t used = 0;
+  bool error_saved = false;
+  for (size_t i = 0; i < num_keys; ++i) {
+    values_offsets[i] = used;
+    values_sizes[i] = 0;
+    if (key_statuses[i].ok()) {
+      values_sizes[i] = value_slices[i].size();
+      if (values_buffer_size - used < value_slices[i].size()) {
+        statuses[i] = rocksdb_multi_get_no_space;
+        continue;
+      }
+      memcpy(values_buffer + used, value_slices[i].data(),
+             value_slices[i].size());
+      used += value_slices[i].size();
+      statuses[i] = rocksdb_multi_get_found;
+    } else if (key_statuses[i].IsNotFound()) {
+      statuses[i] = rocksdb_multi_get_not_found;
+    } else {
+      statuses[i] = rocksdb_multi_get_error;
+      if (!error_saved) {
+        SaveError(errptr, key_statuses[i]);
+        error_saved = true;
+      }
+    }
+  }
+  return used;
+}
+
 unsigned char rocksdb_key_may_exist(rocksdb_t* db,
                                     const rocksdb_readoptions_t* options,
                                     const char* key, size_t key_len,
@@ -2072,6 +2118,31 @@ void rocksdb_iter_get_error(const rocksdb_iterator_t* iter, char** errptr) {
   SaveError(errptr, iter->rep->status());
 }
 
+size_t rocksdb_iter_next_batch(rocksdb_iterator_t* iter, size_t max_entries,
+                               char* buffer, size_t buffer_size,
+                               size_t* offsets, size_t* keys_sizes,
+                               size_t* values_sizes) {
+  Iterator* it = iter->rep;
+  size_t used = 0;
+  size_t num_entries = 0;
+  for (; num_entries < max_entries && it->Valid(); it->Next()) {
+    const Slice key = it->key();
+    const Slice value = it->value();
+    if (buffer_size - used < key.size() + value.size()) {
+      break;
+    }
+    offsets[num_entries] = used;
+    keys_sizes[num_entries] = key.size();
+    values_sizes[num_entries] = value.size();
+    memcpy(buffer + used, key.data(), key.size());
+    used += key.size();
+    memcpy(buffer + used, value.data(), value.size());
+    used += value.size();
+    ++num_entries;
+  }
+  return num_entries;
+}
+
 void rocksdb_iter_refresh(const rocksdb_iterator_t* iter, char** errptr) {
   SaveError(errptr, iter->rep->Refresh());
 }
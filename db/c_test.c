@@ -1924,6 +1924,54 @@ int main(int argc, char** argv) {
         CheckEqual(expected_value[i], val, val_len);
         rocksdb_pinnableslice_destroy(pvals[i]);
       }
+
+      // Only "rocksdb" of the first three values does not fit
+      char values_buffer[4];
+      size_t values_offsets[4];
+      size_t values_sizes[4];
+      unsigned char statuses[4];
+      size_t used = rocksdb_batched_multi_get_cf_into_buffer(
+          db, roptions, handles[1], 4, batched_keys, batched_keys_sizes, 0,
+          values_buffer, sizeof(values_buffer), values_offsets, values_sizes,
+          statuses, &err);
+      CheckNoError(err);
+      CheckCondition(used == 2);
+      CheckCondition(statuses[0] == rocksdb_multi_get_found);
+      CheckEqual("c", values_buffer + values_offsets[0], values_sizes[0]);
+      CheckCondition(statuses[1] == rocksdb_multi_get_no_space);
+      CheckCondition(values_sizes[1] == 7);
+      CheckCondition(statuses[2] == rocksdb_multi_get_not_found);
+      CheckCondition(statuses[3] == rocksdb_multi_get_found);
+      CheckEqual("c", values_buffer + values_offsets[3], values_sizes[3]);
+    }
+
+    {
+      char buffer[64];
+      size_t offsets[4];
+      size_t keys_sizes[4];
+      size_t values_sizes[4];
+      rocksdb_iterator_t* batch_iter =
+          rocksdb_create_iterator_cf(db, roptions, handles[1]);
+      rocksdb_iter_seek_to_first(batch_iter);
+      // Nothing fits in a buffer this small
+      CheckCondition(rocksdb_iter_next_batch(batch_iter, 4, buffer, 2, offsets,
+                                             keys_sizes, values_sizes) == 0);
+      CheckCondition(rocksdb_iter_valid(batch_iter));
+      CheckCondition(rocksdb_iter_next_batch(batch_iter, 2, buffer,
+                                             sizeof(buffer), offsets,
+                                             keys_sizes, values_sizes) == 2);
+      CheckEqual("baz", buffer + offsets[0], keys_sizes[0]);
+      CheckEqual("a", buffer + offsets[0] + keys_sizes[0], values_sizes[0]);
+      CheckEqual("box", buffer + offsets[1], keys_sizes[1]);
+      CheckEqual("c", buffer + offsets[1] + keys_sizes[1], values_sizes[1]);
+      CheckCondition(rocksdb_iter_next_batch(batch_iter, 4, buffer,
+                                             sizeof(buffer), offsets,
+                                             keys_sizes, values_sizes) == 2);
+      CheckEqual("buff", buffer + offsets[0], keys_sizes[0]);
+      CheckCondition(!rocksdb_iter_valid(batch_iter));
+      rocksdb_iter_get_error(batch_iter, &err);
+      CheckNoError(err);
+      rocksdb_iter_destroy(batch_iter);
     }
 
     {
@@ -40,6 +40,7 @@
 #include "util/autovector.h"
 #include "util/cast_util.h"
 #include "util/compression.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -273,6 +274,11 @@ ColumnFamilyOptions SanitizeCfOptions(const ImmutableDBOptions& db_options,
   } else if (result.memtable_prefix_bloom_size_ratio < 0) {
     result.memtable_prefix_bloom_size_ratio = 0;
   }
+  if (result.memtable_point_lookup_index_ratio > 0.25) {
+    result.memtable_point_lookup_index_ratio = 0.25;
+  } else if (result.memtable_point_lookup_index_ratio < 0) {
+    result.memtable_point_lookup_index_ratio = 0;
+  }
 
   if (!result.prefix_extractor) {
     assert(result.memtable_factory);
@@ -692,6 +698,21 @@ ColumnFamilyData::ColumnFamilyData(
               CacheReservationManagerImpl<CacheEntryRole::kFileMetadata>>(
               bbto->block_cache)));
     }
+    const auto compaction_buffer_charged =
+        options_overrides.at(CacheEntryRole::kCompactionBuffer).charged;
+    if (bbto->block_cache && compaction_buffer_charged ==
+                                 CacheEntryRoleOptions::Decision::kEnabled) {
+      compaction_buffer_cache_res_mgr_.reset(
+          new ConcurrentCacheReservationManager(
+              std::make_shared<CacheReservationManagerImpl<
+                  CacheEntryRole::kCompactionBuffer>>(bbto->block_cache)));
+    }
+    if (bbto->block_cache && ioptions_.bottommost_hash_index) {
+      bottommost_hash_index_cache_res_mgr_.reset(
+          new ConcurrentCacheReservationManager(
+              std::make_shared<CacheReservationManagerImpl<
+                  CacheEntryRole::kBottommostHashIndex>>(bbto->block_cache)));
+    }
   }
 }
 
@@ -764,7 +785,10 @@ bool ColumnFamilyData::UnrefAndTryDelete() {
   if (old_refs == 2 && super_version_ != nullptr) {
     // Only the super_version_ holds me
     SuperVersion* sv = super_version_;
-    super_version_ = nullptr;
+    {
+      std::lock_guard<SpinMutex> l(super_version_ref_mutex_);
+      super_version_ = nullptr;
+    }
 
     // Release SuperVersion references kept in ThreadLocalPtr.
     local_sv_.reset();
@@ -819,11 +843,28 @@ const double kNearStopSlowdownRatio = 0.6;
 const double kDelayRecoverSlowdownRatio = 1.4;
 
 namespace {
+// Where value is between the thresholds of delaying and stopping writes, from
+// 0 to 1
+double StallPressure(uint64_t value, uint64_t delay_threshold,
+                     uint64_t stop_threshold) {
+  if (stop_threshold <= delay_threshold) {
+    return 0.5;
+  }
+  if (value <= delay_threshold) {
+    return 0;
+  }
+  return std::min(1.0, static_cast<double>(value - delay_threshold) /
+                           static_cast<double>(stop_threshold -
+                                               delay_threshold));
+}
+
 // If penalize_stop is true, we further reduce slowdown rate.
+// pressure is the StallPressure() of the cause of the delay, used by the
+// adaptive write controller.
 std::unique_ptr<WriteControllerToken> SetupDelay(
-    WriteController* write_controller, uint64_t compaction_needed_bytes,
-    uint64_t prev_compaction_need_bytes, bool penalize_stop,
-    bool auto_compactions_disabled) {
+    WriteController* write_controller, SystemClock* clock,
+    uint64_t compaction_needed_bytes, uint64_t prev_compaction_need_bytes,
+    bool penalize_stop, double pressure, bool auto_compactions_disabled) {
   const uint64_t kMinWriteRate = 16 * 1024u;  // Minimum write rate 16KB/s.
 
   uint64_t max_write_rate = write_controller->max_delayed_write_rate();
@@ -832,6 +873,10 @@ std::unique_ptr<WriteControllerToken> SetupDelay(
   if (auto_compactions_disabled) {
     // When auto compaction is disabled, always use the value user gave.
     write_rate = max_write_rate;
+  } else if (write_controller->adaptive() &&
+             write_controller->drain_rate() > 0) {
+    write_rate = write_controller->AdaptiveDelayedWriteRate(
+        clock, penalize_stop ? 1.0 : pressure);
   } else if (write_controller->NeedsDelay() && max_write_rate > kMinWriteRate) {
     // If user gives rate less than kMinWriteRate, don't adjust it.
     //
@@ -1048,10 +1093,11 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
           name_.c_str(), compaction_needed_bytes);
     } else if (write_stall_condition == WriteStallCondition::kDelayed &&
                write_stall_cause == WriteStallCause::kMemtableLimit) {
-      write_controller_token_ =
-          SetupDelay(write_controller, compaction_needed_bytes,
-                     prev_compaction_needed_bytes_, was_stopped,
-                     mutable_cf_options.disable_auto_compactions);
+      // There is a single immutable memtable between delaying and stopping
+      write_controller_token_ = SetupDelay(
+          write_controller, ioptions_.clock, compaction_needed_bytes,
+          prev_compaction_needed_bytes_, was_stopped, /*pressure=*/0.5,
+          mutable_cf_options.disable_auto_compactions);
       internal_stats_->AddCFStats(InternalStats::MEMTABLE_LIMIT_DELAYS, 1);
       ROCKS_LOG_WARN(
           ioptions_.logger,
@@ -1066,10 +1112,14 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       // L0 is the last two files from stopping.
       bool near_stop = vstorage->l0_delay_trigger_count() >=
                        mutable_cf_options.level0_stop_writes_trigger - 2;
-      write_controller_token_ =
-          SetupDelay(write_controller, compaction_needed_bytes,
-                     prev_compaction_needed_bytes_, was_stopped || near_stop,
-                     mutable_cf_options.disable_auto_compactions);
+      double pressure = StallPressure(
+          vstorage->l0_delay_trigger_count(),
+          mutable_cf_options.level0_slowdown_writes_trigger,
+          mutable_cf_options.level0_stop_writes_trigger);
+      write_controller_token_ = SetupDelay(
+          write_controller, ioptions_.clock, compaction_needed_bytes,
+          prev_compaction_needed_bytes_, was_stopped || near_stop, pressure,
+          mutable_cf_options.disable_auto_compactions);
       internal_stats_->AddCFStats(InternalStats::L0_FILE_COUNT_LIMIT_DELAYS, 1);
       if (compaction_picker_->IsLevel0CompactionInProgress()) {
         internal_stats_->AddCFStats(
@@ -1095,10 +1145,14 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
                    mutable_cf_options.soft_pending_compaction_bytes_limit) /
                   4;
 
-      write_controller_token_ =
-          SetupDelay(write_controller, compaction_needed_bytes,
-                     prev_compaction_needed_bytes_, was_stopped || near_stop,
-                     mutable_cf_options.disable_auto_compactions);
+      double pressure =
+          StallPressure(compaction_needed_bytes,
+                        mutable_cf_options.soft_pending_compaction_bytes_limit,
+                        mutable_cf_options.hard_pending_compaction_bytes_limit);
+      write_controller_token_ = SetupDelay(
+          write_controller, ioptions_.clock, compaction_needed_bytes,
+          prev_compaction_needed_bytes_, was_stopped || near_stop, pressure,
+          mutable_cf_options.disable_auto_compactions);
       internal_stats_->AddCFStats(
           InternalStats::PENDING_COMPACTION_BYTES_LIMIT_DELAYS, 1);
       ROCKS_LOG_WARN(
@@ -1154,8 +1208,12 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       // increase signal.
       if (needed_delay) {
         uint64_t write_rate = write_controller->delayed_write_rate();
-        write_controller->set_delayed_write_rate(static_cast<uint64_t>(
-            static_cast<double>(write_rate) * kDelayRecoverSlowdownRatio));
+        // The adaptive controller resumes from the rate it left
+        if (!write_controller->adaptive() ||
+            write_controller->drain_rate() == 0) {
+          write_controller->set_delayed_write_rate(static_cast<uint64_t>(
+              static_cast<double>(write_rate) * kDelayRecoverSlowdownRatio));
+        }
         // Set the low pri limit to be 1/4 the delayed write rate.
         // Note we don't reset this value even after delay condition is relased.
         // Low-pri rate will continue to apply if there is a compaction
@@ -1169,6 +1227,10 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
   return write_stall_condition;
 }
 
+WriteController* ColumnFamilyData::write_controller() const {
+  return column_family_set_->write_controller();
+}
+
 const FileOptions* ColumnFamilyData::soptions() const {
   return &(column_family_set_->file_options_);
 }
@@ -1330,7 +1392,7 @@ SuperVersion* ColumnFamilyData::GetReferencedSuperVersion(DBImpl* db) {
   return sv;
 }
 
-SuperVersion* ColumnFamilyData::GetThreadLocalSuperVersion(DBImpl* db) {
+SuperVersion* ColumnFamilyData::GetThreadLocalSuperVersion(DBImpl* /*db*/) {
   // The SuperVersion is cached in thread local storage to avoid acquiring
   // mutex when SuperVersion does not change since the last use. When a new
   // SuperVersion is installed, the compaction or flush thread cleans up
@@ -1352,9 +1414,10 @@ SuperVersion* ColumnFamilyData::GetThreadLocalSuperVersion(DBImpl* db) {
   SuperVersion* sv = static_cast<SuperVersion*>(ptr);
   if (sv == SuperVersion::kSVObsolete) {
     RecordTick(ioptions_.stats, NUMBER_SUPERVERSION_ACQUIRES);
-    db->mutex()->Lock();
+    // super_version_ keeps its reference until it is replaced, which cannot
+    // happen while we hold this lock
+    std::lock_guard<SpinMutex> l(super_version_ref_mutex_);
     sv = super_version_->Ref();
-    db->mutex()->Unlock();
   }
   assert(sv != nullptr);
   return sv;
@@ -1393,7 +1456,10 @@ void ColumnFamilyData::InstallSuperVersion(
                              ? super_version_->ShareSeqnoToTimeMapping()
                              : nullptr);
   SuperVersion* old_superversion = super_version_;
-  super_version_ = new_superversion;
+  {
+    std::lock_guard<SpinMutex> l(super_version_ref_mutex_);
+    super_version_ = new_superversion;
+  }
   if (old_superversion == nullptr || old_superversion->current != current() ||
       old_superversion->mem != mem_ ||
       old_superversion->imm != imm_.current()) {
@@ -1528,6 +1594,12 @@ Status ColumnFamilyData::ValidateOptions(
           "The garbage ratio threshold for forcing blob garbage collection "
           "should be in the range [0.0, 1.0].");
     }
+    if (cf_options.blob_garbage_collection_file_threshold < 0.0 ||
+        cf_options.blob_garbage_collection_file_threshold > 1.0) {
+      return Status::InvalidArgument(
+          "The garbage ratio threshold for garbage collecting a blob file "
+          "should be in the range [0.0, 1.0].");
+    }
   }
 
   if (cf_options.compaction_style == kCompactionStyleFIFO &&
@@ -1702,6 +1774,30 @@ void ColumnFamilyData::RecoverEpochNumbers() {
   vstorage->RecoverEpochNumbers(this);
 }
 
+void ColumnFamilyData::RecordCompactionValueSizes(
+    const HistogramStat& value_sizes) {
+  MutexLock l(&value_sizes_mutex_);
+  newer_value_sizes_.Merge(value_sizes);
+  if (newer_value_sizes_.num() >= kValueSizeWindow) {
+    older_value_sizes_.Clear();
+    older_value_sizes_.Merge(newer_value_sizes_);
+    newer_value_sizes_.Clear();
+  }
+}
+
+uint64_t ColumnFamilyData::GetRecentValueSizePercentile(double p) {
+  HistogramStat value_sizes;
+  {
+    MutexLock l(&value_sizes_mutex_);
+    value_sizes.Merge(older_value_sizes_);
+    value_sizes.Merge(newer_value_sizes_);
+  }
+  if (value_sizes.Empty()) {
+    return 0;
+  }
+  return static_cast<uint64_t>(value_sizes.Percentile(p));
+}
+
 ColumnFamilySet::ColumnFamilySet(const std::string& dbname,
                                  const ImmutableDBOptions* db_options,
                                  const FileOptions& file_options,
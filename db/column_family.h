@@ -21,7 +21,9 @@
 #include "db/table_properties_collector.h"
 #include "db/write_batch_internal.h"
 #include "db/write_controller.h"
+#include "monitoring/histogram.h"
 #include "options/cf_options.h"
+#include "port/port.h"
 #include "rocksdb/compaction_job_stats.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
@@ -29,6 +31,7 @@
 #include "trace_replay/block_cache_tracer.h"
 #include "util/cast_util.h"
 #include "util/hash_containers.h"
+#include "util/mutexlock.h"
 #include "util/thread_local.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -566,10 +569,19 @@ class ColumnFamilyData {
 
   ThreadLocalPtr* TEST_GetLocalSV() { return local_sv_.get(); }
   WriteBufferManager* write_buffer_mgr() { return write_buffer_manager_; }
+  WriteController* write_controller() const;
   std::shared_ptr<CacheReservationManager>
   GetFileMetadataCacheReservationManager() {
     return file_metadata_cache_res_mgr_;
   }
+  std::shared_ptr<CacheReservationManager>
+  GetCompactionBufferCacheReservationManager() {
+    return compaction_buffer_cache_res_mgr_;
+  }
+  std::shared_ptr<CacheReservationManager>
+  GetBottommostHashIndexCacheReservationManager() {
+    return bottommost_hash_index_cache_res_mgr_;
+  }
 
   static const uint32_t kDummyColumnFamilyDataId;
 
@@ -599,6 +611,12 @@ class ColumnFamilyData {
     return (mem_->IsEmpty() ? 0 : 1) + imm_.NumNotFlushed();
   }
 
+  // Sizes of the values written by recent compactions, from which the next
+  // ones pick their minimum blob size (see blob_separation_percent).
+  void RecordCompactionValueSizes(const HistogramStat& value_sizes);
+  // Returns 0 if no value was recorded yet.
+  uint64_t GetRecentValueSizePercentile(double p);
+
  private:
   friend class ColumnFamilySet;
   ColumnFamilyData(
@@ -650,6 +668,9 @@ class ColumnFamilyData {
   MemTable* mem_;
   MemTableList imm_;
   SuperVersion* super_version_;
+  // Held, on top of the DB mutex, to change super_version_, so that readers
+  // can reference the current SuperVersion without the DB mutex
+  SpinMutex super_version_ref_mutex_;
 
   // An ordinal representing the current SuperVersion. Updated by
   // InstallSuperVersion(), i.e. incremented every time super_version_
@@ -704,9 +725,23 @@ class ColumnFamilyData {
   // For charging memory usage of file metadata created for newly added files to
   // a Version associated with this CFD
   std::shared_ptr<CacheReservationManager> file_metadata_cache_res_mgr_;
+  // For charging memory usage of the buffers of the running compactions of
+  // this CFD
+  std::shared_ptr<CacheReservationManager> compaction_buffer_cache_res_mgr_;
+  // For charging memory usage of the hash indexes of the files written by
+  // bottommost compactions of this CFD
+  std::shared_ptr<CacheReservationManager>
+      bottommost_hash_index_cache_res_mgr_;
   bool mempurge_used_;
 
   std::atomic<uint64_t> next_epoch_number_;
+
+  // Once the newer histogram holds this many values, it replaces the older
+  // one and starts over.
+  static constexpr uint64_t kValueSizeWindow = uint64_t{1} << 20;
+  port::Mutex value_sizes_mutex_;
+  HistogramStat older_value_sizes_;
+  HistogramStat newer_value_sizes_;
 };
 
 // ColumnFamilySet has interesting thread-safety requirements
@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
@@ -19,7 +20,6 @@
 #include "rocksdb/sst_partitioner.h"
 #include "test_util/sync_point.h"
 #include "util/string_util.h"
-extern bool FLAGS_warmup_after_evict;
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -73,6 +73,39 @@ void Compaction::FinalizeInputInfo(Version* _input_version) {
   cfd_->Ref();
   input_version_->Ref();
   edit_.SetColumnFamily(cfd_->GetID());
+  min_blob_size_ = ComputeMinBlobSize();
+}
+
+uint64_t Compaction::ComputeMinBlobSize() const {
+  const uint64_t min_blob_size = mutable_cf_options_.min_blob_size;
+  const uint32_t percent = mutable_cf_options_.blob_separation_percent;
+  if (!mutable_cf_options_.enable_blob_files || percent == 0) {
+    return min_blob_size;
+  }
+
+  // Separate the values larger than all but `percent` of the recent ones
+  const uint64_t percentile =
+      cfd_->GetRecentValueSizePercentile(100.0 - std::min(percent, 100U));
+  uint64_t threshold =
+      percentile > 0 ? std::max(min_blob_size, percentile + 1) : min_blob_size;
+
+  // Extra blob reads cost more than blob writes save for files that are read
+  // more often than they are rewritten
+  uint64_t num_reads = 0;
+  uint64_t num_entries = 0;
+  for (const auto& level_files : inputs_) {
+    for (const FileMetaData* file : level_files.files) {
+      num_reads +=
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+      num_entries += file->num_entries;
+    }
+  }
+  if (num_entries > 0 && num_reads > num_entries) {
+    const double factor =
+        std::min(static_cast<double>(num_reads) / num_entries, 4.0);
+    threshold = static_cast<uint64_t>(static_cast<double>(threshold) * factor);
+  }
+  return threshold;
 }
 
 void Compaction::GetBoundaryKeys(
@@ -315,10 +348,11 @@ Compaction::Compaction(
       bottommost_level_(
           // For simplicity, we don't support the concept of "bottommost level"
           // with
-          // `CompactionReason::kExternalSstIngestion` and
-          // `CompactionReason::kRefitLevel`
+          // `CompactionReason::kExternalSstIngestion`,
+          // `CompactionReason::kRefitLevel` and `CompactionReason::kFlush`
           (_compaction_reason == CompactionReason::kExternalSstIngestion ||
-           _compaction_reason == CompactionReason::kRefitLevel)
+           _compaction_reason == CompactionReason::kRefitLevel ||
+           _compaction_reason == CompactionReason::kFlush)
               ? false
               : IsBottommostLevel(output_level_, vstorage, inputs_)),
       is_full_compaction_(IsFullCompaction(vstorage, inputs_)),
@@ -341,10 +375,11 @@ Compaction::Compaction(
               : _blob_garbage_collection_age_cutoff),
       proximal_level_(
           // For simplicity, we don't support the concept of "proximal level"
-          // with `CompactionReason::kExternalSstIngestion` and
-          // `CompactionReason::kRefitLevel`
+          // with `CompactionReason::kExternalSstIngestion`,
+          // `CompactionReason::kRefitLevel` and `CompactionReason::kFlush`
           _compaction_reason == CompactionReason::kExternalSstIngestion ||
-                  _compaction_reason == CompactionReason::kRefitLevel
+                  _compaction_reason == CompactionReason::kRefitLevel ||
+                  _compaction_reason == CompactionReason::kFlush
               ? Compaction::kInvalidLevel
               : EvaluateProximalLevel(vstorage, mutable_cf_options_,
                                       immutable_options_, start_level_,
@@ -903,6 +938,11 @@ std::unique_ptr<SstPartitioner> Compaction::CreateSstPartitioner() const {
   context.output_level = output_level_;
   context.smallest_user_key = smallest_user_key_;
   context.largest_user_key = largest_user_key_;
+  context.comparator = immutable_options_.user_comparator;
+  context.hot_key_ranges.reserve(hot_input_key_ranges_.size());
+  for (const auto& range : hot_input_key_ranges_) {
+    context.hot_key_ranges.emplace_back(range.smallest, range.largest);
+  }
   return immutable_options_.sst_partitioner_factory->CreatePartitioner(context);
 }
 
@@ -940,6 +980,21 @@ bool Compaction::ShouldFormSubcompactions() const {
   }
 }
 
+CompactionWarmupMode Compaction::OutputWarmupMode() const {
+  const CompactionWarmupPolicy& policy =
+      mutable_cf_options_.compaction_warmup_policy;
+  if (is_last_level_promotion()) {
+    // The files were promoted for being read
+    return policy.mode == CompactionWarmupMode::kDisabled
+               ? CompactionWarmupMode::kOutputFiles
+               : policy.mode;
+  }
+  if (policy.max_output_level >= 0 && output_level_ > policy.max_output_level) {
+    return CompactionWarmupMode::kDisabled;
+  }
+  return policy.mode;
+}
+
 bool Compaction::DoesInputReferenceBlobFiles() const {
   assert(input_version_);
 
@@ -290,6 +290,13 @@ class Compaction {
                .allow_trivial_copy_when_change_temperature;
   }
 
+  // Whether this compaction moves last level files off
+  // last_level_temperature, see `last_level_promotion_reads`
+  bool is_last_level_promotion() const {
+    return immutable_options_.compaction_style == kCompactionStyleLevel &&
+           compaction_reason_ == CompactionReason::kChangeTemperature;
+  }
+
   // How many total levels are there?
   int number_levels() const { return number_levels_; }
 
@@ -336,6 +343,12 @@ class Compaction {
   // Should this compaction be broken up into smaller ones run in parallel?
   bool ShouldFormSubcompactions() const;
 
+  // How the output files of this compaction are to be warmed once its result
+  // is installed, per the column family's `compaction_warmup_policy`.
+  // kDisabled if the policy does not cover the output level, which promotions
+  // out of the last level temperature always are.
+  CompactionWarmupMode OutputWarmupMode() const;
+
   // Returns true iff at least one input file references a blob file.
   //
   // PRE: input version has been set.
@@ -361,6 +374,12 @@ class Compaction {
     return input_table_properties_;
   }
 
+  // The hot key ranges of the inputs, for the SstPartitioners created
+  // afterwards, see SstPartitionerFactory::NeedsHotKeyRanges().
+  void SetHotInputKeyRanges(std::vector<TableReader::HotKeyRange> ranges) {
+    hot_input_key_ranges_ = std::move(ranges);
+  }
+
   // TODO(hx235): consider making this function symmetric to
   // InitInputTableProperties()
   void SetOutputTableProperties(
@@ -422,6 +441,12 @@ class Compaction {
     return blob_garbage_collection_age_cutoff_;
   }
 
+  // The size of the smallest value that the compaction writes to a blob file,
+  // see blob_separation_percent.
+  //
+  // PRE: input version has been set.
+  uint64_t min_blob_size() const { return min_blob_size_; }
+
   // start and end are sub compact range. Null if no boundary.
   // This is used to calculate the newest_key_time table property after
   // compaction.
@@ -494,6 +519,10 @@ class Compaction {
   // `Compaction::WithinProximalLevelOutputRange()`.
   void PopulateProximalLevelOutputRange();
 
+  // Adapts min_blob_size to the recent values and the reads of the input
+  // files if blob_separation_percent is set.
+  uint64_t ComputeMinBlobSize() const;
+
   // If oldest snapshot is specified at Compaction construction time, we have
   // an opportunity to optimize inputs for compaction iterator for this case:
   // When a standalone range deletion file on the start level is recognized and
@@ -598,6 +627,8 @@ class Compaction {
   TablePropertiesCollection input_table_properties_;
   TablePropertiesCollection output_table_properties_;
 
+  std::vector<TableReader::HotKeyRange> hot_input_key_ranges_;
+
   // smallest user keys in compaction
   // includes timestamp if user-defined timestamp is enabled.
   Slice smallest_user_key_;
@@ -619,6 +650,9 @@ class Compaction {
   // Blob garbage collection age cutoff.
   double blob_garbage_collection_age_cutoff_;
 
+  // Minimum blob size, set along with the input version.
+  uint64_t min_blob_size_ = 0;
+
   SequenceNumber keep_in_last_level_through_seqno_ = kMaxSequenceNumber;
 
   // only set when per_key_placement feature is enabled, -1 (kInvalidLevel)
@@ -44,6 +44,8 @@ struct CompactionIterationStats {
   uint64_t total_blob_bytes_read = 0;
   uint64_t num_blobs_relocated = 0;
   uint64_t total_blob_bytes_relocated = 0;
+  // Relocated blobs inserted into the blob cache at their new location
+  uint64_t num_relocated_blobs_warmed = 0;
 
   // TimedPut diagnostics
   // Total number of kTypeValuePreferredSeqno records encountered.
@@ -22,6 +22,102 @@
 #include "test_util/sync_point.h"
 
 namespace ROCKSDB_NAMESPACE {
+FilterBatchIterator::FilterBatchIterator(InternalIterator* iter,
+                                         const Comparator* cmp,
+                                         const CompactionFilter* filter,
+                                         int level, SystemClock* clock,
+                                         bool report_detailed_time,
+                                         uint64_t* total_filter_time)
+    : icmp_(cmp),
+      inner_iter_(iter),
+      filter_(filter),
+      level_(level),
+      batch_size_(filter->GetFilterBatchSize()),
+      clock_(clock),
+      report_detailed_time_(report_detailed_time),
+      total_filter_time_(total_filter_time) {
+  assert(batch_size_ > 0);
+}
+
+void FilterBatchIterator::Seek(const Slice& target) {
+  while (Valid() && icmp_.Compare(key(), target) < 0) {
+    ++pos_;
+  }
+  if (!Valid()) {
+    // Past the batch, the input is after its last entry
+    inner_iter_->Seek(target);
+    ReadBatch();
+  }
+}
+
+void FilterBatchIterator::ReadBatch() {
+  // The entries of the previous batch that are still referenced are
+  // overwritten only by the next batch
+  batch_.swap(prev_batch_);
+  size_ = 0;
+  pos_ = 0;
+  filtered_.clear();
+  while (size_ < batch_size_ && inner_iter_->Valid()) {
+    if (size_ == batch_.size()) {
+      batch_.emplace_back();
+    }
+    Entry& entry = batch_[size_];
+    const Slice k = inner_iter_->key();
+    const Slice v = inner_iter_->value();
+    entry.key.assign(k.data(), k.size());
+    entry.value.assign(v.data(), v.size());
+    entry.is_range_del = inner_iter_->IsDeleteRangeSentinelKey();
+    entry.decision = CompactionFilter::Decision::kUndetermined;
+    ParsedInternalKey ikey;
+    if (!entry.is_range_del &&
+        ParseInternalKey(k, &ikey, /*log_err_key=*/false).ok() &&
+        ikey.type == kTypeValue) {
+      filtered_.push_back(size_);
+    }
+    ++size_;
+    inner_iter_->Next();
+  }
+  if (filtered_.empty()) {
+    return;
+  }
+
+  keys_.clear();
+  values_.clear();
+  for (size_t i : filtered_) {
+    keys_.push_back(ExtractUserKey(batch_[i].key));
+    values_.push_back(batch_[i].value);
+  }
+  decisions_.assign(filtered_.size(),
+                    CompactionFilter::Decision::kUndetermined);
+  new_values_.assign(filtered_.size(), std::string());
+  {
+    StopWatchNano timer(clock_, report_detailed_time_);
+    filter_->FilterBatch(level_, keys_, values_, &decisions_, &new_values_);
+    *total_filter_time_ += report_detailed_time_ ? timer.ElapsedNanos() : 0;
+  }
+  if (decisions_.size() != filtered_.size() ||
+      new_values_.size() != filtered_.size()) {
+    // Leave all of them to FilterV3()
+    assert(false);
+    return;
+  }
+  for (size_t i = 0; i < filtered_.size(); ++i) {
+    Entry& entry = batch_[filtered_[i]];
+    switch (decisions_[i]) {
+      case CompactionFilter::Decision::kChangeValue:
+        entry.new_value.swap(new_values_[i]);
+        FALLTHROUGH_INTENDED;
+      case CompactionFilter::Decision::kKeep:
+      case CompactionFilter::Decision::kRemove:
+      case CompactionFilter::Decision::kPurge:
+        entry.decision = decisions_[i];
+        break;
+      default:
+        break;
+    }
+  }
+}
+
 CompactionIterator::CompactionIterator(
     InternalIterator* input, const Comparator* cmp, MergeHelper* merge_helper,
     SequenceNumber last_sequence, std::vector<SequenceNumber>* snapshots,
@@ -66,7 +162,16 @@ CompactionIterator::CompactionIterator(
     const std::shared_ptr<Logger> info_log,
     const std::string* full_history_ts_low,
     std::optional<SequenceNumber> preserve_seqno_min)
-    : input_(input, cmp, must_count_input_entries),
+    : filter_batch_iter_(
+          compaction_filter && compaction_filter->GetFilterBatchSize() > 0
+              ? std::make_unique<FilterBatchIterator>(
+                    input, cmp, compaction_filter,
+                    compaction ? compaction->level() : 0,
+                    env->GetSystemClock().get(), report_detailed_time,
+                    &iter_stats_.total_filter_time)
+              : nullptr),
+      input_(filter_batch_iter_ ? filter_batch_iter_.get() : input, cmp,
+             must_count_input_entries),
       cmp_(cmp),
       merge_helper_(merge_helper),
       snapshots_(snapshots),
@@ -100,6 +205,11 @@ CompactionIterator::CompactionIterator(
       merge_out_iter_(merge_helper_),
       blob_garbage_collection_cutoff_file_number_(
           ComputeBlobGarbageCollectionCutoffFileNumber(compaction_.get())),
+      blob_files_over_garbage_threshold_(
+          ComputeBlobFilesOverGarbageThreshold(compaction_.get())),
+      min_blob_size_(compaction_ ? compaction_->min_blob_size() : 0),
+      record_value_sizes_(blob_file_builder_ && compaction_ &&
+                          compaction_->blob_separation_percent() > 0),
       blob_fetcher_(CreateBlobFetcherIfNeeded(compaction_.get())),
       prefetch_buffers_(
           CreatePrefetchBufferCollectionIfNeeded(compaction_.get())),
@@ -143,6 +253,9 @@ void CompactionIterator::ResetRecordCounts() {
 }
 
 void CompactionIterator::SeekToFirst() {
+  if (filter_batch_iter_) {
+    filter_batch_iter_->Start();
+  }
   NextFromInput();
   PrepareOutput();
 }
@@ -306,6 +419,15 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
       }
     }
 
+    if (filter_batch_iter_ && ikey_.type == kTypeValue && input_.Valid() &&
+        filter_batch_iter_->key() == key_) {
+      // Decided ahead by FilterBatch(), if not left to FilterV3()
+      decision = filter_batch_iter_->decision();
+      if (decision == CompactionFilter::Decision::kChangeValue) {
+        compaction_filter_value_ = filter_batch_iter_->new_value();
+      }
+    }
+
     if (decision == CompactionFilter::Decision::kUndetermined) {
       const Slice* existing_val = nullptr;
       const WideColumns* existing_col = nullptr;
@@ -1119,13 +1241,19 @@ void CompactionIterator::NextFromInput() {
   }
 }
 
-bool CompactionIterator::ExtractLargeValueIfNeededImpl() {
+bool CompactionIterator::ExtractLargeValueIfNeededImpl(bool warm_cache) {
   if (!blob_file_builder_) {
     return false;
   }
 
+  // The builder only knows about the min_blob_size option
+  if (value_.size() < min_blob_size_) {
+    return false;
+  }
+
   blob_index_.clear();
-  const Status s = blob_file_builder_->Add(user_key(), value_, &blob_index_);
+  const Status s =
+      blob_file_builder_->Add(user_key(), value_, &blob_index_, warm_cache);
 
   if (!s.ok()) {
     status_ = s;
@@ -1143,6 +1271,23 @@ bool CompactionIterator::ExtractLargeValueIfNeededImpl() {
   return true;
 }
 
+void CompactionIterator::RecordValueSizeIfNeeded() {
+  if (!record_value_sizes_) {
+    return;
+  }
+
+  if (ikey_.type == kTypeValue) {
+    value_sizes_.Add(value_.size());
+    return;
+  }
+
+  assert(ikey_.type == kTypeBlobIndex);
+  BlobIndex blob_index;
+  if (blob_index.DecodeFrom(value_).ok() && !blob_index.IsInlined()) {
+    value_sizes_.Add(blob_index.size());
+  }
+}
+
 void CompactionIterator::ExtractLargeValueIfNeeded() {
   assert(ikey_.type == kTypeValue);
 
@@ -1181,7 +1326,8 @@ void CompactionIterator::GarbageCollectBlobIfNeeded() {
     }
 
     if (blob_index.file_number() >=
-        blob_garbage_collection_cutoff_file_number_) {
+            blob_garbage_collection_cutoff_file_number_ &&
+        !blob_files_over_garbage_threshold_.count(blob_index.file_number())) {
       return;
     }
 
@@ -1214,7 +1360,15 @@ void CompactionIterator::GarbageCollectBlobIfNeeded() {
 
     value_ = blob_value_;
 
-    if (ExtractLargeValueIfNeededImpl()) {
+    // Carry a cached blob over to its new location, as the old one is
+    // garbage once the compaction is installed
+    const bool warm_cache = compaction_->warm_relocated_blobs() &&
+                            blob_fetcher_->IsBlobInCache(blob_index);
+
+    if (ExtractLargeValueIfNeededImpl(warm_cache)) {
+      if (warm_cache) {
+        ++iter_stats_.num_relocated_blobs_warmed;
+      }
       return;
     }
 
@@ -1257,8 +1411,10 @@ void CompactionIterator::PrepareOutput() {
   if (Valid()) {
     if (LIKELY(!is_range_del_)) {
       if (ikey_.type == kTypeValue) {
+        RecordValueSizeIfNeeded();
         ExtractLargeValueIfNeeded();
       } else if (ikey_.type == kTypeBlobIndex) {
+        RecordValueSizeIfNeeded();
         GarbageCollectBlobIfNeeded();
       }
     }
@@ -1399,6 +1555,39 @@ uint64_t CompactionIterator::ComputeBlobGarbageCollectionCutoffFileNumber(
   return meta->GetBlobFileNumber();
 }
 
+std::unordered_set<uint64_t>
+CompactionIterator::ComputeBlobFilesOverGarbageThreshold(
+    const CompactionProxy* compaction) {
+  std::unordered_set<uint64_t> file_numbers;
+
+  if (!compaction || !compaction->enable_blob_garbage_collection()) {
+    return file_numbers;
+  }
+
+  const double threshold = compaction->blob_garbage_collection_file_threshold();
+  if (threshold >= 1.0) {
+    return file_numbers;
+  }
+
+  const Version* const version = compaction->input_version();
+  assert(version);
+
+  const VersionStorageInfo* const storage_info = version->storage_info();
+  assert(storage_info);
+
+  for (const auto& meta : storage_info->GetBlobFiles()) {
+    assert(meta);
+
+    const uint64_t garbage_blob_bytes = meta->GetGarbageBlobBytes();
+    if (garbage_blob_bytes > 0 &&
+        garbage_blob_bytes >= threshold * meta->GetTotalBlobBytes()) {
+      file_numbers.insert(meta->GetBlobFileNumber());
+    }
+  }
+
+  return file_numbers;
+}
+
 std::unique_ptr<BlobFetcher> CompactionIterator::CreateBlobFetcherIfNeeded(
     const CompactionProxy* compaction) {
   if (!compaction) {
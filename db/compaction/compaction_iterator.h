@@ -17,6 +17,7 @@
 #include "db/pinned_iterators_manager.h"
 #include "db/range_del_aggregator.h"
 #include "db/snapshot_checker.h"
+#include "monitoring/histogram.h"
 #include "options/cf_options.h"
 #include "rocksdb/compaction_filter.h"
 
@@ -80,6 +81,95 @@ class SequenceIterWrapper : public InternalIterator {
   bool has_num_itered_ = true;
 };
 
+// Reads the input of a CompactionIterator ahead in batches, and passes the
+// plain values of each batch to CompactionFilter::FilterBatch(). The entries
+// are copied, and stay valid until the batch after the next one is read.
+class FilterBatchIterator : public InternalIterator {
+ public:
+  FilterBatchIterator(InternalIterator* iter, const Comparator* cmp,
+                      const CompactionFilter* filter, int level,
+                      SystemClock* clock, bool report_detailed_time,
+                      uint64_t* total_filter_time);
+
+  // Reads the first batch from the current position of the input.
+  void Start() { ReadBatch(); }
+
+  bool Valid() const override { return pos_ < size_; }
+  Status status() const override {
+    return Valid() ? Status::OK() : inner_iter_->status();
+  }
+  void Next() override {
+    assert(Valid());
+    if (++pos_ == size_) {
+      ReadBatch();
+    }
+  }
+  void Seek(const Slice& target) override;
+  Slice key() const override {
+    assert(Valid());
+    return batch_[pos_].key;
+  }
+  Slice value() const override {
+    assert(Valid());
+    return batch_[pos_].value;
+  }
+  bool IsDeleteRangeSentinelKey() const override {
+    assert(Valid());
+    return batch_[pos_].is_range_del;
+  }
+
+  // The decision of FilterBatch() for the current entry, or kUndetermined if
+  // there is none to apply. For kChangeValue, new_value() is the new value.
+  CompactionFilter::Decision decision() const {
+    assert(Valid());
+    return batch_[pos_].decision;
+  }
+  const std::string& new_value() const {
+    assert(Valid());
+    return batch_[pos_].new_value;
+  }
+
+  // Unused InternalIterator methods
+  void SeekToFirst() override { assert(false); }
+  void Prev() override { assert(false); }
+  void SeekForPrev(const Slice& /* target */) override { assert(false); }
+  void SeekToLast() override { assert(false); }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string value;
+    bool is_range_del = false;
+    CompactionFilter::Decision decision =
+        CompactionFilter::Decision::kUndetermined;
+    std::string new_value;
+  };
+
+  void ReadBatch();
+
+  InternalKeyComparator icmp_;
+  InternalIterator* inner_iter_;  // not owned
+  const CompactionFilter* filter_;
+  const int level_;
+  const size_t batch_size_;
+  SystemClock* clock_;
+  const bool report_detailed_time_;
+  uint64_t* total_filter_time_;
+  // The first `size_` entries of `batch_` are the current batch. The entries
+  // are reused across batches to keep the capacity of their strings.
+  std::vector<Entry> batch_;
+  std::vector<Entry> prev_batch_;
+  size_t size_ = 0;
+  size_t pos_ = 0;
+  // Positions in the batch of the plain values, and their arguments and
+  // results of FilterBatch()
+  std::vector<size_t> filtered_;
+  std::vector<Slice> keys_;
+  std::vector<Slice> values_;
+  std::vector<CompactionFilter::Decision> decisions_;
+  std::vector<std::string> new_values_;
+};
+
 class CompactionIterator {
  public:
   // A wrapper around Compaction. Has a much smaller interface, only what
@@ -108,8 +198,16 @@ class CompactionIterator {
 
     virtual double blob_garbage_collection_age_cutoff() const = 0;
 
+    virtual double blob_garbage_collection_file_threshold() const = 0;
+
     virtual uint64_t blob_compaction_readahead_size() const = 0;
 
+    virtual uint64_t min_blob_size() const = 0;
+
+    virtual uint32_t blob_separation_percent() const = 0;
+
+    virtual bool warm_relocated_blobs() const = 0;
+
     virtual const Version* input_version() const = 0;
 
     virtual bool DoesInputReferenceBlobFiles() const = 0;
@@ -160,10 +258,28 @@ class CompactionIterator {
       return compaction_->blob_garbage_collection_age_cutoff();
     }
 
+    double blob_garbage_collection_file_threshold() const override {
+      return compaction_->mutable_cf_options()
+          .blob_garbage_collection_file_threshold;
+    }
+
     uint64_t blob_compaction_readahead_size() const override {
       return compaction_->mutable_cf_options().blob_compaction_readahead_size;
     }
 
+    uint64_t min_blob_size() const override {
+      return compaction_->min_blob_size();
+    }
+
+    uint32_t blob_separation_percent() const override {
+      return compaction_->mutable_cf_options().blob_separation_percent;
+    }
+
+    bool warm_relocated_blobs() const override {
+      return compaction_->mutable_cf_options()
+          .compaction_warmup_policy.warm_relocated_blobs;
+    }
+
     const Version* input_version() const override {
       return compaction_->input_version();
     }
@@ -253,6 +369,9 @@ class CompactionIterator {
     return current_user_key_;
   }
   const CompactionIterationStats& iter_stats() const { return iter_stats_; }
+  // Sizes of the output values, only recorded for column families with
+  // blob_separation_percent set.
+  const HistogramStat& value_sizes() const { return value_sizes_; }
   bool HasNumInputEntryScanned() const { return input_.HasNumItered(); }
   uint64_t NumInputEntryScanned() const { return input_.NumItered(); }
   Status InputStatus() const { return input_.status(); }
@@ -269,8 +388,13 @@ class CompactionIterator {
   // Passes the output value to the blob file builder (if any), and replaces it
   // with the corresponding blob reference if it has been actually written to a
   // blob file (i.e. if it passed the value size check). Returns true if the
-  // value got extracted to a blob file, false otherwise.
-  bool ExtractLargeValueIfNeededImpl();
+  // value got extracted to a blob file, false otherwise. If `warm_cache`, the
+  // blob is also inserted into the blob cache.
+  bool ExtractLargeValueIfNeededImpl(bool warm_cache = false);
+
+  // Adds the size of the output value, before it is extracted, to
+  // value_sizes_. For blob references, the size of the blob is used.
+  void RecordValueSizeIfNeeded();
 
   // Extracts large values as described above, and updates the internal key's
   // type to kTypeBlobIndex if the value got extracted. Should only be called
@@ -326,11 +450,16 @@ class CompactionIterator {
 
   static uint64_t ComputeBlobGarbageCollectionCutoffFileNumber(
       const CompactionProxy* compaction);
+  static std::unordered_set<uint64_t> ComputeBlobFilesOverGarbageThreshold(
+      const CompactionProxy* compaction);
   static std::unique_ptr<BlobFetcher> CreateBlobFetcherIfNeeded(
       const CompactionProxy* compaction);
   static std::unique_ptr<PrefetchBufferCollection>
   CreatePrefetchBufferCollectionIfNeeded(const CompactionProxy* compaction);
 
+  // Set when the compaction filter takes batches, and then the input of
+  // `input_`
+  std::unique_ptr<FilterBatchIterator> filter_batch_iter_;
   SequenceIterWrapper input_;
   const Comparator* cmp_;
   MergeHelper* merge_helper_;
@@ -444,6 +573,14 @@ class CompactionIterator {
   PinnedIteratorsManager pinned_iters_mgr_;
 
   uint64_t blob_garbage_collection_cutoff_file_number_;
+  // Blob files newer than the cutoff whose blobs are also relocated, for their
+  // ratio of garbage (see blob_garbage_collection_file_threshold)
+  const std::unordered_set<uint64_t> blob_files_over_garbage_threshold_;
+
+  // Values smaller than this are kept inline (see Compaction::min_blob_size)
+  const uint64_t min_blob_size_;
+  const bool record_value_sizes_;
+  HistogramStat value_sizes_;
 
   std::unique_ptr<BlobFetcher> blob_fetcher_;
   std::unique_ptr<PrefetchBufferCollection> prefetch_buffers_;
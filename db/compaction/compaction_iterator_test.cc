@@ -180,8 +180,18 @@ class FakeCompaction : public CompactionIterator::CompactionProxy {
 
   double blob_garbage_collection_age_cutoff() const override { return 0.0; }
 
+  double blob_garbage_collection_file_threshold() const override {
+    return 1.0;
+  }
+
   uint64_t blob_compaction_readahead_size() const override { return 0; }
 
+  bool warm_relocated_blobs() const override { return false; }
+
+  uint64_t min_blob_size() const override { return 0; }
+
+  uint32_t blob_separation_percent() const override { return 0; }
+
   const Version* input_version() const override { return nullptr; }
 
   bool DoesInputReferenceBlobFiles() const override { return false; }
@@ -33,6 +33,7 @@
 #include "db/range_del_aggregator.h"
 #include "db/version_edit.h"
 #include "db/version_set.h"
+#include "file/file_util.h"
 #include "file/filename.h"
 #include "file/read_write_util.h"
 #include "file/sst_file_manager_impl.h"
@@ -56,7 +57,6 @@
 #include "table/unique_id_impl.h"
 #include "test_util/sync_point.h"
 #include "util/stop_watch.h"
-extern bool FLAGS_warmup_after_evict;
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -636,9 +636,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
     return;
   }
 
-  // Group the ranges into subcompactions
+  // Group the ranges into subcompactions. There can be more of them than
+  // threads, see CompactionJob::Run()
+  const uint64_t num_planned_ranges =
+      num_planned_subcompactions *
+      std::max(immutable_db_options_.subcompaction_ranges_per_thread, 1U);
   uint64_t target_range_size = std::max(
-      total_size / num_planned_subcompactions,
+      total_size / num_planned_ranges,
       MaxFileSizeForLevel(
           c->mutable_cf_options(), out_lvl,
           c->immutable_options().compaction_style, base_level,
@@ -658,15 +662,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
       num_actual_subcompactions++;
       boundaries_.push_back(anchor.user_key);
     }
-    if (num_actual_subcompactions == num_planned_subcompactions) {
+    if (num_actual_subcompactions == num_planned_ranges) {
       break;
     }
   }
   TEST_SYNC_POINT_CALLBACK("CompactionJob::GenSubcompactionBoundaries:1",
                            &num_actual_subcompactions);
+  num_subcompaction_threads_ = static_cast<size_t>(
+      std::min(num_planned_subcompactions, num_actual_subcompactions));
   // Shrink extra subcompactions resources when extra resrouces are acquired
   ShrinkSubcompactionResources(
-      std::min((int)(num_planned_subcompactions - num_actual_subcompactions),
+      std::min((int)(num_planned_subcompactions - num_subcompaction_threads_),
                extra_num_subcompaction_threads_reserved_));
 }
 
@@ -677,22 +683,60 @@ Status CompactionJob::Run() {
   log_buffer_->FlushBufferToLog();
   LogCompaction();
 
-  const size_t num_threads = compact_->sub_compact_states.size();
-  assert(num_threads > 0);
+  const size_t num_subcompactions = compact_->sub_compact_states.size();
+  assert(num_subcompactions > 0);
+  // With subcompaction_ranges_per_thread, there can be more subcompactions
+  // than threads. A thread that finishes one takes the next one not started
+  const size_t num_threads =
+      num_subcompaction_threads_ > 0
+          ? std::min(num_subcompaction_threads_, num_subcompactions)
+          : num_subcompactions;
+  std::atomic<size_t> next_subcompaction{num_threads};
+  auto process_subcompactions = [&](size_t first) {
+    for (size_t i = first; i < num_subcompactions;
+         i = next_subcompaction.fetch_add(1, std::memory_order_relaxed)) {
+      ProcessKeyValueCompaction(&compact_->sub_compact_states[i]);
+    }
+  };
   const uint64_t start_micros = immutable_db_options_.clock->NowMicros();
   compact_->compaction->GetOrInitInputTableProperties();
 
+  // The partitioners that isolate hot key ranges need them before anything
+  // is written
+  const SstPartitionerFactory* partitioner_factory =
+      compact_->compaction->immutable_options().sst_partitioner_factory.get();
+  if (partitioner_factory != nullptr &&
+      partitioner_factory->NeedsHotKeyRanges() &&
+      compact_->compaction->output_level() > 0) {
+    CollectHotInputKeyRanges();
+    if (hot_input_key_ranges_.has_value()) {
+      compact_->compaction->SetHotInputKeyRanges(*hot_input_key_ranges_);
+      for (auto& state : compact_->sub_compact_states) {
+        state.RecreatePartitioners();
+      }
+    }
+  }
+  // So do the output files that only prepopulate the block cache with them
+  const auto* bbto = compact_->compaction->mutable_cf_options()
+                         .table_factory->GetOptions<BlockBasedTableOptions>();
+  if (bbto != nullptr &&
+      bbto->prepopulate_block_cache ==
+          BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndCompaction &&
+      bbto->prepopulate_block_cache_compaction_hot_ranges_only &&
+      !hot_input_key_ranges_.has_value()) {
+    CollectHotInputKeyRanges();
+  }
+
   // Launch a thread for each of subcompactions 1...num_threads-1
   std::vector<port::Thread> thread_pool;
   thread_pool.reserve(num_threads - 1);
-  for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this,
-                             &compact_->sub_compact_states[i]);
+  for (size_t i = 1; i < num_threads; i++) {
+    thread_pool.emplace_back(process_subcompactions, i);
   }
 
   // Always schedule the first subcompaction (whether or not there are also
   // others) in the current thread to be efficient with resources
-  ProcessKeyValueCompaction(compact_->sub_compact_states.data());
+  process_subcompactions(0);
 
   // Wait for all other threads (if there are any) to finish execution
   for (auto& thread : thread_pool) {
@@ -919,6 +963,15 @@ Status CompactionJob::Run() {
     }
   }
 
+  // The input files are still alive, look up which of their key ranges were
+  // hot so that the warmup of the outputs can be limited to them.
+  if (status.ok() && immutable_db_options_.max_background_warmups > 0 &&
+      compact_->compaction->OutputWarmupMode() ==
+          CompactionWarmupMode::kHotKeyRanges &&
+      !hot_input_key_ranges_.has_value()) {
+    CollectHotInputKeyRanges();
+  }
+
   RecordCompactionIOStats();
   LogFlush(db_options_.info_log);
   TEST_SYNC_POINT("CompactionJob::Run():End");
@@ -927,6 +980,59 @@ Status CompactionJob::Run() {
   return status;
 }
 
+void CompactionJob::CollectHotInputKeyRanges() {
+  const Compaction* c = compact_->compaction;
+  ColumnFamilyData* cfd = c->column_family_data();
+  const Comparator* ucmp = cfd->user_comparator();
+  ReadOptions read_options(Env::IOActivity::kCompaction);
+  read_options.rate_limiter_priority = GetRateLimiterPriority();
+
+  std::vector<TableReader::HotKeyRange> ranges;
+  for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
+    for (const FileMetaData* f : *c->inputs(lvl_idx)) {
+      const size_t first_range = ranges.size();
+      Status s = cfd->table_cache()->GetHotKeyRanges(
+          read_options, cfd->internal_comparator(), *f, c->mutable_cf_options(),
+          &ranges);
+      if (!s.ok()) {
+        // Without the hot ranges of every input, the whole outputs are warmed.
+        if (!s.IsNotSupported()) {
+          ROCKS_LOG_WARN(db_options_.info_log,
+                         "[%s] [JOB %d] Failed to get the hot key ranges of "
+                         "file %" PRIu64 ": %s",
+                         cfd->GetName().c_str(), job_context_->job_id,
+                         f->fd.GetNumber(), s.ToString().c_str());
+        }
+        return;
+      }
+      for (size_t i = first_range; i < ranges.size(); i++) {
+        if (ranges[i].smallest.empty()) {
+          ranges[i].smallest = f->smallest.user_key().ToString();
+        }
+      }
+    }
+  }
+
+  std::sort(ranges.begin(), ranges.end(),
+            [ucmp](const TableReader::HotKeyRange& a,
+                   const TableReader::HotKeyRange& b) {
+              return ucmp->CompareWithoutTimestamp(a.smallest, b.smallest) < 0;
+            });
+  std::vector<TableReader::HotKeyRange> merged;
+  for (auto& range : ranges) {
+    if (!merged.empty() && ucmp->CompareWithoutTimestamp(
+                               range.smallest, merged.back().largest) <= 0) {
+      if (ucmp->CompareWithoutTimestamp(range.largest, merged.back().largest) >
+          0) {
+        merged.back().largest = std::move(range.largest);
+      }
+    } else {
+      merged.push_back(std::move(range));
+    }
+  }
+  hot_input_key_ranges_ = std::move(merged);
+}
+
 Status CompactionJob::Install(bool* compaction_released) {
   assert(compact_);
 
@@ -943,7 +1049,6 @@ Status CompactionJob::Install(bool* compaction_released) {
                                             internal_stats_);
 
   if (status.ok()) {
-    ROCKS_LOG_INFO(db_options_.info_log.get(), "[WARMUP DEBUG] Entering InstallCompactionResults");
     status = InstallCompactionResults(compaction_released);
   }
   if (!versions_->io_status().ok()) {
@@ -1148,6 +1253,52 @@ void CompactionJob::NotifyOnSubcompactionCompleted(
   }
 }
 
+std::vector<FileOptions> CompactionJob::GetInputFileOptions(
+    const Compaction* c, size_t readahead_budget) {
+  // The merge consumes each input at about the rate of its share of the input
+  // bytes, so that is also its share of the readahead budget.
+  std::vector<uint64_t> input_bytes;
+  uint64_t total_bytes = 0;
+  for (size_t which = 0; which < c->num_input_levels(); which++) {
+    const LevelFilesBrief* flevel = c->input_levels(which);
+    if (flevel->num_files == 0) {
+      continue;
+    }
+    if (c->level(which) == 0) {
+      for (size_t i = 0; i < flevel->num_files; i++) {
+        input_bytes.push_back(flevel->files[i].fd.GetFileSize());
+      }
+    } else {
+      uint64_t level_bytes = 0;
+      for (size_t i = 0; i < flevel->num_files; i++) {
+        level_bytes += flevel->files[i].fd.GetFileSize();
+      }
+      input_bytes.push_back(level_bytes);
+    }
+    total_bytes += input_bytes.back();
+  }
+
+  // Keeps each readahead a multiple of the page size and at least a page
+  constexpr size_t kReadaheadAlignment = 4096;
+  std::vector<FileOptions> input_file_options;
+  input_file_options.reserve(input_bytes.size());
+  for (uint64_t bytes : input_bytes) {
+    FileOptions fo = file_options_for_read_;
+    double share = total_bytes > 0
+                       ? static_cast<double>(bytes) / total_bytes
+                       : 1.0 / static_cast<double>(input_bytes.size());
+    size_t readahead = static_cast<size_t>(share * readahead_budget);
+    fo.compaction_readahead_size =
+        std::max(readahead / kReadaheadAlignment * kReadaheadAlignment,
+                 kReadaheadAlignment);
+    input_file_options.push_back(
+        fs_->OptimizeForCompactionTableRead(fo, immutable_db_options_));
+  }
+  TEST_SYNC_POINT_CALLBACK("CompactionJob::GetInputFileOptions",
+                           &input_file_options);
+  return input_file_options;
+}
+
 void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact);
   assert(sub_compact->compaction);
@@ -1204,6 +1355,11 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   read_options.fill_cache = false;
   read_options.rate_limiter_priority = GetRateLimiterPriority();
   read_options.io_activity = Env::IOActivity::kCompaction;
+  // Only the readahead of the input files is asynchronous, see
+  // BlockBasedTableIterator::InitDataBlock()
+  read_options.async_io =
+      immutable_db_options_.compaction_async_io &&
+      CheckFSFeatureSupport(fs_.get(), FSSupportedOps::kAsyncIO);
   // Compaction iterators shouldn't be confined to a single prefix.
   // Compactions use Seek() for
   // (a) concurrent compactions,
@@ -1231,11 +1387,57 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
   }
 
+  // With compaction_readahead_budget, the budget of this subcompaction is
+  // split between its inputs. Must outlive raw_input.
+  const size_t readahead_budget =
+      mutable_db_options_copy_.compaction_readahead_budget /
+      compact_->sub_compact_states.size();
+  std::vector<FileOptions> input_file_options;
+  if (readahead_budget > 0) {
+    input_file_options =
+        GetInputFileOptions(sub_compact->compaction, readahead_budget);
+  }
+
+  // Charges the buffers of the compaction while it runs: one read-ahead buffer
+  // for each L0 input file and for each other input level, which is read one
+  // file at a time, and the buffer of the output file
+  std::unique_ptr<CacheReservationManager::CacheReservationHandle>
+      buffer_cache_res_handle;
+  if (std::shared_ptr<CacheReservationManager> buffer_cache_res_mgr =
+          cfd->GetCompactionBufferCacheReservationManager()) {
+    const Compaction* c = sub_compact->compaction;
+    size_t num_input_buffers = 0;
+    for (size_t i = 0; i < c->num_input_levels(); i++) {
+      if (c->level(i) == 0) {
+        num_input_buffers += c->num_input_files(i);
+      } else if (c->num_input_files(i) > 0) {
+        num_input_buffers++;
+      }
+    }
+    size_t readahead_bytes = 0;
+    if (input_file_options.empty()) {
+      readahead_bytes =
+          num_input_buffers * file_options_for_read_.compaction_readahead_size;
+    } else {
+      for (const FileOptions& fo : input_file_options) {
+        readahead_bytes += fo.compaction_readahead_size;
+      }
+    }
+    const size_t buffer_bytes =
+        readahead_bytes + file_options_.writable_file_max_buffer_size;
+    Status s = buffer_cache_res_mgr->MakeCacheReservation(
+        buffer_bytes, &buffer_cache_res_handle);
+    // Over the budget, the compaction runs regardless, as it is what frees up
+    // space
+    s.PermitUncheckedError();
+  }
+
   // Although the v2 aggregator is what the level iterator(s) know about,
   // the AddTombstones calls will be propagated down to the v1 aggregator.
   std::unique_ptr<InternalIterator> raw_input(versions_->MakeInputIterator(
       read_options, sub_compact->compaction, sub_compact->RangeDelAgg(),
-      file_options_for_read_, start, end));
+      file_options_for_read_, start, end,
+      input_file_options.empty() ? nullptr : &input_file_options));
   InternalIterator* input = raw_input.get();
 
   IterKey start_ikey;
@@ -1511,6 +1713,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     RecordTick(stats_, BLOB_DB_GC_NUM_KEYS_RELOCATED,
                c_iter_stats.num_blobs_relocated);
   }
+  if (c_iter_stats.num_relocated_blobs_warmed > 0) {
+    RecordTick(stats_, WARMUP_RELOCATED_BLOBS_INSERTED,
+               c_iter_stats.num_relocated_blobs_warmed);
+  }
   if (c_iter_stats.total_blob_bytes_relocated > 0) {
     RecordTick(stats_, BLOB_DB_GC_BYTES_RELOCATED,
                c_iter_stats.total_blob_bytes_relocated);
@@ -1519,6 +1725,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   RecordDroppedKeys(c_iter_stats, &sub_compact->compaction_job_stats);
   RecordCompactionIOStats();
 
+  if (!c_iter->value_sizes().Empty()) {
+    cfd->RecordCompactionValueSizes(c_iter->value_sizes());
+  }
+
   if (status.ok() && cfd->IsDropped()) {
     status =
         Status::ColumnFamilyDropped("Column family dropped during compaction");
@@ -1823,8 +2033,6 @@ Status CompactionJob::FinishCompactionOutputFile(
 }
 
 Status CompactionJob::InstallCompactionResults(bool* compaction_released) {
- fprintf(stderr, "[WARMUP DEBUG] InstallCompactionResults() called for JOB %d\n", job_id_);
-
   assert(compact_);
 
   db_mutex_->AssertHeld();
@@ -1915,78 +2123,11 @@ Status CompactionJob::InstallCompactionResults(bool* compaction_released) {
     *compaction_released = true;
   };
 
-
-
-  ReadOptions warmup_read_options;
-  warmup_read_options.fill_cache = true;
-
-if (true) {
-  fprintf(stderr, "[WARMUP DEBUG] warmup() called for JOB %d\n", job_id_);
-  auto* current_version = cfd_->current();
-  if (!current_version) {
-    fprintf(stderr, "[WARMUP ERROR] current_version is nullptr\n");
-    return Status::OK();
-  }
-  auto* storage_info = current_version->storage_info();
-  if (!storage_info) {
-    fprintf(stderr, "[WARMUP ERROR] storage_info is nullptr\n");
-    return Status::OK();
-  }
-  for (const auto& f : edit->GetDeletedFiles()) {
-    int level = f.first;
-    uint64_t file_number = f.second;
-    fprintf(stderr, "[WARMUP DEBUG] Deleted file — Level: %d, FileNum: %lu\n", level, file_number);
-    if (level < 0 || level >= storage_info->num_levels()) {
-      fprintf(stderr, "[WARMUP ERROR] Invalid level %d (max: %d)\n", level, storage_info->num_levels() - 1);
-      continue;
-    }
-
-    const auto& files = storage_info->LevelFiles(level);
-    if (files.empty()) {
-      fprintf(stderr, "[WARMUP WARN] Level %d has no files\n", level);
-      continue;
-    }
-
-    for (auto* file : files) {
-      if (!file) {
-        fprintf(stderr, "[WARMUP WARN] Null FileMetaData in Level %d\n", level);
-        continue;
-      }
-
-      if (file->fd.GetNumber() == file_number) {
-        const InternalKey& smallest = file->smallest;
-        const InternalKey& largest = file->largest;
-        ROCKS_LOG_INFO(db_options_.info_log.get(), "[WARMUP DEBUG] About to call warmup with range %s ~ %s",
-               smallest.DebugString(true).c_str(),
-               largest.DebugString(true).c_str());
-       auto* table_cache = cfd_->table_cache();
-       if (!table_cache) {
-          fprintf(stderr, "[WARMUP ERROR] table_cache is nullptr\n");
-          continue;
-        }
-        MaybeWarmupBlockCacheForEvictedRange(
-          current_version,
-          smallest,
-          largest,
-          table_cache,
-          warmup_read_options,
-          cfd_->internal_comparator(),
-          env_options_,
-          db_options_.info_log.get(),
-          file_options_for_compaction_,
-          mutable_cf_options_
-);
-        break;
-      }
-    }
-  }
-}
- return versions_->LogAndApply(compaction->column_family_data(), read_options,
+  return versions_->LogAndApply(compaction->column_family_data(), read_options,
                                 write_options, edit, db_mutex_, db_directory_,
                                 /*new_descriptor_log=*/false,
                                 /*column_family_options=*/nullptr,
                                 manifest_wcb);
-
 }
 
 void CompactionJob::RecordCompactionIOStats() {
@@ -2040,7 +2181,8 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
   // Here last_level_temperature supersedes default_write_temperature, when
   // enabled and applicable
   if (last_level_temp != Temperature::kUnknown &&
-      sub_compact->compaction->is_last_level() && !outputs.IsProximalLevel()) {
+      sub_compact->compaction->is_last_level() && !outputs.IsProximalLevel() &&
+      !sub_compact->compaction->is_last_level_promotion()) {
     temperature = last_level_temp;
   }
   fo_copy.temperature = temperature;
@@ -2158,6 +2300,16 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
       0 /* oldest_key_time */, current_time, db_id_, db_session_id_,
       sub_compact->compaction->max_output_file_size(), file_number,
       proximal_after_seqno_ /*last_level_inclusive_max_seqno_threshold*/);
+  tboptions.prepopulated_data_block_bytes = &prepopulated_data_block_bytes_;
+  if (hot_input_key_ranges_.has_value()) {
+    tboptions.hot_key_ranges = &*hot_input_key_ranges_;
+  }
+  if (cfd->ioptions().bottommost_hash_index && bottommost_level_ &&
+      !outputs.IsProximalLevel() &&
+      cfd->user_comparator()->timestamp_size() == 0) {
+    tboptions.hash_index_builder = outputs.NewHashIndexBuilder(
+        cfd->GetBottommostHashIndexCacheReservationManager());
+  }
 
   outputs.NewBuilder(tboptions);
 
@@ -12,6 +12,7 @@
 #include <deque>
 #include <functional>
 #include <limits>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -41,6 +42,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/transaction_log.h"
+#include "table/table_reader.h"
 #include "util/autovector.h"
 #include "util/stop_watch.h"
 #include "util/thread_local.h"
@@ -201,6 +203,15 @@ class CompactionJob {
   // Return the IO status
   IOStatus io_status() const { return io_status_; }
 
+  // The key ranges of the input files that were hot in the block cache, merged
+  // and in key order, collected by Run() when post-compaction warmup is
+  // enabled. std::nullopt if they are unknown, e.g. because some input file
+  // does not track its hot key ranges.
+  const std::optional<std::vector<TableReader::HotKeyRange>>&
+  hot_input_key_ranges() const {
+    return hot_input_key_ranges_;
+  }
+
  protected:
   FileOptions file_options_for_compaction_;
   MutableCFOptions mutable_cf_options_;
@@ -210,11 +221,18 @@ class CompactionJob {
       const InternalStats::CompactionStatsFull& internal_stats) const;
 
   void LogCompaction();
+  // REQUIRED mutex not held
+  void CollectHotInputKeyRanges();
   virtual void RecordCompactionIOStats();
   void CleanupCompaction();
 
   // Iterate through input and compact the kv-pairs.
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
+  // Returns the file options of each input of `c` in the order of
+  // VersionSet::MakeInputIterator(), with readahead_budget split between
+  // them.
+  std::vector<FileOptions> GetInputFileOptions(const Compaction* c,
+                                               size_t readahead_budget);
 
   CompactionState* compact_;
   InternalStats::CompactionStatsFull internal_stats_;
@@ -229,6 +247,12 @@ class CompactionJob {
 
   IOStatus io_status_;
 
+  // Bytes of data blocks of the output files prepopulated into the block
+  // cache, charged against `prepopulate_block_cache_compaction_max_bytes`.
+  std::atomic<uint64_t> prepopulated_data_block_bytes_{0};
+
+  std::optional<std::vector<TableReader::HotKeyRange>> hot_input_key_ranges_;
+
   CompactionJobStats* job_stats_;
 
  private:
@@ -356,6 +380,9 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<std::string> boundaries_;
+  // The number of threads running the subcompactions, or 0 for one thread
+  // per subcompaction
+  size_t num_subcompaction_threads_ = 0;
   Env::Priority thread_pri_;
   std::string full_history_ts_low_;
   std::string trim_ts_;
@@ -51,7 +51,12 @@ Status CompactionOutputs::Finish(
     meta->marked_for_compaction = builder_->NeedCompact();
     meta->user_defined_timestamps_persisted = static_cast<bool>(
         builder_->GetTableProperties().user_defined_timestamps_persisted);
+    meta->SetTimestampRange(builder_->GetTableProperties());
+    if (hash_index_builder_ != nullptr) {
+      meta->hash_index = hash_index_builder_->Finish();
+    }
   }
+  hash_index_builder_.reset();
   current_output().finished = true;
   stats_.bytes_written += current_bytes;
   stats_.bytes_written_pre_comp += builder_->PreCompressionSize();
@@ -755,7 +760,9 @@ Status CompactionOutputs::AddRangeDels(
 void CompactionOutputs::FillFilesToCutForTtl() {
   if (compaction_->immutable_options().compaction_style !=
           kCompactionStyleLevel ||
-      compaction_->immutable_options().compaction_pri != kMinOverlappingRatio ||
+      (compaction_->immutable_options().compaction_pri !=
+           kMinOverlappingRatio &&
+       compaction_->immutable_options().compaction_pri != kHotnessAware) ||
       compaction_->mutable_cf_options().ttl == 0 ||
       compaction_->num_input_levels() < 2 || compaction_->bottommost_level()) {
     return;
@@ -15,6 +15,7 @@
 #include "db/compaction/compaction_iterator.h"
 #include "db/internal_stats.h"
 #include "db/output_validator.h"
+#include "table/block_based/file_hash_index.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -50,6 +51,15 @@ class CompactionOutputs {
 
   bool IsProximalLevel() const { return is_proximal_level_; }
 
+  // Replaces the partitioner with a new one from the compaction, once it
+  // knows more about its inputs. Must be called before any output is added.
+  void RecreatePartitioner() {
+    assert(outputs_.empty());
+    if (partitioner_) {
+      partitioner_ = compaction_->CreateSstPartitioner();
+    }
+  }
+
   // Add generated output to the list
   void AddOutput(FileMetaData&& meta, const InternalKeyComparator& icmp,
                  bool enable_hash, bool finished = false,
@@ -61,6 +71,16 @@ class CompactionOutputs {
   // Set new table builder for the current output
   void NewBuilder(const TableBuilderOptions& tboptions);
 
+  // Set a new builder of the hash index of the current output, to be passed
+  // to its table builder, see
+  // AdvancedColumnFamilyOptions::bottommost_hash_index
+  FileHashIndex::Builder* NewHashIndexBuilder(
+      std::shared_ptr<CacheReservationManager> cache_res_mgr) {
+    hash_index_builder_.reset(
+        new FileHashIndex::Builder(std::move(cache_res_mgr), /*ts_sz=*/0));
+    return hash_index_builder_.get();
+  }
+
   // Assign a new WritableFileWriter to the current output
   void AssignFileWriter(WritableFileWriter* writer) {
     file_writer_.reset(writer);
@@ -226,6 +246,7 @@ class CompactionOutputs {
       builder_->Abandon();
       builder_.reset();
     }
+    hash_index_builder_.reset();
   }
 
   // Updates states related to file cutting for TTL.
@@ -292,6 +313,7 @@ class CompactionOutputs {
 
   // current output builder and writer
   std::unique_ptr<TableBuilder> builder_;
+  std::unique_ptr<FileHashIndex::Builder> hash_index_builder_;
   std::unique_ptr<WritableFileWriter> file_writer_;
   uint64_t current_output_file_size_ = 0;
   SequenceNumber smallest_preferred_seqno_ = kMaxSequenceNumber;
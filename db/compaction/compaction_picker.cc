@@ -1157,9 +1157,12 @@ void CompactionPicker::RegisterCompaction(Compaction* c) {
                                           c->GetProximalLevel()));
   // CompactionReason::kExternalSstIngestion's start level is just a placeholder
   // number without actual meaning as file ingestion technically does not have
-  // an input level like other compactions
+  // an input level like other compactions. The same goes for
+  // CompactionReason::kFlush, which reserves the key range of a flush to a
+  // level below L0.
   if ((c->start_level() == 0 &&
-       c->compaction_reason() != CompactionReason::kExternalSstIngestion) ||
+       c->compaction_reason() != CompactionReason::kExternalSstIngestion &&
+       c->compaction_reason() != CompactionReason::kFlush) ||
       ioptions_.compaction_style == kCompactionStyleUniversal) {
     level0_compactions_in_progress_.insert(c);
   }
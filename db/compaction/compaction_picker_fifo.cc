@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction_picker_fifo.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <string>
 #include <vector>
@@ -173,7 +174,15 @@ Compaction* FIFOCompactionPicker::PickSizeCompaction(
     // total size not exceeded, try to find intra level 0 compaction if enabled
     const std::vector<FileMetaData*>& level0_files = vstorage->LevelFiles(0);
     if (mutable_cf_options.compaction_options_fifo.allow_compaction &&
-        level0_files.size() > 0) {
+        mutable_cf_options.compaction_options_fifo.time_window_seconds > 0) {
+      Compaction* c =
+          PickTimeWindowCompaction(cf_name, mutable_cf_options,
+                                   mutable_db_options, vstorage, log_buffer);
+      if (c != nullptr) {
+        return c;
+      }
+    } else if (mutable_cf_options.compaction_options_fifo.allow_compaction &&
+               level0_files.size() > 0) {
       CompactionInputFiles comp_inputs;
       // try to prevent same files from being compacted multiple times, which
       // could produce large files that may never TTL-expire. Achieve this by
@@ -305,6 +314,76 @@ Compaction* FIFOCompactionPicker::PickSizeCompaction(
   return c;
 }
 
+Compaction* FIFOCompactionPicker::PickTimeWindowCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer) {
+  const uint64_t window =
+      mutable_cf_options.compaction_options_fifo.time_window_seconds;
+  assert(window > 0);
+  int64_t _current_time;
+  if (!ioptions_.clock->GetCurrentTime(&_current_time).ok()) {
+    return nullptr;
+  }
+  const uint64_t current_window = static_cast<uint64_t>(_current_time) / window;
+
+  // In L0, right-most files are the oldest files. Runs of adjacent files of
+  // the same window are compacted, so that an output file takes the place of
+  // its input files in the order of the files.
+  const std::vector<FileMetaData*>& level_files = vstorage->LevelFiles(0);
+  CompactionInputFiles comp_inputs;
+  comp_inputs.level = 0;
+  uint64_t run_window = 0;
+  uint64_t run_bytes = 0;
+  for (auto ritr = level_files.rbegin(); ritr != level_files.rend(); ++ritr) {
+    FileMetaData* f = *ritr;
+    uint64_t newest_key_time = f->TryGetNewestKeyTime();
+    if (newest_key_time == kUnknownNewestKeyTime &&
+        f->fd.table_reader != nullptr &&
+        f->fd.table_reader->GetTableProperties() != nullptr) {
+      newest_key_time = f->fd.table_reader->GetTableProperties()->creation_time;
+    }
+    const bool known = newest_key_time != kUnknownNewestKeyTime;
+    const uint64_t file_window = known ? newest_key_time / window : 0;
+    if (!known || f->being_compacted || file_window >= current_window ||
+        file_window != run_window ||
+        run_bytes + f->fd.file_size > mutable_cf_options.max_compaction_bytes) {
+      if (comp_inputs.size() > 1) {
+        break;
+      }
+      comp_inputs.files.clear();
+      run_bytes = 0;
+      if (!known || f->being_compacted || file_window >= current_window) {
+        continue;
+      }
+    }
+    run_window = file_window;
+    run_bytes += f->fd.file_size;
+    comp_inputs.files.push_back(f);
+  }
+  if (comp_inputs.size() <= 1) {
+    return nullptr;
+  }
+  // The files were added oldest first
+  std::reverse(comp_inputs.files.begin(), comp_inputs.files.end());
+
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] FIFO compaction: compacting %" ROCKSDB_PRIszt
+                   " files of time window %" PRIu64 " of %" PRIu64 " seconds",
+                   cf_name.c_str(), comp_inputs.size(), run_window, window);
+  return new Compaction(
+      vstorage, ioptions_, mutable_cf_options, mutable_db_options,
+      {comp_inputs}, 0,
+      mutable_cf_options.max_compaction_bytes /* output file size limit */,
+      0 /* max compaction bytes, not applicable */, 0 /* output path ID */,
+      mutable_cf_options.compression, mutable_cf_options.compression_opts,
+      mutable_cf_options.default_write_temperature, 0 /* max_subcompactions */,
+      {}, /* earliest_snapshot */ std::nullopt,
+      /* snapshot_checker */ nullptr, /* is manual */ false, /* trim_ts */ "",
+      vstorage->CompactionScore(0), /* is deletion compaction */ false,
+      /* l0_files_might_overlap */ true, CompactionReason::kFIFOReduceNumFiles);
+}
+
 Compaction* FIFOCompactionPicker::PickTemperatureChangeCompaction(
     const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
     const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
@@ -36,6 +36,9 @@ bool LevelCompactionPicker::NeedsCompaction(
   if (!vstorage->FilesMarkedForForcedBlobGC().empty()) {
     return true;
   }
+  if (!vstorage->FilesMarkedForPromotion().empty()) {
+    return true;
+  }
   for (int i = 0; i <= vstorage->MaxInputLevel(); i++) {
     if (vstorage->CompactionScore(i) >= 1) {
       return true;
@@ -127,6 +130,13 @@ class LevelCompactionBuilder {
   bool TryExtendNonL0TrivialMove(int start_index,
                                  bool only_expand_right = false);
 
+  // Called once the output level inputs are set up. If they are small next
+  // to the start level inputs and can trivially move one level further
+  // down, switch to moving them there, so that the start level inputs can
+  // later trivially move to `output_level_`. Returns true if switched. See
+  // AdvancedColumnFamilyOptions::level_compaction_move_edge_overlaps.
+  bool TryPickEdgeOverlapMove();
+
   // Picks a file from level_files to compact.
   // level_files is a vector of (level, file metadata) in ascending order of
   // level. If compact_to_next_level is true, compact the file to the next
@@ -162,6 +172,9 @@ class LevelCompactionBuilder {
                             int level);
 
   static const int kMinFilesForIntraL0Compaction = 4;
+  // The output level inputs are moved down by TryPickEdgeOverlapMove() only
+  // if the start level inputs are at least this many times larger.
+  static const uint64_t kMinEdgeOverlapSizeRatio = 8;
 };
 
 void LevelCompactionBuilder::PickFileToCompact(
@@ -323,6 +336,14 @@ void LevelCompactionBuilder::SetupInitialFiles() {
     compaction_reason_ = CompactionReason::kForcedBlobGC;
     return;
   }
+
+  // Promotion of read cold files out of last_level_temperature
+  PickFileToCompact(vstorage_->FilesMarkedForPromotion(),
+                    CompactToNextLevel::kNo);
+  if (!start_level_inputs_.empty()) {
+    compaction_reason_ = CompactionReason::kChangeTemperature;
+    return;
+  }
 }
 
 bool LevelCompactionBuilder::SetupOtherL0FilesIfNeeded() {
@@ -476,6 +497,9 @@ bool LevelCompactionBuilder::SetupOtherInputsIfNeeded() {
             round_robin_expanding)) {
       return false;
     }
+    if (!is_l0_trivial_move_ && !round_robin_expanding) {
+      TryPickEdgeOverlapMove();
+    }
 
     compaction_inputs_.push_back(start_level_inputs_);
     if (!output_level_inputs_.empty()) {
@@ -700,6 +724,40 @@ bool LevelCompactionBuilder::TryPickL0TrivialMove() {
   return false;
 }
 
+bool LevelCompactionBuilder::TryPickEdgeOverlapMove() {
+  if (!ioptions_.level_compaction_move_edge_overlaps || start_level_ == 0 ||
+      compaction_reason_ != CompactionReason::kLevelMaxLevelSize ||
+      output_level_inputs_.empty() ||
+      output_level_ + 1 >= vstorage_->num_levels()) {
+    return false;
+  }
+  if (TotalFileSize(output_level_inputs_.files) * kMinEdgeOverlapSizeRatio >
+      TotalFileSize(start_level_inputs_.files)) {
+    return false;
+  }
+  // The output level inputs are a clean cut of their level, so they can
+  // move as long as nothing in the level below overlaps their range.
+  const int move_level = output_level_ + 1;
+  InternalKey smallest, largest;
+  compaction_picker_->GetRange(output_level_inputs_, &smallest, &largest);
+  std::vector<FileMetaData*> overlapping;
+  vstorage_->GetOverlappingInputs(move_level, &smallest, &largest,
+                                  &overlapping);
+  if (!overlapping.empty()) {
+    return false;
+  }
+
+  start_level_ = output_level_;
+  output_level_ = move_level;
+  start_level_inputs_ = output_level_inputs_;
+  output_level_inputs_.clear();
+  output_level_inputs_.level = output_level_;
+  TEST_SYNC_POINT_CALLBACK(
+      "LevelCompactionBuilder::TryPickEdgeOverlapMove:Picked",
+      &start_level_inputs_);
+  return true;
+}
+
 bool LevelCompactionBuilder::TryExtendNonL0TrivialMove(int start_index,
                                                        bool only_expand_right) {
   if (start_level_inputs_.size() == 1 &&
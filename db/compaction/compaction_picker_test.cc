@@ -1040,6 +1040,50 @@ TEST_F(CompactionPickerTest, UniversalIncrementalSpace5) {
   ASSERT_EQ(13, compaction->num_input_files(1));
 }
 
+TEST_F(CompactionPickerTest, UniversalIncrementalAvoidFullCompaction) {
+  const uint64_t kFileSize = 100000;
+
+  for (bool avoid_full_compaction : {false, true}) {
+    mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+    mutable_cf_options_.max_compaction_bytes = 400000;
+    mutable_cf_options_.compaction_options_universal.incremental = true;
+    mutable_cf_options_.compaction_options_universal
+        .incremental_avoid_full_compaction = avoid_full_compaction;
+    mutable_cf_options_.compaction_options_universal
+        .max_size_amplification_percent = 20;
+    UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+
+    NewVersionStorage(5, kCompactionStyleUniversal);
+
+    // Every slice rewrites the whole last level file, for a fanout of 10
+    // against 3.3 for merging the whole sorted runs.
+    Add(3, 1U, "100", "110", kFileSize, 0, 200, 251);
+    Add(3, 2U, "120", "130", kFileSize, 0, 200, 251);
+    Add(3, 3U, "140", "150", kFileSize, 0, 200, 251);
+    Add(4, 10U, "000", "999", kFileSize * 10, 0, 101, 150);
+    UpdateVersionStorageInfo();
+
+    std::unique_ptr<Compaction> compaction(
+        universal_compaction_picker.PickCompaction(
+            cf_name_, mutable_cf_options_, mutable_db_options_,
+            /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+            vstorage_.get(), &log_buffer_));
+    ASSERT_TRUE(compaction);
+    ASSERT_EQ(CompactionReason::kUniversalSizeAmplification,
+              compaction->compaction_reason());
+    ASSERT_EQ(3, compaction->start_level());
+    ASSERT_EQ(4, compaction->output_level());
+    if (avoid_full_compaction) {
+      ASSERT_EQ(1U, compaction->num_input_files(0));
+      ASSERT_EQ(1U, compaction->input(0, 0)->fd.GetNumber());
+    } else {
+      ASSERT_EQ(3U, compaction->num_input_files(0));
+    }
+    ASSERT_EQ(1U, compaction->num_input_files(1));
+    ASSERT_EQ(10U, compaction->input(1, 0)->fd.GetNumber());
+  }
+}
+
 TEST_F(CompactionPickerTest,
        PartiallyExcludeL0ToReduceWriteStopForSizeAmpCompaction) {
   const uint64_t kFileSize = 100000;
@@ -1177,6 +1221,65 @@ TEST_F(CompactionPickerTest, FIFOToCold1) {
   }
 }
 
+TEST_F(CompactionPickerTest, FIFOTimeWindowCompaction) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 100000;
+  const uint64_t kWindow = 1000;
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.allow_compaction = true;
+  fifo_options_.time_window_seconds = kWindow;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.max_compaction_bytes = kFileSize * 100;
+
+  auto copiedIOptions = ioptions_;
+  copiedIOptions.compaction_style = kCompactionStyleFIFO;
+  FIFOCompactionPicker fifo_compaction_picker(copiedIOptions, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t current_window_start =
+      static_cast<uint64_t>(current_time) / kWindow * kWindow;
+  // The current window is not over yet
+  Add(0, 5U, "200", "300", kFileSize, 0, 2900, 3000, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      static_cast<uint64_t>(current_time));
+  // The previous window has two files
+  Add(0, 4U, "200", "300", kFileSize, 0, 2700, 2800, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      current_window_start - kWindow + 500);
+  Add(0, 3U, "200", "300", kFileSize, 0, 2500, 2600, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      current_window_start - kWindow + 100);
+  // The windows before have one file each, and are left alone
+  Add(0, 2U, "200", "300", kFileSize, 0, 2300, 2400, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      current_window_start - 2 * kWindow + 900);
+  Add(0, 1U, "200", "300", kFileSize, 0, 2100, 2200, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      current_window_start - 3 * kWindow);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_,
+      /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+      vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(compaction->compaction_reason(),
+            CompactionReason::kFIFOReduceNumFiles);
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(4U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(3U, compaction->input(0, 1)->fd.GetNumber());
+  fifo_compaction_picker.ReleaseCompactionFiles(compaction.get(), Status::OK());
+
+  // Without two files in a window that is over, there is nothing to compact
+  mutable_cf_options_.max_compaction_bytes = kFileSize;
+  compaction.reset(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_,
+      /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+      vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() == nullptr);
+}
+
 TEST_F(CompactionPickerTest, FIFOToColdMaxCompactionSize) {
   // Test fallback behavior from newest_key_time to oldest_ancestor_time
   for (bool newestKeyTimeKnown : {false, true}) {
@@ -1495,6 +1598,60 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping1) {
   ASSERT_GE(uint64_t{55000000}, compaction->OutputFilePreallocationSize());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriHotnessAware) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kHotnessAware;
+  mutable_cf_options_.target_file_size_base = 100000000000;
+  mutable_cf_options_.target_file_size_multiplier = 10;
+  mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+
+  // Both files have the same overlapping ratio, but file 6 is being read
+  Add(2, 6U, "150", "179", 50000000U);
+  Add(2, 7U, "180", "220", 50000000U);
+
+  Add(3, 26U, "150", "170", 260000000U);
+  Add(3, 27U, "191", "220", 260000000U);
+  file_map_[6U].first->stats.num_reads_sampled = 1000;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_,
+      /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+      vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  // Pick the cold file 7 over file 6 with the smaller keys
+  ASSERT_EQ(7U, compaction->input(0, 0)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, CompactionPriHotnessAwareBounded) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kHotnessAware;
+  mutable_cf_options_.target_file_size_base = 100000000000;
+  mutable_cf_options_.target_file_size_multiplier = 10;
+  mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+
+  // File 7 is cold, but overlaps with ten times the bytes of file 6
+  Add(2, 6U, "150", "179", 50000000U);
+  Add(2, 7U, "180", "220", 50000000U);
+
+  Add(3, 26U, "150", "170", 260000000U);
+  Add(3, 27U, "191", "220", 2600000000U);
+  file_map_[6U].first->stats.num_reads_sampled = 1000;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_,
+      /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+      vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  // The hot file 6 is not deferred at any write amplification cost
+  ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, CompactionPriMinOverlapping2) {
   NewVersionStorage(6, kCompactionStyleLevel);
   ioptions_.compaction_pri = kMinOverlappingRatio;
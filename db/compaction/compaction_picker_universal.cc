@@ -1110,15 +1110,29 @@ Compaction* UniversalCompactionBuilder::PickCompactionToReduceSizeAmp() {
   // configurable in the future.
   // This also prevent the case when compaction falls behind and we
   // need to compact more levels for compactions to catch up.
-  if (mutable_cf_options_.compaction_options_universal.incremental) {
+  const CompactionOptionsUniversal& universal_options =
+      mutable_cf_options_.compaction_options_universal;
+  if (universal_options.incremental) {
     double fanout_threshold = static_cast<double>(base_sr_size) /
                               static_cast<double>(candidate_size) * 1.8;
+    if (universal_options.incremental_avoid_full_compaction) {
+      fanout_threshold = std::numeric_limits<double>::max();
+    }
     Compaction* picked = PickIncrementalForReduceSizeAmp(fanout_threshold);
     if (picked != nullptr) {
       // As the feature is still incremental, picking incremental compaction
       // might fail and we will fall bck to compacting full level.
       return picked;
     }
+    if (universal_options.incremental_avoid_full_compaction &&
+        sorted_runs_[sorted_runs_.size() - 2].level > 0) {
+      // The slice is blocked by other compactions, wait for them
+      ROCKS_LOG_BUFFER(log_buffer_,
+                       "[%s] Universal: no incremental compaction to reduce "
+                       "size amp, not compacting all sorted runs instead",
+                       cf_name_.c_str());
+      return nullptr;
+    }
   }
   return PickCompactionWithSortedRunRange(
       start_index, end_index, CompactionReason::kUniversalSizeAmplification);
@@ -1168,6 +1182,7 @@ Compaction* UniversalCompactionBuilder::PickIncrementalForReduceSizeAmp(
   int picked_start_idx = 0;
   int picked_end_idx = 0;
   double picked_fanout = fanout_threshold;
+  bool picked = false;
 
   // Use half target compaction bytes as anchor to stop growing second most
   // level files, and reserve growing space for more overlapping bottom level,
@@ -1240,6 +1255,7 @@ Compaction* UniversalCompactionBuilder::PickIncrementalForReduceSizeAmp(
         picked_start_idx = start_idx;
         picked_end_idx = end_idx;
         picked_fanout = fanout;
+        picked = true;
       }
       // Shrink from the start end to under comp_thres_size
       while (non_bottom_size + bottom_size > comp_thres_size &&
@@ -1258,7 +1274,7 @@ Compaction* UniversalCompactionBuilder::PickIncrementalForReduceSizeAmp(
     }
   }
 
-  if (picked_fanout >= fanout_threshold) {
+  if (!picked) {
     assert(picked_fanout == fanout_threshold);
     return nullptr;
   }
@@ -1295,8 +1311,13 @@ Compaction* UniversalCompactionBuilder::PickIncrementalForReduceSizeAmp(
   // Since we need to go from lower level up and this is in the reverse
   // order, compared to level order, we first write to an reversed
   // data structure and finally copy them to compaction inputs.
+  // Newer sorted runs are left out from the first one that would take the
+  // compaction over max_compaction_bytes, as the keys they have in the range
+  // stay newer than the output anyway.
   InternalKey smallest, largest;
   picker_->GetRange(second_last_level_inputs, &smallest, &largest);
+  uint64_t total_size = TotalFileSize(second_last_level_inputs.files) +
+                        TotalFileSize(bottom_level_inputs.files);
   std::vector<CompactionInputFiles> inputs_reverse;
   for (auto it = ++(++sorted_runs_.rbegin()); it != sorted_runs_.rend(); it++) {
     SortedRun& sr = *it;
@@ -1306,6 +1327,10 @@ Compaction* UniversalCompactionBuilder::PickIncrementalForReduceSizeAmp(
     std::vector<FileMetaData*> level_inputs;
     vstorage_->GetCleanInputsWithinInterval(sr.level, &smallest, &largest,
                                             &level_inputs);
+    total_size += TotalFileSize(level_inputs);
+    if (total_size > mutable_cf_options_.max_compaction_bytes) {
+      break;
+    }
     if (!level_inputs.empty()) {
       inputs_reverse.push_back({});
       inputs_reverse.back().level = sr.level;
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "rocksdb/comparator.h"
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
@@ -56,6 +57,79 @@ std::shared_ptr<SstPartitionerFactory> NewSstPartitionerFixedPrefixFactory(
   return std::make_shared<SstPartitionerFixedPrefixFactory>(prefix_len);
 }
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    sst_hot_ranges_type_info = {
+        {"max_hot_file_size",
+         {0, OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+SstPartitionerHotRanges::SstPartitionerHotRanges(
+    const SstPartitioner::Context& context, uint64_t max_hot_file_size)
+    : comparator_(context.comparator != nullptr ? context.comparator
+                                                : BytewiseComparator()),
+      max_hot_file_size_(max_hot_file_size) {
+  hot_ranges_.reserve(context.hot_key_ranges.size());
+  for (const auto& range : context.hot_key_ranges) {
+    hot_ranges_.emplace_back(range.first.ToString(), range.second.ToString());
+  }
+}
+
+size_t SstPartitionerHotRanges::Position(const Slice& user_key) const {
+  auto it = std::lower_bound(
+      hot_ranges_.begin(), hot_ranges_.end(), user_key,
+      [this](const std::pair<std::string, std::string>& range,
+             const Slice& key) {
+        return comparator_->CompareWithoutTimestamp(range.second, key) < 0;
+      });
+  const size_t i = static_cast<size_t>(it - hot_ranges_.begin());
+  if (it != hot_ranges_.end() &&
+      comparator_->CompareWithoutTimestamp(user_key, it->first) >= 0) {
+    return 2 * i + 1;
+  }
+  return 2 * i;
+}
+
+PartitionerResult SstPartitionerHotRanges::ShouldPartition(
+    const PartitionerRequest& request) {
+  if (hot_ranges_.empty()) {
+    return kNotRequired;
+  }
+  const size_t current = Position(*request.current_user_key);
+  if (current != Position(*request.prev_user_key)) {
+    return kRequired;
+  }
+  const bool hot = current % 2 == 1;
+  return hot && max_hot_file_size_ > 0 &&
+                 request.current_output_file_size >= max_hot_file_size_
+             ? kRequired
+             : kNotRequired;
+}
+
+bool SstPartitionerHotRanges::CanDoTrivialMove(
+    const Slice& smallest_user_key, const Slice& largest_user_key) {
+  return hot_ranges_.empty() ||
+         Position(smallest_user_key) == Position(largest_user_key);
+}
+
+SstPartitionerHotRangesFactory::SstPartitionerHotRangesFactory(
+    uint64_t max_hot_file_size)
+    : max_hot_file_size_(max_hot_file_size) {
+  RegisterOptions("HotRanges", &max_hot_file_size_, &sst_hot_ranges_type_info);
+}
+
+std::unique_ptr<SstPartitioner>
+SstPartitionerHotRangesFactory::CreatePartitioner(
+    const SstPartitioner::Context& context) const {
+  return std::unique_ptr<SstPartitioner>(
+      new SstPartitionerHotRanges(context, max_hot_file_size_));
+}
+
+std::shared_ptr<SstPartitionerFactory> NewSstPartitionerHotRangesFactory(
+    uint64_t max_hot_file_size) {
+  return std::make_shared<SstPartitionerHotRangesFactory>(max_hot_file_size);
+}
+
 namespace {
 static int RegisterSstPartitionerFactories(ObjectLibrary& library,
                                            const std::string& /*arg*/) {
@@ -67,7 +141,15 @@ static int RegisterSstPartitionerFactories(ObjectLibrary& library,
         guard->reset(new SstPartitionerFixedPrefixFactory(0));
         return guard->get();
       });
-  return 1;
+  library.AddFactory<SstPartitionerFactory>(
+      SstPartitionerHotRangesFactory::kClassName(),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<SstPartitionerFactory>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new SstPartitionerHotRangesFactory(0));
+        return guard->get();
+      });
+  return 2;
 }
 }  // namespace
 
@@ -90,6 +90,11 @@ class SubcompactionState {
     range_del_agg_ = std::move(range_del_agg);
   }
 
+  void RecreatePartitioners() {
+    compaction_outputs_.RecreatePartitioner();
+    proximal_level_outputs_.RecreatePartitioner();
+  }
+
   void RemoveLastEmptyOutput() {
     compaction_outputs_.RemoveLastEmptyOutput();
     proximal_level_outputs_.RemoveLastEmptyOutput();
@@ -736,6 +736,71 @@ TEST_F(TieredCompactionTest, LevelColdRangeDelete) {
   db_->ReleaseSnapshot(snap);
 }
 
+TEST_F(TieredCompactionTest, LevelPromoteReadColdFiles) {
+  const int kNumLevels = 7;
+  const int kNumKeys = 100;
+  const int kLastLevel = kNumLevels - 1;
+
+  auto options = CurrentOptions();
+  SetColdTemperature(options);
+  options.num_levels = kNumLevels;
+  options.level_compaction_dynamic_level_bytes = true;
+  options.statistics = CreateDBStatistics();
+  options.max_background_warmups = 1;
+  options.last_level_promotion_reads = 1000;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(GetSstSizeHelper(Temperature::kUnknown), 0);
+  ASSERT_GT(GetSstSizeHelper(Temperature::kCold), 0);
+
+  // Not read enough yet
+  ColumnFamilyData* cfd =
+      dbfull()->GetVersionSet()->GetColumnFamilySet()->GetDefault();
+  FileMetaData* cold_file =
+      cfd->current()->storage_info()->LevelFiles(kLastLevel)[0];
+  cold_file->stats.num_reads_sampled.store(999);
+  ASSERT_OK(Put(Key(kNumKeys), "value"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("1,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(GetSstSizeHelper(Temperature::kCold),
+            cold_file->fd.GetFileSize());
+
+  // The next compaction scores pick the file for promotion
+  cold_file->stats.num_reads_sampled.store(1000);
+  ASSERT_OK(Put(Key(kNumKeys + 1), "value"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+  ASSERT_EQ("2,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(GetSstSizeHelper(Temperature::kCold), 0);
+  ASSERT_GT(
+      GetCompactionStats()[kLastLevel].counts[static_cast<int>(
+          CompactionReason::kChangeTemperature)],
+      0);
+
+  // The compaction warmup already loaded the promoted data
+  ASSERT_GT(options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED), 0);
+  const uint64_t misses_before_reads =
+      options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  ASSERT_EQ(misses_before_reads,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+}
+
 // Test SST partitioner cut after every single key
 class SingleKeySstPartitioner : public SstPartitioner {
  public:
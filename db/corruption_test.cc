@@ -500,6 +500,39 @@ TEST_F(CorruptionTest, VerifyChecksumReadahead) {
   CloseDb();
 }
 
+TEST_F(CorruptionTest, ParallelVerifyChecksum) {
+  Options options;
+  options.level_compaction_dynamic_level_bytes = false;
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  Reopen(&options);
+
+  // Build 4 table files
+  Build(10000, 2500);
+  DBImpl* dbi = static_cast_with_check<DBImpl>(db_);
+  ASSERT_OK(dbi->TEST_FlushMemTable());
+  uint64_t live_sst_size = 0;
+  ASSERT_TRUE(dbi->GetIntProperty(DB::Properties::kLiveSstFilesSize,
+                                  &live_sst_size));
+
+  ReadOptions ro;
+  ro.readahead_size = size_t{64 * 1024};
+  for (bool async_io : {false, true}) {
+    ro.async_io = async_io;
+    ASSERT_OK(options.statistics->Reset());
+    ASSERT_OK(dbi->VerifyChecksum(ro, 4 /* max_threads */));
+    // The bytes read by all the threads are recorded
+    ASSERT_GE(options.statistics->getTickerCount(VERIFY_CHECKSUM_READ_BYTES),
+              live_sst_size);
+  }
+
+  Corrupt(kTableFile, 100, 1);
+  ASSERT_NOK(dbi->VerifyChecksum(ro, 4 /* max_threads */));
+  ASSERT_NOK(dbi->VerifyChecksum(ro, 1 /* max_threads */));
+
+  CloseDb();
+}
+
 TEST_F(CorruptionTest, TableFileIndexData) {
   Options options;
   options.level_compaction_dynamic_level_bytes = false;
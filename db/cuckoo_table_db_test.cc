@@ -240,6 +240,41 @@ TEST_F(CuckooTableDBTest, Uint64Comparator) {
   ASSERT_EQ("v4", Get(Uint64Key(4)));
 }
 
+TEST_F(CuckooTableDBTest, MultiGet) {
+  for (bool uint64_keys : {false, true}) {
+    Options options = CurrentOptions();
+    if (uint64_keys) {
+      options.comparator = test::Uint64Comparator();
+    }
+    DestroyAndReopen(&options);
+
+    auto key = [&](int i) { return uint64_keys ? Uint64Key(i) : Key(i); };
+    for (int i = 0; i < 100; i += 2) {
+      ASSERT_OK(Put(key(i), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(dbfull()->TEST_FlushMemTable());
+    ASSERT_EQ("1", FilesPerLevel());
+
+    std::vector<std::string> key_strs;
+    for (int i = 0; i < 100; i++) {
+      key_strs.push_back(key(i));
+    }
+    std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+    std::vector<std::string> values;
+    std::vector<Status> statuses =
+        dbfull()->MultiGet(ReadOptions(), keys, &values);
+    ASSERT_EQ(keys.size(), statuses.size());
+    for (int i = 0; i < 100; i++) {
+      if (i % 2 == 0) {
+        ASSERT_OK(statuses[i]);
+        ASSERT_EQ("v" + std::to_string(i), values[i]);
+      } else {
+        ASSERT_TRUE(statuses[i].IsNotFound());
+      }
+    }
+  }
+}
+
 TEST_F(CuckooTableDBTest, CompactionIntoMultipleFiles) {
   // Create a big L0 file and check it compacts into multiple files in L1.
   Options options = CurrentOptions();
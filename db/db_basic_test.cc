@@ -17,6 +17,7 @@
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/perf_context.h"
 #include "rocksdb/table.h"
+#include "rocksdb/threadpool.h"
 #include "rocksdb/utilities/debug.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
@@ -526,6 +527,28 @@ TEST_F(DBBasicTest, GetFromVersions) {
   } while (ChangeOptions());
 }
 
+TEST_F(DBBasicTest, GetNewSuperVersionWithoutDBMutex) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_EQ("v1", Get("foo"));
+  ASSERT_OK(Flush());
+  const uint64_t acquires =
+      options.statistics->getTickerCount(NUMBER_SUPERVERSION_ACQUIRES);
+
+  // The new thread has no SuperVersion cached, so it references the current
+  // one while another thread holds the DB mutex
+  std::string value;
+  dbfull()->TEST_LockMutex();
+  port::Thread reader([&]() { value = Get("foo"); });
+  reader.join();
+  dbfull()->TEST_UnlockMutex();
+  ASSERT_EQ("v1", value);
+  ASSERT_EQ(acquires + 1,
+            options.statistics->getTickerCount(NUMBER_SUPERVERSION_ACQUIRES));
+}
+
 TEST_F(DBBasicTest, GetSnapshot) {
   anon::OptionsOverride options_override;
   options_override.skip_policy = kSkipNoSnapshot;
@@ -1257,6 +1280,45 @@ TEST_F(DBBasicTest, MmapAndBufferOptions) {
   options.use_direct_reads = false;
   ASSERT_OK(TryReopen(options));
 }
+
+TEST_F(DBBasicTest, MmapReadsBypassBlockCache) {
+  if (!IsMemoryMappedAccessSupported()) {
+    return;
+  }
+  Options options = CurrentOptions();
+  options.allow_mmap_reads = true;
+  options.compression = kNoCompression;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 20);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(100, count);
+
+  // The uncompressed blocks are served from the mapping, without being
+  // looked up in or charged to the block cache
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_MISS));
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_ADD));
+  ASSERT_EQ(0, table_options.block_cache->GetUsage());
+}
 #endif
 
 class TestEnv : public EnvWrapper {
@@ -3375,6 +3437,57 @@ TEST_F(DBBasicTest, MultiGetIOBufferOverrun) {
                      keys.data(), values.data(), statuses.data(), true);
 }
 
+TEST_F(DBBasicTest, MultiGetDecompressionThreadPool) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  if (Snappy_Supported()) {
+    options.compression = kSnappyCompression;
+  }
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(301);
+  std::string zero_str(128, '\0');
+  std::vector<std::string> expected;
+  for (int i = 0; i < 100; ++i) {
+    // Make the value compressible
+    expected.push_back(rnd.RandomString(128) + zero_str);
+    ASSERT_OK(Put(Key(i), expected.back()));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<std::string> key_data;
+  std::vector<Slice> keys;
+  for (int i = 0; i < 100; i += 3) {
+    key_data.emplace_back(Key(i));
+  }
+  for (const auto& key : key_data) {
+    keys.emplace_back(key);
+  }
+
+  std::unique_ptr<ThreadPool> pool(NewThreadPool(2));
+  ReadOptions ro;
+  ro.multiget_decompression_thread_pool = pool.get();
+  // Without and then with block cache insertion
+  for (bool fill_cache : {false, true}) {
+    ro.fill_cache = fill_cache;
+    ASSERT_OK(options.statistics->Reset());
+    std::vector<PinnableSlice> values(keys.size());
+    std::vector<Status> statuses(keys.size());
+    db_->MultiGet(ro, db_->DefaultColumnFamily(), keys.size(), keys.data(),
+                  values.data(), statuses.data(), /*sorted_input=*/true);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(values[i], expected[i * 3]);
+    }
+    ASSERT_EQ(options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD) > 0,
+              fill_cache);
+  }
+  pool->JoinAllThreads();
+}
+
 TEST_F(DBBasicTest, MultiGetWithSnapshotsAndPersistedTier) {
   Options options = CurrentOptions();
   options.create_if_missing = true;
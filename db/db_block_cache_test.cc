@@ -466,6 +466,108 @@ TEST_F(DBBlockCacheTest, WarmCacheWithDataBlocksDuringFlush) {
             options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
 }
 
+TEST_F(DBBlockCacheTest, WarmCacheWithDataBlocksDuringCompaction) {
+  struct Limits {
+    int max_level;
+    bool metadata_only;
+    uint64_t max_bytes;
+    bool expect_warmed;
+  };
+  for (const Limits& limits :
+       {Limits{-1, false, 0, true}, Limits{1, false, 0, true},
+        Limits{0, false, 0, false}, Limits{-1, true, 0, false},
+        Limits{-1, false, 1, false}}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    options.disable_auto_compactions = true;
+
+    BlockBasedTableOptions table_options = GetTableOptions();
+    table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+    table_options.cache_index_and_filter_blocks = false;
+    table_options.prepopulate_block_cache =
+        BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndCompaction;
+    table_options.prepopulate_block_cache_compaction_max_level =
+        limits.max_level;
+    table_options.prepopulate_block_cache_compaction_metadata_only =
+        limits.metadata_only;
+    table_options.prepopulate_block_cache_compaction_max_bytes =
+        limits.max_bytes;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    std::string value(kValueSize, 'a');
+    for (size_t parity = 0; parity < 2; parity++) {
+      for (size_t i = parity; i < kNumBlocks; i += 2) {
+        ASSERT_OK(Put(std::to_string(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    // Flushes warm the blocks regardless of the compaction limits.
+    ASSERT_EQ(kNumBlocks,
+              options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    ASSERT_EQ("0,1", FilesPerLevel());
+    const uint64_t expected_adds =
+        limits.expect_warmed ? 2 * kNumBlocks : kNumBlocks;
+    ASSERT_EQ(expected_adds,
+              options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+
+    const uint64_t misses_before_reads =
+        options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS);
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      ASSERT_EQ(value, Get(std::to_string(i)));
+    }
+    ASSERT_EQ(limits.expect_warmed ? 0 : kNumBlocks,
+              options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS) -
+                  misses_before_reads);
+  }
+}
+
+TEST_F(DBBlockCacheTest, WarmCacheWithHotDataBlocksDuringCompaction) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.prepopulate_block_cache =
+      BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndCompaction;
+  table_options.prepopulate_block_cache_compaction_hot_ranges_only = true;
+  table_options.warmup_min_data_block_hits = 1;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  for (size_t parity = 0; parity < 2; parity++) {
+    for (size_t i = parity; i < kNumBlocks; i += 2) {
+      ASSERT_OK(Put(std::to_string(i), value));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ(kNumBlocks,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+  // Make the block of one key hot
+  ASSERT_EQ(value, Get("5"));
+  ASSERT_EQ(0, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+
+  // Only the output blocks around the hot key are prepopulated
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  const uint64_t compaction_adds =
+      options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD) - kNumBlocks;
+  ASSERT_GE(compaction_adds, 1);
+  ASSERT_LT(compaction_adds, kNumBlocks);
+
+  ASSERT_EQ(value, Get("5"));
+  ASSERT_EQ(0, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(value, Get("0"));
+  ASSERT_EQ(1, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+}
+
 // This test cache data, index and filter blocks during flush.
 class DBBlockCacheTest1 : public DBTestBase,
                           public ::testing::WithParamInterface<uint32_t> {
@@ -824,6 +926,688 @@ TEST_F(DBBlockCacheTest, ParanoidFileChecks) {
             TestGetTickerCount(options, BLOCK_CACHE_ADD));
 }
 
+TEST_F(DBBlockCacheTest, WarmupAfterCompaction) {
+  for (int max_background_warmups : {0, 1}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    options.level0_file_num_compaction_trigger = 2;
+    options.max_background_warmups = max_background_warmups;
+    options.compaction_warmup_policy.mode = CompactionWarmupMode::kOutputFiles;
+    BlockBasedTableOptions table_options = GetTableOptions();
+    table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+    table_options.cache_index_and_filter_blocks = false;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    // Two overlapping L0 files, so that their compaction is not a trivial
+    // move.
+    std::string value(kValueSize, 'a');
+    for (size_t parity = 0; parity < 2; parity++) {
+      for (size_t i = parity; i < kNumBlocks; i += 2) {
+        ASSERT_OK(Put(std::to_string(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_OK(dbfull()->TEST_WaitForCompact());
+    ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+    ASSERT_EQ("0,1", FilesPerLevel());
+
+    // Compaction reads do not fill the cache, so every data block added so far
+    // comes from warming the compaction output.
+    const uint64_t expected_adds = max_background_warmups > 0 ? kNumBlocks : 0;
+    ASSERT_EQ(expected_adds,
+              options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+    const uint64_t misses_before_reads =
+        options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS);
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      ASSERT_EQ(value, Get(std::to_string(i)));
+    }
+    ASSERT_EQ(kNumBlocks - expected_adds,
+              options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS) -
+                  misses_before_reads);
+  }
+}
+
+TEST_F(DBBlockCacheTest, WarmupOnlyCompactionOutputs) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_background_warmups = 1;
+  options.compaction_warmup_policy.mode = CompactionWarmupMode::kOutputFiles;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // A bottommost file overlapping the whole range that the L0->L1 compaction
+  // below does not touch.
+  std::string value(kValueSize, 'a');
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_OK(Put(std::to_string(i), value));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+
+  for (size_t parity = 0; parity < 2; parity++) {
+    for (size_t i = parity; i < kNumBlocks; i += 2) {
+      ASSERT_OK(Put(std::to_string(i), value));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+  ASSERT_EQ("0,1,1", FilesPerLevel());
+
+  // Only the blocks of the L1 output are warmed.
+  ASSERT_EQ(kNumBlocks,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+}
+
+TEST_F(DBBlockCacheTest, WarmupStats) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_background_warmups = 1;
+  options.compaction_warmup_policy.mode = CompactionWarmupMode::kOutputFiles;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  for (size_t parity = 0; parity < 2; parity++) {
+    for (size_t i = parity; i < kNumBlocks; i += 2) {
+      ASSERT_OK(Put(std::to_string(i), value));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+  ASSERT_EQ("0,1", FilesPerLevel());
+
+  ASSERT_EQ(kNumBlocks,
+            options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED));
+  ASSERT_EQ(0, options.statistics->getTickerCount(WARMUP_BLOCKS_ALREADY_CACHED));
+  const uint64_t bytes_read =
+      options.statistics->getTickerCount(WARMUP_BYTES_READ);
+  ASSERT_GE(bytes_read, kNumBlocks * kValueSize);
+  HistogramData warmup_micros;
+  options.statistics->histogramData(WARMUP_MICROS, &warmup_micros);
+  ASSERT_EQ(1, warmup_micros.count);
+
+  std::map<std::string, std::string> warmup_stats;
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kWarmupStats, &warmup_stats));
+  ASSERT_EQ("1", warmup_stats["num-jobs"]);
+  ASSERT_EQ("1", warmup_stats["num-files"]);
+  ASSERT_EQ(std::to_string(kNumBlocks), warmup_stats["blocks-inserted"]);
+  ASSERT_EQ(std::to_string(bytes_read), warmup_stats["bytes-read"]);
+  ASSERT_EQ("0", warmup_stats["blocks-already-cached"]);
+  std::string warmup_stats_str;
+  ASSERT_TRUE(
+      db_->GetProperty(DB::Properties::kWarmupStats, &warmup_stats_str));
+  ASSERT_NE(std::string::npos, warmup_stats_str.find("num-jobs: 1"));
+}
+
+TEST_F(DBBlockCacheTest, WarmupOnlyHotKeyRanges) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_background_warmups = 1;
+  options.compaction_warmup_policy.mode = CompactionWarmupMode::kHotKeyRanges;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.warmup_min_data_block_hits = 1;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  for (bool read_hot_key : {false, true}) {
+    DestroyAndReopen(options);
+    std::string value(kValueSize, 'a');
+    for (int file = 0; file < 2; file++) {
+      for (size_t i = 0; i < kNumBlocks; i++) {
+        ASSERT_OK(Put(std::to_string(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    if (read_hot_key) {
+      // The first read misses the block cache, the second one hits it.
+      ASSERT_EQ(value, Get("5"));
+      ASSERT_EQ(value, Get("5"));
+    }
+    const uint64_t data_adds_before_compaction =
+        options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD);
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+    ASSERT_EQ("0,1", FilesPerLevel());
+
+    const uint64_t warmed_blocks =
+        options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD) -
+        data_adds_before_compaction;
+    if (read_hot_key) {
+      // The blocks around the hot key, from the separator of the block
+      // before it to the first key past its block.
+      ASSERT_GE(warmed_blocks, 1);
+      ASSERT_LE(warmed_blocks, 3);
+      ASSERT_LT(warmed_blocks, kNumBlocks);
+    } else {
+      ASSERT_EQ(0, warmed_blocks);
+    }
+  }
+}
+
+TEST_F(DBBlockCacheTest, WarmupPolicyDynamicallyChangeable) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_background_warmups = 1;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  auto compact_l0 = [&]() {
+    for (size_t parity = 0; parity < 2; parity++) {
+      for (size_t i = parity; i < kNumBlocks; i += 2) {
+        ASSERT_OK(Put(std::to_string(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+  };
+
+  // Disabled by default.
+  compact_l0();
+  ASSERT_EQ(0, options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED));
+
+  // The output level is above the limit.
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"compaction_warmup_policy", "{mode=kOutputFiles;max_output_level=0}"}}));
+  ASSERT_EQ(CompactionWarmupMode::kOutputFiles,
+            dbfull()->GetOptions().compaction_warmup_policy.mode);
+  compact_l0();
+  ASSERT_EQ(0, options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED));
+
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"compaction_warmup_policy", "{mode=kOutputFiles;max_output_level=1}"}}));
+  compact_l0();
+  ASSERT_EQ(kNumBlocks,
+            options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED));
+
+  // A budget below the size of one block stops the warmup after the first
+  // output file.
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"compaction_warmup_policy",
+        "{mode=kOutputFiles;max_output_level=-1;max_bytes_per_compaction=1}"},
+       {"target_file_size_base", "1"}}));
+  options.statistics->Reset();
+  compact_l0();
+  ASSERT_GT(NumTableFilesAtLevel(1), 1);
+  ASSERT_GT(options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED), 0);
+  ASSERT_LT(options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED),
+            kNumBlocks);
+  std::map<std::string, std::string> warmup_stats;
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kWarmupStats, &warmup_stats));
+  // One file for each of the two compactions that were warmed.
+  ASSERT_EQ("2", warmup_stats["num-files"]);
+}
+
+TEST_F(DBBlockCacheTest, WarmupStopsAtCacheCapacity) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_background_warmups = 1;
+  options.compaction_warmup_policy.mode = CompactionWarmupMode::kOutputFiles;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  // Room for a few of the kNumBlocks blocks of the compaction output only.
+  const size_t kCapacity = 4 * (kValueSize + 100);
+  table_options.block_cache = NewLRUCache(kCapacity, /*num_shard_bits=*/0);
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  for (bool stop_at_cache_capacity : {false, true}) {
+    options.compaction_warmup_policy.stop_at_cache_capacity =
+        stop_at_cache_capacity;
+    DestroyAndReopen(options);
+    options.statistics->Reset();
+
+    std::string value(kValueSize, 'a');
+    for (size_t parity = 0; parity < 2; parity++) {
+      for (size_t i = parity; i < kNumBlocks; i += 2) {
+        ASSERT_OK(Put(std::to_string(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+    ASSERT_EQ("0,1", FilesPerLevel());
+
+    const uint64_t inserted =
+        options.statistics->getTickerCount(WARMUP_BLOCKS_INSERTED);
+    const uint64_t skipped =
+        options.statistics->getTickerCount(WARMUP_BLOCKS_SKIPPED);
+    std::map<std::string, std::string> warmup_stats;
+    ASSERT_TRUE(
+        db_->GetMapProperty(DB::Properties::kWarmupStats, &warmup_stats));
+    ASSERT_EQ(std::to_string(skipped), warmup_stats["blocks-skipped"]);
+    ASSERT_EQ(std::to_string(
+                  options.statistics->getTickerCount(WARMUP_BYTES_SKIPPED)),
+              warmup_stats["bytes-skipped"]);
+    if (stop_at_cache_capacity) {
+      ASSERT_GT(inserted, 0);
+      ASSERT_GT(skipped, 0);
+      ASSERT_EQ(kNumBlocks, inserted + skipped);
+      ASSERT_GT(options.statistics->getTickerCount(WARMUP_BYTES_SKIPPED), 0);
+    } else {
+      // The whole output is loaded, evicting the blocks loaded first.
+      ASSERT_EQ(kNumBlocks, inserted);
+      ASSERT_EQ(0, skipped);
+    }
+  }
+}
+
+TEST_F(DBBlockCacheTest, WarmupIndexAndFilterPartitions) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_background_warmups = 1;
+  options.compaction_warmup_policy.mode = CompactionWarmupMode::kOutputFiles;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  table_options.partition_filters = true;
+  table_options.metadata_block_size = 1;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.block_cache = NewLRUCache(1 << 20, /*num_shard_bits=*/0);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  // Opening the output files loads their partitions. Drop them before the
+  // warmup, as if they had been evicted since.
+  SyncPoint::GetInstance()->SetCallBack(
+      "WarmupScheduler::BackgroundCallWarmup:Start", [&](void* /*arg*/) {
+        table_options.block_cache->EraseUnRefEntries();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool warm_partitions : {false, true}) {
+    options.compaction_warmup_policy.warm_index_and_filter_partitions =
+        warm_partitions;
+    DestroyAndReopen(options);
+
+    std::string value(kValueSize, 'a');
+    for (size_t parity = 0; parity < 2; parity++) {
+      for (size_t i = parity; i < kNumBlocks; i += 2) {
+        ASSERT_OK(Put(std::to_string(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+    ASSERT_EQ("0,1", FilesPerLevel());
+
+    const uint64_t index_misses =
+        TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+    const uint64_t filter_misses =
+        TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS);
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      ASSERT_EQ(value, Get(std::to_string(i)));
+    }
+    // Scanning the index to find the data blocks loads the index partitions
+    // either way, but only the filter partitions that were warmed are cached.
+    ASSERT_EQ(index_misses,
+              TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS));
+    if (warm_partitions) {
+      ASSERT_EQ(filter_misses,
+                TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS));
+    } else {
+      ASSERT_LT(filter_misses,
+                TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS));
+    }
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBBlockCacheTest, WarmupToSecondaryCache) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.max_background_warmups = 1;
+  options.compaction_warmup_policy.mode = CompactionWarmupMode::kOutputFiles;
+  options.compaction_warmup_policy.secondary_cache_min_output_level = 1;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.cache_index_and_filter_blocks = false;
+
+  for (bool with_secondary_cache : {false, true}) {
+    LRUCacheOptions cache_options(1 << 20, /*num_shard_bits=*/0,
+                                  /*strict_capacity_limit=*/false,
+                                  /*high_pri_pool_ratio=*/0.5);
+    if (with_secondary_cache) {
+      CompressedSecondaryCacheOptions secondary_cache_options;
+      secondary_cache_options.capacity = 1 << 20;
+      cache_options.secondary_cache =
+          NewCompressedSecondaryCache(secondary_cache_options);
+    }
+    table_options.block_cache = cache_options.MakeSharedCache();
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    std::string value(kValueSize, 'a');
+    for (size_t parity = 0; parity < 2; parity++) {
+      for (size_t i = parity; i < kNumBlocks; i += 2) {
+        ASSERT_OK(Put(std::to_string(i), value));
+      }
+      ASSERT_OK(Flush());
+    }
+    options.statistics->Reset();
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    ASSERT_OK(dbfull()->TEST_WaitForWarmup());
+    ASSERT_EQ("0,1", FilesPerLevel());
+
+    std::map<std::string, std::string> warmup_stats;
+    ASSERT_TRUE(
+        db_->GetMapProperty(DB::Properties::kWarmupStats, &warmup_stats));
+    ASSERT_EQ(std::to_string(kNumBlocks), warmup_stats["blocks-inserted"]);
+    if (with_secondary_cache) {
+      ASSERT_EQ(std::to_string(kNumBlocks),
+                warmup_stats["blocks-inserted-to-secondary-cache"]);
+      ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+      for (size_t i = 0; i < kNumBlocks; i++) {
+        ASSERT_EQ(value, Get(std::to_string(i)));
+      }
+      ASSERT_EQ(kNumBlocks,
+                TestGetTickerCount(options, SECONDARY_CACHE_DATA_HITS));
+    } else {
+      // Without a secondary cache, the blocks go to the primary one.
+      ASSERT_EQ("0", warmup_stats["blocks-inserted-to-secondary-cache"]);
+      ASSERT_EQ(kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+    }
+  }
+}
+
+TEST_F(DBBlockCacheTest, WarmupRange) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_OK(Put(std::to_string(i), value));
+  }
+  ASSERT_OK(Flush());
+
+  // Background warmups are disabled.
+  WarmupOptions warmup_options;
+  warmup_options.wait = false;
+  ASSERT_TRUE(db_->WarmupRange(db_->DefaultColumnFamily(), nullptr, nullptr,
+                               warmup_options)
+                  .IsNotSupported());
+
+  std::vector<WarmupProgress> reports;
+  warmup_options.wait = true;
+  warmup_options.progress_callback = [&](const WarmupProgress& progress) {
+    reports.push_back(progress);
+  };
+  warmup_options.data_blocks = false;
+  ASSERT_OK(db_->WarmupRange(db_->DefaultColumnFamily(), nullptr, nullptr,
+                             warmup_options));
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+
+  reports.clear();
+  warmup_options.data_blocks = true;
+  ASSERT_OK(db_->WarmupRange(db_->DefaultColumnFamily(), nullptr, nullptr,
+                             warmup_options));
+  ASSERT_EQ(kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+  // One report for the file and the final one.
+  ASSERT_EQ(2U, reports.size());
+  ASSERT_FALSE(reports[0].done);
+  ASSERT_TRUE(reports[1].done);
+  ASSERT_OK(reports[1].status);
+  ASSERT_EQ(1U, reports[1].files_warmed);
+  ASSERT_EQ(1U, reports[1].total_files);
+  ASSERT_EQ(kNumBlocks, reports[1].blocks_inserted);
+
+  // Warming again only finds cached blocks, and reading them does not miss.
+  reports.clear();
+  const Slice begin("0");
+  const Slice end("9");
+  ASSERT_OK(db_->WarmupRange(db_->DefaultColumnFamily(), &begin, &end,
+                             warmup_options));
+  ASSERT_EQ(kNumBlocks, reports.back().blocks_already_cached);
+  ASSERT_EQ(0U, reports.back().blocks_inserted);
+  const uint64_t misses_before_reads =
+      TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(std::to_string(i)));
+  }
+  ASSERT_EQ(misses_before_reads,
+            TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  ASSERT_TRUE(db_->WarmupRange(db_->DefaultColumnFamily(), &end, &begin,
+                               warmup_options)
+                  .IsInvalidArgument());
+}
+
+TEST_F(DBBlockCacheTest, RestoreBlockCacheDumpOnOpen) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.block_cache_dump_file = dbname_ + "_block_cache_dump";
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.cache_index_and_filter_blocks = false;
+  auto reopen_with_new_cache = [&]() {
+    table_options.block_cache = NewLRUCache(1 << 20, /*num_shard_bits=*/0);
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    Reopen(options);
+    dbfull()->TEST_WaitForBlockCacheRestore();
+    options.statistics->Reset();
+  };
+  // Left over by an earlier run
+  env_->DeleteFile(options.block_cache_dump_file).PermitUncheckedError();
+  table_options.block_cache = NewLRUCache(1 << 20, /*num_shard_bits=*/0);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  for (size_t parity = 0; parity < 2; parity++) {
+    for (size_t i = parity; i < kNumBlocks; i += 2) {
+      ASSERT_OK(Put(std::to_string(i), value));
+    }
+    ASSERT_OK(Flush());
+  }
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(std::to_string(i)));
+  }
+
+  // The blocks read are dumped on close and restored into the new block
+  // cache on open.
+  reopen_with_new_cache();
+  ASSERT_GT(table_options.block_cache->GetUsage(), 0);
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(std::to_string(i)));
+  }
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT));
+
+  // Files compacted away between the dump and the restore have their blocks
+  // skipped.
+  const std::string dump_file = options.block_cache_dump_file;
+  options.block_cache_dump_file.clear();
+  Reopen(options);
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  options.block_cache_dump_file = dump_file;
+  reopen_with_new_cache();
+  ASSERT_EQ(0, table_options.block_cache->GetUsage());
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(std::to_string(i)));
+  }
+  ASSERT_EQ(kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+
+  Close();
+  ASSERT_OK(env_->DeleteFile(dump_file));
+}
+
+TEST_F(DBBlockCacheTest, RestartWarmupFromReadHotness) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.read_hotness_file = dbname_ + "_read_hotness";
+  options.read_hotness_persist_period_sec = 0;
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.warmup_min_data_block_hits = 1;
+  table_options.block_cache = NewLRUCache(1 << 20, /*num_shard_bits=*/0);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  // Left over by an earlier run
+  env_->DeleteFile(options.read_hotness_file).PermitUncheckedError();
+  DestroyAndReopen(options);
+
+  // Two files with disjoint key ranges, so that reading one of them does not
+  // touch the other.
+  std::string value(kValueSize, 'a');
+  for (const char* prefix : {"a", "b"}) {
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      ASSERT_OK(Put(prefix + std::to_string(i), value));
+    }
+    ASSERT_OK(Flush());
+  }
+  // The first read misses the block cache, the second one hits it.
+  ASSERT_EQ(value, Get("a5"));
+  ASSERT_EQ(value, Get("a5"));
+
+  // The hotness is saved on close, and only the blocks around the hot key
+  // are loaded into the new block cache on open.
+  table_options.block_cache = NewLRUCache(1 << 20, /*num_shard_bits=*/0);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  dbfull()->TEST_WaitForRestartWarmup();
+  const uint64_t warmed_blocks =
+      TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD);
+  ASSERT_GE(warmed_blocks, 1);
+  ASSERT_LE(warmed_blocks, 3);
+  ASSERT_EQ(warmed_blocks, TestGetTickerCount(options, WARMUP_BLOCKS_INSERTED));
+
+  options.statistics->Reset();
+  ASSERT_EQ(value, Get("a5"));
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(value, Get("b5"));
+  ASSERT_EQ(1, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+
+  Close();
+  ASSERT_OK(env_->FileExists(options.read_hotness_file));
+  ASSERT_OK(env_->DeleteFile(options.read_hotness_file));
+}
+
+TEST_F(DBBlockCacheTest, ScanResistantIterator) {
+  for (bool scan_resistant : {false, true}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    BlockBasedTableOptions table_options = GetTableOptions();
+    LRUCacheOptions co;
+    co.capacity = 1 << 20;
+    co.num_shard_bits = 0;
+    co.strict_capacity_limit = false;
+    co.high_pri_pool_ratio = 0;
+    co.low_pri_pool_ratio = 0.5;
+    table_options.block_cache = co.MakeSharedCache();
+    table_options.cache_index_and_filter_blocks = false;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    std::string value(kValueSize, 'a');
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      ASSERT_OK(Put(std::to_string(i), value));
+    }
+    ASSERT_OK(Flush());
+
+    // The working set of the point lookups, then a cache with room for only
+    // a few more blocks.
+    ASSERT_EQ(value, Get("0"));
+    const size_t block_charge = table_options.block_cache->GetUsage();
+    ASSERT_GT(block_charge, 0);
+    table_options.block_cache->SetCapacity(4 * block_charge +
+                                           block_charge / 2);
+
+    ReadOptions read_options;
+    read_options.scan_resistant = scan_resistant;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    size_t num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumBlocks, num_keys);
+    iter.reset();
+    // The scan hit the cached block and loaded the others.
+    ASSERT_EQ(kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+
+    // Only a scan-resistant scan leaves the working set in the cache.
+    options.statistics->Reset();
+    ASSERT_EQ(value, Get("0"));
+    ASSERT_EQ(scan_resistant ? 0 : 1,
+              TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  }
+}
+
+TEST_F(DBBlockCacheTest, DataBlockFetchUnit) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.compression = kNoCompression;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  BlockBasedTableOptions table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(1 << 20);
+  table_options.cache_index_and_filter_blocks = false;
+  // Room for a few of the one-entry data blocks
+  table_options.data_block_fetch_unit_size = 512;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_OK(Put(std::to_string(i), value));
+  }
+  ASSERT_OK(Flush());
+  Reopen(options);
+
+  // The first lookup loads the whole fetch unit, not only its own block.
+  ASSERT_EQ(value, Get("0"));
+  const uint64_t num_loaded = TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD);
+  ASSERT_GT(num_loaded, 1U);
+  ASSERT_LT(num_loaded, kNumBlocks);
+  ASSERT_EQ(num_loaded, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+
+  // Lookups in the same unit hit the cache.
+  ASSERT_EQ(value, Get("1"));
+  ASSERT_EQ(num_loaded, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+
+  // The padding between units leaves every key readable.
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(std::to_string(i)));
+  }
+  ASSERT_EQ(kNumBlocks, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+}
+
 TEST_F(DBBlockCacheTest, CacheCompressionDict) {
   const int kNumFiles = 4;
   const int kNumEntriesPerFile = 128;
@@ -911,17 +1695,35 @@ static void ClearCache(Cache* cache) {
   }
 }
 
+namespace {
+
+// Hides the charges by role maintained by the wrapped cache, so that its
+// entry stats are gathered by scanning it.
+class ScanOnlyCache : public CacheWrapper {
+ public:
+  using CacheWrapper::CacheWrapper;
+  const char* Name() const override { return target_->Name(); }
+  bool GetChargesByRole(
+      std::array<size_t, kNumCacheEntryRoles>* /*charges*/,
+      std::array<size_t, kNumCacheEntryRoles>* /*counts*/) const override {
+    return false;
+  }
+};
+
+}  // namespace
+
 TEST_F(DBBlockCacheTest, CacheEntryRoleStats) {
   const size_t capacity = size_t{1} << 25;
   int iterations_tested = 0;
   for (bool partition : {false, true}) {
     SCOPED_TRACE("Partition? " + std::to_string(partition));
     for (const std::shared_ptr<Cache>& cache :
-         {NewLRUCache(capacity),
-          HyperClockCacheOptions(
-              capacity,
-              BlockBasedTableOptions().block_size /*estimated_value_size*/)
-              .MakeSharedCache()}) {
+         {std::make_shared<ScanOnlyCache>(NewLRUCache(capacity)),
+          std::make_shared<ScanOnlyCache>(
+              HyperClockCacheOptions(
+                  capacity,
+                  BlockBasedTableOptions().block_size /*estimated_value_size*/)
+                  .MakeSharedCache())}) {
       SCOPED_TRACE(std::string("Cache: ") + cache->Name());
       ++iterations_tested;
 
@@ -1154,6 +1956,71 @@ TEST_F(DBBlockCacheTest, CacheEntryRoleStats) {
   }
 }
 
+TEST_F(DBBlockCacheTest, CacheEntryRoleStatsFromCounters) {
+  const size_t capacity = size_t{1} << 25;
+  for (const std::shared_ptr<Cache>& cache :
+       {NewLRUCache(capacity),
+        HyperClockCacheOptions(
+            capacity,
+            BlockBasedTableOptions().block_size /*estimated_value_size*/)
+            .MakeSharedCache()}) {
+    SCOPED_TRACE(std::string("Cache: ") + cache->Name());
+
+    Options options = CurrentOptions();
+    SetTimeElapseOnlySleepOnReopen(&options);
+    options.create_if_missing = true;
+    options.stats_dump_period_sec = 0;
+
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = cache;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+    table_options.metadata_cache_options.unpartitioned_pinning =
+        PinningTier::kNone;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    ASSERT_OK(Put("foo", "value"));
+    ASSERT_OK(Flush());
+    ClearCache(cache.get());
+
+    int scan_count = 0;
+    SyncPoint::GetInstance()->SetCallBack(
+        "CacheEntryStatsCollector::GetStats:AfterApplyToAllEntries",
+        [&scan_count](void*) { ++scan_count; });
+    SyncPoint::GetInstance()->EnableProcessing();
+
+    std::array<size_t, kNumCacheEntryRoles> expected{};
+    // For CacheEntryStatsCollector
+    expected[static_cast<size_t>(CacheEntryRole::kMisc)] = 1;
+    EXPECT_EQ(expected, GetCacheEntryRoleCountsBg());
+
+    // Up to date without waiting out the interval between scans
+    ASSERT_EQ("value", Get("foo"));
+    expected[static_cast<size_t>(CacheEntryRole::kFilterBlock)]++;
+    expected[static_cast<size_t>(CacheEntryRole::kIndexBlock)]++;
+    expected[static_cast<size_t>(CacheEntryRole::kDataBlock)]++;
+    EXPECT_EQ(expected, GetCacheEntryRoleCountsBg());
+
+    std::map<std::string, std::string> values;
+    ASSERT_TRUE(
+        db_->GetMapProperty(DB::Properties::kBlockCacheEntryStats, &values));
+    EXPECT_EQ("0",
+              values[BlockCacheEntryStatsMapKeys::LastCollectionAgeSeconds()]);
+    EXPECT_NE("0", values[BlockCacheEntryStatsMapKeys::UsedBytes(
+                       CacheEntryRole::kDataBlock)]);
+
+    ClearCache(cache.get());
+    expected = {};
+    expected[static_cast<size_t>(CacheEntryRole::kMisc)] = 1;
+    EXPECT_EQ(expected, GetCacheEntryRoleCountsBg());
+
+    EXPECT_EQ(scan_count, 0);
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+  }
+}
+
 namespace {
 
 void DummyFillCache(Cache& cache, size_t entry_size,
@@ -3552,6 +3552,129 @@ TEST_F(DBBloomFilterTest, DynamicBloomFilterOptions) {
   }
 }
 
+TEST_F(DBBloomFilterTest, RangeFilterPolicy) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy = NewRangeFilterPolicy(
+      std::shared_ptr<const FilterPolicy>(NewBloomFilterPolicy(10)), {2, 4});
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Both files span the ranges of series "bbbb"
+  for (int i = 0; i < 2; i++) {
+    for (int t = 0; t < 10; t++) {
+      ASSERT_OK(Put("aaaa" + std::to_string(t), "v"));
+      ASSERT_OK(Put("cccc" + std::to_string(t), "v"));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  Slice upper_bound;
+  ReadOptions read_options;
+  read_options.iterate_upper_bound = &upper_bound;
+  auto count = [&](const char* target, const char* upper) {
+    upper_bound = upper;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    return CountIter(iter, target);
+  };
+
+  // Bounds sharing a prefix
+  EXPECT_EQ(count("bbbb0", "bbbb5"), 0);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTERED), 2);
+  EXPECT_EQ(count("cccc0", "cccc5"), 5);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTERED), 0);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTER_MATCH), 2);
+
+  // Upper bound being the successor of a prefix
+  EXPECT_EQ(count("bbbb", "bbbc"), 0);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTERED), 2);
+  EXPECT_EQ(count("cccc", "cccd"), 10);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTERED), 0);
+
+  // Only the shorter prefix is shared
+  EXPECT_EQ(count("bb", "bc"), 0);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTERED), 2);
+  EXPECT_EQ(count("aaaa5", "ab"), 5);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTERED), 0);
+
+  // No prefix is shared
+  EXPECT_EQ(count("bbbb0", "cccc5"), 5);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTERED), 0);
+  EXPECT_EQ(PopTicker(options, NON_LAST_LEVEL_SEEK_FILTER_MATCH), 0);
+
+  // Point lookups still use the filter
+  ASSERT_EQ("v", Get("aaaa1"));
+  ASSERT_EQ("NOT_FOUND", Get("bbbb1"));
+  EXPECT_EQ(PopTicker(options, BLOOM_FILTER_USEFUL), 2);
+}
+
+TEST_F(DBBloomFilterTest, LevelAdaptiveBloomFilterPolicy) {
+  const double ln2_squared = std::log(2.0) * std::log(2.0);
+  // The small level gets the bits taken from the large one, and the empty
+  // level as many as the small one.
+  std::vector<double> bits =
+      LevelAdaptiveBloomFilterPolicy::AllocateBitsPerKey(
+          10, {100, 0, 10000}, {0, 0, 0});
+  ASSERT_EQ(3U, bits.size());
+  ASSERT_NEAR(bits[0] - bits[2], std::log(100.0) / ln2_squared, 0.01);
+  ASSERT_NEAR(100 * bits[0] + 10000 * bits[2], 10 * 10100, 1);
+  ASSERT_EQ(bits[0], bits[1]);
+  // Of two levels of the same size, the most probed gets the most bits.
+  bits = LevelAdaptiveBloomFilterPolicy::AllocateBitsPerKey(10, {1000, 1000},
+                                                            {99, 0});
+  ASSERT_NEAR(bits[0] - bits[1], std::log(100.0) / ln2_squared, 0.01);
+  ASSERT_NEAR(bits[0] + bits[1], 20, 0.01);
+  ASSERT_TRUE(
+      LevelAdaptiveBloomFilterPolicy::AllocateBitsPerKey(10, {0, 0}, {})
+          .empty());
+
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.level_compaction_dynamic_level_bytes = false;
+  options.num_levels = 3;
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy = NewLevelAdaptiveBloomFilterPolicy(10);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const auto* policy = table_options.filter_policy
+                           ->CheckedCast<LevelAdaptiveBloomFilterPolicy>();
+  ASSERT_NE(policy, nullptr);
+  DestroyAndReopen(options);
+  // Nothing to allocate yet
+  ASSERT_EQ(10, policy->GetBitsPerKey(kDefaultColumnFamilyName, 1));
+
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_OK(Put(Key(i), "v"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  for (int i = 0; i < 500; i++) {
+    ASSERT_OK(Put(Key(i), "w"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_GT(policy->GetBitsPerKey(kDefaultColumnFamilyName, 1), 12);
+  ASSERT_LT(policy->GetBitsPerKey(kDefaultColumnFamilyName, 2), 10);
+
+  // The compaction into the empty L1 builds its filter with more bits.
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_EQ("0,1,1", FilesPerLevel());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  bool found = false;
+  for (const auto& file : files) {
+    if (file.level == 1) {
+      const auto& file_props = props.at(file.db_path + file.name);
+      ASSERT_GT(file_props->filter_size * 8.0 / file_props->num_entries, 12);
+      found = true;
+    }
+  }
+  ASSERT_TRUE(found);
+}
+
 TEST_F(DBBloomFilterTest, SeekForPrevWithPartitionedFilters) {
   for (bool wkf : {true, false}) {
     SCOPED_TRACE("whole_key_filtering=" + std::to_string(wkf));
@@ -4385,6 +4508,206 @@ TEST_F(DBBloomFilterTest, FixedWidthSegments) {
   EXPECT_EQ(0, TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA));
 }
 
+TEST_F(DBBloomFilterTest, BackgroundFilterBuild) {
+  for (bool ribbon : {false, true}) {
+    BlockBasedTableOptions bbto;
+    bbto.filter_policy.reset(ribbon ? NewRibbonFilterPolicy(10)
+                                    : NewBloomFilterPolicy(10));
+    bbto.background_filter_build = true;
+    Options options = CurrentOptions();
+    options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+    options.statistics = CreateDBStatistics();
+    DestroyAndReopen(options);
+
+    const int kNumKeys = 10000;
+    for (int i = 0; i < kNumKeys; i += 2) {
+      ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+    TablePropertiesCollection tpc;
+    ASSERT_OK(db_->GetPropertiesOfAllTables(&tpc));
+    ASSERT_EQ(1U, tpc.size());
+    EXPECT_EQ(kNumKeys / 2, tpc.begin()->second->num_filter_entries);
+    EXPECT_GT(tpc.begin()->second->filter_size, 0U);
+
+    for (int i = 0; i < kNumKeys; i++) {
+      const std::string expected =
+          i % 2 == 0 ? "v" + std::to_string(i) : "NOT_FOUND";
+      ASSERT_EQ(expected, Get(Key(i)));
+    }
+    // Most of the absent keys are filtered out
+    EXPECT_GT(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), kNumKeys / 4);
+  }
+}
+
+TEST_F(DBBloomFilterTest, PrefixBlockMap) {
+  BlockBasedTableOptions bbto;
+  bbto.prefix_block_map = true;
+  bbto.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  bbto.block_size = 256;
+  bbto.metadata_block_size = 128;
+  bbto.cache_index_and_filter_blocks = true;
+
+  Options options = CurrentOptions();
+  options.prefix_extractor.reset(NewFixedPrefixTransform(4));
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  // The even prefixes p000, p002, ..., p098, where every fifth one has a
+  // single key and the other ones span several data blocks
+  auto key = [](int prefix, int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "p%03dk%04d", prefix, i);
+    return std::string(buf);
+  };
+  auto num_keys = [](int prefix) { return prefix % 10 == 0 ? 1 : 3 * prefix; };
+  for (int prefix = 0; prefix < 100; prefix += 2) {
+    for (int i = 0; i < num_keys(prefix); i++) {
+      ASSERT_OK(Put(key(prefix, i), "value" + key(prefix, i)));
+    }
+  }
+  ASSERT_OK(Flush());
+
+  for (int prefix = 0; prefix < 100; prefix += 2) {
+    for (int i = 0; i < num_keys(prefix); i++) {
+      ASSERT_EQ("value" + key(prefix, i), Get(key(prefix, i)));
+    }
+    ASSERT_EQ("NOT_FOUND", Get(key(prefix, num_keys(prefix))));
+  }
+
+  auto index_accesses = [&]() {
+    return TestGetAndResetTickerCount(options, BLOCK_CACHE_INDEX_HIT) +
+           TestGetAndResetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+  };
+  auto data_accesses = [&]() {
+    return TestGetAndResetTickerCount(options, BLOCK_CACHE_DATA_HIT) +
+           TestGetAndResetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  };
+  index_accesses();
+  data_accesses();
+
+  // A prefix not in the file reads no block
+  ASSERT_EQ("NOT_FOUND", Get(key(13, 0)));
+  ASSERT_EQ(0, index_accesses());
+  ASSERT_EQ(0, data_accesses());
+
+  // A prefix in a single data block reads that block without the index
+  ASSERT_EQ("value" + key(20, 0), Get(key(20, 0)));
+  ASSERT_EQ("NOT_FOUND", Get(key(20, 1)));
+  ASSERT_EQ(0, index_accesses());
+  ASSERT_EQ(2, data_accesses());
+
+  ReadOptions read_options;
+  read_options.prefix_same_as_start = true;
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    iter->Seek(key(13, 0));
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+    iter->Seek(key(14, 5));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(14, 5), iter->key());
+  }
+  read_options.prefix_same_as_start = false;
+  read_options.total_order_seek = true;
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    iter->Seek(key(13, 0));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(14, 0), iter->key());
+  }
+}
+
+TEST_F(DBBloomFilterTest, BottommostHashIndex) {
+  std::shared_ptr<Cache> cache = NewLRUCache(8 << 20);
+  BlockBasedTableOptions bbto;
+  bbto.filter_policy.reset(NewBloomFilterPolicy(10));
+  bbto.block_size = 256;
+  bbto.cache_index_and_filter_blocks = true;
+  bbto.block_cache = cache;
+
+  Options options = CurrentOptions();
+  options.bottommost_hash_index = true;
+  options.disable_auto_compactions = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 2000;
+  const std::string filler(100, 'x');
+  for (int i = 0; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), "old" + std::to_string(i) + filler));
+  }
+  // Keep the old versions of some keys, so that the versions of a key can
+  // span data blocks
+  const Snapshot* snapshot = db_->GetSnapshot();
+  for (int i = 0; i < kNumKeys; i += 10) {
+    ASSERT_OK(Put(Key(i), "new" + std::to_string(i) + filler));
+  }
+  ASSERT_OK(Flush());
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+
+  auto hash_index_charge = [&]() {
+    std::array<size_t, kNumCacheEntryRoles> charges;
+    std::array<size_t, kNumCacheEntryRoles> counts;
+    EXPECT_TRUE(cache->GetChargesByRole(&charges, &counts));
+    return charges[static_cast<size_t>(CacheEntryRole::kBottommostHashIndex)];
+  };
+  EXPECT_GT(hash_index_charge(), 0U);
+
+  auto check_values = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      if (i % 2 != 0) {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+        continue;
+      }
+      const std::string prefix = i % 10 == 0 ? "new" : "old";
+      ASSERT_EQ(prefix + std::to_string(i) + filler, Get(Key(i)));
+      ASSERT_EQ("old" + std::to_string(i) + filler, Get(Key(i), snapshot));
+    }
+  };
+  check_values();
+
+  auto filter_and_index_accesses = [&]() {
+    return TestGetAndResetTickerCount(options, BLOCK_CACHE_FILTER_HIT) +
+           TestGetAndResetTickerCount(options, BLOCK_CACHE_FILTER_MISS) +
+           TestGetAndResetTickerCount(options, BLOCK_CACHE_INDEX_HIT) +
+           TestGetAndResetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+  };
+  auto data_accesses = [&]() {
+    return TestGetAndResetTickerCount(options, BLOCK_CACHE_DATA_HIT) +
+           TestGetAndResetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  };
+  filter_and_index_accesses();
+  data_accesses();
+
+  // Absent keys read no block
+  for (int i = 1; i < kNumKeys; i += 2) {
+    ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+  }
+  ASSERT_EQ(0, filter_and_index_accesses());
+  ASSERT_EQ(0, data_accesses());
+
+  // A key with a single version reads its data block only
+  ASSERT_EQ("old2" + filler, Get(Key(2)));
+  ASSERT_EQ(0, filter_and_index_accesses());
+  ASSERT_EQ(1, data_accesses());
+
+  // The hash indexes are not persisted, and their charge goes away with the
+  // files that had them
+  db_->ReleaseSnapshot(snapshot);
+  snapshot = nullptr;
+  Reopen(options);
+  EXPECT_EQ(0U, hash_index_charge());
+  ASSERT_EQ("new10" + filler, Get(Key(10)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(11)));
+  EXPECT_GT(filter_and_index_accesses(), 0);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -905,6 +905,93 @@ TEST_F(DBTestCompactionFilter, SkipUntilWithBloomFilter) {
   EXPECT_EQ("v50", val);
 }
 
+// Decides by the number in the value: removes 4n, changes 4n+1, keeps 4n+3
+// and leaves 4n+2 to FilterV2()
+class BatchFilter : public CompactionFilter {
+ public:
+  size_t GetFilterBatchSize() const override { return 7; }
+
+  void FilterBatch(int /*level*/, const std::vector<Slice>& keys,
+                   const std::vector<Slice>& existing_values,
+                   std::vector<Decision>* decisions,
+                   std::vector<std::string>* new_values) const override {
+    EXPECT_LE(keys.size(), 7u);
+    EXPECT_EQ(keys.size(), existing_values.size());
+    EXPECT_EQ(keys.size(), decisions->size());
+    EXPECT_EQ(keys.size(), new_values->size());
+    num_batched_ += keys.size();
+    for (size_t i = 0; i < keys.size(); i++) {
+      switch (std::stoi(existing_values[i].ToString()) % 4) {
+        case 0:
+          (*decisions)[i] = Decision::kRemove;
+          break;
+        case 1:
+          (*decisions)[i] = Decision::kChangeValue;
+          (*new_values)[i] = NEW_VALUE;
+          break;
+        case 3:
+          (*decisions)[i] = Decision::kKeep;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  Decision FilterV2(int /*level*/, const Slice& /*key*/,
+                    ValueType /*value_type*/, const Slice& existing_value,
+                    std::string* /*new_value*/,
+                    std::string* /*skip_until*/) const override {
+    EXPECT_EQ(2, std::stoi(existing_value.ToString()) % 4);
+    num_unbatched_++;
+    return Decision::kKeep;
+  }
+
+  const char* Name() const override { return "BatchFilter"; }
+
+  mutable std::atomic<size_t> num_batched_{0};
+  mutable std::atomic<size_t> num_unbatched_{0};
+};
+
+TEST_F(DBTestCompactionFilter, FilterBatch) {
+  auto filter = std::make_shared<BatchFilter>();
+  Options options = CurrentOptions();
+  options.compaction_filter = filter.get();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 100;
+  // The older versions of the keys are hidden under the newer ones, whatever
+  // the filter decides for them
+  for (int version = 0; version < 2; ++version) {
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_OK(Put(Key(i), std::to_string(version * kNumKeys + i)));
+    }
+    ASSERT_OK(Flush());
+  }
+  filter->num_batched_ = 0;
+  filter->num_unbatched_ = 0;
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GE(filter->num_batched_.load(), static_cast<size_t>(kNumKeys));
+  ASSERT_EQ(static_cast<size_t>(kNumKeys / 4), filter->num_unbatched_.load());
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    std::string expected;
+    switch (i % 4) {
+      case 0:
+        expected = "NOT_FOUND";
+        break;
+      case 1:
+        expected = NEW_VALUE;
+        break;
+      default:
+        expected = std::to_string(kNumKeys + i);
+        break;
+    }
+    ASSERT_EQ(expected, Get(Key(i)));
+  }
+}
+
 class TestNotSupportedFilter : public CompactionFilter {
  public:
   bool Filter(int /*level*/, const Slice& /*key*/, const Slice& /*value*/,
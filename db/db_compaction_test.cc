@@ -7,6 +7,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <set>
+#include <thread>
 #include <tuple>
 
 #include "compaction/compaction_picker_universal.h"
@@ -729,6 +731,55 @@ TEST_F(DBCompactionTest, CompactRangeBottomPri) {
   SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBCompactionTest, CompactRangeParallelShards) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  env_->SetBackgroundThreads(4, Env::Priority::LOW);
+
+  // 4 non-overlapping files in L2
+  for (int f = 0; f < 4; ++f) {
+    for (int i = f * 100; i < (f + 1) * 100; ++i) {
+      ASSERT_OK(Put(Key(i), "old"));
+    }
+    ASSERT_OK(Flush());
+  }
+  {
+    CompactRangeOptions cro;
+    cro.change_level = true;
+    cro.target_level = 2;
+    ASSERT_OK(dbfull()->CompactRange(cro, nullptr, nullptr));
+  }
+  ASSERT_EQ("0,0,4", FilesPerLevel(0));
+
+  for (int i = 0; i < 400; i += 7) {
+    ASSERT_OK(Put(Key(i), "new"));
+  }
+  ASSERT_OK(Flush());
+
+  std::atomic<uint32_t> completed_shards{0};
+  CompactRangeOptions cro;
+  cro.max_parallel_shards = 4;
+  cro.completed_shards = &completed_shards;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(dbfull()->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ(4, completed_shards.load());
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_EQ(0, NumTableFilesAtLevel(1));
+  for (int i = 0; i < 400; ++i) {
+    ASSERT_EQ(i % 7 == 0 ? "new" : "old", Get(Key(i)));
+  }
+
+  // A range within one file is not split
+  completed_shards = 0;
+  std::string begin = Key(10);
+  std::string end = Key(20);
+  Slice begin_slice(begin);
+  Slice end_slice(end);
+  ASSERT_OK(dbfull()->CompactRange(cro, &begin_slice, &end_slice));
+  ASSERT_EQ(0, completed_shards.load());
+}
+
 TEST_F(DBCompactionTest, DisableStatsUpdateReopen) {
   uint64_t db_size[3];
   for (int test = 0; test < 2; ++test) {
@@ -1189,6 +1240,58 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNonTrivial) {
   ASSERT_EQ("B", Get("bbbb1"));
 }
 
+TEST_F(DBCompactionTest, CompactionSstPartitionerHotRanges) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleLevel;
+  options.disable_auto_compactions = true;
+  options.sst_partitioner_factory = NewSstPartitionerHotRangesFactory(0);
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25);
+  table_options.block_size = 1024;
+  table_options.warmup_min_data_block_hits = 1;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  for (bool read_hot_keys : {false, true}) {
+    DestroyAndReopen(options);
+    // Two overlapping files, so that the compaction is not a trivial move
+    Random rnd(301);
+    for (int file = 0; file < 2; file++) {
+      for (int i = 0; i < 100; i++) {
+        ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+      }
+      ASSERT_OK(Flush());
+    }
+    if (read_hot_keys) {
+      // The first reads miss the block cache, the second ones hit it
+      for (int round = 0; round < 2; round++) {
+        for (int i = 40; i < 50; i++) {
+          Get(Key(i));
+        }
+      }
+    }
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+
+    std::vector<LiveFileMetaData> files;
+    dbfull()->GetLiveFilesMetaData(&files);
+    if (!read_hot_keys) {
+      ASSERT_EQ(1, files.size());
+      continue;
+    }
+    // The hot keys are in a file of their own, between two cold ones
+    ASSERT_EQ(3, files.size());
+    std::sort(files.begin(), files.end(),
+              [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+                return a.smallestkey < b.smallestkey;
+              });
+    ASSERT_EQ(Key(0), files[0].smallestkey);
+    ASSERT_LE(files[1].smallestkey, Key(40));
+    ASSERT_GT(files[1].smallestkey, Key(0));
+    ASSERT_GE(files[1].largestkey, Key(49));
+    ASSERT_LT(files[1].largestkey, Key(99));
+    ASSERT_EQ(Key(99), files[2].largestkey);
+  }
+}
+
 TEST_F(DBCompactionTest, ZeroSeqIdCompaction) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -2301,6 +2404,67 @@ TEST_P(DBCompactionTestWithParam, TrivialMoveToLastLevelWithFiles) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBCompactionTest, MoveEdgeOverlapsDown) {
+  Options options = CurrentOptions();
+  options.num_levels = 4;
+  options.level_compaction_dynamic_level_bytes = false;
+  options.max_bytes_for_level_base = 256 * 1024;
+  options.max_bytes_for_level_multiplier = 10;
+  options.target_file_size_base = 64 * 1024 * 1024;
+  options.write_buffer_size = 64 * 1024 * 1024;
+  options.disable_auto_compactions = true;
+  options.level_compaction_move_edge_overlaps = true;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  // A small L2 file with keys [ 99 => 100 ]
+  ASSERT_OK(Put(Key(99), "small"));
+  ASSERT_OK(Put(Key(100), "small"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  // A large L1 file with keys [ 0 => 99 ], overlapping the L2 file at its
+  // edge
+  for (int i = 0; i < 100; i++) {
+    values.push_back(rnd.RandomString(10 * 1024));
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_EQ("0,1,1", FilesPerLevel(0));
+
+  int32_t trivial_move = 0;
+  int32_t non_trivial_move = 0;
+  int32_t edge_overlap_move = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:TrivialMove",
+      [&](void* /*arg*/) { trivial_move++; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:NonTrivial",
+      [&](void* /*arg*/) { non_trivial_move++; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionBuilder::TryPickEdgeOverlapMove:Picked",
+      [&](void* /*arg*/) { edge_overlap_move++; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  // L1 is over its target size. The L2 file moves to L3, and then the L1
+  // file to L2, without rewriting either.
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("0,0,1,1", FilesPerLevel(0));
+  ASSERT_EQ(edge_overlap_move, 1);
+  ASSERT_EQ(trivial_move, 2);
+  ASSERT_EQ(non_trivial_move, 0);
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(Get(Key(i)), values[i]);
+  }
+  ASSERT_EQ(Get(Key(100)), "small");
+
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_P(DBCompactionTestWithParam, LevelCompactionThirdPath) {
   Options options = CurrentOptions();
   options.db_paths.emplace_back(dbname_, 500 * 1024);
@@ -6054,6 +6218,77 @@ TEST_F(DBCompactionTest, SubcompactionEvent) {
   listener->ResetExpectedNumL0Files();
 }
 
+TEST_F(DBCompactionTest, SubcompactionRangesPerThread) {
+  class SubcompactionThreadListener : public EventListener {
+   public:
+    void OnSubcompactionBegin(const SubcompactionJobInfo& /*si*/) override {
+      InstrumentedMutexLock l(&mutex_);
+      thread_ids_.insert(std::this_thread::get_id());
+      total_subcompaction_cnt_++;
+    }
+
+    size_t GetNumThreads() {
+      InstrumentedMutexLock l(&mutex_);
+      return thread_ids_.size();
+    }
+
+    size_t GetTotalSubcompactionCount() {
+      InstrumentedMutexLock l(&mutex_);
+      return total_subcompaction_cnt_;
+    }
+
+   private:
+    InstrumentedMutex mutex_;
+    std::set<std::thread::id> thread_ids_;
+    size_t total_subcompaction_cnt_ = 0;
+  };
+
+  Options options = CurrentOptions();
+  options.target_file_size_base = 1024;
+  options.disable_auto_compactions = true;
+  options.max_subcompactions = 2;
+  options.subcompaction_ranges_per_thread = 4;
+  auto* listener = new SubcompactionThreadListener();
+  options.listeners.emplace_back(listener);
+  DestroyAndReopen(options);
+
+  uint64_t num_subcompactions = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::GenSubcompactionBoundaries:1", [&](void* arg) {
+        num_subcompactions = *static_cast<uint64_t*>(arg);
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const int kNumKeys = 400;
+  for (int i = 0; i < 4; i++) {
+    for (int j = i; j < kNumKeys; j += 4) {
+      ASSERT_OK(Put(Key(j), rnd.RandomString(1000)));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  CompactRangeOptions cro;
+  cro.max_subcompactions = 2;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // More subcompactions than threads, which run all of them
+  ASSERT_GT(num_subcompactions, 2);
+  ASSERT_EQ(listener->GetTotalSubcompactionCount(), num_subcompactions);
+  ASSERT_LE(listener->GetNumThreads(), 2);
+
+  int num_keys = 0;
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(iter->key(), Key(num_keys));
+    num_keys++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(num_keys, kNumKeys);
+}
+
 TEST_F(DBCompactionTest, CompactFilesOutputRangeConflict) {
   // LSM setup:
   // L1:      [ba bz]
@@ -6342,6 +6577,66 @@ TEST_F(DBCompactionTest, CompactionLimiter) {
   ASSERT_OK(dbfull()->TEST_WaitForCompact());
 }
 
+TEST_F(DBCompactionTest, PrioritizeCompactionsByReadAmp) {
+  const int kNumKeysPerFile = 10;
+
+  for (bool prioritize : {false, true}) {
+    Options options = CurrentOptions();
+    options.level0_file_num_compaction_trigger = 2;
+    options.prioritize_compactions_by_read_amp = prioritize;
+    DestroyAndReopen(options);
+    CreateAndReopenWithCF({"cold", "hot"}, options);
+
+    std::vector<std::string> compacted_cfs;
+    SyncPoint::GetInstance()->SetCallBack(
+        "DBImpl::BackgroundCompaction:BeforeCompaction", [&](void* arg) {
+          compacted_cfs.push_back(
+              static_cast<ColumnFamilyData*>(arg)->GetName());
+        });
+    SyncPoint::GetInstance()->EnableProcessing();
+
+    // Both column families wait for the only compaction thread
+    env_->SetBackgroundThreads(1, Env::LOW);
+    test::SleepingBackgroundTask sleeping_task_low;
+    env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask,
+                   &sleeping_task_low, Env::Priority::LOW);
+    sleeping_task_low.WaitUntilSleeping();
+
+    // "cold" is queued first, then "hot", whose L0 files are read
+    for (int cf : {1, 2}) {
+      for (int n = 0; n < options.level0_file_num_compaction_trigger; n++) {
+        for (int i = 0; i < kNumKeysPerFile; i++) {
+          ASSERT_OK(Put(cf, Key(i), "value" + std::to_string(n)));
+        }
+        if (cf == 2 && n > 0) {
+          ColumnFamilyData* cfd =
+              static_cast_with_check<ColumnFamilyHandleImpl>(handles_[cf])
+                  ->cfd();
+          cfd->current()
+              ->storage_info()
+              ->LevelFiles(0)[0]
+              ->stats.num_reads_sampled.store(1000);
+        }
+        ASSERT_OK(Flush(cf));
+      }
+    }
+
+    sleeping_task_low.WakeUp();
+    sleeping_task_low.WaitUntilDone();
+    ASSERT_OK(dbfull()->TEST_WaitForCompact());
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+
+    if (prioritize) {
+      ASSERT_EQ(std::vector<std::string>({"hot", "cold"}), compacted_cfs);
+    } else {
+      ASSERT_EQ(std::vector<std::string>({"cold", "hot"}), compacted_cfs);
+    }
+    ASSERT_EQ(0, NumTableFilesAtLevel(0, 1));
+    ASSERT_EQ(0, NumTableFilesAtLevel(0, 2));
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(DBCompactionTestWithParam, DBCompactionTestWithParam,
                         ::testing::Values(std::make_tuple(1, true),
                                           std::make_tuple(1, false),
@@ -10967,6 +11262,111 @@ TEST_F(DBCompactionTest, RecordNewestKeyTimeForTtlCompaction) {
   ASSERT_OK(dbfull()->TEST_WaitForCompact());
   ASSERT_EQ(NumTableFilesAtLevel(0), 0);
 }
+
+TEST_F(DBCompactionTest, ChargeCompactionBuffer) {
+  for (bool strict_capacity_limit : {false, true}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.compaction_readahead_size = 1 << 20;
+    options.writable_file_max_buffer_size = 1 << 20;
+    BlockBasedTableOptions table_options;
+    table_options.cache_usage_options.options_overrides.insert(
+        {CacheEntryRole::kCompactionBuffer,
+         {/*.charged = */ CacheEntryRoleOptions::Decision::kEnabled}});
+    // Too small for the charge with strict_capacity_limit
+    auto cache = std::make_shared<
+        TargetCacheChargeTrackingCache<CacheEntryRole::kCompactionBuffer>>(
+        NewLRUCache(strict_capacity_limit ? 1 << 20 : 64 << 20,
+                    0 /* num_shard_bits */, strict_capacity_limit));
+    table_options.block_cache = cache;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_OK(Put(Key(i), "v"));
+      ASSERT_OK(Flush());
+    }
+    size_t charge_during_compaction = 0;
+    SyncPoint::GetInstance()->SetCallBack(
+        "CompactionJob::Run():Inprogress", [&](void* /*arg*/) {
+          charge_during_compaction = cache->GetCacheCharge();
+        });
+    SyncPoint::GetInstance()->EnableProcessing();
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+    ASSERT_EQ("0,1", FilesPerLevel(0));
+
+    if (strict_capacity_limit) {
+      // The compaction ran regardless, charged only up to the capacity
+      ASSERT_LE(charge_during_compaction, size_t{1} << 20);
+    } else {
+      // A read-ahead buffer for each of the 4 L0 files, plus the output file
+      // buffer
+      ASSERT_EQ(charge_during_compaction, size_t{5} << 20);
+    }
+    ASSERT_EQ(cache->GetCacheCharge(), 0u);
+  }
+}
+
+TEST_F(DBCompactionTest, CompactionReadaheadBudget) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.compaction_readahead_budget = 1 << 20;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  // One large L0 file and two small ones
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(1000)));
+  }
+  ASSERT_OK(Flush());
+  for (int f = 0; f < 2; ++f) {
+    ASSERT_OK(Put(Key(f), rnd.RandomString(1000)));
+    ASSERT_OK(Flush());
+  }
+
+  std::vector<size_t> readahead_sizes;
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::GetInputFileOptions", [&](void* arg) {
+        for (const FileOptions& fo :
+             *static_cast<std::vector<FileOptions>*>(arg)) {
+          readahead_sizes.push_back(fo.compaction_readahead_size);
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ("0,1", FilesPerLevel(0));
+
+  // The budget is split between the 3 L0 files by size
+  ASSERT_EQ(readahead_sizes.size(), 3u);
+  size_t total = 0;
+  for (size_t readahead : readahead_sizes) {
+    ASSERT_GT(readahead, 0u);
+    total += readahead;
+  }
+  ASSERT_LE(total, size_t{1} << 20);
+  auto minmax =
+      std::minmax_element(readahead_sizes.begin(), readahead_sizes.end());
+  ASSERT_GT(*minmax.second, *minmax.first * 10);
+
+  // Without a budget, every input uses compaction_readahead_size
+  options.compaction_readahead_budget = 0;
+  Reopen(options);
+  ASSERT_OK(Put(Key(0), "v"));
+  ASSERT_OK(Flush());
+  readahead_sizes.clear();
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::GetInputFileOptions",
+      [&](void* /*arg*/) { readahead_sizes.push_back(0); });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_TRUE(readahead_sizes.empty());
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -228,6 +228,38 @@ TEST_F(DBFlushTest, CloseDBWhenFlushInLowPri) {
   ASSERT_EQ(1, num_flushes);
 }
 
+// Test that Close() schedules the flushes of all the column families before
+// waiting for any of them.
+TEST_F(DBFlushTest, CloseFlushesColumnFamiliesInParallel) {
+  Options options = CurrentOptions();
+  options.avoid_flush_during_shutdown = false;
+  options.max_background_flushes = 4;
+  DestroyAndReopen(options);
+  CreateColumnFamilies({"cf1", "cf2", "cf3"}, options);
+  ReopenWithColumnFamilies({"default", "cf1", "cf2", "cf3"}, options);
+
+  // No flush can start before all of them are scheduled, which would hang a
+  // shutdown flushing one column family after another.
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBImpl::FlushAllColumnFamiliesInParallel:Scheduled",
+        "DBImpl::BackgroundCallFlush:Start:1"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int cf = 0; cf < 4; ++cf) {
+    ASSERT_OK(Put(cf, "key", "value" + std::to_string(cf)));
+  }
+  Close();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  options.avoid_flush_during_recovery = true;
+  ReopenWithColumnFamilies({"default", "cf1", "cf2", "cf3"}, options);
+  for (int cf = 0; cf < 4; ++cf) {
+    ASSERT_EQ(1, NumTableFilesAtLevel(0, cf));
+    ASSERT_EQ("value" + std::to_string(cf), Get(cf, "key"));
+  }
+}
+
 TEST_F(DBFlushTest, ManualFlushWithMinWriteBufferNumberToMerge) {
   Options options = CurrentOptions();
   options.write_buffer_size = 100;
@@ -263,6 +295,113 @@ TEST_F(DBFlushTest, ManualFlushWithMinWriteBufferNumberToMerge) {
   t.join();
 }
 
+TEST_F(DBFlushTest, PartitionedFlush) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 4 << 20;
+  options.max_write_buffer_number = 4;
+  options.disable_auto_compactions = true;
+  options.target_file_size_base = 64 << 10;
+  options.max_flush_partitions = 4;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+
+  // Two versions of each key in two memtables, with a snapshot of the first
+  const int kNumKeys = 2000;
+  Random rnd(301);
+  std::vector<std::string> old_values;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    old_values.push_back(rnd.RandomString(200));
+    ASSERT_OK(Put(Key(i), old_values.back()));
+  }
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  for (int i = 0; i < kNumKeys; i++) {
+    values.push_back(rnd.RandomString(200));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+
+  // One flush of both memtables into non-overlapping L0 files
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1u);
+  ASSERT_LE(files.size(), 4u);
+  std::sort(files.begin(), files.end(),
+            [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+              return a.smallestkey < b.smallestkey;
+            });
+  uint64_t total_size = 0;
+  for (size_t i = 0; i < files.size(); i++) {
+    ASSERT_EQ(0, files[i].level);
+    ASSERT_EQ(files[0].epoch_number, files[i].epoch_number);
+    if (i > 0) {
+      ASSERT_LT(files[i - 1].largestkey, files[i].smallestkey);
+    }
+    total_size += files[i].size;
+  }
+  ASSERT_GE(options.statistics->getTickerCount(FLUSH_WRITE_BYTES), total_size);
+
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+      if (round == 0) {
+        ASSERT_EQ(old_values[i], Get(Key(i), snapshot));
+      }
+    }
+    if (round == 0) {
+      db_->ReleaseSnapshot(snapshot);
+      Reopen(options);
+    }
+  }
+}
+
+TEST_F(DBFlushTest, FlushBelowLevel0) {
+  Options options = CurrentOptions();
+  options.num_levels = 4;
+  options.level_compaction_dynamic_level_bytes = false;
+  options.disable_auto_compactions = true;
+  options.allow_flush_below_level0 = true;
+  Reopen(options);
+
+  std::map<int, std::string> expected;
+  auto flush_range = [&](int begin, int end, const std::string& value) {
+    for (int i = begin; i < end; i++) {
+      ASSERT_OK(Put(Key(i), value));
+      expected[i] = value;
+    }
+    ASSERT_OK(Flush());
+  };
+
+  // Each flush goes to the level above the first one it overlaps
+  flush_range(100, 200, "a");
+  ASSERT_EQ("0,0,0,1", FilesPerLevel());
+  flush_range(0, 50, "b");
+  ASSERT_EQ("0,0,0,2", FilesPerLevel());
+  flush_range(150, 160, "c");
+  ASSERT_EQ("0,0,1,2", FilesPerLevel());
+  flush_range(0, 300, "d");
+  ASSERT_EQ("0,1,1,2", FilesPerLevel());
+  flush_range(120, 130, "e");
+  ASSERT_EQ("1,1,1,2", FilesPerLevel());
+
+  // Back to L0 only
+  ASSERT_OK(dbfull()->SetOptions({{"allow_flush_below_level0", "false"}}));
+  flush_range(400, 410, "f");
+  ASSERT_EQ("2,1,1,2", FilesPerLevel());
+
+  for (int round = 0; round < 2; round++) {
+    for (const auto& kv : expected) {
+      ASSERT_EQ(kv.second, Get(Key(kv.first)));
+    }
+    Reopen(options);
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (const auto& kv : expected) {
+    ASSERT_EQ(kv.second, Get(Key(kv.first)));
+  }
+}
+
 TEST_F(DBFlushTest, ScheduleOnlyOneBgThread) {
   Options options = CurrentOptions();
   Reopen(options);
@@ -180,14 +180,14 @@ class DBFollowerTest : public DBTestBase {
     uint64_t max_keys_;
   };
 
-  Status OpenAsFollower() {
+  Status OpenAsFollower(uint64_t refresh_catchup_period_ms = 100) {
     Options opts = CurrentOptions();
     if (!follower_env_) {
       follower_env_ = NewCompositeEnv(
           std::make_shared<DBFollowerTestFS>(env_->GetFileSystem()));
     }
     opts.env = follower_env_.get();
-    opts.follower_refresh_catchup_period_ms = 100;
+    opts.follower_refresh_catchup_period_ms = refresh_catchup_period_ms;
     return DB::OpenAsFollower(opts, follower_name_, dbname_, &follower_);
   }
 
@@ -276,6 +276,18 @@ TEST_F(DBFollowerTest, Flush) {
   SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBFollowerTest, TryCatchUpWithPrimary) {
+  // No periodic catch up during the test
+  ASSERT_OK(OpenAsFollower(3600 * 1000));
+  ASSERT_OK(Put("k1", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(FollowerGet("k1"), "NOT_FOUND");
+
+  ASSERT_OK(follower()->TryCatchUpWithPrimary());
+  ASSERT_EQ(FollowerGet("k1"), "v1");
+  CheckDirs();
+}
+
 // This test creates 4 L0 files, immediately followed by a compaction to L1.
 // The follower replays the 4 flush records from the MANIFEST unsuccessfully,
 // and then successfully recovers a Version from the compaction record
@@ -13,6 +13,7 @@
 #include <alloca.h>
 #endif
 
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
 #include <map>
@@ -22,6 +23,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -50,10 +52,12 @@
 #include "db/merge_context.h"
 #include "db/periodic_task_scheduler.h"
 #include "db/range_tombstone_fragmenter.h"
+#include "db/read_hotness.h"
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
 #include "db/transaction_log_impl.h"
 #include "db/version_set.h"
+#include "db/wide/wide_columns_helper.h"
 #include "db/write_batch_internal.h"
 #include "db/write_callback.h"
 #include "env/unique_id_gen.h"
@@ -67,7 +71,9 @@
 #include "monitoring/in_memory_stats_history.h"
 #include "monitoring/instrumented_mutex.h"
 #include "monitoring/iostats_context_imp.h"
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_context_sampler.h"
 #include "monitoring/persistent_stats_history.h"
 #include "monitoring/thread_status_updater.h"
 #include "monitoring/thread_status_util.h"
@@ -93,6 +99,7 @@
 #include "rocksdb/write_buffer_manager.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_factory.h"
+#include "table/block_based/block_based_table_reader.h"
 #include "table/get_context.h"
 #include "table/merging_iterator.h"
 #include "table/multiget_context.h"
@@ -114,6 +121,7 @@
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/udt_util.h"
+#include "utilities/cache_dump_load_impl.h"
 #include "utilities/trace/replayer_impl.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -235,7 +243,9 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
     
      
    
-      atomic_flush_install_cv_(&mutex_)
+      atomic_flush_install_cv_(&mutex_),
+      warmup_scheduler_(immutable_db_options_, file_options_, &mutex_,
+                        &shutting_down_)
 
  {
 
@@ -251,14 +261,27 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   const int table_cache_size = (mutable_db_options_.max_open_files == -1)
                                    ? TableCache::kInfiniteCapacity
                                    : mutable_db_options_.max_open_files - 10;
-  LRUCacheOptions co;
-  co.capacity = table_cache_size;
-  co.num_shard_bits = immutable_db_options_.table_cache_numshardbits;
-  co.metadata_charge_policy = kDontChargeCacheMetadata;
-  // TODO: Consider a non-fixed seed once test fallout (prefetch_test) is
-  // dealt with
-  co.hash_seed = 0;
-  table_cache_ = NewLRUCache(co);
+  if (immutable_db_options_.table_cache_use_hyper_clock_cache) {
+    // Every reader is charged 1, so the table grows with the number of open
+    // files, up to the capacity
+    HyperClockCacheOptions co(table_cache_size, /*estimated_entry_charge=*/0,
+                              immutable_db_options_.table_cache_numshardbits,
+                              /*strict_capacity_limit=*/false,
+                              /*memory_allocator=*/nullptr,
+                              kDontChargeCacheMetadata);
+    co.min_avg_entry_charge = 1;
+    co.hash_seed = 0;
+    table_cache_ = co.MakeSharedCache();
+  } else {
+    LRUCacheOptions co;
+    co.capacity = table_cache_size;
+    co.num_shard_bits = immutable_db_options_.table_cache_numshardbits;
+    co.metadata_charge_policy = kDontChargeCacheMetadata;
+    // TODO: Consider a non-fixed seed once test fallout (prefetch_test) is
+    // dealt with
+    co.hash_seed = 0;
+    table_cache_ = NewLRUCache(co);
+  }
   SetDbSessionId();
   assert(!db_session_id_.empty());
 
@@ -271,6 +294,10 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   periodic_task_functions_.emplace(
       PeriodicTaskType::kRecordSeqnoTime,
       [this]() { this->RecordSeqnoToTimeMapping(); });
+  periodic_task_functions_.emplace(PeriodicTaskType::kAutoTune,
+                                   [this]() { this->AutoTune(); });
+  periodic_task_functions_.emplace(PeriodicTaskType::kPersistReadHotness,
+                                   [this]() { this->PersistReadHotness(); });
 
   versions_.reset(new VersionSet(
       dbname_, &immutable_db_options_, file_options_, table_cache_.get(),
@@ -288,8 +315,11 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
 
   max_total_wal_size_.store(mutable_db_options_.max_total_wal_size,
                             std::memory_order_relaxed);
+  write_controller_.set_adaptive(
+      immutable_db_options_.adaptive_delayed_write_rate);
   if (write_buffer_manager_) {
     wbm_stall_.reset(new WBMStallInterface());
+    write_buffer_manager_->AddFlushCandidate(this);
   }
 }
 
@@ -487,7 +517,13 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
   if (!shutting_down_.load(std::memory_order_acquire) &&
       has_unpersisted_data_.load(std::memory_order_relaxed) &&
       !mutable_db_options_.avoid_flush_during_shutdown) {
+    const uint64_t flush_start = immutable_db_options_.clock->NowMicros();
     s = DBImpl::FlushAllColumnFamilies(FlushOptions(), FlushReason::kShutDown);
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Shutdown: flushed all column families in %" PRIu64
+                   " us: %s",
+                   immutable_db_options_.clock->NowMicros() - flush_start,
+                   s.ToString().c_str());
     s.PermitUncheckedError();  //**TODO: What to do on error?
   }
 
@@ -522,6 +558,563 @@ void DBImpl::UntrackDataFiles() {
                       /*track=*/false);
 }
 
+void DBImpl::RefCurrentVersions(
+    std::vector<std::pair<ColumnFamilyData*, Version*>>* versions) {
+  mutex_.AssertHeld();
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    cfd->Ref();
+    Version* const version = cfd->current();
+    version->Ref();
+    versions->emplace_back(cfd, version);
+  }
+}
+
+void DBImpl::UnrefVersions(
+    std::vector<std::pair<ColumnFamilyData*, Version*>>* versions) {
+  mutex_.AssertHeld();
+  for (auto& cfd_and_version : *versions) {
+    cfd_and_version.second->Unref();
+    cfd_and_version.first->UnrefAndTryDelete();
+  }
+  versions->clear();
+}
+
+void DBImpl::MaybeScheduleBlockCacheRestore() {
+  mutex_.AssertHeld();
+  if (immutable_db_options_.block_cache_dump_file.empty()) {
+    return;
+  }
+  dump_block_cache_on_close_ = true;
+  bg_block_cache_restore_scheduled_++;
+  env_->Schedule(&DBImpl::BGWorkBlockCacheRestore, this, Env::Priority::USER,
+                 nullptr);
+}
+
+void DBImpl::BGWorkBlockCacheRestore(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::USER);
+  static_cast<DBImpl*>(db)->BackgroundCallBlockCacheRestore();
+}
+
+void DBImpl::BackgroundCallBlockCacheRestore() {
+  TEST_SYNC_POINT("DBImpl::BackgroundCallBlockCacheRestore:Start");
+  uint64_t num_restored = 0;
+  uint64_t num_skipped = 0;
+  Status s = RestoreBlockCache(&num_restored, &num_skipped);
+  if (s.ok() || s.IsIncomplete()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Restored %" PRIu64 " blocks from the block cache dump %s%s"
+                   ", skipped %" PRIu64 " blocks of deleted files",
+                   num_restored,
+                   immutable_db_options_.block_cache_dump_file.c_str(),
+                   s.ok() ? "" : " until the block cache was full",
+                   num_skipped);
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Unable to restore the block cache dump %s: %s",
+                   immutable_db_options_.block_cache_dump_file.c_str(),
+                   s.ToString().c_str());
+  }
+  TEST_SYNC_POINT("DBImpl::BackgroundCallBlockCacheRestore:Done");
+
+  InstrumentedMutexLock l(&mutex_);
+  bg_block_cache_restore_scheduled_--;
+  bg_cv_.SignalAll();
+}
+
+void DBImpl::MaybeScheduleRestartWarmup() {
+  mutex_.AssertHeld();
+  if (immutable_db_options_.read_hotness_file.empty()) {
+    return;
+  }
+  persist_read_hotness_ = true;
+  bg_restart_warmup_scheduled_++;
+  env_->Schedule(&DBImpl::BGWorkRestartWarmup, this, Env::Priority::USER,
+                 nullptr);
+}
+
+void DBImpl::BGWorkRestartWarmup(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::USER);
+  static_cast<DBImpl*>(db)->BackgroundCallRestartWarmup();
+}
+
+void DBImpl::BackgroundCallRestartWarmup() {
+  TEST_SYNC_POINT("DBImpl::BackgroundCallRestartWarmup:Start");
+  uint64_t num_files = 0;
+  uint64_t bytes_read = 0;
+  Status s = RestartWarmup(&num_files, &bytes_read);
+  if (s.ok() || s.IsShutdownInProgress()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Warmed %" PRIu64 " files (%" PRIu64
+                   " bytes read) from the read hotness of %s%s",
+                   num_files, bytes_read,
+                   immutable_db_options_.read_hotness_file.c_str(),
+                   s.ok() ? "" : " until shutdown");
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Unable to warm up from the read hotness of %s: %s",
+                   immutable_db_options_.read_hotness_file.c_str(),
+                   s.ToString().c_str());
+  }
+  TEST_SYNC_POINT("DBImpl::BackgroundCallRestartWarmup:Done");
+
+  InstrumentedMutexLock l(&mutex_);
+  bg_restart_warmup_scheduled_--;
+  bg_cv_.SignalAll();
+}
+
+void DBImpl::MaybeScheduleOpenTableFiles() {
+  mutex_.AssertHeld();
+  if (!immutable_db_options_.open_table_files_in_background ||
+      mutable_db_options_.max_open_files != -1) {
+    return;
+  }
+  bg_open_table_files_scheduled_++;
+  env_->Schedule(&DBImpl::BGWorkOpenTableFiles, this, Env::Priority::USER,
+                 nullptr);
+}
+
+void DBImpl::BGWorkOpenTableFiles(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::USER);
+  static_cast<DBImpl*>(db)->BackgroundCallOpenTableFiles();
+}
+
+void DBImpl::BackgroundCallOpenTableFiles() {
+  TEST_SYNC_POINT("DBImpl::BackgroundCallOpenTableFiles:Start");
+  uint64_t num_opened = 0;
+  Status s = OpenTableFiles(&num_opened);
+  if (s.ok() || s.IsShutdownInProgress()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Opened %" PRIu64 " table files in the background%s",
+                   num_opened, s.ok() ? "" : " until shutdown");
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Unable to open the table files in the background: %s",
+                   s.ToString().c_str());
+  }
+  TEST_SYNC_POINT("DBImpl::BackgroundCallOpenTableFiles:Done");
+
+  InstrumentedMutexLock l(&mutex_);
+  bg_open_table_files_scheduled_--;
+  bg_cv_.SignalAll();
+}
+
+Status DBImpl::OpenTableFiles(uint64_t* num_opened) {
+  std::vector<std::pair<ColumnFamilyData*, Version*>> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    RefCurrentVersions(&versions);
+  }
+
+  // <version index, file metadata, level>, the lower levels first since
+  // their files are read by more of the lookups
+  std::vector<std::tuple<size_t, FileMetaData*, int>> files;
+  for (size_t i = 0; i < versions.size(); i++) {
+    const VersionStorageInfo* const vstorage =
+        versions[i].second->storage_info();
+    for (int level = 0; level < vstorage->num_non_empty_levels(); level++) {
+      for (FileMetaData* f : vstorage->LevelFiles(level)) {
+        if (f->fd.table_reader == nullptr) {
+          files.emplace_back(i, f, level);
+        }
+      }
+    }
+  }
+  std::stable_sort(files.begin(), files.end(),
+                   [](const auto& a, const auto& b) {
+                     return std::get<2>(a) < std::get<2>(b);
+                   });
+
+  ReadOptions read_options;
+  read_options.rate_limiter_priority = Env::IO_LOW;
+  std::atomic<size_t> next_file{0};
+  std::atomic<uint64_t> opened{0};
+  std::mutex status_mutex;
+  Status s;
+  std::function<void()> open_files([&]() {
+    while (!shutting_down_.load(std::memory_order_acquire)) {
+      const size_t idx = next_file.fetch_add(1);
+      if (idx >= files.size()) {
+        return;
+      }
+      ColumnFamilyData* const cfd = versions[std::get<0>(files[idx])].first;
+      Version* const version = versions[std::get<0>(files[idx])].second;
+      FileMetaData* const f = std::get<1>(files[idx]);
+      const int level = std::get<2>(files[idx]);
+      TableCache::TypedHandle* handle = nullptr;
+      Status open_s = cfd->table_cache()->FindTable(
+          read_options, file_options_, cfd->internal_comparator(), *f, &handle,
+          version->GetMutableCFOptions(), /*no_io=*/false,
+          cfd->internal_stats()->GetFileReadHist(level),
+          /*skip_filters=*/false, level,
+          /*prefetch_index_and_filter_in_cache=*/false,
+          /*max_file_size_for_l0_meta_pin=*/0, f->temperature);
+      if (open_s.ok()) {
+        // The reader stays in the table cache, which is not bounded with a
+        // max_open_files of -1
+        cfd->table_cache()->get_cache().Release(handle);
+        opened.fetch_add(1);
+      } else {
+        std::lock_guard<std::mutex> l(status_mutex);
+        if (s.ok()) {
+          s = open_s;
+        }
+      }
+    }
+  });
+  std::vector<port::Thread> threads;
+  for (int i = 1; i < immutable_db_options_.max_file_opening_threads; i++) {
+    threads.emplace_back(open_files);
+  }
+  open_files();
+  for (auto& t : threads) {
+    t.join();
+  }
+  *num_opened = opened.load();
+  if (s.ok() && next_file.load() < files.size()) {
+    s = Status::ShutdownInProgress();
+  }
+
+  InstrumentedMutexLock l(&mutex_);
+  UnrefVersions(&versions);
+  return s;
+}
+
+Status DBImpl::RestoreBlockCache(uint64_t* num_restored,
+                                 uint64_t* num_skipped) {
+  const std::string& dump_file = immutable_db_options_.block_cache_dump_file;
+  if (fs_->FileExists(dump_file, IOOptions(), nullptr).IsNotFound()) {
+    // Nothing was dumped yet
+    return Status::OK();
+  }
+
+  std::vector<std::pair<ColumnFamilyData*, Version*>> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    RefCurrentVersions(&versions);
+  }
+
+  // The live table files, by the common prefix of the stable cache keys of
+  // their blocks. The dumped blocks of other files are skipped, the files
+  // being gone.
+  std::unordered_map<std::string, TableReader*> tables;
+  std::vector<std::pair<TableCache*, TableCache::TypedHandle*>> handles;
+  ReadOptions read_options;
+  read_options.rate_limiter_priority = Env::IO_LOW;
+  Status s;
+  for (auto& cfd_and_version : versions) {
+    ColumnFamilyData* const cfd = cfd_and_version.first;
+    Version* const version = cfd_and_version.second;
+    const VersionStorageInfo* const vstorage = version->storage_info();
+    for (int level = 0; s.ok() && level < vstorage->num_non_empty_levels();
+         level++) {
+      for (FileMetaData* f : vstorage->LevelFiles(level)) {
+        TableReader* table = f->fd.table_reader;
+        if (table == nullptr) {
+          TableCache::TypedHandle* handle = nullptr;
+          s = cfd->table_cache()->FindTable(
+              read_options, file_options_, cfd->internal_comparator(), *f,
+              &handle, version->GetMutableCFOptions(), /*no_io=*/false,
+              cfd->internal_stats()->GetFileReadHist(level),
+              /*skip_filters=*/false, level,
+              /*prefetch_index_and_filter_in_cache=*/false);
+          if (!s.ok()) {
+            break;
+          }
+          handles.emplace_back(cfd->table_cache(), handle);
+          table = cfd->table_cache()->get_cache().Value(handle);
+        }
+        OffsetableCacheKey base;
+        bool is_stable;
+        BlockBasedTable::SetupBaseCacheKey(table->GetTableProperties().get(),
+                                           /*cur_db_session_id=*/"",
+                                           /*cur_file_num=*/0, &base,
+                                           &is_stable);
+        if (is_stable) {
+          tables[base.CommonPrefixSlice().ToString()] = table;
+        }
+      }
+    }
+    if (!s.ok()) {
+      break;
+    }
+  }
+
+  if (s.ok()) {
+    std::unique_ptr<CacheDumpReader> reader;
+    s = NewFromFileCacheDumpReader(immutable_db_options_.fs,
+                                   file_options_, dump_file, &reader);
+    if (s.ok()) {
+      CacheDumpOptions dump_options;
+      dump_options.clock = immutable_db_options_.clock;
+      CacheDumpedLoaderImpl loader(dump_options, BlockBasedTableOptions(),
+                                   /*secondary_cache=*/nullptr,
+                                   std::move(reader));
+      s = loader.RestoreCacheEntries(
+          [&](const Slice& key, CacheEntryRole role, const Slice& saved) {
+            if (shutting_down_.load(std::memory_order_acquire)) {
+              return Status::ShutdownInProgress();
+            }
+            auto it = tables.end();
+            if (key.size() >= OffsetableCacheKey::kCommonPrefixSize) {
+              it = tables.find(
+                  Slice(key.data(), OffsetableCacheKey::kCommonPrefixSize)
+                      .ToString());
+            }
+            if (it == tables.end()) {
+              (*num_skipped)++;
+              return Status::OK();
+            }
+            Status rs = it->second->RestoreCacheEntry(key, role, saved);
+            if (rs.ok()) {
+              (*num_restored)++;
+            } else if (rs.IsNotSupported()) {
+              (*num_skipped)++;
+              rs = Status::OK();
+            }
+            return rs;
+          });
+    }
+  }
+
+  for (auto& table_cache_and_handle : handles) {
+    table_cache_and_handle.first->get_cache().Release(
+        table_cache_and_handle.second);
+  }
+  InstrumentedMutexLock l(&mutex_);
+  UnrefVersions(&versions);
+  return s;
+}
+
+Status DBImpl::DumpBlockCache() {
+  std::vector<std::pair<ColumnFamilyData*, Version*>> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    RefCurrentVersions(&versions);
+  }
+  // Column families commonly share their block cache
+  std::vector<std::shared_ptr<Cache>> caches;
+  TablePropertiesCollection props;
+  Status s;
+  for (auto& cfd_and_version : versions) {
+    Version* const version = cfd_and_version.second;
+    const auto* const table_options =
+        version->GetMutableCFOptions()
+            .table_factory->GetOptions<BlockBasedTableOptions>();
+    if (table_options == nullptr || table_options->block_cache == nullptr) {
+      continue;
+    }
+    if (std::find(caches.begin(), caches.end(), table_options->block_cache) ==
+        caches.end()) {
+      caches.push_back(table_options->block_cache);
+    }
+    s = version->GetPropertiesOfAllTables(ReadOptions(), &props);
+    if (!s.ok()) {
+      break;
+    }
+  }
+  {
+    InstrumentedMutexLock l(&mutex_);
+    UnrefVersions(&versions);
+  }
+  if (!s.ok() || caches.empty()) {
+    return s;
+  }
+
+  std::unique_ptr<CacheDumpWriter> writer;
+  s = NewToFileCacheDumpWriter(immutable_db_options_.fs, file_options_,
+                               immutable_db_options_.block_cache_dump_file,
+                               &writer);
+  if (!s.ok()) {
+    return s;
+  }
+  CacheDumpOptions dump_options;
+  dump_options.clock = immutable_db_options_.clock;
+  CacheDumperImpl dumper(dump_options, std::move(caches), std::move(writer));
+  dumper.AddToDumpFilter(props);
+  return dumper.DumpCacheEntriesToWriter();
+}
+
+Status DBImpl::RestartWarmup(uint64_t* num_files, uint64_t* bytes_read) {
+  std::string data;
+  Status s = ReadFileToString(fs_.get(),
+                              immutable_db_options_.read_hotness_file, &data);
+  if (s.IsNotFound()) {
+    // Nothing was saved yet
+    return Status::OK();
+  }
+  std::vector<FileReadHotness> saved;
+  if (s.ok()) {
+    s = DecodeReadHotness(data, &saved);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::vector<std::pair<ColumnFamilyData*, Version*>> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    RefCurrentVersions(&versions);
+  }
+
+  // <version index, file metadata, saved hotness> of the live files, the
+  // files that are gone having nothing left to warm
+  std::vector<std::tuple<size_t, const FileMetaData*, FileReadHotness*>>
+      targets;
+  std::unordered_map<uint64_t, std::pair<size_t, const FileMetaData*>> files;
+  for (size_t i = 0; i < versions.size(); i++) {
+    const VersionStorageInfo* const vstorage =
+        versions[i].second->storage_info();
+    for (int level = 0; level < vstorage->num_non_empty_levels(); level++) {
+      for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+        files.emplace(f->fd.GetNumber(), std::make_pair(i, f));
+      }
+    }
+  }
+  for (FileReadHotness& hotness : saved) {
+    auto it = files.find(hotness.file_number);
+    if (it == files.end() ||
+        versions[it->second.first].first->GetName() != hotness.column_family) {
+      continue;
+    }
+    // The sampled reads drive read-triggered compactions, which would
+    // otherwise start over from nothing after every restart.
+    it->second.second->stats.num_reads_sampled.fetch_add(
+        hotness.num_reads_sampled, std::memory_order_relaxed);
+    targets.emplace_back(it->second.first, it->second.second, &hotness);
+  }
+  std::stable_sort(targets.begin(), targets.end(),
+                   [](const auto& a, const auto& b) {
+                     return std::get<2>(a)->num_reads_sampled >
+                            std::get<2>(b)->num_reads_sampled;
+                   });
+
+  const uint64_t max_bytes = immutable_db_options_.restart_warmup_max_bytes;
+  for (auto& [idx, f, hotness] : targets) {
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      s = Status::ShutdownInProgress();
+      break;
+    }
+    if (max_bytes > 0 && *bytes_read >= max_bytes) {
+      break;
+    }
+    WarmupJob job;
+    job.cfd = versions[idx].first;
+    job.version = versions[idx].second;
+    job.job_id = next_job_id_.fetch_add(1);
+    job.smallest = f->smallest;
+    job.largest = f->largest;
+    job.target_files.push_back(f->fd.GetNumber());
+    // Files without known hot ranges are warmed whole
+    job.hot_ranges = std::move(hotness->hot_ranges);
+    job.max_bytes = max_bytes > 0 ? max_bytes - *bytes_read : 0;
+    job.stop_at_cache_capacity = true;
+    job.index_and_filter_partitions = true;
+    uint64_t job_bytes_read = 0;
+    job.progress_callback = [&job_bytes_read](const WarmupProgress& progress) {
+      job_bytes_read = progress.bytes_read;
+    };
+    s = warmup_scheduler_.Run(job);
+    *bytes_read += job_bytes_read;
+    if (!s.ok()) {
+      break;
+    }
+    (*num_files)++;
+  }
+
+  InstrumentedMutexLock l(&mutex_);
+  UnrefVersions(&versions);
+  return s;
+}
+
+Status DBImpl::WriteReadHotness() {
+  const std::string& fname = immutable_db_options_.read_hotness_file;
+  // The hot ranges of the files not read since the DB was opened are only
+  // known from the previous save.
+  std::unordered_map<uint64_t, std::vector<TableReader::HotKeyRange>>
+      saved_ranges;
+  {
+    std::string data;
+    std::vector<FileReadHotness> saved;
+    if (ReadFileToString(fs_.get(), fname, &data).ok() &&
+        DecodeReadHotness(data, &saved).ok()) {
+      for (FileReadHotness& hotness : saved) {
+        saved_ranges.emplace(hotness.file_number,
+                             std::move(hotness.hot_ranges));
+      }
+    }
+  }
+
+  std::vector<std::pair<ColumnFamilyData*, Version*>> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    RefCurrentVersions(&versions);
+  }
+  ReadOptions read_options;
+  read_options.rate_limiter_priority = Env::IO_LOW;
+  std::vector<FileReadHotness> files;
+  for (auto& cfd_and_version : versions) {
+    ColumnFamilyData* const cfd = cfd_and_version.first;
+    Version* const version = cfd_and_version.second;
+    const VersionStorageInfo* const vstorage = version->storage_info();
+    for (int level = 0; level < vstorage->num_non_empty_levels(); level++) {
+      for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+        FileReadHotness hotness;
+        hotness.column_family = cfd->GetName();
+        hotness.file_number = f->fd.GetNumber();
+        hotness.num_reads_sampled =
+            f->stats.num_reads_sampled.load(std::memory_order_relaxed);
+        // NotSupported unless the table tracks its data block hits
+        cfd->table_cache()
+            ->GetHotKeyRanges(read_options, cfd->internal_comparator(), *f,
+                              version->GetMutableCFOptions(),
+                              &hotness.hot_ranges)
+            .PermitUncheckedError();
+        if (hotness.hot_ranges.empty()) {
+          auto it = saved_ranges.find(hotness.file_number);
+          if (it != saved_ranges.end()) {
+            hotness.hot_ranges = std::move(it->second);
+          }
+        }
+        if (hotness.num_reads_sampled > 0 || !hotness.hot_ranges.empty()) {
+          files.push_back(std::move(hotness));
+        }
+      }
+    }
+  }
+  {
+    InstrumentedMutexLock l(&mutex_);
+    UnrefVersions(&versions);
+  }
+
+  std::string data;
+  EncodeReadHotness(files, &data);
+  // Replaced atomically so that a crash never leaves a partial file behind
+  const std::string tmp_fname = fname + ".tmp";
+  IOStatus io_s = WriteStringToFile(fs_.get(), data, tmp_fname,
+                                    /*should_sync=*/true);
+  if (io_s.ok()) {
+    io_s = fs_->RenameFile(tmp_fname, fname, IOOptions(), nullptr);
+  }
+  return io_s;
+}
+
+void DBImpl::PersistReadHotness() {
+  if (shutdown_initiated_) {
+    return;
+  }
+  TEST_SYNC_POINT("DBImpl::PersistReadHotness:StartRunning");
+  Status s = WriteReadHotness();
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Unable to save the read hotness to %s: %s",
+                   immutable_db_options_.read_hotness_file.c_str(),
+                   s.ToString().c_str());
+  }
+}
+
 Status DBImpl::CloseHelper() {
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
@@ -557,14 +1150,58 @@ Status DBImpl::CloseHelper() {
 
   Status ret = Status::OK();
 
+  SystemClock* const clock = immutable_db_options_.clock;
+  uint64_t phase_start = clock->NowMicros();
   // Wait for background work to finish
   while (bg_bottom_compaction_scheduled_ || bg_compaction_scheduled_ ||
          bg_flush_scheduled_ || bg_purge_scheduled_ ||
-         pending_purge_obsolete_files_ ||
+         bg_block_cache_restore_scheduled_ || bg_restart_warmup_scheduled_ ||
+         bg_open_table_files_scheduled_ || pending_purge_obsolete_files_ ||
          error_handler_.IsRecoveryInProgress()) {
     TEST_SYNC_POINT("DBImpl::~DBImpl:WaitJob");
     bg_cv_.Wait();
   }
+  const uint64_t bg_wait_micros = clock->NowMicros() - phase_start;
+  phase_start = clock->NowMicros();
+  // No compaction can schedule a warmup job anymore. Warmup jobs hold
+  // references to Versions, so they must be gone before versions_ is reset.
+  // Running jobs stop at their next block once shutting_down_ is set.
+  warmup_scheduler_.Shutdown();
+  const uint64_t warmup_wait_micros = clock->NowMicros() - phase_start;
+  phase_start = clock->NowMicros();
+  if (dump_block_cache_on_close_) {
+    mutex_.Unlock();
+    Status s = DumpBlockCache();
+    if (s.ok()) {
+      ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                     "Dumped the block cache to %s",
+                     immutable_db_options_.block_cache_dump_file.c_str());
+    } else {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Unable to dump the block cache to %s: %s",
+                     immutable_db_options_.block_cache_dump_file.c_str(),
+                     s.ToString().c_str());
+    }
+    mutex_.Lock();
+  }
+  if (persist_read_hotness_) {
+    mutex_.Unlock();
+    Status s = WriteReadHotness();
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Unable to save the read hotness to %s: %s",
+                     immutable_db_options_.read_hotness_file.c_str(),
+                     s.ToString().c_str());
+    }
+    mutex_.Lock();
+  }
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Shutdown: waited %" PRIu64
+                 " us for background jobs, %" PRIu64
+                 " us for warmup jobs, spent %" PRIu64
+                 " us saving the cache state",
+                 bg_wait_micros, warmup_wait_micros,
+                 clock->NowMicros() - phase_start);
   TEST_SYNC_POINT_CALLBACK("DBImpl::CloseHelper:PendingPurgeFinished",
                            &files_grabbed_for_purge_);
   EraseThreadStatusDbInfo();
@@ -715,6 +1352,9 @@ Status DBImpl::CloseHelper() {
   if (write_buffer_manager_ && wbm_stall_) {
     write_buffer_manager_->RemoveDBFromQueue(wbm_stall_.get());
   }
+  if (write_buffer_manager_) {
+    write_buffer_manager_->RemoveFlushCandidate(this);
+  }
 
   IOStatus io_s = directories_.Close(IOOptions(), nullptr /* dbg */);
   if (!io_s.ok()) {
@@ -819,6 +1459,26 @@ Status DBImpl::StartPeriodicTaskScheduler() {
       return s;
     }
   }
+  if (mutable_db_options_.auto_tune_period_sec > 0) {
+    Status s = periodic_task_scheduler_.Register(
+        PeriodicTaskType::kAutoTune,
+        periodic_task_functions_.at(PeriodicTaskType::kAutoTune),
+        mutable_db_options_.auto_tune_period_sec);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  if (persist_read_hotness_ &&
+      immutable_db_options_.read_hotness_persist_period_sec > 0) {
+    Status s = periodic_task_scheduler_.Register(
+        PeriodicTaskType::kPersistReadHotness,
+        periodic_task_functions_.at(PeriodicTaskType::kPersistReadHotness),
+        immutable_db_options_.read_hotness_persist_period_sec);
+    if (!s.ok()) {
+      return s;
+    }
+  }
 
   Status s = periodic_task_scheduler_.Register(
       PeriodicTaskType::kFlushInfoLog,
@@ -1146,6 +1806,109 @@ void DBImpl::FlushInfoLog() {
   LogFlush(immutable_db_options_.info_log);
 }
 
+// Allows one more background job while the compactions fall behind the
+// writes, up to twice max_background_jobs, and takes one back after a few
+// runs without write stalls.
+void DBImpl::AutoTune() {
+  if (shutdown_initiated_) {
+    return;
+  }
+  TEST_SYNC_POINT("DBImpl::AutoTune:StartRunning");
+  constexpr int kQuietRunsBeforeDecrease = 3;
+  const uint64_t now_micros = immutable_db_options_.clock->NowMicros();
+  const uint64_t stall_micros = default_cf_internal_stats_->GetDBStats(
+      InternalStats::kIntStatsWriteStallMicros);
+
+  InstrumentedMutexLock l(&mutex_);
+  // Slowdowns and stops that more compaction could have avoided
+  uint64_t stall_count = 0;
+  std::string over_soft_limit_cf;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (!cfd->initialized() || cfd->IsDropped()) {
+      continue;
+    }
+    const InternalStats* stats = cfd->internal_stats();
+    for (auto type : {InternalStats::L0_FILE_COUNT_LIMIT_DELAYS,
+                      InternalStats::L0_FILE_COUNT_LIMIT_STOPS,
+                      InternalStats::PENDING_COMPACTION_BYTES_LIMIT_DELAYS,
+                      InternalStats::PENDING_COMPACTION_BYTES_LIMIT_STOPS}) {
+      stall_count += stats->GetCFStatsCount(type);
+    }
+    const uint64_t soft_limit =
+        cfd->GetCurrentMutableCFOptions().soft_pending_compaction_bytes_limit;
+    if (soft_limit > 0 &&
+        cfd->current()->storage_info()->estimated_compaction_needed_bytes() >
+            soft_limit / 2) {
+      over_soft_limit_cf = cfd->GetName();
+    }
+  }
+
+  AutoTuneState& state = auto_tune_state_;
+  const uint64_t elapsed_micros = now_micros - state.last_run_micros;
+  const uint64_t new_stall_micros = stall_micros - state.last_stall_micros;
+  const uint64_t new_stall_count = stall_count - state.last_stall_count;
+  const bool first_run = state.last_run_micros == 0;
+  state.last_run_micros = now_micros;
+  state.last_stall_micros = stall_micros;
+  state.last_stall_count = stall_count;
+  if (first_run || mutable_db_options_.max_background_flushes != -1 ||
+      mutable_db_options_.max_background_compactions != -1) {
+    return;
+  }
+
+  char reason[200];
+  reason[0] = '\0';
+  if (new_stall_micros * 100 > elapsed_micros) {
+    snprintf(reason, sizeof(reason),
+             "writes were stalled for %" PRIu64 " of the last %" PRIu64
+             " micros",
+             new_stall_micros, elapsed_micros);
+  } else if (new_stall_count > 0) {
+    snprintf(reason, sizeof(reason),
+             "%" PRIu64
+             " write slowdowns or stops by the L0 file count or pending "
+             "compaction bytes limits",
+             new_stall_count);
+  } else if (!over_soft_limit_cf.empty()) {
+    snprintf(reason, sizeof(reason),
+             "column family [%s] is over half its "
+             "soft_pending_compaction_bytes_limit",
+             over_soft_limit_cf.c_str());
+  }
+  TEST_SYNC_POINT_CALLBACK("DBImpl::AutoTune:Reason", reason);
+
+  const int max_background_jobs = mutable_db_options_.max_background_jobs;
+  if (reason[0] != '\0') {
+    state.quiet_runs = 0;
+    if (state.extra_background_jobs >= max_background_jobs) {
+      return;
+    }
+    state.extra_background_jobs++;
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "[auto-tune] Allowing %d background jobs "
+                   "(max_background_jobs %d + %d) as %s",
+                   max_background_jobs + state.extra_background_jobs,
+                   max_background_jobs, state.extra_background_jobs, reason);
+    const BGJobLimits bg_job_limits = GetBGJobLimits();
+    env_->IncBackgroundThreadsIfNeeded(bg_job_limits.max_flushes,
+                                       Env::Priority::HIGH);
+    env_->IncBackgroundThreadsIfNeeded(bg_job_limits.max_compactions,
+                                       Env::Priority::LOW);
+    MaybeScheduleFlushOrCompaction();
+  } else if (state.extra_background_jobs > 0 &&
+             ++state.quiet_runs >= kQuietRunsBeforeDecrease) {
+    state.quiet_runs = 0;
+    state.extra_background_jobs--;
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "[auto-tune] Allowing %d background jobs "
+                   "(max_background_jobs %d + %d) as there were no write "
+                   "stalls in the last %d runs",
+                   max_background_jobs + state.extra_background_jobs,
+                   max_background_jobs, state.extra_background_jobs,
+                   kQuietRunsBeforeDecrease);
+  }
+}
+
 Status DBImpl::TablesRangeTombstoneSummary(ColumnFamilyHandle* column_family,
                                            int max_entries_to_print,
                                            std::string* out_str) {
@@ -1401,6 +2164,16 @@ Status DBImpl::SetDBOptions(
               new_options.stats_persist_period_sec);
         }
       }
+      if (s.ok()) {
+        if (new_options.auto_tune_period_sec == 0) {
+          s = periodic_task_scheduler_.Unregister(PeriodicTaskType::kAutoTune);
+        } else {
+          s = periodic_task_scheduler_.Register(
+              PeriodicTaskType::kAutoTune,
+              periodic_task_functions_.at(PeriodicTaskType::kAutoTune),
+              new_options.auto_tune_period_sec);
+        }
+      }
       mutex_.Lock();
       if (!s.ok()) {
         return s;
@@ -1415,6 +2188,10 @@ Status DBImpl::SetDBOptions(
                                  new_options.wal_bytes_per_sync;
       wal_size_option_changed = mutable_db_options_.max_total_wal_size !=
                                 new_options.max_total_wal_size;
+      if (mutable_db_options_.auto_tune_period_sec !=
+          new_options.auto_tune_period_sec) {
+        auto_tune_state_ = AutoTuneState();
+      }
       mutable_db_options_ = new_options;
       file_options_for_compaction_ = FileOptions(new_db_options);
       file_options_for_compaction_ = fs_->OptimizeForCompactionTableWrite(
@@ -2136,9 +2913,10 @@ InternalIterator* DBImpl::NewInternalIterator(
   if (s.ok()) {
     // Collect iterators for files in L0 - Ln
     if (read_options.read_tier != kMemtableTier) {
-      super_version->current->AddIterators(read_options, file_options_,
-                                           &merge_iter_builder,
-                                           allow_unprepared_value);
+      super_version->current->AddIterators(
+          read_options, file_options_, &merge_iter_builder,
+          allow_unprepared_value,
+          db_iter != nullptr ? db_iter->GetFileIteratorStash() : nullptr);
     }
     internal_iter = merge_iter_builder.Finish(
         read_options.ignore_range_deletions ? nullptr : db_iter);
@@ -2358,6 +3136,13 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
 
   GetWithTimestampReadCallback read_cb(0);  // Will call Refresh
 
+  OperationTraceGuard op_trace(
+      immutable_db_options_.slow_operation_threshold_micros,
+      immutable_db_options_.clock, immutable_db_options_.listeners,
+      SlowOperationType::kGet);
+  PerfContextSampler perf_sampler(
+      immutable_db_options_.perf_context_sample_rate, stats_,
+      PerfSampledOp::kGet);
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, immutable_db_options_.clock);
   StopWatch sw(immutable_db_options_.clock, stats_, DB_GET);
   PERF_TIMER_GUARD(get_snapshot_time);
@@ -2459,7 +3244,8 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   // First look in the memtable, then in the immutable memtable (if any).
   // s is both in/out. When in, s could either be OK or MergeInProgress.
   // merge_operands will contain the sequence of merges in the latter case.
-  LookupKey lkey(key, snapshot, read_options.timestamp);
+  ThreadLocalLookupKeyBuffer lookup_key_buf;
+  LookupKey lkey(key, snapshot, read_options.timestamp, lookup_key_buf.get());
   PERF_TIMER_STOP(get_snapshot_time);
 
   bool skip_memtable = (read_options.read_tier == kPersistedTier &&
@@ -2531,6 +3317,7 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   PinnedIteratorsManager pinned_iters_mgr;
   if (!done) {
     PERF_TIMER_GUARD(get_from_output_files_time);
+    OPERATION_SPAN_GUARD(TableFilesGet);
     sv->current->Get(
         read_options, lkey, get_impl_options.value, get_impl_options.columns,
         timestamp, &s, &merge_context, &max_covering_tombstone_seq,
@@ -2559,6 +3346,13 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
         if (get_impl_options.value) {
           size = get_impl_options.value->size();
         } else if (get_impl_options.columns) {
+          if (read_options.column_projection) {
+            const Status project_status = WideColumnsHelper::ProjectColumns(
+                *read_options.column_projection, *get_impl_options.columns);
+            if (!project_status.ok()) {
+              s = project_status;
+            }
+          }
           size = get_impl_options.columns->serialized_size();
         }
       } else {
@@ -3189,6 +3983,13 @@ Status DBImpl::MultiGetImpl(
     autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
     SuperVersion* super_version, SequenceNumber snapshot,
     ReadCallback* callback) {
+  OperationTraceGuard op_trace(
+      immutable_db_options_.slow_operation_threshold_micros,
+      immutable_db_options_.clock, immutable_db_options_.listeners,
+      SlowOperationType::kMultiGet);
+  PerfContextSampler perf_sampler(
+      immutable_db_options_.perf_context_sample_rate, stats_,
+      PerfSampledOp::kMultiGet);
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, immutable_db_options_.clock);
   StopWatch sw(immutable_db_options_.clock, stats_, DB_MULTIGET);
 
@@ -3253,6 +4054,7 @@ Status DBImpl::MultiGetImpl(
     }
     if (lookup_current) {
       PERF_TIMER_GUARD(get_from_output_files_time);
+      OPERATION_SPAN_GUARD(TableFilesGet);
       super_version->current->MultiGet(read_options, &range, callback);
     }
     curr_value_size = range.GetValueSize();
@@ -3289,6 +4091,14 @@ Status DBImpl::MultiGetImpl(
         bytes_read += key->value->size();
       } else {
         assert(key->columns);
+        if (read_options.column_projection) {
+          const Status project_status = WideColumnsHelper::ProjectColumns(
+              *read_options.column_projection, *key->columns);
+          if (!project_status.ok()) {
+            *(key->s) = project_status;
+            continue;
+          }
+        }
         bytes_read += key->columns->serialized_size();
       }
 
@@ -4132,6 +4942,185 @@ Status DBImpl::NewIterators(
   return Status::OK();
 }
 
+namespace {
+// The bounds of one iterator of a parallel scan, owned by the iterator
+struct ParallelScanBounds {
+  std::string lower;
+  std::string upper;
+  Slice lower_slice;
+  Slice upper_slice;
+};
+}  // namespace
+
+Status DBImpl::NewParallelScan(
+    const ReadOptions& _read_options, ColumnFamilyHandle* column_family,
+    size_t num_partitions, std::vector<std::unique_ptr<Iterator>>* iterators) {
+  if (_read_options.io_activity != Env::IOActivity::kUnknown &&
+      _read_options.io_activity != Env::IOActivity::kDBIterator) {
+    return Status::InvalidArgument(
+        "Can only call NewParallelScan with `ReadOptions::io_activity` is "
+        "`Env::IOActivity::kUnknown` or `Env::IOActivity::kDBIterator`");
+  }
+  ReadOptions read_options(_read_options);
+  if (read_options.io_activity == Env::IOActivity::kUnknown) {
+    read_options.io_activity = Env::IOActivity::kDBIterator;
+  }
+  if (num_partitions == 0) {
+    return Status::InvalidArgument("num_partitions must be positive");
+  }
+  if (read_options.managed) {
+    return Status::NotSupported("Managed iterator is not supported anymore.");
+  }
+  if (read_options.read_tier == kPersistedTier) {
+    return Status::NotSupported(
+        "ReadTier::kPersistedData is not yet supported in iterators.");
+  }
+  if (read_options.tailing) {
+    return Status::NotSupported("Tailing iterators cannot be partitioned.");
+  }
+  assert(column_family);
+  Status s = read_options.timestamp
+                 ? FailIfTsMismatchCf(column_family, *(read_options.timestamp))
+                 : FailIfCfHasTs(column_family);
+  if (!s.ok()) {
+    return s;
+  }
+
+  auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(column_family);
+  ColumnFamilyData* cfd = cfh->cfd();
+  SuperVersion* sv = cfd->GetReferencedSuperVersion(this);
+  if (read_options.timestamp && read_options.timestamp->size() > 0) {
+    s = FailIfReadCollapsedHistory(cfd, sv, *(read_options.timestamp));
+    if (!s.ok()) {
+      CleanupSuperVersion(sv);
+      return s;
+    }
+  }
+  // Assigned after referencing the SuperVersion, see NewIteratorImpl()
+  const SequenceNumber snapshot =
+      read_options.snapshot != nullptr
+          ? read_options.snapshot->GetSequenceNumber()
+          : versions_->LastSequence();
+
+  const std::vector<std::string> boundaries =
+      GetParallelScanBoundaries(read_options, cfd, sv, num_partitions);
+  iterators->clear();
+  iterators->reserve(boundaries.size() + 1);
+  const Slice* const lower_bound = read_options.iterate_lower_bound;
+  const Slice* const upper_bound = read_options.iterate_upper_bound;
+  for (size_t i = 0; i <= boundaries.size(); i++) {
+    auto* bounds = new ParallelScanBounds();
+    read_options.iterate_lower_bound = lower_bound;
+    read_options.iterate_upper_bound = upper_bound;
+    if (i > 0) {
+      bounds->lower = boundaries[i - 1];
+      bounds->lower_slice = bounds->lower;
+      read_options.iterate_lower_bound = &bounds->lower_slice;
+    }
+    if (i < boundaries.size()) {
+      bounds->upper = boundaries[i];
+      bounds->upper_slice = bounds->upper;
+      read_options.iterate_upper_bound = &bounds->upper_slice;
+    }
+    // Every iterator releases its own reference
+    if (i > 0) {
+      sv->Ref();
+    }
+    Iterator* iter = NewIteratorImpl(read_options, cfh, sv, snapshot,
+                                     /*read_callback=*/nullptr);
+    iter->RegisterCleanup(
+        [](void* arg1, void* /*arg2*/) {
+          delete static_cast<ParallelScanBounds*>(arg1);
+        },
+        bounds, nullptr);
+    iterators->emplace_back(iter);
+  }
+  return Status::OK();
+}
+
+std::vector<std::string> DBImpl::GetParallelScanBoundaries(
+    const ReadOptions& read_options, ColumnFamilyData* cfd, SuperVersion* sv,
+    size_t num_partitions) {
+  std::vector<std::string> boundaries;
+  if (num_partitions <= 1 || sv->mutable_cf_options.table_factory->Name() ==
+                                 TableFactory::kPlainTableName()) {
+    return boundaries;
+  }
+  const Comparator* ucmp = cfd->user_comparator();
+  const Slice* lower = read_options.iterate_lower_bound;
+  const Slice* upper = read_options.iterate_upper_bound;
+  auto in_range = [&](const Slice& user_key) {
+    return (lower == nullptr ||
+            ucmp->CompareWithoutTimestamp(user_key, *lower) > 0) &&
+           (upper == nullptr ||
+            ucmp->CompareWithoutTimestamp(user_key, *upper) < 0);
+  };
+
+  // Same approach as CompactionJob::GenSubcompactionBoundaries(): the anchors
+  // of all the files overlapping the range, in key order, split by their
+  // cumulative size. The memtables are not accounted for.
+  ReadOptions anchor_read_options(Env::IOActivity::kDBIterator);
+  anchor_read_options.rate_limiter_priority =
+      read_options.rate_limiter_priority;
+  const VersionStorageInfo* vstorage = sv->current->storage_info();
+  std::vector<TableReader::Anchor> anchors;
+  uint64_t total_size = 0;
+  for (int level = 0; level < vstorage->num_non_empty_levels(); level++) {
+    for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+      if ((lower != nullptr && ucmp->CompareWithoutTimestamp(
+                                   f->largest.user_key(), *lower) < 0) ||
+          (upper != nullptr && ucmp->CompareWithoutTimestamp(
+                                   f->smallest.user_key(), *upper) >= 0)) {
+        continue;
+      }
+      std::vector<TableReader::Anchor> file_anchors;
+      Status s = cfd->table_cache()->ApproximateKeyAnchors(
+          anchor_read_options, cfd->internal_comparator(), *f,
+          sv->mutable_cf_options, file_anchors);
+      if (!s.ok() || file_anchors.empty()) {
+        file_anchors.clear();
+        file_anchors.emplace_back(f->largest.user_key(), f->fd.GetFileSize());
+      }
+      for (auto& anchor : file_anchors) {
+        if (in_range(anchor.user_key)) {
+          total_size += anchor.range_size;
+          anchors.push_back(std::move(anchor));
+        }
+      }
+    }
+  }
+  std::sort(anchors.begin(), anchors.end(),
+            [ucmp](const TableReader::Anchor& a, const TableReader::Anchor& b) {
+              return ucmp->CompareWithoutTimestamp(a.user_key, b.user_key) < 0;
+            });
+  anchors.erase(
+      std::unique(anchors.begin(), anchors.end(),
+                  [ucmp](const TableReader::Anchor& a,
+                         const TableReader::Anchor& b) {
+                    return ucmp->CompareWithoutTimestamp(a.user_key,
+                                                         b.user_key) == 0;
+                  }),
+      anchors.end());
+
+  const uint64_t target_size = total_size / num_partitions;
+  if (target_size == 0) {
+    return boundaries;
+  }
+  uint64_t next_threshold = target_size;
+  uint64_t cumulative_size = 0;
+  for (TableReader::Anchor& anchor : anchors) {
+    cumulative_size += anchor.range_size;
+    if (cumulative_size > next_threshold) {
+      next_threshold += target_size;
+      boundaries.push_back(std::move(anchor.user_key));
+      if (boundaries.size() + 1 == num_partitions) {
+        break;
+      }
+    }
+  }
+  return boundaries;
+}
+
 const Snapshot* DBImpl::GetSnapshot() { return GetSnapshotImpl(false); }
 
 const Snapshot* DBImpl::GetSnapshotForWriteConflictBoundary() {
@@ -4162,7 +5151,6 @@ void DBImpl::ReleaseTimestampedSnapshotsOlderThan(uint64_t ts,
   snapshots_to_release.clear();
 
   if (remaining_total_ss) {
-    InstrumentedMutexLock lock_guard(&mutex_);
     *remaining_total_ss = static_cast<size_t>(snapshots_.count());
   }
 }
@@ -4627,7 +5615,7 @@ bool DBImpl::GetIntPropertyInternal(ColumnFamilyData* cfd,
     sv = GetAndRefSuperVersion(cfd);
 
     bool ret = cfd->internal_stats()->GetIntPropertyOutOfMutex(
-        property_info, sv->current, value);
+        property_info, sv->current, value, this);
 
     ReturnAndCleanupSuperVersion(cfd, sv);
     if (is_locked) {
@@ -4653,6 +5641,9 @@ Status DBImpl::ResetStats() {
   for (auto* cfd : *versions_->GetColumnFamilySet()) {
     if (cfd->initialized()) {
       cfd->internal_stats()->Clear();
+      for (const auto& hist : cfd->table_cache()->GetPathReadHists()) {
+        hist->Clear();
+      }
     }
   }
   return Status::OK();
@@ -4814,6 +5805,11 @@ Status DBImpl::GetApproximateSizes(const SizeApproximationOptions& options,
   if (!options.include_memtables && !options.include_files) {
     return Status::InvalidArgument("Invalid options");
   }
+  if (options.use_key_anchors) {
+    std::vector<uint64_t> counts(n);
+    return GetApproximateRangeStats(options, column_family, range, n, sizes,
+                                    counts.data());
+  }
 
   const Comparator* const ucmp = column_family->GetComparator();
   assert(ucmp);
@@ -4854,6 +5850,57 @@ Status DBImpl::GetApproximateSizes(const SizeApproximationOptions& options,
   return Status::OK();
 }
 
+Status DBImpl::GetApproximateRangeStats(const SizeApproximationOptions& options,
+                                        ColumnFamilyHandle* column_family,
+                                        const Range* range, int n,
+                                        uint64_t* sizes, uint64_t* counts) {
+  if (!options.include_memtables && !options.include_files) {
+    return Status::InvalidArgument("Invalid options");
+  }
+
+  const Comparator* const ucmp = column_family->GetComparator();
+  assert(ucmp);
+  size_t ts_sz = ucmp->timestamp_size();
+
+  auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(column_family);
+  auto cfd = cfh->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+
+  // TODO: plumb Env::IOActivity, Env::IOPriority
+  const ReadOptions read_options;
+  for (int i = 0; i < n; i++) {
+    // Add timestamp if needed
+    std::string start_with_ts, limit_with_ts;
+    auto [start, limit] = MaybeAddTimestampsToRange(
+        range[i].start, range[i].limit, ts_sz, &start_with_ts, &limit_with_ts);
+    assert(start.has_value());
+    assert(limit.has_value());
+    sizes[i] = 0;
+    counts[i] = 0;
+    if (options.include_files) {
+      VersionKeyAnchors::Stats stats =
+          sv->current->GetKeyAnchors(read_options)
+              .Estimate(start.value(), limit.value());
+      sizes[i] += stats.size;
+      counts[i] += stats.count;
+    }
+    if (options.include_memtables) {
+      // Convert user_key into a corresponding internal key.
+      InternalKey k1(start.value(), kMaxSequenceNumber, kValueTypeForSeek);
+      InternalKey k2(limit.value(), kMaxSequenceNumber, kValueTypeForSeek);
+      ReadOnlyMemTable::MemTableStats mem_stats =
+          sv->mem->ApproximateStats(k1.Encode(), k2.Encode());
+      ReadOnlyMemTable::MemTableStats imm_stats =
+          sv->imm->ApproximateStats(k1.Encode(), k2.Encode());
+      sizes[i] += mem_stats.size + imm_stats.size;
+      counts[i] += mem_stats.count + imm_stats.count;
+    }
+  }
+
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  return Status::OK();
+}
+
 std::list<uint64_t>::iterator
 DBImpl::CaptureCurrentFileNumberInPendingOutputs() {
   // We need to remember the iterator of our insert, because after the
@@ -5678,22 +6725,61 @@ Status DBImpl::GetLatestSequenceForKey(
 
   LookupKey lkey(key, current_seq, ts_sz == 0 ? nullptr : &ts);
 
+  if (GetLatestSequenceFromMemTables(
+          sv, lkey, read_options, lower_bound_seq, &s, &merge_context,
+          &max_covering_tombstone_seq, seq, timestamp, found_record_for_key,
+          is_blob_index)) {
+    return s;
+  }
+
+  // TODO(agiardullo): possible optimization: consider checking cached
+  // SST files if cache_only=true?
+  if (!cache_only) {
+    // Check tables
+    PinnedIteratorsManager pinned_iters_mgr;
+    sv->current->Get(read_options, lkey, /*value=*/nullptr, /*columns=*/nullptr,
+                     timestamp, &s, &merge_context, &max_covering_tombstone_seq,
+                     &pinned_iters_mgr, nullptr /* value_found */,
+                     found_record_for_key, seq, nullptr /*read_callback*/,
+                     is_blob_index);
+
+    if (!(s.ok() || s.IsNotFound() || s.IsMergeInProgress())) {
+      // unexpected error reading SST files
+      ROCKS_LOG_ERROR(immutable_db_options_.info_log,
+                      "Unexpected status returned from Version::Get: %s\n",
+                      s.ToString().c_str());
+    }
+  }
+
+  return s;
+}
+
+bool DBImpl::GetLatestSequenceFromMemTables(
+    SuperVersion* sv, const LookupKey& lkey, const ReadOptions& read_options,
+    SequenceNumber lower_bound_seq, Status* s, MergeContext* merge_context,
+    SequenceNumber* max_covering_tombstone_seq, SequenceNumber* seq,
+    std::string* timestamp, bool* found_record_for_key, bool* is_blob_index) {
+  const size_t ts_sz = sv->cfd->user_comparator()->timestamp_size();
+#ifdef NDEBUG
+  (void)ts_sz;
+#endif  // NDEBUG
+
   *seq = kMaxSequenceNumber;
   *found_record_for_key = false;
 
   // Check if there is a record for this key in the latest memtable
-  sv->mem->Get(lkey, /*value=*/nullptr, /*columns=*/nullptr, timestamp, &s,
-               &merge_context, &max_covering_tombstone_seq, seq, read_options,
+  sv->mem->Get(lkey, /*value=*/nullptr, /*columns=*/nullptr, timestamp, s,
+               merge_context, max_covering_tombstone_seq, seq, read_options,
                false /* immutable_memtable */, nullptr /*read_callback*/,
                is_blob_index);
 
-  if (!(s.ok() || s.IsNotFound() || s.IsMergeInProgress())) {
+  if (!(s->ok() || s->IsNotFound() || s->IsMergeInProgress())) {
     // unexpected error reading memtable.
     ROCKS_LOG_ERROR(immutable_db_options_.info_log,
                     "Unexpected status returned from MemTable::Get: %s\n",
-                    s.ToString().c_str());
+                    s->ToString().c_str());
 
-    return s;
+    return true;
   }
   assert(!ts_sz ||
          (*seq != kMaxSequenceNumber &&
@@ -5705,28 +6791,30 @@ Status DBImpl::GetLatestSequenceForKey(
   if (*seq != kMaxSequenceNumber) {
     // Found a sequence number, no need to check immutable memtables
     *found_record_for_key = true;
-    return Status::OK();
+    *s = Status::OK();
+    return true;
   }
 
   SequenceNumber lower_bound_in_mem = sv->mem->GetEarliestSequenceNumber();
   if (lower_bound_in_mem != kMaxSequenceNumber &&
       lower_bound_in_mem < lower_bound_seq) {
     *found_record_for_key = false;
-    return Status::OK();
+    *s = Status::OK();
+    return true;
   }
 
   // Check if there is a record for this key in the immutable memtables
-  sv->imm->Get(lkey, /*value=*/nullptr, /*columns=*/nullptr, timestamp, &s,
-               &merge_context, &max_covering_tombstone_seq, seq, read_options,
+  sv->imm->Get(lkey, /*value=*/nullptr, /*columns=*/nullptr, timestamp, s,
+               merge_context, max_covering_tombstone_seq, seq, read_options,
                nullptr /*read_callback*/, is_blob_index);
 
-  if (!(s.ok() || s.IsNotFound() || s.IsMergeInProgress())) {
+  if (!(s->ok() || s->IsNotFound() || s->IsMergeInProgress())) {
     // unexpected error reading memtable.
     ROCKS_LOG_ERROR(immutable_db_options_.info_log,
                     "Unexpected status returned from MemTableList::Get: %s\n",
-                    s.ToString().c_str());
+                    s->ToString().c_str());
 
-    return s;
+    return true;
   }
 
   assert(!ts_sz ||
@@ -5737,30 +6825,32 @@ Status DBImpl::GetLatestSequenceForKey(
   if (*seq != kMaxSequenceNumber) {
     // Found a sequence number, no need to check memtable history
     *found_record_for_key = true;
-    return Status::OK();
+    *s = Status::OK();
+    return true;
   }
 
   SequenceNumber lower_bound_in_imm = sv->imm->GetEarliestSequenceNumber();
   if (lower_bound_in_imm != kMaxSequenceNumber &&
       lower_bound_in_imm < lower_bound_seq) {
     *found_record_for_key = false;
-    return Status::OK();
+    *s = Status::OK();
+    return true;
   }
 
   // Check if there is a record for this key in the immutable memtables
   sv->imm->GetFromHistory(lkey, /*value=*/nullptr, /*columns=*/nullptr,
-                          timestamp, &s, &merge_context,
-                          &max_covering_tombstone_seq, seq, read_options,
+                          timestamp, s, merge_context,
+                          max_covering_tombstone_seq, seq, read_options,
                           is_blob_index);
 
-  if (!(s.ok() || s.IsNotFound() || s.IsMergeInProgress())) {
+  if (!(s->ok() || s->IsNotFound() || s->IsMergeInProgress())) {
     // unexpected error reading memtable.
     ROCKS_LOG_ERROR(
         immutable_db_options_.info_log,
         "Unexpected status returned from MemTableList::GetFromHistory: %s\n",
-        s.ToString().c_str());
+        s->ToString().c_str());
 
-    return s;
+    return true;
   }
 
   assert(!ts_sz ||
@@ -5772,33 +6862,75 @@ Status DBImpl::GetLatestSequenceForKey(
     // Found a sequence number, no need to check SST files
     assert(0 == ts_sz || *timestamp != std::string(ts_sz, '\xff'));
     *found_record_for_key = true;
-    return Status::OK();
+    *s = Status::OK();
+    return true;
   }
 
   // We could do a sv->imm->GetEarliestSequenceNumber(/*include_history*/ true)
   // check here to skip the history if possible. But currently the caller
   // already does that. Maybe we should move the logic here later.
+  return false;
+}
 
-  // TODO(agiardullo): possible optimization: consider checking cached
-  // SST files if cache_only=true?
-  if (!cache_only) {
-    // Check tables
-    PinnedIteratorsManager pinned_iters_mgr;
-    sv->current->Get(read_options, lkey, /*value=*/nullptr, /*columns=*/nullptr,
-                     timestamp, &s, &merge_context, &max_covering_tombstone_seq,
-                     &pinned_iters_mgr, nullptr /* value_found */,
-                     found_record_for_key, seq, nullptr /*read_callback*/,
-                     is_blob_index);
+void DBImpl::GetLatestSequenceForKeys(
+    SuperVersion* sv, std::vector<LatestSequenceLookup>* lookups) {
+  // TODO: plumb Env::IOActivity, Env::IOPriority
+  ReadOptions read_options;
+  SequenceNumber current_seq = versions_->LastSequence();
+  assert(sv->cfd->user_comparator()->timestamp_size() == 0);
 
-    if (!(s.ok() || s.IsNotFound() || s.IsMergeInProgress())) {
+  // The lookups to finish in the SST files, in the order of their keys
+  std::vector<LatestSequenceLookup*> table_lookups;
+  std::deque<KeyContext> key_contexts;
+  std::deque<PinnableSlice> values;
+  autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE> sorted_keys;
+  for (auto& lookup : *lookups) {
+    LookupKey lkey(lookup.key, current_seq);
+    values.emplace_back();
+    key_contexts.emplace_back(/*col_family=*/nullptr, lookup.key,
+                              &values.back(), /*cols=*/nullptr,
+                              /*ts=*/nullptr, &lookup.s);
+    KeyContext& key_context = key_contexts.back();
+    lookup.s = Status::OK();
+    if (GetLatestSequenceFromMemTables(
+            sv, lkey, read_options, lookup.lower_bound_seq, &lookup.s,
+            &key_context.merge_context,
+            &key_context.max_covering_tombstone_seq, &lookup.seq,
+            /*timestamp=*/nullptr, &lookup.found_record_for_key,
+            /*is_blob_index=*/nullptr) ||
+        lookup.cache_only) {
+      key_contexts.pop_back();
+      values.pop_back();
+      continue;
+    }
+    assert(lookup.s.ok() || lookup.s.IsMergeInProgress());
+    key_context.seq = &lookup.seq;
+    table_lookups.push_back(&lookup);
+    sorted_keys.push_back(&key_context);
+  }
+
+  // Check tables
+  for (size_t start = 0; start < sorted_keys.size();
+       start += MultiGetContext::MAX_BATCH_SIZE) {
+    const size_t batch_size =
+        std::min(sorted_keys.size() - start,
+                 static_cast<size_t>(MultiGetContext::MAX_BATCH_SIZE));
+    MultiGetContext ctx(&sorted_keys, start, batch_size, current_seq,
+                        read_options, GetFileSystem(), stats_);
+    MultiGetRange range = ctx.GetMultiGetRange();
+    sv->current->MultiGet(read_options, &range, /*callback=*/nullptr);
+  }
+
+  for (LatestSequenceLookup* lookup : table_lookups) {
+    lookup->found_record_for_key = lookup->seq != kMaxSequenceNumber;
+    if (!(lookup->s.ok() || lookup->s.IsNotFound() ||
+          lookup->s.IsMergeInProgress())) {
       // unexpected error reading SST files
       ROCKS_LOG_ERROR(immutable_db_options_.info_log,
-                      "Unexpected status returned from Version::Get: %s\n",
-                      s.ToString().c_str());
+                      "Unexpected status returned from Version::MultiGet: %s\n",
+                      lookup->s.ToString().c_str());
     }
   }
-
-  return s;
 }
 
 Status DBImpl::IngestExternalFile(
@@ -6407,10 +7539,15 @@ Status DBImpl::VerifyFileChecksums(const ReadOptions& _read_options) {
     read_options.io_activity = Env::IOActivity::kVerifyFileChecksums;
   }
   return VerifyChecksumInternal(read_options,
-                                /*use_file_checksum=*/true);
+                                /*use_file_checksum=*/true, /*max_threads=*/1);
+}
+
+Status DBImpl::VerifyChecksum(const ReadOptions& read_options) {
+  return VerifyChecksum(read_options, /*max_threads=*/1);
 }
 
-Status DBImpl::VerifyChecksum(const ReadOptions& _read_options) {
+Status DBImpl::VerifyChecksum(const ReadOptions& _read_options,
+                              int max_threads) {
   if (_read_options.io_activity != Env::IOActivity::kUnknown &&
       _read_options.io_activity != Env::IOActivity::kVerifyDBChecksum) {
     return Status::InvalidArgument(
@@ -6422,16 +7559,12 @@ Status DBImpl::VerifyChecksum(const ReadOptions& _read_options) {
     read_options.io_activity = Env::IOActivity::kVerifyDBChecksum;
   }
   return VerifyChecksumInternal(read_options,
-                                /*use_file_checksum=*/false);
+                                /*use_file_checksum=*/false, max_threads);
 }
 
 Status DBImpl::VerifyChecksumInternal(const ReadOptions& read_options,
-                                      bool use_file_checksum) {
-  // `bytes_read` stat is enabled based on compile-time support and cannot
-  // be dynamically toggled. So we do not need to worry about `PerfLevel`
-  // here, unlike many other `IOStatsContext` / `PerfContext` stats.
-  uint64_t prev_bytes_read = IOSTATS(bytes_read);
-
+                                      bool use_file_checksum,
+                                      int max_threads) {
   Status s;
 
   if (use_file_checksum) {
@@ -6462,60 +7595,111 @@ Status DBImpl::VerifyChecksumInternal(const ReadOptions& read_options,
     sv_list.push_back(cfd->GetReferencedSuperVersion(this));
   }
 
-  for (auto& sv : sv_list) {
-    VersionStorageInfo* vstorage = sv->current->storage_info();
-    ColumnFamilyData* cfd = sv->current->cfd();
-    Options opts;
+  // The files to verify, which the referenced super versions keep alive
+  struct FileToVerify {
+    const Options* opts;
+    std::string fname;
+    SequenceNumber largest_seqno;
+    // Set when the file checksum is verified
+    const std::string* file_checksum;
+    const std::string* file_checksum_func_name;
+  };
+  std::vector<Options> opts_list(sv_list.size());
+  std::vector<FileToVerify> files;
+  for (size_t k = 0; k < sv_list.size(); k++) {
+    VersionStorageInfo* vstorage = sv_list[k]->current->storage_info();
+    ColumnFamilyData* cfd = sv_list[k]->current->cfd();
     if (!use_file_checksum) {
       InstrumentedMutexLock l(&mutex_);
-      opts = Options(BuildDBOptions(immutable_db_options_, mutable_db_options_),
-                     cfd->GetLatestCFOptions());
+      opts_list[k] =
+          Options(BuildDBOptions(immutable_db_options_, mutable_db_options_),
+                  cfd->GetLatestCFOptions());
     }
-    for (int i = 0; i < vstorage->num_non_empty_levels() && s.ok(); i++) {
-      for (size_t j = 0; j < vstorage->LevelFilesBrief(i).num_files && s.ok();
-           j++) {
+    for (int i = 0; i < vstorage->num_non_empty_levels(); i++) {
+      for (size_t j = 0; j < vstorage->LevelFilesBrief(i).num_files; j++) {
         const auto& fd_with_krange = vstorage->LevelFilesBrief(i).files[j];
         const auto& fd = fd_with_krange.fd;
         const FileMetaData* fmeta = fd_with_krange.file_metadata;
         assert(fmeta);
-        std::string fname = TableFileName(cfd->ioptions().cf_paths,
-                                          fd.GetNumber(), fd.GetPathId());
-        if (use_file_checksum) {
-          s = VerifyFullFileChecksum(fmeta->file_checksum,
-                                     fmeta->file_checksum_func_name, fname,
-                                     read_options);
-        } else {
-          s = ROCKSDB_NAMESPACE::VerifySstFileChecksumInternal(
-              opts, file_options_, read_options, fname, fd.largest_seqno);
-        }
-        RecordTick(stats_, VERIFY_CHECKSUM_READ_BYTES,
-                   IOSTATS(bytes_read) - prev_bytes_read);
-        prev_bytes_read = IOSTATS(bytes_read);
+        files.push_back(
+            {&opts_list[k],
+             TableFileName(cfd->ioptions().cf_paths, fd.GetNumber(),
+                           fd.GetPathId()),
+             fd.largest_seqno,
+             use_file_checksum ? &fmeta->file_checksum : nullptr,
+             use_file_checksum ? &fmeta->file_checksum_func_name : nullptr});
       }
     }
 
-    if (s.ok() && use_file_checksum) {
+    if (use_file_checksum) {
       const auto& blob_files = vstorage->GetBlobFiles();
       for (const auto& meta : blob_files) {
         assert(meta);
 
         const uint64_t blob_file_number = meta->GetBlobFileNumber();
 
-        const std::string blob_file_name = BlobFileName(
-            cfd->ioptions().cf_paths.front().path, blob_file_number);
-        s = VerifyFullFileChecksum(meta->GetChecksumValue(),
-                                   meta->GetChecksumMethod(), blob_file_name,
-                                   read_options);
-        RecordTick(stats_, VERIFY_CHECKSUM_READ_BYTES,
-                   IOSTATS(bytes_read) - prev_bytes_read);
-        prev_bytes_read = IOSTATS(bytes_read);
-        if (!s.ok()) {
-          break;
-        }
+        files.push_back({&opts_list[k],
+                         BlobFileName(cfd->ioptions().cf_paths.front().path,
+                                      blob_file_number),
+                         kMaxSequenceNumber, &meta->GetChecksumValue(),
+                         &meta->GetChecksumMethod()});
       }
     }
-    if (!s.ok()) {
-      break;
+  }
+
+  // Verifies the files from `next_file` until all are verified or `failed` is
+  // set, and records the bytes the thread read for them.
+  std::atomic<size_t> next_file{0};
+  std::atomic<bool> failed{false};
+  auto verify_files = [&](Status* status) {
+    // `bytes_read` stat is enabled based on compile-time support and cannot
+    // be dynamically toggled. So we do not need to worry about `PerfLevel`
+    // here, unlike many other `IOStatsContext` / `PerfContext` stats.
+    uint64_t prev_bytes_read = IOSTATS(bytes_read);
+    while (!failed.load(std::memory_order_relaxed)) {
+      const size_t i = next_file.fetch_add(1, std::memory_order_relaxed);
+      if (i >= files.size()) {
+        break;
+      }
+      const FileToVerify& file = files[i];
+      if (file.file_checksum != nullptr) {
+        *status = VerifyFullFileChecksum(*file.file_checksum,
+                                         *file.file_checksum_func_name,
+                                         file.fname, read_options);
+      } else {
+        *status = ROCKSDB_NAMESPACE::VerifySstFileChecksumInternal(
+            *file.opts, file_options_, read_options, file.fname,
+            file.largest_seqno);
+      }
+      RecordTick(stats_, VERIFY_CHECKSUM_READ_BYTES,
+                 IOSTATS(bytes_read) - prev_bytes_read);
+      prev_bytes_read = IOSTATS(bytes_read);
+      if (!status->ok()) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  const size_t num_threads = std::min(
+      files.size(), static_cast<size_t>(std::max(max_threads, 1)));
+  if (num_threads <= 1) {
+    verify_files(&s);
+  } else {
+    std::vector<Status> statuses(num_threads);
+    std::vector<port::Thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; i++) {
+      threads.emplace_back(verify_files, &statuses[i]);
+    }
+    verify_files(&statuses[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (auto& status : statuses) {
+      if (s.ok() && !status.ok()) {
+        s = status;
+      }
+      status.PermitUncheckedError();
     }
   }
 
@@ -6539,8 +7723,6 @@ Status DBImpl::VerifyChecksumInternal(const ReadOptions& read_options,
       cfd->UnrefAndTryDelete();
     }
   }
-  RecordTick(stats_, VERIFY_CHECKSUM_READ_BYTES,
-             IOSTATS(bytes_read) - prev_bytes_read);
   return s;
 }
 
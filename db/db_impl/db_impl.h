@@ -34,6 +34,7 @@
 #include "db/log_writer.h"
 #include "db/logs_with_prep_tracker.h"
 #include "db/memtable_list.h"
+#include "db/parallel_wal_recovery.h"
 #include "db/periodic_task_scheduler.h"
 #include "db/post_memtable_callback.h"
 #include "db/pre_release_callback.h"
@@ -45,6 +46,7 @@
 #include "db/trim_history_scheduler.h"
 #include "db/version_edit.h"
 #include "db/wal_manager.h"
+#include "db/warmup_scheduler.h"
 #include "db/write_controller.h"
 #include "db/write_thread.h"
 #include "logging/event_logger.h"
@@ -390,6 +392,11 @@ class DBImpl : public DB {
       const ReadOptions& _read_options, ColumnFamilyHandle* column_family,
       const std::vector<ScanOptions>& scan_opts) override;
 
+  Status NewParallelScan(
+      const ReadOptions& _read_options, ColumnFamilyHandle* column_family,
+      size_t num_partitions,
+      std::vector<std::unique_ptr<Iterator>>* iterators) override;
+
   const Snapshot* GetSnapshot() override;
   void ReleaseSnapshot(const Snapshot* snapshot) override;
 
@@ -431,6 +438,10 @@ class DBImpl : public DB {
                              ColumnFamilyHandle* column_family,
                              const Range* range, int n,
                              uint64_t* sizes) override;
+  Status GetApproximateRangeStats(const SizeApproximationOptions& options,
+                                  ColumnFamilyHandle* column_family,
+                                  const Range* range, int n, uint64_t* sizes,
+                                  uint64_t* counts) override;
   using DB::GetApproximateMemTableStats;
   void GetApproximateMemTableStats(ColumnFamilyHandle* column_family,
                                    const Range& range, uint64_t* const count,
@@ -581,6 +592,9 @@ class DBImpl : public DB {
   Status PromoteL0(ColumnFamilyHandle* column_family,
                    int target_level) override;
 
+  Status WarmupRange(ColumnFamilyHandle* column_family, const Slice* begin,
+                     const Slice* end, const WarmupOptions& options) override;
+
   using DB::IngestExternalFile;
   Status IngestExternalFile(
       ColumnFamilyHandle* column_family,
@@ -608,6 +622,8 @@ class DBImpl : public DB {
 
   using DB::VerifyChecksum;
   Status VerifyChecksum(const ReadOptions& /*read_options*/) override;
+  Status VerifyChecksum(const ReadOptions& /*read_options*/,
+                        int max_threads) override;
   // Verify the checksums of files in db. Currently only tables are checked.
   //
   // read_options: controls file I/O behavior, e.g. read ahead size while
@@ -618,9 +634,11 @@ class DBImpl : public DB {
   //                    with the MANIFEST. Currently, file checksums are
   //                    recomputed by reading all table files.
   //
+  // max_threads: number of files verified at a time.
+  //
   // Returns: OK if there is no file whose file or block checksum mismatches.
   Status VerifyChecksumInternal(const ReadOptions& read_options,
-                                bool use_file_checksum);
+                                bool use_file_checksum, int max_threads);
 
   Status VerifyFullFileChecksum(const std::string& file_checksum_expected,
                                 const std::string& func_name_expected,
@@ -794,6 +812,34 @@ class DBImpl : public DB {
                                  bool* found_record_for_key,
                                  bool* is_blob_index);
 
+  // A key whose latest sequence number is looked up by
+  // GetLatestSequenceForKeys()
+  struct LatestSequenceLookup {
+    LatestSequenceLookup(const Slice& _key, bool _cache_only,
+                         SequenceNumber _lower_bound_seq)
+        : key(_key),
+          cache_only(_cache_only),
+          lower_bound_seq(_lower_bound_seq) {}
+
+    // Arguments of GetLatestSequenceForKey()
+    Slice key;
+    bool cache_only;
+    SequenceNumber lower_bound_seq;
+
+    // Results of GetLatestSequenceForKey()
+    SequenceNumber seq = kMaxSequenceNumber;
+    bool found_record_for_key = false;
+    Status s;
+  };
+
+  // Does GetLatestSequenceForKey() for each of `lookups`, whose keys must be
+  // sorted by the user comparator of the column family of `sv`. The keys not
+  // found in the memtables are looked up together in the SST files with
+  // Version::MultiGet(), sharing the reads of their index, filter and data
+  // blocks. User-defined timestamps are not supported.
+  void GetLatestSequenceForKeys(SuperVersion* sv,
+                                std::vector<LatestSequenceLookup>* lookups);
+
   Status TraceIteratorSeek(const uint32_t& cf_id, const Slice& key,
                            const Slice& lower_bound, const Slice upper_bound);
   Status TraceIteratorSeekForPrev(const uint32_t& cf_id, const Slice& key,
@@ -1177,6 +1223,21 @@ class DBImpl : public DB {
   // Wait for any background purge
   Status TEST_WaitForPurge();
 
+  // Wait for all the queued post-compaction warmup jobs to finish
+  Status TEST_WaitForWarmup();
+
+  // Wait for the restore of the block cache dump scheduled by DB::Open, if
+  // any, to finish. See DBOptions::block_cache_dump_file.
+  void TEST_WaitForBlockCacheRestore();
+
+  // Wait for the warmup from the read hotness scheduled by DB::Open, if any,
+  // to finish. See DBOptions::read_hotness_file.
+  void TEST_WaitForRestartWarmup();
+
+  // Wait for the opening of the table files scheduled by DB::Open, if any, to
+  // finish. See DBOptions::open_table_files_in_background.
+  void TEST_WaitForOpenTableFiles();
+
   // Get the background error status
   Status TEST_GetBGError();
 
@@ -1245,6 +1306,7 @@ class DBImpl : public DB {
 
   int TEST_BGCompactionsAllowed() const;
   int TEST_BGFlushesAllowed() const;
+  int TEST_AutoTuneExtraBackgroundJobs() const;
   size_t TEST_GetWalPreallocateBlockSize(uint64_t write_buffer_size) const;
   void TEST_WaitForPeriodicTaskRun(std::function<void()> callback) const;
   SeqnoToTimeMapping TEST_GetSeqnoToTimeMapping() const;
@@ -1288,6 +1350,13 @@ class DBImpl : public DB {
   // For the background timer job
   void RecordSeqnoToTimeMapping();
 
+  // Adjust the background jobs to the write stalls, see
+  // DBOptions::auto_tune_period_sec
+  void AutoTune();
+
+  // Save the read hotness of the live files, see DBOptions::read_hotness_file
+  void PersistReadHotness();
+
   // REQUIRES: DB mutex held
   std::pair<SequenceNumber, uint64_t> GetSeqnoToTimeSample() const;
 
@@ -1490,6 +1559,21 @@ class DBImpl : public DB {
                               const Slice* begin, const Slice* end,
                               const std::string& trim_ts);
 
+  // Returns the user keys splitting [begin, end] into at most `max_shards`
+  // shards of about the same size in the last non-empty level of `cfd`, or an
+  // empty vector if the range cannot be split.
+  std::vector<std::string> GetCompactRangeShardBoundaries(
+      ColumnFamilyData* cfd, const Slice* begin, const Slice* end,
+      uint32_t max_shards);
+
+  // Compacts each shard of [begin, end] split at `boundaries` concurrently,
+  // with CompactRangeInternal().
+  Status CompactRangeShards(const CompactRangeOptions& options,
+                            ColumnFamilyHandle* column_family,
+                            const Slice* begin, const Slice* end,
+                            const std::vector<std::string>& boundaries,
+                            const std::string& trim_ts);
+
   // The following two functions can only be called when:
   // 1. WriteThread::Writer::EnterUnbatched() is used.
   // 2. db_mutex is NOT held
@@ -1525,6 +1609,13 @@ class DBImpl : public DB {
   Status FlushAllColumnFamilies(const FlushOptions& flush_options,
                                 FlushReason flush_reason);
 
+  // Schedules the flushes of all the column families before waiting for any
+  // of them, so that they run side by side in the flush thread pool instead
+  // of one after another. Used by FlushAllColumnFamilies() on shutdown.
+  // REQUIRES: mutex_ held, atomic_flush off, flush_options.wait
+  Status FlushAllColumnFamiliesInParallel(const FlushOptions& flush_options,
+                                          FlushReason flush_reason);
+
   virtual Status FlushForGetLiveFiles();
 
   void NewThreadStatusCfInfo(ColumnFamilyData* cfd) const;
@@ -2339,6 +2430,11 @@ class DBImpl : public DB {
   // REQUIRES: mutex locked and in write thread.
   Status HandleWriteBufferManagerFlush(WriteContext* write_context);
 
+  // The memory freed by flushing the mutable memtable of `cfd` per expected
+  // cost, see WriteBufferManager::SetCostAwareFlush().
+  // REQUIRES: mutex locked
+  static double MemtableFlushScore(ColumnFamilyData* cfd);
+
   // REQUIRES: mutex locked
   Status PreprocessWrite(const WriteOptions& write_options,
                          WalContext* log_context, WriteContext* write_context);
@@ -2450,12 +2546,18 @@ class DBImpl : public DB {
   static void BGWorkBottomCompaction(void* arg);
   static void BGWorkFlush(void* arg);
   static void BGWorkPurge(void* arg);
+  static void BGWorkBlockCacheRestore(void* arg);
+  static void BGWorkRestartWarmup(void* arg);
+  static void BGWorkOpenTableFiles(void* arg);
   static void UnscheduleCompactionCallback(void* arg);
   static void UnscheduleFlushCallback(void* arg);
   void BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
                                 Env::Priority thread_pri);
   void BackgroundCallFlush(Env::Priority thread_pri);
   void BackgroundCallPurge();
+  void BackgroundCallBlockCacheRestore();
+  void BackgroundCallRestartWarmup();
+  void BackgroundCallOpenTableFiles();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
                               LogBuffer* log_buffer,
                               PrepickedCompaction* prepicked_compaction,
@@ -2564,6 +2666,73 @@ class DBImpl : public DB {
       std::optional<std::shared_ptr<SeqnoToTimeMapping>>
           new_seqno_to_time_mapping = {});
 
+  // Re-allocates the bits per key of the levels of `cfd` if its filter policy
+  // is a LevelAdaptiveBloomFilterPolicy, from its current version.
+  // REQUIRES: mutex held
+  void MaybeUpdateFilterAllocation(ColumnFamilyData* cfd);
+
+  // Hands the output files of compaction `c` over to warmup_scheduler_, to
+  // be warmed from the Version the compaction has just installed, as far as
+  // the column family's compaction_warmup_policy asks for it. In
+  // kHotKeyRanges mode, if `hot_input_key_ranges` is known, only the parts of
+  // the outputs overlapping it are warmed; see
+  // CompactionJob::hot_input_key_ranges().
+  // The files handed over are accounted in `compaction_job_stats`.
+  // REQUIRES: mutex held, `c`'s result installed
+  void MaybeScheduleCompactionWarmup(
+      Compaction* c, int job_id,
+      const std::optional<std::vector<TableReader::HotKeyRange>>&
+          hot_input_key_ranges,
+      CompactionJobStats* compaction_job_stats);
+
+  // Schedules the restore of DBOptions::block_cache_dump_file into the block
+  // caches of the column families, if set, and makes CloseHelper() dump them
+  // to it again. Only called by DB::Open.
+  // REQUIRES: mutex held
+  void MaybeScheduleBlockCacheRestore();
+  // Inserts the blocks of the block cache dump that belong to the live table
+  // files, until the block cache is full.
+  // REQUIRES: mutex not held
+  Status RestoreBlockCache(uint64_t* num_restored, uint64_t* num_skipped);
+  // Schedules the warmup from DBOptions::read_hotness_file, if set, and makes
+  // the periodic task and CloseHelper() save the read hotness to it. Only
+  // called by DB::Open.
+  // REQUIRES: mutex held
+  void MaybeScheduleRestartWarmup();
+  // Restores the sampled reads of the live files saved in the read hotness
+  // file and warms their hot blocks, the most read files first, until
+  // DBOptions::restart_warmup_max_bytes have been read.
+  // REQUIRES: mutex not held
+  Status RestartWarmup(uint64_t* num_files, uint64_t* bytes_read);
+  // Writes the read hotness of the live files to DBOptions::read_hotness_file.
+  // REQUIRES: mutex not held
+  Status WriteReadHotness();
+  // Returns the user keys splitting the range of the iterate bounds of
+  // `read_options` into up to `num_partitions` parts of about the same size,
+  // in key order, see NewParallelScan().
+  // REQUIRES: mutex not held
+  std::vector<std::string> GetParallelScanBoundaries(
+      const ReadOptions& read_options, ColumnFamilyData* cfd,
+      SuperVersion* sv, size_t num_partitions);
+  // Schedules the opening of the table files that DB::Open left unopened, see
+  // DBOptions::open_table_files_in_background. Only called by DB::Open.
+  // REQUIRES: mutex held
+  void MaybeScheduleOpenTableFiles();
+  // Opens the table files of the current versions into the table caches,
+  // until the DB shuts down.
+  // REQUIRES: mutex not held
+  Status OpenTableFiles(uint64_t* num_opened);
+  // Writes the blocks of the live table files that are in the block caches
+  // of the column families to DBOptions::block_cache_dump_file.
+  // REQUIRES: mutex not held, no background work left
+  Status DumpBlockCache();
+  // Refs the column families and their current Versions, or releases them.
+  // REQUIRES: mutex held
+  void RefCurrentVersions(
+      std::vector<std::pair<ColumnFamilyData*, Version*>>* versions);
+  void UnrefVersions(
+      std::vector<std::pair<ColumnFamilyData*, Version*>>* versions);
+
   // A variant of InstallSuperVersionAndScheduleWork() that must be used for
   // new CFs or for changes to mutable_cf_options. This is so that it can
   // update seqno_to_time_mapping cached for the new SuperVersion as relevant.
@@ -2704,6 +2873,16 @@ class DBImpl : public DB {
                          bool extra_sv_ref, SequenceNumber* snapshot,
                          bool* sv_from_thread_local);
 
+  // The part of GetLatestSequenceForKey() checking the memtables, including
+  // memtable history. Returns true with the result in `*s` if the SST files
+  // need not be checked; `*s`, `*merge_context` and
+  // `*max_covering_tombstone_seq` are carried over to Version::Get() otherwise.
+  bool GetLatestSequenceFromMemTables(
+      SuperVersion* sv, const LookupKey& lkey, const ReadOptions& read_options,
+      SequenceNumber lower_bound_seq, Status* s, MergeContext* merge_context,
+      SequenceNumber* max_covering_tombstone_seq, SequenceNumber* seq,
+      std::string* timestamp, bool* found_record_for_key, bool* is_blob_index);
+
   // The actual implementation of the batching MultiGet. The caller is expected
   // to have acquired the SuperVersion and pass in a snapshot sequence number
   // in order to construct the LookupKeys. The start_key and num_keys specify
@@ -2945,6 +3124,10 @@ class DBImpl : public DB {
 
   TrimHistoryScheduler trim_history_scheduler_;
 
+  // Inserts the WAL records into the memtables on multiple threads while
+  // ProcessLogFiles() runs, if max_wal_recovery_threads > 1
+  std::unique_ptr<ParallelWalRecovery> parallel_wal_recovery_;
+
   SnapshotList snapshots_;
 
   TimestampedSnapshotList timestamped_snapshots_;
@@ -3025,6 +3208,23 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_ = 0;
 
+  // number of restores of the block cache dump, submitted to the USER pool
+  int bg_block_cache_restore_scheduled_ = 0;
+
+  // number of warmups from the read hotness file, submitted to the USER pool
+  int bg_restart_warmup_scheduled_ = 0;
+
+  // number of jobs opening the table files, submitted to the USER pool
+  int bg_open_table_files_scheduled_ = 0;
+
+  // Whether CloseHelper() dumps the block caches, see
+  // MaybeScheduleBlockCacheRestore()
+  bool dump_block_cache_on_close_ = false;
+
+  // Whether the read hotness is saved periodically and by CloseHelper(), see
+  // MaybeScheduleRestartWarmup()
+  bool persist_read_hotness_ = false;
+
   std::deque<ManualCompactionState*> manual_compaction_dequeue_;
 
   // shall we disable deletion of obsolete files
@@ -3109,6 +3309,20 @@ class DBImpl : public DB {
   // It contains the implementations for each periodic task.
   std::map<PeriodicTaskType, const PeriodicTaskFunc> periodic_task_functions_;
 
+  // State of AutoTune(), protected by mutex_. Reset whenever
+  // auto_tune_period_sec changes.
+  struct AutoTuneState {
+    // Background jobs allowed on top of max_background_jobs
+    int extra_background_jobs = 0;
+    // What the last run saw, or 0 if there was none
+    uint64_t last_run_micros = 0;
+    uint64_t last_stall_micros = 0;
+    uint64_t last_stall_count = 0;
+    // Runs in a row without write stalls
+    int quiet_runs = 0;
+  };
+  AutoTuneState auto_tune_state_;
+
   // When set, we use a separate queue for writes that don't write to memtable.
   // In 2PC these are the writes at Prepare phase.
   const bool two_write_queues_;
@@ -3150,6 +3364,10 @@ class DBImpl : public DB {
   // installed to MANIFEST first.
   InstrumentedCondVar atomic_flush_install_cv_;
 
+  // Runs the post-compaction block cache warmup jobs in the USER priority
+  // thread pool. See DBOptions::max_background_warmups.
+  WarmupScheduler warmup_scheduler_;
+
   bool wal_in_db_path_;
   std::atomic<uint64_t> max_total_wal_size_;
 
@@ -6,6 +6,7 @@
 // Copyright (c) 2011 The LevelDB Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
+#include <algorithm>
 #include <cinttypes>
 #include <deque>
 
@@ -25,6 +26,7 @@
 #include "rocksdb/io_status.h"
 #include "rocksdb/options.h"
 #include "rocksdb/table.h"
+#include "table/block_based/filter_policy_internal.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 #include "util/coding.h"
@@ -211,8 +213,9 @@ Status DBImpl::FlushMemTableToOutputFile(
       file_options_for_compaction_, versions_.get(), &mutex_, &shutting_down_,
       job_context, flush_reason, log_buffer, directories_.GetDbDir(),
       GetDataDir(cfd, 0U),
-      GetCompressionFlush(cfd->ioptions(), mutable_cf_options), stats_,
-      &event_logger_, mutable_cf_options.report_bg_io_stats,
+      GetCompressionFlush(cfd->ioptions(), mutable_cf_options),
+      cfd->ioptions().stats, &event_logger_,
+      mutable_cf_options.report_bg_io_stats,
       true /* sync_output_directory */, true /* write_manifest */, thread_pri,
       io_tracer_, cfd->GetSuperVersion()->ShareSeqnoToTimeMapping(), db_id_,
       db_session_id_, cfd->GetFullHistoryTsLow(), blob_callback_.get());
@@ -476,8 +479,9 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         max_memtable_id, file_options_for_compaction_, versions_.get(), &mutex_,
         &shutting_down_, job_context, flush_reason, log_buffer,
         directories_.GetDbDir(), data_dir,
-        GetCompressionFlush(cfd->ioptions(), mutable_cf_options), stats_,
-        &event_logger_, mutable_cf_options.report_bg_io_stats,
+        GetCompressionFlush(cfd->ioptions(), mutable_cf_options),
+        cfd->ioptions().stats, &event_logger_,
+        mutable_cf_options.report_bg_io_stats,
         false /* sync_output_directory */, false /* write_manifest */,
         thread_pri, io_tracer_,
         cfd->GetSuperVersion()->ShareSeqnoToTimeMapping(), db_id_,
@@ -1104,6 +1108,19 @@ Status DBImpl::CompactRangeInternal(const CompactRangeOptions& options,
     }
   }
 
+  if (s.ok() && options.max_parallel_shards > 1 &&
+      !options.exclusive_manual_compaction && !options.change_level &&
+      cfd->ioptions().compaction_style == kCompactionStyleLevel) {
+    std::vector<std::string> boundaries = GetCompactRangeShardBoundaries(
+        cfd, begin, end, options.max_parallel_shards);
+    if (!boundaries.empty()) {
+      s = CompactRangeShards(options, column_family, begin, end, boundaries,
+                             trim_ts);
+      LogFlush(immutable_db_options_.info_log);
+      return s;
+    }
+  }
+
   constexpr int kInvalidLevel = -1;
   int final_output_level = kInvalidLevel;
   bool exclusive = options.exclusive_manual_compaction;
@@ -1147,6 +1164,7 @@ Status DBImpl::CompactRangeInternal(const CompactRangeOptions& options,
         // Small lies about compaction range
         context.smallest_user_key = *begin;
         context.largest_user_key = *end;
+        context.comparator = cfd->user_comparator();
         partitioner = partitioner_factory->CreatePartitioner(context);
       }
 
@@ -1518,7 +1536,8 @@ Status DBImpl::CompactFilesImpl(
       file_options_for_compaction_, versions_.get(), &shutting_down_, env_options_,
       log_buffer, directories_.GetDbDir(),
       GetDataDir(c->column_family_data(), c->output_path_id()),
-      GetDataDir(c->column_family_data(), 0), stats_, &mutex_, &error_handler_,
+      GetDataDir(c->column_family_data(), 0),
+      c->column_family_data()->ioptions().stats, &mutex_, &error_handler_,
       job_context, table_cache_, &event_logger_,
       c->mutable_cf_options().paranoid_file_checks,
       c->mutable_cf_options().report_bg_io_stats, dbname_,
@@ -1568,6 +1587,9 @@ Status DBImpl::CompactFilesImpl(
     assert(compaction_job.io_status().ok());
     InstallSuperVersionAndScheduleWork(
         c->column_family_data(), job_context->superversion_contexts.data());
+    MaybeScheduleCompactionWarmup(c.get(), job_context->job_id,
+                                  compaction_job.hot_input_key_ranges(),
+                                  &compaction_job_stats);
   }
   // status above captures any error during compaction_job.Install, so its ok
   // not check compaction_job.io_status() explicitly if we're not calling
@@ -1924,6 +1946,8 @@ Status DBImpl::FlushAllColumnFamilies(const FlushOptions& flush_options,
       status = Status::OK();
     }
     mutex_.Lock();
+  } else if (flush_reason == FlushReason::kShutDown && flush_options.wait) {
+    status = FlushAllColumnFamiliesInParallel(flush_options, flush_reason);
   } else {
     for (auto cfd : versions_->GetRefedColumnFamilySet()) {
       if (cfd->IsDropped()) {
@@ -1944,6 +1968,61 @@ Status DBImpl::FlushAllColumnFamilies(const FlushOptions& flush_options,
   return status;
 }
 
+Status DBImpl::FlushAllColumnFamiliesInParallel(
+    const FlushOptions& flush_options, FlushReason flush_reason) {
+  mutex_.AssertHeld();
+  assert(!immutable_db_options_.atomic_flush);
+  assert(flush_options.wait);
+  FlushOptions schedule_options = flush_options;
+  schedule_options.wait = false;
+  Status status;
+  autovector<ColumnFamilyData*> cfds;
+  autovector<uint64_t> memtable_ids;
+  for (auto cfd : versions_->GetRefedColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    mutex_.Unlock();
+    status = FlushMemTable(cfd, schedule_options, flush_reason);
+    if (status.IsTryAgain()) {
+      // Writes are stopped, so the flush cannot be scheduled without waiting
+      // for it.
+      status = FlushMemTable(cfd, flush_options, flush_reason);
+    }
+    mutex_.Lock();
+    if (status.IsColumnFamilyDropped()) {
+      status = Status::OK();
+      continue;
+    }
+    if (!status.ok()) {
+      break;
+    }
+    cfd->Ref();
+    cfds.push_back(cfd);
+    memtable_ids.push_back(
+        cfd->imm()->GetLatestMemTableID(false /* for_atomic_flush */));
+  }
+  TEST_SYNC_POINT("DBImpl::FlushAllColumnFamiliesInParallel:Scheduled");
+  if (status.ok() && !cfds.empty()) {
+    autovector<const uint64_t*> flush_memtable_ids;
+    for (size_t i = 0; i < memtable_ids.size(); ++i) {
+      flush_memtable_ids.push_back(&memtable_ids[i]);
+    }
+    mutex_.Unlock();
+    status = WaitForFlushMemTables(cfds, flush_memtable_ids,
+                                   false /* resuming_from_bg_err */,
+                                   flush_reason);
+    mutex_.Lock();
+    if (status.IsColumnFamilyDropped()) {
+      status = Status::OK();
+    }
+  }
+  for (auto* cfd : cfds) {
+    cfd->UnrefAndTryDelete();
+  }
+  return status;
+}
+
 Status DBImpl::Flush(const FlushOptions& flush_options,
                      ColumnFamilyHandle* column_family) {
   auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(column_family);
@@ -2006,6 +2085,116 @@ Status DBImpl::Flush(const FlushOptions& flush_options,
   return s;
 }
 
+std::vector<std::string> DBImpl::GetCompactRangeShardBoundaries(
+    ColumnFamilyData* cfd, const Slice* begin, const Slice* end,
+    uint32_t max_shards) {
+  std::vector<std::string> boundaries;
+  SuperVersion* super_version = cfd->GetReferencedSuperVersion(this);
+  const VersionStorageInfo* vstorage = super_version->current->storage_info();
+  const Comparator* ucmp = cfd->user_comparator();
+  const int last_level = vstorage->num_non_empty_levels() - 1;
+  if (last_level > 0) {
+    InternalKey begin_storage, end_storage;
+    if (begin != nullptr) {
+      begin_storage.SetMinPossibleForUserKey(*begin);
+    }
+    if (end != nullptr) {
+      end_storage.SetMaxPossibleForUserKey(*end);
+    }
+    std::vector<FileMetaData*> files;
+    vstorage->GetOverlappingInputs(
+        last_level, begin != nullptr ? &begin_storage : nullptr,
+        end != nullptr ? &end_storage : nullptr, &files);
+    uint64_t total_bytes = 0;
+    for (const FileMetaData* f : files) {
+      total_bytes += f->fd.GetFileSize();
+    }
+    // A shard ends at the file boundary nearest to each multiple of
+    // total_bytes / max_shards
+    uint64_t bytes = 0;
+    for (size_t i = 0; total_bytes > 0 && i + 1 < files.size(); i++) {
+      bytes += files[i]->fd.GetFileSize();
+      if (static_cast<double>(bytes) / static_cast<double>(total_bytes) *
+              max_shards <
+          static_cast<double>(boundaries.size()) + 0.5) {
+        continue;
+      }
+      Slice boundary = files[i + 1]->smallest.user_key();
+      if ((begin != nullptr && ucmp->Compare(boundary, *begin) <= 0) ||
+          (end != nullptr && ucmp->Compare(boundary, *end) >= 0) ||
+          (!boundaries.empty() && ucmp->Compare(boundary, boundaries.back()) <=
+                                      0)) {
+        continue;
+      }
+      boundaries.push_back(boundary.ToString());
+      if (boundaries.size() + 1 == max_shards) {
+        break;
+      }
+    }
+  }
+  CleanupSuperVersion(super_version);
+  return boundaries;
+}
+
+Status DBImpl::CompactRangeShards(const CompactRangeOptions& options,
+                                  ColumnFamilyHandle* column_family,
+                                  const Slice* begin, const Slice* end,
+                                  const std::vector<std::string>& boundaries,
+                                  const std::string& trim_ts) {
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(column_family)
+                 ->cfd();
+  const size_t num_shards = boundaries.size() + 1;
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "[%s] Manual compaction split into %" ROCKSDB_PRIszt
+                 " shards",
+                 cfd->GetName().c_str(), num_shards);
+
+  CompactRangeOptions shard_options = options;
+  shard_options.max_parallel_shards = 0;
+  // Already applied to the whole column family
+  shard_options.full_history_ts_low = nullptr;
+  std::vector<Slice> boundary_slices(boundaries.begin(), boundaries.end());
+  std::vector<Status> statuses(num_shards);
+  std::atomic<size_t> num_done{0};
+  auto compact_shard = [&](size_t shard) {
+    // The shards share their boundary keys, as the range of CompactRange() is
+    // inclusive
+    const Slice* shard_begin =
+        shard == 0 ? begin : &boundary_slices[shard - 1];
+    const Slice* shard_end =
+        shard + 1 == num_shards ? end : &boundary_slices[shard];
+    statuses[shard] = CompactRangeInternal(shard_options, column_family,
+                                           shard_begin, shard_end, trim_ts);
+    size_t done = num_done.fetch_add(1) + 1;
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "[%s] Manual compaction shard %" ROCKSDB_PRIszt
+                   " finished (%" ROCKSDB_PRIszt " of %" ROCKSDB_PRIszt
+                   " done): %s",
+                   cfd->GetName().c_str(), shard, done, num_shards,
+                   statuses[shard].ToString().c_str());
+    if (options.completed_shards != nullptr) {
+      options.completed_shards->fetch_add(1);
+    }
+  };
+
+  std::vector<port::Thread> threads;
+  threads.reserve(num_shards - 1);
+  for (size_t shard = 1; shard < num_shards; shard++) {
+    threads.emplace_back(compact_shard, shard);
+  }
+  compact_shard(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const Status& s : statuses) {
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
 Status DBImpl::RunManualCompaction(
     ColumnFamilyData* cfd, int input_level, int output_level,
     const CompactRangeOptions& compact_range_options, const Slice* begin,
@@ -2920,7 +3109,8 @@ DBImpl::BGJobLimits DBImpl::GetBGJobLimits() const {
   mutex_.AssertHeld();
   return GetBGJobLimits(mutable_db_options_.max_background_flushes,
                         mutable_db_options_.max_background_compactions,
-                        mutable_db_options_.max_background_jobs,
+                        mutable_db_options_.max_background_jobs +
+                            auto_tune_state_.extra_background_jobs,
                         write_controller_.NeedSpeedupCompaction());
 }
 
@@ -2986,6 +3176,19 @@ ColumnFamilyData* DBImpl::PickCompactionFromQueue(
     std::unique_ptr<TaskLimiterToken>* token, LogBuffer* log_buffer) {
   assert(!compaction_queue_.empty());
   assert(*token == nullptr);
+  if (immutable_db_options_.prioritize_compactions_by_read_amp) {
+    // Stable, so that the column families that are equally worth compacting
+    // are still picked in the order they were queued
+    std::stable_sort(compaction_queue_.begin(), compaction_queue_.end(),
+                     [](ColumnFamilyData* a, ColumnFamilyData* b) {
+                       return a->current()
+                                  ->storage_info()
+                                  ->read_amp_reduction_per_byte() >
+                              b->current()
+                                  ->storage_info()
+                                  ->read_amp_reduction_per_byte();
+                     });
+  }
   autovector<ColumnFamilyData*> throttled_candidates;
   ColumnFamilyData* cfd = nullptr;
   while (!compaction_queue_.empty()) {
@@ -4144,8 +4347,9 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
         mutable_db_options_, file_options_for_compaction_, versions_.get(),
         &shutting_down_, env_options_, log_buffer, directories_.GetDbDir(),
         GetDataDir(c->column_family_data(), c->output_path_id()),
-        GetDataDir(c->column_family_data(), 0), stats_, &mutex_,
-        &error_handler_, job_context, table_cache_, &event_logger_,
+        GetDataDir(c->column_family_data(), 0),
+        c->column_family_data()->ioptions().stats, &mutex_, &error_handler_,
+        job_context, table_cache_, &event_logger_,
         c->mutable_cf_options().paranoid_file_checks,
         c->mutable_cf_options().report_bg_io_stats, dbname_,
         &compaction_job_stats, thread_pri, io_tracer_,
@@ -4181,8 +4385,16 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     status = compaction_job.Install(&compaction_released);
     io_s = compaction_job.io_status();
     if (status.ok()) {
+      // Before the write stall conditions are recalculated with the new
+      // version
+      write_controller_.RecordDrainedBytes(
+          compaction_job_stats.total_input_bytes,
+          compaction_job_stats.elapsed_micros, num_running_compactions_);
       InstallSuperVersionAndScheduleWork(
           c->column_family_data(), job_context->superversion_contexts.data());
+      MaybeScheduleCompactionWarmup(c.get(), job_context->job_id,
+                                    compaction_job.hot_input_key_ranges(),
+                                    &compaction_job_stats);
     }
     *made_progress = true;
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
@@ -4490,6 +4702,138 @@ void DBImpl::BuildCompactionJobInfo(
   }
 }
 
+void DBImpl::MaybeScheduleCompactionWarmup(
+    Compaction* c, int job_id,
+    const std::optional<std::vector<TableReader::HotKeyRange>>&
+        hot_input_key_ranges,
+    CompactionJobStats* compaction_job_stats) {
+  mutex_.AssertHeld();
+  if (!warmup_scheduler_.enabled()) {
+    return;
+  }
+  const CompactionWarmupMode mode = c->OutputWarmupMode();
+  if (mode == CompactionWarmupMode::kDisabled) {
+    return;
+  }
+  if (mode == CompactionWarmupMode::kHotKeyRanges &&
+      hot_input_key_ranges.has_value() && hot_input_key_ranges->empty()) {
+    // Nothing the compaction read from was hot.
+    return;
+  }
+  ColumnFamilyData* cfd = c->column_family_data();
+  const InternalKeyComparator& icmp = cfd->internal_comparator();
+  // Warm the files produced by the compaction rather than the key range of
+  // its inputs: the inputs are obsolete once the result is installed, and
+  // the other files overlapping that range were not touched by it.
+  WarmupJob job;
+  uint64_t total_bytes = 0;
+  for (const auto& new_file : c->edit()->GetNewFiles()) {
+    const FileMetaData& f = new_file.second;
+    total_bytes += f.fd.GetFileSize();
+    const bool first = job.target_files.empty();
+    if (first || icmp.Compare(f.smallest, job.smallest) < 0) {
+      job.smallest = f.smallest;
+    }
+    if (first || icmp.Compare(f.largest, job.largest) > 0) {
+      job.largest = f.largest;
+    }
+    job.target_files.push_back(f.fd.GetNumber());
+  }
+  if (job.target_files.empty()) {
+    return;
+  }
+  job.cfd = cfd;
+  job.version = cfd->current();
+  job.job_id = job_id;
+  if (mode == CompactionWarmupMode::kHotKeyRanges &&
+      hot_input_key_ranges.has_value()) {
+    job.hot_ranges = *hot_input_key_ranges;
+  }
+  const CompactionWarmupPolicy& policy =
+      c->mutable_cf_options().compaction_warmup_policy;
+  job.max_bytes = policy.max_bytes_per_compaction;
+  job.stop_at_cache_capacity = policy.stop_at_cache_capacity;
+  job.index_and_filter_partitions = policy.warm_index_and_filter_partitions;
+  job.to_secondary_cache = policy.secondary_cache_min_output_level >= 0 &&
+                           c->output_level() >=
+                               policy.secondary_cache_min_output_level;
+  const size_t num_files = job.target_files.size();
+  if (warmup_scheduler_.Schedule(std::move(job)) &&
+      compaction_job_stats != nullptr) {
+    compaction_job_stats->num_warmup_output_files += num_files;
+    compaction_job_stats->total_warmup_output_bytes += total_bytes;
+  }
+}
+
+Status DBImpl::WarmupRange(ColumnFamilyHandle* column_family,
+                           const Slice* begin, const Slice* end,
+                           const WarmupOptions& options) {
+  auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(column_family);
+  ColumnFamilyData* cfd = cfh->cfd();
+  if (begin != nullptr && end != nullptr &&
+      cfd->user_comparator()->CompareWithoutTimestamp(*begin, *end) > 0) {
+    return Status::InvalidArgument("Invalid warmup range: begin after end");
+  }
+  if (!options.wait && !warmup_scheduler_.enabled()) {
+    return Status::NotSupported(
+        "Background warmups are disabled, see max_background_warmups");
+  }
+
+  WarmupJob job;
+  job.cfd = cfd;
+  job.job_id = next_job_id_.fetch_add(1);
+  job.max_bytes = options.max_bytes;
+  job.stop_at_cache_capacity = options.stop_at_cache_capacity;
+  job.index_and_filter_partitions = options.index_and_filter_partitions;
+  job.data_blocks = options.data_blocks;
+  job.low_priority = options.low_priority;
+  job.rate_limiter_priority = options.rate_limiter_priority;
+  job.progress_callback = options.progress_callback;
+
+  InstrumentedMutexLock l(&mutex_);
+  Version* current = cfd->current();
+  // An unbounded side of the range is bounded by the files of the Version.
+  const InternalKeyComparator& icmp = cfd->internal_comparator();
+  const VersionStorageInfo* vstorage = current->storage_info();
+  bool has_files = false;
+  for (int level = 0; level < vstorage->num_non_empty_levels(); level++) {
+    for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+      if (!has_files || icmp.Compare(f->smallest, job.smallest) < 0) {
+        job.smallest = f->smallest;
+      }
+      if (!has_files || icmp.Compare(f->largest, job.largest) > 0) {
+        job.largest = f->largest;
+      }
+      has_files = true;
+    }
+  }
+  if (!has_files) {
+    return Status::OK();
+  }
+  if (begin != nullptr) {
+    job.smallest.SetMinPossibleForUserKey(*begin);
+  }
+  if (end != nullptr) {
+    job.largest.SetMaxPossibleForUserKey(*end);
+  }
+  job.version = current;
+
+  if (!options.wait) {
+    if (!warmup_scheduler_.Schedule(std::move(job))) {
+      return Status::ShutdownInProgress();
+    }
+    return Status::OK();
+  }
+  cfd->Ref();
+  current->Ref();
+  mutex_.Unlock();
+  Status s = warmup_scheduler_.Run(job);
+  mutex_.Lock();
+  current->Unref();
+  cfd->UnrefAndTryDelete();
+  return s;
+}
+
 // SuperVersionContext gets created and destructed outside of the lock --
 // we use this conveniently to:
 // * malloc one SuperVersion() outside of the lock -- new_superversion
@@ -4502,6 +4846,29 @@ void DBImpl::BuildCompactionJobInfo(
 // new SuperVersion() inside of the mutex. We do similar thing
 // for superversion_to_free
 
+void DBImpl::MaybeUpdateFilterAllocation(ColumnFamilyData* cfd) {
+  mutex_.AssertHeld();
+  const auto* table_options =
+      cfd->GetLatestMutableCFOptions()
+          .table_factory->GetOptions<BlockBasedTableOptions>();
+  if (table_options == nullptr || table_options->filter_policy == nullptr) {
+    return;
+  }
+  const auto* policy = table_options->filter_policy
+                           ->CheckedCast<LevelAdaptiveBloomFilterPolicy>();
+  if (policy == nullptr) {
+    return;
+  }
+  const VersionStorageInfo* vstorage = cfd->current()->storage_info();
+  std::vector<uint64_t> level_bytes(vstorage->num_levels());
+  std::vector<uint64_t> level_probes(vstorage->num_levels());
+  for (int level = 0; level < vstorage->num_levels(); level++) {
+    level_bytes[level] = vstorage->NumLevelBytes(level);
+    level_probes[level] = cfd->internal_stats()->GetSampledFileProbes(level);
+  }
+  policy->UpdateLevels(cfd->GetName(), level_bytes, level_probes);
+}
+
 void DBImpl::InstallSuperVersionAndScheduleWork(
     ColumnFamilyData* cfd, SuperVersionContext* sv_context,
     std::optional<std::shared_ptr<SeqnoToTimeMapping>>
@@ -4522,6 +4889,7 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
   }
   cfd->InstallSuperVersion(sv_context, &mutex_,
                            std::move(new_seqno_to_time_mapping));
+  MaybeUpdateFilterAllocation(cfd);
 
   // There may be a small data race here. The snapshot tricking bottommost
   // compaction may already be released here. But assuming there will always be
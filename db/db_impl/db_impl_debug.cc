@@ -9,6 +9,7 @@
 #ifndef NDEBUG
 #include <iostream>
 
+#include "cache/cache_helpers.h"
 #include "db/blob/blob_file_cache.h"
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
@@ -196,6 +197,33 @@ Status DBImpl::TEST_WaitForPurge() {
   return error_handler_.GetBGError();
 }
 
+Status DBImpl::TEST_WaitForWarmup() {
+  InstrumentedMutexLock l(&mutex_);
+  warmup_scheduler_.WaitForIdle();
+  return Status::OK();
+}
+
+void DBImpl::TEST_WaitForBlockCacheRestore() {
+  InstrumentedMutexLock l(&mutex_);
+  while (bg_block_cache_restore_scheduled_) {
+    bg_cv_.Wait();
+  }
+}
+
+void DBImpl::TEST_WaitForRestartWarmup() {
+  InstrumentedMutexLock l(&mutex_);
+  while (bg_restart_warmup_scheduled_) {
+    bg_cv_.Wait();
+  }
+}
+
+void DBImpl::TEST_WaitForOpenTableFiles() {
+  InstrumentedMutexLock l(&mutex_);
+  while (bg_open_table_files_scheduled_) {
+    bg_cv_.Wait();
+  }
+}
+
 Status DBImpl::TEST_GetBGError() {
   InstrumentedMutexLock l(&mutex_);
   return error_handler_.GetBGError();
@@ -282,6 +310,11 @@ int DBImpl::TEST_BGFlushesAllowed() const {
   return GetBGJobLimits().max_flushes;
 }
 
+int DBImpl::TEST_AutoTuneExtraBackgroundJobs() const {
+  InstrumentedMutexLock l(&mutex_);
+  return auto_tune_state_.extra_background_jobs;
+}
+
 SequenceNumber DBImpl::TEST_GetLastVisibleSequence() const {
   if (last_seq_same_as_publish_seq_) {
     return versions_->LastSequence();
@@ -376,7 +409,7 @@ void DBImpl::TEST_VerifyNoObsoleteFilesCached(
   auto fn = [&live_and_quar_files](const Slice& key, Cache::ObjectPtr, size_t,
                                    const Cache::CacheItemHelper*) {
     // See TableCache and BlobFileCache
-    assert(key.size() == sizeof(uint64_t));
+    assert(key.size() == sizeof(FileNumberCacheKey));
     uint64_t file_number;
     GetUnaligned(reinterpret_cast<const uint64_t*>(key.data()), &file_number);
     // Assert file is in live/quarantined set
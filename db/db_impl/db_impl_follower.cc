@@ -222,6 +222,12 @@ void DBImplFollower::PeriodicRefresh() {
   }
 }
 
+Status DBImplFollower::TryCatchUpWithPrimary() {
+  // Serialized with the periodic refresh, which holds mu_ while catching up
+  MutexLock l(&mu_);
+  return TryCatchUpWithLeader();
+}
+
 Status DBImplFollower::Close() {
   if (catch_up_thread_) {
     stop_requested_.store(true);
@@ -23,6 +23,11 @@ class DBImplFollower : public DBImplSecondary {
 
   Status Close() override;
 
+  // Catch up with the leader now rather than at the next periodic refresh,
+  // e.g. when notified by an EventListener of the leader that its MANIFEST
+  // has changed.
+  Status TryCatchUpWithPrimary() override;
+
  protected:
   bool OwnTablesAndLogs() const override {
     // TODO: Change this to true once we've properly implemented file
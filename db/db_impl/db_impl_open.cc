@@ -81,6 +81,19 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src,
                                            Env::Priority::LOW);
   result.env->IncBackgroundThreadsIfNeeded(bg_job_limits.max_flushes,
                                            Env::Priority::HIGH);
+  if (result.max_background_warmups < 0) {
+    result.max_background_warmups = 0;
+  }
+  // Plus one for restoring the dumped block cache contents, one for the
+  // warmup from the read hotness and one for opening the table files, if any
+  const int max_user_jobs = result.max_background_warmups +
+                            (result.block_cache_dump_file.empty() ? 0 : 1) +
+                            (result.read_hotness_file.empty() ? 0 : 1) +
+                            (result.open_table_files_in_background ? 1 : 0);
+  if (max_user_jobs > 0) {
+    result.env->IncBackgroundThreadsIfNeeded(max_user_jobs,
+                                             Env::Priority::USER);
+  }
 
   if (result.rate_limiter.get() != nullptr) {
     if (result.bytes_per_sync == 0) {
@@ -1202,6 +1215,19 @@ Status DBImpl::ProcessLogFiles(
   uint64_t corrupted_wal_number = kMaxSequenceNumber;
   PredecessorWALInfo predecessor_wal_info;
 
+  // Two phase commit and unordered writes need the records of a transaction
+  // to be applied in order over all column families
+  int wal_recovery_threads =
+      std::min(immutable_db_options_.max_wal_recovery_threads,
+               static_cast<int>(
+                   versions_->GetColumnFamilySet()->NumberOfColumnFamilies()));
+  if (wal_recovery_threads > 1 && !allow_2pc() && !seq_per_batch_ &&
+      batch_per_txn_) {
+    parallel_wal_recovery_.reset(new ParallelWalRecovery(
+        this, versions_->GetColumnFamilySet(), &flush_scheduler_,
+        &trim_history_scheduler_, wal_recovery_threads));
+  }
+
   for (auto wal_number : wal_numbers) {
     // Detecting early break on the next iteration after `wal_number` has been
     // advanced since this `wal_number` doesn't affect follow-up handling after
@@ -1222,6 +1248,7 @@ Status DBImpl::ProcessLogFiles(
                                                   *next_sequence);
     }
   }
+  parallel_wal_recovery_.reset();
 
   if (status.ok()) {
     status = MaybeHandleStopReplayForCorruptionForInconsistency(
@@ -1348,6 +1375,22 @@ Status DBImpl::ProcessLogFile(
     }
   }
 
+  if (parallel_wal_recovery_ != nullptr) {
+    // The insertion errors of the records replayed in parallel are only
+    // known now, and treated like those of ProcessLogRecord()
+    Status insert_status = parallel_wal_recovery_->Wait();
+    MaybeIgnoreError(&insert_status);
+    if (!insert_status.ok()) {
+      reporter.Corruption(0, insert_status);
+    }
+    Status flush_status = MaybeWriteLevel0TableForRecovery(
+        /*has_valid_writes=*/true, read_only, wal_number, job_id,
+        next_sequence, version_edits, flushed);
+    if (!flush_status.ok()) {
+      return flush_status;
+    }
+  }
+
   ROCKS_LOG_INFO(immutable_db_options_.info_log,
                  "Recovered to log #%" PRIu64 " next seq #%" PRIu64, wal_number,
                  *next_sequence);
@@ -1587,6 +1630,24 @@ Status DBImpl::InsertLogRecordToMemtable(WriteBatch* batch_to_use,
   // That's why we set ignore missing column families to true
   assert(batch_to_use);
   assert(has_valid_writes);
+  if (parallel_wal_recovery_ != nullptr) {
+    if (!batch_to_use->HasBeginPrepare() && !batch_to_use->HasEndPrepare() &&
+        !batch_to_use->HasCommit() && !batch_to_use->HasRollback()) {
+      // Every entry consumes a sequence number, whether its column family is
+      // found or not
+      uint32_t count = WriteBatchInternal::Count(batch_to_use);
+      *next_sequence = WriteBatchInternal::Sequence(batch_to_use) + count;
+      *has_valid_writes = count > 0;
+      parallel_wal_recovery_->Add(
+          std::make_shared<WriteBatch>(std::move(*batch_to_use)), wal_number);
+      return Status::OK();
+    }
+    // Transaction markers are applied in order with everything before them
+    Status status = parallel_wal_recovery_->Wait();
+    if (!status.ok()) {
+      return status;
+    }
+  }
   Status status = WriteBatchInternal::InsertInto(
       batch_to_use, column_family_memtables_.get(), &flush_scheduler_,
       &trim_history_scheduler_, true, wal_number, this,
@@ -1605,6 +1666,13 @@ Status DBImpl::MaybeWriteLevel0TableForRecovery(
 
   Status status;
   if (has_valid_writes && !read_only) {
+    if (parallel_wal_recovery_ != nullptr) {
+      if (flush_scheduler_.Empty()) {
+        return status;
+      }
+      // Nothing may be inserted into the memtables being flushed
+      parallel_wal_recovery_->Drain();
+    }
     // we can do this because this is called before client has access to the
     // DB and there is only a single thread operating on DB
     ColumnFamilyData* cfd;
@@ -2361,7 +2429,9 @@ IOStatus DBImpl::CreateWAL(const WriteOptions& write_options,
                                immutable_db_options_.recycle_log_file_num > 0,
                                immutable_db_options_.manual_wal_flush,
                                immutable_db_options_.wal_compression,
-                               immutable_db_options_.track_and_verify_wals);
+                               immutable_db_options_.track_and_verify_wals,
+                               immutable_db_options_
+                                   .wal_compression_pipeline_min_record_size);
     io_s = (*new_log)->AddCompressionTypeRecord(write_options);
     if (io_s.ok()) {
       io_s = (*new_log)->MaybeAddPredecessorWALInfo(write_options,
@@ -2666,6 +2736,9 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
     impl->DeleteObsoleteFiles();
     TEST_SYNC_POINT("DBImpl::Open:AfterDeleteFiles");
     impl->MaybeScheduleFlushOrCompaction();
+    impl->MaybeScheduleBlockCacheRestore();
+    impl->MaybeScheduleRestartWarmup();
+    impl->MaybeScheduleOpenTableFiles();
     impl->mutex_.Unlock();
   }
 
@@ -13,7 +13,9 @@
 #include "db/event_helpers.h"
 #include "logging/logging.h"
 #include "memtable/wbwi_memtable.h"
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_context_sampler.h"
 #include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
@@ -492,6 +494,14 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   assert(!WriteBatchInternal::IsLatestPersistentState(my_batch) ||
          disable_memtable);
 
+  OperationTraceGuard op_trace(
+      immutable_db_options_.slow_operation_threshold_micros,
+      immutable_db_options_.clock, immutable_db_options_.listeners,
+      SlowOperationType::kWrite);
+  PerfContextSampler perf_sampler(
+      immutable_db_options_.perf_context_sample_rate, stats_,
+      PerfSampledOp::kWrite);
+
   if (write_options.low_pri) {
     Status s = ThrottleLowPriWritesIfNeeded(write_options, my_batch);
     if (!s.ok()) {
@@ -559,6 +569,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     if (w.ShouldWriteToMemtable()) {
       PERF_TIMER_STOP(write_pre_and_post_process_time);
       PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
+      OPERATION_SPAN_GUARD(MemTableInsert);
 
       ColumnFamilyMemTablesImpl column_family_memtables(
           versions_->GetColumnFamilySet());
@@ -764,6 +775,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         assert(wal_context.wal_file_number_size);
         wal_context.prev_size = wal_context.writer->file()->GetFileSize();
         PERF_TIMER_GUARD(write_wal_time);
+        OPERATION_SPAN_GUARD(WALWrite);
         io_s = WriteGroupToWAL(write_group, wal_context.writer, wal_used,
                                wal_context.need_wal_sync,
                                wal_context.need_wal_dir_sync, last_sequence + 1,
@@ -772,6 +784,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     } else {
       if (status.ok() && !write_options.disableWAL) {
         PERF_TIMER_GUARD(write_wal_time);
+        OPERATION_SPAN_GUARD(WALWrite);
         // LastAllocatedSequence is increased inside WriteToWAL under
         // wal_write_mutex_ to ensure ordered events in WAL
         io_s = ConcurrentWriteGroupToWAL(write_group, wal_used, &last_sequence,
@@ -849,6 +862,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
 
     if (status.ok()) {
       PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
+      OPERATION_SPAN_GUARD(MemTableInsert);
 
       if (!parallel) {
         // w.sequence will be set inside InsertInto
@@ -1054,6 +1068,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
 
     if (w.status.ok() && !write_options.disableWAL) {
       PERF_TIMER_GUARD(write_wal_time);
+      OPERATION_SPAN_GUARD(WALWrite);
       stats->AddDBStats(InternalStats::kIntStatsWriteDoneBySelf, 1);
       RecordTick(stats_, WRITE_DONE_BY_SELF, 1);
       if (wal_write_group.size > 1) {
@@ -1105,6 +1120,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
 
   if (w.state == WriteThread::STATE_MEMTABLE_WRITER_LEADER) {
     PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
+    OPERATION_SPAN_GUARD(MemTableInsert);
     assert(w.ShouldWriteToMemtable());
     write_thread_.EnterAsMemTableWriter(&w, &memtable_write_group);
     if (memtable_write_group.size > 1 &&
@@ -1135,6 +1151,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
     PERF_TIMER_STOP(write_pre_and_post_process_time);
     PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
+    OPERATION_SPAN_GUARD(MemTableInsert);
 
     assert(w.ShouldWriteToMemtable());
     ColumnFamilyMemTablesImpl column_family_memtables(
@@ -1187,6 +1204,7 @@ Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
 
     PERF_TIMER_STOP(write_pre_and_post_process_time);
     PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
+    OPERATION_SPAN_GUARD(MemTableInsert);
 
     ColumnFamilyMemTablesImpl column_family_memtables(
         versions_->GetColumnFamilySet());
@@ -1271,6 +1289,7 @@ Status DBImpl::WriteImplWALOnly(
   } else {
     PERF_TIMER_STOP(write_pre_and_post_process_time);
     PERF_TIMER_FOR_WAIT_GUARD(write_delay_time);
+    OPERATION_SPAN_GUARD(WriteStall);
     InstrumentedMutexLock lock(&mutex_);
     Status status =
         DelayWrite(/*num_bytes=*/0ull, *write_thread, write_options);
@@ -1341,6 +1360,7 @@ Status DBImpl::WriteImplWALOnly(
   PERF_TIMER_STOP(write_pre_and_post_process_time);
 
   PERF_TIMER_GUARD(write_wal_time);
+  OPERATION_SPAN_GUARD(WALWrite);
   // LastAllocatedSequence is increased inside WriteToWAL under
   // wal_write_mutex_ to ensure ordered events in WAL
   size_t seq_inc = 0 /* total_count */;
@@ -1547,6 +1567,7 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
                                write_controller_.NeedsDelay()))) {
     PERF_TIMER_STOP(write_pre_and_post_process_time);
     PERF_TIMER_FOR_WAIT_GUARD(write_delay_time);
+    OPERATION_SPAN_GUARD(WriteStall);
     // We don't know size of curent batch so that we always use the size
     // for previous one. It might create a fairness issue that expiration
     // might happen for smaller writes but larger writes can go through.
@@ -2111,11 +2132,31 @@ Status DBImpl::HandleWriteBufferManagerFlush(WriteContext* write_context) {
   // no need to refcount because drop is happening in write thread, so can't
   // happen while we're in the write thread
   autovector<ColumnFamilyData*> cfds;
+  const bool cost_aware = write_buffer_manager_->cost_aware_flush();
+  size_t mutable_memory = 0;
+  if (cost_aware) {
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (!cfd->IsDropped()) {
+        mutable_memory += cfd->mem()->ApproximateMemoryUsageFast();
+      }
+    }
+  }
   if (immutable_db_options_.atomic_flush) {
     SelectColumnFamiliesForAtomicFlush(&cfds);
+    if (cost_aware) {
+      double score = 0;
+      for (auto cfd : cfds) {
+        score += MemtableFlushScore(cfd);
+      }
+      if (!write_buffer_manager_->PickFlushVictim(this, mutable_memory,
+                                                  score)) {
+        cfds.clear();
+      }
+    }
   } else {
     ColumnFamilyData* cfd_picked = nullptr;
     SequenceNumber seq_num_for_cf_picked = kMaxSequenceNumber;
+    double score_for_cf_picked = 0;
 
     for (auto cfd : *versions_->GetColumnFamilySet()) {
       if (cfd->IsDropped()) {
@@ -2126,13 +2167,27 @@ Status DBImpl::HandleWriteBufferManagerFlush(WriteContext* write_context) {
         // and no immutable memtables for which flush has yet to finish. If
         // we triggered flush on CFs already trying to flush, we would risk
         // creating too many immutable memtables leading to write stalls.
-        uint64_t seq = cfd->mem()->GetCreationSeq();
-        if (cfd_picked == nullptr || seq < seq_num_for_cf_picked) {
-          cfd_picked = cfd;
-          seq_num_for_cf_picked = seq;
+        if (cost_aware) {
+          const double score = MemtableFlushScore(cfd);
+          if (cfd_picked == nullptr || score > score_for_cf_picked) {
+            cfd_picked = cfd;
+            score_for_cf_picked = score;
+          }
+        } else {
+          uint64_t seq = cfd->mem()->GetCreationSeq();
+          if (cfd_picked == nullptr || seq < seq_num_for_cf_picked) {
+            cfd_picked = cfd;
+            seq_num_for_cf_picked = seq;
+          }
         }
       }
     }
+    if (cost_aware && !write_buffer_manager_->PickFlushVictim(
+                          this, mutable_memory, score_for_cf_picked)) {
+      // Left to the other DBs sharing the write buffer manager
+      TEST_SYNC_POINT("DBImpl::HandleWriteBufferManagerFlush:PassedOver");
+      cfd_picked = nullptr;
+    }
     if (cfd_picked != nullptr) {
       cfds.push_back(cfd_picked);
     }
@@ -2190,6 +2245,16 @@ Status DBImpl::HandleWriteBufferManagerFlush(WriteContext* write_context) {
   return status;
 }
 
+double DBImpl::MemtableFlushScore(ColumnFamilyData* cfd) {
+  // Each flush adds an L0 file, and the more L0 files there are for the
+  // compaction trigger, the sooner it costs an L0 compaction or a stall.
+  const int trigger = std::max(
+      1, cfd->GetCurrentMutableCFOptions().level0_file_num_compaction_trigger);
+  const int l0_files = cfd->current()->storage_info()->NumLevelFiles(0);
+  return static_cast<double>(cfd->mem()->ApproximateMemoryUsageFast()) /
+         (1.0 + static_cast<double>(l0_files) / trigger);
+}
+
 uint64_t DBImpl::GetMaxTotalWalSize() const {
   uint64_t max_total_wal_size =
       max_total_wal_size_.load(std::memory_order_acquire);
@@ -2348,6 +2413,7 @@ Status DBImpl::ThrottleLowPriWritesIfNeeded(const WriteOptions& write_options,
       // a chance to run. Now we guarantee we are still slowly making
       // progress.
       PERF_TIMER_FOR_WAIT_GUARD(write_delay_time);
+      OPERATION_SPAN_GUARD(WriteStall);
       auto data_size = my_batch->GetDataSize();
       while (data_size > 0) {
         size_t allowed = write_controller_.low_pri_rate_limiter()->RequestToken(
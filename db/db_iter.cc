@@ -12,6 +12,7 @@
 #include <limits>
 #include <string>
 
+#include "db/blob/blob_index.h"
 #include "db/dbformat.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
@@ -21,7 +22,9 @@
 #include "file/filename.h"
 #include "logging/logging.h"
 #include "memory/arena.h"
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_context_sampler.h"
 #include "rocksdb/env.h"
 #include "rocksdb/iterator.h"
 #include "rocksdb/merge_operator.h"
@@ -52,10 +55,14 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
       iter_(iter),
       blob_reader_(version, read_options.read_tier,
                    read_options.verify_checksums, read_options.fill_cache,
-                   read_options.io_activity),
+                   read_options.io_activity, read_options.readahead_size),
       read_callback_(read_callback),
       sequence_(s),
       statistics_(ioptions.stats),
+      perf_context_sample_rate_(ioptions.perf_context_sample_rate),
+      slow_operation_threshold_micros_(
+          ioptions.slow_operation_threshold_micros),
+      listeners_(ioptions.listeners),
       max_skip_(mutable_cf_options.max_sequential_skip_in_iterations),
       max_skippable_internal_keys_(read_options.max_skippable_internal_keys),
       num_internal_keys_skipped_(0),
@@ -83,6 +90,7 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
                                      read_options.auto_prefix_mode),
       expose_blob_index_(expose_blob_index),
       allow_unprepared_value_(read_options.allow_unprepared_value),
+      column_projection_(read_options.column_projection),
       is_blob_(false),
       arena_mode_(arena_mode) {
   RecordTick(statistics_, NO_ITERATOR_CREATED);
@@ -225,6 +233,14 @@ Status DBIter::BlobReader::RetrieveAndSetBlobValue(const Slice& user_key,
     return Status::Corruption("Encountered unexpected blob index.");
   }
 
+  BlobIndex blob_index_entry;
+  {
+    const Status s = blob_index_entry.DecodeFrom(blob_index);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
   // TODO: consider moving ReadOptions from ArenaWrappedDBIter to DBIter to
   // avoid having to copy options back and forth.
   // TODO: plumb Env::IOPriority
@@ -233,11 +249,15 @@ Status DBIter::BlobReader::RetrieveAndSetBlobValue(const Slice& user_key,
   read_options.verify_checksums = verify_checksums_;
   read_options.fill_cache = fill_cache_;
   read_options.io_activity = io_activity_;
-  constexpr FilePrefetchBuffer* prefetch_buffer = nullptr;
+  FilePrefetchBuffer* const prefetch_buffer =
+      (read_tier_ == kBlockCacheTier || blob_index_entry.IsInlined())
+          ? nullptr
+          : GetPrefetchBuffer(blob_index_entry.file_number());
   constexpr uint64_t* bytes_read = nullptr;
 
-  const Status s = version_->GetBlob(read_options, user_key, blob_index,
-                                     prefetch_buffer, &blob_value_, bytes_read);
+  const Status s =
+      version_->GetBlob(read_options, user_key, blob_index_entry,
+                        prefetch_buffer, &blob_value_, bytes_read);
 
   if (!s.ok()) {
     return s;
@@ -246,6 +266,26 @@ Status DBIter::BlobReader::RetrieveAndSetBlobValue(const Slice& user_key,
   return Status::OK();
 }
 
+FilePrefetchBuffer* DBIter::BlobReader::GetPrefetchBuffer(
+    uint64_t blob_file_number) {
+  if (!prefetch_buffers_) {
+    ReadaheadParams readahead_params;
+    if (readahead_size_ > 0) {
+      readahead_params.initial_readahead_size = readahead_size_;
+      readahead_params.max_readahead_size = readahead_size_;
+    } else {
+      // Same as the auto-readahead of table files, since the blobs of a range
+      // of keys are mostly laid out in key order in their blob files
+      readahead_params.initial_readahead_size = 8 * 1024;
+      readahead_params.max_readahead_size = 256 * 1024;
+      readahead_params.implicit_auto_readahead = true;
+      readahead_params.num_file_reads_for_auto_readahead = 2;
+    }
+    prefetch_buffers_.reset(new PrefetchBufferCollection(readahead_params));
+  }
+  return prefetch_buffers_->GetOrCreatePrefetchBuffer(blob_file_number);
+}
+
 bool DBIter::SetValueAndColumnsFromBlobImpl(const Slice& user_key,
                                             const Slice& blob_index) {
   const Status s = blob_reader_.RetrieveAndSetBlobValue(user_key, blob_index);
@@ -301,6 +341,10 @@ bool DBIter::SetValueAndColumnsFromEntity(Slice slice) {
     value_ = WideColumnsHelper::GetDefaultColumn(wide_columns_);
   }
 
+  if (column_projection_) {
+    WideColumnsHelper::ProjectColumns(*column_projection_, wide_columns_);
+  }
+
   return true;
 }
 
@@ -1569,6 +1613,10 @@ void DBIter::SetSavedKeyToSeekForPrevTarget(const Slice& target) {
 }
 
 void DBIter::Seek(const Slice& target) {
+  OperationTraceGuard op_trace(slow_operation_threshold_micros_, clock_,
+                               listeners_, SlowOperationType::kSeek);
+  PerfContextSampler perf_sampler(perf_context_sample_rate_, statistics_,
+                                  PerfSampledOp::kSeek);
   PERF_COUNTER_ADD(iter_seek_count, 1);
   PERF_CPU_TIMER_GUARD(iter_seek_cpu_nanos, clock_);
   StopWatch sw(clock_, statistics_, DB_SEEK);
@@ -1646,6 +1694,10 @@ void DBIter::Seek(const Slice& target) {
 }
 
 void DBIter::SeekForPrev(const Slice& target) {
+  OperationTraceGuard op_trace(slow_operation_threshold_micros_, clock_,
+                               listeners_, SlowOperationType::kSeek);
+  PerfContextSampler perf_sampler(perf_context_sample_rate_, statistics_,
+                                  PerfSampledOp::kSeek);
   PERF_COUNTER_ADD(iter_seek_count, 1);
   PERF_CPU_TIMER_GUARD(iter_seek_cpu_nanos, clock_);
   StopWatch sw(clock_, statistics_, DB_SEEK);
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <string>
 
+#include "db/blob/prefetch_buffer_collection.h"
 #include "db/db_impl/db_impl.h"
 #include "memory/arena.h"
 #include "options/cf_options.h"
@@ -189,6 +190,18 @@ class DBIter final : public Iterator {
     return value_;
   }
 
+  void PinValue(PinnableSlice* value) override {
+    assert(valid_);
+
+    // value_ is only found in a block of iter_ while iter_ is still at the
+    // entry
+    if (iter_.Valid() && iter_.PinValue(value_, value)) {
+      return;
+    }
+    value->Reset();
+    value->PinSelf(value_);
+  }
+
   const WideColumns& columns() const override {
     assert(valid_);
 
@@ -264,12 +277,13 @@ class DBIter final : public Iterator {
    public:
     BlobReader(const Version* version, ReadTier read_tier,
                bool verify_checksums, bool fill_cache,
-               Env::IOActivity io_activity)
+               Env::IOActivity io_activity, size_t readahead_size)
         : version_(version),
           read_tier_(read_tier),
           verify_checksums_(verify_checksums),
           fill_cache_(fill_cache),
-          io_activity_(io_activity) {}
+          io_activity_(io_activity),
+          readahead_size_(readahead_size) {}
 
     const Slice& GetBlobValue() const { return blob_value_; }
     Status RetrieveAndSetBlobValue(const Slice& user_key,
@@ -277,12 +291,18 @@ class DBIter final : public Iterator {
     void ResetBlobValue() { blob_value_.Reset(); }
 
    private:
+    FilePrefetchBuffer* GetPrefetchBuffer(uint64_t blob_file_number);
+
     PinnableSlice blob_value_;
     const Version* version_;
     ReadTier read_tier_;
     bool verify_checksums_;
     bool fill_cache_;
     Env::IOActivity io_activity_;
+    // ReadOptions::readahead_size, or 0 for auto-readahead
+    size_t readahead_size_;
+    // Readahead for the blob files read, created on the first blob read
+    std::unique_ptr<PrefetchBufferCollection> prefetch_buffers_;
   };
 
   // For all methods in this block:
@@ -480,6 +500,9 @@ class DBIter final : public Iterator {
   // All columns (i.e. name-value pairs)
   WideColumns wide_columns_;
   Statistics* statistics_;
+  const uint32_t perf_context_sample_rate_;
+  const uint64_t slow_operation_threshold_micros_;
+  const std::vector<std::shared_ptr<EventListener>>& listeners_;
   uint64_t max_skip_;
   uint64_t max_skippable_internal_keys_;
   uint64_t num_internal_keys_skipped_;
@@ -530,6 +553,8 @@ class DBIter final : public Iterator {
   // the stacked BlobDB implementation is used, false otherwise.
   bool expose_blob_index_;
   bool allow_unprepared_value_;
+  // ReadOptions::column_projection
+  const std::vector<Slice>* column_projection_;
   bool is_blob_;
   bool arena_mode_;
 };
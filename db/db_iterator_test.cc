@@ -81,6 +81,94 @@ TEST_F(DBIteratorBaseTest, APICallsWithPerfContext) {
   delete iter;
 }
 
+TEST_F(DBIteratorBaseTest, MultiScanPreparesDataBlocks) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'v')));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<std::pair<int, int>> ranges({{10, 30}, {500, 520}, {700, 710}});
+  std::vector<std::string> bounds;
+  for (const auto& range : ranges) {
+    bounds.push_back(Key(range.first));
+    bounds.push_back(Key(range.second));
+  }
+  std::vector<ScanOptions> scan_opts;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    scan_opts.emplace_back(bounds[2 * i], bounds[2 * i + 1]);
+  }
+  const uint64_t adds_before =
+      options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD);
+  std::unique_ptr<MultiScan> multi_scan =
+      db_->NewMultiScan(ReadOptions(), db_->DefaultColumnFamily(), scan_opts);
+  // The blocks of all the ranges are loaded up front
+  ASSERT_GT(options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD),
+            adds_before);
+  const uint64_t misses =
+      options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS);
+
+  size_t idx = 0;
+  for (auto scan : *multi_scan) {
+    int expected = ranges[idx].first;
+    for (auto kv : scan) {
+      ASSERT_EQ(Key(expected), kv.first.ToString());
+      expected++;
+    }
+    ASSERT_EQ(ranges[idx].second, expected);
+    idx++;
+  }
+  ASSERT_EQ(ranges.size(), idx);
+  ASSERT_EQ(misses, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+}
+
+TEST_F(DBIteratorBaseTest, PinValueFromBlockCache) {
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  std::shared_ptr<Cache> cache = NewLRUCache(8 << 20);
+  table_options.block_cache = cache;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  // Only in the memtable
+  ASSERT_OK(Put(Key(100), "value100"));
+
+  std::vector<PinnableSlice> values(101);
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    size_t i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_LT(i, values.size());
+      iter->PinValue(&values[i]);
+      i++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(values.size(), i);
+  }
+  ASSERT_GT(cache->GetPinnedUsage(), 0u);
+
+  // The values outlive the iterator. The flushed ones reference their blocks,
+  // while the one from the memtable is copied.
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ("value" + std::to_string(i), values[i].ToString());
+    ASSERT_EQ(i < 100, values[i].IsPinned());
+  }
+  for (auto& value : values) {
+    value.Reset();
+  }
+  ASSERT_EQ(0u, cache->GetPinnedUsage());
+}
+
 // Test param:
 //   bool: whether to pass read_callback to NewIterator().
 class DBIteratorTest : public DBIteratorBaseTest,
@@ -3541,6 +3629,60 @@ TEST_F(DBIteratorTest, IteratorRefreshReturnSV) {
   Close();
 }
 
+TEST_F(DBIteratorTest, RefreshKeepsFileIterators) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(6);
+
+  int stashed = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelIterator::NewFileIterator:Stashed",
+      [&](void* /*arg*/) { stashed++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  iter->Seek(Key(10));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(0, stashed);
+
+  // The L6 file is still live after the flush, so the refreshed iterator goes
+  // on with its table iterator
+  ASSERT_OK(Put(Key(100), "v100"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(iter->Refresh());
+  iter->Seek(Key(50));
+  ASSERT_EQ(1, stashed);
+  int count = 50;
+  for (; iter->Valid(); iter->Next()) {
+    ASSERT_EQ(Key(count), iter->key().ToString());
+    ASSERT_EQ("v" + std::to_string(count), iter->value().ToString());
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(101, count);
+
+  // The compaction replaces the L6 file
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(iter->Refresh());
+  iter->SeekToFirst();
+  ASSERT_EQ(1, stashed);
+  count = 0;
+  for (; iter->Valid(); iter->Next()) {
+    ASSERT_EQ(Key(count), iter->key().ToString());
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(101, count);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBIteratorTest, ErrorWhenReadFile) {
   // This is to test a bug that is fixed in
   // https://github.com/facebook/rocksdb/pull/11782.
@@ -3824,6 +3966,96 @@ TEST_F(DBIteratorTest, IteratorsConsistentViewExplicitSnapshot) {
   }
 }
 
+TEST_F(DBIteratorTest, ParallelScan) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  constexpr int kNumFiles = 3;
+  constexpr int kKeysPerFile = 300;
+  Random rnd(301);
+  for (int file = 0; file < kNumFiles; file++) {
+    for (int i = file; i < kNumFiles * kKeysPerFile; i += kNumFiles) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+  }
+  std::vector<std::string> expected_keys;
+  for (int i = 0; i < kNumFiles * kKeysPerFile; i++) {
+    expected_keys.push_back(Key(i));
+  }
+
+  auto scan = [&](const ReadOptions& read_options, size_t num_partitions,
+                  size_t* num_iterators) {
+    std::vector<std::unique_ptr<Iterator>> iterators;
+    EXPECT_OK(db_->NewParallelScan(read_options, db_->DefaultColumnFamily(),
+                                   num_partitions, &iterators));
+    *num_iterators = iterators.size();
+    // Written after the iterators were created, not seen by any of them
+    EXPECT_OK(Put(Key(kNumFiles * kKeysPerFile), "new"));
+    EXPECT_OK(Delete(Key(0)));
+    EXPECT_OK(Flush());
+
+    std::vector<std::vector<std::string>> keys(iterators.size());
+    std::vector<port::Thread> threads;
+    for (size_t i = 0; i < iterators.size(); i++) {
+      threads.emplace_back([&, i]() {
+        Iterator* iter = iterators[i].get();
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+          keys[i].push_back(iter->key().ToString());
+        }
+        EXPECT_OK(iter->status());
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    // Restore the data for the next scan
+    EXPECT_OK(Delete(Key(kNumFiles * kKeysPerFile)));
+    EXPECT_OK(Put(Key(0), "value"));
+    std::vector<std::string> all_keys;
+    for (auto& partition_keys : keys) {
+      all_keys.insert(all_keys.end(), partition_keys.begin(),
+                      partition_keys.end());
+    }
+    return all_keys;
+  };
+
+  size_t num_iterators = 0;
+  ASSERT_EQ(expected_keys, scan(ReadOptions(), 4, &num_iterators));
+  ASSERT_GT(num_iterators, 1U);
+  ASSERT_LE(num_iterators, 4U);
+
+  ASSERT_EQ(expected_keys, scan(ReadOptions(), 1, &num_iterators));
+  ASSERT_EQ(1U, num_iterators);
+
+  // Within bounds
+  const std::string lower = Key(100);
+  const std::string upper = Key(700);
+  Slice lower_slice(lower);
+  Slice upper_slice(upper);
+  ReadOptions read_options;
+  read_options.iterate_lower_bound = &lower_slice;
+  read_options.iterate_upper_bound = &upper_slice;
+  ASSERT_EQ(std::vector<std::string>(expected_keys.begin() + 100,
+                                     expected_keys.begin() + 700),
+            scan(read_options, 3, &num_iterators));
+  ASSERT_GT(num_iterators, 1U);
+
+  std::vector<std::unique_ptr<Iterator>> iterators;
+  ASSERT_TRUE(db_->NewParallelScan(ReadOptions(), db_->DefaultColumnFamily(),
+                                   0, &iterators)
+                  .IsInvalidArgument());
+  read_options = ReadOptions();
+  read_options.tailing = true;
+  ASSERT_TRUE(db_->NewParallelScan(read_options, db_->DefaultColumnFamily(),
+                                   2, &iterators)
+                  .IsNotSupported());
+}
+
 TEST_P(DBIteratorTest, MemtableOpsScanFlushTriggerWithSeek) {
   // Tests that option memtable_op_scan_flush_trigger works when the limit
   // is reached during a Seek() operation.
@@ -882,6 +882,37 @@ TEST_P(DbMemtableKVChecksumTest, FlushWithCorruptAfterMemtableInsert) {
   Destroy(options);
 }
 
+TEST_P(DbMemtableKVChecksumTest, UnverifiedReadCorruptionCaughtByFlush) {
+  if (op_type_ != WriteBatchOpType::kPut) {
+    // Only a value byte is corrupted below so the entry stays readable.
+    return;
+  }
+  SyncPoint::GetInstance()->SetCallBack(
+      "MemTable::Add:BeforeReturn:Encoded",
+      std::bind(&DbKvChecksumTest::CorruptNextByteCallBack, this,
+                std::placeholders::_1));
+  corrupt_byte_offset_ = kValueLenOffset + 1;
+  SyncPoint::GetInstance()->EnableProcessing();
+  Options options = CurrentOptions();
+  options.memtable_protection_bytes_per_key =
+      memtable_protection_bytes_per_key_;
+  // Reads never verify, so only flush can detect the corruption.
+  options.memtable_protection_verify_one_in = 0;
+
+  Reopen(options);
+  ASSERT_OK(ExecuteWrite(nullptr));
+  std::string val;
+  ASSERT_OK(db_->Get(ReadOptions(), "key", &val));
+  std::unique_ptr<Iterator> it(db_->NewIterator(ReadOptions()));
+  it->SeekToFirst();
+  ASSERT_TRUE(it->Valid());
+  ASSERT_OK(it->status());
+  it.reset();
+  ASSERT_TRUE(Flush().IsCorruption());
+  ASSERT_TRUE(dbfull()->TEST_GetBGError().IsCorruption());
+  Destroy(options);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
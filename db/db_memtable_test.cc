@@ -3,6 +3,7 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <map>
 #include <memory>
 #include <string>
 
@@ -12,6 +13,7 @@
 #include "port/stack_trace.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/slice_transform.h"
+#include "utilities/memory_allocators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -277,6 +279,131 @@ TEST_F(DBMemTableTest, ConcurrentMergeWrite) {
   delete mem;
 }
 
+TEST_F(DBMemTableTest, ConcurrentRepWrite) {
+  const int kNumThreads = 4;
+  const int kKeysPerThread = 1000;
+  InternalKeyComparator cmp(BytewiseComparator());
+  for (int rep = 0; rep < 4; rep++) {
+    Options options;
+    // Few prefixes, so that threads keep inserting into the same buckets and
+    // link list buckets get converted to skip lists under contention
+    options.prefix_extractor.reset(NewFixedPrefixTransform(1));
+    if (rep == 0) {
+      options.memtable_factory.reset(NewHashSkipListRepFactory(4));
+    } else if (rep == 1) {
+      options.memtable_factory.reset(NewHashLinkListRepFactory(
+          4, 0 /* huge_page_tlb_size */, 0 /* logging_threshold */,
+          false /* log_when_flash */, 3 /* threshold_use_skiplist */));
+    } else if (rep == 2) {
+      options.memtable_factory = std::make_shared<BTreeRepFactory>();
+    } else {
+      options.memtable_factory =
+          std::make_shared<PartitionedSkipListFactory>(4);
+    }
+    options.allow_concurrent_memtable_write = true;
+    ASSERT_TRUE(options.memtable_factory->IsInsertConcurrentlySupported());
+    ImmutableOptions ioptions(options);
+    WriteBufferManager wb(options.db_write_buffer_size);
+    MemTable* mem = new MemTable(cmp, ioptions, MutableCFOptions(options),
+                                 &wb, kMaxSequenceNumber, 0 /* cf_id */);
+
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&, t]() {
+        MemTablePostProcessInfo post_process_info;
+        for (int i = 0; i < kKeysPerThread; i++) {
+          const int k = i * kNumThreads + t;
+          std::string key = std::string(1, static_cast<char>('a' + k % 8)) +
+                            std::to_string(k);
+          ASSERT_OK(mem->Add(k + 1, kTypeValue, key, std::to_string(k),
+                             nullptr /* kv_prot_info */, true,
+                             &post_process_info));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ReadOptions roptions;
+    for (int k = 0; k < kNumThreads * kKeysPerThread; k++) {
+      std::string key =
+          std::string(1, static_cast<char>('a' + k % 8)) + std::to_string(k);
+      std::string value;
+      Status status;
+      MergeContext merge_context;
+      SequenceNumber max_covering_tombstone_seq = 0;
+      LookupKey lkey(key, kMaxSequenceNumber);
+      ASSERT_TRUE(mem->Get(lkey, &value, /*columns=*/nullptr,
+                           /*timestamp=*/nullptr, &status, &merge_context,
+                           &max_covering_tombstone_seq, roptions,
+                           false /* immutable_memtable */));
+      ASSERT_OK(status);
+      ASSERT_EQ(std::to_string(k), value);
+    }
+    delete mem;
+  }
+}
+
+TEST_F(DBMemTableTest, PartitionedSkipList) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.memtable_factory = std::make_shared<PartitionedSkipListFactory>(4);
+  Reopen(options);
+
+  // Several versions of each key, which must all land in one partition
+  std::map<std::string, std::string> expected;
+  Random rnd(301);
+  for (int i = 0; i < 2000; i++) {
+    std::string key = Key(static_cast<int>(rnd.Uniform(500)));
+    std::string value = rnd.RandomString(10);
+    ASSERT_OK(Put(key, value));
+    expected[key] = value;
+  }
+  for (int i = 0; i < 100; i++) {
+    std::string key = Key(static_cast<int>(rnd.Uniform(500)));
+    ASSERT_OK(Delete(key));
+    expected.erase(key);
+  }
+
+  for (int flushed = 0; flushed < 2; flushed++) {
+    for (int i = 0; i < 500; i++) {
+      auto it = expected.find(Key(i));
+      ASSERT_EQ(it == expected.end() ? "NOT_FOUND" : it->second, Get(Key(i)));
+    }
+
+    // Merged iteration with changes of direction
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto model = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++model) {
+      ASSERT_TRUE(model != expected.end());
+      ASSERT_EQ(model->first, iter->key().ToString());
+      ASSERT_EQ(model->second, iter->value().ToString());
+      if (rnd.OneIn(10) && model != expected.begin()) {
+        iter->Prev();
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(std::prev(model)->first, iter->key().ToString());
+        iter->Next();
+      }
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(model == expected.end());
+
+    auto rmodel = expected.rbegin();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rmodel) {
+      ASSERT_TRUE(rmodel != expected.rend());
+      ASSERT_EQ(rmodel->first, iter->key().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(rmodel == expected.rend());
+
+    // The partitions are flushed as one memtable
+    iter.reset();
+    ASSERT_OK(Flush());
+    ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  }
+}
+
 TEST_F(DBMemTableTest, InsertWithHint) {
   Options options;
   options.allow_concurrent_memtable_write = false;
@@ -339,6 +466,127 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+TEST_F(DBMemTableTest, TierAllocator) {
+  auto allocator = std::make_shared<CountedMemoryAllocator>();
+  Options options = CurrentOptions();
+  options.memtable_tier_allocator = allocator;
+  options.memtable_tier_min_entry_size = 1024;
+  options.arena_block_size = 64 << 10;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("small", std::string(10, 's')));
+  ASSERT_EQ(allocator->GetNumAllocations(), 0U);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put("large" + std::to_string(i), std::string(4000, 'l')));
+  }
+  ASSERT_GT(allocator->GetNumAllocations(), 0U);
+  ASSERT_EQ(std::string(10, 's'), Get("small"));
+  ASSERT_EQ(std::string(4000, 'l'), Get("large42"));
+
+  ASSERT_OK(Flush());
+  ASSERT_EQ(std::string(4000, 'l'), Get("large42"));
+
+  // The tier blocks go with the memtables
+  Close();
+  ASSERT_EQ(allocator->GetNumDeallocations(), allocator->GetNumAllocations());
+}
+
+TEST_F(DBMemTableTest, ValueCompression) {
+  if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("Test requires LZ4 support");
+    return;
+  }
+  uint64_t mem_size[2] = {0, 0};
+  for (bool compress : {false, true}) {
+    Options options = CurrentOptions();
+    options.write_buffer_size = 64 << 20;
+    options.arena_block_size = 4 << 10;
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    if (compress) {
+      options.memtable_value_compression = kLZ4Compression;
+      options.memtable_value_compression_min_size = 100;
+    }
+    DestroyAndReopen(options);
+
+    ASSERT_OK(Put("small", "s"));
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(Key(i), std::string(4000, 'a' + i % 26)));
+    }
+    ASSERT_OK(Merge(Key(1), "m"));
+    ASSERT_TRUE(db_->GetIntProperty("rocksdb.cur-size-active-mem-table",
+                                    &mem_size[compress]));
+
+    auto verify = [&]() {
+      ASSERT_EQ("s", Get("small"));
+      ASSERT_EQ(std::string(4000, 'c'), Get(Key(2)));
+      ASSERT_EQ(std::string(4000, 'b') + ",m", Get(Key(1)));
+      std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+      int count = 0;
+      for (iter->Seek(Key(10)); iter->Valid() && count < 10; iter->Next()) {
+        ASSERT_EQ(std::string(4000, 'a' + (10 + count) % 26),
+                  iter->value().ToString());
+        count++;
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(10, count);
+    };
+    verify();
+    ASSERT_OK(Flush());
+    verify();
+  }
+  ASSERT_LT(mem_size[1] * 4, mem_size[0]);
+}
+
+TEST_F(DBMemTableTest, PointLookupIndex) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 4 << 20;
+  options.memtable_point_lookup_index_ratio = 0.25;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  DestroyAndReopen(options);
+
+  int num_found = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "MemTable::GetFromPointLookupIndex:Found",
+      [&](void* /*arg*/) { num_found++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 20; i++) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+  }
+  ASSERT_OK(Put(Key(1), "v1b"));
+  ASSERT_OK(Delete(Key(2)));
+  ASSERT_OK(Merge(Key(3), "m"));
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put(Key(4), "v4b"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(5), Key(6)));
+
+  // The newest entries of the keys, when a value or a deletion visible to
+  // the read, come from the index
+  ASSERT_EQ("v0", Get(Key(0)));
+  ASSERT_EQ("v1b", Get(Key(1)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(2)));
+  ASSERT_EQ("v4b", Get(Key(4)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(5)));
+  ASSERT_EQ(5, num_found);
+  // Merges and entries newer than the snapshot of the read need the rep
+  ASSERT_EQ("v3,m", Get(Key(3)));
+  ASSERT_EQ("v4", Get(Key(4), snapshot));
+  ASSERT_EQ("NOT_FOUND", Get(Key(20)));
+  ASSERT_EQ(5, num_found);
+
+  std::vector<std::string> keys = {Key(0), Key(1), Key(2), Key(3), Key(20)};
+  std::vector<std::string> values = MultiGet(keys, nullptr);
+  ASSERT_EQ(std::vector<std::string>(
+                {"v0", "v1b", "NOT_FOUND", "v3,m", "NOT_FOUND"}),
+            values);
+  ASSERT_EQ(8, num_found);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  db_->ReleaseSnapshot(snapshot);
+}
+
 TEST_F(DBMemTableTest, IntegrityChecks) {
   // We insert keys key000000, key000001 and key000002 into skiplist at fixed
   // height 1 (smallest height). Then we corrupt the second key to aey000001 to
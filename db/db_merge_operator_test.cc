@@ -1047,6 +1047,57 @@ TEST_F(DBMergeOperatorTest, MaxSuccessiveMergesBaseValues) {
   }
 }
 
+TEST_F(DBMergeOperatorTest, InplaceMergeSupport) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.merge_operator = MergeOperators::CreateUInt64AddOperator();
+  options.inplace_update_support = true;
+  options.inplace_merge_support = true;
+  options.allow_concurrent_memtable_write = false;
+  options.env = env_;
+  Reopen(options);
+
+  auto encode = [](uint64_t num) {
+    std::string result;
+    PutFixed64(&result, num);
+    return result;
+  };
+  auto count_versions = [&](const std::string& key) {
+    constexpr size_t max_key_versions = 64;
+    std::vector<KeyVersion> key_versions;
+    EXPECT_OK(GetAllKeyVersions(db_, db_->DefaultColumnFamily(), key, key,
+                                max_key_versions, &key_versions));
+    return key_versions.size();
+  };
+
+  // The operands of a hot key are folded into the first one
+  for (uint64_t i = 1; i <= 20; i++) {
+    ASSERT_OK(db_->Merge(WriteOptions(), "counter", encode(i)));
+  }
+  ASSERT_EQ(count_versions("counter"), 1);
+  ASSERT_EQ(Get("counter"), encode(210));
+
+  // A base value stops the folding, as the operand is not a merge
+  ASSERT_OK(Put("base", encode(100)));
+  for (uint64_t i = 0; i < 5; i++) {
+    ASSERT_OK(db_->Merge(WriteOptions(), "base", encode(1)));
+  }
+  ASSERT_EQ(count_versions("base"), 2);
+  ASSERT_EQ(Get("base"), encode(105));
+
+  // Operands are not folded into the ones of flushed memtables
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->Merge(WriteOptions(), "counter", encode(1)));
+  ASSERT_OK(db_->Merge(WriteOptions(), "counter", encode(1)));
+  ASSERT_EQ(count_versions("counter"), 2);
+  ASSERT_EQ(Get("counter"), encode(212));
+
+  // The WAL keeps every operand, so recovery reaches the same result
+  Reopen(options);
+  ASSERT_EQ(Get("counter"), encode(212));
+  ASSERT_EQ(Get("base"), encode(105));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -886,6 +886,78 @@ TEST_F(DBOptionsTest, MaxOpenFilesChange) {
   Close();
 }
 
+TEST_F(DBOptionsTest, HyperClockTableCache) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_open_files = 20;
+  options.table_cache_use_hyper_clock_cache = true;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  Cache* tc = dbfull()->TEST_table_cache();
+  ASSERT_STREQ("AutoHyperClockCache", tc->Name());
+
+  // More files than the table cache can keep open
+  for (int i = 0; i < 30; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+    ASSERT_OK(Flush());
+  }
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 30; i++) {
+      ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+    }
+  }
+  ASSERT_GT(TestGetTickerCount(options, NO_FILE_OPENS), 30);
+
+  ASSERT_OK(dbfull()->SetDBOptions({{"max_open_files", "1024"}}));
+  ASSERT_EQ(1014, tc->GetCapacity());
+  for (int i = 0; i < 30; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  Close();
+}
+
+TEST_F(DBOptionsTest, OpenTableFilesInBackground) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_open_files = -1;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+    ASSERT_OK(Flush());
+  }
+  MoveFilesToLevel(1);
+  for (int i = 10; i < 15; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+    ASSERT_OK(Flush());
+  }
+
+  options.open_table_files_in_background = true;
+  options.skip_stats_update_on_db_open = true;
+  options.statistics = CreateDBStatistics();
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBOptionsTest::OpenTableFilesInBackground:Opened",
+        "DBImpl::BackgroundCallOpenTableFiles:Start"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+  Reopen(options);
+  // No file opened by DB::Open()
+  ASSERT_EQ(0, TestGetTickerCount(options, NO_FILE_OPENS));
+  ASSERT_EQ("value3", Get(Key(3)));
+  ASSERT_EQ(1, TestGetTickerCount(options, NO_FILE_OPENS));
+  TEST_SYNC_POINT("DBOptionsTest::OpenTableFilesInBackground:Opened");
+
+  dbfull()->TEST_WaitForOpenTableFiles();
+  ASSERT_EQ(15, TestGetTickerCount(options, NO_FILE_OPENS));
+  for (int i = 0; i < 15; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  ASSERT_EQ(15, TestGetTickerCount(options, NO_FILE_OPENS));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+}
+
 TEST_F(DBOptionsTest, SanitizeDelayedWriteRate) {
   Options options;
   options.env = CurrentOptions().env;
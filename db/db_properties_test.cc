@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include "db/db_test_util.h"
@@ -550,6 +551,61 @@ TEST_F(DBPropertiesTest, ReadLatencyHistogramByLevel) {
   ASSERT_EQ(std::string::npos, prop.find("** Level 2 read latency histogram"));
 }
 
+TEST_F(DBPropertiesTest, ReadLatencyHistogramByPath) {
+  class SlowReadLogger : public Logger {
+   public:
+    using Logger::Logv;
+    void Logv(const InfoLogLevel log_level, const char* format,
+              va_list /*ap*/) override {
+      if (log_level == InfoLogLevel::WARN_LEVEL &&
+          std::strstr(format, "slow table file reads") != nullptr) {
+        ++num_reports;
+      }
+    }
+    std::atomic<int> num_reports{0};
+  };
+  auto logger = std::make_shared<SlowReadLogger>();
+
+  Options options = CurrentOptions();
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.db_paths.emplace_back(dbname_, 1 << 20);
+  options.db_paths.emplace_back(dbname_ + "_2", 1 << 30);
+  options.info_log = logger;
+  options.slow_read_log_threshold_micros = 3600 * 1000000U;
+  Reopen(options);
+
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("bar", Get("foo"));
+  std::string prop;
+  ASSERT_TRUE(dbfull()->GetProperty("rocksdb.cf-file-histogram", &prop));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Path " + dbname_ + " read latency histogram"));
+  ASSERT_EQ(std::string::npos,
+            prop.find("** Path " + dbname_ + "_2 read latency histogram"));
+  ASSERT_EQ(0, logger->num_reports.load());
+
+  // Slow reads are reported once per second
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(
+                 db_->DefaultColumnFamily())
+                 ->cfd();
+  const auto& hists = cfd->table_cache()->GetPathReadHists();
+  ASSERT_EQ(2u, hists.size());
+  hists[1]->Add(options.slow_read_log_threshold_micros);
+  hists[1]->Add(options.slow_read_log_threshold_micros);
+  ASSERT_EQ(1, logger->num_reports.load());
+
+  ASSERT_TRUE(dbfull()->GetProperty("rocksdb.cf-file-histogram", &prop));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Path " + dbname_ + "_2 read latency histogram"));
+
+  ASSERT_OK(dbfull()->ResetStats());
+  ASSERT_TRUE(dbfull()->GetProperty("rocksdb.cf-file-histogram", &prop));
+  ASSERT_EQ(std::string::npos, prop.find("** Path "));
+  Close();
+  ASSERT_OK(DestroyDB(dbname_, options));
+}
+
 TEST_F(DBPropertiesTest, AggregatedTablePropertiesAtLevel) {
   const int kTableCount = 100;
   const int kDeletionsPerTable = 0;
@@ -2147,6 +2203,55 @@ TEST_F(DBPropertiesTest, GetMapPropertyBlockCacheEntryStats) {
   ASSERT_EQ(3 * kNumCacheEntryRoles + 4, values.size());
 }
 
+TEST_F(DBPropertiesTest, GetMapPropertyLsmEfficiency) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.level_compaction_dynamic_level_bytes = false;
+  DestroyAndReopen(options);
+
+  // Two overlapping L0 files, so that compacting them rewrites them
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 100; j++) {
+      ASSERT_OK(Put(Key(j), "value" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+  }
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kLsmEfficiency, &values));
+  ASSERT_EQ(std::stod(values["L0.write_amp"]), 1.0);
+  ASSERT_EQ(std::stod(values["L0.write_amp_interval"]), 1.0);
+  ASSERT_EQ(std::stod(values["L0.space_amp"]), 1.0);
+  ASSERT_EQ(std::stod(values["Sum.write_amp"]), 1.0);
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kLsmEfficiency, &values));
+  ASSERT_GT(std::stod(values["L1.write_amp"]), 0.0);
+  ASSERT_GT(std::stod(values["Sum.write_amp"]), 1.0);
+  // Nothing was flushed since the previous query
+  ASSERT_EQ(std::stod(values["L0.write_amp_interval"]), 0.0);
+  ASSERT_EQ(std::stod(values["L1.space_amp"]), 1.0);
+  ASSERT_EQ(std::stod(values["Sum.space_amp"]), 1.0);
+
+  // Lookups are sampled, and probe the only file
+  for (int i = 0; i < 1000000 && std::stoull(values["sampled_lookups"]) == 0;
+       i++) {
+    ASSERT_EQ("value1", Get(Key(i % 100)));
+    if (i % 1000 == 0) {
+      ASSERT_TRUE(
+          db_->GetMapProperty(DB::Properties::kLsmEfficiency, &values));
+    }
+  }
+  ASSERT_GT(std::stoull(values["sampled_lookups"]), 0U);
+  ASSERT_EQ(std::stod(values["L0.read_amp"]), 0.0);
+  ASSERT_EQ(std::stod(values["L1.read_amp"]), 1.0);
+  ASSERT_EQ(std::stod(values["Sum.read_amp"]), 1.0);
+
+  std::string value;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kLsmEfficiency, &value));
+  ASSERT_NE(value.find("W-Amp"), std::string::npos);
+}
+
 TEST_F(DBPropertiesTest, WriteStallStatsSanityCheck) {
   for (uint32_t i = 0; i < static_cast<uint32_t>(WriteStallCause::kNone); ++i) {
     WriteStallCause cause = static_cast<WriteStallCause>(i);
@@ -711,6 +711,45 @@ TEST_F(DBRangeDelTest, GetCoveredKeyFromMutableMemtable) {
   } while (ChangeOptions(kRangeDelSkipConfigs));
 }
 
+TEST_F(DBRangeDelTest, InterleavedDeleteRangeAndGetInMemtable) {
+  DestroyAndReopen(CurrentOptions());
+  const int kNumKeys = 50;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(db_->Put(WriteOptions(), Key(i), "val"));
+  }
+  std::vector<bool> deleted(kNumKeys, false);
+  Random rnd(301);
+  // Reads after every DeleteRange() extend the cached fragmented tombstones.
+  // Skipping reads for a while makes the next read refragment all of them.
+  for (int round = 0; round < 60; ++round) {
+    int begin = rnd.Uniform(kNumKeys);
+    int end = begin + 1 + rnd.Uniform(8);
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(begin), Key(end)));
+    for (int i = begin; i < std::min(end, kNumKeys); ++i) {
+      deleted[i] = true;
+    }
+    int rewritten = rnd.Uniform(kNumKeys);
+    ASSERT_OK(db_->Put(WriteOptions(), Key(rewritten), "val"));
+    deleted[rewritten] = false;
+    if (round >= 20 && round < 40) {
+      continue;
+    }
+    for (int i = 0; i < kNumKeys; ++i) {
+      std::string value;
+      Status s = db_->Get(ReadOptions(), Key(i), &value);
+      ASSERT_EQ(deleted[i], s.IsNotFound()) << i;
+    }
+  }
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int num_live = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++num_live;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(std::count(deleted.begin(), deleted.end(), false), num_live);
+}
+
 TEST_F(DBRangeDelTest, GetCoveredKeyFromImmutableMemtable) {
   do {
     Options opts = CurrentOptions();
@@ -3825,6 +3864,48 @@ TEST_F(DBRangeDelTest, RowCache) {
   // and should not turn db into read-only mdoe.
   ASSERT_OK(Put(Key(5), "foo"));
 }
+
+TEST_F(DBRangeDelTest, SkipCoveredKeysAtSameLevel) {
+  // The keys and the range tombstone covering most of them are in the same
+  // memtable, along with a newer key within the range tombstone.
+  DestroyAndReopen(CurrentOptions());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put(Key(i), "val" + std::to_string(i)));
+  }
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(10), Key(90)));
+  ASSERT_OK(Put(Key(50), "new"));
+
+  std::vector<std::string> expected;
+  for (int i = 0; i < 10; i++) {
+    expected.push_back(Key(i));
+  }
+  expected.push_back(Key(50));
+  for (int i = 90; i < 100; i++) {
+    expected.push_back(Key(i));
+  }
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  std::vector<std::string> keys;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    keys.push_back(iter->key().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(expected, keys);
+
+  keys.clear();
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    keys.push_back(iter->key().ToString());
+  }
+  ASSERT_OK(iter->status());
+  std::reverse(keys.begin(), keys.end());
+  ASSERT_EQ(expected, keys);
+
+  iter->Seek(Key(20));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(50), iter->key());
+  ASSERT_EQ("new", iter->value());
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
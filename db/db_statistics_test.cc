@@ -160,6 +160,129 @@ TEST_F(DBStatisticsTest, MutexWaitStats) {
   ThreadStatusUtil::TEST_SetStateDelay(ThreadStatus::STATE_MUTEX_WAIT, 0);
 }
 
+TEST_F(DBStatisticsTest, ManifestWriteStats) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  CreateAndReopenWithCF({"pikachu"}, options);
+  ASSERT_OK(options.statistics->Reset());
+
+  // The flushes of both column families, and thus their version installs,
+  // run at the same time
+  for (int i = 0; i < 4; i++) {
+    ASSERT_OK(Put(0, "key" + std::to_string(i), "value"));
+    ASSERT_OK(Put(1, "key" + std::to_string(i), "value"));
+    ASSERT_OK(db_->Flush(FlushOptions(), handles_));
+  }
+
+  HistogramData queue_micros;
+  HistogramData group_size;
+  options.statistics->histogramData(MANIFEST_WRITE_QUEUE_MICROS,
+                                    &queue_micros);
+  options.statistics->histogramData(MANIFEST_WRITE_GROUP_SIZE, &group_size);
+  ASSERT_GT(group_size.count, 0);
+  // Each group commit has a leader, and commits at least its own edits
+  ASSERT_GE(queue_micros.count, group_size.count);
+  ASSERT_GE(group_size.sum, group_size.count);
+}
+
+TEST_F(DBStatisticsTest, PerfContextSampling) {
+  for (uint32_t sample_rate : {0, 1}) {
+    Options options = CurrentOptions();
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    options.perf_context_sample_rate = sample_rate;
+    DestroyAndReopen(options);
+    SetPerfLevel(PerfLevel::kEnableCount);
+
+    const int kNumKeys = 10;
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(Key(i), "v"));
+    }
+    ASSERT_OK(Flush());
+    std::vector<std::string> keys;
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ("v", Get(Key(i)));
+      keys.push_back(Key(i));
+    }
+    std::vector<std::string> values = MultiGet(keys, nullptr);
+    ASSERT_EQ(static_cast<size_t>(kNumKeys), values.size());
+    {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+      for (int i = 0; i < kNumKeys; i++) {
+        iter->Seek(Key(i));
+        ASSERT_TRUE(iter->Valid());
+      }
+      ASSERT_OK(iter->status());
+    }
+    // The perf level of the thread is restored after the sampled operations
+    ASSERT_EQ(PerfLevel::kEnableCount, GetPerfLevel());
+
+    const uint64_t num_ops = sample_rate == 0 ? 0 : kNumKeys;
+    HistogramData data;
+    for (Histograms histogram :
+         {SAMPLED_WRITE_WAL_NANOS, SAMPLED_WRITE_MEMTABLE_NANOS,
+          SAMPLED_WRITE_DELAY_NANOS, SAMPLED_GET_MEMTABLE_NANOS,
+          SAMPLED_GET_FILES_NANOS, SAMPLED_GET_BLOCK_READ_NANOS,
+          SAMPLED_SEEK_MEMTABLE_NANOS, SAMPLED_SEEK_CHILD_NANOS,
+          SAMPLED_SEEK_BLOCK_READ_NANOS}) {
+      options.statistics->histogramData(histogram, &data);
+      ASSERT_EQ(num_ops, data.count);
+    }
+    // One MultiGet() of the keys of one column family
+    options.statistics->histogramData(SAMPLED_MULTIGET_FILES_NANOS, &data);
+    ASSERT_EQ(num_ops == 0 ? 0u : 1u, data.count);
+    if (sample_rate != 0) {
+      // Reading the SST file was timed
+      options.statistics->histogramData(SAMPLED_GET_FILES_NANOS, &data);
+      ASSERT_GT(data.sum, 0u);
+    }
+  }
+}
+
+TEST_F(DBStatisticsTest, ColumnFamilyStatistics) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Options cf_options = options;
+  std::shared_ptr<Statistics> cf_statistics =
+      ROCKSDB_NAMESPACE::CreateDBStatistics();
+  cf_options.cf_statistics = cf_statistics;
+  DestroyAndReopen(options);
+  CreateColumnFamilies({"pikachu"}, cf_options);
+  ReopenWithColumnFamilies({"default", "pikachu"},
+                           std::vector<Options>({options, cf_options}));
+
+  for (int cf = 0; cf < 2; cf++) {
+    for (int i = 0; i < 10; i++) {
+      ASSERT_OK(Put(cf, Key(i), "v"));
+    }
+    ASSERT_OK(Flush(cf));
+  }
+  // Only the flush of pikachu is recorded into its statistics
+  const uint64_t cf_flush_bytes =
+      cf_statistics->getTickerCount(FLUSH_WRITE_BYTES);
+  ASSERT_GT(cf_flush_bytes, 0u);
+  ASSERT_GT(options.statistics->getTickerCount(FLUSH_WRITE_BYTES),
+            cf_flush_bytes);
+
+  ASSERT_EQ("v", Get(1, Key(0)));
+  ASSERT_EQ(1u, cf_statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(1u, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ("v", Get(0, Key(0)));
+  ASSERT_EQ(1u, cf_statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(2u, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+
+  ASSERT_OK(Put(1, Key(0), "v2"));
+  ASSERT_OK(Flush(1));
+  ASSERT_OK(
+      db_->CompactRange(CompactRangeOptions(), handles_[1], nullptr, nullptr));
+  const uint64_t cf_compact_bytes =
+      cf_statistics->getTickerCount(COMPACT_WRITE_BYTES);
+  ASSERT_GT(cf_compact_bytes, 0u);
+  ASSERT_EQ(cf_compact_bytes,
+            options.statistics->getTickerCount(COMPACT_WRITE_BYTES));
+}
+
 TEST_F(DBStatisticsTest, ResetStats) {
   Options options = CurrentOptions();
   options.create_if_missing = true;
@@ -314,6 +314,60 @@ TEST_P(DBTestTailingIterator, TailingIteratorTrimSeekToNext) {
   }
 }
 
+TEST_P(DBTestTailingIterator, TailingIteratorKeepsUnchangedLevels) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  ReadOptions read_options;
+  read_options.tailing = true;
+  if (GetParam()) {
+    read_options.async_io = true;
+  }
+  std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+  iter->SeekToFirst();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(0), iter->key().ToString());
+
+  int reused_levels = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "ForwardIterator::RenewIterators:ReuseLevel",
+      [&](void* /*arg*/) { reused_levels++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // The flush only adds an L0 file, so the iterator of the compacted level
+  // is kept
+  ASSERT_OK(Put(Key(100), "v100"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  iter->Next();
+  ASSERT_EQ(1, reused_levels);
+  int count = 1;
+  for (; iter->Valid(); iter->Next()) {
+    ASSERT_EQ(Key(count), iter->key().ToString());
+    ASSERT_EQ("v" + std::to_string(count), iter->value().ToString());
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(101, count);
+
+  // A compaction changes the files of the level
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  iter->Seek(Key(50));
+  ASSERT_EQ(1, reused_levels);
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(50), iter->key().ToString());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_P(DBTestTailingIterator, TailingIteratorDeletes) {
   if (mem_env_ || encrypted_env_) {
     ROCKSDB_GTEST_BYPASS("Test requires non-mem or non-encrypted environment");
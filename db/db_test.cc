@@ -1908,6 +1908,77 @@ TEST_F(DBTest, ApproximateSizesFilesWithErrorMargin) {
   }
 }
 
+TEST_F(DBTest, ApproximateRangeStatsWithKeyAnchors) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 1024 * 1024;
+  options.target_file_size_base = 256 * 1024;
+  options.compression = kNoCompression;
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+  const auto default_cf = db_->DefaultColumnFamily();
+
+  const int N = 20000;
+  Random rnd(301);
+  for (int i = 0; i < N; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(
+      db_->CompactRange(CompactRangeOptions(), default_cf, nullptr, nullptr));
+  ASSERT_GT(NumTableFilesAtLevel(1), 1);
+
+  const std::string start = Key(N / 4);
+  const std::string end = Key(3 * N / 4);
+  const Range r(start, end);
+  SizeApproximationOptions size_approx_options;
+  uint64_t precise_size;
+  ASSERT_OK(db_->GetApproximateSizes(size_approx_options, default_cf, &r, 1,
+                                     &precise_size));
+  ASSERT_GT(precise_size, 0);
+
+  uint64_t size;
+  uint64_t count;
+  ASSERT_OK(db_->GetApproximateRangeStats(size_approx_options, default_cf, &r,
+                                          1, &size, &count));
+  ASSERT_LT(size, precise_size * 1.1);
+  ASSERT_GT(size, precise_size * 0.9);
+  ASSERT_LT(count, N / 2 * 1.1);
+  ASSERT_GT(count, N / 2 * 0.9);
+
+  uint64_t size2;
+  size_approx_options.use_key_anchors = true;
+  ASSERT_OK(db_->GetApproximateSizes(size_approx_options, default_cf, &r, 1,
+                                     &size2));
+  ASSERT_EQ(size, size2);
+
+  // Empty and out of range
+  const std::string past_start = Key(N);
+  const std::string past_end = Key(2 * N);
+  const Range empty(start, start);
+  const Range beyond(past_start, past_end);
+  ASSERT_OK(db_->GetApproximateRangeStats(size_approx_options, default_cf,
+                                          &empty, 1, &size, &count));
+  ASSERT_EQ(0, size);
+  ASSERT_EQ(0, count);
+  ASSERT_OK(db_->GetApproximateRangeStats(size_approx_options, default_cf,
+                                          &beyond, 1, &size, &count));
+  ASSERT_LT(count, N / 20);
+
+  // The memtables are accounted for if asked for
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put(Key(i) + "m", rnd.RandomString(100)));
+  }
+  const std::string mem_end = Key(100);
+  const Range mem_range(Key(0), mem_end);
+  uint64_t files_count;
+  ASSERT_OK(db_->GetApproximateRangeStats(size_approx_options, default_cf,
+                                          &mem_range, 1, &size, &files_count));
+  size_approx_options.include_memtables = true;
+  ASSERT_OK(db_->GetApproximateRangeStats(size_approx_options, default_cf,
+                                          &mem_range, 1, &size, &count));
+  ASSERT_GT(count, files_count);
+}
+
 TEST_F(DBTest, GetApproximateMemTableStats) {
   Options options = CurrentOptions();
   options.write_buffer_size = 100000000;
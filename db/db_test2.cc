@@ -587,6 +587,75 @@ TEST_F(DBTest2, SharedWriteBufferLimitAcrossDB) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBTest2, CostAwareFlushAcrossDB) {
+  std::string dbname2 = test::PerThreadDBPath("db_cost_aware_flush_db2");
+  Options options = CurrentOptions();
+  options.arena_block_size = 4096;
+  auto flush_listener = std::make_shared<FlushCounterListener>();
+  options.listeners.push_back(flush_listener);
+  // Don't trip the listener at shutdown.
+  options.avoid_flush_during_shutdown = true;
+  // Avoid undeterministic value by malloc_usable_size();
+  // Force arena block size to 1
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "Arena::Arena:0", [&](void* arg) {
+        size_t* block_size = static_cast<size_t*>(arg);
+        *block_size = 1;
+      });
+
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "Arena::AllocateNewBlock:0", [&](void* arg) {
+        std::pair<size_t*, size_t*>* pair =
+            static_cast<std::pair<size_t*, size_t*>*>(arg);
+        *std::get<0>(*pair) = *std::get<1>(*pair);
+      });
+  int passed_over = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::HandleWriteBufferManagerFlush:PassedOver",
+      [&](void*) { passed_over++; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  options.write_buffer_size = 500000;  // this is never hit
+  // The soft limit is about 105000
+  options.write_buffer_manager.reset(new WriteBufferManager(120000));
+  options.write_buffer_manager->SetCostAwareFlush(true);
+  Reopen(options);
+
+  ASSERT_OK(DestroyDB(dbname2, options));
+  DB* db2 = nullptr;
+  ASSERT_OK(DB::Open(options, dbname2, &db2));
+
+  WriteOptions wo;
+  wo.disableWAL = true;
+  std::function<void()> wait_flush = [&]() {
+    ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+    ASSERT_OK(static_cast<DBImpl*>(db2)->TEST_WaitForFlushMemTable());
+    ASSERT_OK(dbfull()->TEST_WaitForBackgroundWork());
+    ASSERT_OK(
+        static_cast_with_check<DBImpl>(db2)->TEST_WaitForBackgroundWork());
+  };
+
+  flush_listener->expected_flush_reason = FlushReason::kWriteBufferManager;
+  ASSERT_OK(Put(Key(1), DummyString(70000), wo));
+  ASSERT_OK(db2->Put(wo, Key(2), DummyString(40000)));
+  // Over the soft limit, db2 leaves the flush to the DB with more memory
+  ASSERT_OK(db2->Put(wo, Key(3), DummyString(1)));
+  wait_flush();
+  ASSERT_EQ(1, passed_over);
+  ASSERT_EQ(GetNumberOfSstFilesForColumnFamily(db2, "default"), 0U);
+  ASSERT_EQ(GetNumberOfSstFilesForColumnFamily(db_, "default"), 0U);
+
+  ASSERT_OK(Put(Key(1), DummyString(1), wo));
+  wait_flush();
+  ASSERT_EQ(GetNumberOfSstFilesForColumnFamily(db2, "default"), 0U);
+  ASSERT_EQ(GetNumberOfSstFilesForColumnFamily(db_, "default"), 1U);
+
+  delete db2;
+  ASSERT_OK(DestroyDB(dbname2, options));
+
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+}
+
 TEST_F(DBTest2, TestWriteBufferNoLimitWithCache) {
   Options options = CurrentOptions();
   options.arena_block_size = 4096;
@@ -1404,6 +1473,69 @@ TEST_F(DBTest2, PresetCompressionDictLocality) {
   }
 }
 
+TEST_F(DBTest2, PresetCompressionDictReuse) {
+  if (!ZSTD_Supported()) {
+    return;
+  }
+  // Verifies that with `compression_dict_reuse_files`, a dictionary trained
+  // for one compaction output file is reused by the next files and then
+  // retrained.
+  const int kNumEntriesPerFile = 1 << 10;  // 1KB
+  const int kNumBytesPerEntry = 1 << 10;   // 1KB
+  const int kNumFiles = 8;
+  const uint32_t kReuseFiles = 2;
+  Options options = CurrentOptions();
+  options.compression = kZSTD;
+  options.compression_opts.max_dict_bytes = 1 << 14;        // 16KB
+  options.compression_opts.zstd_max_train_bytes = 1 << 18;  // 256KB
+  options.target_file_size_base = kNumEntriesPerFile * kNumBytesPerEntry;
+  BlockBasedTableOptions table_options;
+  table_options.compression_dict_reuse_files = kReuseFiles;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(301);
+  for (int i = 0; i < kNumFiles; ++i) {
+    for (int j = 0; j < kNumEntriesPerFile; ++j) {
+      ASSERT_OK(Put(Key(i * kNumEntriesPerFile + j),
+                    rnd.RandomString(kNumBytesPerEntry)));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+  }
+
+  std::vector<std::string> compression_dicts;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::WriteCompressionDictBlock:RawDict",
+      [&](void* arg) {
+        compression_dicts.emplace_back(static_cast<Slice*>(arg)->ToString());
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  CompactRangeOptions compact_range_opts;
+  compact_range_opts.bottommost_level_compaction =
+      BottommostLevelCompaction::kForceOptimized;
+  ASSERT_OK(db_->CompactRange(compact_range_opts, nullptr, nullptr));
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Every file still carries a dictionary. Each trained dictionary is shared
+  // by the next `kReuseFiles` files, and the file after them trains anew.
+  ASSERT_EQ(NumTableFilesAtLevel(1),
+            static_cast<int>(compression_dicts.size()));
+  ASSERT_GT(compression_dicts.size(), size_t{kReuseFiles + 1});
+  for (size_t i = 1; i < compression_dicts.size(); ++i) {
+    if (i % (kReuseFiles + 1) == 0) {
+      ASSERT_NE(compression_dicts[i], compression_dicts[i - 1]);
+    } else {
+      ASSERT_EQ(compression_dicts[i], compression_dicts[i - 1]);
+    }
+  }
+
+  for (int i = 0; i < kNumFiles * kNumEntriesPerFile; i += 97) {
+    ASSERT_EQ(kNumBytesPerEntry, static_cast<int>(Get(Key(i)).size()));
+  }
+}
+
 class PresetCompressionDictTest
     : public DBTestBase,
       public testing::WithParamInterface<std::tuple<CompressionType, bool>> {
@@ -1998,6 +2130,130 @@ TEST_F(DBTest2, CompressionManagerWrapper) {
   }
 }
 
+TEST_F(DBTest2, CompressionManagerDecompressor) {
+  // Test that a custom CompressionManager compatible with the built-in one,
+  // like one offloading to a hardware accelerator, decompresses the blocks
+  // read from files in the built-in format.
+  struct MyDecompressor : public Decompressor {
+    explicit MyDecompressor(std::shared_ptr<Decompressor> wrapped)
+        : wrapped_(std::move(wrapped)) {}
+    const char* Name() const override { return "MyDecompressor"; }
+    Status ExtractUncompressedSize(Args& args) override {
+      return wrapped_->ExtractUncompressedSize(args);
+    }
+    Status DecompressBlock(const Args& args,
+                           char* uncompressed_output) override {
+      num_decompressed++;
+      // The working area, if any, is not one of the wrapped decompressor
+      Args wrapped_args = args;
+      wrapped_args.working_area = nullptr;
+      return wrapped_->DecompressBlock(wrapped_args, uncompressed_output);
+    }
+
+    std::shared_ptr<Decompressor> wrapped_;
+    std::atomic<int> num_decompressed{0};
+  };
+  struct MyManager : public CompressionManagerWrapper {
+    using CompressionManagerWrapper::CompressionManagerWrapper;
+    const char* Name() const override { return "MyManager"; }
+    std::shared_ptr<Decompressor> GetDecompressorOptimizeFor(
+        CompressionType /*optimize_for_type*/) override {
+      return decompressor;
+    }
+
+    std::shared_ptr<MyDecompressor> decompressor =
+        std::make_shared<MyDecompressor>(wrapped_->GetDecompressor());
+  };
+
+  CompressionType type = kNoCompression;
+  for (CompressionType supported : GetSupportedCompressions()) {
+    if (supported != kNoCompression) {
+      type = supported;
+      break;
+    }
+  }
+  if (type == kNoCompression) {
+    ROCKSDB_GTEST_SKIP("No compression library supported");
+    return;
+  }
+
+  auto mgr = std::make_shared<MyManager>(GetDefaultBuiltinCompressionManager());
+  Options options = CurrentOptions();
+  options.compression = type;
+  options.compression_manager = mgr;
+  BlockBasedTableOptions bbto;
+  bbto.no_block_cache = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  constexpr int kCount = 10;
+  std::vector<std::string> values(kCount);
+  for (int i = 0; i < kCount; ++i) {
+    test::CompressibleString(&rnd, 0.1, 10000, &values[i]);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  Reopen(options);
+
+  mgr->decompressor->num_decompressed = 0;
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_EQ(Get(Key(i)), values[i]);
+  }
+  ASSERT_GE(mgr->decompressor->num_decompressed.load(), kCount);
+}
+
+TEST_F(DBTest2, AdaptiveCompressionManager) {
+  AdaptiveCompressionOptions adaptive_opts;
+  for (CompressionType type : GetSupportedCompressions()) {
+    if (type != kNoCompression) {
+      adaptive_opts.candidates.push_back({type});
+    }
+  }
+  if (adaptive_opts.candidates.empty()) {
+    ROCKSDB_GTEST_SKIP("No compression library supported");
+    return;
+  }
+  adaptive_opts.sample_interval = 4;
+
+  for (bool with_budget : {false, true}) {
+    SCOPED_TRACE(with_budget ? "with budget" : "no budget");
+    // No candidate might be within the budget at level 0, so that the
+    // fastest is used there
+    adaptive_opts.max_nanos_per_kb.clear();
+    if (with_budget) {
+      adaptive_opts.max_nanos_per_kb = {0, 1000000};
+    }
+
+    Options options = CurrentOptions();
+    options.compression = ZSTD_Supported()
+                              ? kZSTD
+                              : adaptive_opts.candidates.front().type;
+    options.compression_manager = NewAdaptiveCompressionManager(adaptive_opts);
+    options.statistics = CreateDBStatistics();
+    BlockBasedTableOptions bbto;
+    bbto.no_block_cache = true;
+    options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    constexpr int kCount = 20;
+    std::vector<std::string> values(kCount);
+    for (int i = 0; i < kCount; ++i) {
+      test::CompressibleString(&rnd, 0.1, 10000, &values[i]);
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_GE(options.statistics->getTickerCount(NUMBER_BLOCK_COMPRESSED),
+              kCount);
+
+    Reopen(options);
+    for (int i = 0; i < kCount; ++i) {
+      ASSERT_EQ(Get(Key(i)), values[i]);
+    }
+  }
+}
+
 class CompactionStallTestListener : public EventListener {
  public:
   CompactionStallTestListener()
@@ -2133,6 +2389,38 @@ TEST_F(DBTest2, DuplicateSnapshot) {
   }
 }
 
+TEST_F(DBTest2, OldestSnapshotProperties) {
+  Options options = CurrentOptions();
+  Reopen(options);
+  ASSERT_EQ(0U, GetNumSnapshots());
+  ASSERT_EQ(0U, GetSequenceOldestSnapshots());
+
+  ASSERT_OK(Put("k", "v"));
+  const Snapshot* s1 = db_->GetSnapshot();
+  ASSERT_OK(Put("k", "v"));
+  const Snapshot* s2 = db_->GetSnapshot();
+  ASSERT_OK(Put("k", "v"));
+  const Snapshot* s3 = db_->GetSnapshot();
+  ASSERT_EQ(3U, GetNumSnapshots());
+  ASSERT_EQ(s1->GetSequenceNumber(), GetSequenceOldestSnapshots());
+  ASSERT_EQ(static_cast<uint64_t>(s1->GetUnixTime()),
+            GetTimeOldestSnapshots());
+
+  // Releasing a snapshot other than the oldest keeps the oldest
+  db_->ReleaseSnapshot(s2);
+  ASSERT_EQ(2U, GetNumSnapshots());
+  ASSERT_EQ(s1->GetSequenceNumber(), GetSequenceOldestSnapshots());
+
+  db_->ReleaseSnapshot(s1);
+  ASSERT_EQ(1U, GetNumSnapshots());
+  ASSERT_EQ(s3->GetSequenceNumber(), GetSequenceOldestSnapshots());
+
+  db_->ReleaseSnapshot(s3);
+  ASSERT_EQ(0U, GetNumSnapshots());
+  ASSERT_EQ(0U, GetSequenceOldestSnapshots());
+  ASSERT_EQ(0U, GetTimeOldestSnapshots());
+}
+
 class PinL0IndexAndFilterBlocksTest
     : public DBTestBase,
       public testing::WithParamInterface<std::tuple<bool, bool>> {
@@ -4597,6 +4885,18 @@ TEST_F(DBTest2, TraceAndReplay) {
   ASSERT_EQ(res_handler.GetNumMultiGets(), 0);
   res_handler.Reset();
 
+  // Re-replay using 3 threads dispatched by key, 4x speed.
+  ASSERT_OK(replayer->Prepare());
+  ReplayOptions key_order_options(3, 4.0);
+  key_order_options.preserve_key_order = true;
+  ASSERT_OK(replayer->Replay(key_order_options, res_cb));
+  ASSERT_GE(res_handler.GetAvgLatency(), 0.0);
+  ASSERT_EQ(res_handler.GetNumWrites(), 8);
+  ASSERT_EQ(res_handler.GetNumGets(), 3);
+  ASSERT_EQ(res_handler.GetNumIterSeeks(), 2);
+  ASSERT_EQ(res_handler.GetNumMultiGets(), 0);
+  res_handler.Reset();
+
   replayer.reset();
 
   for (auto handle : handles) {
@@ -8110,6 +8410,54 @@ TEST_F(DBTest2, GetLatestSeqAndTsForKey) {
   ASSERT_EQ(0, options.statistics->getTickerCount(GET_HIT_L0));
 }
 
+TEST_F(DBTest2, GetLatestSeqForKeys) {
+  Options options = CurrentOptions();
+  // No memtable history, so that the flushed keys must be read from the SST
+  // file
+  options.max_write_buffer_size_to_maintain = 0;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  // Keys 0 to 99 in an SST file, the even ones updated in the memtable. The
+  // keys 100 to 109 do not exist.
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v1"));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_OK(Put(Key(i), "v2"));
+  }
+  ASSERT_OK(Delete(Key(50)));
+
+  auto* cfhi = static_cast_with_check<ColumnFamilyHandleImpl>(
+      dbfull()->DefaultColumnFamily());
+  SuperVersion* sv = cfhi->cfd()->GetSuperVersion();
+  std::vector<std::string> keys;
+  for (int i = 0; i < 110; ++i) {
+    keys.push_back(Key(i));
+  }
+  for (bool cache_only : {false, true}) {
+    std::vector<DBImpl::LatestSequenceLookup> lookups;
+    for (const auto& key : keys) {
+      lookups.emplace_back(key, cache_only, /*lower_bound_seq=*/0);
+    }
+    dbfull()->GetLatestSequenceForKeys(sv, &lookups);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      SequenceNumber seq = kMaxSequenceNumber;
+      bool found_record_for_key = false;
+      Status s = dbfull()->GetLatestSequenceForKey(
+          sv, keys[i], cache_only, /*lower_bound_seq=*/0, &seq,
+          /*timestamp=*/nullptr, &found_record_for_key,
+          /*is_blob_index=*/nullptr);
+      ASSERT_EQ(s.IsNotFound(), lookups[i].s.IsNotFound());
+      ASSERT_EQ(found_record_for_key, lookups[i].found_record_for_key);
+      ASSERT_EQ(seq, lookups[i].seq);
+      ASSERT_EQ(found_record_for_key, i < 100 && (!cache_only || i % 2 == 0));
+    }
+  }
+}
+
 #if defined(ZSTD)
 TEST_F(DBTest2, ZSTDChecksum) {
   // Verify that corruption during decompression is caught.
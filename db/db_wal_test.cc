@@ -1321,6 +1321,49 @@ TEST_F(DBWALTest, RecoverWithLargeLog) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, RecoverWithParallelReplay) {
+  Options options = CurrentOptions();
+  options.avoid_flush_during_recovery = false;
+  CreateAndReopenWithCF({"pikachu", "dobrynia", "nikitich"}, options);
+
+  // Batches over all column families, in several WALs
+  std::map<std::pair<int, std::string>, std::string> expected;
+  Random rnd(301);
+  for (int wal = 0; wal < 3; wal++) {
+    for (int i = 0; i < 200; i++) {
+      WriteBatch batch;
+      for (int cf = 0; cf < 4; cf++) {
+        std::string key = Key(rnd.Uniform(100));
+        std::string value = rnd.RandomString(1000);
+        if (rnd.OneIn(10)) {
+          ASSERT_OK(batch.Delete(handles_[cf], key));
+          expected[{cf, key}] = "NOT_FOUND";
+        } else {
+          ASSERT_OK(batch.Put(handles_[cf], key, value));
+          expected[{cf, key}] = value;
+        }
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    }
+    // Switches to a new WAL
+    ASSERT_OK(Put(0, "wal", std::to_string(wal)));
+    ASSERT_OK(Flush(0));
+  }
+  SequenceNumber last_sequence = dbfull()->GetLatestSequenceNumber();
+
+  // Flushes in the middle of the WALs
+  options.write_buffer_size = 64 << 10;
+  options.max_wal_recovery_threads = 3;
+  ReopenWithColumnFamilies({"default", "pikachu", "dobrynia", "nikitich"},
+                           options);
+  ASSERT_EQ(last_sequence, dbfull()->GetLatestSequenceNumber());
+  ASSERT_GT(NumTableFilesAtLevel(0, 1), 1);
+  for (const auto& kv : expected) {
+    ASSERT_EQ(kv.second, Get(kv.first.first, kv.first.second));
+  }
+  ASSERT_EQ("2", Get(0, "wal"));
+}
+
 // In https://reviews.facebook.net/D20661 we change
 // recovery behavior: previously for each log file each column family
 // memtable was flushed, even it was empty. Now it's changed:
@@ -4914,6 +4914,73 @@ TEST_F(DBBasicTestWithTimestamp, TimestampFilterTableReadOnGet) {
   Close();
 }
 
+TEST_F(DBBasicTestWithTimestamp, TimestampFilterFilesOnIterator) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  const size_t kTimestampSize = Timestamp(0, 0).size();
+  TestComparator test_cmp(kTimestampSize);
+  options.comparator = &test_cmp;
+  BlockBasedTableOptions bbto;
+  bbto.no_block_cache = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  // file1: key => [1, 2], timestamp => [10, 20], in L1
+  // file2: key => [3, 4], timestamp => [30, 40], in L1
+  // file3: key => [5, 5], timestamp => [50, 50], in L0
+  WriteOptions write_opts;
+  ASSERT_OK(db_->Put(write_opts, Key1(1), Timestamp(10, 0), "value1"));
+  ASSERT_OK(db_->Put(write_opts, Key1(2), Timestamp(20, 0), "value2"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(db_->Put(write_opts, Key1(3), Timestamp(30, 0), "value3"));
+  ASSERT_OK(db_->Put(write_opts, Key1(4), Timestamp(40, 0), "value4"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(db_->Put(write_opts, Key1(5), Timestamp(50, 0), "value5"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,2", FilesPerLevel());
+
+  // The timestamp ranges of the files survive a reopen
+  Reopen(options);
+
+  auto scan = [&](uint64_t read_ts, uint64_t* block_reads) {
+    std::string read_ts_str = Timestamp(read_ts, 0);
+    Slice read_ts_slice = read_ts_str;
+    ReadOptions read_opts;
+    read_opts.timestamp = &read_ts_slice;
+    get_perf_context()->Reset();
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_opts));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      count++;
+    }
+    EXPECT_OK(iter->status());
+    *block_reads = get_perf_context()->block_read_count;
+    return count;
+  };
+
+  SetPerfLevel(kEnableCount);
+  uint64_t all_reads = 0;
+  ASSERT_EQ(5, scan(60, &all_reads));
+  ASSERT_GT(all_reads, 0u);
+
+  // file2 and file3 are skipped without reading any of their blocks
+  uint64_t reads = 0;
+  ASSERT_EQ(2, scan(25, &reads));
+  ASSERT_GT(reads, 0u);
+  ASSERT_LT(reads, all_reads);
+
+  // Every file is newer than the read
+  ASSERT_EQ(0, scan(5, &reads));
+  ASSERT_EQ(0u, reads);
+  SetPerfLevel(kDisable);
+
+  Close();
+}
+
 class GetNewestUserDefinedTimestampTest : public DBBasicTestWithTimestampBase {
  public:
   explicit GetNewestUserDefinedTimestampTest()
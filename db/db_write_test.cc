@@ -722,6 +722,44 @@ TEST_P(DBWriteTest, LockWALInEffect) {
   Close();
 }
 
+TEST_P(DBWriteTest, PerCoreWriteQueues) {
+  Options options = GetOptions();
+  options.enable_write_thread_per_core_queues = true;
+  Reopen(options);
+
+  const int kNumThreads = 16;
+  const int kKeysPerThread = 200;
+  auto write_func = [&](int t) {
+    for (int i = 0; i < kKeysPerThread; i++) {
+      std::string key = Key(t * kKeysPerThread + i);
+      ASSERT_OK(Put(key, "v" + key));
+    }
+  };
+
+  // Writers pile up in the staging queues behind the write stall
+  ASSERT_OK(db_->LockWAL());
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads / 2; t++) {
+    threads.emplace_back(write_func, t);
+  }
+  // Writers with no_slowdown are not staged, and fail right away
+  WriteOptions no_slowdown;
+  no_slowdown.no_slowdown = true;
+  ASSERT_TRUE(db_->Put(no_slowdown, "foo", "bar").IsIncomplete());
+  ASSERT_OK(db_->UnlockWAL());
+  for (int t = kNumThreads / 2; t < kNumThreads; t++) {
+    threads.emplace_back(write_func, t);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (int k = 0; k < kNumThreads * kKeysPerThread; k++) {
+    ASSERT_EQ("v" + Key(k), Get(Key(k)));
+  }
+  ASSERT_EQ("NOT_FOUND", Get("foo"));
+}
+
 TEST_P(DBWriteTest, LockWALConcurrentRecursive) {
   // This is a micro-stress test of LockWAL and concurrency handling.
   // It is considered the most convenient way to balance functional
@@ -1390,6 +1390,48 @@ TEST_F(ExternalSSTFileBasicTest, VerifyChecksumReadahead) {
   Destroy(options);
 }
 
+TEST_F(ExternalSSTFileBasicTest, ParallelPrepare) {
+  Options options = CurrentOptions();
+  options.file_checksum_gen_factory = GetFileChecksumGenCrc32cFactory();
+  DestroyAndReopen(options);
+
+  const int kNumFiles = 16;
+  std::vector<std::string> files;
+  for (int f = 0; f < kNumFiles; f++) {
+    SstFileWriter sst_file_writer(EnvOptions(), options);
+    files.push_back(sst_files_dir_ + "parallel_" + std::to_string(f) + ".sst");
+    ASSERT_OK(sst_file_writer.Open(files.back()));
+    for (int i = f * 100; i < (f + 1) * 100; i++) {
+      ASSERT_OK(sst_file_writer.Put(Key(i), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(sst_file_writer.Finish());
+  }
+
+  IngestExternalFileOptions ingest_opt;
+  ingest_opt.verify_checksums_before_ingest = true;
+  ingest_opt.max_prepare_threads = 4;
+  // A missing file fails the ingestion with nothing left in the DB
+  std::vector<std::string> with_missing = files;
+  with_missing.push_back(sst_files_dir_ + "missing.sst");
+  ASSERT_NOK(db_->IngestExternalFile(with_missing, ingest_opt));
+  std::vector<std::string> db_files;
+  ASSERT_OK(env_->GetChildren(dbname_, &db_files));
+  for (const auto& fname : db_files) {
+    ASSERT_EQ(std::string::npos, fname.find(".sst")) << fname;
+  }
+
+  ASSERT_OK(db_->IngestExternalFile(files, ingest_opt));
+  for (int i = 0; i < kNumFiles * 100; i++) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+  std::vector<LiveFileMetaData> live_files;
+  db_->GetLiveFilesMetaData(&live_files);
+  ASSERT_EQ(kNumFiles, live_files.size());
+  for (const auto& file : live_files) {
+    ASSERT_EQ("FileChecksumCrc32c", file.file_checksum_func_name);
+  }
+}
+
 TEST_F(ExternalSSTFileBasicTest, ReadOldValueOfIngestedKeyBug) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleUniversal;
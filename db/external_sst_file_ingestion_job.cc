@@ -6,6 +6,7 @@
 #include "db/external_sst_file_ingestion_job.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <string>
 #include <unordered_set>
@@ -35,14 +36,17 @@ Status ExternalSstFileIngestionJob::Prepare(
   Status status;
 
   // Read the information of files we are ingesting
-  for (const std::string& file_path : external_files_paths) {
-    IngestedFileInfo file_to_ingest;
+  files_to_ingest_.resize(external_files_paths.size());
+  std::atomic<uint64_t> warm_cache_bytes_read{0};
+  status = ForEachFile(files_to_ingest_.size(), [&](size_t i) {
+    IngestedFileInfo& file_to_ingest = files_to_ingest_[i];
     // For temperature, first assume it matches provided hint
     file_to_ingest.file_temperature = file_temperature;
-    status =
-        GetIngestedFileInfo(file_path, next_file_number++, &file_to_ingest, sv);
-    if (!status.ok()) {
-      return status;
+    Status s = GetIngestedFileInfo(external_files_paths[i],
+                                   next_file_number + i, &file_to_ingest, sv,
+                                   &warm_cache_bytes_read);
+    if (!s.ok()) {
+      return s;
     }
 
     // Files generated in another DB or CF may have a different column family
@@ -64,8 +68,10 @@ Status ExternalSstFileIngestionJob::Prepare(
         !file_to_ingest.largest_internal_key.Valid()) {
       return Status::Corruption("Generated table have corrupted keys");
     }
-
-    files_to_ingest_.emplace_back(std::move(file_to_ingest));
+    return Status::OK();
+  });
+  if (!status.ok()) {
+    return status;
   }
 
   auto num_files = files_to_ingest_.size();
@@ -143,49 +149,49 @@ Status ExternalSstFileIngestionJob::Prepare(
   }
 
   // Copy/Move external files into DB
-  std::unordered_set<size_t> ingestion_path_ids;
-  for (IngestedFileInfo& f : files_to_ingest_) {
+  status = ForEachFile(files_to_ingest_.size(), [&](size_t i) {
+    IngestedFileInfo& f = files_to_ingest_[i];
+    Status s;
     f.copy_file = false;
     const std::string path_outside_db = f.external_file_path;
     const std::string path_inside_db = TableFileName(
         cfd_->ioptions().cf_paths, f.fd.GetNumber(), f.fd.GetPathId());
     if (ingestion_options_.move_files || ingestion_options_.link_files) {
-      status =
-          fs_->LinkFile(path_outside_db, path_inside_db, IOOptions(), nullptr);
-      if (status.ok()) {
+      s = fs_->LinkFile(path_outside_db, path_inside_db, IOOptions(), nullptr);
+      if (s.ok()) {
         // It is unsafe to assume application had sync the file and file
         // directory before ingest the file. For integrity of RocksDB we need
         // to sync the file.
         std::unique_ptr<FSWritableFile> file_to_sync;
-        Status s = fs_->ReopenWritableFile(path_inside_db, env_options_,
-                                           &file_to_sync, nullptr);
+        Status reopen_s = fs_->ReopenWritableFile(path_inside_db, env_options_,
+                                                  &file_to_sync, nullptr);
         TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::Prepare:Reopen",
-                                 &s);
+                                 &reopen_s);
         // Some file systems (especially remote/distributed) don't support
         // reopening a file for writing and don't require reopening and
         // syncing the file. Ignore the NotSupported error in that case.
-        if (!s.IsNotSupported()) {
-          status = s;
-          if (status.ok()) {
+        if (!reopen_s.IsNotSupported()) {
+          s = reopen_s;
+          if (s.ok()) {
             TEST_SYNC_POINT(
                 "ExternalSstFileIngestionJob::BeforeSyncIngestedFile");
-            status = SyncIngestedFile(file_to_sync.get());
+            s = SyncIngestedFile(file_to_sync.get());
             TEST_SYNC_POINT(
                 "ExternalSstFileIngestionJob::AfterSyncIngestedFile");
-            if (!status.ok()) {
+            if (!s.ok()) {
               ROCKS_LOG_WARN(db_options_.info_log,
                              "Failed to sync ingested file %s: %s",
-                             path_inside_db.c_str(), status.ToString().c_str());
+                             path_inside_db.c_str(), s.ToString().c_str());
             }
           }
         }
-      } else if (status.IsNotSupported() &&
+      } else if (s.IsNotSupported() &&
                  ingestion_options_.failed_move_fall_back_to_copy) {
         // Original file is on a different FS, use copy instead of hard linking.
         f.copy_file = true;
         ROCKS_LOG_INFO(db_options_.info_log,
                        "Tried to link file %s but it's not supported : %s",
-                       path_outside_db.c_str(), status.ToString().c_str());
+                       path_outside_db.c_str(), s.ToString().c_str());
       }
     } else {
       f.copy_file = true;
@@ -205,9 +211,9 @@ Status ExternalSstFileIngestionJob::Prepare(
               ? sv->mutable_cf_options.last_level_temperature
               : sv->mutable_cf_options.default_write_temperature;
       // Note: CopyFile also syncs the new file.
-      status = CopyFile(fs_.get(), path_outside_db, f.file_temperature,
-                        path_inside_db, dst_temp, 0, db_options_.use_fsync,
-                        io_tracer_);
+      s = CopyFile(fs_.get(), path_outside_db, f.file_temperature,
+                   path_inside_db, dst_temp, 0, db_options_.use_fsync,
+                   io_tracer_);
       // The destination of the copy will be ingested
       f.file_temperature = dst_temp;
     } else {
@@ -215,14 +221,20 @@ Status ExternalSstFileIngestionJob::Prepare(
       // temperatures, so no need to change f.file_temperature
     }
     TEST_SYNC_POINT("ExternalSstFileIngestionJob::Prepare:FileAdded");
-    if (!status.ok()) {
-      break;
+    if (!s.ok()) {
+      return s;
     }
     f.internal_file_path = path_inside_db;
     // Initialize the checksum information of ingested files.
     f.file_checksum = kUnknownFileChecksum;
     f.file_checksum_func_name = kUnknownFileChecksumFuncName;
-    ingestion_path_ids.insert(f.fd.GetPathId());
+    return s;
+  });
+  std::unordered_set<size_t> ingestion_path_ids;
+  for (const IngestedFileInfo& f : files_to_ingest_) {
+    if (!f.internal_file_path.empty()) {
+      ingestion_path_ids.insert(f.fd.GetPathId());
+    }
   }
 
   TEST_SYNC_POINT("ExternalSstFileIngestionJob::BeforeSyncDir");
@@ -268,9 +280,12 @@ Status ExternalSstFileIngestionJob::Prepare(
     std::vector<std::string> generated_checksum_func_names;
     // Step 1: generate the checksum for ingested sst file.
     if (need_generate_file_checksum_) {
-      for (size_t i = 0; i < files_to_ingest_.size(); i++) {
-        std::string generated_checksum;
-        std::string generated_checksum_func_name;
+      generated_checksums.resize(files_to_ingest_.size());
+      generated_checksum_func_names.resize(files_to_ingest_.size());
+      status = ForEachFile(files_to_ingest_.size(), [&](size_t i) {
+        std::string& generated_checksum = generated_checksums[i];
+        std::string& generated_checksum_func_name =
+            generated_checksum_func_names[i];
         std::string requested_checksum_func_name;
         // TODO: rate limit file reads for checksum calculation during file
         // ingestion.
@@ -286,21 +301,19 @@ Status ExternalSstFileIngestionJob::Prepare(
             db_options_.rate_limiter.get(), ro, db_options_.stats,
             db_options_.clock);
         if (!io_s.ok()) {
-          status = io_s;
           ROCKS_LOG_WARN(db_options_.info_log,
                          "Sst file checksum generation of file: %s failed: %s",
                          files_to_ingest_[i].internal_file_path.c_str(),
-                         status.ToString().c_str());
-          break;
+                         io_s.ToString().c_str());
+          return Status(io_s);
         }
         if (ingestion_options_.write_global_seqno == false) {
           files_to_ingest_[i].file_checksum = generated_checksum;
           files_to_ingest_[i].file_checksum_func_name =
               generated_checksum_func_name;
         }
-        generated_checksums.push_back(generated_checksum);
-        generated_checksum_func_names.push_back(generated_checksum_func_name);
-      }
+        return Status::OK();
+      });
     }
 
     // Step 2: based on the verify_file_checksum and ingested checksum
@@ -379,6 +392,40 @@ Status ExternalSstFileIngestionJob::Prepare(
   return status;
 }
 
+Status ExternalSstFileIngestionJob::ForEachFile(
+    size_t num_files, const std::function<Status(size_t)>& func) {
+  std::vector<Status> statuses(num_files);
+  std::atomic<size_t> next_file{0};
+  std::atomic<bool> failed{false};
+  auto worker = [&]() {
+    for (size_t i = next_file.fetch_add(1);
+         i < num_files && !failed.load(std::memory_order_relaxed);
+         i = next_file.fetch_add(1)) {
+      statuses[i] = func(i);
+      if (!statuses[i].ok()) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+  const size_t num_threads = std::min(
+      static_cast<size_t>(std::max(ingestion_options_.max_prepare_threads, 1)),
+      num_files);
+  std::vector<port::Thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& s : statuses) {
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
 void ExternalSstFileIngestionJob::DivideInputFilesIntoBatches() {
   if (!files_overlap_) {
     // No overlap, treat as one batch without the need of tracking overall batch
@@ -630,6 +677,7 @@ Status ExternalSstFileIngestionJob::AssignLevelsForOneBatch(
         tail_size, file->user_defined_timestamps_persisted);
     f_metadata.temperature = file->file_temperature;
     f_metadata.marked_for_compaction = marked_for_compaction;
+    f_metadata.SetTimestampRange(file->table_properties);
     edit_.AddFile(file->picked_level, f_metadata);
 
     *batch_uppermost_level =
@@ -829,7 +877,9 @@ Status ExternalSstFileIngestionJob::ResetTableReader(
                                  nullptr /*Env*/, io_tracer_));
   table_reader->reset();
   ReadOptions ro;
-  ro.fill_cache = ingestion_options_.fill_cache;
+  const bool fill_cache =
+      ingestion_options_.fill_cache || ingestion_options_.warm_cache;
+  ro.fill_cache = fill_cache;
   status = sv->mutable_cf_options.table_factory->NewTableReader(
       ro,
       TableReaderOptions(
@@ -845,7 +895,7 @@ Status ExternalSstFileIngestionJob::ResetTableReader(
           /* tail_size */ 0, user_defined_timestamps_persisted),
       std::move(sst_file_reader), file_to_ingest->file_size, table_reader,
       // No need to prefetch index/filter if caching is not needed.
-      /*prefetch_index_and_filter_in_cache=*/ingestion_options_.fill_cache);
+      /*prefetch_index_and_filter_in_cache=*/fill_cache);
   return status;
 }
 
@@ -954,7 +1004,8 @@ Status ExternalSstFileIngestionJob::SanityCheckTableProperties(
 
 Status ExternalSstFileIngestionJob::GetIngestedFileInfo(
     const std::string& external_file, uint64_t new_file_number,
-    IngestedFileInfo* file_to_ingest, SuperVersion* sv) {
+    IngestedFileInfo* file_to_ingest, SuperVersion* sv,
+    std::atomic<uint64_t>* warm_cache_bytes_read) {
   file_to_ingest->external_file_path = external_file;
 
   // Get external file size
@@ -1128,6 +1179,15 @@ Status ExternalSstFileIngestionJob::GetIngestedFileInfo(
     file_to_ingest->limit_ukey.assign(largest.data(), largest.size());
   }
 
+  if (ingestion_options_.warm_cache) {
+    Status warm_status = WarmCache(table_reader.get(), warm_cache_bytes_read);
+    if (!warm_status.ok()) {
+      ROCKS_LOG_WARN(db_options_.info_log,
+                     "Failed to warm the block cache for file %s: %s",
+                     external_file.c_str(), warm_status.ToString().c_str());
+    }
+  }
+
   auto s =
       GetSstInternalUniqueId(file_to_ingest->table_properties.db_id,
                              file_to_ingest->table_properties.db_session_id,
@@ -1143,6 +1203,39 @@ Status ExternalSstFileIngestionJob::GetIngestedFileInfo(
   return status;
 }
 
+Status ExternalSstFileIngestionJob::WarmCache(
+    TableReader* table_reader, std::atomic<uint64_t>* bytes_read) {
+  ReadOptions ro;
+  ro.fill_cache = true;
+  ro.rate_limiter_priority = Env::IO_LOW;
+  TableReader::PrefetchOptions prefetch_options;
+  prefetch_options.caller = TableReaderCaller::kWarmup;
+  prefetch_options.stop_at_cache_capacity =
+      ingestion_options_.warm_cache_stop_at_cache_capacity;
+  prefetch_options.index_and_filter_partitions = true;
+  prefetch_options.data_blocks =
+      ingestion_options_.warm_cache_data_blocks &&
+      (ingestion_options_.warm_cache_max_bytes == 0 ||
+       bytes_read->load(std::memory_order_relaxed) <
+           ingestion_options_.warm_cache_max_bytes);
+  TableReader::PrefetchStats stats;
+  Status s = table_reader->Prefetch(ro, /*begin=*/nullptr, /*end=*/nullptr,
+                                    &stats, &prefetch_options);
+  if (s.IsIncomplete()) {
+    // The block cache is full, what was loaded stays.
+    s = Status::OK();
+  }
+  bytes_read->fetch_add(stats.bytes_read, std::memory_order_relaxed);
+  RecordTick(db_options_.stats, WARMUP_BLOCKS_INSERTED, stats.blocks_loaded);
+  RecordTick(db_options_.stats, WARMUP_BYTES_READ, stats.bytes_read);
+  RecordTick(db_options_.stats, WARMUP_BLOCKS_ALREADY_CACHED,
+             stats.blocks_already_cached);
+  RecordTick(db_options_.stats, WARMUP_BLOCKS_SKIPPED, stats.blocks_skipped);
+  RecordTick(db_options_.stats, WARMUP_BYTES_SKIPPED, stats.bytes_skipped);
+  TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::WarmCache", &stats);
+  return s;
+}
+
 Status ExternalSstFileIngestionJob::AssignLevelAndSeqnoForIngestedFile(
     SuperVersion* sv, bool force_global_seqno, CompactionStyle compaction_style,
     SequenceNumber last_seqno, IngestedFileInfo* file_to_ingest,
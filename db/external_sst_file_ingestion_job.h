@@ -4,6 +4,8 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #pragma once
+#include <atomic>
+#include <functional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -309,11 +311,26 @@ class ExternalSstFileIngestionJob {
                                     std::unique_ptr<TableReader>* table_reader);
 
   // Open the external file and populate `file_to_ingest` with all the
-  // external information we need to ingest this file.
+  // external information we need to ingest this file. The file is also
+  // warmed if the job asks for it, see WarmCache().
   Status GetIngestedFileInfo(const std::string& external_file,
                              uint64_t new_file_number,
                              IngestedFileInfo* file_to_ingest,
-                             SuperVersion* sv);
+                             SuperVersion* sv,
+                             std::atomic<uint64_t>* warm_cache_bytes_read);
+
+  // Loads the blocks of a file to ingest into the block cache through
+  // `table_reader`, whose cache keys are those of the file once ingested, see
+  // IngestExternalFileOptions::warm_cache. `bytes_read` counts the bytes of
+  // data blocks read for all the files of the job.
+  Status WarmCache(TableReader* table_reader,
+                   std::atomic<uint64_t>* bytes_read);
+
+  // Runs `func` on the index of each of `num_files` files on up to
+  // `max_prepare_threads` threads, including the calling one. Stops at the
+  // first failure and returns the error of the lowest index that failed.
+  Status ForEachFile(size_t num_files,
+                     const std::function<Status(size_t)>& func);
 
   // If the input files' key range overlaps themselves, this function divides
   // them in the user specified order into multiple batches. Where the files
@@ -360,6 +360,50 @@ TEST_F(ExternalSSTFileTest, NoBlockCache) {
   }
 }
 
+TEST_F(ExternalSSTFileTest, WarmCache) {
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(32 << 20);
+  table_options.block_size = 1024;
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  auto write_file = [&](const std::string& file, int first, int last) {
+    SstFileWriter sst_file_writer(EnvOptions(), options);
+    ASSERT_OK(sst_file_writer.Open(file));
+    for (int k = first; k <= last; k++) {
+      ASSERT_OK(sst_file_writer.Put(Key(k), std::string(100, 'v')));
+    }
+    ASSERT_OK(sst_file_writer.Finish());
+  };
+  IngestExternalFileOptions ifo;
+  ifo.fill_cache = false;
+  ifo.warm_cache = true;
+
+  // Only the index and filter blocks.
+  ifo.warm_cache_data_blocks = false;
+  write_file(sst_files_dir_ + "file1.sst", 0, 99);
+  ASSERT_OK(db_->IngestExternalFile({sst_files_dir_ + "file1.sst"}, ifo));
+  ASSERT_EQ(0U, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+
+  ifo.warm_cache_data_blocks = true;
+  write_file(sst_files_dir_ + "file2.sst", 100, 199);
+  ASSERT_OK(db_->IngestExternalFile({sst_files_dir_ + "file2.sst"}, ifo));
+  const uint64_t warmed = TestGetTickerCount(options, WARMUP_BLOCKS_INSERTED);
+  ASSERT_GT(warmed, 1U);
+  ASSERT_EQ(warmed, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+
+  // The blocks were cached under the keys of the ingested file.
+  const uint64_t misses_before_reads =
+      TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  for (int k = 100; k < 200; k++) {
+    ASSERT_EQ(std::string(100, 'v'), Get(Key(k)));
+  }
+  ASSERT_EQ(misses_before_reads,
+            TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+}
+
 TEST_F(ExternalSSTFileTest, Basic) {
   do {
     Options options = CurrentOptions();
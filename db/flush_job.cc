@@ -11,9 +11,12 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <climits>
 #include <vector>
 
 #include "db/builder.h"
+#include "db/compaction/clipping_iterator.h"
+#include "db/compaction/compaction.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
@@ -27,6 +30,7 @@
 #include "db/version_set.h"
 #include "file/file_util.h"
 #include "file/filename.h"
+#include "file/sst_file_manager_impl.h"
 #include "logging/event_logger.h"
 #include "logging/log_buffer.h"
 #include "logging/logging.h"
@@ -139,7 +143,10 @@ FlushJob::FlushJob(
   TEST_SYNC_POINT("FlushJob::FlushJob()");
 }
 
-FlushJob::~FlushJob() { ThreadStatusUtil::ResetThreadStatus(); }
+FlushJob::~FlushJob() {
+  assert(output_range_compaction_ == nullptr);
+  ThreadStatusUtil::ResetThreadStatus();
+}
 
 void FlushJob::ReportStartedFlush() {
   ThreadStatusUtil::SetEnableTracking(db_options_.enable_thread_tracking);
@@ -166,6 +173,151 @@ void FlushJob::RecordFlushIOStats() {
       ThreadStatus::FLUSH_BYTES_WRITTEN, IOSTATS(bytes_written));
   IOSTATS_RESET(bytes_written);
 }
+
+std::vector<std::string> FlushJob::PickPartitionBoundaries(
+    uint64_t total_data_size, uint64_t num_range_deletes) const {
+  std::vector<std::string> boundaries;
+  const uint64_t target_file_size =
+      std::max<uint64_t>(mutable_cf_options_.target_file_size_base, 1);
+  const uint64_t num_partitions = std::min<uint64_t>(
+      db_options_.max_flush_partitions, total_data_size / target_file_size);
+  const Comparator* ucmp = cfd_->internal_comparator().user_comparator();
+  // The range tombstones and blob files of a flush are not split, and the
+  // keys are sampled from skip lists
+  if (num_partitions <= 1 || num_range_deletes > 0 ||
+      mutable_cf_options_.enable_blob_files || ucmp->timestamp_size() > 0 ||
+      !cfd_->ioptions().memtable_factory->IsInstanceOf(
+          SkipListFactory::kClassName())) {
+    return boundaries;
+  }
+  for (ReadOnlyMemTable* m : mems_) {
+    if (dynamic_cast<MemTable*>(m) == nullptr) {
+      return boundaries;
+    }
+  }
+
+  // Samples of the user keys from each memtable in proportion to its size
+  constexpr uint64_t kSamplesPerPartition = 64;
+  std::vector<std::string> samples;
+  for (ReadOnlyMemTable* m : mems_) {
+    const uint64_t target_sample_size = std::max<uint64_t>(
+        kSamplesPerPartition * num_partitions * m->GetDataSize() /
+            total_data_size,
+        1);
+    std::unordered_set<const char*> entries;
+    m->UniqueRandomSample(target_sample_size, &entries);
+    for (const char* entry : entries) {
+      samples.push_back(
+          ExtractUserKey(GetLengthPrefixedSlice(entry)).ToString());
+    }
+  }
+  std::sort(samples.begin(), samples.end(),
+            [ucmp](const std::string& a, const std::string& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  for (uint64_t i = 1; i < num_partitions && !samples.empty(); i++) {
+    const std::string& key = samples[i * samples.size() / num_partitions];
+    if (ucmp->Compare(key, samples.front()) > 0 &&
+        (boundaries.empty() || ucmp->Compare(boundaries.back(), key) < 0)) {
+      boundaries.push_back(key);
+    }
+  }
+  return boundaries;
+}
+
+int FlushJob::PickOutputLevel(const std::vector<const FileMetaData*>& outputs) {
+  db_mutex_->AssertHeld();
+  const ImmutableOptions& ioptions = cfd_->ioptions();
+  const Comparator* ucmp = cfd_->internal_comparator().user_comparator();
+  if (!mutable_cf_options_.allow_flush_below_level0 || outputs.empty() ||
+      ioptions.compaction_style != kCompactionStyleLevel ||
+      ioptions.num_levels < 2 || db_options_.atomic_flush || !write_manifest_ ||
+      ucmp->timestamp_size() > 0 || cfd_->IsDropped()) {
+    return 0;
+  }
+  // The memtables older than the flushed ones would be flushed to L0 later,
+  // above the newer data of the output files
+  const uint64_t earliest_id = cfd_->imm()->GetEarliestMemTableID();
+  if (std::none_of(mems_.begin(), mems_.end(), [&](ReadOnlyMemTable* m) {
+        return m->GetID() == earliest_id;
+      })) {
+    return 0;
+  }
+
+  Slice smallest = outputs.front()->smallest.user_key();
+  Slice largest = outputs.front()->largest.user_key();
+  for (const FileMetaData* f : outputs) {
+    if (ucmp->Compare(f->smallest.user_key(), smallest) < 0) {
+      smallest = f->smallest.user_key();
+    }
+    if (ucmp->Compare(f->largest.user_key(), largest) > 0) {
+      largest = f->largest.user_key();
+    }
+  }
+  int max_level = ioptions.num_levels - 1;
+  if (db_options_.allow_ingest_behind ||
+      mutable_cf_options_.preclude_last_level_data_seconds > 0) {
+    max_level--;
+  }
+  // Like an ingested file, the output files can go down to the level above
+  // the first one holding or compacting into keys of their range
+  VersionStorageInfo* vstorage = cfd_->current()->storage_info();
+  int output_level = 0;
+  for (int lvl = 0; lvl <= max_level; lvl++) {
+    if (lvl > 0 && lvl < vstorage->base_level()) {
+      continue;
+    }
+    if (cfd_->RangeOverlapWithCompaction(smallest, largest, lvl) ||
+        vstorage->OverlapInLevel(lvl, &smallest, &largest)) {
+      break;
+    }
+    output_level = lvl;
+  }
+  TEST_SYNC_POINT_CALLBACK("FlushJob::PickOutputLevel", &output_level);
+  if (output_level == 0) {
+    return 0;
+  }
+
+  output_range_files_.reserve(outputs.size());
+  CompactionInputFiles input;
+  input.level = 0;
+  for (const FileMetaData* f : outputs) {
+    output_range_files_.push_back(*f);
+    input.files.push_back(&output_range_files_.back());
+  }
+  output_range_compaction_.reset(new Compaction(
+      vstorage, ioptions, mutable_cf_options_, MutableDBOptions(), {input},
+      output_level,
+      MaxFileSizeForLevel(mutable_cf_options_, output_level,
+                          ioptions.compaction_style),
+      LLONG_MAX /* max compaction bytes, not applicable */,
+      0 /* output path ID, not applicable */, mutable_cf_options_.compression,
+      mutable_cf_options_.compression_opts,
+      mutable_cf_options_.default_write_temperature,
+      1 /* max_subcompactions, not applicable */,
+      {} /* grandparents, not applicable */,
+      std::nullopt /* earliest_snapshot */, nullptr /* snapshot_checker */,
+      false /* is manual */, "" /* trim_ts */, -1 /* score, not applicable */,
+      false /* is deletion compaction, not applicable */,
+      false /* l0_files_might_overlap, not applicable */,
+      CompactionReason::kFlush));
+  cfd_->compaction_picker()->RegisterCompaction(output_range_compaction_.get());
+  ROCKS_LOG_BUFFER(log_buffer_, "[%s] [JOB %d] Flushing %zu files to level %d",
+                   cfd_->GetName().c_str(), job_context_->job_id,
+                   outputs.size(), output_level);
+  return output_level;
+}
+
+void FlushJob::UnregisterOutputRange() {
+  db_mutex_->AssertHeld();
+  if (output_range_compaction_ != nullptr) {
+    cfd_->compaction_picker()->UnregisterCompaction(
+        output_range_compaction_.get());
+    output_range_compaction_.reset();
+  }
+  output_range_files_.clear();
+}
+
 void FlushJob::PickMemTable() {
   db_mutex_->AssertHeld();
   assert(!pick_memtable_called);
@@ -331,6 +483,9 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker, FileMetaData* file_meta,
                               or new level 0 file path to write to manifest. */);
     }
   }
+  // The flush is installed or rolled back by now, since no older memtables
+  // were left to commit before it.
+  UnregisterOutputRange();
 
   if (s.ok() && file_meta != nullptr) {
     *file_meta = meta_;
@@ -862,6 +1017,9 @@ Status FlushJob::WriteLevel0Table() {
       ts_sz > 0 && !cfd_->ioptions().persist_user_defined_timestamps;
 
   std::vector<BlobFileAddition> blob_file_additions;
+  // The files of the key ranges after the first one, when the flush builds
+  // several files
+  std::vector<FileMetaData> partition_metas;
   // Note that here we treat flush as level 0 compaction in internal stats
   InternalStats::CompactionStats flush_stats(CompactionReason::kFlush,
                                              1 /* count**/);
@@ -938,6 +1096,9 @@ Status FlushJob::WriteLevel0Table() {
                          << "flush_reason"
                          << GetFlushReasonString(flush_reason_);
 
+    const std::vector<std::string> partition_boundaries =
+        PickPartitionBoundaries(total_data_size, total_num_range_deletes);
+
     {
       ScopedArenaPtr<InternalIterator> iter(
           NewMergingIterator(&cfd_->internal_comparator(), memtables.data(),
@@ -982,31 +1143,147 @@ Status FlushJob::WriteLevel0Table() {
       ReadOptions read_options(Env::IOActivity::kFlush);
       read_options.rate_limiter_priority = io_priority;
       const WriteOptions write_options(io_priority, Env::IOActivity::kFlush);
-      TableBuilderOptions tboptions(
-          cfd_->ioptions(), mutable_cf_options_, read_options, write_options,
-          cfd_->internal_comparator(), cfd_->internal_tbl_prop_coll_factories(),
-          output_compression_, mutable_cf_options_.compression_opts,
-          cfd_->GetID(), cfd_->GetName(), 0 /* level */,
-          current_time /* newest_key_time */, false /* is_bottommost */,
-          TableFileCreationReason::kFlush, oldest_key_time, current_time,
-          db_id_, db_session_id_, 0 /* target_file_size */,
-          meta_.fd.GetNumber(),
-          preclude_last_level_min_seqno_ == kMaxSequenceNumber
-              ? preclude_last_level_min_seqno_
-              : std::min(earliest_snapshot_, preclude_last_level_min_seqno_));
-      s = BuildTable(
-          dbname_, versions_, db_options_, tboptions, file_options_,
-          cfd_->table_cache(), iter.get(), std::move(range_del_iters), &meta_,
-          &blob_file_additions, job_context_->snapshot_seqs, earliest_snapshot_,
-          job_context_->earliest_write_conflict_snapshot,
-          job_context_->GetJobSnapshotSequence(),
-          job_context_->snapshot_checker,
-          mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
-          &io_s, io_tracer_, BlobFileCreationReason::kFlush,
-          seqno_to_time_mapping_.get(), event_logger_, job_context_->job_id,
-          &table_properties_, write_hint, full_history_ts_low, blob_callback_,
-          base_, &memtable_payload_bytes, &memtable_garbage_bytes,
-          &flush_stats);
+      auto new_tboptions = [&](uint64_t file_number) {
+        return TableBuilderOptions(
+            cfd_->ioptions(), mutable_cf_options_, read_options, write_options,
+            cfd_->internal_comparator(),
+            cfd_->internal_tbl_prop_coll_factories(), output_compression_,
+            mutable_cf_options_.compression_opts, cfd_->GetID(),
+            cfd_->GetName(), 0 /* level */,
+            current_time /* newest_key_time */, false /* is_bottommost */,
+            TableFileCreationReason::kFlush, oldest_key_time, current_time,
+            db_id_, db_session_id_, 0 /* target_file_size */, file_number,
+            preclude_last_level_min_seqno_ == kMaxSequenceNumber
+                ? preclude_last_level_min_seqno_
+                : std::min(earliest_snapshot_,
+                           preclude_last_level_min_seqno_));
+      };
+      TableBuilderOptions tboptions = new_tboptions(meta_.fd.GetNumber());
+      uint64_t num_table_entries = 0;
+      if (partition_boundaries.empty()) {
+        s = BuildTable(
+            dbname_, versions_, db_options_, tboptions, file_options_,
+            cfd_->table_cache(), iter.get(), std::move(range_del_iters),
+            &meta_, &blob_file_additions, job_context_->snapshot_seqs,
+            earliest_snapshot_, job_context_->earliest_write_conflict_snapshot,
+            job_context_->GetJobSnapshotSequence(),
+            job_context_->snapshot_checker,
+            mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
+            &io_s, io_tracer_, BlobFileCreationReason::kFlush,
+            seqno_to_time_mapping_.get(), event_logger_, job_context_->job_id,
+            &table_properties_, write_hint, full_history_ts_low,
+            blob_callback_, base_, &memtable_payload_bytes,
+            &memtable_garbage_bytes, &flush_stats);
+        num_table_entries = table_properties_.num_entries;
+      } else {
+        // One file per key range, the first one being meta_. Each range goes
+        // through its own iterators of the memtables, clipped to the range.
+        const size_t num_partitions = partition_boundaries.size() + 1;
+        std::vector<std::string> bounds;
+        for (const auto& user_key : partition_boundaries) {
+          bounds.push_back(
+              InternalKey(user_key, kMaxSequenceNumber, kValueTypeForSeek)
+                  .Encode()
+                  .ToString());
+        }
+        partition_metas.resize(num_partitions - 1);
+        std::vector<FileMetaData*> metas{&meta_};
+        for (FileMetaData& meta : partition_metas) {
+          meta.fd = FileDescriptor(versions_->NewFileNumber(), 0, 0);
+          meta.epoch_number = meta_.epoch_number;
+          meta.temperature = meta_.temperature;
+          meta.oldest_ancester_time = meta_.oldest_ancester_time;
+          meta.file_creation_time = meta_.file_creation_time;
+          metas.push_back(&meta);
+        }
+        std::vector<Status> statuses(num_partitions);
+        std::vector<IOStatus> io_statuses(num_partitions);
+        std::vector<TableProperties> properties(num_partitions);
+        std::vector<InternalStats::CompactionStats> stats(num_partitions);
+        std::vector<uint64_t> payload_bytes(num_partitions);
+        std::vector<uint64_t> garbage_bytes(num_partitions);
+        std::vector<uint64_t> bytes_written(num_partitions);
+        auto build_partition = [&](size_t p) {
+          const uint64_t prev_bytes_written = IOSTATS(bytes_written);
+          Arena partition_arena;
+          std::vector<InternalIterator*> partition_memtables;
+          for (ReadOnlyMemTable* m : mems_) {
+            partition_memtables.push_back(m->NewIterator(
+                ro, /*seqno_to_time_mapping=*/nullptr, &partition_arena,
+                /*prefix_extractor=*/nullptr, /*for_flush=*/true));
+          }
+          ScopedArenaPtr<InternalIterator> merged(NewMergingIterator(
+              &cfd_->internal_comparator(), partition_memtables.data(),
+              static_cast<int>(partition_memtables.size()), &partition_arena));
+          const Slice lower = p > 0 ? Slice(bounds[p - 1]) : Slice();
+          const Slice upper = p < bounds.size() ? Slice(bounds[p]) : Slice();
+          ClippingIterator clipped(merged.get(), p > 0 ? &lower : nullptr,
+                                   p < bounds.size() ? &upper : nullptr,
+                                   &cfd_->internal_comparator());
+          ROCKS_LOG_INFO(db_options_.info_log,
+                         "[%s] [JOB %d] Level-0 flush table #%" PRIu64
+                         ": started, key range %" ROCKSDB_PRIszt
+                         " of %" ROCKSDB_PRIszt,
+                         cfd_->GetName().c_str(), job_context_->job_id,
+                         metas[p]->fd.GetNumber(), p + 1, num_partitions);
+          std::vector<BlobFileAddition> no_blob_file_additions;
+          statuses[p] = BuildTable(
+              dbname_, versions_, db_options_,
+              new_tboptions(metas[p]->fd.GetNumber()), file_options_,
+              cfd_->table_cache(), &clipped, {}, metas[p],
+              &no_blob_file_additions, job_context_->snapshot_seqs,
+              earliest_snapshot_,
+              job_context_->earliest_write_conflict_snapshot,
+              job_context_->GetJobSnapshotSequence(),
+              job_context_->snapshot_checker,
+              mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
+              &io_statuses[p], io_tracer_, BlobFileCreationReason::kFlush,
+              seqno_to_time_mapping_.get(), event_logger_,
+              job_context_->job_id, &properties[p], write_hint,
+              full_history_ts_low, blob_callback_, base_, &payload_bytes[p],
+              &garbage_bytes[p], &stats[p]);
+          io_statuses[p].PermitUncheckedError();
+          bytes_written[p] = IOSTATS(bytes_written) - prev_bytes_written;
+        };
+        std::vector<port::Thread> threads;
+        for (size_t p = 1; p < num_partitions; p++) {
+          threads.emplace_back(build_partition, p);
+        }
+        build_partition(0);
+        for (auto& thread : threads) {
+          thread.join();
+        }
+
+        table_properties_ = properties[0];
+        for (size_t p = 0; p < num_partitions; p++) {
+          if (s.ok()) {
+            s = statuses[p];
+          }
+          if (p > 0) {
+            // Counted by RecordFlushIOStats() on this thread
+            IOSTATS_ADD(bytes_written, bytes_written[p]);
+          }
+          flush_stats.Add(stats[p]);
+          memtable_payload_bytes += payload_bytes[p];
+          memtable_garbage_bytes += garbage_bytes[p];
+          num_table_entries += properties[p].num_entries;
+        }
+        auto sfm = static_cast<SstFileManagerImpl*>(
+            db_options_.sst_file_manager.get());
+        for (const FileMetaData& meta : partition_metas) {
+          ROCKS_LOG_BUFFER(log_buffer_,
+                           "[%s] [JOB %d] Level-0 flush table #%" PRIu64
+                           ": %" PRIu64 " bytes",
+                           cfd_->GetName().c_str(), job_context_->job_id,
+                           meta.fd.GetNumber(), meta.fd.GetFileSize());
+          // The DB only tells the SstFileManager about meta_
+          if (s.ok() && sfm != nullptr && meta.fd.GetFileSize() > 0) {
+            sfm->OnAddFile(MakeTableFileName(cfd_->ioptions().cf_paths[0].path,
+                                             meta.fd.GetNumber()))
+                .PermitUncheckedError();
+          }
+        }
+      }
       TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:s", &s);
       // TODO: Cleanup io_status in BuildTable and table builders
       assert(!s.ok() || io_s.ok());
@@ -1030,13 +1307,12 @@ Status FlushJob::WriteLevel0Table() {
                TableFactory::kBlockBasedTableName()) ||
            mutable_cf_options_.table_factory->IsInstanceOf(
                TableFactory::kPlainTableName())) &&
-          flush_stats.num_output_records != table_properties_.num_entries) {
+          flush_stats.num_output_records != num_table_entries) {
         std::string msg =
             "Number of keys in flush output SST files does not match "
             "number of keys added to the table. Expected " +
             std::to_string(flush_stats.num_output_records) + " but there are " +
-            std::to_string(table_properties_.num_entries) +
-            " in output SST files";
+            std::to_string(num_table_entries) + " in output SST files";
         ROCKS_LOG_WARN(db_options_.info_log, "[%s] [JOB %d] Level-0 flush %s",
                        cfd_->GetName().c_str(), job_context_->job_id,
                        msg.c_str());
@@ -1081,14 +1357,27 @@ Status FlushJob::WriteLevel0Table() {
   // should not be added to the manifest.
   const bool has_output = meta_.fd.GetFileSize() > 0;
 
+  int output_level = 0;
+  if (s.ok()) {
+    std::vector<const FileMetaData*> outputs;
+    if (has_output) {
+      outputs.push_back(&meta_);
+    }
+    for (const FileMetaData& meta : partition_metas) {
+      if (meta.fd.GetFileSize() > 0) {
+        outputs.push_back(&meta);
+      }
+    }
+    output_level = PickOutputLevel(outputs);
+  }
+
   if (s.ok() && has_output) {
     TEST_SYNC_POINT("DBImpl::FlushJob:SSTFileCreated");
     // if we have more than 1 background thread, then we cannot
     // insert files directly into higher levels because some other
     // threads could be concurrently producing compacted files for
-    // that key range.
-    // Add file to L0
-    edit_->AddFile(0 /* level */, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
+    // that key range, unless PickOutputLevel() reserved it.
+    edit_->AddFile(output_level, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
                    meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
                    meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
                    meta_.marked_for_compaction, meta_.temperature,
@@ -1097,7 +1386,16 @@ Status FlushJob::WriteLevel0Table() {
                    meta_.file_checksum, meta_.file_checksum_func_name,
                    meta_.unique_id, meta_.compensated_range_deletion_size,
                    meta_.tail_size, meta_.user_defined_timestamps_persisted);
-    edit_->SetBlobFileAdditions(std::move(blob_file_additions));
+  }
+  if (s.ok()) {
+    for (const FileMetaData& meta : partition_metas) {
+      if (meta.fd.GetFileSize() > 0) {
+        edit_->AddFile(output_level, meta);
+      }
+    }
+    if (has_output) {
+      edit_->SetBlobFileAdditions(std::move(blob_file_additions));
+    }
   }
   // Piggyback FlushJobInfo on the first first flushed memtable.
   mems_[0]->SetFlushJobInfo(GetFlushJobInfo());
@@ -1117,6 +1415,12 @@ Status FlushJob::WriteLevel0Table() {
     flush_stats.bytes_written = meta_.fd.GetFileSize();
     flush_stats.num_output_files = 1;
   }
+  for (const FileMetaData& meta : partition_metas) {
+    if (meta.fd.GetFileSize() > 0) {
+      flush_stats.bytes_written += meta.fd.GetFileSize();
+      flush_stats.num_output_files++;
+    }
+  }
 
   const auto& blobs = edit_->GetBlobFileAdditions();
   for (const auto& blob : blobs) {
@@ -1126,7 +1430,7 @@ Status FlushJob::WriteLevel0Table() {
   flush_stats.num_output_files_blob = static_cast<int>(blobs.size());
 
   RecordTimeToHistogram(stats_, FLUSH_TIME, flush_stats.micros);
-  cfd_->internal_stats()->AddCompactionStats(0 /* level */, thread_pri_,
+  cfd_->internal_stats()->AddCompactionStats(output_level, thread_pri_,
                                              flush_stats);
   cfd_->internal_stats()->AddCFStats(
       InternalStats::BYTES_FLUSHED,
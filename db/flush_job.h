@@ -53,6 +53,7 @@ class Version;
 class VersionEdit;
 class VersionSet;
 class Arena;
+class Compaction;
 
 class FlushJob {
  public:
@@ -102,6 +103,20 @@ class FlushJob {
   static void ReportFlushInputSize(const autovector<ReadOnlyMemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
+  // Returns the user keys that split the memtables to flush into up to
+  // `max_flush_partitions` key ranges of about the same size, each built
+  // into its own file, or none to build a single file
+  std::vector<std::string> PickPartitionBoundaries(
+      uint64_t total_data_size, uint64_t num_range_deletes) const;
+  // Require db_mutex held.
+  // Returns the level to add the output files to: the lowest level that they
+  // fit in if `allow_flush_below_level0` is set and this job flushes the
+  // oldest unflushed memtables, else 0. The key range of a level below L0 is
+  // reserved to the flush, as if compacted to it, until
+  // UnregisterOutputRange() is called.
+  int PickOutputLevel(const std::vector<const FileMetaData*>& outputs);
+  // Require db_mutex held.
+  void UnregisterOutputRange();
 
   // Memtable Garbage Collection algorithm: a MemPurge takes the list
   // of immutable memtables and filters out (or "purge") the outdated bytes
@@ -232,6 +247,12 @@ class FlushJob {
   // `earliest_snapshot_` will be output to the proximal level had it gone
   // through a compaction to the last level.
   SequenceNumber preclude_last_level_min_seqno_ = kMaxSequenceNumber;
+
+  // When the output files go below L0, a compaction from L0 of copies of
+  // their metadata that keeps compactions from being picked for their key
+  // range in the output level until the flush is installed
+  std::vector<FileMetaData> output_range_files_;
+  std::unique_ptr<Compaction> output_range_compaction_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -39,12 +39,12 @@ class ForwardLevelIterator : public InternalIterator {
                        bool allow_unprepared_value)
       : cfd_(cfd),
         read_options_(read_options),
-        files_(files),
+        files_(&files),
         valid_(false),
         file_index_(std::numeric_limits<uint32_t>::max()),
         file_iter_(nullptr),
         pinned_iters_mgr_(nullptr),
-        mutable_cf_options_(mutable_cf_options),
+        mutable_cf_options_(&mutable_cf_options),
         allow_unprepared_value_(allow_unprepared_value) {
     status_.PermitUncheckedError();  // Allow uninitialized status through
   }
@@ -58,8 +58,22 @@ class ForwardLevelIterator : public InternalIterator {
     }
   }
 
+  // Whether the iterator can be kept for `files` of a newer SuperVersion
+  bool CanReuseFor(const std::vector<FileMetaData*>& files) const {
+    return *files_ == files && status().ok();
+  }
+  // Moves the iterator to the same files of a newer SuperVersion, keeping
+  // the table iterator of the current file. REQUIRES: CanReuseFor(files)
+  void Reuse(const std::vector<FileMetaData*>& files,
+             const MutableCFOptions& mutable_cf_options) {
+    assert(CanReuseFor(files));
+    files_ = &files;
+    mutable_cf_options_ = &mutable_cf_options;
+    valid_ = false;
+  }
+
   void SetFileIndex(uint32_t file_index) {
-    assert(file_index < files_.size());
+    assert(file_index < files_->size());
     status_ = Status::OK();
     if (file_index != file_index_) {
       file_index_ = file_index;
@@ -67,7 +81,7 @@ class ForwardLevelIterator : public InternalIterator {
     }
   }
   void Reset() {
-    assert(file_index_ < files_.size());
+    assert(file_index_ < files_->size());
 
     // Reset current pointer
     if (pinned_iters_mgr_ && pinned_iters_mgr_->PinningEnabled()) {
@@ -80,9 +94,9 @@ class ForwardLevelIterator : public InternalIterator {
                                          kMaxSequenceNumber /* upper_bound */);
     file_iter_ = cfd_->table_cache()->NewIterator(
         read_options_, *(cfd_->soptions()), cfd_->internal_comparator(),
-        *files_[file_index_],
+        *(*files_)[file_index_],
         read_options_.ignore_range_deletions ? nullptr : &range_del_agg,
-        mutable_cf_options_, /*table_reader_ptr=*/nullptr,
+        *mutable_cf_options_, /*table_reader_ptr=*/nullptr,
         /*file_read_hist=*/nullptr, TableReaderCaller::kUserIterator,
         /*arena=*/nullptr, /*skip_filters=*/false, /*level=*/-1,
         /*max_file_size_for_l0_meta_pin=*/0,
@@ -145,7 +159,7 @@ class ForwardLevelIterator : public InternalIterator {
       if (valid_) {
         return;
       }
-      if (file_index_ + 1 >= files_.size()) {
+      if (file_index_ + 1 >= files_->size()) {
         valid_ = false;
         return;
       }
@@ -205,14 +219,14 @@ class ForwardLevelIterator : public InternalIterator {
  private:
   const ColumnFamilyData* const cfd_;
   const ReadOptions& read_options_;
-  const std::vector<FileMetaData*>& files_;
+  const std::vector<FileMetaData*>* files_;
 
   bool valid_;
   uint32_t file_index_;
   Status status_;
   InternalIterator* file_iter_;
   PinnedIteratorsManager* pinned_iters_mgr_;
-  const MutableCFOptions& mutable_cf_options_;
+  const MutableCFOptions* mutable_cf_options_;
 
   const bool allow_unprepared_value_;
 };
@@ -773,7 +787,12 @@ void ForwardIterator::RenewIterators() {
   assert(sv_);
   svnew = cfd_->GetReferencedSuperVersion(db_);
 
-  if (mutable_iter_ != nullptr) {
+  // A flush or compaction installs a new SuperVersion with the same mutable
+  // memtable, whose iterator is kept rather than allocating another one from
+  // arena_.
+  const bool reuse_mutable_iter =
+      mutable_iter_ != nullptr && svnew->mem == sv_->mem;
+  if (mutable_iter_ != nullptr && !reuse_mutable_iter) {
     DeleteIterator(mutable_iter_, true /* is_arena */);
   }
   for (auto* m : imm_iters_) {
@@ -783,10 +802,12 @@ void ForwardIterator::RenewIterators() {
 
   UnownedPtr<const SeqnoToTimeMapping> seqno_to_time_mapping =
       svnew->GetSeqnoToTimeMapping();
-  mutable_iter_ =
-      svnew->mem->NewIterator(read_options_, seqno_to_time_mapping, &arena_,
-                              svnew->mutable_cf_options.prefix_extractor.get(),
-                              /*for_flush=*/false);
+  if (!reuse_mutable_iter) {
+    mutable_iter_ = svnew->mem->NewIterator(
+        read_options_, seqno_to_time_mapping, &arena_,
+        svnew->mutable_cf_options.prefix_extractor.get(),
+        /*for_flush=*/false);
+  }
   svnew->imm->AddIterators(read_options_, seqno_to_time_mapping,
                            svnew->mutable_cf_options.prefix_extractor.get(),
                            &imm_iters_, &arena_);
@@ -851,11 +872,9 @@ void ForwardIterator::RenewIterators() {
   l0_iters_.clear();
   l0_iters_ = l0_iters_new;
 
-  for (auto* l : level_iters_) {
-    DeleteIterator(l);
-  }
-  level_iters_.clear();
-  BuildLevelIterators(vstorage_new, svnew);
+  std::vector<ForwardLevelIterator*> old_level_iters;
+  old_level_iters.swap(level_iters_);
+  BuildLevelIterators(vstorage_new, svnew, &old_level_iters);
   current_ = nullptr;
   is_prev_set_ = false;
   SVCleanup();
@@ -869,11 +888,26 @@ void ForwardIterator::RenewIterators() {
   }
 }
 
-void ForwardIterator::BuildLevelIterators(const VersionStorageInfo* vstorage,
-                                          SuperVersion* sv) {
+void ForwardIterator::BuildLevelIterators(
+    const VersionStorageInfo* vstorage, SuperVersion* sv,
+    std::vector<ForwardLevelIterator*>* old_level_iters) {
   level_iters_.reserve(vstorage->num_levels() - 1);
   for (int32_t level = 1; level < vstorage->num_levels(); ++level) {
     const auto& level_files = vstorage->LevelFiles(level);
+    ForwardLevelIterator* old_iter = nullptr;
+    if (old_level_iters != nullptr &&
+        static_cast<size_t>(level) <= old_level_iters->size()) {
+      old_iter = (*old_level_iters)[level - 1];
+    }
+    if (old_iter != nullptr && !level_files.empty() &&
+        old_iter->CanReuseFor(level_files)) {
+      old_iter->Reuse(level_files, sv->mutable_cf_options);
+      level_iters_.push_back(old_iter);
+      (*old_level_iters)[level - 1] = nullptr;
+      TEST_SYNC_POINT_CALLBACK("ForwardIterator::RenewIterators:ReuseLevel",
+                               this);
+      continue;
+    }
     if ((level_files.empty()) ||
         ((read_options_.iterate_upper_bound != nullptr) &&
          (user_comparator_->Compare(*read_options_.iterate_upper_bound,
@@ -889,6 +923,12 @@ void ForwardIterator::BuildLevelIterators(const VersionStorageInfo* vstorage,
           allow_unprepared_value_));
     }
   }
+  if (old_level_iters != nullptr) {
+    for (auto* l : *old_level_iters) {
+      DeleteIterator(l);
+    }
+    old_level_iters->clear();
+  }
 }
 
 void ForwardIterator::ResetIncompleteIterators() {
@@ -98,8 +98,11 @@ class ForwardIterator : public InternalIterator {
 
   void RebuildIterators(bool refresh_sv);
   void RenewIterators();
-  void BuildLevelIterators(const VersionStorageInfo* vstorage,
-                           SuperVersion* sv);
+  // Iterators of `old_level_iters`, if given, over the same files as a level
+  // of `vstorage` are moved to level_iters_ instead of creating new ones.
+  void BuildLevelIterators(
+      const VersionStorageInfo* vstorage, SuperVersion* sv,
+      std::vector<ForwardLevelIterator*>* old_level_iters = nullptr);
   void ResetIncompleteIterators();
   void SeekInternal(const Slice& internal_key, bool seek_to_first,
                     bool seek_after_async_io);
@@ -24,10 +24,13 @@
 #include "cache/cache_entry_stats.h"
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
+#include "db/table_cache.h"
 #include "db/write_stall_stats.h"
+#include "memory/slab_allocator.h"
 #include "port/port.h"
 #include "rocksdb/system_clock.h"
 #include "rocksdb/table.h"
+#include "rocksdb/utilities/sim_cache.h"
 #include "table/block_based/cachable_entry.h"
 #include "util/hash_containers.h"
 #include "util/string_util.h"
@@ -258,8 +261,12 @@ static const std::string cf_file_histogram = "cf-file-histogram";
 static const std::string cf_write_stall_stats = "cf-write-stall-stats";
 static const std::string dbstats = "dbstats";
 static const std::string db_write_stall_stats = "db-write-stall-stats";
+static const std::string warmup_stats = "warmup-stats";
 static const std::string levelstats = "levelstats";
+static const std::string lsm_efficiency = "lsm-efficiency";
 static const std::string block_cache_entry_stats = "block-cache-entry-stats";
+static const std::string block_cache_hit_ratio_curve =
+    "block-cache-hit-ratio-curve";
 static const std::string fast_block_cache_entry_stats =
     "fast-block-cache-entry-stats";
 static const std::string num_immutable_mem_table = "num-immutable-mem-table";
@@ -318,6 +325,8 @@ static const std::string estimate_oldest_key_time = "estimate-oldest-key-time";
 static const std::string block_cache_capacity = "block-cache-capacity";
 static const std::string block_cache_usage = "block-cache-usage";
 static const std::string block_cache_pinned_usage = "block-cache-pinned-usage";
+static const std::string block_cache_fragmentation =
+    "block-cache-fragmentation";
 static const std::string options_statistics = "options-statistics";
 static const std::string num_blob_files = "num-blob-files";
 static const std::string blob_stats = "blob-stats";
@@ -344,12 +353,17 @@ const std::string DB::Properties::kCFWriteStallStats =
     rocksdb_prefix + cf_write_stall_stats;
 const std::string DB::Properties::kDBWriteStallStats =
     rocksdb_prefix + db_write_stall_stats;
+const std::string DB::Properties::kWarmupStats = rocksdb_prefix + warmup_stats;
 const std::string DB::Properties::kDBStats = rocksdb_prefix + dbstats;
 const std::string DB::Properties::kLevelStats = rocksdb_prefix + levelstats;
+const std::string DB::Properties::kLsmEfficiency =
+    rocksdb_prefix + lsm_efficiency;
 const std::string DB::Properties::kBlockCacheEntryStats =
     rocksdb_prefix + block_cache_entry_stats;
 const std::string DB::Properties::kFastBlockCacheEntryStats =
     rocksdb_prefix + fast_block_cache_entry_stats;
+const std::string DB::Properties::kBlockCacheHitRatioCurve =
+    rocksdb_prefix + block_cache_hit_ratio_curve;
 const std::string DB::Properties::kNumImmutableMemTable =
     rocksdb_prefix + num_immutable_mem_table;
 const std::string DB::Properties::kNumImmutableMemTableFlushed =
@@ -427,6 +441,8 @@ const std::string DB::Properties::kBlockCacheUsage =
     rocksdb_prefix + block_cache_usage;
 const std::string DB::Properties::kBlockCachePinnedUsage =
     rocksdb_prefix + block_cache_pinned_usage;
+const std::string DB::Properties::kBlockCacheFragmentation =
+    rocksdb_prefix + block_cache_fragmentation;
 const std::string DB::Properties::kOptionsStatistics =
     rocksdb_prefix + options_statistics;
 const std::string DB::Properties::kLiveSstFilesSizeAtTemperature =
@@ -461,6 +477,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
           nullptr, nullptr}},
         {DB::Properties::kLevelStats,
          {false, &InternalStats::HandleLevelStats, nullptr, nullptr, nullptr}},
+        {DB::Properties::kLsmEfficiency,
+         {false, &InternalStats::HandleLsmEfficiency, nullptr,
+          &InternalStats::HandleLsmEfficiencyMap, nullptr}},
         {DB::Properties::kStats,
          {false, &InternalStats::HandleStats, nullptr, nullptr, nullptr}},
         {DB::Properties::kCFStats,
@@ -484,12 +503,18 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kDBWriteStallStats,
          {false, &InternalStats::HandleDBWriteStallStats, nullptr,
           &InternalStats::HandleDBWriteStallStatsMap, nullptr}},
+        {DB::Properties::kWarmupStats,
+         {false, &InternalStats::HandleWarmupStats, nullptr,
+          &InternalStats::HandleWarmupStatsMap, nullptr}},
         {DB::Properties::kBlockCacheEntryStats,
          {true, &InternalStats::HandleBlockCacheEntryStats, nullptr,
           &InternalStats::HandleBlockCacheEntryStatsMap, nullptr}},
         {DB::Properties::kFastBlockCacheEntryStats,
          {true, &InternalStats::HandleFastBlockCacheEntryStats, nullptr,
           &InternalStats::HandleFastBlockCacheEntryStatsMap, nullptr}},
+        {DB::Properties::kBlockCacheHitRatioCurve,
+         {false, &InternalStats::HandleBlockCacheHitRatioCurve, nullptr,
+          &InternalStats::HandleBlockCacheHitRatioCurveMap, nullptr}},
         {DB::Properties::kSSTables,
          {false, &InternalStats::HandleSsTables, nullptr, nullptr, nullptr}},
         {DB::Properties::kAggregatedTableProperties,
@@ -545,13 +570,13 @@ const UnorderedMap<std::string, DBPropertyInfo>
          {false, nullptr, &InternalStats::HandleIsFileDeletionsEnabled, nullptr,
           nullptr}},
         {DB::Properties::kNumSnapshots,
-         {false, nullptr, &InternalStats::HandleNumSnapshots, nullptr,
+         {true, nullptr, &InternalStats::HandleNumSnapshots, nullptr,
           nullptr}},
         {DB::Properties::kOldestSnapshotTime,
-         {false, nullptr, &InternalStats::HandleOldestSnapshotTime, nullptr,
+         {true, nullptr, &InternalStats::HandleOldestSnapshotTime, nullptr,
           nullptr}},
         {DB::Properties::kOldestSnapshotSequence,
-         {false, nullptr, &InternalStats::HandleOldestSnapshotSequence, nullptr,
+         {true, nullptr, &InternalStats::HandleOldestSnapshotSequence, nullptr,
           nullptr}},
         {DB::Properties::kNumLiveVersions,
          {false, nullptr, &InternalStats::HandleNumLiveVersions, nullptr,
@@ -612,6 +637,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kBlockCachePinnedUsage,
          {false, nullptr, &InternalStats::HandleBlockCachePinnedUsage, nullptr,
           nullptr}},
+        {DB::Properties::kBlockCacheFragmentation,
+         {false, nullptr, &InternalStats::HandleBlockCacheFragmentation,
+          nullptr, nullptr}},
         {DB::Properties::kOptionsStatistics,
          {true, nullptr, nullptr, nullptr,
           &DBImpl::GetPropertyHandleOptionsStatistics}},
@@ -648,7 +676,9 @@ InternalStats::InternalStats(int num_levels, SystemClock* clock,
       comp_stats_(num_levels),
       comp_stats_by_pri_(Env::Priority::TOTAL),
       file_read_latency_(num_levels),
+      sampled_file_probes_(num_levels),
       has_cf_change_since_dump_(true),
+      lsm_efficiency_snapshot_(num_levels),
       bg_error_count_(0),
       num_running_compaction_sorted_runs_(0),
       number_levels_(num_levels),
@@ -733,6 +763,20 @@ void InternalStats::CacheEntryRoleStats::SkippedCollection() {
   ++copies_of_last_collection;
 }
 
+bool InternalStats::CacheEntryRoleStats::CollectFromCache(
+    Cache* cache, SystemClock* clock, uint64_t time_micros) {
+  std::array<size_t, kNumCacheEntryRoles> charges;
+  std::array<size_t, kNumCacheEntryRoles> counts;
+  if (!cache->GetChargesByRole(&charges, &counts)) {
+    return false;
+  }
+  BeginCollection(cache, clock, time_micros);
+  std::copy(charges.begin(), charges.end(), total_charges.begin());
+  entry_counts = counts;
+  EndCollection(cache, clock, time_micros);
+  return true;
+}
+
 uint64_t InternalStats::CacheEntryRoleStats::GetLastDurationMicros() const {
   if (last_end_time_micros_ > last_start_time_micros_) {
     return last_end_time_micros_ - last_start_time_micros_;
@@ -831,6 +875,46 @@ bool InternalStats::HandleFastBlockCacheEntryStatsMap(
   return HandleBlockCacheEntryStatsMapInternal(values, true /* fast */);
 }
 
+bool InternalStats::HandleBlockCacheHitRatioCurve(std::string* value,
+                                                  Slice suffix) {
+  std::map<std::string, std::string> values;
+  if (!HandleBlockCacheHitRatioCurveMap(&values, suffix)) {
+    return false;
+  }
+  std::ostringstream str;
+  str << "Block cache hit ratio curve:\n";
+  for (const auto& kv : values) {
+    str << "  " << kv.first << ": " << kv.second << "\n";
+  }
+  *value = str.str();
+  return true;
+}
+
+bool InternalStats::HandleBlockCacheHitRatioCurveMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  Cache* block_cache = GetBlockCacheForStats();
+  if (block_cache == nullptr) {
+    return false;
+  }
+  auto* mrc_cache = block_cache->CheckedCast<MissRatioCurveCache>();
+  if (mrc_cache == nullptr) {
+    return false;
+  }
+  std::map<double, double> curve;
+  mrc_cache->GetHitRatioCurve(&curve);
+  values->clear();
+  for (const auto& point : curve) {
+    char key[32];
+    snprintf(key, sizeof(key), "%gx", point.first);
+    char ratio[32];
+    snprintf(ratio, sizeof(ratio), "%.4f", point.second);
+    (*values)[key] = ratio;
+  }
+  (*values)["sampled_lookups"] =
+      std::to_string(mrc_cache->GetNumSampledLookups());
+  return true;
+}
+
 bool InternalStats::HandleLiveSstFilesSizeAtTemperature(std::string* value,
                                                         Slice suffix) {
   uint64_t temperature;
@@ -1009,11 +1093,12 @@ bool InternalStats::GetIntProperty(const DBPropertyInfo& property_info,
 }
 
 bool InternalStats::GetIntPropertyOutOfMutex(
-    const DBPropertyInfo& property_info, Version* version, uint64_t* value) {
+    const DBPropertyInfo& property_info, Version* version, uint64_t* value,
+    DBImpl* db) {
   assert(value != nullptr);
   assert(property_info.handle_int != nullptr &&
          property_info.need_out_of_mutex);
-  return (this->*(property_info.handle_int))(value, nullptr /* db */, version);
+  return (this->*(property_info.handle_int))(value, db, version);
 }
 
 bool InternalStats::HandleNumFilesAtLevel(std::string* value, Slice suffix) {
@@ -1061,6 +1146,116 @@ bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/) {
   return true;
 }
 
+bool InternalStats::HandleLsmEfficiency(std::string* value, Slice suffix) {
+  std::map<std::string, std::string> values;
+  if (!HandleLsmEfficiencyMap(&values, suffix)) {
+    return false;
+  }
+  char buf[1000];
+  snprintf(buf, sizeof(buf),
+           "Level    W-Amp W-Amp(Int)    R-Amp R-Amp(Int)    S-Amp\n"
+           "-----------------------------------------------------\n");
+  value->append(buf);
+  auto append_level = [&](const std::string& level) {
+    auto get = [&](const char* name) {
+      return std::stod(values[level + "." + name]);
+    };
+    snprintf(buf, sizeof(buf), "%5s %8.2f %10.2f %8.2f %10.2f %8.2f\n",
+             level.c_str(), get("write_amp"), get("write_amp_interval"),
+             get("read_amp"), get("read_amp_interval"), get("space_amp"));
+    value->append(buf);
+  };
+  for (int level = 0; level < number_levels_; level++) {
+    append_level("L" + std::to_string(level));
+  }
+  append_level("Sum");
+  return true;
+}
+
+/**
+ * Dump the write, read and space amplification of each level, and of the
+ * whole LSM tree as a special level "Sum", to a map with keys
+ * "<level>.<stat>". The stats are:
+ * - write_amp: bytes written to the level, over the bytes written to it from
+ *   other levels (or flushed and ingested, for L0 and Sum)
+ * - read_amp: files of the level probed per lookup that reaches the files,
+ *   from sampled lookups
+ * - space_amp: bytes of the levels up to this one over the bytes of this
+ *   one, which is the space amplification of the LSM tree for the last level
+ *   and Sum
+ * write_amp and read_amp are cumulative, and also reported as
+ * write_amp_interval and read_amp_interval since the previous query of the
+ * property. "sampled_lookups" is the number of sampled lookups.
+ */
+bool InternalStats::HandleLsmEfficiencyMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  const auto* vstorage = cfd_->current()->storage_info();
+  auto ratio = [](uint64_t num, uint64_t denom) {
+    return denom == 0 ? 0.0
+                      : static_cast<double>(num) / static_cast<double>(denom);
+  };
+  LsmEfficiencySnapshot& prev = lsm_efficiency_snapshot_;
+  LsmEfficiencySnapshot curr(number_levels_);
+  curr.ingest_bytes = cf_stats_value_[BYTES_FLUSHED] +
+                      cf_stats_value_[BYTES_INGESTED_ADD_FILE];
+  curr.lookups = sampled_lookups_.LoadRelaxed();
+  const uint64_t interval_lookups = curr.lookups - prev.lookups;
+
+  uint64_t total_written = 0;
+  uint64_t total_probes = 0;
+  uint64_t total_bytes = 0;
+  uint64_t last_level_bytes = 0;
+  for (int level = 0; level < number_levels_; level++) {
+    const CompactionStats& stats = comp_stats_[level];
+    curr.bytes_written[level] = stats.bytes_written + stats.bytes_written_blob;
+    curr.bytes_input[level] =
+        level == 0 ? curr.ingest_bytes
+                   : stats.bytes_read_non_output_levels + stats.bytes_read_blob;
+    curr.file_probes[level] = sampled_file_probes_[level].LoadRelaxed();
+    const uint64_t level_bytes = vstorage->NumLevelBytes(level);
+    total_written += curr.bytes_written[level];
+    total_probes += curr.file_probes[level];
+    total_bytes += level_bytes;
+    if (level_bytes > 0) {
+      last_level_bytes = level_bytes;
+    }
+
+    const std::string prefix = "L" + std::to_string(level) + ".";
+    (*values)[prefix + "write_amp"] = std::to_string(
+        ratio(curr.bytes_written[level], curr.bytes_input[level]));
+    (*values)[prefix + "write_amp_interval"] = std::to_string(
+        ratio(curr.bytes_written[level] - prev.bytes_written[level],
+              curr.bytes_input[level] - prev.bytes_input[level]));
+    (*values)[prefix + "read_amp"] =
+        std::to_string(ratio(curr.file_probes[level], curr.lookups));
+    (*values)[prefix + "read_amp_interval"] = std::to_string(ratio(
+        curr.file_probes[level] - prev.file_probes[level], interval_lookups));
+    (*values)[prefix + "space_amp"] =
+        std::to_string(ratio(total_bytes, level_bytes));
+  }
+
+  uint64_t prev_total_written = 0;
+  uint64_t prev_total_probes = 0;
+  for (int level = 0; level < number_levels_; level++) {
+    prev_total_written += prev.bytes_written[level];
+    prev_total_probes += prev.file_probes[level];
+  }
+  (*values)["Sum.write_amp"] =
+      std::to_string(ratio(total_written, curr.ingest_bytes));
+  (*values)["Sum.write_amp_interval"] =
+      std::to_string(ratio(total_written - prev_total_written,
+                           curr.ingest_bytes - prev.ingest_bytes));
+  (*values)["Sum.read_amp"] = std::to_string(ratio(total_probes, curr.lookups));
+  (*values)["Sum.read_amp_interval"] = std::to_string(
+      ratio(total_probes - prev_total_probes, interval_lookups));
+  (*values)["Sum.space_amp"] =
+      std::to_string(ratio(total_bytes, last_level_bytes));
+  (*values)["sampled_lookups"] = std::to_string(curr.lookups);
+
+  prev = std::move(curr);
+  return true;
+}
+
 bool InternalStats::HandleStats(std::string* value, Slice suffix) {
   if (!HandleCFStats(value, suffix)) {
     return false;
@@ -1138,6 +1333,37 @@ bool InternalStats::HandleCFWriteStallStatsMap(
   return true;
 }
 
+bool InternalStats::HandleWarmupStats(std::string* value, Slice /*suffix*/) {
+  std::map<std::string, std::string> warmup_stats_map;
+  HandleWarmupStatsMap(&warmup_stats_map, Slice());
+  std::ostringstream str;
+  str << "Warmup: ";
+  for (auto it = warmup_stats_map.begin(); it != warmup_stats_map.end();
+       it++) {
+    str << it->first << ": " << it->second
+        << (std::next(it) == warmup_stats_map.end() ? "\n" : ", ");
+  }
+  *value = str.str();
+  return true;
+}
+
+bool InternalStats::HandleWarmupStatsMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  (*values)["num-jobs"] = std::to_string(warmup_stats_.num_jobs);
+  (*values)["num-files"] = std::to_string(warmup_stats_.num_files);
+  (*values)["blocks-inserted"] = std::to_string(warmup_stats_.blocks_inserted);
+  (*values)["blocks-inserted-to-secondary-cache"] =
+      std::to_string(warmup_stats_.blocks_inserted_to_secondary_cache);
+  (*values)["bytes-read"] = std::to_string(warmup_stats_.bytes_read);
+  (*values)["blocks-already-cached"] =
+      std::to_string(warmup_stats_.blocks_already_cached);
+  (*values)["blocks-skipped"] = std::to_string(warmup_stats_.blocks_skipped);
+  (*values)["bytes-skipped"] = std::to_string(warmup_stats_.bytes_skipped);
+  (*values)["files-skipped"] = std::to_string(warmup_stats_.files_skipped);
+  (*values)["micros"] = std::to_string(warmup_stats_.micros);
+  return true;
+}
+
 bool InternalStats::HandleDBMapStats(
     std::map<std::string, std::string>* db_stats, Slice /*suffix*/) {
   DumpDBMapStats(db_stats);
@@ -1559,6 +1785,23 @@ bool InternalStats::HandleBlockCachePinnedUsage(uint64_t* value, DBImpl* /*db*/,
   return false;
 }
 
+bool InternalStats::HandleBlockCacheFragmentation(uint64_t* value,
+                                                  DBImpl* /*db*/,
+                                                  Version* /*version*/) {
+  Cache* block_cache = GetBlockCacheForStats();
+  if (block_cache) {
+    const SlabAllocator* slabs =
+        GetSlabAllocator(block_cache->memory_allocator());
+    if (slabs) {
+      // The slabs are mapped before any allocation out of them
+      *value = static_cast<uint64_t>(slabs->GetMappedBytes() -
+                                     slabs->GetAllocatedBytes());
+      return true;
+    }
+  }
+  return false;
+}
+
 void InternalStats::DumpDBMapStats(
     std::map<std::string, std::string>* db_stats) {
   for (int i = 0; i < static_cast<int>(kIntStatsNumMax); ++i) {
@@ -1718,6 +1961,12 @@ void InternalStats::DumpDBMapStatsWriteStall(
       (*value)[name] = std::to_string(stat);
     }
   }
+
+  const WriteController* write_controller = cfd_->write_controller();
+  (*value)[WriteStallStatsMapKeys::DelayedWriteRate()] =
+      std::to_string(write_controller->delayed_write_rate());
+  (*value)[WriteStallStatsMapKeys::CompactionDrainRate()] =
+      std::to_string(write_controller->drain_rate());
 }
 
 void InternalStats::DumpDBStatsWriteStall(std::string* value) {
@@ -2161,6 +2410,16 @@ void InternalStats::DumpCFFileHistogram(std::string* value) {
         << blob_file_read_latency_.ToString() << '\n';
   }
 
+  if (cfd_->table_cache() != nullptr) {
+    for (const auto& hist : cfd_->table_cache()->GetPathReadHists()) {
+      if (!hist->Empty()) {
+        oss << "** Path " << hist->path()
+            << " read latency histogram (micros):\n"
+            << hist->ToString() << '\n';
+      }
+    }
+  }
+
   value->append(oss.str());
 }
 
@@ -2217,7 +2476,8 @@ std::unique_ptr<IntPropertyAggregator> CreateIntPropertyAggregator(
     const Slice& property) {
   if (property == DB::Properties::kBlockCacheCapacity ||
       property == DB::Properties::kBlockCacheUsage ||
-      property == DB::Properties::kBlockCachePinnedUsage) {
+      property == DB::Properties::kBlockCachePinnedUsage ||
+      property == DB::Properties::kBlockCacheFragmentation) {
     return std::make_unique<BlockCachePropertyAggregator>();
   } else {
     return std::make_unique<SumPropertyAggregator>();
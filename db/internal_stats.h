@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -18,6 +19,7 @@
 #include "cache/cache_entry_roles.h"
 #include "db/version_set.h"
 #include "rocksdb/system_clock.h"
+#include "util/atomic.h"
 #include "util/hash_containers.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -534,6 +536,7 @@ class InternalStats {
     GetEntryCallback();
     void EndCollection(Cache*, SystemClock*, uint64_t end_time_micros);
     void SkippedCollection();
+    bool CollectFromCache(Cache*, SystemClock*, uint64_t time_micros);
 
     std::string ToString(SystemClock* clock) const;
     void ToMap(std::map<std::string, std::string>* values,
@@ -543,6 +546,38 @@ class InternalStats {
     uint64_t GetLastDurationMicros() const;
   };
 
+  // Cumulative results of the post-compaction warmup jobs of the column
+  // family, see WarmupScheduler.
+  struct WarmupStats {
+    uint64_t num_jobs = 0;
+    uint64_t num_files = 0;
+    uint64_t blocks_inserted = 0;
+    // Of blocks_inserted, the ones inserted into the secondary cache.
+    uint64_t blocks_inserted_to_secondary_cache = 0;
+    uint64_t bytes_read = 0;
+    uint64_t blocks_already_cached = 0;
+    // Not warmed because the block cache was full: the remaining data blocks
+    // of the file that filled it and the files the job did not get to.
+    uint64_t blocks_skipped = 0;
+    uint64_t bytes_skipped = 0;
+    uint64_t files_skipped = 0;
+    uint64_t micros = 0;
+
+    void Add(const WarmupStats& other) {
+      num_jobs += other.num_jobs;
+      num_files += other.num_files;
+      blocks_inserted += other.blocks_inserted;
+      blocks_inserted_to_secondary_cache +=
+          other.blocks_inserted_to_secondary_cache;
+      bytes_read += other.bytes_read;
+      blocks_already_cached += other.blocks_already_cached;
+      blocks_skipped += other.blocks_skipped;
+      bytes_skipped += other.bytes_skipped;
+      files_skipped += other.files_skipped;
+      micros += other.micros;
+    }
+  };
+
   void Clear() {
     for (int i = 0; i < kIntStatsNumMax; i++) {
       db_stats_[i].store(0);
@@ -559,8 +594,14 @@ class InternalStats {
       h.Clear();
     }
     blob_file_read_latency_.Clear();
+    warmup_stats_ = WarmupStats();
     cf_stats_snapshot_.Clear();
     db_stats_snapshot_.Clear();
+    sampled_lookups_.StoreRelaxed(0);
+    for (auto& probes : sampled_file_probes_) {
+      probes.StoreRelaxed(0);
+    }
+    lsm_efficiency_snapshot_.Clear();
     bg_error_count_ = 0;
     started_at_ = clock_->NowMicros();
     has_cf_change_since_dump_ = true;
@@ -580,6 +621,10 @@ class InternalStats {
     }
   }
 
+  void AddWarmupStats(const WarmupStats& stats) { warmup_stats_.Add(stats); }
+
+  const WarmupStats& GetWarmupStats() const { return warmup_stats_; }
+
   void IncBytesMoved(int level, uint64_t amount) {
     comp_stats_[level].bytes_moved += amount;
   }
@@ -590,6 +635,10 @@ class InternalStats {
     ++cf_stats_count_[type];
   }
 
+  uint64_t GetCFStatsCount(InternalCFStatsType type) const {
+    return cf_stats_count_[type];
+  }
+
   void IncrNumRunningCompactionSortedRuns(uint64_t value) {
     num_running_compaction_sorted_runs_.fetch_add(value,
                                                   std::memory_order_relaxed);
@@ -623,6 +672,21 @@ class InternalStats {
     return &file_read_latency_[level];
   }
 
+  // Lookups of keys in the table files with a sampled GetContext, and the
+  // files that they probe at each level, for the read amplification
+  // reported by "rocksdb.lsm-efficiency"
+  void AddSampledLookups(uint64_t count) {
+    sampled_lookups_.FetchAddRelaxed(count);
+  }
+  void AddSampledFileProbe(int level) {
+    assert(level >= 0 && level < number_levels_);
+    sampled_file_probes_[level].FetchAddRelaxed(1);
+  }
+  uint64_t GetSampledFileProbes(int level) const {
+    assert(level >= 0 && level < number_levels_);
+    return sampled_file_probes_[level].LoadRelaxed();
+  }
+
   HistogramImpl* GetBlobFileReadHist() { return &blob_file_read_latency_; }
 
   uint64_t GetBackgroundErrorCount() const { return bg_error_count_; }
@@ -640,7 +704,8 @@ class InternalStats {
                       DBImpl* db);
 
   bool GetIntPropertyOutOfMutex(const DBPropertyInfo& property_info,
-                                Version* version, uint64_t* value);
+                                Version* version, uint64_t* value,
+                                DBImpl* db);
 
   // Unless there is a recent enough collection of the stats, collect and
   // saved new cache entry stats. If `foreground`, require data to be more
@@ -717,6 +782,9 @@ class InternalStats {
   CompactionStats per_key_placement_comp_stats_;
   std::vector<HistogramImpl> file_read_latency_;
   HistogramImpl blob_file_read_latency_;
+  RelaxedAtomic<uint64_t> sampled_lookups_;
+  std::vector<RelaxedAtomic<uint64_t>> sampled_file_probes_;
+  WarmupStats warmup_stats_;
   bool has_cf_change_since_dump_;
   // How many periods of no change since the last time stats are dumped for
   // a periodic dump.
@@ -769,6 +837,29 @@ class InternalStats {
     }
   } cf_stats_snapshot_;
 
+  // Cumulative counters per level at the previous query of
+  // "rocksdb.lsm-efficiency", for its interval amplifications
+  struct LsmEfficiencySnapshot {
+    explicit LsmEfficiencySnapshot(int num_levels)
+        : bytes_written(num_levels),
+          bytes_input(num_levels),
+          file_probes(num_levels) {}
+
+    void Clear() {
+      std::fill(bytes_written.begin(), bytes_written.end(), 0);
+      std::fill(bytes_input.begin(), bytes_input.end(), 0);
+      std::fill(file_probes.begin(), file_probes.end(), 0);
+      ingest_bytes = 0;
+      lookups = 0;
+    }
+
+    std::vector<uint64_t> bytes_written;
+    std::vector<uint64_t> bytes_input;
+    std::vector<uint64_t> file_probes;
+    uint64_t ingest_bytes = 0;
+    uint64_t lookups = 0;
+  } lsm_efficiency_snapshot_;
+
   struct DBStatsSnapshot {
     // DB-level stats
     uint64_t ingest_bytes;    // Bytes written by user
@@ -817,6 +908,9 @@ class InternalStats {
   bool HandleNumFilesAtLevel(std::string* value, Slice suffix);
   bool HandleCompressionRatioAtLevelPrefix(std::string* value, Slice suffix);
   bool HandleLevelStats(std::string* value, Slice suffix);
+  bool HandleLsmEfficiency(std::string* value, Slice suffix);
+  bool HandleLsmEfficiencyMap(std::map<std::string, std::string>* values,
+                              Slice suffix);
   bool HandleStats(std::string* value, Slice suffix);
   bool HandleCFMapStats(std::map<std::string, std::string>* compaction_stats,
                         Slice suffix);
@@ -831,6 +925,9 @@ class InternalStats {
                         Slice suffix);
   bool HandleDBStats(std::string* value, Slice suffix);
   bool HandleDBWriteStallStats(std::string* value, Slice suffix);
+  bool HandleWarmupStats(std::string* value, Slice suffix);
+  bool HandleWarmupStatsMap(std::map<std::string, std::string>* values,
+                            Slice suffix);
   bool HandleDBWriteStallStatsMap(std::map<std::string, std::string>* values,
                                   Slice suffix);
   bool HandleSsTables(std::string* value, Slice suffix);
@@ -898,6 +995,8 @@ class InternalStats {
   bool HandleBlockCacheUsage(uint64_t* value, DBImpl* db, Version* version);
   bool HandleBlockCachePinnedUsage(uint64_t* value, DBImpl* db,
                                    Version* version);
+  bool HandleBlockCacheFragmentation(uint64_t* value, DBImpl* db,
+                                     Version* version);
   bool HandleBlockCacheEntryStatsInternal(std::string* value, bool fast);
   bool HandleBlockCacheEntryStatsMapInternal(
       std::map<std::string, std::string>* values, bool fast);
@@ -907,6 +1006,9 @@ class InternalStats {
   bool HandleFastBlockCacheEntryStats(std::string* value, Slice suffix);
   bool HandleFastBlockCacheEntryStatsMap(
       std::map<std::string, std::string>* values, Slice suffix);
+  bool HandleBlockCacheHitRatioCurve(std::string* value, Slice suffix);
+  bool HandleBlockCacheHitRatioCurveMap(
+      std::map<std::string, std::string>* values, Slice suffix);
   bool HandleLiveSstFilesSizeAtTemperature(std::string* value, Slice suffix);
   bool HandleNumBlobFiles(uint64_t* value, DBImpl* db, Version* version);
   bool HandleBlobStats(std::string* value, Slice suffix);
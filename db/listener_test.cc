@@ -920,6 +920,89 @@ TEST_F(EventListenerTest, MemTableSealedListenerTest) {
   }
 }
 
+class SlowOperationListener : public EventListener {
+ public:
+  void OnSlowOperation(const SlowOperationInfo& info) override {
+    MutexLock l(&mutex_);
+    infos_.push_back(info);
+  }
+
+  std::vector<SlowOperationInfo> GetInfos() {
+    MutexLock l(&mutex_);
+    return infos_;
+  }
+
+ private:
+  port::Mutex mutex_;
+  std::vector<SlowOperationInfo> infos_;
+};
+
+static const OperationSpan* FindSpan(const SlowOperationInfo& info,
+                                     const std::string& name) {
+  for (const auto& span : info.spans) {
+    if (name == span.name) {
+      return &span;
+    }
+  }
+  return nullptr;
+}
+
+TEST_F(EventListenerTest, OnSlowOperationTest) {
+  auto listener = std::make_shared<SlowOperationListener>();
+  Options options;
+  options.env = CurrentOptions().env;
+  options.create_if_missing = true;
+  options.slow_operation_threshold_micros = 1000;
+  options.listeners.push_back(listener);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+  const size_t num_infos = listener->GetInfos().size();
+
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WriteImpl:BeforeLeaderEnters",
+      [&](void*) { env_->SleepForMicroseconds(2000); });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::GetImpl:PostMemTableGet:0",
+      [&](void*) { env_->SleepForMicroseconds(2000); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(Put("baz", "qux"));
+  ASSERT_EQ("bar", Get("foo"));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::vector<SlowOperationInfo> infos = listener->GetInfos();
+  ASSERT_EQ(infos.size(), num_infos + 2);
+  infos.erase(infos.begin(), infos.begin() + num_infos);
+
+  ASSERT_EQ(infos[0].type, SlowOperationType::kWrite);
+  ASSERT_GE(infos[0].duration_nanos, 2000000U);
+  ASSERT_NE(FindSpan(infos[0], "WALWrite"), nullptr);
+  ASSERT_NE(FindSpan(infos[0], "MemTableInsert"), nullptr);
+
+  ASSERT_EQ(infos[1].type, SlowOperationType::kGet);
+  ASSERT_GE(infos[1].duration_nanos, 2000000U);
+  ASSERT_EQ(infos[1].num_dropped_spans, 0U);
+  const OperationSpan* memtable = FindSpan(infos[1], "MemTableGet");
+  const OperationSpan* files = FindSpan(infos[1], "TableFilesGet");
+  const OperationSpan* block_read = FindSpan(infos[1], "BlockRead");
+  ASSERT_NE(memtable, nullptr);
+  ASSERT_NE(files, nullptr);
+  ASSERT_NE(block_read, nullptr);
+  // The sleep is between the memtable and the files
+  ASSERT_GE(files->start_nanos,
+            memtable->start_nanos + memtable->duration_nanos + 2000000U);
+  // Block reads are nested in the lookup of the files
+  ASSERT_GT(block_read->depth, files->depth);
+  ASSERT_GE(block_read->start_nanos, files->start_nanos);
+  ASSERT_LE(block_read->start_nanos + block_read->duration_nanos,
+            files->start_nanos + files->duration_nanos);
+  Close();  // Avoid UAF on listener
+}
+
 class ColumnFamilyHandleDeletionStartedListener : public EventListener {
  private:
   std::vector<std::string> cfs_;
@@ -1138,6 +1138,45 @@ TEST_P(CompressionLogTest, Fragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(CompressionLogTest, Pipeline) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (!StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  ASSERT_OK(SetupTestEnv());
+  // A writer compressing the records of at least a block in the background
+  test::StringSink* pipelined_sink = new test::StringSink();
+  Writer pipelined_writer(
+      std::make_unique<WritableFileWriter>(
+          std::unique_ptr<FSWritableFile>(pipelined_sink), "" /* don't care */,
+          FileOptions()),
+      123, std::get<0>(GetParam()), false, compression_type,
+      false /* track_and_verify_wals */, kBlockSize);
+  ASSERT_OK(pipelined_writer.AddCompressionTypeRecord(WriteOptions()));
+
+  Random rnd(301);
+  std::vector<std::string> wal_entries = {
+      "small",
+      rnd.RandomBinaryString(3 * kBlockSize / 2),
+      rnd.RandomBinaryString(10 * kBlockSize),
+      "",
+      BigString("compressible", 20 * kBlockSize),
+      "small again",
+  };
+  for (const std::string& wal_entry : wal_entries) {
+    Write(wal_entry);
+    ASSERT_OK(pipelined_writer.AddRecord(WriteOptions(), Slice(wal_entry)));
+  }
+
+  // The same bytes are written as when compressing inline
+  ASSERT_EQ(get_reader_contents()->ToString(), pipelined_sink->contents());
+  for (const std::string& wal_entry : wal_entries) {
+    ASSERT_EQ(wal_entry, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
 TEST_P(CompressionLogTest, AlignedFragmentation) {
   CompressionType compression_type = std::get<2>(GetParam());
   if (!StreamingCompressionTypeSupported(compression_type)) {
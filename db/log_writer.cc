@@ -10,19 +10,148 @@
 #include "db/log_writer.h"
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "file/writable_file_writer.h"
 #include "rocksdb/env.h"
+#include "port/port.h"
 #include "rocksdb/io_status.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 #include "util/udt_util.h"
 
 namespace ROCKSDB_NAMESPACE::log {
 
+// Runs the StreamingCompress of a Writer in a background thread, a record at
+// a time, so that the chunks of a large record are compressed while the
+// writing thread appends the ones already compressed. The chunks are the
+// same, and come in the same order, as when compressing inline.
+class Writer::CompressionPipeline {
+ public:
+  CompressionPipeline(StreamingCompress* compress, size_t max_chunk_len)
+      : compress_(compress) {
+    for (Chunk& chunk : chunks_) {
+      chunk.data.reset(new char[max_chunk_len]);
+    }
+    thread_ = port::Thread([this] { Run(); });
+  }
+
+  ~CompressionPipeline() {
+    {
+      MutexLock l(&mutex_);
+      stop_ = true;
+      cv_.SignalAll();
+    }
+    thread_.join();
+  }
+
+  // Starts compressing `record`, which must stay alive until Finish().
+  void Start(const Slice& record) {
+    MutexLock l(&mutex_);
+    assert(!active_);
+    record_ = record;
+    num_produced_ = 0;
+    num_consumed_ = 0;
+    taken_ = false;
+    record_done_ = false;
+    active_ = true;
+    cv_.SignalAll();
+  }
+
+  // Releases the chunk returned by the previous call, if any, and waits for
+  // the next one. Sets `*chunk` and `*chunk_len` to it, and returns what
+  // StreamingCompress::Compress() returned for it.
+  int Next(const char** chunk, size_t* chunk_len) {
+    MutexLock l(&mutex_);
+    assert(active_);
+    if (taken_) {
+      ++num_consumed_;
+      cv_.SignalAll();
+    }
+    while (num_produced_ == num_consumed_) {
+      assert(!record_done_);
+      cv_.Wait();
+    }
+    const Chunk& next = chunks_[num_consumed_ % kNumChunks];
+    taken_ = true;
+    *chunk = next.data.get();
+    *chunk_len = next.len;
+    return next.remaining;
+  }
+
+  // Stops compressing the record, if not done yet, and waits until the
+  // background thread no longer uses it.
+  void Finish() {
+    MutexLock l(&mutex_);
+    active_ = false;
+    while (compressing_) {
+      cv_.Wait();
+    }
+  }
+
+ private:
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    size_t len = 0;
+    int remaining = 0;
+  };
+
+  void Run() {
+    MutexLock l(&mutex_);
+    while (true) {
+      while (!stop_ && (!active_ || record_done_ ||
+                        num_produced_ - num_consumed_ == kNumChunks)) {
+        cv_.Wait();
+      }
+      if (stop_) {
+        return;
+      }
+      const bool first = num_produced_ == 0;
+      Chunk& chunk = chunks_[num_produced_ % kNumChunks];
+      const Slice record = record_;
+      compressing_ = true;
+      mutex_.Unlock();
+      chunk.remaining = compress_->Compress(record.data(), record.size(),
+                                            chunk.data.get(), &chunk.len);
+      mutex_.Lock();
+      compressing_ = false;
+      ++num_produced_;
+      // Same end conditions as the inline loop of AddRecord()
+      if (chunk.remaining <= 0 || (chunk.len == 0 && !first)) {
+        record_done_ = true;
+      }
+      cv_.SignalAll();
+    }
+  }
+
+  static constexpr size_t kNumChunks = 4;
+
+  StreamingCompress* const compress_;
+  Chunk chunks_[kNumChunks];
+  port::Mutex mutex_;
+  port::CondVar cv_{&mutex_};
+  // The rest is protected by mutex_
+  Slice record_;
+  // Whether a record is being written
+  bool active_ = false;
+  // Whether the background thread produced the last chunk of the record
+  bool record_done_ = false;
+  // Whether the background thread is in StreamingCompress::Compress()
+  bool compressing_ = false;
+  // Whether the writing thread holds the chunk num_consumed_
+  bool taken_ = false;
+  size_t num_produced_ = 0;
+  size_t num_consumed_ = 0;
+  bool stop_ = false;
+  port::Thread thread_;
+};
+
 Writer::Writer(std::unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
                bool recycle_log_files, bool manual_flush,
-               CompressionType compression_type, bool track_and_verify_wals)
+               CompressionType compression_type, bool track_and_verify_wals,
+               size_t compression_pipeline_min_record_size)
     : dest_(std::move(dest)),
       block_offset_(0),
       log_number_(log_number),
@@ -32,6 +161,8 @@ Writer::Writer(std::unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
       manual_flush_(manual_flush),
       compression_type_(compression_type),
       compress_(nullptr),
+      compression_pipeline_min_record_size_(
+          compression_pipeline_min_record_size),
       track_and_verify_wals_(track_and_verify_wals),
       last_seqno_recorded_(0) {
   for (uint8_t i = 0; i <= kMaxRecordType; i++) {
@@ -47,6 +178,8 @@ Writer::~Writer() {
   if (dest_) {
     WriteBuffer(WriteOptions()).PermitUncheckedError();
   }
+  // Uses compress_
+  compression_pipeline_.reset();
   if (compress_) {
     delete compress_;
   }
@@ -105,10 +238,22 @@ IOStatus Writer::AddRecord(const WriteOptions& write_options,
     compress_->Reset();
     compress_start = true;
   }
+  CompressionPipeline* const pipeline =
+      compression_pipeline_ != nullptr &&
+              slice.size() >= compression_pipeline_min_record_size_
+          ? compression_pipeline_.get()
+          : nullptr;
+  if (pipeline != nullptr) {
+    pipeline->Start(slice);
+  }
 
   IOOptions opts;
   s = WritableFileWriter::PrepareIOOptions(write_options, opts);
-  if (s.ok()) {
+  if (s.ok() && compress_ == nullptr && !manual_flush_ && left > kBlockSize) {
+    // Written from slice rather than copied into the file buffer fragment by
+    // fragment. Not with manual_flush, which has to keep it buffered.
+    s = EmitFragmentsVectored(opts, slice);
+  } else if (s.ok()) {
     do {
       const int64_t leftover = kBlockSize - block_offset_;
       assert(leftover >= 0);
@@ -139,8 +284,13 @@ IOStatus Writer::AddRecord(const WriteOptions& write_options,
       // previous generated compressed chunk is written out as one or more
       // physical records (left=0).
       if (compress_ && (compress_start || left == 0)) {
-        compress_remaining = compress_->Compress(
-            slice.data(), slice.size(), compressed_buffer_.get(), &left);
+        if (pipeline != nullptr) {
+          compress_remaining = pipeline->Next(&ptr, &left);
+        } else {
+          compress_remaining = compress_->Compress(
+              slice.data(), slice.size(), compressed_buffer_.get(), &left);
+          ptr = compressed_buffer_.get();
+        }
 
         if (compress_remaining < 0) {
           // Set failure status
@@ -154,22 +304,12 @@ IOStatus Writer::AddRecord(const WriteOptions& write_options,
           }
         }
         compress_start = false;
-        ptr = compressed_buffer_.get();
       }
 
       const size_t fragment_length = (left < avail) ? left : avail;
 
-      RecordType type;
       const bool end = (left == fragment_length && compress_remaining == 0);
-      if (begin && end) {
-        type = recycle_log_files_ ? kRecyclableFullType : kFullType;
-      } else if (begin) {
-        type = recycle_log_files_ ? kRecyclableFirstType : kFirstType;
-      } else if (end) {
-        type = recycle_log_files_ ? kRecyclableLastType : kLastType;
-      } else {
-        type = recycle_log_files_ ? kRecyclableMiddleType : kMiddleType;
-      }
+      RecordType type = FragmentType(begin, end);
 
       s = EmitPhysicalRecord(write_options, type, ptr, fragment_length);
       ptr += fragment_length;
@@ -177,6 +317,9 @@ IOStatus Writer::AddRecord(const WriteOptions& write_options,
       begin = false;
     } while (s.ok() && (left > 0 || compress_remaining > 0));
   }
+  if (pipeline != nullptr) {
+    pipeline->Finish();
+  }
   if (s.ok()) {
     if (!manual_flush_) {
       s = dest_->Flush(opts);
@@ -228,6 +371,10 @@ IOStatus Writer::AddCompressionTypeRecord(const WriteOptions& write_options) {
     compressed_buffer_ =
         std::unique_ptr<char[]>(new char[max_output_buffer_len]);
     assert(compressed_buffer_);
+    if (compression_pipeline_min_record_size_ > 0) {
+      compression_pipeline_ = std::make_unique<CompressionPipeline>(
+          compress_, max_output_buffer_len);
+    }
   } else {
     // Disable compression if the record could not be added.
     compression_type_ = kNoCompression;
@@ -308,12 +455,73 @@ IOStatus Writer::MaybeAddUserDefinedTimestampSizeRecord(
 
 bool Writer::BufferIsEmpty() { return dest_->BufferIsEmpty(); }
 
-IOStatus Writer::EmitPhysicalRecord(const WriteOptions& write_options,
-                                    RecordType t, const char* ptr, size_t n) {
+RecordType Writer::FragmentType(bool begin, bool end) const {
+  if (begin && end) {
+    return recycle_log_files_ ? kRecyclableFullType : kFullType;
+  } else if (begin) {
+    return recycle_log_files_ ? kRecyclableFirstType : kFirstType;
+  } else if (end) {
+    return recycle_log_files_ ? kRecyclableLastType : kLastType;
+  } else {
+    return recycle_log_files_ ? kRecyclableMiddleType : kMiddleType;
+  }
+}
+
+IOStatus Writer::EmitFragmentsVectored(const IOOptions& opts,
+                                       const Slice& slice) {
+  const char* ptr = slice.data();
+  size_t left = slice.size();
+  // At most one fragment at the end of the current block, then full blocks
+  const size_t max_fragments = 2 + left / (kBlockSize - header_size_);
+  std::unique_ptr<char[]> headers(
+      new char[max_fragments * kRecyclableHeaderSize]);
+  char* header = headers.get();
+  // A trailer, a header and a payload per fragment
+  std::vector<Slice> pieces;
+  pieces.reserve(3 * max_fragments);
+
+  bool begin = true;
+  do {
+    const int64_t leftover = kBlockSize - block_offset_;
+    assert(leftover >= 0);
+    if (leftover < header_size_) {
+      // Switch to a new block
+      if (leftover > 0) {
+        assert(header_size_ <= 11);
+        pieces.emplace_back("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+                            static_cast<size_t>(leftover));
+      }
+      block_offset_ = 0;
+    }
+
+    const size_t avail = kBlockSize - block_offset_ - header_size_;
+    const size_t fragment_length = (left < avail) ? left : avail;
+    RecordType type = FragmentType(begin, left == fragment_length);
+
+    uint32_t payload_crc;
+    size_t header_size =
+        EncodePhysicalRecordHeader(type, ptr, fragment_length, header,
+                                   &payload_crc);
+    pieces.emplace_back(header, header_size);
+    pieces.emplace_back(ptr, fragment_length);
+    header += header_size;
+    block_offset_ += header_size + fragment_length;
+
+    ptr += fragment_length;
+    left -= fragment_length;
+    begin = false;
+  } while (left > 0);
+  assert(header <= headers.get() + max_fragments * kRecyclableHeaderSize);
+
+  return dest_->AppendV(opts, pieces);
+}
+
+size_t Writer::EncodePhysicalRecordHeader(RecordType t, const char* ptr,
+                                          size_t n, char* buf,
+                                          uint32_t* payload_crc) {
   assert(n <= 0xffff);  // Must fit in two bytes
 
   size_t header_size;
-  char buf[kRecyclableHeaderSize];
 
   // Format the header
   buf[4] = static_cast<char>(n & 0xff);
@@ -341,12 +549,20 @@ IOStatus Writer::EmitPhysicalRecord(const WriteOptions& write_options,
   }
 
   // Compute the crc of the record type and the payload.
-  uint32_t payload_crc = crc32c::Value(ptr, n);
-  crc = crc32c::Crc32cCombine(crc, payload_crc, n);
+  *payload_crc = crc32c::Value(ptr, n);
+  crc = crc32c::Crc32cCombine(crc, *payload_crc, n);
   crc = crc32c::Mask(crc);  // Adjust for storage
   TEST_SYNC_POINT_CALLBACK("LogWriter::EmitPhysicalRecord:BeforeEncodeChecksum",
                            &crc);
   EncodeFixed32(buf, crc);
+  return header_size;
+}
+
+IOStatus Writer::EmitPhysicalRecord(const WriteOptions& write_options,
+                                    RecordType t, const char* ptr, size_t n) {
+  char buf[kRecyclableHeaderSize];
+  uint32_t payload_crc;
+  size_t header_size = EncodePhysicalRecordHeader(t, ptr, n, buf, &payload_crc);
 
   // Write the header and the payload
   IOOptions opts;
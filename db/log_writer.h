@@ -83,7 +83,8 @@ class Writer {
                   uint64_t log_number, bool recycle_log_files,
                   bool manual_flush = false,
                   CompressionType compressionType = kNoCompression,
-                  bool track_and_verify_wals = false);
+                  bool track_and_verify_wals = false,
+                  size_t compression_pipeline_min_record_size = 0);
   // No copying allowed
   Writer(const Writer&) = delete;
   void operator=(const Writer&) = delete;
@@ -140,6 +141,19 @@ class Writer {
   IOStatus EmitPhysicalRecord(const WriteOptions& write_options,
                               RecordType type, const char* ptr, size_t length);
 
+  // Formats the header of a physical record into buf, which must have room
+  // for kRecyclableHeaderSize bytes, and returns its size. The crc of the
+  // payload is returned in payload_crc.
+  size_t EncodePhysicalRecordHeader(RecordType type, const char* ptr,
+                                    size_t length, char* buf,
+                                    uint32_t* payload_crc);
+
+  // Emits all the physical records of an uncompressed record with a single
+  // vectored append
+  IOStatus EmitFragmentsVectored(const IOOptions& opts, const Slice& slice);
+
+  RecordType FragmentType(bool begin, bool end) const;
+
   IOStatus MaybeHandleSeenFileWriterError();
 
   IOStatus MaybeSwitchToNewBlock(const WriteOptions& write_options,
@@ -154,6 +168,11 @@ class Writer {
   StreamingCompress* compress_;
   // Reusable compressed output buffer
   std::unique_ptr<char[]> compressed_buffer_;
+  // Records of at least this size are compressed by compression_pipeline_,
+  // see DBOptions::wal_compression_pipeline_min_record_size
+  const size_t compression_pipeline_min_record_size_;
+  class CompressionPipeline;
+  std::unique_ptr<CompressionPipeline> compression_pipeline_;
 
   // The recorded user-defined timestamp size that have been written so far.
   // Since the user-defined timestamp size cannot be changed while the DB is
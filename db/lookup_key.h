@@ -24,6 +24,12 @@ class LookupKey {
   LookupKey(const Slice& _user_key, SequenceNumber sequence,
             const Slice* ts = nullptr);
 
+  // Same, but builds the key in `*buf` instead of a new allocation when it
+  // does not fit the inline space, so that the lookups sharing the buffer
+  // only allocate when it has to grow. `*buf` must outlive *this.
+  LookupKey(const Slice& _user_key, SequenceNumber sequence, const Slice* ts,
+            std::string* buf);
+
   ~LookupKey();
 
   // Return a key suitable for lookup in a MemTable.
@@ -54,15 +60,38 @@ class LookupKey {
   const char* start_;
   const char* kstart_;
   const char* end_;
+  // Whether start_ was allocated, rather than in space_ or a caller's buffer
+  bool owned_ = false;
   char space_[200];  // Avoid allocation for short keys
 
+  void Init(const Slice& _user_key, SequenceNumber s, const Slice* ts,
+            std::string* buf);
+
   // No copying allowed
   LookupKey(const LookupKey&);
   void operator=(const LookupKey&);
 };
 
 inline LookupKey::~LookupKey() {
-  if (start_ != space_) delete[] start_;
+  if (owned_) delete[] start_;
 }
 
+// Lends the LookupKey buffer of the thread to a Get(), keeping its
+// capacity across the lookups of the thread. Nested lookups, e.g. from a
+// merge operator, get an empty buffer of their own.
+class ThreadLocalLookupKeyBuffer {
+ public:
+  ThreadLocalLookupKeyBuffer() { buf_.swap(tls_buf_); }
+  ~ThreadLocalLookupKeyBuffer();
+
+  std::string* get() { return &buf_; }
+
+ private:
+  // Beyond this, the buffer is not kept for the next lookup
+  static constexpr size_t kMaxKeptCapacity = 64 << 10;
+
+  static thread_local std::string tls_buf_;
+  std::string buf_;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -26,6 +26,7 @@
 #include "logging/logging.h"
 #include "memory/arena.h"
 #include "memory/memory_usage.h"
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/statistics_impl.h"
 #include "port/lang.h"
@@ -42,7 +43,9 @@
 #include "table/merging_iterator.h"
 #include "util/autovector.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/mutexlock.h"
+#include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -61,6 +64,7 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
       inplace_update_support(ioptions.inplace_update_support),
       inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
       inplace_callback(ioptions.inplace_callback),
+      inplace_merge_support(ioptions.inplace_merge_support),
       max_successive_merges(mutable_cf_options.max_successive_merges),
       strict_max_successive_merges(
           mutable_cf_options.strict_max_successive_merges),
@@ -69,8 +73,22 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
       info_log(ioptions.logger),
       protection_bytes_per_key(
           mutable_cf_options.memtable_protection_bytes_per_key),
+      protection_verify_one_in(
+          mutable_cf_options.memtable_protection_verify_one_in),
       allow_data_in_errors(ioptions.allow_data_in_errors),
-      paranoid_memory_checks(mutable_cf_options.paranoid_memory_checks) {}
+      paranoid_memory_checks(mutable_cf_options.paranoid_memory_checks),
+      value_compression(ioptions.memtable_value_compression),
+      value_compression_min_size(ioptions.memtable_value_compression_min_size),
+      point_lookup_index_buckets(static_cast<uint32_t>(std::min<double>(
+          static_cast<double>(mutable_cf_options.write_buffer_size) *
+              ioptions.memtable_point_lookup_index_ratio / sizeof(void*),
+          std::numeric_limits<uint32_t>::max()))) {
+  // In-place updates and the entry checksums work on the stored value
+  if (inplace_update_support || protection_bytes_per_key > 0 ||
+      !CompressionTypeSupported(value_compression)) {
+    value_compression = kNoCompression;
+  }
+}
 
 MemTable::MemTable(const InternalKeyComparator& cmp,
                    const ImmutableOptions& ioptions,
@@ -128,10 +146,25 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                          6 /* hard coded 6 probes */,
                          moptions_.memtable_huge_page_size, ioptions.logger));
   }
+  // The index relies on keys being equal only if their bytes are
+  if (moptions_.point_lookup_index_buckets > 0 &&
+      !moptions_.inplace_update_support &&
+      cmp.user_comparator()->timestamp_size() == 0 &&
+      !cmp.user_comparator()->CanKeysWithDifferentByteContentsBeEqual()) {
+    point_lookup_index_.reset(new MemTablePointLookupIndex(
+        &arena_, moptions_.point_lookup_index_buckets,
+        moptions_.memtable_huge_page_size, ioptions.logger));
+  }
+  // After the structures that stay on the main arena
+  if (ioptions.memtable_tier_allocator) {
+    arena_.EnableTier(ioptions.memtable_tier_allocator.get(),
+                      ioptions.memtable_tier_min_entry_size);
+  }
   // Initialize cached_range_tombstone_ here since it could
   // be read before it is constructed in MemTable::Add(), which could also lead
   // to a data race on the global mutex table backing atomic shared_ptr.
   auto new_cache = std::make_shared<FragmentedRangeTombstoneListCache>();
+  new_cache->extend_base = true;
   size_t size = cached_range_tombstone_.Size();
   for (size_t i = 0; i < size; ++i) {
     std::shared_ptr<FragmentedRangeTombstoneListCache>* local_cache_ref_ptr =
@@ -272,6 +305,30 @@ void MemTable::UpdateOldestKeyTime() {
   }
 }
 
+Status MemTable::DecodeValue(Slice* value, std::string* buf) {
+  if (value->empty()) {
+    return Status::Corruption("Missing memtable value compression type");
+  }
+  const CompressionType type = static_cast<CompressionType>((*value)[0]);
+  value->remove_prefix(1);
+  if (type == kNoCompression) {
+    return Status::OK();
+  }
+  UncompressionContext context(type);
+  UncompressionInfo info(context, UncompressionDict::GetEmptyDict(), type);
+  constexpr uint32_t compression_format_version = 2;
+  size_t uncompressed_size = 0;
+  CacheAllocationPtr output =
+      OLD_UncompressData(info, value->data(), value->size(), &uncompressed_size,
+                         compression_format_version);
+  if (!output) {
+    return Status::Corruption("Unable to uncompress memtable value");
+  }
+  buf->assign(output.get(), uncompressed_size);
+  *value = *buf;
+  return Status::OK();
+}
+
 Status MemTable::VerifyEntryChecksum(const char* entry,
                                      uint32_t protection_bytes_per_key,
                                      bool allow_data_in_errors) {
@@ -368,7 +425,8 @@ class MemTableIterator : public InternalIterator {
       Kind kind, const MemTable& mem, const ReadOptions& read_options,
       UnownedPtr<const SeqnoToTimeMapping> seqno_to_time_mapping = nullptr,
       Arena* arena = nullptr,
-      const SliceTransform* cf_prefix_extractor = nullptr)
+      const SliceTransform* cf_prefix_extractor = nullptr,
+      bool for_flush = false)
       : bloom_(nullptr),
         prefix_extractor_(mem.prefix_extractor_),
         comparator_(mem.comparator_),
@@ -377,12 +435,22 @@ class MemTableIterator : public InternalIterator {
         logger_(mem.moptions_.info_log),
         ts_sz_(mem.ts_sz_),
         protection_bytes_per_key_(mem.moptions_.protection_bytes_per_key),
+        verify_one_in_(for_flush || kind == kRangeDelEntries
+                           ? 1
+                           : mem.moptions_.protection_verify_one_in),
         valid_(false),
         value_pinned_(
-            !mem.GetImmutableMemTableOptions()->inplace_update_support),
+            !mem.GetImmutableMemTableOptions()->inplace_update_support &&
+            mem.GetImmutableMemTableOptions()->value_compression ==
+                kNoCompression),
+        value_compression_(mem.moptions_.value_compression != kNoCompression &&
+                           kind == kPointEntries),
         arena_mode_(arena != nullptr),
         paranoid_memory_checks_(mem.moptions_.paranoid_memory_checks),
         allow_data_in_error(mem.moptions_.allow_data_in_errors) {
+    if (protection_bytes_per_key_ > 0 && verify_one_in_ > 1) {
+      verify_countdown_ = Random::GetTLSInstance()->Uniform(verify_one_in_);
+    }
     if (kind == kRangeDelEntries) {
       iter_ = mem.range_del_table_->GetIterator(arena);
     } else if (prefix_extractor_ != nullptr &&
@@ -435,6 +503,7 @@ class MemTableIterator : public InternalIterator {
 
   void Seek(const Slice& k) override {
     PERF_TIMER_GUARD(seek_on_memtable_time);
+    OPERATION_SPAN_GUARD(MemTableSeek);
     PERF_COUNTER_ADD(seek_on_memtable_count, 1);
     status_ = Status::OK();
     if (bloom_) {
@@ -461,6 +530,7 @@ class MemTableIterator : public InternalIterator {
   }
   void SeekForPrev(const Slice& k) override {
     PERF_TIMER_GUARD(seek_on_memtable_time);
+    OPERATION_SPAN_GUARD(MemTableSeek);
     PERF_COUNTER_ADD(seek_on_memtable_count, 1);
     status_ = Status::OK();
     if (bloom_) {
@@ -557,10 +627,25 @@ class MemTableIterator : public InternalIterator {
   Slice value() const override {
     assert(Valid());
     Slice key_slice = GetLengthPrefixedSlice(iter_->key());
-    return GetLengthPrefixedSlice(key_slice.data() + key_slice.size());
+    Slice value = GetLengthPrefixedSlice(key_slice.data() + key_slice.size());
+    if (value_compression_ && ExtractValueType(key_slice) == kTypeValue) {
+      if (value_buf_entry_ == iter_->key()) {
+        return value_buf_;
+      }
+      Status s = MemTable::DecodeValue(&value, &value_buf_str_);
+      if (!s.ok()) {
+        value_status_ = s;
+        return Slice();
+      }
+      value_buf_entry_ = iter_->key();
+      value_buf_ = value;
+    }
+    return value;
   }
 
-  Status status() const override { return status_; }
+  Status status() const override {
+    return status_.ok() ? value_status_ : status_;
+  }
 
   bool IsKeyPinned() const override {
     // memtable data is always pinned
@@ -583,14 +668,36 @@ class MemTableIterator : public InternalIterator {
   Logger* logger_;
   size_t ts_sz_;
   uint32_t protection_bytes_per_key_;
+  // The checksum of one in this many entries is verified
+  const uint32_t verify_one_in_;
+  // Entries to skip before the next one to verify
+  uint32_t verify_countdown_ = 0;
   bool valid_;
   bool value_pinned_;
+  const bool value_compression_;
   bool arena_mode_;
   const bool paranoid_memory_checks_;
   const bool allow_data_in_error;
+  // The value of the entry last returned by value(), with value compression
+  mutable const char* value_buf_entry_ = nullptr;
+  mutable Slice value_buf_;
+  mutable std::string value_buf_str_;
+  mutable Status value_status_;
+
+  bool ShouldVerifyEntry() {
+    if (verify_one_in_ <= 1) {
+      return verify_one_in_ == 1;
+    }
+    if (verify_countdown_ > 0) {
+      --verify_countdown_;
+      return false;
+    }
+    verify_countdown_ = verify_one_in_ - 1;
+    return true;
+  }
 
   void VerifyEntryChecksum() {
-    if (protection_bytes_per_key_ > 0 && Valid()) {
+    if (protection_bytes_per_key_ > 0 && Valid() && ShouldVerifyEntry()) {
       status_ = MemTable::VerifyEntryChecksum(iter_->key(),
                                               protection_bytes_per_key_);
       if (!status_.ok()) {
@@ -603,12 +710,12 @@ class MemTableIterator : public InternalIterator {
 InternalIterator* MemTable::NewIterator(
     const ReadOptions& read_options,
     UnownedPtr<const SeqnoToTimeMapping> seqno_to_time_mapping, Arena* arena,
-    const SliceTransform* prefix_extractor, bool /*for_flush*/) {
+    const SliceTransform* prefix_extractor, bool for_flush) {
   assert(arena != nullptr);
   auto mem = arena->AllocateAligned(sizeof(MemTableIterator));
-  return new (mem)
-      MemTableIterator(MemTableIterator::kPointEntries, *this, read_options,
-                       seqno_to_time_mapping, arena, prefix_extractor);
+  return new (mem) MemTableIterator(MemTableIterator::kPointEntries, *this,
+                                    read_options, seqno_to_time_mapping, arena,
+                                    prefix_extractor, for_flush);
 }
 
 // An iterator wrapper that wraps a MemTableIterator and logically strips each
@@ -624,9 +731,10 @@ class TimestampStrippingIterator : public InternalIterator {
     assert(ts_sz_ != 0);
     void* mem = arena ? arena->AllocateAligned(sizeof(MemTableIterator))
                       : operator new(sizeof(MemTableIterator));
+    // Only used to flush the memtable
     iter_ = new (mem)
         MemTableIterator(kind, memtable, read_options, seqno_to_time_mapping,
-                         arena, cf_prefix_extractor);
+                         arena, cf_prefix_extractor, /*for_flush=*/true);
   }
 
   // No copying allowed
@@ -795,11 +903,16 @@ FragmentedRangeTombstoneIterator* MemTable::NewRangeTombstoneIteratorInternal(
   if (!cache->initialized.load(std::memory_order_acquire)) {
     cache->reader_mutex.lock();
     if (!cache->tombstones) {
-      auto* unfragmented_iter = new MemTableIterator(
-          MemTableIterator::kRangeDelEntries, *this, read_options);
-      cache->tombstones.reset(new FragmentedRangeTombstoneList(
-          std::unique_ptr<InternalIterator>(unfragmented_iter),
-          comparator_.comparator));
+      if (cache->extend_base) {
+        cache->tombstones = std::make_shared<FragmentedRangeTombstoneList>(
+            cache->base.get(), cache->new_tombstones, comparator_.comparator);
+      } else {
+        auto* unfragmented_iter = new MemTableIterator(
+            MemTableIterator::kRangeDelEntries, *this, read_options);
+        cache->tombstones.reset(new FragmentedRangeTombstoneList(
+            std::unique_ptr<InternalIterator>(unfragmented_iter),
+            comparator_.comparator));
+      }
       cache->initialized.store(true, std::memory_order_release);
     }
     cache->reader_mutex.unlock();
@@ -884,6 +997,14 @@ Status MemTable::VerifyEncodedEntry(Slice encoded,
     return Status::Corruption("Value length too long");
   }
   Slice value(encoded.data(), value_len);
+  std::string value_buf;
+  if (moptions_.value_compression != kNoCompression &&
+      value_type == kTypeValue) {
+    Status s = DecodeValue(&value, &value_buf);
+    if (!s.ok()) {
+      return s;
+    }
+  }
 
   return kv_prot_info.StripS(sequence_number)
       .StripKVO(key, value, value_type)
@@ -922,8 +1043,31 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
   //  value_size   : varint32 of value.size()
   //  value bytes  : char[value.size()]
   //  checksum     : char[moptions_.protection_bytes_per_key]
+  // With value compression, the value bytes of kTypeValue are the
+  // compression type (1 byte) and the value compressed with it.
+  Slice stored_value = value;
+  char value_header = 0;
+  bool has_value_header = false;
+  std::string compressed_value;
+  if (moptions_.value_compression != kNoCompression && type == kTypeValue) {
+    has_value_header = true;
+    if (value.size() >= moptions_.value_compression_min_size) {
+      CompressionOptions opts;
+      CompressionContext context(moptions_.value_compression, opts);
+      CompressionInfo info(opts, context, CompressionDict::GetEmptyDict(),
+                           moptions_.value_compression);
+      constexpr uint32_t compression_format_version = 2;
+      if (OLD_CompressData(value, info, compression_format_version,
+                           &compressed_value) &&
+          compressed_value.size() < value.size()) {
+        value_header = static_cast<char>(moptions_.value_compression);
+        stored_value = compressed_value;
+      }
+    }
+  }
   uint32_t key_size = static_cast<uint32_t>(key.size());
-  uint32_t val_size = static_cast<uint32_t>(value.size());
+  uint32_t val_size =
+      static_cast<uint32_t>(stored_value.size() + (has_value_header ? 1 : 0));
   uint32_t internal_key_size = key_size + 8;
   const uint32_t encoded_len = VarintLength(internal_key_size) +
                                internal_key_size + VarintLength(val_size) +
@@ -941,7 +1085,14 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
   EncodeFixed64(p, packed);
   p += 8;
   p = EncodeVarint32(p, val_size);
-  memcpy(p, value.data(), val_size);
+  Slice internal_key_slice(key_slice.data(), internal_key_size);
+  Slice value_slice(p, val_size);
+  if (has_value_header) {
+    p[0] = value_header;
+    memcpy(p + 1, stored_value.data(), stored_value.size());
+  } else {
+    memcpy(p, value.data(), val_size);
+  }
   assert((unsigned)(p + val_size - buf + moptions_.protection_bytes_per_key) ==
          (unsigned)encoded_len);
 
@@ -974,6 +1125,9 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
         return Status::TryAgain("key+seq exists");
       }
     }
+    if (point_lookup_index_ && table == table_) {
+      point_lookup_index_->Add(key, s, buf);
+    }
 
     // this is a bit ugly, but is the way to avoid locked instructions
     // when incrementing an atomic
@@ -1021,6 +1175,9 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
     if (UNLIKELY(!res)) {
       return Status::TryAgain("key+seq exists");
     }
+    if (point_lookup_index_ && table == table_) {
+      point_lookup_index_->Add(key, s, buf);
+    }
 
     assert(post_process_info != nullptr);
     post_process_info->num_entries++;
@@ -1057,6 +1214,28 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
       post_process_info->num_range_deletes++;
       range_del_mutex_.lock();
     }
+    if (ts_sz_ == 0) {
+      // Let the first reader add the new tombstones to the last fragmented
+      // list rather than refragmenting every range tombstone, as long as only
+      // a few were added since that list was built.
+      std::shared_ptr<FragmentedRangeTombstoneListCache> old_cache =
+          std::atomic_load_explicit(cached_range_tombstone_.Access(),
+                                    std::memory_order_relaxed);
+      if (old_cache->initialized.load(std::memory_order_acquire)) {
+        new_cache->base = old_cache->tombstones;
+        new_cache->extend_base = true;
+      } else if (old_cache->extend_base &&
+                 old_cache->new_tombstones.size() <
+                     kMaxRangeTombstonesToExtendBase) {
+        new_cache->base = old_cache->base;
+        new_cache->new_tombstones = old_cache->new_tombstones;
+        new_cache->extend_base = true;
+      }
+      if (new_cache->extend_base) {
+        new_cache->new_tombstones.emplace_back(internal_key_slice,
+                                               value_slice);
+      }
+    }
     for (size_t i = 0; i < size; ++i) {
       std::shared_ptr<FragmentedRangeTombstoneListCache>* local_cache_ref_ptr =
           cached_range_tombstone_.AccessAtCore(i);
@@ -1258,9 +1437,23 @@ static bool SaveValue(void* arg, const char* entry) {
         if (type == kTypeValuePreferredSeqno) {
           v = ParsePackedValueForValue(v);
         }
+        std::string value_buf;
+        const bool value_compression =
+            s->mem->GetImmutableMemTableOptions()->value_compression !=
+                kNoCompression &&
+            type == kTypeValue;
+        if (value_compression) {
+          Status decode_status = MemTable::DecodeValue(&v, &value_buf);
+          if (!decode_status.ok()) {
+            *(s->status) = decode_status;
+            *(s->found_final_value) = true;
+            return false;
+          }
+        }
 
         ReadOnlyMemTable::HandleTypeValue(
-            s->key->user_key(), v, s->inplace_update_support == false,
+            s->key->user_key(), v,
+            s->inplace_update_support == false && !value_compression,
             s->do_merge, *(s->merge_in_progress), merge_context,
             s->merge_operator, s->clock, s->statistics, s->logger, s->status,
             s->value, s->columns, s->is_blob_index);
@@ -1357,6 +1550,83 @@ static bool SaveValue(void* arg, const char* entry) {
   return false;
 }
 
+// Sets up a Saver for looking up key in mem
+bool MemTable::GetFromPointLookupIndex(const LookupKey& key,
+                                       ReadCallback* callback, void* saver) {
+  if (point_lookup_index_ == nullptr || callback != nullptr ||
+      moptions_.paranoid_memory_checks) {
+    return false;
+  }
+  const char* entry = point_lookup_index_->Get(key.user_key());
+  if (entry == nullptr) {
+    return false;
+  }
+  uint32_t key_length = 0;
+  const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+  ValueType type;
+  SequenceNumber seq;
+  UnPackSequenceAndType(DecodeFixed64(key_ptr + key_length - 8), &seq, &type);
+  // The newest entry of the key must be visible to the read, and not need
+  // the older ones
+  if (seq > GetInternalKeySeqno(key.internal_key())) {
+    return false;
+  }
+  switch (type) {
+    case kTypeValue:
+    case kTypeWideColumnEntity:
+    case kTypeDeletion:
+    case kTypeSingleDeletion:
+      break;
+    default:
+      return false;
+  }
+  TEST_SYNC_POINT("MemTable::GetFromPointLookupIndex:Found");
+  const bool more = SaveValue(saver, entry);
+  assert(!more);
+  (void)more;
+  return true;
+}
+
+static void InitSaver(Saver* saver, MemTable* mem,
+                      const ImmutableMemTableOptions& moptions,
+                      SystemClock* clock, const LookupKey& key,
+                      SequenceNumber max_covering_tombstone_seq, bool do_merge,
+                      ReadCallback* callback, bool* is_blob_index,
+                      std::string* value, PinnableWideColumns* columns,
+                      std::string* timestamp, Status* s,
+                      MergeContext* merge_context, bool* found_final_value,
+                      bool* merge_in_progress) {
+  saver->status = s;
+  saver->found_final_value = found_final_value;
+  saver->merge_in_progress = merge_in_progress;
+  saver->key = &key;
+  saver->value = value;
+  saver->columns = columns;
+  saver->timestamp = timestamp;
+  saver->seq = kMaxSequenceNumber;
+  saver->mem = mem;
+  saver->merge_context = merge_context;
+  saver->max_covering_tombstone_seq = max_covering_tombstone_seq;
+  saver->merge_operator = moptions.merge_operator;
+  saver->logger = moptions.info_log;
+  saver->inplace_update_support = moptions.inplace_update_support;
+  saver->statistics = moptions.statistics;
+  saver->clock = clock;
+  saver->callback_ = callback;
+  saver->is_blob_index = is_blob_index;
+  saver->do_merge = do_merge;
+  saver->allow_data_in_errors = moptions.allow_data_in_errors;
+  // Only one in protection_verify_one_in lookups verifies the checksums
+  const uint32_t verify_one_in = moptions.protection_verify_one_in;
+  saver->protection_bytes_per_key =
+      moptions.protection_bytes_per_key > 0 &&
+              (verify_one_in == 1 ||
+               (verify_one_in > 1 &&
+                Random::GetTLSInstance()->OneIn(verify_one_in)))
+          ? moptions.protection_bytes_per_key
+          : 0;
+}
+
 bool MemTable::Get(const LookupKey& key, std::string* value,
                    PinnableWideColumns* columns, std::string* timestamp,
                    Status* s, MergeContext* merge_context,
@@ -1371,6 +1641,7 @@ bool MemTable::Get(const LookupKey& key, std::string* value,
   }
 
   PERF_TIMER_GUARD(get_from_memtable_time);
+  OPERATION_SPAN_GUARD(MemTableGet);
 
   std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
       NewRangeTombstoneIterator(read_opts,
@@ -1446,29 +1717,13 @@ void MemTable::GetFromTable(const LookupKey& key,
                             MergeContext* merge_context, SequenceNumber* seq,
                             bool* found_final_value, bool* merge_in_progress) {
   Saver saver;
-  saver.status = s;
-  saver.found_final_value = found_final_value;
-  saver.merge_in_progress = merge_in_progress;
-  saver.key = &key;
-  saver.value = value;
-  saver.columns = columns;
-  saver.timestamp = timestamp;
-  saver.seq = kMaxSequenceNumber;
-  saver.mem = this;
-  saver.merge_context = merge_context;
-  saver.max_covering_tombstone_seq = max_covering_tombstone_seq;
-  saver.merge_operator = moptions_.merge_operator;
-  saver.logger = moptions_.info_log;
-  saver.inplace_update_support = moptions_.inplace_update_support;
-  saver.statistics = moptions_.statistics;
-  saver.clock = clock_;
-  saver.callback_ = callback;
-  saver.is_blob_index = is_blob_index;
-  saver.do_merge = do_merge;
-  saver.allow_data_in_errors = moptions_.allow_data_in_errors;
-  saver.protection_bytes_per_key = moptions_.protection_bytes_per_key;
-
-  if (!moptions_.paranoid_memory_checks) {
+  InitSaver(&saver, this, moptions_, clock_, key, max_covering_tombstone_seq,
+            do_merge, callback, is_blob_index, value, columns, timestamp, s,
+            merge_context, found_final_value, merge_in_progress);
+
+  if (GetFromPointLookupIndex(key, callback, &saver)) {
+    // Found without searching the memtable rep
+  } else if (!moptions_.paranoid_memory_checks) {
     table_->Get(key, &saver, SaveValue);
   } else {
     Status check_s = table_->GetAndValidate(key, &saver, SaveValue,
@@ -1491,6 +1746,7 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
     return;
   }
   PERF_TIMER_GUARD(get_from_memtable_time);
+  OPERATION_SPAN_GUARD(MemTableGet);
 
   // For now, memtable Bloom filter is effectively disabled if there are any
   // range tombstones. This is the simplest way to ensure range tombstones are
@@ -1525,9 +1781,20 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
       }
     }
   }
+  // Look up all keys before processing any results, so that the memtable
+  // can overlap the lookups
+  std::array<Saver, MultiGetContext::MAX_BATCH_SIZE> savers;
+  std::array<const LookupKey*, MultiGetContext::MAX_BATCH_SIZE> lookup_keys;
+  std::array<void*, MultiGetContext::MAX_BATCH_SIZE> saver_args;
+  std::array<bool, MultiGetContext::MAX_BATCH_SIZE> found_final_values;
+  std::array<bool, MultiGetContext::MAX_BATCH_SIZE> merges_in_progress;
+  size_t num_lookups = 0;
+  // The lookups not settled by the point lookup index
+  size_t num_table_lookups = 0;
   for (auto iter = temp_range.begin(); iter != temp_range.end(); ++iter) {
-    bool found_final_value{false};
-    bool merge_in_progress = iter->s->IsMergeInProgress();
+    const size_t i = num_lookups++;
+    found_final_values[i] = false;
+    merges_in_progress[i] = iter->s->IsMergeInProgress();
     if (!no_range_del) {
       std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
           NewRangeTombstoneIteratorInternal(
@@ -1545,12 +1812,38 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         }
       }
     }
-    SequenceNumber dummy_seq;
-    GetFromTable(*(iter->lkey), iter->max_covering_tombstone_seq, true,
-                 callback, &iter->is_blob_index,
-                 iter->value ? iter->value->GetSelf() : nullptr, iter->columns,
-                 iter->timestamp, iter->s, &(iter->merge_context), &dummy_seq,
-                 &found_final_value, &merge_in_progress);
+    std::string* value = iter->value ? iter->value->GetSelf() : nullptr;
+    if (moptions_.paranoid_memory_checks) {
+      // Validation is only supported one key at a time
+      SequenceNumber dummy_seq;
+      GetFromTable(*(iter->lkey), iter->max_covering_tombstone_seq, true,
+                   callback, &iter->is_blob_index, value, iter->columns,
+                   iter->timestamp, iter->s, &(iter->merge_context),
+                   &dummy_seq, &found_final_values[i], &merges_in_progress[i]);
+    } else {
+      InitSaver(&savers[i], this, moptions_, clock_, *(iter->lkey),
+                iter->max_covering_tombstone_seq, true, callback,
+                &iter->is_blob_index, value, iter->columns, iter->timestamp,
+                iter->s, &(iter->merge_context), &found_final_values[i],
+                &merges_in_progress[i]);
+      if (!GetFromPointLookupIndex(*(iter->lkey), callback, &savers[i])) {
+        lookup_keys[num_table_lookups] = iter->lkey;
+        saver_args[num_table_lookups++] = &savers[i];
+      }
+    }
+  }
+  if (num_table_lookups > 0) {
+    table_->MultiGet(num_table_lookups, lookup_keys.data(), saver_args.data(),
+                     SaveValue);
+  }
+
+  // Results of temp_range are in the order of the lookups above
+  size_t lookup = 0;
+  for (auto iter = temp_range.begin(); iter != temp_range.end(); ++iter) {
+    const size_t i = lookup++;
+    const bool found_final_value = found_final_values[i];
+    const bool merge_in_progress = merges_in_progress[i];
+    assert(iter->s->ok() || iter->s->IsMergeInProgress() || found_final_value);
 
     if (!found_final_value && merge_in_progress) {
       if (iter->s->ok()) {
@@ -1746,6 +2039,66 @@ Status MemTable::UpdateCallback(SequenceNumber seq, const Slice& key,
   return Status::NotFound();
 }
 
+Status MemTable::UpdateMerge(SequenceNumber seq, const Slice& key,
+                             const Slice& operand,
+                             const ProtectionInfoKVOS64* kv_prot_info) {
+  LookupKey lkey(key, seq);
+  Slice mem_key = lkey.memtable_key();
+
+  std::unique_ptr<MemTableRep::Iterator> iter(
+      table_->GetDynamicPrefixIterator());
+  iter->Seek(lkey.internal_key(), mem_key.data());
+
+  if (iter->Valid()) {
+    // Refer to comments under MemTable::Add() for entry format.
+    const char* entry = iter->key();
+    uint32_t key_length = 0;
+    const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+    if (comparator_.comparator.user_comparator()->Equal(
+            Slice(key_ptr, key_length - 8), lkey.user_key())) {
+      // Correct user key
+      const uint64_t tag = DecodeFixed64(key_ptr + key_length - 8);
+      ValueType type;
+      SequenceNumber existing_seq;
+      UnPackSequenceAndType(tag, &existing_seq, &type);
+      assert(existing_seq != seq);
+      if (type == kTypeMerge) {
+        Slice prev_operand = GetLengthPrefixedSlice(key_ptr + key_length);
+        std::string new_operand;
+        // The existing operand is older, so it is the left operand
+        if (moptions_.merge_operator->PartialMerge(
+                lkey.user_key(), prev_operand, operand, &new_operand,
+                moptions_.info_log) &&
+            new_operand.size() <= prev_operand.size()) {
+          uint32_t new_size = static_cast<uint32_t>(new_operand.size());
+          WriteLock wl(GetLock(lkey.user_key()));
+          char* p =
+              EncodeVarint32(const_cast<char*>(key_ptr) + key_length, new_size);
+          memcpy(p, new_operand.data(), new_operand.size());
+          RecordTick(moptions_.statistics, NUMBER_KEYS_UPDATED);
+          if (kv_prot_info != nullptr) {
+            ProtectionInfoKVOS64 updated_kv_prot_info(*kv_prot_info);
+            // `seq` is swallowed and `existing_seq` prevails.
+            updated_kv_prot_info.UpdateS(seq, existing_seq);
+            updated_kv_prot_info.UpdateV(operand, new_operand);
+            UpdateEntryChecksum(&updated_kv_prot_info, key, new_operand, type,
+                                existing_seq, p + new_operand.size());
+            Slice encoded(entry, p + new_operand.size() - entry);
+            return VerifyEncodedEntry(encoded, updated_kv_prot_info);
+          } else {
+            UpdateEntryChecksum(nullptr, key, new_operand, type, existing_seq,
+                                p + new_operand.size());
+          }
+          return Status::OK();
+        }
+      }
+    }
+  }
+  // The latest value is not `kTypeMerge`, key doesn't exist or the operands
+  // could not be combined in place
+  return Status::NotFound();
+}
+
 size_t MemTable::CountSuccessiveMergeEntries(const LookupKey& key,
                                              size_t limit) {
   Slice memkey = key.memtable_key();
@@ -1791,6 +2144,15 @@ void MemTableRep::Get(const LookupKey& k, void* callback_args,
   }
 }
 
+void MemTableRep::MultiGet(size_t num_keys, const LookupKey* const* keys,
+                           void* const* callback_args,
+                           bool (*callback_func)(void* arg,
+                                                 const char* entry)) {
+  for (size_t i = 0; i < num_keys; i++) {
+    Get(*keys[i], callback_args[i], callback_func);
+  }
+}
+
 void MemTable::RefLogContainingPrepSection(uint64_t log) {
   assert(log > 0);
   auto cur = min_prep_log_referenced_.load();
@@ -25,6 +25,7 @@
 #include "db/version_edit.h"
 #include "memory/allocator.h"
 #include "memory/concurrent_arena.h"
+#include "memtable/point_lookup_index.h"
 #include "monitoring/instrumented_mutex.h"
 #include "options/cf_options.h"
 #include "rocksdb/db.h"
@@ -57,14 +58,24 @@ struct ImmutableMemTableOptions {
                                    uint32_t* existing_value_size,
                                    Slice delta_value,
                                    std::string* merged_value);
+  bool inplace_merge_support;
   size_t max_successive_merges;
   bool strict_max_successive_merges;
   Statistics* statistics;
   MergeOperator* merge_operator;
   Logger* info_log;
   uint32_t protection_bytes_per_key;
+  // Reads verify the checksum of one in this many entries, flush of all
+  uint32_t protection_verify_one_in;
   bool allow_data_in_errors;
   bool paranoid_memory_checks;
+  // kNoCompression if the values are not compressed, see
+  // AdvancedColumnFamilyOptions::memtable_value_compression
+  CompressionType value_compression;
+  size_t value_compression_min_size;
+  // 0 if there is no point lookup index, see
+  // AdvancedColumnFamilyOptions::memtable_point_lookup_index_ratio
+  uint32_t point_lookup_index_buckets;
 };
 
 // Batched counters to updated when inserting keys in one write batch.
@@ -542,6 +553,9 @@ class MemTable final : public ReadOnlyMemTable {
                    const char* prefix_len_key2) const override;
     int operator()(const char* prefix_len_key,
                    const DecodedType& key) const override;
+    size_t timestamp_size() const override {
+      return comparator.user_comparator()->timestamp_size();
+    }
   };
 
   // earliest_seq should be the current SequenceNumber in the db such that any
@@ -679,6 +693,21 @@ class MemTable final : public ReadOnlyMemTable {
                         const Slice& delta,
                         const ProtectionInfoKVOS64* kv_prot_info);
 
+  // If the latest version of `key` in the memtable is a merge operand, combine
+  // it with `operand` by `MergeOperator::PartialMerge()`, and overwrite it in
+  // place when the result is no larger. The existing sequence number is kept.
+  // Used by inplace_merge_support.
+  //
+  // Returns `Status::NotFound` if `key` does not exist in current memtable, the
+  // latest version of `key` is not `kTypeMerge`, or the operands could not be
+  // combined in place. The operand should then be added out-of-place.
+  //
+  // REQUIRES: external synchronization to prevent simultaneous
+  // operations on the same MemTable.
+  Status UpdateMerge(SequenceNumber seq, const Slice& key,
+                     const Slice& operand,
+                     const ProtectionInfoKVOS64* kv_prot_info);
+
   // Returns the number of successive merge entries starting from the newest
   // entry for the key. The count ends when the oldest entry in the memtable
   // with which the newest entry would be merged is reached, or the count
@@ -829,6 +858,11 @@ class MemTable final : public ReadOnlyMemTable {
   //  be called when user defined timestamp is enabled.
   const Slice& GetNewestUDT() const override;
 
+  // With value compression, the value of each kTypeValue entry starts with
+  // the compression type of the rest. Sets *value to the uncompressed value,
+  // which is in *buf if it was compressed.
+  static Status DecodeValue(Slice* value, std::string* buf);
+
   // Returns Corruption status if verification fails.
   static Status VerifyEntryChecksum(const char* entry,
                                     uint32_t protection_bytes_per_key,
@@ -877,6 +911,8 @@ class MemTable final : public ReadOnlyMemTable {
 
   const SliceTransform* const prefix_extractor_;
   std::unique_ptr<DynamicBloom> bloom_filter_;
+  // Set with AdvancedColumnFamilyOptions::memtable_point_lookup_index_ratio
+  std::unique_ptr<MemTablePointLookupIndex> point_lookup_index_;
 
   std::atomic<FlushStateEnum> flush_state_;
 
@@ -921,6 +957,11 @@ class MemTable final : public ReadOnlyMemTable {
                     MergeContext* merge_context, SequenceNumber* seq,
                     bool* found_final_value, bool* merge_in_progress);
 
+  // Returns true if the entry of `key` in point_lookup_index_ settles the
+  // lookup by `saver`, which then holds its result.
+  bool GetFromPointLookupIndex(const LookupKey& key, ReadCallback* callback,
+                               void* saver);
+
   // Always returns non-null and assumes certain pre-checks (e.g.,
   // is_range_del_table_empty_) are done. This is only valid during the lifetime
   // of the underlying memtable.
@@ -942,6 +983,10 @@ class MemTable final : public ReadOnlyMemTable {
   std::unique_ptr<FragmentedRangeTombstoneList>
       timestamp_stripping_fragmented_range_tombstone_list_;
 
+  // A reader extends the last fragmented range tombstone list with at most
+  // this many new tombstones before refragmenting all of them instead.
+  static constexpr size_t kMaxRangeTombstonesToExtendBase = 16;
+
   // makes sure there is a single range tombstone writer to invalidate cache
   std::mutex range_del_mutex_;
   CoreLocalArray<std::shared_ptr<FragmentedRangeTombstoneListCache>>
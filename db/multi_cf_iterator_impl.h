@@ -12,6 +12,7 @@
 #include "rocksdb/iterator.h"
 #include "rocksdb/options.h"
 #include "util/heap.h"
+#include "util/threadpool_imp.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -30,6 +31,7 @@ class MultiCfIteratorImpl {
           cfh_iter_pairs,
       ResetFunc reset_func, PopulateFunc populate_func)
       : allow_unprepared_value_(read_options.allow_unprepared_value),
+        seek_thread_pool_(read_options.multi_cf_iterator_seek_thread_pool),
         comparator_(comparator),
         cfh_iter_pairs_(std::move(cfh_iter_pairs)),
         reset_func_(std::move(reset_func)),
@@ -112,6 +114,7 @@ class MultiCfIteratorImpl {
  private:
   Status status_;
   bool allow_unprepared_value_;
+  ThreadPool* seek_thread_pool_;
   const Comparator* comparator_;
   std::vector<std::pair<ColumnFamilyHandle*, std::unique_ptr<Iterator>>>
       cfh_iter_pairs_;
@@ -184,9 +187,21 @@ class MultiCfIteratorImpl {
   void SeekCommon(BinaryHeap& heap, ChildSeekFuncType child_seek_func) {
     reset_func_();
     heap.clear();
+    const bool parallel_seek =
+        seek_thread_pool_ != nullptr && cfh_iter_pairs_.size() > 1;
+    if (parallel_seek) {
+      // The child iterators are independent, so each one can be positioned
+      // on its own thread. The heap is then built in order, as below.
+      ParallelFor(seek_thread_pool_, cfh_iter_pairs_.size(),
+                  [this, &child_seek_func](size_t idx) {
+                    child_seek_func(cfh_iter_pairs_[idx].second.get());
+                  });
+    }
     int i = 0;
     for (auto& [cfh, iter] : cfh_iter_pairs_) {
-      child_seek_func(iter.get());
+      if (!parallel_seek) {
+        child_seek_func(iter.get());
+      }
       if (iter->Valid()) {
         assert(iter->status().ok());
         heap.push(MultiCfIteratorInfo{cfh, iter.get(), i});
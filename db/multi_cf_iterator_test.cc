@@ -5,6 +5,7 @@
 
 #include "db/db_test_util.h"
 #include "rocksdb/attribute_groups.h"
+#include "rocksdb/threadpool.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -577,6 +578,53 @@ TEST_F(CoalescingIteratorTest, EmptyCfs) {
   }
 }
 
+TEST_F(CoalescingIteratorTest, ParallelSeek) {
+  Options options = GetDefaultOptions();
+  CreateAndReopenWithCF({"cf_1", "cf_2", "cf_3"}, options);
+
+  // Same key in several CFs, and each CF on disk
+  ASSERT_OK(Put(0, "key_1", "key_1_cf_0_val"));
+  ASSERT_OK(Put(3, "key_1", "key_1_cf_3_val"));
+  ASSERT_OK(Put(1, "key_2", "key_2_cf_1_val"));
+  ASSERT_OK(Put(2, "key_2", "key_2_cf_2_val"));
+  ASSERT_OK(Put(0, "key_3", "key_3_cf_0_val"));
+  ASSERT_OK(Put(1, "key_3", "key_3_cf_1_val"));
+  ASSERT_OK(Put(3, "key_3", "key_3_cf_3_val"));
+  for (int cf = 0; cf < 4; ++cf) {
+    ASSERT_OK(Flush(cf));
+  }
+
+  std::unique_ptr<ThreadPool> pool(NewThreadPool(3));
+  ReadOptions read_options;
+  read_options.multi_cf_iterator_seek_thread_pool = pool.get();
+  std::unique_ptr<Iterator> iter =
+      db_->NewCoalescingIterator(read_options, handles_);
+
+  iter->SeekToFirst();
+  ASSERT_EQ(IterStatus(iter.get()), "key_1->key_1_cf_3_val");
+  iter->Next();
+  ASSERT_EQ(IterStatus(iter.get()), "key_2->key_2_cf_2_val");
+  iter->Seek("key_3");
+  ASSERT_EQ(IterStatus(iter.get()), "key_3->key_3_cf_3_val");
+  iter->Next();
+  ASSERT_EQ(IterStatus(iter.get()), "(invalid)");
+  iter->SeekToLast();
+  ASSERT_EQ(IterStatus(iter.get()), "key_3->key_3_cf_3_val");
+  iter->Prev();
+  ASSERT_EQ(IterStatus(iter.get()), "key_2->key_2_cf_2_val");
+  // Switching direction seeks the children again
+  iter->Next();
+  ASSERT_EQ(IterStatus(iter.get()), "key_3->key_3_cf_3_val");
+  iter->SeekForPrev("key_2");
+  ASSERT_EQ(IterStatus(iter.get()), "key_2->key_2_cf_2_val");
+  iter->Seek("key_x");
+  ASSERT_EQ(IterStatus(iter.get()), "(invalid)");
+  ASSERT_OK(iter->status());
+
+  iter.reset();
+  pool->JoinAllThreads();
+}
+
 TEST_F(CoalescingIteratorTest, WideColumns) {
   // Set up the DB and Column Families
   Options options = GetDefaultOptions();
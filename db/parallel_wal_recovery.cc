@@ -0,0 +1,136 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/parallel_wal_recovery.h"
+
+#include <cassert>
+
+#include "db/column_family.h"
+#include "db/db_impl/db_impl.h"
+#include "db/write_batch_internal.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Only finds the column families assigned to one thread
+class AssignedColumnFamilyMemTables : public ColumnFamilyMemTablesImpl {
+ public:
+  AssignedColumnFamilyMemTables(ColumnFamilySet* column_family_set,
+                                uint32_t index, uint32_t num_threads)
+      : ColumnFamilyMemTablesImpl(column_family_set),
+        index_(index),
+        num_threads_(num_threads) {}
+
+  bool Seek(uint32_t column_family_id) override {
+    return column_family_id % num_threads_ == index_ &&
+           ColumnFamilyMemTablesImpl::Seek(column_family_id);
+  }
+
+ private:
+  const uint32_t index_;
+  const uint32_t num_threads_;
+};
+
+// Bounds the memory of the batches read ahead of the slowest thread
+constexpr size_t kMaxQueuedBatches = 256;
+}  // namespace
+
+struct ParallelWalRecovery::Worker {
+  Worker(ColumnFamilySet* column_family_set, uint32_t index,
+         uint32_t num_threads)
+      : memtables(column_family_set, index, num_threads),
+        queue(kMaxQueuedBatches) {}
+
+  AssignedColumnFamilyMemTables memtables;
+  WorkQueue<Work> queue;
+  port::Thread thread;
+};
+
+ParallelWalRecovery::ParallelWalRecovery(
+    DBImpl* db, ColumnFamilySet* column_family_set,
+    FlushScheduler* flush_scheduler,
+    TrimHistoryScheduler* trim_history_scheduler, int num_threads)
+    : db_(db),
+      flush_scheduler_(flush_scheduler),
+      trim_history_scheduler_(trim_history_scheduler) {
+  assert(num_threads > 1);
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(new Worker(column_family_set, static_cast<uint32_t>(i),
+                                     static_cast<uint32_t>(num_threads)));
+  }
+  for (auto& worker : workers_) {
+    Worker* w = worker.get();
+    w->thread = port::Thread([this, w]() { Run(w); });
+  }
+}
+
+ParallelWalRecovery::~ParallelWalRecovery() {
+  for (auto& worker : workers_) {
+    worker->queue.finish();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+  assert(pending_ == 0);
+  status_.PermitUncheckedError();
+}
+
+void ParallelWalRecovery::Add(std::shared_ptr<WriteBatch> batch,
+                              uint64_t wal_number) {
+  assert(!batch->HasBeginPrepare() && !batch->HasEndPrepare() &&
+         !batch->HasCommit() && !batch->HasRollback());
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    pending_ += workers_.size();
+  }
+  for (auto& worker : workers_) {
+    Work work;
+    work.batch = batch;
+    work.wal_number = wal_number;
+    bool pushed = worker->queue.push(std::move(work));
+    assert(pushed);
+    (void)pushed;
+  }
+}
+
+void ParallelWalRecovery::Drain() {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+Status ParallelWalRecovery::Wait() {
+  Drain();
+  std::lock_guard<std::mutex> lock(mu_);
+  Status s = status_;
+  status_ = Status::OK();
+  return s;
+}
+
+void ParallelWalRecovery::Run(Worker* worker) {
+  Work work;
+  while (worker->queue.pop(work)) {
+    // Entries of the other threads' column families are skipped as if their
+    // column families were missing, which still advances the sequence number
+    Status s = WriteBatchInternal::InsertInto(
+        work.batch.get(), &worker->memtables, flush_scheduler_,
+        trim_history_scheduler_, /*ignore_missing_column_families=*/true,
+        work.wal_number, db_, /*concurrent_memtable_writes=*/false);
+    work.batch.reset();
+
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!s.ok() && status_.ok()) {
+      status_ = s;
+    }
+    s.PermitUncheckedError();
+    assert(pending_ > 0);
+    if (--pending_ == 0) {
+      cv_.notify_all();
+    }
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
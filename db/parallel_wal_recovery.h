@@ -0,0 +1,82 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/status.h"
+#include "rocksdb/write_batch.h"
+#include "util/work_queue.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ColumnFamilySet;
+class DBImpl;
+class FlushScheduler;
+class TrimHistoryScheduler;
+
+// Inserts the write batches read from the WALs into the memtables on a pool
+// of threads during recovery, while the opening thread goes on reading and
+// verifying records. Every thread gets every batch, and only inserts the
+// entries of the column families whose ID modulo the number of threads is
+// its index. So the entries of a column family are inserted by a single
+// thread in WAL order, with the same sequence numbers as a serial replay.
+//
+// Add(), Drain() and Wait() are called by one thread, the one recovering
+// under the DB mutex.
+class ParallelWalRecovery {
+ public:
+  ParallelWalRecovery(DBImpl* db, ColumnFamilySet* column_family_set,
+                      FlushScheduler* flush_scheduler,
+                      TrimHistoryScheduler* trim_history_scheduler,
+                      int num_threads);
+  // Waits for the queued batches and stops the threads
+  ~ParallelWalRecovery();
+
+  // No copying allowed
+  ParallelWalRecovery(const ParallelWalRecovery&) = delete;
+  ParallelWalRecovery& operator=(const ParallelWalRecovery&) = delete;
+
+  // Queues batch, read from WAL wal_number, for insertion. Blocks while the
+  // queue of a thread is full.
+  // REQUIRES: batch has no 2PC markers, and is not using seq_per_batch
+  void Add(std::shared_ptr<WriteBatch> batch, uint64_t wal_number);
+
+  // Waits until the batches queued so far are inserted
+  void Drain();
+
+  // Drain()s, then returns the first insertion error since the last Wait(),
+  // if any.
+  Status Wait();
+
+ private:
+  struct Work {
+    std::shared_ptr<WriteBatch> batch;
+    uint64_t wal_number = 0;
+  };
+  struct Worker;
+
+  void Run(Worker* worker);
+
+  DBImpl* const db_;
+  FlushScheduler* const flush_scheduler_;
+  TrimHistoryScheduler* const trim_history_scheduler_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  // Number of queued (batch, thread) pairs not inserted yet
+  size_t pending_ = 0;
+  Status status_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
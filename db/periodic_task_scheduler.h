@@ -21,6 +21,8 @@ enum class PeriodicTaskType : uint8_t {
   kPersistStats,
   kFlushInfoLog,
   kRecordSeqnoTime,
+  kAutoTune,
+  kPersistReadHotness,
   kMax,
 };
 
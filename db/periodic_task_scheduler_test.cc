@@ -121,6 +121,73 @@ TEST_F(PeriodicTaskSchedulerTest, Basic) {
   Close();
 }
 
+TEST_F(PeriodicTaskSchedulerTest, AutoTune) {
+  constexpr unsigned int kPeriodSec = 10;
+  Close();
+  Options options;
+  options.stats_dump_period_sec = 0;
+  options.stats_persist_period_sec = 0;
+  options.auto_tune_period_sec = kPeriodSec;
+  options.max_background_jobs = 2;
+  options.create_if_missing = true;
+  options.env = mock_env_.get();
+
+  int auto_tune_counter = 0;
+  SyncPoint::GetInstance()->SetCallBack("DBImpl::AutoTune:StartRunning",
+                                        [&](void*) { auto_tune_counter++; });
+  bool stalled = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::AutoTune:Reason", [&](void* arg) {
+        if (stalled) {
+          strcpy(static_cast<char*>(arg), "test");
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Reopen(options);
+  const PeriodicTaskScheduler& scheduler =
+      dbfull()->TEST_GetPeriodicTaskScheduler();
+  ASSERT_TRUE(scheduler.TEST_HasTask(PeriodicTaskType::kAutoTune));
+
+  auto run_once = [&]() {
+    dbfull()->TEST_WaitForPeriodicTaskRun([&] {
+      mock_clock_->MockSleepForSeconds(static_cast<int>(kPeriodSec));
+    });
+  };
+  // The first run only takes the stats
+  dbfull()->TEST_WaitForPeriodicTaskRun([&] {
+    mock_clock_->MockSleepForSeconds(static_cast<int>(kPeriodSec) - 1);
+  });
+  ASSERT_EQ(1, auto_tune_counter);
+  ASSERT_EQ(0, dbfull()->TEST_AutoTuneExtraBackgroundJobs());
+
+  // Up to twice max_background_jobs while stalled
+  stalled = true;
+  run_once();
+  ASSERT_EQ(1, dbfull()->TEST_AutoTuneExtraBackgroundJobs());
+  run_once();
+  run_once();
+  ASSERT_EQ(2, dbfull()->TEST_AutoTuneExtraBackgroundJobs());
+  ASSERT_EQ(2, dbfull()->GetDBOptions().max_background_jobs);
+
+  // One back after three quiet runs
+  stalled = false;
+  run_once();
+  run_once();
+  ASSERT_EQ(2, dbfull()->TEST_AutoTuneExtraBackgroundJobs());
+  run_once();
+  ASSERT_EQ(1, dbfull()->TEST_AutoTuneExtraBackgroundJobs());
+  ASSERT_EQ(7, auto_tune_counter);
+
+  ASSERT_OK(dbfull()->SetDBOptions({{"auto_tune_period_sec", "0"}}));
+  ASSERT_FALSE(scheduler.TEST_HasTask(PeriodicTaskType::kAutoTune));
+  ASSERT_EQ(0, dbfull()->TEST_AutoTuneExtraBackgroundJobs());
+  run_once();
+  ASSERT_EQ(7, auto_tune_counter);
+
+  Close();
+}
+
 TEST_F(PeriodicTaskSchedulerTest, MultiInstances) {
   constexpr int kPeriodSec = 5;
   const int kInstanceNum = 10;
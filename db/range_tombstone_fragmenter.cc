@@ -85,6 +85,108 @@ FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
   FragmentTombstones(std::move(iter), icmp, for_compaction, snapshots);
 }
 
+FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
+    const FragmentedRangeTombstoneList* base,
+    const std::vector<std::pair<Slice, Slice>>& new_tombstones,
+    const InternalKeyComparator& icmp) {
+  const Comparator* ucmp = icmp.user_comparator();
+  assert(ucmp->timestamp_size() == 0);
+  num_unfragmented_tombstones_ = 0;
+  total_tombstone_payload_bytes_ = 0;
+  if (base != nullptr) {
+    assert(base->pinned_slices_.empty());
+    assert(base->tombstone_timestamps_.empty());
+    tombstones_ = base->tombstones_;
+    tombstone_seqs_ = base->tombstone_seqs_;
+    num_unfragmented_tombstones_ = base->num_unfragmented_tombstones_;
+    total_tombstone_payload_bytes_ = base->total_tombstone_payload_bytes_;
+  }
+  for (const auto& tombstone : new_tombstones) {
+    num_unfragmented_tombstones_++;
+    total_tombstone_payload_bytes_ +=
+        tombstone.first.size() + tombstone.second.size();
+    AddTombstone(ExtractUserKey(tombstone.first), tombstone.second,
+                 GetInternalKeySeqno(tombstone.first), ucmp);
+  }
+}
+
+void FragmentedRangeTombstoneList::AddTombstone(const Slice& start_key,
+                                                const Slice& end_key,
+                                                SequenceNumber seq,
+                                                const Comparator* ucmp) {
+  if (ucmp->Compare(start_key, end_key) >= 0) {
+    // Empty tombstone.
+    return;
+  }
+  std::vector<RangeTombstoneStack> tombstones;
+  std::vector<SequenceNumber> tombstone_seqs;
+  tombstones.reserve(tombstones_.size() + 2);
+  tombstone_seqs.reserve(tombstone_seqs_.size() + tombstones_.size() + 1);
+
+  // Appends the fragment [start, end) covered by the seqnums of `stack` (none
+  // if null), plus `seq` if `add_seq`. Seqnums stay in descending order.
+  auto append = [&](const Slice& start, const Slice& end,
+                    const RangeTombstoneStack* stack, bool add_seq) {
+    size_t start_idx = tombstone_seqs.size();
+    bool seq_added = !add_seq;
+    if (stack != nullptr) {
+      for (size_t i = stack->seq_start_idx; i < stack->seq_end_idx; ++i) {
+        SequenceNumber s = tombstone_seqs_[i];
+        if (!seq_added && seq >= s) {
+          if (seq > s) {
+            tombstone_seqs.push_back(seq);
+          }
+          seq_added = true;
+        }
+        tombstone_seqs.push_back(s);
+      }
+    }
+    if (!seq_added) {
+      tombstone_seqs.push_back(seq);
+    }
+    tombstones.emplace_back(start, end, start_idx, tombstone_seqs.size());
+  };
+
+  // The part [pos, end_key) of the new tombstone is not in any fragment yet.
+  Slice pos = start_key;
+  bool placed = false;
+  for (const auto& stack : tombstones_) {
+    if (placed || ucmp->Compare(stack.end_key, pos) <= 0) {
+      append(stack.start_key, stack.end_key, &stack, false);
+      continue;
+    }
+    if (ucmp->Compare(stack.start_key, end_key) >= 0) {
+      append(pos, end_key, nullptr, true);
+      placed = true;
+      append(stack.start_key, stack.end_key, &stack, false);
+      continue;
+    }
+    // The fragment overlaps [pos, end_key).
+    Slice overlap_start = stack.start_key;
+    int cmp = ucmp->Compare(stack.start_key, pos);
+    if (cmp < 0) {
+      append(stack.start_key, pos, &stack, false);
+      overlap_start = pos;
+    } else if (cmp > 0) {
+      append(pos, stack.start_key, nullptr, true);
+    }
+    if (ucmp->Compare(stack.end_key, end_key) > 0) {
+      append(overlap_start, end_key, &stack, true);
+      append(end_key, stack.end_key, &stack, false);
+      placed = true;
+    } else {
+      append(overlap_start, stack.end_key, &stack, true);
+      pos = stack.end_key;
+      placed = ucmp->Compare(pos, end_key) >= 0;
+    }
+  }
+  if (!placed) {
+    append(pos, end_key, nullptr, true);
+  }
+  tombstones_ = std::move(tombstones);
+  tombstone_seqs_ = std::move(tombstone_seqs);
+}
+
 void FragmentedRangeTombstoneList::FragmentTombstones(
     std::unique_ptr<InternalIterator> unfragmented_tombstones,
     const InternalKeyComparator& icmp, bool for_compaction,
@@ -9,6 +9,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "db/dbformat.h"
@@ -47,6 +48,17 @@ struct FragmentedRangeTombstoneList {
       const std::vector<SequenceNumber>& snapshots = {},
       const bool tombstone_end_include_ts = true);
 
+  // Builds the fragments of `base` (an empty list if null) with
+  // `new_tombstones` added. Each new tombstone is an (internal key, end key)
+  // pair and only splits the fragments it overlaps, which is cheaper than
+  // refragmenting every tombstone when few are added. The keys of `base` and
+  // `new_tombstones` must outlive this list. User-defined timestamps are not
+  // supported.
+  FragmentedRangeTombstoneList(
+      const FragmentedRangeTombstoneList* base,
+      const std::vector<std::pair<Slice, Slice>>& new_tombstones,
+      const InternalKeyComparator& icmp);
+
   std::vector<RangeTombstoneStack>::const_iterator begin() const {
     return tombstones_.begin();
   }
@@ -103,6 +115,11 @@ struct FragmentedRangeTombstoneList {
       const InternalKeyComparator& icmp, bool for_compaction,
       const std::vector<SequenceNumber>& snapshots);
 
+  // Adds the tombstone [start_key, end_key) at `seq` to the fragments,
+  // splitting those that partially overlap it.
+  void AddTombstone(const Slice& start_key, const Slice& end_key,
+                    SequenceNumber seq, const Comparator* ucmp);
+
   std::vector<RangeTombstoneStack> tombstones_;
   std::vector<SequenceNumber> tombstone_seqs_;
   std::vector<Slice> tombstone_timestamps_;
@@ -117,9 +134,16 @@ struct FragmentedRangeTombstoneList {
 struct FragmentedRangeTombstoneListCache {
   // ensure only the first reader needs to initialize l
   std::mutex reader_mutex;
-  std::unique_ptr<FragmentedRangeTombstoneList> tombstones = nullptr;
+  std::shared_ptr<FragmentedRangeTombstoneList> tombstones = nullptr;
   // readers will first check this bool to avoid
   std::atomic<bool> initialized = false;
+  // If true, `tombstones` is built by adding `new_tombstones` to `base` (an
+  // empty list if null) instead of refragmenting all range tombstones of the
+  // memtable. Set by the writer before the cache is published.
+  bool extend_base = false;
+  std::shared_ptr<FragmentedRangeTombstoneList> base = nullptr;
+  // (internal key, end key) of the range tombstones missing from `base`.
+  std::vector<std::pair<Slice, Slice>> new_tombstones;
 };
 
 // FragmentedRangeTombstoneIterator converts an InternalIterator of a range-del
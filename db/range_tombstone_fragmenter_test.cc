@@ -143,6 +143,37 @@ TEST_F(RangeTombstoneFragmenterTest, OverlappingTombstones) {
                                    {{"a", 10}, {"c", 15}, {"e", 15}, {"g", 0}});
 }
 
+TEST_F(RangeTombstoneFragmenterTest, ExtendBaseList) {
+  auto range_del_iter = MakeRangeDelIter({{"a", "e", 10}, {"g", "i", 5}});
+  FragmentedRangeTombstoneList base(std::move(range_del_iter), bytewise_icmp);
+
+  std::vector<RangeTombstone> added = {{"c", "h", 15}, {"j", "k", 3}};
+  std::vector<std::pair<InternalKey, Slice>> serialized;
+  for (const RangeTombstone& t : added) {
+    serialized.push_back(t.Serialize());
+  }
+  std::vector<std::pair<Slice, Slice>> new_tombstones;
+  for (const auto& key_and_value : serialized) {
+    new_tombstones.emplace_back(key_and_value.first.Encode(),
+                                key_and_value.second);
+  }
+  FragmentedRangeTombstoneList fragment_list(&base, new_tombstones,
+                                             bytewise_icmp);
+  ASSERT_EQ(4U, fragment_list.num_unfragmented_tombstones());
+  FragmentedRangeTombstoneIterator iter(&fragment_list, bytewise_icmp,
+                                        kMaxSequenceNumber);
+  VerifyFragmentedRangeDels(&iter, {{"a", "c", 10},
+                                    {"c", "e", 15},
+                                    {"c", "e", 10},
+                                    {"e", "g", 15},
+                                    {"g", "h", 15},
+                                    {"g", "h", 5},
+                                    {"h", "i", 5},
+                                    {"j", "k", 3}});
+  VerifyMaxCoveringTombstoneSeqnum(
+      &iter, {{"a", 10}, {"d", 15}, {"f", 15}, {"h", 5}, {"i", 0}, {"j", 3}});
+}
+
 TEST_F(RangeTombstoneFragmenterTest, ContiguousTombstones) {
   auto range_del_iter = MakeRangeDelIter(
       {{"a", "c", 10}, {"c", "e", 20}, {"c", "e", 5}, {"e", "g", 15}});
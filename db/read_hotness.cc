@@ -0,0 +1,86 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/read_hotness.h"
+
+#include <utility>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Leads the file, to tell it from other formats or a future version
+constexpr uint32_t kReadHotnessMagic = 0x52484f31;  // "RHO1"
+}  // namespace
+
+void EncodeReadHotness(const std::vector<FileReadHotness>& files,
+                       std::string* dst) {
+  const size_t start = dst->size();
+  PutFixed32(dst, kReadHotnessMagic);
+  PutVarint64(dst, files.size());
+  for (const FileReadHotness& file : files) {
+    PutLengthPrefixedSlice(dst, file.column_family);
+    PutVarint64(dst, file.file_number);
+    PutVarint64(dst, file.num_reads_sampled);
+    PutVarint64(dst, file.hot_ranges.size());
+    for (const auto& range : file.hot_ranges) {
+      PutLengthPrefixedSlice(dst, range.smallest);
+      PutLengthPrefixedSlice(dst, range.largest);
+    }
+  }
+  PutFixed32(dst, crc32c::Mask(crc32c::Value(dst->data() + start,
+                                             dst->size() - start)));
+}
+
+Status DecodeReadHotness(const Slice& src,
+                         std::vector<FileReadHotness>* files) {
+  if (src.size() < 2 * sizeof(uint32_t)) {
+    return Status::Corruption("Read hotness file truncated");
+  }
+  const size_t content_size = src.size() - sizeof(uint32_t);
+  const uint32_t expected =
+      crc32c::Unmask(DecodeFixed32(src.data() + content_size));
+  if (crc32c::Value(src.data(), content_size) != expected) {
+    return Status::Corruption("Read hotness file checksum mismatch");
+  }
+  Slice input(src.data(), content_size);
+  if (DecodeFixed32(input.data()) != kReadHotnessMagic) {
+    return Status::Corruption("Not a read hotness file");
+  }
+  input.remove_prefix(sizeof(uint32_t));
+  uint64_t num_files = 0;
+  if (!GetVarint64(&input, &num_files)) {
+    return Status::Corruption("Read hotness file truncated");
+  }
+  files->clear();
+  for (uint64_t i = 0; i < num_files; i++) {
+    FileReadHotness file;
+    Slice column_family;
+    uint64_t num_ranges = 0;
+    if (!GetLengthPrefixedSlice(&input, &column_family) ||
+        !GetVarint64(&input, &file.file_number) ||
+        !GetVarint64(&input, &file.num_reads_sampled) ||
+        !GetVarint64(&input, &num_ranges)) {
+      return Status::Corruption("Read hotness file truncated");
+    }
+    file.column_family = column_family.ToString();
+    for (uint64_t r = 0; r < num_ranges; r++) {
+      Slice smallest;
+      Slice largest;
+      if (!GetLengthPrefixedSlice(&input, &smallest) ||
+          !GetLengthPrefixedSlice(&input, &largest)) {
+        return Status::Corruption("Read hotness file truncated");
+      }
+      file.hot_ranges.push_back({smallest.ToString(), largest.ToString()});
+    }
+    files->push_back(std::move(file));
+  }
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
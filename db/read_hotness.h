@@ -0,0 +1,39 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/table_reader.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// How hot a live table file was for reads, as saved to and loaded from
+// DBOptions::read_hotness_file.
+struct FileReadHotness {
+  std::string column_family;
+  uint64_t file_number = 0;
+  // FileSampledStats::num_reads_sampled of the file
+  uint64_t num_reads_sampled = 0;
+  // The key ranges of the file found hot in the block cache, see
+  // TableReader::GetHotKeyRanges(). Empty if not tracked.
+  std::vector<TableReader::HotKeyRange> hot_ranges;
+};
+
+// Appends the encoding of `files` to `dst`, followed by a checksum of it.
+void EncodeReadHotness(const std::vector<FileReadHotness>& files,
+                       std::string* dst);
+
+// Decodes what EncodeReadHotness() produced into `files`. Returns
+// Status::Corruption() if `src` is truncated or does not match its checksum.
+Status DecodeReadHotness(const Slice& src, std::vector<FileReadHotness>* files);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <atomic>
 #include <vector>
 
 #include "db/dbformat.h"
@@ -62,14 +63,13 @@ class SnapshotList {
     list_.unix_time_ = 0;
     list_.timestamp_ = 0;
     list_.is_write_conflict_boundary_ = false;
-    count_ = 0;
   }
 
   // No copy-construct.
   SnapshotList(const SnapshotList&) = delete;
 
   bool empty() const {
-    assert(list_.next_ != &list_ || 0 == count_);
+    assert(list_.next_ != &list_ || 0 == count());
     return list_.next_ == &list_;
   }
   SnapshotImpl* oldest() const {
@@ -93,16 +93,23 @@ class SnapshotList {
     s->prev_ = list_.prev_;
     s->prev_->next_ = s;
     s->next_->prev_ = s;
-    count_++;
+    count_.store(count() + 1, std::memory_order_relaxed);
+    if (s->prev_ == &list_) {
+      UpdateOldest();
+    }
     return s;
   }
 
   // Do not responsible to free the object.
   void Delete(const SnapshotImpl* s) {
     assert(s->list_ == this);
+    const bool was_oldest = s->prev_ == &list_;
     s->prev_->next_ = s->next_;
     s->next_->prev_ = s->prev_;
-    count_--;
+    count_.store(count() - 1, std::memory_order_relaxed);
+    if (was_oldest) {
+      UpdateOldest();
+    }
   }
 
   // retrieve all snapshot numbers up until max_seq. They are sorted in
@@ -121,6 +128,7 @@ class SnapshotList {
     std::vector<SequenceNumber>& ret = *snap_vector;
     // So far we have no use case that would pass a non-empty vector
     assert(ret.size() == 0);
+    ret.reserve(static_cast<size_t>(count()));
 
     if (oldest_write_conflict_snapshot != nullptr) {
       *oldest_write_conflict_snapshot = kMaxSequenceNumber;
@@ -160,28 +168,36 @@ class SnapshotList {
     return newest()->number_;
   }
 
+  // Unlike the rest of the list, GetOldestSnapshotTime(),
+  // GetOldestSnapshotSequence() and count() may be called without the db
+  // mutex, and then return values that were current at some recent point.
   int64_t GetOldestSnapshotTime() const {
-    if (empty()) {
-      return 0;
-    } else {
-      return oldest()->unix_time_;
-    }
+    return oldest_time_.load(std::memory_order_relaxed);
   }
 
   int64_t GetOldestSnapshotSequence() const {
+    return static_cast<int64_t>(oldest_seq_.load(std::memory_order_relaxed));
+  }
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+ private:
+  void UpdateOldest() {
     if (empty()) {
-      return 0;
+      oldest_time_.store(0, std::memory_order_relaxed);
+      oldest_seq_.store(0, std::memory_order_relaxed);
     } else {
-      return oldest()->GetSequenceNumber();
+      oldest_time_.store(oldest()->unix_time_, std::memory_order_relaxed);
+      oldest_seq_.store(oldest()->number_, std::memory_order_relaxed);
     }
   }
 
-  uint64_t count() const { return count_; }
-
- private:
   // Dummy head of doubly-linked list of snapshots
   SnapshotImpl list_;
-  uint64_t count_;
+  // Only written with the db mutex held
+  std::atomic<uint64_t> count_{0};
+  std::atomic<int64_t> oldest_time_{0};
+  std::atomic<SequenceNumber> oldest_seq_{0};
 };
 
 // All operations on TimestampedSnapshotList must be protected by db mutex.
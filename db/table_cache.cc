@@ -16,6 +16,8 @@
 #include "file/file_util.h"
 #include "file/filename.h"
 #include "file/random_access_file_reader.h"
+#include "logging/logging.h"
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/advanced_options.h"
 #include "rocksdb/statistics.h"
@@ -48,11 +50,6 @@ namespace ROCKSDB_NAMESPACE {
 
 namespace {
 
-static Slice GetSliceForFileNumber(const uint64_t* file_number) {
-  return Slice(reinterpret_cast<const char*>(file_number),
-               sizeof(*file_number));
-}
-
 void AppendVarint64(IterKey* key, uint64_t v) {
   char buf[10];
   auto ptr = EncodeVarint64(buf, v);
@@ -63,6 +60,28 @@ void AppendVarint64(IterKey* key, uint64_t v) {
 
 const int kLoadConcurency = 128;
 
+void PathReadLatencyHistogram::Add(uint64_t micros) {
+  HistogramImpl::Add(micros);
+  const uint64_t threshold = ioptions_.slow_read_log_threshold_micros;
+  if (threshold == 0 || micros < threshold) {
+    return;
+  }
+  num_slow_reads_.fetch_add(1, std::memory_order_relaxed);
+  const uint64_t now = ioptions_.clock->NowMicros();
+  uint64_t next_report = next_report_micros_.load(std::memory_order_relaxed);
+  // Only one of the reads ending the period reports
+  if (now < next_report ||
+      !next_report_micros_.compare_exchange_strong(next_report,
+                                                   now + 1000000)) {
+    return;
+  }
+  const uint64_t num_slow_reads = num_slow_reads_.exchange(0);
+  ROCKS_LOG_WARN(ioptions_.logger,
+                 "%" PRIu64 " slow table file reads from %s, the last one of %"
+                 PRIu64 " micros. P99 read latency: %.1f micros",
+                 num_slow_reads, path_.c_str(), micros, Percentile(99));
+}
+
 TableCache::TableCache(const ImmutableOptions& ioptions,
                        const FileOptions* file_options, Cache* const cache,
                        BlockCacheTracer* const block_cache_tracer,
@@ -81,6 +100,16 @@ TableCache::TableCache(const ImmutableOptions& ioptions,
     // disambiguate its entries.
     PutVarint64(&row_cache_id_, ioptions_.row_cache->NewId());
   }
+  for (const auto& path : ioptions_.cf_paths) {
+    path_read_latency_.emplace_back(
+        new PathReadLatencyHistogram(ioptions_, path.path));
+  }
+  if (ioptions_.hedged_read_threads > 0) {
+    hedged_reads_ = std::make_shared<HedgedReads>(
+        ioptions_.clock, ioptions_.hedged_read_threads,
+        ioptions_.hedged_read_percentile,
+        ioptions_.hedged_read_budget_percent);
+  }
 }
 
 TableCache::~TableCache() = default;
@@ -130,13 +159,18 @@ Status TableCache::GetTableReader(
         file_temperature == Temperature::kUnknown) {
       file_temperature = ioptions_.default_temperature;
     }
+    const uint32_t path_id = file_meta.fd.GetPathId();
+    HistogramImpl* path_read_hist = path_id < path_read_latency_.size()
+                                        ? path_read_latency_[path_id].get()
+                                        : nullptr;
     StopWatch sw(ioptions_.clock, ioptions_.stats, TABLE_OPEN_IO_MICROS);
     std::unique_ptr<RandomAccessFileReader> file_reader(
         new RandomAccessFileReader(std::move(file), fname, ioptions_.clock,
                                    io_tracer_, ioptions_.stats, SST_READ_MICROS,
                                    file_read_hist, ioptions_.rate_limiter.get(),
                                    ioptions_.listeners, file_temperature,
-                                   level == ioptions_.num_levels - 1));
+                                   level == ioptions_.num_levels - 1,
+                                   path_read_hist, hedged_reads_));
     UniqueId64x2 expected_unique_id;
     if (ioptions_.verify_sst_unique_id_in_manifest) {
       expected_unique_id = file_meta.unique_id;
@@ -153,7 +187,8 @@ Status TableCache::GetTableReader(
             block_cache_tracer_, max_file_size_for_l0_meta_pin, db_session_id_,
             file_meta.fd.GetNumber(), expected_unique_id,
             file_meta.fd.largest_seqno, file_meta.tail_size,
-            file_meta.user_defined_timestamps_persisted),
+            file_meta.user_defined_timestamps_persisted,
+            mutable_cf_options.compression_manager),
         std::move(file_reader), file_meta.fd.GetFileSize(), table_reader,
         prefetch_index_and_filter_in_cache);
     TEST_SYNC_POINT("TableCache::GetTableReader:0");
@@ -163,8 +198,8 @@ Status TableCache::GetTableReader(
 
 Cache::Handle* TableCache::Lookup(Cache* cache, uint64_t file_number) {
   // NOTE: sharing same Cache with BlobFileCache
-  Slice key = GetSliceForFileNumber(&file_number);
-  return cache->Lookup(key);
+  const FileNumberCacheKey key(file_number);
+  return cache->Lookup(key.AsSlice());
 }
 
 Status TableCache::FindTable(
@@ -178,7 +213,8 @@ Status TableCache::FindTable(
   PERF_TIMER_GUARD_WITH_CLOCK(find_table_nanos, ioptions_.clock);
   uint64_t number = file_meta.fd.GetNumber();
   // NOTE: sharing same Cache with BlobFileCache
-  Slice key = GetSliceForFileNumber(&number);
+  const FileNumberCacheKey key_data(number);
+  const Slice key = key_data.AsSlice();
   *handle = cache_.Lookup(key);
   TEST_SYNC_POINT_CALLBACK("TableCache::FindTable:0",
                            const_cast<bool*>(&no_io));
@@ -187,6 +223,7 @@ Status TableCache::FindTable(
     if (no_io) {
       return Status::Incomplete("Table not found in table_cache, no_io is set");
     }
+    OPERATION_SPAN_GUARD(TableOpen);
     MutexLock load_lock(&loader_mutex_.Get(key));
     // We check the cache again under loading mutex
     *handle = cache_.Lookup(key);
@@ -488,8 +525,14 @@ Status TableCache::Get(const ReadOptions& options,
     }
     if (s.ok()) {
       get_context->SetReplayLog(row_cache_entry);  // nullptr if no cache.
-      s = t->Get(options, k, get_context,
-                 mutable_cf_options.prefix_extractor.get(), skip_filters);
+      if (file_meta.hash_index != nullptr) {
+        s = t->GetWithHashIndex(options, k, get_context,
+                                mutable_cf_options.prefix_extractor.get(),
+                                skip_filters, file_meta.hash_index.get());
+      } else {
+        s = t->Get(options, k, get_context,
+                   mutable_cf_options.prefix_extractor.get(), skip_filters);
+      }
       get_context->SetReplayLog(nullptr);
     } else if (options.read_tier == kBlockCacheTier && s.IsIncomplete()) {
       // Couldn't find table in cache and couldn't open it because of no_io.
@@ -643,6 +686,60 @@ Status TableCache::ApproximateKeyAnchors(
   return s;
 }
 
+Status TableCache::Prefetch(const ReadOptions& ro,
+                            const InternalKeyComparator& internal_comparator,
+                            const FileMetaData& file_meta,
+                            const MutableCFOptions& mutable_cf_options,
+                            const Slice* begin, const Slice* end,
+                            HistogramImpl* file_read_hist, int level,
+                            TableReader::PrefetchStats* stats,
+                            const TableReader::PrefetchOptions* options) {
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, file_meta, &handle,
+                  mutable_cf_options,
+                  ro.read_tier == kBlockCacheTier /* no_io */, file_read_hist,
+                  /*skip_filters=*/false, level,
+                  /*prefetch_index_and_filter_in_cache=*/true,
+                  MaxFileSizeForL0MetaPin(mutable_cf_options));
+    if (s.ok()) {
+      t = cache_.Value(handle);
+    }
+  }
+  if (s.ok() && t != nullptr) {
+    s = t->Prefetch(ro, begin, end, stats, options);
+  }
+  if (handle != nullptr) {
+    cache_.Release(handle);
+  }
+  return s;
+}
+
+Status TableCache::GetHotKeyRanges(
+    const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, const MutableCFOptions& mutable_cf_options,
+    std::vector<TableReader::HotKeyRange>* ranges) {
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, file_meta, &handle,
+                  mutable_cf_options);
+    if (s.ok()) {
+      t = cache_.Value(handle);
+    }
+  }
+  if (s.ok() && t != nullptr) {
+    s = t->GetHotKeyRanges(ro, ranges);
+  }
+  if (handle != nullptr) {
+    cache_.Release(handle);
+  }
+  return s;
+}
+
 size_t TableCache::GetMemoryUsageByTableReader(
     const FileOptions& file_options, const ReadOptions& read_options,
     const InternalKeyComparator& internal_comparator,
@@ -668,7 +765,7 @@ size_t TableCache::GetMemoryUsageByTableReader(
 }
 
 void TableCache::Evict(Cache* cache, uint64_t file_number) {
-  cache->Erase(GetSliceForFileNumber(&file_number));
+  cache->Erase(FileNumberCacheKey(file_number).AsSlice());
 }
 
 uint64_t TableCache::ApproximateOffsetOf(
@@ -731,7 +828,8 @@ void TableCache::ReleaseObsolete(Cache* cache, uint64_t file_number,
   CacheInterface typed_cache(cache);
   TypedHandle* table_handle = reinterpret_cast<TypedHandle*>(h);
   if (table_handle == nullptr) {
-    table_handle = typed_cache.Lookup(GetSliceForFileNumber(&file_number));
+    table_handle =
+        typed_cache.Lookup(FileNumberCacheKey(file_number).AsSlice());
   }
   if (table_handle != nullptr) {
     TableReader* table_reader = typed_cache.Value(table_handle);
@@ -10,13 +10,17 @@
 // Thread-safe (provides internal synchronization)
 
 #pragma once
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "cache/typed_cache.h"
 #include "db/dbformat.h"
 #include "db/range_del_aggregator.h"
+#include "file/hedged_read.h"
+#include "monitoring/histogram.h"
 #include "options/cf_options.h"
 #include "port/port.h"
 #include "rocksdb/cache.h"
@@ -33,7 +37,26 @@ class Env;
 class Arena;
 struct FileDescriptor;
 class GetContext;
-class HistogramImpl;
+
+// Latency of the reads of the table files under one of cf_paths, which is
+// often a device of its own. Reports the reads of at least
+// slow_read_log_threshold_micros to the info log, at most once per second.
+class PathReadLatencyHistogram : public HistogramImpl {
+ public:
+  PathReadLatencyHistogram(const ImmutableOptions& ioptions, std::string path)
+      : ioptions_(ioptions), path_(std::move(path)) {}
+
+  void Add(uint64_t micros) override;
+
+  const std::string& path() const { return path_; }
+
+ private:
+  const ImmutableOptions& ioptions_;
+  const std::string path_;
+  // Slow reads since the last report
+  std::atomic<uint64_t> num_slow_reads_{0};
+  std::atomic<uint64_t> next_report_micros_{0};
+};
 
 // Manages caching for TableReader objects for a column family. The actual
 // cache is allocated separately and passed to the constructor. TableCache
@@ -57,6 +80,12 @@ class TableCache {
              const std::string& db_session_id);
   ~TableCache();
 
+  // Latency histograms of the reads of the table files, by path_id
+  const std::vector<std::unique_ptr<PathReadLatencyHistogram>>&
+  GetPathReadHists() const {
+    return path_read_latency_;
+  }
+
   // Cache interface for table cache
   using CacheInterface =
       BasicTypedCacheInterface<TableReader, CacheEntryRole::kMisc>;
@@ -206,6 +235,27 @@ class TableCache {
                                const MutableCFOptions& mutable_cf_options,
                                std::vector<TableReader::Anchor>& anchors);
 
+  // Loads the data blocks of the table overlapping the internal key range
+  // [begin, end] into the block cache, see TableReader::Prefetch(). A null
+  // `begin` or `end` means the start or the end of the table.
+  // @param level The level this table is at, -1 for "not set / don't know"
+  Status Prefetch(const ReadOptions& ro,
+                  const InternalKeyComparator& internal_comparator,
+                  const FileMetaData& file_meta,
+                  const MutableCFOptions& mutable_cf_options,
+                  const Slice* begin, const Slice* end,
+                  HistogramImpl* file_read_hist = nullptr, int level = -1,
+                  TableReader::PrefetchStats* stats = nullptr,
+                  const TableReader::PrefetchOptions* options = nullptr);
+
+  // Appends the hot key ranges of the table to `ranges`, see
+  // TableReader::GetHotKeyRanges().
+  Status GetHotKeyRanges(const ReadOptions& ro,
+                         const InternalKeyComparator& internal_comparator,
+                         const FileMetaData& file_meta,
+                         const MutableCFOptions& mutable_cf_options,
+                         std::vector<TableReader::HotKeyRange>* ranges);
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
@@ -231,6 +281,8 @@ class TableCache {
 
   CacheInterface& get_cache() { return cache_; }
 
+  Env* env() const { return ioptions_.env; }
+
   // Capacity of the backing Cache that indicates infinite TableCache capacity.
   // For example when max_open_files is -1 we set the backing Cache to this.
   static const int kInfiniteCapacity = 0x400000;
@@ -287,6 +339,9 @@ class TableCache {
   Striped<CacheAlignedWrapper<port::Mutex>> loader_mutex_;
   std::shared_ptr<IOTracer> io_tracer_;
   std::string db_session_id_;
+  std::vector<std::unique_ptr<PathReadLatencyHistogram>> path_read_latency_;
+  // Set with DBOptions::hedged_read_threads
+  std::shared_ptr<HedgedReads> hedged_reads_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
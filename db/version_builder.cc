@@ -1421,6 +1421,18 @@ class VersionBuilder::Rep {
     const auto& unordered_added_files = levels_[level].added_files;
     vstorage->Reserve(level, base_files.size() + unordered_added_files.size());
 
+    // A level that the edits did not touch is copied as is, without looking
+    // up each of its files in the added and deleted ones
+    if (unordered_added_files.empty() &&
+        levels_[level].deleted_files.empty() &&
+        !(track_found_and_missing_files_ && level == 0 &&
+          !l0_missing_files_.empty())) {
+      for (FileMetaData* file : base_files) {
+        vstorage->AddFile(level, file);
+      }
+      return;
+    }
+
     MergeUnorderdAddedFilesWithBase(
         base_files, unordered_added_files, cmp,
         [&](FileMetaData* file) { MaybeAddFile(vstorage, level, file); });
@@ -218,6 +218,12 @@ bool VersionEdit::EncodeTo(std::string* dst,
       PutVarint64(&varint_tail_size, f.tail_size);
       PutLengthPrefixedSlice(dst, Slice(varint_tail_size));
     }
+    if (!f.min_timestamp.empty()) {
+      PutVarint32(dst, NewFileCustomTag::kMinTimestamp);
+      PutLengthPrefixedSlice(dst, Slice(f.min_timestamp));
+      PutVarint32(dst, NewFileCustomTag::kMaxTimestamp);
+      PutLengthPrefixedSlice(dst, Slice(f.max_timestamp));
+    }
     if (!f.user_defined_timestamps_persisted) {
       // The default value for the flag is true, it's only explicitly persisted
       // when it's false. We are putting 0 as the value here to signal false
@@ -423,6 +429,12 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
           }
           f.user_defined_timestamps_persisted = (field[0] == 1);
           break;
+        case kMinTimestamp:
+          f.min_timestamp = field.ToString();
+          break;
+        case kMaxTimestamp:
+          f.max_timestamp = field.ToString();
+          break;
         default:
           if ((custom_tag & kCustomTagNonSafeIgnoreMask) != 0) {
             // Should not proceed if cannot understand it
@@ -893,6 +905,13 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     AppendNumberTo(&r, f.tail_size);
     r.append(" User-defined timestamps persisted: ");
     r.append(f.user_defined_timestamps_persisted ? "true" : "false");
+    if (!f.min_timestamp.empty()) {
+      r.append(" timestamps: [");
+      r.append(Slice(f.min_timestamp).ToString(true));
+      r.append(" .. ");
+      r.append(Slice(f.max_timestamp).ToString(true));
+      r.append("]");
+    }
   }
 
   for (const auto& blob_file_addition : blob_file_additions_) {
@@ -103,6 +103,7 @@ enum NewFileCustomTag : uint32_t {
   kPathId,
 };
 
+class FileHashIndex;
 class VersionSet;
 
 constexpr uint64_t kFileNumberMask = 0x3FFFFFFFFFFFFFFF;
@@ -259,6 +260,16 @@ struct FileMetaData {
   // false, it's explicitly written to Manifest.
   bool user_defined_timestamps_persisted = true;
 
+  // The smallest and the largest user-defined timestamps of the entries in
+  // the file, from the table properties. Empty when unknown.
+  std::string min_timestamp;
+  std::string max_timestamp;
+
+  // The in-memory hash index of the file, built when a bottommost compaction
+  // writes it, see AdvancedColumnFamilyOptions::bottommost_hash_index. Not
+  // persisted.
+  std::shared_ptr<const FileHashIndex> hash_index;
+
   FileMetaData() = default;
 
   FileMetaData(uint64_t file, uint32_t file_path_id, uint64_t file_size,
@@ -369,10 +380,23 @@ struct FileMetaData {
     usage += sizeof(*this);
 #endif  // ROCKSDB_MALLOC_USABLE_SIZE
     usage += smallest.size() + largest.size() + file_checksum.size() +
-             file_checksum_func_name.size();
+             file_checksum_func_name.size() + min_timestamp.size() +
+             max_timestamp.size();
     return usage;
   }
 
+  // Sets `min_timestamp` and `max_timestamp` from the properties collected
+  // by the table builder, if any.
+  void SetTimestampRange(const TableProperties& props) {
+    const auto& user_props = props.user_collected_properties;
+    auto min_ts_pos = user_props.find("rocksdb.timestamp_min");
+    auto max_ts_pos = user_props.find("rocksdb.timestamp_max");
+    if (min_ts_pos != user_props.end() && max_ts_pos != user_props.end()) {
+      min_timestamp = min_ts_pos->second;
+      max_timestamp = max_ts_pos->second;
+    }
+  }
+
   // Returns whether this file is one with just one range tombstone. These type
   // of file should always be marked for compaction.
   bool FileIsStandAloneRangeTombstone() const {
@@ -434,9 +458,15 @@ struct FdWithKeyRange {
 struct LevelFilesBrief {
   size_t num_files;
   FdWithKeyRange* files;
+  // Optional. For each file, the first 8 bytes of its largest user key, as a
+  // big-endian integer padded with zeros. In bytewise order, they don't
+  // decrease from one file to the next, so that a search among the files
+  // can be narrowed with integer comparisons before comparing keys.
+  uint64_t* largest_key_prefixes;
   LevelFilesBrief() {
     num_files = 0;
     files = nullptr;
+    largest_key_prefixes = nullptr;
   }
 };
 
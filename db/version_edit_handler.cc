@@ -535,6 +535,14 @@ Status VersionEditHandler::LoadTables(ColumnFamilyData* cfd,
     return Status::OK();
   }
   assert(cfd != nullptr);
+  // DB::Open() leaves them to a background job, see
+  // DBImpl::MaybeScheduleOpenTableFiles()
+  if (is_initial_load &&
+      version_set_->db_options_->open_table_files_in_background &&
+      cfd->table_cache()->get_cache().get()->GetCapacity() ==
+          TableCache::kInfiniteCapacity) {
+    return Status::OK();
+  }
   assert(!cfd->IsDropped());
   auto builder_iter = builders_.find(cfd->GetID());
   assert(builder_iter != builders_.end());
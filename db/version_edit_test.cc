@@ -130,6 +130,40 @@ TEST_F(VersionEditTest, EncodeDecodeNewFile4) {
   ASSERT_FALSE(parsed.GetPersistUserDefinedTimestamps());
 }
 
+TEST_F(VersionEditTest, EncodeDecodeTimestampRange) {
+  FileMetaData meta(300, 0, 100, InternalKey("foo", 500, kTypeValue),
+                    InternalKey("zoo", 600, kTypeValue), 500, 600, false,
+                    Temperature::kUnknown, kInvalidBlobFileNumber,
+                    kUnknownOldestAncesterTime, kUnknownFileCreationTime,
+                    300 /* epoch_number */, kUnknownFileChecksum,
+                    kUnknownFileChecksumFuncName, kNullUniqueId64x2, 0, 0,
+                    true);
+  TableProperties props;
+  props.user_collected_properties["rocksdb.timestamp_min"] = "ts10";
+  props.user_collected_properties["rocksdb.timestamp_max"] = "ts20";
+  meta.SetTimestampRange(props);
+
+  VersionEdit edit;
+  edit.AddFile(3, meta);
+  edit.AddFile(4, 301, 0, 100, InternalKey("foo", 501, kTypeValue),
+               InternalKey("zoo", 601, kTypeValue), 501, 601, false,
+               Temperature::kUnknown, kInvalidBlobFileNumber,
+               kUnknownOldestAncesterTime, kUnknownFileCreationTime,
+               301 /* epoch_number */, kUnknownFileChecksum,
+               kUnknownFileChecksumFuncName, kNullUniqueId64x2, 0, 0, true);
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded, 0 /* ts_sz */);
+  VersionEdit parsed;
+  ASSERT_OK(parsed.DecodeFrom(encoded));
+  auto& new_files = parsed.GetNewFiles();
+  ASSERT_EQ("ts10", new_files[0].second.min_timestamp);
+  ASSERT_EQ("ts20", new_files[0].second.max_timestamp);
+  ASSERT_TRUE(new_files[1].second.min_timestamp.empty());
+  ASSERT_TRUE(new_files[1].second.max_timestamp.empty());
+}
+
 TEST_F(VersionEditTest, EncodeDecodeNewFile4HandleFileBoundary) {
   static const uint64_t kBig = 1ull << 50;
   size_t ts_sz = 16;
@@ -19,7 +19,7 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
-#include <fstream>
+
 #include "db/blob/blob_fetcher.h"
 #include "db/blob/blob_file_cache.h"
 #include "db/blob/blob_file_reader.h"
@@ -75,6 +75,7 @@
 #include "util/cast_util.h"
 #include "util/coding.h"
 #include "util/coro_utils.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/user_comparator_wrapper.h"
@@ -97,11 +98,35 @@ namespace ROCKSDB_NAMESPACE {
 
 namespace {
 
+// See LevelFilesBrief::largest_key_prefixes
+uint64_t UserKeyPrefix(const Slice& user_key) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(prefix); i++) {
+    prefix <<= 8;
+    if (i < user_key.size()) {
+      prefix |= static_cast<unsigned char>(user_key[i]);
+    }
+  }
+  return prefix;
+}
+
 // Find File in LevelFilesBrief data structure
 // Within an index range defined by left and right
 int FindFileInRange(const InternalKeyComparator& icmp,
                     const LevelFilesBrief& file_level, const Slice& key,
                     uint32_t left, uint32_t right) {
+  if (file_level.largest_key_prefixes != nullptr &&
+      icmp.user_comparator() == BytewiseComparator()) {
+    // Only the files whose largest key has the same prefix as `key` need
+    // their keys compared: the ones before are before `key`, and the ones
+    // after are after it.
+    const uint64_t* const p = file_level.largest_key_prefixes;
+    const uint64_t key_prefix = UserKeyPrefix(ExtractUserKey(key));
+    left = static_cast<uint32_t>(
+        std::lower_bound(p + left, p + right, key_prefix) - p);
+    right = static_cast<uint32_t>(
+        std::upper_bound(p + left, p + right, key_prefix) - p);
+  }
   auto cmp = [&](const FdWithKeyRange& f, const Slice& k) -> bool {
     return icmp.InternalKeyComparator::Compare(f.largest_key, k) < 0;
   };
@@ -890,6 +915,8 @@ void DoGenerateLevelFilesBrief(LevelFilesBrief* file_level,
   file_level->num_files = num;
   char* mem = arena->AllocateAligned(num * sizeof(FdWithKeyRange));
   file_level->files = new (mem) FdWithKeyRange[num];
+  mem = arena->AllocateAligned(num * sizeof(uint64_t));
+  file_level->largest_key_prefixes = reinterpret_cast<uint64_t*>(mem);
 
   for (size_t i = 0; i < num; i++) {
     Slice smallest_key = files[i]->smallest.Encode();
@@ -907,6 +934,8 @@ void DoGenerateLevelFilesBrief(LevelFilesBrief* file_level,
     f.file_metadata = files[i];
     f.smallest_key = Slice(mem, smallest_size);
     f.largest_key = Slice(mem + smallest_size, largest_size);
+    file_level->largest_key_prefixes[i] =
+        UserKeyPrefix(files[i]->largest.user_key());
   }
 }
 
@@ -965,6 +994,16 @@ bool SomeFileOverlapsRange(const InternalKeyComparator& icmp,
 
 namespace {
 
+// Returns false when all of the entries of the file are newer than the read
+// timestamp, so that none of them is visible to the read and the file can be
+// skipped without opening it.
+bool TimestampMayMatch(const ReadOptions& read_options, const Comparator* ucmp,
+                       const FileMetaData& file) {
+  return read_options.timestamp == nullptr || file.min_timestamp.empty() ||
+         ucmp->CompareTimestamp(*read_options.timestamp, file.min_timestamp) >=
+             0;
+}
+
 class LevelIterator final : public InternalIterator {
  public:
   // NOTE: many of the const& parameters are saved in this object (so
@@ -980,7 +1019,8 @@ class LevelIterator final : public InternalIterator {
           nullptr,
       bool allow_unprepared_value = false,
       std::unique_ptr<TruncatedRangeDelIterator>*** range_tombstone_iter_ptr_ =
-          nullptr)
+          nullptr,
+      FileIteratorStash* file_iter_stash = nullptr)
       : table_cache_(table_cache),
         read_options_(read_options),
         file_options_(file_options),
@@ -1005,7 +1045,8 @@ class LevelIterator final : public InternalIterator {
         allow_unprepared_value_(allow_unprepared_value),
         is_next_read_sequential_(false),
         to_return_sentinel_(false),
-        scan_opts_(nullptr) {
+        scan_opts_(nullptr),
+        file_iter_stash_(file_iter_stash) {
     // Empty level is not supported.
     assert(flevel_ != nullptr && flevel_->num_files > 0);
     if (range_tombstone_iter_ptr_) {
@@ -1013,7 +1054,13 @@ class LevelIterator final : public InternalIterator {
     }
   }
 
-  ~LevelIterator() override { delete file_iter_.Set(nullptr); }
+  ~LevelIterator() override {
+    WaitForNextFileOpen();
+    InternalIterator* iter = file_iter_.Set(nullptr);
+    if (!MaybeStashFileIterator(iter)) {
+      delete iter;
+    }
+  }
 
   // Seek to the first file with a key >= target.
   // If range_tombstone_iter_ is not nullptr, then we pretend that file
@@ -1095,6 +1142,11 @@ class LevelIterator final : public InternalIterator {
            file_iter_.iter() && file_iter_.IsValuePinned();
   }
 
+  bool PinValue(const Slice& value, PinnableSlice* pinned) override {
+    assert(Valid());
+    return !to_return_sentinel_ && file_iter_.PinValue(value, pinned);
+  }
+
   bool IsDeleteRangeSentinelKey() const override { return to_return_sentinel_; }
 
   void SetRangeDelReadSeqno(SequenceNumber read_seq) override {
@@ -1156,7 +1208,20 @@ class LevelIterator final : public InternalIterator {
     }
     CheckMayBeOutOfLowerBound();
     ClearRangeTombstoneIter();
-    return table_cache_->NewIterator(
+    if (!TimestampMayMatch(read_options_, icomparator_.user_comparator(),
+                           *file_meta.file_metadata)) {
+      return NewEmptyInternalIterator<Slice>(/*arena=*/nullptr);
+    }
+    if (file_iter_stash_ != nullptr) {
+      InternalIterator* iter = file_iter_stash_->Take(
+          file_meta.fd.GetNumber(), level_, prefix_extractor_);
+      if (iter != nullptr) {
+        TEST_SYNC_POINT("LevelIterator::NewFileIterator:Stashed");
+        file_has_range_tombstones_ = false;
+        return iter;
+      }
+    }
+    InternalIterator* iter = table_cache_->NewIterator(
         read_options_, file_options_, icomparator_, *file_meta.file_metadata,
         range_del_agg_, mutable_cf_options_,
         nullptr /* don't need reference to table */, file_read_hist_, caller_,
@@ -1164,6 +1229,26 @@ class LevelIterator final : public InternalIterator {
         /*max_file_size_for_l0_meta_pin=*/0, smallest_compaction_key,
         largest_compaction_key, allow_unprepared_value_, &read_seq_,
         range_tombstone_iter_);
+    file_has_range_tombstones_ =
+        range_tombstone_iter_ != nullptr && *range_tombstone_iter_ != nullptr;
+    return iter;
+  }
+
+  // Moves the table iterator of the current file to file_iter_stash_, if it
+  // can be used by the level iterator of a refreshed DB iterator. Returns
+  // whether it did.
+  bool MaybeStashFileIterator(InternalIterator* iter) {
+    if (iter == nullptr || file_iter_stash_ == nullptr ||
+        file_index_ >= flevel_->num_files || file_has_range_tombstones_ ||
+        range_del_agg_ != nullptr || scan_opts_ != nullptr ||
+        !iter->status().ok() ||
+        (pinned_iters_mgr_ != nullptr && pinned_iters_mgr_->PinningEnabled())) {
+      return false;
+    }
+    iter->SetPinnedItersMgr(nullptr);
+    return file_iter_stash_->Put(flevel_->files[file_index_].fd.GetNumber(),
+                                 level_, mutable_cf_options_.prefix_extractor,
+                                 iter);
   }
 
   // Check if current file being fully within iterate_lower_bound.
@@ -1234,14 +1319,80 @@ class LevelIterator final : public InternalIterator {
   // Whether next/prev key is a sentinel key.
   bool to_return_sentinel_ = false;
   const std::vector<ScanOptions>* scan_opts_;
+  FileIteratorStash* file_iter_stash_;
+  // Whether the table iterator of the current file came with range tombstones
+  bool file_has_range_tombstones_ = false;
 
   // Sets flags for if we should return the sentinel key next.
   // The condition for returning sentinel is reaching the end of current
   // file_iter_: !Valid() && status.().ok().
   void TrySetDeleteRangeSentinel(const Slice& boundary_key);
   void ClearSentinel() { to_return_sentinel_ = false; }
+
+  // When a sequential scan moves into a file, opens the table of the file
+  // after it from a background thread, so that it is in the table cache, with
+  // its index and filter, by the time the scan gets there.
+  void MaybeOpenNextFile();
+  static void OpenNextFile(void* arg);
+  // Cancels the background open, or waits for it to finish
+  void WaitForNextFileOpen();
+
+  port::Mutex next_file_mutex_;
+  port::CondVar next_file_cv_{&next_file_mutex_};
+  bool next_file_open_pending_ = false;
+  size_t next_file_index_ = 0;
 };
 
+void LevelIterator::MaybeOpenNextFile() {
+  if (!read_options_.adaptive_readahead || !read_options_.async_io ||
+      file_index_ + 1 >= flevel_->num_files ||
+      flevel_->files[file_index_ + 1].fd.table_reader != nullptr ||
+      KeyReachedUpperBound(file_smallest_key(file_index_ + 1))) {
+    return;
+  }
+  MutexLock l(&next_file_mutex_);
+  if (next_file_open_pending_) {
+    // Still opening a previous file
+    return;
+  }
+  next_file_open_pending_ = true;
+  next_file_index_ = file_index_ + 1;
+  TEST_SYNC_POINT("LevelIterator::MaybeOpenNextFile:Schedule");
+  table_cache_->env()->Schedule(&LevelIterator::OpenNextFile, this,
+                                Env::Priority::LOW, this);
+}
+
+void LevelIterator::OpenNextFile(void* arg) {
+  LevelIterator* iter = static_cast<LevelIterator*>(arg);
+  TEST_SYNC_POINT("LevelIterator::OpenNextFile");
+  const size_t file_index = iter->next_file_index_;
+  TableCache::TypedHandle* handle = nullptr;
+  Status s = iter->table_cache_->FindTable(
+      iter->read_options_, iter->file_options_, iter->icomparator_,
+      *iter->flevel_->files[file_index].file_metadata, &handle,
+      iter->mutable_cf_options_, /*no_io=*/false, iter->file_read_hist_,
+      iter->skip_filters_, iter->level_);
+  // Any error is hit again when the scan opens the file
+  s.PermitUncheckedError();
+  if (handle != nullptr) {
+    iter->table_cache_->get_cache().Release(handle);
+  }
+  MutexLock l(&iter->next_file_mutex_);
+  iter->next_file_open_pending_ = false;
+  iter->next_file_cv_.SignalAll();
+}
+
+void LevelIterator::WaitForNextFileOpen() {
+  MutexLock l(&next_file_mutex_);
+  if (next_file_open_pending_ &&
+      table_cache_->env()->UnSchedule(this, Env::Priority::LOW) > 0) {
+    next_file_open_pending_ = false;
+  }
+  while (next_file_open_pending_) {
+    next_file_cv_.Wait();
+  }
+}
+
 void LevelIterator::TrySetDeleteRangeSentinel(const Slice& boundary_key) {
   assert(range_tombstone_iter_);
   if (file_iter_.iter() != nullptr && !file_iter_.Valid() &&
@@ -1420,7 +1571,9 @@ void LevelIterator::Next() {
       TrySetDeleteRangeSentinel(file_largest_key(file_index_));
     }
   }
+  is_next_read_sequential_ = true;
   SkipEmptyFileForward();
+  is_next_read_sequential_ = false;
 }
 
 bool LevelIterator::NextAndGetResult(IterateResult* result) {
@@ -1489,6 +1642,9 @@ bool LevelIterator::SkipEmptyFileForward() {
     }
     // may init a new *range_tombstone_iter
     InitFileIterator(file_index_ + 1);
+    if (is_next_read_sequential_) {
+      MaybeOpenNextFile();
+    }
     // We moved to a new SST file
     // Seek range_tombstone_iter_ to reset its !Valid() default state.
     // We do not need to call range_tombstone_iter_.Seek* in
@@ -1955,6 +2111,116 @@ void Version::GetCreationTimeOfOldestFile(uint64_t* creation_time) {
   *creation_time = oldest_time;
 }
 
+VersionKeyAnchors::VersionKeyAnchors(const Comparator* ucmp,
+                                     std::vector<Anchor>&& anchors)
+    : ucmp_(ucmp) {
+  std::sort(anchors.begin(), anchors.end(),
+            [ucmp](const Anchor& a, const Anchor& b) {
+              return ucmp->Compare(a.user_key, b.user_key) < 0;
+            });
+  keys_.reserve(anchors.size());
+  cumulative_sizes_.reserve(anchors.size() + 1);
+  cumulative_counts_.reserve(anchors.size() + 1);
+  cumulative_sizes_.push_back(0);
+  cumulative_counts_.push_back(0);
+  for (Anchor& anchor : anchors) {
+    keys_.push_back(std::move(anchor.user_key));
+    cumulative_sizes_.push_back(cumulative_sizes_.back() + anchor.size);
+    cumulative_counts_.push_back(cumulative_counts_.back() + anchor.count);
+  }
+}
+
+size_t VersionKeyAnchors::LowerBound(const Slice& user_key) const {
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), user_key,
+                             [this](const std::string& key, const Slice& k) {
+                               return ucmp_->Compare(key, k) < 0;
+                             });
+  return static_cast<size_t>(it - keys_.begin());
+}
+
+VersionKeyAnchors::Stats VersionKeyAnchors::Estimate(
+    const Slice& start, const Slice& limit) const {
+  Stats stats;
+  if (ucmp_->Compare(start, limit) >= 0) {
+    return stats;
+  }
+  // The data of the anchors [begin, end) is in [start, limit), but for the
+  // part of anchor `end` below `limit`.
+  const size_t begin = LowerBound(start);
+  const size_t end = LowerBound(limit);
+  stats.size = cumulative_sizes_[end] - cumulative_sizes_[begin];
+  stats.count = cumulative_counts_[end] - cumulative_counts_[begin];
+  return stats;
+}
+
+const VersionKeyAnchors& Version::GetKeyAnchors(
+    const ReadOptions& read_options) {
+  std::call_once(key_anchors_once_,
+                 [&]() { key_anchors_ = BuildKeyAnchors(read_options); });
+  return *key_anchors_;
+}
+
+std::unique_ptr<VersionKeyAnchors> Version::BuildKeyAnchors(
+    const ReadOptions& read_options) {
+  std::vector<VersionKeyAnchors::Anchor> anchors;
+  std::vector<TableReader::Anchor> file_anchors;
+  for (int level = 0; level < storage_info_.num_non_empty_levels_; level++) {
+    for (FileMetaData* f : storage_info_.LevelFiles(level)) {
+      file_anchors.clear();
+      Status s = table_cache_->ApproximateKeyAnchors(
+          read_options, *internal_comparator(), *f, mutable_cf_options_,
+          file_anchors);
+      if (!s.ok() || file_anchors.empty()) {
+        file_anchors.clear();
+        file_anchors.emplace_back(f->largest.user_key(), f->fd.GetFileSize());
+      }
+      uint64_t num_entries = f->num_entries;
+      if (num_entries == 0) {
+        std::shared_ptr<const TableProperties> props;
+        s = table_cache_->GetTableProperties(
+            file_options_, read_options, *internal_comparator(), *f, &props,
+            mutable_cf_options_);
+        if (s.ok() && props != nullptr) {
+          num_entries = props->num_entries;
+        }
+      }
+
+      uint64_t file_size = 0;
+      for (const auto& anchor : file_anchors) {
+        file_size += anchor.range_size;
+      }
+      // Keeps every `step`-th anchor, each covering the data of the anchors
+      // skipped before it, and spreads the entries of the file over them in
+      // proportion to their size.
+      const size_t step =
+          (file_anchors.size() + VersionKeyAnchors::kMaxAnchorsPerFile - 1) /
+          VersionKeyAnchors::kMaxAnchorsPerFile;
+      uint64_t size_so_far = 0;
+      uint64_t entries_so_far = 0;
+      uint64_t anchor_size = 0;
+      for (size_t i = 0; i < file_anchors.size(); ++i) {
+        anchor_size += file_anchors[i].range_size;
+        if ((i + 1) % step != 0 && i + 1 != file_anchors.size()) {
+          continue;
+        }
+        size_so_far += anchor_size;
+        const uint64_t entries =
+            file_size == 0
+                ? num_entries
+                : static_cast<uint64_t>(static_cast<double>(num_entries) *
+                                        static_cast<double>(size_so_far) /
+                                        static_cast<double>(file_size));
+        anchors.push_back({std::move(file_anchors[i].user_key), anchor_size,
+                           entries - entries_so_far});
+        entries_so_far = entries;
+        anchor_size = 0;
+      }
+    }
+  }
+  return std::make_unique<VersionKeyAnchors>(user_comparator(),
+                                             std::move(anchors));
+}
+
 InternalIterator* Version::TEST_GetLevelIterator(
     const ReadOptions& read_options, MergeIteratorBuilder* merge_iter_builder,
     int level, bool allow_unprepared_value) {
@@ -2036,22 +2302,55 @@ double VersionStorageInfo::GetEstimatedCompressionRatioAtLevel(
   return static_cast<double>(sum_data_size_bytes) / sum_file_size_bytes;
 }
 
+bool FileIteratorStash::Put(
+    uint64_t file_number, int level,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor,
+    InternalIterator* iter) {
+  if (!accepting_) {
+    return false;
+  }
+  auto result = entries_.emplace(file_number,
+                                 Entry{iter, level, prefix_extractor});
+  return result.second;
+}
+
+InternalIterator* FileIteratorStash::Take(
+    uint64_t file_number, int level, const SliceTransform* prefix_extractor) {
+  auto it = entries_.find(file_number);
+  if (it == entries_.end() || it->second.level != level ||
+      it->second.prefix_extractor.get() != prefix_extractor) {
+    return nullptr;
+  }
+  InternalIterator* iter = it->second.iter;
+  entries_.erase(it);
+  return iter;
+}
+
+void FileIteratorStash::Clear() {
+  for (auto& entry : entries_) {
+    delete entry.second.iter;
+  }
+  entries_.clear();
+}
+
 void Version::AddIterators(const ReadOptions& read_options,
                            const FileOptions& soptions,
                            MergeIteratorBuilder* merge_iter_builder,
-                           bool allow_unprepared_value) {
+                           bool allow_unprepared_value,
+                           FileIteratorStash* file_iter_stash) {
   assert(storage_info_.finalized_);
 
   for (int level = 0; level < storage_info_.num_non_empty_levels(); level++) {
     AddIteratorsForLevel(read_options, soptions, merge_iter_builder, level,
-                         allow_unprepared_value);
+                         allow_unprepared_value, file_iter_stash);
   }
 }
 
 void Version::AddIteratorsForLevel(const ReadOptions& read_options,
                                    const FileOptions& soptions,
                                    MergeIteratorBuilder* merge_iter_builder,
-                                   int level, bool allow_unprepared_value) {
+                                   int level, bool allow_unprepared_value,
+                                   FileIteratorStash* file_iter_stash) {
   assert(storage_info_.finalized_);
   if (level >= storage_info_.num_non_empty_levels()) {
     // This is an empty level
@@ -2069,6 +2368,10 @@ void Version::AddIteratorsForLevel(const ReadOptions& read_options,
     std::unique_ptr<TruncatedRangeDelIterator> tombstone_iter = nullptr;
     for (size_t i = 0; i < storage_info_.LevelFilesBrief(0).num_files; i++) {
       const auto& file = storage_info_.LevelFilesBrief(0).files[i];
+      if (!TimestampMayMatch(read_options, user_comparator(),
+                             *file.file_metadata)) {
+        continue;
+      }
       auto table_iter = cfd_->table_cache()->NewIterator(
           read_options, soptions, cfd_->internal_comparator(),
           *file.file_metadata, /*range_del_agg=*/nullptr, mutable_cf_options_,
@@ -2108,7 +2411,7 @@ void Version::AddIteratorsForLevel(const ReadOptions& read_options,
         TableReaderCaller::kUserIterator, IsFilterSkipped(level), level,
         /*range_del_agg=*/nullptr,
         /*compaction_boundaries=*/nullptr, allow_unprepared_value,
-        &tombstone_iter_ptr);
+        &tombstone_iter_ptr, file_iter_stash);
     if (read_options.ignore_range_deletions) {
       merge_iter_builder->AddIterator(level_iter);
     } else {
@@ -2197,6 +2500,8 @@ VersionStorageInfo::VersionStorageInfo(
       lowest_unnecessary_level_(-1),
       level_multiplier_(0.0),
       files_by_compaction_pri_(num_levels_),
+      files_by_compaction_pri_reusable_(false),
+      ref_vstorage_(ref_vstorage),
       level0_non_overlapping_(false),
       next_file_to_compact_by_size_(num_levels_),
       compaction_score_(num_levels_),
@@ -2212,6 +2517,7 @@ VersionStorageInfo::VersionStorageInfo(
       current_num_deletions_(0),
       current_num_samples_(0),
       estimated_compaction_needed_bytes_(0),
+      read_amp_reduction_per_byte_(0.0),
       clock_(clock),
       bottommost_file_compaction_delay_(bottommost_file_compaction_delay),
       finalized_(false),
@@ -2325,6 +2631,12 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
   return s;
 }
 
+bool Version::IsBlobInCache(const BlobIndex& blob_index) const {
+  assert(blob_source_);
+  return blob_source_->IsBlobInCache(blob_index.file_number(),
+                                     blob_index.offset());
+}
+
 void Version::MultiGetBlob(
     const ReadOptions& read_options, MultiGetRange& range,
     std::unordered_map<uint64_t, BlobReadContexts>& blob_ctxs) {
@@ -2461,6 +2773,9 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                 &storage_info_.file_indexer_, user_comparator(),
                 internal_comparator());
   FdWithKeyRange* f = fp.GetNextFile();
+  if (get_context.sample()) {
+    cfd_->internal_stats()->AddSampledLookups(1);
+  }
 
   while (f != nullptr) {
     if (*max_covering_tombstone_seq > 0) {
@@ -2470,6 +2785,16 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
     }
     if (get_context.sample()) {
       sample_file_read_inc(f->file_metadata);
+      cfd_->internal_stats()->AddSampledFileProbe(
+          static_cast<int>(fp.GetHitFileLevel()));
+    }
+    if (!TimestampMayMatch(read_options, user_comparator(),
+                           *f->file_metadata)) {
+      // Counted as the table reader would have, had the file been opened
+      RecordTick(db_statistics_, TIMESTAMP_FILTER_TABLE_CHECKED);
+      RecordTick(db_statistics_, TIMESTAMP_FILTER_TABLE_FILTERED);
+      f = fp.GetNextFile();
+      continue;
     }
 
     bool timer_enabled =
@@ -2634,7 +2959,7 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         iter->s->ok() ? GetContext::kNotFound : GetContext::kMerge,
         iter->ukey_with_ts, iter->value, iter->columns, iter->timestamp,
         nullptr, &(iter->merge_context), true,
-        &iter->max_covering_tombstone_seq, clock_, nullptr,
+        &iter->max_covering_tombstone_seq, clock_, iter->seq,
         merge_operator_ ? &pinned_iters_mgr : nullptr, callback,
         &iter->is_blob_index, tracing_mget_id, &blob_fetcher);
     // MergeInProgress status, if set, has been transferred to the get_context
@@ -2644,9 +2969,16 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
     *(iter->s) = Status::OK();
   }
   int get_ctx_index = 0;
+  uint64_t num_sampled_lookups = 0;
   for (auto iter = range->begin(); iter != range->end();
        ++iter, get_ctx_index++) {
     iter->get_context = &(get_ctx[get_ctx_index]);
+    if (iter->get_context->sample()) {
+      num_sampled_lookups++;
+    }
+  }
+  if (num_sampled_lookups > 0) {
+    cfd_->internal_stats()->AddSampledLookups(num_sampled_lookups);
   }
 
   Status s;
@@ -3123,6 +3455,7 @@ void VersionStorageInfo::PrepareForVersionAppend(
   GenerateLevel0NonOverlapping();
   GenerateBottommostFiles();
   GenerateFileLocationIndex();
+  ref_vstorage_ = nullptr;
 }
 
 void Version::PrepareAppend(const ReadOptions& read_options,
@@ -3657,8 +3990,47 @@ void VersionStorageInfo::ComputeCompactionScore(
       mutable_cf_options.blob_garbage_collection_age_cutoff,
       mutable_cf_options.blob_garbage_collection_force_threshold,
       mutable_cf_options.enable_blob_garbage_collection);
+  ComputeFilesMarkedForBlobGCByGarbageRatio(
+      mutable_cf_options.blob_garbage_collection_file_threshold,
+      mutable_cf_options.enable_blob_garbage_collection);
+  ComputeFilesMarkedForPromotion(immutable_options, mutable_cf_options,
+                                 max_output_level);
 
   EstimateCompactionBytesNeeded(mutable_cf_options);
+  EstimateReadAmpReductionPerByte();
+}
+
+void VersionStorageInfo::EstimateReadAmpReductionPerByte() {
+  read_amp_reduction_per_byte_ = 0.0;
+  if (CompactionScore(0) < 1.0) {
+    return;
+  }
+  const int level = CompactionScoreLevel(0);
+  // The sampled reads of the input files approximate the lookups that stop
+  // probing them once they are merged into the next level.
+  uint64_t reads = 0;
+  uint64_t bytes = 0;
+  for (const auto* f : files_[level]) {
+    if (f->being_compacted) {
+      continue;
+    }
+    reads += f->stats.num_reads_sampled.load(std::memory_order_relaxed);
+    bytes += f->fd.GetFileSize();
+    if (level == 0) {
+      // Every L0 file is a sorted run of its own, which point lookups that
+      // have not been sampled probe as well
+      reads++;
+    }
+  }
+  if (level == 0 && compaction_style_ == kCompactionStyleLevel &&
+      base_level_ > 0) {
+    // L0 files usually overlap the whole base level
+    bytes += NumLevelBytes(base_level_);
+  }
+  if (bytes > 0) {
+    read_amp_reduction_per_byte_ =
+        static_cast<double>(reads) / static_cast<double>(bytes);
+  }
 }
 
 void VersionStorageInfo::ComputeFilesMarkedForCompaction(int last_level) {
@@ -3838,8 +4210,7 @@ void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
   const auto& oldest_meta = blob_files_.front();
   assert(oldest_meta);
 
-  const auto& linked_ssts = oldest_meta->GetLinkedSsts();
-  assert(!linked_ssts.empty());
+  assert(!oldest_meta->GetLinkedSsts().empty());
 
   size_t count = 1;
   uint64_t sum_total_blob_bytes = oldest_meta->GetTotalBlobBytes();
@@ -3860,7 +4231,76 @@ void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
     return;
   }
 
-  for (uint64_t sst_file_number : linked_ssts) {
+  MarkLinkedSstsForForcedBlobGC(*oldest_meta);
+}
+
+void VersionStorageInfo::ComputeFilesMarkedForBlobGCByGarbageRatio(
+    double blob_garbage_collection_file_threshold,
+    bool enable_blob_garbage_collection) {
+  if (!(enable_blob_garbage_collection &&
+        blob_garbage_collection_file_threshold < 1.0)) {
+    return;
+  }
+
+  // The compactions forced based on age come first
+  if (!files_marked_for_forced_blob_gc_.empty()) {
+    return;
+  }
+
+  // Pick the blob file with the highest ratio of garbage among those that
+  // reach the threshold and have linked SSTs to compact. Those SSTs reference
+  // it as their oldest blob file, and compacting them relocates the valid
+  // blobs they reference.
+  const BlobFileMetaData* picked_meta = nullptr;
+  double picked_ratio = 0.0;
+
+  for (const auto& meta : blob_files_) {
+    assert(meta);
+
+    const uint64_t total_blob_bytes = meta->GetTotalBlobBytes();
+    const uint64_t garbage_blob_bytes = meta->GetGarbageBlobBytes();
+    if (garbage_blob_bytes == 0 ||
+        garbage_blob_bytes <
+            blob_garbage_collection_file_threshold * total_blob_bytes) {
+      continue;
+    }
+
+    const double ratio = static_cast<double>(garbage_blob_bytes) /
+                         static_cast<double>(total_blob_bytes);
+    if (ratio <= picked_ratio) {
+      continue;
+    }
+
+    bool has_sst_to_compact = false;
+    for (uint64_t sst_file_number : meta->GetLinkedSsts()) {
+      const FileLocation location = GetFileLocation(sst_file_number);
+      assert(location.IsValid());
+
+      const FileMetaData* const sst_meta =
+          files_[location.GetLevel()][location.GetPosition()];
+      assert(sst_meta);
+
+      if (!sst_meta->being_compacted) {
+        has_sst_to_compact = true;
+        break;
+      }
+    }
+    if (!has_sst_to_compact) {
+      continue;
+    }
+
+    picked_meta = meta.get();
+    picked_ratio = ratio;
+  }
+
+  if (picked_meta) {
+    MarkLinkedSstsForForcedBlobGC(*picked_meta);
+  }
+}
+
+void VersionStorageInfo::MarkLinkedSstsForForcedBlobGC(
+    const BlobFileMetaData& blob_file_meta) {
+  for (uint64_t sst_file_number : blob_file_meta.GetLinkedSsts()) {
     const FileLocation location = GetFileLocation(sst_file_number);
     assert(location.IsValid());
 
@@ -3880,6 +4320,31 @@ void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
   }
 }
 
+void VersionStorageInfo::ComputeFilesMarkedForPromotion(
+    const ImmutableOptions& ioptions,
+    const MutableCFOptions& mutable_cf_options, int last_level) {
+  files_marked_for_promotion_.clear();
+  const Temperature cold = mutable_cf_options.last_level_temperature;
+  const uint64_t min_reads = mutable_cf_options.last_level_promotion_reads;
+  if (ioptions.compaction_style != kCompactionStyleLevel || min_reads == 0 ||
+      cold == Temperature::kUnknown ||
+      cold == mutable_cf_options.default_write_temperature) {
+    return;
+  }
+  // Compactions only write last_level_temperature into the actual last
+  // level, which is not one of their outputs with allow_ingest_behind
+  if (last_level != num_levels_ - 1) {
+    return;
+  }
+  for (FileMetaData* f : files_[last_level]) {
+    if (!f->being_compacted && f->temperature == cold &&
+        f->stats.num_reads_sampled.load(std::memory_order_relaxed) >=
+            min_reads) {
+      files_marked_for_promotion_.emplace_back(last_level, f);
+    }
+  }
+}
+
 namespace {
 
 // used to sort files by size
@@ -3970,12 +4435,15 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
+// Sort `temp` based on ratio of overlapping size over file size. When
+// `hotness_aware` is set, the ratio of a file is scaled by its sampled reads
+// relative to the average of the level, by at most kMaxHotnessPenalty.
 void SortFileByOverlappingRatio(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
     const std::vector<FileMetaData*>& next_level_files, SystemClock* clock,
-    int level, int num_non_empty_levels, uint64_t ttl,
+    int level, int num_non_empty_levels, uint64_t ttl, bool hotness_aware,
     std::vector<Fsize>* temp) {
+  constexpr uint64_t kMaxHotnessPenalty = 4;
   std::unordered_map<uint64_t, uint64_t> file_to_order;
   auto next_level_it = next_level_files.begin();
 
@@ -4016,6 +4484,26 @@ void SortFileByOverlappingRatio(
                                           ttl_boost_score;
   }
 
+  if (hotness_aware && !files.empty()) {
+    uint64_t total_reads = 0;
+    for (auto& file : files) {
+      total_reads +=
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+    }
+    // A file with the average number of reads keeps its order, and a cold one
+    // gets up to half of it. Files with no overlap stay first, since moving
+    // them keeps their cached blocks.
+    const uint64_t avg_reads = total_reads / files.size() + 1;
+    for (auto& file : files) {
+      const uint64_t reads =
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+      uint64_t& order = file_to_order[file->fd.GetNumber()];
+      order = order * std::min(reads + avg_reads,
+                               kMaxHotnessPenalty * 2 * avg_reads) /
+              (2 * avg_reads);
+    }
+  }
+
   size_t num_to_sort = temp->size() > VersionStorageInfo::kNumberFilesToSort
                            ? VersionStorageInfo::kNumberFilesToSort
                            : temp->size();
@@ -4105,11 +4593,40 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
     // don't need this
     return;
   }
+  // With these priorities, the order of the files of a level is a function of
+  // the files of the level, and of the next one for kMinOverlappingRatio
+  const bool reusable =
+      ioptions.compaction_pri == kByCompensatedSize ||
+      ioptions.compaction_pri == kOldestLargestSeqFirst ||
+      ioptions.compaction_pri == kOldestSmallestSeqFirst ||
+      (ioptions.compaction_pri == kMinOverlappingRatio && options.ttl == 0);
+  const VersionStorageInfo* ref = ref_vstorage_;
+  if (ref != nullptr &&
+      (!reusable || !ref->files_by_compaction_pri_reusable_ ||
+       ref->num_levels() != num_levels())) {
+    ref = nullptr;
+  }
+  files_by_compaction_pri_reusable_ = reusable;
+
   // No need to sort the highest level because it is never compacted.
   for (int level = 0; level < num_levels() - 1; level++) {
     const std::vector<FileMetaData*>& files = files_[level];
     auto& files_by_compaction_pri = files_by_compaction_pri_[level];
     assert(files_by_compaction_pri.size() == 0);
+    next_file_to_compact_by_size_[level] = 0;
+
+    // Levels that did not change since the reference version keep its order,
+    // which saves sorting the unchanged levels of a large LSM at every
+    // version install
+    if (ref != nullptr && ref->files_[level] == files &&
+        ref->files_by_compaction_pri_[level].size() == files.size() &&
+        (ioptions.compaction_pri != kMinOverlappingRatio ||
+         ref->files_[level + 1] == files_[level + 1])) {
+      files_by_compaction_pri = ref->files_by_compaction_pri_[level];
+      TEST_SYNC_POINT_CALLBACK(
+          "VersionStorageInfo::UpdateFilesByCompactionPri:Reused", &level);
+      continue;
+    }
 
     // populate a temp vector for sorting based on size
     std::vector<Fsize> temp(files.size());
@@ -4145,7 +4662,14 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
       case kMinOverlappingRatio:
         SortFileByOverlappingRatio(*internal_comparator_, files_[level],
                                    files_[level + 1], ioptions.clock, level,
-                                   num_non_empty_levels_, options.ttl, &temp);
+                                   num_non_empty_levels_, options.ttl,
+                                   false /* hotness_aware */, &temp);
+        break;
+      case kHotnessAware:
+        SortFileByOverlappingRatio(*internal_comparator_, files_[level],
+                                   files_[level + 1], ioptions.clock, level,
+                                   num_non_empty_levels_, options.ttl,
+                                   true /* hotness_aware */, &temp);
         break;
       case kRoundRobin:
         SortFileByRoundRobin(*internal_comparator_, &compact_cursor_,
@@ -4160,7 +4684,6 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
     for (size_t i = 0; i < temp.size(); i++) {
       files_by_compaction_pri.push_back(static_cast<int>(temp[i].index));
     }
-    next_file_to_compact_by_size_[level] = 0;
     assert(files_[level].size() == files_by_compaction_pri_[level].size());
   }
 }
@@ -5917,9 +6440,11 @@ Status VersionSet::ProcessManifestWrites(
 #endif  // NDEBUG
 
   // wake up all the waiting writers
+  uint64_t group_size = 0;
   while (true) {
     ManifestWriter* ready = manifest_writers_.front();
     manifest_writers_.pop_front();
+    group_size++;
     bool need_signal = true;
     for (const auto& w : writers) {
       if (&w == ready) {
@@ -5939,6 +6464,7 @@ Status VersionSet::ProcessManifestWrites(
       break;
     }
   }
+  RecordInHistogram(db_options_->stats, MANIFEST_WRITE_GROUP_SIZE, group_size);
   if (!manifest_writers_.empty()) {
     manifest_writers_.front()->cv.Signal();
   }
@@ -6001,9 +6527,16 @@ Status VersionSet::LogAndApply(
   ManifestWriter& first_writer = writers.front();
   TEST_SYNC_POINT_CALLBACK("VersionSet::LogAndApply:BeforeWriterWaiting",
                            nullptr);
+  Statistics* stats = db_options_->stats;
+  const uint64_t queue_start_micros =
+      stats != nullptr ? clock_->NowMicros() : 0;
   while (!first_writer.done && &first_writer != manifest_writers_.front()) {
     first_writer.cv.Wait();
   }
+  if (stats != nullptr) {
+    RecordInHistogram(stats, MANIFEST_WRITE_QUEUE_MICROS,
+                      clock_->NowMicros() - queue_start_micros);
+  }
   if (first_writer.done) {
     // All non-CF-manipulation operations can be grouped together and committed
     // to MANIFEST. They should all have finished. The status code is stored in
@@ -7127,7 +7660,8 @@ InternalIterator* VersionSet::MakeInputIterator(
     RangeDelAggregator* range_del_agg,
     const FileOptions& file_options_compactions,
     const std::optional<const Slice>& start,
-    const std::optional<const Slice>& end) {
+    const std::optional<const Slice>& end,
+    const std::vector<FileOptions>* input_file_options) {
   auto cfd = c->column_family_data();
   // Level-0 files have to be merged together.  For other levels,
   // we will make a concatenating iterator per level.
@@ -7146,6 +7680,15 @@ InternalIterator* VersionSet::MakeInputIterator(
       range_tombstones;
   size_t num = 0;
   [[maybe_unused]] size_t num_input_files = 0;
+  // Index of the next input in input_file_options
+  size_t input_idx = 0;
+  auto next_input_file_options = [&]() -> const FileOptions& {
+    if (input_file_options == nullptr) {
+      return file_options_compactions;
+    }
+    assert(input_idx < input_file_options->size());
+    return (*input_file_options)[input_idx++];
+  };
   for (size_t which = 0; which < c->num_input_levels(); which++) {
     const LevelFilesBrief* flevel = c->input_levels(which);
     num_input_files += flevel->num_files;
@@ -7153,6 +7696,7 @@ InternalIterator* VersionSet::MakeInputIterator(
       if (c->level(which) == 0) {
         for (size_t i = 0; i < flevel->num_files; i++) {
           const FileMetaData& fmd = *flevel->files[i].file_metadata;
+          const FileOptions& file_options = next_input_file_options();
           if (start.has_value() &&
               cfd->user_comparator()->CompareWithoutTimestamp(
                   *start, fmd.largest.user_key()) > 0) {
@@ -7169,9 +7713,8 @@ InternalIterator* VersionSet::MakeInputIterator(
           std::unique_ptr<TruncatedRangeDelIterator> range_tombstone_iter =
               nullptr;
           list[num++] = cfd->table_cache()->NewIterator(
-              read_options, file_options_compactions,
-              cfd->internal_comparator(), fmd, range_del_agg,
-              c->mutable_cf_options(),
+              read_options, file_options, cfd->internal_comparator(), fmd,
+              range_del_agg, c->mutable_cf_options(),
               /*table_reader_ptr=*/nullptr,
               /*file_read_hist=*/nullptr, TableReaderCaller::kCompaction,
               /*arena=*/nullptr,
@@ -7191,7 +7734,7 @@ InternalIterator* VersionSet::MakeInputIterator(
         std::unique_ptr<TruncatedRangeDelIterator>** tombstone_iter_ptr =
             nullptr;
         list[num++] = new LevelIterator(
-            cfd->table_cache(), read_options, file_options_compactions,
+            cfd->table_cache(), read_options, next_input_file_options(),
             cfd->internal_comparator(), flevel, c->mutable_cf_options(),
             /*should_sample=*/false,
             /*no per level latency histogram=*/nullptr,
@@ -7610,92 +8153,6 @@ Status ReactiveVersionSet::MaybeSwitchManifest(
   return s;
 }
 
-void MaybeWarmupBlockCacheForEvictedRange(Version* current_version,
-                                           const InternalKey& smallest,
-                                           const InternalKey& largest,
-                                           TableCache* table_cache,
-                                           const ReadOptions& base_read_options,
-                                           const InternalKeyComparator& icmp,
-                                           const EnvOptions& env_options,
-                                           Logger* info_log,
-					   const FileOptions& file_options,
-					   const MutableCFOptions& mutable_cf_options) {
-
-
-    (void)env_options;
-    TableCache::TypedHandle* handle = nullptr; 
-    Arena arena;
-    std::cout << "[WARMUP] smallest: " << smallest.DebugString(false, nullptr) << std::endl; 
-    std::cout << "[WARMUP] largest: " << largest.DebugString(false, nullptr) << std::endl;
-    std::cout << "[WARMUP] comparison result: " << icmp.Compare(largest, smallest) << std::endl;
-  
-   assert(info_log != nullptr);
-     std::ofstream warmup_log("/tmp/warmup_log.txt", std::ios::app);
-
-     warmup_log << "[WARMUP] Start warmup for evicted range: ["
-                << smallest.DebugString(false, nullptr) << " ~ "
-                << largest.DebugString(false, nullptr) << "]\n";
-
-     warmup_log.close();
-    
-
-    std::cout << "[Warmup] Start warm-up for evicted range [" 
-          << smallest.DebugString(false, nullptr) << ", " 
-          << largest.DebugString(false, nullptr) << "]" << std::endl;
-
-    for (int level = 0; level < current_version->storage_info()->num_levels(); ++level) {
-        const auto& files = current_version->storage_info()->LevelFiles(level);
-        for (auto* f : files) {
-            if (icmp.Compare(f->largest, smallest) < 0 || icmp.Compare(f->smallest, largest) > 0) {
-                continue; // 범위 겹치지 않음
-            }
-
-   
-            TableReader* table_reader = nullptr;
-            const ReadOptions& ro = base_read_options;
-            ReadOptions ro_copy = base_read_options;
-            ro_copy.fill_cache = true;
-
-            Status s = table_cache->FindTable(ro, file_options, icmp, *f, &handle,
-                                  mutable_cf_options, /*skip_filters=*/false,
-                                  /*level_histogram=*/nullptr,
-                                  /*for_compaction=*/false,
-                                  /*level=*/level,
-                                  /*force_table_reader_creation=*/false,
-                                  /*file_read_cost=*/0,
-                                  Temperature::kUnknown);
-
-            if (!s.ok() || table_reader == nullptr) {
-              
-                continue;
-            }
-
-
-            ro_copy.fill_cache = true;
-            std::unique_ptr<InternalIterator> iter(
-            table_reader->NewIterator(ro_copy, nullptr,  &arena, false,
-                              TableReaderCaller::kCompaction, 0,
-                              /*for_compaction=*/true));
-
-
-            size_t count = 0;
-            for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
-                const Slice& ikey = iter->key();
-		InternalKey internal_key(ikey, kMaxSequenceNumber, kTypeValue);
-                if (icmp.Compare(internal_key, smallest) >= 0 &&
-                    icmp.Compare(internal_key, largest) <= 0) {
-                    ++count;
-                    continue; // blockcache에 올라감
-                }
-            }
-           
-        }
-    }
-    
-}
-
-
-
 #ifndef NDEBUG
 uint64_t ReactiveVersionSet::TEST_read_edits_in_atomic_group() const {
   assert(manifest_tailer_);
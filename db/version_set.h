@@ -24,6 +24,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -206,6 +207,12 @@ class VersionStorageInfo {
   void EstimateCompactionBytesNeeded(
       const MutableCFOptions& mutable_cf_options);
 
+  // Estimate read_amp_reduction_per_byte_ for the compaction of the level
+  // with the highest score. Called by ComputeCompactionScore().
+  //
+  // REQUIRES: DB mutex held
+  void EstimateReadAmpReductionPerByte();
+
   // This computes files_marked_for_compaction_ and is called by
   // ComputeCompactionScore()
   void ComputeFilesMarkedForCompaction(int last_level);
@@ -242,6 +249,25 @@ class VersionStorageInfo {
       double blob_garbage_collection_force_threshold,
       bool enable_blob_garbage_collection);
 
+  // This adds the SSTs linked to the blob file with the highest ratio of
+  // garbage at or above blob_garbage_collection_file_threshold to
+  // files_marked_for_forced_blob_gc_, unless the latter has files already, and
+  // is called by ComputeCompactionScore() after
+  // ComputeFilesMarkedForForcedBlobGC()
+  //
+  // REQUIRES: DB mutex held
+  void ComputeFilesMarkedForBlobGCByGarbageRatio(
+      double blob_garbage_collection_file_threshold,
+      bool enable_blob_garbage_collection);
+
+  // This computes files_marked_for_promotion_ and is called by
+  // ComputeCompactionScore()
+  //
+  // REQUIRES: DB mutex held
+  void ComputeFilesMarkedForPromotion(
+      const ImmutableOptions& ioptions,
+      const MutableCFOptions& mutable_cf_options, int last_level);
+
   bool level0_non_overlapping() const { return level0_non_overlapping_; }
 
   // Updates the oldest snapshot and related internal state, like the bottommost
@@ -520,6 +546,16 @@ class VersionStorageInfo {
     return files_marked_for_forced_blob_gc_;
   }
 
+  // The files of the last level on last_level_temperature that have been
+  // read often enough to go back to default_write_temperature
+  // REQUIRES: ComputeCompactionScore has been called
+  // REQUIRES: DB mutex held during access
+  const autovector<std::pair<int, FileMetaData*>>& FilesMarkedForPromotion()
+      const {
+    assert(finalized_);
+    return files_marked_for_promotion_;
+  }
+
   int base_level() const { return base_level_; }
   double level_multiplier() const { return level_multiplier_; }
 
@@ -604,6 +640,13 @@ class VersionStorageInfo {
     return estimated_compaction_needed_bytes_;
   }
 
+  // How much the compaction of the level with the highest score is expected
+  // to reduce the work of reads, per byte it writes. Only meaningful to
+  // compare the column families of a DB.
+  double read_amp_reduction_per_byte() const {
+    return read_amp_reduction_per_byte_;
+  }
+
   void TEST_set_estimated_compaction_needed_bytes(uint64_t v,
                                                   InstrumentedMutex* mu) {
     InstrumentedMutexLock l(mu);
@@ -652,6 +695,10 @@ class VersionStorageInfo {
   void GenerateBottommostFiles();
   void GenerateFileLocationIndex();
 
+  // Adds the SSTs linked to the blob file that are not being compacted to
+  // files_marked_for_forced_blob_gc_
+  void MarkLinkedSstsForForcedBlobGC(const BlobFileMetaData& blob_file_meta);
+
   const InternalKeyComparator* internal_comparator_;
   const Comparator* user_comparator_;
   int num_levels_;            // Number of levels
@@ -697,6 +744,17 @@ class VersionStorageInfo {
   // This vector stores the index of the file from files_.
   std::vector<std::vector<int>> files_by_compaction_pri_;
 
+  // True if the order of files_by_compaction_pri_ of each level only depends
+  // on the files of the level and of the next level, and not on the time or
+  // on the reads of the files, so that it can be reused by a version with the
+  // same files in the two levels.
+  bool files_by_compaction_pri_reusable_;
+
+  // The storage info of the version this one is built from, whose
+  // files_by_compaction_pri_ are reused by UpdateFilesByCompactionPri() for
+  // the levels that did not change. Only set until PrepareForVersionAppend().
+  const VersionStorageInfo* ref_vstorage_;
+
   // If true, means that files in L0 have keys with non overlapping ranges
   bool level0_non_overlapping_;
 
@@ -726,6 +784,8 @@ class VersionStorageInfo {
 
   autovector<std::pair<int, FileMetaData*>> files_marked_for_forced_blob_gc_;
 
+  autovector<std::pair<int, FileMetaData*>> files_marked_for_promotion_;
+
   // Threshold for needing to mark another bottommost file. Maintain it so we
   // can quickly check when releasing a snapshot whether more bottommost files
   // became eligible for compaction. It's defined as the min of the max nonzero
@@ -777,6 +837,8 @@ class VersionStorageInfo {
   // Estimated bytes needed to be compacted until all levels' size is down to
   // target sizes.
   uint64_t estimated_compaction_needed_bytes_;
+  // See read_amp_reduction_per_byte()
+  double read_amp_reduction_per_byte_;
 
   // Used for computing bottommost files marked for compaction and checking for
   // offpeak time.
@@ -867,6 +929,94 @@ class ObsoleteBlobFileInfo {
   std::string path_;
 };
 
+// The table iterators of the files below L0 of a DB iterator, kept across
+// Iterator::Refresh() so that the refreshed iterator goes on with their
+// blocks and readahead for the files that are still live, instead of opening
+// new table iterators for them.
+class FileIteratorStash {
+ public:
+  FileIteratorStash() = default;
+  ~FileIteratorStash() { Clear(); }
+  // No copying allowed
+  FileIteratorStash(const FileIteratorStash&) = delete;
+  FileIteratorStash& operator=(const FileIteratorStash&) = delete;
+
+  // While accepting, the level iterators being destroyed move their table
+  // iterators here instead of deleting them.
+  void set_accepting(bool accepting) { accepting_ = accepting; }
+
+  // Returns false if the stash does not take ownership of `iter`, the table
+  // iterator of a file without range tombstones.
+  bool Put(uint64_t file_number, int level,
+           const std::shared_ptr<const SliceTransform>& prefix_extractor,
+           InternalIterator* iter);
+
+  // Returns the iterator stashed for the file, or nullptr if there is none
+  // or it was built for another level or prefix extractor. The caller takes
+  // ownership of the returned iterator.
+  InternalIterator* Take(uint64_t file_number, int level,
+                         const SliceTransform* prefix_extractor);
+
+  bool empty() const { return entries_.empty(); }
+
+  // Deletes the iterators which were not taken
+  void Clear();
+
+ private:
+  struct Entry {
+    InternalIterator* iter;
+    int level;
+    // The table iterator may use it
+    std::shared_ptr<const SliceTransform> prefix_extractor;
+  };
+
+  UnorderedMap<uint64_t, Entry> entries_;
+  bool accepting_ = false;
+};
+
+// Sampled key anchors (see TableReader::ApproximateKeyAnchors()) of all the
+// table files of a Version, with the cumulative size and number of entries
+// of the data up to each anchor, so that the amount of data in a key range
+// can be estimated with two binary searches in memory. The estimates have
+// the granularity of the anchors: data of an anchor partly in the range is
+// counted as outside of it. See SizeApproximationOptions::use_key_anchors.
+class VersionKeyAnchors {
+ public:
+  struct Anchor {
+    std::string user_key;
+    // Size and number of entries of the data of the file between the
+    // previous anchor of the file (excluded) and this one (included)
+    uint64_t size;
+    uint64_t count;
+  };
+
+  struct Stats {
+    uint64_t size = 0;
+    uint64_t count = 0;
+  };
+
+  // At most this many anchors are kept per file
+  static constexpr size_t kMaxAnchorsPerFile = 32;
+
+  VersionKeyAnchors(const Comparator* ucmp, std::vector<Anchor>&& anchors);
+
+  // Returns the estimated size and number of entries of the data in the
+  // user key range [start, limit).
+  Stats Estimate(const Slice& start, const Slice& limit) const;
+
+  size_t NumAnchors() const { return keys_.size(); }
+
+ private:
+  // Index of the first anchor not below `user_key`
+  size_t LowerBound(const Slice& user_key) const;
+
+  const Comparator* const ucmp_;
+  std::vector<std::string> keys_;
+  // cumulative_sizes_[i] and cumulative_counts_[i] sum the anchors [0, i)
+  std::vector<uint64_t> cumulative_sizes_;
+  std::vector<uint64_t> cumulative_counts_;
+};
+
 using MultiGetRange = MultiGetContext::Range;
 // A column family's version consists of the table and blob files owned by
 // the column family at a certain point in time.
@@ -876,17 +1026,21 @@ class Version {
   // yield the contents of this Version when merged together.
   // @param read_options Must outlive any iterator built by
   // `merger_iter_builder`.
+  // @param file_iter_stash If not nullptr, the level iterators take table
+  // iterators from it and return theirs to it, see FileIteratorStash.
   void AddIterators(const ReadOptions& read_options,
                     const FileOptions& soptions,
                     MergeIteratorBuilder* merger_iter_builder,
-                    bool allow_unprepared_value);
+                    bool allow_unprepared_value,
+                    FileIteratorStash* file_iter_stash = nullptr);
 
   // @param read_options Must outlive any iterator built by
   // `merger_iter_builder`.
   void AddIteratorsForLevel(const ReadOptions& read_options,
                             const FileOptions& soptions,
                             MergeIteratorBuilder* merger_iter_builder,
-                            int level, bool allow_unprepared_value);
+                            int level, bool allow_unprepared_value,
+                            FileIteratorStash* file_iter_stash = nullptr);
 
   Status OverlapWithLevelIterator(const ReadOptions&, const FileOptions&,
                                   const Slice& smallest_user_key,
@@ -943,6 +1097,10 @@ class Version {
                  FilePrefetchBuffer* prefetch_buffer, PinnableSlice* value,
                  uint64_t* bytes_read) const;
 
+  // Whether the blob referenced by `blob_index` is in the primary tier of the
+  // blob cache, see BlobSource::IsBlobInCache().
+  bool IsBlobInCache(const BlobIndex& blob_index) const;
+
   struct BlobReadContext {
     BlobReadContext(const BlobIndex& blob_idx, const KeyContext* key_ctx)
         : blob_index(blob_idx), key_context(key_ctx) {}
@@ -1053,6 +1211,11 @@ class Version {
 
   const MutableCFOptions& GetMutableCFOptions() { return mutable_cf_options_; }
 
+  // Returns the key anchors of the table files of this version, reading them
+  // from the files on the first call. Thread-safe.
+  // REQUIRES: DB mutex not held
+  const VersionKeyAnchors& GetKeyAnchors(const ReadOptions& read_options);
+
   InternalIterator* TEST_GetLevelIterator(
       const ReadOptions& read_options, MergeIteratorBuilder* merge_iter_builder,
       int level, bool allow_unprepared_value);
@@ -1079,6 +1242,9 @@ class Version {
   // that it eventually expires from the cache.
   bool IsFilterSkipped(int level, bool is_file_last_in_level = false);
 
+  std::unique_ptr<VersionKeyAnchors> BuildKeyAnchors(
+      const ReadOptions& read_options);
+
   // The helper function of UpdateAccumulatedStats, which may fill the missing
   // fields of file_meta from its associated TableProperties.
   // Returns true if it does initialize FileMetaData.
@@ -1141,6 +1307,9 @@ class Version {
   uint64_t version_number_;
   std::shared_ptr<IOTracer> io_tracer_;
   bool use_async_io_;
+  // Built by the first call to GetKeyAnchors()
+  std::once_flag key_anchors_once_;
+  std::unique_ptr<VersionKeyAnchors> key_anchors_;
 
   Version(ColumnFamilyData* cfd, VersionSet* vset, const FileOptions& file_opt,
           const MutableCFOptions& mutable_cf_options,
@@ -1482,12 +1651,16 @@ class VersionSet {
   // The caller should delete the iterator when no longer needed.
   // @param read_options Must outlive the returned iterator.
   // @param start, end indicates compaction range
+  // @param input_file_options If not null, the file options of each L0 input
+  // file and then of each other input level, replacing
+  // file_options_compactions. Must outlive the returned iterator.
   InternalIterator* MakeInputIterator(
       const ReadOptions& read_options, const Compaction* c,
       RangeDelAggregator* range_del_agg,
       const FileOptions& file_options_compactions,
       const std::optional<const Slice>& start,
-      const std::optional<const Slice>& end);
+      const std::optional<const Slice>& end,
+      const std::vector<FileOptions>* input_file_options = nullptr);
 
   // Add all files listed in any live version to *live_table_files and
   // *live_blob_files. Note that these lists may contain duplicates.
@@ -1741,20 +1914,6 @@ class VersionSet {
   bool closed_;
 };
 
-// warm-up 함수 선언
-void MaybeWarmupBlockCacheForEvictedRange(
-    Version* current_version,
-    const InternalKey& smallest,
-    const InternalKey& largest,
-    TableCache* table_cache,
-    const ReadOptions& base_read_options,
-    const InternalKeyComparator& icmp,
-    const EnvOptions& env_options,
-    Logger* info_log,
-    const FileOptions& file_options,
-    const MutableCFOptions& mutable_cf_options);
-
-
 // ReactiveVersionSet represents a collection of versions of the column
 // families of the database. Users of ReactiveVersionSet, e.g. DBImplSecondary,
 // need to replay the MANIFEST (description log in older terms) in order to
@@ -58,6 +58,7 @@ DEFINE_SYNC_AND_ASYNC(Status, Version::MultiGetFromSST)
 
     if (get_context.sample()) {
       sample_file_read_inc(f->file_metadata);
+      cfd_->internal_stats()->AddSampledFileProbe(hit_file_level);
     }
     batch_size++;
     num_index_read += get_context.get_context_stats_.num_index_read;
@@ -100,7 +101,7 @@ DEFINE_SYNC_AND_ASYNC(Status, Version::MultiGetFromSST)
 
         file_range.MarkKeyDone(iter);
 
-        if (iter->is_blob_index) {
+        if (iter->is_blob_index && iter->seq == nullptr) {
           BlobIndex blob_index;
           Status tmp_s;
 
@@ -94,6 +94,34 @@ TEST_F(GenerateLevelFilesBriefTest, Multiple) {
   ASSERT_EQ(0, Compare());
 }
 
+TEST_F(GenerateLevelFilesBriefTest, FindFileWithKeyPrefixes) {
+  // Files sharing the first 8 bytes of their largest keys, and keys shorter
+  // than 8 bytes
+  Add("a", "b");
+  Add("c", "prefix00a");
+  Add("prefix00b", "prefix00c");
+  Add("prefix00d", "prefix00e");
+  Add("prefix01", "prefix02");
+  Add("q", "r\xff");
+  DoGenerateLevelFilesBrief(&file_level_, files_, &arena_);
+  ASSERT_NE(file_level_.largest_key_prefixes, nullptr);
+
+  InternalKeyComparator icmp(BytewiseComparator());
+  LevelFilesBrief plain = file_level_;
+  plain.largest_key_prefixes = nullptr;
+  for (const char* user_key :
+       {"", "a", "b", "bb", "prefix", "prefix00", "prefix00a", "prefix00aa",
+        "prefix00c", "prefix00cc", "prefix00e", "prefix00f", "prefix01",
+        "prefix02", "prefix020", "q", "r", "r\xff", "r\xff\xff", "s"}) {
+    InternalKey key(user_key, 100, kValueTypeForSeek);
+    ASSERT_EQ(FindFile(icmp, plain, key.Encode()),
+              FindFile(icmp, file_level_, key.Encode()))
+        << user_key;
+  }
+  InternalKey key("prefix00cc", 100, kValueTypeForSeek);
+  ASSERT_EQ(3, FindFile(icmp, file_level_, key.Encode()));
+}
+
 class CountingLogger : public Logger {
  public:
   CountingLogger() : log_count(0) {}
@@ -758,6 +786,108 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCSingleBatch) {
   }
 }
 
+TEST_F(VersionStorageInfoTest, ForcedBlobGCByGarbageRatio) {
+  // Add three L0 SSTs (1, 2, and 3), whose oldest blob files are 10, 11, and
+  // 12 respectively, with garbage ratios of 0.1, 0.6, and 0.8.
+
+  constexpr int level = 0;
+
+  constexpr uint64_t first_sst = 1;
+  constexpr uint64_t second_sst = 2;
+  constexpr uint64_t third_sst = 3;
+
+  constexpr uint64_t first_blob = 10;
+  constexpr uint64_t second_blob = 11;
+  constexpr uint64_t third_blob = 12;
+
+  constexpr uint64_t file_size = 1000;
+
+  Add(level, first_sst, "bar1", "foo1", file_size, first_blob);
+  Add(level, second_sst, "bar2", "foo2", file_size, second_blob);
+  Add(level, third_sst, "bar3", "foo3", file_size, third_blob);
+
+  constexpr uint64_t total_blob_count = 10;
+  constexpr uint64_t total_blob_bytes = 100000;
+
+  AddBlob(first_blob, total_blob_count, total_blob_bytes,
+          BlobFileMetaData::LinkedSsts{first_sst}, /*garbage_blob_count=*/1,
+          /*garbage_blob_bytes=*/10000);
+  AddBlob(second_blob, total_blob_count, total_blob_bytes,
+          BlobFileMetaData::LinkedSsts{second_sst}, /*garbage_blob_count=*/6,
+          /*garbage_blob_bytes=*/60000);
+  AddBlob(third_blob, total_blob_count, total_blob_bytes,
+          BlobFileMetaData::LinkedSsts{third_sst}, /*garbage_blob_count=*/8,
+          /*garbage_blob_bytes=*/80000);
+
+  UpdateVersionStorageInfo();
+
+  const auto& level_files = vstorage_.LevelFiles(level);
+  assert(level_files.size() == 3);
+  assert(level_files[1] && level_files[1]->fd.GetNumber() == second_sst);
+  assert(level_files[2] && level_files[2]->fd.GetNumber() == third_sst);
+
+  // No blob file reaches the threshold
+
+  {
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(
+        /*age_cutoff=*/0.0, /*force_threshold=*/1.0,
+        /*enable_blob_garbage_collection=*/true);
+    vstorage_.ComputeFilesMarkedForBlobGCByGarbageRatio(
+        /*file_threshold=*/0.9, /*enable_blob_garbage_collection=*/true);
+
+    ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
+  }
+
+  // The blob file with the most garbage is picked
+
+  {
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(
+        /*age_cutoff=*/0.0, /*force_threshold=*/1.0,
+        /*enable_blob_garbage_collection=*/true);
+    vstorage_.ComputeFilesMarkedForBlobGCByGarbageRatio(
+        /*file_threshold=*/0.5, /*enable_blob_garbage_collection=*/true);
+
+    const auto& ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
+    ASSERT_EQ(ssts_to_be_compacted.size(), 1);
+    ASSERT_EQ(ssts_to_be_compacted[0],
+              (std::pair<int, FileMetaData*>{level, level_files[2]}));
+  }
+
+  // Blob files whose linked SSTs are all being compacted are skipped
+
+  {
+    level_files[2]->being_compacted = true;
+
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(
+        /*age_cutoff=*/0.0, /*force_threshold=*/1.0,
+        /*enable_blob_garbage_collection=*/true);
+    vstorage_.ComputeFilesMarkedForBlobGCByGarbageRatio(
+        /*file_threshold=*/0.5, /*enable_blob_garbage_collection=*/true);
+
+    const auto& ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
+    ASSERT_EQ(ssts_to_be_compacted.size(), 1);
+    ASSERT_EQ(ssts_to_be_compacted[0],
+              (std::pair<int, FileMetaData*>{level, level_files[1]}));
+
+    level_files[2]->being_compacted = false;
+  }
+
+  // The compactions forced based on age take precedence
+
+  {
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(
+        /*age_cutoff=*/0.5, /*force_threshold=*/0.0,
+        /*enable_blob_garbage_collection=*/true);
+    vstorage_.ComputeFilesMarkedForBlobGCByGarbageRatio(
+        /*file_threshold=*/0.5, /*enable_blob_garbage_collection=*/true);
+
+    const auto& ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
+    ASSERT_EQ(ssts_to_be_compacted.size(), 1);
+    ASSERT_EQ(ssts_to_be_compacted[0],
+              (std::pair<int, FileMetaData*>{level, level_files[0]}));
+  }
+}
+
 TEST_F(VersionStorageInfoTest, ForcedBlobGCMultipleBatches) {
   // Add three L0 SSTs (1, 2, and 3) and four blob files (10, 11, 12, and 13).
   // The first two SSTs have the same oldest blob file, namely, the very oldest
@@ -2409,6 +2539,75 @@ TEST_F(VersionStorageInfoTest, AddRangeDeletionCompensatedFileSize) {
   ASSERT_EQ(meta->compensated_file_size, 100U + 1000U);
 }
 
+TEST_F(VersionStorageInfoTest, ReuseFilesByCompactionPriOfUnchangedLevels) {
+  ioptions_.compaction_pri = kMinOverlappingRatio;
+  mutable_cf_options_.ttl = 0;
+  Add(1, 10U, "a", "c", 300U);
+  Add(1, 11U, "d", "f", 100U);
+  Add(1, 12U, "g", "i", 200U);
+  Add(2, 20U, "a", "b", 1000U);
+  Add(2, 21U, "e", "h", 3000U);
+  Add(3, 30U, "a", "c", 5000U);
+  UpdateVersionStorageInfo();
+
+  // A version with one more file in L3, and thus a different order of L2
+  auto* new_file = new FileMetaData(
+      40U, 0, 9000U, GetInternalKey("e", 0), GetInternalKey("f", 0),
+      /* smallest_seq */ 0, /* largest_seq */ 0,
+      /* marked_for_compact */ false, Temperature::kUnknown,
+      kInvalidBlobFileNumber, kUnknownOldestAncesterTime,
+      kUnknownFileCreationTime, kUnknownEpochNumber, kUnknownFileChecksum,
+      kUnknownFileChecksumFuncName, kNullUniqueId64x2, 0, 0,
+      /* user_defined_timestamps_persisted */ true);
+  std::vector<std::unique_ptr<VersionStorageInfo>> vstorages;
+  for (VersionStorageInfo* ref :
+       {&vstorage_, static_cast<VersionStorageInfo*>(nullptr)}) {
+    vstorages.emplace_back(new VersionStorageInfo(
+        &icmp_, ucmp_, 6, kCompactionStyleLevel, ref,
+        /*_force_consistency_checks=*/false,
+        EpochNumberRequirement::kMustPresent, ioptions_.clock,
+        mutable_cf_options_.bottommost_file_compaction_delay,
+        OffpeakTimeOption()));
+    for (int level = 0; level < vstorage_.num_levels(); level++) {
+      for (auto* f : vstorage_.LevelFiles(level)) {
+        vstorages.back()->AddFile(level, f);
+      }
+    }
+  }
+  std::vector<int> reused_levels;
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionStorageInfo::UpdateFilesByCompactionPri:Reused",
+      [&](void* arg) { reused_levels.push_back(*static_cast<int*>(arg)); });
+  SyncPoint::GetInstance()->EnableProcessing();
+  for (auto& vstorage : vstorages) {
+    vstorage->AddFile(3, new_file);
+    vstorage->PrepareForVersionAppend(ioptions_, mutable_cf_options_);
+    vstorage->SetFinalized();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Only the version built from vstorage_ reuses its order, and only for the
+  // levels whose next level did not change either
+  ASSERT_EQ(std::vector<int>({0, 1, 4}), reused_levels);
+  for (int level = 0; level < vstorage_.num_levels() - 1; level++) {
+    ASSERT_EQ(vstorages[1]->FilesByCompactionPri(level),
+              vstorages[0]->FilesByCompactionPri(level));
+  }
+  ASSERT_EQ(vstorage_.FilesByCompactionPri(1),
+            vstorages[0]->FilesByCompactionPri(1));
+
+  for (auto& vstorage : vstorages) {
+    for (int level = 0; level < vstorage->num_levels(); level++) {
+      for (auto* f : vstorage->LevelFiles(level)) {
+        if (--f->refs == 0) {
+          delete f;
+        }
+      }
+    }
+  }
+}
+
 class VersionSetWithTimestampTest : public VersionSetTest {
  public:
   static const std::string kNewCfName;
@@ -0,0 +1,284 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/warmup_scheduler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <memory>
+#include <utility>
+
+#include "db/column_family.h"
+#include "db/internal_stats.h"
+#include "db/table_cache.h"
+#include "db/version_set.h"
+#include "logging/logging.h"
+#include "monitoring/statistics_impl.h"
+#include "options/db_options.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+WarmupScheduler::WarmupScheduler(const ImmutableDBOptions& db_options,
+                                 const FileOptions& file_options,
+                                 InstrumentedMutex* db_mutex,
+                                 const std::atomic<bool>* shutting_down)
+    : db_options_(db_options),
+      file_options_(file_options),
+      db_mutex_(db_mutex),
+      shutting_down_(shutting_down),
+      max_background_warmups_(db_options.max_background_warmups),
+      bg_cv_(db_mutex) {}
+
+WarmupScheduler::~WarmupScheduler() {
+  assert(queue_.empty());
+  assert(bg_warmup_scheduled_ == 0);
+}
+
+bool WarmupScheduler::Schedule(WarmupJob&& job) {
+  db_mutex_->AssertHeld();
+  assert(job.cfd != nullptr);
+  assert(job.version != nullptr);
+  if (!enabled() || ShouldStop()) {
+    return false;
+  }
+  job.cfd->Ref();
+  job.version->Ref();
+  queue_.push_back(std::move(job));
+  if (bg_warmup_scheduled_ < max_background_warmups_) {
+    ++bg_warmup_scheduled_;
+    db_options_.env->Schedule(&WarmupScheduler::BGWorkWarmup, this,
+                              Env::Priority::USER, this);
+  }
+  return true;
+}
+
+void WarmupScheduler::Shutdown() {
+  db_mutex_->AssertHeld();
+  closed_.store(true, std::memory_order_release);
+  while (!queue_.empty()) {
+    ReleaseJob(&queue_.front());
+    queue_.pop_front();
+  }
+  while (bg_warmup_scheduled_ > 0) {
+    bg_cv_.Wait();
+  }
+}
+
+void WarmupScheduler::WaitForIdle() {
+  db_mutex_->AssertHeld();
+  while (!queue_.empty() || bg_warmup_scheduled_ > 0) {
+    bg_cv_.Wait();
+  }
+}
+
+void WarmupScheduler::BGWorkWarmup(void* arg) {
+  reinterpret_cast<WarmupScheduler*>(arg)->BackgroundCallWarmup();
+}
+
+void WarmupScheduler::BackgroundCallWarmup() {
+  InstrumentedMutexLock l(db_mutex_);
+  while (!queue_.empty()) {
+    WarmupJob job = std::move(queue_.front());
+    queue_.pop_front();
+    if (!job.cfd->IsDropped() && !ShouldStop()) {
+      db_mutex_->Unlock();
+      TEST_SYNC_POINT("WarmupScheduler::BackgroundCallWarmup:Start");
+      InternalStats::WarmupStats warmup_stats;
+      RunAndRecordJob(job, &warmup_stats).PermitUncheckedError();
+      TEST_SYNC_POINT("WarmupScheduler::BackgroundCallWarmup:End");
+      db_mutex_->Lock();
+      job.cfd->internal_stats()->AddWarmupStats(warmup_stats);
+    }
+    ReleaseJob(&job);
+  }
+  --bg_warmup_scheduled_;
+  bg_cv_.SignalAll();
+}
+
+Status WarmupScheduler::RunAndRecordJob(const WarmupJob& job,
+                                        InternalStats::WarmupStats* stats) {
+  const uint64_t start_micros = db_options_.clock->NowMicros();
+  WarmupProgress progress;
+  Status s = RunJob(job, stats, &progress);
+  stats->num_jobs = 1;
+  stats->micros = db_options_.clock->NowMicros() - start_micros;
+  RecordTick(db_options_.stats, WARMUP_BLOCKS_INSERTED, stats->blocks_inserted);
+  RecordTick(db_options_.stats, WARMUP_BYTES_READ, stats->bytes_read);
+  RecordTick(db_options_.stats, WARMUP_BLOCKS_ALREADY_CACHED,
+             stats->blocks_already_cached);
+  RecordTick(db_options_.stats, WARMUP_BLOCKS_SKIPPED, stats->blocks_skipped);
+  RecordTick(db_options_.stats, WARMUP_BYTES_SKIPPED, stats->bytes_skipped);
+  RecordInHistogram(db_options_.stats, WARMUP_MICROS, stats->micros);
+  if (s.ok() || s.IsShutdownInProgress()) {
+    ROCKS_LOG_INFO(
+        db_options_.info_log,
+        "[%s] [JOB %d] Warmup: %" PRIu64 " files, %" PRIu64
+        " blocks inserted (%" PRIu64 " to the secondary cache), %" PRIu64
+        " bytes read, %" PRIu64
+        " blocks already cached, skipped for a full block cache: %" PRIu64
+        " blocks, %" PRIu64 " bytes, %" PRIu64 " files in %" PRIu64
+        " us, status: %s",
+        job.cfd->GetName().c_str(), job.job_id, stats->num_files,
+        stats->blocks_inserted, stats->blocks_inserted_to_secondary_cache,
+        stats->bytes_read, stats->blocks_already_cached, stats->blocks_skipped,
+        stats->bytes_skipped, stats->files_skipped, stats->micros,
+        s.ToString().c_str());
+  } else {
+    ROCKS_LOG_WARN(db_options_.info_log, "[%s] [JOB %d] Warmup failed: %s",
+                   job.cfd->GetName().c_str(), job.job_id,
+                   s.ToString().c_str());
+  }
+  if (job.progress_callback) {
+    progress.done = true;
+    progress.status = s;
+    job.progress_callback(progress);
+  }
+  return s;
+}
+
+Status WarmupScheduler::Run(const WarmupJob& job) {
+  InternalStats::WarmupStats warmup_stats;
+  Status s = RunAndRecordJob(job, &warmup_stats);
+  InstrumentedMutexLock l(db_mutex_);
+  job.cfd->internal_stats()->AddWarmupStats(warmup_stats);
+  return s;
+}
+
+void WarmupScheduler::ReleaseJob(WarmupJob* job) {
+  db_mutex_->AssertHeld();
+  job->version->Unref();
+  job->cfd->UnrefAndTryDelete();
+  job->version = nullptr;
+  job->cfd = nullptr;
+}
+
+bool WarmupScheduler::ShouldStop() const {
+  return closed_.load(std::memory_order_acquire) ||
+         shutting_down_->load(std::memory_order_acquire);
+}
+
+Status WarmupScheduler::RunJob(const WarmupJob& job,
+                               InternalStats::WarmupStats* stats,
+                               WarmupProgress* progress) {
+  const VersionStorageInfo* vstorage = job.version->storage_info();
+  std::vector<std::pair<int, const FileMetaData*>> targets;
+  std::vector<FileMetaData*> files;
+  for (int level = 0; level < vstorage->num_non_empty_levels(); level++) {
+    files.clear();
+    vstorage->GetOverlappingInputs(level, &job.smallest, &job.largest, &files,
+                                   /*hint_index=*/-1, /*file_index=*/nullptr,
+                                   /*expand_range=*/false);
+    for (const FileMetaData* f : files) {
+      if (job.target_files.empty() ||
+          std::find(job.target_files.begin(), job.target_files.end(),
+                    f->fd.GetNumber()) != job.target_files.end()) {
+        targets.emplace_back(level, f);
+      }
+    }
+  }
+  progress->total_files = targets.size();
+
+  bool cache_full = false;
+  for (const auto& [level, f] : targets) {
+    if (ShouldStop()) {
+      return Status::ShutdownInProgress();
+    }
+    if (BudgetExhausted(job, *stats)) {
+      return Status::OK();
+    }
+    if (cache_full) {
+      ++stats->files_skipped;
+      continue;
+    }
+    Status s = WarmupFile(job, *f, level, stats);
+    if (s.IsIncomplete()) {
+      // Loading more would evict blocks that are in use, count what is left.
+      cache_full = true;
+      s = Status::OK();
+    }
+    if (!s.ok()) {
+      return s;
+    }
+    ++stats->num_files;
+    progress->files_warmed = stats->num_files;
+    progress->blocks_inserted = stats->blocks_inserted;
+    progress->bytes_read = stats->bytes_read;
+    progress->blocks_already_cached = stats->blocks_already_cached;
+    if (job.progress_callback) {
+      job.progress_callback(*progress);
+    }
+  }
+  return Status::OK();
+}
+
+Status WarmupScheduler::WarmupFile(const WarmupJob& job,
+                                   const FileMetaData& file, int level,
+                                   InternalStats::WarmupStats* stats) {
+  ColumnFamilyData* cfd = job.cfd;
+  const MutableCFOptions& mutable_cf_options =
+      job.version->GetMutableCFOptions();
+  const Comparator* ucmp = cfd->user_comparator();
+
+  ReadOptions read_options;
+  read_options.fill_cache = true;
+  read_options.rate_limiter_priority = job.rate_limiter_priority;
+  TableReader::PrefetchOptions prefetch_options;
+  prefetch_options.caller = job.low_priority ? TableReaderCaller::kWarmup
+                                             : TableReaderCaller::kPrefetch;
+  prefetch_options.data_blocks = job.data_blocks;
+  prefetch_options.stop_at_cache_capacity = job.stop_at_cache_capacity;
+  prefetch_options.to_secondary_cache = job.to_secondary_cache;
+  // The partitions are loaded with the first range prefetched from the file.
+  prefetch_options.index_and_filter_partitions =
+      job.index_and_filter_partitions;
+  auto prefetch = [&](const Slice& begin, const Slice& end) {
+    TableReader::PrefetchStats prefetch_stats;
+    Status s = cfd->table_cache()->Prefetch(
+        read_options, cfd->internal_comparator(), file, mutable_cf_options,
+        &begin, &end, cfd->internal_stats()->GetFileReadHist(level), level,
+        &prefetch_stats, &prefetch_options);
+    prefetch_options.index_and_filter_partitions = false;
+    stats->blocks_inserted += prefetch_stats.blocks_loaded;
+    stats->blocks_inserted_to_secondary_cache +=
+        prefetch_stats.blocks_loaded_to_secondary_cache;
+    stats->bytes_read += prefetch_stats.bytes_read;
+    stats->blocks_already_cached += prefetch_stats.blocks_already_cached;
+    stats->blocks_skipped += prefetch_stats.blocks_skipped;
+    stats->bytes_skipped += prefetch_stats.bytes_skipped;
+    return s;
+  };
+
+  if (job.hot_ranges.empty()) {
+    return prefetch(job.smallest.Encode(), job.largest.Encode());
+  }
+  for (const auto& range : job.hot_ranges) {
+    if (ucmp->CompareWithoutTimestamp(range.largest,
+                                      file.smallest.user_key()) < 0) {
+      continue;
+    }
+    if (ucmp->CompareWithoutTimestamp(range.smallest,
+                                      file.largest.user_key()) > 0) {
+      break;
+    }
+    if (ShouldStop()) {
+      return Status::ShutdownInProgress();
+    }
+    if (BudgetExhausted(job, *stats)) {
+      break;
+    }
+    const InternalKey begin(range.smallest, kMaxSequenceNumber,
+                            kValueTypeForSeek);
+    const InternalKey end(range.largest, 0, kValueTypeForSeekForPrev);
+    Status s = prefetch(begin.Encode(), end.Encode());
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,171 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "db/internal_stats.h"
+#include "monitoring/instrumented_mutex.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+#include "table/table_reader.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ColumnFamilyData;
+struct FileMetaData;
+struct ImmutableDBOptions;
+class Version;
+
+// A request to load the blocks of a key range of one column family into the
+// block cache. `version` is the Version that was installed by the compaction
+// that produced the request, or the current one for DB::WarmupRange(); the
+// job only ever reads files of that Version.
+struct WarmupJob {
+  ColumnFamilyData* cfd = nullptr;
+  Version* version = nullptr;
+  int job_id = 0;
+  // Internal key range to warm, inclusive on both ends.
+  InternalKey smallest;
+  InternalKey largest;
+  // If not empty, only these files (by file number) are warmed. Otherwise all
+  // files of `version` overlapping [smallest, largest] are warmed.
+  std::vector<uint64_t> target_files;
+  // If not empty, only the parts of the files overlapping these user key
+  // ranges are warmed. In key order and without overlaps.
+  std::vector<TableReader::HotKeyRange> hot_ranges;
+  // If not 0, the job stops once it has read this many bytes, see
+  // CompactionWarmupPolicy::max_bytes_per_compaction.
+  uint64_t max_bytes = 0;
+  // See CompactionWarmupPolicy::stop_at_cache_capacity.
+  bool stop_at_cache_capacity = false;
+  // See CompactionWarmupPolicy::warm_index_and_filter_partitions.
+  bool index_and_filter_partitions = false;
+  // Whether the data blocks go to the secondary cache, see
+  // CompactionWarmupPolicy::secondary_cache_min_output_level.
+  bool to_secondary_cache = false;
+  // See WarmupOptions::data_blocks.
+  bool data_blocks = true;
+  // Whether the data blocks are inserted at Cache::Priority::BOTTOM, see
+  // WarmupOptions::low_priority.
+  bool low_priority = true;
+  Env::IOPriority rate_limiter_priority = Env::IO_LOW;
+  // See WarmupOptions::progress_callback.
+  std::function<void(const WarmupProgress&)> progress_callback;
+};
+
+// WarmupScheduler owns the queue of pending WarmupJobs of a DB instance and
+// runs them in the Env::Priority::USER thread pool. Reads issued by a job are
+// charged to the DB's rate limiter at Env::IO_LOW and never happen while the
+// DB mutex is held: the mutex is only taken to hand a job over and to release
+// the references it carries.
+//
+// Unless noted otherwise, the state of the scheduler is protected by the DB
+// mutex.
+class WarmupScheduler {
+ public:
+  WarmupScheduler(const ImmutableDBOptions& db_options,
+                  const FileOptions& file_options,
+                  InstrumentedMutex* db_mutex,
+                  const std::atomic<bool>* shutting_down);
+
+  WarmupScheduler(const WarmupScheduler&) = delete;
+  WarmupScheduler& operator=(const WarmupScheduler&) = delete;
+
+  ~WarmupScheduler();
+
+  // Whether the DB was opened with a non-zero `max_background_warmups`.
+  bool enabled() const { return max_background_warmups_ > 0; }
+
+  // Queues `job` and schedules a background warmup call if fewer than
+  // `max_background_warmups` are already scheduled. References to
+  // `job.cfd` and `job.version` are taken here and released once the job
+  // has run or has been dropped.
+  // Returns false if the job was dropped because warmup is disabled or the
+  // scheduler is shut down.
+  // REQUIRES: db mutex held, the new Version of `job.cfd` installed.
+  bool Schedule(WarmupJob&& job);
+
+  // Runs `job` on the calling thread, with the same accounting as a
+  // background job. Works whether or not background warmups are enabled.
+  // REQUIRES: db mutex not held, the caller holds references to `job.cfd`
+  // and `job.version` for the duration of the call.
+  Status Run(const WarmupJob& job);
+
+  // Drops all the queued jobs and waits for the running ones to finish. No
+  // job is accepted afterwards.
+  // REQUIRES: db mutex held
+  void Shutdown();
+
+  // Waits until no job is queued or running.
+  // REQUIRES: db mutex held
+  void WaitForIdle();
+
+  // REQUIRES: db mutex held
+  size_t NumPendingJobs() const { return queue_.size(); }
+  // REQUIRES: db mutex held
+  int NumScheduled() const { return bg_warmup_scheduled_; }
+
+ private:
+  static void BGWorkWarmup(void* arg);
+  void BackgroundCallWarmup();
+
+  // Runs `job` and records its results in the statistics and the info log.
+  // REQUIRES: db mutex not held
+  Status RunAndRecordJob(const WarmupJob& job,
+                         InternalStats::WarmupStats* stats);
+
+  // Loads the blocks of the job's key range into the block cache. Data blocks
+  // are inserted at Cache::Priority::BOTTOM for low priority jobs. If the job
+  // stops at the capacity of the block cache, the files it did not get to are
+  // counted as skipped. The job's progress callback, if any, is called after
+  // each file.
+  // REQUIRES: db mutex not held
+  Status RunJob(const WarmupJob& job, InternalStats::WarmupStats* stats,
+                WarmupProgress* progress);
+
+  // Loads the data blocks of a single file of the job's Version that overlap
+  // the job's key range (or its hot ranges) into the block cache, without
+  // iterating over their keys, after its index and filter partitions if the
+  // job asks for them. Returns Status::Incomplete() if it stopped because the
+  // block cache was full.
+  // REQUIRES: db mutex not held
+  Status WarmupFile(const WarmupJob& job, const FileMetaData& file, int level,
+                    InternalStats::WarmupStats* stats);
+
+  // REQUIRES: db mutex held
+  void ReleaseJob(WarmupJob* job);
+
+  bool ShouldStop() const;
+
+  // Whether `job` has used up its byte budget.
+  static bool BudgetExhausted(const WarmupJob& job,
+                              const InternalStats::WarmupStats& stats) {
+    return job.max_bytes > 0 && stats.bytes_read >= job.max_bytes;
+  }
+
+  const ImmutableDBOptions& db_options_;
+  const FileOptions& file_options_;
+  InstrumentedMutex* db_mutex_;
+  const std::atomic<bool>* shutting_down_;
+  const int max_background_warmups_;
+
+  // Signaled whenever bg_warmup_scheduled_ decreases.
+  InstrumentedCondVar bg_cv_;
+  std::deque<WarmupJob> queue_;
+  int bg_warmup_scheduled_ = 0;
+  // Also read without the DB mutex by running jobs.
+  std::atomic<bool> closed_{false};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -1794,6 +1794,112 @@ TEST_F(DBWideBasicTest, PinnableWideColumnsMove) {
   test_move(/* fill_cache*/ true);
 }
 
+TEST_F(DBWideBasicTest, ColumnProjection) {
+  Options options = GetDefaultOptions();
+
+  constexpr char first_key[] = "first";
+  const WideColumns first_columns{{kDefaultWideColumnName, "hello"},
+                                  {"attr_name1", "foo"},
+                                  {"attr_name2", "bar"},
+                                  {"attr_name3", "baz"}};
+
+  constexpr char second_key[] = "second";
+  constexpr char second_value[] = "quux";
+
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(),
+                           first_key, first_columns));
+  ASSERT_OK(db_->Put(WriteOptions(), db_->DefaultColumnFamily(), second_key,
+                     second_value));
+
+  const std::vector<Slice> column_names{"attr_name1", "attr_name3", "missing"};
+  ReadOptions read_options;
+  read_options.column_projection = &column_names;
+  const WideColumns expected_first_columns{{"attr_name1", "foo"},
+                                           {"attr_name3", "baz"}};
+
+  auto verify = [&]() {
+    {
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               first_key, &result));
+      ASSERT_EQ(result.columns(), expected_first_columns);
+
+      // Projected columns don't refer to the entity, so they survive moves
+      PinnableWideColumns move_target(std::move(result));
+      ASSERT_EQ(move_target.columns(), expected_first_columns);
+    }
+
+    {
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               second_key, &result));
+      ASSERT_TRUE(result.columns().empty());
+    }
+
+    {
+      constexpr size_t num_keys = 2;
+
+      std::array<Slice, num_keys> keys{{first_key, second_key}};
+      std::array<PinnableWideColumns, num_keys> results;
+      std::array<Status, num_keys> statuses;
+
+      db_->MultiGetEntity(read_options, db_->DefaultColumnFamily(), num_keys,
+                          keys.data(), results.data(), statuses.data());
+
+      ASSERT_OK(statuses[0]);
+      ASSERT_EQ(results[0].columns(), expected_first_columns);
+
+      ASSERT_OK(statuses[1]);
+      ASSERT_TRUE(results[1].columns().empty());
+    }
+
+    {
+      // Plain lookups are not affected
+      PinnableSlice result;
+      ASSERT_OK(db_->Get(read_options, db_->DefaultColumnFamily(), first_key,
+                         &result));
+      ASSERT_EQ(result, "hello");
+    }
+
+    {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+
+      iter->SeekToFirst();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), first_key);
+      ASSERT_EQ(iter->value(), "hello");
+      ASSERT_EQ(iter->columns(), expected_first_columns);
+
+      iter->Next();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), second_key);
+      ASSERT_EQ(iter->value(), second_value);
+      const WideColumns expected_second_columns{
+          {kDefaultWideColumnName, second_value}};
+      ASSERT_EQ(iter->columns(), expected_second_columns);
+
+      iter->Next();
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+    }
+  };
+
+  // Try reading from memtable
+  verify();
+
+  // Try reading after recovery
+  Close();
+  options.avoid_flush_during_recovery = true;
+  Reopen(options);
+
+  verify();
+
+  // Try reading from storage
+  ASSERT_OK(Flush());
+
+  verify();
+}
+
 TEST_F(DBWideBasicTest, SanityChecks) {
   constexpr char foo[] = "foo";
   constexpr char bar[] = "bar";
@@ -6,6 +6,7 @@
 #include "db/wide/wide_columns_helper.h"
 
 #include <ios>
+#include <string>
 
 #include "db/wide/wide_column_serialization.h"
 
@@ -41,4 +42,46 @@ Status WideColumnsHelper::DumpSliceAsWideColumns(const Slice& value,
   return s;
 }
 
+void WideColumnsHelper::ProjectColumns(const std::vector<Slice>& column_names,
+                                       WideColumns& columns) {
+  assert(std::is_sorted(column_names.begin(), column_names.end(),
+                        [](const Slice& lhs, const Slice& rhs) {
+                          return lhs.compare(rhs) < 0;
+                        }));
+
+  // Both are sorted, so they are merged
+  auto name_it = column_names.begin();
+  auto out = columns.begin();
+  for (auto it = columns.begin();
+       it != columns.end() && name_it != column_names.end(); ++it) {
+    int cmp = 0;
+    while (name_it != column_names.end() &&
+           (cmp = name_it->compare(it->name())) < 0) {
+      ++name_it;
+    }
+    if (name_it != column_names.end() && cmp == 0) {
+      *out++ = *it;
+      ++name_it;
+    }
+  }
+  columns.erase(out, columns.end());
+}
+
+Status WideColumnsHelper::ProjectColumns(const std::vector<Slice>& column_names,
+                                         PinnableWideColumns& columns) {
+  WideColumns projected = columns.columns();
+  ProjectColumns(column_names, projected);
+  if (projected.size() == columns.columns().size()) {
+    return Status::OK();
+  }
+
+  std::string output;
+  const Status s = WideColumnSerialization::Serialize(projected, output);
+  if (!s.ok()) {
+    return s;
+  }
+
+  return columns.SetWideColumnValue(std::move(output));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cassert>
 #include <ostream>
+#include <vector>
 
 #include "rocksdb/rocksdb_namespace.h"
 #include "rocksdb/wide_columns.h"
@@ -61,6 +62,16 @@ class WideColumnsHelper {
 
     return it;
   }
+
+  // Keeps only the columns named in `column_names`, which must be sorted and
+  // unique, like ReadOptions::column_projection.
+  static void ProjectColumns(const std::vector<Slice>& column_names,
+                             WideColumns& columns);
+
+  // Like above, but also copies the values of the columns kept, so that
+  // `columns` no longer refers to the whole entity.
+  static Status ProjectColumns(const std::vector<Slice>& column_names,
+                               PinnableWideColumns& columns);
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -2862,7 +2862,27 @@ class MemTableInserter : public WriteBatch::Handler {
       }
     }
 
-    if (!perform_merge) {
+    bool updated_in_place = false;
+    if (!perform_merge && moptions->inplace_update_support &&
+        moptions->inplace_merge_support) {
+      assert(!concurrent_memtable_writes_);
+      // Fold the operand into the latest one of the key in place
+      if (kv_prot_info != nullptr) {
+        auto mem_kv_prot_info =
+            kv_prot_info->StripC(column_family_id).ProtectS(sequence_);
+        ret_status = mem->UpdateMerge(sequence_, key, value, &mem_kv_prot_info);
+      } else {
+        ret_status =
+            mem->UpdateMerge(sequence_, key, value, nullptr /* kv_prot_info */);
+      }
+      if (ret_status.IsNotFound()) {
+        ret_status = Status::OK();
+      } else {
+        updated_in_place = true;
+      }
+    }
+
+    if (!perform_merge && !updated_in_place) {
       assert(ret_status.ok());
       // Add merge operand to memtable
       if (kv_prot_info != nullptr) {
@@ -99,6 +99,77 @@ uint64_t WriteController::GetDelay(SystemClock* clock, uint64_t num_bytes) {
   return std::max(next_refill_time_ - time_now, kMicrosPerRefill);
 }
 
+void WriteController::RecordDrainedBytes(uint64_t num_bytes, uint64_t micros,
+                                         int parallelism) {
+  // Weight of the newest compaction in the drain rate
+  const double kDrainRateWeight = 0.3;
+
+  if (num_bytes == 0 || micros == 0) {
+    return;
+  }
+  // The compactions running together share the device, so each of them
+  // reading at this rate adds up to the drain rate of all of them
+  double rate = 1.0 * num_bytes / micros * 1000000 * std::max(parallelism, 1);
+  if (drain_rate_ == 0) {
+    drain_rate_ = static_cast<uint64_t>(rate);
+  } else {
+    drain_rate_ = static_cast<uint64_t>(
+        kDrainRateWeight * rate +
+        (1 - kDrainRateWeight) * static_cast<double>(drain_rate_));
+  }
+}
+
+uint64_t WriteController::AdaptiveDelayedWriteRate(SystemClock* clock,
+                                                   double pressure) {
+  // Writes are shaped to keep the pressure around this
+  const double kTargetPressure = 0.25;
+  const double kProportionalGain = 1.0;
+  // Per second of error
+  const double kIntegralGain = 0.5;
+  const double kMaxIntegral = 1.0;
+  // Seconds
+  const double kDerivativeGain = 0.1;
+  const double kMaxDerivativeTerm = 0.5;
+  // Bounds of the drain rate scaling, and of its change per call
+  const double kMinFactor = 0.05;
+  const double kMaxFactor = 2.0;
+  const double kMaxStepRatio = 1.5;
+  const uint64_t kMinWriteRate = 16 * 1024u;
+  assert(drain_rate_ > 0);
+
+  auto time_now = NowMicrosMonotonic(clock);
+  double error = kTargetPressure - std::min(std::max(pressure, 0.0), 1.0);
+  double dt = 0;
+  if (last_adapt_time_ != 0 && time_now > last_adapt_time_) {
+    dt = 1.0 * (time_now - last_adapt_time_) / 1000000;
+  }
+  last_adapt_time_ = time_now;
+
+  pressure_error_integral_ =
+      std::min(std::max(pressure_error_integral_ + error * dt, -kMaxIntegral),
+               kMaxIntegral);
+  double derivative_term = 0;
+  if (dt > 0) {
+    derivative_term =
+        std::min(std::max(kDerivativeGain * (error - prev_pressure_error_) / dt,
+                          -kMaxDerivativeTerm),
+                 kMaxDerivativeTerm);
+  }
+  prev_pressure_error_ = error;
+
+  double factor = 1 + kProportionalGain * error +
+                  kIntegralGain * pressure_error_integral_ + derivative_term;
+  factor = std::min(std::max(factor, kMinFactor), kMaxFactor);
+
+  double write_rate = factor * static_cast<double>(drain_rate_);
+  double current_rate = static_cast<double>(delayed_write_rate_);
+  write_rate = std::min(std::max(write_rate, current_rate / kMaxStepRatio),
+                        current_rate * kMaxStepRatio);
+  return std::min(
+      std::max(static_cast<uint64_t>(write_rate), kMinWriteRate),
+      max_delayed_write_rate_);
+}
+
 uint64_t WriteController::NowMicrosMonotonic(SystemClock* clock) {
   return clock->NowNanos() / std::milli::den;
 }
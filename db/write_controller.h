@@ -83,6 +83,28 @@ class WriteController {
 
   uint64_t max_delayed_write_rate() const { return max_delayed_write_rate_; }
 
+  // If true, the delayed write rate of the column families follows
+  // AdaptiveDelayedWriteRate() once drain_rate() is known.
+  // See `DBOptions::adaptive_delayed_write_rate`.
+  void set_adaptive(bool adaptive) { adaptive_ = adaptive; }
+  bool adaptive() const { return adaptive_; }
+
+  // Accounts for a finished compaction that read num_bytes in micros, while
+  // parallelism compactions were running, in the estimated rate at which
+  // compactions drain the compaction debt.
+  // Prerequisite: DB mutex held.
+  void RecordDrainedBytes(uint64_t num_bytes, uint64_t micros,
+                          int parallelism);
+  // Bytes per second, or 0 if no compaction was recorded
+  uint64_t drain_rate() const { return drain_rate_; }
+
+  // Returns the delayed write rate for the stall pressure of a column family,
+  // which is 0 when it starts delaying writes and 1 when it would stop them.
+  // The rate is the drain rate scaled by a PID controller that keeps the
+  // pressure around a low target, and changes by a bounded ratio per call.
+  // Prerequisite: DB mutex held, drain_rate() > 0.
+  uint64_t AdaptiveDelayedWriteRate(SystemClock* clock, double pressure);
+
   RateLimiter* low_pri_rate_limiter() { return low_pri_rate_limiter_.get(); }
 
  private:
@@ -107,6 +129,14 @@ class WriteController {
   uint64_t delayed_write_rate_;
 
   std::unique_ptr<RateLimiter> low_pri_rate_limiter_;
+
+  bool adaptive_ = false;
+  // Smoothed rate of the compactions reading their input (bytes / second)
+  uint64_t drain_rate_ = 0;
+  // State of the controller of AdaptiveDelayedWriteRate()
+  double pressure_error_integral_ = 0;
+  double prev_pressure_error_ = 0;
+  uint64_t last_adapt_time_ = 0;
 };
 
 class WriteControllerToken {
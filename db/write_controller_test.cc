@@ -239,6 +239,55 @@ TEST_F(WriteControllerTest, CreditAccumulation) {
   ASSERT_EQ(10 SECS, controller.GetDelay(clock_.get(), 10 MB));
 }
 
+TEST_F(WriteControllerTest, AdaptiveDelayedWriteRate) {
+  WriteController controller(100 MBPS);
+  controller.set_adaptive(true);
+  ASSERT_EQ(0, controller.drain_rate());
+
+  // Concurrent compactions add up, and the rate is smoothed
+  controller.RecordDrainedBytes(20 MB, 1 SECS, 2);
+  ASSERT_EQ(40 MBPS, controller.drain_rate());
+  controller.RecordDrainedBytes(10 MB, 1 SECS, 1);
+  const double drain_rate = 31 MBPS;
+  ASSERT_NEAR(drain_rate, controller.drain_rate(), 1);
+
+  // At the target pressure, the write rate converges to the drain rate by
+  // bounded steps
+  std::unique_ptr<WriteControllerToken> token;
+  uint64_t prev_rate = controller.delayed_write_rate();
+  for (int i = 0; i < 3; i++) {
+    uint64_t rate = controller.AdaptiveDelayedWriteRate(clock_.get(), 0.25);
+    ASSERT_LT(rate, prev_rate);
+    ASSERT_GT(rate, prev_rate / 2);
+    token = controller.GetDelayToken(rate);
+    prev_rate = rate;
+    clock_->now_micros_ += 1 SECS;
+  }
+  ASSERT_NEAR(drain_rate, controller.delayed_write_rate(), 1 MBPS / 10);
+
+  // Persistent pressure near the stop slows down further and further
+  for (int i = 0; i < 10; i++) {
+    uint64_t rate = controller.AdaptiveDelayedWriteRate(clock_.get(), 1.0);
+    ASSERT_LE(rate, prev_rate);
+    token = controller.GetDelayToken(rate);
+    prev_rate = rate;
+    clock_->now_micros_ += 1 SECS;
+  }
+  ASSERT_LT(controller.delayed_write_rate(), drain_rate / 4);
+
+  // And the write rate goes back above the drain rate once the pressure is
+  // released, without exceeding the configured rate
+  for (int i = 0; i < 20; i++) {
+    uint64_t rate = controller.AdaptiveDelayedWriteRate(clock_.get(), 0);
+    ASSERT_GE(rate, prev_rate);
+    ASSERT_LE(rate, controller.max_delayed_write_rate());
+    token = controller.GetDelayToken(rate);
+    prev_rate = rate;
+    clock_->now_micros_ += 1 SECS;
+  }
+  ASSERT_GT(controller.delayed_write_rate(), drain_rate);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
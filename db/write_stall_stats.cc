@@ -139,6 +139,16 @@ const std::string& WriteStallStatsMapKeys::TotalDelays() {
   return kTotalDelays;
 }
 
+const std::string& WriteStallStatsMapKeys::DelayedWriteRate() {
+  static const std::string kDelayedWriteRate = "delayed-write-rate";
+  return kDelayedWriteRate;
+}
+
+const std::string& WriteStallStatsMapKeys::CompactionDrainRate() {
+  static const std::string kCompactionDrainRate = "compaction-drain-rate";
+  return kCompactionDrainRate;
+}
+
 const std::string&
 WriteStallStatsMapKeys::CFL0FileCountLimitDelaysWithOngoingCompaction() {
   static const std::string ret =
@@ -9,6 +9,7 @@
 #include <thread>
 
 #include "db/column_family.h"
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
@@ -27,6 +28,9 @@ WriteThread::WriteThread(const ImmutableDBOptions& db_options)
       max_write_batch_group_size_bytes(
           db_options.max_write_batch_group_size_bytes),
       newest_writer_(nullptr),
+      staged_writers_(db_options.enable_write_thread_per_core_queues
+                          ? new CoreLocalArray<StagedWriters>()
+                          : nullptr),
       newest_memtable_writer_(nullptr),
       last_sequence_(0),
       write_stall_dummy_(),
@@ -84,6 +88,7 @@ uint8_t WriteThread::AwaitState(Writer* w, uint8_t goal_mask,
   // This is below the fast path, so that the stat is zero when all writes are
   // from the same thread.
   PERF_TIMER_FOR_WAIT_GUARD(write_thread_wait_nanos);
+  OPERATION_SPAN_GUARD(WriteThreadWait);
 
   // If we're only going to end up waiting a short period of time,
   // it can be a lot more efficient to call std::this_thread::yield()
@@ -259,6 +264,44 @@ bool WriteThread::LinkOne(Writer* w, std::atomic<Writer*>* newest_writer) {
   }
 }
 
+bool WriteThread::LinkStaged(Writer* w) {
+  assert(staged_writers_ != nullptr);
+  assert(!w->no_slowdown);
+  assert(w->state == STATE_INIT);
+  StagedWriters* staged = staged_writers_->Access();
+  Writer* newest = staged->newest.load(std::memory_order_relaxed);
+  do {
+    w->link_older = newest;
+  } while (!staged->newest.compare_exchange_weak(newest, w));
+  if (newest != nullptr) {
+    // The first writer staged in this queue links us
+    return false;
+  }
+
+  // Everyone staged since w is linked in the same order as by LinkOne(),
+  // with w as the oldest.
+  newest = staged->newest.exchange(nullptr);
+  Writer* writers = newest_writer_.load(std::memory_order_relaxed);
+  while (true) {
+    // None of the staged writers has no_slowdown set, so all wait for a
+    // write stall to clear
+    if (writers == &write_stall_dummy_) {
+      MutexLock lock(&stall_mu_);
+      writers = newest_writer_.load(std::memory_order_relaxed);
+      if (writers == &write_stall_dummy_) {
+        TEST_SYNC_POINT_CALLBACK("WriteThread::WriteStall::Wait", w);
+        stall_cv_.Wait();
+        writers = newest_writer_.load(std::memory_order_relaxed);
+      }
+      continue;
+    }
+    w->link_older = writers;
+    if (newest_writer_.compare_exchange_weak(writers, newest)) {
+      return (writers == nullptr);
+    }
+  }
+}
+
 bool WriteThread::LinkGroup(WriteGroup& write_group,
                             std::atomic<Writer*>* newest_writer) {
   assert(newest_writer != nullptr);
@@ -402,7 +445,11 @@ void WriteThread::JoinBatchGroup(Writer* w) {
   TEST_SYNC_POINT_CALLBACK("WriteThread::JoinBatchGroup:Start", w);
   assert(w->batch != nullptr);
 
-  bool linked_as_leader = LinkOne(w, &newest_writer_);
+  // Writers with no_slowdown must not wait for a write stall on behalf of
+  // other staged writers
+  bool linked_as_leader = staged_writers_ != nullptr && !w->no_slowdown
+                              ? LinkStaged(w)
+                              : LinkOne(w, &newest_writer_);
 
   w->CheckWriteEnqueuedCallback();
 
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <type_traits>
 #include <vector>
@@ -26,6 +27,7 @@
 #include "rocksdb/write_batch.h"
 #include "util/aligned_storage.h"
 #include "util/autovector.h"
+#include "util/core_local.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -432,6 +434,16 @@ class WriteThread {
   // elements, adding can be done lock-free by anybody.
   std::atomic<Writer*> newest_writer_;
 
+  // Writers that joined on one core and are not linked into newest_writer_
+  // yet, newest first through link_older.
+  struct ALIGN_AS(CACHE_LINE_SIZE) StagedWriters {
+    std::atomic<Writer*> newest{nullptr};
+  };
+
+  // The staging queues of JoinBatchGroup(), or nullptr unless
+  // enable_write_thread_per_core_queues is set.
+  std::unique_ptr<CoreLocalArray<StagedWriters>> staged_writers_;
+
   // Points to the newest pending memtable writer. Used only when pipelined
   // write is enabled.
   std::atomic<Writer*> newest_memtable_writer_;
@@ -481,6 +493,13 @@ class WriteThread {
   // external locking.
   bool LinkOne(Writer* w, std::atomic<Writer*>* newest_writer);
 
+  // Stages w in the queue of the current core. The first writer staged in a
+  // queue links itself and the writers staged after it into newest_writer_
+  // at once, waiting for any write stall to end. Returns true iff w was
+  // linked directly into the leader position.
+  // REQUIRES: staged_writers_ != nullptr, !w->no_slowdown
+  bool LinkStaged(Writer* w);
+
   // Link write group into the newest_writer list as a whole, while keeping the
   // order of the writers unchanged. Return true if the group was linked
   // directly into the leader position.
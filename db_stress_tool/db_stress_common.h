@@ -162,6 +162,7 @@ DECLARE_bool(fifo_allow_compaction);
 DECLARE_bool(allow_concurrent_memtable_write);
 DECLARE_double(experimental_mempurge_threshold);
 DECLARE_bool(enable_write_thread_adaptive_yield);
+DECLARE_bool(enable_write_thread_per_core_queues);
 DECLARE_int32(reopen);
 DECLARE_double(bloom_bits);
 DECLARE_int32(bloom_before_level);
@@ -407,6 +408,7 @@ DECLARE_uint64(max_sequential_skip_in_iterations);
 DECLARE_bool(enable_sst_partitioner_factory);
 DECLARE_bool(enable_do_not_compress_roles);
 DECLARE_bool(block_align);
+DECLARE_bool(avoid_data_block_page_crossing);
 DECLARE_uint32(lowest_used_cache_tier);
 DECLARE_bool(enable_custom_split_merge);
 DECLARE_uint32(adm_policy);
@@ -418,6 +418,11 @@ DEFINE_bool(enable_write_thread_adaptive_yield,
             ROCKSDB_NAMESPACE::Options().enable_write_thread_adaptive_yield,
             "Use a yielding spin loop for brief writer thread waits.");
 
+DEFINE_bool(enable_write_thread_per_core_queues,
+            ROCKSDB_NAMESPACE::Options().enable_write_thread_per_core_queues,
+            "Stage joining writers in per-core queues before linking them "
+            "into the shared writer list.");
+
 // Options for StackableDB-based BlobDB
 DEFINE_bool(use_blob_db, false, "[Stacked BlobDB] Use BlobDB.");
 
@@ -1416,6 +1421,11 @@ DEFINE_bool(block_align,
             ROCKSDB_NAMESPACE::BlockBasedTableOptions().block_align,
             "BlockBasedTableOptions.block_align");
 
+DEFINE_bool(avoid_data_block_page_crossing,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .avoid_data_block_page_crossing,
+            "BlockBasedTableOptions.avoid_data_block_page_crossing");
+
 DEFINE_uint32(
     lowest_used_cache_tier,
     static_cast<uint32_t>(ROCKSDB_NAMESPACE::Options().lowest_used_cache_tier),
@@ -3359,6 +3359,9 @@ void StressTest::PrintEnv() const {
     case kRoundRobin:
       compaction_pri = "kRoundRobin";
       break;
+    case kHotnessAware:
+      compaction_pri = "kHotnessAware";
+      break;
   }
   fprintf(stdout, "Compaction Pri            : %s\n", compaction_pri);
   fprintf(stdout, "Background Purge          : %d\n",
@@ -4054,6 +4057,8 @@ void InitializeOptionsFromFlags(
       static_cast<BlockBasedTableOptions::IndexShorteningMode>(
           FLAGS_index_shortening);
   block_based_options.block_align = FLAGS_block_align;
+  block_based_options.avoid_data_block_page_crossing =
+      FLAGS_avoid_data_block_page_crossing;
   options.table_factory.reset(NewBlockBasedTableFactory(block_based_options));
   options.db_write_buffer_size = FLAGS_db_write_buffer_size;
   options.write_buffer_size = FLAGS_write_buffer_size;
@@ -4149,6 +4154,8 @@ void InitializeOptionsFromFlags(
   options.enable_pipelined_write = FLAGS_enable_pipelined_write;
   options.enable_write_thread_adaptive_yield =
       FLAGS_enable_write_thread_adaptive_yield;
+  options.enable_write_thread_per_core_queues =
+      FLAGS_enable_write_thread_per_core_queues;
   options.compaction_options_universal.size_ratio = FLAGS_universal_size_ratio;
   options.compaction_options_universal.min_merge_width =
       FLAGS_universal_min_merge_width;
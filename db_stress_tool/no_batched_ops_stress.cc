@@ -2366,12 +2366,15 @@ class NonBatchedOpsStressTest : public StressTest {
       ingest_options.verify_checksums_readahead_size =
           thread->rand.OneInOpt(2) ? 1024 * 1024 : 0;
       ingest_options.fill_cache = thread->rand.OneInOpt(4);
+      ingest_options.max_prepare_threads = thread->rand.OneInOpt(2) ? 4 : 1;
       ingest_options_oss << "move_files: " << ingest_options.move_files
                          << ", verify_checksums_before_ingest: "
                          << ingest_options.verify_checksums_before_ingest
                          << ", verify_checksums_readahead_size: "
                          << ingest_options.verify_checksums_readahead_size
                          << ", fill_cache: " << ingest_options.fill_cache
+                         << ", max_prepare_threads: "
+                         << ingest_options.max_prepare_threads
                          << ", test_standalone_range_deletion: "
                          << test_standalone_range_deletion;
       s = db_->IngestExternalFile(column_families_[column_family],
@@ -1158,6 +1158,8 @@ EnvOptions Env::OptimizeForCompactionTableWrite(
   EnvOptions optimized_env_options(env_options);
   optimized_env_options.use_direct_writes =
       db_options.use_direct_io_for_flush_and_compaction;
+  optimized_env_options.use_background_writes =
+      db_options.background_writes_for_flush_and_compaction;
   return optimized_env_options;
 }
 
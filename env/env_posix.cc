@@ -395,6 +395,19 @@ class PosixEnv : public CompositeEnv {
     return Status::OK();
   }
 
+  Status SetThreadPoolCpuAffinity(Priority pool,
+                                  const std::vector<int>& cpus) override {
+    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+#ifdef OS_LINUX
+    thread_pools_[pool].SetCpuAffinity(cpus);
+    return Status::OK();
+#else
+    (void)pool;
+    (void)cpus;
+    return Status::NotSupported("CPU affinity is only supported on Linux");
+#endif
+  }
+
  private:
   friend Env* Env::Default();
   // Constructs the default Env, a singleton
@@ -14,6 +14,8 @@
 #if defined(ROCKSDB_IOURING_PRESENT)
 #include <liburing.h>
 #include <sys/uio.h>
+
+#include "env/io_posix.h"
 #endif
 
 #include <sys/types.h>
@@ -26,6 +28,7 @@
 #ifdef OS_LINUX
 #include <fcntl.h>
 #include <linux/fs.h>
+#include <sched.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -89,6 +92,11 @@ struct Deleter {
 
 extern "C" bool RocksDbIOUringEnable() { return true; }
 
+static unsigned int io_uring_sq_poll_idle_ms = 0;
+extern "C" unsigned int RocksDbIOUringSqPollIdleMillis() {
+  return io_uring_sq_poll_idle_ms;
+}
+
 std::unique_ptr<char, Deleter> NewAligned(const size_t size, const char ch) {
   char* ptr = nullptr;
 #ifdef OS_WIN
@@ -310,6 +318,45 @@ TEST_F(EnvPosixTest, LowerThreadPoolCpuPriority) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
 }
+
+TEST_F(EnvPosixTest, SetThreadPoolCpuAffinity) {
+  cpu_set_t allowed;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+  int first_cpu = 0;
+  while (!CPU_ISSET(first_cpu, &allowed)) {
+    first_cpu++;
+  }
+
+  env_->SetBackgroundThreads(1, Env::BOTTOM);
+  auto GetPoolCpus = [&]() {
+    std::atomic<bool> done(false);
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    std::function<void()> task = [&]() {
+      EXPECT_EQ(0, sched_getaffinity(0, sizeof(cpus), &cpus));
+      done.store(true);
+    };
+    env_->Schedule(
+        [](void* arg) { (*static_cast<std::function<void()>*>(arg))(); },
+        &task, Env::Priority::BOTTOM);
+    for (int i = 0; i < kDelayMicros && !done.load(); i++) {
+      Env::Default()->SleepForMicroseconds(1);
+    }
+    EXPECT_TRUE(done.load());
+    return cpus;
+  };
+
+  ASSERT_OK(env_->SetThreadPoolCpuAffinity(Env::Priority::BOTTOM,
+                                           {first_cpu}));
+  cpu_set_t cpus = GetPoolCpus();
+  ASSERT_EQ(1, CPU_COUNT(&cpus));
+  ASSERT_TRUE(CPU_ISSET(first_cpu, &cpus));
+
+  // Back to all CPUs
+  ASSERT_OK(env_->SetThreadPoolCpuAffinity(Env::Priority::BOTTOM, {}));
+  cpus = GetPoolCpus();
+  ASSERT_TRUE(CPU_EQUAL(&allowed, &cpus));
+}
 #endif
 
 TEST_F(EnvPosixTest, MemoryMappedFileBuffer) {
@@ -1732,6 +1779,136 @@ TEST_F(EnvPosixTest, MultiReadIOUringError2) {
   SyncPoint::GetInstance()->DisableProcessing();
   SyncPoint::GetInstance()->ClearAllCallBacks();
 }
+
+TEST_F(EnvPosixTest, MultiReadSqPollIOUring) {
+  EnvOptions soptions;
+  soptions.use_direct_reads = soptions.use_direct_writes = false;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  std::vector<std::string> scratches;
+  std::vector<ReadRequest> reqs;
+  GenerateFilesAndRequest(env_, fname, &reqs, &scratches);
+  std::string expected_data;
+  ASSERT_OK(ReadFileToString(env_, fname, &expected_data));
+  std::unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+
+  io_uring_sq_poll_idle_ms = 10;
+  // The io_uring instance of a new thread attaches to the SQ polling thread,
+  // falling back to a plain one where the kernel does not allow it
+  Status s;
+  port::Thread reader(
+      [&]() { s = file->MultiRead(reqs.data(), reqs.size()); });
+  reader.join();
+  io_uring_sq_poll_idle_ms = 0;
+
+  ASSERT_OK(s);
+  for (const auto& req : reqs) {
+    ASSERT_OK(req.status);
+    ASSERT_EQ(expected_data.substr(req.offset, req.len),
+              req.result.ToString());
+  }
+}
+
+TEST_F(EnvPosixTest, ReadAsyncIOUringTimeout) {
+  EnvOptions soptions;
+  soptions.use_direct_reads = soptions.use_direct_writes = false;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  std::vector<std::string> scratches;
+  std::vector<ReadRequest> reqs;
+  GenerateFilesAndRequest(env_, fname, &reqs, &scratches);
+  std::string expected_data;
+  ASSERT_OK(ReadFileToString(env_, fname, &expected_data));
+  const std::shared_ptr<FileSystem>& fs = env_->GetFileSystem();
+  std::unique_ptr<FSRandomAccessFile> file;
+  ASSERT_OK(fs->NewRandomAccessFile(fname, FileOptions(soptions), &file,
+                                    nullptr));
+
+  FSReadRequest req;
+  req.offset = reqs[0].offset;
+  req.len = reqs[0].len;
+  req.scratch = reqs[0].scratch;
+  IOOptions opts;
+  opts.timeout = std::chrono::seconds(10);
+  auto callback = [](FSReadRequest& r, void* cb_arg) {
+    FSReadRequest* out = static_cast<FSReadRequest*>(cb_arg);
+    out->status = r.status;
+    out->result = r.result;
+  };
+  FSReadRequest result;
+  void* io_handle = nullptr;
+  IOHandleDeleter del_fn;
+  IOStatus s = file->ReadAsync(req, opts, callback, &result, &io_handle,
+                               &del_fn, nullptr);
+  if (s.IsNotSupported()) {
+    ROCKSDB_GTEST_SKIP("io_uring not supported");
+    return;
+  }
+  ASSERT_OK(s);
+  std::vector<void*> io_handles{io_handle};
+  ASSERT_OK(fs->Poll(io_handles, 1));
+  del_fn(io_handle);
+  ASSERT_OK(result.status);
+  ASSERT_EQ(expected_data.substr(req.offset, req.len),
+            result.result.ToString());
+
+  // A read with a timeout below the recent latency of the io_uring of the
+  // thread is rejected without being submitted, and the latency decays.
+  IOUringReadLatencyMicros() = 1000000;
+  opts.timeout = std::chrono::microseconds(1000);
+  io_handle = nullptr;
+  s = file->ReadAsync(req, opts, callback, &result, &io_handle, &del_fn,
+                      nullptr);
+  ASSERT_TRUE(s.IsTimedOut());
+  ASSERT_EQ(nullptr, io_handle);
+  ASSERT_LT(IOUringReadLatencyMicros(), 1000000);
+  IOUringReadLatencyMicros() = 0;
+}
+
+TEST_F(EnvPosixTest, IOUringWritableFile) {
+  EnvOptions soptions;
+  soptions.use_io_uring_writes = true;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+  SetupSyncPointsToMockDirectIO();
+
+  Random rnd(301);
+  std::string expected;
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    // Unaligned appends, some while the previous write is in flight
+    for (int i = 0; i < 100; i++) {
+      std::string data = rnd.RandomString(static_cast<int>(rnd.Uniform(9000)));
+      ASSERT_OK(wfile->Append(data));
+      expected += data;
+      if (i % 3 == 0) {
+        ASSERT_OK(wfile->Flush());
+      }
+      if (i % 7 == 0) {
+        ASSERT_OK(wfile->Sync());
+      }
+      ASSERT_EQ(expected.size(), wfile->GetFileSize());
+    }
+    // Appends continue from the partial last sector read back
+    expected.resize(expected.size() - 1234);
+    ASSERT_OK(wfile->Truncate(expected.size()));
+    std::string data = rnd.RandomString(5000);
+    ASSERT_OK(wfile->Append(data));
+    expected += data;
+    ASSERT_OK(wfile->Fsync());
+    ASSERT_OK(wfile->Append(data));
+    expected += data;
+    ASSERT_OK(wfile->Close());
+  }
+
+  std::string actual;
+  ASSERT_OK(ReadFileToString(env_, fname, &actual));
+  ASSERT_EQ(expected, actual);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
 #endif  // ROCKSDB_IOURING_PRESENT
 
 // Only works in linux platforms
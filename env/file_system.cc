@@ -160,6 +160,8 @@ FileOptions FileSystem::OptimizeForCompactionTableWrite(
   FileOptions optimized_file_options(file_options);
   optimized_file_options.use_direct_writes =
       db_options.use_direct_io_for_flush_and_compaction;
+  optimized_file_options.use_background_writes =
+      db_options.background_writes_for_flush_and_compaction;
   return optimized_file_options;
 }
 
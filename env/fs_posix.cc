@@ -285,8 +285,25 @@ class PosixFileSystem : public FileSystem {
     IOStatus s;
     int fd = -1;
     int flags = (reopen) ? (O_CREAT | O_APPEND) : (O_CREAT | O_TRUNC);
-    // Direct IO mode with O_DIRECT flag or F_NOCAHCE (MAC OSX)
-    if (options.use_direct_writes && !options.use_mmap_writes) {
+    bool use_io_uring_writes = false;
+#if defined(ROCKSDB_IOURING_PRESENT)
+    // The staging buffers start empty, so only new files are supported
+    struct io_uring* iu = nullptr;
+    if (options.use_io_uring_writes && !options.use_mmap_writes && !reopen &&
+        IsIOUringEnabled()) {
+      iu = CreateIOUring();
+      use_io_uring_writes = iu != nullptr;
+    }
+#endif
+    if (use_io_uring_writes) {
+      // Truncate() reads the partial last sector back
+      flags |= O_RDWR;
+#if !defined(OS_MACOSX) && !defined(OS_OPENBSD) && !defined(OS_SOLARIS)
+      flags |= O_DIRECT;
+#endif
+      TEST_SYNC_POINT_CALLBACK("NewWritableFile:O_DIRECT", &flags);
+    } else if (options.use_direct_writes && !options.use_mmap_writes) {
+      // Direct IO mode with O_DIRECT flag or F_NOCAHCE (MAC OSX)
       // Note: we should avoid O_APPEND here due to ta the following bug:
       // POSIX requires that opening a file with the O_APPEND flag should
       // have no affect on the location at which pwrite() writes data.
@@ -315,6 +332,12 @@ class PosixFileSystem : public FileSystem {
 
     if (fd < 0) {
       s = IOError("While open a file for appending", fname, errno);
+#if defined(ROCKSDB_IOURING_PRESENT)
+      if (iu != nullptr) {
+        io_uring_queue_exit(iu);
+        delete iu;
+      }
+#endif
       return s;
     }
     SetFD_CLOEXEC(fd, &options);
@@ -333,6 +356,11 @@ class PosixFileSystem : public FileSystem {
     if (options.use_mmap_writes && !forceMmapOff_) {
       result->reset(
           new PosixMmapFile(fname, fd, page_size_, options, initial_file_size));
+#if defined(ROCKSDB_IOURING_PRESENT)
+    } else if (use_io_uring_writes) {
+      result->reset(new PosixIOUringWritableFile(
+          fname, fd, GetLogicalBlockSize(fname, fd), options, iu));
+#endif
     } else if (options.use_direct_writes && !options.use_mmap_writes) {
 #ifdef OS_MACOSX
       if (fcntl(fd, F_NOCACHE, 1) == -1) {
@@ -923,6 +951,7 @@ class PosixFileSystem : public FileSystem {
     FileOptions optimized = file_options;
     optimized.use_mmap_writes = false;
     optimized.use_direct_writes = false;
+    optimized.use_io_uring_writes = db_options.use_direct_io_for_wal;
     optimized.bytes_per_sync = db_options.wal_bytes_per_sync;
     // TODO(icanadi) it's faster if fallocate_with_keep_size is false, but it
     // breaks TransactionLogIteratorStallAtLastRecord unit test. Fix the unit
@@ -1067,6 +1096,10 @@ class PosixFileSystem : public FileSystem {
   // equal to atleast min_completions.
   // 2. Currently in case of direct_io, Read API is called because of which call
   // to Poll API fails as it expects IOHandle to be populated.
+  //
+  // Requests submitted with an IOOptions::timeout are cancelled once past
+  // their deadline, completing with Status::TimedOut(), which Poll then
+  // returns.
   IOStatus Poll(std::vector<void*>& io_handles,
                 size_t /*min_completions*/) override {
 #if defined(ROCKSDB_IOURING_PRESENT)
@@ -1081,16 +1114,50 @@ class PosixFileSystem : public FileSystem {
       return IOStatus::NotSupported("Poll");
     }
 
+    IOStatus s;
     for (size_t i = 0; i < io_handles.size(); i++) {
-      // The request has been completed in earlier runs.
-      if ((static_cast<Posix_IOHandle*>(io_handles[i]))->is_finished) {
-        continue;
-      }
-      // Loop until IO for io_handles[i] is completed.
-      while (true) {
+      Posix_IOHandle* handle = static_cast<Posix_IOHandle*>(io_handles[i]);
+      // Loop until IO for io_handles[i] is completed. It might have been
+      // completed in earlier runs.
+      while (!handle->is_finished) {
         // io_uring_wait_cqe.
         struct io_uring_cqe* cqe = nullptr;
-        ssize_t ret = io_uring_wait_cqe(iu, &cqe);
+        ssize_t ret;
+        if (handle->deadline_micros == 0) {
+          ret = io_uring_wait_cqe(iu, &cqe);
+        } else {
+          const uint64_t now = IOUringNowMicros();
+          if (now >= handle->deadline_micros) {
+            ret = -ETIME;
+          } else {
+            const uint64_t wait_micros = handle->deadline_micros - now;
+            struct __kernel_timespec ts;
+            ts.tv_sec = static_cast<int64_t>(wait_micros / 1000000);
+            ts.tv_nsec = static_cast<long long>(wait_micros % 1000000 * 1000);
+            ret = io_uring_wait_cqe_timeout(iu, &cqe, &ts);
+          }
+        }
+        if (ret == -ETIME) {
+          // Free the queue slots of all the requests past their deadline
+          // rather than let them run to completion.
+          const uint64_t now = IOUringNowMicros();
+          std::vector<void*> expired_handles;
+          for (void* io_handle : io_handles) {
+            Posix_IOHandle* h = static_cast<Posix_IOHandle*>(io_handle);
+            if (!h->is_finished && h->deadline_micros != 0 &&
+                (h == handle || h->deadline_micros <= now)) {
+              expired_handles.push_back(io_handle);
+            }
+          }
+          IOStatus cancel_s = CancelAsyncReads(
+              iu, expired_handles,
+              IOStatus::TimedOut("Async read past its deadline"));
+          if (!cancel_s.ok()) {
+            return cancel_s;
+          }
+          s = IOStatus::TimedOut("Async read past its deadline");
+          continue;
+        }
         if (ret) {
           // abort as it shouldn't be in indeterminate state and there is no
           // good way currently to handle this error.
@@ -1105,35 +1172,10 @@ class PosixFileSystem : public FileSystem {
         if (posix_handle->iu != iu) {
           return IOStatus::IOError("");
         }
-        // Reset cqe data to catch any stray reuse of it
-        static_cast<struct io_uring_cqe*>(cqe)->user_data = 0xd5d5d5d5d5d5d5d5;
-
-        FSReadRequest req;
-        req.scratch = posix_handle->scratch;
-        req.offset = posix_handle->offset;
-        req.len = posix_handle->len;
-
-        size_t finished_len = 0;
-        size_t bytes_read = 0;
-        bool read_again = false;
-        UpdateResult(cqe, "", req.len, posix_handle->iov.iov_len,
-                     true /*async_read*/, posix_handle->use_direct_io,
-                     posix_handle->alignment, finished_len, &req, bytes_read,
-                     read_again);
-        posix_handle->is_finished = true;
-        io_uring_cqe_seen(iu, cqe);
-        posix_handle->cb(req, posix_handle->cb_arg);
-
-        (void)finished_len;
-        (void)bytes_read;
-        (void)read_again;
-
-        if (static_cast<Posix_IOHandle*>(io_handles[i]) == posix_handle) {
-          break;
-        }
+        CompleteAsyncRead(iu, cqe, posix_handle);
       }
     }
-    return IOStatus::OK();
+    return s;
 #else
     (void)io_handles;
     return IOStatus::NotSupported("Poll");
@@ -1154,7 +1196,32 @@ class PosixFileSystem : public FileSystem {
     if (iu == nullptr) {
       return IOStatus::OK();
     }
+    return CancelAsyncReads(iu, io_handles, IOStatus::Aborted());
+#else
+    // If Poll is not supported then it didn't submit any request and it should
+    // return OK.
+    (void)io_handles;
+    return IOStatus::OK();
+#endif
+  }
+
+  void SupportedOps(int64_t& supported_ops) override {
+    supported_ops = 0;
+#if defined(ROCKSDB_IOURING_PRESENT)
+    if (IsIOUringEnabled()) {
+      // Underlying FS supports async_io
+      supported_ops |= (1 << FSSupportedOps::kAsyncIO);
+    }
+#endif
+  }
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // Cancels the unfinished requests of `io_handles` and waits for them,
+  // completing each one with `status`. The requests of other handles that
+  // complete meanwhile are completed as usual.
+  IOStatus CancelAsyncReads(struct io_uring* iu,
+                            std::vector<void*>& io_handles,
+                            const IOStatus& status) {
     for (size_t i = 0; i < io_handles.size(); i++) {
       Posix_IOHandle* posix_handle =
           static_cast<Posix_IOHandle*>(io_handles[i]);
@@ -1175,6 +1242,7 @@ class PosixFileSystem : public FileSystem {
       io_uring_prep_cancel(sqe, &posix_handle->iov, 0);
       // Sets sqe->user_data to posix_handle.
       io_uring_sqe_set_data(sqe, posix_handle);
+      posix_handle->cancelling = true;
 
       // submit the request.
       ssize_t ret = io_uring_submit(iu);
@@ -1187,11 +1255,7 @@ class PosixFileSystem : public FileSystem {
 
     // After submitting the requests, wait for the requests.
     for (size_t i = 0; i < io_handles.size(); i++) {
-      if ((static_cast<Posix_IOHandle*>(io_handles[i]))->is_finished) {
-        continue;
-      }
-
-      while (true) {
+      while (!static_cast<Posix_IOHandle*>(io_handles[i])->is_finished) {
         struct io_uring_cqe* cqe = nullptr;
         ssize_t ret = io_uring_wait_cqe(iu, &cqe);
         if (ret) {
@@ -1208,6 +1272,10 @@ class PosixFileSystem : public FileSystem {
         if (posix_handle->iu != iu) {
           return IOStatus::IOError("");
         }
+        if (!posix_handle->cancelling) {
+          CompleteAsyncRead(iu, cqe, posix_handle);
+          continue;
+        }
         posix_handle->req_count++;
 
         // Reset cqe data to catch any stray reuse of it
@@ -1225,37 +1293,17 @@ class PosixFileSystem : public FileSystem {
         //
         // Every handle has to wait for 2 requests completion: original one and
         // the cancel request which is tracked by PosixHandle::req_count.
-        if (posix_handle->req_count == 2 &&
-            static_cast<Posix_IOHandle*>(io_handles[i]) == posix_handle) {
+        if (posix_handle->req_count == 2) {
           posix_handle->is_finished = true;
           FSReadRequest req;
-          req.status = IOStatus::Aborted();
+          req.status = status;
           posix_handle->cb(req, posix_handle->cb_arg);
-
-          break;
         }
       }
     }
     return IOStatus::OK();
-#else
-    // If Poll is not supported then it didn't submit any request and it should
-    // return OK.
-    (void)io_handles;
-    return IOStatus::OK();
-#endif
   }
 
-  void SupportedOps(int64_t& supported_ops) override {
-    supported_ops = 0;
-#if defined(ROCKSDB_IOURING_PRESENT)
-    if (IsIOUringEnabled()) {
-      // Underlying FS supports async_io
-      supported_ops |= (1 << FSSupportedOps::kAsyncIO);
-    }
-#endif
-  }
-
-#if defined(ROCKSDB_IOURING_PRESENT)
   // io_uring instance
   std::unique_ptr<ThreadLocalPtr> thread_local_io_urings_;
 #endif
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <climits>
 #if defined(OS_LINUX)
 #include <linux/fs.h>
 #ifndef FALLOC_FL_KEEP_SIZE
@@ -24,10 +25,12 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 #if defined(OS_LINUX) || defined(OS_ANDROID)
 #include <sys/statfs.h>
 #include <sys/sysmacros.h>
@@ -133,6 +136,37 @@ bool PosixWrite(int fd, const char* buf, size_t nbyte) {
   return true;
 }
 
+bool PosixWriteV(int fd, const Slice* data, size_t n) {
+  std::vector<struct iovec> iov(n);
+  for (size_t i = 0; i < n; i++) {
+    iov[i].iov_base = const_cast<char*>(data[i].data());
+    iov[i].iov_len = data[i].size();
+  }
+
+  size_t first = 0;
+  while (first < n) {
+    int count = static_cast<int>(std::min(n - first, size_t{IOV_MAX}));
+    ssize_t done = writev(fd, &iov[first], count);
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    // Skip the slices written in full, and the written part of the next one
+    size_t written = static_cast<size_t>(done);
+    while (first < n && written >= iov[first].iov_len) {
+      written -= iov[first].iov_len;
+      first++;
+    }
+    if (written > 0) {
+      iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+      iov[first].iov_len -= written;
+    }
+  }
+  return true;
+}
+
 bool PosixPositionedWrite(int fd, const char* buf, size_t nbyte, off_t offset) {
   const size_t kLimit1Gb = 1UL << 30;
 
@@ -579,6 +613,13 @@ size_t PosixHelper::GetQueueSysfsFileValueOfFd(
   return default_return_value;
 }
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+uint64_t& IOUringReadLatencyMicros() {
+  static thread_local uint64_t latency_micros = 0;
+  return latency_micros;
+}
+#endif
+
 /*
  * PosixRandomAccessFile
  *
@@ -694,8 +735,25 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
     req_wraps.emplace_back(&reqs[i]);
   }
 
+  // Batches are not submitted past the deadline of the read, if any
+  const uint64_t timeout_micros =
+      static_cast<uint64_t>(options.timeout.count());
+  const uint64_t deadline_micros =
+      timeout_micros > 0 ? IOUringNowMicros() + timeout_micros : 0;
+
   size_t reqs_off = 0;
   while (num_reqs > reqs_off || !incomplete_rq_list.empty()) {
+    if (deadline_micros != 0 && reqs_off > 0 &&
+        IOUringNowMicros() >= deadline_micros) {
+      for (WrappedReadRequest* req_wrap : incomplete_rq_list) {
+        req_wrap->req->status = IOStatus::TimedOut("MultiRead past deadline");
+      }
+      for (size_t i = reqs_off; i < num_reqs; i++) {
+        reqs[i].result = Slice(reqs[i].scratch, 0);
+        reqs[i].status = IOStatus::TimedOut("MultiRead past deadline");
+      }
+      break;
+    }
     size_t this_reqs = (num_reqs - reqs_off) + incomplete_rq_list.size();
 
     // If requests exceed depth, split it into batches
@@ -900,7 +958,7 @@ IOStatus PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 }
 
 IOStatus PosixRandomAccessFile::ReadAsync(
-    FSReadRequest& req, const IOOptions& /*opts*/,
+    FSReadRequest& req, const IOOptions& opts,
     std::function<void(FSReadRequest&, void*)> cb, void* cb_arg,
     void** io_handle, IOHandleDeleter* del_fn, IODebugContext* /*dbg*/) {
   if (use_direct_io()) {
@@ -927,6 +985,16 @@ IOStatus PosixRandomAccessFile::ReadAsync(
     return IOStatus::NotSupported("ReadAsync");
   }
 
+  // Shed the read if the reads of this io_uring lately took longer than its
+  // timeout. Every rejected read decays the average, so that reads are tried
+  // again once the queue had time to drain.
+  const uint64_t timeout_micros = static_cast<uint64_t>(opts.timeout.count());
+  uint64_t& avg_latency = IOUringReadLatencyMicros();
+  if (timeout_micros > 0 && avg_latency > timeout_micros) {
+    avg_latency -= avg_latency / 8;
+    return IOStatus::TimedOut("io_uring read latency exceeds the timeout");
+  }
+
   // Allocate io_handle.
   IOHandleDeleter deletefn = [](void* args) -> void {
     delete (static_cast<Posix_IOHandle*>(args));
@@ -939,6 +1007,11 @@ IOStatus PosixRandomAccessFile::ReadAsync(
                          use_direct_io(), GetRequiredBufferAlignment());
   posix_handle->iov.iov_base = req.scratch;
   posix_handle->iov.iov_len = req.len;
+  posix_handle->submit_micros = IOUringNowMicros();
+  if (timeout_micros > 0) {
+    posix_handle->deadline_micros =
+        posix_handle->submit_micros + timeout_micros;
+  }
 
   *io_handle = static_cast<void*>(posix_handle);
   *del_fn = deletefn;
@@ -963,6 +1036,7 @@ IOStatus PosixRandomAccessFile::ReadAsync(
   return IOStatus::OK();
 #else
   (void)req;
+  (void)opts;
   (void)cb;
   (void)cb_arg;
   (void)io_handle;
@@ -1360,6 +1434,22 @@ IOStatus PosixWritableFile::Append(const Slice& data, const IOOptions& /*opts*/,
   return IOStatus::OK();
 }
 
+IOStatus PosixWritableFile::AppendV(const Slice* data, size_t n,
+                                    const IOOptions& opts,
+                                    IODebugContext* dbg) {
+  if (use_direct_io()) {
+    // Every slice would have to be aligned
+    return FSWritableFile::AppendV(data, n, opts, dbg);
+  }
+  if (!PosixWriteV(fd_, data, n)) {
+    return IOError("While appending to file", filename_, errno);
+  }
+  for (size_t i = 0; i < n; i++) {
+    filesize_ += data[i].size();
+  }
+  return IOStatus::OK();
+}
+
 IOStatus PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset,
                                              const IOOptions& /*opts*/,
                                              IODebugContext* /*dbg*/) {
@@ -1581,6 +1671,247 @@ size_t PosixWritableFile::GetUniqueId(char* id, size_t max_size) const {
 }
 #endif
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+/*
+ * PosixIOUringWritableFile
+ *
+ * Use io_uring to write data to a file opened with O_DIRECT.
+ */
+PosixIOUringWritableFile::PosixIOUringWritableFile(const std::string& fname,
+                                                   int fd,
+                                                   size_t logical_block_size,
+                                                   const EnvOptions& options,
+                                                   struct io_uring* iu)
+    : PosixWritableFile(fname, fd, logical_block_size, options,
+                        /*initial_file_size=*/0),
+      iu_(iu) {
+  assert(iu_ != nullptr);
+  for (auto& buf : buffers_) {
+    buf.Alignment(logical_sector_size_);
+    buf.AllocateNewBuffer(
+        std::max(options.writable_file_max_buffer_size, logical_sector_size_));
+  }
+}
+
+PosixIOUringWritableFile::~PosixIOUringWritableFile() {
+  if (fd_ >= 0) {
+    IOStatus s = PosixIOUringWritableFile::Close(IOOptions(), nullptr);
+    s.PermitUncheckedError();
+  }
+  io_uring_queue_exit(iu_);
+  delete iu_;
+}
+
+IOStatus PosixIOUringWritableFile::Append(const Slice& data,
+                                          const IOOptions& /*opts*/,
+                                          IODebugContext* /*dbg*/) {
+  MutexLock lock(&mu_);
+  if (!error_.ok()) {
+    return error_;
+  }
+  AlignedBuffer& buf = buffers_[cur_];
+  const size_t needed = buf.CurrentSize() + data.size();
+  if (needed > buf.Capacity()) {
+    buf.AllocateNewBuffer(std::max(needed, 2 * buf.Capacity()),
+                          /*copy_data=*/true);
+  }
+  buf.Append(data.data(), data.size());
+  filesize_ += data.size();
+  return IOStatus::OK();
+}
+
+IOStatus PosixIOUringWritableFile::PositionedAppend(const Slice& /*data*/,
+                                                    uint64_t /*offset*/,
+                                                    const IOOptions& /*opts*/,
+                                                    IODebugContext* /*dbg*/) {
+  return IOStatus::NotSupported("PositionedAppend with io_uring writes");
+}
+
+void PosixIOUringWritableFile::QueueStagedWrite(unsigned char sqe_flags) {
+  assert(inflight_ == 0);
+  assert(queued_size_ < filesize_);
+  AlignedBuffer& buf = buffers_[cur_];
+  AlignedBuffer& next = buffers_[1 - cur_];
+  const size_t tail_offset =
+      TruncateToPageBoundary(logical_sector_size_, buf.CurrentSize());
+  next.Clear();
+  next.Append(buf.BufferStart() + tail_offset,
+              buf.CurrentSize() - tail_offset);
+  buf.PadToAlignmentWith(0);
+
+  iov_.iov_base = buf.BufferStart();
+  iov_.iov_len = buf.CurrentSize();
+  struct io_uring_sqe* sqe = io_uring_get_sqe(iu_);
+  assert(sqe != nullptr);
+  io_uring_prep_writev(sqe, fd_, &iov_, /*nr_vecs=*/1, buf_offset_);
+  // Non-null user data tells the write from the sync
+  io_uring_sqe_set_data(sqe, &iov_);
+  io_uring_sqe_set_flags(sqe, sqe_flags);
+  inflight_++;
+
+  buf_offset_ += tail_offset;
+  queued_size_ = filesize_;
+  cur_ = 1 - cur_;
+}
+
+IOStatus PosixIOUringWritableFile::Submit(unsigned int wait_nr) {
+  int ret;
+  do {
+    ret = io_uring_submit_and_wait(iu_, wait_nr);
+  } while (ret == -EINTR);
+  if (ret < 0) {
+    error_ = IOError("While io_uring_submit_and_wait", filename_, -ret);
+  }
+  return error_;
+}
+
+IOStatus PosixIOUringWritableFile::WaitForInflight() {
+  while (inflight_ > 0 && error_.ok()) {
+    struct io_uring_cqe* cqe = nullptr;
+    int ret = io_uring_wait_cqe(iu_, &cqe);
+    if (ret == -EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      error_ = IOError("While io_uring_wait_cqe", filename_, -ret);
+      break;
+    }
+    const bool is_write = io_uring_cqe_get_data(cqe) != nullptr;
+    const int res = cqe->res;
+    io_uring_cqe_seen(iu_, cqe);
+    inflight_--;
+    // The sync linked to a failed write is canceled; report the write
+    if (res < 0) {
+      error_ = IOError(
+          is_write ? "While io_uring write" : "While io_uring sync", filename_,
+          -res);
+    } else if (is_write && static_cast<size_t>(res) != iov_.iov_len) {
+      error_ = IOStatus::IOError(IOErrorMsg(
+          "Short io_uring write of " + std::to_string(res) + " bytes out of " +
+              std::to_string(iov_.iov_len),
+          filename_));
+    }
+  }
+  return error_;
+}
+
+IOStatus PosixIOUringWritableFile::SubmitSync(bool datasync) {
+  // A write submitted earlier just has to complete before the sync starts
+  unsigned char sync_flags = inflight_ > 0 ? IOSQE_IO_DRAIN : 0;
+  if (queued_size_ < filesize_) {
+    IOStatus s = WaitForInflight();
+    if (!s.ok()) {
+      return s;
+    }
+    QueueStagedWrite(IOSQE_IO_LINK);
+    sync_flags = 0;
+  }
+  struct io_uring_sqe* sqe = io_uring_get_sqe(iu_);
+  assert(sqe != nullptr);
+  io_uring_prep_fsync(sqe, fd_, datasync ? IORING_FSYNC_DATASYNC : 0);
+  io_uring_sqe_set_data(sqe, nullptr);
+  io_uring_sqe_set_flags(sqe, sync_flags);
+  inflight_++;
+  IOStatus s = Submit(inflight_);
+  if (!s.ok()) {
+    return s;
+  }
+  return WaitForInflight();
+}
+
+IOStatus PosixIOUringWritableFile::WriteStaged() {
+  IOStatus s = WaitForInflight();
+  if (s.ok() && queued_size_ < filesize_) {
+    QueueStagedWrite(/*sqe_flags=*/0);
+    s = Submit(inflight_);
+    if (s.ok()) {
+      s = WaitForInflight();
+    }
+  }
+  return s;
+}
+
+// Submit the staged data to the device, without waiting for it
+IOStatus PosixIOUringWritableFile::Flush(const IOOptions& /*opts*/,
+                                         IODebugContext* /*dbg*/) {
+  MutexLock lock(&mu_);
+  if (!error_.ok() || queued_size_ == filesize_) {
+    return error_;
+  }
+  // The write in flight covers the last sector again, and its buffer is the
+  // one that the next write continues in
+  IOStatus s = WaitForInflight();
+  if (!s.ok()) {
+    return s;
+  }
+  QueueStagedWrite(/*sqe_flags=*/0);
+  return Submit(/*wait_nr=*/0);
+}
+
+IOStatus PosixIOUringWritableFile::Sync(const IOOptions& /*opts*/,
+                                        IODebugContext* /*dbg*/) {
+  MutexLock lock(&mu_);
+  if (!error_.ok()) {
+    return error_;
+  }
+  return SubmitSync(/*datasync=*/true);
+}
+
+IOStatus PosixIOUringWritableFile::Fsync(const IOOptions& /*opts*/,
+                                         IODebugContext* /*dbg*/) {
+  MutexLock lock(&mu_);
+  if (!error_.ok()) {
+    return error_;
+  }
+  return SubmitSync(/*datasync=*/false);
+}
+
+IOStatus PosixIOUringWritableFile::Truncate(uint64_t size,
+                                            const IOOptions& opts,
+                                            IODebugContext* dbg) {
+  MutexLock lock(&mu_);
+  IOStatus s = WriteStaged();
+  if (!s.ok()) {
+    return s;
+  }
+  // Read back the partial last sector, as the next write rewrites it
+  AlignedBuffer& buf = buffers_[cur_];
+  const uint64_t tail_start = TruncateToPageBoundary(
+      logical_sector_size_, static_cast<size_t>(size));
+  const size_t tail_size = static_cast<size_t>(size - tail_start);
+  buf.Clear();
+  if (tail_size > 0) {
+    ssize_t r;
+    do {
+      r = pread(fd_, buf.BufferStart(), logical_sector_size_,
+                static_cast<off_t>(tail_start));
+    } while (r < 0 && errno == EINTR);
+    if (r < static_cast<ssize_t>(tail_size)) {
+      return IOError("While pread last sector before offset " +
+                         std::to_string(size),
+                     filename_, r < 0 ? errno : EIO);
+    }
+    buf.Size(tail_size);
+  }
+  buf_offset_ = tail_start;
+  queued_size_ = size;
+  return PosixWritableFile::Truncate(size, opts, dbg);
+}
+
+IOStatus PosixIOUringWritableFile::Close(const IOOptions& opts,
+                                         IODebugContext* dbg) {
+  MutexLock lock(&mu_);
+  IOStatus s = WriteStaged();
+  // Cut the padding of the last sector off
+  if (s.ok() && ftruncate(fd_, filesize_) < 0) {
+    s = IOError("While ftruncate file to size " + std::to_string(filesize_),
+                filename_, errno);
+  }
+  IOStatus close_status = PosixWritableFile::Close(opts, dbg);
+  return s.ok() ? close_status : s;
+}
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
+
 /*
  * PosixRandomRWFile
  */
@@ -15,6 +15,8 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <string>
@@ -24,6 +26,7 @@
 #include "rocksdb/file_system.h"
 #include "rocksdb/io_status.h"
 #include "test_util/sync_point.h"
+#include "util/aligned_buffer.h"
 #include "util/mutexlock.h"
 #include "util/thread_local.h"
 
@@ -44,6 +47,15 @@
 #define POSIX_MADV_DONTNEED 4   /* [MC1] don't need these pages */
 #endif
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+// If defined by the application and returning non-zero, the io_uring
+// instances poll their submission queues from a kernel thread, which sleeps
+// after being idle for this many milliseconds. Submitting then takes no
+// system call while the kernel thread is awake.
+extern "C" unsigned int RocksDbIOUringSqPollIdleMillis()
+    __attribute__((__weak__));
+#endif
+
 namespace ROCKSDB_NAMESPACE {
 std::string IOErrorMsg(const std::string& context,
                        const std::string& file_name);
@@ -117,7 +129,10 @@ struct Posix_IOHandle {
         use_direct_io(_use_direct_io),
         alignment(_alignment),
         is_finished(false),
-        req_count(0) {}
+        req_count(0),
+        submit_micros(0),
+        deadline_micros(0),
+        cancelling(false) {}
 
   struct iovec iov;
   struct io_uring* iu;
@@ -131,8 +146,28 @@ struct Posix_IOHandle {
   bool is_finished;
   // req_count is used by AbortIO API to keep track of number of requests.
   uint32_t req_count;
+  // See IOUringNowMicros()
+  uint64_t submit_micros;
+  // Time past which Poll cancels the request, 0 for none. Set from
+  // IOOptions::timeout.
+  uint64_t deadline_micros;
+  // Whether a cancel request was submitted for the request
+  bool cancelling;
 };
 
+inline uint64_t IOUringNowMicros() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// Moving average of the time the async reads of the io_uring of the calling
+// thread took from submission to completion. Every thread has its own
+// io_uring. ReadAsync rejects reads with a timeout shorter than this, since
+// they would most likely be cancelled unfinished.
+uint64_t& IOUringReadLatencyMicros();
+
 inline void UpdateResult(struct io_uring_cqe* cqe, const std::string& file_name,
                          size_t len, size_t iov_len, bool async_read,
                          bool use_direct_io, size_t alignment,
@@ -187,6 +222,40 @@ inline void UpdateResult(struct io_uring_cqe* cqe, const std::string& file_name,
   (void)len;
 #endif
 }
+
+// Completes the async read of `posix_handle` from its completion queue entry
+// `cqe`, and calls its callback.
+inline void CompleteAsyncRead(struct io_uring* iu, struct io_uring_cqe* cqe,
+                              Posix_IOHandle* posix_handle) {
+  // Reset cqe data to catch any stray reuse of it
+  static_cast<struct io_uring_cqe*>(cqe)->user_data = 0xd5d5d5d5d5d5d5d5;
+
+  FSReadRequest req;
+  req.scratch = posix_handle->scratch;
+  req.offset = posix_handle->offset;
+  req.len = posix_handle->len;
+
+  size_t finished_len = 0;
+  size_t bytes_read = 0;
+  bool read_again = false;
+  UpdateResult(cqe, "", req.len, posix_handle->iov.iov_len,
+               true /*async_read*/, posix_handle->use_direct_io,
+               posix_handle->alignment, finished_len, &req, bytes_read,
+               read_again);
+  posix_handle->is_finished = true;
+  io_uring_cqe_seen(iu, cqe);
+
+  uint64_t& avg_latency = IOUringReadLatencyMicros();
+  const uint64_t latency = IOUringNowMicros() - posix_handle->submit_micros;
+  avg_latency = avg_latency == 0 ? latency
+                                 : avg_latency - avg_latency / 8 + latency / 8;
+
+  posix_handle->cb(req, posix_handle->cb_arg);
+
+  (void)finished_len;
+  (void)bytes_read;
+  (void)read_again;
+}
 #endif
 
 #ifdef OS_LINUX
@@ -297,9 +366,46 @@ inline void DeleteIOUring(void* p) {
   delete iu;
 }
 
+// Returns the file descriptor of the io_uring instance, created on first use,
+// that owns the kernel thread polling the submission queues of all of the
+// other instances (see IORING_SETUP_ATTACH_WQ), so that there is one such
+// thread however many threads have an instance. Returns -1 if it cannot be
+// created.
+inline int GetSqPollIOUringFd(unsigned int idle_ms) {
+  static const int fd = [idle_ms]() {
+    static struct io_uring sq_poll_io_uring;
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SQPOLL;
+    params.sq_thread_idle = idle_ms;
+    if (io_uring_queue_init_params(1, &sq_poll_io_uring, &params)) {
+      return -1;
+    }
+    return sq_poll_io_uring.ring_fd;
+  }();
+  return fd;
+}
+
 inline struct io_uring* CreateIOUring() {
   struct io_uring* new_io_uring = new struct io_uring;
-  int ret = io_uring_queue_init(kIoUringDepth, new_io_uring, 0);
+  int ret = -1;
+  const unsigned int sq_poll_idle_ms =
+      RocksDbIOUringSqPollIdleMillis ? RocksDbIOUringSqPollIdleMillis() : 0;
+  if (sq_poll_idle_ms > 0) {
+    const int wq_fd = GetSqPollIOUringFd(sq_poll_idle_ms);
+    if (wq_fd >= 0) {
+      struct io_uring_params params;
+      memset(&params, 0, sizeof(params));
+      params.flags = IORING_SETUP_SQPOLL | IORING_SETUP_ATTACH_WQ;
+      params.sq_thread_idle = sq_poll_idle_ms;
+      params.wq_fd = static_cast<__u32>(wq_fd);
+      ret = io_uring_queue_init_params(kIoUringDepth, new_io_uring, &params);
+    }
+  }
+  if (ret) {
+    // Without SQ polling, e.g. if the kernel does not allow it
+    ret = io_uring_queue_init(kIoUringDepth, new_io_uring, 0);
+  }
   if (ret) {
     delete new_io_uring;
     new_io_uring = nullptr;
@@ -390,6 +496,8 @@ class PosixWritableFile : public FSWritableFile {
                   IODebugContext* dbg) override {
     return Append(data, opts, dbg);
   }
+  IOStatus AppendV(const Slice* data, size_t n, const IOOptions& opts,
+                   IODebugContext* dbg) override;
   IOStatus PositionedAppend(const Slice& data, uint64_t offset,
                             const IOOptions& opts,
                             IODebugContext* dbg) override;
@@ -421,6 +529,85 @@ class PosixWritableFile : public FSWritableFile {
 #endif
 };
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+// Writes a file opened with O_DIRECT through io_uring, for the WAL.
+// Appends are staged in a sector aligned buffer, so the caller doesn't need
+// to align them and sees it as a buffered file. Flush() submits the staged
+// bytes without waiting for them, appends go to a second buffer meanwhile,
+// and Sync() is linked to the write before it in the ring. The partial last
+// sector is rewritten by the next write, so only one write is in flight.
+class PosixIOUringWritableFile : public PosixWritableFile {
+ public:
+  // Takes the ownership of iu.
+  PosixIOUringWritableFile(const std::string& fname, int fd,
+                           size_t logical_block_size,
+                           const EnvOptions& options, struct io_uring* iu);
+  ~PosixIOUringWritableFile() override;
+
+  IOStatus Truncate(uint64_t size, const IOOptions& opts,
+                    IODebugContext* dbg) override;
+  IOStatus Close(const IOOptions& opts, IODebugContext* dbg) override;
+  IOStatus Append(const Slice& data, const IOOptions& opts,
+                  IODebugContext* dbg) override;
+  IOStatus Append(const Slice& data, const IOOptions& opts,
+                  const DataVerificationInfo& /* verification_info */,
+                  IODebugContext* dbg) override {
+    return Append(data, opts, dbg);
+  }
+  // The slices are staged in the aligned buffers like any Append()
+  IOStatus AppendV(const Slice* data, size_t n, const IOOptions& opts,
+                   IODebugContext* dbg) override {
+    return FSWritableFile::AppendV(data, n, opts, dbg);
+  }
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& opts,
+                            IODebugContext* dbg) override;
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& opts,
+                            const DataVerificationInfo& /* verification_info */,
+                            IODebugContext* dbg) override {
+    return PositionedAppend(data, offset, opts, dbg);
+  }
+  IOStatus Flush(const IOOptions& opts, IODebugContext* dbg) override;
+  IOStatus Sync(const IOOptions& opts, IODebugContext* dbg) override;
+  IOStatus Fsync(const IOOptions& opts, IODebugContext* dbg) override;
+  // The alignment is handled here, not by the caller
+  bool use_direct_io() const override { return false; }
+
+ private:
+  // Queues a write of the staged buffer, padded to the sector size, and
+  // continues staging in the other buffer from the partial last sector.
+  // REQUIRES: mu_ held, no write in flight
+  void QueueStagedWrite(unsigned char sqe_flags);
+  // Submits a sync after the queued or in flight write and waits for all.
+  // REQUIRES: mu_ held
+  IOStatus SubmitSync(bool datasync);
+  // Reaps all the submitted requests, returning the first error.
+  // REQUIRES: mu_ held
+  IOStatus WaitForInflight();
+  // Writes everything staged and waits for it.
+  // REQUIRES: mu_ held
+  IOStatus WriteStaged();
+  // Submits the queued requests and waits for wait_nr completions.
+  // REQUIRES: mu_ held
+  IOStatus Submit(unsigned int wait_nr);
+
+  port::Mutex mu_;
+  struct io_uring* iu_;
+  // buffers_[cur_] holds the file from buf_offset_ to filesize_, and the
+  // other one belongs to the write in flight, if any
+  AlignedBuffer buffers_[2];
+  int cur_ = 0;
+  uint64_t buf_offset_ = 0;
+  // File size up to which writes are queued
+  uint64_t queued_size_ = 0;
+  struct iovec iov_;
+  unsigned int inflight_ = 0;
+  // Sticky, as the sectors written by a failed request are unknown
+  IOStatus error_;
+};
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
+
 // mmap() based random-access
 class PosixMmapReadableFile : public FSRandomAccessFile {
  private:
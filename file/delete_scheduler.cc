@@ -5,6 +5,7 @@
 
 #include "file/delete_scheduler.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <thread>
 #include <vector>
@@ -34,7 +35,11 @@ DeleteScheduler::DeleteScheduler(SystemClock* clock, FileSystem* fs,
       bytes_max_delete_chunk_(bytes_max_delete_chunk),
       closing_(false),
       cv_(&mu_),
-      bg_thread_(nullptr),
+      num_threads_(1),
+      busy_threads_(0),
+      rate_start_time_(0),
+      rate_deleted_bytes_(0),
+      rate_current_(0),
       info_log_(info_log),
       sst_file_manager_(sst_file_manager),
       max_trash_db_ratio_(max_trash_db_ratio) {
@@ -49,8 +54,8 @@ DeleteScheduler::~DeleteScheduler() {
     closing_ = true;
     cv_.SignalAll();
   }
-  if (bg_thread_) {
-    bg_thread_->join();
+  for (auto& bg_thread : bg_threads_) {
+    bg_thread.join();
   }
   for (const auto& it : bg_errors_) {
     it.second.PermitUncheckedError();
@@ -161,7 +166,7 @@ Status DeleteScheduler::AddFileToDeletionQueue(const std::string& file_path,
   {
     InstrumentedMutexLock l(&mu_);
     RecordTick(stats_.get(), FILES_MARKED_TRASH);
-    queue_.emplace(trash_file, dir_to_sync, accounted, bucket);
+    queue_.emplace_back(trash_file, dir_to_sync, accounted, bucket);
     pending_files_++;
     if (bucket.has_value()) {
       auto iter = pending_files_in_buckets_.find(bucket.value());
@@ -170,7 +175,7 @@ Status DeleteScheduler::AddFileToDeletionQueue(const std::string& file_path,
         iter->second++;
       }
     }
-    if (pending_files_ == 1) {
+    if (pending_files_ == 1 || num_threads_ > 1) {
       cv_.SignalAll();
     }
   }
@@ -268,12 +273,18 @@ Status DeleteScheduler::MarkAsTrash(const std::string& file_path,
   return s;
 }
 
-void DeleteScheduler::BackgroundEmptyTrash() {
+void DeleteScheduler::BackgroundEmptyTrash(int thread_id) {
   TEST_SYNC_POINT("DeleteScheduler::BackgroundEmptyTrash");
 
+  InstrumentedMutexLock l(&mu_);
+  // Whether this thread is counted in busy_threads_
+  bool busy = false;
   while (true) {
-    InstrumentedMutexLock l(&mu_);
-    while (queue_.empty() && !closing_) {
+    while ((queue_.empty() || thread_id >= num_threads_) && !closing_) {
+      if (busy) {
+        busy = false;
+        busy_threads_--;
+      }
       cv_.Wait();
     }
 
@@ -281,85 +292,83 @@ void DeleteScheduler::BackgroundEmptyTrash() {
       return;
     }
 
-    // Delete all files in queue_
-    uint64_t start_time = clock_->NowMicros();
-    uint64_t total_deleted_bytes = 0;
-    int64_t current_delete_rate = rate_bytes_per_sec_.load();
-    while (!queue_.empty() && !closing_) {
-      // Satisfy static analysis.
-      std::optional<int32_t> bucket = std::nullopt;
-      if (current_delete_rate != rate_bytes_per_sec_.load()) {
+    const int64_t delete_rate = rate_bytes_per_sec_.load();
+    if (busy_threads_ == 0 || rate_current_ != delete_rate) {
+      if (busy_threads_ > 0) {
         // User changed the delete rate
-        current_delete_rate = rate_bytes_per_sec_.load();
-        start_time = clock_->NowMicros();
-        total_deleted_bytes = 0;
         ROCKS_LOG_INFO(info_log_, "rate_bytes_per_sec is changed to %" PRIi64,
-                       current_delete_rate);
+                       delete_rate);
       }
+      rate_start_time_ = clock_->NowMicros();
+      rate_deleted_bytes_ = 0;
+      rate_current_ = delete_rate;
+    }
+    if (!busy) {
+      busy = true;
+      busy_threads_++;
+    }
 
-      // Get new file to delete
-      const FileAndDir& fad = queue_.front();
-      std::string path_in_trash = fad.fname;
-      std::string dir_to_sync = fad.dir;
-      bool accounted = fad.accounted;
-      bucket = fad.bucket;
-
-      // We don't need to hold the lock while deleting the file
-      mu_.Unlock();
-      uint64_t deleted_bytes = 0;
-      bool is_complete = true;
-      // Delete file from trash and update total_penlty value
-      Status s = DeleteTrashFile(path_in_trash, dir_to_sync, accounted,
-                                 &deleted_bytes, &is_complete);
-      total_deleted_bytes += deleted_bytes;
-      mu_.Lock();
-      if (is_complete) {
-        RecordTick(stats_.get(), FILES_DELETED_FROM_TRASH_QUEUE);
-        queue_.pop();
-      }
+    // Get new file to delete
+    FileAndDir fad = queue_.front();
+    queue_.pop_front();
+
+    // We don't need to hold the lock while deleting the file
+    mu_.Unlock();
+    uint64_t deleted_bytes = 0;
+    bool is_complete = true;
+    // Delete file from trash and update total_penlty value
+    Status s = DeleteTrashFile(fad.fname, fad.dir, fad.accounted,
+                               &deleted_bytes, &is_complete);
+    mu_.Lock();
+    rate_deleted_bytes_ += deleted_bytes;
+    if (is_complete) {
+      RecordTick(stats_.get(), FILES_DELETED_FROM_TRASH_QUEUE);
+    } else {
+      // Keep deleting the rest of the file before the files queued after it
+      queue_.push_front(fad);
+    }
 
-      if (!s.ok()) {
-        bg_errors_[path_in_trash] = s;
-      }
+    if (!s.ok()) {
+      bg_errors_[fad.fname] = s;
+    }
 
-      // Apply penalty if necessary
-      uint64_t total_penalty;
-      if (current_delete_rate > 0) {
-        // rate limiting is enabled
-        total_penalty =
-            ((total_deleted_bytes * kMicrosInSecond) / current_delete_rate);
-        ROCKS_LOG_INFO(info_log_,
-                       "Rate limiting is enabled with penalty %" PRIu64
-                       " after deleting file %s",
-                       total_penalty, path_in_trash.c_str());
-        while (!closing_ && !cv_.TimedWait(start_time + total_penalty)) {
-        }
-      } else {
-        // rate limiting is disabled
-        total_penalty = 0;
-        ROCKS_LOG_INFO(info_log_,
-                       "Rate limiting is disabled after deleting file %s",
-                       path_in_trash.c_str());
+    // Apply penalty if necessary
+    uint64_t total_penalty;
+    if (rate_current_ > 0) {
+      // rate limiting is enabled
+      total_penalty = ((rate_deleted_bytes_ * kMicrosInSecond) / rate_current_);
+      ROCKS_LOG_INFO(info_log_,
+                     "Rate limiting is enabled with penalty %" PRIu64
+                     " after deleting file %s",
+                     total_penalty, fad.fname.c_str());
+      const uint64_t wait_until = rate_start_time_ + total_penalty;
+      while (!closing_ && !cv_.TimedWait(wait_until)) {
       }
-      TEST_SYNC_POINT_CALLBACK("DeleteScheduler::BackgroundEmptyTrash:Wait",
-                               &total_penalty);
-
-      int32_t pending_files_in_bucket = std::numeric_limits<int32_t>::max();
-      if (is_complete) {
-        pending_files_--;
-        if (bucket.has_value()) {
-          auto iter = pending_files_in_buckets_.find(bucket.value());
-          assert(iter != pending_files_in_buckets_.end());
-          if (iter != pending_files_in_buckets_.end()) {
-            pending_files_in_bucket = iter->second--;
-          }
+    } else {
+      // rate limiting is disabled
+      total_penalty = 0;
+      ROCKS_LOG_INFO(info_log_,
+                     "Rate limiting is disabled after deleting file %s",
+                     fad.fname.c_str());
+    }
+    TEST_SYNC_POINT_CALLBACK("DeleteScheduler::BackgroundEmptyTrash:Wait",
+                             &total_penalty);
+
+    int32_t pending_files_in_bucket = std::numeric_limits<int32_t>::max();
+    if (is_complete) {
+      pending_files_--;
+      if (fad.bucket.has_value()) {
+        auto iter = pending_files_in_buckets_.find(fad.bucket.value());
+        assert(iter != pending_files_in_buckets_.end());
+        if (iter != pending_files_in_buckets_.end()) {
+          pending_files_in_bucket = iter->second--;
         }
       }
-      if (pending_files_ == 0 || pending_files_in_bucket == 0) {
-        // Unblock WaitForEmptyTrash or WaitForEmptyTrashBucket since there are
-        // no more files waiting to be deleted
-        cv_.SignalAll();
-      }
+    }
+    if (pending_files_ == 0 || pending_files_in_bucket == 0) {
+      // Unblock WaitForEmptyTrash or WaitForEmptyTrashBucket since there are
+      // no more files waiting to be deleted
+      cv_.SignalAll();
     }
   }
 }
@@ -499,10 +508,23 @@ void DeleteScheduler::WaitForEmptyTrashBucket(int32_t bucket) {
   pending_files_in_buckets_.erase(bucket);
 }
 
+void DeleteScheduler::SetNumThreads(int num_threads) {
+  {
+    InstrumentedMutexLock l(&mu_);
+    num_threads_ = std::max(num_threads, 1);
+    cv_.SignalAll();
+  }
+  MaybeCreateBackgroundThread();
+}
+
 void DeleteScheduler::MaybeCreateBackgroundThread() {
-  if (bg_thread_ == nullptr && rate_bytes_per_sec_.load() > 0) {
-    bg_thread_.reset(
-        new port::Thread(&DeleteScheduler::BackgroundEmptyTrash, this));
+  if (rate_bytes_per_sec_.load() <= 0) {
+    return;
+  }
+  InstrumentedMutexLock l(&mu_);
+  while (!closing_ && static_cast<int>(bg_threads_.size()) < num_threads_) {
+    bg_threads_.emplace_back(&DeleteScheduler::BackgroundEmptyTrash, this,
+                             static_cast<int>(bg_threads_.size()));
     ROCKS_LOG_INFO(info_log_,
                    "Created background thread for deletion scheduler with "
                    "rate_bytes_per_sec: %" PRIi64,
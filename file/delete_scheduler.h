@@ -5,11 +5,12 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
 #include <optional>
-#include <queue>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "monitoring/instrumented_mutex.h"
 #include "port/port.h"
@@ -25,8 +26,10 @@ class SystemClock;
 
 // DeleteScheduler allows the DB to enforce a rate limit on file deletion,
 // Instead of deleteing files immediately, files are marked as trash
-// and deleted in a background thread that apply sleep penalty between deletes
+// and deleted in background threads that apply sleep penalty between deletes
 // if they are happening in a rate faster than rate_bytes_per_sec,
+// The threads share rate_bytes_per_sec, so that it bounds the rate of all of
+// their deletes together.
 //
 // Rate limiting can be turned off by setting rate_bytes_per_sec = 0, In this
 // case DeleteScheduler will delete files immediately.
@@ -48,6 +51,21 @@ class DeleteScheduler {
     MaybeCreateBackgroundThread();
   }
 
+  // Return the number of background threads deleting trash files
+  int GetNumThreads() {
+    InstrumentedMutexLock l(&mu_);
+    return num_threads_;
+  }
+
+  // Set the number of background threads deleting trash files
+  void SetNumThreads(int num_threads);
+
+  // Return the number of trash files waiting to be deleted
+  int32_t GetNumTrashFiles() {
+    InstrumentedMutexLock l(&mu_);
+    return pending_files_;
+  }
+
   // Delete an accounted file that is tracked by `SstFileManager` and should be
   // tracked by this `DeleteScheduler` when it's deleted.
   // The file is deleted immediately if slow deletion is disabled. If force_bg
@@ -131,7 +149,7 @@ class DeleteScheduler {
 
   Status OnDeleteFile(const std::string& file_path, bool accounted);
 
-  void BackgroundEmptyTrash();
+  void BackgroundEmptyTrash(int thread_id);
 
   void MaybeCreateBackgroundThread();
 
@@ -143,7 +161,8 @@ class DeleteScheduler {
   // Maximum number of bytes that should be deleted per second
   std::atomic<int64_t> rate_bytes_per_sec_;
   // Mutex to protect queue_, pending_files_, next_trash_bucket_,
-  // pending_files_in_buckets_, bg_errors_, closing_, stats_
+  // pending_files_in_buckets_, bg_errors_, closing_, stats_, num_threads_,
+  // bg_threads_, busy_threads_ and the rate_* counters
   InstrumentedMutex mu_;
 
   struct FileAndDir {
@@ -156,8 +175,9 @@ class DeleteScheduler {
     std::optional<int32_t> bucket;
   };
 
-  // Queue of trash files that need to be deleted
-  std::queue<FileAndDir> queue_;
+  // Queue of trash files that need to be deleted, not including the ones that
+  // background threads are deleting
+  std::deque<FileAndDir> queue_;
   // Number of trash files that are waiting to be deleted
   int32_t pending_files_;
   // Next trash bucket that can be created
@@ -168,17 +188,31 @@ class DeleteScheduler {
   // Errors that happened in BackgroundEmptyTrash (file_path => error)
   std::map<std::string, Status> bg_errors_;
 
-  bool num_link_error_printed_ = false;
+  std::atomic<bool> num_link_error_printed_{false};
   // Set to true in ~DeleteScheduler() to force BackgroundEmptyTrash to stop
   bool closing_;
   // Condition variable signaled in these conditions
   //    - pending_files_ value change from 0 => 1
   //    - pending_files_ value change from 1 => 0
   //    - a value in pending_files_in_buckets change from 1 => 0
+  //    - a file is queued while num_threads_ > 1
+  //    - num_threads_ value changes
   //    - closing_ value is set to true
   InstrumentedCondVar cv_;
-  // Background thread running BackgroundEmptyTrash
-  std::unique_ptr<port::Thread> bg_thread_;
+  // Number of background threads that should be running BackgroundEmptyTrash.
+  // The threads past it stay idle.
+  int num_threads_;
+  // Background threads running BackgroundEmptyTrash
+  std::vector<port::Thread> bg_threads_;
+  // Number of background threads that have not found queue_ empty since they
+  // last took a file from it
+  int busy_threads_;
+  // Start of the current run of deletes, bytes deleted by it and the rate
+  // limit it runs at. A run lasts until all of the background threads are
+  // idle.
+  uint64_t rate_start_time_;
+  uint64_t rate_deleted_bytes_;
+  int64_t rate_current_;
   // Mutex to protect threads from file name conflicts
   InstrumentedMutex file_move_mu_;
   Logger* info_log_;
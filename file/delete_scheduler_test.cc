@@ -5,6 +5,7 @@
 
 #include "file/delete_scheduler.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cinttypes>
 #include <thread>
@@ -324,6 +325,75 @@ TEST_F(DeleteSchedulerTest, RateLimitingMultiThreaded) {
   }
 }
 
+// Delete files with multiple background threads and make sure that they
+// delete files at once while sharing the rate limit
+TEST_F(DeleteSchedulerTest, ParallelDeletions) {
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->LoadDependency({
+      {"DeleteSchedulerTest::ParallelDeletions:1",
+       "DeleteScheduler::BackgroundEmptyTrash"},
+  });
+
+  std::vector<uint64_t> penalties;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DeleteScheduler::BackgroundEmptyTrash:Wait",
+      [&](void* arg) { penalties.push_back(*(static_cast<uint64_t*>(arg))); });
+  std::atomic<int> deleting(0);
+  std::atomic<int> max_deleting(0);
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DeleteScheduler::DeleteTrashFile::cb", [&](void* /*arg*/) {
+        int cur = deleting.fetch_add(1) + 1;
+        int prev = max_deleting.load();
+        while (cur > prev && !max_deleting.compare_exchange_weak(prev, cur)) {
+        }
+        env_->SleepForMicroseconds(10 * 1000);
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DeleteScheduler::DeleteTrashFile::AfterSyncDir",
+      [&](void* /*arg*/) { deleting.fetch_sub(1); });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  int num_files = 100;        // 100 files
+  uint64_t file_size = 1024;  // every file is 1 kb
+  rate_bytes_per_sec_ = 1024 * 1024;
+  NewDeleteScheduler();
+  sst_file_mgr_->SetNumDeleteThreads(4);
+  ASSERT_EQ(4, sst_file_mgr_->GetNumDeleteThreads());
+
+  std::vector<std::string> generated_files;
+  for (int i = 0; i < num_files; i++) {
+    std::string file_name = "file" + std::to_string(i) + ".data";
+    generated_files.push_back(NewDummyFile(file_name, file_size));
+  }
+  for (int i = 0; i < num_files; i++) {
+    ASSERT_OK(delete_scheduler_->DeleteFile(generated_files[i],
+                                            dummy_files_dirs_[0]));
+  }
+  ASSERT_EQ(num_files, sst_file_mgr_->GetNumTrashFiles());
+
+  uint64_t delete_start_time = env_->NowMicros();
+  TEST_SYNC_POINT("DeleteSchedulerTest::ParallelDeletions:1");
+  delete_scheduler_->WaitForEmptyTrash();
+  uint64_t time_spent_deleting = env_->NowMicros() - delete_start_time;
+  ASSERT_EQ(0, sst_file_mgr_->GetNumTrashFiles());
+  ASSERT_EQ(delete_scheduler_->GetBackgroundErrors().size(), 0);
+  ASSERT_GT(max_deleting.load(), 1);
+
+  // The threads add up the bytes they delete against the same rate limit
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ASSERT_EQ(penalties.size(), num_files);
+  std::sort(penalties.begin(), penalties.end());
+  uint64_t expected_penlty = 0;
+  for (int i = 0; i < num_files; i++) {
+    expected_penlty = (((i + 1) * file_size * 1000000) / rate_bytes_per_sec_);
+    ASSERT_EQ(expected_penlty, penalties[i]);
+  }
+  ASSERT_GT(time_spent_deleting, expected_penlty * 0.9);
+
+  ASSERT_EQ(CountTrashFiles(), 0);
+  ASSERT_EQ(num_files,
+            stats_->getAndResetTickerCount(FILES_DELETED_FROM_TRASH_QUEUE));
+}
+
 // Disable rate limiting by setting rate_bytes_per_sec_ to 0 and make sure
 // that when DeleteScheduler delete a file it delete it immediately and don't
 // move it to trash
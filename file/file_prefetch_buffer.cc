@@ -480,7 +480,7 @@ void FilePrefetchBuffer::HandleOverlappingSyncData(uint64_t offset,
     use_overlap_buffer = true;
     overlap_buf_->ClearBuffer();
     overlap_buf_->buffer_.Alignment(1);
-    overlap_buf_->buffer_.AllocateNewBuffer(length);
+    overlap_buf_->buffer_.AllocateNewPooledBuffer(length);
     overlap_buf_->offset_ = offset;
     CopyDataToOverlapBuffer(buf, tmp_offset, tmp_length);
     UpdateStats(/*found_in_buffer=*/false, overlap_buf_->CurrentSize());
@@ -532,7 +532,7 @@ Status FilePrefetchBuffer::HandleOverlappingAsyncData(
     // Allocate new buffer to overlap_buf_.
     overlap_buf_->ClearBuffer();
     overlap_buf_->buffer_.Alignment(alignment);
-    overlap_buf_->buffer_.AllocateNewBuffer(length);
+    overlap_buf_->buffer_.AllocateNewPooledBuffer(length);
     overlap_buf_->offset_ = offset;
     copy_to_overlap_buffer = true;
 
@@ -775,12 +775,6 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
 bool FilePrefetchBuffer::TryReadFromCacheUntracked(
     const IOOptions& opts, RandomAccessFileReader* reader, uint64_t offset,
     size_t n, Slice* result, Status* status, bool for_compaction) {
-  // We disallow async IO for compaction reads since they are performed in
-  // the background anyways and are less latency sensitive compared to
-  // user-initiated reads
-  (void)for_compaction;
-  assert(!for_compaction || num_buffers_ == 1);
-
   if (track_min_offset_ && offset < min_offset_read_) {
     min_offset_read_ = static_cast<size_t>(offset);
   }
@@ -0,0 +1,161 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "file/hedged_read.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "monitoring/histogram.h"
+#include "rocksdb/system_clock.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Reads recorded for a file before its latency percentile is trusted
+constexpr uint64_t kMinReadsForThreshold = 100;
+}  // namespace
+
+const std::string HedgedReads::kPropertyName = "rocksdb.hedged_read";
+
+// The requests of one read. Shared with the thread pool since the slower
+// request completes after the read has returned.
+struct HedgedReads::ReadState {
+  ReadState(FSRandomAccessFile* _file, uint64_t _offset, size_t _n)
+      : file(_file), offset(_offset), n(_n), cv(&mutex) {}
+
+  FSRandomAccessFile* const file;
+  const uint64_t offset;
+  const size_t n;
+  IOOptions opts[2];
+  std::unique_ptr<char[]> bufs[2];
+  Slice results[2];
+  IOStatus statuses[2];
+
+  port::Mutex mutex;
+  port::CondVar cv;
+  int num_issued = 0;
+  int num_done = 0;
+  // The first request to succeed, or -1
+  int winner = -1;
+  // The last request to fail, or -1
+  int last_failed = -1;
+};
+
+HedgedReads::HedgedReads(SystemClock* clock, int num_threads,
+                         double percentile, uint32_t budget_percent)
+    : clock_(clock),
+      num_threads_(num_threads),
+      percentile_(percentile),
+      budget_percent_(budget_percent),
+      thread_pool_(NewThreadPool(num_threads)),
+      cv_(&mutex_) {}
+
+HedgedReads::~HedgedReads() { thread_pool_->WaitForJobsAndJoinAllThreads(); }
+
+uint64_t HedgedReads::GetThresholdMicros(const HistogramImpl* hist) const {
+  if (hist == nullptr || hist->num() < kMinReadsForThreshold) {
+    return 0;
+  }
+  return std::max(uint64_t{1},
+                  static_cast<uint64_t>(hist->Percentile(percentile_)));
+}
+
+bool HedgedReads::Read(FSRandomAccessFile* file, uint64_t offset, size_t n,
+                       const IOOptions& opts, uint64_t threshold_micros,
+                       std::atomic<int>* pending, Slice* result, char* scratch,
+                       IOStatus* s) {
+  if (num_running_.fetch_add(1, std::memory_order_relaxed) >= num_threads_) {
+    num_running_.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+  }
+  num_reads_.fetch_add(1, std::memory_order_relaxed);
+
+  auto state = std::make_shared<ReadState>(file, offset, n);
+  state->opts[0] = opts;
+  state->bufs[0].reset(new char[n]);
+  state->num_issued = 1;
+  pending->fetch_add(1, std::memory_order_relaxed);
+  thread_pool_->SubmitJob(
+      [this, state, pending]() { RunRequest(state, 0, pending); });
+
+  const uint64_t deadline = clock_->NowMicros() + threshold_micros;
+  bool may_hedge = true;
+  MutexLock l(&state->mutex);
+  while (state->winner < 0 && state->num_done < state->num_issued) {
+    if (!may_hedge) {
+      state->cv.Wait();
+      continue;
+    }
+    if (!state->cv.TimedWait(deadline)) {
+      continue;
+    }
+    // The first request is slow. Hedge it if the budget and a thread allow.
+    may_hedge = false;
+    const uint64_t num_hedged = num_hedged_.load(std::memory_order_relaxed);
+    if (num_hedged * 100 >=
+        num_reads_.load(std::memory_order_relaxed) * budget_percent_) {
+      continue;
+    }
+    if (num_running_.fetch_add(1, std::memory_order_relaxed) >= num_threads_) {
+      num_running_.fetch_sub(1, std::memory_order_relaxed);
+      continue;
+    }
+    num_hedged_.fetch_add(1, std::memory_order_relaxed);
+    state->opts[1] = opts;
+    state->opts[1].property_bag[kPropertyName] = "1";
+    state->bufs[1].reset(new char[n]);
+    state->num_issued = 2;
+    pending->fetch_add(1, std::memory_order_relaxed);
+    thread_pool_->SubmitJob(
+        [this, state, pending]() { RunRequest(state, 1, pending); });
+  }
+
+  const int idx = state->winner >= 0 ? state->winner : state->last_failed;
+  assert(idx >= 0);
+  *s = state->statuses[idx];
+  size_t len = 0;
+  if (s->ok()) {
+    len = std::min(n, state->results[idx].size());
+    memcpy(scratch, state->results[idx].data(), len);
+  }
+  *result = Slice(scratch, len);
+  return true;
+}
+
+void HedgedReads::RunRequest(const std::shared_ptr<ReadState>& state, int idx,
+                             std::atomic<int>* pending) {
+  Slice result;
+  IOStatus s = state->file->Read(state->offset, state->n, state->opts[idx],
+                                 &result, state->bufs[idx].get(),
+                                 nullptr /* dbg */);
+  num_running_.fetch_sub(1, std::memory_order_relaxed);
+  {
+    MutexLock l(&state->mutex);
+    state->results[idx] = result;
+    state->statuses[idx] = s;
+    if (!s.ok()) {
+      state->last_failed = idx;
+    } else if (state->winner < 0) {
+      state->winner = idx;
+    }
+    state->num_done++;
+    state->cv.SignalAll();
+  }
+  MutexLock l(&mutex_);
+  pending->fetch_sub(1, std::memory_order_relaxed);
+  cv_.SignalAll();
+}
+
+void HedgedReads::WaitForPending(const std::atomic<int>* pending) {
+  MutexLock l(&mutex_);
+  while (pending->load(std::memory_order_relaxed) > 0) {
+    cv_.Wait();
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
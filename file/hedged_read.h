@@ -0,0 +1,80 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "port/port.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/threadpool.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class HistogramImpl;
+class SystemClock;
+
+// Issues reads from a thread pool and, when a read takes longer than usual
+// for its file, a second identical request, taking whichever completes first.
+// See DBOptions::hedged_read_threads. Shared by the RandomAccessFileReaders
+// of a TableCache, each of which must call WaitForPending() before its file
+// is closed, since the slower request of a hedged read completes in the
+// background.
+class HedgedReads {
+ public:
+  // The IOOptions::property_bag key set on the second request of a read.
+  static const std::string kPropertyName;
+
+  HedgedReads(SystemClock* clock, int num_threads, double percentile,
+              uint32_t budget_percent);
+  ~HedgedReads();
+
+  // Returns the latency in microseconds after which a read of a file whose
+  // read latencies are recorded in `hist` is hedged, or 0 if too few reads
+  // are recorded yet.
+  uint64_t GetThresholdMicros(const HistogramImpl* hist) const;
+
+  // Reads `n` bytes at `offset` of `file` into `scratch`, issuing a second
+  // request if the first has not completed after `threshold_micros` and the
+  // budget allows, and sets `*result` and `*s` from the first request to
+  // succeed (or the last to fail). Returns false without reading if all the
+  // threads are busy. `*pending` counts the requests still running for the
+  // caller's file.
+  bool Read(FSRandomAccessFile* file, uint64_t offset, size_t n,
+            const IOOptions& opts, uint64_t threshold_micros,
+            std::atomic<int>* pending, Slice* result, char* scratch,
+            IOStatus* s);
+
+  // Waits until `*pending` drops to zero.
+  void WaitForPending(const std::atomic<int>* pending);
+
+  uint64_t TEST_NumHedged() const {
+    return num_hedged_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct ReadState;
+
+  void RunRequest(const std::shared_ptr<ReadState>& state, int idx,
+                  std::atomic<int>* pending);
+
+  SystemClock* const clock_;
+  const int num_threads_;
+  const double percentile_;
+  const uint32_t budget_percent_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+  // Requests queued or running in `thread_pool_`
+  std::atomic<int> num_running_{0};
+  std::atomic<uint64_t> num_reads_{0};
+  std::atomic<uint64_t> num_hedged_{0};
+  // Protects the `pending` counters of the readers
+  port::Mutex mutex_;
+  port::CondVar cv_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -1899,6 +1899,75 @@ TEST_P(PrefetchTest, DBIterLevelReadAheadWithAsyncIO) {
   Close();
 }
 
+TEST_P(PrefetchTest, DBIterOpenNextFileWithAsyncIO) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_BYPASS("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+  const int kNumKeys = 1000;
+  bool use_direct_io = std::get<0>(GetParam());
+  bool is_adaptive_readahead = std::get<1>(GetParam());
+
+  Options options;
+  SetGenericOptions(env_, use_direct_io, options);
+  // Tables are only opened on demand
+  options.max_open_files = 100;
+  options.target_file_size_base = 1024 * 1024;
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  Random rnd(309);
+  int total_keys = 0;
+  for (int j = 0; j < 5; j++) {
+    for (int i = j * kNumKeys; i < (j + 1) * kNumKeys; i++) {
+      ASSERT_OK(Put(BuildKey(i), rnd.RandomString(1000)));
+      total_keys++;
+    }
+    ASSERT_OK(Flush());
+  }
+  MoveFilesToLevel(2);
+  ASSERT_GT(NumTableFilesAtLevel(2), 1);
+  dbfull()->TEST_table_cache()->EraseUnRefEntries();
+
+  std::atomic<int> num_scheduled{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelIterator::MaybeOpenNextFile:Schedule",
+      [&](void*) { num_scheduled++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ReadOptions ro;
+  ro.adaptive_readahead = is_adaptive_readahead;
+  ro.async_io = true;
+  {
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ro));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(num_keys, total_keys);
+    // Destroying the iterator waits for the file being opened
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  if (is_adaptive_readahead) {
+    ASSERT_GT(num_scheduled.load(), 0);
+  } else {
+    ASSERT_EQ(num_scheduled.load(), 0);
+  }
+  Close();
+}
+
 TEST_P(PrefetchTest, AvoidBlockCacheLookupTwice) {
   const int kNumKeys = 1000;
   // Set options
@@ -2646,6 +2715,173 @@ TEST_P(PrefetchTest, ReadAsyncWithPosixFS) {
   Close();
 }
 
+// This test verifies that a scan with async_io keeps the configured number
+// of readahead buffers of a table file in flight.
+TEST_P(PrefetchTest, ReadAsyncWithMultipleBuffers) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_SKIP("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+
+  const int kNumKeys = 1000;
+  std::shared_ptr<MockFS> fs = std::make_shared<MockFS>(
+      FileSystem::Default(), /*support_prefetch=*/false);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  bool use_direct_io = std::get<0>(GetParam());
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  int total_keys = 0;
+  {
+    WriteBatch batch;
+    Random rnd(309);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(batch.Put(BuildKey(i), rnd.RandomString(1000)));
+      total_keys++;
+    }
+    ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(2);
+  }
+
+  int extra_prefetch_count = 0;
+  bool read_async_called = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "FilePrefetchBuffer::PrefetchAsync:ExtraPrefetching",
+      [&](void*) { extra_prefetch_count++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "UpdateResults::io_uring_result",
+      [&](void* /*arg*/) { read_async_called = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  int extra_prefetch_counts[2];
+  const size_t kNumBuffers[2] = {2, 4};
+  for (int i = 0; i < 2; i++) {
+    extra_prefetch_count = 0;
+    ReadOptions ro;
+    ro.async_io = true;
+    ro.fill_cache = false;
+    ro.readahead_size = 16 * 1024;
+    ro.async_readahead_num_buffers = kNumBuffers[i];
+
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ro));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_OK(iter->status());
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(num_keys, total_keys);
+    extra_prefetch_counts[i] = extra_prefetch_count;
+  }
+
+  // Not all platforms support iouring. In that case, ReadAsync in posix
+  // won't submit async requests.
+  if (read_async_called) {
+    ASSERT_GT(extra_prefetch_counts[0], 0);
+    ASSERT_GT(extra_prefetch_counts[1], extra_prefetch_counts[0]);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  Close();
+}
+
+// This test verifies that compaction inputs are prefetched asynchronously
+// with compaction_async_io.
+TEST_P(PrefetchTest, CompactionReadAsyncWithPosixFS) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_SKIP("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+
+  const int kNumKeys = 1000;
+  // Without file system prefetching, compactions use FilePrefetchBuffer
+  std::shared_ptr<MockFS> fs = std::make_shared<MockFS>(
+      FileSystem::Default(), /*support_prefetch=*/false);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  bool use_direct_io = std::get<0>(GetParam());
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  options.statistics = CreateDBStatistics();
+  options.compaction_async_io = true;
+  if (std::get<1>(GetParam())) {
+    options.compaction_readahead_size = 64 * 1024;
+  }
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  int total_keys = 0;
+  {
+    WriteBatch batch;
+    Random rnd(309);
+    for (int j = 0; j < 5; j++) {
+      for (int i = j * kNumKeys; i < (j + 1) * kNumKeys; i++) {
+        ASSERT_OK(batch.Put(BuildKey(i), rnd.RandomString(1000)));
+        total_keys++;
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+      ASSERT_OK(Flush());
+    }
+  }
+
+  bool read_async_called = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "UpdateResults::io_uring_result",
+      [&](void* /*arg*/) { read_async_called = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(options.statistics->Reset());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  // Not all platforms support iouring. In that case, ReadAsync in posix
+  // won't submit async requests.
+  if (read_async_called) {
+    HistogramData async_read_bytes;
+    options.statistics->histogramData(ASYNC_READ_BYTES, &async_read_bytes);
+    ASSERT_GT(async_read_bytes.count, 0);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  {
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ReadOptions()));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(num_keys, total_keys);
+  }
+
+  Close();
+}
+
 // This test verifies implementation of seek parallelization with
 // PosixFileSystem during prefetching.
 TEST_P(PrefetchTest, MultipleSeekWithPosixFS) {
@@ -92,6 +92,19 @@ inline void RecordIOStats(Statistics* stats, Temperature file_temperature,
   }
 }
 
+// The latency is only measured with statistics
+void RandomAccessFileReader::RecordReadLatency(uint64_t elapsed) const {
+  if (stats_ == nullptr) {
+    return;
+  }
+  if (file_read_hist_ != nullptr) {
+    file_read_hist_->Add(elapsed);
+  }
+  if (path_read_hist_ != nullptr) {
+    path_read_hist_->Add(elapsed);
+  }
+}
+
 IOStatus RandomAccessFileReader::Create(
     const std::shared_ptr<FileSystem>& fs, const std::string& fname,
     const FileOptions& file_opts,
@@ -149,13 +162,13 @@ IOStatus RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
           Roundup(static_cast<size_t>(offset + n), alignment) - aligned_offset;
       AlignedBuffer buf;
       buf.Alignment(alignment);
-      buf.AllocateNewBuffer(read_size);
+      buf.AllocateNewPooledBuffer(read_size);
       while (buf.CurrentSize() < read_size) {
         size_t allowed;
         if (rate_limiter_priority != Env::IO_TOTAL &&
             rate_limiter_ != nullptr) {
           allowed = rate_limiter_->RequestToken(
-              buf.Capacity() - buf.CurrentSize(), buf.Alignment(),
+              read_size - buf.CurrentSize(), buf.Alignment(),
               rate_limiter_priority, stats_, RateLimiter::OpType::kRead);
         } else {
           assert(buf.CurrentSize() == 0);
@@ -209,7 +222,38 @@ IOStatus RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
     } else {
       size_t pos = 0;
       const char* res_scratch = nullptr;
-      while (pos < n) {
+      bool hedged = false;
+      const uint64_t hedge_threshold =
+          hedged_reads_ != nullptr && scratch != nullptr && n > 0 &&
+                  !use_direct_io() &&
+                  (rate_limiter_priority == Env::IO_TOTAL ||
+                   rate_limiter_ == nullptr)
+              ? hedged_reads_->GetThresholdMicros(file_read_hist_)
+              : 0;
+      if (hedge_threshold > 0) {
+        Slice tmp_result;
+        FileOperationInfo::StartTimePoint start_ts;
+        if (ShouldNotifyListeners()) {
+          start_ts = FileOperationInfo::StartNow();
+        }
+        hedged = hedged_reads_->Read(file_.get(), offset, n, opts,
+                                     hedge_threshold, &pending_hedged_requests_,
+                                     &tmp_result, scratch, &io_s);
+        if (hedged) {
+          if (ShouldNotifyListeners()) {
+            auto finish_ts = FileOperationInfo::FinishNow();
+            NotifyOnFileReadFinish(offset, tmp_result.size(), start_ts,
+                                   finish_ts, io_s);
+            if (!io_s.ok()) {
+              NotifyOnIOError(io_s, FileOperationType::kRead, file_name(),
+                              tmp_result.size(), offset);
+            }
+          }
+          res_scratch = scratch;
+          pos = tmp_result.size();
+        }
+      }
+      while (!hedged && pos < n) {
         size_t allowed;
         if (rate_limiter_priority != Env::IO_TOTAL &&
             rate_limiter_ != nullptr) {
@@ -270,9 +314,7 @@ IOStatus RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
     RecordIOStats(stats_, file_temperature_, is_last_level_, result->size());
     SetPerfLevel(prev_perf_level);
   }
-  if (stats_ != nullptr && file_read_hist_ != nullptr) {
-    file_read_hist_->Add(elapsed);
-  }
+  RecordReadLatency(elapsed);
 
 #ifndef NDEBUG
   auto pair = std::make_pair(&file_name_, &io_s);
@@ -381,7 +423,7 @@ IOStatus RandomAccessFileReader::MultiRead(const IOOptions& opts,
       }
       AlignedBuffer buf;
       buf.Alignment(alignment);
-      buf.AllocateNewBuffer(total_len);
+      buf.AllocateNewPooledBuffer(total_len);
       char* scratch = buf.BufferStart();
       for (auto& r : aligned_reqs) {
         r.scratch = scratch;
@@ -473,9 +515,7 @@ IOStatus RandomAccessFileReader::MultiRead(const IOOptions& opts,
     }
     SetPerfLevel(prev_perf_level);
   }
-  if (stats_ != nullptr && file_read_hist_ != nullptr) {
-    file_read_hist_->Add(elapsed);
-  }
+  RecordReadLatency(elapsed);
 
   return io_s;
 }
@@ -522,7 +562,7 @@ IOStatus RandomAccessFileReader::ReadAsync(
 
     // Allocate aligned buffer.
     read_async_info->buf_.Alignment(alignment);
-    read_async_info->buf_.AllocateNewBuffer(aligned_req.len);
+    read_async_info->buf_.AllocateNewPooledBuffer(aligned_req.len);
 
     // Set rem fields in aligned FSReadRequest.
     aligned_req.scratch = read_async_info->buf_.BufferStart();
@@ -620,11 +660,11 @@ void RandomAccessFileReader::ReadAsyncCallback(FSReadRequest& req,
   }
 
   // Update stats and notify listeners.
-  if (stats_ != nullptr && file_read_hist_ != nullptr) {
+  if (stats_ != nullptr) {
     // elapsed doesn't take into account delay and overwrite as StopWatch does
     // in Read.
     uint64_t elapsed = clock_->NowMicros() - read_async_info->start_time_;
-    file_read_hist_->Add(elapsed);
+    RecordReadLatency(elapsed);
   }
   if (req.status.ok()) {
     RecordInHistogram(stats_, ASYNC_READ_BYTES, req.result.size());
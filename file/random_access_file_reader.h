@@ -13,6 +13,7 @@
 #include <string>
 
 #include "env/file_system_tracer.h"
+#include "file/hedged_read.h"
 #include "port/port.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/listener.h"
@@ -78,16 +79,22 @@ class RandomAccessFileReader {
 
   bool ShouldNotifyListeners() const { return !listeners_.empty(); }
 
+  void RecordReadLatency(uint64_t elapsed) const;
+
   FSRandomAccessFilePtr file_;
   std::string file_name_;
   SystemClock* clock_;
   Statistics* stats_;
   uint32_t hist_type_;
   HistogramImpl* file_read_hist_;
+  HistogramImpl* path_read_hist_;
   RateLimiter* rate_limiter_;
   std::vector<std::shared_ptr<EventListener>> listeners_;
   const Temperature file_temperature_;
   const bool is_last_level_;
+  std::shared_ptr<HedgedReads> hedged_reads_;
+  // Requests of hedged reads of this file still running
+  mutable std::atomic<int> pending_hedged_requests_{0};
 
   struct ReadAsyncInfo {
     ReadAsyncInfo(std::function<void(FSReadRequest&, void*)> cb, void* cb_arg,
@@ -127,17 +134,20 @@ class RandomAccessFileReader {
       RateLimiter* rate_limiter = nullptr,
       const std::vector<std::shared_ptr<EventListener>>& listeners = {},
       Temperature file_temperature = Temperature::kUnknown,
-      bool is_last_level = false)
+      bool is_last_level = false, HistogramImpl* path_read_hist = nullptr,
+      std::shared_ptr<HedgedReads> hedged_reads = nullptr)
       : file_(std::move(raf), io_tracer, _file_name),
         file_name_(std::move(_file_name)),
         clock_(clock),
         stats_(stats),
         hist_type_(hist_type),
         file_read_hist_(file_read_hist),
+        path_read_hist_(path_read_hist),
         rate_limiter_(rate_limiter),
         listeners_(),
         file_temperature_(file_temperature),
-        is_last_level_(is_last_level) {
+        is_last_level_(is_last_level),
+        hedged_reads_(std::move(hedged_reads)) {
     std::for_each(listeners.begin(), listeners.end(),
                   [this](const std::shared_ptr<EventListener>& e) {
                     if (e->ShouldBeNotifiedOnFileIO()) {
@@ -150,6 +160,12 @@ class RandomAccessFileReader {
                          const std::string& fname, const FileOptions& file_opts,
                          std::unique_ptr<RandomAccessFileReader>* reader,
                          IODebugContext* dbg);
+  ~RandomAccessFileReader() {
+    if (hedged_reads_ != nullptr) {
+      hedged_reads_->WaitForPending(&pending_hedged_requests_);
+    }
+  }
+
   RandomAccessFileReader(const RandomAccessFileReader&) = delete;
   RandomAccessFileReader& operator=(const RandomAccessFileReader&) = delete;
 
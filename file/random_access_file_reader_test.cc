@@ -8,6 +8,7 @@
 #include <algorithm>
 
 #include "file/file_util.h"
+#include "monitoring/histogram.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/file_system.h"
@@ -46,6 +47,10 @@ class RandomAccessFileReaderTest : public testing::Test {
                                              env_->GetSystemClock().get()));
   }
 
+  void Open(const std::string& fname, std::unique_ptr<FSRandomAccessFile>* f) {
+    ASSERT_OK(fs_->NewRandomAccessFile(Path(fname), FileOptions(), f, nullptr));
+  }
+
   void AssertResult(const std::string& content,
                     const std::vector<FSReadRequest>& reqs) {
     for (const auto& r : reqs) {
@@ -299,6 +304,69 @@ TEST_F(RandomAccessFileReaderTest, MultiReadDirectIO) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
 }
 
+TEST_F(RandomAccessFileReaderTest, HedgedRead) {
+  // A file whose reads are slow, except for the second requests of hedged
+  // reads.
+  class SlowFile : public FSRandomAccessFileOwnerWrapper {
+   public:
+    explicit SlowFile(std::unique_ptr<FSRandomAccessFile>&& f)
+        : FSRandomAccessFileOwnerWrapper(std::move(f)) {}
+
+    IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                  Slice* result, char* scratch,
+                  IODebugContext* dbg) const override {
+      if (options.property_bag.count(HedgedReads::kPropertyName) > 0) {
+        num_hedge_requests++;
+      } else if (slow) {
+        SystemClock::Default()->SleepForMicroseconds(500000);
+      }
+      return target()->Read(offset, n, options, result, scratch, dbg);
+    }
+
+    std::atomic<bool> slow{false};
+    mutable std::atomic<int> num_hedge_requests{0};
+  };
+
+  std::string fname = "hedged-read";
+  Random rand(0);
+  std::string content = rand.RandomString(4096);
+  Write(fname, content);
+  std::unique_ptr<FSRandomAccessFile> f;
+  Open(fname, &f);
+  auto* slow_file = new SlowFile(std::move(f));
+
+  // Reads are hedged after 50ms.
+  HistogramImpl read_hist;
+  for (int i = 0; i < 200; i++) {
+    read_hist.Add(50000);
+  }
+  auto hedged_reads = std::make_shared<HedgedReads>(
+      SystemClock::Default().get(), 2 /* num_threads */, 99.0,
+      100 /* budget_percent */);
+  std::unique_ptr<RandomAccessFileReader> r(new RandomAccessFileReader(
+      std::unique_ptr<FSRandomAccessFile>(slow_file), fname,
+      SystemClock::Default().get(), nullptr /* io_tracer */,
+      nullptr /* stats */, Histograms::HISTOGRAM_ENUM_MAX, &read_hist,
+      nullptr /* rate_limiter */, {} /* listeners */, Temperature::kUnknown,
+      false /* is_last_level */, nullptr /* path_read_hist */, hedged_reads));
+
+  std::string scratch(content.size(), '\0');
+  Slice result;
+  ASSERT_OK(r->Read(IOOptions(), 100, 1000, &result, &scratch[0], nullptr));
+  ASSERT_EQ(content.substr(100, 1000), result.ToString());
+  ASSERT_EQ(0U, hedged_reads->TEST_NumHedged());
+
+  // The slow request is overtaken by the second one.
+  slow_file->slow = true;
+  ASSERT_OK(r->Read(IOOptions(), 2000, 2000, &result, &scratch[0], nullptr));
+  ASSERT_EQ(content.substr(2000, 2000), result.ToString());
+  ASSERT_EQ(1U, hedged_reads->TEST_NumHedged());
+  ASSERT_EQ(1, slow_file->num_hedge_requests.load());
+
+  // Closing the file waits for the slow request.
+  r.reset();
+}
+
 TEST(FSReadRequest, Align) {
   FSReadRequest r;
   r.offset = 2000;
@@ -251,6 +251,18 @@ uint64_t SstFileManagerImpl::GetTotalTrashSize() {
   return delete_scheduler_.GetTotalTrashSize();
 }
 
+int32_t SstFileManagerImpl::GetNumTrashFiles() {
+  return delete_scheduler_.GetNumTrashFiles();
+}
+
+int SstFileManagerImpl::GetNumDeleteThreads() {
+  return delete_scheduler_.GetNumThreads();
+}
+
+void SstFileManagerImpl::SetNumDeleteThreads(int num_threads) {
+  delete_scheduler_.SetNumThreads(num_threads);
+}
+
 void SstFileManagerImpl::ReserveDiskBuffer(uint64_t size,
                                            const std::string& path) {
   MutexLock l(&mu_);
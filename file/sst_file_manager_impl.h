@@ -109,6 +109,15 @@ class SstFileManagerImpl : public SstFileManager {
   // Return the total size of trash files
   uint64_t GetTotalTrashSize() override;
 
+  // Return the number of trash files waiting to be deleted
+  int32_t GetNumTrashFiles() override;
+
+  // Return the number of background threads deleting trash files
+  int GetNumDeleteThreads() override;
+
+  // Update the number of background threads deleting trash files
+  void SetNumDeleteThreads(int num_threads) override;
+
   // Called by each DB instance using this sst file manager to reserve
   // disk buffer space for recovery from out of space errors
   void ReserveDiskBuffer(uint64_t buffer, const std::string& path);
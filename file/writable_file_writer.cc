@@ -81,7 +81,9 @@ IOStatus WritableFileWriter::Append(const IOOptions& opts, const Slice& data,
   // Calculate the checksum of appended data
   UpdateFileChecksum(data);
 
-  {
+  // With a background writer, the file is only prepared by the writes, which
+  // may be under way
+  if (background_writer_ == nullptr) {
     IOSTATS_TIMER_GUARD(prepare_write_nanos);
     TEST_SYNC_POINT("WritableFileWriter::Append:BeforePrepareWrite");
     writable_file_->PrepareWrite(static_cast<size_t>(GetFileSize()), left,
@@ -115,7 +117,11 @@ IOStatus WritableFileWriter::Append(const IOOptions& opts, const Slice& data,
         left -= appended;
         src += appended;
       }
-      s = Flush(io_options);
+      if (background_writer_ != nullptr) {
+        s = WriteInBackground(io_options);
+      } else {
+        s = Flush(io_options);
+      }
       if (!s.ok()) {
         set_seen_error(s);
         return s;
@@ -204,6 +210,100 @@ IOStatus WritableFileWriter::Append(const IOOptions& opts, const Slice& data,
   return s;
 }
 
+IOStatus WritableFileWriter::AppendV(const IOOptions& opts,
+                                     const std::vector<Slice>& data) {
+  size_t size = 0;
+  for (const Slice& slice : data) {
+    size += slice.size();
+  }
+  if (use_direct_io() || perform_data_verification_ ||
+      rate_limiter_ != nullptr || background_writer_ != nullptr ||
+      buf_.Capacity() - buf_.CurrentSize() >= size) {
+    IOStatus s;
+    for (const Slice& slice : data) {
+      s = Append(opts, slice);
+      if (!s.ok()) {
+        break;
+      }
+    }
+    return s;
+  }
+
+  if (seen_error()) {
+    return GetWriterHasPreviousErrorStatus();
+  }
+
+  StopWatch sw(clock_, stats_, hist_type_,
+               GetFileWriteHistograms(hist_type_, opts.io_activity));
+
+  const IOOptions io_options = FinalizeIOOptions(opts);
+  IOStatus s;
+  pending_sync_ = true;
+
+  for (const Slice& slice : data) {
+    UpdateFileChecksum(slice);
+  }
+
+  {
+    IOSTATS_TIMER_GUARD(prepare_write_nanos);
+    TEST_SYNC_POINT("WritableFileWriter::Append:BeforePrepareWrite");
+    writable_file_->PrepareWrite(static_cast<size_t>(GetFileSize()), size,
+                                 io_options, nullptr);
+  }
+
+  // The buffered data goes first, in the same write
+  std::vector<Slice> slices;
+  slices.reserve(data.size() + 1);
+  if (buf_.CurrentSize() > 0) {
+    slices.emplace_back(buf_.BufferStart(), buf_.CurrentSize());
+  }
+  slices.insert(slices.end(), data.begin(), data.end());
+  const size_t write_size = buf_.CurrentSize() + size;
+
+  {
+    IOSTATS_TIMER_GUARD(write_nanos);
+    TEST_SYNC_POINT("WritableFileWriter::Flush:BeforeAppend");
+
+    FileOperationInfo::StartTimePoint start_ts;
+    uint64_t old_size = writable_file_->GetFileSize(io_options, nullptr);
+    if (ShouldNotifyListeners()) {
+      start_ts = FileOperationInfo::StartNow();
+      old_size = next_write_offset_;
+    }
+    {
+      auto prev_perf_level = GetPerfLevel();
+
+      IOSTATS_CPU_TIMER_GUARD(cpu_write_nanos, clock_);
+      s = writable_file_->AppendV(slices.data(), slices.size(), io_options,
+                                  nullptr);
+      // Like in WriteBuffered(), the buffered data is not written again if
+      // the write failed
+      buf_.Size(0);
+      SetPerfLevel(prev_perf_level);
+    }
+    if (ShouldNotifyListeners()) {
+      auto finish_ts = std::chrono::steady_clock::now();
+      NotifyOnFileWriteFinish(old_size, write_size, start_ts, finish_ts, s);
+      if (!s.ok()) {
+        NotifyOnIOError(s, FileOperationType::kAppend, file_name(),
+                        write_size, old_size);
+      }
+    }
+  }
+
+  TEST_KILL_RANDOM("WritableFileWriter::Append:1");
+  if (s.ok()) {
+    IOSTATS_ADD(bytes_written, write_size);
+    uint64_t cur_size = flushed_size_.load(std::memory_order_acquire);
+    flushed_size_.store(cur_size + write_size, std::memory_order_release);
+    cur_size = filesize_.load(std::memory_order_acquire);
+    filesize_.store(cur_size + size, std::memory_order_release);
+  } else {
+    set_seen_error(s);
+  }
+  return s;
+}
+
 IOStatus WritableFileWriter::Pad(const IOOptions& opts,
                                  const size_t pad_bytes) {
   if (seen_error()) {
@@ -249,6 +349,8 @@ IOStatus WritableFileWriter::Pad(const IOOptions& opts,
 
 IOStatus WritableFileWriter::Close(const IOOptions& opts) {
   IOOptions io_options = FinalizeIOOptions(opts);
+  // The status of its last write is left to Flush()
+  StopBackgroundWriter();
   if (seen_error()) {
     IOStatus interim;
     if (writable_file_.get() != nullptr) {
@@ -361,7 +463,11 @@ IOStatus WritableFileWriter::Flush(const IOOptions& opts) {
 
   const IOOptions io_options = FinalizeIOOptions(opts);
 
-  IOStatus s;
+  IOStatus s = WaitForBackgroundWrite();
+  if (!s.ok()) {
+    set_seen_error(s);
+    return s;
+  }
   TEST_KILL_RANDOM_WITH_WEIGHT("WritableFileWriter::Flush:0", REDUCE_ODDS2);
 
   if (buf_.CurrentSize() > 0) {
@@ -387,12 +493,19 @@ IOStatus WritableFileWriter::Flush(const IOOptions& opts) {
     }
   }
 
+  return FlushFileAndRangeSync(io_options,
+                               filesize_.load(std::memory_order_acquire));
+}
+
+IOStatus WritableFileWriter::FlushFileAndRangeSync(const IOOptions& opts,
+                                                   uint64_t cur_size) {
+  IOStatus s;
   {
     FileOperationInfo::StartTimePoint start_ts;
     if (ShouldNotifyListeners()) {
       start_ts = FileOperationInfo::StartNow();
     }
-    s = writable_file_->Flush(io_options, nullptr);
+    s = writable_file_->Flush(opts, nullptr);
     if (ShouldNotifyListeners()) {
       auto finish_ts = std::chrono::steady_clock::now();
       NotifyOnFileFlushFinish(start_ts, finish_ts, s);
@@ -422,15 +535,13 @@ IOStatus WritableFileWriter::Flush(const IOOptions& opts) {
     const uint64_t kBytesNotSyncRange =
         1024 * 1024;                                // recent 1MB is not synced.
     const uint64_t kBytesAlignWhenSync = 4 * 1024;  // Align 4KB.
-    uint64_t cur_size = filesize_.load(std::memory_order_acquire);
     if (cur_size > kBytesNotSyncRange) {
       uint64_t offset_sync_to = cur_size - kBytesNotSyncRange;
       offset_sync_to -= offset_sync_to % kBytesAlignWhenSync;
       assert(offset_sync_to >= last_sync_size_);
       if (offset_sync_to > 0 &&
           offset_sync_to - last_sync_size_ >= bytes_per_sync_) {
-        s = RangeSync(io_options, last_sync_size_,
-                      offset_sync_to - last_sync_size_);
+        s = RangeSync(opts, last_sync_size_, offset_sync_to - last_sync_size_);
         if (!s.ok()) {
           set_seen_error(s);
         }
@@ -580,8 +691,39 @@ IOStatus WritableFileWriter::WriteBuffered(const IOOptions& opts,
     return GetWriterHasPreviousErrorStatus();
   }
 
+  IOStatus s = WaitForBackgroundWrite();
+  if (s.ok()) {
+    s = WriteBufferedData(opts, data, size);
+  }
+  // If writable_file_->Append() failed, then the data may or may not exist in
+  // the underlying memory buffer, OS page cache, remote file system's buffer,
+  // etc. If WritableFileWriter keeps the data in buf_, then a future Close()
+  // or write retry may send the data to the underlying file again. If the data
+  // does exist in the underlying buffer and gets written to the file
+  // eventually despite returning error, the file may end up with two
+  // duplicate pieces of data. Therefore, clear the buf_ at the
+  // WritableFileWriter layer and let caller determine error handling.
+  buf_.Size(0);
+  buffered_data_crc32c_checksum_ = 0;
+  if (!s.ok()) {
+    set_seen_error(s);
+  }
+  return s;
+}
+
+IOStatus WritableFileWriter::WriteBufferedData(const IOOptions& opts,
+                                               const char* data, size_t size) {
+  if (seen_error()) {
+    return GetWriterHasPreviousErrorStatus();
+  }
+
   IOStatus s;
   assert(!use_direct_io());
+  if (background_writer_ != nullptr) {
+    IOSTATS_TIMER_GUARD(prepare_write_nanos);
+    writable_file_->PrepareWrite(static_cast<size_t>(GetFlushedSize()), size,
+                                 opts, nullptr);
+  }
   const char* src = data;
   size_t left = size;
   DataVerificationInfo v_info;
@@ -619,19 +761,6 @@ IOStatus WritableFileWriter::WriteBuffered(const IOOptions& opts,
         } else {
           s = writable_file_->Append(Slice(src, allowed), opts, nullptr);
         }
-        if (!s.ok()) {
-          // If writable_file_->Append() failed, then the data may or may not
-          // exist in the underlying memory buffer, OS page cache, remote file
-          // system's buffer, etc. If WritableFileWriter keeps the data in
-          // buf_, then a future Close() or write retry may send the data to
-          // the underlying file again. If the data does exist in the
-          // underlying buffer and gets written to the file eventually despite
-          // returning error, the file may end up with two duplicate pieces of
-          // data. Therefore, clear the buf_ at the WritableFileWriter layer
-          // and let caller determine error handling.
-          buf_.Size(0);
-          buffered_data_crc32c_checksum_ = 0;
-        }
         SetPerfLevel(prev_perf_level);
       }
       if (ShouldNotifyListeners()) {
@@ -656,14 +785,107 @@ IOStatus WritableFileWriter::WriteBuffered(const IOOptions& opts,
     uint64_t cur_size = flushed_size_.load(std::memory_order_acquire);
     flushed_size_.store(cur_size + allowed, std::memory_order_release);
   }
-  buf_.Size(0);
-  buffered_data_crc32c_checksum_ = 0;
   if (!s.ok()) {
     set_seen_error(s);
   }
   return s;
 }
 
+IOStatus WritableFileWriter::WriteInBackground(const IOOptions& opts) {
+  BackgroundWriter* const bw = background_writer_.get();
+  assert(bw != nullptr);
+  IOStatus s = WaitForBackgroundWrite();
+  if (!s.ok()) {
+    return s;
+  }
+  const size_t capacity = buf_.Capacity();
+  {
+    std::unique_lock<std::mutex> lock(bw->mutex);
+    if (bw->stop) {
+      lock.unlock();
+      return Flush(opts);
+    }
+    assert(bw->buf.CurrentSize() == 0);
+    std::swap(buf_, bw->buf);
+    bw->opts = opts;
+    bw->perf_level = GetPerfLevel();
+    bw->pending = true;
+    if (!bw->thread.joinable()) {
+      bw->thread = port::Thread(&WritableFileWriter::BackgroundWriteLoop, this);
+    }
+  }
+  bw->cv.notify_all();
+  TEST_SYNC_POINT("WritableFileWriter::WriteInBackground:HandedOver");
+  if (buf_.Capacity() < capacity) {
+    buf_.AllocateNewBuffer(capacity);
+  }
+  return s;
+}
+
+IOStatus WritableFileWriter::WaitForBackgroundWrite() {
+  BackgroundWriter* const bw = background_writer_.get();
+  if (bw == nullptr) {
+    return IOStatus::OK();
+  }
+  std::unique_lock<std::mutex> lock(bw->mutex);
+  bw->cv.wait(lock, [bw] { return !bw->pending; });
+  IOSTATS_ADD(bytes_written, bw->bytes_written);
+  IOSTATS_ADD(write_nanos, bw->write_nanos);
+  IOSTATS_ADD(range_sync_nanos, bw->range_sync_nanos);
+  bw->bytes_written = 0;
+  bw->write_nanos = 0;
+  bw->range_sync_nanos = 0;
+  IOStatus s = bw->status;
+  bw->status = IOStatus::OK();
+  return s;
+}
+
+void WritableFileWriter::StopBackgroundWriter() {
+  BackgroundWriter* const bw = background_writer_.get();
+  if (bw == nullptr) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(bw->mutex);
+    bw->cv.wait(lock, [bw] { return !bw->pending; });
+    bw->stop = true;
+  }
+  bw->cv.notify_all();
+  if (bw->thread.joinable()) {
+    bw->thread.join();
+  }
+}
+
+void WritableFileWriter::BackgroundWriteLoop() {
+  BackgroundWriter* const bw = background_writer_.get();
+  std::unique_lock<std::mutex> lock(bw->mutex);
+  while (true) {
+    bw->cv.wait(lock, [bw] { return bw->pending || bw->stop; });
+    if (!bw->pending) {
+      break;
+    }
+    lock.unlock();
+    TEST_SYNC_POINT("WritableFileWriter::BackgroundWriteLoop:BeforeWrite");
+    SetPerfLevel(bw->perf_level);
+    const uint64_t prev_bytes_written = IOSTATS(bytes_written);
+    const uint64_t prev_write_nanos = IOSTATS(write_nanos);
+    const uint64_t prev_range_sync_nanos = IOSTATS(range_sync_nanos);
+    IOStatus s = WriteBufferedData(bw->opts, bw->buf.BufferStart(),
+                                   bw->buf.CurrentSize());
+    if (s.ok()) {
+      s = FlushFileAndRangeSync(bw->opts, GetFlushedSize());
+    }
+    lock.lock();
+    bw->bytes_written += IOSTATS(bytes_written) - prev_bytes_written;
+    bw->write_nanos += IOSTATS(write_nanos) - prev_write_nanos;
+    bw->range_sync_nanos += IOSTATS(range_sync_nanos) - prev_range_sync_nanos;
+    bw->status = s;
+    bw->buf.Size(0);
+    bw->pending = false;
+    bw->cv.notify_all();
+  }
+}
+
 IOStatus WritableFileWriter::WriteBufferedWithChecksum(const IOOptions& opts,
                                                        const char* data,
                                                        size_t size) {
@@ -9,7 +9,10 @@
 
 #pragma once
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "db/version_edit.h"
 #include "env/file_system_tracer.h"
@@ -19,6 +22,7 @@
 #include "rocksdb/file_system.h"
 #include "rocksdb/io_status.h"
 #include "rocksdb/listener.h"
+#include "rocksdb/perf_level.h"
 #include "rocksdb/rate_limiter.h"
 #include "test_util/sync_point.h"
 #include "util/aligned_buffer.h"
@@ -168,6 +172,28 @@ class WritableFileWriter {
   bool buffered_data_with_checksum_;
   Temperature temperature_;
 
+  // Writes the full buffers handed over by Append() on a thread of its own
+  // while the next buffer is filled, see EnvOptions::use_background_writes
+  struct BackgroundWriter {
+    std::mutex mutex;
+    std::condition_variable cv;
+    // The buffer being written while `pending`, otherwise empty and ready to
+    // be swapped with buf_
+    AlignedBuffer buf;
+    IOOptions opts;
+    PerfLevel perf_level = PerfLevel::kDisable;
+    bool pending = false;
+    bool stop = false;
+    // Status of the last write, until WaitForBackgroundWrite() returns it
+    IOStatus status;
+    // IO stats of the writes, added to the thread waiting for them
+    uint64_t bytes_written = 0;
+    uint64_t write_nanos = 0;
+    uint64_t range_sync_nanos = 0;
+    port::Thread thread;
+  };
+  std::unique_ptr<BackgroundWriter> background_writer_;
+
  public:
   WritableFileWriter(
       std::unique_ptr<FSWritableFile>&& file, const std::string& _file_name,
@@ -209,6 +235,11 @@ class WritableFileWriter {
                              reinterpret_cast<void*>(max_buffer_size_));
     buf_.Alignment(writable_file_->GetRequiredBufferAlignment());
     buf_.AllocateNewBuffer(std::min((size_t)65536, max_buffer_size_));
+    if (options.use_background_writes && !use_direct_io() &&
+        !perform_data_verification_) {
+      background_writer_.reset(new BackgroundWriter());
+      background_writer_->buf.Alignment(buf_.Alignment());
+    }
     std::for_each(listeners.begin(), listeners.end(),
                   [this](const std::shared_ptr<EventListener>& e) {
                     if (e->ShouldBeNotifiedOnFileIO()) {
@@ -256,6 +287,13 @@ class WritableFileWriter {
   IOStatus Append(const IOOptions& opts, const Slice& data,
                   uint32_t crc32c_checksum = 0);
 
+  // Appends the concatenation of the slices in data. When they do not fit in
+  // the buffer, they are written together with the buffered data by a single
+  // FSWritableFile::AppendV(), straight from the caller's memory. Otherwise,
+  // and with direct I/O, checksum handoff or a rate limiter, it is the same
+  // as appending the slices one by one.
+  IOStatus AppendV(const IOOptions& opts, const std::vector<Slice>& data);
+
   IOStatus Pad(const IOOptions& opts, const size_t pad_bytes);
 
   IOStatus Flush(const IOOptions& opts);
@@ -358,6 +396,21 @@ class WritableFileWriter {
   // Normal write.
   // `opts` should've been called with `FinalizeIOOptions()` before passing in
   IOStatus WriteBuffered(const IOOptions& opts, const char* data, size_t size);
+  // WriteBuffered() without clearing buf_, so that it can write the buffer of
+  // the background writer.
+  IOStatus WriteBufferedData(const IOOptions& opts, const char* data,
+                             size_t size);
+  // Flushes the file, and range syncs all but the last 1MB of its first
+  // `cur_size` bytes every bytes_per_sync_.
+  IOStatus FlushFileAndRangeSync(const IOOptions& opts, uint64_t cur_size);
+  // Hands buf_ over to the background writer, and takes its empty buffer,
+  // once its previous write is done.
+  IOStatus WriteInBackground(const IOOptions& opts);
+  // Waits for the write of the background writer, if any, and returns its
+  // status. Required before anything else writes to the file.
+  IOStatus WaitForBackgroundWrite();
+  void StopBackgroundWriter();
+  void BackgroundWriteLoop();
   // `opts` should've been called with `FinalizeIOOptions()` before passing in
   IOStatus WriteBufferedWithChecksum(const IOOptions& opts, const char* data,
                                      size_t size);
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -368,6 +369,18 @@ class Cache : public Customizable {
   // Returns the memory size for a specific entry in the cache.
   virtual size_t GetUsage(Handle* handle) const = 0;
 
+  // EXPERIMENTAL
+  // If the cache maintains charges by CacheEntryRole as entries are inserted
+  // and removed, sets `charges` and `counts` to the total charge and number
+  // of the entries currently in the cache for each role (indexed by the
+  // role's integer value), and returns true. This is much cheaper than
+  // gathering the same through ApplyToAllEntries(). Returns false otherwise.
+  virtual bool GetChargesByRole(
+      std::array<size_t, kNumCacheEntryRoles>* /*charges*/,
+      std::array<size_t, kNumCacheEntryRoles>* /*counts*/) const {
+    return false;
+  }
+
   // Returns the memory size for the entries in use by the system
   virtual size_t GetPinnedUsage() const = 0;
 
@@ -385,6 +398,25 @@ class Cache : public Customizable {
     return Status::NotSupported();
   }
 
+  // Inserts an entry into the secondary cache of this cache, if any, without
+  // inserting it into this cache. As with SecondaryCache::Insert(), the
+  // caller retains ownership of `value`, whose persistable data is saved
+  // through `helper`, which must be secondary cache compatible. The entry is
+  // inserted even if the secondary cache would otherwise only admit it on a
+  // later insertion. Returns NotSupported() if there is no secondary cache.
+  virtual Status InsertIntoSecondaryCache(const Slice& /*key*/,
+                                          ObjectPtr /*value*/,
+                                          const CacheItemHelper* /*helper*/) {
+    return Status::NotSupported();
+  }
+
+  // Returns an estimate, at most 15, of how many times `key` was looked up
+  // recently, whether or not it is in the cache, if the cache tracks it (see
+  // HyperClockCacheOptions::track_access_frequency). Returns 0 otherwise.
+  virtual uint32_t GetAccessFrequency(const Slice& /*key*/) const {
+    return 0;
+  }
+
   // Call this on shutdown if you want to speed it up. Cache will disown
   // any underlying data and will not free it on delete. This call will leak
   // memory - call this only if you're shutting down the process.
@@ -530,6 +562,13 @@ class Cache : public Customizable {
   // SecondaryCache configured.)
   virtual void StartAsyncLookup(AsyncLookupHandle& async_handle);
 
+  // Same as StartAsyncLookup() on each of an array of async handles, to be
+  // followed by WaitAll() in the same way, but lets the implementation
+  // amortize the work over the batch, e.g. by hashing all the keys up front
+  // and looking up the keys of the same shard together. Default
+  // implementation calls StartAsyncLookup() on each of them.
+  virtual void MultiLookup(AsyncLookupHandle* async_handles, size_t count);
+
   // A convenient wrapper around WaitAll() and AsyncLookupHandle::Result()
   // for a single async handle. See StartAsyncLookup().
   Handle* Wait(AsyncLookupHandle& async_handle);
@@ -629,6 +668,12 @@ class CacheWrapper : public Cache {
     return target_->GetUsage(handle);
   }
 
+  bool GetChargesByRole(
+      std::array<size_t, kNumCacheEntryRoles>* charges,
+      std::array<size_t, kNumCacheEntryRoles>* counts) const override {
+    return target_->GetChargesByRole(charges, counts);
+  }
+
   size_t GetPinnedUsage() const override { return target_->GetPinnedUsage(); }
 
   size_t GetCharge(Handle* handle) const override {
@@ -639,6 +684,15 @@ class CacheWrapper : public Cache {
     return target_->GetCacheItemHelper(handle);
   }
 
+  Status InsertIntoSecondaryCache(const Slice& key, ObjectPtr value,
+                                  const CacheItemHelper* helper) override {
+    return target_->InsertIntoSecondaryCache(key, value, helper);
+  }
+
+  uint32_t GetAccessFrequency(const Slice& key) const override {
+    return target_->GetAccessFrequency(key);
+  }
+
   void ApplyToAllEntries(
       const std::function<void(const Slice& key, ObjectPtr value, size_t charge,
                                const CacheItemHelper* helper)>& callback,
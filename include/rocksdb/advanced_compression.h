@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "rocksdb/cache.h"
 #include "rocksdb/compression_type.h"
 #include "rocksdb/data_structure.h"
@@ -507,4 +509,44 @@ class CompressionManagerWrapper : public CompressionManager {
 const std::shared_ptr<CompressionManager>&
 GetDefaultBuiltinCompressionManager();
 
+// Options for NewAdaptiveCompressionManager()
+struct AdaptiveCompressionOptions {
+  struct Candidate {
+    CompressionType type = kNoCompression;
+    // As CompressionOptions::level
+    int level = CompressionOptions::kDefaultCompressionLevel;
+  };
+  // The compressions to choose from for the data blocks. They do not use
+  // compression dictionaries.
+  std::vector<Candidate> candidates;
+
+  // The first data block of a file, and every sample_interval-th one after
+  // it, is compressed with all of the candidates. The best of them is then
+  // used for the following blocks, up to the next sample.
+  uint32_t sample_interval = 64;
+
+  // The budget of compression time, in nanoseconds per KiB of input, of the
+  // files created at each level. The last entry applies to the levels after
+  // it, and an empty vector means no budget. On a sample, the candidate
+  // with the smallest output within the budget is picked, or the fastest
+  // one if none is within it.
+  //
+  // For example, {5000, 5000, 50000} with LZ4 and ZSTD level 9 candidates
+  // tends to use LZ4 for the hot levels 0 and 1, and ZSTD further down.
+  std::vector<uint64_t> max_nanos_per_kb;
+};
+
+// EXPERIMENTAL
+// Returns a CompressionManager that picks the compression of the data blocks
+// of each SST file from options.candidates, by trying them on samples of
+// the blocks. The compression type of each block is recorded along with it,
+// so files are readable with the decompressors of `base`, defaulting to the
+// built-in CompressionManager. A file whose blocks are not all compressed
+// the same way still has the compression of the column family in its
+// compression_name table property, which should be kZSTD if ZSTD is among
+// the candidates. Other compressions are left to `base`.
+std::shared_ptr<CompressionManager> NewAdaptiveCompressionManager(
+    const AdaptiveCompressionOptions& options,
+    std::shared_ptr<CompressionManager> base = nullptr);
+
 }  // namespace ROCKSDB_NAMESPACE
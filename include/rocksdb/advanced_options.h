@@ -19,6 +19,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Slice;
 class SliceTransform;
+class Statistics;
 class TablePropertiesCollectorFactory;
 class TableFactory;
 struct Options;
@@ -59,6 +60,15 @@ enum CompactionPri : char {
   // level. The file picking process will cycle through all the files in a
   // round-robin manner.
   kRoundRobin = 0x4,
+  // EXPERIMENTAL
+  // Like kMinOverlappingRatio, but the ratio of a file is scaled up by how
+  // often it is read compared to the other files of its level, by at most a
+  // factor of 4. Compacting a file drops its blocks from the block cache, so
+  // among files with similar overlapping ratios the cold ones are picked
+  // first, and hot ones are deferred while the extra write amplification of
+  // compacting others instead stays bounded. Reads are counted per file by
+  // sampling, and the counters start from zero after the DB is reopened.
+  kHotnessAware = 0x5,
 };
 
 struct FileTemperatureAge {
@@ -83,6 +93,17 @@ struct CompactionOptionsFIFO {
   // Default: false;
   bool allow_compaction = false;
 
+  // EXPERIMENTAL
+  // When not 0 and allow_compaction is true, the compaction of smaller files
+  // into larger ones partitions the files into windows of this many seconds
+  // by the newest key time of each file, instead of going by size. The files
+  // of each window are compacted together once the window is over, and never
+  // with the files of another window, so that TTL deletes data by whole
+  // windows. A window takes more than one file when its files are larger
+  // than max_compaction_bytes.
+  // Default: 0 (disabled)
+  uint64_t time_window_seconds = 0;
+
   // DEPRECATED
   // When not 0, if the data in the file is older than this threshold, RocksDB
   // will soon move the file to warm temperature.
@@ -140,6 +161,96 @@ struct CompactionOptionsFIFO {
 #endif
 };
 
+// What the post-compaction warmup of a column family loads into the block
+// cache. See CompactionWarmupPolicy.
+enum class CompactionWarmupMode : uint8_t {
+  // The output files of compactions are not warmed.
+  kDisabled = 0x0,
+  // The data blocks of the output files are warmed, up to the byte budget.
+  kOutputFiles = 0x1,
+  // Only the parts of the output files overlapping the key ranges that were
+  // hot in the compaction inputs are warmed (see
+  // BlockBasedTableOptions::warmup_min_data_block_hits). If the hotness of
+  // the inputs is not known, e.g. because the table format does not track
+  // it, this behaves like kOutputFiles.
+  kHotKeyRanges = 0x2,
+};
+
+// EXPERIMENTAL
+// Per column family control of the post-compaction warmup, which reloads
+// into the block cache the data that compactions dropped from it. Warmup jobs
+// only run if DBOptions::max_background_warmups is non-zero.
+//
+// Dynamically changeable through the SetOptions() API, e.g.,
+//   SetOptions({{"compaction_warmup_policy",
+//                "{mode=kHotKeyRanges;max_output_level=2}"}})
+struct CompactionWarmupPolicy {
+  // Default: kDisabled
+  CompactionWarmupMode mode = CompactionWarmupMode::kDisabled;
+
+  // Only compactions whose output level is at most this are warmed. -1 means
+  // no limit.
+  //
+  // Default: -1
+  int max_output_level = -1;
+
+  // Upper bound on the bytes read by the warmup of a single compaction. Once
+  // this much has been read, the warmup does not start on another file or key
+  // range, so the budget may be exceeded by up to the size of one output
+  // file. 0 means no limit.
+  //
+  // Default: 0
+  uint64_t max_bytes_per_compaction = 0;
+
+  // Warmed data blocks are inserted into the block cache at
+  // Cache::Priority::BOTTOM. If true, the warmup also stops once loading the
+  // next block would push the block cache usage over its capacity, so that it
+  // never evicts blocks that were actually read to make room for blocks that
+  // may never be. It then only fills the room that is left, e.g. the room
+  // freed by erasing the blocks of the compaction inputs (see
+  // `uncache_aggressiveness`). What is skipped is reported in the
+  // "rocksdb.warmup-stats" property and the WARMUP_*_SKIPPED tickers.
+  //
+  // Default: true
+  bool stop_at_cache_capacity = true;
+
+  // If true and the output files have a partitioned index
+  // (kTwoLevelIndexSearch) or partitioned filters, all their index and filter
+  // partitions are loaded into the block cache before any data block, so that
+  // the first lookups in the new files do not have to read them. Partitions
+  // are comparatively small and needed by every lookup, so they are loaded
+  // regardless of the hot key ranges and of `stop_at_cache_capacity`.
+  //
+  // Default: true
+  bool warm_index_and_filter_partitions = true;
+
+  // Output files at this level or higher have their data blocks warmed into
+  // the secondary cache of the block cache (e.g. the compressed tier of a
+  // NewTieredCache(), or the LRUCacheOptions::secondary_cache), rather than
+  // into the primary cache. Colder levels then cost less memory while still
+  // saving the reads from storage. Without a secondary cache the primary one
+  // is used. `stop_at_cache_capacity` only applies to the primary cache.
+  // -1 means always the primary cache.
+  //
+  // Default: -1
+  int secondary_cache_min_output_level = -1;
+
+  // If true, the blobs that blob garbage collection relocates to new blob
+  // files and that were in the primary tier of the blob cache are inserted
+  // into the blob cache under their new location, as the compaction writes
+  // them, so that reads keep hitting the cache once the compaction is
+  // installed. Unlike the rest of the policy, this happens during the
+  // compaction itself, so it applies regardless of `mode` and of
+  // DBOptions::max_background_warmups.
+  //
+  // Default: false
+  bool warm_relocated_blobs = false;
+
+#if __cplusplus >= 202002L
+  bool operator==(const CompactionWarmupPolicy& rhs) const = default;
+#endif
+};
+
 // The control option of how the cache tiers will be used. Currently rocksdb
 // support block cache (volatile tier), secondary cache (non-volatile tier).
 // In the future, we may add more caching layers.
@@ -323,6 +434,21 @@ struct AdvancedColumnFamilyOptions {
                                    Slice delta_value,
                                    std::string* merged_value) = nullptr;
 
+  // EXPERIMENTAL
+  // Applicable only when inplace_update_support is true. A Merge(key, operand)
+  // whose latest version in the current memtable is also a merge operand is
+  // combined with it through MergeOperator::PartialMerge(), and the result
+  // overwrites the existing operand in place if it is no larger. This bounds
+  // the number of operands a read has to fold for hot keys of associative
+  // merge operators such as counters (see AssociativeMergeOperator).
+  // Otherwise the operand is added to the memtable as usual.
+  //
+  // As with inplace_update_support, the transaction log still contains every
+  // operand, so PartialMerge() must be deterministic across db reopens.
+  //
+  // Default: false
+  bool inplace_merge_support = false;
+
   // Should really be called `memtable_bloom_size_ratio`. Enables a dynamic
   // Bloom filter in memtable to optimize many queries that must go beyond
   // the memtable. The size in bytes of the filter is
@@ -360,6 +486,79 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t memtable_huge_page_size = 0;
 
+  // EXPERIMENTAL
+  // If not nullptr, the memtable entries of at least
+  // `memtable_tier_min_entry_size` bytes, i.e. the ones with large values,
+  // are placed in arena blocks allocated from this allocator, while the
+  // smaller entries, the memtable bloom filter and the other memtable
+  // structures stay in the blocks allocated from the heap. An allocator of a
+  // slower and larger memory tier, such as NewMemkindKmemAllocator() for
+  // PMem or CXL memory exposed as a NUMA node, then allows for larger write
+  // buffers without as much DRAM. The key of such an entry is placed along
+  // with its value. The tier memory counts toward `write_buffer_size` and
+  // the WriteBufferManager as the rest does.
+  //
+  // Default: nullptr (disabled)
+  //
+  // Not dynamically changeable
+  std::shared_ptr<MemoryAllocator> memtable_tier_allocator = nullptr;
+
+  // EXPERIMENTAL
+  // See `memtable_tier_allocator`.
+  //
+  // Default: 1024
+  //
+  // Not dynamically changeable
+  size_t memtable_tier_min_entry_size = 1024;
+
+  // EXPERIMENTAL
+  // If not kNoCompression, the values of Put() of at least
+  // `memtable_value_compression_min_size` bytes are compressed with this
+  // compression type when they are inserted in the memtable, and
+  // uncompressed when they are read from it, if that saves space. The
+  // memtable then holds more data before it is flushed, at the CPU cost of
+  // the compression and of the uncompression on each read. Values read by
+  // an iterator over the memtable are not pinned. Every value of Put() in
+  // the memtable takes one more byte. Ignored with inplace_update_support or
+  // memtable_protection_bytes_per_key, or if the compression type is not
+  // supported.
+  //
+  // Default: kNoCompression
+  //
+  // Not dynamically changeable
+  CompressionType memtable_value_compression = kNoCompression;
+
+  // EXPERIMENTAL
+  // See `memtable_value_compression`.
+  //
+  // Default: 1024
+  //
+  // Not dynamically changeable
+  size_t memtable_value_compression_min_size = 1024;
+
+  // EXPERIMENTAL
+  // If larger than 0, each memtable gets a lock-free hash index of size
+  // write_buffer_size * memtable_point_lookup_index_ratio bytes, next to the
+  // memtable rep. Each of its buckets holds the newest entry of one of the
+  // user keys hashing to it, in general the most recently written one. A
+  // Get() or MultiGet() whose key is there, and whose newest version in the
+  // memtable is a value or a deletion visible to the read, then takes it
+  // from the hash index without searching the memtable rep, which makes
+  // lookups of recently written hot keys O(1). Other lookups search the
+  // memtable rep as usual.
+  //
+  // Ignored with inplace_update_support, user-defined timestamps, or a
+  // comparator under which keys with different bytes can be equal. Not used
+  // by reads with a ReadCallback, as in transactions, or with
+  // paranoid_memory_checks.
+  //
+  // If this value is larger than 0.25, it is sanitized to 0.25.
+  //
+  // Default: 0 (disabled)
+  //
+  // Not dynamically changeable
+  double memtable_point_lookup_index_ratio = 0.0;
+
   // If non-nullptr, memtable will use the specified function to extract
   // prefixes for keys, and for each prefix maintain a hint of insert location
   // to reduce CPU usage for inserting keys with the prefix. Keys out of
@@ -841,6 +1040,29 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   Temperature default_write_temperature = Temperature::kUnknown;
 
+  // EXPERIMENTAL
+  // If nonzero, a file of the last level written with last_level_temperature
+  // that gets this many reads is rewritten by a compaction within the last
+  // level, with default_write_temperature instead, so that data that turned
+  // hot again moves back to the faster storage. If DBOptions::
+  // max_background_warmups is nonzero, the output files are then warmed into
+  // the block cache as per compaction_warmup_policy, regardless of its
+  // max_output_level and at least in mode kOutputFiles, so that the promoted
+  // data is already cached when reads move over to it. The data goes back to
+  // last_level_temperature the next time a compaction into the last level
+  // rewrites it.
+  //
+  // The reads are sampled (see FileMetaData::stats), and the files are only
+  // checked when the compaction scores are computed, e.g. after flushes and
+  // compactions. Only supported by level compaction, and ignored when
+  // last_level_temperature is kUnknown or the same as
+  // default_write_temperature.
+  //
+  // Default: 0 (disabled)
+  //
+  // Dynamically changeable through the SetOptions() API
+  uint64_t last_level_promotion_reads = 0;
+
   // EXPERIMENTAL
   // When this field is set, all SST files without an explicitly set temperature
   // will be treated as if they have this temperature for file reading
@@ -915,6 +1137,21 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   uint64_t min_blob_size = 0;
 
+  // EXPERIMENTAL
+  // If nonzero, each compaction picks its own minimum blob size, so that
+  // about this percentage of the values, the largest ones, go to blob files.
+  // It is taken from the sizes of the values written by recent compactions
+  // of the column family, and min_blob_size is its lower bound. It is raised
+  // further, up to four times, when the input files are read more often than
+  // their entries are rewritten, to keep more of those values inline. Values
+  // already in blob files are not rewritten for this, but the ones relocated
+  // by blob garbage collection can be inlined. Flushes use min_blob_size.
+  //
+  // Default: 0 (always min_blob_size)
+  //
+  // Dynamically changeable through the SetOptions() API
+  uint32_t blob_separation_percent = 0;
+
   // The size limit for blob files. When writing blob files, a new file is
   // opened once this limit is reached. Note that enable_blob_files has to be
   // set in order for this option to have any effect.
@@ -937,8 +1174,9 @@ struct AdvancedColumnFamilyOptions {
   // compaction. Valid blobs residing in blob files older than a cutoff get
   // relocated to new files as they are encountered during compaction, which
   // makes it possible to clean up blob files once they contain nothing but
-  // obsolete/garbage blobs. See also blob_garbage_collection_age_cutoff and
-  // blob_garbage_collection_force_threshold below.
+  // obsolete/garbage blobs. See also blob_garbage_collection_age_cutoff,
+  // blob_garbage_collection_force_threshold and
+  // blob_garbage_collection_file_threshold below.
   //
   // Default: false
   //
@@ -968,6 +1206,21 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   double blob_garbage_collection_force_threshold = 1.0;
 
+  // If the ratio of garbage in a blob file reaches this threshold, the blob
+  // file is garbage collected regardless of its age: compactions relocate its
+  // valid blobs, and if no compaction is forced by
+  // blob_garbage_collection_force_threshold, targeted compactions are
+  // scheduled for the SST files that reference the blob file with the highest
+  // ratio of garbage as their oldest one. This option is currently only
+  // supported with leveled compactions. Note that
+  // enable_blob_garbage_collection has to be set in order for this option to
+  // have any effect.
+  //
+  // Default: 1.0
+  //
+  // Dynamically changeable through the SetOptions() API
+  double blob_garbage_collection_file_threshold = 1.0;
+
   // Compaction readahead for blob files.
   //
   // Default: 0
@@ -1027,6 +1280,16 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API.
   uint32_t memtable_protection_bytes_per_key = 0;
 
+  // With memtable_protection_bytes_per_key, the reads (Get() and iterators)
+  // only verify the checksum of about one in this many memtable entries they
+  // return, chosen at random. 0 means reads do not verify the checksums. Flush
+  // always verifies every entry it writes out, so a corrupted entry is still
+  // caught before it is persisted, while the reads pay less for the checksums.
+  //
+  // Default: 1 (reads verify every entry)
+  // Dynamically changeable through the SetOptions() API.
+  uint32_t memtable_protection_verify_one_in = 1;
+
   // UNDER CONSTRUCTION -- DO NOT USE
   // When the user-defined timestamp feature is enabled, this flag controls
   // whether the user-defined timestamps will be persisted.
@@ -1146,6 +1409,89 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API.
   uint32_t memtable_avg_op_scan_flush_trigger = 0;
 
+  // EXPERIMENTAL
+  // Which compactions of this column family are followed by a warmup of
+  // their output files, and how much of the outputs is warmed. See
+  // CompactionWarmupPolicy.
+  //
+  // Default: disabled
+  //
+  // Dynamically changeable through the SetOptions() API
+  CompactionWarmupPolicy compaction_warmup_policy;
+
+  // EXPERIMENTAL
+  // With leveled compaction, a flush places its output files on the lowest
+  // level that they fit in, the way IngestExternalFile() does, instead of
+  // always on L0: the files go below L0 if their key range overlaps neither
+  // the files of the levels above nor the outputs of running compactions.
+  // Workloads writing non-overlapping key ranges, e.g. sequential or
+  // range-partitioned loads, then skip the L0->Ln compactions of the data.
+  //
+  // Only the flush of the oldest unflushed memtables can go below L0, and
+  // never with atomic_flush. The last level is not used when data is kept
+  // off it, e.g. with allow_ingest_behind or
+  // preclude_last_level_data_seconds. Ignored by other compaction styles.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through the SetOptions() API
+  bool allow_flush_below_level0 = false;
+
+  // EXPERIMENTAL
+  // If not nullptr, the statistics of the operations on this column family,
+  // such as reads of its table files, block cache and bloom filter lookups,
+  // memtable updates, iterators, flushes and compactions, are recorded into
+  // this object, e.g. one created with CreateDBStatistics(), as well as into
+  // DBOptions::statistics. This gives each column family, e.g. of a tenant,
+  // its own tickers and histograms. Statistics of operations on the whole DB,
+  // such as those of the WAL, are only recorded into DBOptions::statistics.
+  // The stats levels of both objects are taken when the column family is
+  // opened.
+  //
+  // Default: nullptr
+  //
+  // Not dynamically changeable
+  std::shared_ptr<Statistics> cf_statistics = nullptr;
+
+  // EXPERIMENTAL
+  // If true, each table file written by a bottommost compaction gets an
+  // in-memory hash index from the fingerprints of its user keys to the data
+  // blocks holding them. A point lookup in such a file then probes the hash
+  // index in place of the filter and the index block: a key absent from the
+  // file costs no block read, and a present one a single data block read.
+  // This mostly helps leveled compaction, where most of the data, and so of
+  // the point lookups that miss the upper levels, end up in the last level.
+  //
+  // The hash indexes are not persisted, so files from before the DB was
+  // opened, or ingested or moved into the bottommost level, are read as
+  // usual until they are compacted again. Their memory, about 16 bytes per
+  // distinct user key, is charged to the block cache under
+  // CacheEntryRole::kBottommostHashIndex; a file whose hash index does not
+  // fit under a strict capacity limit goes without. Only supported with
+  // BlockBasedTable and without user-defined timestamps; ignored otherwise.
+  //
+  // Default: false
+  //
+  // Not dynamically changeable
+  bool bottommost_hash_index = false;
+
+  // EXPERIMENTAL
+  // With leveled compaction, a file picked to compact down from level L is
+  // usually rewritten, together with the files of level L+1 that it
+  // overlaps, even when those are a small sliver at its edge. If this is
+  // true and the overlapped files of L+1 are at most 1/8 the size of the
+  // picked files and overlap no file of L+2, they are first trivially moved
+  // down to L+2, after which the picked files can trivially move down to
+  // L+1. Neither gets rewritten, and their blocks stay in the block cache,
+  // at the cost of a little more overlap between the lower levels. Does not
+  // apply to manual compactions, compactions out of L0 or into the last
+  // level.
+  //
+  // Default: false
+  //
+  // Not dynamically changeable
+  bool level_compaction_move_edge_overlaps = false;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -592,6 +592,37 @@ extern ROCKSDB_LIBRARY_API void rocksdb_batched_multi_get_cf(
     const char* const* keys_list, const size_t* keys_list_sizes,
     rocksdb_pinnableslice_t** values, char** errs, const bool sorted_input);
 
+// Status of each key of rocksdb_batched_multi_get_cf_into_buffer()
+enum {
+  rocksdb_multi_get_found = 0,
+  rocksdb_multi_get_not_found = 1,
+  // The value was found but did not fit in the remaining space of the buffer
+  rocksdb_multi_get_no_space = 2,
+  rocksdb_multi_get_error = 3,
+};
+
+// Same as rocksdb_batched_multi_get_cf(), but the values found are copied
+// one after the other into the buffer supplied by the caller, instead of
+// being returned in an allocation per key, so that a binding can read a
+// whole batch with a single call and no allocation.
+//
+// values_offsets, values_sizes and statuses must be num_keys in length,
+// allocated by the caller. When statuses[i] is rocksdb_multi_get_found,
+// the value of keys_list[i] is the values_sizes[i] bytes at
+// values_buffer + values_offsets[i]. When it is rocksdb_multi_get_no_space,
+// values_sizes[i] is the size the value needs, and the values of the
+// following keys may still have been copied. The first error other than
+// not found, if any, is saved in errptr.
+//
+// Returns the number of bytes of values_buffer used.
+extern ROCKSDB_LIBRARY_API size_t rocksdb_batched_multi_get_cf_into_buffer(
+    rocksdb_t* db, const rocksdb_readoptions_t* options,
+    rocksdb_column_family_handle_t* column_family, size_t num_keys,
+    const char* const* keys_list, const size_t* keys_list_sizes,
+    unsigned char sorted_input, char* values_buffer, size_t values_buffer_size,
+    size_t* values_offsets, size_t* values_sizes, unsigned char* statuses,
+    char** errptr);
+
 // The value is only allocated (using malloc) and returned if it is found and
 // value_found isn't NULL. In that case the user is responsible for freeing it.
 extern ROCKSDB_LIBRARY_API unsigned char rocksdb_key_may_exist(
@@ -758,6 +789,23 @@ extern ROCKSDB_LIBRARY_API const char* rocksdb_iter_timestamp(
     const rocksdb_iterator_t*, size_t* tslen);
 extern ROCKSDB_LIBRARY_API void rocksdb_iter_get_error(
     const rocksdb_iterator_t*, char** errptr);
+// Copies up to max_entries entries into the buffer supplied by the caller,
+// starting from the current entry and advancing the iterator past each
+// entry copied, so that a binding can read many entries with a single call.
+// The key of entry i is the keys_sizes[i] bytes at buffer + offsets[i], and
+// its value the values_sizes[i] bytes right after the key. offsets,
+// keys_sizes and values_sizes must be max_entries in length, allocated by
+// the caller.
+//
+// Stops early at the end of the iteration, or at the first entry that does
+// not fit in the remaining space of the buffer, which is then still the
+// current entry. Returns the number of entries copied; check
+// rocksdb_iter_valid() and rocksdb_iter_get_error() afterwards as after
+// rocksdb_iter_next().
+extern ROCKSDB_LIBRARY_API size_t rocksdb_iter_next_batch(
+    rocksdb_iterator_t* iter, size_t max_entries, char* buffer,
+    size_t buffer_size, size_t* offsets, size_t* keys_sizes,
+    size_t* values_sizes);
 extern ROCKSDB_LIBRARY_API void rocksdb_iter_refresh(
     const rocksdb_iterator_t* iter, char** errptr);
 
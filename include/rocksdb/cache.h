@@ -13,6 +13,7 @@
 
 #include <cstdint>
 #include <limits>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -25,6 +26,7 @@ namespace ROCKSDB_NAMESPACE {
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
 class SecondaryCache;
+class Slice;
 
 // These definitions begin source compatibility for a future change in which
 // a specific class for block cache is split away from general caches, so that
@@ -82,6 +84,11 @@ enum class CacheEntryRole {
   // Blob cache's charge to account for its memory usage (when using a
   // separate block cache and blob cache)
   kBlobCache,
+  // Charge for the read-ahead and output file buffers of running compactions
+  kCompactionBuffer,
+  // Hash index of the files written by bottommost compactions, see
+  // AdvancedColumnFamilyOptions::bottommost_hash_index
+  kBottommostHashIndex,
   // Default bucket, for miscellaneous cache entries. Do not use for
   // entries that could potentially add up to large usage.
   kMisc,
@@ -123,6 +130,57 @@ enum CacheMetadataChargePolicy {
 const CacheMetadataChargePolicy kDefaultCacheMetadataChargePolicy =
     kFullChargeCacheMetadata;
 
+// EXPERIMENTAL: Decides whether a sharded cache (LRUCache or
+// HyperClockCache) inserts a new entry into a full shard, where it would have
+// to evict other entries, so that for example the blocks read once by a long
+// scan do not push out the working set of point lookups. See
+// ShardedCacheOptions::admission_policy and NewTinyLfuAdmissionPolicy().
+// Implementations must be thread-safe.
+class CacheAdmissionPolicy {
+ public:
+  virtual ~CacheAdmissionPolicy() = default;
+
+  virtual const char* Name() const = 0;
+
+  // Called on each Lookup() of `key`, whether a hit or a miss.
+  virtual void RecordAccess(const Slice& key) = 0;
+
+  // Called on Insert() of an entry that does not fit into the shard of `key`
+  // without evicting. If false, the entry is not inserted: Insert() returns
+  // OK as if it were inserted and evicted right away, with a handle, if asked
+  // for, to a standalone entry. `role` is that of the entry's helper; entries
+  // only accounting for memory, like those of cache reservations, should
+  // always be admitted.
+  virtual bool Admit(const Slice& key, CacheEntryRole role, size_t charge) = 0;
+};
+
+struct TinyLfuAdmissionPolicyOptions {
+  // The approximate number of entries the cache holds, e.g. its capacity
+  // divided by the block size, for sizing the frequency counts, which take
+  // about three bytes per expected entry.
+  size_t expected_entries = 0;
+
+  // The number of recent lookups of the key of an entry (at most 16) for it
+  // to be admitted into a full shard. The default of 2 rejects the blocks
+  // read only once.
+  uint32_t min_frequency = 2;
+
+  // The entries subject to the policy. Those of other roles, like filter and
+  // index blocks, are always admitted.
+  CacheEntryRoleSet admission_roles = {CacheEntryRole::kDataBlock,
+                                       CacheEntryRole::kBlobValue};
+};
+
+// EXPERIMENTAL: Creates a TinyLFU admission policy: an approximate count of
+// the recent lookups of each key, in a count-min sketch whose counts are
+// halved periodically, behind a "doorkeeper" Bloom filter that absorbs the
+// first lookup of each key, so that the many keys looked up only once take
+// up no counters. An entry of any of `admission_roles` is admitted into a
+// full shard only if its key was looked up at least `min_frequency` times.
+// One policy should be used by only one cache.
+std::shared_ptr<CacheAdmissionPolicy> NewTinyLfuAdmissionPolicy(
+    const TinyLfuAdmissionPolicyOptions& opts);
+
 // Options shared betweeen various cache implementations that
 // divide the key space into shards using hashing.
 struct ShardedCacheOptions {
@@ -160,6 +218,21 @@ struct ShardedCacheOptions {
   // this option must be kept as default empty.
   std::shared_ptr<SecondaryCache> secondary_cache;
 
+  // EXPERIMENTAL: If non-nullptr, decides which entries are inserted into a
+  // full shard, see CacheAdmissionPolicy.
+  std::shared_ptr<CacheAdmissionPolicy> admission_policy;
+
+  // EXPERIMENTAL: If true, in builds with NUMA support (WITH_NUMA), the cache
+  // keeps a separate group of 2^num_shard_bits shards for each NUMA node,
+  // splitting the capacity evenly among them and allocating each group's
+  // memory on its node. Lookups and inserts go to the shards of the node the
+  // calling thread runs on, so that shard locks and metadata stay local, at
+  // the cost of each node caching its own copy of the entries it reads,
+  // which replicates hot index and filter blocks to every node. Erase()
+  // erases the entry from all the nodes. Currently only supported by
+  // LRUCache, and ignored otherwise.
+  bool numa_aware = false;
+
   // See hash_seed comments below
   static constexpr int32_t kQuasiRandomHashSeed = -1;
   static constexpr int32_t kHostHashSeed = -2;
@@ -243,6 +316,15 @@ struct LRUCacheOptions : public ShardedCacheOptions {
   // -DROCKSDB_DEFAULT_TO_ADAPTIVE_MUTEX, false otherwise.
   bool use_adaptive_mutex = kDefaultToAdaptiveMutex;
 
+  // EXPERIMENTAL
+  // Whether cache shards use a reader-writer lock, so that lookups hitting
+  // entries already referenced and hit before, typically the hottest blocks,
+  // share the lock with each other instead of serializing, and releasing a
+  // reference other than the last one takes no lock at all. Other operations,
+  // including hits that have to update the LRU list, lock exclusively, at
+  // some extra cost compared to use_adaptive_mutex alone, which is ignored.
+  bool shared_lookups = false;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -313,6 +395,18 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // (Filter blocks are essentially non-compressible but others usually are.)
   CacheEntryRoleSet do_not_compress_roles = {CacheEntryRole::kFilterBlock};
 
+  // Compression method for the entries of the given kinds, overriding
+  // compression_type for them, e.g. kZSTD for data blocks while index blocks
+  // use a faster method. Kinds in do_not_compress_roles are not compressed
+  // regardless.
+  std::map<CacheEntryRole, CompressionType> compression_type_overrides;
+
+  // Entries that compress by less than this ratio (uncompressed size over
+  // compressed size) are stored uncompressed, so that looking them up does
+  // not pay decompression for little saved capacity. 0 keeps every compressed
+  // entry. Not applied with enable_custom_split_merge.
+  double min_compression_ratio = 0.0;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -478,6 +572,24 @@ struct HyperClockCacheOptions : public ShardedCacheOptions {
   // keep operations very fast.
   int eviction_effort_cap = 30;
 
+  // EXPERIMENTAL: If true, each shard keeps an approximate count of how many
+  // times each key was looked up recently, hit or miss, which
+  // Cache::GetAccessFrequency() returns. This lets decisions like what to
+  // warm up or dump be based on popularity rather than recency. The counts
+  // are kept in a count-min sketch of about two bytes per
+  // estimated_entry_charge (or min_avg_entry_charge) of capacity, and halved
+  // periodically to favor recent lookups.
+  bool track_access_frequency = false;
+
+  // EXPERIMENTAL: If non-zero, TinyLFU-style admission, which implies
+  // track_access_frequency: an entry whose insertion would push the usage of
+  // its shard over capacity is only inserted if its key was looked up at
+  // least this many times recently. Otherwise the insertion succeeds as if
+  // the entry were inserted and evicted right away (with a handle, if asked
+  // for, to a standalone entry), so that entries only ever read once do not
+  // evict popular ones. Values above 15 are treated as 15.
+  uint32_t min_admission_frequency = 0;
+
   HyperClockCacheOptions(
       size_t _capacity, size_t _estimated_entry_charge,
       int _num_shard_bits = -1, bool _strict_capacity_limit = false,
@@ -555,6 +667,21 @@ struct TieredCacheOptions {
   // divided between the primary block cache and compressed secondary cache
   size_t total_capacity = 0;
   double compressed_secondary_ratio = 0.0;
+  // EXPERIMENTAL
+  // If non-zero, the compressed_secondary_ratio is adapted to the workload
+  // once every this many lookups of entries that can be in the secondary
+  // cache. It is moved by adaptive_ratio_step in the direction that last
+  // lowered the estimated cost of those lookups: the time spent looking up
+  // the compressed secondary cache (mostly decompressing) plus miss_cost_nanos
+  // for each lookup missing both tiers. The ratio stays within
+  // [min_compressed_secondary_ratio, max_compressed_secondary_ratio], which
+  // must include compressed_secondary_ratio and exclude 0.0.
+  uint64_t adaptive_ratio_window = 0;
+  double adaptive_ratio_step = 0.02;
+  double min_compressed_secondary_ratio = 0.05;
+  double max_compressed_secondary_ratio = 0.5;
+  // The estimated cost of reading a block from storage
+  uint64_t miss_cost_nanos = 100000;
   // An optional secondary cache that will serve as the persistent cache
   // tier. If present, compressed blocks will be written to this
   // secondary cache.
@@ -336,6 +336,32 @@ class CompactionFilter : public Customizable {
                                    std::string* /*skip_until*/) const {
     return Decision::kUndetermined;
   }
+
+  // EXPERIMENTAL
+  // When it returns more than 0, the table file creation reads its input
+  // ahead in runs of this many key-values, and passes the plain values
+  // (kValue) of each run to FilterBatch() before reaching them.
+  virtual size_t GetFilterBatchSize() const { return 0; }
+
+  // EXPERIMENTAL
+  // Batched variant of FilterV3() for plain values, so that the application
+  // can vectorize the work of a run of key-values or split it across
+  // threads. `keys` and `existing_values` are in key order, and
+  // `decisions` and `new_values` come in with the same size, set to
+  // kUndetermined and empty. The decisions kKeep, kRemove, kPurge, and
+  // kChangeValue, with the new value in `new_values`, are applied as if
+  // FilterV3() returned them; for any other decision, including the default
+  // kUndetermined, FilterV3() is called for the key as usual. The decisions
+  // are applied in key order, so the output does not depend on how the work
+  // is split.
+  //
+  // A key-value may be passed here without FilterV3() ever being called for
+  // it, e.g. an older version of a user key, so the decisions must not have
+  // side effects.
+  virtual void FilterBatch(int /*level*/, const std::vector<Slice>& /*keys*/,
+                           const std::vector<Slice>& /*existing_values*/,
+                           std::vector<Decision>* /*decisions*/,
+                           std::vector<std::string>* /*new_values*/) const {}
 };
 
 // Each thread of work involving creating table files will create a new
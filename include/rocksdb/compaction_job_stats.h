@@ -120,6 +120,13 @@ struct CompactionJobStats {
   // number of single-deletes which meet something other than a put
   uint64_t num_single_del_mismatch = 0;
 
+  // the number of compaction output files handed to post-compaction warmup
+  // (DBOptions::max_background_warmups), and their total size. The warmup
+  // runs after the compaction has completed; its outcome is reported by the
+  // WARMUP_* statistics and the "rocksdb.warmup-stats" property.
+  uint64_t num_warmup_output_files = 0;
+  uint64_t total_warmup_output_bytes = 0;
+
   // TODO: Add output_to_proximal_level output information
 };
 }  // namespace ROCKSDB_NAMESPACE
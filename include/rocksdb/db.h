@@ -54,6 +54,7 @@ struct ReadOptions;
 struct TableProperties;
 struct WriteOptions;
 struct WaitForCompactOptions;
+struct WarmupOptions;
 class Env;
 class EventListener;
 class FileSystem;
@@ -336,7 +337,9 @@ class DB {
   // the leader to its own database. Another difference is the follower
   // tries to keep up with the leader by periodically tailing the leader's
   // MANIFEST, and (in the future) memtable updates, rather than relying on
-  // the user to manually call TryCatchupWithPrimary().
+  // the user to manually call TryCatchupWithPrimary(). The user can still call
+  // it to catch up without waiting for the next periodic refresh, e.g. from an
+  // EventListener of the leader on the completion of flushes and compactions.
 
   // Open as a follower with the default column family
   static Status OpenAsFollower(const Options& options, const std::string& name,
@@ -1102,6 +1105,27 @@ class DB {
     return ms_iter;
   }
 
+  // Returns in `iterators` up to `num_partitions` iterators that together
+  // cover the key range of `options.iterate_lower_bound` and
+  // `options.iterate_upper_bound` (the whole column family if not set), for
+  // example to export it from several threads at once. The range is split in
+  // partitions of about the same amount of data, after the data block
+  // anchors (see TableReader::ApproximateKeyAnchors()) of the overlapping
+  // table files. The iterators are in key order, each one bounded to its own
+  // partition, and all read the same SuperVersion at the same sequence
+  // number, so that they see a single consistent state of the DB even if it
+  // is written to meanwhile (unless one is Refresh()ed). Fewer iterators are
+  // returned if the range holds too little data. Each iterator does its own
+  // readahead and may be used by a different thread.
+  //
+  // Tailing iterators are not supported.
+  virtual Status NewParallelScan(
+      const ReadOptions& /*options*/, ColumnFamilyHandle* /*column_family*/,
+      size_t /*num_partitions*/,
+      std::vector<std::unique_ptr<Iterator>>* /*iterators*/) {
+    return Status::NotSupported("NewParallelScan() is not supported");
+  }
+
   // Return a handle to the current DB state.  Iterators created with
   // this handle will all observe a stable snapshot of the current DB
   // state.  The caller must call ReleaseSnapshot(result) when the
@@ -1153,7 +1177,8 @@ class DB {
     static const std::string kCFStatsNoFileHistogram;
 
     //  "rocksdb.cf-file-histogram" - print out how many file reads to every
-    //      level, as well as the histogram of latency of single requests.
+    //      level and to each of the cf_paths, as well as the histogram of
+    //      latency of single requests.
     static const std::string kCFFileHistogram;
 
     // "rocksdb.cf-write-stall-stats" - returns a multi-line string or
@@ -1168,6 +1193,16 @@ class DB {
     // available in the map form.
     static const std::string kDBWriteStallStats;
 
+    // "rocksdb.warmup-stats" - returns a multi-line string or map with the
+    //      cumulative results of the post-compaction warmup jobs of a column
+    //      family (see DBOptions::max_background_warmups). Map keys:
+    //      "num-jobs", "num-files", "blocks-inserted",
+    //      "blocks-inserted-to-secondary-cache", "bytes-read",
+    //      "blocks-already-cached", "blocks-skipped", "bytes-skipped",
+    //      "files-skipped" and "micros". The skipped counts are what was not
+    //      warmed because the block cache was full.
+    static const std::string kWarmupStats;
+
     //  "rocksdb.dbstats" - As a string property, returns a multi-line string
     //      with general database stats, both cumulative (over the db's
     //      lifetime) and interval (since the last retrieval of kDBStats).
@@ -1179,6 +1214,12 @@ class DB {
     //      of files per level and total size of each level (MB).
     static const std::string kLevelStats;
 
+    //  "rocksdb.lsm-efficiency" - returns a multi-line string or map with the
+    //      write, read and space amplification of each level and of the whole
+    //      LSM tree, cumulative and since the previous query of the property.
+    //      Read amplification is measured from sampled lookups.
+    static const std::string kLsmEfficiency;
+
     //  "rocksdb.block-cache-entry-stats" - returns a multi-line string or
     //      map with statistics on block cache usage. See
     //      `BlockCacheEntryStatsMapKeys` for structured representation of keys
@@ -1189,6 +1230,12 @@ class DB {
     //      stale values more frequently to reduce overhead and latency.
     static const std::string kFastBlockCacheEntryStats;
 
+    //  "rocksdb.block-cache-hit-ratio-curve" - returns a multi-line string or
+    //      map with the hit ratio that the block cache is estimated to have
+    //      at multiples of its capacity, keyed by the multiple, for a block
+    //      cache made with NewMissRatioCurveCache().
+    static const std::string kBlockCacheHitRatioCurve;
+
     //  "rocksdb.num-immutable-mem-table" - returns number of immutable
     //      memtables that have not yet been flushed.
     static const std::string kNumImmutableMemTable;
@@ -1369,6 +1416,12 @@ class DB {
     //      entries being pinned.
     static const std::string kBlockCachePinnedUsage;
 
+    // "rocksdb.block-cache-fragmentation" - returns the size of the slabs
+    //      that the memory allocator of the block cache has mapped, but that
+    //      no entry uses, for an allocator made with NewSlabMemoryAllocator()
+    //      or NewHugePageMemoryAllocator().
+    static const std::string kBlockCacheFragmentation;
+
     // "rocksdb.options-statistics" - returns multi-line string
     //      of options.statistics
     static const std::string kOptionsStatistics;
@@ -1465,6 +1518,7 @@ class DB {
   //  "rocksdb.block-cache-capacity"
   //  "rocksdb.block-cache-usage"
   //  "rocksdb.block-cache-pinned-usage"
+  //  "rocksdb.block-cache-fragmentation"
   //
   //  Properties dedicated for BlobDB:
   //  "rocksdb.num-blob-files"
@@ -1528,6 +1582,20 @@ class DB {
                                include_flags);
   }
 
+  // Like GetApproximateSizes(), but also stores in "counts[i]" the
+  // approximate number of entries in "[range[i].start .. range[i].limit)".
+  // The table files are always accounted for with sampled key anchors, as
+  // with SizeApproximationOptions::use_key_anchors: the anchors of the files
+  // of a Version are read once, on the first call that needs them, after
+  // which an estimate takes a couple of binary searches in memory and no I/O.
+  // The memtables are accounted for as in GetApproximateMemTableStats().
+  virtual Status GetApproximateRangeStats(
+      const SizeApproximationOptions& /*options*/,
+      ColumnFamilyHandle* /*column_family*/, const Range* /*ranges*/,
+      int /*n*/, uint64_t* /*sizes*/, uint64_t* /*counts*/) {
+    return Status::NotSupported("GetApproximateRangeStats() not supported");
+  }
+
   // The method is similar to GetApproximateSizes, except it
   // returns approximate number of records in memtables.
   virtual void GetApproximateMemTableStats(ColumnFamilyHandle* column_family,
@@ -2071,6 +2139,16 @@ class DB {
 
   virtual Status VerifyChecksum() { return VerifyChecksum(ReadOptions()); }
 
+  // Like VerifyChecksum(read_options), but verifies up to `max_threads` table
+  // files at a time, each with its own readahead of
+  // `read_options.readahead_size` bytes, read asynchronously while its blocks
+  // are verified if `read_options.async_io` is set. Once a corruption is found,
+  // the files not verified yet are skipped and the corruption is returned.
+  virtual Status VerifyChecksum(const ReadOptions& read_options,
+                                int /*max_threads*/) {
+    return VerifyChecksum(read_options);
+  }
+
   // Returns the unique ID which is read from IDENTITY file during the opening
   // of database by setting in the identity variable
   // Returns Status::OK if identity could be set properly
@@ -2114,6 +2192,19 @@ class DB {
     return Status::NotSupported("PromoteL0() is not implemented.");
   }
 
+  // EXPERIMENTAL
+  // Loads the blocks of the SST files of `column_family` overlapping the user
+  // key range [*begin, *end] into the block cache, ahead of reads the
+  // application expects. A null `begin` or `end` means the range is unbounded
+  // on that side. Memtables and blob files are not warmed. See WarmupOptions.
+  // Returns Status::NotSupported() if `options.wait` is false and background
+  // warmups are disabled.
+  virtual Status WarmupRange(ColumnFamilyHandle* /*column_family*/,
+                             const Slice* /*begin*/, const Slice* /*end*/,
+                             const WarmupOptions& /*options*/) {
+    return Status::NotSupported("WarmupRange() is not implemented.");
+  }
+
   // Trace DB operations. Use EndTrace() to stop tracing.
   virtual Status StartTrace(const TraceOptions& /*options*/,
                             std::unique_ptr<TraceWriter>&& /*trace_writer*/) {
@@ -2193,6 +2284,12 @@ struct WriteStallStatsMapKeys {
   static const std::string& CFL0FileCountLimitDelaysWithOngoingCompaction();
   static const std::string& CFL0FileCountLimitStopsWithOngoingCompaction();
 
+  // DB scope state of the write controller, in bytes per second: the delayed
+  // write rate, and the rate at which compactions are estimated to drain the
+  // compaction debt (see `DBOptions::adaptive_delayed_write_rate`)
+  static const std::string& DelayedWriteRate();
+  static const std::string& CompactionDrainRate();
+
   // REQUIRES:
   // `cause` isn't any of these: `WriteStallCause::kNone`,
   // `WriteStallCause::kCFScopeWriteStallCauseEnumMax`,
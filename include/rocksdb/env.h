@@ -93,6 +93,17 @@ struct EnvOptions {
   // If true, then use O_DIRECT for writing data
   bool use_direct_writes = false;
 
+  // If true, then use O_DIRECT for writing data through io_uring, where
+  // supported, without requiring aligned appends. Set for WAL files by
+  // OptimizeForLogWrite() from DBOptions::use_direct_io_for_wal.
+  bool use_io_uring_writes = false;
+
+  // If true, WritableFileWriter writes each full buffer from a background
+  // thread while the next one is filled. Set for table and blob files by
+  // OptimizeForCompactionTableWrite() from
+  // DBOptions::background_writes_for_flush_and_compaction.
+  bool use_background_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -592,6 +603,16 @@ class Env : public Customizable {
   // Lower CPU priority for threads from the specified pool.
   virtual void LowerThreadPoolCPUPriority(Priority /*pool*/ = LOW) {}
 
+  // Restrict the threads from the specified pool to run on the given CPUs,
+  // e.g. the CPUs of one NUMA node, or let them run on any CPU when `cpus`
+  // is empty. Each thread applies it before the next job it runs.
+  virtual Status SetThreadPoolCpuAffinity(Priority /*pool*/,
+                                          const std::vector<int>& /*cpus*/) {
+    return Status::NotSupported(
+        "Env::SetThreadPoolCpuAffinity(Priority, const std::vector<int>&) not "
+        "supported");
+  }
+
   // Converts seconds-since-Jan-01-1970 to a printable string
   virtual std::string TimeToString(uint64_t time) = 0;
 
@@ -1637,6 +1658,11 @@ class EnvWrapper : public Env {
     return target_.env->LowerThreadPoolCPUPriority(pool, pri);
   }
 
+  Status SetThreadPoolCpuAffinity(Priority pool,
+                                  const std::vector<int>& cpus) override {
+    return target_.env->SetThreadPoolCpuAffinity(pool, cpus);
+  }
+
   std::string TimeToString(uint64_t time) override {
     return target_.env->TimeToString(time);
   }
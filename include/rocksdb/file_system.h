@@ -1071,6 +1071,23 @@ class FSWritableFile {
     return Append(data, options, dbg);
   }
 
+  // EXPERIMENTAL
+  // Append the concatenation of the n slices in data, in order. File systems
+  // that can gather them into a single write, without copying them into a
+  // contiguous buffer first, may override this. The default appends them one
+  // by one. File wrappers do not forward it to the wrapped file, so that they
+  // still see every Append().
+  virtual IOStatus AppendV(const Slice* data, size_t n,
+                           const IOOptions& options, IODebugContext* dbg) {
+    for (size_t i = 0; i < n; i++) {
+      IOStatus s = Append(data[i], options, dbg);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return IOStatus::OK();
+  }
+
   // PositionedAppend data to the specified offset. The new EOF after append
   // must be larger than the previous EOF. This is to be used when writes are
   // not backed by OS buffers and hence has to always start from the start of
@@ -209,4 +209,48 @@ const FilterPolicy* NewBloomFilterPolicy(
 FilterPolicy* NewRibbonFilterPolicy(double bloom_equivalent_bits_per_key,
                                     int bloom_before_level = 0);
 
+// EXPERIMENTAL
+// A Bloom filter policy that, rather than the same bits per key at every
+// level, spreads `bits_per_key` bits per key on average over the levels of
+// each column family so that point lookups probe the fewest table files in
+// vain, as in "Monkey: Optimal Navigable Key-Value Store" (SIGMOD 2017). The
+// false positive rate of a level is made proportional to its size divided by
+// the number of its files probed by the (sampled) point lookups, so the
+// largest and least read levels get fewer bits per key than the average and
+// the others more, up to twice the average. A level can end up without
+// filters. The allocation is re-evaluated each time the column family
+// installs a new version of its LSM and applies to the filters built by
+// later flushes and compactions. Files of unknown level, like ingested ones,
+// get the average.
+//
+// The filters are Bloom filters, read by any built-in filter policy. One
+// policy can be shared by column families: each gets its own allocation.
+std::shared_ptr<const FilterPolicy> NewLevelAdaptiveBloomFilterPolicy(
+    double bits_per_key);
+
+// EXPERIMENTAL
+// Wraps a filter policy, like NewBloomFilterPolicy(), so that its filters
+// can also tell that an SST file has no key in the range [target,
+// ReadOptions::iterate_upper_bound) of a forward Seek(), without a
+// prefix_extractor. Along with each key, the filter gets the first `len`
+// bytes of the key for each `len` of `prefix_lengths`. A range whose bounds
+// share their first `len` bytes (or whose upper bound is the immediate
+// successor of that prefix) is then checked against that prefix, using the
+// longest such `len`. For example, with keys made of an 8-byte series id
+// followed by a timestamp, prefix_lengths = {8} lets the scans over a time
+// range of one series skip the SST files without that series.
+//
+// Each prefix length adds up to one filter entry per key, so it takes more
+// filter space when few keys share each prefix. Ranges are only checked
+// against full (not partitioned) filters, with whole_key_filtering and the
+// default bytewise comparator without timestamps. Otherwise, and for point
+// lookups and prefix_extractor, filters work as those of `base`.
+//
+// The filters are not compatible with those of `base`, nor with those built
+// with other prefix lengths: changing the policy leaves the existing SST
+// files without a usable filter until they are compacted.
+std::shared_ptr<const FilterPolicy> NewRangeFilterPolicy(
+    std::shared_ptr<const FilterPolicy> base,
+    std::vector<size_t> prefix_lengths);
+
 }  // namespace ROCKSDB_NAMESPACE
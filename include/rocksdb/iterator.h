@@ -56,6 +56,18 @@ class Iterator : public IteratorBase {
     return kNoWideColumns;
   }
 
+  // EXPERIMENTAL
+  // Makes `value` hold the value of the current entry, as returned by
+  // value(), until it is reset, even after the iterator moves or is
+  // destroyed. When the value is in a block of the block cache, `value`
+  // references the cache entry instead of copying the value, so that the
+  // memory stays charged to the block cache until then.
+  // REQUIRES: Valid()
+  virtual void PinValue(PinnableSlice* value) {
+    value->Reset();
+    value->PinSelf(this->value());
+  }
+
   // Property "rocksdb.iterator.is-key-pinned":
   //   If returning "1", this means that the Slice returned by key() is valid
   //   as long as the iterator is not deleted.
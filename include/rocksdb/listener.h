@@ -550,6 +550,35 @@ struct IOErrorInfo {
   uint64_t offset;
 };
 
+enum class SlowOperationType {
+  kGet,
+  kMultiGet,
+  kWrite,
+  kSeek,
+};
+
+// A stage of an operation traced with
+// DBOptions::slow_operation_threshold_micros
+struct OperationSpan {
+  // Name of the stage, e.g. "MutexWait", "TableOpen" or "BlockRead"
+  const char* name;
+  // Number of the spans of the operation that this one is nested in
+  uint32_t depth;
+  // Relative to the start of the operation
+  uint64_t start_nanos;
+  uint64_t duration_nanos;
+};
+
+struct SlowOperationInfo {
+  SlowOperationType type;
+  uint64_t duration_nanos;
+  // The stages of the operation by start time, so that each span is followed
+  // by the ones nested in it
+  std::vector<OperationSpan> spans;
+  // Number of spans not recorded, past the maximum number for an operation
+  uint32_t num_dropped_spans;
+};
+
 // EventListener class contains a set of callback functions that will
 // be called when specific RocksDB event happens such as flush.  It can
 // be used as a building block for developing custom features such as
@@ -866,6 +895,13 @@ class EventListener : public Customizable {
   // happens. ShouldBeNotifiedOnFileIO should be set to true to get a callback.
   virtual void OnIOError(const IOErrorInfo& /*info*/) {}
 
+  // EXPERIMENTAL
+  // A callback function for RocksDB which will be called, by the thread of
+  // the operation, after a Get(), MultiGet(), Write() or iterator Seek() that
+  // took at least DBOptions::slow_operation_threshold_micros, with the spans
+  // of its stages.
+  virtual void OnSlowOperation(const SlowOperationInfo& /*info*/) {}
+
   ~EventListener() override {}
 };
 
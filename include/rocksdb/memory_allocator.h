@@ -84,4 +84,70 @@ Status NewJemallocNodumpAllocator(
     const JemallocAllocatorOptions& options,
     std::shared_ptr<MemoryAllocator>* memory_allocator);
 
+struct HugePageAllocatorOptions {
+  static const char* kName() { return "HugePageAllocatorOptions"; }
+  // Total size of the slabs that the allocator may map, e.g. a bit more than
+  // the capacity of the block cache using it. Only the address range is
+  // reserved up front; the slabs are mapped as they are needed.
+  size_t capacity = size_t{1} << 30;
+
+  // Size of each slab, a power of two of at least 64KB. It has to be a
+  // multiple of the huge page size, or the slabs are mapped with normal
+  // pages.
+  size_t slab_size = 2 << 20;
+
+  // Size of the huge pages to map, e.g. 1GB with a `slab_size` of 1GB, or 0
+  // for the default huge page size of the system.
+  size_t huge_page_size = 0;
+
+  // Larger allocations are not served from the slabs. At most `slab_size`.
+  size_t max_allocation_size = 256 << 10;
+};
+
+// EXPERIMENTAL
+// Generate memory allocator which allocates from huge pages, reducing the TLB
+// misses of the lookups in a large block cache. The allocations are carved
+// out of slabs mapped with MAP_HUGETLB, by size class. When not enough huge
+// pages are reserved (see /proc/sys/vm/nr_hugepages), the slabs are mapped
+// with normal pages and advised to be backed by transparent huge pages
+// instead. The allocations larger than `max_allocation_size`, or made once
+// `capacity` is mapped, come from operator new.
+//
+// The memory of the slabs is only returned to the system when the allocator
+// is destroyed, and each size class keeps the pages that it used.
+Status NewHugePageMemoryAllocator(
+    const HugePageAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator);
+
+struct SlabAllocatorOptions {
+  static const char* kName() { return "SlabAllocatorOptions"; }
+  // Total size of the slabs that the allocator may map, e.g. a bit more than
+  // the capacity of the block cache using it. Only the address range is
+  // reserved up front; the slabs are mapped as they are needed.
+  size_t capacity = size_t{1} << 30;
+
+  // Size of each slab, a power of two of at least 64KB.
+  size_t slab_size = 2 << 20;
+
+  // Larger allocations are not served from the slabs. At most `slab_size`.
+  size_t max_allocation_size = 64 << 10;
+};
+
+// EXPERIMENTAL
+// Generate memory allocator which carves the allocations out of slabs by
+// size class, from 64 bytes to `max_allocation_size` with 4 classes for each
+// power of two, such as the 4KB to 64KB blocks of a block cache. Freed
+// allocations are kept on core-local free lists of their class and reused
+// by later allocations of the class, avoiding the fragmentation of the heap
+// that entries of varied sizes cause with a long running block cache. The
+// usable size of an allocation, and so the charge of a block cache entry
+// allocated from it, is the size of its class.
+//
+// The memory of the slabs is only returned to the system when the allocator
+// is destroyed. See DB::Properties::kBlockCacheFragmentation for the bytes
+// of the slabs that no allocation uses.
+Status NewSlabMemoryAllocator(
+    const SlabAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -80,6 +80,9 @@ class MemTableRep {
     virtual int operator()(const char* prefix_len_key,
                            const Slice& key) const = 0;
 
+    // Size of the user-defined timestamp at the end of each user key
+    virtual size_t timestamp_size() const { return 0; }
+
     virtual ~KeyComparator() {}
   };
 
@@ -194,6 +197,15 @@ class MemTableRep {
   virtual void Get(const LookupKey& k, void* callback_args,
                    bool (*callback_func)(void* arg, const char* entry));
 
+  // Get() for each of keys[0, num_keys), with callback_args[i] forwarded to
+  // callback_func() for keys[i]. Implementations may overlap the lookups.
+  //
+  // Default:
+  // Get() on each key in turn.
+  virtual void MultiGet(size_t num_keys, const LookupKey* const* keys,
+                        void* const* callback_args,
+                        bool (*callback_func)(void* arg, const char* entry));
+
   // Same as Get() but performs data integrity validation.
   virtual Status GetAndValidate(const LookupKey& /* k */,
                                 void* /* callback_args */,
@@ -420,6 +432,63 @@ class VectorRepFactory : public MemTableRepFactory {
                                  Logger* logger) override;
 };
 
+// EXPERIMENTAL
+// This uses a B+-tree to store keys. Compared to the skip list, it keeps the
+// keys of a node next to each other, so point lookups take fewer cache
+// misses, and it needs no towers of next pointers. Supports concurrent
+// inserts, but not detecting duplicate keys or insert hints, and
+// Iterator::Prev() is a lookup from the root.
+class BTreeRepFactory : public MemTableRepFactory {
+ public:
+  BTreeRepFactory() {}
+
+  // Methods for Configurable/Customizable class overrides
+  static const char* kClassName() { return "BTreeRepFactory"; }
+  static const char* kNickName() { return "btree"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+
+  // Methods for MemTableRepFactory class overrides
+  using MemTableRepFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&, Allocator*,
+                                 const SliceTransform*,
+                                 Logger* logger) override;
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+};
+
+// EXPERIMENTAL
+// This factory creates memtables made of num_partitions skip lists, with
+// the user keys hash partitioned among them. Concurrent writers mostly insert
+// into different skip lists, and iterators merge all of them in key order,
+// so that the memtable is still read and flushed as a whole.
+// Parameters:
+//   num_partitions: number of skip lists, at least 1
+class PartitionedSkipListFactory : public MemTableRepFactory {
+ public:
+  explicit PartitionedSkipListFactory(size_t num_partitions = 16);
+
+  // Methods for Configurable/Customizable class overrides
+  static const char* kClassName() { return "PartitionedSkipListFactory"; }
+  static const char* kNickName() { return "partitioned_skip_list"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+  std::string GetId() const override;
+
+  // Methods for MemTableRepFactory class overrides
+  using MemTableRepFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&, Allocator*,
+                                 const SliceTransform*,
+                                 Logger* logger) override;
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+
+ private:
+  size_t num_partitions_;
+};
+
 // This class contains a fixed array of buckets, each
 // pointing to a skiplist (null if the bucket is empty).
 // bucket_count: number of fixed array buckets
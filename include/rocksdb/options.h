@@ -54,6 +54,7 @@ class MemTableRepFactory;
 class RateLimiter;
 class Slice;
 class Statistics;
+class ThreadPool;
 class InternalKeyComparator;
 class WalFilter;
 class FileSystem;
@@ -775,6 +776,28 @@ struct DBOptions {
   // Default: 16
   int max_file_opening_threads = 16;
 
+  // EXPERIMENTAL
+  // If true and max_open_files is -1, DB::Open() doesn't open the table files
+  // of the DB, so that it returns without waiting for them. Each file is
+  // opened on its first use instead, and a background job opens the others
+  // into the table cache, with up to max_file_opening_threads threads, the
+  // files of the lower levels first. The files that the job opens are read
+  // through the table cache rather than pinned to their metadata like the
+  // ones opened by DB::Open(). Unless skip_stats_update_on_db_open is also
+  // true, DB::Open() still opens some of the files to read their stats.
+  //
+  // Default: false
+  bool open_table_files_in_background = false;
+
+  // EXPERIMENTAL
+  // If greater than 1, the WAL records are inserted into the memtables on up
+  // to this many threads during DB::Open(), while the WALs are being read.
+  // Each column family is replayed by a single thread, so this only helps
+  // with multiple column families. Recovery stays on a single thread with
+  // two phase commit or unordered write policies.
+  // Default: 1
+  int max_wal_recovery_threads = 1;
+
   // Once write-ahead logs exceed this size, we will start forcing the flush of
   // column families whose memtables are backed by the oldest live WAL file
   // (i.e. the ones that are causing all the space amplification). If set to 0
@@ -896,6 +919,33 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint32_t max_subcompactions = 1;
 
+  // EXPERIMENTAL
+  // The number of ranges each subcompaction thread gets on average. With a
+  // value larger than 1, a compaction is split into up to
+  // max_subcompactions * subcompaction_ranges_per_thread subcompactions, and
+  // max_subcompactions threads run them: a thread that finishes one takes the
+  // next one not started yet. A range with many more keys than estimated then
+  // only delays its own thread, instead of leaving the others idle. Ranges
+  // are still no smaller than the target file size of the output level.
+  //
+  // Default: 1 (one subcompaction per thread)
+  uint32_t subcompaction_ranges_per_thread = 1;
+
+  // EXPERIMENTAL
+  // If true, a background compaction thread picks, among the column families
+  // waiting for one, the column family whose compaction is expected to save
+  // reads the most work per byte written, instead of the one that has waited
+  // the longest. The estimate comes from the sampled reads of the files the
+  // compaction would merge and, for L0, from the number of L0 files.
+  //
+  // To also bound the threads the compactions of the DB use in total, share
+  // one ColumnFamilyOptions::compaction_thread_limiter among all the column
+  // families: a column family that reads depend on then gets the next thread
+  // the limiter lets through, rather than waiting behind the others.
+  //
+  // Default: false
+  bool prioritize_compactions_by_read_amp = false;
+
   // DEPRECATED: RocksDB automatically decides this based on the
   // value of max_background_jobs. For backwards compatibility we will set
   // `max_background_jobs = max_background_compactions + max_background_flushes`
@@ -918,6 +968,104 @@ struct DBOptions {
   // Default: -1
   int max_background_flushes = -1;
 
+  // EXPERIMENTAL
+  // Maximum number of L0 files that a flush builds in parallel, like the
+  // subcompactions of a compaction. The memtables being flushed are split
+  // into that many key ranges of about the same size, with one file per range
+  // and a thread per file, the flush thread being one of them. A flush is
+  // not split into files smaller than `target_file_size_base`, so it mostly
+  // applies when several immutable memtables are flushed at once. Flushes
+  // with range deletions, blob files or user-defined timestamps, or of
+  // memtables other than skip lists, build one file.
+  //
+  // Default: 1 (one file per flush)
+  uint32_t max_flush_partitions = 1;
+
+  // Maximum number of concurrent background jobs that load the blocks of a
+  // freshly compacted key range into the block cache, submitted to the USER
+  // priority thread pool. Warmup jobs are scheduled only after the compaction
+  // result has been installed, run without holding the DB mutex, and are
+  // charged against `rate_limiter` (if any) at Env::IO_LOW priority.
+  //
+  // If you're increasing this, also consider increasing number of threads in
+  // USER priority thread pool. For more information, see
+  // Env::SetBackgroundThreads
+  //
+  // Default: 0 (post-compaction warmup disabled)
+  int max_background_warmups = 0;
+
+  // EXPERIMENTAL
+  // If not empty, the path of a file the contents of the block caches of the
+  // column families (data, index and filter blocks) are dumped to when the DB
+  // is closed, and restored from, into the same block caches, in the
+  // background after the DB is opened again. Blocks of table files that no
+  // longer exist are skipped, and the restore stops once the block cache is
+  // full. The restore runs in the USER priority thread pool. Ignored by
+  // read-only and secondary instances.
+  //
+  // Default: "" (block cache contents are not persisted)
+  std::string block_cache_dump_file = "";
+
+  // EXPERIMENTAL
+  // If not empty, the path of a file the read hotness of the live table files
+  // is saved to every `read_hotness_persist_period_sec` seconds and when the
+  // DB is closed: the sampled reads of each file (see
+  // FileSampledStats::num_reads_sampled) and, with
+  // BlockBasedTableOptions::warmup_min_data_block_hits, the key ranges of its
+  // data blocks found hot in the block cache. After DB::Open, a job in the
+  // USER priority thread pool restores the sampled reads of the files that
+  // still exist and loads their hot blocks (or, if their hot ranges are not
+  // known, their whole data) into the block cache, the most read files first,
+  // until `restart_warmup_max_bytes` have been read or the block cache is
+  // full. Unlike `block_cache_dump_file`, only what was read is loaded and the
+  // file stays small. Ignored by read-only and secondary instances.
+  //
+  // Default: "" (read hotness is not persisted)
+  std::string read_hotness_file = "";
+
+  // Period in seconds between two saves of `read_hotness_file`. 0 means it
+  // is only saved when the DB is closed.
+  //
+  // Default: 600 (10 min)
+  unsigned int read_hotness_persist_period_sec = 600;
+
+  // Upper bound on the bytes the warmup from `read_hotness_file` reads after
+  // DB::Open. Once this much has been read, no other file is warmed, so the
+  // budget may be exceeded by up to the size of one file. 0 means no limit.
+  //
+  // Default: 0
+  uint64_t restart_warmup_max_bytes = 0;
+
+  // EXPERIMENTAL
+  // If positive, reads of table files that take much longer than usual are
+  // hedged: the read is issued from a pool of this many threads per column
+  // family, and if it has not completed after the `hedged_read_percentile`
+  // latency of the reads at the same level, a second identical request is
+  // issued and the first of the two to succeed is used. The second request
+  // carries the IOOptions::property_bag entry "rocksdb.hedged_read", so a
+  // FileSystem may serve it from a replica. When all the threads are busy,
+  // reads are issued inline without hedging. Only reads through
+  // RandomAccessFileReader::Read that are not rate limited and do not use
+  // direct I/O are hedged, and the read latencies are only recorded with
+  // `statistics` set, so hedging requires it. Meant for remote or
+  // network-attached file systems where a few reads take many times the
+  // median latency; it costs a thread handoff per read.
+  //
+  // Default: 0 (disabled)
+  int hedged_read_threads = 0;
+
+  // The percentile of the recent read latencies at a level after which a
+  // read is hedged, see `hedged_read_threads`.
+  //
+  // Default: 99.0
+  double hedged_read_percentile = 99.0;
+
+  // Upper bound on the second requests issued by hedged reads, as a
+  // percentage of the reads, see `hedged_read_threads`.
+  //
+  // Default: 5
+  uint32_t hedged_read_budget_percent = 5;
+
   // Specify the maximal size of the info log file. If the log file
   // is larger than `max_log_file_size`, a new info log file will
   // be created.
@@ -957,6 +1105,16 @@ struct DBOptions {
   // Number of shards used for table cache.
   int table_cache_numshardbits = 6;
 
+  // EXPERIMENTAL
+  // If true, the table cache is a HyperClockCache rather than an LRUCache.
+  // Its lookups don't take a lock, which reduces the contention on the open
+  // table readers when many threads use the same files, and its evictions
+  // are cheaper under the churn of a max_open_files much smaller than the
+  // number of files.
+  //
+  // Default: false
+  bool table_cache_use_hyper_clock_cache = false;
+
   // The following two fields affect when WALs will be archived and deleted.
   //
   // When both are zero, obsolete WALs will not be archived and will be deleted
@@ -1017,6 +1175,25 @@ struct DBOptions {
   // Default: false
   bool use_direct_io_for_flush_and_compaction = false;
 
+  // EXPERIMENTAL
+  // Write the table and blob files of flushes and compactions from a second
+  // buffer on a background thread of each file, so that the next blocks are
+  // built while the previous buffer of writable_file_max_buffer_size is
+  // written and range synced. Explicit flushes and syncs of a file still wait
+  // for its writes. Ignored with use_direct_io_for_flush_and_compaction.
+  // Default: false
+  bool background_writes_for_flush_and_compaction = false;
+
+  // EXPERIMENTAL
+  // Use O_DIRECT for WAL writes, submitted through io_uring. Appends are
+  // staged in sector aligned buffers by the file system, each flush is
+  // written without waiting for it, and a sync is linked to the write before
+  // it, so the next write group can be prepared while the previous one is
+  // still being written. Only the posix file system built with io_uring
+  // support acts on it; elsewhere WAL writes are buffered as usual.
+  // Default: false
+  bool use_direct_io_for_wal = false;
+
   // If false, fallocate() calls are bypassed, which disables file
   // preallocation. The file space preallocation is used to increase the file
   // write/append performance. By default, RocksDB preallocates space for WAL,
@@ -1054,6 +1231,57 @@ struct DBOptions {
   // Default: false
   bool persist_stats_to_disk = false;
 
+  // EXPERIMENTAL
+  // If not zero, every auto_tune_period_sec seconds the write stalls of the
+  // DB since the last run are checked, and when compactions fall behind (the
+  // writes were stalled more than 1% of the time, or stopped or slowed down
+  // by the L0 file count or pending compaction bytes limits, or a column
+  // family is over half its soft_pending_compaction_bytes_limit), one more
+  // background job is allowed, up to twice max_background_jobs. After three
+  // runs in a row without any of that, one extra job is taken back. Each
+  // change is explained in the info log. The extra jobs are not reflected in
+  // max_background_jobs nor written to the OPTIONS file, and changing this
+  // option drops them. Has no effect with the deprecated
+  // max_background_compactions or max_background_flushes.
+  //
+  // Default: 0 (disabled)
+  //
+  // Dynamically changeable through SetDBOptions() API.
+  unsigned int auto_tune_period_sec = 0;
+
+  // EXPERIMENTAL
+  // If not zero, the reads of table files taking at least this many
+  // microseconds are reported to info_log, at most once per second for each
+  // of the cf_paths with the number of such reads since the last report.
+  // Requires statistics, which also enable the latency histograms by path of
+  // the "rocksdb.cf-file-histogram" property.
+  //
+  // Default: 0
+  uint64_t slow_read_log_threshold_micros = 0;
+
+  // EXPERIMENTAL
+  // If not zero, one in this many Get(), MultiGet(), iterator Seek() and
+  // Write() operations is run with PerfLevel::kEnableTimeExceptForMutex, and
+  // the time it spends in memtables, SST files, block reads, the WAL, etc. is
+  // recorded into the SAMPLED_* histograms of statistics. This gives breakdowns
+  // of the latencies without setting the perf level for every operation. The
+  // timers of the PerfContext of the thread also advance during the sampled
+  // operations. Requires statistics.
+  //
+  // Default: 0
+  uint32_t perf_context_sample_rate = 0;
+
+  // EXPERIMENTAL
+  // If not zero, and there are listeners, the stages of Get(), MultiGet(),
+  // Write() and iterator Seek() operations are timed: memtable lookups,
+  // table file opens, block reads, DB mutex waits, write stalls, WAL writes,
+  // and so on. The operations taking at least this many microseconds are
+  // reported to EventListener::OnSlowOperation() with a span for each stage.
+  // Faster operations only cost two clock reads per stage.
+  //
+  // Default: 0
+  uint64_t slow_operation_threshold_micros = 0;
+
   // if not zero, periodically take stats snapshots and store in memory, the
   // memory size for stats snapshots is capped at stats_history_buffer_size
   // Default: 1MB
@@ -1102,6 +1330,33 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t compaction_readahead_size = 2 * 1024 * 1024;
 
+  // EXPERIMENTAL
+  // If non-zero, replaces compaction_readahead_size for compaction inputs:
+  // this many bytes of readahead are split between the inputs of each
+  // compaction (and between its subcompactions). Every L0 input file, and
+  // every other input level, which is read one file at a time, gets a share
+  // proportional to its input bytes, as the merge consumes it at about that
+  // rate. So a compaction from many L0 files does not buffer
+  // compaction_readahead_size for each of them, and a large merge into a deep
+  // level reads its biggest input with a larger readahead.
+  //
+  // Default: 0 (disabled)
+  //
+  // Dynamically changeable through SetDBOptions() API.
+  size_t compaction_readahead_budget = 0;
+
+  // EXPERIMENTAL
+  // If true, and the file system supports asynchronous reads, the readahead
+  // of compaction inputs is double buffered: while the compaction consumes
+  // one buffer of compaction_readahead_size / 2 bytes, the next one is read
+  // in the background. This keeps the device busy while the subcompaction
+  // thread merges, builds and compresses blocks. It applies when the input
+  // files are not prefetched by the file system itself, e.g. with
+  // use_direct_reads.
+  //
+  // Default: false
+  bool compaction_async_io = false;
+
   // This is the maximum buffer size that is used by WritableFileWriter.
   // With direct IO, we need to maintain an aligned buffer for writes.
   // We allow the buffer to grow until it's size hits the limit in buffered
@@ -1204,6 +1459,18 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint64_t delayed_write_rate = 0;
 
+  // EXPERIMENTAL
+  // If true, while writes are delayed, the delayed write rate follows a
+  // feedback controller instead of being scaled up and down by fixed ratios.
+  // The controller estimates the rate at which compactions read their input,
+  // and sets the write rate around it, lower as the column family gets closer
+  // to stopping writes and as the stall pressure persists or grows.
+  // `delayed_write_rate` stays the upper bound. Until a compaction has run,
+  // the fixed ratios are used.
+  //
+  // Default: false
+  bool adaptive_delayed_write_rate = false;
+
   // By default, a single write thread queue is maintained. The thread gets
   // to the head of the queue becomes write batch group leader and responsible
   // for writing to WAL and memtable for the batch group.
@@ -1247,7 +1514,9 @@ struct DBOptions {
 
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
-  // is implemented only for SkipListFactory.  Concurrent memtable writes
+  // is implemented for SkipListFactory and the factories returned by
+  // NewHashSkipListRepFactory and NewHashLinkListRepFactory, which serialize
+  // concurrent inserts into the same bucket.  Concurrent memtable writes
   // are not compatible with inplace_update_support or filter_deletes.
   // It is strongly recommended to set enable_write_thread_adaptive_yield
   // if you are going to use this feature.
@@ -1263,6 +1532,17 @@ struct DBOptions {
   // Default: true
   bool enable_write_thread_adaptive_yield = true;
 
+  // EXPERIMENTAL
+  // If true, writers joining a write batch group are first staged in a
+  // queue of the CPU core they run on, and the first writer staged in a
+  // queue links all writers staged there meanwhile into the shared writer
+  // list at once. This spreads the contention of many concurrent writers on
+  // the head of the shared list over the cores. Writers still wait for the
+  // leader as set by enable_write_thread_adaptive_yield.
+  //
+  // Default: false
+  bool enable_write_thread_per_core_queues = false;
+
   // The maximum limit of number of bytes that are written in a single batch
   // of WAL or memtable write. It is followed when the leader write size
   // is larger than 1/8 of this limit.
@@ -1385,6 +1665,18 @@ struct DBOptions {
   // the WAL is read.
   CompressionType wal_compression = kNoCompression;
 
+  // EXPERIMENTAL
+  // With `wal_compression`, WAL records of at least this many bytes are
+  // compressed by a background thread of the WAL writer, one chunk ahead of
+  // the writing thread, which appends each compressed chunk to the WAL while
+  // the next is compressed. This overlaps the compression of large write
+  // groups with their WAL writes, taking it mostly off their latency. The
+  // WAL contents are the same as when compressing inline. Costs a thread per
+  // open WAL writer. 0 means always compressing inline.
+  //
+  // Default: 0
+  size_t wal_compression_pipeline_min_record_size = 0;
+
   // Set to true to re-instate an old behavior of keeping complete, synced WAL
   // files open for write until they are collected for deletion by a
   // background thread. This should not be needed unless there is a
@@ -1852,6 +2144,19 @@ struct ReadOptions {
   // block cache.
   bool fill_cache = true;
 
+  // If true, together with `fill_cache`, the data blocks read from storage
+  // for this request are inserted into the block cache at
+  // Cache::Priority::BOTTOM, the priority of the blocks loaded by a warmup.
+  // They then live in the bottom priority pool of LRUCache (bounded by the
+  // room left by its high and low priority pools, see
+  // LRUCacheOptions::low_pri_pool_ratio) or get a shorter initial life in
+  // HyperClockCache, and are evicted before the blocks read by other requests.
+  // The blocks already in the cache are used as usual, and the blocks a scan
+  // reads ahead remain available to it, unlike with `fill_cache` = false.
+  // Meant for long scans that should not evict the working set of point
+  // lookups. Index and filter blocks are inserted as usual.
+  bool scan_resistant = false;
+
   // DEPRECATED: This option might be removed in a future release.
   // There should be no noticeable performance difference whether this option
   // is turned on or off when a DB does not use DeleteRange().
@@ -1877,6 +2182,27 @@ struct ReadOptions {
   // comes at the expense of slightly higher CPU overhead.
   bool optimize_multiget_for_io = true;
 
+  // EXPERIMENTAL
+  //
+  // If set, the data blocks that MultiGet reads from a table file in one
+  // batch are decompressed, and inserted into the block cache, on this
+  // thread pool and the calling thread at the same time, instead of one
+  // after another on the calling thread. This can cut the latency of large
+  // batches of heavily compressed blocks. The pool is not owned, and should
+  // not be shared with jobs that block.
+  ThreadPool* multiget_decompression_thread_pool = nullptr;
+
+  // EXPERIMENTAL
+  //
+  // If non-nullptr, the wide-column results of GetEntity(), MultiGetEntity()
+  // and the columns() of iterators only hold the columns named here. The
+  // other columns of the entities found are neither copied into the results
+  // nor kept pinned. The value() of iterators is not affected. The names must
+  // be sorted in bytewise order, without duplicates; the default column is
+  // kDefaultWideColumnName. For iterators, the vector must outlive them, like
+  // `iterate_upper_bound`.
+  const std::vector<Slice>* column_projection = nullptr;
+
   // *** END options relevant to point lookups (as well as scans) ***
   // *** BEGIN options only relevant to iterators or scans ***
 
@@ -1888,8 +2214,20 @@ struct ReadOptions {
   // needed.
   // Using a large readahead size (> 2MB) can typically improve the performance
   // of forward iteration on spinning disks.
+  // The same goes for the blob files whose values an iterator reads, which
+  // also get auto-readahead when it is 0.
   size_t readahead_size = 0;
 
+  // EXPERIMENTAL
+  //
+  // With async_io, the number of readahead buffers of a table file that are
+  // read at the same time, each of them up to the readahead size. Full table
+  // scans on high latency storage can keep more reads in flight by raising
+  // it along with a multi-MB readahead_size, and with fill_cache = false to
+  // keep the scanned blocks out of the block cache. Values below 2 are
+  // treated as 2.
+  size_t async_readahead_num_buffers = 2;
+
   // A threshold for the number of keys that can be skipped before failing an
   // iterator seek as incomplete. The default value of 0 should be used to
   // never fail a request as incomplete, even on skipping too many keys.
@@ -2039,6 +2377,20 @@ struct ReadOptions {
   // Default: false
   bool allow_unprepared_value = false;
 
+  // EXPERIMENTAL
+  //
+  // If set, the seeks of a multi-column-family iterator (CoalescingIterator
+  // and AttributeGroupIterator) position the iterators of the column families
+  // on this thread pool and the calling thread at the same time, instead of
+  // one after another on the calling thread, so that a cold seek over N
+  // column families waits for about one read instead of N. Next() and Prev()
+  // are not affected. The pool is not owned, and should not be shared with
+  // jobs that block. Perf context counts of the reads on the pool are not
+  // reported to the calling thread.
+  //
+  // Default: nullptr
+  ThreadPool* multi_cf_iterator_seek_thread_pool = nullptr;
+
   // EXPERIMENTAL
   //
   // Long-running iterators are holding onto memory and storage resources long
@@ -2283,6 +2635,21 @@ struct CompactRangeOptions {
   bool allow_write_stall = false;
   // If > 0, it will replace the option in the DBOptions for this compaction.
   uint32_t max_subcompactions = 0;
+  // EXPERIMENTAL
+  // If > 1, with level compaction, the range is split into up to this many
+  // key shards at file boundaries of the last non-empty level, balanced by
+  // size, and the shards are compacted concurrently. Each shard runs its own
+  // compactions level by level in the LOW or BOTTOM thread pool, so a large
+  // range compacts with as many jobs as shards rather than one at a time.
+  // Shards still wait on each other where their input files overlap, e.g. in
+  // L0. Ignored with exclusive_manual_compaction or change_level.
+  //
+  // Default: 0 (a single shard)
+  uint32_t max_parallel_shards = 0;
+  // If not null, incremented each time a shard of a sharded compaction (see
+  // max_parallel_shards) finishes, so that other threads can follow the
+  // progress. The number of shards is logged when the compaction starts.
+  std::atomic<uint32_t>* completed_shards = nullptr;
   // Set user-defined timestamp low bound, the data with older timestamp than
   // low bound maybe GCed by compaction. Default: nullptr
   const Slice* full_history_ts_low = nullptr;
@@ -2421,6 +2788,34 @@ struct IngestExternalFileOptions {
   // When ingesting to multiple families, this option should be the same across
   // ingestion options.
   bool fill_cache = true;
+
+  // Number of threads, including the calling one, that the files are opened
+  // and validated on, linked or copied into the DB, and checksummed on before
+  // the ingestion. The DB mutex is not held meanwhile. It mostly helps when
+  // ingesting many files with copies, `verify_checksums_before_ingest` or
+  // file checksums.
+  int max_prepare_threads = 1;
+
+  // EXPERIMENTAL
+  // If true, the blocks of the ingested files are loaded into the block cache
+  // while the files are prepared, before they become visible to reads, so
+  // that the first reads after a bulk load do not all go to storage. The
+  // index and filter blocks are loaded, including all their partitions, then
+  // the data blocks if `warm_cache_data_blocks`. Data blocks are inserted at
+  // Cache::Priority::BOTTOM, like the ones of the post-compaction warmup (see
+  // CompactionWarmupPolicy). The reads are charged to the DB's rate limiter
+  // at Env::IO_LOW. Warming is best effort: a failure to warm a file does
+  // not fail the ingestion.
+  bool warm_cache = false;
+  // Whether `warm_cache` loads the data blocks too.
+  bool warm_cache_data_blocks = true;
+  // Upper bound on the bytes of data blocks `warm_cache` reads across the
+  // ingested files. Once this much has been read, the data blocks of the
+  // remaining files are not loaded, so the budget may be exceeded by up to
+  // the size of one file. 0 means no limit.
+  uint64_t warm_cache_max_bytes = 0;
+  // See CompactionWarmupPolicy::stop_at_cache_capacity.
+  bool warm_cache_stop_at_cache_capacity = true;
 };
 
 // It is valid that files_checksums and files_checksum_func_names are both
@@ -2519,6 +2914,13 @@ struct SizeApproximationOptions {
   // If the value is non-positive - a more precise yet more CPU intensive
   // estimation is performed.
   double files_size_error_margin = -1.0;
+  // If true, the files part of the size is estimated from sampled key anchors
+  // of the table files (see DB::GetApproximateRangeStats()) instead of the
+  // index blocks of every file overlapping the range. Much cheaper for
+  // frequent queries, but only as precise as the anchors: up to about 1/32 of
+  // a file may be missed at each end of the range.
+  // files_size_error_margin is ignored then.
+  bool use_key_anchors = false;
 };
 
 struct CompactionServiceOptionsOverride {
@@ -2601,4 +3003,64 @@ struct WaitForCompactOptions {
   std::chrono::microseconds timeout = std::chrono::microseconds::zero();
 };
 
+// Progress of a DB::WarmupRange() call, reported to
+// WarmupOptions::progress_callback.
+struct WarmupProgress {
+  // Files of the range warmed so far, and of the whole range.
+  uint64_t files_warmed = 0;
+  uint64_t total_files = 0;
+  // Data blocks read and loaded into the block cache, and their bytes
+  // including trailers.
+  uint64_t blocks_inserted = 0;
+  uint64_t bytes_read = 0;
+  // Data blocks of the range that were already in the block cache.
+  uint64_t blocks_already_cached = 0;
+  // True for the last report of the call, whose status is then `status`.
+  bool done = false;
+  Status status;
+};
+
+// EXPERIMENTAL
+// Options of DB::WarmupRange(). The blocks are loaded by the same machinery as
+// the post-compaction warmup (see CompactionWarmupPolicy), one file at a time
+// and without iterating over the keys.
+struct WarmupOptions {
+  // Upper bound on the bytes read. Once this much has been read, the warmup
+  // does not start on another file, so the budget may be exceeded by up to
+  // the size of one file. 0 means no limit.
+  uint64_t max_bytes = 0;
+
+  // If true, the data blocks are inserted into the block cache at
+  // Cache::Priority::BOTTOM, like the ones of the post-compaction warmup, so
+  // that they are the first to go if they are not read soon. Otherwise they
+  // are inserted like the blocks read by the application.
+  bool low_priority = true;
+
+  // If true, no block is loaded that would push the block cache usage over
+  // its capacity, so that the warmup never evicts blocks in use.
+  bool stop_at_cache_capacity = false;
+
+  // Whether the data blocks of the range are loaded.
+  bool data_blocks = true;
+
+  // Whether all the index and filter partitions of the files overlapping the
+  // range are loaded, for files with a partitioned index or filters.
+  bool index_and_filter_partitions = true;
+
+  // The reads are charged to DBOptions::rate_limiter, if any, at this
+  // priority. Env::IO_TOTAL means they are not rate limited.
+  Env::IOPriority rate_limiter_priority = Env::IO_LOW;
+
+  // If false, the warmup is queued to the background warmup jobs (see
+  // DBOptions::max_background_warmups, which must then be non-zero) and
+  // WarmupRange() returns as soon as it is queued. Otherwise it runs on the
+  // calling thread.
+  bool wait = true;
+
+  // If set, called after each file and once more, with `done` set, when the
+  // warmup is over, on the thread running the warmup. Must not call back into
+  // the DB.
+  std::function<void(const WarmupProgress&)> progress_callback;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
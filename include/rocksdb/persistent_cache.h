@@ -19,6 +19,8 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class SecondaryCache;
+
 // PersistentCache
 //
 // Persistent cache interface for caching IO pages on a persistent medium. The
@@ -71,4 +73,18 @@ Status NewPersistentCache(Env* const env, const std::string& path,
                           const std::shared_ptr<Logger>& log,
                           const bool optimized_for_nvm,
                           std::shared_ptr<PersistentCache>* cache);
+
+// EXPERIMENTAL
+// Returns a SecondaryCache storing the blocks in `cache`, e.g. one created
+// by NewPersistentCache() on flash, so that it can back a block cache as
+// its secondary cache, or a TieredCacheOptions::nvm_sec_cache.
+//
+// The blocks evicted from the primary cache are admitted only when the
+// primary cache forces their insertion, which with
+// TieredAdmissionPolicy::kAdmPolicyAllowCacheHits means that they were hit
+// before being evicted, or when they are evicted a second time within the
+// last million evictions. The blocks given to InsertSaved() are always
+// admitted, along with their compression type.
+std::shared_ptr<SecondaryCache> NewPersistentSecondaryCache(
+    std::shared_ptr<PersistentCache> cache);
 }  // namespace ROCKSDB_NAMESPACE
@@ -82,6 +82,23 @@ class SstFileManager {
   // thread-safe
   virtual uint64_t GetTotalTrashSize() = 0;
 
+  // Return the number of trash files waiting to be deleted
+  // thread-safe
+  virtual int32_t GetNumTrashFiles() = 0;
+
+  // EXPERIMENTAL
+  // Return the number of background threads deleting trash files
+  // thread-safe
+  virtual int GetNumDeleteThreads() = 0;
+
+  // EXPERIMENTAL
+  // Update the number of background threads deleting trash files at once.
+  // They share the delete rate limit, so that the rate of all of their deletes
+  // together is bounded by it. More threads help meet the rate limit when
+  // deleting a single file, or syncing its directory, is slow. Default: 1
+  // thread-safe
+  virtual void SetNumDeleteThreads(int num_threads) = 0;
+
   // Set the statistics ptr to dump the stat information
   virtual void SetStatisticsPtr(const std::shared_ptr<Statistics>& stats) = 0;
 };
@@ -8,6 +8,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "rocksdb/customizable.h"
 #include "rocksdb/rocksdb_namespace.h"
@@ -15,6 +17,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Comparator;
 class Slice;
 
 enum PartitionerResult : char {
@@ -75,6 +78,15 @@ class SstPartitioner {
     Slice smallest_user_key;
     // Largest key for compaction
     Slice largest_user_key;
+    // User key comparator of the column family
+    const Comparator* comparator = nullptr;
+    // Key ranges of the compaction inputs that user reads found hot in the
+    // block cache, each as its smallest and largest user key, both included.
+    // They are in key order and do not overlap. Only filled in for factories
+    // whose NeedsHotKeyRanges() is true, and otherwise or if the hotness of
+    // the inputs is not known, empty. The slices are only valid during
+    // CreatePartitioner().
+    std::vector<std::pair<Slice, Slice>> hot_key_ranges;
   };
 };
 
@@ -92,6 +104,12 @@ class SstPartitionerFactory : public Customizable {
   virtual std::unique_ptr<SstPartitioner> CreatePartitioner(
       const SstPartitioner::Context& context) const = 0;
 
+  // If true, compactions look up which key ranges of their inputs were hot
+  // before creating their partitioners, see Context::hot_key_ranges. That
+  // takes reading the index of every input file, and the hotness is only
+  // tracked with BlockBasedTableOptions::warmup_min_data_block_hits.
+  virtual bool NeedsHotKeyRanges() const { return false; }
+
   // Returns a name that identifies this partitioner factory.
   const char* Name() const override = 0;
 };
@@ -139,4 +157,65 @@ class SstPartitionerFixedPrefixFactory : public SstPartitionerFactory {
 std::shared_ptr<SstPartitionerFactory> NewSstPartitionerFixedPrefixFactory(
     size_t prefix_len);
 
+/*
+ * Hot key range partitioner. It splits the output SST files where the keys
+ * enter or leave a hot key range of the compaction inputs, and within such a
+ * range every max_hot_file_size bytes, so that the hot keys end up in small
+ * files of their own. A later compaction of the cold keys around them then
+ * does not evict the hot data from the block cache, and the compactions and
+ * warmups of the hot data work on small files.
+ *
+ * Hot key ranges are only known with
+ * BlockBasedTableOptions::warmup_min_data_block_hits, and otherwise the
+ * partitioner never splits.
+ */
+class SstPartitionerHotRanges : public SstPartitioner {
+ public:
+  SstPartitionerHotRanges(const SstPartitioner::Context& context,
+                          uint64_t max_hot_file_size);
+
+  ~SstPartitionerHotRanges() override {}
+
+  const char* Name() const override { return "SstPartitionerHotRanges"; }
+
+  PartitionerResult ShouldPartition(const PartitionerRequest& request) override;
+
+  bool CanDoTrivialMove(const Slice& smallest_user_key,
+                        const Slice& largest_user_key) override;
+
+ private:
+  // 2 * i + 1 for the keys of hot range i, and 2 * i for the keys between
+  // hot ranges i - 1 and i, so that the files are split where it changes.
+  size_t Position(const Slice& user_key) const;
+
+  const Comparator* comparator_;
+  std::vector<std::pair<std::string, std::string>> hot_ranges_;
+  uint64_t max_hot_file_size_;
+};
+
+/*
+ * Factory for hot key range partitioner.
+ */
+class SstPartitionerHotRangesFactory : public SstPartitionerFactory {
+ public:
+  explicit SstPartitionerHotRangesFactory(uint64_t max_hot_file_size);
+
+  ~SstPartitionerHotRangesFactory() override {}
+
+  static const char* kClassName() { return "SstPartitionerHotRangesFactory"; }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<SstPartitioner> CreatePartitioner(
+      const SstPartitioner::Context& context) const override;
+
+  bool NeedsHotKeyRanges() const override { return true; }
+
+ private:
+  uint64_t max_hot_file_size_;
+};
+
+// max_hot_file_size of 0 means that hot key ranges are not split further.
+std::shared_ptr<SstPartitionerFactory> NewSstPartitionerHotRangesFactory(
+    uint64_t max_hot_file_size);
+
 }  // namespace ROCKSDB_NAMESPACE
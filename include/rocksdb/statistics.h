@@ -542,6 +542,23 @@ enum Tickers : uint32_t {
   // TransactionOptions::large_txn_commit_optimize_threshold.
   NUMBER_WBWI_INGEST,
 
+  // Post-compaction warmup (DBOptions::max_background_warmups):
+  // number of data blocks read and inserted into the block cache,
+  WARMUP_BLOCKS_INSERTED,
+  // number of bytes read from SST files,
+  WARMUP_BYTES_READ,
+  // number of data blocks skipped because they were already cached,
+  WARMUP_BLOCKS_ALREADY_CACHED,
+  // and number of data blocks, and their bytes, that were not loaded because
+  // the block cache was full
+  // (CompactionWarmupPolicy::stop_at_cache_capacity).
+  WARMUP_BLOCKS_SKIPPED,
+  WARMUP_BYTES_SKIPPED,
+  // Number of blobs relocated by blob garbage collection that were inserted
+  // into the blob cache at their new location
+  // (CompactionWarmupPolicy::warm_relocated_blobs).
+  WARMUP_RELOCATED_BLOBS_INSERTED,
+
   TICKER_ENUM_MAX
 };
 
@@ -682,6 +699,36 @@ enum Histograms : uint32_t {
   // Number of operations per transaction.
   NUM_OP_PER_TRANSACTION,
 
+  // Time spent running a post-compaction warmup job.
+  WARMUP_MICROS,
+
+  // Time spent in each part of the operations sampled with
+  // DBOptions::perf_context_sample_rate, in nanoseconds:
+  // Get() in memtables, in SST files, and reading blocks,
+  SAMPLED_GET_MEMTABLE_NANOS,
+  SAMPLED_GET_FILES_NANOS,
+  SAMPLED_GET_BLOCK_READ_NANOS,
+  // the MultiGet() of the keys of a column family in memtables, in SST files,
+  // and reading blocks,
+  SAMPLED_MULTIGET_MEMTABLE_NANOS,
+  SAMPLED_MULTIGET_FILES_NANOS,
+  SAMPLED_MULTIGET_BLOCK_READ_NANOS,
+  // iterator Seek() and SeekForPrev() in memtables, in the child iterators,
+  // and reading blocks,
+  SAMPLED_SEEK_MEMTABLE_NANOS,
+  SAMPLED_SEEK_CHILD_NANOS,
+  SAMPLED_SEEK_BLOCK_READ_NANOS,
+  // and Write() to the WAL, to memtables, and delayed.
+  SAMPLED_WRITE_WAL_NANOS,
+  SAMPLED_WRITE_MEMTABLE_NANOS,
+  SAMPLED_WRITE_DELAY_NANOS,
+
+  // Time a LogAndApply() call waits in the MANIFEST write queue, until it
+  // either leads a group commit or is committed by another call's.
+  MANIFEST_WRITE_QUEUE_MICROS,
+  // Number of LogAndApply() calls committed by each MANIFEST write.
+  MANIFEST_WRITE_GROUP_SIZE,
+
   HISTOGRAM_ENUM_MAX
 };
 
@@ -258,6 +258,17 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // EXPERIMENTAL
+    // Like kBinarySearch, plus a piecewise-linear model from the keys of the
+    // index block to its restart points, stored in a meta block. Seeks only
+    // binary search the few restart points around the predicted one, so they
+    // touch less of the index block. Fits fixed-width keys spread evenly
+    // over their range. Without the default bytewise comparator, or with
+    // user-defined timestamps, no model is written and seeks binary search
+    // the whole index block. Releases that don't know this index type can't
+    // read the files.
+    kLearnedIndexSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -266,6 +277,15 @@ struct BlockBasedTableOptions {
   enum DataBlockIndexType : char {
     kDataBlockBinarySearch = 0,   // traditional block type
     kDataBlockBinaryAndHash = 1,  // additional hash index
+    // EXPERIMENTAL
+    // Stores the first 8 bytes of the user key of each restart point in an
+    // array beside the restart array, so that seeks narrow down the restart
+    // points by comparing integers and only decode the keys and call the
+    // comparator on the ones sharing the prefix of the target. Only used
+    // with BytewiseComparator() and for blocks of up to 64KiB; other data
+    // blocks are written with kDataBlockBinarySearch. Older versions of
+    // RocksDB cannot read the data blocks written with it.
+    kDataBlockBinarySearchWithKeyPrefixes = 2,
   };
 
   DataBlockIndexType data_block_index_type = kDataBlockBinarySearch;
@@ -409,7 +429,21 @@ struct BlockBasedTableOptions {
   // (iii) Compatible existing behavior:
   // Same as kDisabled.
   //
-  // (e) Other CacheEntryRole
+  // (e) CacheEntryRole::kCompactionBuffer
+  // (i) If kEnabled:
+  // Charge an estimate of the memory used by a running compaction for the
+  // read-ahead buffers of its input files and the buffer of its output file,
+  // for as long as it runs.
+  // The compaction still runs, uncharged, if the estimate exceeds the
+  // avaible space left in the block cache (i.e, causing a cache full under
+  // `LRUCacheOptions::strict_capacity_limit` = true), but the other
+  // consumers charging to the block cache see the memory as used meanwhile.
+  // (ii) If kDisabled:
+  // Does not charge the memory usage mentioned above.
+  // (iii) Compatible existing behavior:
+  // Same as kDisabled.
+  //
+  // (f) Other CacheEntryRole
   // Not supported.
   // `Status::kNotSupported` will be returned if
   // `CacheEntryRoleOptions::charged` is set to {`kEnabled`, `kDisabled`}.
@@ -578,6 +612,66 @@ struct BlockBasedTableOptions {
   // Align data blocks on lesser of page size and block size
   bool block_align = false;
 
+  // EXPERIMENTAL
+  // Pad the file before a data block that would otherwise span one more page
+  // than its size requires, so that reading a block of up to a page touches
+  // one page. Unlike `block_align`, this works with compression and only pads
+  // where a block would cross a page boundary. It works best with a
+  // `block_size` at which most data blocks come out just under a page (4KB)
+  // after compression.
+  bool avoid_data_block_page_crossing = false;
+
+  // EXPERIMENTAL
+  // If non-zero, data blocks are grouped into fetch units of this many bytes
+  // for file systems with a high cost per request, such as object stores:
+  // the file is padded before a data block that would otherwise span two
+  // units, and when a point lookup misses the block cache on a data block,
+  // all the data blocks of its unit that are not cached are read with a
+  // single request and loaded into the block cache. Sizes of 1-4MB suit
+  // object stores. The index, filter and other metadata already sit in a
+  // contiguous tail that is read in one request when the table is opened
+  // (see FileMetaData::tail_size). Requires a block cache to have an effect
+  // on reads.
+  //
+  // Default: 0 (disabled)
+  uint64_t data_block_fetch_unit_size = 0;
+
+  // EXPERIMENTAL
+  // With a prefix extractor, write a meta block mapping each prefix of the
+  // file to the range of data blocks holding its keys. The table reader keeps
+  // the map in memory, with the other table reader memory. A Get of a key
+  // whose prefix is not in the file returns without reading the index or a
+  // filter, and one whose prefix is in a single data block reads that block
+  // without searching the index, which saves the most with
+  // kTwoLevelIndexSearch. A prefix seek to a prefix not in the file doesn't
+  // read the index either. It works with any index type. The map is only
+  // written when the prefixes of the keys are in bytewise order, as with the
+  // bytewise comparators, and files written without it are read as usual.
+  bool prefix_block_map = false;
+
+  // EXPERIMENTAL
+  // Write index blocks in a compact format, where the restart array and the
+  // offsets of the data blocks of the restart entries are Elias-Fano encoded
+  // and read in place, without decoding the block. This saves about 4 bytes
+  // per index entry with the default `index_block_restart_interval` of 1, so
+  // more of the index fits in the block cache, at the cost of more CPU per
+  // binary search step. It applies
+  // to kBinarySearch, kBinarySearchWithFirstKey and the partitions of
+  // kTwoLevelIndexSearch, only with `format_version` >= 4 and without
+  // `block_align` or `avoid_data_block_page_crossing`, and files written
+  // with it cannot be read by versions without it.
+  bool compact_index_blocks = false;
+
+  // EXPERIMENTAL
+  // Build the full filter of each table file on a helper thread while the
+  // index and the other meta blocks are written, instead of before them, to
+  // take filter construction (Ribbon filters in particular) off the critical
+  // path of finishing a file. The filter block is then written after the
+  // other meta blocks, just before the properties block. It has no effect
+  // with `partition_filters`, where the partitions are built as the keys are
+  // added.
+  bool background_filter_build = false;
+
   // This enum allows trading off increased index size for improved iterator
   // seek performance in some situations, particularly when block cache is
   // disabled (ReadOptions::fill_cache = false) and direct IO is
@@ -642,16 +736,87 @@ struct BlockBasedTableOptions {
   // further helps if the workload exhibits high temporal locality, where most
   // of the reads go to recently written data. This also helps in case of
   // Distributed FileSystem.
+  //
+  // kFlushAndCompaction also prepopulates the blocks of compaction output
+  // files, which keeps recently compacted (and likely still hot) key ranges
+  // cached without reading them back after the compaction. Since compactions
+  // write far more data than flushes, this can be limited with the
+  // prepopulate_block_cache_compaction_* options below.
   enum class PrepopulateBlockCache : char {
     // Disable prepopulate block cache.
     kDisable,
     // Prepopulate blocks during flush only.
     kFlushOnly,
+    // Prepopulate blocks during flush and compaction.
+    kFlushAndCompaction,
   };
 
   PrepopulateBlockCache prepopulate_block_cache =
       PrepopulateBlockCache::kDisable;
 
+  // Only used with kFlushAndCompaction. The blocks of a compaction output
+  // file are prepopulated only if the file is written to a level no greater
+  // than this one. A negative value means compaction outputs of all levels
+  // are prepopulated.
+  //
+  // Default: -1
+  int prepopulate_block_cache_compaction_max_level = -1;
+
+  // Only used with kFlushAndCompaction. If true, only the index, filter and
+  // compression dictionary blocks of compaction output files are
+  // prepopulated, not their data blocks.
+  //
+  // Default: false
+  bool prepopulate_block_cache_compaction_metadata_only = false;
+
+  // Only used with kFlushAndCompaction. Maximum total size of the data blocks
+  // that a single compaction job prepopulates, across all of its output
+  // files. Data blocks past the budget are written without being cached.
+  // Index, filter and compression dictionary blocks are not charged to the
+  // budget. 0 means no limit.
+  //
+  // Default: 0
+  uint64_t prepopulate_block_cache_compaction_max_bytes = 0;
+
+  // Only used with kFlushAndCompaction and `warmup_min_data_block_hits`. If
+  // true, only the data blocks of compaction output files overlapping the key
+  // ranges that were hot in the block cache in the compaction inputs are
+  // prepopulated. The compaction then carries the cached part of its inputs
+  // over to its outputs as it writes them, instead of dropping it from the
+  // cache or filling the cache with every output block. If the hot key
+  // ranges of an input are not known, all the data blocks are prepopulated
+  // as without this option.
+  //
+  // Default: false
+  bool prepopulate_block_cache_compaction_hot_ranges_only = false;
+
+  // If non-zero, each table reader keeps an approximate count of the block
+  // cache hits of its data blocks by user reads (Get, MultiGet, iterators).
+  // When a compaction rewrites such tables and post-compaction warmup is
+  // enabled (DBOptions::max_background_warmups), only the parts of the output
+  // files overlapping input data blocks with at least this many hits are
+  // warmed, instead of the whole output files. The count saturates at 255,
+  // so larger values behave like 255. Costs about one byte of memory per data
+  // block of each open table. The same counts give the hot key ranges of
+  // SstPartitionerHotRangesFactory.
+  //
+  // Default: 0 (disabled)
+  uint32_t warmup_min_data_block_hits = 0;
+
+  // EXPERIMENTAL
+  // When dictionary compression is configured (see
+  // CompressionOptions::max_dict_bytes), a dictionary trained for a flush or
+  // compaction output file is kept and reused for up to this many later
+  // output files of the same column family and level with the same
+  // compression settings. Those files skip buffering and sampling their data
+  // blocks, so they are written as they are built, and the dictionary is
+  // retrained from fresh samples once the reuses are used up. Each file still
+  // stores its own copy of the dictionary, so files remain self-contained.
+  // Files written by SstFileWriter never reuse a dictionary.
+  //
+  // Default: 0 (train a dictionary for every file)
+  uint32_t compression_dict_reuse_files = 0;
+
   // RocksDB does auto-readahead for iterators on noticing more than two reads
   // for a table file if user doesn't provide readahead_size. The readahead size
   // starts at initial_auto_readahead_size and doubles on every additional read
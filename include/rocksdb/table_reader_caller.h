@@ -35,6 +35,9 @@ enum TableReaderCaller : char {
   // A list of callers that are either not interesting for analysis or are
   // calling from a test environment, e.g., unit test, benchmark, etc.
   kUncategorized = 14,
+  // The post-compaction warmup of the block cache, see
+  // DBOptions::max_background_warmups.
+  kWarmup = 15,
   // All callers should be added before kMaxBlockCacheLookupCaller.
   kMaxBlockCacheLookupCaller
 };
@@ -111,6 +111,20 @@ class CompactionOptionsUniversal {
   // Default: false
   bool incremental;
 
+  // EXPERIMENTAL
+  // Only used with `incremental`. A size amplification compaction normally
+  // merges a key range slice of the last two sorted runs only if that costs
+  // at most 1.8 times the write amplification of merging whole sorted runs,
+  // and otherwise all of them are merged at once, which temporarily takes up
+  // to twice the space of the data. If true, the slice with the lowest
+  // fanout is picked anyway, so that size amplification is always reduced
+  // about max_compaction_bytes at a time, with a space overhead of a few
+  // percent and a steady I/O rate, at the cost of more write amplification.
+  // Whole sorted runs are still merged when the second last sorted run is in
+  // L0, which cannot be sliced.
+  // Default: false
+  bool incremental_avoid_full_compaction;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
@@ -121,7 +135,8 @@ class CompactionOptionsUniversal {
         max_read_amp(-1),
         stop_style(kCompactionStopStyleTotalSize),
         allow_trivial_move(false),
-        incremental(false) {}
+        incremental(false),
+        incremental_avoid_full_compaction(false) {}
 
 #if __cplusplus >= 202002L
   bool operator==(const CompactionOptionsUniversal& rhs) const = default;
@@ -0,0 +1,71 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct AsyncGetQueueOptions {
+  // The queued lookups are run once this many of them are queued, on top of
+  // when Poll() is called.
+  size_t max_batch_size = 128;
+};
+
+// EXPERIMENTAL
+// AsyncGetQueue lets one application thread issue point lookups one at a
+// time, like with DB::Get(), while they are run together like with
+// DB::MultiGet(). The lookups of a batch share the index and filter accesses
+// of the files that they go to, and the data blocks that they need from a
+// file are read in parallel. With ReadOptions::async_io, and a build with
+// coroutines, the reads of different files overlap as well.
+//
+// The lookups see the DB as of when they are run, not as of when they are
+// queued, unless ReadOptions::snapshot is set.
+//
+// Not thread-safe: each thread should use its own queue.
+class AsyncGetQueue {
+ public:
+  // Called with the outcome of a lookup. `value` is only valid for the
+  // duration of the call, and is empty unless `status` is OK.
+  using Callback = std::function<void(const Status& status, PinnableSlice*)>;
+
+  // `db` must outlive the queue.
+  AsyncGetQueue(DB* db, const ReadOptions& read_options,
+                const AsyncGetQueueOptions& options = AsyncGetQueueOptions());
+  // Runs the lookups still queued.
+  ~AsyncGetQueue();
+
+  AsyncGetQueue(const AsyncGetQueue&) = delete;
+  AsyncGetQueue& operator=(const AsyncGetQueue&) = delete;
+
+  // Queues a lookup of `key`, which is copied. The queued lookups, including
+  // this one, are run right away if the queue is full, so `callback` can be
+  // called before this returns.
+  void Get(ColumnFamilyHandle* column_family, const Slice& key,
+           Callback callback);
+
+  // Runs the queued lookups and calls their callbacks. The callbacks can
+  // queue more lookups, which are run by the next call. Returns the number
+  // of lookups run.
+  size_t Poll();
+
+  // Number of lookups queued and not run yet
+  size_t NumPending() const;
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
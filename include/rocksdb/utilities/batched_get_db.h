@@ -0,0 +1,50 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/utilities/stackable_db.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct BatchedGetOptions {
+  // How long the first Get of a batch waits for others to join it. 0 only
+  // batches the Gets that arrive while the batch is being set up.
+  uint64_t window_micros = 10;
+
+  // A batch is run as soon as it has this many Gets.
+  size_t max_batch_size = 32;
+};
+
+// EXPERIMENTAL
+// BatchedGetDB gathers the Gets that threads make at about the same time
+// into one DB::MultiGet(), so that independent lookups share the filter
+// probes and the coalesced reads of MultiGet, at the cost of up to
+// `window_micros` of added latency. Each Get still returns its own result
+// to its caller.
+//
+// Gets are batched together when they are for the same column family with
+// equivalent ReadOptions. Gets that ask for timestamps are passed through.
+class BatchedGetDB : public StackableDB {
+ public:
+  // Takes ownership of `db`, like StackableDB
+  BatchedGetDB(DB* db, const BatchedGetOptions& options);
+  ~BatchedGetDB() override;
+
+  using StackableDB::Get;
+  Status Get(const ReadOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, PinnableSlice* value,
+             std::string* timestamp) override;
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
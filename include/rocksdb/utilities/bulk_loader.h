@@ -0,0 +1,94 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct BulkLoaderOptions {
+  // The keys and values added are buffered up to this many bytes in total,
+  // including the buffers being sorted and spilled in the background.
+  size_t memory_budget = 256 << 20;
+
+  // Number of threads sorting and spilling the buffers, and then writing the
+  // output files. At least 1.
+  int num_threads = 4;
+
+  // The output files are cut at about this size. 0 means the
+  // `target_file_size_base` of the column family.
+  uint64_t target_file_size = 0;
+
+  // Directory of the spilled runs and the output files. It must be on the
+  // file system of the DB so that the output files can be moved into the
+  // DB. Empty means a "bulk_loader" directory in the DB directory.
+  std::string temp_dir;
+
+  // Options of the ingestion of the output files. `move_files` is set by
+  // default, since the output files are of no use after the ingestion.
+  IngestExternalFileOptions ingest_options;
+
+  // When `hot_end` is not empty, the data blocks of the keys in
+  // [hot_begin, hot_end) are loaded into the block cache once the files are
+  // ingested, so that the first reads of the range do not miss the cache.
+  std::string hot_begin;
+  std::string hot_end;
+
+  BulkLoaderOptions() { ingest_options.move_files = true; }
+};
+
+// EXPERIMENTAL
+// BulkLoader loads a large unsorted set of keys and values into a column
+// family with a single ingestion, without going through the memtables and
+// the compactions of the DB.
+//
+// The pairs added are buffered, and each full buffer is sorted and spilled
+// to a run file in the background while the next one fills. Finish() then
+// splits the key space into ranges, merges the runs of each range into
+// non-overlapping table files on `num_threads` threads, and ingests all of
+// them at once with IngestExternalFile(), which places them on the lowest
+// level that they fit in, e.g. the bottommost level of an empty column
+// family.
+//
+// When a key is added more than once, the last value added is kept. The
+// keys must not be in timestamp format, and BulkLoader is not thread-safe.
+class BulkLoader {
+ public:
+  // `db` and `column_family` must outlive the BulkLoader. A null
+  // `column_family` means the default one.
+  BulkLoader(DB* db, ColumnFamilyHandle* column_family,
+             const BulkLoaderOptions& options);
+  ~BulkLoader();
+
+  BulkLoader(const BulkLoader&) = delete;
+  BulkLoader& operator=(const BulkLoader&) = delete;
+
+  // Adds a pair to load. Blocks while the buffers being spilled take the
+  // memory budget. Returns the error of an earlier spill, if any.
+  Status Add(const Slice& key, const Slice& value);
+
+  // Writes the output files and ingests them. Nothing can be added after it
+  // is called, and the temporary files are removed whether it succeeds or
+  // not.
+  Status Finish();
+
+  // Number of output files ingested by Finish()
+  size_t GetNumFilesIngested() const;
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
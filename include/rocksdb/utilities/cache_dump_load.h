@@ -6,6 +6,8 @@
 #pragma once
 
 #include <set>
+#include <string>
+#include <unordered_map>
 
 #include "rocksdb/cache.h"
 #include "rocksdb/env.h"
@@ -63,6 +65,10 @@ class CacheDumpReader {
   // (Close not needed)
 };
 
+// The number of accesses to block cache entries, by cache key. See
+// CountCacheEntryAccesses() and CacheDumpOptions::access_counts.
+using CacheEntryAccessCounts = std::unordered_map<std::string, uint64_t>;
+
 // CacheDumpOptions is the option for CacheDumper and CacheDumpedLoader. Any
 // dump or load process related control variables can be added here.
 struct CacheDumpOptions {
@@ -71,6 +77,12 @@ struct CacheDumpOptions {
   std::chrono::microseconds deadline = std::chrono::microseconds::zero();
   // Max size bytes for dumper or loader
   uint64_t max_size_bytes = 0;
+  // The fraction, in [0, 1], of the entries passing the dump filter that the
+  // dumper writes out: the most accessed ones according to `access_counts`,
+  // in which entries that are missing count as never accessed. Less than 1
+  // requires `access_counts`.
+  double hot_entries_ratio = 1.0;
+  std::shared_ptr<const CacheEntryAccessCounts> access_counts;
 };
 
 // NOTE that: this class is EXPERIMENTAL! May be changed in the future!
@@ -96,7 +108,8 @@ class CacheDumper {
   }
   // The main function to dump out all the blocks that satisfy the filter
   // condition from block cache to a certain CacheDumpWriter in one shot. This
-  // process may take some time.
+  // process may take some time. Index and filter blocks are written before
+  // data blocks, so that a loader restores them first.
   virtual IOStatus DumpCacheEntriesToWriter() {
     return IOStatus::NotSupported("DumpCacheEntriesToWriter is not supported");
   }
@@ -127,6 +140,12 @@ IOStatus NewFromFileCacheDumpReader(const std::shared_ptr<FileSystem>& fs,
                                     const std::string& file_name,
                                     std::unique_ptr<CacheDumpReader>* reader);
 
+// Counts the accesses to each block recorded in the block cache trace file
+// `trace_file` (see DB::StartBlockCacheTrace()) into `counts`, e.g. to only
+// dump the hot entries of a block cache.
+Status CountCacheEntryAccesses(Env* env, const std::string& trace_file,
+                               CacheEntryAccessCounts* counts);
+
 // Get the default cache dumper
 Status NewDefaultCacheDumper(const CacheDumpOptions& dump_options,
                              const std::shared_ptr<Cache>& cache,
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,9 +17,28 @@ namespace ROCKSDB_NAMESPACE {
 
 class DB;
 class ColumnFamilyHandle;
+class RateLimiter;
 struct LiveFileMetaData;
 struct ExportImportFilesMetaData;
 
+struct IncrementalCheckpointOptions {
+  // A checkpoint created by CreateIncrementalCheckpoint() on the same file
+  // system as the new checkpoint. The SST and blob files of the DB that are
+  // also in the base checkpoint are hard linked from it instead of being
+  // copied from the DB. The base checkpoint must not have been opened for
+  // writes. Empty means no base checkpoint.
+  std::string base_checkpoint_dir;
+
+  // The number of threads copying the files that cannot be hard linked
+  int max_background_copies = 1;
+
+  // If not nullptr, limits the rate of the writes of the copies
+  std::shared_ptr<RateLimiter> rate_limiter;
+
+  // Same as the argument of CreateCheckpoint()
+  uint64_t log_size_for_flush = 0;
+};
+
 class Checkpoint {
  public:
   // Creates a Checkpoint object to be used for creating openable snapshots
@@ -49,6 +69,18 @@ class Checkpoint {
                                   uint64_t log_size_for_flush = 0,
                                   uint64_t* sequence_number_ptr = nullptr);
 
+  // Same as CreateCheckpoint(), except that the SST and blob files that cannot
+  // be hard linked from the DB, e.g. when the checkpoint is on another file
+  // system, are hard linked from `options.base_checkpoint_dir` when it has
+  // them and copied from the DB otherwise, by parallel copy threads. The file
+  // checksums recorded in the DB, if any, are used to find the files of the
+  // base checkpoint that can be reused, and are recorded in the new checkpoint
+  // along with its files, so that it can be the base of the next one.
+  virtual Status CreateIncrementalCheckpoint(
+      const std::string& checkpoint_dir,
+      const IncrementalCheckpointOptions& options,
+      uint64_t* sequence_number_ptr = nullptr);
+
   // Exports all live SST files of a specified Column Family onto export_dir,
   // returning SST files information in metadata.
   // - SST files will be created as hard links when the directory specified
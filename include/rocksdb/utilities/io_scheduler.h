@@ -0,0 +1,45 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+
+#include "rocksdb/file_system.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct IOSchedulerOptions {
+  // Number of background I/Os in flight at once. 0 means no limit.
+  int max_background_ios = 8;
+
+  // Number of background I/Os in flight at once while foreground I/Os are in
+  // flight. 0 holds background I/Os back until no foreground I/O is in
+  // flight, or until they run out of `max_background_wait_micros`.
+  int max_background_ios_with_foreground = 1;
+
+  // A background I/O that has waited this long goes ahead regardless of the
+  // limits above, so that background work is slowed down but not starved.
+  uint64_t max_background_wait_micros = 10 * 1000;
+};
+
+// EXPERIMENTAL
+// Returns a FileSystem that keeps the reads and writes of background work,
+// like flushes, compactions and low priority user reads, from queuing ahead
+// of foreground reads in the device. It caps the number of background I/Os
+// in flight on the files it opens, more tightly while foreground I/Os are in
+// flight. Foreground I/Os are never held back.
+//
+// An I/O is foreground if its IOOptions::io_activity is that of a user read
+// or its IOOptions::rate_limiter_priority is Env::IO_USER, and background if
+// its io_activity is kFlush or kCompaction or its rate_limiter_priority is
+// below Env::IO_USER. Other I/Os, like the ones of DB open, are not
+// scheduled.
+std::shared_ptr<FileSystem> NewIOSchedulerFileSystem(
+    const std::shared_ptr<FileSystem>& base,
+    const IOSchedulerOptions& options);
+
+}  // namespace ROCKSDB_NAMESPACE
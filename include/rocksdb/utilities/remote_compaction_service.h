@@ -0,0 +1,117 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// EXPERIMENTAL
+// RemoteCompactionService hands the compactions of a DB to a pool of
+// stateless RemoteCompactionWorkers through a job queue directory. The
+// workers open the DB files from the same shared storage, so only the
+// serialized CompactionServiceInput and CompactionServiceResult go through
+// the queue. A worker writes the output files into a directory under the DB,
+// from where the primary installs them.
+//
+// For an attempt <job> of a compaction, the queue directory holds:
+//   <job>.job      the compaction input, written by the primary
+//   <job>.claimed  renamed from <job>.job by the one worker running the job
+//   <job>.result   the outcome, written by the worker
+//   <job>.cancel   asks the worker to abandon the job
+// Every file is written under a temporary name and renamed into place, so
+// that they are never seen partially written.
+struct RemoteCompactionServiceOptions {
+  // Directory on the shared storage holding the job files. The primary and
+  // all of its workers must use the same one.
+  std::string queue_dir;
+
+  // Env used to access the queue directory and, on the workers, the DB.
+  Env* env = Env::Default();
+
+  // How often a waiting primary or idle worker looks at the queue directory.
+  uint64_t poll_interval_micros = 100 * 1000;
+
+  // A job that no worker has claimed within this time is taken back and run
+  // locally by the primary.
+  uint64_t claim_timeout_micros = 10 * 1000 * 1000;
+
+  // An attempt that has not finished within this time of being scheduled is
+  // canceled and scheduled again, assuming that its worker is gone.
+  // 0 means no limit.
+  uint64_t run_timeout_micros = 0;
+
+  // Number of attempts at a job, counting the ones that the worker reported
+  // as failed, before the primary gives up on it. A job that ran out of time
+  // is then run locally, and a failed one fails the compaction.
+  int max_attempts = 3;
+};
+
+class RemoteCompactionService : public CompactionService {
+ public:
+  explicit RemoteCompactionService(
+      const RemoteCompactionServiceOptions& options);
+  ~RemoteCompactionService() override;
+
+  static const char* kClassName() { return "RemoteCompactionService"; }
+  const char* Name() const override { return kClassName(); }
+
+  CompactionServiceScheduleResponse Schedule(
+      const CompactionServiceJobInfo& info,
+      const std::string& compaction_service_input) override;
+
+  CompactionServiceJobStatus Wait(const std::string& scheduled_job_id,
+                                  std::string* result) override;
+
+  // Jobs being waited for, and any scheduled afterwards, are aborted, and
+  // their workers are asked to stop.
+  void CancelAwaitingJobs() override;
+
+  // Removes what is left of the job on the shared storage.
+  void OnInstallation(const std::string& scheduled_job_id,
+                      CompactionServiceJobStatus status) override;
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+// Runs the jobs of a RemoteCompactionService queue through
+// DB::OpenAndCompact(). Any number of workers, in any number of processes,
+// can serve the same queue.
+class RemoteCompactionWorker {
+ public:
+  // `options_override` supplies the objects of the DB that cannot be
+  // serialized, like its comparator, merge operator and table factory.
+  RemoteCompactionWorker(
+      const RemoteCompactionServiceOptions& options,
+      const CompactionServiceOptionsOverride& options_override);
+
+  // Claims one job of the queue and runs it. Returns NotFound if there was
+  // no job to claim, Aborted if the primary canceled the job, and otherwise
+  // the status of reporting the outcome of the job to the primary.
+  Status RunOnce();
+
+  // Runs jobs until `stop` is set, waiting for new ones when the queue is
+  // empty. A job being run when `stop` is set is reported as failed, for the
+  // primary to schedule it again.
+  void Run(const std::atomic<bool>* stop);
+
+ private:
+  Status RunNextJob(const std::atomic<bool>* stop);
+
+  const RemoteCompactionServiceOptions options_;
+  const CompactionServiceOptionsOverride options_override_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -28,6 +28,12 @@ struct ReplayOptions {
   //   If > 1, speed up the replay by this amount.
   double fast_forward;
 
+  // With more than one thread, replay the records of the same key in the same
+  // thread, in their order in the trace, rather than in any thread as soon as
+  // it is free. The key of a record of a write batch or of a MultiGet is its
+  // first key.
+  bool preserve_key_order = false;
+
   ReplayOptions() : num_threads(1), fast_forward(1.0) {}
 
   ReplayOptions(uint32_t num_of_threads, double fast_forward_ratio)
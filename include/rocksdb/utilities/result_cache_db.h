@@ -0,0 +1,95 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/advanced_cache.h"
+#include "rocksdb/utilities/stackable_db.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct ResultCacheOptions {
+  // Holds the results of the Gets, charged by the size of their key and
+  // value. Required.
+  std::shared_ptr<Cache> cache;
+};
+
+// EXPERIMENTAL
+// ResultCacheDB caches the final results of Gets, including that a key is
+// not found, so that a Get of a hot key is one cache lookup. Unlike
+// `row_cache`, which caches the result of each table file separately, an
+// entry is not tied to the files holding the key, so that it is kept through
+// flushes and compactions.
+//
+// Each write through ResultCacheDB removes the entries of its keys. A Get
+// only adds its result to the cache if no write to a key hashing like its
+// own got the DB past the sequence number that the Get started at, so that a
+// Get racing with a write never caches an outdated result. Writes of whole
+// ranges, like DeleteRange() and file ingestion, drop all of the entries.
+//
+// Only Gets of the latest data are cached, i.e. without a snapshot or a
+// timestamp. All of the writes must go through ResultCacheDB, and the DB must
+// not change values on its own, e.g. with a compaction filter or a TTL.
+class ResultCacheDB : public StackableDB {
+ public:
+  // Takes ownership of `db`, like StackableDB
+  ResultCacheDB(DB* db, const ResultCacheOptions& options);
+  ~ResultCacheDB() override;
+
+  using StackableDB::Get;
+  Status Get(const ReadOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, PinnableSlice* value,
+             std::string* timestamp) override;
+
+  using StackableDB::Put;
+  Status Put(const WriteOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, const Slice& val) override;
+
+  using StackableDB::PutEntity;
+  Status PutEntity(const WriteOptions& options,
+                   ColumnFamilyHandle* column_family, const Slice& key,
+                   const WideColumns& columns) override;
+  Status PutEntity(const WriteOptions& options, const Slice& key,
+                   const AttributeGroups& attribute_groups) override;
+
+  using StackableDB::Delete;
+  Status Delete(const WriteOptions& options, ColumnFamilyHandle* column_family,
+                const Slice& key) override;
+
+  using StackableDB::SingleDelete;
+  Status SingleDelete(const WriteOptions& options,
+                      ColumnFamilyHandle* column_family,
+                      const Slice& key) override;
+
+  using StackableDB::DeleteRange;
+  Status DeleteRange(const WriteOptions& options,
+                     ColumnFamilyHandle* column_family, const Slice& start_key,
+                     const Slice& end_key) override;
+
+  using StackableDB::Merge;
+  Status Merge(const WriteOptions& options, ColumnFamilyHandle* column_family,
+               const Slice& key, const Slice& value) override;
+
+  Status Write(const WriteOptions& options, WriteBatch* updates) override;
+
+  using StackableDB::IngestExternalFile;
+  Status IngestExternalFile(ColumnFamilyHandle* column_family,
+                            const std::vector<std::string>& external_files,
+                            const IngestExternalFileOptions& options) override;
+
+  using StackableDB::IngestExternalFiles;
+  Status IngestExternalFiles(
+      const std::vector<IngestExternalFileArg>& args) override;
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -83,6 +83,22 @@ class FaissIVFIndex : public SecondaryIndex {
       SecondaryIndexIterator* it, const Slice& target, size_t neighbors,
       size_t probes, std::vector<std::pair<std::string, float>>* result) const;
 
+  // Performs a K-nearest-neighbors search for each of the given targets, with
+  // the same parameters and preconditions as FindKNearestNeighbors. The
+  // results of targets[i] are returned in (*results)[i].
+  //
+  // Each inverted list probed by any of the targets is read through the
+  // iterator only once, and shared by the targets probing it. The distance
+  // computations of all the targets are then done by FAISS in one batch,
+  // which it can parallelize over the targets (e.g. with OpenMP). This makes
+  // the batch considerably cheaper than a FindKNearestNeighbors call per
+  // target, at the expense of holding the probed lists in memory during the
+  // search.
+  Status FindKNearestNeighborsBatch(
+      SecondaryIndexIterator* it, const std::vector<Slice>& targets,
+      size_t neighbors, size_t probes,
+      std::vector<std::vector<std::pair<std::string, float>>>* results) const;
+
  private:
   struct KNNContext;
   class Adapter;
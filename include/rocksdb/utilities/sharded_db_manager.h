@@ -0,0 +1,74 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct ShardedDBManagerOptions {
+  // Options of the DB that holds the shards. Its WAL, background threads,
+  // periodic tasks, info log and write buffer manager are shared by all the
+  // shards.
+  DBOptions db_options;
+
+  // Options of each shard. Shards share the table factory, and so the block
+  // cache, set here.
+  ColumnFamilyOptions shard_options;
+};
+
+// EXPERIMENTAL
+// ShardedDBManager runs many small logical DBs, such as one per tenant
+// shard, as the column families of one DB, so that they share what separate
+// DB instances would each have their own of: one group-committed WAL, and
+// so one fsync for the writes to many shards, one set of background flush
+// and compaction threads, one periodic task scheduler, one info log, and
+// one block cache. Memory of all the memtables can be bounded together with
+// DBOptions::db_write_buffer_size or a WriteBufferManager, which can also
+// charge it to the shared block cache.
+//
+// Reads and writes of a shard go to db() with the handle of the shard.
+// Shards persist across reopens of the manager.
+class ShardedDBManager {
+ public:
+  // Opens the DB at `path`, with a shard for each column family of the DB
+  // other than the default one.
+  static Status Open(const ShardedDBManagerOptions& options,
+                     const std::string& path,
+                     std::unique_ptr<ShardedDBManager>* manager);
+
+  // Closes the DB.
+  ~ShardedDBManager();
+
+  // Adds a shard, and sets *handle to its handle, which stays owned by the
+  // manager. Returns InvalidArgument if there is such a shard already.
+  Status CreateShard(const std::string& name, ColumnFamilyHandle** handle);
+
+  // Drops a shard and all its data. Its handle must no longer be used.
+  Status DropShard(const std::string& name);
+
+  // Returns the handle of the shard, or nullptr if there is no such shard.
+  ColumnFamilyHandle* GetShard(const std::string& name) const;
+
+  std::vector<std::string> GetShardNames() const;
+
+  DB* db() const;
+
+ private:
+  struct Rep;
+
+  explicit ShardedDBManager(std::unique_ptr<Rep>&& rep);
+
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
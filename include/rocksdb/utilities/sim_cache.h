@@ -7,8 +7,10 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/advanced_cache.h"
 #include "rocksdb/env.h"
@@ -89,4 +91,49 @@ class SimCache : public CacheWrapper {
   SimCache& operator=(const SimCache&);
 };
 
+class MissRatioCurveCache;
+
+struct MissRatioCurveOptions {
+  // Fraction of the keys whose lookups are simulated, chosen by the hash of
+  // the key. Must be in (0, 1].
+  double sampling_rate = 0.01;
+
+  // The capacities to estimate the hit ratio at, as multiples of the capacity
+  // of the cache. Each one is simulated by a key-only LRU cache with
+  // `sampling_rate` of that capacity, which only sees the sampled keys.
+  std::vector<double> capacity_ratios = {0.5, 1, 2, 4};
+};
+
+// EXPERIMENTAL
+// NewMissRatioCurveCache returns a wrapper of `cache` that estimates online
+// the hit ratio that `cache` would have at other capacities, using spatially
+// hashed sampling of the keys (SHARDS), so that it can be sized to the
+// workload. Used as BlockBasedTableOptions::block_cache, the estimates are
+// reported by the "rocksdb.block-cache-hit-ratio-curve" DB property.
+//
+// The memory overhead is at most about
+// sampling_rate * sum(capacity_ratios) * capacity * entry_size / block_size,
+// where the entry size is about 100 bytes. Returns nullptr if `options` are
+// invalid.
+std::shared_ptr<MissRatioCurveCache> NewMissRatioCurveCache(
+    std::shared_ptr<Cache> cache, const MissRatioCurveOptions& options);
+
+class MissRatioCurveCache : public CacheWrapper {
+ public:
+  using CacheWrapper::CacheWrapper;
+
+  static const char* kClassName() { return "MissRatioCurveCache"; }
+
+  // Returns the estimated hit ratio, in [0, 1], of each of the capacity
+  // ratios of the options, over the lookups since the cache was created or
+  // ResetCurve() was called last.
+  virtual void GetHitRatioCurve(std::map<double, double>* curve) const = 0;
+
+  // Returns the number of lookups that the estimates are based on
+  virtual uint64_t GetNumSampledLookups() const = 0;
+
+  // Resets the estimates, but not the state of the simulated caches
+  virtual void ResetCurve() = 0;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -213,6 +213,10 @@ class StackableDB : public DB {
     return db_->VerifyChecksum(options);
   }
 
+  Status VerifyChecksum(const ReadOptions& options, int max_threads) override {
+    return db_->VerifyChecksum(options, max_threads);
+  }
+
   using DB::KeyMayExist;
   bool KeyMayExist(const ReadOptions& options,
                    ColumnFamilyHandle* column_family, const Slice& key,
@@ -296,6 +300,14 @@ class StackableDB : public DB {
     return db_->NewMultiScan(opts, column_family, scan_opts);
   }
 
+  Status NewParallelScan(
+      const ReadOptions& opts, ColumnFamilyHandle* column_family,
+      size_t num_partitions,
+      std::vector<std::unique_ptr<Iterator>>* iterators) override {
+    return db_->NewParallelScan(opts, column_family, num_partitions,
+                                iterators);
+  }
+
   const Snapshot* GetSnapshot() override { return db_->GetSnapshot(); }
 
   void ReleaseSnapshot(const Snapshot* snapshot) override {
@@ -332,6 +344,14 @@ class StackableDB : public DB {
     return db_->GetApproximateSizes(options, column_family, r, n, sizes);
   }
 
+  Status GetApproximateRangeStats(const SizeApproximationOptions& options,
+                                  ColumnFamilyHandle* column_family,
+                                  const Range* r, int n, uint64_t* sizes,
+                                  uint64_t* counts) override {
+    return db_->GetApproximateRangeStats(options, column_family, r, n, sizes,
+                                         counts);
+  }
+
   using DB::GetApproximateMemTableStats;
   void GetApproximateMemTableStats(ColumnFamilyHandle* column_family,
                                    const Range& range, uint64_t* const count,
@@ -590,6 +610,11 @@ class StackableDB : public DB {
     return db_->PromoteL0(column_family, target_level);
   }
 
+  Status WarmupRange(ColumnFamilyHandle* column_family, const Slice* begin,
+                     const Slice* end, const WarmupOptions& options) override {
+    return db_->WarmupRange(column_family, begin, end, options);
+  }
+
   ColumnFamilyHandle* DefaultColumnFamily() const override {
     return db_->DefaultColumnFamily();
   }
@@ -0,0 +1,47 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "rocksdb/file_system.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct TieredFileSystemOptions {
+  // Directory holding the files of each temperature, usually on a device
+  // suited to it. A file created with a temperature of the map is placed in
+  // its directory, under the path that it has in the base FileSystem, e.g.
+  // "/cold/db/000012.sst" for "/db/000012.sst". The files of the other
+  // temperatures, including Temperature::kUnknown, are placed where they are
+  // created, and so are directories. The directories must exist.
+  std::map<Temperature, std::string> temperature_dirs;
+
+  // Whether to move a file to where its temperature belongs when it is opened
+  // for reading with a temperature other than the one it was created with,
+  // e.g. after `temperature_dirs` changed.
+  bool migrate_on_open = true;
+};
+
+// EXPERIMENTAL
+// Returns a FileSystem that places each file on a device by the temperature
+// that it is created with, such as hot files on NVMe and cold files on HDD,
+// without a FileSystem plugin. The DB keeps seeing all of its files in their
+// usual directories: a file keeps its place through renames and links, and
+// listing or syncing a directory covers the files of all temperatures.
+//
+// Files are moved between devices as they are rewritten by compactions that
+// change their temperature, or with `migrate_on_open`. A file must not be
+// deleted while it is being moved, which the DB does not do to the files it
+// opens.
+std::shared_ptr<FileSystem> NewTieredFileSystem(
+    const std::shared_ptr<FileSystem>& base,
+    const TieredFileSystemOptions& options);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -116,10 +116,18 @@ class WriteBatchWithIndex : public WriteBatchBase {
   //                show two entries with the same key.
   //                Note that for Merge, it's added as a new update instead
   //                of overwriting the existing one.
+  // lazy_index: if true, the writes are not indexed as they are added, but
+  //             when the index is first needed, e.g. by a lookup, an iterator
+  //             or SubBatchCnt(). Without overwrite_key, the entries written
+  //             since the index was last needed are sorted before being
+  //             merged into it. This makes batches with many writes and few
+  //             reads much cheaper to build. The iterators do not see the
+  //             writes made after they were created.
   explicit WriteBatchWithIndex(
       const Comparator* backup_index_comparator = BytewiseComparator(),
       size_t reserved_bytes = 0, bool overwrite_key = false,
-      size_t max_bytes = 0, size_t protection_bytes_per_key = 0);
+      size_t max_bytes = 0, size_t protection_bytes_per_key = 0,
+      bool lazy_index = false);
 
   ~WriteBatchWithIndex() override;
   WriteBatchWithIndex(WriteBatchWithIndex&&);
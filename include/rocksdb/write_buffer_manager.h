@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <list>
 #include <mutex>
+#include <unordered_map>
 
 #include "rocksdb/cache.h"
 
@@ -95,6 +96,23 @@ class WriteBufferManager final {
     MaybeEndWriteStall();
   }
 
+  // EXPERIMENTAL
+  // If set, the DB which finds ShouldFlush() true flushes the column family
+  // whose mutable memtable frees the most memory per expected cost, of the
+  // flush and of the L0 compactions after it, rather than the one with the
+  // oldest memtable. And while memory_usage() is below buffer_size(), it
+  // leaves the flush to the other DBs sharing this manager (on their next
+  // write) when one of them last reported a better memtable to flush, or when
+  // it holds less mutable memtable memory than them on average. This keeps a
+  // busy DB from causing tiny flushes in the idle ones.
+  void SetCostAwareFlush(bool new_cost_aware_flush) {
+    cost_aware_flush_.store(new_cost_aware_flush, std::memory_order_relaxed);
+  }
+
+  bool cost_aware_flush() const {
+    return cost_aware_flush_.load(std::memory_order_relaxed);
+  }
+
   // Below functions should be called by RocksDB internally.
 
   // Should only be called from write thread
@@ -159,6 +177,20 @@ class WriteBufferManager final {
 
   void RemoveDBFromQueue(StallInterface* wbm_stall);
 
+  // With cost_aware_flush(), called by the DB identified by `db` when
+  // ShouldFlush() returns true, with the memory of its mutable memtables and
+  // the score of its best memtable to flush (0 if none). Returns true if the
+  // DB should flush it now. If instead another DB reported a better one, that
+  // DB is passed over by the next calls until it calls this again, so that
+  // the memory is freed even if it has stopped writing.
+  // Should only be called by RocksDB internally.
+  bool PickFlushVictim(const void* db, size_t mutable_memory, double score);
+
+  // Called by each DB sharing the manager when it is opened and closed, for
+  // PickFlushVictim().
+  void AddFlushCandidate(const void* db);
+  void RemoveFlushCandidate(const void* db);
+
  private:
   std::atomic<size_t> buffer_size_;
   std::atomic<size_t> mutable_limit_;
@@ -177,6 +209,17 @@ class WriteBufferManager final {
   // while holding mu_, but it can be read without a lock.
   std::atomic<bool> stall_active_;
 
+  std::atomic<bool> cost_aware_flush_;
+  struct FlushCandidate {
+    double score = 0;
+    // Left to flush it on its next write
+    bool passed_over = false;
+  };
+  // The last flush candidate reported by each DB
+  std::unordered_map<const void*, FlushCandidate> flush_candidates_;
+  // Protects flush_candidates_
+  std::mutex flush_candidates_mu_;
+
   void ReserveMemWithCache(size_t mem);
   void FreeMemWithCache(size_t mem);
 };
@@ -16,6 +16,7 @@
 
 #include "include/org_rocksdb_RocksIterator.h"
 #include "rocksjni/portal.h"
+#include "util/coding.h"
 
 /*
  * Class:     org_rocksdb_RocksIterator
@@ -302,6 +303,56 @@ jint Java_org_rocksdb_RocksIterator_keyByteArray0(JNIEnv* env, jclass /*jcls*/,
   return static_cast<jsize>(key_slice.size());
 }
 
+/*
+ * Copies up to `jmax_entries` entries into the direct buffer `jtarget`
+ * with a single JNI call, starting from the current entry and advancing
+ * the iterator past each entry copied. Each entry is packed as the length
+ * of its key in a little-endian 32-bit integer, the key, the length of its
+ * value and the value.
+ *
+ * Stops early at the end of the iteration, or at the first entry that does
+ * not fit in the buffer, which is then still the current entry. Returns
+ * the number of entries copied.
+ *
+ * Class:     org_rocksdb_RocksIterator
+ * Method:    nextBatchDirect0
+ * Signature: (JLjava/nio/ByteBuffer;III)I
+ */
+jint Java_org_rocksdb_RocksIterator_nextBatchDirect0(
+    JNIEnv* env, jclass /*jcls*/, jlong handle, jobject jtarget,
+    jint jtarget_off, jint jtarget_len, jint jmax_entries) {
+  char* target = ROCKSDB_NAMESPACE::JniUtil::directBufferRange(
+      env, jtarget, jtarget_off, jtarget_len, "Invalid target argument");
+  if (target == nullptr) {
+    // exception thrown
+    return 0;
+  }
+
+  auto* it = reinterpret_cast<ROCKSDB_NAMESPACE::Iterator*>(handle);
+  size_t remaining = static_cast<size_t>(jtarget_len);
+  jint num_entries = 0;
+  for (; num_entries < jmax_entries && it->Valid(); it->Next()) {
+    const ROCKSDB_NAMESPACE::Slice key = it->key();
+    const ROCKSDB_NAMESPACE::Slice value = it->value();
+    const size_t entry_size = 2 * sizeof(uint32_t) + key.size() + value.size();
+    if (remaining < entry_size) {
+      break;
+    }
+    ROCKSDB_NAMESPACE::EncodeFixed32(target, static_cast<uint32_t>(key.size()));
+    target += sizeof(uint32_t);
+    memcpy(target, key.data(), key.size());
+    target += key.size();
+    ROCKSDB_NAMESPACE::EncodeFixed32(target,
+                                     static_cast<uint32_t>(value.size()));
+    target += sizeof(uint32_t);
+    memcpy(target, value.data(), value.size());
+    target += value.size();
+    remaining -= entry_size;
+    ++num_entries;
+  }
+  return num_entries;
+}
+
 /*
  * Class:     org_rocksdb_RocksIterator
  * Method:    value0
@@ -2498,6 +2498,23 @@ class JniUtil {
 
     return cvalue_len;
   }
+
+  /*
+   * Returns the address of [jbuf_off, jbuf_off + jbuf_len) in a direct
+   * ByteBuffer, or nullptr with a RocksDBException thrown if the buffer is
+   * not direct or the range is not within it.
+   */
+  static char* directBufferRange(JNIEnv* env, jobject jbuf, jint jbuf_off,
+                                 jint jbuf_len, const char* what) {
+    char* buf = reinterpret_cast<char*>(env->GetDirectBufferAddress(jbuf));
+    if (buf == nullptr || jbuf_off < 0 || jbuf_len < 0 ||
+        env->GetDirectBufferCapacity(jbuf) <
+            static_cast<jlong>(jbuf_off) + jbuf_len) {
+      ROCKSDB_NAMESPACE::RocksDBExceptionJni::ThrowNew(env, what);
+      return nullptr;
+    }
+    return buf + jbuf_off;
+  }
 };
 
 class MapJni : public JavaClass {
@@ -4761,6 +4778,8 @@ class CompactionPriorityJni {
         return 0x3;
       case ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin:
         return 0x4;
+      case ROCKSDB_NAMESPACE::CompactionPri::kHotnessAware:
+        return 0x5;
       default:
         return 0x0;  // undefined
     }
@@ -4781,6 +4800,8 @@ class CompactionPriorityJni {
         return ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio;
       case 0x4:
         return ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin;
+      case 0x5:
+        return ROCKSDB_NAMESPACE::CompactionPri::kHotnessAware;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionPri::kByCompensatedSize;
@@ -29,6 +29,7 @@
 #include "rocksjni/jni_multiget_helpers.h"
 #include "rocksjni/kv_helper.h"
 #include "rocksjni/portal.h"
+#include "util/coding.h"
 
 #ifdef min
 #undef min
@@ -1817,6 +1818,97 @@ void Java_org_rocksdb_RocksDB_multiGet__JJ_3J_3Ljava_nio_ByteBuffer_2_3I_3I_3Lja
       env, values, statuses, jvalues, jvalues_sizes, jstatus_objects);
 }
 
+/*
+ * @brief Bulk variant of MultiGet() crossing JNI once for the whole batch
+ *
+ * The keys are packed in the direct buffer `jkeys`, each one as its length
+ * in a little-endian 32-bit integer followed by its bytes. The results are
+ * packed in the direct buffer `jresults` in order of the keys, each one as
+ * the code of its status and the length of its value in little-endian
+ * 32-bit integers followed by the bytes of the value, which is empty
+ * unless the status is OK.
+ *
+ * Only the results of the keys up to the first one whose result does not
+ * fit in `jresults` are written, and their number is returned, so that the
+ * remaining keys can be looked up with another call.
+ *
+ * Class:     org_rocksdb_RocksDB
+ * Method:    multiGetPacked
+ * Signature: (JJJLjava/nio/ByteBuffer;IIILjava/nio/ByteBuffer;II)I
+ */
+jint Java_org_rocksdb_RocksDB_multiGetPacked(
+    JNIEnv* env, jclass, jlong jdb_handle, jlong jropt_handle,
+    jlong jcf_handle, jobject jkeys, jint jkeys_off, jint jkeys_len,
+    jint jnum_keys, jobject jresults, jint jresults_off, jint jresults_len) {
+  const char* keys_buf = ROCKSDB_NAMESPACE::JniUtil::directBufferRange(
+      env, jkeys, jkeys_off, jkeys_len, "Invalid keys argument");
+  if (keys_buf == nullptr) {
+    // exception thrown
+    return 0;
+  }
+  char* results_buf = ROCKSDB_NAMESPACE::JniUtil::directBufferRange(
+      env, jresults, jresults_off, jresults_len, "Invalid results argument");
+  if (results_buf == nullptr) {
+    // exception thrown
+    return 0;
+  }
+  if (jnum_keys < 0) {
+    ROCKSDB_NAMESPACE::RocksDBExceptionJni::ThrowNew(
+        env, "Invalid number of keys");
+    return 0;
+  }
+
+  std::vector<ROCKSDB_NAMESPACE::Slice> keys;
+  keys.reserve(jnum_keys);
+  ROCKSDB_NAMESPACE::Slice input(keys_buf, jkeys_len);
+  for (jint i = 0; i < jnum_keys; ++i) {
+    uint32_t key_len = 0;
+    if (!ROCKSDB_NAMESPACE::GetFixed32(&input, &key_len) ||
+        input.size() < key_len) {
+      ROCKSDB_NAMESPACE::RocksDBExceptionJni::ThrowNew(
+          env, "Invalid packed keys");
+      return 0;
+    }
+    keys.emplace_back(input.data(), key_len);
+    input.remove_prefix(key_len);
+  }
+
+  auto* db = reinterpret_cast<ROCKSDB_NAMESPACE::DB*>(jdb_handle);
+  auto* cf_handle =
+      jcf_handle == 0
+          ? db->DefaultColumnFamily()
+          : reinterpret_cast<ROCKSDB_NAMESPACE::ColumnFamilyHandle*>(
+                jcf_handle);
+  const ROCKSDB_NAMESPACE::ReadOptions ro =
+      jropt_handle == 0
+          ? ROCKSDB_NAMESPACE::ReadOptions()
+          : *reinterpret_cast<ROCKSDB_NAMESPACE::ReadOptions*>(jropt_handle);
+  std::vector<ROCKSDB_NAMESPACE::PinnableSlice> values(keys.size());
+  std::vector<ROCKSDB_NAMESPACE::Status> statuses(keys.size());
+  db->MultiGet(ro, cf_handle, keys.size(), keys.data(), values.data(),
+               statuses.data(), false /* sorted_input */);
+
+  size_t remaining = static_cast<size_t>(jresults_len);
+  jint num_results = 0;
+  for (; num_results < jnum_keys; ++num_results) {
+    const ROCKSDB_NAMESPACE::Status& s = statuses[num_results];
+    const ROCKSDB_NAMESPACE::Slice value =
+        s.ok() ? values[num_results] : ROCKSDB_NAMESPACE::Slice();
+    if (remaining < 2 * sizeof(uint32_t) + value.size()) {
+      break;
+    }
+    ROCKSDB_NAMESPACE::EncodeFixed32(results_buf,
+                                     static_cast<uint32_t>(s.code()));
+    ROCKSDB_NAMESPACE::EncodeFixed32(results_buf + sizeof(uint32_t),
+                                     static_cast<uint32_t>(value.size()));
+    results_buf += 2 * sizeof(uint32_t);
+    memcpy(results_buf, value.data(), value.size());
+    results_buf += value.size();
+    remaining -= 2 * sizeof(uint32_t) + value.size();
+  }
+  return num_results;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // ROCKSDB_NAMESPACE::DB::KeyMayExist
 bool key_may_exist_helper(JNIEnv* env, jlong jdb_handle, jlong jcf_handle,
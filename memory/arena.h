@@ -17,6 +17,7 @@
 #include <deque>
 
 #include "memory/allocator.h"
+#include "memory/memory_allocator_impl.h"
 #include "port/mmap.h"
 #include "rocksdb/env.h"
 
@@ -39,8 +40,12 @@ class Arena : public Allocator {
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
   // page TLB first. If allocation fails, will fall back to normal case.
+  // block_allocator: if not nullptr, the blocks, other than the huge page
+  // ones, are allocated from it instead of operator new. Not owned, and
+  // must outlive the arena.
   explicit Arena(size_t block_size = kMinBlockSize,
-                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0);
+                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0,
+                 MemoryAllocator* block_allocator = nullptr);
   ~Arena();
 
   char* Allocate(size_t bytes) override;
@@ -92,7 +97,8 @@ class Arena : public Allocator {
   // Number of bytes allocated in one block
   const size_t kBlockSize;
   // Allocated memory blocks
-  std::deque<std::unique_ptr<char[]>> blocks_;
+  std::deque<CacheAllocationPtr> blocks_;
+  MemoryAllocator* const block_allocator_;
   // Huge page allocations
   std::deque<MemMapping> huge_blocks_;
   size_t irregular_block_num = 0;
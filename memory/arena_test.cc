@@ -12,10 +12,12 @@
 #ifndef OS_WIN
 #include <sys/resource.h>
 #endif
+#include "memory/concurrent_arena.h"
 #include "port/jemalloc_helper.h"
 #include "port/port.h"
 #include "test_util/testharness.h"
 #include "util/random.h"
+#include "utilities/memory_allocators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -203,6 +205,60 @@ TEST_F(ArenaTest, Simple) {
   SimpleTest(kHugePageSize);
 }
 
+TEST_F(ArenaTest, BlockAllocator) {
+  CountedMemoryAllocator allocator;
+  {
+    Arena arena(Arena::kMinBlockSize, nullptr, 0, &allocator);
+    // From the inline block
+    ASSERT_NE(arena.Allocate(100), nullptr);
+    ASSERT_EQ(allocator.GetNumAllocations(), 0U);
+    for (int i = 0; i < 10; i++) {
+      char* p = arena.AllocateAligned(Arena::kMinBlockSize / 2);
+      memset(p, i, Arena::kMinBlockSize / 2);
+    }
+    ASSERT_EQ(allocator.GetNumAllocations(), 10U);
+    ASSERT_GE(arena.MemoryAllocatedBytes(),
+              Arena::kInlineSize + 10 * Arena::kMinBlockSize / 2);
+  }
+  ASSERT_EQ(allocator.GetNumDeallocations(), 10U);
+}
+
+TEST_F(ArenaTest, ConcurrentArenaTier) {
+  CountedMemoryAllocator allocator;
+  {
+    ConcurrentArena arena(64 << 10);
+    // Before the tier is enabled
+    char* p = arena.AllocateAligned(8 << 10);
+    memset(p, 1, 8 << 10);
+    arena.EnableTier(&allocator, 1024);
+    const size_t allocated_bytes = arena.MemoryAllocatedBytes();
+
+    // The small allocations stay on the main arena
+    for (int i = 0; i < 100; i++) {
+      p = arena.AllocateAligned(100);
+      memset(p, 2, 100);
+      p = arena.Allocate(1023);
+      memset(p, 3, 1023);
+    }
+    ASSERT_EQ(allocator.GetNumAllocations(), 0U);
+
+    // Huge page ones too
+    p = arena.AllocateAligned(8 << 10, 2 << 20);
+    ASSERT_EQ(allocator.GetNumAllocations(), 0U);
+
+    for (int i = 0; i < 100; i++) {
+      p = arena.AllocateAligned(1024);
+      memset(p, 4, 1024);
+      p = arena.Allocate(4000);
+      memset(p, 5, 4000);
+    }
+    ASSERT_GT(allocator.GetNumAllocations(), 0U);
+    ASSERT_GT(arena.MemoryAllocatedBytes(), allocated_bytes + 100 * 5024);
+    ASSERT_GE(arena.ApproximateMemoryUsage(), 100 * 5024U);
+  }
+  ASSERT_EQ(allocator.GetNumDeallocations(), allocator.GetNumAllocations());
+}
+
 // Number of minor page faults since last call
 size_t PopMinorPageFaultCount() {
 #ifdef RUSAGE_SELF
@@ -30,7 +30,17 @@ ConcurrentArena::ConcurrentArena(size_t block_size, AllocTracker* tracker,
                                  size_t huge_page_size)
     : shard_block_size_(std::min(kMaxShardBlockSize, block_size / 8)),
       shards_(),
-      arena_(block_size, tracker, huge_page_size) {
+      arena_(block_size, tracker, huge_page_size),
+      tracker_(tracker) {
+  Fixup();
+}
+
+void ConcurrentArena::EnableTier(MemoryAllocator* tier_allocator,
+                                 size_t tier_min_bytes) {
+  assert(tier_allocator != nullptr && tier_arena_ == nullptr);
+  tier_arena_.reset(new Arena(arena_.BlockSize(), tracker_,
+                              0 /* huge_page_size */, tier_allocator));
+  tier_min_bytes_ = tier_min_bytes;
   Fixup();
 }
 
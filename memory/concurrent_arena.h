@@ -49,7 +49,17 @@ class ConcurrentArena : public Allocator {
                            AllocTracker* tracker = nullptr,
                            size_t huge_page_size = 0);
 
+  // From then on, allocations of at least tier_min_bytes, other than the
+  // huge page ones, come from an arena of blocks allocated by
+  // tier_allocator, e.g. on a slower memory tier, so that the other ones
+  // keep to the main arena. tier_allocator is not owned and must outlive
+  // the arena. Not thread-safe, to be called before the arena is shared.
+  void EnableTier(MemoryAllocator* tier_allocator, size_t tier_min_bytes);
+
   char* Allocate(size_t bytes) override {
+    if (UNLIKELY(IsForTier(bytes))) {
+      return AllocateFromTier(bytes, false /* aligned */);
+    }
     return AllocateImpl(bytes, false /*force_arena*/,
                         [this, bytes]() { return arena_.Allocate(bytes); });
   }
@@ -60,6 +70,9 @@ class ConcurrentArena : public Allocator {
     assert(rounded_up >= bytes && rounded_up < bytes + sizeof(void*) &&
            (rounded_up % sizeof(void*)) == 0);
 
+    if (UNLIKELY(huge_page_size == 0 && IsForTier(rounded_up))) {
+      return AllocateFromTier(rounded_up, true /* aligned */);
+    }
     return AllocateImpl(rounded_up, huge_page_size != 0 /*force_arena*/,
                         [this, rounded_up, huge_page_size, logger]() {
                           return arena_.AllocateAligned(rounded_up,
@@ -70,7 +83,8 @@ class ConcurrentArena : public Allocator {
   size_t ApproximateMemoryUsage() const {
     std::unique_lock<SpinMutex> lock(arena_mutex_, std::defer_lock);
     lock.lock();
-    return arena_.ApproximateMemoryUsage() - ShardAllocatedAndUnused();
+    return arena_.ApproximateMemoryUsage() - ShardAllocatedAndUnused() +
+           (tier_arena_ ? tier_arena_->ApproximateMemoryUsage() : 0);
   }
 
   size_t MemoryAllocatedBytes() const {
@@ -79,6 +93,7 @@ class ConcurrentArena : public Allocator {
 
   size_t AllocatedAndUnused() const {
     return arena_allocated_and_unused_.load(std::memory_order_relaxed) +
+           tier_allocated_and_unused_.load(std::memory_order_relaxed) +
            ShardAllocatedAndUnused();
   }
 
@@ -107,15 +122,32 @@ class ConcurrentArena : public Allocator {
   CoreLocalArray<Shard> shards_;
 
   Arena arena_;
+  AllocTracker* const tracker_;
   mutable SpinMutex arena_mutex_;
   std::atomic<size_t> arena_allocated_and_unused_;
   std::atomic<size_t> memory_allocated_bytes_;
   std::atomic<size_t> irregular_block_num_;
+  // Set by EnableTier(), and guarded by arena_mutex_ as arena_ is
+  std::unique_ptr<Arena> tier_arena_;
+  size_t tier_min_bytes_ = 0;
+  std::atomic<size_t> tier_allocated_and_unused_{0};
 
   char padding1[56] ROCKSDB_FIELD_UNUSED;
 
   Shard* Repick();
 
+  bool IsForTier(size_t bytes) const {
+    return tier_arena_ != nullptr && bytes >= tier_min_bytes_;
+  }
+
+  char* AllocateFromTier(size_t bytes, bool aligned) {
+    std::lock_guard<SpinMutex> lock(arena_mutex_);
+    char* rv = aligned ? tier_arena_->AllocateAligned(bytes)
+                       : tier_arena_->Allocate(bytes);
+    Fixup();
+    return rv;
+  }
+
   size_t ShardAllocatedAndUnused() const {
     size_t total = 0;
     for (size_t i = 0; i < shards_.Size(); ++i) {
@@ -202,10 +234,17 @@ class ConcurrentArena : public Allocator {
   void Fixup() {
     arena_allocated_and_unused_.store(arena_.AllocatedAndUnused(),
                                       std::memory_order_relaxed);
-    memory_allocated_bytes_.store(arena_.MemoryAllocatedBytes(),
+    size_t memory_allocated_bytes = arena_.MemoryAllocatedBytes();
+    size_t irregular_block_num = arena_.IrregularBlockNum();
+    if (tier_arena_ != nullptr) {
+      tier_allocated_and_unused_.store(tier_arena_->AllocatedAndUnused(),
+                                       std::memory_order_relaxed);
+      memory_allocated_bytes += tier_arena_->MemoryAllocatedBytes();
+      irregular_block_num += tier_arena_->IrregularBlockNum();
+    }
+    memory_allocated_bytes_.store(memory_allocated_bytes,
                                   std::memory_order_relaxed);
-    irregular_block_num_.store(arena_.IrregularBlockNum(),
-                               std::memory_order_relaxed);
+    irregular_block_num_.store(irregular_block_num, std::memory_order_relaxed);
   }
 
   ConcurrentArena(const ConcurrentArena&) = delete;
@@ -0,0 +1,107 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/huge_page_allocator.h"
+
+#include <unordered_map>
+
+#include "rocksdb/convenience.h"
+#include "rocksdb/utilities/options_type.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+static std::unordered_map<std::string, OptionTypeInfo> huge_page_type_info = {
+    {"capacity",
+     {offsetof(struct HugePageAllocatorOptions, capacity), OptionType::kSizeT,
+      OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+    {"slab_size",
+     {offsetof(struct HugePageAllocatorOptions, slab_size), OptionType::kSizeT,
+      OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+    {"huge_page_size",
+     {offsetof(struct HugePageAllocatorOptions, huge_page_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal,
+      OptionTypeFlags::kNone}},
+    {"max_allocation_size",
+     {offsetof(struct HugePageAllocatorOptions, max_allocation_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal,
+      OptionTypeFlags::kNone}},
+};
+
+bool HugePageMemoryAllocator::IsSupported(std::string* why) {
+#ifdef ROCKSDB_HUGE_PAGE_ALLOCATOR
+  (void)why;
+  return true;
+#else
+  *why = "HugePageMemoryAllocator is only available with MAP_HUGETLB";
+  return false;
+#endif  // ROCKSDB_HUGE_PAGE_ALLOCATOR
+}
+
+HugePageMemoryAllocator::HugePageMemoryAllocator(
+    const HugePageAllocatorOptions& options)
+    : options_(options) {
+  RegisterOptions(&options_, &huge_page_type_info);
+}
+
+HugePageMemoryAllocator::~HugePageMemoryAllocator() = default;
+
+Status HugePageMemoryAllocator::PrepareOptions(
+    const ConfigOptions& config_options) {
+  std::string message;
+  if (!IsSupported(&message)) {
+    return Status::NotSupported(message);
+  } else if (IsMutable()) {
+    Status s = MemoryAllocator::PrepareOptions(config_options);
+#ifdef ROCKSDB_HUGE_PAGE_ALLOCATOR
+    if (s.ok()) {
+      s = SlabAllocator::Create(options_.capacity, options_.slab_size,
+                                options_.max_allocation_size,
+                                true /* huge_pages */, options_.huge_page_size,
+                                &slabs_);
+    }
+#endif  // ROCKSDB_HUGE_PAGE_ALLOCATOR
+    return s;
+  } else {
+    // Already prepared
+    return Status::OK();
+  }
+}
+
+#ifdef ROCKSDB_HUGE_PAGE_ALLOCATOR
+void* HugePageMemoryAllocator::Allocate(size_t size) {
+  void* p = slabs_->Allocate(size);
+  return p != nullptr ? p : new char[size];
+}
+
+void HugePageMemoryAllocator::Deallocate(void* p) {
+  if (slabs_->Owns(p)) {
+    slabs_->Deallocate(p);
+  } else {
+    delete[] static_cast<char*>(p);
+  }
+}
+
+size_t HugePageMemoryAllocator::UsableSize(void* p,
+                                           size_t allocation_size) const {
+  return slabs_->Owns(p) ? slabs_->UsableSize(p) : allocation_size;
+}
+#endif  // ROCKSDB_HUGE_PAGE_ALLOCATOR
+
+Status NewHugePageMemoryAllocator(
+    const HugePageAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator) {
+  if (memory_allocator == nullptr) {
+    return Status::InvalidArgument("memory_allocator must be non-null.");
+  }
+  std::unique_ptr<MemoryAllocator> allocator(
+      new HugePageMemoryAllocator(options));
+  Status s = allocator->PrepareOptions(ConfigOptions());
+  if (s.ok()) {
+    memory_allocator->reset(allocator.release());
+  }
+  return s;
+}
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,60 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "memory/slab_allocator.h"
+#include "rocksdb/memory_allocator.h"
+#include "utilities/memory_allocators.h"
+
+#if defined(ROCKSDB_SLAB_ALLOCATOR) && defined(MAP_HUGETLB)
+#define ROCKSDB_HUGE_PAGE_ALLOCATOR
+#endif  // ROCKSDB_SLAB_ALLOCATOR && MAP_HUGETLB
+
+namespace ROCKSDB_NAMESPACE {
+
+// Allocations of up to `max_allocation_size` are carved out of slabs mapped
+// with huge pages, and the larger ones come from operator new.
+class HugePageMemoryAllocator : public BaseMemoryAllocator {
+ public:
+  explicit HugePageMemoryAllocator(const HugePageAllocatorOptions& options);
+  ~HugePageMemoryAllocator() override;
+
+  static const char* kClassName() { return "HugePageMemoryAllocator"; }
+  const char* Name() const override { return kClassName(); }
+  static bool IsSupported() {
+    std::string unused;
+    return IsSupported(&unused);
+  }
+  static bool IsSupported(std::string* why);
+  bool IsMutable() const { return slabs_ == nullptr; }
+
+  Status PrepareOptions(const ConfigOptions& config_options) override;
+
+#ifdef ROCKSDB_HUGE_PAGE_ALLOCATOR
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+
+  // Number of slabs mapped with huge pages
+  size_t GetNumHugePageSlabs() const { return slabs_->GetNumHugePageSlabs(); }
+  // Number of slabs mapped with normal pages, which transparent huge pages
+  // may back, as not enough huge pages were reserved
+  size_t GetNumNormalPageSlabs() const {
+    return slabs_->GetNumNormalPageSlabs();
+  }
+#endif  // ROCKSDB_HUGE_PAGE_ALLOCATOR
+
+  const SlabAllocator* GetSlabAllocator() const { return slabs_.get(); }
+
+ private:
+  HugePageAllocatorOptions options_;
+  std::unique_ptr<SlabAllocator> slabs_;
+};
+}  // namespace ROCKSDB_NAMESPACE
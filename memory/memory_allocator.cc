@@ -5,8 +5,10 @@
 
 #include "rocksdb/memory_allocator.h"
 
+#include "memory/huge_page_allocator.h"
 #include "memory/jemalloc_nodump_allocator.h"
 #include "memory/memkind_kmem_allocator.h"
+#include "memory/slab_allocator.h"
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
@@ -36,6 +38,16 @@ static int RegisterBuiltinAllocators(ObjectLibrary& library,
             std::make_shared<DefaultMemoryAllocator>()));
         return guard->get();
       });
+  library.AddFactory<MemoryAllocator>(
+      HugePageMemoryAllocator::kClassName(),
+      [](const std::string& /*uri*/, std::unique_ptr<MemoryAllocator>* guard,
+         std::string* errmsg) {
+        if (HugePageMemoryAllocator::IsSupported(errmsg)) {
+          HugePageAllocatorOptions options;
+          guard->reset(new HugePageMemoryAllocator(options));
+        }
+        return guard->get();
+      });
   library.AddFactory<MemoryAllocator>(
       JemallocNodumpAllocator::kClassName(),
       [](const std::string& /*uri*/, std::unique_ptr<MemoryAllocator>* guard,
@@ -55,6 +67,16 @@ static int RegisterBuiltinAllocators(ObjectLibrary& library,
         }
         return guard->get();
       });
+  library.AddFactory<MemoryAllocator>(
+      SlabMemoryAllocator::kClassName(),
+      [](const std::string& /*uri*/, std::unique_ptr<MemoryAllocator>* guard,
+         std::string* errmsg) {
+        if (SlabMemoryAllocator::IsSupported(errmsg)) {
+          SlabAllocatorOptions options;
+          guard->reset(new SlabMemoryAllocator(options));
+        }
+        return guard->get();
+      });
   size_t num_types;
   return static_cast<int>(library.GetFactoryCount(&num_types));
 }
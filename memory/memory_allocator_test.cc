@@ -5,9 +5,12 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #include <cstdio>
+#include <cstring>
 
+#include "memory/huge_page_allocator.h"
 #include "memory/jemalloc_nodump_allocator.h"
 #include "memory/memkind_kmem_allocator.h"
+#include "memory/slab_allocator.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
@@ -112,6 +115,12 @@ TEST_P(MemoryAllocatorTest, DatabaseBlockCache) {
   }
   ASSERT_GT(cache->GetUsage(), 2000);
 
+  // Only with slabs to tell the unused part of
+  uint64_t fragmentation = 0;
+  ASSERT_EQ(db->GetIntProperty(DB::Properties::kBlockCacheFragmentation,
+                               &fragmentation),
+            GetSlabAllocator(allocator_.get()) != nullptr);
+
   // Close database
   s = db->Close();
   ASSERT_OK(s);
@@ -209,9 +218,181 @@ TEST_F(CreateMemoryAllocatorTest, NewJemallocNodumpAllocator) {
   ASSERT_EQ(opts->limit_tcache_size, jopts.limit_tcache_size);
 }
 
+TEST_F(CreateMemoryAllocatorTest, NewHugePageMemoryAllocator) {
+  HugePageAllocatorOptions options;
+  std::shared_ptr<MemoryAllocator> allocator;
+  ASSERT_NOK(NewHugePageMemoryAllocator(options, nullptr));
+  Status s = NewHugePageMemoryAllocator(options, &allocator);
+  if (!HugePageMemoryAllocator::IsSupported()) {
+    ASSERT_NOK(s);
+    ROCKSDB_GTEST_BYPASS("HugePageMemoryAllocator not supported");
+    return;
+  }
+  ASSERT_OK(s);
+
+  // Invalid options
+  options.slab_size = 3 << 20;
+  ASSERT_NOK(NewHugePageMemoryAllocator(options, &allocator));
+  options.slab_size = 2 << 20;
+  options.huge_page_size = 1 << 30;
+  ASSERT_NOK(NewHugePageMemoryAllocator(options, &allocator));
+  options.huge_page_size = 0;
+  options.max_allocation_size = 4 << 20;
+  ASSERT_NOK(NewHugePageMemoryAllocator(options, &allocator));
+
+  ASSERT_OK(MemoryAllocator::CreateFromString(
+      config_options_,
+      std::string("id=") + HugePageMemoryAllocator::kClassName() +
+          "; capacity=1048576; slab_size=65536; max_allocation_size=1024",
+      &allocator));
+  auto opts = allocator->GetOptions<HugePageAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->capacity, 1048576U);
+  ASSERT_EQ(opts->slab_size, 65536U);
+  ASSERT_EQ(opts->max_allocation_size, 1024U);
+}
+
+TEST_F(CreateMemoryAllocatorTest, HugePageAllocations) {
+  if (!HugePageMemoryAllocator::IsSupported()) {
+    ROCKSDB_GTEST_BYPASS("HugePageMemoryAllocator not supported");
+    return;
+  }
+  HugePageAllocatorOptions options;
+  options.capacity = 256 << 10;
+  options.slab_size = 64 << 10;
+  options.max_allocation_size = 16 << 10;
+  HugePageMemoryAllocator allocator(options);
+  ASSERT_OK(allocator.PrepareOptions(config_options_));
+
+  std::vector<std::pair<char*, size_t>> allocations;
+  for (size_t size = 1; size <= options.max_allocation_size; size += 777) {
+    char* p = static_cast<char*>(allocator.Allocate(size));
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0U);
+    const size_t usable = allocator.UsableSize(p, size);
+    ASSERT_GE(usable, size);
+    ASSERT_LE(usable, std::max(size_t{64}, size + size / 4));
+    std::memset(p, static_cast<int>(size), usable);
+    allocations.emplace_back(p, size);
+  }
+  for (const auto& allocation : allocations) {
+    ASSERT_EQ(allocation.first[0], static_cast<char>(allocation.second));
+    allocator.Deallocate(allocation.first);
+  }
+  allocations.clear();
+
+  // Beyond the capacity, and above max_allocation_size
+  for (int i = 0; i < 64; i++) {
+    const size_t size = options.max_allocation_size;
+    allocations.emplace_back(static_cast<char*>(allocator.Allocate(size)),
+                             size);
+    std::memset(allocations.back().first, 1, size);
+  }
+  ASSERT_EQ(allocator.GetNumHugePageSlabs() + allocator.GetNumNormalPageSlabs(),
+            options.capacity / options.slab_size);
+  const size_t large_size = options.max_allocation_size + 1;
+  allocations.emplace_back(static_cast<char*>(allocator.Allocate(large_size)),
+                           large_size);
+  ASSERT_EQ(allocator.UsableSize(allocations.back().first, large_size),
+            large_size);
+  for (const auto& allocation : allocations) {
+    allocator.Deallocate(allocation.first);
+  }
+}
+
+TEST_F(CreateMemoryAllocatorTest, NewSlabMemoryAllocator) {
+  SlabAllocatorOptions options;
+  std::shared_ptr<MemoryAllocator> allocator;
+  ASSERT_NOK(NewSlabMemoryAllocator(options, nullptr));
+  Status s = NewSlabMemoryAllocator(options, &allocator);
+  if (!SlabMemoryAllocator::IsSupported()) {
+    ASSERT_NOK(s);
+    ROCKSDB_GTEST_BYPASS("SlabMemoryAllocator not supported");
+    return;
+  }
+  ASSERT_OK(s);
+
+  // Invalid options
+  options.slab_size = 32 << 10;
+  ASSERT_NOK(NewSlabMemoryAllocator(options, &allocator));
+  options.slab_size = 2 << 20;
+  options.max_allocation_size = 4 << 20;
+  ASSERT_NOK(NewSlabMemoryAllocator(options, &allocator));
+
+  ASSERT_OK(MemoryAllocator::CreateFromString(
+      config_options_,
+      std::string("id=") + SlabMemoryAllocator::kClassName() +
+          "; capacity=1048576; slab_size=65536; max_allocation_size=1024",
+      &allocator));
+  auto opts = allocator->GetOptions<SlabAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->capacity, 1048576U);
+  ASSERT_EQ(opts->slab_size, 65536U);
+  ASSERT_EQ(opts->max_allocation_size, 1024U);
+  ASSERT_NE(GetSlabAllocator(allocator.get()), nullptr);
+}
+
+TEST_F(CreateMemoryAllocatorTest, SlabAllocationsAreRecycled) {
+  if (!SlabMemoryAllocator::IsSupported()) {
+    ROCKSDB_GTEST_BYPASS("SlabMemoryAllocator not supported");
+    return;
+  }
+  SlabAllocatorOptions options;
+  options.capacity = 16 << 20;
+  options.slab_size = 64 << 10;
+  SlabMemoryAllocator allocator(options);
+  ASSERT_OK(allocator.PrepareOptions(config_options_));
+  const SlabAllocator* slabs = allocator.GetSlabAllocator();
+  ASSERT_NE(slabs, nullptr);
+  ASSERT_EQ(slabs->GetMappedBytes(), 0U);
+
+  // Blocks of varied sizes, from 4KB to 64KB
+  std::vector<char*> allocations;
+  size_t usable_total = 0;
+  for (size_t size = 4 << 10; size <= options.max_allocation_size;
+       size += 4 << 10) {
+    char* p = static_cast<char*>(allocator.Allocate(size));
+    const size_t usable = allocator.UsableSize(p, size);
+    ASSERT_GE(usable, size);
+    ASSERT_LE(usable, size + size / 4);
+    std::memset(p, 1, usable);
+    usable_total += usable;
+    allocations.push_back(p);
+  }
+  ASSERT_EQ(slabs->GetAllocatedBytes(), usable_total);
+  const size_t mapped = slabs->GetMappedBytes();
+  ASSERT_GE(mapped, usable_total);
+
+  // Churning through the same sizes reuses the freed allocations, short of
+  // the thread moving to another core in between
+  for (int round = 0; round < 10; round++) {
+    for (char*& p : allocations) {
+      const size_t usable = allocator.UsableSize(p, 0);
+      allocator.Deallocate(p);
+      p = static_cast<char*>(allocator.Allocate(usable));
+      ASSERT_EQ(allocator.UsableSize(p, usable), usable);
+    }
+  }
+  ASSERT_LT(slabs->GetMappedBytes(), 2 * mapped);
+  ASSERT_EQ(slabs->GetAllocatedBytes(), usable_total);
+
+  for (char* p : allocations) {
+    allocator.Deallocate(p);
+  }
+  ASSERT_EQ(slabs->GetAllocatedBytes(), 0U);
+}
+
 INSTANTIATE_TEST_CASE_P(DefaultMemoryAllocator, MemoryAllocatorTest,
                         ::testing::Values(std::make_tuple(
                             DefaultMemoryAllocator::kClassName(), true)));
+INSTANTIATE_TEST_CASE_P(
+    HugePageMemoryAllocator, MemoryAllocatorTest,
+    ::testing::Values(std::make_tuple(HugePageMemoryAllocator::kClassName(),
+                                      HugePageMemoryAllocator::IsSupported())));
+INSTANTIATE_TEST_CASE_P(
+    SlabMemoryAllocator, MemoryAllocatorTest,
+    ::testing::Values(std::make_tuple(SlabMemoryAllocator::kClassName(),
+                                      SlabMemoryAllocator::IsSupported())));
 #ifdef MEMKIND
 INSTANTIATE_TEST_CASE_P(
     MemkindkMemAllocator, MemoryAllocatorTest,
@@ -0,0 +1,161 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "port/mmap.h"
+#include "port/port.h"
+#include "rocksdb/memory_allocator.h"
+#include "rocksdb/status.h"
+#include "util/core_local.h"
+#include "util/mutexlock.h"
+#include "utilities/memory_allocators.h"
+
+#ifdef ROCKSDB_PLATFORM_POSIX
+#define ROCKSDB_SLAB_ALLOCATOR
+#endif  // ROCKSDB_PLATFORM_POSIX
+
+namespace ROCKSDB_NAMESPACE {
+
+#ifdef ROCKSDB_SLAB_ALLOCATOR
+// Carves allocations of up to `max_allocation_size` out of slabs of
+// `slab_size` bytes, mapped one at a time into an address range reserved
+// for `capacity` bytes. Each size class has its own runs of pages, so that
+// the page of an allocation tells its size, and its own free list in each
+// of the core-local shards. Thread-safe.
+class SlabAllocator {
+ public:
+  // With `huge_pages`, the slabs are mapped with huge pages of
+  // `huge_page_size`, or of the default size of the system for 0, falling
+  // back to normal pages advised to be backed by transparent huge pages.
+  static Status Create(size_t capacity, size_t slab_size,
+                       size_t max_allocation_size, bool huge_pages,
+                       size_t huge_page_size,
+                       std::unique_ptr<SlabAllocator>* result);
+
+  ~SlabAllocator();
+
+  // Returns nullptr when `size` is above max_allocation_size, or once the
+  // capacity is used up
+  void* Allocate(size_t size);
+  // `p` must be owned
+  void Deallocate(void* p);
+  size_t UsableSize(const void* p) const;
+
+  bool Owns(const void* p) const {
+    return p >= base_ && p < base_ + reserved_size_;
+  }
+
+  // Number of slabs mapped with huge pages
+  size_t GetNumHugePageSlabs() const { return num_huge_page_slabs_.load(); }
+  // Number of slabs mapped with normal pages
+  size_t GetNumNormalPageSlabs() const {
+    return num_normal_page_slabs_.load();
+  }
+  // Size of the slabs mapped
+  size_t GetMappedBytes() const {
+    return (GetNumHugePageSlabs() + GetNumNormalPageSlabs()) * slab_size_;
+  }
+  // Usable size of the allocations out of the slabs
+  size_t GetAllocatedBytes() const;
+
+ private:
+  static constexpr size_t kPageShift = 12;
+  static constexpr size_t kMinRunSize = 64 << 10;
+  // Up to 4 size classes for each power of two, from 64 bytes
+  static constexpr size_t kMaxSizeClasses = 128;
+
+  SlabAllocator(size_t slab_size, size_t max_allocation_size,
+                bool huge_pages, size_t huge_page_size);
+
+  static size_t SizeClassOf(size_t size);
+  static size_t SizeOfClass(size_t size_class);
+
+  struct Shard {
+    SpinMutex mutex;
+    // Unused part of the slab that the runs of the shard are carved from
+    char* slab_pos = nullptr;
+    char* slab_end = nullptr;
+    // Usable size of the allocations made, minus that of the ones freed, in
+    // the shard
+    std::atomic<int64_t> allocated_bytes{0};
+    struct SizeClassState {
+      // Freed allocations, each starting with a pointer to the next one
+      void* free_list = nullptr;
+      // Never allocated part of the latest run
+      char* run_pos = nullptr;
+      char* run_end = nullptr;
+    } size_classes[kMaxSizeClasses];
+  };
+
+  // Returns a new run of `size` bytes for `size_class`, or nullptr once the
+  // capacity is used up
+  char* NewRun(Shard* shard, size_t size_class, size_t size);
+  // Returns the next slab, mapped, or nullptr
+  char* NewSlab();
+
+  const size_t slab_size_;
+  const size_t max_allocation_size_;
+  const bool huge_pages_;
+  const size_t huge_page_size_;
+  // Start of the range reserved for the slabs, aligned to the slab size
+  char* base_ = nullptr;
+  size_t reserved_size_ = 0;
+  // The whole mapping of the reserved range
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  size_t num_slabs_ = 0;
+  std::atomic<size_t> next_slab_{0};
+  // Size class plus one of each page of the slabs that is in a run, or 0
+  TypedMemMapping<uint8_t> page_size_classes_;
+  std::atomic<size_t> num_huge_page_slabs_{0};
+  std::atomic<size_t> num_normal_page_slabs_{0};
+  CoreLocalArray<Shard> shards_;
+};
+#else
+class SlabAllocator {};
+#endif  // ROCKSDB_SLAB_ALLOCATOR
+
+// Allocations are carved out of slabs by size class, with per-core free
+// lists, and the larger ones come from operator new.
+class SlabMemoryAllocator : public BaseMemoryAllocator {
+ public:
+  explicit SlabMemoryAllocator(const SlabAllocatorOptions& options);
+  ~SlabMemoryAllocator() override;
+
+  static const char* kClassName() { return "SlabMemoryAllocator"; }
+  const char* Name() const override { return kClassName(); }
+  static bool IsSupported() {
+    std::string unused;
+    return IsSupported(&unused);
+  }
+  static bool IsSupported(std::string* why);
+  bool IsMutable() const { return slabs_ == nullptr; }
+
+  Status PrepareOptions(const ConfigOptions& config_options) override;
+
+#ifdef ROCKSDB_SLAB_ALLOCATOR
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+#endif  // ROCKSDB_SLAB_ALLOCATOR
+
+  const SlabAllocator* GetSlabAllocator() const { return slabs_.get(); }
+
+ private:
+  SlabAllocatorOptions options_;
+  std::unique_ptr<SlabAllocator> slabs_;
+};
+
+// Returns the slabs that `allocator` carves allocations out of, if it is a
+// SlabMemoryAllocator or a HugePageMemoryAllocator, or nullptr
+const SlabAllocator* GetSlabAllocator(MemoryAllocator* allocator);
+}  // namespace ROCKSDB_NAMESPACE
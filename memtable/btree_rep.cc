@@ -0,0 +1,130 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "memtable/concurrent_btree.h"
+#include "rocksdb/memtablerep.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+class BTreeRep : public MemTableRep {
+  using Tree = ConcurrentBTree<const MemTableRep::KeyComparator&>;
+  Tree tree_;
+
+ public:
+  BTreeRep(const MemTableRep::KeyComparator& compare, Allocator* allocator)
+      : MemTableRep(allocator), tree_(compare, allocator) {}
+
+  // Insert key into the tree.
+  // REQUIRES: nothing that compares equal to key is currently in the tree.
+  void Insert(KeyHandle handle) override {
+    tree_.Insert(static_cast<char*>(handle));
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    tree_.Insert(static_cast<char*>(handle));
+  }
+
+  // Returns true iff an entry that compares equal to key is in the tree.
+  bool Contains(const char* key) const override { return tree_.Contains(key); }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    Tree::Iterator iter(&tree_);
+    for (iter.Seek(k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  ~BTreeRep() override = default;
+
+  // Iteration over the contents of a tree
+  class Iterator : public MemTableRep::Iterator {
+    Tree::Iterator iter_;
+
+   public:
+    // Initialize an iterator over the specified tree.
+    // The returned iterator is not valid.
+    explicit Iterator(const Tree* tree) : iter_(tree) {}
+
+    ~Iterator() override = default;
+
+    // Returns true iff the iterator is positioned at a valid node.
+    bool Valid() const override { return iter_.Valid(); }
+
+    // Returns the key at the current position.
+    // REQUIRES: Valid()
+    const char* key() const override {
+      assert(Valid());
+      return iter_.key();
+    }
+
+    // Advances to the next position.
+    // REQUIRES: Valid()
+    void Next() override {
+      assert(Valid());
+      iter_.Next();
+    }
+
+    // Advances to the previous position.
+    // REQUIRES: Valid()
+    void Prev() override {
+      assert(Valid());
+      iter_.Prev();
+    }
+
+    // Advance to the first entry with a key >= target
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      if (memtable_key != nullptr) {
+        iter_.Seek(memtable_key);
+      } else {
+        iter_.Seek(EncodeKey(&tmp_, user_key));
+      }
+    }
+
+    // Retreat to the last entry with a key <= target
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override {
+      if (memtable_key != nullptr) {
+        iter_.SeekForPrev(memtable_key);
+      } else {
+        iter_.SeekForPrev(EncodeKey(&tmp_, user_key));
+      }
+    }
+
+    // Position at the first entry in tree.
+    // Final state of iterator is Valid() iff tree is not empty.
+    void SeekToFirst() override { iter_.SeekToFirst(); }
+
+    // Position at the last entry in tree.
+    // Final state of iterator is Valid() iff tree is not empty.
+    void SeekToLast() override { iter_.SeekToLast(); }
+
+   protected:
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(BTreeRep::Iterator))
+                      : operator new(sizeof(BTreeRep::Iterator));
+    return new (mem) BTreeRep::Iterator(&tree_);
+  }
+};
+}  // namespace
+
+MemTableRep* BTreeRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  return new BTreeRep(compare, allocator);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,594 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// ConcurrentBTree is a B+-tree of keys allocated by the user, for use as a
+// memtable index in place of InlineSkipList. Each node packs up to kMaxKeys
+// key pointers next to each other, so a lookup takes a binary search over a
+// few cache lines per level instead of a cache miss per skip list hop, and
+// the tree needs no per-key tower of next pointers.
+//
+// Thread safety -------------
+//
+// Insert can be called concurrently with other inserts and with reads. Reads
+// require a guarantee that the ConcurrentBTree will not be destroyed while
+// the read is in progress; apart from that, they take no locks.
+//
+// Nodes are protected by optimistic lock coupling: every node has a version
+// that writers lock (setting kLockedBit) while they modify the node, and
+// advance when they unlock it. Readers and writers descend the tree without
+// locking, then validate the version of each node they read from, restarting
+// from the root if it changed. A writer only locks the leaf it inserts into,
+// or, when a node is full, the node and its parent for splitting it. Splits
+// happen eagerly on the way down, so the parent of a node being split always
+// has room for the new separator.
+//
+// Invariants:
+//
+// (1) Allocated nodes are never deleted until the ConcurrentBTree is
+// destroyed, and a split keeps the left half in place, so every node, once
+// reachable, stays reachable.
+//
+// (2) A key never moves to the left of the leaf it is in, and leaves are
+// linked in key order. Iterators copy the keys of one leaf at a time and
+// follow the links, so they see every key inserted before they were
+// positioned.
+//
+
+#pragma once
+
+#include <assert.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "memory/allocator.h"
+#include "port/port.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+template <class Comparator>
+class ConcurrentBTree {
+ private:
+  static constexpr uint32_t kMaxKeys = 31;
+  static constexpr uint64_t kLockedBit = 2;
+
+  struct Node;
+  struct Leaf;
+  struct Inner;
+
+ public:
+  // Create a new ConcurrentBTree object that will use "cmp" for comparing
+  // keys, and will allocate memory using "*allocator".  Objects allocated
+  // in the allocator must remain allocated for the lifetime of the tree.
+  // "*allocator" must be thread-safe if Insert is called concurrently.
+  ConcurrentBTree(Comparator cmp, Allocator* allocator);
+  // No copying allowed
+  ConcurrentBTree(const ConcurrentBTree&) = delete;
+  ConcurrentBTree& operator=(const ConcurrentBTree&) = delete;
+
+  // Inserts key into the tree; safe to call concurrently with other inserts
+  // and with reads.
+  // REQUIRES: nothing that compares equal to key is currently in the tree.
+  void Insert(const char* key);
+
+  // Returns true iff an entry that compares equal to key is in the tree.
+  bool Contains(const char* key) const;
+
+  // Iteration over the contents of the tree
+  class Iterator {
+   public:
+    // Initialize an iterator over the specified tree.
+    // The returned iterator is not valid.
+    explicit Iterator(const ConcurrentBTree* tree);
+
+    // Returns true iff the iterator is positioned at a valid entry.
+    bool Valid() const { return pos_ < num_keys_; }
+
+    // Returns the key at the current position.
+    // REQUIRES: Valid()
+    const char* key() const {
+      assert(Valid());
+      return keys_[pos_];
+    }
+
+    // Advances to the next position.
+    // REQUIRES: Valid()
+    void Next();
+
+    // Advances to the previous position.
+    // REQUIRES: Valid()
+    void Prev();
+
+    // Advance to the first entry with a key >= target
+    void Seek(const char* target);
+
+    // Retreat to the last entry with a key <= target
+    void SeekForPrev(const char* target);
+
+    // Position at the first entry in tree.
+    // Final state of iterator is Valid() iff tree is not empty.
+    void SeekToFirst();
+
+    // Position at the last entry in tree.
+    // Final state of iterator is Valid() iff tree is not empty.
+    void SeekToLast();
+
+   private:
+    // Copies the keys of `leaf`, read under `version`. Returns false if the
+    // leaf changed meanwhile.
+    bool Load(const Leaf* leaf, uint64_t version);
+    // Positions at the first key of the leaves from next_ on.
+    void LoadNext();
+    // Loads the leaf that FindLeaf(target, less) returns
+    void SeekLeaf(const char* target, bool less);
+    // Number of the loaded keys that are less than, or if `or_equal` less
+    // than or equal to, target
+    uint32_t Rank(const char* target, bool or_equal) const;
+
+    const ConcurrentBTree* tree_;
+    // Copy of the keys of the current leaf
+    const char* keys_[kMaxKeys];
+    uint32_t num_keys_;
+    uint32_t pos_;
+    const Leaf* next_;
+    // Intentionally copyable
+  };
+
+ private:
+  struct Node {
+    explicit Node(bool leaf) : is_leaf(leaf) {
+      for (auto& key : keys) {
+        key.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    // Returns the version to validate against, or kLockedBit if a writer
+    // holds the node.
+    uint64_t ReadVersion() const {
+      const uint64_t version = version_.load(std::memory_order_acquire);
+      return (version & kLockedBit) ? kLockedBit : version;
+    }
+
+    // Whether the node is unchanged since `version` was read
+    bool Validate(uint64_t version) const {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return version_.load(std::memory_order_relaxed) == version;
+    }
+
+    // Locks the node if it is unchanged since `version` was read
+    bool TryLock(uint64_t version) {
+      if (version == kLockedBit ||
+          !version_.compare_exchange_strong(version, version + kLockedBit,
+                                            std::memory_order_acquire)) {
+        return false;
+      }
+      // Readers that see any of the following writes also see the lock
+      std::atomic_thread_fence(std::memory_order_release);
+      return true;
+    }
+
+    void Unlock() {
+      version_.fetch_add(kLockedBit, std::memory_order_release);
+    }
+
+    uint32_t Count() const { return count.load(std::memory_order_relaxed); }
+    // Keys and nodes are published with release stores, so that what they
+    // point to is visible to readers.
+    const char* Key(uint32_t i) const {
+      return keys[i].load(std::memory_order_acquire);
+    }
+
+    std::atomic<uint64_t> version_{0};
+    std::atomic<uint32_t> count{0};
+    const bool is_leaf;
+    std::atomic<const char*> keys[kMaxKeys];
+  };
+
+  struct Leaf : public Node {
+    Leaf() : Node(true) {}
+
+    const Leaf* Next() const { return next.load(std::memory_order_acquire); }
+
+    std::atomic<Leaf*> next{nullptr};
+  };
+
+  // children[i] holds the keys in [keys[i - 1], keys[i])
+  struct Inner : public Node {
+    Inner() : Node(false) {
+      for (auto& child : children) {
+        child.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    Node* Child(uint32_t i) const {
+      return children[i].load(std::memory_order_acquire);
+    }
+
+    std::atomic<Node*> children[kMaxKeys + 1];
+  };
+
+  // Number of the first `count` keys of `node` that are less than, or if
+  // `or_equal` less than or equal to, `target`. Returns -1 on seeing a slot
+  // that a concurrent insert has not filled yet.
+  int Rank(const Node* node, uint32_t count, const char* target,
+           bool or_equal) const;
+
+  // Descends to the leaf that holds the last key <= target (if any, and
+  // otherwise to the first leaf), or if `less` the last key < target, and
+  // returns it with its version. A nullptr target descends to the first
+  // leaf, or if `less` the last one.
+  const Leaf* FindLeaf(const char* target, bool less, uint64_t* version) const;
+
+  // Returns false if a concurrent change calls for restarting from the root
+  bool TryInsert(const char* key);
+
+  // REQUIRES: node and, unless node is the root, parent locked
+  void Split(Node* node, Inner* parent);
+  // REQUIRES: node locked and not full
+  void InsertAt(Node* node, uint32_t pos, const char* key, Node* right_child);
+
+  Comparator const compare_;
+  Allocator* const allocator_;  // Allocator used for allocations of nodes
+  std::atomic<Node*> root_;
+};
+
+// Implementation details follow
+
+template <class Comparator>
+ConcurrentBTree<Comparator>::ConcurrentBTree(const Comparator cmp,
+                                             Allocator* allocator)
+    : compare_(cmp), allocator_(allocator) {
+  root_.store(new (allocator_->AllocateAligned(sizeof(Leaf))) Leaf(),
+              std::memory_order_relaxed);
+}
+
+template <class Comparator>
+int ConcurrentBTree<Comparator>::Rank(const Node* node, uint32_t count,
+                                      const char* target,
+                                      bool or_equal) const {
+  uint32_t lo = 0;
+  uint32_t hi = count;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const char* key = node->Key(mid);
+    if (key == nullptr) {
+      return -1;
+    }
+    const int cmp = compare_(key, target);
+    if (cmp < 0 || (or_equal && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return static_cast<int>(lo);
+}
+
+template <class Comparator>
+const typename ConcurrentBTree<Comparator>::Leaf*
+ConcurrentBTree<Comparator>::FindLeaf(const char* target, bool less,
+                                      uint64_t* version) const {
+  for (;; port::AsmVolatilePause()) {
+    const Node* node = root_.load(std::memory_order_acquire);
+    uint64_t node_version = node->ReadVersion();
+    if (node_version == kLockedBit ||
+        node != root_.load(std::memory_order_acquire)) {
+      continue;
+    }
+    const Node* parent = nullptr;
+    uint64_t parent_version = 0;
+    bool restart = false;
+    while (!node->is_leaf) {
+      const Inner* inner = static_cast<const Inner*>(node);
+      const uint32_t count = inner->Count();
+      int pos = static_cast<int>(less ? count : 0);
+      if (target != nullptr) {
+        // Keys equal to a separator are in the child to its right
+        pos = Rank(inner, count, target, !less);
+      }
+      if (pos < 0 || (parent != nullptr && !parent->Validate(parent_version))) {
+        restart = true;
+        break;
+      }
+      const Node* child = inner->Child(static_cast<uint32_t>(pos));
+      if (!inner->Validate(node_version)) {
+        restart = true;
+        break;
+      }
+      parent = inner;
+      parent_version = node_version;
+      node = child;
+      node_version = node->ReadVersion();
+      if (node_version == kLockedBit) {
+        restart = true;
+        break;
+      }
+    }
+    if (restart ||
+        (parent != nullptr && !parent->Validate(parent_version))) {
+      continue;
+    }
+    *version = node_version;
+    return static_cast<const Leaf*>(node);
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Insert(const char* key) {
+  while (!TryInsert(key)) {
+    port::AsmVolatilePause();
+  }
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::TryInsert(const char* key) {
+  Node* node = root_.load(std::memory_order_acquire);
+  uint64_t node_version = node->ReadVersion();
+  if (node_version == kLockedBit ||
+      node != root_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  Inner* parent = nullptr;
+  uint64_t parent_version = 0;
+  for (;;) {
+    if (node->Count() == kMaxKeys) {
+      // Split full nodes on the way down, so that a parent always has room
+      if (parent != nullptr && !parent->TryLock(parent_version)) {
+        return false;
+      }
+      if (!node->TryLock(node_version)) {
+        if (parent != nullptr) {
+          parent->Unlock();
+        }
+        return false;
+      }
+      if (parent == nullptr && node != root_.load(std::memory_order_relaxed)) {
+        // Another thread split what was the root
+        node->Unlock();
+        return false;
+      }
+      Split(node, parent);
+      node->Unlock();
+      if (parent != nullptr) {
+        parent->Unlock();
+      }
+      return false;
+    }
+    if (node->is_leaf) {
+      break;
+    }
+    if (parent != nullptr && !parent->Validate(parent_version)) {
+      return false;
+    }
+    Inner* inner = static_cast<Inner*>(node);
+    const int pos = Rank(inner, inner->Count(), key, true);
+    if (pos < 0) {
+      return false;
+    }
+    Node* child = inner->Child(static_cast<uint32_t>(pos));
+    if (!inner->Validate(node_version)) {
+      return false;
+    }
+    parent = inner;
+    parent_version = node_version;
+    node = child;
+    node_version = node->ReadVersion();
+    if (node_version == kLockedBit) {
+      return false;
+    }
+  }
+  if (!node->TryLock(node_version)) {
+    return false;
+  }
+  if (parent != nullptr && !parent->Validate(parent_version)) {
+    // The leaf might have been split before we locked it
+    node->Unlock();
+    return false;
+  }
+  const int pos = Rank(node, node->Count(), key, false);
+  assert(pos >= 0);
+  assert(static_cast<uint32_t>(pos) == node->Count() ||
+         compare_(node->Key(static_cast<uint32_t>(pos)), key) != 0);
+  InsertAt(node, static_cast<uint32_t>(pos), key, nullptr);
+  node->Unlock();
+  return true;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Split(Node* node, Inner* parent) {
+  assert(node->Count() == kMaxKeys);
+  const uint32_t mid = kMaxKeys / 2;
+  const char* separator = node->Key(mid);
+  Node* right;
+  if (node->is_leaf) {
+    // The separator is the first key of the right leaf
+    Leaf* leaf = static_cast<Leaf*>(node);
+    Leaf* right_leaf = new (allocator_->AllocateAligned(sizeof(Leaf))) Leaf();
+    for (uint32_t i = mid; i < kMaxKeys; i++) {
+      right_leaf->keys[i - mid].store(leaf->Key(i), std::memory_order_release);
+    }
+    right_leaf->count.store(kMaxKeys - mid, std::memory_order_relaxed);
+    right_leaf->next.store(leaf->next.load(std::memory_order_relaxed),
+                           std::memory_order_release);
+    leaf->next.store(right_leaf, std::memory_order_release);
+    right = right_leaf;
+  } else {
+    // The separator moves up to the parent
+    Inner* inner = static_cast<Inner*>(node);
+    Inner* right_inner =
+        new (allocator_->AllocateAligned(sizeof(Inner))) Inner();
+    for (uint32_t i = mid + 1; i < kMaxKeys; i++) {
+      right_inner->keys[i - mid - 1].store(inner->Key(i),
+                                           std::memory_order_release);
+    }
+    for (uint32_t i = mid + 1; i <= kMaxKeys; i++) {
+      right_inner->children[i - mid - 1].store(inner->Child(i),
+                                               std::memory_order_release);
+    }
+    right_inner->count.store(kMaxKeys - mid - 1, std::memory_order_relaxed);
+    right = right_inner;
+  }
+  node->count.store(mid, std::memory_order_relaxed);
+
+  if (parent != nullptr) {
+    const int pos = Rank(parent, parent->Count(), separator, false);
+    assert(pos >= 0);
+    InsertAt(parent, static_cast<uint32_t>(pos), separator, right);
+  } else {
+    Inner* root = new (allocator_->AllocateAligned(sizeof(Inner))) Inner();
+    root->keys[0].store(separator, std::memory_order_release);
+    root->children[0].store(node, std::memory_order_release);
+    root->children[1].store(right, std::memory_order_release);
+    root->count.store(1, std::memory_order_relaxed);
+    root_.store(root, std::memory_order_release);
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::InsertAt(Node* node, uint32_t pos,
+                                           const char* key,
+                                           Node* right_child) {
+  const uint32_t count = node->Count();
+  assert(count < kMaxKeys);
+  assert(pos <= count);
+  for (uint32_t i = count; i > pos; i--) {
+    node->keys[i].store(node->Key(i - 1), std::memory_order_release);
+  }
+  node->keys[pos].store(key, std::memory_order_release);
+  if (!node->is_leaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    for (uint32_t i = count + 1; i > pos + 1; i--) {
+      inner->children[i].store(inner->Child(i - 1),
+                               std::memory_order_release);
+    }
+    inner->children[pos + 1].store(right_child, std::memory_order_release);
+  }
+  node->count.store(count + 1, std::memory_order_relaxed);
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Contains(const char* key) const {
+  Iterator iter(this);
+  iter.Seek(key);
+  return iter.Valid() && compare_(iter.key(), key) == 0;
+}
+
+template <class Comparator>
+ConcurrentBTree<Comparator>::Iterator::Iterator(const ConcurrentBTree* tree)
+    : tree_(tree), num_keys_(0), pos_(0), next_(nullptr) {}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Iterator::Load(const Leaf* leaf,
+                                                 uint64_t version) {
+  uint32_t count = leaf->Count();
+  if (count > kMaxKeys) {
+    count = kMaxKeys;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    keys_[i] = leaf->Key(i);
+  }
+  next_ = leaf->Next();
+  num_keys_ = count;
+  pos_ = 0;
+  if (!leaf->Validate(version)) {
+    num_keys_ = 0;
+    return false;
+  }
+  return true;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::LoadNext() {
+  num_keys_ = 0;
+  pos_ = 0;
+  while (num_keys_ == 0 && next_ != nullptr) {
+    const Leaf* leaf = next_;
+    uint64_t version;
+    do {
+      version = leaf->ReadVersion();
+    } while (version == kLockedBit || !Load(leaf, version));
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekLeaf(const char* target,
+                                                     bool less) {
+  uint64_t version;
+  while (!Load(tree_->FindLeaf(target, less, &version), version)) {
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Next() {
+  assert(Valid());
+  if (++pos_ == num_keys_) {
+    LoadNext();
+  }
+}
+
+template <class Comparator>
+uint32_t ConcurrentBTree<Comparator>::Iterator::Rank(const char* target,
+                                                     bool or_equal) const {
+  uint32_t lo = 0;
+  uint32_t hi = num_keys_;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const int cmp = tree_->compare_(keys_[mid], target);
+    if (cmp < 0 || (or_equal && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Prev() {
+  assert(Valid());
+  if (pos_ > 0) {
+    pos_--;
+    return;
+  }
+  // Leaves are not linked backwards, so look up the last key less than the
+  // current one from the root
+  const char* target = keys_[0];
+  SeekLeaf(target, true);
+  const uint32_t rank = Rank(target, false);
+  pos_ = rank > 0 ? rank - 1 : num_keys_;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Seek(const char* target) {
+  SeekLeaf(target, false);
+  pos_ = Rank(target, false);
+  if (pos_ == num_keys_) {
+    LoadNext();
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekForPrev(const char* target) {
+  SeekLeaf(target, false);
+  const uint32_t rank = Rank(target, true);
+  pos_ = rank > 0 ? rank - 1 : num_keys_;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekToFirst() {
+  SeekLeaf(nullptr, false);
+  if (num_keys_ == 0) {
+    LoadNext();
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekToLast() {
+  SeekLeaf(nullptr, true);
+  pos_ = num_keys_ > 0 ? num_keys_ - 1 : 0;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,222 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memtable/concurrent_btree.h"
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+#include "memory/concurrent_arena.h"
+#include "port/port.h"
+#include "port/stack_trace.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Our test tree stores 8-byte unsigned integers
+using Key = uint64_t;
+
+static const char* Encode(const uint64_t* key) {
+  return reinterpret_cast<const char*>(key);
+}
+
+static Key Decode(const char* key) {
+  Key rv;
+  memcpy(&rv, key, sizeof(Key));
+  return rv;
+}
+
+struct TestComparator {
+  int operator()(const char* a, const char* b) const {
+    if (Decode(a) < Decode(b)) {
+      return -1;
+    } else if (Decode(a) > Decode(b)) {
+      return +1;
+    } else {
+      return 0;
+    }
+  }
+};
+
+using TestBTree = ConcurrentBTree<TestComparator>;
+
+class ConcurrentBTreeTest : public testing::Test {
+ public:
+  void Insert(TestBTree* tree, Allocator* allocator, Key key) {
+    char* buf = allocator->AllocateAligned(sizeof(Key));
+    memcpy(buf, &key, sizeof(Key));
+    tree->Insert(buf);
+  }
+};
+
+TEST_F(ConcurrentBTreeTest, Empty) {
+  Arena arena;
+  TestComparator cmp;
+  TestBTree tree(cmp, &arena);
+  Key key = 10;
+  ASSERT_FALSE(tree.Contains(Encode(&key)));
+
+  TestBTree::Iterator iter(&tree);
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToFirst();
+  ASSERT_FALSE(iter.Valid());
+  key = 100;
+  iter.Seek(Encode(&key));
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekForPrev(Encode(&key));
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToLast();
+  ASSERT_FALSE(iter.Valid());
+}
+
+TEST_F(ConcurrentBTreeTest, InsertAndLookup) {
+  const int N = 20000;
+  const int R = 50000;
+  Random rnd(1000);
+  std::set<Key> keys;
+  Arena arena;
+  TestComparator cmp;
+  TestBTree tree(cmp, &arena);
+  for (int i = 0; i < N; i++) {
+    // Even keys only, so that odd ones can be looked up between them
+    Key key = 2 * (rnd.Next() % R) + 2;
+    if (keys.insert(key).second) {
+      Insert(&tree, &arena, key);
+    }
+  }
+
+  for (Key i = 0; i < 2 * R + 4; i++) {
+    ASSERT_EQ(keys.count(i) == 1, tree.Contains(Encode(&i)));
+  }
+
+  // Forward and backward iteration
+  TestBTree::Iterator iter(&tree);
+  iter.SeekToFirst();
+  for (Key key : keys) {
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(key, Decode(iter.key()));
+    iter.Next();
+  }
+  ASSERT_FALSE(iter.Valid());
+
+  iter.SeekToLast();
+  for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(*it, Decode(iter.key()));
+    iter.Prev();
+  }
+  ASSERT_FALSE(iter.Valid());
+
+  // Seek and SeekForPrev to present and absent keys
+  for (Key i = 0; i < 2 * R + 4; i++) {
+    iter.Seek(Encode(&i));
+    auto lower = keys.lower_bound(i);
+    if (lower == keys.end()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*lower, Decode(iter.key()));
+    }
+
+    iter.SeekForPrev(Encode(&i));
+    auto upper = keys.upper_bound(i);
+    if (upper == keys.begin()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*std::prev(upper), Decode(iter.key()));
+    }
+  }
+}
+
+TEST_F(ConcurrentBTreeTest, SequentialInsert) {
+  // Always splitting the rightmost nodes
+  const Key N = 10000;
+  Arena arena;
+  TestComparator cmp;
+  TestBTree tree(cmp, &arena);
+  for (Key i = 0; i < N; i++) {
+    Insert(&tree, &arena, i);
+  }
+  TestBTree::Iterator iter(&tree);
+  iter.SeekToFirst();
+  for (Key i = 0; i < N; i++) {
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(i, Decode(iter.key()));
+    iter.Next();
+  }
+  ASSERT_FALSE(iter.Valid());
+  Key key = N / 2;
+  iter.Seek(Encode(&key));
+  for (Key i = N / 2; i > 0; i--) {
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(i, Decode(iter.key()));
+    iter.Prev();
+  }
+  ASSERT_TRUE(iter.Valid());
+  ASSERT_EQ(0U, Decode(iter.key()));
+}
+
+TEST_F(ConcurrentBTreeTest, ConcurrentInsert) {
+  const int kNumWriters = 4;
+  const Key kKeysPerWriter = 20000;
+  ConcurrentArena arena;
+  TestComparator cmp;
+  TestBTree tree(cmp, &arena);
+  std::atomic<int> writers_done{0};
+
+  // Readers must see keys in order while the tree is split under them
+  port::Thread reader([&]() {
+    TestBTree::Iterator iter(&tree);
+    while (writers_done.load() < kNumWriters) {
+      Key last = 0;
+      bool first = true;
+      for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+        Key key = Decode(iter.key());
+        ASSERT_TRUE(first || key > last);
+        last = key;
+        first = false;
+      }
+    }
+  });
+  std::vector<port::Thread> writers;
+  for (int w = 0; w < kNumWriters; w++) {
+    writers.emplace_back([&, w]() {
+      for (Key i = 0; i < kKeysPerWriter; i++) {
+        // Interleave the keys of all writers
+        Insert(&tree, &arena, i * kNumWriters + w);
+      }
+      writers_done.fetch_add(1);
+      for (Key i = 0; i < kKeysPerWriter; i++) {
+        Key key = i * kNumWriters + w;
+        ASSERT_TRUE(tree.Contains(Encode(&key)));
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  reader.join();
+
+  TestBTree::Iterator iter(&tree);
+  iter.SeekToFirst();
+  for (Key i = 0; i < kNumWriters * kKeysPerWriter; i++) {
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(i, Decode(iter.key()));
+    iter.Next();
+  }
+  ASSERT_FALSE(iter.Valid());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -5,7 +5,9 @@
 //
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <mutex>
 
 #include "db/memtable.h"
 #include "memory/arena.h"
@@ -17,6 +19,7 @@
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/utilities/options_type.h"
 #include "util/hash.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace {
@@ -41,7 +44,7 @@ struct BucketHeader {
     return num_entries.load(std::memory_order_relaxed);
   }
 
-  // REQUIRES: called from single-threaded Insert()
+  // REQUIRES: called from Insert() with no concurrent insert into the bucket
   void IncNumEntries() {
     // Only one thread can do write at one time. No need to do atomic
     // incremental. Update it with relaxed load and store.
@@ -169,6 +172,8 @@ class HashLinkListRep : public MemTableRep {
 
   void Insert(KeyHandle handle) override;
 
+  void InsertConcurrently(KeyHandle handle) override;
+
   bool Contains(const char* key) const override;
 
   size_t ApproximateMemoryUsage() override;
@@ -203,6 +208,13 @@ class HashLinkListRep : public MemTableRep {
   int bucket_entries_logging_threshold_;
   bool if_log_bucket_dist_when_flash_;
 
+  // Concurrent inserts into buckets with the same index modulo
+  // kNumInsertLocks are serialized, so that each bucket, including its
+  // conversions to a counting and a skip list bucket, has a single writer at
+  // a time.
+  static constexpr size_t kNumInsertLocks = 64;
+  std::array<CacheAlignedWrapper<SpinMutex>, kNumInsertLocks> insert_locks_;
+
   bool LinkListContains(Node* head, const Slice& key) const;
 
   bool IsEmptyBucket(Pointer& bucket_pointer) const {
@@ -616,8 +628,8 @@ void HashLinkListRep::Insert(KeyHandle handle) {
       assert(header->GetNumEntries() > threshold_use_skiplist_);
       auto* skip_list_bucket_header =
           reinterpret_cast<SkipListBucketHeader*>(header);
-      // Only one thread can execute Insert() at one time. No need to do atomic
-      // incremental.
+      // Only one thread can execute Insert() on the bucket at one time. No
+      // need to do atomic incremental.
       skip_list_bucket_header->Counting_header.IncNumEntries();
       skip_list_bucket_header->skip_list.Insert(x->key);
       return;
@@ -701,6 +713,14 @@ void HashLinkListRep::Insert(KeyHandle handle) {
   }
 }
 
+void HashLinkListRep::InsertConcurrently(KeyHandle handle) {
+  Slice internal_key =
+      GetLengthPrefixedSlice(static_cast<Node*>(handle)->key);
+  std::lock_guard<SpinMutex> guard(
+      insert_locks_[GetHash(GetPrefix(internal_key)) % kNumInsertLocks].obj_);
+  Insert(handle);
+}
+
 bool HashLinkListRep::Contains(const char* key) const {
   Slice internal_key = GetLengthPrefixedSlice(key);
 
@@ -896,6 +916,8 @@ class HashLinkListRepFactory : public MemTableRepFactory {
   const char* Name() const override { return kClassName(); }
   const char* NickName() const override { return kNickName(); }
 
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
  private:
   HashLinkListRepOptions options_;
 };
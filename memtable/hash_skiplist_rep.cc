@@ -4,7 +4,9 @@
 //  (found in the LICENSE.Apache file in the root directory).
 //
 
+#include <array>
 #include <atomic>
+#include <mutex>
 
 #include "db/memtable.h"
 #include "memory/arena.h"
@@ -15,6 +17,7 @@
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/utilities/options_type.h"
 #include "util/murmurhash.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace {
@@ -28,6 +31,8 @@ class HashSkipListRep : public MemTableRep {
 
   void Insert(KeyHandle handle) override;
 
+  void InsertConcurrently(KeyHandle handle) override;
+
   bool Contains(const char* key) const override;
 
   size_t ApproximateMemoryUsage() override;
@@ -62,6 +67,12 @@ class HashSkipListRep : public MemTableRep {
   // immutable after construction
   Allocator* const allocator_;
 
+  // Concurrent inserts into buckets with the same index modulo
+  // kNumInsertLocks are serialized, so that each bucket, including its lazy
+  // initialization, has a single writer at a time.
+  static constexpr size_t kNumInsertLocks = 64;
+  std::array<CacheAlignedWrapper<SpinMutex>, kNumInsertLocks> insert_locks_;
+
   inline size_t GetHash(const Slice& slice) const {
     return MurmurHash(slice.data(), static_cast<int>(slice.size()), 0) %
            bucket_size_;
@@ -271,6 +282,13 @@ void HashSkipListRep::Insert(KeyHandle handle) {
   bucket->Insert(key);
 }
 
+void HashSkipListRep::InsertConcurrently(KeyHandle handle) {
+  auto transformed = transform_->Transform(UserKey(static_cast<char*>(handle)));
+  std::lock_guard<SpinMutex> guard(
+      insert_locks_[GetHash(transformed) % kNumInsertLocks].obj_);
+  Insert(handle);
+}
+
 bool HashSkipListRep::Contains(const char* key) const {
   auto transformed = transform_->Transform(UserKey(key));
   auto bucket = GetBucket(transformed);
@@ -368,6 +386,8 @@ class HashSkipListRepFactory : public MemTableRepFactory {
   const char* Name() const override { return kClassName(); }
   const char* NickName() const override { return kNickName(); }
 
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
  private:
   HashSkipListRepOptions options_;
 };
@@ -45,6 +45,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <type_traits>
 
@@ -141,6 +142,19 @@ class InlineSkipList {
   // Returns true iff an entry that compares equal to key is in the list.
   bool Contains(const char* key) const;
 
+  class Iterator;
+
+  // Maximum number of targets of one MultiSeek()
+  static constexpr size_t kMaxMultiSeek = 16;
+
+  // Positions *iters[i] at the first entry with a key >= targets[i], like
+  // iters[i]->Seek(targets[i]), for each i < num. The searches take steps in
+  // turn, each prefetching the node of its next comparison, so that their
+  // cache misses overlap.
+  // REQUIRES: num <= kMaxMultiSeek, and iters[i] are over this list
+  void MultiSeek(size_t num, const char* const* targets,
+                 Iterator* const* iters) const;
+
   // Return estimated number of entries from `start_ikey` to `end_ikey`.
   uint64_t ApproximateNumEntries(const Slice& start_ikey,
                                  const Slice& end_ikey) const;
@@ -200,6 +214,8 @@ class InlineSkipList {
     void SeekToLast();
 
    private:
+    friend class InlineSkipList;
+
     const InlineSkipList* list_;
     Node* node_;
     // Intentionally copyable
@@ -572,6 +588,61 @@ InlineSkipList<Comparator>::FindGreaterOrEqual(
   }
 }
 
+template <class Comparator>
+void InlineSkipList<Comparator>::MultiSeek(size_t num,
+                                           const char* const* targets,
+                                           Iterator* const* iters) const {
+  assert(num <= kMaxMultiSeek);
+  // The state of FindGreaterOrEqual() for each target
+  struct Search {
+    Node* x;
+    Node* last_bigger;
+    int level;
+    DecodedKey key;
+  };
+  std::array<Search, kMaxMultiSeek> searches;
+  std::array<size_t, kMaxMultiSeek> active;
+  const int max_level = GetMaxHeight() - 1;
+  for (size_t i = 0; i < num; i++) {
+    assert(iters[i]->list_ == this);
+    searches[i] = {head_, nullptr, max_level, compare_.decode_key(targets[i])};
+    active[i] = i;
+  }
+  size_t num_active = num;
+  while (num_active > 0) {
+    for (size_t a = 0; a < num_active;) {
+      const size_t i = active[a];
+      Search& search = searches[i];
+      Node* next = search.x->Next(search.level);
+      // Make sure the lists are sorted
+      assert(search.x == head_ || next == nullptr ||
+             KeyIsAfterNode(next->Key(), search.x));
+      // Make sure we haven't overshot during our search
+      assert(search.x == head_ || KeyIsAfterNode(search.key, search.x));
+      const int cmp = (next == nullptr || next == search.last_bigger)
+                          ? 1
+                          : compare_(next->Key(), search.key);
+      if (cmp == 0 || (cmp > 0 && search.level == 0)) {
+        iters[i]->node_ = next;
+        active[a] = active[--num_active];
+        continue;
+      } else if (cmp < 0) {
+        // Keep searching in this list
+        search.x = next;
+      } else {
+        // Switch to next list, reuse compare_() result
+        search.last_bigger = next;
+        search.level--;
+      }
+      Node* upcoming = search.x->Next(search.level);
+      if (upcoming != nullptr && upcoming != search.last_bigger) {
+        PREFETCH(upcoming->Key(), 0, 1);
+      }
+      a++;
+    }
+  }
+}
+
 template <class Comparator>
 typename InlineSkipList<Comparator>::Node*
 InlineSkipList<Comparator>::FindLessThan(const char* key,
@@ -11,6 +11,7 @@
 
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 #include "memory/concurrent_arena.h"
 #include "rocksdb/env.h"
@@ -212,6 +213,53 @@ TEST_F(InlineSkipTest, InsertAndLookup) {
   }
 }
 
+TEST_F(InlineSkipTest, MultiSeek) {
+  const int N = 2000;
+  const int R = 5000;
+  using List = InlineSkipList<TestComparator>;
+  Random rnd(301);
+  std::set<Key> keys;
+  ConcurrentArena arena;
+  TestComparator cmp;
+  List list(cmp, &arena);
+  for (int i = 0; i < N; i++) {
+    Key key = rnd.Next() % R;
+    if (keys.insert(key).second) {
+      char* buf = list.AllocateKey(sizeof(Key));
+      memcpy(buf, &key, sizeof(Key));
+      list.Insert(buf);
+    }
+  }
+
+  // Batches of all sizes, with targets in random order and past the end
+  for (size_t num = 0; num <= List::kMaxMultiSeek; num++) {
+    for (int batch = 0; batch < 50; batch++) {
+      std::vector<Key> targets;
+      std::vector<const char*> encoded;
+      std::vector<List::Iterator> iters;
+      std::vector<List::Iterator*> iter_ptrs;
+      for (size_t i = 0; i < num; i++) {
+        targets.push_back(rnd.Next() % (R + 10));
+        iters.emplace_back(&list);
+      }
+      for (size_t i = 0; i < num; i++) {
+        encoded.push_back(Encode(&targets[i]));
+        iter_ptrs.push_back(&iters[i]);
+      }
+      list.MultiSeek(num, encoded.data(), iter_ptrs.data());
+      for (size_t i = 0; i < num; i++) {
+        auto model_iter = keys.lower_bound(targets[i]);
+        if (model_iter == keys.end()) {
+          ASSERT_FALSE(iters[i].Valid());
+        } else {
+          ASSERT_TRUE(iters[i].Valid());
+          ASSERT_EQ(*model_iter, Decode(iters[i].key()));
+        }
+      }
+    }
+  }
+}
+
 TEST_F(InlineSkipTest, InsertWithHint_Sequential) {
   const int N = 100000;
   Arena arena;
@@ -61,10 +61,17 @@ DEFINE_string(memtablerep, "skiplist",
               "  more details. Options:\n"
               "\tskiplist            -- backed by a skiplist\n"
               "\tvector              -- backed by an std::vector\n"
+              "\tbtree               -- backed by a B+-tree\n"
+              "\tpartitionedskiplist -- backed by hash partitioned skip "
+              "lists\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
               "\tcuckoo              -- backed by a cuckoo hash table");
 
+DEFINE_int64(num_partitions, 16,
+             "num_partitions parameter to pass into "
+             "PartitionedSkipListFactory");
+
 DEFINE_int64(bucket_count, 1000000,
              "bucket_count parameter to pass into NewHashSkiplistRepFactory or "
              "NewHashLinkListRepFactory");
@@ -583,6 +590,11 @@ int main(int argc, char** argv) {
     factory.reset(new ROCKSDB_NAMESPACE::SkipListFactory);
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new ROCKSDB_NAMESPACE::VectorRepFactory);
+  } else if (FLAGS_memtablerep == "btree") {
+    factory.reset(new ROCKSDB_NAMESPACE::BTreeRepFactory);
+  } else if (FLAGS_memtablerep == "partitionedskiplist") {
+    factory.reset(new ROCKSDB_NAMESPACE::PartitionedSkipListFactory(
+        static_cast<size_t>(FLAGS_num_partitions)));
   } else if (FLAGS_memtablerep == "hashskiplist" ||
              FLAGS_memtablerep == "prefix_hash") {
     factory.reset(ROCKSDB_NAMESPACE::NewHashSkipListRepFactory(
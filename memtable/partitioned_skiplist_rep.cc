@@ -0,0 +1,348 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "memtable/inlineskiplist.h"
+#include "rocksdb/memtablerep.h"
+#include "rocksdb/utilities/options_type.h"
+#include "util/hash.h"
+#include "util/heap.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// A memtable of independent skip lists, one per hash partition of the user
+// keys. All the entries of a user key are in the same partition, so point
+// lookups only search one skip list, and iterators merge all of them.
+class PartitionedSkipListRep : public MemTableRep {
+  using SkipList = InlineSkipList<const MemTableRep::KeyComparator&>;
+
+  // Padded so that inserts into neighbouring partitions don't false share
+  struct Partition {
+    Partition(const MemTableRep::KeyComparator& compare, Allocator* allocator)
+        : list(compare, allocator) {}
+
+    ALIGN_AS(CACHE_LINE_SIZE) SkipList list;
+  };
+
+  std::vector<std::unique_ptr<Partition>> partitions_;
+  const MemTableRep::KeyComparator& cmp_;
+  const size_t ts_sz_;
+
+ public:
+  PartitionedSkipListRep(const MemTableRep::KeyComparator& compare,
+                         Allocator* allocator, size_t num_partitions)
+      : MemTableRep(allocator),
+        cmp_(compare),
+        ts_sz_(compare.timestamp_size()) {
+    assert(num_partitions > 0);
+    partitions_.reserve(num_partitions);
+    for (size_t i = 0; i < num_partitions; i++) {
+      partitions_.emplace_back(new Partition(compare, allocator));
+    }
+  }
+
+  // The partition of the key is not known yet, but the nodes of all skip
+  // lists are alike, as they have the same maximum height and branching.
+  KeyHandle Allocate(const size_t len, char** buf) override {
+    *buf = partitions_[0]->list.AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  // Insert key into its partition.
+  // REQUIRES: nothing that compares equal to key is currently in the list.
+  void Insert(KeyHandle handle) override {
+    char* key = static_cast<char*>(handle);
+    ListFor(key).Insert(key);
+  }
+
+  bool InsertKey(KeyHandle handle) override {
+    char* key = static_cast<char*>(handle);
+    return ListFor(key).Insert(key);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    char* key = static_cast<char*>(handle);
+    ListFor(key).InsertConcurrently(key);
+  }
+
+  bool InsertKeyConcurrently(KeyHandle handle) override {
+    char* key = static_cast<char*>(handle);
+    return ListFor(key).InsertConcurrently(key);
+  }
+
+  // Returns true iff an entry that compares equal to key is in the list.
+  bool Contains(const char* key) const override {
+    return ListFor(key).Contains(key);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    SkipList::Iterator iter(&ListForUserKey(k.user_key()));
+    for (iter.Seek(k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  Status GetAndValidate(const LookupKey& k, void* callback_args,
+                        bool (*callback_func)(void* arg, const char* entry),
+                        bool allow_data_in_errors) override {
+    SkipList::Iterator iter(&ListForUserKey(k.user_key()));
+    Status status =
+        iter.SeekAndValidate(k.memtable_key().data(), allow_data_in_errors);
+    for (; iter.Valid() && status.ok() &&
+           callback_func(callback_args, iter.key());
+         status = iter.NextAndValidate(allow_data_in_errors)) {
+    }
+    return status;
+  }
+
+  uint64_t ApproximateNumEntries(const Slice& start_ikey,
+                                 const Slice& end_ikey) override {
+    uint64_t num_entries = 0;
+    for (auto& partition : partitions_) {
+      num_entries +=
+          partition->list.ApproximateNumEntries(start_ikey, end_ikey);
+    }
+    return num_entries;
+  }
+
+  ~PartitionedSkipListRep() override = default;
+
+  // Merges the skip lists of all partitions in key order. There is a single
+  // entry for each key over all partitions.
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const PartitionedSkipListRep& rep)
+        : cmp_(rep.cmp_),
+          min_heap_(MinIteratorComparator(&cmp_)),
+          max_heap_(MaxIteratorComparator(&cmp_)) {
+      children_.reserve(rep.partitions_.size());
+      for (auto& partition : rep.partitions_) {
+        children_.emplace_back(&partition->list);
+      }
+    }
+
+    ~Iterator() override = default;
+
+    // Returns true iff the iterator is positioned at a valid node.
+    bool Valid() const override { return current_ != nullptr; }
+
+    // Returns the key at the current position.
+    // REQUIRES: Valid()
+    const char* key() const override {
+      assert(Valid());
+      return current_->key();
+    }
+
+    // Advances to the next position.
+    // REQUIRES: Valid()
+    void Next() override {
+      assert(Valid());
+      if (!forward_) {
+        SwitchToForward();
+      }
+      current_->Next();
+      if (current_->Valid()) {
+        min_heap_.replace_top(current_);
+      } else {
+        min_heap_.pop();
+      }
+      current_ = min_heap_.empty() ? nullptr : min_heap_.top();
+    }
+
+    // Advances to the previous position.
+    // REQUIRES: Valid()
+    void Prev() override {
+      assert(Valid());
+      if (forward_) {
+        SwitchToBackward();
+      }
+      current_->Prev();
+      if (current_->Valid()) {
+        max_heap_.replace_top(current_);
+      } else {
+        max_heap_.pop();
+      }
+      current_ = max_heap_.empty() ? nullptr : max_heap_.top();
+    }
+
+    // Advance to the first entry with a key >= target
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      const char* target =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+      for (auto& child : children_) {
+        child.Seek(target);
+      }
+      BuildMinHeap();
+    }
+
+    // Retreat to the last entry with a key <= target
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override {
+      const char* target =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+      for (auto& child : children_) {
+        child.SeekForPrev(target);
+      }
+      BuildMaxHeap();
+    }
+
+    // Position at the first entry in the memtable.
+    // Final state of iterator is Valid() iff the memtable is not empty.
+    void SeekToFirst() override {
+      for (auto& child : children_) {
+        child.SeekToFirst();
+      }
+      BuildMinHeap();
+    }
+
+    // Position at the last entry in the memtable.
+    // Final state of iterator is Valid() iff the memtable is not empty.
+    void SeekToLast() override {
+      for (auto& child : children_) {
+        child.SeekToLast();
+      }
+      BuildMaxHeap();
+    }
+
+   private:
+    class MinIteratorComparator {
+     public:
+      explicit MinIteratorComparator(const MemTableRep::KeyComparator* cmp)
+          : cmp_(cmp) {}
+      bool operator()(SkipList::Iterator* a, SkipList::Iterator* b) const {
+        return (*cmp_)(a->key(), b->key()) > 0;
+      }
+
+     private:
+      const MemTableRep::KeyComparator* cmp_;
+    };
+
+    class MaxIteratorComparator {
+     public:
+      explicit MaxIteratorComparator(const MemTableRep::KeyComparator* cmp)
+          : cmp_(cmp) {}
+      bool operator()(SkipList::Iterator* a, SkipList::Iterator* b) const {
+        return (*cmp_)(a->key(), b->key()) < 0;
+      }
+
+     private:
+      const MemTableRep::KeyComparator* cmp_;
+    };
+
+    void BuildMinHeap() {
+      forward_ = true;
+      min_heap_.clear();
+      for (auto& child : children_) {
+        if (child.Valid()) {
+          min_heap_.push(&child);
+        }
+      }
+      current_ = min_heap_.empty() ? nullptr : min_heap_.top();
+    }
+
+    void BuildMaxHeap() {
+      forward_ = false;
+      max_heap_.clear();
+      for (auto& child : children_) {
+        if (child.Valid()) {
+          max_heap_.push(&child);
+        }
+      }
+      current_ = max_heap_.empty() ? nullptr : max_heap_.top();
+    }
+
+    // Keys are unique over all partitions, so positioning the other children
+    // at or after key() puts them strictly after it.
+    void SwitchToForward() {
+      const char* target = current_->key();
+      for (auto& child : children_) {
+        if (&child != current_) {
+          child.Seek(target);
+        }
+      }
+      BuildMinHeap();
+      assert(current_ != nullptr && current_->key() == target);
+    }
+
+    void SwitchToBackward() {
+      const char* target = current_->key();
+      for (auto& child : children_) {
+        if (&child != current_) {
+          child.SeekForPrev(target);
+        }
+      }
+      BuildMaxHeap();
+      assert(current_ != nullptr && current_->key() == target);
+    }
+
+    const MemTableRep::KeyComparator& cmp_;
+    std::vector<SkipList::Iterator> children_;
+    BinaryHeap<SkipList::Iterator*, MinIteratorComparator> min_heap_;
+    BinaryHeap<SkipList::Iterator*, MaxIteratorComparator> max_heap_;
+    SkipList::Iterator* current_ = nullptr;
+    bool forward_ = true;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem =
+        arena ? arena->AllocateAligned(sizeof(PartitionedSkipListRep::Iterator))
+              : operator new(sizeof(PartitionedSkipListRep::Iterator));
+    return new (mem) PartitionedSkipListRep::Iterator(*this);
+  }
+
+ private:
+  // Timestamps are left out so that all versions of a user key are together
+  SkipList& ListForUserKey(const Slice& user_key) const {
+    Slice key = StripTimestampFromUserKey(user_key, ts_sz_);
+    return partitions_[GetSliceRangedNPHash(key, partitions_.size())]->list;
+  }
+
+  SkipList& ListFor(const char* key) const {
+    return ListForUserKey(UserKey(key));
+  }
+};
+}  // namespace
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    partitioned_skiplist_factory_info = {
+        {"num_partitions",
+         {0, OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kDontSerialize /*Since it is part of the ID*/}},
+};
+
+PartitionedSkipListFactory::PartitionedSkipListFactory(size_t num_partitions)
+    : num_partitions_(num_partitions) {
+  RegisterOptions("PartitionedSkipListFactoryOptions", &num_partitions_,
+                  &partitioned_skiplist_factory_info);
+}
+
+std::string PartitionedSkipListFactory::GetId() const {
+  std::string id = Name();
+  id.append(":").append(std::to_string(num_partitions_));
+  return id;
+}
+
+MemTableRep* PartitionedSkipListFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  return new PartitionedSkipListRep(compare, allocator,
+                                    std::max(num_partitions_, size_t{1}));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,111 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// MemTablePointLookupIndex is a hash index from user keys to the newest
+// entry of each key in a memtable, kept next to the memtable rep so that a
+// point lookup of a recently written key takes a hash probe instead of a
+// search of the rep. See
+// AdvancedColumnFamilyOptions::memtable_point_lookup_index_ratio.
+//
+// Each bucket holds one entry, of one of the keys hashing to it, so keys
+// evict each other and the index is only a cache of the newest entries. The
+// entries are the encoded memtable entries (see MemTable::Add()), which live
+// as long as the memtable.
+//
+// Thread safety -------------
+//
+// Add can be called concurrently with other adds and with lookups, and
+// neither takes a lock. An entry takes over a bucket only if its sequence
+// number is no lower than that of the entry in the bucket, so the sequence
+// numbers in a bucket never decrease. Since no two entries of a key have the
+// same sequence number, this guarantees that when a bucket holds an entry
+// of a key, no entry of the key with a higher sequence number was added
+// before it, even when the entries of a key are added out of order by
+// concurrent writers.
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+
+#include "db/dbformat.h"
+#include "memory/allocator.h"
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Logger;
+
+class MemTablePointLookupIndex {
+ public:
+  // Allocates `num_buckets` buckets from `allocator`.
+  MemTablePointLookupIndex(Allocator* allocator, uint32_t num_buckets,
+                           size_t huge_page_size, Logger* logger)
+      : num_buckets_(num_buckets) {
+    assert(num_buckets_ > 0);
+    const size_t size = sizeof(std::atomic<const char*>) * num_buckets_;
+    char* raw = allocator->AllocateAligned(size, huge_page_size, logger);
+    memset(raw, 0, size);
+    static_assert(sizeof(std::atomic<const char*>) == sizeof(const char*),
+                  "Expecting zero-space-overhead atomic");
+    buckets_ = reinterpret_cast<std::atomic<const char*>*>(raw);
+  }
+
+  // No copying allowed
+  MemTablePointLookupIndex(const MemTablePointLookupIndex&) = delete;
+  void operator=(const MemTablePointLookupIndex&) = delete;
+
+  // Records `entry`, the encoded memtable entry of `user_key` at `seq`, if it
+  // is no older than the entry in its bucket.
+  void Add(const Slice& user_key, SequenceNumber seq, const char* entry) {
+    std::atomic<const char*>& bucket = buckets_[GetBucket(user_key)];
+    const char* current = bucket.load(std::memory_order_acquire);
+    while (current == nullptr || GetEntrySequence(current) <= seq) {
+      if (bucket.compare_exchange_weak(current, entry,
+                                       std::memory_order_release,
+                                       std::memory_order_acquire)) {
+        return;
+      }
+    }
+  }
+
+  // Returns the newest entry of `user_key` added, or nullptr if the bucket
+  // of the key holds another key.
+  const char* Get(const Slice& user_key) const {
+    const char* entry =
+        buckets_[GetBucket(user_key)].load(std::memory_order_acquire);
+    if (entry == nullptr) {
+      return nullptr;
+    }
+    uint32_t key_length = 0;
+    const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+    assert(key_length >= 8);
+    if (Slice(key_ptr, key_length - 8) != user_key) {
+      return nullptr;
+    }
+    return entry;
+  }
+
+ private:
+  uint32_t GetBucket(const Slice& user_key) const {
+    return FastRange32(GetSliceHash(user_key), num_buckets_);
+  }
+
+  static SequenceNumber GetEntrySequence(const char* entry) {
+    uint32_t key_length = 0;
+    const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+    assert(key_length >= 8);
+    return DecodeFixed64(key_ptr + key_length - 8) >> 8;
+  }
+
+  const uint32_t num_buckets_;
+  std::atomic<const char*>* buckets_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -3,6 +3,7 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 //
+#include <array>
 #include <random>
 
 #include "db/memtable.h"
@@ -10,6 +11,7 @@
 #include "memtable/inlineskiplist.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/utilities/options_type.h"
+#include "util/autovector.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -92,6 +94,34 @@ class SkipListRep : public MemTableRep {
     }
   }
 
+  void MultiGet(size_t num_keys, const LookupKey* const* keys,
+                void* const* callback_args,
+                bool (*callback_func)(void* arg, const char* entry)) override {
+    using SkipList = InlineSkipList<const MemTableRep::KeyComparator&>;
+    for (size_t start = 0; start < num_keys; start += SkipList::kMaxMultiSeek) {
+      const size_t num =
+          std::min(num_keys - start, size_t{SkipList::kMaxMultiSeek});
+      autovector<SkipList::Iterator, SkipList::kMaxMultiSeek> iters;
+      std::array<SkipList::Iterator*, SkipList::kMaxMultiSeek> iter_ptrs;
+      std::array<const char*, SkipList::kMaxMultiSeek> targets;
+      for (size_t i = 0; i < num; i++) {
+        iters.emplace_back(&skip_list_);
+        targets[i] = keys[start + i]->memtable_key().data();
+      }
+      // All iterators fit on the stack, so their addresses are stable
+      for (size_t i = 0; i < num; i++) {
+        iter_ptrs[i] = &iters[i];
+      }
+      skip_list_.MultiSeek(num, targets.data(), iter_ptrs.data());
+      for (size_t i = 0; i < num; i++) {
+        void* arg = callback_args[start + i];
+        for (SkipList::Iterator& iter = iters[i];
+             iter.Valid() && callback_func(arg, iter.key()); iter.Next()) {
+        }
+      }
+    }
+  }
+
   Status GetAndValidate(const LookupKey& k, void* callback_args,
                         bool (*callback_func)(void* arg, const char* entry),
                         bool allow_data_in_errors) override {
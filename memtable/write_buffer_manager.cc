@@ -9,6 +9,7 @@
 
 #include "rocksdb/write_buffer_manager.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "cache/cache_entry_roles.h"
@@ -27,7 +28,8 @@ WriteBufferManager::WriteBufferManager(size_t _buffer_size,
       memory_active_(0),
       cache_res_mgr_(nullptr),
       allow_stall_(allow_stall),
-      stall_active_(false) {
+      stall_active_(false),
+      cost_aware_flush_(false) {
   if (cache) {
     // Memtable's memory usage tends to fluctuate frequently
     // therefore we set delayed_decrease = true to save some dummy entry
@@ -182,4 +184,45 @@ void WriteBufferManager::RemoveDBFromQueue(StallInterface* wbm_stall) {
   wbm_stall->Signal();
 }
 
+bool WriteBufferManager::PickFlushVictim(const void* db, size_t mutable_memory,
+                                         double score) {
+  std::lock_guard<std::mutex> lock(flush_candidates_mu_);
+  FlushCandidate& self = flush_candidates_[db];
+  self.score = score;
+  self.passed_over = false;
+  if (memory_usage() < buffer_size()) {
+    FlushCandidate* best = &self;
+    for (auto& candidate : flush_candidates_) {
+      if (!candidate.second.passed_over &&
+          candidate.second.score > best->score) {
+        best = &candidate.second;
+      }
+    }
+    if (best != &self) {
+      best->passed_over = true;
+      return false;
+    }
+    const size_t num_others = flush_candidates_.size() - 1;
+    const size_t total_memory = mutable_memtable_memory_usage();
+    const size_t others_memory =
+        total_memory - std::min(total_memory, mutable_memory);
+    if (num_others > 0 && mutable_memory * num_others < others_memory) {
+      return false;
+    }
+  }
+  // Its best memtable is about to be flushed, and what is left is unknown
+  self.score = 0;
+  return true;
+}
+
+void WriteBufferManager::AddFlushCandidate(const void* db) {
+  std::lock_guard<std::mutex> lock(flush_candidates_mu_);
+  flush_candidates_.emplace(db, FlushCandidate());
+}
+
+void WriteBufferManager::RemoveFlushCandidate(const void* db) {
+  std::lock_guard<std::mutex> lock(flush_candidates_mu_);
+  flush_candidates_.erase(db);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -78,6 +78,33 @@ TEST_F(WriteBufferManagerTest, ShouldFlush) {
   ASSERT_FALSE(wbf->ShouldFlush());
 }
 
+TEST_F(WriteBufferManagerTest, PickFlushVictim) {
+  WriteBufferManager wbf(10 * 1024 * 1024);
+  wbf.SetCostAwareFlush(true);
+  // Only their addresses are used
+  int db1 = 0;
+  int db2 = 0;
+  wbf.AddFlushCandidate(&db1);
+  wbf.ReserveMem(9 * 1024 * 1024);
+
+  // db2 holds less memory than db1, so it leaves the flush to db1
+  ASSERT_FALSE(wbf.PickFlushVictim(&db2, 1 * 1024 * 1024, 10));
+  // But db2 reported a better memtable to flush, so db1 leaves it to db2
+  ASSERT_FALSE(wbf.PickFlushVictim(&db1, 8 * 1024 * 1024, 5));
+  // Until db2 reports again, it is passed over
+  ASSERT_TRUE(wbf.PickFlushVictim(&db1, 8 * 1024 * 1024, 5));
+
+  // Over the buffer size, the DB flushes its own memtable
+  wbf.ReserveMem(2 * 1024 * 1024);
+  ASSERT_TRUE(wbf.PickFlushVictim(&db2, 1 * 1024 * 1024, 10));
+
+  // Alone, too
+  wbf.FreeMem(2 * 1024 * 1024);
+  wbf.RemoveFlushCandidate(&db1);
+  ASSERT_TRUE(wbf.PickFlushVictim(&db2, 1 * 1024 * 1024, 10));
+  wbf.RemoveFlushCandidate(&db2);
+}
+
 class ChargeWriteBufferTest : public testing::Test {};
 
 TEST_F(ChargeWriteBufferTest, Basic) {
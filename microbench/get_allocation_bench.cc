@@ -0,0 +1,138 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Counts the heap allocations of Get(), which replaces the global operator
+// new of the binary, so it is kept apart from the other micro-benchmarks.
+
+#ifndef OS_WIN
+#include <unistd.h>
+#endif  // ! OS_WIN
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "file/filename.h"
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+
+namespace {
+thread_local uint64_t num_allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  num_allocations++;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t /*size*/) noexcept { std::free(p); }
+
+namespace ROCKSDB_NAMESPACE {
+
+static std::string Key(uint64_t i, size_t key_size) {
+  std::string key = std::to_string(i);
+  key.resize(key_size, 'k');
+  return key;
+}
+
+// Heap allocations per Get() of existing keys, after a first Get() of each
+// key warms up the buffers being reused. Memtable hits must not allocate.
+static void GetAllocations(benchmark::State& state) {
+  const size_t key_size = static_cast<size_t>(state.range(0));
+  const bool from_block_cache = state.range(1);
+  const uint64_t num_keys = 1000;
+
+  std::string db_path;
+  Status s = Env::Default()->GetTestDirectory(&db_path);
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+  std::string db_name = db_path + kFilePathSeparator + "GetAllocations" +
+                        std::to_string(getpid());
+  Options options;
+  options.create_if_missing = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(64 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyDB(db_name, options);
+  std::unique_ptr<DB> db;
+  s = DB::Open(options, db_name, &db);
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+  for (uint64_t i = 0; i < num_keys && s.ok(); i++) {
+    s = db->Put(WriteOptions(), Key(i, key_size), std::string(100, 'v'));
+  }
+  if (s.ok() && from_block_cache) {
+    s = db->Flush(FlushOptions());
+  }
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+
+  std::vector<std::string> keys;
+  for (uint64_t i = 0; i < num_keys; i++) {
+    keys.push_back(Key(i, key_size));
+  }
+  ReadOptions read_options;
+  PinnableSlice value;
+  for (const auto& key : keys) {
+    s = db->Get(read_options, db->DefaultColumnFamily(), key, &value);
+    value.Reset();
+  }
+
+  uint64_t allocations = 0;
+  size_t i = 0;
+  for (auto _ : state) {
+    const uint64_t before = num_allocations;
+    s = db->Get(read_options, db->DefaultColumnFamily(), keys[i], &value);
+    allocations += num_allocations - before;
+    value.Reset();
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+    i = (i + 1) % keys.size();
+  }
+  state.counters["allocs_per_get"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  if (!from_block_cache && allocations > 0) {
+    state.SkipWithError("Get() from the memtable allocated");
+  }
+
+  s = db->Close();
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+  }
+  DestroyDB(db_name, options);
+}
+
+static void GetAllocationsArguments(benchmark::internal::Benchmark* b) {
+  for (int64_t key_size : {16, 256, 1024}) {
+    for (bool from_block_cache : {false, true}) {
+      b->Args({key_size, from_block_cache});
+    }
+  }
+  b->ArgNames({"key_size", "from_block_cache"});
+}
+
+BENCHMARK(GetAllocations)->Iterations(100000)->Apply(GetAllocationsArguments);
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
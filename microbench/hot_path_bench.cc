@@ -0,0 +1,389 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Micro-benchmarks of the primitives on the hot paths of reads and writes,
+// which catch their regressions well below the noise of db_bench.
+
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "db/dbformat.h"
+#include "memory/arena.h"
+#include "memtable/inlineskiplist.h"
+#include "rocksdb/advanced_cache.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/write_batch.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_builder.h"
+#include "table/block_based/filter_policy_internal.h"
+#include "table/block_based/mock_block_based_table.h"
+#include "table/merging_iterator.h"
+#include "util/crc32c.h"
+#include "util/random.h"
+#include "util/vector_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Fixed size keys, sorted like their numbers
+std::string MakeKey(uint64_t i) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "key%016" PRIu64, i);
+  return buf;
+}
+
+std::string MakeInternalKey(uint64_t i) {
+  return InternalKey(MakeKey(i), /*seq=*/1, kTypeValue).Encode().ToString();
+}
+
+// The skip list stores 8-byte unsigned integers, as in inlineskiplist_test
+struct U64Comparator {
+  using DecodedType = uint64_t;
+
+  static DecodedType decode_key(const char* b) {
+    uint64_t rv;
+    memcpy(&rv, b, sizeof(rv));
+    return rv;
+  }
+
+  int operator()(const char* a, const char* b) const {
+    return (*this)(a, decode_key(b));
+  }
+
+  int operator()(const char* a, const DecodedType b) const {
+    const uint64_t a_key = decode_key(a);
+    return a_key < b ? -1 : (a_key > b ? 1 : 0);
+  }
+};
+
+using U64InlineSkipList = InlineSkipList<U64Comparator>;
+
+void InsertU64(U64InlineSkipList* list, uint64_t key) {
+  char* buf = list->AllocateKey(sizeof(key));
+  memcpy(buf, &key, sizeof(key));
+  list->Insert(buf);
+}
+}  // namespace
+
+// benchmark arguments:
+// 0. number of entries already in the skip list
+static void InlineSkipListInsert(benchmark::State& state) {
+  const uint64_t num_entries = state.range(0);
+  U64Comparator cmp;
+  std::unique_ptr<Arena> arena;
+  std::unique_ptr<U64InlineSkipList> list;
+  Random64 rnd(301);
+  uint64_t inserted = num_entries;
+  for (auto _ : state) {
+    if (inserted == num_entries) {
+      state.PauseTiming();
+      list.reset();
+      arena.reset(new Arena());
+      list.reset(new U64InlineSkipList(cmp, arena.get()));
+      for (uint64_t i = 0; i < num_entries; i++) {
+        InsertU64(list.get(), rnd.Next());
+      }
+      inserted = 0;
+      state.ResumeTiming();
+    }
+    // Random keys are unique with high probability
+    InsertU64(list.get(), rnd.Next());
+    inserted++;
+  }
+}
+
+BENCHMARK(InlineSkipListInsert)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// benchmark arguments:
+// 0. number of entries in the skip list
+static void InlineSkipListSeek(benchmark::State& state) {
+  const uint64_t num_entries = state.range(0);
+  U64Comparator cmp;
+  Arena arena;
+  U64InlineSkipList list(cmp, &arena);
+  Random64 rnd(301);
+  for (uint64_t i = 0; i < num_entries; i++) {
+    InsertU64(&list, rnd.Next());
+  }
+
+  U64InlineSkipList::Iterator iter(&list);
+  uint64_t found = 0;
+  for (auto _ : state) {
+    const uint64_t target = rnd.Next();
+    iter.Seek(reinterpret_cast<const char*>(&target));
+    found += iter.Valid();
+  }
+  benchmark::DoNotOptimize(found);
+}
+
+BENCHMARK(InlineSkipListSeek)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// benchmark arguments:
+// 0. block restart interval
+// 1. number of entries in the block
+static void BlockIterSeek(benchmark::State& state) {
+  const int restart_interval = static_cast<int>(state.range(0));
+  const uint64_t num_entries = state.range(1);
+  BlockBuilder builder(restart_interval);
+  for (uint64_t i = 0; i < num_entries; i++) {
+    builder.Add(MakeInternalKey(i * 2), std::string(100, 'v'));
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  Block block(std::move(contents));
+  std::unique_ptr<DataBlockIter> iter(block.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+
+  std::vector<std::string> targets;
+  for (uint64_t i = 0; i < num_entries * 2; i++) {
+    targets.push_back(MakeInternalKey(i));
+  }
+  Random64 rnd(301);
+  uint64_t found = 0;
+  for (auto _ : state) {
+    iter->Seek(targets[rnd.Uniform(targets.size())]);
+    found += iter->Valid();
+  }
+  benchmark::DoNotOptimize(found);
+}
+
+static void BlockIterSeekArguments(benchmark::internal::Benchmark* b) {
+  for (int64_t restart_interval : {1, 16}) {
+    for (int64_t num_entries : {32, 256}) {
+      b->Args({restart_interval, num_entries});
+    }
+  }
+  b->ArgNames({"restart_interval", "num_entries"});
+}
+
+BENCHMARK(BlockIterSeek)->Apply(BlockIterSeekArguments);
+
+// benchmark arguments:
+// 0. number of child iterators, whose keys interleave
+static void MergingIteratorNext(benchmark::State& state) {
+  const int num_children = static_cast<int>(state.range(0));
+  const uint64_t kNumEntries = 1 << 16;
+  InternalKeyComparator icmp(BytewiseComparator());
+  std::vector<InternalIterator*> children;
+  for (int c = 0; c < num_children; c++) {
+    std::vector<std::string> keys;
+    std::vector<std::string> values;
+    for (uint64_t i = c; i < kNumEntries; i += num_children) {
+      keys.push_back(MakeInternalKey(i));
+      values.emplace_back("v");
+    }
+    children.push_back(
+        new VectorIterator(std::move(keys), std::move(values), &icmp));
+  }
+  std::unique_ptr<InternalIterator> iter(
+      NewMergingIterator(&icmp, children.data(), num_children));
+
+  iter->SeekToFirst();
+  for (auto _ : state) {
+    if (!iter->Valid()) {
+      state.PauseTiming();
+      iter->SeekToFirst();
+      state.ResumeTiming();
+    }
+    iter->Next();
+  }
+}
+
+BENCHMARK(MergingIteratorNext)->Arg(2)->Arg(8)->Arg(32);
+
+// The batched query of a full filter, as in FullFilterBlockReader::MayMatch()
+// for MultiGet.
+//
+// benchmark arguments:
+// 0. filter impl (like filter_bench -impl)
+// 1. number of keys per query
+static void FilterKeysMayMatch(benchmark::State& state) {
+  const uint64_t kNumEntries = 1 << 16;
+  auto filter = BloomLikeFilterPolicy::Create(
+      BloomLikeFilterPolicy::GetAllFixedImpls().at(state.range(0)),
+      /*bits_per_key=*/10);
+  auto tester = std::make_unique<mock::MockBlockBasedTableTester>(filter);
+  std::unique_ptr<FilterBitsBuilder> builder(tester->GetBuilder());
+  for (uint64_t i = 0; i < kNumEntries; i++) {
+    builder->AddKey(MakeKey(i * 2));
+  }
+  std::unique_ptr<const char[]> owner;
+  Slice data = builder->Finish(&owner);
+  std::unique_ptr<FilterBitsReader> reader(filter->GetFilterBitsReader(data));
+
+  // Half of the keys are in the filter
+  const int num_keys = static_cast<int>(state.range(1));
+  std::vector<std::string> keys;
+  for (uint64_t i = 0; i < 2 * kNumEntries; i++) {
+    keys.push_back(MakeKey(i));
+  }
+  // The queries cycle through kNumQueries random batches
+  const size_t kNumQueries = 1024;
+  Random64 rnd(301);
+  std::vector<Slice> key_slices(kNumQueries * num_keys);
+  std::vector<Slice*> key_ptrs(kNumQueries * num_keys);
+  for (size_t i = 0; i < key_slices.size(); i++) {
+    key_slices[i] = keys[rnd.Uniform(keys.size())];
+    key_ptrs[i] = &key_slices[i];
+  }
+  std::unique_ptr<bool[]> may_match(new bool[num_keys]);
+  uint64_t matches = 0;
+  size_t query = 0;
+  for (auto _ : state) {
+    reader->MayMatch(num_keys, &key_ptrs[query * num_keys], may_match.get());
+    for (int i = 0; i < num_keys; i++) {
+      matches += may_match[i];
+    }
+    query = (query + 1) % kNumQueries;
+  }
+  benchmark::DoNotOptimize(matches);
+  state.SetItemsProcessed(state.iterations() * num_keys);
+}
+
+static void FilterKeysMayMatchArguments(benchmark::internal::Benchmark* b) {
+  const auto kImplCount =
+      static_cast<int>(BloomLikeFilterPolicy::GetAllFixedImpls().size());
+  for (int filter_impl = 0; filter_impl < kImplCount; ++filter_impl) {
+    for (int64_t num_keys : {1, 32}) {
+      b->Args({filter_impl, num_keys});
+    }
+  }
+  b->ArgNames({"filter_impl", "num_keys"});
+}
+
+BENCHMARK(FilterKeysMayMatch)->Apply(FilterKeysMayMatchArguments);
+
+// Lookups of the entries of a HyperClockCache, i.e. of ClockCacheShard
+//
+// benchmark arguments:
+// 0. number of entries in the cache
+static void HyperClockCacheLookup(benchmark::State& state) {
+  const uint64_t num_entries = state.range(0);
+  const size_t kCharge = 1024;
+  HyperClockCacheOptions opts(num_entries * kCharge * 2,
+                              /*estimated_entry_charge=*/kCharge,
+                              /*num_shard_bits=*/4);
+  std::shared_ptr<Cache> cache = opts.MakeSharedCache();
+  // 16-byte keys, like the cache keys of blocks
+  std::vector<std::string> keys;
+  for (uint64_t i = 0; i < num_entries; i++) {
+    std::string key(16, '\0');
+    EncodeFixed64(&key[0], i);
+    EncodeFixed64(&key[8], i * 0x9E3779B97F4A7C15ULL);
+    keys.push_back(key);
+    Status s =
+        cache->Insert(key, /*obj=*/nullptr, &kNoopCacheItemHelper, kCharge);
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      return;
+    }
+  }
+
+  Random64 rnd(301);
+  uint64_t hits = 0;
+  for (auto _ : state) {
+    Cache::Handle* handle = cache->Lookup(keys[rnd.Uniform(keys.size())]);
+    if (handle != nullptr) {
+      hits++;
+      cache->Release(handle);
+    }
+  }
+  state.counters["hit_pct"] = benchmark::Counter(
+      static_cast<double>(hits * 100), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(HyperClockCacheLookup)->Arg(1 << 10)->Arg(1 << 20);
+
+// benchmark arguments:
+// 0. value size
+static void WriteBatchEncode(benchmark::State& state) {
+  const size_t value_size = static_cast<size_t>(state.range(0));
+  const uint64_t kNumEntries = 100;
+  std::vector<std::string> keys;
+  for (uint64_t i = 0; i < kNumEntries; i++) {
+    keys.push_back(MakeKey(i));
+  }
+  const std::string value(value_size, 'v');
+  WriteBatch batch;
+  for (auto _ : state) {
+    batch.Clear();
+    for (const auto& key : keys) {
+      Status s = batch.Put(key, value);
+      benchmark::DoNotOptimize(s);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumEntries);
+  state.SetBytesProcessed(state.iterations() * batch.GetDataSize());
+}
+
+BENCHMARK(WriteBatchEncode)->Arg(16)->Arg(1024);
+
+namespace {
+class CountingHandler : public WriteBatch::Handler {
+ public:
+  Status PutCF(uint32_t /*column_family_id*/, const Slice& key,
+               const Slice& value) override {
+    bytes_ += key.size() + value.size();
+    return Status::OK();
+  }
+
+  uint64_t bytes_ = 0;
+};
+}  // namespace
+
+// benchmark arguments:
+// 0. value size
+static void WriteBatchDecode(benchmark::State& state) {
+  const size_t value_size = static_cast<size_t>(state.range(0));
+  const uint64_t kNumEntries = 100;
+  const std::string value(value_size, 'v');
+  WriteBatch batch;
+  for (uint64_t i = 0; i < kNumEntries; i++) {
+    Status s = batch.Put(MakeKey(i), value);
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      return;
+    }
+  }
+  CountingHandler handler;
+  for (auto _ : state) {
+    Status s = batch.Iterate(&handler);
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+  }
+  benchmark::DoNotOptimize(handler.bytes_);
+  state.SetItemsProcessed(state.iterations() * kNumEntries);
+  state.SetBytesProcessed(state.iterations() * batch.GetDataSize());
+}
+
+BENCHMARK(WriteBatchDecode)->Arg(16)->Arg(1024);
+
+// benchmark arguments:
+// 0. data size
+static void Crc32c(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  Random rnd(301);
+  const std::string data = rnd.RandomString(static_cast<int>(size));
+  uint32_t crc = 0;
+  for (auto _ : state) {
+    crc = crc32c::Extend(crc, data.data(), data.size());
+  }
+  benchmark::DoNotOptimize(crc);
+  state.SetBytesProcessed(state.iterations() * size);
+  state.SetLabel(crc32c::IsFastCrc32Supported());
+}
+
+BENCHMARK(Crc32c)->Arg(64)->Arg(4 << 10)->Arg(64 << 10);
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 
 #include "monitoring/instrumented_mutex.h"
 
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/thread_status_util.h"
 #include "rocksdb/system_clock.h"
@@ -28,6 +29,7 @@ void InstrumentedMutex::Lock() {
   PERF_CONDITIONAL_TIMER_FOR_MUTEX_GUARD(
       db_mutex_lock_nanos, stats_code_ == DB_MUTEX_WAIT_MICROS,
       stats_for_report(clock_, stats_), stats_code_);
+  OPERATION_SPAN_GUARD(MutexWait);
   LockInternal();
 }
 
@@ -0,0 +1,31 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "monitoring/operation_tracer.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+thread_local OperationTraceContext op_trace_context;
+
+void OperationTraceGuard::Finish() {
+  OperationTraceContext& ctx = op_trace_context;
+  const uint64_t duration_nanos = ctx.clock->NowNanos() - ctx.start_nanos;
+  // Operations of the listeners are not traced as part of this one
+  ctx.clock = nullptr;
+  if (duration_nanos < threshold_nanos_) {
+    return;
+  }
+  SlowOperationInfo info;
+  info.type = type_;
+  info.duration_nanos = duration_nanos;
+  info.spans.assign(ctx.spans, ctx.spans + ctx.num_spans);
+  info.num_dropped_spans = ctx.num_dropped_spans;
+  for (const auto& listener : *listeners_) {
+    listener->OnSlowOperation(info);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,116 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rocksdb/listener.h"
+#include "rocksdb/system_clock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The spans recorded by the thread for the operation it is tracing, if any
+struct OperationTraceContext {
+  static constexpr uint32_t kMaxSpans = 64;
+
+  // Set while an operation is traced
+  SystemClock* clock = nullptr;
+  uint64_t start_nanos = 0;
+  // Number of spans open
+  uint32_t depth = 0;
+  uint32_t num_spans = 0;
+  uint32_t num_dropped_spans = 0;
+  OperationSpan spans[kMaxSpans];
+};
+
+extern thread_local OperationTraceContext op_trace_context;
+
+// Traces the operation it guards with the spans of its stages, when
+// `threshold_micros` is not zero and there are listeners, and reports it to
+// EventListener::OnSlowOperation() if it takes at least `threshold_micros`.
+// Operations nested in a traced one are not traced on their own.
+class OperationTraceGuard {
+ public:
+  OperationTraceGuard(
+      uint64_t threshold_micros, SystemClock* clock,
+      const std::vector<std::shared_ptr<EventListener>>& listeners,
+      SlowOperationType type)
+      : type_(type) {
+    if (threshold_micros == 0 || listeners.empty() ||
+        op_trace_context.clock != nullptr) {
+      return;
+    }
+    threshold_nanos_ = threshold_micros * 1000;
+    listeners_ = &listeners;
+    op_trace_context.clock = clock;
+    op_trace_context.start_nanos = clock->NowNanos();
+    op_trace_context.depth = 0;
+    op_trace_context.num_spans = 0;
+    op_trace_context.num_dropped_spans = 0;
+  }
+
+  ~OperationTraceGuard() {
+    if (listeners_ != nullptr) {
+      Finish();
+    }
+  }
+
+  OperationTraceGuard(const OperationTraceGuard&) = delete;
+  OperationTraceGuard& operator=(const OperationTraceGuard&) = delete;
+
+ private:
+  void Finish();
+
+  const SlowOperationType type_;
+  // Set when the operation is traced
+  const std::vector<std::shared_ptr<EventListener>>* listeners_ = nullptr;
+  uint64_t threshold_nanos_ = 0;
+};
+
+// Records a span named `name`, which must be a string literal, for the stage
+// of the traced operation of the thread that it guards, if any.
+class OperationSpanGuard {
+ public:
+  explicit OperationSpanGuard(const char* name) {
+    OperationTraceContext& ctx = op_trace_context;
+    if (ctx.clock == nullptr) {
+      return;
+    }
+    if (ctx.num_spans == OperationTraceContext::kMaxSpans) {
+      ctx.num_dropped_spans++;
+      return;
+    }
+    span_ = &ctx.spans[ctx.num_spans++];
+    span_->name = name;
+    span_->depth = ctx.depth++;
+    start_nanos_ = ctx.clock->NowNanos();
+    span_->start_nanos = start_nanos_ - ctx.start_nanos;
+  }
+
+  ~OperationSpanGuard() {
+    if (span_ != nullptr) {
+      OperationTraceContext& ctx = op_trace_context;
+      span_->duration_nanos = ctx.clock->NowNanos() - start_nanos_;
+      ctx.depth--;
+    }
+  }
+
+  OperationSpanGuard(const OperationSpanGuard&) = delete;
+  OperationSpanGuard& operator=(const OperationSpanGuard&) = delete;
+
+ private:
+  OperationSpan* span_ = nullptr;
+  uint64_t start_nanos_ = 0;
+};
+
+// Declare a span for the rest of the enclosing scope
+#define OPERATION_SPAN_GUARD(name) \
+  OperationSpanGuard operation_span_guard_##name(#name)
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,124 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+
+#include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_level_imp.h"
+#include "rocksdb/statistics.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The operations whose PerfContext breakdowns are sampled with
+// DBOptions::perf_context_sample_rate
+enum class PerfSampledOp {
+  kGet,
+  kMultiGet,
+  kSeek,
+  kWrite,
+};
+
+// Runs one in `sample_rate` of the operations of the calling thread that it
+// guards with at least PerfLevel::kEnableTimeExceptForMutex, and records the
+// time spent in each part of a sampled operation into the histograms of
+// `stats` for the type of the operation. Must be constructed before the perf
+// timers of the operation.
+class PerfContextSampler {
+ public:
+  PerfContextSampler(uint32_t sample_rate, Statistics* stats,
+                     PerfSampledOp op) {
+#if !defined(NPERF_CONTEXT)
+    if (sample_rate == 0 || stats == nullptr ||
+        !Random::GetTLSInstance()->OneIn(sample_rate)) {
+      return;
+    }
+    stats_ = stats;
+    metrics_ = GetMetrics(op);
+    for (size_t i = 0; i < kNumMetrics; i++) {
+      start_[i] = perf_context.*metrics_[i].field;
+    }
+    prev_perf_level_ = perf_level;
+    if (perf_level < PerfLevel::kEnableTimeExceptForMutex) {
+      perf_level = PerfLevel::kEnableTimeExceptForMutex;
+    }
+#else
+    (void)sample_rate;
+    (void)stats;
+    (void)op;
+#endif  // !NPERF_CONTEXT
+  }
+
+  ~PerfContextSampler() {
+#if !defined(NPERF_CONTEXT)
+    if (stats_ == nullptr) {
+      return;
+    }
+    perf_level = prev_perf_level_;
+    for (size_t i = 0; i < kNumMetrics; i++) {
+      RecordInHistogram(stats_, metrics_[i].histogram,
+                        perf_context.*metrics_[i].field - start_[i]);
+    }
+#endif  // !NPERF_CONTEXT
+  }
+
+  PerfContextSampler(const PerfContextSampler&) = delete;
+  PerfContextSampler& operator=(const PerfContextSampler&) = delete;
+
+ private:
+  static constexpr size_t kNumMetrics = 3;
+
+  struct Metric {
+    uint64_t PerfContext::*field;
+    Histograms histogram;
+  };
+
+  static const Metric* GetMetrics(PerfSampledOp op) {
+    static const Metric kGetMetrics[kNumMetrics] = {
+        {&PerfContext::get_from_memtable_time, SAMPLED_GET_MEMTABLE_NANOS},
+        {&PerfContext::get_from_output_files_time, SAMPLED_GET_FILES_NANOS},
+        {&PerfContext::block_read_time, SAMPLED_GET_BLOCK_READ_NANOS},
+    };
+    static const Metric kMultiGetMetrics[kNumMetrics] = {
+        {&PerfContext::get_from_memtable_time,
+         SAMPLED_MULTIGET_MEMTABLE_NANOS},
+        {&PerfContext::get_from_output_files_time,
+         SAMPLED_MULTIGET_FILES_NANOS},
+        {&PerfContext::block_read_time, SAMPLED_MULTIGET_BLOCK_READ_NANOS},
+    };
+    static const Metric kSeekMetrics[kNumMetrics] = {
+        {&PerfContext::seek_on_memtable_time, SAMPLED_SEEK_MEMTABLE_NANOS},
+        {&PerfContext::seek_child_seek_time, SAMPLED_SEEK_CHILD_NANOS},
+        {&PerfContext::block_read_time, SAMPLED_SEEK_BLOCK_READ_NANOS},
+    };
+    static const Metric kWriteMetrics[kNumMetrics] = {
+        {&PerfContext::write_wal_time, SAMPLED_WRITE_WAL_NANOS},
+        {&PerfContext::write_memtable_time, SAMPLED_WRITE_MEMTABLE_NANOS},
+        {&PerfContext::write_delay_time, SAMPLED_WRITE_DELAY_NANOS},
+    };
+    switch (op) {
+      case PerfSampledOp::kGet:
+        return kGetMetrics;
+      case PerfSampledOp::kMultiGet:
+        return kMultiGetMetrics;
+      case PerfSampledOp::kSeek:
+        return kSeekMetrics;
+      case PerfSampledOp::kWrite:
+        return kWriteMetrics;
+    }
+    return kGetMetrics;
+  }
+
+  // Set when the operation is sampled
+  Statistics* stats_ = nullptr;
+  const Metric* metrics_ = nullptr;
+  uint64_t start_[kNumMetrics] = {};
+  PerfLevel prev_perf_level_ = PerfLevel::kDisable;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -273,6 +273,13 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
      "rocksdb.file.read.corruption.retry.success.count"},
     {NUMBER_WBWI_INGEST, "rocksdb.number.wbwi.ingest"},
+    {WARMUP_BLOCKS_INSERTED, "rocksdb.warmup.blocks.inserted"},
+    {WARMUP_BYTES_READ, "rocksdb.warmup.bytes.read"},
+    {WARMUP_BLOCKS_ALREADY_CACHED, "rocksdb.warmup.blocks.already.cached"},
+    {WARMUP_BLOCKS_SKIPPED, "rocksdb.warmup.blocks.skipped"},
+    {WARMUP_BYTES_SKIPPED, "rocksdb.warmup.bytes.skipped"},
+    {WARMUP_RELOCATED_BLOBS_INSERTED,
+     "rocksdb.warmup.relocated.blobs.inserted"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -345,6 +352,23 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
      "rocksdb.table.open.prefetch.tail.read.bytes"},
     {NUM_OP_PER_TRANSACTION, "rocksdb.num.op.per.transaction"},
+    {WARMUP_MICROS, "rocksdb.warmup.micros"},
+    {SAMPLED_GET_MEMTABLE_NANOS, "rocksdb.sampled.get.memtable.nanos"},
+    {SAMPLED_GET_FILES_NANOS, "rocksdb.sampled.get.files.nanos"},
+    {SAMPLED_GET_BLOCK_READ_NANOS, "rocksdb.sampled.get.block.read.nanos"},
+    {SAMPLED_MULTIGET_MEMTABLE_NANOS,
+     "rocksdb.sampled.multiget.memtable.nanos"},
+    {SAMPLED_MULTIGET_FILES_NANOS, "rocksdb.sampled.multiget.files.nanos"},
+    {SAMPLED_MULTIGET_BLOCK_READ_NANOS,
+     "rocksdb.sampled.multiget.block.read.nanos"},
+    {SAMPLED_SEEK_MEMTABLE_NANOS, "rocksdb.sampled.seek.memtable.nanos"},
+    {SAMPLED_SEEK_CHILD_NANOS, "rocksdb.sampled.seek.child.nanos"},
+    {SAMPLED_SEEK_BLOCK_READ_NANOS, "rocksdb.sampled.seek.block.read.nanos"},
+    {SAMPLED_WRITE_WAL_NANOS, "rocksdb.sampled.write.wal.nanos"},
+    {SAMPLED_WRITE_MEMTABLE_NANOS, "rocksdb.sampled.write.memtable.nanos"},
+    {SAMPLED_WRITE_DELAY_NANOS, "rocksdb.sampled.write.delay.nanos"},
+    {MANIFEST_WRITE_QUEUE_MICROS, "rocksdb.manifest.write.queue.micros"},
+    {MANIFEST_WRITE_GROUP_SIZE, "rocksdb.manifest.write.group.size"},
 };
 
 std::shared_ptr<Statistics> CreateDBStatistics() {
@@ -567,4 +591,46 @@ bool StatisticsImpl::HistEnabledForType(uint32_t type) const {
   return type < HISTOGRAM_ENUM_MAX;
 }
 
+ColumnFamilyStatistics::ColumnFamilyStatistics(
+    std::shared_ptr<Statistics> cf_stats, std::shared_ptr<Statistics> db_stats)
+    : cf_stats_(std::move(cf_stats)), db_stats_(std::move(db_stats)) {
+  assert(cf_stats_ != nullptr);
+  // Each object filters the updates by its own stats level
+  StatsLevel stats_level = cf_stats_->get_stats_level();
+  if (db_stats_ != nullptr) {
+    stats_level = std::max(stats_level, db_stats_->get_stats_level());
+  }
+  set_stats_level(stats_level);
+}
+
+void ColumnFamilyStatistics::recordTick(uint32_t ticker_type, uint64_t count) {
+  cf_stats_->recordTick(ticker_type, count);
+  if (db_stats_ != nullptr) {
+    db_stats_->recordTick(ticker_type, count);
+  }
+}
+
+void ColumnFamilyStatistics::reportTimeToHistogram(uint32_t histogram_type,
+                                                   uint64_t time) {
+  cf_stats_->reportTimeToHistogram(histogram_type, time);
+  if (db_stats_ != nullptr) {
+    db_stats_->reportTimeToHistogram(histogram_type, time);
+  }
+}
+
+void ColumnFamilyStatistics::recordInHistogram(uint32_t histogram_type,
+                                               uint64_t value) {
+  if (cf_stats_->HistEnabledForType(histogram_type)) {
+    cf_stats_->recordInHistogram(histogram_type, value);
+  }
+  if (db_stats_ != nullptr && db_stats_->HistEnabledForType(histogram_type)) {
+    db_stats_->recordInHistogram(histogram_type, value);
+  }
+}
+
+bool ColumnFamilyStatistics::HistEnabledForType(uint32_t type) const {
+  return cf_stats_->HistEnabledForType(type) ||
+         (db_stats_ != nullptr && db_stats_->HistEnabledForType(type));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -111,6 +111,63 @@ class StatisticsImpl : public Statistics {
   void setTickerCountLocked(uint32_t ticker_type, uint64_t count);
 };
 
+// The statistics of a column family with ColumnFamilyOptions::cf_statistics.
+// Updates are recorded into the statistics of the column family, and into
+// those of the DB if any, while reads return the former.
+class ColumnFamilyStatistics : public Statistics {
+ public:
+  ColumnFamilyStatistics(std::shared_ptr<Statistics> cf_stats,
+                         std::shared_ptr<Statistics> db_stats);
+  const char* Name() const override { return kClassName(); }
+  static const char* kClassName() { return "ColumnFamilyStatistics"; }
+
+  uint64_t getTickerCount(uint32_t ticker_type) const override {
+    return cf_stats_->getTickerCount(ticker_type);
+  }
+  void histogramData(uint32_t histogram_type,
+                     HistogramData* const data) const override {
+    cf_stats_->histogramData(histogram_type, data);
+  }
+  std::string getHistogramString(uint32_t histogram_type) const override {
+    return cf_stats_->getHistogramString(histogram_type);
+  }
+
+  // Only the tickers of the column family are set or reset
+  void setTickerCount(uint32_t ticker_type, uint64_t count) override {
+    cf_stats_->setTickerCount(ticker_type, count);
+  }
+  uint64_t getAndResetTickerCount(uint32_t ticker_type) override {
+    return cf_stats_->getAndResetTickerCount(ticker_type);
+  }
+  void recordTick(uint32_t ticker_type, uint64_t count) override;
+  void reportTimeToHistogram(uint32_t histogram_type, uint64_t time) override;
+  void measureTime(uint32_t histogram_type, uint64_t time) override {
+    recordInHistogram(histogram_type, time);
+  }
+  void recordInHistogram(uint32_t histogram_type, uint64_t value) override;
+
+  Status Reset() override { return cf_stats_->Reset(); }
+  std::string ToString() const override { return cf_stats_->ToString(); }
+  bool getTickerMap(std::map<std::string, uint64_t>* stats_map) const override {
+    return cf_stats_->getTickerMap(stats_map);
+  }
+  bool HistEnabledForType(uint32_t type) const override;
+
+  const Customizable* Inner() const override { return cf_stats_.get(); }
+
+  const std::shared_ptr<Statistics>& GetColumnFamilyStatistics() const {
+    return cf_stats_;
+  }
+  const std::shared_ptr<Statistics>& GetDBStatistics() const {
+    return db_stats_;
+  }
+
+ private:
+  std::shared_ptr<Statistics> cf_stats_;
+  // Can be nullptr
+  std::shared_ptr<Statistics> db_stats_;
+};
+
 // Utility functions
 inline void RecordInHistogram(Statistics* statistics, uint32_t histogram_type,
                               uint64_t value) {
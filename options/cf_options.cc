@@ -12,6 +12,7 @@
 #include <string>
 
 #include "logging/logging.h"
+#include "monitoring/statistics_impl.h"
 #include "options/configurable_helper.h"
 #include "options/db_options.h"
 #include "options/options_helper.h"
@@ -24,6 +25,7 @@
 #include "rocksdb/convenience.h"
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
+#include "rocksdb/memory_allocator.h"
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/options.h"
 #include "rocksdb/table.h"
@@ -276,6 +278,46 @@ static std::unordered_map<std::string, OptionTypeInfo>
           OptionVerificationType::kNormal, OptionTypeFlags::kMutable}},
 };
 
+static std::unordered_map<std::string, CompactionWarmupMode>
+    compaction_warmup_mode_string_map = {
+        {"kDisabled", CompactionWarmupMode::kDisabled},
+        {"kOutputFiles", CompactionWarmupMode::kOutputFiles},
+        {"kHotKeyRanges", CompactionWarmupMode::kHotKeyRanges}};
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    compaction_warmup_policy_type_info = {
+        {"mode", OptionTypeInfo::Enum<CompactionWarmupMode>(
+                     offsetof(struct CompactionWarmupPolicy, mode),
+                     &compaction_warmup_mode_string_map,
+                     OptionTypeFlags::kMutable)},
+        {"max_output_level",
+         {offsetof(struct CompactionWarmupPolicy, max_output_level),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"max_bytes_per_compaction",
+         {offsetof(struct CompactionWarmupPolicy, max_bytes_per_compaction),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"stop_at_cache_capacity",
+         {offsetof(struct CompactionWarmupPolicy, stop_at_cache_capacity),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"warm_index_and_filter_partitions",
+         {offsetof(struct CompactionWarmupPolicy,
+                   warm_index_and_filter_partitions),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"secondary_cache_min_output_level",
+         {offsetof(struct CompactionWarmupPolicy,
+                   secondary_cache_min_output_level),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"warm_relocated_blobs",
+         {offsetof(struct CompactionWarmupPolicy, warm_relocated_blobs),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+};
+
 static std::unordered_map<std::string, OptionTypeInfo>
     fifo_compaction_options_type_info = {
         {"max_table_files_size",
@@ -293,6 +335,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionOptionsFIFO, allow_compaction),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"time_window_seconds",
+         {offsetof(struct CompactionOptionsFIFO, time_window_seconds),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"file_temperature_age_thresholds",
          OptionTypeInfo::Vector<struct FileTemperatureAge>(
              offsetof(struct CompactionOptionsFIFO,
@@ -347,6 +393,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(class CompactionOptionsUniversal, incremental),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"incremental_avoid_full_compaction",
+         {offsetof(class CompactionOptionsUniversal,
+                   incremental_avoid_full_compaction),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"allow_trivial_move",
          {offsetof(class CompactionOptionsUniversal, allow_trivial_move),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -580,6 +631,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, default_write_temperature),
           OptionType::kTemperature, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"last_level_promotion_reads",
+         {offsetof(struct MutableCFOptions, last_level_promotion_reads),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"enable_blob_files",
          {offsetof(struct MutableCFOptions, enable_blob_files),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -588,6 +643,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, min_blob_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"blob_separation_percent",
+         {offsetof(struct MutableCFOptions, blob_separation_percent),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"blob_file_size",
          {offsetof(struct MutableCFOptions, blob_file_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -609,6 +668,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    blob_garbage_collection_force_threshold),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"blob_garbage_collection_file_threshold",
+         {offsetof(struct MutableCFOptions,
+                   blob_garbage_collection_file_threshold),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"blob_compaction_readahead_size",
          {offsetof(struct MutableCFOptions, blob_compaction_readahead_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -642,6 +706,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, memtable_protection_bytes_per_key),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"memtable_protection_verify_one_in",
+         {offsetof(struct MutableCFOptions, memtable_protection_verify_one_in),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"bottommost_file_compaction_delay",
          {offsetof(struct MutableCFOptions, bottommost_file_compaction_delay),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
@@ -716,6 +784,15 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, memtable_avg_op_scan_flush_trigger),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"compaction_warmup_policy",
+         OptionTypeInfo::Struct(
+             "compaction_warmup_policy", &compaction_warmup_policy_type_info,
+             offsetof(struct MutableCFOptions, compaction_warmup_policy),
+             OptionVerificationType::kNormal, OptionTypeFlags::kMutable)},
+        {"allow_flush_below_level0",
+         {offsetof(struct MutableCFOptions, allow_flush_below_level0),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -741,6 +818,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableCFOptions, inplace_update_support),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"inplace_merge_support",
+         {offsetof(struct ImmutableCFOptions, inplace_merge_support),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"level_compaction_dynamic_level_bytes",
          {offsetof(struct ImmutableCFOptions,
                    level_compaction_dynamic_level_bytes),
@@ -889,6 +970,44 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableCFOptions, persist_user_defined_timestamps),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kCompareLoose}},
+        {"memtable_tier_allocator",
+         OptionTypeInfo::AsCustomSharedPtr<MemoryAllocator>(
+             offsetof(struct ImmutableCFOptions, memtable_tier_allocator),
+             OptionVerificationType::kByName, OptionTypeFlags::kAllowNull)},
+        {"cf_statistics",
+         OptionTypeInfo::AsCustomSharedPtr<Statistics>(
+             // As DBOptions::statistics
+             offsetof(struct ImmutableCFOptions, cf_statistics),
+             OptionVerificationType::kNormal,
+             OptionTypeFlags::kCompareNever | OptionTypeFlags::kDontSerialize |
+                 OptionTypeFlags::kAllowNull)},
+        {"memtable_tier_min_entry_size",
+         {offsetof(struct ImmutableCFOptions, memtable_tier_min_entry_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"memtable_value_compression",
+         {offsetof(struct ImmutableCFOptions, memtable_value_compression),
+          OptionType::kCompressionType, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"memtable_value_compression_min_size",
+         {offsetof(struct ImmutableCFOptions,
+                   memtable_value_compression_min_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"memtable_point_lookup_index_ratio",
+         {offsetof(struct ImmutableCFOptions,
+                   memtable_point_lookup_index_ratio),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"bottommost_hash_index",
+         {offsetof(struct ImmutableCFOptions, bottommost_hash_index),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"level_compaction_move_edge_overlaps",
+         {offsetof(struct ImmutableCFOptions,
+                   level_compaction_move_edge_overlaps),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kCFOptionsName = "ColumnFamilyOptions";
@@ -1010,6 +1129,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
           cf_options.max_write_buffer_size_to_maintain),
       inplace_update_support(cf_options.inplace_update_support),
       inplace_callback(cf_options.inplace_callback),
+      inplace_merge_support(cf_options.inplace_merge_support),
       memtable_factory(cf_options.memtable_factory),
       table_properties_collector_factories(
           cf_options.table_properties_collector_factories),
@@ -1028,7 +1148,18 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
       sst_partitioner_factory(cf_options.sst_partitioner_factory),
       blob_cache(cf_options.blob_cache),
       persist_user_defined_timestamps(
-          cf_options.persist_user_defined_timestamps) {}
+          cf_options.persist_user_defined_timestamps),
+      memtable_tier_allocator(cf_options.memtable_tier_allocator),
+      memtable_tier_min_entry_size(cf_options.memtable_tier_min_entry_size),
+      cf_statistics(cf_options.cf_statistics),
+      memtable_value_compression(cf_options.memtable_value_compression),
+      memtable_value_compression_min_size(
+          cf_options.memtable_value_compression_min_size),
+      memtable_point_lookup_index_ratio(
+          cf_options.memtable_point_lookup_index_ratio),
+      bottommost_hash_index(cf_options.bottommost_hash_index),
+      level_compaction_move_edge_overlaps(
+          cf_options.level_compaction_move_edge_overlaps) {}
 
 ImmutableOptions::ImmutableOptions() : ImmutableOptions(Options()) {}
 
@@ -1037,19 +1168,47 @@ ImmutableOptions::ImmutableOptions(const Options& options)
 
 ImmutableOptions::ImmutableOptions(const DBOptions& db_options,
                                    const ColumnFamilyOptions& cf_options)
-    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {}
+    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {
+  SetUpColumnFamilyStatistics();
+}
 
 ImmutableOptions::ImmutableOptions(const DBOptions& db_options,
                                    const ImmutableCFOptions& cf_options)
-    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {}
+    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {
+  SetUpColumnFamilyStatistics();
+}
 
 ImmutableOptions::ImmutableOptions(const ImmutableDBOptions& db_options,
                                    const ColumnFamilyOptions& cf_options)
-    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {}
+    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {
+  SetUpColumnFamilyStatistics();
+}
 
 ImmutableOptions::ImmutableOptions(const ImmutableDBOptions& db_options,
                                    const ImmutableCFOptions& cf_options)
-    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {}
+    : ImmutableDBOptions(db_options), ImmutableCFOptions(cf_options) {
+  SetUpColumnFamilyStatistics();
+}
+
+void ImmutableOptions::SetUpColumnFamilyStatistics() {
+  if (cf_statistics == nullptr) {
+    return;
+  }
+  std::shared_ptr<Statistics> db_statistics = statistics;
+  if (db_statistics != nullptr &&
+      db_statistics->IsInstanceOf(ColumnFamilyStatistics::kClassName())) {
+    // Copied from the ImmutableOptions of a column family
+    auto* cf_stats =
+        static_cast_with_check<ColumnFamilyStatistics>(db_statistics.get());
+    if (cf_stats->GetColumnFamilyStatistics() == cf_statistics) {
+      return;
+    }
+    db_statistics = cf_stats->GetDBStatistics();
+  }
+  statistics =
+      std::make_shared<ColumnFamilyStatistics>(cf_statistics, db_statistics);
+  stats = statistics.get();
+}
 
 // Multiple two operands. If they overflow, return op1.
 uint64_t MultiplyCheckOverflow(uint64_t op1, double op2) {
@@ -1169,6 +1328,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  preserve_internal_time_seconds);
   ROCKS_LOG_INFO(log, "                   paranoid_memory_checks: %d",
                  paranoid_memory_checks);
+  ROCKS_LOG_INFO(log, "        memtable_protection_verify_one_in: %" PRIu32,
+                 memtable_protection_verify_one_in);
   std::string result;
   char buf[10];
   for (const auto m : max_bytes_for_level_multiplier_additional) {
@@ -1201,6 +1362,27 @@ void MutableCFOptions::Dump(Logger* log) const {
                  memtable_op_scan_flush_trigger);
   ROCKS_LOG_INFO(log, "         memtable_avg_op_scan_flush_trigger: %" PRIu32,
                  memtable_avg_op_scan_flush_trigger);
+  ROCKS_LOG_INFO(log, "compaction_warmup_policy.mode : %d",
+                 static_cast<int>(compaction_warmup_policy.mode));
+  ROCKS_LOG_INFO(log, "compaction_warmup_policy.max_output_level : %d",
+                 compaction_warmup_policy.max_output_level);
+  ROCKS_LOG_INFO(log,
+                 "compaction_warmup_policy.max_bytes_per_compaction : %" PRIu64,
+                 compaction_warmup_policy.max_bytes_per_compaction);
+  ROCKS_LOG_INFO(log, "compaction_warmup_policy.stop_at_cache_capacity : %d",
+                 compaction_warmup_policy.stop_at_cache_capacity);
+  ROCKS_LOG_INFO(log,
+                 "compaction_warmup_policy.warm_index_and_filter_partitions "
+                 ": %d",
+                 compaction_warmup_policy.warm_index_and_filter_partitions);
+  ROCKS_LOG_INFO(log,
+                 "compaction_warmup_policy.secondary_cache_min_output_level "
+                 ": %d",
+                 compaction_warmup_policy.secondary_cache_min_output_level);
+  ROCKS_LOG_INFO(log, "compaction_warmup_policy.warm_relocated_blobs : %d",
+                 compaction_warmup_policy.warm_relocated_blobs);
+  ROCKS_LOG_INFO(log, "                 allow_flush_below_level0: %d",
+                 allow_flush_below_level0);
 
   // Universal Compaction Options
   ROCKS_LOG_INFO(log, "compaction_options_universal.size_ratio : %d",
@@ -1224,18 +1406,27 @@ void MutableCFOptions::Dump(Logger* log) const {
       static_cast<int>(compaction_options_universal.allow_trivial_move));
   ROCKS_LOG_INFO(log, "compaction_options_universal.incremental        : %d",
                  static_cast<int>(compaction_options_universal.incremental));
+  ROCKS_LOG_INFO(
+      log,
+      "compaction_options_universal.incremental_avoid_full_compaction : %d",
+      static_cast<int>(
+          compaction_options_universal.incremental_avoid_full_compaction));
 
   // FIFO Compaction Options
   ROCKS_LOG_INFO(log, "compaction_options_fifo.max_table_files_size : %" PRIu64,
                  compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_INFO(log, "compaction_options_fifo.allow_compaction : %d",
                  compaction_options_fifo.allow_compaction);
+  ROCKS_LOG_INFO(log, "compaction_options_fifo.time_window_seconds : %" PRIu64,
+                 compaction_options_fifo.time_window_seconds);
 
   // Blob file related options
   ROCKS_LOG_INFO(log, "                        enable_blob_files: %s",
                  enable_blob_files ? "true" : "false");
   ROCKS_LOG_INFO(log, "                            min_blob_size: %" PRIu64,
                  min_blob_size);
+  ROCKS_LOG_INFO(log, "                  blob_separation_percent: %" PRIu32,
+                 blob_separation_percent);
   ROCKS_LOG_INFO(log, "                           blob_file_size: %" PRIu64,
                  blob_file_size);
   ROCKS_LOG_INFO(log, "                    blob_compression_type: %s",
@@ -1246,6 +1437,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  blob_garbage_collection_age_cutoff);
   ROCKS_LOG_INFO(log, "  blob_garbage_collection_force_threshold: %f",
                  blob_garbage_collection_force_threshold);
+  ROCKS_LOG_INFO(log, "   blob_garbage_collection_file_threshold: %f",
+                 blob_garbage_collection_file_threshold);
   ROCKS_LOG_INFO(log, "           blob_compaction_readahead_size: %" PRIu64,
                  blob_compaction_readahead_size);
   ROCKS_LOG_INFO(log, "                 blob_file_starting_level: %d",
@@ -1256,6 +1449,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                      : "disable");
   ROCKS_LOG_INFO(log, "                   last_level_temperature: %d",
                  static_cast<int>(last_level_temperature));
+  ROCKS_LOG_INFO(log, "               last_level_promotion_reads: %" PRIu64,
+                 last_level_promotion_reads);
 }
 
 MutableCFOptions::MutableCFOptions(const Options& options)
@@ -49,6 +49,8 @@ struct ImmutableCFOptions {
                                    Slice delta_value,
                                    std::string* merged_value);
 
+  bool inplace_merge_support;
+
   std::shared_ptr<MemTableRepFactory> memtable_factory;
 
   Options::TablePropertiesCollectorFactories
@@ -82,6 +84,22 @@ struct ImmutableCFOptions {
   std::shared_ptr<Cache> blob_cache;
 
   bool persist_user_defined_timestamps;
+
+  std::shared_ptr<MemoryAllocator> memtable_tier_allocator;
+
+  size_t memtable_tier_min_entry_size;
+
+  std::shared_ptr<Statistics> cf_statistics;
+
+  CompressionType memtable_value_compression;
+
+  size_t memtable_value_compression_min_size;
+
+  double memtable_point_lookup_index_ratio;
+
+  bool bottommost_hash_index;
+
+  bool level_compaction_move_edge_overlaps;
 };
 
 struct ImmutableOptions : public ImmutableDBOptions, public ImmutableCFOptions {
@@ -99,6 +117,10 @@ struct ImmutableOptions : public ImmutableDBOptions, public ImmutableCFOptions {
 
   ImmutableOptions(const ImmutableDBOptions& db_options,
                    const ColumnFamilyOptions& cf_options);
+
+ private:
+  // With cf_statistics, makes statistics and stats record into it as well
+  void SetUpColumnFamilyStatistics();
 };
 
 struct MutableCFOptions {
@@ -143,6 +165,7 @@ struct MutableCFOptions {
         preserve_internal_time_seconds(options.preserve_internal_time_seconds),
         enable_blob_files(options.enable_blob_files),
         min_blob_size(options.min_blob_size),
+        blob_separation_percent(options.blob_separation_percent),
         blob_file_size(options.blob_file_size),
         blob_compression_type(options.blob_compression_type),
         enable_blob_garbage_collection(options.enable_blob_garbage_collection),
@@ -150,6 +173,8 @@ struct MutableCFOptions {
             options.blob_garbage_collection_age_cutoff),
         blob_garbage_collection_force_threshold(
             options.blob_garbage_collection_force_threshold),
+        blob_garbage_collection_file_threshold(
+            options.blob_garbage_collection_file_threshold),
         blob_compaction_readahead_size(options.blob_compaction_readahead_size),
         blob_file_starting_level(options.blob_file_starting_level),
         prepopulate_blob_cache(options.prepopulate_blob_cache),
@@ -164,8 +189,11 @@ struct MutableCFOptions {
         compression_manager(options.compression_manager),
         last_level_temperature(options.last_level_temperature),
         default_write_temperature(options.default_write_temperature),
+        last_level_promotion_reads(options.last_level_promotion_reads),
         memtable_protection_bytes_per_key(
             options.memtable_protection_bytes_per_key),
+        memtable_protection_verify_one_in(
+            options.memtable_protection_verify_one_in),
         block_protection_bytes_per_key(options.block_protection_bytes_per_key),
         paranoid_memory_checks(options.paranoid_memory_checks),
         sample_for_compression(
@@ -177,7 +205,9 @@ struct MutableCFOptions {
         uncache_aggressiveness(options.uncache_aggressiveness),
         memtable_op_scan_flush_trigger(options.memtable_op_scan_flush_trigger),
         memtable_avg_op_scan_flush_trigger(
-            options.memtable_avg_op_scan_flush_trigger) {
+            options.memtable_avg_op_scan_flush_trigger),
+        compaction_warmup_policy(options.compaction_warmup_policy),
+        allow_flush_below_level0(options.allow_flush_below_level0) {
     RefreshDerivedOptions(options.num_levels, options.compaction_style);
   }
 
@@ -211,11 +241,13 @@ struct MutableCFOptions {
         preserve_internal_time_seconds(0),
         enable_blob_files(false),
         min_blob_size(0),
+        blob_separation_percent(0),
         blob_file_size(0),
         blob_compression_type(kNoCompression),
         enable_blob_garbage_collection(false),
         blob_garbage_collection_age_cutoff(0.0),
         blob_garbage_collection_force_threshold(0.0),
+        blob_garbage_collection_file_threshold(0.0),
         blob_compaction_readahead_size(0),
         blob_file_starting_level(0),
         prepopulate_blob_cache(PrepopulateBlobCache::kDisable),
@@ -226,7 +258,9 @@ struct MutableCFOptions {
         bottommost_compression(kDisableCompressionOption),
         last_level_temperature(Temperature::kUnknown),
         default_write_temperature(Temperature::kUnknown),
+        last_level_promotion_reads(0),
         memtable_protection_bytes_per_key(0),
+        memtable_protection_verify_one_in(1),
         block_protection_bytes_per_key(0),
         paranoid_memory_checks(false),
         sample_for_compression(0),
@@ -234,7 +268,9 @@ struct MutableCFOptions {
         bottommost_file_compaction_delay(0),
         uncache_aggressiveness(0),
         memtable_op_scan_flush_trigger(0),
-        memtable_avg_op_scan_flush_trigger(0) {}
+        memtable_avg_op_scan_flush_trigger(0),
+        compaction_warmup_policy(),
+        allow_flush_below_level0(false) {}
 
   explicit MutableCFOptions(const Options& options);
 
@@ -314,11 +350,13 @@ struct MutableCFOptions {
   // Blob file related options
   bool enable_blob_files;
   uint64_t min_blob_size;
+  uint32_t blob_separation_percent;
   uint64_t blob_file_size;
   CompressionType blob_compression_type;
   bool enable_blob_garbage_collection;
   double blob_garbage_collection_age_cutoff;
   double blob_garbage_collection_force_threshold;
+  double blob_garbage_collection_file_threshold;
   uint64_t blob_compaction_readahead_size;
   int blob_file_starting_level;
   PrepopulateBlobCache prepopulate_blob_cache;
@@ -334,7 +372,9 @@ struct MutableCFOptions {
   std::shared_ptr<CompressionManager> compression_manager;
   Temperature last_level_temperature;
   Temperature default_write_temperature;
+  uint64_t last_level_promotion_reads;
   uint32_t memtable_protection_bytes_per_key;
+  uint32_t memtable_protection_verify_one_in;
   uint8_t block_protection_bytes_per_key;
   bool paranoid_memory_checks;
 
@@ -345,6 +385,8 @@ struct MutableCFOptions {
   uint32_t uncache_aggressiveness;
   uint32_t memtable_op_scan_flush_trigger;
   uint32_t memtable_avg_op_scan_flush_trigger;
+  CompactionWarmupPolicy compaction_warmup_policy;
+  bool allow_flush_below_level0;
 
   // Derived options
   // Per-level target file size.
@@ -97,6 +97,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableDBOptions, stats_persist_period_sec),
           OptionType::kUInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"auto_tune_period_sec",
+         {offsetof(struct MutableDBOptions, auto_tune_period_sec),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"stats_history_buffer_size",
          {offsetof(struct MutableDBOptions, stats_history_buffer_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
@@ -120,6 +124,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableDBOptions, compaction_readahead_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"compaction_readahead_budget",
+         {offsetof(struct MutableDBOptions, compaction_readahead_budget),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"max_background_flushes",
          {offsetof(struct MutableDBOptions, max_background_flushes),
           OptionType::kInt, OptionVerificationType::kNormal,
@@ -171,6 +179,28 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    use_direct_io_for_flush_and_compaction),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"background_writes_for_flush_and_compaction",
+         {offsetof(struct ImmutableDBOptions,
+                   background_writes_for_flush_and_compaction),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"use_direct_io_for_wal",
+         {offsetof(struct ImmutableDBOptions, use_direct_io_for_wal),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_async_io",
+         {offsetof(struct ImmutableDBOptions, compaction_async_io),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"subcompaction_ranges_per_thread",
+         {offsetof(struct ImmutableDBOptions, subcompaction_ranges_per_thread),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"prioritize_compactions_by_read_amp",
+         {offsetof(struct ImmutableDBOptions,
+                   prioritize_compactions_by_read_amp),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"allow_2pc",
          {offsetof(struct ImmutableDBOptions, allow_2pc), OptionType::kBoolean,
           OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
@@ -193,6 +223,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"disable_data_sync",  // for compatibility
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
+        {"adaptive_delayed_write_rate",
+         {offsetof(struct ImmutableDBOptions, adaptive_delayed_write_rate),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"enable_thread_tracking",
          {offsetof(struct ImmutableDBOptions, enable_thread_tracking),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -264,14 +298,63 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"use_fsync",
          {offsetof(struct ImmutableDBOptions, use_fsync), OptionType::kBoolean,
           OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+        {"max_background_warmups",
+         {offsetof(struct ImmutableDBOptions, max_background_warmups),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_flush_partitions",
+         {offsetof(struct ImmutableDBOptions, max_flush_partitions),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_cache_dump_file",
+         {offsetof(struct ImmutableDBOptions, block_cache_dump_file),
+          OptionType::kString, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"read_hotness_file",
+         {offsetof(struct ImmutableDBOptions, read_hotness_file),
+          OptionType::kString, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"read_hotness_persist_period_sec",
+         {offsetof(struct ImmutableDBOptions, read_hotness_persist_period_sec),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"restart_warmup_max_bytes",
+         {offsetof(struct ImmutableDBOptions, restart_warmup_max_bytes),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"hedged_read_threads",
+         {offsetof(struct ImmutableDBOptions, hedged_read_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"hedged_read_percentile",
+         {offsetof(struct ImmutableDBOptions, hedged_read_percentile),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"hedged_read_budget_percent",
+         {offsetof(struct ImmutableDBOptions, hedged_read_budget_percent),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"max_file_opening_threads",
          {offsetof(struct ImmutableDBOptions, max_file_opening_threads),
           OptionType::kInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"open_table_files_in_background",
+         {offsetof(struct ImmutableDBOptions, open_table_files_in_background),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_wal_recovery_threads",
+         {offsetof(struct ImmutableDBOptions, max_wal_recovery_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"table_cache_numshardbits",
          {offsetof(struct ImmutableDBOptions, table_cache_numshardbits),
           OptionType::kInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"table_cache_use_hyper_clock_cache",
+         {offsetof(struct ImmutableDBOptions,
+                   table_cache_use_hyper_clock_cache),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"db_write_buffer_size",
          {offsetof(struct ImmutableDBOptions, db_write_buffer_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
@@ -318,6 +401,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, persist_stats_to_disk),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"slow_read_log_threshold_micros",
+         {offsetof(struct ImmutableDBOptions, slow_read_log_threshold_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"perf_context_sample_rate",
+         {offsetof(struct ImmutableDBOptions, perf_context_sample_rate),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"slow_operation_threshold_micros",
+         {offsetof(struct ImmutableDBOptions, slow_operation_threshold_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"fail_if_options_file_error",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -342,6 +437,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    enable_write_thread_adaptive_yield),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"enable_write_thread_per_core_queues",
+         {offsetof(struct ImmutableDBOptions,
+                   enable_write_thread_per_core_queues),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"write_thread_slow_yield_usec",
          {offsetof(struct ImmutableDBOptions, write_thread_slow_yield_usec),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -391,6 +491,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, wal_compression),
           OptionType::kCompressionType, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"wal_compression_pipeline_min_record_size",
+         {offsetof(struct ImmutableDBOptions,
+                   wal_compression_pipeline_min_record_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"background_close_inactive_wals",
          {offsetof(struct ImmutableDBOptions, background_close_inactive_wals),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -728,6 +833,17 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       info_log(options.info_log),
       info_log_level(options.info_log_level),
       max_file_opening_threads(options.max_file_opening_threads),
+      open_table_files_in_background(options.open_table_files_in_background),
+      max_wal_recovery_threads(options.max_wal_recovery_threads),
+      max_background_warmups(options.max_background_warmups),
+      max_flush_partitions(options.max_flush_partitions),
+      block_cache_dump_file(options.block_cache_dump_file),
+      read_hotness_file(options.read_hotness_file),
+      read_hotness_persist_period_sec(options.read_hotness_persist_period_sec),
+      restart_warmup_max_bytes(options.restart_warmup_max_bytes),
+      hedged_read_threads(options.hedged_read_threads),
+      hedged_read_percentile(options.hedged_read_percentile),
+      hedged_read_budget_percent(options.hedged_read_budget_percent),
       statistics(options.statistics),
       use_fsync(options.use_fsync),
       db_paths(options.db_paths),
@@ -739,6 +855,8 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       recycle_log_file_num(options.recycle_log_file_num),
       max_manifest_file_size(options.max_manifest_file_size),
       table_cache_numshardbits(options.table_cache_numshardbits),
+      table_cache_use_hyper_clock_cache(
+          options.table_cache_use_hyper_clock_cache),
       WAL_ttl_seconds(options.WAL_ttl_seconds),
       WAL_size_limit_MB(options.WAL_size_limit_MB),
       max_write_batch_group_size_bytes(
@@ -749,6 +867,13 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       use_direct_reads(options.use_direct_reads),
       use_direct_io_for_flush_and_compaction(
           options.use_direct_io_for_flush_and_compaction),
+      background_writes_for_flush_and_compaction(
+          options.background_writes_for_flush_and_compaction),
+      use_direct_io_for_wal(options.use_direct_io_for_wal),
+      compaction_async_io(options.compaction_async_io),
+      subcompaction_ranges_per_thread(options.subcompaction_ranges_per_thread),
+      prioritize_compactions_by_read_amp(
+          options.prioritize_compactions_by_read_amp),
       allow_fallocate(options.allow_fallocate),
       is_fd_close_on_exec(options.is_fd_close_on_exec),
       advise_random_on_open(options.advise_random_on_open),
@@ -757,11 +882,14 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       use_adaptive_mutex(options.use_adaptive_mutex),
       listeners(options.listeners),
       enable_thread_tracking(options.enable_thread_tracking),
+      adaptive_delayed_write_rate(options.adaptive_delayed_write_rate),
       enable_pipelined_write(options.enable_pipelined_write),
       unordered_write(options.unordered_write),
       allow_concurrent_memtable_write(options.allow_concurrent_memtable_write),
       enable_write_thread_adaptive_yield(
           options.enable_write_thread_adaptive_yield),
+      enable_write_thread_per_core_queues(
+          options.enable_write_thread_per_core_queues),
       write_thread_max_yield_usec(options.write_thread_max_yield_usec),
       write_thread_slow_yield_usec(options.write_thread_slow_yield_usec),
       skip_stats_update_on_db_open(options.skip_stats_update_on_db_open),
@@ -777,11 +905,16 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       two_write_queues(options.two_write_queues),
       manual_wal_flush(options.manual_wal_flush),
       wal_compression(options.wal_compression),
+      wal_compression_pipeline_min_record_size(
+          options.wal_compression_pipeline_min_record_size),
       background_close_inactive_wals(options.background_close_inactive_wals),
       atomic_flush(options.atomic_flush),
       avoid_unnecessary_blocking_io(options.avoid_unnecessary_blocking_io),
       prefix_seek_opt_in_only(options.prefix_seek_opt_in_only),
       persist_stats_to_disk(options.persist_stats_to_disk),
+      slow_read_log_threshold_micros(options.slow_read_log_threshold_micros),
+      perf_context_sample_rate(options.perf_context_sample_rate),
+      slow_operation_threshold_micros(options.slow_operation_threshold_micros),
       write_dbid_to_manifest(options.write_dbid_to_manifest),
       write_identity_file(options.write_identity_file),
       log_readahead_size(options.log_readahead_size),
@@ -838,6 +971,31 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    info_log.get());
   ROCKS_LOG_HEADER(log, "               Options.max_file_opening_threads: %d",
                    max_file_opening_threads);
+  ROCKS_LOG_HEADER(log, "         Options.open_table_files_in_background: %d",
+                   open_table_files_in_background);
+  ROCKS_LOG_HEADER(log, "               Options.max_wal_recovery_threads: %d",
+                   max_wal_recovery_threads);
+  ROCKS_LOG_HEADER(log, "                 Options.max_background_warmups: %d",
+                   max_background_warmups);
+  ROCKS_LOG_HEADER(log,
+                   "                   Options.max_flush_partitions: %" PRIu32,
+                   max_flush_partitions);
+  ROCKS_LOG_HEADER(log, "                  Options.block_cache_dump_file: %s",
+                   block_cache_dump_file.c_str());
+  ROCKS_LOG_HEADER(log, "                      Options.read_hotness_file: %s",
+                   read_hotness_file.c_str());
+  ROCKS_LOG_HEADER(log, "        Options.read_hotness_persist_period_sec: %u",
+                   read_hotness_persist_period_sec);
+  ROCKS_LOG_HEADER(log,
+                   "               Options.restart_warmup_max_bytes: %" PRIu64,
+                   restart_warmup_max_bytes);
+  ROCKS_LOG_HEADER(log, "                    Options.hedged_read_threads: %d",
+                   hedged_read_threads);
+  ROCKS_LOG_HEADER(log, "                 Options.hedged_read_percentile: %f",
+                   hedged_read_percentile);
+  ROCKS_LOG_HEADER(log,
+                   "             Options.hedged_read_budget_percent: %" PRIu32,
+                   hedged_read_budget_percent);
   ROCKS_LOG_HEADER(log, "                             Options.statistics: %p",
                    stats);
   if (stats) {
@@ -874,6 +1032,19 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    "                       "
                    "Options.use_direct_io_for_flush_and_compaction: %d",
                    use_direct_io_for_flush_and_compaction);
+  ROCKS_LOG_HEADER(log,
+                   "                   "
+                   "Options.background_writes_for_flush_and_compaction: %d",
+                   background_writes_for_flush_and_compaction);
+  ROCKS_LOG_HEADER(log, "                  Options.use_direct_io_for_wal: %d",
+                   use_direct_io_for_wal);
+  ROCKS_LOG_HEADER(log, "                    Options.compaction_async_io: %d",
+                   compaction_async_io);
+  ROCKS_LOG_HEADER(
+      log, "        Options.subcompaction_ranges_per_thread: %" PRIu32,
+      subcompaction_ranges_per_thread);
+  ROCKS_LOG_HEADER(log, "     Options.prioritize_compactions_by_read_amp: %d",
+                   prioritize_compactions_by_read_amp);
   ROCKS_LOG_HEADER(log, "         Options.create_missing_column_families: %d",
                    create_missing_column_families);
   ROCKS_LOG_HEADER(log, "                             Options.db_log_dir: %s",
@@ -882,6 +1053,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    wal_dir.c_str());
   ROCKS_LOG_HEADER(log, "               Options.table_cache_numshardbits: %d",
                    table_cache_numshardbits);
+  ROCKS_LOG_HEADER(log, "      Options.table_cache_use_hyper_clock_cache: %d",
+                   table_cache_use_hyper_clock_cache);
   ROCKS_LOG_HEADER(log,
                    "                        Options.WAL_ttl_seconds: %" PRIu64,
                    WAL_ttl_seconds);
@@ -915,6 +1088,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    static_cast<int>(wal_recovery_mode));
   ROCKS_LOG_HEADER(log, "                 Options.enable_thread_tracking: %d",
                    enable_thread_tracking);
+  ROCKS_LOG_HEADER(log, "            Options.adaptive_delayed_write_rate: %d",
+                   adaptive_delayed_write_rate);
   ROCKS_LOG_HEADER(log, "                 Options.enable_pipelined_write: %d",
                    enable_pipelined_write);
   ROCKS_LOG_HEADER(log, "                 Options.unordered_write: %d",
@@ -923,6 +1098,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    allow_concurrent_memtable_write);
   ROCKS_LOG_HEADER(log, "     Options.enable_write_thread_adaptive_yield: %d",
                    enable_write_thread_adaptive_yield);
+  ROCKS_LOG_HEADER(log, "    Options.enable_write_thread_per_core_queues: %d",
+                   enable_write_thread_per_core_queues);
   ROCKS_LOG_HEADER(log,
                    "            Options.write_thread_max_yield_usec: %" PRIu64,
                    write_thread_max_yield_usec);
@@ -951,6 +1128,10 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    manual_wal_flush);
   ROCKS_LOG_HEADER(log, "            Options.wal_compression: %d",
                    wal_compression);
+  ROCKS_LOG_HEADER(log,
+                   "  Options.wal_compression_pipeline_min_record_size: "
+                   "%" ROCKSDB_PRIszt,
+                   wal_compression_pipeline_min_record_size);
   ROCKS_LOG_HEADER(log,
                    "            Options.background_close_inactive_wals: %d",
                    background_close_inactive_wals);
@@ -961,6 +1142,15 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    prefix_seek_opt_in_only);
   ROCKS_LOG_HEADER(log, "                Options.persist_stats_to_disk: %u",
                    persist_stats_to_disk);
+  ROCKS_LOG_HEADER(log,
+                   "       Options.slow_read_log_threshold_micros: %" PRIu64,
+                   slow_read_log_threshold_micros);
+  ROCKS_LOG_HEADER(log,
+                   "             Options.perf_context_sample_rate: %" PRIu32,
+                   perf_context_sample_rate);
+  ROCKS_LOG_HEADER(log,
+                   "      Options.slow_operation_threshold_micros: %" PRIu64,
+                   slow_operation_threshold_micros);
   ROCKS_LOG_HEADER(log, "                Options.write_dbid_to_manifest: %d",
                    write_dbid_to_manifest);
   ROCKS_LOG_HEADER(log, "                Options.write_identity_file: %d",
@@ -1036,12 +1226,14 @@ MutableDBOptions::MutableDBOptions()
       delete_obsolete_files_period_micros(6ULL * 60 * 60 * 1000000),
       stats_dump_period_sec(600),
       stats_persist_period_sec(600),
+      auto_tune_period_sec(0),
       stats_history_buffer_size(1024 * 1024),
       max_open_files(-1),
       bytes_per_sync(0),
       wal_bytes_per_sync(0),
       strict_bytes_per_sync(false),
       compaction_readahead_size(0),
+      compaction_readahead_budget(0),
       max_background_flushes(-1) {}
 
 MutableDBOptions::MutableDBOptions(const DBOptions& options)
@@ -1056,12 +1248,14 @@ MutableDBOptions::MutableDBOptions(const DBOptions& options)
           options.delete_obsolete_files_period_micros),
       stats_dump_period_sec(options.stats_dump_period_sec),
       stats_persist_period_sec(options.stats_persist_period_sec),
+      auto_tune_period_sec(options.auto_tune_period_sec),
       stats_history_buffer_size(options.stats_history_buffer_size),
       max_open_files(options.max_open_files),
       bytes_per_sync(options.bytes_per_sync),
       wal_bytes_per_sync(options.wal_bytes_per_sync),
       strict_bytes_per_sync(options.strict_bytes_per_sync),
       compaction_readahead_size(options.compaction_readahead_size),
+      compaction_readahead_budget(options.compaction_readahead_budget),
       max_background_flushes(options.max_background_flushes),
       daily_offpeak_time_utc(options.daily_offpeak_time_utc) {}
 
@@ -1088,6 +1282,8 @@ void MutableDBOptions::Dump(Logger* log) const {
                    stats_dump_period_sec);
   ROCKS_LOG_HEADER(log, "                Options.stats_persist_period_sec: %d",
                    stats_persist_period_sec);
+  ROCKS_LOG_HEADER(log, "                    Options.auto_tune_period_sec: %u",
+                   auto_tune_period_sec);
   ROCKS_LOG_HEADER(
       log,
       "                Options.stats_history_buffer_size: %" ROCKSDB_PRIszt,
@@ -1105,6 +1301,9 @@ void MutableDBOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "      Options.compaction_readahead_size: %" ROCKSDB_PRIszt,
                    compaction_readahead_size);
+  ROCKS_LOG_HEADER(log,
+                   "    Options.compaction_readahead_budget: %" ROCKSDB_PRIszt,
+                   compaction_readahead_budget);
   ROCKS_LOG_HEADER(log, "                 Options.max_background_flushes: %d",
                    max_background_flushes);
   ROCKS_LOG_HEADER(log, "Options.daily_offpeak_time_utc: %s",
@@ -35,6 +35,17 @@ struct ImmutableDBOptions {
   std::shared_ptr<Logger> info_log;
   InfoLogLevel info_log_level;
   int max_file_opening_threads;
+  bool open_table_files_in_background;
+  int max_wal_recovery_threads;
+  int max_background_warmups;
+  uint32_t max_flush_partitions;
+  std::string block_cache_dump_file;
+  std::string read_hotness_file;
+  unsigned int read_hotness_persist_period_sec;
+  uint64_t restart_warmup_max_bytes;
+  int hedged_read_threads;
+  double hedged_read_percentile;
+  uint32_t hedged_read_budget_percent;
   std::shared_ptr<Statistics> statistics;
   bool use_fsync;
   std::vector<DbPath> db_paths;
@@ -49,6 +60,7 @@ struct ImmutableDBOptions {
   size_t recycle_log_file_num;
   uint64_t max_manifest_file_size;
   int table_cache_numshardbits;
+  bool table_cache_use_hyper_clock_cache;
   uint64_t WAL_ttl_seconds;
   uint64_t WAL_size_limit_MB;
   uint64_t max_write_batch_group_size_bytes;
@@ -57,6 +69,11 @@ struct ImmutableDBOptions {
   bool allow_mmap_writes;
   bool use_direct_reads;
   bool use_direct_io_for_flush_and_compaction;
+  bool background_writes_for_flush_and_compaction;
+  bool use_direct_io_for_wal;
+  bool compaction_async_io;
+  uint32_t subcompaction_ranges_per_thread;
+  bool prioritize_compactions_by_read_amp;
   bool allow_fallocate;
   bool is_fd_close_on_exec;
   bool advise_random_on_open;
@@ -65,10 +82,12 @@ struct ImmutableDBOptions {
   bool use_adaptive_mutex;
   std::vector<std::shared_ptr<EventListener>> listeners;
   bool enable_thread_tracking;
+  bool adaptive_delayed_write_rate;
   bool enable_pipelined_write;
   bool unordered_write;
   bool allow_concurrent_memtable_write;
   bool enable_write_thread_adaptive_yield;
+  bool enable_write_thread_per_core_queues;
   uint64_t write_thread_max_yield_usec;
   uint64_t write_thread_slow_yield_usec;
   bool skip_stats_update_on_db_open;
@@ -83,11 +102,15 @@ struct ImmutableDBOptions {
   bool two_write_queues;
   bool manual_wal_flush;
   CompressionType wal_compression;
+  size_t wal_compression_pipeline_min_record_size;
   bool background_close_inactive_wals;
   bool atomic_flush;
   bool avoid_unnecessary_blocking_io;
   bool prefix_seek_opt_in_only;
   bool persist_stats_to_disk;
+  uint64_t slow_read_log_threshold_micros;
+  uint32_t perf_context_sample_rate;
+  uint64_t slow_operation_threshold_micros;
   bool write_dbid_to_manifest;
   bool write_identity_file;
   size_t log_readahead_size;
@@ -139,12 +162,14 @@ struct MutableDBOptions {
   uint64_t delete_obsolete_files_period_micros;
   unsigned int stats_dump_period_sec;
   unsigned int stats_persist_period_sec;
+  unsigned int auto_tune_period_sec;
   size_t stats_history_buffer_size;
   int max_open_files;
   uint64_t bytes_per_sync;
   uint64_t wal_bytes_per_sync;
   bool strict_bytes_per_sync;
   size_t compaction_readahead_size;
+  size_t compaction_readahead_budget;
   int max_background_flushes;
   std::string daily_offpeak_time_utc;
 };
@@ -21,6 +21,7 @@
 #include "rocksdb/comparator.h"
 #include "rocksdb/env.h"
 #include "rocksdb/filter_policy.h"
+#include "rocksdb/memory_allocator.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/slice.h"
@@ -49,10 +50,18 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       inplace_update_num_locks(options.inplace_update_num_locks),
       experimental_mempurge_threshold(options.experimental_mempurge_threshold),
       inplace_callback(options.inplace_callback),
+      inplace_merge_support(options.inplace_merge_support),
       memtable_prefix_bloom_size_ratio(
           options.memtable_prefix_bloom_size_ratio),
       memtable_whole_key_filtering(options.memtable_whole_key_filtering),
       memtable_huge_page_size(options.memtable_huge_page_size),
+      memtable_tier_allocator(options.memtable_tier_allocator),
+      memtable_tier_min_entry_size(options.memtable_tier_min_entry_size),
+      memtable_value_compression(options.memtable_value_compression),
+      memtable_value_compression_min_size(
+          options.memtable_value_compression_min_size),
+      memtable_point_lookup_index_ratio(
+          options.memtable_point_lookup_index_ratio),
       memtable_insert_with_hint_prefix_extractor(
           options.memtable_insert_with_hint_prefix_extractor),
       bloom_locality(options.bloom_locality),
@@ -94,12 +103,14 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       sample_for_compression(options.sample_for_compression),
       last_level_temperature(options.last_level_temperature),
       default_write_temperature(options.default_write_temperature),
+      last_level_promotion_reads(options.last_level_promotion_reads),
       default_temperature(options.default_temperature),
       preclude_last_level_data_seconds(
           options.preclude_last_level_data_seconds),
       preserve_internal_time_seconds(options.preserve_internal_time_seconds),
       enable_blob_files(options.enable_blob_files),
       min_blob_size(options.min_blob_size),
+      blob_separation_percent(options.blob_separation_percent),
       blob_file_size(options.blob_file_size),
       blob_compression_type(options.blob_compression_type),
       enable_blob_garbage_collection(options.enable_blob_garbage_collection),
@@ -107,6 +118,8 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
           options.blob_garbage_collection_age_cutoff),
       blob_garbage_collection_force_threshold(
           options.blob_garbage_collection_force_threshold),
+      blob_garbage_collection_file_threshold(
+          options.blob_garbage_collection_file_threshold),
       blob_compaction_readahead_size(options.blob_compaction_readahead_size),
       blob_file_starting_level(options.blob_file_starting_level),
       blob_cache(options.blob_cache),
@@ -114,7 +127,13 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       persist_user_defined_timestamps(options.persist_user_defined_timestamps),
       memtable_op_scan_flush_trigger(options.memtable_op_scan_flush_trigger),
       memtable_avg_op_scan_flush_trigger(
-          options.memtable_avg_op_scan_flush_trigger) {
+          options.memtable_avg_op_scan_flush_trigger),
+      compaction_warmup_policy(options.compaction_warmup_policy),
+      allow_flush_below_level0(options.allow_flush_below_level0),
+      cf_statistics(options.cf_statistics),
+      bottommost_hash_index(options.bottommost_hash_index),
+      level_compaction_move_edge_overlaps(
+          options.level_compaction_move_edge_overlaps) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -292,6 +311,30 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "     Options.memtable_avg_op_scan_flush_trigger: %" PRIu32,
                    memtable_avg_op_scan_flush_trigger);
+  ROCKS_LOG_HEADER(log, "       Options.compaction_warmup_policy.mode: %d",
+                   static_cast<int>(compaction_warmup_policy.mode));
+  ROCKS_LOG_HEADER(log, "Options.compaction_warmup_policy.max_output_level: %d",
+                   compaction_warmup_policy.max_output_level);
+  ROCKS_LOG_HEADER(
+      log,
+      "Options.compaction_warmup_policy.max_bytes_per_compaction: %" PRIu64,
+      compaction_warmup_policy.max_bytes_per_compaction);
+  ROCKS_LOG_HEADER(
+      log, "Options.compaction_warmup_policy.stop_at_cache_capacity: %d",
+      compaction_warmup_policy.stop_at_cache_capacity);
+  ROCKS_LOG_HEADER(
+      log,
+      "Options.compaction_warmup_policy.warm_index_and_filter_partitions: %d",
+      compaction_warmup_policy.warm_index_and_filter_partitions);
+  ROCKS_LOG_HEADER(
+      log,
+      "Options.compaction_warmup_policy.secondary_cache_min_output_level: %d",
+      compaction_warmup_policy.secondary_cache_min_output_level);
+  ROCKS_LOG_HEADER(
+      log, "  Options.compaction_warmup_policy.warm_relocated_blobs: %d",
+      compaction_warmup_policy.warm_relocated_blobs);
+  ROCKS_LOG_HEADER(log, "           Options.allow_flush_below_level0: %d",
+                   allow_flush_below_level0);
   ROCKS_LOG_HEADER(log,
                    "                   Options.max_compaction_bytes: %" PRIu64,
                    max_compaction_bytes);
@@ -363,6 +406,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_HEADER(log, "Options.compaction_options_fifo.allow_compaction: %d",
                    compaction_options_fifo.allow_compaction);
+  ROCKS_LOG_HEADER(
+      log, "Options.compaction_options_fifo.time_window_seconds: %" PRIu64,
+      compaction_options_fifo.time_window_seconds);
   std::ostringstream collector_info;
   for (const auto& collector_factory : table_properties_collector_factories) {
     collector_info << collector_factory->ToString() << ';';
@@ -375,6 +421,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(
       log, "                Options.inplace_update_num_locks: %" ROCKSDB_PRIszt,
       inplace_update_num_locks);
+  ROCKS_LOG_HEADER(log, "                   Options.inplace_merge_support: %d",
+                   inplace_merge_support);
   // TODO: easier config for bloom (maybe based on avg key/value size)
   ROCKS_LOG_HEADER(log,
                    "              Options.memtable_prefix_bloom_size_ratio: %f",
@@ -385,6 +433,26 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
 
   ROCKS_LOG_HEADER(log, "  Options.memtable_huge_page_size: %" ROCKSDB_PRIszt,
                    memtable_huge_page_size);
+  ROCKS_LOG_HEADER(
+      log, "  Options.memtable_tier_allocator: %s",
+      memtable_tier_allocator ? memtable_tier_allocator->Name() : "None");
+  ROCKS_LOG_HEADER(log,
+                   "  Options.memtable_tier_min_entry_size: %" ROCKSDB_PRIszt,
+                   memtable_tier_min_entry_size);
+  ROCKS_LOG_HEADER(
+      log, "  Options.memtable_value_compression: %s",
+      CompressionTypeToString(memtable_value_compression).c_str());
+  ROCKS_LOG_HEADER(
+      log, "  Options.memtable_value_compression_min_size: %" ROCKSDB_PRIszt,
+      memtable_value_compression_min_size);
+  ROCKS_LOG_HEADER(log, "  Options.memtable_point_lookup_index_ratio: %f",
+                   memtable_point_lookup_index_ratio);
+  ROCKS_LOG_HEADER(log, "  Options.cf_statistics: %s",
+                   cf_statistics ? cf_statistics->Name() : "None");
+  ROCKS_LOG_HEADER(log, "  Options.bottommost_hash_index: %d",
+                   bottommost_hash_index);
+  ROCKS_LOG_HEADER(log, "  Options.level_compaction_move_edge_overlaps: %d",
+                   level_compaction_move_edge_overlaps);
   ROCKS_LOG_HEADER(log, "                          Options.bloom_locality: %d",
                    bloom_locality);
 
@@ -428,6 +496,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "                          Options.min_blob_size: %" PRIu64,
                    min_blob_size);
+  ROCKS_LOG_HEADER(log,
+                   "                Options.blob_separation_percent: %" PRIu32,
+                   blob_separation_percent);
   ROCKS_LOG_HEADER(log,
                    "                         Options.blob_file_size: %" PRIu64,
                    blob_file_size);
@@ -439,6 +510,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                    blob_garbage_collection_age_cutoff);
   ROCKS_LOG_HEADER(log, "Options.blob_garbage_collection_force_threshold: %f",
                    blob_garbage_collection_force_threshold);
+  ROCKS_LOG_HEADER(log, " Options.blob_garbage_collection_file_threshold: %f",
+                   blob_garbage_collection_file_threshold);
   ROCKS_LOG_HEADER(log,
                    "         Options.blob_compaction_readahead_size: %" PRIu64,
                    blob_compaction_readahead_size);
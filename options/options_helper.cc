@@ -82,6 +82,22 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_open_files = mutable_db_options.max_open_files;
   options.max_file_opening_threads =
       immutable_db_options.max_file_opening_threads;
+  options.open_table_files_in_background =
+      immutable_db_options.open_table_files_in_background;
+  options.max_wal_recovery_threads =
+      immutable_db_options.max_wal_recovery_threads;
+  options.max_background_warmups = immutable_db_options.max_background_warmups;
+  options.max_flush_partitions = immutable_db_options.max_flush_partitions;
+  options.block_cache_dump_file = immutable_db_options.block_cache_dump_file;
+  options.read_hotness_file = immutable_db_options.read_hotness_file;
+  options.read_hotness_persist_period_sec =
+      immutable_db_options.read_hotness_persist_period_sec;
+  options.restart_warmup_max_bytes =
+      immutable_db_options.restart_warmup_max_bytes;
+  options.hedged_read_threads = immutable_db_options.hedged_read_threads;
+  options.hedged_read_percentile = immutable_db_options.hedged_read_percentile;
+  options.hedged_read_budget_percent =
+      immutable_db_options.hedged_read_budget_percent;
   options.max_total_wal_size = mutable_db_options.max_total_wal_size;
   options.statistics = immutable_db_options.statistics;
   options.use_fsync = immutable_db_options.use_fsync;
@@ -102,6 +118,8 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_manifest_file_size = immutable_db_options.max_manifest_file_size;
   options.table_cache_numshardbits =
       immutable_db_options.table_cache_numshardbits;
+  options.table_cache_use_hyper_clock_cache =
+      immutable_db_options.table_cache_use_hyper_clock_cache;
   options.WAL_ttl_seconds = immutable_db_options.WAL_ttl_seconds;
   options.WAL_size_limit_MB = immutable_db_options.WAL_size_limit_MB;
   options.manifest_preallocation_size =
@@ -111,12 +129,27 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.use_direct_reads = immutable_db_options.use_direct_reads;
   options.use_direct_io_for_flush_and_compaction =
       immutable_db_options.use_direct_io_for_flush_and_compaction;
+  options.background_writes_for_flush_and_compaction =
+      immutable_db_options.background_writes_for_flush_and_compaction;
+  options.use_direct_io_for_wal = immutable_db_options.use_direct_io_for_wal;
+  options.compaction_async_io = immutable_db_options.compaction_async_io;
+  options.subcompaction_ranges_per_thread =
+      immutable_db_options.subcompaction_ranges_per_thread;
+  options.prioritize_compactions_by_read_amp =
+      immutable_db_options.prioritize_compactions_by_read_amp;
   options.allow_fallocate = immutable_db_options.allow_fallocate;
   options.is_fd_close_on_exec = immutable_db_options.is_fd_close_on_exec;
   options.stats_dump_period_sec = mutable_db_options.stats_dump_period_sec;
   options.stats_persist_period_sec =
       mutable_db_options.stats_persist_period_sec;
+  options.auto_tune_period_sec = mutable_db_options.auto_tune_period_sec;
   options.persist_stats_to_disk = immutable_db_options.persist_stats_to_disk;
+  options.slow_read_log_threshold_micros =
+      immutable_db_options.slow_read_log_threshold_micros;
+  options.perf_context_sample_rate =
+      immutable_db_options.perf_context_sample_rate;
+  options.slow_operation_threshold_micros =
+      immutable_db_options.slow_operation_threshold_micros;
   options.stats_history_buffer_size =
       mutable_db_options.stats_history_buffer_size;
   options.advise_random_on_open = immutable_db_options.advise_random_on_open;
@@ -124,6 +157,8 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.write_buffer_manager = immutable_db_options.write_buffer_manager;
   options.compaction_readahead_size =
       mutable_db_options.compaction_readahead_size;
+  options.compaction_readahead_budget =
+      mutable_db_options.compaction_readahead_budget;
   options.writable_file_max_buffer_size =
       mutable_db_options.writable_file_max_buffer_size;
   options.use_adaptive_mutex = immutable_db_options.use_adaptive_mutex;
@@ -133,12 +168,16 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.listeners = immutable_db_options.listeners;
   options.enable_thread_tracking = immutable_db_options.enable_thread_tracking;
   options.delayed_write_rate = mutable_db_options.delayed_write_rate;
+  options.adaptive_delayed_write_rate =
+      immutable_db_options.adaptive_delayed_write_rate;
   options.enable_pipelined_write = immutable_db_options.enable_pipelined_write;
   options.unordered_write = immutable_db_options.unordered_write;
   options.allow_concurrent_memtable_write =
       immutable_db_options.allow_concurrent_memtable_write;
   options.enable_write_thread_adaptive_yield =
       immutable_db_options.enable_write_thread_adaptive_yield;
+  options.enable_write_thread_per_core_queues =
+      immutable_db_options.enable_write_thread_per_core_queues;
   options.max_write_batch_group_size_bytes =
       immutable_db_options.max_write_batch_group_size_bytes;
   options.write_thread_max_yield_usec =
@@ -162,6 +201,8 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.two_write_queues = immutable_db_options.two_write_queues;
   options.manual_wal_flush = immutable_db_options.manual_wal_flush;
   options.wal_compression = immutable_db_options.wal_compression;
+  options.wal_compression_pipeline_min_record_size =
+      immutable_db_options.wal_compression_pipeline_min_record_size;
   options.background_close_inactive_wals =
       immutable_db_options.background_close_inactive_wals;
   options.atomic_flush = immutable_db_options.atomic_flush;
@@ -229,6 +270,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.experimental_mempurge_threshold;
   cf_opts->memtable_protection_bytes_per_key =
       moptions.memtable_protection_bytes_per_key;
+  cf_opts->memtable_protection_verify_one_in =
+      moptions.memtable_protection_verify_one_in;
   cf_opts->block_protection_bytes_per_key =
       moptions.block_protection_bytes_per_key;
   cf_opts->paranoid_memory_checks = moptions.paranoid_memory_checks;
@@ -271,6 +314,7 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
   // Blob file related options
   cf_opts->enable_blob_files = moptions.enable_blob_files;
   cf_opts->min_blob_size = moptions.min_blob_size;
+  cf_opts->blob_separation_percent = moptions.blob_separation_percent;
   cf_opts->blob_file_size = moptions.blob_file_size;
   cf_opts->blob_compression_type = moptions.blob_compression_type;
   cf_opts->enable_blob_garbage_collection =
@@ -279,6 +323,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.blob_garbage_collection_age_cutoff;
   cf_opts->blob_garbage_collection_force_threshold =
       moptions.blob_garbage_collection_force_threshold;
+  cf_opts->blob_garbage_collection_file_threshold =
+      moptions.blob_garbage_collection_file_threshold;
   cf_opts->blob_compaction_readahead_size =
       moptions.blob_compaction_readahead_size;
   cf_opts->blob_file_starting_level = moptions.blob_file_starting_level;
@@ -298,12 +344,15 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
   cf_opts->compression_per_level = moptions.compression_per_level;
   cf_opts->last_level_temperature = moptions.last_level_temperature;
   cf_opts->default_write_temperature = moptions.default_write_temperature;
+  cf_opts->last_level_promotion_reads = moptions.last_level_promotion_reads;
   cf_opts->memtable_max_range_deletions = moptions.memtable_max_range_deletions;
   cf_opts->uncache_aggressiveness = moptions.uncache_aggressiveness;
   cf_opts->memtable_op_scan_flush_trigger =
       moptions.memtable_op_scan_flush_trigger;
   cf_opts->memtable_avg_op_scan_flush_trigger =
       moptions.memtable_avg_op_scan_flush_trigger;
+  cf_opts->compaction_warmup_policy = moptions.compaction_warmup_policy;
+  cf_opts->allow_flush_below_level0 = moptions.allow_flush_below_level0;
 }
 
 void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
@@ -320,6 +369,7 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
       ioptions.max_write_buffer_size_to_maintain;
   cf_opts->inplace_update_support = ioptions.inplace_update_support;
   cf_opts->inplace_callback = ioptions.inplace_callback;
+  cf_opts->inplace_merge_support = ioptions.inplace_merge_support;
   cf_opts->memtable_factory = ioptions.memtable_factory;
   cf_opts->table_properties_collector_factories =
       ioptions.table_properties_collector_factories;
@@ -339,6 +389,17 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
   cf_opts->persist_user_defined_timestamps =
       ioptions.persist_user_defined_timestamps;
   cf_opts->default_temperature = ioptions.default_temperature;
+  cf_opts->memtable_tier_allocator = ioptions.memtable_tier_allocator;
+  cf_opts->memtable_tier_min_entry_size = ioptions.memtable_tier_min_entry_size;
+  cf_opts->cf_statistics = ioptions.cf_statistics;
+  cf_opts->memtable_value_compression = ioptions.memtable_value_compression;
+  cf_opts->memtable_value_compression_min_size =
+      ioptions.memtable_value_compression_min_size;
+  cf_opts->memtable_point_lookup_index_ratio =
+      ioptions.memtable_point_lookup_index_ratio;
+  cf_opts->bottommost_hash_index = ioptions.bottommost_hash_index;
+  cf_opts->level_compaction_move_edge_overlaps =
+      ioptions.level_compaction_move_edge_overlaps;
 
   // TODO(yhchiang): find some way to handle the following derived options
   // * max_file_size
@@ -356,7 +417,8 @@ std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
     {kMinOverlappingRatio, "kMinOverlappingRatio"},
-    {kRoundRobin, "kRoundRobin"}};
+    {kRoundRobin, "kRoundRobin"},
+    {kHotnessAware, "kHotnessAware"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -827,7 +889,8 @@ std::unordered_map<std::string, CompactionPri>
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
         {"kMinOverlappingRatio", kMinOverlappingRatio},
-        {"kRoundRobin", kRoundRobin}};
+        {"kRoundRobin", kRoundRobin},
+        {"kHotnessAware", kHotnessAware}};
 
 std::unordered_map<std::string, CompactionStopStyle>
     OptionsHelper::compaction_stop_style_string_map = {
@@ -198,8 +198,19 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "verify_compression=true;read_amp_bytes_per_bit=0;"
       "enable_index_compression=false;"
       "block_align=true;"
+      "avoid_data_block_page_crossing=true;"
+      "data_block_fetch_unit_size=1048576;"
+      "prefix_block_map=true;"
+      "compact_index_blocks=true;"
+      "background_filter_build=true;"
       "max_auto_readahead_size=0;"
       "prepopulate_block_cache=kDisable;"
+      "prepopulate_block_cache_compaction_max_level=3;"
+      "prepopulate_block_cache_compaction_metadata_only=true;"
+      "prepopulate_block_cache_compaction_max_bytes=1048576;"
+      "prepopulate_block_cache_compaction_hot_ranges_only=true;"
+      "warmup_min_data_block_hits=2;"
+      "compression_dict_reuse_files=4;"
       "initial_auto_readahead_size=0;"
       "num_file_reads_for_auto_readahead=0",
       new_bbto));
@@ -328,6 +339,8 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
       {offsetof(struct DBOptions, db_paths), sizeof(std::vector<DbPath>)},
       {offsetof(struct DBOptions, db_log_dir), sizeof(std::string)},
       {offsetof(struct DBOptions, wal_dir), sizeof(std::string)},
+      {offsetof(struct DBOptions, block_cache_dump_file), sizeof(std::string)},
+      {offsetof(struct DBOptions, read_hotness_file), sizeof(std::string)},
       {offsetof(struct DBOptions, write_buffer_manager),
        sizeof(std::shared_ptr<WriteBufferManager>)},
       {offsetof(struct DBOptions, listeners),
@@ -390,14 +403,27 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "db_write_buffer_size=2587;"
                              "max_subcompactions=64330;"
                              "table_cache_numshardbits=28;"
+                             "table_cache_use_hyper_clock_cache=false;"
                              "max_open_files=72;"
                              "max_file_opening_threads=35;"
+                             "open_table_files_in_background=false;"
+                             "max_wal_recovery_threads=5;"
+                             "max_background_warmups=3;"
+                             "max_flush_partitions=4;"
+                             "block_cache_dump_file=path/to/cache_dump;"
+                             "read_hotness_file=path/to/read_hotness;"
+                             "read_hotness_persist_period_sec=300;"
+                             "restart_warmup_max_bytes=1048576;"
+                             "hedged_read_threads=4;"
+                             "hedged_read_percentile=95.0;"
+                             "hedged_read_budget_percent=10;"
                              "max_background_jobs=8;"
                              "max_background_compactions=33;"
                              "use_fsync=true;"
                              "use_adaptive_mutex=false;"
                              "max_total_wal_size=4295005604;"
                              "compaction_readahead_size=0;"
+                             "compaction_readahead_budget=4194304;"
                              "keep_log_file_num=4890;"
                              "skip_stats_update_on_db_open=false;"
                              "skip_checking_sst_file_sizes_on_db_open=false;"
@@ -414,6 +440,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "bytes_per_sync=4295013613;"
                              "strict_bytes_per_sync=true;"
                              "enable_thread_tracking=false;"
+                             "adaptive_delayed_write_rate=false;"
                              "recycle_log_file_num=0;"
                              "create_missing_column_families=true;"
                              "log_file_time_to_roll=3097;"
@@ -425,12 +452,22 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "allow_mmap_writes=false;"
                              "stats_dump_period_sec=70127;"
                              "stats_persist_period_sec=54321;"
+                             "auto_tune_period_sec=4321;"
                              "persist_stats_to_disk=true;"
+                             "slow_read_log_threshold_micros=1000;"
+                             "perf_context_sample_rate=100;"
+                             "slow_operation_threshold_micros=50000;"
                              "stats_history_buffer_size=14159;"
                              "allow_fallocate=true;"
                              "allow_mmap_reads=false;"
                              "use_direct_reads=false;"
                              "use_direct_io_for_flush_and_compaction=false;"
+                             "background_writes_for_flush_and_compaction="
+                             "false;"
+                             "use_direct_io_for_wal=false;"
+                             "compaction_async_io=false;"
+                             "subcompaction_ranges_per_thread=1;"
+                             "prioritize_compactions_by_read_amp=false;"
                              "max_log_file_size=4607;"
                              "advise_random_on_open=true;"
                              "enable_pipelined_write=false;"
@@ -438,6 +475,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "allow_concurrent_memtable_write=true;"
                              "wal_recovery_mode=kPointInTimeRecovery;"
                              "enable_write_thread_adaptive_yield=true;"
+                             "enable_write_thread_per_core_queues=true;"
                              "write_thread_slow_yield_usec=5;"
                              "write_thread_max_yield_usec=1000;"
                              "info_log_level=DEBUG_LEVEL;"
@@ -450,6 +488,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "two_write_queues=false;"
                              "manual_wal_flush=false;"
                              "wal_compression=kZSTD;"
+                             "wal_compression_pipeline_min_record_size=65536;"
                              "background_close_inactive_wals=true;"
                              "seq_per_batch=false;"
                              "atomic_flush=false;"
@@ -523,6 +562,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
        sizeof(uint64_t)},
       {offsetof(struct ColumnFamilyOptions, blob_cache),
        sizeof(std::shared_ptr<Cache>)},
+      {offsetof(struct ColumnFamilyOptions, compaction_warmup_policy),
+       sizeof(struct CompactionWarmupPolicy)},
       {offsetof(struct ColumnFamilyOptions, comparator), sizeof(Comparator*)},
       {offsetof(struct ColumnFamilyOptions, merge_operator),
        sizeof(std::shared_ptr<MergeOperator>)},
@@ -544,6 +585,10 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
        sizeof(std::shared_ptr<ConcurrentTaskLimiter>)},
       {offsetof(struct ColumnFamilyOptions, sst_partitioner_factory),
        sizeof(std::shared_ptr<SstPartitionerFactory>)},
+      {offsetof(struct ColumnFamilyOptions, memtable_tier_allocator),
+       sizeof(std::shared_ptr<MemoryAllocator>)},
+      {offsetof(struct ColumnFamilyOptions, cf_statistics),
+       sizeof(std::shared_ptr<Statistics>)},
   };
 
   char* options_ptr = new char[sizeof(ColumnFamilyOptions)];
@@ -599,6 +644,12 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "bloom_locality=8016;"
       "target_file_size_base=4294976376;"
       "memtable_huge_page_size=2557;"
+      "memtable_tier_min_entry_size=3127;"
+      "memtable_value_compression=kLZ4Compression;"
+      "memtable_value_compression_min_size=2111;"
+      "memtable_point_lookup_index_ratio=0.125;"
+      "bottommost_hash_index=true;"
+      "level_compaction_move_edge_overlaps=true;"
       "max_successive_merges=5497;"
       "strict_max_successive_merges=true;"
       "max_sequential_skip_in_iterations=4294971408;"
@@ -642,6 +693,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "level_compaction_dynamic_level_bytes=false;"
       "level_compaction_dynamic_file_size=true;"
       "inplace_update_support=false;"
+      "inplace_merge_support=false;"
       "compaction_style=kCompactionStyleFIFO;"
       "compaction_pri=kMinOverlappingRatio;"
       "hard_pending_compaction_bytes_limit=0;"
@@ -653,25 +705,30 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "sample_for_compression=0;"
       "enable_blob_files=true;"
       "min_blob_size=256;"
+      "blob_separation_percent=10;"
       "blob_file_size=1000000;"
       "blob_compression_type=kBZip2Compression;"
       "enable_blob_garbage_collection=true;"
       "blob_garbage_collection_age_cutoff=0.5;"
       "blob_garbage_collection_force_threshold=0.75;"
+      "blob_garbage_collection_file_threshold=0.9;"
       "blob_compaction_readahead_size=262144;"
       "blob_file_starting_level=1;"
       "prepopulate_blob_cache=kDisable;"
       "bottommost_temperature=kWarm;"
       "last_level_temperature=kWarm;"
       "default_write_temperature=kCold;"
+      "last_level_promotion_reads=1000;"
       "default_temperature=kHot;"
       "preclude_last_level_data_seconds=86400;"
       "preserve_internal_time_seconds=86400;"
       "compaction_options_fifo={max_table_files_size=3;allow_"
-      "compaction=true;age_for_warm=0;file_temperature_age_thresholds={{"
+      "compaction=true;time_window_seconds=60;age_for_warm=0;"
+      "file_temperature_age_thresholds={{"
       "temperature=kCold;age=12345}};};"
       "blob_cache=1M;"
       "memtable_protection_bytes_per_key=2;"
+      "memtable_protection_verify_one_in=16;"
       "persist_user_defined_timestamps=true;"
       "block_protection_bytes_per_key=1;"
       "memtable_max_range_deletions=999999;"
@@ -679,7 +736,12 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "uncache_aggressiveness=1234;"
       "paranoid_memory_checks=1;"
       "memtable_op_scan_flush_trigger=123;"
-      "memtable_avg_op_scan_flush_trigger=12;",
+      "memtable_avg_op_scan_flush_trigger=12;"
+      "compaction_warmup_policy={mode=kHotKeyRanges;max_output_level=3;"
+      "max_bytes_per_compaction=1048576;stop_at_cache_capacity=false;"
+      "warm_index_and_filter_partitions=false;"
+      "secondary_cache_min_output_level=5;warm_relocated_blobs=true};"
+      "allow_flush_below_level0=true;",
       new_options));
 
   ASSERT_NE(new_options->blob_cache.get(), nullptr);
@@ -692,6 +754,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
   // kColumnFamilyOptionsExcluded
   ASSERT_EQ(new_options->compaction_options_fifo.max_table_files_size, 3);
   ASSERT_EQ(new_options->compaction_options_fifo.allow_compaction, true);
+  ASSERT_EQ(new_options->compaction_options_fifo.time_window_seconds, 60);
   ASSERT_EQ(new_options->compaction_options_fifo.file_temperature_age_thresholds
                 .size(),
             1);
@@ -703,6 +766,18 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       new_options->compaction_options_fifo.file_temperature_age_thresholds[0]
           .age,
       12345);
+  ASSERT_EQ(new_options->compaction_warmup_policy.mode,
+            CompactionWarmupMode::kHotKeyRanges);
+  ASSERT_EQ(new_options->compaction_warmup_policy.max_output_level, 3);
+  ASSERT_EQ(new_options->compaction_warmup_policy.max_bytes_per_compaction,
+            1048576);
+  ASSERT_FALSE(new_options->compaction_warmup_policy.stop_at_cache_capacity);
+  ASSERT_FALSE(
+      new_options->compaction_warmup_policy.warm_index_and_filter_partitions);
+  ASSERT_EQ(
+      new_options->compaction_warmup_policy.secondary_cache_min_output_level,
+      5);
+  ASSERT_TRUE(new_options->compaction_warmup_policy.warm_relocated_blobs);
   ASSERT_EQ(new_options->compression_manager,
             GetBuiltinCompressionManager(/*compression_format_version*/ 2));
 
@@ -728,6 +803,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
        sizeof(std::shared_ptr<CompressionManager>)},
       {offsetof(struct MutableCFOptions, compression_per_level),
        sizeof(std::vector<CompressionType>)},
+      {offsetof(struct MutableCFOptions, compaction_warmup_policy),
+       sizeof(struct CompactionWarmupPolicy)},
       {offsetof(struct MutableCFOptions, max_file_size),
        sizeof(std::vector<uint64_t>)},
   };
@@ -105,8 +105,13 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
       {"verify_checksums_in_compaction", "false"},
       {"compaction_options_fifo",
        "{allow_compaction=true;max_table_files_size=11002244;"
+       "time_window_seconds=3600;"
        "file_temperature_age_thresholds={{temperature=kCold;age=12345}}}"},
       {"max_sequential_skip_in_iterations", "24"},
+      {"compaction_warmup_policy",
+       "{mode=kOutputFiles;max_output_level=2;max_bytes_per_compaction=4096;"
+       "secondary_cache_min_output_level=4;warm_relocated_blobs=true}"},
+      {"allow_flush_below_level0", "true"},
       {"inplace_update_support", "true"},
       {"report_bg_io_stats", "true"},
       {"compaction_measure_io_stats", "false"},
@@ -129,6 +134,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
       {"enable_blob_garbage_collection", "true"},
       {"blob_garbage_collection_age_cutoff", "0.5"},
       {"blob_garbage_collection_force_threshold", "0.75"},
+      {"blob_garbage_collection_file_threshold", "0.9"},
       {"blob_compaction_readahead_size", "256K"},
       {"blob_file_starting_level", "1"},
       {"prepopulate_blob_cache", "kDisable"},
@@ -253,6 +259,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.compaction_options_fifo.max_table_files_size,
             static_cast<uint64_t>(11002244));
   ASSERT_EQ(new_cf_opt.compaction_options_fifo.allow_compaction, true);
+  ASSERT_EQ(new_cf_opt.compaction_options_fifo.time_window_seconds, 3600);
   ASSERT_EQ(
       new_cf_opt.compaction_options_fifo.file_temperature_age_thresholds.size(),
       1);
@@ -263,6 +270,17 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(
       new_cf_opt.compaction_options_fifo.file_temperature_age_thresholds[0].age,
       12345);
+  ASSERT_EQ(new_cf_opt.compaction_warmup_policy.mode,
+            CompactionWarmupMode::kOutputFiles);
+  ASSERT_EQ(new_cf_opt.compaction_warmup_policy.max_output_level, 2);
+  ASSERT_EQ(new_cf_opt.compaction_warmup_policy.max_bytes_per_compaction,
+            4096U);
+  ASSERT_TRUE(
+      new_cf_opt.compaction_warmup_policy.warm_index_and_filter_partitions);
+  ASSERT_EQ(
+      new_cf_opt.compaction_warmup_policy.secondary_cache_min_output_level, 4);
+  ASSERT_TRUE(new_cf_opt.compaction_warmup_policy.warm_relocated_blobs);
+  ASSERT_TRUE(new_cf_opt.allow_flush_below_level0);
   ASSERT_EQ(new_cf_opt.max_sequential_skip_in_iterations,
             static_cast<uint64_t>(24));
   ASSERT_EQ(new_cf_opt.inplace_update_support, true);
@@ -284,6 +302,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.enable_blob_garbage_collection, true);
   ASSERT_EQ(new_cf_opt.blob_garbage_collection_age_cutoff, 0.5);
   ASSERT_EQ(new_cf_opt.blob_garbage_collection_force_threshold, 0.75);
+  ASSERT_EQ(new_cf_opt.blob_garbage_collection_file_threshold, 0.9);
   ASSERT_EQ(new_cf_opt.blob_compaction_readahead_size, 262144);
   ASSERT_EQ(new_cf_opt.blob_file_starting_level, 1);
   ASSERT_EQ(new_cf_opt.prepopulate_blob_cache, PrepopulateBlobCache::kDisable);
@@ -1353,6 +1372,34 @@ TEST_F(OptionsTest, MemTableRepFactoryCreateFromString) {
       config_options, "id=vector; count=42", &new_mem_factory));
   ASSERT_NOK(MemTableRepFactory::CreateFromString(
       config_options, "id=vector; invalid=unknown", &new_mem_factory));
+
+  ASSERT_OK(MemTableRepFactory::CreateFromString(config_options, "btree",
+                                                 &new_mem_factory));
+  ASSERT_STREQ(new_mem_factory->Name(), "BTreeRepFactory");
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("btree"));
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("BTreeRepFactory"));
+  ASSERT_TRUE(new_mem_factory->IsInsertConcurrentlySupported());
+  ASSERT_NOK(MemTableRepFactory::CreateFromString(
+      config_options, "id=btree; invalid=unknown", &new_mem_factory));
+
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "partitioned_skip_list", &new_mem_factory));
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "partitioned_skip_list:8", &new_mem_factory));
+  ASSERT_STREQ(new_mem_factory->Name(), "PartitionedSkipListFactory");
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("partitioned_skip_list"));
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("PartitionedSkipListFactory"));
+  ASSERT_TRUE(new_mem_factory->IsInsertConcurrentlySupported());
+  ASSERT_EQ(new_mem_factory->GetId(), "PartitionedSkipListFactory:8");
+  ASSERT_NOK(MemTableRepFactory::CreateFromString(
+      config_options, "partitioned_skip_list:8:invalid_opt",
+      &new_mem_factory));
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "id=partitioned_skip_list; num_partitions=4",
+      &new_mem_factory));
+  ASSERT_NOK(MemTableRepFactory::CreateFromString(
+      config_options, "id=partitioned_skip_list; invalid=unknown",
+      &new_mem_factory));
   ASSERT_NOK(MemTableRepFactory::CreateFromString(config_options, "cuckoo",
                                                   &new_mem_factory));
   // CuckooHash memtable is already removed.
@@ -2408,6 +2455,7 @@ TEST_F(OptionsOldApiTest, GetOptionsFromMapTest) {
       {"verify_checksums_in_compaction", "false"},
       {"compaction_options_fifo",
        "{allow_compaction=true;max_table_files_size=11002244;"
+       "time_window_seconds=3600;"
        "file_temperature_age_thresholds={{temperature=kCold;age=12345}}}"},
       {"max_sequential_skip_in_iterations", "24"},
       {"inplace_update_support", "true"},
@@ -2432,6 +2480,7 @@ TEST_F(OptionsOldApiTest, GetOptionsFromMapTest) {
       {"enable_blob_garbage_collection", "true"},
       {"blob_garbage_collection_age_cutoff", "0.5"},
       {"blob_garbage_collection_force_threshold", "0.75"},
+      {"blob_garbage_collection_file_threshold", "0.9"},
       {"blob_compaction_readahead_size", "256K"},
       {"blob_file_starting_level", "1"},
       {"prepopulate_blob_cache", "kDisable"},
@@ -2552,6 +2601,7 @@ TEST_F(OptionsOldApiTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.compaction_options_fifo.max_table_files_size,
             static_cast<uint64_t>(11002244));
   ASSERT_EQ(new_cf_opt.compaction_options_fifo.allow_compaction, true);
+  ASSERT_EQ(new_cf_opt.compaction_options_fifo.time_window_seconds, 3600);
   ASSERT_EQ(
       new_cf_opt.compaction_options_fifo.file_temperature_age_thresholds.size(),
       1);
@@ -2583,6 +2633,7 @@ TEST_F(OptionsOldApiTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.enable_blob_garbage_collection, true);
   ASSERT_EQ(new_cf_opt.blob_garbage_collection_age_cutoff, 0.5);
   ASSERT_EQ(new_cf_opt.blob_garbage_collection_force_threshold, 0.75);
+  ASSERT_EQ(new_cf_opt.blob_garbage_collection_file_threshold, 0.9);
   ASSERT_EQ(new_cf_opt.blob_compaction_readahead_size, 262144);
   ASSERT_EQ(new_cf_opt.blob_file_starting_level, 1);
   ASSERT_EQ(new_cf_opt.prepopulate_blob_cache, PrepopulateBlobCache::kDisable);
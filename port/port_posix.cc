@@ -280,6 +280,30 @@ void SetCpuPriority(ThreadId id, CpuPriority priority) {
 #endif
 }
 
+bool SetCpuAffinity(ThreadId id, const std::vector<int>& cpus) {
+#ifdef OS_LINUX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (cpus.empty()) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  } else {
+    for (int cpu : cpus) {
+      if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+      }
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  return sched_setaffinity(id, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  (void)id;
+  (void)cpus;
+  return false;
+#endif
+}
+
 int64_t GetProcessID() { return getpid(); }
 
 bool GenerateRfcUuid(std::string* output) {
@@ -57,6 +57,7 @@
 
 #include <limits>
 #include <string>
+#include <vector>
 
 #ifndef PLATFORM_IS_LITTLE_ENDIAN
 #define PLATFORM_IS_LITTLE_ENDIAN (__BYTE_ORDER == __LITTLE_ENDIAN)
@@ -236,6 +237,10 @@ using ThreadId = pid_t;
 
 void SetCpuPriority(ThreadId id, CpuPriority priority);
 
+// Restricts the thread to the given CPUs, or lets it run on any of them when
+// `cpus` is empty. Returns false when it is not supported or fails.
+bool SetCpuAffinity(ThreadId id, const std::vector<int>& cpus);
+
 int64_t GetProcessID();
 
 // Uses platform APIs to generate a 36-character RFC-4122 UUID. Returns
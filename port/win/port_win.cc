@@ -277,6 +277,13 @@ void SetCpuPriority(ThreadId id, CpuPriority priority) {
   (void)priority;
 }
 
+bool SetCpuAffinity(ThreadId id, const std::vector<int>& cpus) {
+  // Not supported
+  (void)id;
+  (void)cpus;
+  return false;
+}
+
 int64_t GetProcessID() { return GetCurrentProcessId(); }
 
 bool GenerateRfcUuid(std::string* output) {
@@ -30,6 +30,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "port/win/win_thread.h"
 #include "rocksdb/port_defs.h"
@@ -311,6 +312,8 @@ using ThreadId = int;
 
 void SetCpuPriority(ThreadId id, CpuPriority priority);
 
+bool SetCpuAffinity(ThreadId id, const std::vector<int>& cpus);
+
 int64_t GetProcessID();
 
 // Uses platform APIs to generate a 36-character RFC-4122 UUID. Returns
@@ -13,6 +13,7 @@ LIB_SOURCES =                                                   \
   cache/secondary_cache_adapter.cc                              \
   cache/sharded_cache.cc                                        \
   cache/tiered_secondary_cache.cc                               \
+  cache/tiny_lfu_admission_policy.cc                            \
   db/arena_wrapped_db_iter.cc                                   \
   db/attribute_group_iterator_impl.cc                           \
   db/blob/blob_contents.cc                                      \
@@ -81,9 +82,11 @@ LIB_SOURCES =                                                   \
   db/merge_helper.cc                                            \
   db/merge_operator.cc                                          \
   db/output_validator.cc                                        \
+  db/parallel_wal_recovery.cc                                   \
   db/periodic_task_scheduler.cc                                 \
   db/range_del_aggregator.cc                                    \
   db/range_tombstone_fragmenter.cc                              \
+  db/read_hotness.cc                                            \
   db/repair.cc                                                  \
   db/seqno_to_time_mapping.cc                                   \
   db/snapshot_impl.cc                                           \
@@ -97,6 +100,7 @@ LIB_SOURCES =                                                   \
   db/version_set.cc                                             \
   db/wal_edit.cc                                                \
   db/wal_manager.cc                                             \
+  db/warmup_scheduler.cc                                        \
   db/wide/wide_column_serialization.cc                          \
   db/wide/wide_columns.cc                                       \
   db/wide/wide_columns_helper.cc                                \
@@ -122,6 +126,7 @@ LIB_SOURCES =                                                   \
   file/file_prefetch_buffer.cc                                  \
   file/file_util.cc                                             \
   file/filename.cc                                              \
+  file/hedged_read.cc                                           \
   file/line_file_reader.cc                                      \
   file/random_access_file_reader.cc                             \
   file/read_write_util.cc                                       \
@@ -134,12 +139,16 @@ LIB_SOURCES =                                                   \
   logging/log_buffer.cc                                         \
   memory/arena.cc                                               \
   memory/concurrent_arena.cc                                    \
+  memory/huge_page_allocator.cc                                 \
   memory/jemalloc_nodump_allocator.cc                           \
   memory/memkind_kmem_allocator.cc                              \
   memory/memory_allocator.cc                                    \
+  memory/slab_allocator.cc                                      \
   memtable/alloc_tracker.cc                                     \
+  memtable/btree_rep.cc                                         \
   memtable/hash_linklist_rep.cc                                 \
   memtable/hash_skiplist_rep.cc                                 \
+  memtable/partitioned_skiplist_rep.cc                          \
   memtable/skiplistrep.cc                                       \
   memtable/vectorrep.cc                                         \
   memtable/wbwi_memtable.cc                                     \
@@ -149,6 +158,7 @@ LIB_SOURCES =                                                   \
   monitoring/in_memory_stats_history.cc                         \
   monitoring/instrumented_mutex.cc                              \
   monitoring/iostats_context.cc                                 \
+  monitoring/operation_tracer.cc                                \
   monitoring/perf_context.cc                                    \
   monitoring/perf_level.cc                                      \
   monitoring/persistent_stats_history.cc                        \
@@ -184,10 +194,13 @@ LIB_SOURCES =                                                   \
   table/block_based/block_based_table_reader.cc                 \
   table/block_based/block_builder.cc                            \
   table/block_based/block_cache.cc                              \
+  table/block_based/block_learned_index.cc                      \
   table/block_based/block_prefetcher.cc                         \
   table/block_based/block_prefix_index.cc                       \
   table/block_based/data_block_hash_index.cc                    \
   table/block_based/data_block_footer.cc                        \
+  table/block_based/elias_fano.cc                               \
+  table/block_based/file_hash_index.cc                          \
   table/block_based/filter_block_reader_common.cc               \
   table/block_based/filter_policy.cc                            \
   table/block_based/flush_block_policy.cc                       \
@@ -195,10 +208,12 @@ LIB_SOURCES =                                                   \
   table/block_based/hash_index_reader.cc                        \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
+  table/block_based/learned_index_reader.cc                     \
   table/block_based/parsed_full_filter_block.cc                 \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
   table/block_based/partitioned_index_reader.cc                 \
+  table/block_based/prefix_block_map.cc                         \
   table/block_based/reader_common.cc                            \
   table/block_based/uncompression_dict_reader.cc                \
   table/block_fetcher.cc                                        \
@@ -236,6 +251,7 @@ LIB_SOURCES =                                                   \
   trace_replay/trace_replay.cc                                  \
   trace_replay/block_cache_tracer.cc                            \
   trace_replay/io_tracer.cc                                     \
+  util/adaptive_compression_manager.cc                          \
   util/async_file_reader.cc					                            \
   util/build_version.cc                                         \
   util/cleanable.cc                                             \
@@ -265,12 +281,15 @@ LIB_SOURCES =                                                   \
   util/write_batch_util.cc                                      \
   util/xxhash.cc                                                \
   utilities/agg_merge/agg_merge.cc                              \
+  utilities/async_get_queue/async_get_queue.cc                  \
   utilities/backup/backup_engine.cc                             \
+  utilities/batched_get_db/batched_get_db.cc                    \
   utilities/blob_db/blob_compaction_filter.cc                   \
   utilities/blob_db/blob_db.cc                                  \
   utilities/blob_db/blob_db_impl.cc                             \
   utilities/blob_db/blob_db_impl_filesnapshot.cc                \
   utilities/blob_db/blob_file.cc                                \
+  utilities/bulk_loader/bulk_loader.cc                          \
   utilities/cache_dump_load.cc                                  \
   utilities/cache_dump_load_impl.cc                             \
   utilities/cassandra/cassandra_compaction_filter.cc            \
@@ -287,6 +306,7 @@ LIB_SOURCES =                                                   \
   utilities/fault_injection_env.cc                              \
   utilities/fault_injection_fs.cc                               \
   utilities/fault_injection_secondary_cache.cc                  \
+  utilities/io_scheduler/io_scheduler.cc                        \
   utilities/leveldb_options/leveldb_options.cc                  \
   utilities/memory/memory_util.cc                               \
   utilities/merge_operators.cc                                  \
@@ -304,13 +324,18 @@ LIB_SOURCES =                                                   \
   utilities/persistent_cache/block_cache_tier_file.cc           \
   utilities/persistent_cache/block_cache_tier_metadata.cc       \
   utilities/persistent_cache/persistent_cache_tier.cc           \
+  utilities/persistent_cache/persistent_secondary_cache.cc      \
   utilities/persistent_cache/volatile_tier_impl.cc              \
+  utilities/remote_compaction/remote_compaction_service.cc      \
+  utilities/result_cache_db/result_cache_db.cc                  \
   utilities/secondary_index/secondary_index_iterator.cc         \
   utilities/secondary_index/simple_secondary_index.cc           \
+  utilities/sharded_db/sharded_db_manager.cc                    \
   utilities/simulator_cache/cache_simulator.cc                  \
   utilities/simulator_cache/sim_cache.cc                        \
   utilities/table_properties_collectors/compact_for_tiering_collector.cc \
   utilities/table_properties_collectors/compact_on_deletion_collector.cc \
+  utilities/tiered_file_system/tiered_file_system.cc            \
   utilities/trace/file_trace_reader_writer.cc                   \
   utilities/trace/replayer_impl.cc                              \
   utilities/transactions/lock/lock_manager.cc                   \
@@ -567,6 +592,7 @@ TEST_MAIN_SOURCES =                                                     \
   logging/event_logger_test.cc                                          \
   memory/arena_test.cc                                                  \
   memory/memory_allocator_test.cc                                       \
+  memtable/concurrent_btree_test.cc                                     \
   memtable/inlineskiplist_test.cc                                       \
   memtable/skiplist_test.cc                                             \
   memtable/write_buffer_manager_test.cc                                 \
@@ -622,14 +648,18 @@ TEST_MAIN_SOURCES =                                                     \
   util/udt_util_test.cc                                                 \
   util/work_queue_test.cc                                               \
   utilities/agg_merge/agg_merge_test.cc                                 \
+  utilities/async_get_queue/async_get_queue_test.cc                     \
   utilities/backup/backup_engine_test.cc                                \
+  utilities/batched_get_db/batched_get_db_test.cc                       \
   utilities/blob_db/blob_db_test.cc                                     \
+  utilities/bulk_loader/bulk_loader_test.cc                             \
   utilities/cassandra/cassandra_format_test.cc                          \
   utilities/cassandra/cassandra_functional_test.cc                      \
   utilities/cassandra/cassandra_row_merge_test.cc                       \
   utilities/cassandra/cassandra_serialize_test.cc                       \
   utilities/checkpoint/checkpoint_test.cc                               \
   utilities/env_timed_test.cc                                           \
+  utilities/io_scheduler/io_scheduler_test.cc                           \
   utilities/memory/memory_test.cc                                       \
   utilities/merge_operators/string_append/stringappend_test.cc          \
   utilities/object_registry_test.cc                                     \
@@ -637,10 +667,14 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/options/options_util_test.cc                                \
   utilities/persistent_cache/hash_table_test.cc                         \
   utilities/persistent_cache/persistent_cache_test.cc                   \
+  utilities/remote_compaction/remote_compaction_service_test.cc         \
+  utilities/result_cache_db/result_cache_db_test.cc                     \
+  utilities/sharded_db/sharded_db_manager_test.cc                       \
   utilities/simulator_cache/cache_simulator_test.cc                     \
   utilities/simulator_cache/sim_cache_test.cc                           \
   utilities/table_properties_collectors/compact_for_tiering_collector_test.cc \
   utilities/table_properties_collectors/compact_on_deletion_collector_test.cc  \
+  utilities/tiered_file_system/tiered_file_system_test.cc               \
   utilities/transactions/optimistic_transaction_test.cc                 \
   utilities/transactions/lock/range/range_locking_test.cc               \
   utilities/transactions/transaction_test.cc                            \
@@ -663,6 +697,8 @@ WITH_FAISS_TEST_MAIN_SOURCES =                                          \
 MICROBENCH_SOURCES =                                          \
   microbench/ribbon_bench.cc                                  \
   microbench/db_basic_bench.cc                                \
+  microbench/get_allocation_bench.cc                          \
+  microbench/hot_path_bench.cc                                \
 
 JNI_NATIVE_SOURCES =                                          \
   java/rocksjni/backupenginejni.cc                            \
@@ -11,7 +11,12 @@
 
 #include "table/block_based/block.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include <algorithm>
+#include <limits>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -20,10 +25,12 @@
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/comparator.h"
+#include "table/block_based/block_learned_index.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
 #include "table/format.h"
 #include "util/coding.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -307,7 +314,9 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = restart_key_prefixes_ != nullptr
+                ? BinarySeekWithKeyPrefixes(seek_key, &index, &skip_linear_scan)
+                : BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -494,6 +503,8 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (learned_index_) {
+    ok = LearnedSeek(seek_key, &index, &skip_linear_scan);
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -514,7 +525,9 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = restart_key_prefixes_ != nullptr
+                ? BinarySeekWithKeyPrefixes(seek_key, &index, &skip_linear_scan)
+                : BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -716,12 +729,30 @@ bool DataBlockIter::ParseNextDataKey(bool* is_shared) {
 
 bool IndexBlockIter::ParseNextIndexKey() {
   bool is_shared = false;
+  uint32_t compact_restart = num_restarts_;
+  if (compact_handle_offsets_ != nullptr) {
+    // Restart entries of compact index blocks may have shared key bytes, so
+    // they are found by their offsets
+    if (value_.empty()) {
+      // Positioned by SeekToRestartPoint()
+      compact_restart = restart_index_;
+    } else if (NextEntryOffset() == next_compact_restart_offset_) {
+      compact_restart = next_compact_restart_;
+    }
+    if (compact_restart < num_restarts_) {
+      next_compact_restart_ = compact_restart + 1;
+      next_compact_restart_offset_ =
+          next_compact_restart_ < num_restarts_
+              ? GetRestartPoint(next_compact_restart_)
+              : restarts_;
+    }
+  }
   bool ok = (value_delta_encoded_) ? ParseNextKey<DecodeEntryV4>(&is_shared)
                                    : ParseNextKey<DecodeEntry>(&is_shared);
   if (ok) {
     if (value_delta_encoded_ || global_seqno_state_ != nullptr ||
         pad_min_timestamp_) {
-      DecodeCurrentValue(is_shared);
+      DecodeCurrentValue(is_shared, compact_restart);
     }
   }
   return ok;
@@ -738,12 +769,33 @@ bool IndexBlockIter::ParseNextIndexKey() {
 // is_shared is false, which included the first entry in each restart point.
 // Otherwise, the format is delta-size = the size of current block - the size o
 // last block.
-void IndexBlockIter::DecodeCurrentValue(bool is_shared) {
+// In compact index blocks, the value of each restart entry is the size of
+// its block, with the offset in compact_handle_offsets_, and the other
+// values are delta encoded whether or not their keys have shared bytes.
+void IndexBlockIter::DecodeCurrentValue(bool is_shared,
+                                        uint32_t compact_restart) {
   Slice v(value_.data(), data_ + restarts_ - value_.data());
-  // Delta encoding is used if `shared` != 0.
-  Status decode_s __attribute__((__unused__)) = decoded_value_.DecodeFrom(
-      &v, have_first_key_,
-      (value_delta_encoded_ && is_shared) ? &decoded_value_.handle : nullptr);
+  Status decode_s __attribute__((__unused__));
+  if (compact_restart < num_restarts_) {
+    uint64_t size = 0;
+    if (!GetVarint64(&v, &size)) {
+      decode_s = Status::Corruption("bad compact index value");
+    } else if (!have_first_key_) {
+      decoded_value_.first_internal_key = Slice();
+    } else if (!GetLengthPrefixedSlice(&v,
+                                       &decoded_value_.first_internal_key)) {
+      decode_s = Status::Corruption("bad first key in block info");
+    }
+    decoded_value_.handle =
+        BlockHandle(compact_handle_offsets_->Get(compact_restart), size);
+  } else {
+    // Delta encoding is used if `shared` != 0, or in compact index blocks.
+    const bool delta_encoded =
+        value_delta_encoded_ &&
+        (is_shared || compact_handle_offsets_ != nullptr);
+    decode_s = decoded_value_.DecodeFrom(
+        &v, have_first_key_, delta_encoded ? &decoded_value_.handle : nullptr);
+  }
   assert(decode_s.ok());
   value_ = Slice(value_.data(), v.data() - value_.data());
 
@@ -838,6 +890,17 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
     return false;
   }
 
+  return BinarySeekInRange<DecodeKeyFunc>(target, -1, num_restarts_ - 1, index,
+                                         skip_linear_scan);
+}
+
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::BinarySeekInRange(const Slice& target, int64_t left,
+                                          int64_t right, uint32_t* index,
+                                          bool* skip_linear_scan) {
+  assert(restarts_ > 0);
+  assert(left >= -1 && left <= right && right < int64_t{num_restarts_});
   *skip_linear_scan = false;
   // Loop invariants:
   // - Restart key at index `left` is less than or equal to the target key. The
@@ -845,7 +908,6 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -885,6 +947,79 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   return true;
 }
 
+namespace {
+// Counts the entries of the sorted key prefix array `prefixes` of
+// `num_restarts` entries that are less than `prefix`, and in `*num_not_greater`
+// the ones that are not greater than it. Stops at the first entries greater
+// than `prefix`, so the cost is in the number of restart points before the
+// target.
+uint32_t CountRestartKeyPrefixes(const char* prefixes, uint32_t num_restarts,
+                                 uint64_t prefix, uint32_t* num_not_greater) {
+  uint32_t num_less = 0;
+  uint32_t num_not_greater_so_far = 0;
+  uint32_t i = 0;
+#ifdef __AVX2__
+  // Entries are little-endian, so they load as they are. Unsigned order is
+  // compared as signed order, with the sign bits flipped.
+  const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  const __m256i target = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<int64_t>(prefix)), sign);
+  for (; i + 4 <= num_restarts; i += 4) {
+    const __m256i entries = _mm256_xor_si256(
+        _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(prefixes + i * sizeof(uint64_t))),
+        sign);
+    const int less = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(target, entries)));
+    const int greater = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(entries, target)));
+    num_less += static_cast<uint32_t>(BitsSetToOne(less));
+    num_not_greater_so_far += 4 - static_cast<uint32_t>(BitsSetToOne(greater));
+    if (greater != 0) {
+      *num_not_greater = num_not_greater_so_far;
+      return num_less;
+    }
+  }
+#endif
+  for (; i < num_restarts; i++) {
+    const uint64_t entry = DecodeFixed64(prefixes + i * sizeof(uint64_t));
+    if (entry > prefix) {
+      break;
+    }
+    num_less += entry < prefix;
+    num_not_greater_so_far++;
+  }
+  *num_not_greater = num_not_greater_so_far;
+  return num_less;
+}
+}  // namespace
+
+bool DataBlockIter::BinarySeekWithKeyPrefixes(const Slice& target,
+                                              uint32_t* index,
+                                              bool* skip_linear_scan) {
+  assert(restart_key_prefixes_ != nullptr);
+  if (restarts_ == 0) {
+    // See BinarySeek()
+    return false;
+  }
+  // Prefixes don't decrease with the keys, so a restart key with a smaller
+  // prefix than the target is less than it, and one with a larger prefix is
+  // greater.
+  uint32_t num_not_greater = 0;
+  const uint32_t num_less = CountRestartKeyPrefixes(
+      restart_key_prefixes_, num_restarts_,
+      RestartKeyPrefix(ExtractUserKey(target)), &num_not_greater);
+  if (num_not_greater == 0) {
+    // All restart keys are greater than the target
+    *skip_linear_scan = true;
+    *index = 0;
+    return true;
+  }
+  return BinarySeekInRange<DecodeKey>(target, int64_t{num_less} - 1,
+                                      int64_t{num_not_greater} - 1, index,
+                                      skip_linear_scan);
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
@@ -905,6 +1040,54 @@ int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   return CompareCurrentKey(target);
 }
 
+bool IndexBlockIter::LearnedSeek(const Slice& target, uint32_t* index,
+                                 bool* skip_linear_scan) {
+  assert(learned_index_);
+  if (restarts_ == 0) {
+    // See BinarySeek()
+    return false;
+  }
+  if (learned_index_->num_restarts() == num_restarts_) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    learned_index_->Predict(
+        raw_key_.IsUserKey() ? target : ExtractUserKey(target), &first, &last);
+    // Same loop invariants as BinarySeek(), if the restart points just
+    // outside [first, last] confirm the prediction
+    int64_t left = -1;
+    int64_t right = last;
+    bool predicted = true;
+    if (first > 0) {
+      int cmp = CompareBlockKey(first, target);
+      if (!status_.ok()) {
+        return false;
+      }
+      predicted = cmp <= 0;
+      left = first;
+    }
+    if (predicted && last + 1 < num_restarts_) {
+      int cmp = CompareBlockKey(last + 1, target);
+      if (!status_.ok()) {
+        return false;
+      }
+      predicted = cmp > 0;
+    }
+    if (predicted) {
+      if (value_delta_encoded_) {
+        return BinarySeekInRange<DecodeKeyV4>(target, left, right, index,
+                                              skip_linear_scan);
+      }
+      return BinarySeekInRange<DecodeKey>(target, left, right, index,
+                                          skip_linear_scan);
+    }
+  }
+  // The keys are not where the model predicts them
+  if (value_delta_encoded_) {
+    return BinarySeek<DecodeKeyV4>(target, index, skip_linear_scan);
+  }
+  return BinarySeek<DecodeKey>(target, index, skip_linear_scan);
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool IndexBlockIter::BinaryBlockIndexSeek(const Slice& target,
@@ -1020,6 +1203,10 @@ uint32_t Block::NumRestarts() const {
   uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
   uint32_t num_restarts = block_footer;
   if (size_ > kMaxBlockSizeSupportedByHashIndex) {
+    if (block_footer & kCompactIndexBlockFlag) {
+      // See kCompactIndexBlockFlag
+      return block_footer & ~kCompactIndexBlockFlag;
+    }
     // In BlockBuilder, we have ensured a block with HashIndex is less than
     // kMaxBlockSizeSupportedByHashIndex (64KiB).
     //
@@ -1072,6 +1259,11 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
     num_restarts_ = NumRestarts();
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
+        if (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) &
+            kCompactIndexBlockFlag) {
+          InitializeCompactIndex();
+          break;
+        }
         restart_offset_ = static_cast<uint32_t>(size_) -
                           (1 + num_restarts_) * sizeof(uint32_t);
         if (restart_offset_ > size_ - sizeof(uint32_t)) {
@@ -1102,6 +1294,20 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
           break;
         }
         break;
+      case BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes: {
+        // The key prefix array is between the restart array and the footer
+        const uint64_t trailer_size =
+            sizeof(uint32_t) +
+            uint64_t{num_restarts_} * (sizeof(uint32_t) + sizeof(uint64_t));
+        if (trailer_size > size_) {
+          size_ = 0;
+          break;
+        }
+        restart_offset_ = static_cast<uint32_t>(size_ - trailer_size);
+        restart_key_prefixes_ =
+            data_ + restart_offset_ + num_restarts_ * sizeof(uint32_t);
+        break;
+      }
       default:
         size_ = 0;  // Error marker
     }
@@ -1112,6 +1318,33 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
   }
 }
 
+void Block::InitializeCompactIndex() {
+  // The trailer is everything after the entries but the entries size and the
+  // footer
+  const size_t kFixedTrailerSize = 2 * sizeof(uint32_t);
+  if (size_ < kFixedTrailerSize) {
+    size_ = 0;
+    return;
+  }
+  const uint32_t entries_size =
+      DecodeFixed32(data_ + size_ - kFixedTrailerSize);
+  if (entries_size > size_ - kFixedTrailerSize) {
+    size_ = 0;
+    return;
+  }
+  Slice trailer(data_ + entries_size, size_ - kFixedTrailerSize - entries_size);
+  if (!compact_restarts_.Init(&trailer) ||
+      !compact_handle_offsets_.Init(&trailer) || !trailer.empty() ||
+      num_restarts_ == 0 || compact_restarts_.size() != num_restarts_ ||
+      compact_handle_offsets_.size() != num_restarts_ ||
+      compact_restarts_.Get(num_restarts_ - 1) >= entries_size) {
+    size_ = 0;
+    return;
+  }
+  restart_offset_ = entries_size;
+  compact_index_ = true;
+}
+
 void Block::InitializeDataBlockProtectionInfo(uint8_t protection_bytes_per_key,
                                               const Comparator* raw_ucmp) {
   protection_bytes_per_key_ = 0;
@@ -1246,6 +1479,8 @@ MetaBlockIter* Block::NewMetaIterator(bool block_contents_pinned) {
   } else if (num_restarts_ == 0) {
     // Empty block.
     iter->Invalidate(Status::OK());
+  } else if (compact_index_) {
+    iter->Invalidate(Status::Corruption("compact index block in meta block"));
   } else {
     iter->Initialize(data_, restart_offset_, num_restarts_,
                      block_contents_pinned, protection_bytes_per_key_,
@@ -1273,13 +1508,18 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
     // Empty block.
     ret_iter->Invalidate(Status::OK());
     return ret_iter;
+  } else if (compact_index_) {
+    ret_iter->Invalidate(
+        Status::Corruption("compact index block in data block"));
+    return ret_iter;
   } else {
     ret_iter->Initialize(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         read_amp_bitmap_.get(), block_contents_pinned,
         user_defined_timestamps_persisted,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        restart_key_prefixes_, protection_bytes_per_key_, kv_checksum_,
+        block_restart_interval_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1296,7 +1536,7 @@ IndexBlockIter* Block::NewIndexIterator(
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
     bool block_contents_pinned, bool user_defined_timestamps_persisted,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index, const BlockLearnedIndex* learned_index) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1316,9 +1556,18 @@ IndexBlockIter* Block::NewIndexIterator(
         total_order_seek ? nullptr : prefix_index;
     ret_iter->Initialize(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
-        prefix_index_ptr, have_first_key, key_includes_seq, value_is_full,
-        block_contents_pinned, user_defined_timestamps_persisted,
+        prefix_index_ptr, learned_index, have_first_key, key_includes_seq,
+        value_is_full, block_contents_pinned, user_defined_timestamps_persisted,
         protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+    if (compact_index_) {
+      if (value_is_full) {
+        ret_iter->Invalidate(Status::Corruption(
+            "compact index block without delta encoded values"));
+      } else {
+        ret_iter->InitializeCompactIndex(&compact_restarts_,
+                                         &compact_handle_offsets_);
+      }
+    }
   }
 
   return ret_iter;
@@ -24,6 +24,7 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_hash_index.h"
+#include "table/block_based/elias_fano.h"
 #include "table/format.h"
 #include "table/internal_iterator.h"
 #include "test_util/sync_point.h"
@@ -37,6 +38,7 @@ template <class TValue>
 class BlockIter;
 class DataBlockIter;
 class IndexBlockIter;
+class BlockLearnedIndex;
 class MetaBlockIter;
 class BlockPrefixIndex;
 
@@ -227,6 +229,9 @@ class Block {
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
   //
+  // If `learned_index` is not nullptr, seeks only binary search the restart
+  // points around the one it predicts.
+  //
   // `have_first_key` controls whether IndexValue will contain
   // first_internal_key. It affects data serialization format, so the same value
   // have_first_key must be used when writing and reading index.
@@ -239,7 +244,8 @@ class Block {
       bool have_first_key, bool key_includes_seq, bool value_is_full,
       bool block_contents_pinned = false,
       bool user_defined_timestamps_persisted = true,
-      BlockPrefixIndex* prefix_index = nullptr);
+      BlockPrefixIndex* prefix_index = nullptr,
+      const BlockLearnedIndex* learned_index = nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -288,6 +294,15 @@ class Block {
   uint32_t block_restart_interval_{0};
   uint8_t protection_bytes_per_key_{0};
   DataBlockHashIndex data_block_hash_index_;
+  // Key prefix array of a kDataBlockBinarySearchWithKeyPrefixes block
+  const char* restart_key_prefixes_{nullptr};
+  // Of a compact index block, see BlockBuilder
+  bool compact_index_{false};
+  EliasFanoSequence compact_restarts_;
+  EliasFanoSequence compact_handle_offsets_;
+
+  // Sets up a compact index block, or marks it as bad
+  void InitializeCompactIndex();
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -427,6 +442,11 @@ class BlockIter : public InternalIteratorBase<TValue> {
 
   Cache::Handle* cache_handle() { return cache_handle_; }
 
+  // Whether `s` lies within the entries of the block
+  bool Contains(const Slice& s) const {
+    return s.data() >= data_ && s.data() + s.size() <= data_ + restarts_;
+  }
+
  protected:
   std::unique_ptr<InternalKeyComparator> icmp_;
   const char* data_;       // underlying block contents
@@ -435,6 +455,9 @@ class BlockIter : public InternalIteratorBase<TValue> {
   // Index of restart block in which current_ or current_-1 falls
   uint32_t restart_index_;
   uint32_t restarts_;  // Offset of restart array (list of fixed32)
+  // The restart array of a compact index block, instead of the one at
+  // restarts_, which is then the end of the entries
+  const EliasFanoSequence* compact_restarts_ = nullptr;
   // current_ is offset in data_ of current entry.  >= restarts_ if !Valid
   uint32_t current_;
   // Raw key from block.
@@ -534,6 +557,7 @@ class BlockIter : public InternalIteratorBase<TValue> {
     icmp_ = std::make_unique<InternalKeyComparator>(raw_ucmp);
     data_ = data;
     restarts_ = restarts;
+    compact_restarts_ = nullptr;
     num_restarts_ = num_restarts;
     current_ = restarts_;
     restart_index_ = num_restarts_;
@@ -651,6 +675,9 @@ class BlockIter : public InternalIteratorBase<TValue> {
 
   uint32_t GetRestartPoint(uint32_t index) const {
     assert(index < num_restarts_);
+    if (compact_restarts_ != nullptr) {
+      return static_cast<uint32_t>(compact_restarts_->Get(index));
+    }
     return DecodeFixed32(data_ + restarts_ + index * sizeof(uint32_t));
   }
 
@@ -669,6 +696,15 @@ class BlockIter : public InternalIteratorBase<TValue> {
   inline bool BinarySeek(const Slice& target, uint32_t* index,
                          bool* is_index_key_result);
 
+  // Like BinarySeek(), but only searches the restart points in
+  // (`left`, `right`], which the caller knows to hold the result: the restart
+  // key at `left` is less than or equal to the target key, if `left` is not
+  // -1, and the restart keys after `right` are greater than it.
+  template <typename DecodeKeyFunc>
+  inline bool BinarySeekInRange(const Slice& target, int64_t left,
+                                int64_t right, uint32_t* index,
+                                bool* is_index_key_result);
+
   // Find the first key in restart interval `index` that is >= `target`.
   // If there is no such key, iterator is positioned at the first key in
   // restart interval `index + 1`.
@@ -693,6 +729,7 @@ class DataBlockIter final : public BlockIter<Slice> {
                   bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   DataBlockHashIndex* data_block_hash_index,
+                  const char* restart_key_prefixes,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
                   uint32_t block_restart_interval) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
@@ -703,6 +740,7 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    restart_key_prefixes_ = restart_key_prefixes;
   }
 
   Slice value() const override {
@@ -779,8 +817,14 @@ class DataBlockIter final : public BlockIter<Slice> {
   int32_t prev_entries_idx_ = -1;
 
   DataBlockHashIndex* data_block_hash_index_;
+  // RestartKeyPrefix() of each restart point, if the block has them
+  const char* restart_key_prefixes_ = nullptr;
 
   bool SeekForGetImpl(const Slice& target);
+  // Like BinarySeek(), but first narrows down the restart points to the ones
+  // whose key prefix is the one of `target`.
+  bool BinarySeekWithKeyPrefixes(const Slice& target, uint32_t* index,
+                                 bool* skip_linear_scan);
 };
 
 // Iterator over MetaBlocks.  MetaBlocks are similar to Data Blocks and
@@ -825,7 +869,8 @@ class MetaBlockIter final : public BlockIter<Slice> {
 
 class IndexBlockIter final : public BlockIter<IndexValue> {
  public:
-  IndexBlockIter() : BlockIter(), prefix_index_(nullptr) {}
+  IndexBlockIter()
+      : BlockIter(), prefix_index_(nullptr), learned_index_(nullptr) {}
 
   // key_includes_seq, default true, means that the keys are in internal key
   // format.
@@ -834,7 +879,8 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   void Initialize(const Comparator* raw_ucmp, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno, BlockPrefixIndex* prefix_index,
-                  bool have_first_key, bool key_includes_seq,
+                  const BlockLearnedIndex* learned_index, bool have_first_key,
+                  bool key_includes_seq,
                   bool value_is_full, bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
@@ -845,7 +891,9 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                    kv_checksum, block_restart_interval);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
+    learned_index_ = learned_index;
     value_delta_encoded_ = !value_is_full;
+    compact_handle_offsets_ = nullptr;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
       global_seqno_state_.reset(new GlobalSeqnoState(global_seqno));
@@ -854,6 +902,16 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
     }
   }
 
+  // Reads a compact index block, with the restart points and the offsets of
+  // the block handles of the restart entries of the Block. REQUIRES: the
+  // values are delta encoded.
+  void InitializeCompactIndex(const EliasFanoSequence* restarts,
+                              const EliasFanoSequence* handle_offsets) {
+    assert(value_delta_encoded_);
+    compact_restarts_ = restarts;
+    compact_handle_offsets_ = handle_offsets;
+  }
+
   Slice user_key() const override {
     assert(Valid());
     return raw_key_.GetUserKey();
@@ -914,6 +972,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  const BlockLearnedIndex* learned_index_;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -922,6 +981,12 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   // the first value in that restart interval.
   IndexValue decoded_value_;
 
+  // Of a compact index block, the offsets of the block handles of the
+  // restart entries, and the next restart entry after the current one
+  const EliasFanoSequence* compact_handle_offsets_ = nullptr;
+  uint32_t next_compact_restart_ = 0;
+  uint32_t next_compact_restart_offset_ = 0;
+
   // When sequence number overwriting is enabled, this struct contains the seqno
   // to overwrite with, and current first_internal_key with overwritten seqno.
   // This is rarely used, so we put it behind a pointer and only allocate when
@@ -951,13 +1016,20 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
                             uint32_t left, uint32_t right, uint32_t* index,
                             bool* prefix_may_exist);
+  // Like BinarySeek(), but only searches the restart points that
+  // learned_index_ predicts for `target`, unless they turn out not to hold
+  // the result.
+  bool LearnedSeek(const Slice& target, uint32_t* index,
+                   bool* skip_linear_scan);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
 
   inline bool ParseNextIndexKey();
 
   // When value_delta_encoded_ is enabled it decodes the value which is assumed
-  // to be BlockHandle and put it to decoded_value_
-  inline void DecodeCurrentValue(bool is_shared);
+  // to be BlockHandle and put it to decoded_value_. `compact_restart` is the
+  // restart index of the entry of a compact index block, or num_restarts_ if
+  // the entry is not a restart one.
+  inline void DecodeCurrentValue(bool is_shared, uint32_t compact_restart);
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -46,6 +46,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/prefix_block_map.h"
 #include "table/format.h"
 #include "table/meta_blocks.h"
 #include "table/table_builder.h"
@@ -107,6 +108,28 @@ FilterBlockBuilder* CreateFilterBlockBuilder(
   }
 }
 
+// The data block index type to use with `ucmp`, falling back to
+// kDataBlockBinarySearch where the requested one doesn't work with it.
+BlockBasedTableOptions::DataBlockIndexType GetDataBlockIndexType(
+    const BlockBasedTableOptions& table_opt, const Comparator* ucmp) {
+  switch (table_opt.data_block_index_type) {
+    case BlockBasedTableOptions::kDataBlockBinaryAndHash:
+      if (ucmp->CanKeysWithDifferentByteContentsBeEqual()) {
+        return BlockBasedTableOptions::kDataBlockBinarySearch;
+      }
+      break;
+    case BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes:
+      // Key prefixes are ordered bytewise
+      if (ucmp != BytewiseComparator()) {
+        return BlockBasedTableOptions::kDataBlockBinarySearch;
+      }
+      break;
+    default:
+      break;
+  }
+  return table_opt.data_block_index_type;
+}
+
 }  // namespace
 
 // kBlockBasedTableMagicNumber was picked by running
@@ -230,6 +253,22 @@ struct BlockBasedTableBuilder::Rep {
   std::string last_ikey;  // Internal key or empty (unset)
   const Slice* first_key_in_next_block = nullptr;
   bool warm_cache = false;
+  // Whether warm_cache is on for a compaction output, in which case
+  // ShouldWarmBlock() applies the prepopulate_block_cache_compaction_* limits.
+  bool warm_cache_for_compaction = false;
+  // Bytes of data blocks prepopulated, possibly shared with the other outputs
+  // of the same compaction job (TableBuilderOptions).
+  std::atomic<uint64_t>* prepopulated_data_block_bytes = nullptr;
+  std::atomic<uint64_t> own_prepopulated_data_block_bytes{0};
+  // Set with prepopulate_block_cache_compaction_hot_ranges_only and
+  // tbo.hot_key_ranges, in which case only the data blocks with a key in one
+  // of these ranges are prepopulated
+  const std::vector<TableReader::HotKeyRange>* hot_key_ranges = nullptr;
+  // The first of `hot_key_ranges` that does not end before the last key
+  // checked
+  size_t next_hot_key_range = 0;
+  // Whether a key of the data block being written is in `hot_key_ranges`
+  bool data_block_hot = false;
 
   uint64_t sample_for_compression;
   std::atomic<uint64_t> compressible_input_data_bytes;
@@ -247,8 +286,13 @@ struct BlockBasedTableBuilder::Rep {
 
   // A compressor for blocks in general, without dictionary compression
   std::unique_ptr<Compressor> basic_compressor;
-  // A compressor using dictionary compression (when applicable)
-  std::unique_ptr<Compressor> compressor_with_dict;
+  // A compressor using dictionary compression (when applicable). Shared
+  // when the dictionary is reused across files.
+  std::shared_ptr<Compressor> compressor_with_dict;
+  // Where to save a dictionary trained for this file for reuse by later
+  // files, under `compression_dict_cache_key` (when non-nullptr)
+  CompressionDictCache* compression_dict_cache = nullptr;
+  std::string compression_dict_cache_key;
   // Once configured/determined, points to one of the above Compressors to
   // use on data blocks.
   Compressor* data_block_compressor = nullptr;
@@ -307,6 +351,18 @@ struct BlockBasedTableBuilder::Rep {
       compression_dict_buffer_cache_res_mgr;
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
+  // The full filter being built by StartBackgroundFilterBuild()
+  struct BackgroundFilterBuild {
+    port::Thread thread;
+    Status status;
+    Slice filter_content;
+    std::unique_ptr<const char[]> filter_owner;
+  };
+  std::unique_ptr<BackgroundFilterBuild> background_filter_build;
+  // Set with table_options.prefix_block_map and a prefix extractor
+  std::unique_ptr<PrefixBlockMap::Builder> prefix_block_map_builder;
+  // Set with tbo.hash_index_builder
+  FileHashIndex::Builder* const hash_index_builder;
   OffsetableCacheKey base_cache_key;
   const TableFileCreationReason reason;
 
@@ -388,6 +444,58 @@ struct BlockBasedTableBuilder::Rep {
     }
   }
 
+  // Called with each key of a data block, in order, before the block is
+  // written. REQUIRES: hot_key_ranges != nullptr
+  void CheckHotKeyRanges(const Slice& ikey) {
+    if (data_block_hot) {
+      return;
+    }
+    const Comparator* ucmp = internal_comparator.user_comparator();
+    const Slice user_key = ExtractUserKey(ikey);
+    while (next_hot_key_range < hot_key_ranges->size() &&
+           ucmp->CompareWithoutTimestamp(
+               (*hot_key_ranges)[next_hot_key_range].largest, user_key) < 0) {
+      ++next_hot_key_range;
+    }
+    data_block_hot =
+        next_hot_key_range < hot_key_ranges->size() &&
+        ucmp->CompareWithoutTimestamp(
+            (*hot_key_ranges)[next_hot_key_range].smallest, user_key) <= 0;
+  }
+
+  // Whether a block about to be written should be inserted into the block
+  // cache. REQUIRES: warm_cache
+  bool ShouldWarmBlock(BlockType block_type, size_t block_size) {
+    assert(warm_cache);
+    if (!warm_cache_for_compaction || block_type != BlockType::kData) {
+      return true;
+    }
+    if (table_options.prepopulate_block_cache_compaction_metadata_only) {
+      return false;
+    }
+    if (hot_key_ranges != nullptr) {
+      const bool hot = data_block_hot;
+      data_block_hot = false;
+      if (!hot) {
+        return false;
+      }
+    }
+    const uint64_t max_bytes =
+        table_options.prepopulate_block_cache_compaction_max_bytes;
+    if (max_bytes == 0) {
+      return true;
+    }
+    uint64_t used =
+        prepopulated_data_block_bytes->load(std::memory_order_relaxed);
+    do {
+      if (used + block_size > max_bytes) {
+        return false;
+      }
+    } while (!prepopulated_data_block_bytes->compare_exchange_weak(
+        used, used + block_size, std::memory_order_relaxed));
+    return true;
+  }
+
   // Never erase an existing I/O status that is not OK.
   // Calling this will also SetStatus(ios)
   void SetIOStatus(IOStatus ios) {
@@ -421,10 +529,9 @@ struct BlockBasedTableBuilder::Rep {
         data_block(table_options.block_restart_interval,
                    table_options.use_delta_encoding,
                    false /* use_value_delta_encoding */,
-                   tbo.internal_comparator.user_comparator()
-                           ->CanKeysWithDifferentByteContentsBeEqual()
-                       ? BlockBasedTableOptions::kDataBlockBinarySearch
-                       : table_options.data_block_index_type,
+                   GetDataBlockIndexType(
+                       table_options,
+                       tbo.internal_comparator.user_comparator()),
                    table_options.data_block_hash_table_util_ratio, ts_sz,
                    persist_user_defined_timestamps),
         range_del_block(
@@ -444,8 +551,11 @@ struct BlockBasedTableBuilder::Rep {
         max_compressed_bytes_per_kb(
             tbo.compression_opts.max_compressed_bytes_per_kb),
         data_block_working_areas(compression_parallel_threads),
-        use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
-                                            !table_opt.block_align),
+        use_delta_encoding_for_index_values(
+            table_opt.format_version >= 4 && !table_opt.block_align &&
+            !table_opt.avoid_data_block_page_crossing &&
+            table_opt.data_block_fetch_unit_size == 0),
+        hash_index_builder(tbo.hash_index_builder),
         reason(tbo.reason),
         flush_block_policy(
             table_options.flush_block_policy_factory->NewFlushBlockPolicy(
@@ -540,6 +650,17 @@ struct BlockBasedTableBuilder::Rep {
       case BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly:
         warm_cache = (reason == TableFileCreationReason::kFlush);
         break;
+      case BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndCompaction:
+        if (reason == TableFileCreationReason::kCompaction) {
+          const int max_level =
+              table_options.prepopulate_block_cache_compaction_max_level;
+          warm_cache_for_compaction =
+              max_level < 0 || tbo.level_at_creation <= max_level;
+          warm_cache = warm_cache_for_compaction;
+        } else {
+          warm_cache = (reason == TableFileCreationReason::kFlush);
+        }
+        break;
       case BlockBasedTableOptions::PrepopulateBlockCache::kDisable:
         warm_cache = false;
         break;
@@ -548,6 +669,15 @@ struct BlockBasedTableBuilder::Rep {
         assert(false);
         warm_cache = false;
     }
+    if (warm_cache_for_compaction &&
+        !table_options.prepopulate_block_cache_compaction_metadata_only &&
+        table_options.prepopulate_block_cache_compaction_hot_ranges_only) {
+      hot_key_ranges = tbo.hot_key_ranges;
+    }
+    prepopulated_data_block_bytes =
+        tbo.prepopulated_data_block_bytes != nullptr
+            ? tbo.prepopulated_data_block_bytes
+            : &own_prepopulated_data_block_bytes;
 
     const auto compress_dict_build_buffer_charged =
         table_options.cache_usage_options.options_overrides
@@ -594,6 +724,10 @@ struct BlockBasedTableBuilder::Rep {
           use_delta_encoding_for_index_values, p_index_builder_, ts_sz,
           persist_user_defined_timestamps));
     }
+    if (table_options.prefix_block_map && prefix_extractor != nullptr) {
+      prefix_block_map_builder.reset(
+          new PrefixBlockMap::Builder(prefix_extractor.get(), ts_sz));
+    }
 
     assert(tbo.internal_tbl_prop_coll_factories);
     for (auto& factory : *tbo.internal_tbl_prop_coll_factories) {
@@ -967,13 +1101,34 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
 
 BlockBasedTableBuilder::BlockBasedTableBuilder(
     const BlockBasedTableOptions& table_options, const TableBuilderOptions& tbo,
-    WritableFileWriter* file) {
+    WritableFileWriter* file, CompressionDictCache* compression_dict_cache) {
   BlockBasedTableOptions sanitized_table_options(table_options);
   auto ucmp = tbo.internal_comparator.user_comparator();
   assert(ucmp);
   (void)ucmp;  // avoids unused variable error.
   rep_ = new Rep(sanitized_table_options, tbo, file);
 
+  if (rep_->state == Rep::State::kBuffered &&
+      compression_dict_cache != nullptr &&
+      table_options.compression_dict_reuse_files > 0 &&
+      (tbo.reason == TableFileCreationReason::kFlush ||
+       tbo.reason == TableFileCreationReason::kCompaction)) {
+    rep_->compression_dict_cache_key =
+        tbo.db_session_id + "/" + std::to_string(tbo.column_family_id) + "/" +
+        std::to_string(tbo.level_at_creation) + "/" +
+        rep_->props.compression_name + "/" + rep_->props.compression_options;
+    rep_->compressor_with_dict =
+        compression_dict_cache->Lookup(rep_->compression_dict_cache_key);
+    if (rep_->compressor_with_dict) {
+      // Reuse the dictionary of an earlier file instead of buffering data
+      // blocks to train a new one.
+      rep_->state = Rep::State::kUnbuffered;
+      SetUpDataBlockCompressor();
+    } else {
+      rep_->compression_dict_cache = compression_dict_cache;
+    }
+  }
+
   TEST_SYNC_POINT_CALLBACK(
       "BlockBasedTableBuilder::BlockBasedTableBuilder:PreSetupBaseCacheKey",
       const_cast<TableProperties*>(&rep_->props));
@@ -1057,6 +1212,12 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
           r->index_builder->AddIndexEntry(r->last_ikey, &ikey,
                                           r->pending_handle,
                                           &r->index_separator_scratch);
+          if (r->prefix_block_map_builder != nullptr) {
+            r->prefix_block_map_builder->OnDataBlockWritten(r->pending_handle);
+          }
+          if (r->hash_index_builder != nullptr) {
+            r->hash_index_builder->OnDataBlockWritten(r->pending_handle);
+          }
         }
       }
     }
@@ -1086,6 +1247,15 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
     } else {
       if (!r->IsParallelCompressionEnabled()) {
         r->index_builder->OnKeyAdded(ikey);
+        if (r->prefix_block_map_builder != nullptr) {
+          r->prefix_block_map_builder->OnKeyAdded(ikey);
+        }
+        if (r->hash_index_builder != nullptr) {
+          r->hash_index_builder->OnKeyAdded(ikey);
+        }
+        if (r->hot_key_ranges != nullptr) {
+          r->CheckHotKeyRanges(ikey);
+        }
       }
     }
     // TODO offset passed in is not accurate for parallel compression case
@@ -1411,6 +1581,42 @@ void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
   }
   // Old, misleading name of this function: WriteRawBlock
   StopWatch sw(r->ioptions.clock, r->ioptions.stats, WRITE_RAW_BLOCK_MICROS);
+  if (is_data_block && r->table_options.data_block_fetch_unit_size > 0) {
+    // Pad to the next fetch unit rather than have the block span two, unless
+    // it does not fit in one.
+    const uint64_t unit_size = r->table_options.data_block_fetch_unit_size;
+    const uint64_t size = block_contents.size() + kBlockTrailerSize;
+    const uint64_t offset_in_unit = r->get_offset() % unit_size;
+    if (offset_in_unit + size > unit_size && size <= unit_size) {
+      const size_t pad_bytes = static_cast<size_t>(unit_size - offset_in_unit);
+      io_s = r->file->Pad(io_options, pad_bytes);
+      if (!io_s.ok()) {
+        r->SetIOStatus(io_s);
+        return;
+      }
+      r->pre_compression_size += pad_bytes;
+      r->set_offset(r->get_offset() + pad_bytes);
+    }
+  }
+  if (r->table_options.avoid_data_block_page_crossing && is_data_block) {
+    const uint64_t page_size = kDefaultPageSize;
+    const uint64_t size = block_contents.size() + kBlockTrailerSize;
+    const uint64_t offset_in_page = r->get_offset() % page_size;
+    // Pages that the block spans from here, and at least
+    const uint64_t num_pages = (offset_in_page + size + page_size - 1) /
+                               page_size;
+    const uint64_t min_num_pages = (size + page_size - 1) / page_size;
+    if (num_pages > min_num_pages) {
+      const size_t pad_bytes = static_cast<size_t>(page_size - offset_in_page);
+      io_s = r->file->Pad(io_options, pad_bytes);
+      if (!io_s.ok()) {
+        r->SetIOStatus(io_s);
+        return;
+      }
+      r->pre_compression_size += pad_bytes;
+      r->set_offset(r->get_offset() + pad_bytes);
+    }
+  }
   const uint64_t offset = r->get_offset();
   handle->set_offset(offset);
   handle->set_size(block_contents.size());
@@ -1459,7 +1665,8 @@ void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
     }
   }
 
-  if (r->warm_cache) {
+  if (r->warm_cache &&
+      r->ShouldWarmBlock(block_type, uncompressed_block_data->size())) {
     Status s =
         InsertBlockInCacheHelper(*uncompressed_block_data, handle, block_type);
     if (!s.ok()) {
@@ -1527,6 +1734,15 @@ void BlockBasedTableBuilder::BGWorkWriteMaybeCompressedBlock() {
         prev_key_no_ts = key_no_ts;
       }
       r->index_builder->OnKeyAdded(key);
+      if (r->prefix_block_map_builder != nullptr) {
+        r->prefix_block_map_builder->OnKeyAdded(key);
+      }
+      if (r->hash_index_builder != nullptr) {
+        r->hash_index_builder->OnKeyAdded(key);
+      }
+      if (r->hot_key_ranges != nullptr) {
+        r->CheckHotKeyRanges(key);
+      }
     }
     if (r->filter_builder != nullptr) {
       prev_block_last_key_no_ts.assign(prev_key_no_ts.data(),
@@ -1560,6 +1776,12 @@ void BlockBasedTableBuilder::BGWorkWriteMaybeCompressedBlock() {
           block_rep->keys.Back(), &first_key_in_next_block, r->pending_handle,
           &r->index_separator_scratch);
     }
+    if (r->prefix_block_map_builder != nullptr) {
+      r->prefix_block_map_builder->OnDataBlockWritten(r->pending_handle);
+    }
+    if (r->hash_index_builder != nullptr) {
+      r->hash_index_builder->OnDataBlockWritten(r->pending_handle);
+    }
 
     r->pc_rep->ReapBlock(block_rep);
   }
@@ -1622,13 +1844,41 @@ Status BlockBasedTableBuilder::InsertBlockInCacheHelper(
   return s;
 }
 
+bool BlockBasedTableBuilder::StartBackgroundFilterBuild() {
+  Rep* r = rep_;
+  if (!r->table_options.background_filter_build ||
+      r->table_options.partition_filters || r->filter_builder == nullptr ||
+      r->filter_builder->IsEmpty() || !ok()) {
+    return false;
+  }
+  if (!r->last_ikey.empty()) {
+    r->filter_builder->PrevKeyBeforeFinish(
+        ExtractUserKeyAndStripTimestamp(r->last_ikey, r->ts_sz));
+  }
+  r->props.num_filter_entries += r->filter_builder->EstimateEntriesAdded();
+  // Nothing else touches the filter builder until WriteFilterBlock() joins
+  // the thread
+  r->background_filter_build.reset(new Rep::BackgroundFilterBuild());
+  Rep::BackgroundFilterBuild* build = r->background_filter_build.get();
+  FilterBlockBuilder* filter_builder = r->filter_builder.get();
+  build->thread = port::Thread([build, filter_builder] {
+    build->status = filter_builder->Finish(
+        BlockHandle(), &build->filter_content, &build->filter_owner);
+  });
+  return true;
+}
+
 void BlockBasedTableBuilder::WriteFilterBlock(
     MetaIndexBuilder* meta_index_builder) {
-  if (rep_->filter_builder == nullptr || rep_->filter_builder->IsEmpty()) {
+  std::unique_ptr<Rep::BackgroundFilterBuild> build =
+      std::move(rep_->background_filter_build);
+  if (build != nullptr) {
+    build->thread.join();
+  } else if (rep_->filter_builder == nullptr ||
+             rep_->filter_builder->IsEmpty()) {
     // No filter block needed
     return;
-  }
-  if (!rep_->last_ikey.empty()) {
+  } else if (!rep_->last_ikey.empty()) {
     // We might have been using AddWithPrevKey, so need PrevKeyBeforeFinish
     // to be safe. And because we are re-synchronized after buffered/parallel
     // operation, rep_->last_ikey is accurate.
@@ -1637,7 +1887,17 @@ void BlockBasedTableBuilder::WriteFilterBlock(
   }
   BlockHandle filter_block_handle;
   bool is_partitioned_filter = rep_->table_options.partition_filters;
-  if (ok()) {
+  if (build != nullptr) {
+    assert(build->status.ok() || build->status.IsCorruption());
+    if (!build->status.ok()) {
+      rep_->SetStatus(build->status);
+    } else if (ok()) {
+      rep_->props.filter_size += build->filter_content.size();
+      WriteMaybeCompressedBlock(build->filter_content, kNoCompression,
+                                &filter_block_handle, BlockType::kFilter);
+    }
+    rep_->filter_builder->ResetFilterBitsBuilder();
+  } else if (ok()) {
     rep_->props.num_filter_entries +=
         rep_->filter_builder->EstimateEntriesAdded();
     Status s = Status::Incomplete();
@@ -1890,6 +2150,17 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WritePrefixBlockMap(
+    MetaIndexBuilder* meta_index_builder) {
+  std::string contents;
+  if (ok() && rep_->prefix_block_map_builder != nullptr &&
+      rep_->prefix_block_map_builder->Finish(&contents)) {
+    BlockHandle prefix_block_map_handle;
+    WriteBlock(contents, &prefix_block_map_handle, BlockType::kPrefixBlockMap);
+    meta_index_builder->Add(kPrefixBlockMapBlock, prefix_block_map_handle);
+  }
+}
+
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
                                          BlockHandle& index_block_handle) {
   assert(ok());
@@ -1922,6 +2193,46 @@ void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
   }
 }
 
+void BlockBasedTableBuilder::SetUpDataBlockCompressor() {
+  Rep* r = rep_;
+  // The compressor might opt not to use a dictionary, in which case we
+  // can use the same compressor as for e.g. index blocks.
+  r->data_block_compressor = r->compressor_with_dict
+                                 ? r->compressor_with_dict.get()
+                                 : r->basic_compressor.get();
+  for (uint32_t i = 0; i < r->compression_parallel_threads; i++) {
+    r->data_block_working_areas[i].compress =
+        r->data_block_compressor->ObtainWorkingArea();
+  }
+  Slice serialized_dict = r->data_block_compressor->GetSerializedDict();
+  if (r->verify_decompressor) {
+    if (serialized_dict.empty()) {
+      // No dictionary
+      r->data_block_verify_decompressor = r->verify_decompressor.get();
+    } else {
+      // Get an updated dictionary-aware decompressor for verification.
+      Status s = r->verify_decompressor->MaybeCloneForDict(
+          serialized_dict, &r->verify_decompressor_with_dict);
+      // Dictionary support must be present on the decompressor side if it's on
+      // the compressor side.
+      assert(r->verify_decompressor_with_dict);
+      if (r->verify_decompressor_with_dict) {
+        r->data_block_verify_decompressor =
+            r->verify_decompressor_with_dict.get();
+        for (uint32_t i = 0; i < r->compression_parallel_threads; i++) {
+          r->data_block_working_areas[i].verify =
+              r->data_block_verify_decompressor->ObtainWorkingArea(
+                  r->data_block_compressor->GetPreferredCompressionType());
+        }
+        assert(s.ok());
+      } else {
+        assert(!s.ok());
+        r->SetStatus(s);
+      }
+    }
+  }
+}
+
 void BlockBasedTableBuilder::EnterUnbuffered() {
   Rep* r = rep_;
   assert(r->state == Rep::State::kBuffered);
@@ -1971,42 +2282,12 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
   r->compressor_with_dict = r->basic_compressor->MaybeCloneSpecialized(
       CacheEntryRole::kDataBlock, std::move(samples));
 
-  // The compressor might opt not to use a dictionary, in which case we
-  // can use the same compressor as for e.g. index blocks.
-  r->data_block_compressor = r->compressor_with_dict
-                                 ? r->compressor_with_dict.get()
-                                 : r->basic_compressor.get();
-  for (uint32_t i = 0; i < r->compression_parallel_threads; i++) {
-    r->data_block_working_areas[i].compress =
-        r->data_block_compressor->ObtainWorkingArea();
-  }
-  Slice serialized_dict = r->data_block_compressor->GetSerializedDict();
-  if (r->verify_decompressor) {
-    if (serialized_dict.empty()) {
-      // No dictionary
-      r->data_block_verify_decompressor = r->verify_decompressor.get();
-    } else {
-      // Get an updated dictionary-aware decompressor for verification.
-      Status s = r->verify_decompressor->MaybeCloneForDict(
-          serialized_dict, &r->verify_decompressor_with_dict);
-      // Dictionary support must be present on the decompressor side if it's on
-      // the compressor side.
-      assert(r->verify_decompressor_with_dict);
-      if (r->verify_decompressor_with_dict) {
-        r->data_block_verify_decompressor =
-            r->verify_decompressor_with_dict.get();
-        for (uint32_t i = 0; i < r->compression_parallel_threads; i++) {
-          r->data_block_working_areas[i].verify =
-              r->data_block_verify_decompressor->ObtainWorkingArea(
-                  r->data_block_compressor->GetPreferredCompressionType());
-        }
-        assert(s.ok());
-      } else {
-        assert(!s.ok());
-        r->SetStatus(s);
-      }
-    }
+  if (r->compression_dict_cache != nullptr) {
+    r->compression_dict_cache->Insert(
+        r->compression_dict_cache_key, r->compressor_with_dict,
+        r->table_options.compression_dict_reuse_files);
   }
+  SetUpDataBlockCompressor();
 
   auto get_iterator_for_block = [&r](size_t i) {
     auto& data_block = r->data_block_buffers[i];
@@ -2070,6 +2351,15 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
               ExtractUserKeyAndStripTimestamp(key, r->ts_sz));
         }
         r->index_builder->OnKeyAdded(key);
+        if (r->prefix_block_map_builder != nullptr) {
+          r->prefix_block_map_builder->OnKeyAdded(key);
+        }
+        if (r->hash_index_builder != nullptr) {
+          r->hash_index_builder->OnKeyAdded(key);
+        }
+        if (r->hot_key_ranges != nullptr) {
+          r->CheckHotKeyRanges(key);
+        }
       }
       WriteBlock(Slice(data_block), &r->pending_handle, BlockType::kData);
       if (ok() && i + 1 < r->data_block_buffers.size()) {
@@ -2083,6 +2373,12 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
         r->index_builder->AddIndexEntry(
             iter->key(), first_key_in_next_block_ptr, r->pending_handle,
             &r->index_separator_scratch);
+        if (r->prefix_block_map_builder != nullptr) {
+          r->prefix_block_map_builder->OnDataBlockWritten(r->pending_handle);
+        }
+        if (r->hash_index_builder != nullptr) {
+          r->hash_index_builder->OnDataBlockWritten(r->pending_handle);
+        }
       }
     }
     std::swap(iter, next_block_iter);
@@ -2120,6 +2416,12 @@ Status BlockBasedTableBuilder::Finish() {
       r->index_builder->AddIndexEntry(
           r->last_ikey, nullptr /* no next data block */, r->pending_handle,
           &r->index_separator_scratch);
+      if (r->prefix_block_map_builder != nullptr) {
+        r->prefix_block_map_builder->OnDataBlockWritten(r->pending_handle);
+      }
+      if (r->hash_index_builder != nullptr) {
+        r->hash_index_builder->OnDataBlockWritten(r->pending_handle);
+      }
     }
   }
 
@@ -2133,12 +2435,21 @@ Status BlockBasedTableBuilder::Finish() {
   //    5. [meta block: properties]
   //    6. [metaindex block]
   //    7. Footer
+  // except that a full filter built in the background is written once it is
+  // built, just before the properties.
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
-  WriteFilterBlock(&meta_index_builder);
+  const bool background_filter_build = StartBackgroundFilterBuild();
+  if (!background_filter_build) {
+    WriteFilterBlock(&meta_index_builder);
+  }
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WritePrefixBlockMap(&meta_index_builder);
+  if (background_filter_build) {
+    WriteFilterBlock(&meta_index_builder);
+  }
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
@@ -31,6 +31,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class BlockBuilder;
 class BlockHandle;
+class CompressionDictCache;
 class WritableFile;
 struct BlockBasedTableOptions;
 
@@ -41,10 +42,15 @@ class BlockBasedTableBuilder : public TableBuilder {
  public:
   // Create a builder that will store the contents of the table it is
   // building in *file.  Does not close the file.  It is up to the
-  // caller to close the file after calling Finish().
-  BlockBasedTableBuilder(const BlockBasedTableOptions& table_options,
-                         const TableBuilderOptions& table_builder_options,
-                         WritableFileWriter* file);
+  // caller to close the file after calling Finish(). With a non-null
+  // `compression_dict_cache`, a compression dictionary may be reused from or
+  // saved for other files, see
+  // BlockBasedTableOptions::compression_dict_reuse_files.
+  BlockBasedTableBuilder(
+      const BlockBasedTableOptions& table_options,
+      const TableBuilderOptions& table_builder_options,
+      WritableFileWriter* file,
+      CompressionDictCache* compression_dict_cache = nullptr);
 
   // No copying allowed
   BlockBasedTableBuilder(const BlockBasedTableBuilder&) = delete;
@@ -120,6 +126,10 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: `rep_->state == kBuffered`
   void EnterUnbuffered();
 
+  // Pick the data block compressor, using `rep_->compressor_with_dict` if
+  // set, and set up its working areas and verification.
+  void SetUpDataBlockCompressor();
+
   // Compress and write block content to the file.
   void WriteBlock(const Slice& block_contents, BlockHandle* handle,
                   BlockType block_type);
@@ -142,12 +152,17 @@ class BlockBasedTableBuilder : public TableBuilder {
                                       const CompressionType type,
                                       const BlockHandle* handle);
 
+  // Starts building the full filter on a helper thread, to be written by
+  // WriteFilterBlock(), see BlockBasedTableOptions::background_filter_build.
+  // Returns false if the filter is to be built by WriteFilterBlock().
+  bool StartBackgroundFilterBuild();
   void WriteFilterBlock(MetaIndexBuilder* meta_index_builder);
   void WriteIndexBlock(MetaIndexBuilder* meta_index_builder,
                        BlockHandle* index_block_handle);
   void WritePropertiesBlock(MetaIndexBuilder* meta_index_builder);
   void WriteCompressionDictBlock(MetaIndexBuilder* meta_index_builder);
   void WriteRangeDelBlock(MetaIndexBuilder* meta_index_builder);
+  void WritePrefixBlockMap(MetaIndexBuilder* meta_index_builder);
   void WriteFooter(BlockHandle& metaindex_block_handle,
                    BlockHandle& index_block_handle);
 
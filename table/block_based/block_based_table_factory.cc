@@ -164,6 +164,34 @@ size_t TailPrefetchStats::GetSuggestedPrefetchSize() {
   return std::min(kMaxPrefetchSize, max_qualified_size);
 }
 
+std::shared_ptr<Compressor> CompressionDictCache::Lookup(
+    const std::string& key) {
+  MutexLock l(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  std::shared_ptr<Compressor> compressor = std::move(it->second.compressor);
+  if (--it->second.remaining_uses > 0) {
+    it->second.compressor = compressor;
+  } else {
+    entries_.erase(it);
+  }
+  return compressor;
+}
+
+void CompressionDictCache::Insert(const std::string& key,
+                                  std::shared_ptr<Compressor> compressor,
+                                  uint32_t max_uses) {
+  if (compressor == nullptr || max_uses == 0) {
+    return;
+  }
+  MutexLock l(&mutex_);
+  Entry& entry = entries_[key];
+  entry.compressor = std::move(compressor);
+  entry.remaining_uses = max_uses;
+}
+
 const std::string kOptNameMetadataCacheOpts = "metadata_cache_options";
 
 static std::unordered_map<std::string, PinningTier>
@@ -180,7 +208,9 @@ static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kLearnedIndexSearch",
+         BlockBasedTableOptions::IndexType::kLearnedIndexSearch}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::DataBlockIndexType>
@@ -188,7 +218,10 @@ static std::unordered_map<std::string,
         {"kDataBlockBinarySearch",
          BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch},
         {"kDataBlockBinaryAndHash",
-         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash}};
+         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash},
+        {"kDataBlockBinarySearchWithKeyPrefixes",
+         BlockBasedTableOptions::DataBlockIndexType::
+             kDataBlockBinarySearchWithKeyPrefixes}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::IndexShorteningMode>
@@ -221,7 +254,9 @@ static std::unordered_map<std::string,
     block_base_table_prepopulate_block_cache_string_map = {
         {"kDisable", BlockBasedTableOptions::PrepopulateBlockCache::kDisable},
         {"kFlushOnly",
-         BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly}};
+         BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly},
+        {"kFlushAndCompaction",
+         BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndCompaction}};
 
 static struct BlockBasedTableTypeInfo {
   std::unordered_map<std::string, OptionTypeInfo> info;
@@ -357,6 +392,22 @@ static struct BlockBasedTableTypeInfo {
         {"block_align",
          {offsetof(struct BlockBasedTableOptions, block_align),
           OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"avoid_data_block_page_crossing",
+         {offsetof(struct BlockBasedTableOptions,
+                   avoid_data_block_page_crossing),
+          OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"data_block_fetch_unit_size",
+         {offsetof(struct BlockBasedTableOptions, data_block_fetch_unit_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal}},
+        {"prefix_block_map",
+         {offsetof(struct BlockBasedTableOptions, prefix_block_map),
+          OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"compact_index_blocks",
+         {offsetof(struct BlockBasedTableOptions, compact_index_blocks),
+          OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"background_filter_build",
+         {offsetof(struct BlockBasedTableOptions, background_filter_build),
+          OptionType::kBoolean, OptionVerificationType::kNormal}},
         {"pin_top_level_index_and_filter",
          {offsetof(struct BlockBasedTableOptions,
                    pin_top_level_index_and_filter),
@@ -385,6 +436,29 @@ static struct BlockBasedTableTypeInfo {
          OptionTypeInfo::Enum<BlockBasedTableOptions::PrepopulateBlockCache>(
              offsetof(struct BlockBasedTableOptions, prepopulate_block_cache),
              &block_base_table_prepopulate_block_cache_string_map)},
+        {"prepopulate_block_cache_compaction_max_level",
+         {offsetof(struct BlockBasedTableOptions,
+                   prepopulate_block_cache_compaction_max_level),
+          OptionType::kInt, OptionVerificationType::kNormal}},
+        {"prepopulate_block_cache_compaction_metadata_only",
+         {offsetof(struct BlockBasedTableOptions,
+                   prepopulate_block_cache_compaction_metadata_only),
+          OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"prepopulate_block_cache_compaction_max_bytes",
+         {offsetof(struct BlockBasedTableOptions,
+                   prepopulate_block_cache_compaction_max_bytes),
+          OptionType::kUInt64T, OptionVerificationType::kNormal}},
+        {"prepopulate_block_cache_compaction_hot_ranges_only",
+         {offsetof(struct BlockBasedTableOptions,
+                   prepopulate_block_cache_compaction_hot_ranges_only),
+          OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"warmup_min_data_block_hits",
+         {offsetof(struct BlockBasedTableOptions, warmup_min_data_block_hits),
+          OptionType::kUInt32T, OptionVerificationType::kNormal}},
+        {"compression_dict_reuse_files",
+         {offsetof(struct BlockBasedTableOptions,
+                   compression_dict_reuse_files),
+          OptionType::kUInt32T, OptionVerificationType::kNormal}},
         {"initial_auto_readahead_size",
          {offsetof(struct BlockBasedTableOptions, initial_auto_readahead_size),
           OptionType::kSizeT, OptionVerificationType::kNormal}},
@@ -578,14 +652,16 @@ Status BlockBasedTableFactory::NewTableReader(
       table_reader_options.max_file_size_for_l0_meta_pin,
       table_reader_options.cur_db_session_id, table_reader_options.cur_file_num,
       table_reader_options.unique_id,
-      table_reader_options.user_defined_timestamps_persisted);
+      table_reader_options.user_defined_timestamps_persisted,
+      table_reader_options.compression_manager);
 }
 
 TableBuilder* BlockBasedTableFactory::NewTableBuilder(
     const TableBuilderOptions& table_builder_options,
     WritableFileWriter* file) const {
   return new BlockBasedTableBuilder(table_options_, table_builder_options,
-                                    file);
+                                    file,
+                                    &shared_state_->compression_dict_cache);
 }
 
 Status BlockBasedTableFactory::ValidateOptions(
@@ -666,7 +742,7 @@ Status BlockBasedTableFactory::ValidateOptions(
         CacheEntryRole::kCompressionDictionaryBuildingBuffer,
         CacheEntryRole::kFilterConstruction,
         CacheEntryRole::kBlockBasedTableReader, CacheEntryRole::kFileMetadata,
-        CacheEntryRole::kBlobCache};
+        CacheEntryRole::kBlobCache, CacheEntryRole::kCompactionBuffer};
     if (options.charged != CacheEntryRoleOptions::Decision::kFallback &&
         kMemoryChargingSupported.count(role) == 0) {
       return Status::NotSupported(
@@ -838,6 +914,22 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  block_align: %d\n",
            table_options_.block_align);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  avoid_data_block_page_crossing: %d\n",
+           table_options_.avoid_data_block_page_crossing);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  data_block_fetch_unit_size: %" PRIu64 "\n",
+           table_options_.data_block_fetch_unit_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  prefix_block_map: %d\n",
+           table_options_.prefix_block_map);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  compact_index_blocks: %d\n",
+           table_options_.compact_index_blocks);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  background_filter_build: %d\n",
+           table_options_.background_filter_build);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize,
            "  max_auto_readahead_size: %" ROCKSDB_PRIszt "\n",
            table_options_.max_auto_readahead_size);
@@ -845,6 +937,29 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  prepopulate_block_cache: %d\n",
            static_cast<int>(table_options_.prepopulate_block_cache));
   ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  prepopulate_block_cache_compaction_max_level: %d\n",
+           table_options_.prepopulate_block_cache_compaction_max_level);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  prepopulate_block_cache_compaction_metadata_only: %d\n",
+           table_options_.prepopulate_block_cache_compaction_metadata_only);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  prepopulate_block_cache_compaction_max_bytes: %" PRIu64 "\n",
+           table_options_.prepopulate_block_cache_compaction_max_bytes);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  prepopulate_block_cache_compaction_hot_ranges_only: %d\n",
+           table_options_.prepopulate_block_cache_compaction_hot_ranges_only);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  warmup_min_data_block_hits: %" PRIu32 "\n",
+           table_options_.warmup_min_data_block_hits);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  compression_dict_reuse_files: %" PRIu32 "\n",
+           table_options_.compression_dict_reuse_files);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize,
            "  initial_auto_readahead_size: %" ROCKSDB_PRIszt "\n",
            table_options_.initial_auto_readahead_size);
@@ -980,6 +1095,8 @@ const std::string BlockBasedTablePropertyNames::kDecoupledPartitionedFilters =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kLearnedIndexModelBlock = "rocksdb.learnedindex.model";
+const std::string kPrefixBlockMapBlock = "rocksdb.prefix.block.map";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "cache/cache_reservation_manager.h"
 #include "port/port.h"
@@ -25,6 +26,7 @@ struct DBOptions;
 struct EnvOptions;
 
 class BlockBasedTableBuilder;
+class Compressor;
 class RandomAccessFileReader;
 class WritableFileWriter;
 
@@ -47,6 +49,28 @@ class TailPrefetchStats {
   size_t num_records_ = 0;
 };
 
+// Compressors with a trained dictionary, kept by table builders for reuse by
+// later files with the same key (column family, level and compression
+// settings). See BlockBasedTableOptions::compression_dict_reuse_files.
+class CompressionDictCache {
+ public:
+  // Returns the compressor saved under `key` and counts one use of it, or
+  // nullptr if there is none or its uses are used up.
+  std::shared_ptr<Compressor> Lookup(const std::string& key);
+  // Saves `compressor` under `key` for the next `max_uses` lookups,
+  // replacing any previous one.
+  void Insert(const std::string& key, std::shared_ptr<Compressor> compressor,
+              uint32_t max_uses);
+
+ private:
+  struct Entry {
+    std::shared_ptr<Compressor> compressor;
+    uint32_t remaining_uses = 0;
+  };
+  port::Mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
 class BlockBasedTableFactory : public TableFactory {
  public:
   explicit BlockBasedTableFactory(
@@ -107,12 +131,15 @@ class BlockBasedTableFactory : public TableFactory {
   struct SharedState {
     std::shared_ptr<CacheReservationManager> table_reader_cache_res_mgr;
     TailPrefetchStats tail_prefetch_stats;
+    CompressionDictCache compression_dict_cache;
   };
   std::shared_ptr<SharedState> shared_state_;
 };
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexModelBlock;
+extern const std::string kPrefixBlockMapBlock;
 extern const std::string kPropTrue;
 extern const std::string kPropFalse;
 }  // namespace ROCKSDB_NAMESPACE
@@ -144,7 +144,9 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
   } else {
     // Need to use the data block.
     if (!same_block) {
-      if (read_options_.async_io && async_prefetch) {
+      // Compactions only use async_io for the readahead of InitDataBlock()
+      if (read_options_.async_io && async_prefetch &&
+          lookup_context_.caller != TableReaderCaller::kCompaction) {
         AsyncInitDataBlock(/*is_first_pass=*/true);
         if (async_read_in_progress_) {
           // Status::TryAgain indicates asynchronous request for retrieval of
@@ -343,6 +345,30 @@ void BlockBasedTableIterator::Prev() {
   FindKeyBackward();
 }
 
+bool BlockBasedTableIterator::PinValue(const Slice& value,
+                                       PinnableSlice* pinned) {
+  assert(Valid());
+  Cache::Handle* handle = block_iter_points_to_real_block_
+                              ? block_iter_.cache_handle()
+                              : nullptr;
+  if (handle == nullptr || !block_iter_.Contains(value)) {
+    return false;
+  }
+  Cache* cache = table_->get_rep()->table_options.block_cache.get();
+  assert(cache != nullptr);
+  if (!cache->Ref(handle)) {
+    return false;
+  }
+  pinned->Reset();
+  pinned->PinSlice(
+      value,
+      [](void* arg1, void* arg2) {
+        static_cast<Cache*>(arg1)->Release(static_cast<Cache::Handle*>(arg2));
+      },
+      cache, handle);
+  return true;
+}
+
 void BlockBasedTableIterator::InitDataBlock() {
   BlockHandle data_block_handle;
   bool is_in_cache = false;
@@ -26,7 +26,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
       const BlockBasedTable* table, const ReadOptions& read_options,
       const InternalKeyComparator& icomp,
       std::unique_ptr<InternalIteratorBase<IndexValue>>&& index_iter,
-      bool check_filter, bool need_upper_bound_check,
+      bool check_filter, bool check_range_filter, bool need_upper_bound_check,
       const SliceTransform* prefix_extractor, TableReaderCaller caller,
       size_t compaction_readahead_size = 0, bool allow_unprepared_value = false)
       : index_iter_(std::move(index_iter)),
@@ -43,6 +43,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
         allow_unprepared_value_(allow_unprepared_value),
         block_iter_points_to_real_block_(false),
         check_filter_(check_filter),
+        check_range_filter_(check_range_filter),
         need_upper_bound_check_(need_upper_bound_check),
         async_read_in_progress_(false),
         is_last_level_(table->IsLastLevel()) {}
@@ -182,6 +183,8 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
            block_iter_points_to_real_block_;
   }
 
+  bool PinValue(const Slice& value, PinnableSlice* pinned) override;
+
   void ResetDataIter() {
     if (block_iter_points_to_real_block_) {
       if (pinned_iters_mgr_ != nullptr && pinned_iters_mgr_->PinningEnabled()) {
@@ -201,6 +204,12 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
     }
   }
 
+  void Prepare(const std::vector<ScanOptions>* scan_opts) override {
+    if (scan_opts != nullptr) {
+      table_->PrepareScans(read_options_, *scan_opts);
+    }
+  }
+
   void GetReadaheadState(ReadaheadFileInfo* readahead_file_info) override {
     if (block_prefetcher_.prefetch_buffer() != nullptr &&
         read_options_.adaptive_readahead) {
@@ -321,6 +330,8 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   // that block yet. A call to PrepareValue() will trigger loading the block.
   bool is_at_first_key_from_index_ = false;
   bool check_filter_;
+  // Whether forward seeks check their range against a RangeFilterPolicy
+  bool check_range_filter_;
   // TODO(Zhongyi): pick a better name
   bool need_upper_bound_check_;
 
@@ -379,6 +390,12 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
 
   bool CheckPrefixMayMatch(const Slice& ikey, IterDirection direction,
                            bool* filter_checked) {
+    if (check_range_filter_ && direction == IterDirection::kForward &&
+        !table_->RangeFilterMayMatch(ikey, read_options_, &lookup_context_,
+                                     filter_checked)) {
+      ResetDataIter();
+      return false;
+    }
     if (need_upper_bound_check_ && direction == IterDirection::kBackward) {
       // Upper bound check isn't sufficient for backward direction to
       // guarantee the same result as total order, so disable prefix
@@ -12,6 +12,8 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <string>
@@ -45,6 +47,7 @@
 #include "rocksdb/system_clock.h"
 #include "rocksdb/table.h"
 #include "rocksdb/table_properties.h"
+#include "rocksdb/threadpool.h"
 #include "rocksdb/trace_record.h"
 #include "table/block_based/binary_search_index_reader.h"
 #include "table/block_based/block.h"
@@ -52,10 +55,12 @@
 #include "table/block_based/block_based_table_iterator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/block_type.h"
+#include "table/block_based/file_hash_index.h"
 #include "table/block_based/filter_block.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -71,8 +76,10 @@
 #include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
+#include "util/threadpool_imp.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace {
@@ -83,6 +90,65 @@ CacheAllocationPtr CopyBufferToHeap(MemoryAllocator* allocator, Slice& buf) {
   memcpy(heap_buf.get(), buf.data(), buf.size());
   return heap_buf;
 }
+
+// An index iterator over the one data block that can hold the key of a Get,
+// found in the prefix block map.
+class SingleBlockIndexIterator : public InternalIteratorBase<IndexValue> {
+ public:
+  explicit SingleBlockIndexIterator(const BlockHandle& handle)
+      : handle_(handle) {}
+  bool Valid() const override { return valid_; }
+  void Seek(const Slice& /*target*/) override { valid_ = true; }
+  void SeekForPrev(const Slice& /*target*/) override { valid_ = true; }
+  void SeekToFirst() override { valid_ = true; }
+  void SeekToLast() override { valid_ = true; }
+  void Next() override { valid_ = false; }
+  void Prev() override { valid_ = false; }
+  Slice key() const override {
+    assert(false);
+    return Slice();
+  }
+  IndexValue value() const override {
+    assert(valid_);
+    return IndexValue(handle_, Slice());
+  }
+  Status status() const override { return Status::OK(); }
+
+ private:
+  const BlockHandle handle_;
+  bool valid_ = false;
+};
+
+// An index iterator over the data blocks from the one that the hash index of
+// the file points to for the key of a Get, to the end of the file.
+class HashIndexBlockIterator : public InternalIteratorBase<IndexValue> {
+ public:
+  HashIndexBlockIterator(const FileHashIndex* hash_index, uint32_t first)
+      : hash_index_(hash_index), first_(first), pos_(first) {}
+  bool Valid() const override {
+    return hash_index_ != nullptr && pos_ < hash_index_->num_blocks();
+  }
+  void Seek(const Slice& /*target*/) override { pos_ = first_; }
+  void SeekForPrev(const Slice& /*target*/) override { pos_ = first_; }
+  void SeekToFirst() override { pos_ = first_; }
+  void SeekToLast() override { pos_ = first_; }
+  void Next() override { pos_++; }
+  void Prev() override { pos_ = FileHashIndex::kNotFound; }
+  Slice key() const override {
+    assert(false);
+    return Slice();
+  }
+  IndexValue value() const override {
+    assert(Valid());
+    return IndexValue(hash_index_->block_handle(pos_), Slice());
+  }
+  Status status() const override { return Status::OK(); }
+
+ private:
+  const FileHashIndex* const hash_index_;
+  const uint32_t first_;
+  uint32_t pos_;
+};
 }  // namespace
 
 // Explicitly instantiate templates for each "blocklike" type we use (and
@@ -134,6 +200,8 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexModelBlock;
+extern const std::string kPrefixBlockMapBlock;
 
 BlockBasedTable::~BlockBasedTable() {
   auto ua = rep_->uncache_aggressiveness.LoadRelaxed();
@@ -636,7 +704,8 @@ Status BlockBasedTable::Open(
     BlockCacheTracer* const block_cache_tracer,
     size_t max_file_size_for_l0_meta_pin, const std::string& cur_db_session_id,
     uint64_t cur_file_num, UniqueId64x2 expected_unique_id,
-    const bool user_defined_timestamps_persisted) {
+    const bool user_defined_timestamps_persisted,
+    const std::shared_ptr<CompressionManager>& compression_manager) {
   table_reader->reset();
 
   Status s;
@@ -746,6 +815,11 @@ Status BlockBasedTable::Open(
     return s;
   }
 
+  if (table_options.warmup_min_data_block_hits > 0 && rep->table_properties) {
+    rep->data_block_hits.reset(
+        new DataBlockHitCounter(rep->table_properties->num_data_blocks));
+  }
+
   CompressionType saved_comp_type = CompressionTypeFromString(
       rep->table_properties ? rep->table_properties->compression_name
                             : std::string{});
@@ -753,11 +827,19 @@ Status BlockBasedTable::Open(
     // Includes "unrecognized" or "unspecified" case, including some old files
     // before the compression_name table property was introduced in
     // version 4.9.0
-    // TODO: custom CompressionManager
     auto mgr = GetBuiltinCompressionManager(
         GetCompressFormatForVersion(footer.format_version()));
+    // A custom CompressionManager for the same format, like one offloading
+    // to a hardware accelerator, can decompress the blocks instead
+    if (compression_manager != nullptr &&
+        strcmp(compression_manager->CompatibilityName(),
+               mgr->CompatibilityName()) == 0) {
+      mgr = compression_manager;
+    }
     rep->decompressor = mgr->GetDecompressorOptimizeFor(saved_comp_type);
   }
+  rep->blocks_in_mmap =
+      ioptions.allow_mmap_reads && rep->decompressor == nullptr;
 
   // Populate BlockCreateContext
   rep->create_context = BlockCreateContext(
@@ -855,6 +937,10 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  if (rep->table_prefix_extractor != nullptr) {
+    new_table->ReadPrefixBlockMap(ro, prefetch_buffer.get(),
+                                  metaindex_iter.get());
+  }
   rep->verify_checksum_set_on_open = ro.verify_checksums;
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
@@ -1141,6 +1227,14 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
         break;
       }
     }
+    // Checking a range needs all keys of the table in a single filter, and
+    // ordered like the prefixes of their bytes
+    if (rep_->filter_type == Rep::FilterType::kFullFilter &&
+        rep_->whole_key_filtering &&
+        rep_->internal_comparator.user_comparator() == BytewiseComparator()) {
+      rep_->range_filter_policy =
+          rep_->filter_policy->CheckedCast<RangeFilterPolicy>();
+    }
   }
   // Partition filters cannot be enabled without partition indexes
   assert(rep_->filter_type != Rep::FilterType::kPartitionedFilter ||
@@ -1285,6 +1379,31 @@ const SeqnoToTimeMapping& BlockBasedTable::GetSeqnoToTimeMapping() const {
   return rep_->seqno_to_time_mapping;
 }
 
+void BlockBasedTable::ReadPrefixBlockMap(const ReadOptions& ro,
+                                         FilePrefetchBuffer* prefetch_buffer,
+                                         InternalIterator* meta_iter) {
+  BlockHandle handle;
+  Status s = FindOptionalMetaBlock(meta_iter, kPrefixBlockMapBlock, &handle);
+  if (s.ok() && !handle.IsNull()) {
+    BlockContents contents;
+    BlockFetcher block_fetcher(
+        rep_->file.get(), prefetch_buffer, rep_->footer, ro, handle,
+        &contents, rep_->ioptions, true /*decompress*/,
+        true /*maybe_compressed*/, BlockType::kPrefixBlockMap,
+        rep_->decompressor.get(), rep_->persistent_cache_options,
+        GetMemoryAllocator(rep_->table_options));
+    s = block_fetcher.ReadBlockContents();
+    if (s.ok()) {
+      s = PrefixBlockMap::Create(contents.data, &rep_->prefix_block_map);
+    }
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Failed to read the prefix block map of %s: %s",
+                   rep_->file->file_name().c_str(), s.ToString().c_str());
+  }
+}
+
 size_t BlockBasedTable::ApproximateMemoryUsage() const {
   size_t usage = 0;
   if (rep_) {
@@ -1304,6 +1423,12 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->table_properties) {
     usage += rep_->table_properties->ApproximateMemoryUsage();
   }
+  if (rep_->data_block_hits) {
+    usage += rep_->data_block_hits->ApproximateMemoryUsage();
+  }
+  if (rep_->prefix_block_map) {
+    usage += rep_->prefix_block_map->ApproximateMemoryUsage();
+  }
   return usage;
 }
 
@@ -1418,7 +1543,7 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::PutDataBlockToCache(
     BlockContents&& uncompressed_block_contents,
     BlockContents&& compressed_block_contents, CompressionType block_comp_type,
     UnownedPtr<Decompressor> decomp, MemoryAllocator* memory_allocator,
-    GetContext* get_context) const {
+    GetContext* get_context, Cache::Priority priority) const {
   const ImmutableOptions& ioptions = rep_->ioptions;
   assert(out_parsed_block);
   assert(out_parsed_block->IsEmpty());
@@ -1447,7 +1572,7 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::PutDataBlockToCache(
     size_t charge = block_holder->ApproximateMemoryUsage();
     BlockCacheTypedHandle<TBlocklike>* cache_handle = nullptr;
     s = block_cache.InsertFull(cache_key, block_holder.get(), charge,
-                               &cache_handle, GetCachePriority<TBlocklike>(),
+                               &cache_handle, priority,
                                rep_->ioptions.lowest_used_cache_tier,
                                compressed_block_contents.data, block_comp_type);
 
@@ -1641,6 +1766,11 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
           // TODO(haoyu): Differentiate cache hit on uncompressed block cache
           // and compressed block cache.
           is_cache_hit = true;
+          if (TBlocklike::kBlockType == BlockType::kData &&
+              rep_->data_block_hits && !for_compaction && lookup_context &&
+              BlockCacheTraceHelper::IsUserAccess(lookup_context->caller)) {
+            rep_->data_block_hits->RecordHit(handle.offset());
+          }
           if (prefetch_buffer) {
             // Update the block details so that PrefetchBuffer can use the read
             // pattern to determine if reads are sequential or not for
@@ -1660,6 +1790,16 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
         out_parsed_block->GetCacheHandle() == nullptr && !no_io &&
         ro.fill_cache) {
       Statistics* statistics = rep_->ioptions.stats;
+      // Data blocks loaded by a warmup were not asked for by anyone yet, and
+      // the ones of a scan-resistant read are not expected to be read again:
+      // they are the first to go when the cache needs room.
+      const Cache::Priority priority =
+          TBlocklike::kBlockType == BlockType::kData &&
+                  (ro.scan_resistant ||
+                   (lookup_context &&
+                    lookup_context->caller == TableReaderCaller::kWarmup))
+              ? Cache::Priority::BOTTOM
+              : GetCachePriority<TBlocklike>();
       const bool maybe_compressed =
           TBlocklike::kBlockType != BlockType::kFilter &&
           TBlocklike::kBlockType != BlockType::kCompressionDictionary &&
@@ -1735,7 +1875,8 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
           s = PutDataBlockToCache(
               key, block_cache, out_parsed_block, std::move(uncomp_contents),
               std::move(comp_contents), contents_comp_type, decomp,
-              GetMemoryAllocator(rep_->table_options), get_context);
+              GetMemoryAllocator(rep_->table_options), get_context,
+              priority);
         }
       } else {
         contents_comp_type = GetBlockCompressionType(*contents);
@@ -1751,7 +1892,8 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
           s = PutDataBlockToCache(
               key, block_cache, out_parsed_block, std::move(uncomp_contents),
               std::move(comp_contents), contents_comp_type, decomp,
-              GetMemoryAllocator(rep_->table_options), get_context);
+              GetMemoryAllocator(rep_->table_options), get_context,
+              priority);
         }
       }
     }
@@ -1873,7 +2015,7 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::RetrieveBlock(
   assert(out_parsed_block->IsEmpty());
 
   Status s;
-  if (use_cache) {
+  if (use_cache && !rep_->blocks_in_mmap) {
     s = MaybeReadBlockAndLoadToCache(
         prefetch_buffer, ro, handle, decomp, for_compaction, out_parsed_block,
         get_context, lookup_context,
@@ -1987,6 +2129,22 @@ bool BlockBasedTable::PrefixRangeMayMatch(
     const SliceTransform* options_prefix_extractor,
     const bool need_upper_bound_check, BlockCacheLookupContext* lookup_context,
     bool* filter_checked) const {
+  if (rep_->prefix_block_map != nullptr && !need_upper_bound_check &&
+      !read_options.total_order_seek && !read_options.auto_prefix_mode) {
+    // The map is built with the prefix extractor of the file, which the
+    // current one is the same as without the upper bound check
+    const SliceTransform* const table_prefix_extractor =
+        rep_->table_prefix_extractor.get();
+    const Slice user_key = ExtractUserKeyAndStripTimestamp(
+        internal_key,
+        rep_->internal_comparator.user_comparator()->timestamp_size());
+    BlockHandle first, last;
+    if (table_prefix_extractor->InDomain(user_key) &&
+        !rep_->prefix_block_map->Lookup(
+            table_prefix_extractor->Transform(user_key), &first, &last)) {
+      return false;
+    }
+  }
   if (!rep_->filter_policy) {
     return true;
   }
@@ -1994,7 +2152,7 @@ bool BlockBasedTable::PrefixRangeMayMatch(
   const SliceTransform* prefix_extractor;
 
   if (rep_->table_prefix_extractor == nullptr) {
-    if (need_upper_bound_check) {
+    if (need_upper_bound_check || options_prefix_extractor == nullptr) {
       return true;
     }
     prefix_extractor = options_prefix_extractor;
@@ -2023,6 +2181,28 @@ bool BlockBasedTable::PrefixRangeMayMatch(
   return may_match;
 }
 
+bool BlockBasedTable::RangeFilterMayMatch(
+    const Slice& internal_key, const ReadOptions& read_options,
+    BlockCacheLookupContext* lookup_context, bool* filter_checked) const {
+  const RangeFilterPolicy* const policy = rep_->range_filter_policy;
+  FilterBlockReader* const filter = rep_->filter.get();
+  if (policy == nullptr || filter == nullptr ||
+      read_options.iterate_upper_bound == nullptr) {
+    return true;
+  }
+  const Slice user_key = ExtractUserKey(internal_key);
+  const size_t len =
+      policy->RangePrefixLength(user_key, *read_options.iterate_upper_bound);
+  if (len == 0) {
+    return true;
+  }
+  std::string entry;
+  RangeFilterPolicy::GetRangeEntry(user_key, len, &entry);
+  *filter_checked = true;
+  return filter->PrefixMayMatch(entry, &internal_key, /*get_context=*/nullptr,
+                                lookup_context, read_options);
+}
+
 bool BlockBasedTable::PrefixExtractorChanged(
     const SliceTransform* prefix_extractor) const {
   if (prefix_extractor == nullptr) {
@@ -2061,6 +2241,7 @@ InternalIterator* BlockBasedTable::NewIterator(
             (!read_options.total_order_seek || read_options.auto_prefix_mode ||
              read_options.prefix_same_as_start) &&
             prefix_extractor != nullptr,
+        !skip_filters && rep_->range_filter_policy != nullptr,
         need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   } else {
@@ -2071,6 +2252,7 @@ InternalIterator* BlockBasedTable::NewIterator(
             (!read_options.total_order_seek || read_options.auto_prefix_mode ||
              read_options.prefix_same_as_start) &&
             prefix_extractor != nullptr,
+        !skip_filters && rep_->range_filter_policy != nullptr,
         need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   }
@@ -2251,6 +2433,45 @@ Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
   return Status::OK();
 }
 
+Status BlockBasedTable::GetHotKeyRanges(const ReadOptions& read_options,
+                                        std::vector<HotKeyRange>* ranges) {
+  if (!rep_->data_block_hits) {
+    return Status::NotSupported("Data block hits are not tracked.");
+  }
+  const uint32_t min_hits = rep_->table_options.warmup_min_data_block_hits;
+  const uint8_t threshold = static_cast<uint8_t>(
+      std::min(min_hits, static_cast<uint32_t>(UINT8_MAX)));
+
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(
+      read_options, /*disable_prefix_seek=*/false, &iiter_on_stack,
+      /*get_context=*/nullptr, /*lookup_context=*/nullptr);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(iiter);
+  }
+
+  // Data block i holds the keys between index keys i-1 and i, so the range
+  // of a hot block starts at the index key of the block before it. Runs of
+  // hot blocks are merged into a single range.
+  std::string prev_key;
+  bool prev_hot = false;
+  for (iiter->SeekToFirst(); iiter->Valid(); iiter->Next()) {
+    const bool hot = rep_->data_block_hits->GetHits(
+                         iiter->value().handle.offset()) >= threshold;
+    if (hot) {
+      if (prev_hot) {
+        ranges->back().largest = iiter->user_key().ToString();
+      } else {
+        ranges->push_back({prev_key, iiter->user_key().ToString()});
+      }
+    }
+    prev_hot = hot;
+    prev_key = iiter->user_key().ToString();
+  }
+  return iiter->status();
+}
+
 bool BlockBasedTable::TimestampMayMatch(const ReadOptions& read_options) const {
   if (read_options.timestamp != nullptr && !rep_->min_timestamp.empty()) {
     RecordTick(rep_->ioptions.stats, TIMESTAMP_FILTER_TABLE_CHECKED);
@@ -2268,6 +2489,23 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
                             GetContext* get_context,
                             const SliceTransform* prefix_extractor,
                             bool skip_filters) {
+  return GetImpl(read_options, key, get_context, prefix_extractor,
+                 skip_filters, /*hash_index=*/nullptr);
+}
+
+Status BlockBasedTable::GetWithHashIndex(
+    const ReadOptions& read_options, const Slice& key, GetContext* get_context,
+    const SliceTransform* prefix_extractor, bool skip_filters,
+    const FileHashIndex* hash_index) {
+  return GetImpl(read_options, key, get_context, prefix_extractor,
+                 skip_filters, hash_index);
+}
+
+Status BlockBasedTable::GetImpl(const ReadOptions& read_options,
+                                const Slice& key, GetContext* get_context,
+                                const SliceTransform* prefix_extractor,
+                                bool skip_filters,
+                                const FileHashIndex* hash_index) {
   // Similar to Bloom filter !may_match
   // If timestamp is beyond the range of the table, skip
   if (!TimestampMayMatch(read_options)) {
@@ -2277,6 +2515,35 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
   assert(get_context != nullptr);
   Status s;
 
+  // Set to the first data block that can have the key when the hash index of
+  // the file has it, which then stands in for the filter and the index
+  uint32_t hash_index_block = FileHashIndex::kAmbiguous;
+  if (hash_index != nullptr) {
+    hash_index_block = hash_index->Lookup(ExtractUserKey(key));
+    if (hash_index_block == FileHashIndex::kNotFound) {
+      return s;
+    }
+  }
+  const bool use_hash_index = hash_index_block != FileHashIndex::kAmbiguous;
+
+  // Set when all the keys of the prefix of the key are in one data block
+  bool prefix_in_one_block = false;
+  BlockHandle prefix_first_block, prefix_last_block;
+  if (rep_->prefix_block_map != nullptr && !use_hash_index) {
+    const SliceTransform* const table_prefix_extractor =
+        rep_->table_prefix_extractor.get();
+    const Slice user_key = ExtractUserKeyAndStripTimestamp(
+        key, rep_->internal_comparator.user_comparator()->timestamp_size());
+    if (table_prefix_extractor->InDomain(user_key)) {
+      if (!rep_->prefix_block_map->Lookup(
+              table_prefix_extractor->Transform(user_key), &prefix_first_block,
+              &prefix_last_block)) {
+        return s;
+      }
+      prefix_in_one_block = prefix_first_block == prefix_last_block;
+    }
+  }
+
   FilterBlockReader* const filter =
       !skip_filters ? rep_->filter.get() : nullptr;
 
@@ -2294,6 +2561,7 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
   }
   TEST_SYNC_POINT("BlockBasedTable::Get:BeforeFilterMatch");
   const bool may_match =
+      use_hash_index ||
       FullFilterKeyMayMatch(filter, key, prefix_extractor, get_context,
                             &lookup_context, read_options);
   TEST_SYNC_POINT("BlockBasedTable::Get:AfterFilterMatch");
@@ -2305,11 +2573,22 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
     if (rep_->index_type == BlockBasedTableOptions::kHashSearch) {
       need_upper_bound_check = PrefixExtractorChanged(prefix_extractor);
     }
-    auto iiter =
-        NewIndexIterator(read_options, need_upper_bound_check, &iiter_on_stack,
-                         get_context, &lookup_context);
+    SingleBlockIndexIterator single_block_iter(prefix_first_block);
+    HashIndexBlockIterator hash_block_iter(hash_index, hash_index_block);
+    InternalIteratorBase<IndexValue>* iiter;
+    if (use_hash_index) {
+      // The versions of the key start in the block the hash index points to
+      iiter = &hash_block_iter;
+    } else if (prefix_in_one_block) {
+      // No need to search the index for the only block that can have the key
+      iiter = &single_block_iter;
+    } else {
+      iiter = NewIndexIterator(read_options, need_upper_bound_check,
+                               &iiter_on_stack, get_context, &lookup_context);
+    }
     std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
-    if (iiter != &iiter_on_stack) {
+    if (iiter != &iiter_on_stack && iiter != &single_block_iter &&
+        iiter != &hash_block_iter) {
       iiter_unique_ptr.reset(iiter);
     }
 
@@ -2338,6 +2617,13 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
       DataBlockIter biter;
       uint64_t referenced_data_size = 0;
       Status tmp_status;
+      if (rep_->table_options.data_block_fetch_unit_size > 0 &&
+          read_options.read_tier != kBlockCacheTier &&
+          read_options.fill_cache && !rep_->ioptions.allow_mmap_reads &&
+          !BlockInCache(v.handle)) {
+        // Errors are left for the read of the block itself to hit.
+        LoadDataFetchUnit(read_options, key, v.handle).PermitUncheckedError();
+      }
       NewDataBlockIterator<DataBlockIter>(
           read_options, v.handle, &biter, BlockType::kData, get_context,
           &lookup_data_block_context, /*prefetch_buffer=*/nullptr,
@@ -2472,14 +2758,20 @@ Status BlockBasedTable::MultiGetFilter(const ReadOptions& read_options,
 
 Status BlockBasedTable::Prefetch(const ReadOptions& read_options,
                                  const Slice* const begin,
-                                 const Slice* const end) {
+                                 const Slice* const end,
+                                 PrefetchStats* stats,
+                                 const PrefetchOptions* options) {
+  const PrefetchOptions default_options;
+  if (options == nullptr) {
+    options = &default_options;
+  }
   auto& comparator = rep_->internal_comparator;
   UserComparatorWrapper user_comparator(comparator.user_comparator());
   // pre-condition
   if (begin && end && comparator.Compare(*begin, *end) > 0) {
     return Status::InvalidArgument(*begin, *end);
   }
-  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  BlockCacheLookupContext lookup_context{options->caller};
   IndexBlockIter iiter_on_stack;
   auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
                                 &iiter_on_stack, /*get_context=*/nullptr,
@@ -2494,9 +2786,30 @@ Status BlockBasedTable::Prefetch(const ReadOptions& read_options,
     return iiter->status();
   }
 
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  if (options->index_and_filter_partitions && block_cache != nullptr) {
+    // Every lookup in the file needs them, whatever its key. Without pinning,
+    // CacheDependencies() only loads the partitions into the block cache.
+    Status s = rep_->index_reader->CacheDependencies(
+        read_options, /*pin=*/false, /*tail_prefetch_buffer=*/nullptr);
+    if (s.ok() && rep_->filter) {
+      s = rep_->filter->CacheDependencies(read_options, /*pin=*/false,
+                                          /*tail_prefetch_buffer=*/nullptr);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  if (!options->data_blocks) {
+    return Status::OK();
+  }
+
   // indicates if we are on the last page that need to be pre-fetched
   bool prefetching_boundary_page = false;
 
+  // The data blocks of the range that are not in the block cache yet. Blocks
+  // already cached are neither read nor decoded again.
+  std::vector<BlockHandle> block_handles;
   for (begin ? iiter->Seek(*begin) : iiter->SeekToFirst(); iiter->Valid();
        iiter->Next()) {
     BlockHandle block_handle = iiter->value().handle;
@@ -2514,24 +2827,295 @@ Status BlockBasedTable::Prefetch(const ReadOptions& read_options,
       prefetching_boundary_page = true;
     }
 
-    // Load the block specified by the block_handle into the block cache
-    DataBlockIter biter;
-    Status tmp_status;
-    NewDataBlockIterator<DataBlockIter>(
-        read_options, block_handle, &biter, /*type=*/BlockType::kData,
-        /*get_context=*/nullptr, &lookup_context,
-        /*prefetch_buffer=*/nullptr, /*for_compaction=*/false,
-        /*async_read=*/false, tmp_status, /*use_block_cache_for_lookup=*/true);
+    if (!BlockInCache(block_handle)) {
+      block_handles.push_back(block_handle);
+    } else if (stats) {
+      stats->blocks_already_cached++;
+    }
+  }
+  if (!iiter->status().ok()) {
+    return iiter->status();
+  }
+  const size_t max_read_bytes = read_options.readahead_size > 0
+                                    ? read_options.readahead_size
+                                    : kDefaultPrefetchReadBytes;
+  return LoadDataBlocks(read_options, block_handles, max_read_bytes,
+                        /*max_gap_bytes=*/0, stats, *options, lookup_context);
+}
 
-    if (!biter.status().ok()) {
-      // there was an unexpected error while pre-fetching
-      return biter.status();
+Status BlockBasedTable::LoadDataFetchUnit(const ReadOptions& read_options,
+                                          const Slice& key,
+                                          const BlockHandle& handle) {
+  const uint64_t unit_size = rep_->table_options.data_block_fetch_unit_size;
+  assert(unit_size > 0);
+  const uint64_t unit_start = handle.offset() / unit_size * unit_size;
+  const uint64_t unit_end = unit_start + unit_size;
+
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                                &iiter_on_stack, /*get_context=*/nullptr,
+                                &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+
+  // Back to the first data block of the fetch unit, then through its last
+  std::vector<BlockHandle> block_handles;
+  iiter->Seek(key);
+  while (iiter->Valid() && iiter->value().handle.offset() > unit_start) {
+    iiter->Prev();
+  }
+  if (!iiter->Valid() && iiter->status().ok()) {
+    iiter->SeekToFirst();
+  }
+  for (; iiter->Valid(); iiter->Next()) {
+    const BlockHandle block_handle = iiter->value().handle;
+    if (block_handle.offset() >= unit_end) {
+      break;
+    }
+    if (block_handle.offset() >= unit_start && !BlockInCache(block_handle)) {
+      block_handles.push_back(block_handle);
     }
   }
+  if (!iiter->status().ok()) {
+    return iiter->status();
+  }
+  // The blocks of the unit are read with a single I/O, over any cached ones
+  // between them.
+  return LoadDataBlocks(read_options, block_handles,
+                        static_cast<size_t>(unit_size),
+                        /*max_gap_bytes=*/unit_size, /*stats=*/nullptr,
+                        PrefetchOptions(), lookup_context);
+}
+
+Status BlockBasedTable::LoadDataBlocks(
+    const ReadOptions& read_options,
+    const std::vector<BlockHandle>& block_handles, size_t max_read_bytes,
+    uint64_t max_gap_bytes, PrefetchStats* stats,
+    const PrefetchOptions& options, BlockCacheLookupContext& lookup_context) {
+  if (block_handles.empty()) {
+    return Status::OK();
+  }
+
+  IOOptions opts;
+  IODebugContext dbg;
+  Status s = rep_->file->PrepareIOOptions(read_options, opts, &dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  std::unique_ptr<FilePrefetchBuffer> prefetch_buffer;
+  rep_->CreateFilePrefetchBuffer(ReadaheadParams(), &prefetch_buffer,
+                                 /*readaheadsize_cb=*/nullptr,
+                                 FilePrefetchBufferUsage::kUnknown);
+
+  bool to_secondary_cache =
+      options.to_secondary_cache && block_cache != nullptr;
+  bool limit_to_capacity = options.stop_at_cache_capacity &&
+                           block_cache != nullptr && !to_secondary_cache;
+  // Room left in the block cache before it starts evicting. The charge of a
+  // block is approximated by its size in the file, so the cache may end up
+  // over its capacity by the difference for the last block loaded.
+  auto room_in_cache = [&]() -> uint64_t {
+    if (!limit_to_capacity) {
+      return std::numeric_limits<uint64_t>::max();
+    }
+    const size_t usage = block_cache->GetUsage();
+    const size_t capacity = block_cache->GetCapacity();
+    return usage < capacity ? capacity - usage : 0;
+  };
+  // Blocks are inserted into the secondary cache in the form they take in the
+  // primary one, for which they have to be decompressed first.
+  CachableEntry<DecompressorDict> dict;
+  auto load_to_secondary_cache = [&](const BlockHandle& handle) -> Status {
+    Decompressor* decomp = rep_->decompressor.get();
+    if (rep_->uncompression_dict_reader) {
+      if (dict.IsEmpty()) {
+        Status s =
+            rep_->uncompression_dict_reader->GetOrReadUncompressionDictionary(
+                /*prefetch_buffer=*/nullptr, read_options,
+                /*get_context=*/nullptr, &lookup_context, &dict);
+        if (!s.ok()) {
+          return s;
+        }
+      }
+      if (dict.GetValue()) {
+        decomp = dict.GetValue()->decompressor_.get();
+      }
+    }
+    std::unique_ptr<Block_kData> block;
+    Status s = ReadAndParseBlockFromFile(
+        rep_->file.get(), prefetch_buffer.get(), rep_->footer, read_options,
+        handle, &block, rep_->ioptions, rep_->create_context,
+        /*maybe_compressed=*/rep_->decompressor != nullptr, decomp,
+        rep_->persistent_cache_options, GetMemoryAllocator(rep_->table_options),
+        /*for_compaction=*/false, /*async_read=*/false);
+    if (!s.ok()) {
+      return s;
+    }
+    const CacheKey key = GetCacheKey(rep_->base_cache_key, handle);
+    return block_cache->InsertIntoSecondaryCache(
+        key.AsSlice(), block.get(),
+        GetCacheItemHelper(BlockType::kData,
+                           rep_->ioptions.lowest_used_cache_tier));
+  };
+  auto skip_from = [&](size_t first) {
+    if (stats) {
+      for (size_t i = first; i < block_handles.size(); i++) {
+        stats->blocks_skipped++;
+        stats->bytes_skipped += BlockSizeWithTrailer(block_handles[i]);
+      }
+    }
+    return Status::Incomplete("Block cache is full");
+  };
+
+  // Blocks that are adjacent in the file, or up to `max_gap_bytes` apart, are
+  // read with a single I/O of up to `max_read_bytes` and then loaded into the
+  // block cache from the buffer. Runs are also cut at the room left in the
+  // cache, not to read blocks that would not be loaded.
+  size_t run_start = 0;
+  while (run_start < block_handles.size()) {
+    const uint64_t room = room_in_cache();
+    const uint64_t run_offset = block_handles[run_start].offset();
+    uint64_t run_end =
+        run_offset + BlockSizeWithTrailer(block_handles[run_start]);
+    if (run_end - run_offset > room) {
+      return skip_from(run_start);
+    }
+    size_t run_limit = run_start + 1;
+    while (run_limit < block_handles.size() &&
+           block_handles[run_limit].offset() - run_end <= max_gap_bytes &&
+           run_end - run_offset < max_read_bytes) {
+      const uint64_t block_end = block_handles[run_limit].offset() +
+                                 BlockSizeWithTrailer(block_handles[run_limit]);
+      if (block_end - run_offset > room) {
+        break;
+      }
+      run_end = block_end;
+      run_limit++;
+    }
+    if (run_limit - run_start > 1) {
+      s = prefetch_buffer->Prefetch(opts, rep_->file.get(), run_offset,
+                                    static_cast<size_t>(run_end - run_offset));
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    for (size_t i = run_start; i < run_limit; i++) {
+      if (i > run_start &&
+          BlockSizeWithTrailer(block_handles[i]) > room_in_cache()) {
+        // The blocks loaded so far took more room than estimated.
+        return skip_from(i);
+      }
+      if (to_secondary_cache) {
+        s = load_to_secondary_cache(block_handles[i]);
+        if (s.ok()) {
+          if (stats) {
+            stats->blocks_loaded++;
+            stats->blocks_loaded_to_secondary_cache++;
+            stats->bytes_read += BlockSizeWithTrailer(block_handles[i]);
+          }
+          continue;
+        }
+        if (!s.IsNotSupported() && !s.IsInvalidArgument()) {
+          return s;
+        }
+        // No usable secondary cache, fall back to the block cache.
+        to_secondary_cache = false;
+        limit_to_capacity = options.stop_at_cache_capacity;
+        if (BlockSizeWithTrailer(block_handles[i]) > room_in_cache()) {
+          return skip_from(i);
+        }
+      }
+      // Load the block specified by the block_handle into the block cache
+      DataBlockIter biter;
+      Status tmp_status;
+      NewDataBlockIterator<DataBlockIter>(
+          read_options, block_handles[i], &biter, /*type=*/BlockType::kData,
+          /*get_context=*/nullptr, &lookup_context, prefetch_buffer.get(),
+          /*for_compaction=*/false, /*async_read=*/false, tmp_status,
+          /*use_block_cache_for_lookup=*/true);
+
+      if (!biter.status().ok()) {
+        // there was an unexpected error while pre-fetching
+        return biter.status();
+      }
+      if (stats) {
+        stats->blocks_loaded++;
+        stats->bytes_read += BlockSizeWithTrailer(block_handles[i]);
+      }
+    }
+    run_start = run_limit;
+  }
 
   return Status::OK();
 }
 
+Status BlockBasedTable::RestoreCacheEntry(const Slice& key,
+                                          CacheEntryRole role,
+                                          const Slice& saved) {
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr) {
+    return Status::NotSupported("No block cache");
+  }
+  BlockType block_type;
+  Cache::Priority priority =
+      rep_->table_options.cache_index_and_filter_blocks_with_high_priority
+          ? Cache::Priority::HIGH
+          : Cache::Priority::LOW;
+  switch (role) {
+    case CacheEntryRole::kDataBlock:
+      block_type = BlockType::kData;
+      priority = Cache::Priority::LOW;
+      break;
+    case CacheEntryRole::kFilterBlock:
+      block_type = BlockType::kFilter;
+      break;
+    case CacheEntryRole::kFilterMetaBlock:
+      block_type = BlockType::kFilterPartitionIndex;
+      break;
+    case CacheEntryRole::kIndexBlock:
+      block_type = BlockType::kIndex;
+      break;
+    default:
+      return Status::NotSupported("Cache entry role not restorable");
+  }
+  Cache::Handle* const cached = block_cache->Lookup(key);
+  if (cached != nullptr) {
+    block_cache->Release(cached);
+    return Status::OK();
+  }
+  if (block_cache->GetUsage() + saved.size() > block_cache->GetCapacity()) {
+    return Status::Incomplete("Block cache is full");
+  }
+  // The saved form is the one of the secondary cache, which only the full
+  // helper can parse, whatever helper the block is then inserted with.
+  const Cache::CacheItemHelper* const full_helper =
+      GetCacheItemHelper(block_type, CacheTier::kNonVolatileBlockTier);
+  assert(full_helper != nullptr && full_helper->create_cb != nullptr);
+  Cache::ObjectPtr value = nullptr;
+  size_t charge = 0;
+  MemoryAllocator* const allocator = GetMemoryAllocator(rep_->table_options);
+  Status s = full_helper->create_cb(saved, kNoCompression,
+                                    CacheTier::kVolatileTier,
+                                    &rep_->create_context, allocator, &value,
+                                    &charge);
+  if (!s.ok()) {
+    return s;
+  }
+  const Cache::CacheItemHelper* const helper =
+      GetCacheItemHelper(block_type, rep_->ioptions.lowest_used_cache_tier);
+  s = block_cache->Insert(key, value, helper, charge, /*handle=*/nullptr,
+                          priority);
+  if (!s.ok()) {
+    helper->del_cb(value, allocator);
+  }
+  return s;
+}
+
 Status BlockBasedTable::VerifyChecksum(const ReadOptions& read_options,
                                        TableReaderCaller caller) {
   Status s;
@@ -2580,8 +3164,16 @@ Status BlockBasedTable::VerifyChecksumInBlocks(
   ReadaheadParams readahead_params;
   readahead_params.initial_readahead_size = readahead_size;
   readahead_params.max_readahead_size = readahead_size;
+  // With async_io, the next part of the file is read while the blocks read
+  // before are verified.
+  readahead_params.num_buffers =
+      read_options.async_io
+          ? std::max(read_options.async_readahead_num_buffers, size_t{2})
+          : 1;
   FilePrefetchBuffer prefetch_buffer(
-      readahead_params, !rep_->ioptions.allow_mmap_reads /* enable */);
+      readahead_params, !rep_->ioptions.allow_mmap_reads /* enable */,
+      false /* track_min_offset */, rep_->ioptions.fs.get(),
+      rep_->ioptions.clock);
 
   for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
     s = index_iter->status();
@@ -2639,6 +3231,14 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kLearnedIndexModelBlock) {
+    return BlockType::kLearnedIndexModel;
+  }
+
+  if (meta_block_name == kPrefixBlockMapBlock) {
+    return BlockType::kPrefixBlockMap;
+  }
+
   if (meta_block_name == kIndexBlockName) {
     return BlockType::kIndex;
   }
@@ -2717,6 +3317,10 @@ bool BlockBasedTable::EraseFromCache(const BlockHandle& handle) const {
 }
 
 bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
+  return BlockInCache(handle);
+}
+
+bool BlockBasedTable::BlockInCache(const BlockHandle& handle) const {
   assert(rep_ != nullptr);
 
   Cache* const cache = rep_->table_options.block_cache.get();
@@ -2736,6 +3340,149 @@ bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
   return true;
 }
 
+void BlockBasedTable::PrepareScans(
+    const ReadOptions& read_options,
+    const std::vector<ScanOptions>& scan_opts) const {
+  const Comparator* ucmp = rep_->internal_comparator.user_comparator();
+  if (rep_->table_options.block_cache == nullptr || !read_options.fill_cache ||
+      read_options.read_tier == kBlockCacheTier ||
+      rep_->ioptions.allow_mmap_reads || ucmp->timestamp_size() > 0) {
+    return;
+  }
+
+  // The blocks holding each range, from the one where it starts to the one
+  // where it ends. An unbounded range only needs its first block here, as
+  // readahead takes over from there.
+  std::vector<BlockHandle> handles;
+  {
+    std::unique_ptr<InternalIteratorBase<IndexValue>> index_iter(
+        NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                         /*input_iter=*/nullptr, /*get_context=*/nullptr,
+                         /*lookup_context=*/nullptr));
+    for (const auto& scan : scan_opts) {
+      if (!scan.range.start) {
+        continue;
+      }
+      InternalKey start(*scan.range.start, kMaxSequenceNumber,
+                        kValueTypeForSeek);
+      for (index_iter->Seek(start.Encode()); index_iter->Valid();
+           index_iter->Next()) {
+        handles.push_back(index_iter->value().handle);
+        if (!scan.range.limit ||
+            ucmp->Compare(index_iter->user_key(), *scan.range.limit) >= 0) {
+          break;
+        }
+      }
+    }
+  }
+  std::sort(handles.begin(), handles.end(),
+            [](const BlockHandle& a, const BlockHandle& b) {
+              return a.offset() < b.offset();
+            });
+  handles.erase(std::unique(handles.begin(), handles.end(),
+                            [](const BlockHandle& a, const BlockHandle& b) {
+                              return a.offset() == b.offset();
+                            }),
+                handles.end());
+  handles.erase(std::remove_if(handles.begin(), handles.end(),
+                               [this](const BlockHandle& handle) {
+                                 return BlockInCache(handle);
+                               }),
+                handles.end());
+  if (handles.empty()) {
+    return;
+  }
+
+  // One read for each run of adjacent blocks
+  RandomAccessFileReader* file = rep_->file.get();
+  std::vector<FSReadRequest> read_reqs;
+  std::vector<std::unique_ptr<char[]>> bufs;
+  std::vector<size_t> req_idx_for_block;
+  for (const auto& handle : handles) {
+    if (read_reqs.empty() ||
+        read_reqs.back().offset + read_reqs.back().len != handle.offset()) {
+      FSReadRequest req;
+      req.offset = handle.offset();
+      req.len = 0;
+      req.scratch = nullptr;
+      read_reqs.emplace_back(std::move(req));
+    }
+    read_reqs.back().len += BlockSizeWithTrailer(handle);
+    req_idx_for_block.push_back(read_reqs.size() - 1);
+  }
+  if (!file->use_direct_io()) {
+    for (auto& req : read_reqs) {
+      bufs.emplace_back(new char[req.len]);
+      req.scratch = bufs.back().get();
+    }
+  }
+  AlignedBuf direct_io_buf;
+  IOOptions opts;
+  IODebugContext dbg;
+  IOStatus io_s = file->PrepareIOOptions(read_options, opts, &dbg);
+  if (io_s.ok()) {
+    io_s = file->MultiRead(opts, read_reqs.data(), read_reqs.size(),
+                           &direct_io_buf, &dbg);
+  }
+  if (!io_s.ok()) {
+    return;
+  }
+
+  UnownedPtr<Decompressor> decomp = rep_->decompressor.get();
+  CachableEntry<DecompressorDict> dict;
+  if (rep_->uncompression_dict_reader) {
+    Status s =
+        rep_->uncompression_dict_reader->GetOrReadUncompressionDictionary(
+            /*prefetch_buffer=*/nullptr, read_options, /*get_context=*/nullptr,
+            /*lookup_context=*/nullptr, &dict);
+    if (!s.ok()) {
+      return;
+    }
+    if (dict.GetValue()) {
+      decomp = dict.GetValue()->decompressor_.get();
+    }
+  }
+
+  uint64_t req_offset = 0;
+  for (size_t i = 0; i < handles.size(); i++) {
+    const BlockHandle& handle = handles[i];
+    const FSReadRequest& req = read_reqs[req_idx_for_block[i]];
+    if (i == 0 || req_idx_for_block[i] != req_idx_for_block[i - 1]) {
+      req_offset = 0;
+    }
+    const size_t block_size = BlockSizeWithTrailer(handle);
+    const uint64_t offset_in_req = req_offset;
+    req_offset += block_size;
+    if (!req.status.ok() || offset_in_req + block_size > req.result.size()) {
+      continue;
+    }
+    const char* data = req.result.data() + offset_in_req;
+    if (read_options.verify_checksums) {
+      Status s = VerifyBlockChecksum(rep_->footer, data, handle.size(),
+                                     file->file_name(), handle.offset());
+      RecordTick(rep_->ioptions.stats, BLOCK_CHECKSUM_COMPUTE_COUNT);
+      if (!s.ok()) {
+        RecordTick(rep_->ioptions.stats, BLOCK_CHECKSUM_MISMATCH_COUNT);
+        continue;
+      }
+    }
+    Slice serialized(data, block_size);
+    BlockContents serialized_block(
+        CopyBufferToHeap(GetMemoryAllocator(rep_->table_options), serialized),
+        handle.size());
+#ifndef NDEBUG
+    serialized_block.has_trailer = true;
+#endif
+    CachableEntry<Block_kData> block;
+    MaybeReadBlockAndLoadToCache(
+        /*prefetch_buffer=*/nullptr, read_options, handle, decomp,
+        /*for_compaction=*/false, &block, /*get_context=*/nullptr,
+        /*lookup_context=*/nullptr, &serialized_block, /*async_read=*/false,
+        /*use_block_cache_for_lookup=*/false)
+        .PermitUncheckedError();
+  }
+}
+
 bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
                                       const Slice& key) {
   std::unique_ptr<InternalIteratorBase<IndexValue>> iiter(NewIndexIterator(
@@ -2806,6 +3553,11 @@ Status BlockBasedTable::CreateIndexReader(
                                        index_reader);
       }
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer, meta_iter,
+                                        use_cache, prefetch, pin,
+                                        lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + std::to_string(rep_->index_type);
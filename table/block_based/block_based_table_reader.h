@@ -25,7 +25,9 @@
 #include "table/block_based/block_cache.h"
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
+#include "table/block_based/data_block_hit_counter.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/prefix_block_map.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/format.h"
 #include "table/persistent_cache_options.h"
@@ -46,6 +48,7 @@ class FullFilterBlockReader;
 class Footer;
 class InternalKeyComparator;
 class Iterator;
+class RangeFilterPolicy;
 class FSRandomAccessFile;
 class TableCache;
 class TableReader;
@@ -76,6 +79,8 @@ class BlockBasedTable : public TableReader {
 
   // 1-byte compression type + 32-bit checksum
   static constexpr size_t kBlockTrailerSize = 5;
+  // Default maximum size of a single read issued by Prefetch().
+  static constexpr size_t kDefaultPrefetchReadBytes = 1 << 20;
 
   // Attempt to open the table that is stored in bytes [0..file_size)
   // of "file", and read the metadata entries necessary to allow
@@ -115,7 +120,9 @@ class BlockBasedTable : public TableReader {
       size_t max_file_size_for_l0_meta_pin = 0,
       const std::string& cur_db_session_id = "", uint64_t cur_file_num = 0,
       UniqueId64x2 expected_unique_id = {},
-      const bool user_defined_timestamps_persisted = true);
+      const bool user_defined_timestamps_persisted = true,
+      const std::shared_ptr<CompressionManager>& compression_manager =
+          nullptr);
 
   bool PrefixRangeMayMatch(const Slice& internal_key,
                            const ReadOptions& read_options,
@@ -124,6 +131,13 @@ class BlockBasedTable : public TableReader {
                            BlockCacheLookupContext* lookup_context,
                            bool* filter_checked) const;
 
+  // Checks the range [internal_key, iterate_upper_bound) of a forward seek
+  // against the filter of a RangeFilterPolicy, if applicable.
+  bool RangeFilterMayMatch(const Slice& internal_key,
+                           const ReadOptions& read_options,
+                           BlockCacheLookupContext* lookup_context,
+                           bool* filter_checked) const;
+
   // Returns a new iterator over the table contents.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -149,6 +163,12 @@ class BlockBasedTable : public TableReader {
              GetContext* get_context, const SliceTransform* prefix_extractor,
              bool skip_filters = false) override;
 
+  Status GetWithHashIndex(const ReadOptions& readOptions, const Slice& key,
+                          GetContext* get_context,
+                          const SliceTransform* prefix_extractor,
+                          bool skip_filters,
+                          const FileHashIndex* hash_index) override;
+
   Status MultiGetFilter(const ReadOptions& read_options,
                         const SliceTransform* prefix_extractor,
                         MultiGetRange* mget_range) override;
@@ -161,9 +181,16 @@ class BlockBasedTable : public TableReader {
 
   // Pre-fetch the disk blocks that correspond to the key range specified by
   // (kbegin, kend). The call will return error status in the event of
-  // IO or iteration error.
+  // IO or iteration error. Data blocks already in the block cache are
+  // skipped, and runs of adjacent blocks that are not are read with one I/O
+  // of up to `read_options.readahead_size` bytes (kDefaultPrefetchReadBytes
+  // if 0).
   Status Prefetch(const ReadOptions& read_options, const Slice* begin,
-                  const Slice* end) override;
+                  const Slice* end, PrefetchStats* stats = nullptr,
+                  const PrefetchOptions* options = nullptr) override;
+
+  Status RestoreCacheEntry(const Slice& key, CacheEntryRole role,
+                           const Slice& saved) override;
 
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
@@ -185,8 +212,21 @@ class BlockBasedTable : public TableReader {
   Status ApproximateKeyAnchors(const ReadOptions& read_options,
                                std::vector<Anchor>& anchors) override;
 
+  Status GetHotKeyRanges(const ReadOptions& read_options,
+                         std::vector<HotKeyRange>* ranges) override;
+
   bool EraseFromCache(const BlockHandle& handle) const;
 
+  // Whether the block is in the (uncompressed) block cache.
+  bool BlockInCache(const BlockHandle& handle) const;
+
+  // Loads into the block cache the data blocks that the scans will need from
+  // this table, and that are not in the cache already. The blocks of all the
+  // scans are read together, adjacent ones in a single read. Errors are left
+  // for the scans to hit.
+  void PrepareScans(const ReadOptions& read_options,
+                    const std::vector<ScanOptions>& scan_opts) const;
+
   bool TEST_BlockInCache(const BlockHandle& handle) const;
 
   // Returns true if the block for the specified key is in cache.
@@ -341,6 +381,21 @@ class BlockBasedTable : public TableReader {
   friend class BlockBasedTableReaderTestVerifyChecksum_ChecksumMismatch_Test;
   BlockCacheTracer* const block_cache_tracer_;
 
+  // Loads into the block cache the data blocks of `block_handles` that are
+  // not there yet, reading runs of them at most `max_gap_bytes` apart with a
+  // single I/O of up to `max_read_bytes`. See Prefetch().
+  Status LoadDataBlocks(const ReadOptions& read_options,
+                        const std::vector<BlockHandle>& block_handles,
+                        size_t max_read_bytes, uint64_t max_gap_bytes,
+                        PrefetchStats* stats, const PrefetchOptions& options,
+                        BlockCacheLookupContext& lookup_context);
+
+  // Loads into the block cache, with a single I/O, the data blocks of the
+  // fetch unit (see BlockBasedTableOptions::data_block_fetch_unit_size) that
+  // holds the block `handle` found for `key`.
+  Status LoadDataFetchUnit(const ReadOptions& read_options, const Slice& key,
+                           const BlockHandle& handle);
+
   void UpdateCacheHitMetrics(BlockType block_type, GetContext* get_context,
                              size_t usage) const;
   void UpdateCacheMissMetrics(BlockType block_type,
@@ -449,7 +504,8 @@ class BlockBasedTable : public TableReader {
       BlockContents&& uncompressed_block_contents,
       BlockContents&& compressed_block_contents,
       CompressionType block_comp_type, UnownedPtr<Decompressor> decomp,
-      MemoryAllocator* memory_allocator, GetContext* get_context) const;
+      MemoryAllocator* memory_allocator, GetContext* get_context,
+      Cache::Priority priority) const;
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -501,6 +557,11 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  // Loads the prefix block map of the file, if any. Without it reads only
+  // lose the shortcuts, so errors are logged and ignored.
+  void ReadPrefixBlockMap(const ReadOptions& ro,
+                          FilePrefetchBuffer* prefetch_buffer,
+                          InternalIterator* meta_iter);
   // If index and filter blocks do not need to be pinned, `prefetch_all`
   // determines whether they will be read and add to cache.
   Status PrefetchIndexAndFilterBlocks(
@@ -543,6 +604,12 @@ class BlockBasedTable : public TableReader {
 
   bool TimestampMayMatch(const ReadOptions& read_options) const;
 
+  // Get() with the optional hash index of the file
+  Status GetImpl(const ReadOptions& read_options, const Slice& key,
+                 GetContext* get_context,
+                 const SliceTransform* prefix_extractor, bool skip_filters,
+                 const FileHashIndex* hash_index);
+
   // A cumulative data block file read in MultiGet lower than this size will
   // use a stack buffer
   static constexpr size_t kMultiGetReadStackBufSize = 8192;
@@ -615,6 +682,9 @@ struct BlockBasedTable::Rep {
   };
   FilterType filter_type;
   BlockHandle filter_handle;
+  // The filter_policy, if it is a RangeFilterPolicy that can check ranges
+  // against the filter found
+  const RangeFilterPolicy* range_filter_policy = nullptr;
   BlockHandle compression_dict_handle;
 
   std::shared_ptr<const TableProperties> table_properties;
@@ -627,6 +697,10 @@ struct BlockBasedTable::Rep {
 
   std::shared_ptr<FragmentedRangeTombstoneList> fragmented_range_dels;
 
+  // Built with `table_prefix_extractor`, see
+  // BlockBasedTableOptions::prefix_block_map
+  std::unique_ptr<PrefixBlockMap> prefix_block_map;
+
   // Context for block cache CreateCallback
   BlockCreateContext create_context;
 
@@ -656,6 +730,12 @@ struct BlockBasedTable::Rep {
   // might live in the block cache.
   std::shared_ptr<Decompressor> decompressor;
 
+  // Whether blocks are served straight from the mmap'd file, bypassing the
+  // block cache. An uncompressed file has no block that would own the memory
+  // needed for a cache entry, so looking blocks up in the cache, or charging
+  // for them, would only add overhead.
+  bool blocks_in_mmap = false;
+
   // These describe how index is encoded.
   bool index_has_first_key = false;
   bool index_key_includes_seq = true;
@@ -685,6 +765,10 @@ struct BlockBasedTable::Rep {
   // case of such a race, they will most likely be storing the same value.
   RelaxedAtomic<uint32_t> uncache_aggressiveness{0};
 
+  // Block cache hits of the data blocks by user reads, if
+  // `table_options.warmup_min_data_block_hits` is non-zero.
+  std::unique_ptr<DataBlockHitCounter> data_block_hits;
+
   std::unique_ptr<CacheReservationManager::CacheReservationHandle>
       table_reader_cache_res_handle = nullptr;
 
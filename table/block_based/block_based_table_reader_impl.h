@@ -115,7 +115,7 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
                                        block_contents_pinned);
 
   if (!block.IsCached()) {
-    if (!ro.fill_cache) {
+    if (!ro.fill_cache && !rep_->blocks_in_mmap) {
       IterPlaceholderCacheInterface block_cache{
           rep_->table_options.block_cache.get()};
       if (block_cache) {
@@ -175,7 +175,7 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
                                        iter, block_contents_pinned);
 
   if (!block.IsCached()) {
-    if (!ro.fill_cache) {
+    if (!ro.fill_cache && !rep_->blocks_in_mmap) {
       IterPlaceholderCacheInterface block_cache{
           rep_->table_options.block_cache.get()};
       if (block_cache) {
@@ -162,6 +162,103 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
     }
   }
 
+  // Decompresses the block if needed, and inserts it into the block caches
+  // or sets it up in results. With a decompression thread pool, this runs
+  // on the blocks at the same time, which only touch their own GetContext
+  // and results.
+  auto finish_block = [&](size_t block_idx, GetContext* get_context,
+                          const BlockHandle& handle,
+                          BlockContents* serialized_block,
+                          const char* data) -> Status {
+    Status s;
+    if (options.fill_cache) {
+      CachableEntry<Block_kData>* block_entry = &results[block_idx];
+      // MaybeReadBlockAndLoadToCache will insert into the block caches if
+      // necessary. Since we're passing the serialized block contents, it
+      // will avoid looking up the block cache
+      s = MaybeReadBlockAndLoadToCache(
+          nullptr, options, handle, decomp,
+          /*for_compaction=*/false, block_entry, get_context,
+          /*lookup_context=*/nullptr, serialized_block,
+          /*async_read=*/false, /*use_block_cache_for_lookup=*/true);
+
+      // block_entry value could be null if no block cache is present, i.e
+      // BlockBasedTableOptions::no_block_cache is true and no compressed
+      // block cache is configured. In that case, fall
+      // through and set up the block explicitly
+      if (!s.ok() || block_entry->GetValue() != nullptr) {
+        return s;
+      }
+    }
+
+    CompressionType compression_type =
+        GetBlockCompressionType(*serialized_block);
+    BlockContents contents;
+    if (compression_type != kNoCompression) {
+      s = DecompressSerializedBlock(data, handle.size(), compression_type,
+                                    *decomp, &contents, rep_->ioptions,
+                                    memory_allocator);
+    } else {
+      // There are two cases here:
+      // 1) caller uses the shared buffer (scratch or direct io buffer);
+      // 2) we use the requst buffer.
+      // If scratch buffer or direct io buffer is used, we ensure that
+      // all serialized blocks are copyed to the heap as single blocks. If
+      // scratch buffer is not used, we also have no combined read, so the
+      // serialized block can be used directly.
+      contents = std::move(*serialized_block);
+    }
+    if (s.ok()) {
+      results[block_idx].SetOwnedValue(std::make_unique<Block_kData>(
+          std::move(contents), read_amp_bytes_per_bit, ioptions.stats));
+    }
+    return s;
+  };
+  struct PendingBlock {
+    size_t idx_in_batch;
+    GetContext* get_context;
+    BlockHandle handle;
+    BlockContents serialized_block;
+    const char* data;
+  };
+  std::vector<PendingBlock> pending_blocks;
+
+  // Computes the checksums of the blocks read together, which is faster than
+  // computing them one by one below. Since the scratch might be shared, the
+  // offset of the data block in the buffer might not be 0. req.result.data()
+  // only point to the begin address of each read request, we need to add the
+  // offset in each read request.
+  std::array<uint32_t, MultiGetContext::MAX_BATCH_SIZE> checksums;
+  if (options.verify_checksums) {
+    std::array<const char*, MultiGetContext::MAX_BATCH_SIZE> block_data;
+    std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> block_sizes;
+    std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> block_valid_idx;
+    size_t num_blocks = 0;
+    size_t valid_idx = 0;
+    for (idx_in_batch = 0; idx_in_batch < handles->size(); ++idx_in_batch) {
+      const BlockHandle& handle = (*handles)[idx_in_batch];
+      if (handle.IsNull()) {
+        continue;
+      }
+      const size_t req_offset = req_offset_for_block[valid_idx];
+      const FSReadRequest& req = read_reqs[req_idx_for_block[valid_idx]];
+      if (req.status.ok() && req.result.size() == req.len &&
+          req_offset + BlockSizeWithTrailer(handle) <= req.result.size()) {
+        block_data[num_blocks] = req.result.data() + req_offset;
+        block_sizes[num_blocks] = handle.size();
+        block_valid_idx[num_blocks] = valid_idx;
+        num_blocks++;
+      }
+      valid_idx++;
+    }
+    std::array<uint32_t, MultiGetContext::MAX_BATCH_SIZE> computed;
+    ComputeBlockChecksums(footer, num_blocks, block_data.data(),
+                          block_sizes.data(), computed.data());
+    for (size_t i = 0; i < num_blocks; i++) {
+      checksums[block_valid_idx[i]] = computed[i];
+    }
+  }
+
   idx_in_batch = 0;
   size_t valid_batch_idx = 0;
   for (auto mget_iter = batch->begin(); mget_iter != batch->end();
@@ -216,13 +313,10 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
       if (options.verify_checksums) {
         PERF_TIMER_GUARD(block_checksum_time);
         const char* data = serialized_block.data.data();
-        // Since the scratch might be shared, the offset of the data block in
-        // the buffer might not be 0. req.result.data() only point to the
-        // begin address of each read request, we need to add the offset
-        // in each read request. Checksum is stored in the block trailer,
-        // beyond the payload size.
+        // Checksum is stored in the block trailer, beyond the payload size.
         s = VerifyBlockChecksum(footer, data, handle.size(),
-                                rep_->file->file_name(), handle.offset());
+                                rep_->file->file_name(), handle.offset(),
+                                checksums[valid_batch_idx - 1]);
         RecordTick(ioptions.stats, BLOCK_CHECKSUM_COMPUTE_COUNT);
         if (!s.ok()) {
           RecordTick(ioptions.stats, BLOCK_CHECKSUM_MISMATCH_COUNT);
@@ -293,56 +387,29 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
       }
     }
 
+    if (s.ok() && options.multiget_decompression_thread_pool != nullptr) {
+      pending_blocks.push_back({idx_in_batch, mget_iter->get_context, handle,
+                                std::move(serialized_block),
+                                req.result.data() + req_offset});
+      continue;
+    }
     if (s.ok()) {
-      if (options.fill_cache) {
-        CachableEntry<Block_kData>* block_entry = &results[idx_in_batch];
-        // MaybeReadBlockAndLoadToCache will insert into the block caches if
-        // necessary. Since we're passing the serialized block contents, it
-        // will avoid looking up the block cache
-        s = MaybeReadBlockAndLoadToCache(
-            nullptr, options, handle, decomp,
-            /*for_compaction=*/false, block_entry, mget_iter->get_context,
-            /*lookup_context=*/nullptr, &serialized_block,
-            /*async_read=*/false, /*use_block_cache_for_lookup=*/true);
-
-        if (!s.ok()) {
-          statuses[idx_in_batch] = s;
-          continue;
-        }
-        // block_entry value could be null if no block cache is present, i.e
-        // BlockBasedTableOptions::no_block_cache is true and no compressed
-        // block cache is configured. In that case, fall
-        // through and set up the block explicitly
-        if (block_entry->GetValue() != nullptr) {
-          continue;
-        }
-      }
-
-      CompressionType compression_type =
-          GetBlockCompressionType(serialized_block);
-      BlockContents contents;
-      if (compression_type != kNoCompression) {
-        s = DecompressSerializedBlock(
-            req.result.data() + req_offset, handle.size(), compression_type,
-            *decomp, &contents, rep_->ioptions, memory_allocator);
-      } else {
-        // There are two cases here:
-        // 1) caller uses the shared buffer (scratch or direct io buffer);
-        // 2) we use the requst buffer.
-        // If scratch buffer or direct io buffer is used, we ensure that
-        // all serialized blocks are copyed to the heap as single blocks. If
-        // scratch buffer is not used, we also have no combined read, so the
-        // serialized block can be used directly.
-        contents = std::move(serialized_block);
-      }
-      if (s.ok()) {
-        results[idx_in_batch].SetOwnedValue(std::make_unique<Block_kData>(
-            std::move(contents), read_amp_bytes_per_bit, ioptions.stats));
-      }
+      s = finish_block(idx_in_batch, mget_iter->get_context, handle,
+                       &serialized_block, req.result.data() + req_offset);
     }
     statuses[idx_in_batch] = s;
   }
 
+  if (!pending_blocks.empty()) {
+    ParallelFor(options.multiget_decompression_thread_pool,
+                pending_blocks.size(), [&](size_t i) {
+                  PendingBlock& block = pending_blocks[i];
+                  statuses[block.idx_in_batch] = finish_block(
+                      block.idx_in_batch, block.get_context, block.handle,
+                      &block.serialized_block, block.data);
+                });
+  }
+
   if (use_fs_scratch) {
     // Free the allocated scratch buffer by fs here as read requests might have
     // been combined into one.
@@ -512,32 +579,62 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
             cache_keys[cache_lookup_count] =
                 GetCacheKey(rep_->base_cache_key, v.handle);
             async_handle.key = cache_keys[cache_lookup_count].AsSlice();
-            // NB: StartAsyncLookupFull populates async_handle.helper
+            // NB: MultiLookupFull populates async_handle.helper
             async_handle.create_context = &create_ctx;
             async_handle.priority = GetCachePriority<Block_kData>();
             async_handle.stats = rep_->ioptions.statistics.get();
-
-            block_cache.StartAsyncLookupFull(
-                async_handle, rep_->ioptions.lowest_used_cache_tier);
             ++cache_lookup_count;
             // TODO: stats?
           }
         }
 
         if (block_cache) {
-          block_cache.get()->WaitAll(&async_handles[0], cache_lookup_count);
+          // All the data blocks together, to amortize hashing and shard
+          // access
+          block_cache.MultiLookupFull(&async_handles[0], cache_lookup_count,
+                                      rep_->ioptions.lowest_used_cache_tier);
         }
-        size_t lookup_idx = 0;
-        for (size_t i = 0; i < block_handles.size(); ++i) {
-          // If this block was a success or failure or not needed because
-          // the corresponding key is in the same block as a prior key, skip
-          if (block_handles[i] == BlockHandle::NullBlockHandle()) {
-            continue;
+        // The lookups still pending on a secondary cache are only waited on
+        // after starting to read the blocks missing from all the cache tiers,
+        // so that the secondary cache I/O overlaps with the SST I/O. Round 0
+        // reads the misses of the completed lookups and round 1 those of the
+        // pending ones, or all of them if none was pending.
+        MultiGetContext::Mask pending_mask = 0;
+        for (size_t i = 0; i < cache_lookup_count; ++i) {
+          if (async_handles[i].IsPending()) {
+            pending_mask |= MultiGetContext::Mask{1} << i;
           }
-          if (!block_cache) {
-            total_len += BlockSizeWithTrailer(block_handles[i]);
-          } else {
-            BCI::TypedHandle* h = async_handles[lookup_idx].Result();
+        }
+        for (int round = pending_mask ? 0 : 1; round < 2; ++round) {
+          if (round == 1 && pending_mask) {
+            block_cache.get()->WaitAll(&async_handles[0], cache_lookup_count);
+          }
+          // The blocks to read in this round
+          autovector<BlockHandle, MultiGetContext::MAX_BATCH_SIZE> read_handles;
+          total_len = 0;
+          size_t lookup_idx = 0;
+          for (size_t i = 0; i < block_handles.size(); ++i) {
+            read_handles.emplace_back(BlockHandle::NullBlockHandle());
+            // If this block was a success or failure or not needed because
+            // the corresponding key is in the same block as a prior key, skip
+            if (block_handles[i] == BlockHandle::NullBlockHandle()) {
+              continue;
+            }
+            if (!block_cache) {
+              read_handles[i] = block_handles[i];
+              total_len += BlockSizeWithTrailer(block_handles[i]);
+              continue;
+            }
+            BCI::TypedAsyncLookupHandle& async_handle =
+                async_handles[lookup_idx];
+            const bool was_pending = (pending_mask >> lookup_idx) & 1;
+            ++lookup_idx;
+            const bool this_round =
+                round == 0 ? !was_pending : (was_pending || pending_mask == 0);
+            if (!this_round) {
+              continue;
+            }
+            BCI::TypedHandle* h = async_handle.Result();
             if (h) {
               // Cache hit
               results[i].SetCachedValue(block_cache.Value(h), block_cache.get(),
@@ -548,61 +645,60 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
                                     block_cache.get()->GetUsage(h));
             } else {
               // Cache miss
+              read_handles[i] = block_handles[i];
               total_len += BlockSizeWithTrailer(block_handles[i]);
               UpdateCacheMissMetrics(BlockType::kData, get_context);
             }
             if (!data_lookup_contexts.empty()) {
               // Populate cache key before it's discarded
-              data_lookup_contexts[i].block_key =
-                  async_handles[lookup_idx].key.ToString();
+              data_lookup_contexts[i].block_key = async_handle.key.ToString();
             }
-            ++lookup_idx;
           }
-        }
-        assert(lookup_idx == cache_lookup_count);
-      }
-
-      if (total_len) {
-        char* scratch = nullptr;
-        bool use_fs_scratch = false;
-        assert(dict_inited || !rep_->uncompression_dict_reader);
-        assert(dict_status.ok());
-
-        if (!rep_->file->use_direct_io()) {
-          if (CheckFSFeatureSupport(rep_->ioptions.fs.get(),
-                                    FSSupportedOps::kFSBuffer)) {
-            use_fs_scratch = true;
-          }
-        }
+          assert(!block_cache || lookup_idx == cache_lookup_count);
+
+          if (total_len) {
+            char* scratch = nullptr;
+            bool use_fs_scratch = false;
+            assert(dict_inited || !rep_->uncompression_dict_reader);
+            assert(dict_status.ok());
+
+            if (!rep_->file->use_direct_io()) {
+              if (CheckFSFeatureSupport(rep_->ioptions.fs.get(),
+                                        FSSupportedOps::kFSBuffer)) {
+                use_fs_scratch = true;
+              }
+            }
 
-        // If using direct IO, then scratch is not used, so keep it nullptr.
-        // If the blocks need to be uncompressed and we don't need the
-        // compressed blocks, then we can use a contiguous block of
-        // memory to read in all the blocks as it will be temporary
-        // storage
-        // 1. If blocks are compressed and compressed block cache is there,
-        //    alloc heap bufs
-        // 2. If blocks are uncompressed, alloc heap bufs
-        // 3. If blocks are compressed and no compressed block cache, use
-        //    stack buf
-        if (!use_fs_scratch && !rep_->file->use_direct_io() &&
-            rep_->decompressor) {
-          if (total_len <= kMultiGetReadStackBufSize) {
-            scratch = stack_buf;
-          } else {
-            scratch = new char[total_len];
-            block_buf.reset(scratch);
+            // If using direct IO, then scratch is not used, so keep it
+            // nullptr. If the blocks need to be uncompressed and we don't
+            // need the compressed blocks, then we can use a contiguous block
+            // of memory to read in all the blocks as it will be temporary
+            // storage
+            // 1. If blocks are compressed and compressed block cache is
+            //    there, alloc heap bufs
+            // 2. If blocks are uncompressed, alloc heap bufs
+            // 3. If blocks are compressed and no compressed block cache, use
+            //    stack buf
+            if (!use_fs_scratch && !rep_->file->use_direct_io() &&
+                rep_->decompressor) {
+              if (total_len <= kMultiGetReadStackBufSize) {
+                scratch = stack_buf;
+              } else {
+                scratch = new char[total_len];
+                block_buf.reset(scratch);
+              }
+            }
+            CO_AWAIT(RetrieveMultipleBlocks)
+            (read_options, &data_block_range, &read_handles, &statuses[0],
+             &results[0], scratch,
+             dict.GetValue() ? dict.GetValue()->decompressor_.get()
+                             : rep_->decompressor.get(),
+             use_fs_scratch);
+            if (get_context) {
+              ++(get_context->get_context_stats_.num_sst_read);
+            }
           }
         }
-        CO_AWAIT(RetrieveMultipleBlocks)
-        (read_options, &data_block_range, &block_handles, &statuses[0],
-         &results[0], scratch,
-         dict.GetValue() ? dict.GetValue()->decompressor_.get()
-                         : rep_->decompressor.get(),
-         use_fs_scratch);
-        if (get_context) {
-          ++(get_context->get_context_stats_.num_sst_read);
-        }
       }
     }
 
@@ -30,6 +30,16 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// A compact index block has delta encoded values, where the value of each
+// restart entry is the size of its block handle followed by the rest of the
+// IndexValue, and the trailer has the form:
+//     restarts: EliasFanoSequence
+//     restart_handle_offsets: EliasFanoSequence
+//     entries_size: uint32
+//     num_restarts | kCompactIndexBlockFlag: uint32
+// restart_handle_offsets[i] is the offset of the block handle of the ith
+// restart entry.
 
 #include "table/block_based/block_builder.h"
 
@@ -39,6 +49,8 @@
 #include "db/dbformat.h"
 #include "rocksdb/comparator.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/elias_fano.h"
+#include "table/format.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -48,7 +60,7 @@ BlockBuilder::BlockBuilder(
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
     double data_block_hash_table_util_ratio, size_t ts_sz,
-    bool persist_user_defined_timestamps, bool is_user_key)
+    bool persist_user_defined_timestamps, bool is_user_key, bool compact_index)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
@@ -56,7 +68,8 @@ BlockBuilder::BlockBuilder(
       is_user_key_(is_user_key),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
-      finished_(false) {
+      finished_(false),
+      compact_index_(compact_index) {
   switch (index_type) {
     case BlockBasedTableOptions::kDataBlockBinarySearch:
       break;
@@ -64,10 +77,14 @@ BlockBuilder::BlockBuilder(
       data_block_hash_index_builder_.Initialize(
           data_block_hash_table_util_ratio);
       break;
+    case BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes:
+      use_restart_key_prefixes_ = true;
+      break;
     default:
       assert(0);
   }
   assert(block_restart_interval_ >= 1);
+  assert(!compact_index_ || use_value_delta_encoding_);
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
 }
 
@@ -82,6 +99,8 @@ void BlockBuilder::Reset() {
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
+  restart_key_prefixes_.clear();
+  restart_handle_offsets_.clear();
 #ifndef NDEBUG
   add_with_last_key_called_ = false;
 #endif
@@ -110,6 +129,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 
   if (counter_ >= block_restart_interval_) {
     estimate += sizeof(uint32_t);  // a new restart entry.
+    if (use_restart_key_prefixes_) {
+      estimate += sizeof(uint64_t);  // and its key prefix.
+    }
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -124,6 +146,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 }
 
 Slice BlockBuilder::Finish() {
+  if (compact_index_ && !buffer_.empty()) {
+    return FinishCompactIndex();
+  }
   // Append restart array
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
@@ -136,6 +161,15 @@ Slice BlockBuilder::Finish() {
       CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  } else if (use_restart_key_prefixes_ &&
+             restart_key_prefixes_.size() == restarts_.size() &&
+             CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
+    // Readers only look at the index type of blocks of up to 64KiB, like
+    // for the hash index.
+    for (uint64_t prefix : restart_key_prefixes_) {
+      PutFixed64(&buffer_, prefix);
+    }
+    index_type = BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes;
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
@@ -146,6 +180,18 @@ Slice BlockBuilder::Finish() {
   return Slice(buffer_);
 }
 
+Slice BlockBuilder::FinishCompactIndex() {
+  const uint32_t entries_size = static_cast<uint32_t>(buffer_.size());
+  EliasFanoSequence::Encode(
+      std::vector<uint64_t>(restarts_.begin(), restarts_.end()), &buffer_);
+  EliasFanoSequence::Encode(restart_handle_offsets_, &buffer_);
+  PutFixed32(&buffer_, entries_size);
+  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()) |
+                           kCompactIndexBlockFlag);
+  finished_ = true;
+  return Slice(buffer_);
+}
+
 void BlockBuilder::Add(const Slice& key, const Slice& value,
                        const Slice* const delta_value) {
   // Ensure no unsafe mixing of Add and AddWithLastKey
@@ -211,6 +257,13 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     // See how much sharing to do with previous string
     shared = key_to_persist.difference_offset(last_key_persisted);
   }
+  if (use_restart_key_prefixes_ && counter_ == 0) {
+    // Only data blocks, which have internal keys, use key prefixes
+    assert(!is_user_key_);
+    restart_key_prefixes_.push_back(
+        RestartKeyPrefix(ExtractUserKey(key_to_persist)));
+    estimate_ += sizeof(uint64_t);
+  }
 
   const size_t non_shared = key_to_persist.size() - shared;
 
@@ -230,7 +283,22 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
   // Use value delta encoding only when the key has shared bytes. This would
   // simplify the decoding, where it can figure which decoding to use simply by
   // looking at the shared bytes size.
-  if (shared != 0 && use_value_delta_encoding_) {
+  if (compact_index_) {
+    // Here only restart entries are not delta encoded, whether or not their
+    // keys have shared bytes
+    if (counter_ == 0) {
+      Slice rest = value;
+      BlockHandle handle;
+      Status s __attribute__((__unused__)) = handle.DecodeFrom(&rest);
+      assert(s.ok());
+      restart_handle_offsets_.push_back(handle.offset());
+      PutVarint64(&buffer_, handle.size());
+      buffer_.append(rest.data(), rest.size());
+    } else {
+      assert(!delta_value->empty());
+      buffer_.append(delta_value->data(), delta_value->size());
+    }
+  } else if (shared != 0 && use_value_delta_encoding_) {
     buffer_.append(delta_value->data(), delta_value->size());
   } else {
     buffer_.append(value.data(), value.size());
@@ -31,7 +31,8 @@ class BlockBuilder {
                         double data_block_hash_table_util_ratio = 0.75,
                         size_t ts_sz = 0,
                         bool persist_user_defined_timestamps = true,
-                        bool is_user_key = false);
+                        bool is_user_key = false,
+                        bool compact_index = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -86,6 +87,9 @@ class BlockBuilder {
                                  const Slice* const delta_value,
                                  size_t buffer_size);
 
+  // Finish() of a non-empty compact index block
+  Slice FinishCompactIndex();
+
   inline const Slice MaybeStripTimestampFromKey(std::string* key_buf,
                                                 const Slice& key);
 
@@ -120,6 +124,16 @@ class BlockBuilder {
   bool finished_;  // Has Finish() been called?
   std::string last_key_;
   DataBlockHashIndexBuilder data_block_hash_index_builder_;
+  // For kDataBlockBinarySearchWithKeyPrefixes, the RestartKeyPrefix() of each
+  // restart point
+  bool use_restart_key_prefixes_ = false;
+  std::vector<uint64_t> restart_key_prefixes_;
+  // Whether to build a compact index block, see
+  // BlockBasedTableOptions::compact_index_blocks. Then the restart index
+  // entries only have the size of their block handle, and the offsets are in
+  // restart_handle_offsets_
+  const bool compact_index_;
+  std::vector<uint64_t> restart_handle_offsets_;
 #ifndef NDEBUG
   bool add_with_last_key_called_ = false;
 #endif
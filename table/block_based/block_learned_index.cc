@@ -0,0 +1,179 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/block_learned_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// The number of the key, from the 8 bytes after `prefix_len`. Missing bytes
+// count as zeros, so that the numbers of keys that share the prefix don't
+// decrease in bytewise order.
+uint64_t ModelKey(const Slice& key, size_t prefix_len) {
+  uint64_t x = 0;
+  for (size_t i = prefix_len; i < prefix_len + sizeof(uint64_t); i++) {
+    x <<= 8;
+    if (i < key.size()) {
+      x |= static_cast<uint8_t>(key[i]);
+    }
+  }
+  return x;
+}
+}  // namespace
+
+// The meta block is
+//   prefix (length prefixed), num_restarts (varint32), max_error (varint32),
+//   num_knots (varint32), and for each knot
+//   key number (fixed64), restart index (varint32)
+std::string BlockLearnedIndex::Builder::Finish() {
+  assert(!empty());
+  const Slice first_key = keys_.front();
+  const Slice last_key = keys_.back();
+  // Keys are sorted, so what the first and last ones share all of them do
+  const size_t prefix_len = first_key.difference_offset(last_key);
+  std::string contents;
+  PutLengthPrefixedSlice(&contents, Slice(first_key.data(), prefix_len));
+  const uint32_t num_restarts = static_cast<uint32_t>(keys_.size());
+
+  std::vector<uint64_t> xs;
+  xs.reserve(keys_.size());
+  for (const auto& key : keys_) {
+    xs.push_back(ModelKey(key, prefix_len));
+  }
+  keys_.clear();
+
+  // Greedily extends each segment to the farthest knot whose line keeps the
+  // restart points in between within max_error_, by narrowing the range of
+  // slopes that do.
+  std::vector<std::pair<uint64_t, uint32_t>> knots;
+  knots.emplace_back(xs[0], 0);
+  uint32_t start = 0;
+  while (start + 1 < num_restarts) {
+    double min_slope = 0.0;
+    double max_slope = std::numeric_limits<double>::max();
+    uint32_t end = 0;
+    for (uint32_t j = start + 1; j < num_restarts; j++) {
+      const double dy = static_cast<double>(j - start);
+      if (xs[j] == xs[start]) {
+        if (j - start > max_error_) {
+          break;
+        }
+        continue;
+      }
+      const double dx = static_cast<double>(xs[j] - xs[start]);
+      const double slope = dy / dx;
+      if (slope >= min_slope && slope <= max_slope) {
+        end = j;
+      }
+      min_slope = std::max(min_slope, (dy - max_error_) / dx);
+      max_slope = std::min(max_slope, (dy + max_error_) / dx);
+      if (min_slope > max_slope) {
+        break;
+      }
+    }
+    if (end == 0) {
+      // Too many keys share the number of the knot, so the next knot is the
+      // first one with a larger number
+      end = start + 1;
+      while (end < num_restarts && xs[end] == xs[start]) {
+        end++;
+      }
+      if (end == num_restarts) {
+        break;
+      }
+    }
+    knots.emplace_back(xs[end], end);
+    start = end;
+  }
+
+  PutVarint32Varint32Varint32(&contents, num_restarts, max_error_,
+                              static_cast<uint32_t>(knots.size()));
+  for (const auto& knot : knots) {
+    PutFixed64(&contents, knot.first);
+    PutVarint32(&contents, knot.second);
+  }
+  return contents;
+}
+
+Status BlockLearnedIndex::Create(
+    const Slice& contents, std::unique_ptr<BlockLearnedIndex>* learned_index) {
+  Slice input = contents;
+  Slice prefix;
+  uint32_t num_restarts = 0;
+  uint32_t max_error = 0;
+  uint32_t num_knots = 0;
+  if (!GetLengthPrefixedSlice(&input, &prefix) ||
+      !GetVarint32(&input, &num_restarts) ||
+      !GetVarint32(&input, &max_error) || !GetVarint32(&input, &num_knots) ||
+      num_knots == 0 || num_knots > num_restarts) {
+    return Status::Corruption("Bad learned index model");
+  }
+  std::unique_ptr<BlockLearnedIndex> index(new BlockLearnedIndex());
+  index->prefix_ = prefix.ToString();
+  index->num_restarts_ = num_restarts;
+  index->max_error_ = max_error;
+  index->knot_keys_.reserve(num_knots);
+  index->knot_indexes_.reserve(num_knots);
+  for (uint32_t i = 0; i < num_knots; i++) {
+    uint64_t key = 0;
+    uint32_t restart_index = 0;
+    if (!GetFixed64(&input, &key) || !GetVarint32(&input, &restart_index) ||
+        restart_index >= num_restarts ||
+        (i > 0 && (key <= index->knot_keys_.back() ||
+                   restart_index <= index->knot_indexes_.back()))) {
+      return Status::Corruption("Bad learned index model knot");
+    }
+    index->knot_keys_.push_back(key);
+    index->knot_indexes_.push_back(restart_index);
+  }
+  *learned_index = std::move(index);
+  return Status::OK();
+}
+
+void BlockLearnedIndex::Predict(const Slice& user_key, uint32_t* first,
+                                uint32_t* last) const {
+  uint64_t x;
+  const int cmp =
+      Slice(user_key.data(), std::min(user_key.size(), prefix_.size()))
+          .compare(prefix_);
+  if (cmp < 0) {
+    x = 0;
+  } else if (cmp > 0) {
+    x = std::numeric_limits<uint64_t>::max();
+  } else {
+    x = ModelKey(user_key, prefix_.size());
+  }
+
+  uint32_t predicted;
+  auto it = std::upper_bound(knot_keys_.begin(), knot_keys_.end(), x);
+  if (it == knot_keys_.begin()) {
+    predicted = knot_indexes_.front();
+  } else if (it == knot_keys_.end()) {
+    predicted = knot_indexes_.back();
+  } else {
+    const size_t i = it - knot_keys_.begin() - 1;
+    const double fraction =
+        static_cast<double>(x - knot_keys_[i]) /
+        static_cast<double>(knot_keys_[i + 1] - knot_keys_[i]);
+    predicted = knot_indexes_[i] +
+                static_cast<uint32_t>(
+                    fraction * (knot_indexes_[i + 1] - knot_indexes_[i]));
+  }
+  // The restart point at or before the key is at most one before the
+  // prediction for the key, which is rounded down, so one more is allowed
+  // for on either side of the error of the model
+  const uint64_t margin = uint64_t{max_error_} + 1;
+  *first = predicted > margin ? static_cast<uint32_t>(predicted - margin) : 0;
+  *last = static_cast<uint32_t>(
+      std::min<uint64_t>(uint64_t{predicted} + margin, num_restarts_ - 1));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
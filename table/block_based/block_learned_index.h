@@ -0,0 +1,84 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A piecewise-linear model mapping the user keys of the restart points of an
+// index block to their restart indexes, so that a seek only binary searches
+// the few restart points around the predicted one.
+//
+// Keys are mapped to numbers through the 8 bytes that follow the prefix that
+// all keys of the block share, so the model only works for comparators that
+// order keys bytewise. It fits best fixed-width keys that are spread evenly,
+// like the ones generated from counters or hashes.
+//
+// The model is a sequence of knots, restart points whose index is exact, and
+// interpolates linearly between consecutive knots. The restart points between
+// two knots are predicted within `max_error` of their index, except the ones
+// that share the number of their key with more than `max_error` others.
+class BlockLearnedIndex {
+ public:
+  class Builder;
+
+  // Create the model by reading the meta block written by Builder.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<BlockLearnedIndex>* learned_index);
+
+  // Sets [*first, *last] to the restart indexes in which the last restart
+  // point with a key <= `user_key` is expected to be. If no restart key is
+  // <= `user_key`, *first is 0. The prediction is only valid when the keys
+  // are within the error bound of the model, so callers must verify it.
+  void Predict(const Slice& user_key, uint32_t* first, uint32_t* last) const;
+
+  uint32_t num_restarts() const { return num_restarts_; }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(BlockLearnedIndex) + prefix_.capacity() +
+           knot_keys_.capacity() * sizeof(uint64_t) +
+           knot_indexes_.capacity() * sizeof(uint32_t);
+  }
+
+ private:
+  BlockLearnedIndex() = default;
+
+  std::string prefix_;
+  uint32_t num_restarts_ = 0;
+  uint32_t max_error_ = 0;
+  std::vector<uint64_t> knot_keys_;
+  std::vector<uint32_t> knot_indexes_;
+};
+
+class BlockLearnedIndex::Builder {
+ public:
+  explicit Builder(uint32_t max_error) : max_error_(max_error) {}
+
+  // Adds the user key of the next restart point, in key order.
+  void Add(const Slice& user_key) {
+    keys_.emplace_back(user_key.data(), user_key.size());
+  }
+
+  bool empty() const { return keys_.empty(); }
+
+  // Returns the contents of the meta block with the model of all the keys
+  // added.
+  // REQUIRES: !empty()
+  std::string Finish();
+
+ private:
+  const uint32_t max_error_;
+  std::vector<std::string> keys_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "table/block_based/block_prefetcher.h"
 
+#include <algorithm>
+
 #include "rocksdb/file_system.h"
 #include "table/block_based/block_based_table_reader.h"
 
@@ -27,7 +29,10 @@ void BlockPrefetcher::PrefetchIfNeeded(
   ReadaheadParams readahead_params;
   readahead_params.initial_readahead_size = readahead_size;
   readahead_params.max_readahead_size = readahead_size;
-  readahead_params.num_buffers = is_async_io_prefetch ? 2 : 1;
+  readahead_params.num_buffers =
+      is_async_io_prefetch
+          ? std::max(read_options.async_readahead_num_buffers, size_t{2})
+          : 1;
 
   const size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
   const size_t offset = handle.offset();
@@ -25,6 +25,7 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/block_learned_index.h"
 #include "table/format.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
@@ -291,15 +292,102 @@ TEST_P(BlockTest, IndexHashWithSharedPrefix) {
 // Param 2: data block index type. User-defined timestamp feature is not
 // compatible with `kDataBlockBinaryAndHash` data block index type because the
 // user comparator doesn't provide a `CanKeysWithDifferentByteContentsBeEqual`
-// override. This combination is disabled.
+// override, nor with `kDataBlockBinarySearchWithKeyPrefixes`, which needs
+// keys in bytewise order. These combinations are disabled.
 INSTANTIATE_TEST_CASE_P(
     P, BlockTest,
     ::testing::Combine(
         ::testing::Bool(), ::testing::ValuesIn(test::GetUDTTestModes()),
         ::testing::Values(
             BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch,
+            BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash,
             BlockBasedTableOptions::DataBlockIndexType::
-                kDataBlockBinaryAndHash)));
+                kDataBlockBinarySearchWithKeyPrefixes)));
+
+TEST_F(BlockTest, KeyPrefixesSeek) {
+  Random rnd(301);
+  // Short keys and keys sharing their first 8 bytes, with bytes that zero
+  // padding and unsigned comparisons could get wrong
+  const char kAlphabet[] = {'\0', 'a', 'b', '\xff'};
+  std::set<std::string> user_keys;
+  while (user_keys.size() < 300) {
+    std::string user_key(rnd.Uniform(13), 'x');
+    for (auto &c : user_key) {
+      c = kAlphabet[rnd.Uniform(4)];
+    }
+    user_keys.insert(user_key);
+  }
+  std::vector<std::string> keys;
+  for (const auto &user_key : user_keys) {
+    keys.push_back(user_key);
+    AppendInternalKeyFooter(&keys.back(), 0 /* seqno */, kTypeValue);
+  }
+
+  for (int restart_interval : {1, 4}) {
+    BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                         false /* use_value_delta_encoding */,
+                         BlockBasedTableOptions::kDataBlockBinarySearch);
+    BlockBuilder prefixes_builder(
+        restart_interval, true /* use_delta_encoding */,
+        false /* use_value_delta_encoding */,
+        BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes);
+    for (size_t i = 0; i < keys.size(); i++) {
+      builder.Add(keys[i], std::to_string(i));
+      prefixes_builder.Add(keys[i], std::to_string(i));
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents));
+    BlockContents prefixes_contents;
+    prefixes_contents.data = prefixes_builder.Finish();
+    Block prefixes_reader(std::move(prefixes_contents));
+    ASSERT_EQ(BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes,
+              prefixes_reader.IndexType());
+    ASSERT_EQ(reader.NumRestarts(), prefixes_reader.NumRestarts());
+
+    std::unique_ptr<DataBlockIter> expected_iter(reader.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    std::unique_ptr<DataBlockIter> iter(prefixes_reader.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    ASSERT_OK(iter->status());
+    for (int i = 0; i < 2000; i++) {
+      std::string target;
+      if (i % 2 == 0) {
+        target = keys[rnd.Uniform(static_cast<int>(keys.size()))];
+      } else {
+        target.assign(rnd.Uniform(13), 'x');
+        for (auto &c : target) {
+          c = kAlphabet[rnd.Uniform(4)];
+        }
+        AppendInternalKeyFooter(&target, kMaxSequenceNumber,
+                                kValueTypeForSeek);
+      }
+      expected_iter->Seek(target);
+      iter->Seek(target);
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(expected_iter->Valid(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(expected_iter->key(), iter->key());
+        ASSERT_EQ(expected_iter->value(), iter->value());
+      }
+
+      expected_iter->SeekForPrev(target);
+      iter->SeekForPrev(target);
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(expected_iter->Valid(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(expected_iter->key(), iter->key());
+      }
+
+      ASSERT_TRUE(iter->SeekForGet(target));
+      expected_iter->Seek(target);
+      ASSERT_EQ(expected_iter->Valid(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(expected_iter->key(), iter->key());
+      }
+    }
+  }
+}
 
 // A slow and accurate version of BlockReadAmpBitmap that simply store
 // all the marked ranges in a set.
@@ -758,6 +846,174 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(::testing::Bool(), ::testing::Bool(), ::testing::Bool(),
                        ::testing::ValuesIn(test::GetUDTTestModes())));
 
+TEST_F(BlockTest, CompactIndexBlock) {
+  Random rnd(301);
+  const int kNumRecords = 500;
+  std::vector<std::string> separators;
+  std::vector<BlockHandle> block_handles;
+  std::vector<std::string> first_keys;
+  GenerateRandomIndexEntries(&separators, &block_handles, &first_keys,
+                             kNumRecords, 0 /* ts_sz */, true /* zero_seqno */);
+  for (int restart_interval : {1, 4, 16}) {
+    for (bool have_first_key : {false, true}) {
+      std::vector<std::unique_ptr<BlockBuilder>> builders;
+      for (bool compact : {false, true}) {
+        builders.emplace_back(new BlockBuilder(
+            restart_interval, true /* use_delta_encoding */,
+            true /* use_value_delta_encoding */,
+            BlockBasedTableOptions::kDataBlockBinarySearch,
+            0.75 /* data_block_hash_table_util_ratio */, 0 /* ts_sz */,
+            true /* persist_user_defined_timestamps */, false /* is_user_key */,
+            compact));
+      }
+      for (int i = 0; i < kNumRecords; i++) {
+        IndexValue entry(block_handles[i], first_keys[i]);
+        std::string encoded_entry;
+        std::string delta_encoded_entry;
+        entry.EncodeTo(&encoded_entry, have_first_key, nullptr);
+        if (i > 0) {
+          entry.EncodeTo(&delta_encoded_entry, have_first_key,
+                         &block_handles[i - 1]);
+        }
+        const Slice delta_encoded_entry_slice(delta_encoded_entry);
+        for (auto& builder : builders) {
+          builder->Add(separators[i], encoded_entry,
+                       &delta_encoded_entry_slice);
+        }
+      }
+      BlockContents regular_contents;
+      regular_contents.data = builders[0]->Finish();
+      BlockContents compact_contents;
+      compact_contents.data = builders[1]->Finish();
+      ASSERT_LT(compact_contents.data.size(), regular_contents.data.size());
+      Block regular(std::move(regular_contents));
+      Block compact(std::move(compact_contents));
+      ASSERT_EQ(regular.NumRestarts(), compact.NumRestarts());
+
+      std::unique_ptr<IndexBlockIter> iter(compact.NewIndexIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+          true /* total_order_seek */, have_first_key,
+          true /* key_includes_seq */, false /* value_is_full */));
+      auto check = [&](int index) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(separators[index], iter->key().ToString());
+        ASSERT_EQ(block_handles[index].offset(), iter->value().handle.offset());
+        ASSERT_EQ(block_handles[index].size(), iter->value().handle.size());
+        ASSERT_EQ(have_first_key ? first_keys[index] : "",
+                  iter->value().first_internal_key.ToString());
+      };
+      iter->SeekToFirst();
+      for (int i = 0; i < kNumRecords; i++) {
+        check(i);
+        iter->Next();
+      }
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+      iter->SeekToLast();
+      for (int i = kNumRecords - 1; i >= 0; i--) {
+        check(i);
+        iter->Prev();
+      }
+      ASSERT_FALSE(iter->Valid());
+      for (int i = 0; i < kNumRecords; i++) {
+        const int index = rnd.Uniform(kNumRecords);
+        iter->Seek(separators[index]);
+        check(index);
+        if (index + 1 < kNumRecords) {
+          iter->Next();
+          check(index + 1);
+        }
+      }
+      ASSERT_OK(iter->status());
+
+      // Compact index blocks need delta encoded values
+      iter.reset(compact.NewIndexIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+          true /* total_order_seek */, have_first_key,
+          true /* key_includes_seq */, true /* value_is_full */));
+      ASSERT_TRUE(iter->status().IsCorruption());
+    }
+  }
+}
+
+TEST_F(BlockTest, LearnedIndexSeek) {
+  Random64 rnd(301);
+  const int kNumRecords = 1000;
+  for (int restart_interval : {1, 4}) {
+    for (bool skewed : {false, true}) {
+      // Fixed-width user keys; skewed ones are dense at the start and
+      // sparse at the end of the key space
+      std::vector<std::string> keys;
+      char buf[17];
+      uint64_t key = 0;
+      for (int i = 0; i < kNumRecords; i++) {
+        const uint64_t n = static_cast<uint64_t>(i);
+        key += skewed ? 1 + n * n * n : 1000 + rnd.Uniform(10);
+        snprintf(buf, sizeof(buf), "%016" PRIx64, key);
+        keys.emplace_back(buf);
+      }
+
+      BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                           false /* use_value_delta_encoding */,
+                           BlockBasedTableOptions::kDataBlockBinarySearch,
+                           0.75 /* data_block_hash_table_util_ratio */,
+                           0 /* ts_sz */, true /* persist_user_defined_ts */,
+                           true /* is_user_key */);
+      BlockLearnedIndex::Builder model_builder(8 /* max_error */);
+      for (int i = 0; i < kNumRecords; i++) {
+        std::string encoded_entry;
+        IndexValue(BlockHandle(uint64_t{100} * i, 100), Slice())
+            .EncodeTo(&encoded_entry, false /* have_first_key */, nullptr);
+        builder.Add(keys[i], encoded_entry);
+        if (i % restart_interval == 0) {
+          model_builder.Add(keys[i]);
+        }
+      }
+      BlockContents contents;
+      contents.data = builder.Finish();
+      Block reader(std::move(contents));
+      const std::string model = model_builder.Finish();
+      std::unique_ptr<BlockLearnedIndex> learned_index;
+      ASSERT_OK(BlockLearnedIndex::Create(model, &learned_index));
+      ASSERT_EQ(reader.NumRestarts(), learned_index->num_restarts());
+
+      std::unique_ptr<IndexBlockIter> expected_iter(reader.NewIndexIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+          true /* total_order_seek */, false /* have_first_key */,
+          false /* key_includes_seq */, true /* value_is_full */));
+      std::unique_ptr<IndexBlockIter> iter(reader.NewIndexIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+          true /* total_order_seek */, false /* have_first_key */,
+          false /* key_includes_seq */, true /* value_is_full */,
+          false /* block_contents_pinned */,
+          true /* user_defined_timestamps_persisted */,
+          nullptr /* prefix_index */, learned_index.get()));
+
+      std::vector<std::string> targets = {"", "0", "1", "g", keys.back()};
+      for (int i = 0; i < kNumRecords * 2; i++) {
+        if (i % 2 == 0) {
+          targets.push_back(keys[rnd.Uniform(kNumRecords)]);
+        } else {
+          snprintf(buf, sizeof(buf), "%016" PRIx64, rnd.Uniform(key + 1));
+          targets.emplace_back(buf);
+        }
+      }
+      for (const auto& target : targets) {
+        InternalKey seek_key(target, kMaxSequenceNumber, kValueTypeForSeek);
+        expected_iter->Seek(seek_key.Encode());
+        iter->Seek(seek_key.Encode());
+        ASSERT_OK(iter->status());
+        ASSERT_EQ(expected_iter->Valid(), iter->Valid()) << target;
+        if (iter->Valid()) {
+          ASSERT_EQ(expected_iter->key(), iter->key()) << target;
+          ASSERT_EQ(expected_iter->value().handle.offset(),
+                    iter->value().handle.offset());
+        }
+      }
+    }
+  }
+}
+
 class BlockPerKVChecksumTest : public DBTestBase {
  public:
   BlockPerKVChecksumTest()
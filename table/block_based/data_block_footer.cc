@@ -15,11 +15,13 @@ namespace ROCKSDB_NAMESPACE {
 
 const int kDataBlockIndexTypeBitShift = 31;
 
-// 0x7FFFFFFF
-const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
+const int kDataBlockKeyPrefixesBitShift = 30;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// 0x1FFFFFFF
+const uint32_t kMaxNumRestarts = kCompactIndexBlockFlag - 1u;
+
+// 0x1FFFFFFF
+const uint32_t kNumRestartsMask = kCompactIndexBlockFlag - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
@@ -31,6 +33,9 @@ uint32_t PackIndexTypeAndNumRestarts(
   uint32_t block_footer = num_restarts;
   if (index_type == BlockBasedTableOptions::kDataBlockBinaryAndHash) {
     block_footer |= 1u << kDataBlockIndexTypeBitShift;
+  } else if (index_type ==
+             BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes) {
+    block_footer |= 1u << kDataBlockKeyPrefixesBitShift;
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
@@ -45,6 +50,9 @@ void UnPackIndexTypeAndNumRestarts(
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+    } else if (block_footer & 1u << kDataBlockKeyPrefixesBitShift) {
+      *index_type =
+          BlockBasedTableOptions::kDataBlockBinarySearchWithKeyPrefixes;
     } else {
       *index_type = BlockBasedTableOptions::kDataBlockBinarySearch;
     }
@@ -9,10 +9,35 @@
 
 #pragma once
 
+#include <cstdint>
+
+#include "rocksdb/slice.h"
 #include "rocksdb/table.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+// The entry for a restart point in the key prefix array of a
+// kDataBlockBinarySearchWithKeyPrefixes block: the first 8 bytes of the user
+// key of the restart point, read as a big-endian number. Missing bytes count
+// as zeros, so that the entries of keys in bytewise order don't decrease.
+// The array is stored between the restart array and the block footer, with
+// each entry encoded with PutFixed64().
+inline uint64_t RestartKeyPrefix(const Slice& user_key) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    prefix <<= 8;
+    if (i < user_key.size()) {
+      prefix |= static_cast<uint8_t>(user_key[i]);
+    }
+  }
+  return prefix;
+}
+
+// Set in the footer of compact index blocks, see BlockBuilder. Unlike the
+// index type bits, it is read for blocks of any size, as a block needs at
+// least 2GiB for 2^29 restarts.
+constexpr uint32_t kCompactIndexBlockFlag = uint32_t{1} << 29;
+
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
     uint32_t num_restarts);
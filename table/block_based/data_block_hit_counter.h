@@ -0,0 +1,60 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "rocksdb/slice.h"
+#include "util/atomic.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Approximate per data block count of the block cache hits of one table file,
+// see BlockBasedTableOptions::warmup_min_data_block_hits. Blocks are
+// identified by their offset in the file and hashed to one of as many
+// saturating one-byte counters as the file has data blocks, so colliding
+// blocks share a counter. Thread-safe; concurrent hits on the same counter
+// may be lost, which is fine for telling hot blocks from cold ones.
+class DataBlockHitCounter {
+ public:
+  explicit DataBlockHitCounter(uint64_t num_data_blocks)
+      : num_counters_(static_cast<size_t>(
+            num_data_blocks == 0 ? uint64_t{1} : num_data_blocks)),
+        counters_(new RelaxedAtomic<uint8_t>[num_counters_]) {}
+
+  void RecordHit(uint64_t block_offset) {
+    RelaxedAtomic<uint8_t>& counter = counters_[Index(block_offset)];
+    const uint8_t hits = counter.LoadRelaxed();
+    if (hits < UINT8_MAX) {
+      counter.StoreRelaxed(hits + 1);
+    }
+  }
+
+  uint8_t GetHits(uint64_t block_offset) const {
+    return counters_[Index(block_offset)].LoadRelaxed();
+  }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + num_counters_ * sizeof(RelaxedAtomic<uint8_t>);
+  }
+
+ private:
+  size_t Index(uint64_t block_offset) const {
+    return FastRange64(
+        GetSliceNPHash64(Slice(reinterpret_cast<const char*>(&block_offset),
+                               sizeof(block_offset))),
+        num_counters_);
+  }
+
+  const size_t num_counters_;
+  std::unique_ptr<RelaxedAtomic<uint8_t>[]> counters_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
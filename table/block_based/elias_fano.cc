@@ -0,0 +1,155 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/elias_fano.h"
+
+#include <cassert>
+
+#include "util/coding.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr size_t kHeaderSize = 2 * sizeof(uint32_t) + 1 + sizeof(uint64_t);
+}  // namespace
+
+void EliasFanoSequence::Encode(const std::vector<uint64_t>& values,
+                               std::string* dst) {
+  const uint32_t size = static_cast<uint32_t>(values.size());
+  PutFixed32(dst, size);
+  if (size == 0) {
+    dst->push_back(0);
+    PutFixed64(dst, 0);
+    PutFixed32(dst, 0);
+    return;
+  }
+  const uint64_t base = values.front();
+  const uint64_t range = values.back() - base;
+  uint32_t low_bits = 0;
+  for (uint64_t q = range / size; q > 1; q >>= 1) {
+    low_bits++;
+  }
+  const uint64_t low_mask = (uint64_t{1} << low_bits) - 1;
+  // Less than 3 * size, since range >> low_bits < 2 * size
+  const uint32_t high_bits = static_cast<uint32_t>(size + (range >> low_bits));
+  dst->push_back(static_cast<char>(low_bits));
+  PutFixed64(dst, base);
+  PutFixed32(dst, high_bits);
+
+  std::vector<uint64_t> low_words((uint64_t{size} * low_bits + 63) / 64);
+  std::vector<uint64_t> high_words((uint64_t{high_bits} + 63) / 64);
+  std::vector<uint32_t> samples;
+  samples.reserve((size + kSampleRate - 1) / kSampleRate);
+  for (uint32_t i = 0; i < size; i++) {
+    assert(i == 0 || values[i] >= values[i - 1]);
+    const uint64_t v = values[i] - base;
+    if (low_bits > 0) {
+      const uint64_t pos = uint64_t{i} * low_bits;
+      const uint64_t off = pos % 64;
+      low_words[pos / 64] |= (v & low_mask) << off;
+      if (off + low_bits > 64) {
+        low_words[pos / 64 + 1] |= (v & low_mask) >> (64 - off);
+      }
+    }
+    const uint64_t pos = i + (v >> low_bits);
+    high_words[pos / 64] |= uint64_t{1} << (pos % 64);
+    if (i % kSampleRate == 0) {
+      samples.push_back(static_cast<uint32_t>(pos));
+    }
+  }
+  for (uint64_t w : low_words) {
+    PutFixed64(dst, w);
+  }
+  for (uint64_t w : high_words) {
+    PutFixed64(dst, w);
+  }
+  for (uint32_t s : samples) {
+    PutFixed32(dst, s);
+  }
+}
+
+bool EliasFanoSequence::Init(Slice* input) {
+  if (input->size() < kHeaderSize) {
+    return false;
+  }
+  const char* p = input->data();
+  size_ = DecodeFixed32(p);
+  low_bits_ = static_cast<uint8_t>(p[sizeof(uint32_t)]);
+  base_ = DecodeFixed64(p + sizeof(uint32_t) + 1);
+  const uint32_t high_bits =
+      DecodeFixed32(p + sizeof(uint32_t) + 1 + sizeof(uint64_t));
+  if (low_bits_ >= 64 || high_bits < size_) {
+    return false;
+  }
+  num_high_words_ = static_cast<uint32_t>((uint64_t{high_bits} + 63) / 64);
+  const uint64_t low_size =
+      (uint64_t{size_} * low_bits_ + 63) / 64 * sizeof(uint64_t);
+  const uint64_t high_size = uint64_t{num_high_words_} * sizeof(uint64_t);
+  const uint64_t num_samples = (uint64_t{size_} + kSampleRate - 1) / kSampleRate;
+  const uint64_t total_size =
+      kHeaderSize + low_size + high_size + num_samples * sizeof(uint32_t);
+  if (total_size > input->size()) {
+    return false;
+  }
+  low_words_ = p + kHeaderSize;
+  high_words_ = low_words_ + low_size;
+  samples_ = high_words_ + high_size;
+  for (uint64_t i = 0; i < num_samples; i++) {
+    if (DecodeFixed32(samples_ + i * sizeof(uint32_t)) >= high_bits) {
+      return false;
+    }
+  }
+  input->remove_prefix(static_cast<size_t>(total_size));
+  return true;
+}
+
+uint64_t EliasFanoSequence::HighWord(uint32_t w) const {
+  return DecodeFixed64(high_words_ + uint64_t{w} * sizeof(uint64_t));
+}
+
+uint64_t EliasFanoSequence::SelectHigh(uint32_t i) const {
+  const uint32_t pos =
+      DecodeFixed32(samples_ + (i / kSampleRate) * sizeof(uint32_t));
+  uint32_t rank = i % kSampleRate;
+  uint32_t w = pos / 64;
+  uint64_t word = HighWord(w) & (~uint64_t{0} << (pos % 64));
+  for (;;) {
+    const uint32_t ones = static_cast<uint32_t>(BitsSetToOne(word));
+    if (rank < ones) {
+      break;
+    }
+    rank -= ones;
+    if (++w >= num_high_words_) {
+      // Only for corrupted sequences
+      return pos;
+    }
+    word = HighWord(w);
+  }
+  for (; rank > 0; rank--) {
+    word &= word - 1;
+  }
+  return uint64_t{w} * 64 + CountTrailingZeroBits(word);
+}
+
+uint64_t EliasFanoSequence::Get(uint32_t i) const {
+  assert(i < size_);
+  uint64_t low = 0;
+  if (low_bits_ > 0) {
+    const uint64_t pos = uint64_t{i} * low_bits_;
+    const uint64_t off = pos % 64;
+    const char* w = low_words_ + pos / 64 * sizeof(uint64_t);
+    low = DecodeFixed64(w) >> off;
+    if (off + low_bits_ > 64) {
+      low |= DecodeFixed64(w + sizeof(uint64_t)) << (64 - off);
+    }
+    low &= (uint64_t{1} << low_bits_) - 1;
+  }
+  const uint64_t high = SelectHigh(i) - i;
+  return base_ + ((high << low_bits_) | low);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,60 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A non-decreasing sequence of integers in Elias-Fano encoding, which takes
+// about 2 + log2(range / size) bits per value and is read in place, in
+// constant time for each value. It is used by compact index blocks, see
+// BlockBasedTableOptions::compact_index_blocks.
+//
+// The encoding is
+//   size (fixed32), low_bits (1 byte), base (fixed64), high_bits (fixed32)
+//   low words: fixed64[ceil(size * low_bits / 64)]
+//   high words: fixed64[ceil(high_bits / 64)]
+//   samples: fixed32[ceil(size / kSampleRate)]
+// For the i-th value minus `base`, its low `low_bits` bits are at bit
+// i * low_bits of the low words, and the rest is the number of zeros before
+// the i-th one of the high words. The samples are the bit positions of every
+// kSampleRate-th one of the high words.
+class EliasFanoSequence {
+ public:
+  static constexpr uint32_t kSampleRate = 64;
+
+  // Appends the encoding of `values` to *dst. REQUIRES: `values` is sorted.
+  static void Encode(const std::vector<uint64_t>& values, std::string* dst);
+
+  // Parses the sequence at the start of *input, which must outlive the
+  // sequence, and advances *input past it. Returns false if it is malformed.
+  bool Init(Slice* input);
+
+  uint32_t size() const { return size_; }
+
+  // REQUIRES: i < size()
+  uint64_t Get(uint32_t i) const;
+
+ private:
+  uint64_t HighWord(uint32_t w) const;
+  // Position of the i-th one of the high words
+  uint64_t SelectHigh(uint32_t i) const;
+
+  uint32_t size_ = 0;
+  uint32_t low_bits_ = 0;
+  uint64_t base_ = 0;
+  uint32_t num_high_words_ = 0;
+  const char* low_words_ = nullptr;
+  const char* high_words_ = nullptr;
+  const char* samples_ = nullptr;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
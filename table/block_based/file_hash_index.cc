@@ -0,0 +1,97 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/file_hash_index.h"
+
+#include <cassert>
+
+#include "db/dbformat.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The fingerprint of a key goes in the upper 32 bits of a slot, and is never
+// zero so that a slot in use is never 0
+inline uint64_t SlotTag(uint64_t hash) {
+  return (hash | (uint64_t{1} << 32)) & ~uint64_t{0xffffffff};
+}
+}  // namespace
+
+void FileHashIndex::Builder::OnKeyAdded(const Slice& internal_key) {
+  const Slice user_key = ExtractUserKeyAndStripTimestamp(internal_key, ts_sz_);
+  if (has_last_user_key_ && user_key == Slice(last_user_key_)) {
+    return;
+  }
+  last_user_key_.assign(user_key.data(), user_key.size());
+  has_last_user_key_ = true;
+  keys_.push_back(KeyEntry{GetSliceHash64(user_key),
+                           static_cast<uint32_t>(handles_.size())});
+}
+
+void FileHashIndex::Builder::OnDataBlockWritten(const BlockHandle& handle) {
+  handles_.push_back(handle);
+}
+
+std::shared_ptr<const FileHashIndex> FileHashIndex::Builder::Finish() {
+  if (handles_.empty() || handles_.size() >= kAmbiguous) {
+    return nullptr;
+  }
+  assert(keys_.empty() || keys_.back().block < handles_.size());
+  std::shared_ptr<FileHashIndex> index(new FileHashIndex());
+  // Keep the load factor at most 3/4
+  size_t num_slots = 1;
+  while (num_slots * 3 < keys_.size() * 4 + 4) {
+    num_slots *= 2;
+  }
+  index->slots_.resize(num_slots, 0);
+  index->handles_ = std::move(handles_);
+  const size_t mask = num_slots - 1;
+  for (const KeyEntry& key : keys_) {
+    const uint64_t tag = SlotTag(key.hash);
+    for (size_t i = static_cast<size_t>(key.hash) & mask;;
+         i = (i + 1) & mask) {
+      uint64_t& slot = index->slots_[i];
+      if (slot == 0) {
+        slot = tag | key.block;
+        break;
+      }
+      if ((slot & ~uint64_t{0xffffffff}) == tag) {
+        if (static_cast<uint32_t>(slot) != key.block) {
+          slot = tag | kAmbiguous;
+        }
+        break;
+      }
+    }
+  }
+  keys_.clear();
+  keys_.shrink_to_fit();
+  if (cache_res_mgr_ != nullptr) {
+    Status s = cache_res_mgr_->MakeCacheReservation(
+        index->ApproximateMemoryUsage(), &index->cache_res_handle_);
+    if (!s.ok()) {
+      return nullptr;
+    }
+  }
+  return index;
+}
+
+uint32_t FileHashIndex::Lookup(const Slice& user_key) const {
+  const uint64_t hash = GetSliceHash64(user_key);
+  const uint64_t tag = SlotTag(hash);
+  const size_t mask = slots_.size() - 1;
+  for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+    const uint64_t slot = slots_[i];
+    if (slot == 0) {
+      return kNotFound;
+    }
+    if ((slot & ~uint64_t{0xffffffff}) == tag) {
+      return static_cast<uint32_t>(slot);
+    }
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,101 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cache/cache_reservation_manager.h"
+#include "rocksdb/slice.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// An in-memory hash index from the user keys of a table file to the data
+// blocks holding them, see AdvancedColumnFamilyOptions::bottommost_hash_index.
+// Each key is stored as a 32-bit fingerprint, so a lookup of a key that is
+// not in the file can, rarely, point to a data block that does not hold it.
+class FileHashIndex {
+ public:
+  class Builder;
+
+  // Returned by Lookup() when no key of the file has the fingerprint of the
+  // key
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+  // Returned by Lookup() when keys of different data blocks share the
+  // fingerprint of the key, which must then be looked up in the index block
+  static constexpr uint32_t kAmbiguous = UINT32_MAX - 1;
+
+  // Returns kNotFound, kAmbiguous or the ordinal of the first data block that
+  // can hold `user_key`. The versions of a key can go on in the next blocks.
+  uint32_t Lookup(const Slice& user_key) const;
+
+  size_t num_blocks() const { return handles_.size(); }
+
+  const BlockHandle& block_handle(uint32_t ordinal) const {
+    return handles_[ordinal];
+  }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(FileHashIndex) + handles_.capacity() * sizeof(BlockHandle) +
+           slots_.capacity() * sizeof(uint64_t);
+  }
+
+ private:
+  FileHashIndex() = default;
+
+  // The handles of the data blocks, in file order
+  std::vector<BlockHandle> handles_;
+  // Open addressing with linear probing. A slot holds the (non-zero)
+  // fingerprint of a key in its upper 32 bits and the block ordinal in the
+  // lower ones, or is 0 when empty. The size is a power of two.
+  std::vector<uint64_t> slots_;
+  // Charges the index to the block cache for as long as it lives
+  std::unique_ptr<CacheReservationManager::CacheReservationHandle>
+      cache_res_handle_;
+};
+
+// Builds the hash index from the keys of the data blocks, in the order they
+// are written to the file.
+class FileHashIndex::Builder {
+ public:
+  // `cache_res_mgr` charges the memory of the finished index, and may be
+  // null.
+  Builder(std::shared_ptr<CacheReservationManager> cache_res_mgr,
+          size_t ts_sz)
+      : cache_res_mgr_(std::move(cache_res_mgr)), ts_sz_(ts_sz) {}
+
+  // Adds the internal key of the next entry of the data block being built.
+  void OnKeyAdded(const Slice& internal_key);
+
+  // Called once the data block with all the keys added since the last call is
+  // written to `handle`.
+  void OnDataBlockWritten(const BlockHandle& handle);
+
+  // Returns the index, or nullptr if the file has no data blocks or the
+  // index could not be charged to the block cache. REQUIRES: all the data
+  // blocks were written.
+  std::shared_ptr<const FileHashIndex> Finish();
+
+ private:
+  struct KeyEntry {
+    uint64_t hash;
+    // Ordinal of the first data block with the key
+    uint32_t block;
+  };
+
+  const std::shared_ptr<CacheReservationManager> cache_res_mgr_;
+  const size_t ts_sz_;
+  std::vector<BlockHandle> handles_;
+  std::vector<KeyEntry> keys_;
+  // The last user key added, whose other versions are not added again
+  std::string last_user_key_;
+  bool has_last_user_key_ = false;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
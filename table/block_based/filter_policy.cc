@@ -12,8 +12,10 @@
 #include <array>
 #include <atomic>
 #include <climits>
+#include <cmath>
 #include <cstring>
 #include <deque>
+#include <functional>
 #include <limits>
 #include <memory>
 
@@ -21,6 +23,7 @@
 #include "cache/cache_reservation_manager.h"
 #include "logging/logging.h"
 #include "port/lang.h"
+#include "rocksdb/comparator.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/rocksdb_namespace.h"
 #include "rocksdb/slice.h"
@@ -596,18 +599,26 @@ class FastLocalBloomBitsReader : public BuiltinFilterBitsReader {
   }
 
   void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
-    std::array<uint32_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    for (int i = 0; i < num_keys; ++i) {
+      hashes[i] = GetSliceHash64(*keys[i]);
+    }
+    HashesMayMatch(num_keys, hashes.data(), may_match);
+  }
+
+  bool HashesMayMatch(int num_keys, const uint64_t* hashes,
+                      bool* may_match) override {
+    // Prefetch the cache lines of all keys before probing any of them
     std::array<uint32_t, MultiGetContext::MAX_BATCH_SIZE> byte_offsets;
     for (int i = 0; i < num_keys; ++i) {
-      uint64_t h = GetSliceHash64(*keys[i]);
-      FastLocalBloomImpl::PrepareHash(Lower32of64(h), len_bytes_, data_,
-                                      /*out*/ &byte_offsets[i]);
-      hashes[i] = Upper32of64(h);
+      FastLocalBloomImpl::PrepareHash(Lower32of64(hashes[i]), len_bytes_,
+                                      data_, /*out*/ &byte_offsets[i]);
     }
     for (int i = 0; i < num_keys; ++i) {
       may_match[i] = FastLocalBloomImpl::HashMayMatchPrepared(
-          hashes[i], num_probes_, data_ + byte_offsets[i]);
+          Upper32of64(hashes[i]), num_probes_, data_ + byte_offsets[i]);
     }
+    return true;
   }
 
   bool HashMayMatch(const uint64_t h) override {
@@ -1036,6 +1047,15 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
   }
 
   void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
+    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    for (int i = 0; i < num_keys; ++i) {
+      hashes[i] = GetSliceHash64(*keys[i]);
+    }
+    HashesMayMatch(num_keys, hashes.data(), may_match);
+  }
+
+  bool HashesMayMatch(int num_keys, const uint64_t* hashes,
+                      bool* may_match) override {
     struct SavedData {
       uint64_t seeded_hash;
       uint32_t segment_num;
@@ -1045,7 +1065,7 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
     std::array<SavedData, MultiGetContext::MAX_BATCH_SIZE> saved;
     for (int i = 0; i < num_keys; ++i) {
       ribbon::InterleavedPrepareQuery(
-          GetSliceHash64(*keys[i]), hasher_, soln_, &saved[i].seeded_hash,
+          hashes[i], hasher_, soln_, &saved[i].seeded_hash,
           &saved[i].segment_num, &saved[i].num_columns, &saved[i].start_bits);
     }
     for (int i = 0; i < num_keys; ++i) {
@@ -1053,6 +1073,7 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
           saved[i].seeded_hash, saved[i].segment_num, saved[i].num_columns,
           saved[i].start_bits, hasher_, soln_);
     }
+    return true;
   }
 
   bool HashMayMatch(const uint64_t h) override {
@@ -1883,12 +1904,287 @@ std::string RibbonFilterPolicy::GetId() const {
          std::to_string(bloom_before_level_.load(std::memory_order_acquire));
 }
 
+LevelAdaptiveBloomFilterPolicy::LevelAdaptiveBloomFilterPolicy(
+    double bits_per_key)
+    : BloomLikeFilterPolicy(bits_per_key),
+      avg_bits_per_key_(GetMillibitsPerKey() / 1000.0) {}
+
+const char* LevelAdaptiveBloomFilterPolicy::kClassName() {
+  return "levelbloomfilter";
+}
+const char* LevelAdaptiveBloomFilterPolicy::kNickName() {
+  return "rocksdb.LevelAdaptiveBloomFilter";
+}
+
+FilterBitsBuilder* LevelAdaptiveBloomFilterPolicy::GetBuilderWithContext(
+    const FilterBuildingContext& context) const {
+  if (GetMillibitsPerKey() == 0) {
+    // "No filter" special case
+    return nullptr;
+  }
+  // Flushes are built for L0
+  const double bits_per_key =
+      GetBitsPerKey(context.column_family_name, context.level_at_creation);
+  // Rounded to thousandths of a bit, like BloomLikeFilterPolicy
+  const int millibits_per_key =
+      static_cast<int>(std::round(bits_per_key * 1000.0));
+  BloomFilterPolicy* policy;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& level_policy = level_policies_[millibits_per_key];
+    if (level_policy == nullptr) {
+      level_policy.reset(new BloomFilterPolicy(millibits_per_key / 1000.0));
+    }
+    policy = level_policy.get();
+  }
+  return policy->GetBuilderWithContext(context);
+}
+
+double LevelAdaptiveBloomFilterPolicy::GetBitsPerKey(
+    const std::string& column_family, int level) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = cf_bits_per_key_.find(column_family);
+  if (level < 0 || it == cf_bits_per_key_.end() ||
+      static_cast<size_t>(level) >= it->second.size()) {
+    return avg_bits_per_key_;
+  }
+  return it->second[level];
+}
+
+void LevelAdaptiveBloomFilterPolicy::UpdateLevels(
+    const std::string& column_family, const std::vector<uint64_t>& level_bytes,
+    const std::vector<uint64_t>& level_probes) const {
+  std::vector<double> bits_per_key =
+      AllocateBitsPerKey(avg_bits_per_key_, level_bytes, level_probes);
+  std::lock_guard<std::mutex> l(mutex_);
+  if (bits_per_key.empty()) {
+    cf_bits_per_key_.erase(column_family);
+  } else {
+    cf_bits_per_key_[column_family] = std::move(bits_per_key);
+  }
+}
+
+std::vector<double> LevelAdaptiveBloomFilterPolicy::AllocateBitsPerKey(
+    double avg_bits_per_key, const std::vector<uint64_t>& level_bytes,
+    const std::vector<uint64_t>& level_probes) {
+  double total_bytes = 0;
+  for (uint64_t bytes : level_bytes) {
+    total_bytes += static_cast<double>(bytes);
+  }
+  if (total_bytes == 0 || avg_bits_per_key <= 0) {
+    return {};
+  }
+  // A Bloom filter with b bits per key has a false positive rate of about
+  // exp(-b * ln(2)^2). With rate p_i = lambda * bytes_i / probes_i, level i
+  // gets b_i = (-ln(lambda) - ln(bytes_i / probes_i)) / ln(2)^2 bits per key,
+  // and lambda is found by bisection on its log so that the levels use up
+  // the budget.
+  const double ln2_squared = std::log(2.0) * std::log(2.0);
+  const double max_bits_per_key = 2 * avg_bits_per_key;
+  std::vector<double> log_ratio(level_bytes.size(), 0);
+  for (size_t i = 0; i < level_bytes.size(); i++) {
+    if (level_bytes[i] > 0) {
+      // Smoothed, levels are not probed before they are read
+      const uint64_t probes = i < level_probes.size() ? level_probes[i] : 0;
+      log_ratio[i] = std::log(static_cast<double>(level_bytes[i]) /
+                              static_cast<double>(probes + 1));
+    }
+  }
+  auto bits_for = [&](size_t i, double log_lambda) {
+    return std::clamp((-log_lambda - log_ratio[i]) / ln2_squared, 0.0,
+                      max_bits_per_key);
+  };
+  const double budget = avg_bits_per_key * total_bytes;
+  double lo = -200;
+  double hi = 200;
+  for (int iter = 0; iter < 100; iter++) {
+    const double mid = (lo + hi) / 2;
+    double used = 0;
+    for (size_t i = 0; i < level_bytes.size(); i++) {
+      used += static_cast<double>(level_bytes[i]) * bits_for(i, mid);
+    }
+    // The bits used decrease as lambda grows
+    if (used > budget) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  std::vector<double> bits_per_key(level_bytes.size(), 0);
+  double most_bits = 0;
+  for (size_t i = 0; i < level_bytes.size(); i++) {
+    if (level_bytes[i] > 0) {
+      bits_per_key[i] = bits_for(i, hi);
+      most_bits = std::max(most_bits, bits_per_key[i]);
+    }
+  }
+  // A level that is empty now is about to receive less data than any other
+  for (size_t i = 0; i < level_bytes.size(); i++) {
+    if (level_bytes[i] == 0) {
+      bits_per_key[i] = most_bits;
+    }
+  }
+  return bits_per_key;
+}
+
+std::shared_ptr<const FilterPolicy> NewLevelAdaptiveBloomFilterPolicy(
+    double bits_per_key) {
+  return std::make_shared<LevelAdaptiveBloomFilterPolicy>(bits_per_key);
+}
+
 FilterPolicy* NewRibbonFilterPolicy(double bloom_equivalent_bits_per_key,
                                     int bloom_before_level) {
   return new RibbonFilterPolicy(bloom_equivalent_bits_per_key,
                                 bloom_before_level);
 }
 
+namespace {
+// Feeds the wrapped builder, for each key, the range entries of the key
+// prefixes that differ from those of the previous key.
+class RangeFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  RangeFilterBitsBuilder(FilterBitsBuilder* base,
+                         const std::vector<size_t>& prefix_lengths)
+      : base_(base),
+        prefix_lengths_(prefix_lengths),
+        prev_prefixes_(prefix_lengths.size()) {}
+
+  void AddKey(const Slice& key) override {
+    if (!IsNewKey(key)) {
+      return;
+    }
+    base_->AddKey(key);
+    AddRangeEntries(key);
+  }
+
+  void AddKeyAndAlt(const Slice& key, const Slice& alt) override {
+    if (!IsNewKey(key)) {
+      return;
+    }
+    base_->AddKeyAndAlt(key, alt);
+    AddRangeEntries(key);
+  }
+
+  size_t EstimateEntriesAdded() override {
+    return base_->EstimateEntriesAdded();
+  }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    return base_->Finish(buf);
+  }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf, Status* status) override {
+    return base_->Finish(buf, status);
+  }
+
+  Status MaybePostVerify(const Slice& filter_content) override {
+    return base_->MaybePostVerify(filter_content);
+  }
+
+  size_t ApproximateNumEntries(size_t bytes) override {
+    // Assuming one range entry per key and prefix length
+    return base_->ApproximateNumEntries(bytes) / (1 + prefix_lengths_.size());
+  }
+
+ private:
+  // The range entries added between keys defeat the de-duplication of
+  // successive keys by the wrapped builder
+  bool IsNewKey(const Slice& key) {
+    if (has_prev_key_ && key == prev_key_) {
+      return false;
+    }
+    has_prev_key_ = true;
+    prev_key_.assign(key.data(), key.size());
+    return true;
+  }
+
+  void AddRangeEntries(const Slice& key) {
+    for (size_t i = 0; i < prefix_lengths_.size(); i++) {
+      const size_t len = prefix_lengths_[i];
+      if (key.size() < len) {
+        continue;
+      }
+      const Slice prefix(key.data(), len);
+      std::string& prev_prefix = prev_prefixes_[i];
+      if (prefix == prev_prefix) {
+        continue;
+      }
+      prev_prefix.assign(prefix.data(), prefix.size());
+      RangeFilterPolicy::GetRangeEntry(key, len, &entry_);
+      base_->AddKey(entry_);
+    }
+  }
+
+  const std::unique_ptr<FilterBitsBuilder> base_;
+  const std::vector<size_t> prefix_lengths_;
+  bool has_prev_key_ = false;
+  std::string prev_key_;
+  std::vector<std::string> prev_prefixes_;
+  std::string entry_;
+};
+}  // namespace
+
+RangeFilterPolicy::RangeFilterPolicy(std::shared_ptr<const FilterPolicy> base,
+                                     std::vector<size_t> prefix_lengths)
+    : base_(std::move(base)), prefix_lengths_(std::move(prefix_lengths)) {
+  assert(base_ != nullptr);
+  std::sort(prefix_lengths_.begin(), prefix_lengths_.end(),
+            std::greater<size_t>());
+  prefix_lengths_.erase(
+      std::unique(prefix_lengths_.begin(), prefix_lengths_.end()),
+      prefix_lengths_.end());
+  if (!prefix_lengths_.empty() && prefix_lengths_.back() == 0) {
+    prefix_lengths_.pop_back();
+  }
+  compatibility_name_ = base_->CompatibilityName();
+  compatibility_name_ += ":range";
+  for (size_t len : prefix_lengths_) {
+    compatibility_name_ += ":" + std::to_string(len);
+  }
+}
+
+FilterBitsBuilder* RangeFilterPolicy::GetBuilderWithContext(
+    const FilterBuildingContext& context) const {
+  FilterBitsBuilder* base = base_->GetBuilderWithContext(context);
+  if (base == nullptr || prefix_lengths_.empty()) {
+    return base;
+  }
+  return new RangeFilterBitsBuilder(base, prefix_lengths_);
+}
+
+size_t RangeFilterPolicy::RangePrefixLength(const Slice& lower,
+                                            const Slice& upper) const {
+  for (size_t len : prefix_lengths_) {
+    if (lower.size() < len || upper.size() < len) {
+      continue;
+    }
+    const Slice prefix(lower.data(), len);
+    if (memcmp(prefix.data(), upper.data(), len) == 0 ||
+        (upper.size() == len &&
+         BytewiseComparator()->IsSameLengthImmediateSuccessor(prefix,
+                                                              upper))) {
+      return len;
+    }
+  }
+  return 0;
+}
+
+void RangeFilterPolicy::GetRangeEntry(const Slice& key, size_t len,
+                                      std::string* entry) {
+  assert(key.size() >= len);
+  entry->assign(key.data(), len);
+  // Tags the entry, so that it only matches a whole key by a false positive
+  PutVarint64(entry, len);
+  entry->push_back('\xff');
+}
+
+std::shared_ptr<const FilterPolicy> NewRangeFilterPolicy(
+    std::shared_ptr<const FilterPolicy> base,
+    std::vector<size_t> prefix_lengths) {
+  return std::make_shared<RangeFilterPolicy>(std::move(base),
+                                             std::move(prefix_lengths));
+}
+
 FilterBuildingContext::FilterBuildingContext(
     const BlockBasedTableOptions& _table_options)
     : table_options(_table_options) {}
@@ -1991,6 +2287,16 @@ static int RegisterBuiltinFilterPolicies(ObjectLibrary& library,
         guard->reset(NewRibbonFilterPolicy(bits_per_key, bloom_before_level));
         return guard->get();
       });
+  library.AddFactory<const FilterPolicy>(
+      FilterPatternEntryWithBits(LevelAdaptiveBloomFilterPolicy::kClassName())
+          .AnotherName(LevelAdaptiveBloomFilterPolicy::kNickName()),
+      [](const std::string& uri, std::unique_ptr<const FilterPolicy>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(
+            NewBuiltinFilterPolicyWithBits<LevelAdaptiveBloomFilterPolicy>(
+                uri));
+        return guard->get();
+      });
   library.AddFactory<const FilterPolicy>(
       FilterPatternEntryWithBits(test::LegacyBloomFilterPolicy::kClassName()),
       [](const std::string& uri, std::unique_ptr<const FilterPolicy>* guard,
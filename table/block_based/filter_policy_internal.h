@@ -9,8 +9,11 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "rocksdb/filter_policy.h"
@@ -107,6 +110,15 @@ class FilterBitsReader {
       may_match[i] = MayMatch(*keys[i]);
     }
   }
+
+  // Same as above given the GetSliceHash64() of the entries, so that callers
+  // checking the same entries against many filters hash them only once.
+  // Returns false, without checking any entry, if the filter is not based
+  // on that hash.
+  virtual bool HashesMayMatch(int /*num_keys*/, const uint64_t* /*hashes*/,
+                              bool* /*may_match*/) {
+    return false;
+  }
 };
 
 // Exposes any extra information needed for testing built-in
@@ -308,6 +320,94 @@ class RibbonFilterPolicy : public BloomLikeFilterPolicy {
   std::atomic<int> bloom_before_level_;
 };
 
+// For NewLevelAdaptiveBloomFilterPolicy
+//
+// A Bloom filter policy whose bits per key depend on the level of the table,
+// allocated per column family by UpdateLevels() from the shape of its LSM.
+class LevelAdaptiveBloomFilterPolicy : public BloomLikeFilterPolicy {
+ public:
+  explicit LevelAdaptiveBloomFilterPolicy(double bits_per_key);
+
+  FilterBitsBuilder* GetBuilderWithContext(
+      const FilterBuildingContext&) const override;
+
+  static const char* kClassName();
+  const char* Name() const override { return kClassName(); }
+  static const char* kNickName();
+  const char* NickName() const override { return kNickName(); }
+
+  // Re-allocates the bits per key of the levels of `column_family`, given the
+  // bytes of each level and the (sampled) number of table files probed at
+  // each level by point lookups. Const like the other uses of a policy, the
+  // allocation being derived state.
+  void UpdateLevels(const std::string& column_family,
+                    const std::vector<uint64_t>& level_bytes,
+                    const std::vector<uint64_t>& level_probes) const;
+
+  // The bits per key the filters built for `level` of `column_family` get,
+  // the configured average if not allocated.
+  double GetBitsPerKey(const std::string& column_family, int level) const;
+
+  // Returns the bits per key of each level minimizing the expected number of
+  // filter false positives, sum(level_probes[i] * fp_rate[i]), given that
+  // sum(level_bytes[i] * bits[i]) = avg_bits_per_key * sum(level_bytes[i]).
+  // The false positive rate of a level comes out proportional to its bytes
+  // divided by its probes. Each level gets at most twice the average; empty
+  // levels get the most bits of any level. Empty if all levels are empty.
+  static std::vector<double> AllocateBitsPerKey(
+      double avg_bits_per_key, const std::vector<uint64_t>& level_bytes,
+      const std::vector<uint64_t>& level_probes);
+
+ private:
+  double avg_bits_per_key_;
+  mutable std::mutex mutex_;
+  // Bits per key of each level, by column family name
+  mutable std::unordered_map<std::string, std::vector<double>>
+      cf_bits_per_key_;
+  // The policies building the filters, by millibits per key. Never removed,
+  // builders refer to their policy.
+  mutable std::map<int, std::unique_ptr<BloomFilterPolicy>> level_policies_;
+};
+
+// For NewRangeFilterPolicy
+//
+// Adds to the filters of the wrapped policy an entry for each of the
+// configured prefixes of every key, to answer whether any key of the table
+// might be in a range of keys sharing one of these prefixes.
+class RangeFilterPolicy : public FilterPolicy {
+ public:
+  RangeFilterPolicy(std::shared_ptr<const FilterPolicy> base,
+                    std::vector<size_t> prefix_lengths);
+
+  static const char* kClassName() { return "rocksdb.RangeFilter"; }
+  const char* Name() const override { return kClassName(); }
+  // The wrapped CompatibilityName() along with the prefix lengths
+  const char* CompatibilityName() const override {
+    return compatibility_name_.c_str();
+  }
+
+  FilterBitsBuilder* GetBuilderWithContext(
+      const FilterBuildingContext& context) const override;
+  FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
+    return base_->GetFilterBitsReader(contents);
+  }
+
+  // Longest of the prefix lengths such that, in bytewise order, all keys in
+  // [lower, upper) share their prefix of that length with `lower`. Returns 0
+  // if there is none.
+  size_t RangePrefixLength(const Slice& lower, const Slice& upper) const;
+
+  // Sets `entry` to the filter entry standing for the keys starting with the
+  // first `len` bytes of `key`.
+  static void GetRangeEntry(const Slice& key, size_t len, std::string* entry);
+
+ private:
+  const std::shared_ptr<const FilterPolicy> base_;
+  // Longest first, without duplicates or 0
+  std::vector<size_t> prefix_lengths_;
+  std::string compatibility_name_;
+};
+
 // For testing only, but always constructable with internal names
 namespace test {
 
@@ -14,6 +14,7 @@
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "util/coding.h"
+#include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -183,10 +184,17 @@ void FullFilterBlockReader::MayMatch(MultiGetRange* range,
   std::array<Slice*, MultiGetContext::MAX_BATCH_SIZE> keys;
   std::array<bool, MultiGetContext::MAX_BATCH_SIZE> may_match = {{true}};
   autovector<Slice, MultiGetContext::MAX_BATCH_SIZE> prefixes;
+  std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
   int num_keys = 0;
   MultiGetRange filter_range(*range, range->begin(), range->end());
   for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
     if (!prefix_extractor) {
+      // The whole key hashes are reused by the filters of the other files
+      if (!iter->has_filter_hash) {
+        iter->filter_hash = GetSliceHash64(iter->ukey_without_ts);
+        iter->has_filter_hash = true;
+      }
+      hashes[num_keys] = iter->filter_hash;
       keys[num_keys++] = &iter->ukey_without_ts;
     } else if (prefix_extractor->InDomain(iter->ukey_without_ts)) {
       prefixes.emplace_back(prefix_extractor->Transform(iter->ukey_without_ts));
@@ -196,7 +204,11 @@ void FullFilterBlockReader::MayMatch(MultiGetRange* range,
     }
   }
 
-  filter_bits_reader->MayMatch(num_keys, keys.data(), may_match.data());
+  if (prefix_extractor ||
+      !filter_bits_reader->HashesMayMatch(num_keys, hashes.data(),
+                                          may_match.data())) {
+    filter_bits_reader->MayMatch(num_keys, keys.data(), may_match.data());
+  }
 
   int i = 0;
   for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
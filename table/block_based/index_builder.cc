@@ -37,7 +37,7 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           comparator, table_opt.index_block_restart_interval,
           table_opt.format_version, use_value_delta_encoding,
           table_opt.index_shortening, /* include_first_key */ false, ts_sz,
-          persist_user_defined_timestamps);
+          persist_user_defined_timestamps, table_opt.compact_index_blocks);
       break;
     }
     case BlockBasedTableOptions::kHashSearch: {
@@ -62,7 +62,14 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           comparator, table_opt.index_block_restart_interval,
           table_opt.format_version, use_value_delta_encoding,
           table_opt.index_shortening, /* include_first_key */ true, ts_sz,
-          persist_user_defined_timestamps);
+          persist_user_defined_timestamps, table_opt.compact_index_blocks);
+      break;
+    }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      result = new LearnedIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding,
+          table_opt.index_shortening, ts_sz, persist_user_defined_timestamps);
       break;
     }
     default: {
@@ -161,7 +168,7 @@ void PartitionedIndexBuilder::MakeNewSubIndexBuilder() {
       comparator_, table_opt_.index_block_restart_interval,
       table_opt_.format_version, use_value_delta_encoding_,
       table_opt_.index_shortening, /* include_first_key */ false, ts_sz_,
-      persist_user_defined_timestamps_);
+      persist_user_defined_timestamps_, table_opt_.compact_index_blocks);
 
   // Set sub_index_builder_->seperator_is_key_plus_seq_ to true if
   // seperator_is_key_plus_seq_ is true (internal-key mode) (set to false by
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
 #include <list>
 #include <string>
@@ -18,6 +19,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/block_learned_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -159,20 +161,23 @@ class ShortenedIndexBuilder : public IndexBuilder {
       const bool use_value_delta_encoding,
       BlockBasedTableOptions::IndexShorteningMode shortening_mode,
       bool include_first_key, size_t ts_sz,
-      const bool persist_user_defined_timestamps)
+      const bool persist_user_defined_timestamps,
+      const bool compact_index_blocks = false)
       : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
         index_block_builder_(
             index_block_restart_interval, true /*use_delta_encoding*/,
             use_value_delta_encoding,
             BlockBasedTableOptions::kDataBlockBinarySearch /* index_type */,
             0.75 /* data_block_hash_table_util_ratio */, ts_sz,
-            persist_user_defined_timestamps, false /* is_user_key */),
+            persist_user_defined_timestamps, false /* is_user_key */,
+            use_value_delta_encoding && compact_index_blocks),
         index_block_builder_without_seq_(
             index_block_restart_interval, true /*use_delta_encoding*/,
             use_value_delta_encoding,
             BlockBasedTableOptions::kDataBlockBinarySearch /* index_type */,
             0.75 /* data_block_hash_table_util_ratio */, ts_sz,
-            persist_user_defined_timestamps, true /* is_user_key */),
+            persist_user_defined_timestamps, true /* is_user_key */,
+            use_value_delta_encoding && compact_index_blocks),
         use_value_delta_encoding_(use_value_delta_encoding),
         include_first_key_(include_first_key),
         shortening_mode_(shortening_mode) {
@@ -436,6 +441,76 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder contains the binary-searchable index of
+// ShortenedIndexBuilder, plus a meta block with a BlockLearnedIndex model of
+// the keys at the restart points of the index block. No model is written for
+// comparators other than the bytewise one, as the model needs the numbers of
+// the keys to follow their order, nor for keys with timestamps.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  // How far the model can predict a restart point from its actual index
+  static constexpr uint32_t kMaxError = 8;
+
+  LearnedIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+      size_t ts_sz, const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               ts_sz, persist_user_defined_timestamps),
+        index_block_restart_interval_(
+            static_cast<uint64_t>(std::max(index_block_restart_interval, 1))),
+        model_builder_(kMaxError),
+        build_model_(ts_sz == 0 &&
+                     comparator->user_comparator() == BytewiseComparator()) {}
+
+  Slice AddIndexEntry(const Slice& last_key_in_current_block,
+                      const Slice* first_key_in_next_block,
+                      const BlockHandle& block_handle,
+                      std::string* separator_scratch) override {
+    Slice separator = primary_index_builder_.AddIndexEntry(
+        last_key_in_current_block, first_key_in_next_block, block_handle,
+        separator_scratch);
+    if (build_model_ && num_entries_ % index_block_restart_interval_ == 0) {
+      model_builder_.Add(ExtractUserKey(separator));
+    }
+    ++num_entries_;
+    return separator;
+  }
+
+  Status Finish(IndexBlocks* index_blocks,
+                const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    if (!model_builder_.empty()) {
+      model_block_ = model_builder_.Finish();
+      index_blocks->meta_blocks.insert(
+          {kLearnedIndexModelBlock.c_str(), model_block_});
+    }
+    return s;
+  }
+
+  size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  const uint64_t index_block_restart_interval_;
+  BlockLearnedIndex::Builder model_builder_;
+  const bool build_model_;
+  uint64_t num_entries_ = 0;
+  std::string model_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
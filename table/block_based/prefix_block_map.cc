@@ -0,0 +1,135 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/prefix_block_map.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "db/dbformat.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+void PrefixBlockMap::Builder::OnKeyAdded(const Slice& internal_key) {
+  if (abandoned_) {
+    return;
+  }
+  const Slice user_key = ExtractUserKeyAndStripTimestamp(internal_key, ts_sz_);
+  if (!prefix_extractor_->InDomain(user_key)) {
+    return;
+  }
+  const Slice prefix = prefix_extractor_->Transform(user_key);
+  if (has_current_) {
+    const int cmp = prefix.compare(current_.prefix);
+    if (cmp == 0) {
+      current_.last_pending = true;
+      return;
+    }
+    if (cmp < 0) {
+      // Binary search of the map would miss prefixes
+      abandoned_ = true;
+      return;
+    }
+    done_.push_back(std::move(current_));
+  }
+  current_ = PendingEntry();
+  current_.prefix.assign(prefix.data(), prefix.size());
+  has_current_ = true;
+}
+
+void PrefixBlockMap::Builder::OnDataBlockWritten(const BlockHandle& handle) {
+  if (abandoned_) {
+    return;
+  }
+  for (auto& entry : done_) {
+    if (entry.first_pending) {
+      entry.first = handle;
+    }
+    if (entry.last_pending) {
+      entry.last = handle;
+    }
+    AddEntry(entry);
+  }
+  done_.clear();
+  if (has_current_ && current_.last_pending) {
+    if (current_.first_pending) {
+      current_.first = handle;
+      current_.first_pending = false;
+    }
+    current_.last = handle;
+    current_.last_pending = false;
+  }
+}
+
+// The meta block is
+//   num_prefixes (varint32), and for each prefix in bytewise order
+//   prefix (length prefixed), first block handle, last block handle
+void PrefixBlockMap::Builder::AddEntry(const PendingEntry& entry) {
+  PutLengthPrefixedSlice(&entries_, entry.prefix);
+  entry.first.EncodeTo(&entries_);
+  entry.last.EncodeTo(&entries_);
+  num_entries_++;
+}
+
+bool PrefixBlockMap::Builder::Finish(std::string* contents) {
+  if (abandoned_ || !has_current_) {
+    return false;
+  }
+  assert(done_.empty() && !current_.last_pending);
+  if (!done_.empty() || current_.last_pending) {
+    return false;
+  }
+  AddEntry(current_);
+  has_current_ = false;
+  contents->clear();
+  PutVarint32(contents, num_entries_);
+  contents->append(entries_);
+  return true;
+}
+
+Status PrefixBlockMap::Create(
+    const Slice& contents, std::unique_ptr<PrefixBlockMap>* prefix_block_map) {
+  std::unique_ptr<PrefixBlockMap> map(new PrefixBlockMap());
+  map->data_.assign(contents.data(), contents.size());
+  Slice input = map->data_;
+  uint32_t num_prefixes = 0;
+  if (!GetVarint32(&input, &num_prefixes) || num_prefixes > input.size()) {
+    return Status::Corruption("Bad prefix block map");
+  }
+  map->entries_.reserve(num_prefixes);
+  for (uint32_t i = 0; i < num_prefixes; i++) {
+    Entry entry;
+    if (!GetLengthPrefixedSlice(&input, &entry.prefix) ||
+        !entry.first.DecodeFrom(&input).ok() ||
+        !entry.last.DecodeFrom(&input).ok() ||
+        entry.last.offset() < entry.first.offset() ||
+        (i > 0 && entry.prefix.compare(map->entries_.back().prefix) <= 0)) {
+      return Status::Corruption("Bad prefix block map entry");
+    }
+    map->entries_.push_back(entry);
+  }
+  if (!input.empty()) {
+    return Status::Corruption("Bad prefix block map size");
+  }
+  *prefix_block_map = std::move(map);
+  return Status::OK();
+}
+
+bool PrefixBlockMap::Lookup(const Slice& prefix, BlockHandle* first,
+                            BlockHandle* last) const {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), prefix,
+      [](const Entry& e, const Slice& p) { return e.prefix.compare(p) < 0; });
+  if (it == entries_.end() || it->prefix != prefix) {
+    return false;
+  }
+  *first = it->first;
+  *last = it->last;
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
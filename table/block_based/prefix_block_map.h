@@ -0,0 +1,103 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/slice_transform.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The range of data blocks holding the keys of each prefix of a table file,
+// see BlockBasedTableOptions::prefix_block_map. A prefix that is not in the
+// map has no keys in the file, and the keys of a prefix in the map are all in
+// the data blocks from its first to its last one.
+class PrefixBlockMap {
+ public:
+  class Builder;
+
+  // Create the map by reading the meta block written by Builder.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<PrefixBlockMap>* prefix_block_map);
+
+  // Returns false if no key of the file has `prefix`. Otherwise sets *first
+  // and *last to the handles of the first and last data blocks with keys of
+  // `prefix`.
+  bool Lookup(const Slice& prefix, BlockHandle* first, BlockHandle* last) const;
+
+  size_t num_prefixes() const { return entries_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(PrefixBlockMap) + data_.capacity() +
+           entries_.capacity() * sizeof(Entry);
+  }
+
+ private:
+  struct Entry {
+    Slice prefix;
+    BlockHandle first;
+    BlockHandle last;
+  };
+
+  PrefixBlockMap() = default;
+
+  // The contents of the meta block, which `entries_` point into
+  std::string data_;
+  // Sorted bytewise by prefix
+  std::vector<Entry> entries_;
+};
+
+// Builds the map from the keys of the data blocks, in the order they are
+// written to the file. The prefixes must come in strictly increasing
+// bytewise order, as they do with the bytewise comparators; otherwise no map
+// is written. Keys out of the domain of the prefix extractor are not in the
+// map, and the map says nothing about them.
+class PrefixBlockMap::Builder {
+ public:
+  Builder(const SliceTransform* prefix_extractor, size_t ts_sz)
+      : prefix_extractor_(prefix_extractor), ts_sz_(ts_sz) {}
+
+  // Adds the internal key of the next entry of the data block being built.
+  void OnKeyAdded(const Slice& internal_key);
+
+  // Called once the data block with all the keys added since the last call is
+  // written to `handle`.
+  void OnDataBlockWritten(const BlockHandle& handle);
+
+  // Returns false if there is no map to write, otherwise sets *contents to
+  // the meta block. REQUIRES: all the data blocks were written.
+  bool Finish(std::string* contents);
+
+ private:
+  struct PendingEntry {
+    std::string prefix;
+    BlockHandle first;
+    BlockHandle last;
+    // The first or last block is the one being built
+    bool first_pending = true;
+    bool last_pending = true;
+  };
+
+  void AddEntry(const PendingEntry& entry);
+
+  const SliceTransform* const prefix_extractor_;
+  const size_t ts_sz_;
+  bool abandoned_ = false;
+  bool has_current_ = false;
+  // The prefix of the last key in the domain added
+  PendingEntry current_;
+  // The prefixes done with since the last block was written
+  std::vector<PendingEntry> done_;
+  uint32_t num_entries_ = 0;
+  std::string entries_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "table/block_based/reader_common.h"
 
+#include <algorithm>
+
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/table.h"
 #include "table/format.h"
@@ -29,15 +31,22 @@ Status VerifyBlockChecksum(const Footer& footer, const char* data,
   PERF_TIMER_GUARD(block_checksum_time);
 
   assert(footer.GetBlockTrailerSize() == 5);
-  ChecksumType type = footer.checksum_type();
-
   // After block_size bytes is compression type (1 byte), which is part of
   // the checksummed section.
-  size_t len = block_size + 1;
-  // And then the stored checksum value (4 bytes).
-  uint32_t stored = DecodeFixed32(data + len);
+  uint32_t computed =
+      ComputeBuiltinChecksum(footer.checksum_type(), data, block_size + 1);
+  return VerifyBlockChecksum(footer, data, block_size, file_name, offset,
+                             computed);
+}
 
-  uint32_t computed = ComputeBuiltinChecksum(type, data, len);
+Status VerifyBlockChecksum(const Footer& footer, const char* data,
+                           size_t block_size, const std::string& file_name,
+                           uint64_t offset, uint32_t computed) {
+  assert(footer.GetBlockTrailerSize() == 5);
+  ChecksumType type = footer.checksum_type();
+
+  // And then the stored checksum value (4 bytes).
+  uint32_t stored = DecodeFixed32(data + block_size + 1);
 
   // Unapply context to 'stored' rather than apply to 'computed, for people
   // who might look for reference crc value in error message
@@ -61,4 +70,32 @@ Status VerifyBlockChecksum(const Footer& footer, const char* data,
         std::to_string(offset) + " size " + std::to_string(block_size));
   }
 }
+
+void ComputeBlockChecksums(const Footer& footer, size_t num_blocks,
+                           const char* const* data, const size_t* block_sizes,
+                           uint32_t* checksums) {
+  PERF_TIMER_GUARD(block_checksum_time);
+
+  assert(footer.GetBlockTrailerSize() == 5);
+  ChecksumType type = footer.checksum_type();
+  if (type != kCRC32c) {
+    for (size_t i = 0; i < num_blocks; i++) {
+      checksums[i] = ComputeBuiltinChecksum(type, data[i], block_sizes[i] + 1);
+    }
+    return;
+  }
+  constexpr size_t kGroupSize = 16;
+  size_t lens[kGroupSize];
+  for (size_t i = 0; i < num_blocks; i += kGroupSize) {
+    const size_t n = std::min(kGroupSize, num_blocks - i);
+    for (size_t j = 0; j < n; j++) {
+      // Including the compression type
+      lens[j] = block_sizes[i + j] + 1;
+    }
+    crc32c::ValueBatch(n, data + i, lens, checksums + i);
+    for (size_t j = 0; j < n; j++) {
+      checksums[i + j] = crc32c::Mask(checksums[i + j]);
+    }
+  }
+}
 }  // namespace ROCKSDB_NAMESPACE
@@ -33,4 +33,17 @@ inline MemoryAllocator* GetMemoryAllocator(
 Status VerifyBlockChecksum(const Footer& footer, const char* data,
                            size_t block_size, const std::string& file_name,
                            uint64_t offset);
+
+// As above, with `computed` the checksum of the block from
+// ComputeBlockChecksums()
+Status VerifyBlockChecksum(const Footer& footer, const char* data,
+                           size_t block_size, const std::string& file_name,
+                           uint64_t offset, uint32_t computed);
+
+// Computes the checksums of `num_blocks` blocks with trailers as in format.h,
+// to be compared with their stored checksums by VerifyBlockChecksum(). Faster
+// than verifying the blocks one by one for small CRC32c blocks.
+void ComputeBlockChecksums(const Footer& footer, size_t num_blocks,
+                           const char* const* data, const size_t* block_sizes,
+                           uint32_t* checksums);
 }  // namespace ROCKSDB_NAMESPACE
@@ -15,6 +15,7 @@
 
 #include "logging/logging.h"
 #include "memory/memory_allocator_impl.h"
+#include "monitoring/operation_tracer.h"
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/compression_type.h"
 #include "rocksdb/env.h"
@@ -255,6 +256,7 @@ void BlockFetcher::ReadBlock(bool retry) {
   if (io_status_.ok()) {
     if (file_->use_direct_io()) {
       PERF_TIMER_GUARD(block_read_time);
+      OPERATION_SPAN_GUARD(BlockRead);
       PERF_CPU_TIMER_GUARD(
           block_read_cpu_time,
           ioptions_.env ? ioptions_.env->GetSystemClock().get() : nullptr);
@@ -265,6 +267,7 @@ void BlockFetcher::ReadBlock(bool retry) {
       used_buf_ = const_cast<char*>(slice_.data());
     } else if (use_fs_scratch_) {
       PERF_TIMER_GUARD(block_read_time);
+      OPERATION_SPAN_GUARD(BlockRead);
       PERF_CPU_TIMER_GUARD(
           block_read_cpu_time,
           ioptions_.env ? ioptions_.env->GetSystemClock().get() : nullptr);
@@ -282,6 +285,7 @@ void BlockFetcher::ReadBlock(bool retry) {
       PrepareBufferForBlockFromFile();
 
       PERF_TIMER_GUARD(block_read_time);
+      OPERATION_SPAN_GUARD(BlockRead);
       PERF_CPU_TIMER_GUARD(
           block_read_cpu_time,
           ioptions_.env ? ioptions_.env->GetSystemClock().get() : nullptr);
@@ -190,7 +190,7 @@ class CompactionMergingIterator : public InternalIterator {
         : comparator_(comparator) {}
 
     bool operator()(HeapItem* a, HeapItem* b) const {
-      int r = comparator_->Compare(a->key(), b->key());
+      int r = comparator_.Compare(a->key(), b->key());
       // For each file, we assume all range tombstone start keys come before
       // its file boundary sentinel key (file's meta.largest key).
       // In the case when meta.smallest = meta.largest and range tombstone start
@@ -202,7 +202,7 @@ class CompactionMergingIterator : public InternalIterator {
     }
 
    private:
-    const InternalKeyComparator* comparator_;
+    const MergingIteratorKeyComparator comparator_;
   };
 
   using CompactionMinHeap = BinaryHeap<HeapItem*, CompactionHeapItemComparator>;
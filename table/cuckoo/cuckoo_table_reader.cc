@@ -52,6 +52,7 @@ CuckooTableReader::CuckooTableReader(
       cuckoo_block_bytes_minus_one_(0),
       table_size_(0),
       ucomp_(comparator),
+      bytewise_equal_(!comparator->CanKeysWithDifferentByteContentsBeEqual()),
       get_slice_hash_(get_slice_hash) {
   if (!ioptions.allow_mmap_reads) {
     status_ = Status::InvalidArgument("File is not mmaped");
@@ -162,13 +163,12 @@ Status CuckooTableReader::Get(const ReadOptions& /*readOptions*/,
     const char* bucket = &file_data_.data()[offset];
     for (uint32_t block_idx = 0; block_idx < cuckoo_block_size_;
          ++block_idx, bucket += bucket_length_) {
-      if (ucomp_->Equal(Slice(unused_key_.data(), user_key.size()),
-                        Slice(bucket, user_key.size()))) {
+      if (KeyEquals(bucket, Slice(unused_key_.data(), user_key.size()))) {
         return Status::OK();
       }
       // Here, we compare only the user key part as we support only one entry
       // per user key and we don't support snapshot.
-      if (ucomp_->Equal(user_key, Slice(bucket, user_key.size()))) {
+      if (KeyEquals(bucket, user_key)) {
         Slice value(bucket + key_length_, value_length_);
         if (is_last_level_) {
           // Sequence number is not stored at the last level, so we will use
@@ -212,6 +212,31 @@ void CuckooTableReader::Prepare(const Slice& key) {
   }
 }
 
+void CuckooTableReader::PrefetchBuckets(const Slice& user_key) const {
+  for (uint32_t hash_cnt = 0; hash_cnt < num_hash_func_; ++hash_cnt) {
+    uint64_t addr =
+        reinterpret_cast<uint64_t>(file_data_.data()) +
+        bucket_length_ * CuckooHash(user_key, hash_cnt, use_module_hash_,
+                                    table_size_, identity_as_first_hash_,
+                                    get_slice_hash_);
+    uint64_t end_addr = addr + cuckoo_block_bytes_minus_one_;
+    for (addr &= CACHE_LINE_MASK; addr <= end_addr; addr += CACHE_LINE_SIZE) {
+      PREFETCH(reinterpret_cast<const char*>(addr), 0, 3);
+    }
+  }
+}
+
+void CuckooTableReader::MultiGet(const ReadOptions& readOptions,
+                                 const MultiGetContext::Range* mget_range,
+                                 const SliceTransform* prefix_extractor,
+                                 bool skip_filters) {
+  for (auto iter = mget_range->begin(); iter != mget_range->end(); ++iter) {
+    PrefetchBuckets(ExtractUserKey(iter->ikey));
+  }
+  TableReader::MultiGet(readOptions, mget_range, prefix_extractor,
+                        skip_filters);
+}
+
 class CuckooTableIterator : public InternalIterator {
  public:
   explicit CuckooTableIterator(CuckooTableReader* reader);
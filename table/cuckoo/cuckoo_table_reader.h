@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -43,6 +44,13 @@ class CuckooTableReader : public TableReader {
              GetContext* get_context, const SliceTransform* prefix_extractor,
              bool skip_filters = false) override;
 
+  // Prefetches the buckets of all the keys before looking them up, so that
+  // the cache misses of the keys overlap.
+  void MultiGet(const ReadOptions& readOptions,
+                const MultiGetContext::Range* mget_range,
+                const SliceTransform* prefix_extractor,
+                bool skip_filters = false) override;
+
   // Returns a new iterator over table contents
   // compaction_readahead_size: its value will only be used if for_compaction =
   // true
@@ -76,6 +84,19 @@ class CuckooTableReader : public TableReader {
  private:
   friend class CuckooTableIterator;
   void LoadAllKeys(std::vector<std::pair<Slice, uint32_t>>* key_to_bucket_id);
+
+  // Whether the user key stored at `bucket` equals `user_key`
+  bool KeyEquals(const char* bucket, const Slice& user_key) const {
+    if (bytewise_equal_) {
+      // The keys are of fixed length, so this compiles to a few word or
+      // vector compares for the usual key lengths
+      return memcmp(bucket, user_key.data(), user_key.size()) == 0;
+    }
+    return ucomp_->Equal(user_key, Slice(bucket, user_key.size()));
+  }
+
+  // Prefetches the cuckoo blocks of all the hash functions of `user_key`
+  void PrefetchBuckets(const Slice& user_key) const;
   std::unique_ptr<RandomAccessFileReader> file_;
   Slice file_data_;
   bool is_last_level_;
@@ -93,6 +114,9 @@ class CuckooTableReader : public TableReader {
   uint32_t cuckoo_block_bytes_minus_one_;
   uint64_t table_size_;
   const Comparator* ucomp_;
+  // Whether keys are equal only if their bytes are, so that they can be
+  // compared with memcmp instead of through the comparator
+  bool bytewise_equal_;
   uint64_t (*get_slice_hash_)(const Slice& s, uint32_t index,
                               uint64_t max_num_buckets);
 };
@@ -177,6 +177,14 @@ class InternalIteratorBase : public Cleanable {
   // REQUIRES: Same as for value().
   virtual bool IsValuePinned() const { return false; }
 
+  // Makes `pinned` reference `value`, a slice of the current value(), without
+  // copying it. Returns false if the memory of `value` cannot be referenced
+  // beyond the current position of the iterator.
+  // REQUIRES: Same as for value().
+  virtual bool PinValue(const Slice& /*value*/, PinnableSlice* /*pinned*/) {
+    return false;
+  }
+
   virtual Status GetProperty(std::string /*prop_name*/, std::string* /*prop*/) {
     return Status::NotSupported("");
   }
@@ -175,6 +175,10 @@ class IteratorWrapperBase {
     assert(Valid());
     return iter_->IsValuePinned();
   }
+  bool PinValue(const Slice& value, PinnableSlice* pinned) {
+    assert(Valid());
+    return iter_->PinValue(value, pinned);
+  }
 
   bool IsValuePrepared() const { return result_.value_prepared; }
 
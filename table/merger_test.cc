@@ -173,6 +173,49 @@ TEST_F(MergerTest, SeekToLastTest) {
   }
 }
 
+TEST_F(MergerTest, KeyComparatorMatchesInternalKeyComparator) {
+  // Short keys and zero bytes, around the 8-byte prefix
+  const std::vector<std::string> user_keys = {
+      "",
+      std::string(1, '\0'),
+      std::string(2, '\0'),
+      "a",
+      std::string("a\0", 2),
+      std::string("a\0b", 3),
+      "ab",
+      "abcdefg",
+      "abcdefgh",
+      std::string("abcdefgh\0", 9),
+      "abcdefghi",
+      "abcdefgi",
+      "b",
+      "\xff",
+      "\xff\xff\xff\xff\xff\xff\xff\xff\xff"};
+  std::vector<std::string> keys;
+  for (const auto& user_key : user_keys) {
+    for (SequenceNumber seq : {1, 2}) {
+      keys.push_back(
+          InternalKey(user_key, seq, kTypeValue).Encode().ToString());
+    }
+  }
+  for (int i = 0; i < 100; ++i) {
+    keys.push_back(InternalKey(rnd_.RandomString(rnd_.Uniform(12)), 0,
+                               kTypeValue)
+                       .Encode()
+                       .ToString());
+  }
+
+  MergingIteratorKeyComparator key_comparator(&icomp_);
+  for (const auto& a : keys) {
+    for (const auto& b : keys) {
+      const int expected = icomp_.Compare(a, b);
+      const int actual = key_comparator.Compare(a, b);
+      ASSERT_EQ(expected < 0, actual < 0);
+      ASSERT_EQ(expected > 0, actual > 0);
+    }
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -482,6 +482,11 @@ class MergingIterator : public InternalIterator {
            current_->IsValuePinned();
   }
 
+  bool PinValue(const Slice& value, PinnableSlice* pinned) override {
+    assert(Valid());
+    return current_->PinValue(value, pinned);
+  }
+
   void Prepare(const std::vector<ScanOptions>* scan_opts) override {
     for (auto& child : children_) {
       child.iter.Prepare(scan_opts);
@@ -521,12 +526,12 @@ class MergingIterator : public InternalIterator {
   class MinHeapItemComparator {
    public:
     explicit MinHeapItemComparator(const InternalKeyComparator* comparator)
-        : comparator_(comparator) {}
+        : key_comparator_(comparator), comparator_(comparator) {}
 
     bool operator()(HeapItem* a, HeapItem* b) const {
       if (LIKELY(a->type == HeapItem::Type::ITERATOR)) {
         if (LIKELY(b->type == HeapItem::Type::ITERATOR)) {
-          return comparator_->Compare(a->iter.key(), b->iter.key()) > 0;
+          return key_comparator_.Compare(a->iter.key(), b->iter.key()) > 0;
         } else {
           return comparator_->Compare(a->iter.key(), b->tombstone_pik) > 0;
         }
@@ -540,18 +545,19 @@ class MergingIterator : public InternalIterator {
     }
 
    private:
+    const MergingIteratorKeyComparator key_comparator_;
     const InternalKeyComparator* comparator_;
   };
 
   class MaxHeapItemComparator {
    public:
     explicit MaxHeapItemComparator(const InternalKeyComparator* comparator)
-        : comparator_(comparator) {}
+        : key_comparator_(comparator), comparator_(comparator) {}
 
     bool operator()(HeapItem* a, HeapItem* b) const {
       if (LIKELY(a->type == HeapItem::Type::ITERATOR)) {
         if (LIKELY(b->type == HeapItem::Type::ITERATOR)) {
-          return comparator_->Compare(a->iter.key(), b->iter.key()) < 0;
+          return key_comparator_.Compare(a->iter.key(), b->iter.key()) < 0;
         } else {
           return comparator_->Compare(a->iter.key(), b->tombstone_pik) < 0;
         }
@@ -565,6 +571,7 @@ class MergingIterator : public InternalIterator {
     }
 
    private:
+    const MergingIteratorKeyComparator key_comparator_;
     const InternalKeyComparator* comparator_;
   };
 
@@ -643,6 +650,13 @@ class MergingIterator : public InternalIterator {
 
   bool SkipPrevDeleted();
 
+  // Moves `current` past its current key and the following keys that are
+  // covered by the range tombstone from the same level, i.e., until a key out
+  // of the range tombstone or newer than it.
+  // REQUIRES: `current` is at a key covered by a range tombstone from the same
+  // level.
+  void SkipCoveredKeysAtLevel(HeapItem* current, bool forward);
+
   // Invariant: at the end of each InternalIterator API,
   // current_ points to minHeap_.top().iter (maxHeap_ if backward scanning)
   // or nullptr if no child iterator is valid.
@@ -1050,8 +1064,11 @@ bool MergingIterator::SkipNextDeleted() {
       assert(comparator_->Compare(pik, range_tombstone_iters_[i]->end_key()) <
              0);
       if (pik.sequence < range_tombstone_iters_[current->level]->seq()) {
-        // covered by range tombstone
-        current->iter.Next();
+        // covered by range tombstone. Newer keys of this level may lie within
+        // the range tombstone, so it is not skipped with a Seek() like above.
+        // Still, the following covered keys of this level are skipped here,
+        // without going through minHeap_ for each of them.
+        SkipCoveredKeysAtLevel(current, true /* forward */);
         // Invariant (children_)
         if (current->iter.Valid()) {
           minHeap_.replace_top(current);
@@ -1077,6 +1094,30 @@ bool MergingIterator::SkipNextDeleted() {
   return false /* current key not deleted */;
 }
 
+void MergingIterator::SkipCoveredKeysAtLevel(HeapItem* current,
+                                             bool forward) {
+  TruncatedRangeDelIterator* tombstone =
+      range_tombstone_iters_[current->level].get();
+  ParsedInternalKey pik;
+  while (true) {
+    if (forward) {
+      current->iter.Next();
+    } else {
+      current->iter.Prev();
+    }
+    if (!current->iter.Valid() || current->iter.IsDeleteRangeSentinelKey() ||
+        !ParseInternalKey(current->iter.key(), &pik, false).ok()) {
+      return;
+    }
+    const bool in_range =
+        forward ? comparator_->Compare(pik, tombstone->end_key()) < 0
+                : comparator_->Compare(tombstone->start_key(), pik) <= 0;
+    if (!in_range || pik.sequence >= tombstone->seq()) {
+      return;
+    }
+  }
+}
+
 void MergingIterator::SeekForPrevImpl(const Slice& target,
                                       size_t starting_level,
                                       bool range_tombstone_reseek) {
@@ -1269,7 +1310,7 @@ bool MergingIterator::SkipPrevDeleted() {
       assert(comparator_->Compare(pik, range_tombstone_iters_[i]->end_key()) <
              0);
       if (pik.sequence < range_tombstone_iters_[current->level]->seq()) {
-        current->iter.Prev();
+        SkipCoveredKeysAtLevel(current, false /* forward */);
         if (current->iter.Valid()) {
           maxHeap_->replace_top(current);
         } else {
@@ -12,13 +12,57 @@
 #include "db/range_del_aggregator.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/types.h"
+#include "port/likely.h"
 #include "table/iterator_wrapper.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
 class Arena;
 class ArenaWrappedDBIter;
-class InternalKeyComparator;
+
+// Orders internal keys like `comparator`, for the heaps of the merging
+// iterators. With BytewiseComparator(), the first 8 bytes of the user keys
+// are compared as one integer beforehand, and only the keys that share them
+// go through the comparator.
+class MergingIteratorKeyComparator {
+ public:
+  explicit MergingIteratorKeyComparator(const InternalKeyComparator* comparator)
+      : comparator_(comparator),
+        bytewise_(comparator->user_comparator() == BytewiseComparator()) {}
+
+  int Compare(const Slice& a, const Slice& b) const {
+    if (bytewise_) {
+      const uint64_t a_prefix = UserKeyPrefix(a);
+      const uint64_t b_prefix = UserKeyPrefix(b);
+      if (a_prefix != b_prefix) {
+        return a_prefix < b_prefix ? -1 : 1;
+      }
+    }
+    return comparator_->Compare(a, b);
+  }
+
+  const InternalKeyComparator* comparator() const { return comparator_; }
+
+ private:
+  // The bytes of a shorter user key are padded with zeros. Such a key can
+  // only tie with the ones that it is a prefix of, so different prefixes
+  // are in the order of the user keys.
+  static uint64_t UserKeyPrefix(const Slice& internal_key) {
+    assert(internal_key.size() >= kNumInternalBytes);
+    const size_t user_key_size = internal_key.size() - kNumInternalBytes;
+    uint64_t prefix = 0;
+    if (LIKELY(user_key_size >= sizeof(prefix))) {
+      memcpy(&prefix, internal_key.data(), sizeof(prefix));
+    } else {
+      memcpy(&prefix, internal_key.data(), user_key_size);
+    }
+    return port::kLittleEndian ? EndianSwapValue(prefix) : prefix;
+  }
+
+  const InternalKeyComparator* comparator_;
+  const bool bytewise_;
+};
 
 template <class TValue>
 class InternalIteratorBase;
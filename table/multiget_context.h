@@ -41,6 +41,13 @@ struct KeyContext {
   PinnableWideColumns* columns;
   std::string* timestamp;
   GetContext* get_context;
+  // GetSliceHash64() of ukey_without_ts for the table filters, computed by
+  // the first one that needs it
+  uint64_t filter_hash;
+  bool has_filter_hash;
+  // When set, gets the sequence number of the latest record of the key found
+  // in the SST files, and blob values are not read
+  SequenceNumber* seq;
 
   KeyContext(ColumnFamilyHandle* col_family, const Slice& user_key,
              PinnableSlice* val, PinnableWideColumns* cols, std::string* ts,
@@ -56,7 +63,10 @@ struct KeyContext {
         value(val),
         columns(cols),
         timestamp(ts),
-        get_context(nullptr) {}
+        get_context(nullptr),
+        filter_hash(0),
+        has_filter_hash(false),
+        seq(nullptr) {}
 };
 
 // The MultiGetContext class is a container for the sorted list of keys that
@@ -178,6 +178,29 @@ static int RegisterBuiltinMemTableRepFactory(ObjectLibrary& library,
         }
         return guard->get();
       });
+  library.AddFactory<MemTableRepFactory>(
+      AsPattern(PartitionedSkipListFactory::kClassName(),
+                PartitionedSkipListFactory::kNickName()),
+      [](const std::string& uri, std::unique_ptr<MemTableRepFactory>* guard,
+         std::string* /*errmsg*/) {
+        auto colon = uri.find(':');
+        if (colon != std::string::npos) {
+          size_t num_partitions = ParseSizeT(uri.substr(colon + 1));
+          guard->reset(new PartitionedSkipListFactory(num_partitions));
+        } else {
+          guard->reset(new PartitionedSkipListFactory());
+        }
+        return guard->get();
+      });
+  library.AddFactory<MemTableRepFactory>(
+      ObjectLibrary::PatternEntry(BTreeRepFactory::kClassName(), true)
+          .AnotherName(BTreeRepFactory::kNickName()),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<MemTableRepFactory>* guard,
+         std::string* /*errmsg*/) {
+        guard->reset(new BTreeRepFactory());
+        return guard->get();
+      });
   library.AddFactory<MemTableRepFactory>(
       AsPattern("HashLinkListRepFactory", "hash_linkedlist"),
       [](const std::string& uri, std::unique_ptr<MemTableRepFactory>* guard,
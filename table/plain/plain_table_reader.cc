@@ -20,6 +20,7 @@
 #include "rocksdb/statistics.h"
 #include "table/block_based/block.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_fetcher.h"
 #include "table/format.h"
 #include "table/get_context.h"
 #include "table/internal_iterator.h"
@@ -291,6 +292,29 @@ Status PlainTableReader::MmapDataIfNeeded() {
   return Status::OK();
 }
 
+Status PlainTableReader::ReadMetaBlockContents(const Footer& footer,
+                                               const BlockHandle& handle,
+                                               BlockType block_type,
+                                               BlockContents* contents) {
+  if (file_info_.is_mmap_mode) {
+    if (handle.offset() + handle.size() > file_info_.file_data.size()) {
+      return Status::Corruption("Meta block is out of the file");
+    }
+    *contents = BlockContents(
+        Slice(file_info_.file_data.data() + handle.offset(),
+              static_cast<size_t>(handle.size())));
+    return Status::OK();
+  }
+  // TODO: plumb Env::IOActivity, Env::IOPriority
+  const ReadOptions read_options;
+  return BlockFetcher(file_info_.file.get(), nullptr /* prefetch_buffer */,
+                      footer, read_options, handle, contents, ioptions_,
+                      false /* decompress */, false /* maybe_compressed */,
+                      block_type, nullptr /* decompressor */,
+                      PersistentCacheOptions::kEmpty)
+      .ReadBlockContents();
+}
+
 Status PlainTableReader::PopulateIndex(TableProperties* props,
                                        int bloom_bits_per_key,
                                        double hash_table_ratio,
@@ -298,26 +322,54 @@ Status PlainTableReader::PopulateIndex(TableProperties* props,
                                        size_t huge_page_tlb_size) {
   assert(props != nullptr);
 
-  BlockContents index_block_contents;
-
   // TODO: plumb Env::IOActivity, Env::IOPriority
   const ReadOptions read_options;
-  Status s =
-      ReadMetaBlock(file_info_.file.get(), nullptr /* prefetch_buffer */,
-                    file_size_, kPlainTableMagicNumber, ioptions_, read_options,
-                    PlainTableIndexBuilder::kPlainTableIndexBlock,
-                    BlockType::kIndex, &index_block_contents);
 
-  bool index_in_file = s.ok();
+  // Look up both the index and the bloom block with a single read of the
+  // meta index block.
+  Footer footer;
+  BlockHandle index_block_handle = BlockHandle::NullBlockHandle();
+  BlockHandle bloom_block_handle = BlockHandle::NullBlockHandle();
+  {
+    BlockContents metaindex_contents;
+    Status s = ReadMetaIndexBlockInFile(
+        file_info_.file.get(), file_size_, kPlainTableMagicNumber, ioptions_,
+        read_options, &metaindex_contents, nullptr /* memory_allocator */,
+        nullptr /* prefetch_buffer */, &footer);
+    if (s.ok()) {
+      Block metaindex_block(std::move(metaindex_contents));
+      std::unique_ptr<InternalIterator> meta_iter(
+          metaindex_block.NewMetaIterator());
+      s = FindOptionalMetaBlock(meta_iter.get(),
+                                PlainTableIndexBuilder::kPlainTableIndexBlock,
+                                &index_block_handle);
+      if (s.ok() && !index_block_handle.IsNull()) {
+        s = FindOptionalMetaBlock(meta_iter.get(),
+                                  BloomBlockBuilder::kBloomBlock,
+                                  &bloom_block_handle);
+      }
+    }
+    if (!s.ok()) {
+      // Rebuild the index from the data, as when it is not in the file
+      index_block_handle = BlockHandle::NullBlockHandle();
+    }
+  }
+
+  BlockContents index_block_contents;
+  Status s;
+  bool index_in_file = false;
+  if (!index_block_handle.IsNull()) {
+    s = ReadMetaBlockContents(footer, index_block_handle, BlockType::kIndex,
+                              &index_block_contents);
+    index_in_file = s.ok();
+  }
 
   BlockContents bloom_block_contents;
   bool bloom_in_file = false;
   // We only need to read the bloom block if index block is in file.
-  if (index_in_file) {
-    s = ReadMetaBlock(file_info_.file.get(), nullptr /* prefetch_buffer */,
-                      file_size_, kPlainTableMagicNumber, ioptions_,
-                      read_options, BloomBlockBuilder::kBloomBlock,
-                      BlockType::kFilter, &bloom_block_contents);
+  if (index_in_file && !bloom_block_handle.IsNull()) {
+    s = ReadMetaBlockContents(footer, bloom_block_handle, BlockType::kFilter,
+                              &bloom_block_contents);
     bloom_in_file = s.ok() && bloom_block_contents.data.size() > 0;
   }
 
@@ -216,6 +216,12 @@ class PlainTableReader : public TableReader {
 
   void FillBloom(const std::vector<uint32_t>& prefix_hashes);
 
+  // Reads the meta block at `handle`. In mmap mode, the contents point
+  // directly into the mapped file, so that the index and the bloom filter
+  // stored in the file are used in place, without copying them.
+  Status ReadMetaBlockContents(const Footer& footer, const BlockHandle& handle,
+                               BlockType block_type, BlockContents* contents);
+
   // Read the key and value at `offset` to parameters for keys, the and
   // `seekable`.
   // On success, `offset` will be updated as the offset for the next key.
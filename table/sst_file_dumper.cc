@@ -199,10 +199,12 @@ Status SstFileDumper::NewTableReader(
                                                 file_size, &table_reader_);
 }
 
-Status SstFileDumper::VerifyChecksum() {
+Status SstFileDumper::VerifyChecksum(bool async_io) {
   assert(read_options_.verify_checksums);
   // We could pass specific readahead setting into read options if needed.
-  return table_reader_->VerifyChecksum(read_options_,
+  ReadOptions read_options = read_options_;
+  read_options.async_io = async_io;
+  return table_reader_->VerifyChecksum(read_options,
                                        TableReaderCaller::kSSTDumpTool);
 }
 
@@ -38,7 +38,10 @@ class SstFileDumper {
   uint64_t GetReadNumber() { return read_num_; }
   TableProperties* GetInitTableProperties() { return table_properties_.get(); }
 
-  Status VerifyChecksum();
+  // Verifies the block checksums of the file, reading the rest of the
+  // readahead asynchronously while the blocks read before are verified if
+  // `async_io` is set.
+  Status VerifyChecksum(bool async_io = false);
   Status DumpTable(const std::string& out_filename);
   Status getStatus() { return init_result_; }
 
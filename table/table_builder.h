@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,6 +23,8 @@
 #include "options/cf_options.h"
 #include "rocksdb/options.h"
 #include "rocksdb/table_properties.h"
+#include "table/block_based/file_hash_index.h"
+#include "table/table_reader.h"
 #include "table/unique_id_impl.h"
 #include "trace_replay/block_cache_tracer.h"
 
@@ -43,7 +46,9 @@ struct TableReaderOptions {
       size_t _max_file_size_for_l0_meta_pin = 0,
       const std::string& _cur_db_session_id = "", uint64_t _cur_file_num = 0,
       UniqueId64x2 _unique_id = {}, SequenceNumber _largest_seqno = 0,
-      uint64_t _tail_size = 0, bool _user_defined_timestamps_persisted = true)
+      uint64_t _tail_size = 0, bool _user_defined_timestamps_persisted = true,
+      const std::shared_ptr<CompressionManager>& _compression_manager =
+          nullptr)
       : ioptions(_ioptions),
         prefix_extractor(_prefix_extractor),
         env_options(_env_options),
@@ -60,7 +65,8 @@ struct TableReaderOptions {
         unique_id(_unique_id),
         block_protection_bytes_per_key(_block_protection_bytes_per_key),
         tail_size(_tail_size),
-        user_defined_timestamps_persisted(_user_defined_timestamps_persisted) {}
+        user_defined_timestamps_persisted(_user_defined_timestamps_persisted),
+        compression_manager(_compression_manager) {}
 
   const ImmutableOptions& ioptions;
   const std::shared_ptr<const SliceTransform>& prefix_extractor;
@@ -97,6 +103,10 @@ struct TableReaderOptions {
 
   // Whether the key in the table contains user-defined timestamps.
   bool user_defined_timestamps_persisted;
+
+  // The CompressionManager of the column family, if any. It provides the
+  // decompressor for files in a format it is compatible with.
+  std::shared_ptr<CompressionManager> compression_manager;
 };
 
 struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
@@ -163,6 +173,22 @@ struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
   // in the table options of the ioptions.table_factory
   bool skip_filters = false;
   const uint64_t cur_file_num;
+
+  // Only used by BlockBasedTableBuilder, to enforce
+  // `prepopulate_block_cache_compaction_max_bytes` across the output files of
+  // one compaction job. If not null, it counts the bytes of data blocks
+  // prepopulated into the block cache by all the builders sharing it.
+  std::atomic<uint64_t>* prepopulated_data_block_bytes = nullptr;
+
+  // Only used by BlockBasedTableBuilder, for
+  // `prepopulate_block_cache_compaction_hot_ranges_only`. If not null, the
+  // hot key ranges of the compaction inputs, in order and without overlaps.
+  const std::vector<TableReader::HotKeyRange>* hot_key_ranges = nullptr;
+
+  // Only used by BlockBasedTableBuilder. If not null, it is fed the keys and
+  // data blocks of the file to build its hash index, see
+  // AdvancedColumnFamilyOptions::bottommost_hash_index.
+  FileHashIndex::Builder* hash_index_builder = nullptr;
 };
 
 // TableBuilder provides the interface used to build a Table
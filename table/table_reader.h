@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "db/range_tombstone_fragmenter.h"
+#include "rocksdb/advanced_cache.h"
 #if USE_COROUTINES
 #include "folly/coro/Coroutine.h"
 #include "folly/coro/Task.h"
@@ -23,6 +24,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class FileHashIndex;
 class Iterator;
 struct ParsedInternalKey;
 class Slice;
@@ -109,6 +111,22 @@ class TableReader {
     return Status::NotSupported("ApproximateKeyAnchors() not supported.");
   }
 
+  // A range of user keys, inclusive on both ends. An empty `smallest` means
+  // the range starts at the first key of the table.
+  struct HotKeyRange {
+    std::string smallest;
+    std::string largest;
+  };
+
+  // Appends to `ranges`, in key order and without overlaps, the key ranges of
+  // the table that were found hot in the block cache by user reads. An OK
+  // status with no ranges appended means the table has no hot key range.
+  // NotSupported means the table does not track its hot key ranges.
+  virtual Status GetHotKeyRanges(const ReadOptions& /*read_options*/,
+                                 std::vector<HotKeyRange>* /*ranges*/) {
+    return Status::NotSupported("GetHotKeyRanges() not supported.");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -137,6 +155,17 @@ class TableReader {
                      const SliceTransform* prefix_extractor,
                      bool skip_filters = false) = 0;
 
+  // Like Get(), with the in-memory hash index built for the file, see
+  // AdvancedColumnFamilyOptions::bottommost_hash_index. Readers that cannot
+  // use it ignore it.
+  virtual Status GetWithHashIndex(const ReadOptions& readOptions,
+                                  const Slice& key, GetContext* get_context,
+                                  const SliceTransform* prefix_extractor,
+                                  bool skip_filters,
+                                  const FileHashIndex* /*hash_index*/) {
+    return Get(readOptions, key, get_context, prefix_extractor, skip_filters);
+  }
+
   // Use bloom filters in the table file, if present, to filter out keys. The
   // mget_range will be updated to skip keys that get a negative result from
   // the filter lookup.
@@ -165,19 +194,79 @@ class TableReader {
   }
 #endif  // USE_COROUTINES
 
+  // Counters of the work done by Prefetch().
+  struct PrefetchStats {
+    // Data blocks read from the file and loaded into the block cache.
+    uint64_t blocks_loaded = 0;
+    // Of those, the ones that were loaded into its secondary cache, see
+    // PrefetchOptions::to_secondary_cache.
+    uint64_t blocks_loaded_to_secondary_cache = 0;
+    // Bytes of those blocks, including their trailers.
+    uint64_t bytes_read = 0;
+    // Data blocks of the range that were already in the block cache.
+    uint64_t blocks_already_cached = 0;
+    // Data blocks of the range, and their bytes including trailers, that were
+    // neither cached nor loaded because the block cache was full, see
+    // PrefetchOptions::stop_at_cache_capacity.
+    uint64_t blocks_skipped = 0;
+    uint64_t bytes_skipped = 0;
+  };
+
+  struct PrefetchOptions {
+    // Reported to the block cache tracer. Data blocks prefetched on behalf of
+    // TableReaderCaller::kWarmup are inserted into the block cache at
+    // Cache::Priority::BOTTOM, so that they are evicted before any block that
+    // was actually read.
+    TableReaderCaller caller = TableReaderCaller::kPrefetch;
+    // If true, no block is loaded that would push the usage of the block
+    // cache over its capacity, i.e. evict other entries from it. Prefetch()
+    // then returns Status::Incomplete() once it reaches such a block.
+    bool stop_at_cache_capacity = false;
+    // If true, the index and filter partitions of the file, if any, are
+    // loaded into the block cache before the data blocks of the range.
+    bool index_and_filter_partitions = false;
+    // If true, data blocks are loaded into the secondary cache of the block
+    // cache (see Cache::InsertIntoSecondaryCache()) rather than into the
+    // block cache itself. Falls back to the block cache if it has no
+    // secondary cache. `stop_at_cache_capacity` does not apply to the
+    // secondary cache.
+    bool to_secondary_cache = false;
+    // If false, the data blocks of the range are not loaded, only the index
+    // and filter partitions if `index_and_filter_partitions` is set.
+    bool data_blocks = true;
+  };
+
   // Prefetch data corresponding to a give range of keys
   // Typically this functionality is required for table implementations that
   // persists the data on a non volatile storage medium like disk/SSD
+  // If `stats` is not null, the work done is added to it. A null `options`
+  // means the default PrefetchOptions.
   virtual Status Prefetch(const ReadOptions& /* read_options */,
                           const Slice* begin = nullptr,
-                          const Slice* end = nullptr) {
+                          const Slice* end = nullptr,
+                          PrefetchStats* stats = nullptr,
+                          const PrefetchOptions* options = nullptr) {
     (void)begin;
     (void)end;
+    (void)stats;
+    (void)options;
     // Default implementation is NOOP.
     // The child class should implement functionality when applicable
     return Status::OK();
   }
 
+  // Inserts into the block cache a block of this table that was saved from
+  // it earlier, e.g. by a cache dump (see DBOptions::block_cache_dump_file).
+  // `key` is the cache key of the block, `role` the role it had in the cache
+  // and `saved` its data in the form the secondary cache saves it. Does
+  // nothing if the block is already cached, and returns Status::Incomplete()
+  // if inserting the block would push the block cache over its capacity.
+  virtual Status RestoreCacheEntry(const Slice& /*key*/,
+                                   CacheEntryRole /*role*/,
+                                   const Slice& /*saved*/) {
+    return Status::NotSupported("RestoreCacheEntry() not supported");
+  }
+
   // convert db file to a human readable form
   virtual Status DumpTable(WritableFile* /*out_file*/) {
     return Status::NotSupported("DumpTable() not supported");
@@ -2072,9 +2072,53 @@ TEST_P(BlockBasedTableTest, PrefetchTest) {
   c.ResetTableReader();
 }
 
+TEST_P(BlockBasedTableTest, PrefetchCoalescesReadsAndSkipsCachedBlocks) {
+  Options opt;
+  std::unique_ptr<InternalKeyComparator> ikc;
+  ikc.reset(new test::PlainInternalKeyComparator(opt.comparator));
+  opt.compression = kNoCompression;
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.block_size = 1024;
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.block_cache = NewLRUCache(16 * 1024 * 1024, 4);
+  opt.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator(), true /* convert_to_internal_key_ */);
+  for (int i = 0; i < 20; i++) {
+    c.Add("k" + std::to_string(10 + i), std::string(2000, 'x'));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableOptions ioptions(opt);
+  const MutableCFOptions moptions(opt);
+  c.Finish(opt, ioptions, moptions, table_options, *ikc, &keys, &kvmap);
+  auto* table_reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+
+  SetPerfLevel(PerfLevel::kEnableCount);
+  // All the data blocks are adjacent, so they are read from the file at once
+  // rather than block by block.
+  get_perf_context()->Reset();
+  ASSERT_OK(table_reader->Prefetch(ReadOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, get_perf_context()->block_read_count -
+                   get_perf_context()->index_block_read_count);
+  AssertKeysInCache(table_reader, keys, /*keys_not_in_cache=*/{},
+                    /*convert=*/true);
+
+  // Blocks already cached are not looked up through the regular read path
+  // again.
+  get_perf_context()->Reset();
+  ASSERT_OK(table_reader->Prefetch(ReadOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, get_perf_context()->block_read_count -
+                   get_perf_context()->index_block_read_count);
+  ASSERT_EQ(0, get_perf_context()->block_cache_hit_count -
+                   get_perf_context()->block_cache_index_hit_count);
+  SetPerfLevel(PerfLevel::kDisable);
+  c.ResetTableReader();
+}
+
 TEST_P(BlockBasedTableTest, TotalOrderSeekOnHashIndex) {
   BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
-  for (int i = 0; i <= 4; ++i) {
+  for (int i = 0; i <= 5; ++i) {
     Options options;
     // Make each key/value an individual block
     table_options.block_size = 64;
@@ -2108,6 +2152,11 @@ TEST_P(BlockBasedTableTest, TotalOrderSeekOnHashIndex) {
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
         options.table_factory.reset(new BlockBasedTableFactory(table_options));
         break;
+      case 5:
+        // Learned index
+        table_options.index_type = BlockBasedTableOptions::kLearnedIndexSearch;
+        options.table_factory.reset(new BlockBasedTableFactory(table_options));
+        break;
     }
 
     TableConstructor c(BytewiseComparator(),
@@ -5526,6 +5575,89 @@ TEST_P(BlockBasedTableTest, BlockAlignTest) {
   table_reader.reset();
 }
 
+TEST_P(BlockBasedTableTest, AvoidDataBlockPageCrossingTest) {
+  BlockBasedTableOptions bbto = GetBlockBasedTableOptions();
+  bbto.avoid_data_block_page_crossing = true;
+  bbto.block_size = 3000;
+  test::StringSink* sink = new test::StringSink();
+  std::unique_ptr<FSWritableFile> holder(sink);
+  std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
+      std::move(holder), "" /* don't care */, FileOptions()));
+  Options options;
+  options.compression =
+      Snappy_Supported() ? kSnappyCompression : kNoCompression;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  ASSERT_OK(options.table_factory->ValidateOptions(
+      DBOptions(options), ColumnFamilyOptions(options)));
+  const ImmutableOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  InternalKeyComparator ikc(options.comparator);
+  InternalTblPropCollFactories internal_tbl_prop_coll_factories;
+  std::string column_family_name;
+  const ReadOptions read_options;
+  const WriteOptions write_options;
+  std::unique_ptr<TableBuilder> builder(options.table_factory->NewTableBuilder(
+      TableBuilderOptions(ioptions, moptions, read_options, write_options, ikc,
+                          &internal_tbl_prop_coll_factories,
+                          options.compression, CompressionOptions(),
+                          kUnknownColumnFamily, column_family_name, -1,
+                          kUnknownNewestKeyTime),
+      file_writer.get()));
+
+  Random rnd(301);
+  std::vector<std::pair<std::string, std::string>> kvs;
+  for (int i = 1; i <= 10000; ++i) {
+    std::ostringstream ostr;
+    ostr << std::setfill('0') << std::setw(5) << i;
+    InternalKey ik(ostr.str(), 0, kTypeValue);
+    // Partly compressible, so that data blocks vary in size
+    std::string value = rnd.RandomString(i % 20) + std::string(i % 30, 'v');
+    builder->Add(ik.Encode(), value);
+    kvs.emplace_back(ik.Encode().ToString(), value);
+  }
+  ASSERT_OK(builder->Finish());
+  ASSERT_OK(file_writer->Flush(IOOptions()));
+
+  std::unique_ptr<FSRandomAccessFile> source(
+      new test::StringSource(sink->contents(), 73342, false));
+  std::unique_ptr<RandomAccessFileReader> file_reader(
+      new RandomAccessFileReader(std::move(source), "test"));
+  std::unique_ptr<TableReader> table_reader;
+  ASSERT_OK(options.table_factory->NewTableReader(
+      TableReaderOptions(ioptions, moptions.prefix_extractor, EnvOptions(),
+                         ikc, 0 /* block_protection_bytes_per_key */),
+      std::move(file_reader), sink->contents().size(), &table_reader));
+  auto table = static_cast<BlockBasedTable*>(table_reader.get());
+
+  // No data block spans more pages than it has to
+  const uint64_t page_size = kDefaultPageSize;
+  int num_padded_blocks = 0;
+  for (const auto& kv : kvs) {
+    BlockHandle handle;
+    table->TEST_GetDataBlockHandle(read_options, kv.first, handle);
+    const uint64_t size = handle.size() + BlockBasedTable::kBlockTrailerSize;
+    const uint64_t offset_in_page = handle.offset() % page_size;
+    ASSERT_EQ((size + page_size - 1) / page_size,
+              (offset_in_page + size + page_size - 1) / page_size);
+    if (offset_in_page == 0 && handle.offset() > 0) {
+      num_padded_blocks++;
+    }
+  }
+  ASSERT_GT(num_padded_blocks, 0);
+
+  std::unique_ptr<InternalIterator> db_iter(table_reader->NewIterator(
+      read_options, moptions.prefix_extractor.get(), /*arena=*/nullptr,
+      /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+  size_t i = 0;
+  for (db_iter->SeekToFirst(); db_iter->Valid(); db_iter->Next(), ++i) {
+    ASSERT_LT(i, kvs.size());
+    ASSERT_EQ(kvs[i].first, db_iter->key().ToString());
+    ASSERT_EQ(kvs[i].second, db_iter->value().ToString());
+  }
+  ASSERT_OK(db_iter->status());
+  ASSERT_EQ(kvs.size(), i);
+}
+
 TEST_P(BlockBasedTableTest, FixBlockAlignMismatchedFileChecksums) {
   Options options;
   options.create_if_missing = true;
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "port/port.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
@@ -60,6 +62,12 @@ class RandomTransactionInserter {
 
   ~RandomTransactionInserter();
 
+  // Picks the key to increment in each set with `key_picker`, which must
+  // return a number below num_keys, instead of uniformly at random.
+  void SetKeyPicker(std::function<uint64_t()> key_picker) {
+    key_picker_ = std::move(key_picker);
+  }
+
   // Increment a key in each set using a Transaction on a TransactionDB.
   //
   // Returns true if the transaction succeeded OR if any error encountered was
@@ -119,6 +127,7 @@ class RandomTransactionInserter {
   ReadOptions read_options_;
   const uint64_t num_keys_;
   const uint16_t num_sets_;
+  std::function<uint64_t()> key_picker_;
 
   // Number of successful insert batches performed
   uint64_t success_count_ = 0;
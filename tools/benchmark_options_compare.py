@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+#  Copyright (c) Meta Platforms, Inc. and affiliates.
+#  This source code is licensed under both the GPLv2 (found in the
+#  COPYING file in the root directory) and Apache 2.0 License
+#  (found in the LICENSE.Apache file in the root directory).
+
+"""Compare option sets of db_bench on the same dataset snapshot
+
+Unlike benchmark_compare.sh, which rebuilds the DB for every run and
+compares binaries, this tool loads nothing: every run of every option
+variant starts from its own checkpoint of one already loaded DB, so the
+variants see identical data. The first variant is the baseline, and for
+each other variant the deltas of the throughput, the p99 latency, the
+write amplification and the block cache hit rate are reported with the
+p-value of Welch's t-test over the repeated runs.
+
+Example:
+
+  tools/benchmark_options_compare.py --db=/data/loaded_db \\
+      --work_dir=/data/compare --runs=5 \\
+      --common_args="--benchmarks=readrandomwriterandom --duration=300" \\
+      --variant="base:" \\
+      --variant="warmup:--compaction_warmup_mode=1" \\
+      --variant="big_cache:--cache_size=8589934592"
+"""
+
+import argparse
+import concurrent.futures
+import logging
+import math
+import os
+import re
+import shlex
+import shutil
+import statistics
+import subprocess
+import sys
+
+logging.basicConfig(level=logging.INFO)
+
+# The metrics of a run, with whether a higher value is better
+METRICS = [
+    ("ops_per_sec", True),
+    ("p99_micros", False),
+    ("write_amp", False),
+    ("block_cache_hit_rate", True),
+]
+
+THROUGHPUT_RE = re.compile(r"^\S+\s*:\s*[\d.]+ micros/op (\d+) ops/sec")
+PERCENTILES_RE = re.compile(r"^Percentiles:.* P99: ([\d.]+)")
+TICKER_RE = re.compile(r"^(rocksdb\.[\w.]+) COUNT : (\d+)")
+
+
+def parse_output(output):
+    """Returns the metrics of the db_bench output of one run"""
+    ops_per_sec = 0
+    p99_micros = []
+    tickers = {}
+    for line in output.splitlines():
+        match = THROUGHPUT_RE.match(line)
+        if match:
+            ops_per_sec += int(match.group(1))
+            continue
+        match = PERCENTILES_RE.match(line)
+        if match:
+            p99_micros.append(float(match.group(1)))
+            continue
+        match = TICKER_RE.match(line)
+        if match:
+            tickers[match.group(1)] = int(match.group(2))
+
+    metrics = {"ops_per_sec": float(ops_per_sec)}
+    if p99_micros:
+        # The worst of the operation types
+        metrics["p99_micros"] = max(p99_micros)
+    user_bytes = tickers.get("rocksdb.bytes.written", 0)
+    if user_bytes > 0:
+        metrics["write_amp"] = (
+            tickers.get("rocksdb.flush.write.bytes", 0)
+            + tickers.get("rocksdb.compact.write.bytes", 0)
+        ) / user_bytes
+    hits = tickers.get("rocksdb.block.cache.hit", 0)
+    misses = tickers.get("rocksdb.block.cache.miss", 0)
+    if hits + misses > 0:
+        metrics["block_cache_hit_rate"] = hits / (hits + misses)
+    return metrics
+
+
+def incomplete_beta(a, b, x):
+    """Regularized incomplete beta function I_x(a, b), by Lentz's continued
+    fraction"""
+    if x <= 0:
+        return 0.0
+    if x >= 1:
+        return 1.0
+    if x > (a + 1) / (a + b + 2):
+        return 1.0 - incomplete_beta(b, a, 1 - x)
+    log_front = (
+        math.lgamma(a + b)
+        - math.lgamma(a)
+        - math.lgamma(b)
+        + a * math.log(x)
+        + b * math.log(1 - x)
+    )
+    tiny = 1e-300
+    c = 1.0
+    d = 1.0 - (a + b) * x / (a + 1)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    result = d
+    for m in range(1, 300):
+        for numerator in (
+            m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+            -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1)),
+        ):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            result *= c * d
+        if abs(c * d - 1.0) < 1e-12:
+            break
+    return math.exp(log_front) * result / a
+
+
+def welch_t_test(baseline, variant):
+    """Returns the two-sided p-value of Welch's t-test of the samples, or
+    None without at least two of each"""
+    if len(baseline) < 2 or len(variant) < 2:
+        return None
+    se_baseline = statistics.variance(baseline) / len(baseline)
+    se_variant = statistics.variance(variant) / len(variant)
+    if se_baseline + se_variant == 0:
+        return 1.0 if statistics.mean(baseline) == statistics.mean(variant) else 0.0
+    t = (statistics.mean(variant) - statistics.mean(baseline)) / math.sqrt(
+        se_baseline + se_variant
+    )
+    df = (se_baseline + se_variant) ** 2 / (
+        se_baseline**2 / (len(baseline) - 1) + se_variant**2 / (len(variant) - 1)
+    )
+    return incomplete_beta(df / 2, 0.5, df / (df + t * t))
+
+
+def run_variant(args, name, variant_args, run):
+    """Runs db_bench once for the variant on a fresh checkpoint of the DB and
+    returns its metrics"""
+    run_dir = os.path.join(args.work_dir, f"{name}.{run}")
+    db_dir = os.path.join(run_dir, "db")
+    shutil.rmtree(run_dir, ignore_errors=True)
+    os.makedirs(run_dir)
+    subprocess.run(
+        [
+            args.ldb,
+            "checkpoint",
+            f"--db={args.db}",
+            f"--checkpoint_dir={db_dir}",
+            "--try_load_options",
+        ],
+        check=True,
+        stdout=subprocess.DEVNULL,
+    )
+    cmd = (
+        [args.db_bench, f"--db={db_dir}", "--use_existing_db=1"]
+        + ["--statistics=1", "--histogram=1"]
+        + shlex.split(args.common_args)
+        + shlex.split(variant_args)
+    )
+    logging.info(f"{name} run {run}: {' '.join(cmd)}")
+    with open(os.path.join(run_dir, "db_bench.log"), "w") as log:
+        result = subprocess.run(
+            cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True
+        )
+        log.write(result.stdout)
+    if result.returncode != 0:
+        raise RuntimeError(
+            f"{name} run {run} failed, see {run_dir}/db_bench.log"
+        )
+    if not args.keep_dbs:
+        shutil.rmtree(db_dir)
+    return parse_output(result.stdout)
+
+
+def report(variants, results, alpha):
+    """Prints the mean of each metric of each variant, and the deltas from the
+    baseline with their p-values"""
+    baseline = variants[0][0]
+    print(
+        "variant\tmetric\tmean\tstdev\tdelta_pct\tp_value\tverdict",
+        flush=True,
+    )
+    for name, _ in variants:
+        for metric, higher_is_better in METRICS:
+            samples = [r[metric] for r in results[name] if metric in r]
+            if not samples:
+                continue
+            mean = statistics.mean(samples)
+            stdev = statistics.stdev(samples) if len(samples) > 1 else 0.0
+            base_samples = [r[metric] for r in results[baseline] if metric in r]
+            delta, p_value, verdict = "", "", "baseline"
+            if name != baseline and base_samples:
+                base_mean = statistics.mean(base_samples)
+                if base_mean != 0:
+                    delta = f"{100.0 * (mean - base_mean) / base_mean:+.2f}"
+                p = welch_t_test(base_samples, samples)
+                if p is None:
+                    verdict = "too_few_runs"
+                else:
+                    p_value = f"{p:.4f}"
+                    if p >= alpha:
+                        verdict = "no_change"
+                    elif (mean > base_mean) == higher_is_better:
+                        verdict = "better"
+                    else:
+                        verdict = "worse"
+            print(
+                f"{name}\t{metric}\t{mean:.4f}\t{stdev:.4f}\t{delta}\t"
+                f"{p_value}\t{verdict}"
+            )
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare db_bench option sets on checkpoints of one DB."
+    )
+    parser.add_argument("--db", required=True, help="The loaded DB to clone")
+    parser.add_argument(
+        "--work_dir", required=True, help="Directory of the checkpoints and logs"
+    )
+    parser.add_argument(
+        "--variant",
+        action="append",
+        required=True,
+        help="NAME:DB_BENCH_ARGS of an option set, the first is the baseline",
+    )
+    parser.add_argument(
+        "--common_args", default="", help="db_bench arguments of all the runs"
+    )
+    parser.add_argument("--runs", type=int, default=3, help="Runs per variant")
+    parser.add_argument(
+        "--parallel",
+        type=int,
+        default=1,
+        help="Number of runs at a time. Runs in parallel share the machine, so "
+        "use it only when it has the resources of all of them",
+    )
+    parser.add_argument(
+        "--alpha", type=float, default=0.05, help="Significance level"
+    )
+    parser.add_argument("--db_bench", default="./db_bench")
+    parser.add_argument("--ldb", default="./ldb")
+    parser.add_argument(
+        "--keep_dbs", action="store_true", help="Keep the checkpoints after runs"
+    )
+    args = parser.parse_args()
+
+    variants = []
+    for variant in args.variant:
+        name, sep, variant_args = variant.partition(":")
+        if not sep or not name or any(name == n for n, _ in variants):
+            parser.error(f"invalid or duplicate variant: {variant}")
+        variants.append((name, variant_args))
+
+    # Interleave the runs of the variants so that a drift of the machine
+    # affects them alike
+    jobs = [(name, a, run) for run in range(args.runs) for name, a in variants]
+    results = {name: [] for name, _ in variants}
+    os.makedirs(args.work_dir, exist_ok=True)
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.parallel) as pool:
+        futures = {
+            pool.submit(run_variant, args, name, a, run): name
+            for name, a, run in jobs
+        }
+        for future in concurrent.futures.as_completed(futures):
+            results[futures[future]].append(future.result())
+
+    report(variants, results, args.alpha)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
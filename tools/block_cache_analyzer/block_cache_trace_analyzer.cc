@@ -36,7 +36,9 @@ DEFINE_string(
     "cache configuration is "
     "cache_name,num_shard_bits,ghost_capacity,cache_capacity_1,...,cache_"
     "capacity_N. Supported cache names are lru, lru_priority, lru_hybrid, and "
-    "lru_hybrid_no_insert_on_row_miss. User may also add a prefix 'ghost_' to "
+    "lru_hybrid_no_insert_on_row_miss, and lru_warmup_none, "
+    "lru_warmup_outputs, lru_warmup_hot and lru_warmup_prepopulate which need "
+    "compaction_events_path. User may also add a prefix 'ghost_' to "
     "a cache_name to add a ghost cache in front of the real cache. "
     "ghost_capacity and cache_capacity can be xK, xM or xG where x is a "
     "positive number.");
@@ -55,6 +57,24 @@ DEFINE_bool(print_data_block_access_count_stats, false,
 DEFINE_int32(cache_sim_warmup_seconds, 0,
              "The number of seconds to warmup simulated caches. The hit/miss "
              "counters are reset after the warmup completes.");
+DEFINE_string(
+    compaction_events_path, "",
+    "The compactions that ran while the trace was recorded, e.g. as reported "
+    "by EventListener::OnCompactionCompleted(). One compaction per line in "
+    "the format timestamp,input_file_numbers,output_file_numbers where the "
+    "timestamp is in microseconds and the file numbers are separated by "
+    "spaces. The lru_warmup_* caches warm up the output files of each "
+    "compaction once it completes: lru_warmup_none does not, "
+    "lru_warmup_outputs inserts their data blocks at the bottom priority, "
+    "lru_warmup_hot only the ones overlapping the key ranges of the hot data "
+    "blocks of the inputs, and lru_warmup_prepopulate all their blocks like "
+    "prepopulate_block_cache.");
+DEFINE_int32(compaction_warmup_sim_max_bytes_per_compaction, 0,
+             "The most bytes the lru_warmup_* caches warm up per compaction, "
+             "0 for no limit.");
+DEFINE_int32(compaction_warmup_sim_min_data_block_hits, 1,
+             "The number of accesses after which lru_warmup_hot considers a "
+             "data block of a compaction input hot.");
 DEFINE_int32(analyze_bottom_k_access_count_blocks, 0,
              "Print out detailed access information for blocks with their "
              "number of accesses are the bottom k among all blocks.");
@@ -169,7 +189,8 @@ const std::set<std::string> kGroupbyLabels{
 const std::string kSupportedCacheNames =
     " lru ghost_lru lru_priority ghost_lru_priority lru_hybrid "
     "ghost_lru_hybrid lru_hybrid_no_insert_on_row_miss "
-    "ghost_lru_hybrid_no_insert_on_row_miss ";
+    "ghost_lru_hybrid_no_insert_on_row_miss lru_warmup_none lru_warmup_outputs "
+    "lru_warmup_hot lru_warmup_prepopulate ";
 
 // The suffix for the generated csv files.
 const std::string kFileNameSuffixMissRatioTimeline = "miss_ratio_timeline";
@@ -242,6 +263,8 @@ std::string caller_to_string(TableReaderCaller caller) {
       return "SSTFileReader";
     case kUncategorized:
       return "Uncategorized";
+    case kWarmup:
+      return "Warmup";
     default:
       break;
   }
@@ -278,6 +301,8 @@ TableReaderCaller string_to_caller(std::string caller_str) {
     return kSSTFileReader;
   } else if (caller_str == "Uncategorized") {
     return kUncategorized;
+  } else if (caller_str == "Warmup") {
+    return kWarmup;
   }
   return TableReaderCaller::kMaxBlockCacheLookupCaller;
 }
@@ -1524,24 +1549,45 @@ Status BlockCacheTraceAnalyzer::RecordAccess(
       access, block_access_info.block_id, get_key_id);
 }
 
+Status BlockCacheTraceAnalyzer::NewTraceReader(
+    std::unique_ptr<BlockCacheTraceReader>* reader) {
+  if (is_human_readable_trace_file_) {
+    reader->reset(new BlockCacheHumanReadableTraceReader(trace_file_path_));
+    return Status::OK();
+  }
+  std::unique_ptr<TraceReader> trace_reader;
+  Status s =
+      NewFileTraceReader(env_, EnvOptions(), trace_file_path_, &trace_reader);
+  if (!s.ok()) {
+    return s;
+  }
+  reader->reset(new BlockCacheTraceReader(std::move(trace_reader)));
+  return (*reader)->ReadHeader(&header_);
+}
+
 Status BlockCacheTraceAnalyzer::Analyze() {
   SystemClock* clock = env_->GetSystemClock().get();
   std::unique_ptr<BlockCacheTraceReader> reader;
-  Status s = Status::OK();
-  if (is_human_readable_trace_file_) {
-    reader.reset(new BlockCacheHumanReadableTraceReader(trace_file_path_));
-  } else {
-    std::unique_ptr<TraceReader> trace_reader;
-    s = NewFileTraceReader(env_, EnvOptions(), trace_file_path_, &trace_reader);
-    if (!s.ok()) {
-      return s;
+  Status s;
+  if (cache_simulator_ && cache_simulator_->NeedsTraceFileBlocks()) {
+    // The output files of a compaction are only accessed after it completes,
+    // so their blocks are collected by a first pass for their warmup.
+    s = NewTraceReader(&reader);
+    while (s.ok()) {
+      BlockCacheTraceRecord access;
+      s = reader->ReadAccess(&access);
+      if (s.ok()) {
+        cache_simulator_->AddTraceFileBlock(access);
+      }
     }
-    reader.reset(new BlockCacheTraceReader(std::move(trace_reader)));
-    s = reader->ReadHeader(&header_);
-    if (!s.ok()) {
+    if (!s.IsIncomplete()) {
       return s;
     }
   }
+  s = NewTraceReader(&reader);
+  if (!s.ok()) {
+    return s;
+  }
   if (!human_readable_trace_file_path_.empty()) {
     s = human_readable_trace_writer_.NewWritableFile(
         human_readable_trace_file_path_, env_);
@@ -2117,6 +2163,50 @@ std::vector<CacheConfiguration> parse_cache_config_file(
   return configs;
 }
 
+std::vector<CompactionEvent> parse_compaction_events_file(
+    const std::string& events_path) {
+  std::ifstream file(events_path);
+  if (!file.is_open()) {
+    fprintf(stderr, "Cannot open compaction events %s\n",
+            events_path.c_str());
+    exit(1);
+  }
+  std::vector<CompactionEvent> events;
+  std::string line;
+  while (getline(file, line)) {
+    std::stringstream ss(line);
+    std::vector<std::string> event_strs;
+    while (ss.good()) {
+      std::string substr;
+      getline(ss, substr, ',');
+      event_strs.push_back(substr);
+    }
+    if (event_strs.size() != 3) {
+      fprintf(stderr, "Invalid compaction event %s\n", line.c_str());
+      exit(1);
+    }
+    CompactionEvent event;
+    event.timestamp = ParseUint64(event_strs[0]);
+    for (size_t i = 1; i < event_strs.size(); i++) {
+      std::vector<uint64_t>* file_numbers = i == 1
+                                                ? &event.input_file_numbers
+                                                : &event.output_file_numbers;
+      std::stringstream files_ss(event_strs[i]);
+      std::string file_number;
+      while (files_ss >> file_number) {
+        file_numbers->push_back(ParseUint64(file_number));
+      }
+    }
+    events.push_back(std::move(event));
+  }
+  file.close();
+  std::stable_sort(events.begin(), events.end(),
+                   [](const CompactionEvent& a, const CompactionEvent& b) {
+                     return a.timestamp < b.timestamp;
+                   });
+  return events;
+}
+
 std::vector<uint64_t> parse_buckets(const std::string& bucket_str) {
   std::vector<uint64_t> buckets;
   std::stringstream ss(bucket_str);
@@ -2146,6 +2236,20 @@ int block_cache_trace_analyzer_tool(int argc, char** argv) {
   if (!cache_configs.empty()) {
     cache_simulator.reset(new BlockCacheTraceSimulator(
         warmup_seconds, downsample_ratio, cache_configs));
+    if (!FLAGS_compaction_events_path.empty()) {
+      CompactionWarmupSimOptions warmup_options;
+      warmup_options.compaction_events =
+          parse_compaction_events_file(FLAGS_compaction_events_path);
+      warmup_options.max_bytes_per_compaction =
+          FLAGS_compaction_warmup_sim_max_bytes_per_compaction > 0
+              ? FLAGS_compaction_warmup_sim_max_bytes_per_compaction
+              : 0;
+      warmup_options.min_data_block_hits =
+          FLAGS_compaction_warmup_sim_min_data_block_hits > 0
+              ? FLAGS_compaction_warmup_sim_min_data_block_hits
+              : 1;
+      cache_simulator->SetCompactionWarmupOptions(std::move(warmup_options));
+    }
     Status s = cache_simulator->InitializeCaches();
     if (!s.ok()) {
       fprintf(stderr, "Cannot initialize cache simulators %s\n",
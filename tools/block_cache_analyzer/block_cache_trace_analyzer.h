@@ -370,6 +370,9 @@ class BlockCacheTraceAnalyzer {
       const std::map<std::string, Predictions>& label_predictions,
       uint32_t max_number_of_values) const;
 
+  // Opens the trace file and reads its header.
+  Status NewTraceReader(std::unique_ptr<BlockCacheTraceReader>* reader);
+
   ROCKSDB_NAMESPACE::Env* env_;
   const std::string trace_file_path_;
   const std::string output_dir_;
@@ -29,8 +29,10 @@
 #endif
 #include <atomic>
 #include <cinttypes>
+#include <cmath>
 #include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -63,6 +65,7 @@
 #include "rocksdb/stats_history.h"
 #include "rocksdb/table.h"
 #include "rocksdb/tool_hooks.h"
+#include "rocksdb/trace_record_result.h"
 #include "rocksdb/utilities/backup_engine.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
@@ -156,6 +159,7 @@ DEFINE_string(
     "timeseries,"
     "getmergeoperands,"
     "readrandomoperands,"
+    "compactionwarmup,"
     "backup,"
     "restore,"
     "approximatememtablestats",
@@ -189,6 +193,9 @@ DEFINE_string(
     "reads\n"
     "\treadwhilescanning     -- 1 thread doing full table scan, "
     "N threads doing random reads\n"
+    "\tcompactionwarmup      -- 1 writer driving compactions, N threads "
+    "doing zipfian random reads; measures the block cache hit rate recovery "
+    "after compactions with post-compaction warmup off, then on\n"
     "\treadrandomwriterandom -- N threads doing random-read, "
     "random-write\n"
     "\tupdaterandom  -- N threads doing read-modify-write for random "
@@ -416,6 +423,15 @@ DEFINE_double(read_random_exp_range, 0.0,
               "The larger the number is, the more skewed the reads are. "
               "Only used in readrandom and multireadrandom benchmarks.");
 
+DEFINE_double(compaction_warmup_zipf_theta, 0.99,
+              "Skew of the zipfian key distribution of the reads of the "
+              "compactionwarmup benchmark. 0 means uniform.");
+
+DEFINE_double(compaction_warmup_recovery_ratio, 0.99,
+              "In the compactionwarmup benchmark, the block cache hit rate has "
+              "recovered from a compaction in the first one-second interval "
+              "with at least this fraction of the hit rate before it.");
+
 DEFINE_bool(histogram, false, "Print histogram of operation timings");
 
 DEFINE_bool(confidence_interval_only, false,
@@ -503,11 +519,92 @@ DEFINE_uint64(subcompactions, 1,
 static const bool FLAGS_subcompactions_dummy __attribute__((__unused__)) =
     RegisterFlagValidator(&FLAGS_subcompactions, &ValidateUint32Range);
 
+DEFINE_uint32(subcompaction_ranges_per_thread,
+              ROCKSDB_NAMESPACE::Options().subcompaction_ranges_per_thread,
+              "Number of subcompaction ranges per subcompaction thread, which "
+              "take the next range not started yet when they finish one");
+
+DEFINE_bool(prioritize_compactions_by_read_amp,
+            ROCKSDB_NAMESPACE::Options().prioritize_compactions_by_read_amp,
+            "Give background compactions to the column families whose reads "
+            "they are expected to speed up the most per byte written");
+
 DEFINE_int32(max_background_flushes,
              ROCKSDB_NAMESPACE::Options().max_background_flushes,
              "The maximum number of concurrent background flushes"
              " that can occur in parallel.");
 
+DEFINE_uint32(max_flush_partitions,
+              ROCKSDB_NAMESPACE::Options().max_flush_partitions,
+              "The maximum number of L0 files that a flush builds in "
+              "parallel.");
+
+DEFINE_int32(max_background_warmups,
+             ROCKSDB_NAMESPACE::Options().max_background_warmups,
+             "The maximum number of concurrent post-compaction warmups of the "
+             "block cache. 0 disables them.");
+
+DEFINE_int32(compaction_warmup_mode, 0,
+             "What the post-compaction warmup loads into the block cache. "
+             "0 = nothing, 1 = the output files, 2 = the parts of the output "
+             "files that were hot in the compaction inputs. Requires "
+             "--max_background_warmups > 0.");
+
+DEFINE_int32(compaction_warmup_max_output_level,
+             ROCKSDB_NAMESPACE::CompactionWarmupPolicy().max_output_level,
+             "Only compactions whose output level is at most this are warmed. "
+             "-1 means no limit.");
+
+DEFINE_uint64(compaction_warmup_max_bytes,
+              ROCKSDB_NAMESPACE::CompactionWarmupPolicy()
+                  .max_bytes_per_compaction,
+              "Upper bound on the bytes read by the warmup of a single "
+              "compaction. 0 means no limit.");
+
+DEFINE_bool(compaction_warmup_stop_at_cache_capacity,
+            ROCKSDB_NAMESPACE::CompactionWarmupPolicy().stop_at_cache_capacity,
+            "Stop the post-compaction warmup once it would evict entries from "
+            "the block cache.");
+
+DEFINE_bool(compaction_warmup_index_and_filter_partitions,
+            ROCKSDB_NAMESPACE::CompactionWarmupPolicy()
+                .warm_index_and_filter_partitions,
+            "Load the index and filter partitions of the compaction outputs "
+            "before their data blocks.");
+
+DEFINE_int32(compaction_warmup_secondary_cache_min_output_level,
+             ROCKSDB_NAMESPACE::CompactionWarmupPolicy()
+                 .secondary_cache_min_output_level,
+             "Compactions whose output level is at least this warm their "
+             "output into the secondary cache of the block cache. -1 means "
+             "never.");
+
+DEFINE_bool(compaction_warmup_relocated_blobs,
+            ROCKSDB_NAMESPACE::CompactionWarmupPolicy().warm_relocated_blobs,
+            "Insert the blobs that blob garbage collection relocates into the "
+            "blob cache at their new location if they were cached.");
+
+DEFINE_bool(allow_flush_below_level0,
+            ROCKSDB_NAMESPACE::Options().allow_flush_below_level0,
+            "With leveled compaction, flush to the lowest level that the "
+            "output files fit in instead of always to L0.");
+
+DEFINE_bool(bottommost_hash_index,
+            ROCKSDB_NAMESPACE::Options().bottommost_hash_index,
+            "Build an in-memory hash index of the files written by bottommost "
+            "compactions, and use it for their point lookups.");
+
+DEFINE_bool(level_compaction_move_edge_overlaps,
+            ROCKSDB_NAMESPACE::Options().level_compaction_move_edge_overlaps,
+            "With leveled compaction, trivially move small files that a "
+            "file picked for compaction overlaps at its edge down a level, "
+            "so that the picked file can trivially move too.");
+
+DEFINE_double(memtable_point_lookup_index_ratio,
+              ROCKSDB_NAMESPACE::Options().memtable_point_lookup_index_ratio,
+              "Ratio of write_buffer_size given to the hash index of the "
+              "newest entries of the memtable keys, for point lookups.");
+
 static ROCKSDB_NAMESPACE::CompactionStyle FLAGS_compaction_style_e;
 DEFINE_int32(compaction_style,
              (int32_t)ROCKSDB_NAMESPACE::Options().compaction_style,
@@ -546,6 +643,10 @@ DEFINE_bool(universal_allow_trivial_move, false,
 DEFINE_bool(universal_incremental, false,
             "Enable incremental compactions in universal compaction.");
 
+DEFINE_bool(universal_incremental_avoid_full_compaction, false,
+            "With --universal_incremental, never fall back to compacting all "
+            "sorted runs at once to reduce size amplification.");
+
 DEFINE_int32(
     universal_stop_style,
     (int32_t)ROCKSDB_NAMESPACE::CompactionOptionsUniversal().stop_style,
@@ -646,6 +747,10 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(use_learned_index, false,
+            "Predict the position of keys in the index blocks with a "
+            "piecewise-linear model");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -706,9 +811,56 @@ DEFINE_bool(block_align,
             ROCKSDB_NAMESPACE::BlockBasedTableOptions().block_align,
             "Align data blocks on page size");
 
+DEFINE_bool(avoid_data_block_page_crossing,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .avoid_data_block_page_crossing,
+            "Pad data blocks that would cross a page boundary to the next "
+            "page");
+
+DEFINE_bool(prefix_block_map,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions().prefix_block_map,
+            "Write and use a map from the prefixes of each table file to "
+            "their data blocks");
+
+DEFINE_bool(compact_index_blocks,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions().compact_index_blocks,
+            "Write index blocks with Elias-Fano encoded restart points and "
+            "block offsets");
+
+DEFINE_bool(background_filter_build,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions().background_filter_build,
+            "Build the full filter of each table file on a helper thread "
+            "while the other meta blocks are written");
+
 DEFINE_int64(prepopulate_block_cache, 0,
-             "Pre-populate hot/warm blocks in block cache. 0 to disable and 1 "
-             "to insert during flush");
+             "Pre-populate hot/warm blocks in block cache. 0 to disable, 1 "
+             "to insert during flush and 2 to insert during flush and "
+             "compaction");
+
+DEFINE_int32(prepopulate_block_cache_compaction_max_level,
+             ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                 .prepopulate_block_cache_compaction_max_level,
+             "With --prepopulate_block_cache=2, only compaction outputs up to "
+             "this level are pre-populated. Negative for all levels.");
+
+DEFINE_bool(prepopulate_block_cache_compaction_metadata_only,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .prepopulate_block_cache_compaction_metadata_only,
+            "With --prepopulate_block_cache=2, only pre-populate the index, "
+            "filter and dictionary blocks of compaction outputs.");
+
+DEFINE_uint64(prepopulate_block_cache_compaction_max_bytes,
+              ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                  .prepopulate_block_cache_compaction_max_bytes,
+              "With --prepopulate_block_cache=2, maximum bytes of data blocks "
+              "pre-populated per compaction job. 0 for unlimited.");
+
+DEFINE_bool(prepopulate_block_cache_compaction_hot_ranges_only,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .prepopulate_block_cache_compaction_hot_ranges_only,
+            "With --prepopulate_block_cache=2, only pre-populate the data "
+            "blocks of compaction outputs in key ranges that were hot in the "
+            "compaction inputs.");
 
 DEFINE_uint32(uncache_aggressiveness,
               ROCKSDB_NAMESPACE::ColumnFamilyOptions().uncache_aggressiveness,
@@ -721,6 +873,11 @@ DEFINE_bool(use_data_block_hash_index, false,
             "instead of kDataBlockBinarySearch. "
             "This is valid if only we use BlockTable");
 
+DEFINE_bool(use_data_block_key_prefixes, false,
+            "if use kDataBlockBinarySearchWithKeyPrefixes "
+            "instead of kDataBlockBinarySearch. "
+            "This is valid if only we use BlockTable");
+
 DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "util ratio for data block hash index table. "
               "This is only valid if use_data_block_hash_index is "
@@ -742,10 +899,25 @@ DEFINE_int32(file_opening_threads,
              "If open_files is set to -1, this option set the number of "
              "threads that will be used to open files during DB::Open()");
 
+DEFINE_bool(open_table_files_in_background,
+            ROCKSDB_NAMESPACE::Options().open_table_files_in_background,
+            "If open_files is set to -1, open the table files in the "
+            "background after DB::Open() rather than during it");
+
+DEFINE_int32(wal_recovery_threads,
+             ROCKSDB_NAMESPACE::Options().max_wal_recovery_threads,
+             "Number of threads inserting the WAL records into the memtables "
+             "of the column families during DB::Open()");
+
 DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
 
+DEFINE_uint64(compaction_readahead_budget,
+              ROCKSDB_NAMESPACE::Options().compaction_readahead_budget,
+              "Readahead bytes split between the inputs of a compaction by "
+              "their size, instead of compaction_readahead_size for each");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(writable_file_max_buffer_size, 1024 * 1024,
@@ -850,6 +1022,12 @@ DEFINE_string(wal_compression, "none",
 static enum ROCKSDB_NAMESPACE::CompressionType FLAGS_wal_compression_e =
     ROCKSDB_NAMESPACE::kNoCompression;
 
+DEFINE_uint64(wal_compression_pipeline_min_record_size,
+              ROCKSDB_NAMESPACE::Options()
+                  .wal_compression_pipeline_min_record_size,
+              "With --wal_compression, compress WAL records of at least this "
+              "size in a background thread. 0 to always compress inline.");
+
 DEFINE_string(wal_dir, "", "If not empty, use the given dir for WAL");
 
 DEFINE_string(truth_db, "/dev/shm/truth_db/dbbench",
@@ -969,6 +1147,11 @@ DEFINE_uint64(transaction_sets, 2,
               "Number of keys each transaction will "
               "modify (use in RandomTransaction only).  Max: 9999");
 
+DEFINE_double(transaction_zipf_theta, 0,
+              "Skew of the zipfian distribution of the keys modified by the "
+              "randomtransaction benchmark, to contend on hot keys. 0 means "
+              "uniform.");
+
 DEFINE_bool(transaction_set_snapshot, false,
             "Setting to true will have each transaction call SetSnapshot()"
             " upon creation.");
@@ -1008,6 +1191,9 @@ DEFINE_uint64(fifo_compaction_ttl, 0, "TTL for the SST Files in seconds.");
 
 DEFINE_uint64(fifo_age_for_warm, 0, "age_for_warm for FIFO compaction.");
 
+DEFINE_uint64(fifo_time_window_seconds, 0,
+              "time_window_seconds for FIFO compaction.");
+
 // Stacked BlobDB Options
 DEFINE_bool(use_blob_db, false, "[Stacked BlobDB] Open a BlobDB instance.");
 
@@ -1070,6 +1256,12 @@ DEFINE_uint64(min_blob_size,
               "[Integrated BlobDB] The size of the smallest value to be stored "
               "separately in a blob file.");
 
+DEFINE_uint32(blob_separation_percent,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_separation_percent,
+              "[Integrated BlobDB] If nonzero, compactions adapt the minimum "
+              "blob size to separate about this percentage of the values.");
+
 DEFINE_uint64(blob_file_size,
               ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions().blob_file_size,
               "[Integrated BlobDB] The size limit for blob files.");
@@ -1095,6 +1287,12 @@ DEFINE_double(blob_garbage_collection_force_threshold,
               "[Integrated BlobDB] The threshold for the ratio of garbage in "
               "the eligible blob files for forcing garbage collection.");
 
+DEFINE_double(blob_garbage_collection_file_threshold,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_garbage_collection_file_threshold,
+              "[Integrated BlobDB] The threshold for the ratio of garbage in "
+              "a blob file for garbage collecting it regardless of its age.");
+
 DEFINE_uint64(blob_compaction_readahead_size,
               ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
                   .blob_compaction_readahead_size,
@@ -1170,11 +1368,22 @@ DEFINE_int64(
 DEFINE_string(block_cache_trace_file, "", "Block cache trace file path.");
 DEFINE_int32(trace_replay_threads, 1,
              "The number of threads to replay, must >=1.");
+DEFINE_bool(trace_replay_preserve_key_order, false,
+            "With --trace_replay_threads > 1, replay the records of the same "
+            "key in the same thread, in their order in the trace.");
 
 DEFINE_bool(io_uring_enabled, true,
             "If true, enable the use of IO uring if the platform supports it");
 extern "C" bool RocksDbIOUringEnable() { return FLAGS_io_uring_enabled; }
 
+DEFINE_uint32(io_uring_sq_poll_idle_ms, 0,
+              "If non-zero, IO uring instances share a kernel thread polling "
+              "their submission queues, which sleeps after being idle for "
+              "this many milliseconds");
+extern "C" unsigned int RocksDbIOUringSqPollIdleMillis() {
+  return FLAGS_io_uring_sq_poll_idle_ms;
+}
+
 DEFINE_bool(adaptive_readahead, false,
             "carry forward internal auto readahead size from one file to next "
             "file at each level during iteration");
@@ -1225,6 +1434,11 @@ DEFINE_bool(charge_blob_cache, false,
             "CacheEntryRoleOptions::charged of "
             "CacheEntryRole::kBlobCache");
 
+DEFINE_bool(charge_compaction_buffer, false,
+            "Setting for "
+            "CacheEntryRoleOptions::charged of "
+            "CacheEntryRole::kCompactionBuffer");
+
 DEFINE_uint64(backup_rate_limit, 0ull,
               "If non-zero, db_bench will rate limit reads and writes for DB "
               "backup. This "
@@ -1393,6 +1607,9 @@ static bool ValidateTableCacheNumshardbits(const char* flagname,
   return true;
 }
 DEFINE_int32(table_cache_numshardbits, 4, "");
+DEFINE_bool(table_cache_use_hyper_clock_cache,
+            ROCKSDB_NAMESPACE::Options().table_cache_use_hyper_clock_cache,
+            "Use a HyperClockCache for the table cache");
 
 DEFINE_string(env_uri, "",
               "URI for registry Env lookup. Mutually exclusive with --fs_uri");
@@ -1461,6 +1678,11 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
               "Limited bytes allowed to DB when soft_rate_limit or "
               "level0_slowdown_writes_trigger triggers");
 
+DEFINE_bool(adaptive_delayed_write_rate,
+            ROCKSDB_NAMESPACE::Options().adaptive_delayed_write_rate,
+            "Set the delayed write rate from the observed compaction "
+            "throughput while writes are delayed");
+
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
@@ -1484,9 +1706,19 @@ DEFINE_uint64(inplace_update_num_locks,
               ROCKSDB_NAMESPACE::Options().inplace_update_num_locks,
               "Number of RW locks to protect in-place memtable updates");
 
+DEFINE_bool(inplace_merge_support,
+            ROCKSDB_NAMESPACE::Options().inplace_merge_support,
+            "Combine merge operands in place in the memtable when "
+            "inplace_update_support is set");
+
 DEFINE_bool(enable_write_thread_adaptive_yield, true,
             "Use a yielding spin loop for brief writer thread waits.");
 
+DEFINE_bool(enable_write_thread_per_core_queues,
+            ROCKSDB_NAMESPACE::Options().enable_write_thread_per_core_queues,
+            "Stage joining writers in per-core queues before linking them "
+            "into the shared writer list.");
+
 DEFINE_uint64(
     write_thread_max_yield_usec, 100,
     "Maximum microseconds for enable_write_thread_adaptive_yield operation.");
@@ -1595,6 +1827,18 @@ DEFINE_uint64(
     "If non-zero, db_bench will rate-limit the reads from RocksDB. This "
     "is the global rate in ops/second.");
 
+DEFINE_uint64(
+    open_loop_rate, 0,
+    "If non-zero, each thread of a benchmark issues its ops on an open-loop "
+    "schedule of this many ops/second, whether or not the previous ops have "
+    "finished in time, and --histogram measures the latency of each op from "
+    "its scheduled start, so that the stalls of the DB are not hidden by the "
+    "ops that a closed loop would not have issued.");
+
+DEFINE_bool(open_loop_poisson, true,
+            "For --open_loop_rate, schedule the ops as a Poisson process "
+            "rather than at fixed intervals.");
+
 DEFINE_uint64(max_compaction_bytes,
               ROCKSDB_NAMESPACE::Options().max_compaction_bytes,
               "Max bytes allowed in one compaction");
@@ -1624,6 +1868,20 @@ DEFINE_bool(use_direct_io_for_flush_and_compaction,
             ROCKSDB_NAMESPACE::Options().use_direct_io_for_flush_and_compaction,
             "Use O_DIRECT for background flush and compaction writes");
 
+DEFINE_bool(background_writes_for_flush_and_compaction,
+            ROCKSDB_NAMESPACE::Options()
+                .background_writes_for_flush_and_compaction,
+            "Write the table and blob files of flushes and compactions from "
+            "a background thread while the next buffer is filled");
+
+DEFINE_bool(use_direct_io_for_wal,
+            ROCKSDB_NAMESPACE::Options().use_direct_io_for_wal,
+            "Use O_DIRECT through io_uring for WAL writes");
+
+DEFINE_bool(compaction_async_io,
+            ROCKSDB_NAMESPACE::Options().compaction_async_io,
+            "Double buffer compaction input readahead with async reads");
+
 DEFINE_bool(advise_random_on_open,
             ROCKSDB_NAMESPACE::Options().advise_random_on_open,
             "Advise random access on table file open");
@@ -1721,6 +1979,17 @@ DEFINE_uint64(stats_persist_period_sec,
 DEFINE_bool(persist_stats_to_disk,
             ROCKSDB_NAMESPACE::Options().persist_stats_to_disk,
             "whether to persist stats to disk");
+DEFINE_uint64(slow_read_log_threshold_micros,
+              ROCKSDB_NAMESPACE::Options().slow_read_log_threshold_micros,
+              "Report table file reads taking at least this long to the LOG");
+DEFINE_uint32(perf_context_sample_rate,
+              ROCKSDB_NAMESPACE::Options().perf_context_sample_rate,
+              "Record the PerfContext of one in this many operations into "
+              "the SAMPLED_* histograms of statistics");
+DEFINE_uint64(slow_operation_threshold_micros,
+              ROCKSDB_NAMESPACE::Options().slow_operation_threshold_micros,
+              "Report operations taking at least this long, with the spans "
+              "of their stages, to the event listeners");
 DEFINE_uint64(stats_history_buffer_size,
               ROCKSDB_NAMESPACE::Options().stats_history_buffer_size,
               "Max number of stats snapshots to keep in memory");
@@ -1753,6 +2022,11 @@ DEFINE_bool(report_file_operations, false,
 DEFINE_bool(report_open_timing, false, "if report open timing");
 DEFINE_int32(readahead_size, 0, "Iterator readahead size");
 
+DEFINE_uint64(async_readahead_num_buffers,
+              ROCKSDB_NAMESPACE::ReadOptions().async_readahead_num_buffers,
+              "Number of readahead buffers of a table file read at the same "
+              "time with --async_io");
+
 DEFINE_bool(read_with_latest_user_timestamp, true,
             "If true, always use the current latest timestamp for read. If "
             "false, choose a random timestamp from the past.");
@@ -1760,7 +2034,6 @@ DEFINE_bool(read_with_latest_user_timestamp, true,
 DEFINE_string(cache_uri, "", "Full URI for creating a custom cache object");
 DEFINE_string(secondary_cache_uri, "",
               "Full URI for creating a custom secondary cache object");
-DEFINE_bool(warmup_after_evict, false, "Warm-up block cache after SST eviction due to compaction");
 
 static class std::shared_ptr<ROCKSDB_NAMESPACE::SecondaryCache> secondary_cache;
 
@@ -1801,6 +2074,11 @@ DEFINE_uint32(
     "This options determines the size of such checksums. "
     "Supported values: 0, 1, 2, 4, 8.");
 
+DEFINE_uint32(memtable_protection_verify_one_in,
+              ROCKSDB_NAMESPACE::Options().memtable_protection_verify_one_in,
+              "Reads verify the memtable checksum of one in this many "
+              "entries. 0 verifies none; flush verifies all of them.");
+
 DEFINE_uint32(block_protection_bytes_per_key, 0,
               "Enable block per key-value checksum protection. "
               "Supported values: 0, 1, 2, 4, 8.");
@@ -2198,6 +2476,9 @@ class Stats {
   uint64_t bytes_;
   uint64_t last_op_finish_;
   uint64_t last_report_finish_;
+  // For --open_loop_rate, the scheduled start of the next op to finish
+  uint64_t open_loop_op_start_ = 0;
+  Random64 open_loop_rand_{0};
   std::unordered_map<OperationType, std::shared_ptr<HistogramImpl>,
                      std::hash<unsigned char>>
       hist_;
@@ -2226,6 +2507,9 @@ class Stats {
     sine_interval_ = clock_->NowMicros();
     finish_ = start_;
     last_report_finish_ = start_;
+    // The first op is scheduled to start now
+    open_loop_op_start_ = start_;
+    open_loop_rand_ = Random64(FLAGS_seed + id);
     message_.clear();
     // When set, stats from this thread won't be merged with others.
     exclude_from_merge_ = false;
@@ -2312,6 +2596,24 @@ class Stats {
     last_op_finish_ = clock_->NowMicros();
   }
 
+  // With --open_loop_rate, the time between the scheduled starts of the op
+  // that has finished and of the next one
+  uint64_t NextOpenLoopIntervalMicros(int64_t num_ops) {
+    const double mean_micros = 1e6 / static_cast<double>(FLAGS_open_loop_rate);
+    double micros = 0;
+    for (int64_t i = 0; i < num_ops; i++) {
+      if (FLAGS_open_loop_poisson) {
+        // Uniform in (0, 1]
+        const double u =
+            static_cast<double>((open_loop_rand_.Next() >> 11) + 1) / 0x1p53;
+        micros -= mean_micros * std::log(u);
+      } else {
+        micros += mean_micros;
+      }
+    }
+    return static_cast<uint64_t>(micros);
+  }
+
   void FinishedOps(DBWithColumnFamilies* db_with_cfh, DB* db, int64_t num_ops,
                    enum OperationType op_type = kOthers) {
     if (reporter_agent_) {
@@ -2319,7 +2621,10 @@ class Stats {
     }
     if (FLAGS_histogram) {
       uint64_t now = clock_->NowMicros();
-      uint64_t micros = now - last_op_finish_;
+      // With --open_loop_rate, the latency includes the time that the op has
+      // waited for the previous ones past its scheduled start
+      uint64_t micros = now - (FLAGS_open_loop_rate > 0 ? open_loop_op_start_
+                                                        : last_op_finish_);
 
       if (hist_.find(op_type) == hist_.end()) {
         auto hist_temp = std::make_shared<HistogramImpl>();
@@ -2333,6 +2638,16 @@ class Stats {
       }
       last_op_finish_ = now;
     }
+    if (FLAGS_open_loop_rate > 0) {
+      // Wait for the scheduled start of the next op, which is in the past when
+      // the ops are behind the schedule
+      open_loop_op_start_ += NextOpenLoopIntervalMicros(num_ops);
+      uint64_t now = clock_->NowMicros();
+      if (open_loop_op_start_ > now) {
+        clock_->SleepForMicroseconds(
+            static_cast<int>(open_loop_op_start_ - now));
+      }
+    }
 
     done_ += num_ops;
     if (done_ >= next_report_ && FLAGS_progress_reports) {
@@ -2737,6 +3052,51 @@ class Duration {
   uint64_t start_at_;
 };
 
+// Generates integers in [0, n) with a zipfian distribution of skew `theta`,
+// 0 < theta < 1, 0 being the most frequent one. See "Quickly Generating
+// Billion-Record Synthetic Databases", Gray et al., SIGMOD 1994.
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t n, double theta)
+      : n_(n),
+        theta_(theta),
+        alpha_(1.0 / (1.0 - theta)),
+        zeta_n_(Zeta(n, theta)),
+        eta_((1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) /
+             (1.0 - Zeta(2, theta) / zeta_n_)) {}
+
+  uint64_t Next(Random64* rand) const {
+    const double u = static_cast<double>(rand->Next() >> 11) /
+                     static_cast<double>(uint64_t{1} << 53);
+    const double uz = u * zeta_n_;
+    if (uz < 1.0) {
+      return 0;
+    }
+    if (uz < 1.0 + std::pow(0.5, theta_)) {
+      return 1;
+    }
+    return std::min(n_ - 1,
+                    static_cast<uint64_t>(static_cast<double>(n_) *
+                                          std::pow(eta_ * u - eta_ + 1.0,
+                                                   alpha_)));
+  }
+
+ private:
+  static double Zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i), theta);
+    }
+    return sum;
+  }
+
+  const uint64_t n_;
+  const double theta_;
+  const double alpha_;
+  const double zeta_n_;
+  const double eta_;
+};
+
 class Benchmark {
  private:
   std::shared_ptr<Cache> cache_;
@@ -2821,6 +3181,35 @@ class Benchmark {
 
   std::shared_ptr<ErrorHandlerListener> listener_;
 
+  // Counts the compactions that completed successfully, for the
+  // compactionwarmup benchmark.
+  class CompactionCountListener : public EventListener {
+   public:
+    const char* Name() const override { return kClassName(); }
+    static const char* kClassName() { return "CompactionCountListener"; }
+
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& info) override {
+      if (info.status.ok()) {
+        num_completed_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    uint64_t num_completed() const {
+      return num_completed_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<uint64_t> num_completed_{0};
+  };
+
+  std::shared_ptr<CompactionCountListener> compaction_count_listener_;
+
+  // State shared by the threads of the compactionwarmup benchmark.
+  std::unique_ptr<ZipfianGenerator> compaction_warmup_keys_;
+  HistogramImpl compaction_warmup_get_micros_;
+  std::atomic<bool> compaction_warmup_done_{false};
+
   std::unique_ptr<TimestampEmulator> mock_app_clock_;
 
   bool SanityCheck() {
@@ -3305,6 +3694,7 @@ class Benchmark {
     }
 
     listener_.reset(new ErrorHandlerListener());
+    compaction_count_listener_.reset(new CompactionCountListener());
     if (user_timestamp_size_ > 0) {
       mock_app_clock_.reset(new TimestampEmulator());
     }
@@ -3493,6 +3883,8 @@ class Benchmark {
       read_options_.readahead_size = FLAGS_readahead_size;
       read_options_.adaptive_readahead = FLAGS_adaptive_readahead;
       read_options_.async_io = FLAGS_async_io;
+      read_options_.async_readahead_num_buffers =
+          FLAGS_async_readahead_num_buffers;
       read_options_.optimize_multiget_for_io = FLAGS_optimize_multiget_for_io;
       read_options_.auto_readahead_size = FLAGS_auto_readahead_size;
       read_options_.auto_refresh_iterator_with_snapshot =
@@ -3662,6 +4054,28 @@ class Benchmark {
       } else if (name == "readwhilescanning") {
         num_threads++;  // Add extra thread for scaning
         method = &Benchmark::ReadWhileScanning;
+      } else if (name == "compactionwarmup") {
+        if (FLAGS_duration < 2 || dbstats == nullptr ||
+            FLAGS_max_background_warmups <= 0 || FLAGS_num_multi_db > 1) {
+          fprintf(stderr,
+                  "compactionwarmup requires --duration >= 2, --statistics, "
+                  "--max_background_warmups > 0 and a single DB\n");
+          ErrorExit();
+        }
+        if (FLAGS_compaction_warmup_zipf_theta < 0 ||
+            FLAGS_compaction_warmup_zipf_theta >= 1) {
+          fprintf(stderr, "--compaction_warmup_zipf_theta must be in [0, 1)\n");
+          ErrorExit();
+        }
+        if (FLAGS_compaction_warmup_zipf_theta > 0) {
+          compaction_warmup_keys_.reset(new ZipfianGenerator(
+              FLAGS_num, FLAGS_compaction_warmup_zipf_theta));
+        } else {
+          compaction_warmup_keys_.reset();
+        }
+        compaction_warmup_done_.store(false);
+        num_threads++;  // Add extra thread for writing and sampling
+        method = &Benchmark::CompactionWarmup;
       } else if (name == "readrandomwriterandom") {
         method = &Benchmark::ReadRandomWriteRandom;
       } else if (name == "readrandommergerandom") {
@@ -4241,6 +4655,11 @@ class Benchmark {
     options.stats_persist_period_sec =
         static_cast<unsigned int>(FLAGS_stats_persist_period_sec);
     options.persist_stats_to_disk = FLAGS_persist_stats_to_disk;
+    options.slow_read_log_threshold_micros =
+        FLAGS_slow_read_log_threshold_micros;
+    options.perf_context_sample_rate = FLAGS_perf_context_sample_rate;
+    options.slow_operation_threshold_micros =
+        FLAGS_slow_operation_threshold_micros;
     options.stats_history_buffer_size =
         static_cast<size_t>(FLAGS_stats_history_buffer_size);
     options.avoid_flush_during_recovery = FLAGS_avoid_flush_during_recovery;
@@ -4271,7 +4690,34 @@ class Benchmark {
     options.max_background_jobs = FLAGS_max_background_jobs;
     options.max_background_compactions = FLAGS_max_background_compactions;
     options.max_subcompactions = static_cast<uint32_t>(FLAGS_subcompactions);
+    options.subcompaction_ranges_per_thread =
+        FLAGS_subcompaction_ranges_per_thread;
+    options.prioritize_compactions_by_read_amp =
+        FLAGS_prioritize_compactions_by_read_amp;
     options.max_background_flushes = FLAGS_max_background_flushes;
+    options.max_flush_partitions = FLAGS_max_flush_partitions;
+    options.max_background_warmups = FLAGS_max_background_warmups;
+    options.compaction_warmup_policy.mode =
+        static_cast<ROCKSDB_NAMESPACE::CompactionWarmupMode>(
+            FLAGS_compaction_warmup_mode);
+    options.compaction_warmup_policy.max_output_level =
+        FLAGS_compaction_warmup_max_output_level;
+    options.compaction_warmup_policy.max_bytes_per_compaction =
+        FLAGS_compaction_warmup_max_bytes;
+    options.compaction_warmup_policy.stop_at_cache_capacity =
+        FLAGS_compaction_warmup_stop_at_cache_capacity;
+    options.compaction_warmup_policy.warm_index_and_filter_partitions =
+        FLAGS_compaction_warmup_index_and_filter_partitions;
+    options.compaction_warmup_policy.secondary_cache_min_output_level =
+        FLAGS_compaction_warmup_secondary_cache_min_output_level;
+    options.compaction_warmup_policy.warm_relocated_blobs =
+        FLAGS_compaction_warmup_relocated_blobs;
+    options.allow_flush_below_level0 = FLAGS_allow_flush_below_level0;
+    options.bottommost_hash_index = FLAGS_bottommost_hash_index;
+    options.level_compaction_move_edge_overlaps =
+        FLAGS_level_compaction_move_edge_overlaps;
+    options.memtable_point_lookup_index_ratio =
+        FLAGS_memtable_point_lookup_index_ratio;
     options.compaction_style = FLAGS_compaction_style_e;
     options.compaction_pri = FLAGS_compaction_pri_e;
     options.allow_mmap_reads = FLAGS_mmap_read;
@@ -4279,13 +4725,21 @@ class Benchmark {
     options.use_direct_reads = FLAGS_use_direct_reads;
     options.use_direct_io_for_flush_and_compaction =
         FLAGS_use_direct_io_for_flush_and_compaction;
+    options.background_writes_for_flush_and_compaction =
+        FLAGS_background_writes_for_flush_and_compaction;
+    options.use_direct_io_for_wal = FLAGS_use_direct_io_for_wal;
+    options.compaction_async_io = FLAGS_compaction_async_io;
     options.manual_wal_flush = FLAGS_manual_wal_flush;
     options.wal_compression = FLAGS_wal_compression_e;
+    options.wal_compression_pipeline_min_record_size = static_cast<size_t>(
+        FLAGS_wal_compression_pipeline_min_record_size);
     options.ttl = FLAGS_fifo_compaction_ttl;
     options.compaction_options_fifo = CompactionOptionsFIFO(
         FLAGS_fifo_compaction_max_table_files_size_mb * 1024 * 1024,
         FLAGS_fifo_compaction_allow_compaction);
     options.compaction_options_fifo.age_for_warm = FLAGS_fifo_age_for_warm;
+    options.compaction_options_fifo.time_window_seconds =
+        FLAGS_fifo_time_window_seconds;
     options.prefix_extractor = prefix_extractor_;
     if (FLAGS_use_uint64_comparator) {
       options.comparator = test::Uint64Comparator();
@@ -4307,7 +4761,11 @@ class Benchmark {
     }
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
+    options.open_table_files_in_background =
+        FLAGS_open_table_files_in_background;
+    options.max_wal_recovery_threads = FLAGS_wal_recovery_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.compaction_readahead_budget = FLAGS_compaction_readahead_budget;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
     options.use_fsync = FLAGS_use_fsync;
@@ -4404,6 +4862,9 @@ class Benchmark {
       } else if (FLAGS_index_with_first_key) {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
+      } else if (FLAGS_use_learned_index) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kLearnedIndexSearch;
       }
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
@@ -4471,6 +4932,11 @@ class Benchmark {
            {/*.charged = */ FLAGS_charge_blob_cache
                 ? CacheEntryRoleOptions::Decision::kEnabled
                 : CacheEntryRoleOptions::Decision::kDisabled}});
+      block_based_options.cache_usage_options.options_overrides.insert(
+          {CacheEntryRole::kCompactionBuffer,
+           {/*.charged = */ FLAGS_charge_compaction_buffer
+                ? CacheEntryRoleOptions::Decision::kEnabled
+                : CacheEntryRoleOptions::Decision::kDisabled}});
       block_based_options.block_size = FLAGS_block_size;
       block_based_options.block_restart_interval = FLAGS_block_restart_interval;
       block_based_options.index_block_restart_interval =
@@ -4481,6 +4947,12 @@ class Benchmark {
       block_based_options.enable_index_compression =
           FLAGS_enable_index_compression;
       block_based_options.block_align = FLAGS_block_align;
+      block_based_options.avoid_data_block_page_crossing =
+          FLAGS_avoid_data_block_page_crossing;
+      block_based_options.prefix_block_map = FLAGS_prefix_block_map;
+      block_based_options.compact_index_blocks = FLAGS_compact_index_blocks;
+      block_based_options.background_filter_build =
+          FLAGS_background_filter_build;
       block_based_options.whole_key_filtering = FLAGS_whole_key_filtering;
       block_based_options.max_auto_readahead_size =
           FLAGS_max_auto_readahead_size;
@@ -4500,13 +4972,29 @@ class Benchmark {
           prepopulate_block_cache =
               BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly;
           break;
+        case 2:
+          prepopulate_block_cache = BlockBasedTableOptions::
+              PrepopulateBlockCache::kFlushAndCompaction;
+          break;
         default:
           fprintf(stderr, "Unknown prepopulate block cache mode\n");
       }
       block_based_options.prepopulate_block_cache = prepopulate_block_cache;
+      block_based_options.prepopulate_block_cache_compaction_max_level =
+          FLAGS_prepopulate_block_cache_compaction_max_level;
+      block_based_options.prepopulate_block_cache_compaction_metadata_only =
+          FLAGS_prepopulate_block_cache_compaction_metadata_only;
+      block_based_options.prepopulate_block_cache_compaction_max_bytes =
+          FLAGS_prepopulate_block_cache_compaction_max_bytes;
+      block_based_options.prepopulate_block_cache_compaction_hot_ranges_only =
+          FLAGS_prepopulate_block_cache_compaction_hot_ranges_only;
       if (FLAGS_use_data_block_hash_index) {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+      } else if (FLAGS_use_data_block_key_prefixes) {
+        block_based_options.data_block_index_type =
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions::
+                kDataBlockBinarySearchWithKeyPrefixes;
       } else {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockBinarySearch;
@@ -4641,19 +5129,25 @@ class Benchmark {
     options.hard_pending_compaction_bytes_limit =
         FLAGS_hard_pending_compaction_bytes_limit;
     options.delayed_write_rate = FLAGS_delayed_write_rate;
+    options.adaptive_delayed_write_rate = FLAGS_adaptive_delayed_write_rate;
     options.allow_concurrent_memtable_write =
         FLAGS_allow_concurrent_memtable_write;
     options.experimental_mempurge_threshold =
         FLAGS_experimental_mempurge_threshold;
     options.inplace_update_support = FLAGS_inplace_update_support;
     options.inplace_update_num_locks = FLAGS_inplace_update_num_locks;
+    options.inplace_merge_support = FLAGS_inplace_merge_support;
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
+    options.enable_write_thread_per_core_queues =
+        FLAGS_enable_write_thread_per_core_queues;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
     options.unordered_write = FLAGS_unordered_write;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.table_cache_numshardbits = FLAGS_table_cache_numshardbits;
+    options.table_cache_use_hyper_clock_cache =
+        FLAGS_table_cache_use_hyper_clock_cache;
     options.max_compaction_bytes = FLAGS_max_compaction_bytes;
     options.disable_auto_compactions = FLAGS_disable_auto_compactions;
     options.optimize_filters_for_hits = FLAGS_optimize_filters_for_hits;
@@ -4708,6 +5202,8 @@ class Benchmark {
         FLAGS_universal_allow_trivial_move;
     options.compaction_options_universal.incremental =
         FLAGS_universal_incremental;
+    options.compaction_options_universal.incremental_avoid_full_compaction =
+        FLAGS_universal_incremental_avoid_full_compaction;
     options.compaction_options_universal.stop_style =
         static_cast<CompactionStopStyle>(FLAGS_universal_stop_style);
     if (FLAGS_thread_status_per_interval > 0) {
@@ -4730,6 +5226,7 @@ class Benchmark {
     // Integrated BlobDB
     options.enable_blob_files = FLAGS_enable_blob_files;
     options.min_blob_size = FLAGS_min_blob_size;
+    options.blob_separation_percent = FLAGS_blob_separation_percent;
     options.blob_file_size = FLAGS_blob_file_size;
     options.blob_compression_type =
         StringToCompressionType(FLAGS_blob_compression_type.c_str());
@@ -4739,6 +5236,8 @@ class Benchmark {
         FLAGS_blob_garbage_collection_age_cutoff;
     options.blob_garbage_collection_force_threshold =
         FLAGS_blob_garbage_collection_force_threshold;
+    options.blob_garbage_collection_file_threshold =
+        FLAGS_blob_garbage_collection_file_threshold;
     options.blob_compaction_readahead_size =
         FLAGS_blob_compaction_readahead_size;
     options.blob_file_starting_level = FLAGS_blob_file_starting_level;
@@ -4754,6 +5253,8 @@ class Benchmark {
     }
     options.memtable_protection_bytes_per_key =
         FLAGS_memtable_protection_bytes_per_key;
+    options.memtable_protection_verify_one_in =
+        FLAGS_memtable_protection_verify_one_in;
     options.block_protection_bytes_per_key =
         FLAGS_block_protection_bytes_per_key;
     options.paranoid_memory_checks = FLAGS_paranoid_memory_checks;
@@ -4845,6 +5346,7 @@ class Benchmark {
     }
 
     options.listeners.emplace_back(listener_);
+    options.listeners.emplace_back(compaction_count_listener_);
 
     if (options.file_checksum_gen_factory == nullptr) {
       if (FLAGS_file_checksum) {
@@ -5903,6 +6405,7 @@ class Benchmark {
 
     options.adaptive_readahead = FLAGS_adaptive_readahead;
     options.async_io = FLAGS_async_io;
+    options.async_readahead_num_buffers = FLAGS_async_readahead_num_buffers;
     options.auto_readahead_size = FLAGS_auto_readahead_size;
     std::unique_ptr<ManagedSnapshot> snapshot = nullptr;
     if (FLAGS_explicit_snapshot) {
@@ -7046,6 +7549,213 @@ class Benchmark {
     }
   }
 
+  // Thread 0 keeps writing to drive compactions, and samples the data block
+  // cache hit rate and the p99 latency of the reads once per second. The other
+  // threads do zipfian random reads. The post-compaction warmup is disabled
+  // during the first half of --duration and enabled during the second one.
+  // For each half, the time the hit rate takes to recover after a compaction
+  // is reported.
+  void CompactionWarmup(ThreadState* thread) {
+    if (thread->tid > 0) {
+      CompactionWarmupReader(thread);
+    } else {
+      CompactionWarmupController(thread);
+    }
+  }
+
+  void CompactionWarmupReader(ThreadState* thread) {
+    int64_t read = 0;
+    int64_t found = 0;
+    DB* db = db_.db;
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    PinnableSlice value;
+    while (!compaction_warmup_done_.load(std::memory_order_relaxed)) {
+      uint64_t key_rand;
+      if (compaction_warmup_keys_) {
+        // Spread the popular keys over the key space, as GetRandomKey() does.
+        const uint64_t kBigPrime = 0x5bd1e995;
+        key_rand =
+            (compaction_warmup_keys_->Next(&thread->rand) * kBigPrime) %
+            FLAGS_num;
+      } else {
+        key_rand = thread->rand.Next() % FLAGS_num;
+      }
+      GenerateKeyFromInt(key_rand, FLAGS_num, &key);
+      value.Reset();
+      const uint64_t start = FLAGS_env->NowMicros();
+      Status s = db->Get(read_options_, db->DefaultColumnFamily(), key, &value);
+      compaction_warmup_get_micros_.Add(FLAGS_env->NowMicros() - start);
+      if (s.ok()) {
+        found++;
+      } else if (!s.IsNotFound()) {
+        fprintf(stderr, "Get returned an error: %s\n", s.ToString().c_str());
+        abort();
+      }
+      read++;
+      thread->stats.FinishedOps(&db_, db, 1, kRead);
+    }
+
+    char msg[100];
+    snprintf(msg, sizeof(msg), "(%" PRIu64 " of %" PRIu64 " found)\n", found,
+             read);
+    thread->stats.AddMessage(msg);
+  }
+
+  void CompactionWarmupController(ThreadState* thread) {
+    // Don't merge stats from this thread with the readers.
+    thread->stats.SetExcludeFromMerge();
+    DB* db = db_.db;
+    RandomGenerator gen;
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    std::unique_ptr<RateLimiter> write_rate_limiter;
+    if (FLAGS_benchmark_write_rate_limit > 0) {
+      write_rate_limiter.reset(
+          NewGenericRateLimiter(FLAGS_benchmark_write_rate_limit));
+    }
+    const uint64_t phase_micros =
+        static_cast<uint64_t>(FLAGS_duration) * kMicrosInSecond / 2;
+    // Intervals whose average hit rate a compaction has to recover to.
+    const size_t kBaselineIntervals = 5;
+
+    for (bool warmup : {false, true}) {
+      std::string policy = "{mode=";
+      policy += !warmup ? "kDisabled"
+                : FLAGS_compaction_warmup_mode == 2 ? "kHotKeyRanges"
+                                                    : "kOutputFiles";
+      policy += ";max_output_level=" +
+                std::to_string(FLAGS_compaction_warmup_max_output_level) +
+                ";max_bytes_per_compaction=" +
+                std::to_string(FLAGS_compaction_warmup_max_bytes) +
+                ";stop_at_cache_capacity=" +
+                (FLAGS_compaction_warmup_stop_at_cache_capacity ? "true"
+                                                                : "false") +
+                ";warm_index_and_filter_partitions=" +
+                (FLAGS_compaction_warmup_index_and_filter_partitions
+                     ? "true"
+                     : "false") +
+                ";secondary_cache_min_output_level=" +
+                std::to_string(
+                    FLAGS_compaction_warmup_secondary_cache_min_output_level) +
+                "}";
+      Status s = db->SetOptions({{"compaction_warmup_policy", policy}});
+      if (!s.ok()) {
+        fprintf(stderr, "SetOptions error: %s\n", s.ToString().c_str());
+        ErrorExit();
+      }
+      const char* phase = warmup ? "on" : "off";
+
+      // A compaction that completed in the interval ending at `secs`, and the
+      // hit rate before it.
+      struct PendingCompaction {
+        uint64_t secs;
+        double baseline_hit_rate;
+      };
+      std::vector<PendingCompaction> pending;
+      std::vector<uint64_t> recovery_secs;
+      std::deque<double> recent_hit_rates;
+      uint64_t num_compactions = 0;
+      uint64_t num_intervals = 0;
+      double sum_hit_rate = 0;
+      double sum_p99_micros = 0;
+
+      uint64_t prev_hits = dbstats->getTickerCount(BLOCK_CACHE_DATA_HIT);
+      uint64_t prev_misses = dbstats->getTickerCount(BLOCK_CACHE_DATA_MISS);
+      uint64_t prev_compactions = compaction_count_listener_->num_completed();
+      compaction_warmup_get_micros_.Clear();
+      const uint64_t phase_start = FLAGS_env->NowMicros();
+      uint64_t next_sample = phase_start + kMicrosInSecond;
+      uint64_t now = phase_start;
+      while (now < phase_start + phase_micros) {
+        GenerateKeyFromInt(thread->rand.Next() % FLAGS_num, FLAGS_num, &key);
+        Slice val = gen.Generate();
+        s = db->Put(write_options_, key, val);
+        if (!s.ok()) {
+          fprintf(stderr, "put error: %s\n", s.ToString().c_str());
+          ErrorExit();
+        }
+        thread->stats.FinishedOps(&db_, db, 1, kWrite);
+        if (write_rate_limiter) {
+          write_rate_limiter->Request(key.size() + val.size(), Env::IO_HIGH,
+                                      nullptr /* stats */,
+                                      RateLimiter::OpType::kWrite);
+        }
+
+        now = FLAGS_env->NowMicros();
+        if (now < next_sample) {
+          continue;
+        }
+        next_sample += kMicrosInSecond;
+        const uint64_t secs = (now - phase_start) / kMicrosInSecond;
+        const uint64_t hits = dbstats->getTickerCount(BLOCK_CACHE_DATA_HIT);
+        const uint64_t misses = dbstats->getTickerCount(BLOCK_CACHE_DATA_MISS);
+        const uint64_t lookups = (hits - prev_hits) + (misses - prev_misses);
+        const double hit_rate =
+            lookups == 0 ? 1.0
+                         : static_cast<double>(hits - prev_hits) / lookups;
+        const double p99_micros = compaction_warmup_get_micros_.Percentile(99);
+        compaction_warmup_get_micros_.Clear();
+        const uint64_t compactions =
+            compaction_count_listener_->num_completed();
+        prev_hits = hits;
+        prev_misses = misses;
+
+        for (auto it = pending.begin(); it != pending.end();) {
+          if (hit_rate >= it->baseline_hit_rate *
+                              FLAGS_compaction_warmup_recovery_ratio) {
+            recovery_secs.push_back(secs - it->secs);
+            it = pending.erase(it);
+          } else {
+            ++it;
+          }
+        }
+        if (compactions > prev_compactions && !recent_hit_rates.empty()) {
+          double baseline = 0;
+          for (double r : recent_hit_rates) {
+            baseline += r;
+          }
+          pending.push_back({secs, baseline / recent_hit_rates.size()});
+        }
+        num_compactions += compactions - prev_compactions;
+        prev_compactions = compactions;
+        recent_hit_rates.push_back(hit_rate);
+        if (recent_hit_rates.size() > kBaselineIntervals) {
+          recent_hit_rates.pop_front();
+        }
+        num_intervals++;
+        sum_hit_rate += hit_rate;
+        sum_p99_micros += p99_micros;
+        fprintf(stdout,
+                "compactionwarmup warmup=%s secs=%" PRIu64
+                " hit_rate=%.4f p99_get_micros=%.1f compactions=%" PRIu64 "\n",
+                phase, secs, hit_rate, p99_micros, num_compactions);
+      }
+
+      std::sort(recovery_secs.begin(), recovery_secs.end());
+      double mean_recovery_secs = 0;
+      for (uint64_t r : recovery_secs) {
+        mean_recovery_secs += static_cast<double>(r);
+      }
+      if (!recovery_secs.empty()) {
+        mean_recovery_secs /= recovery_secs.size();
+      }
+      fprintf(stdout,
+              "compactionwarmup warmup=%s: %" PRIu64
+              " compactions, average hit rate %.4f, average p99 Get %.1f "
+              "micros, hit rate recovered %" ROCKSDB_PRIszt
+              " times in %.1f s on average (p50 %" PRIu64 " s, max %" PRIu64
+              " s), not recovered %" ROCKSDB_PRIszt " times\n",
+              phase, num_compactions,
+              num_intervals == 0 ? 0.0 : sum_hit_rate / num_intervals,
+              num_intervals == 0 ? 0.0 : sum_p99_micros / num_intervals,
+              recovery_secs.size(), mean_recovery_secs,
+              recovery_secs.empty() ? 0 : recovery_secs[recovery_secs.size() / 2],
+              recovery_secs.empty() ? 0 : recovery_secs.back(), pending.size());
+    }
+    compaction_warmup_done_.store(true, std::memory_order_relaxed);
+  }
+
   void BGWriter(ThreadState* thread, enum OperationType write_merge) {
     // Special thread that keeps writing until other threads are done.
     RandomGenerator gen;
@@ -8022,6 +8732,16 @@ class Benchmark {
     RandomTransactionInserter inserter(&thread->rand, write_options_,
                                        read_options_, FLAGS_num,
                                        num_prefix_ranges);
+    if (FLAGS_transaction_zipf_theta < 0 || FLAGS_transaction_zipf_theta >= 1) {
+      fprintf(stderr, "--transaction_zipf_theta must be in [0, 1)\n");
+      abort();
+    }
+    std::unique_ptr<ZipfianGenerator> zipf_keys;
+    if (FLAGS_transaction_zipf_theta > 0) {
+      zipf_keys.reset(
+          new ZipfianGenerator(FLAGS_num, FLAGS_transaction_zipf_theta));
+      inserter.SetKeyPicker([&]() { return zipf_keys->Next(&thread->rand); });
+    }
 
     if (FLAGS_num_multi_db > 1) {
       fprintf(stderr,
@@ -8605,14 +9325,56 @@ class Benchmark {
       fprintf(stderr, "Prepare for replay failed. Error: %s\n",
               s.ToString().c_str());
     }
-    s = replayer->Replay(
-        ReplayOptions(static_cast<uint32_t>(FLAGS_trace_replay_threads),
-                      FLAGS_trace_replay_fast_forward),
-        nullptr);
+    ReplayOptions replay_options(
+        static_cast<uint32_t>(FLAGS_trace_replay_threads),
+        FLAGS_trace_replay_fast_forward);
+    replay_options.preserve_key_order = FLAGS_trace_replay_preserve_key_order;
+    // With --histogram, the latencies of the replayed records by trace type
+    std::mutex latency_hists_mutex;
+    std::map<TraceType, HistogramImpl> latency_hists;
+    std::function<void(Status, std::unique_ptr<TraceRecordResult>&&)>
+        result_cb = nullptr;
+    if (FLAGS_histogram) {
+      result_cb = [&](Status exec_s,
+                      std::unique_ptr<TraceRecordResult>&& result) {
+        // All the results of the execution handler have latencies
+        auto timed_result = static_cast<TraceExecutionResult*>(result.get());
+        if (exec_s.ok() && timed_result != nullptr) {
+          std::lock_guard<std::mutex> lock(latency_hists_mutex);
+          latency_hists[timed_result->GetTraceType()].Add(
+              timed_result->GetLatency());
+        }
+      };
+    }
+    s = replayer->Replay(replay_options, result_cb);
     replayer.reset();
     if (s.ok()) {
       fprintf(stdout, "Replay completed from trace_file: %s\n",
               FLAGS_trace_file.c_str());
+      for (const auto& type_and_hist : latency_hists) {
+        const char* name = "Other";
+        switch (type_and_hist.first) {
+          case kTraceWrite:
+            name = "Write";
+            break;
+          case kTraceGet:
+            name = "Get";
+            break;
+          case kTraceIteratorSeek:
+            name = "IteratorSeek";
+            break;
+          case kTraceIteratorSeekForPrev:
+            name = "IteratorSeekForPrev";
+            break;
+          case kTraceMultiGet:
+            name = "MultiGet";
+            break;
+          default:
+            break;
+        }
+        fprintf(stdout, "Microseconds per %s:\n%s\n", name,
+                type_and_hist.second.ToString().c_str());
+      }
     } else {
       fprintf(stderr, "Replay failed. Error: %s\n", s.ToString().c_str());
     }
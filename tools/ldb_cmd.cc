@@ -6,6 +6,7 @@
 //
 #include "rocksdb/utilities/ldb_cmd.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdlib>
 #include <ctime>
@@ -32,6 +33,7 @@
 #include "rocksdb/file_checksum.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/options.h"
+#include "rocksdb/system_clock.h"
 #include "rocksdb/table_properties.h"
 #include "rocksdb/utilities/backup_engine.h"
 #include "rocksdb/utilities/checkpoint.h"
@@ -4338,16 +4340,30 @@ void DBQuerierCommand::DoCommand() {
 
 // ----------------------------------------------------------------------------
 
+const std::string CheckConsistencyCommand::ARG_VERIFY_THREADS =
+    "verify_threads";
+
 CheckConsistencyCommand::CheckConsistencyCommand(
     const std::vector<std::string>& /*params*/,
     const std::map<std::string, std::string>& options,
     const std::vector<std::string>& flags)
     : LDBCommand(options, flags, true /* is_read_only */,
-                 BuildCmdLineOptions({})) {}
+                 BuildCmdLineOptions({ARG_VERIFY_THREADS})) {
+  if (ParseIntOption(options, ARG_VERIFY_THREADS, verify_threads_,
+                     exec_state_) &&
+      verify_threads_ <= 0) {
+    exec_state_ = LDBCommandExecuteResult::Failed(ARG_VERIFY_THREADS +
+                                                  " must be positive.");
+  }
+}
 
 void CheckConsistencyCommand::Help(std::string& ret) {
   ret.append("  ");
   ret.append(CheckConsistencyCommand::Name());
+  ret.append(" [--" + ARG_VERIFY_THREADS + "=<N>]");
+  ret.append(
+      " : with --verify_threads, also verify the block checksums of N table "
+      "files at a time");
   ret.append("\n");
 }
 
@@ -4355,6 +4371,27 @@ void CheckConsistencyCommand::DoCommand() {
   options_.paranoid_checks = true;
   options_.num_levels = 64;
   OpenDB();
+  if (db_ != nullptr && verify_threads_ > 0) {
+    uint64_t live_sst_size = 0;
+    db_->GetAggregatedIntProperty(DB::Properties::kLiveSstFilesSize,
+                                  &live_sst_size);
+    ReadOptions read_options;
+    read_options.readahead_size = 2 << 20;
+    read_options.async_io = true;
+    SystemClock* clock = options_.env->GetSystemClock().get();
+    const uint64_t start_micros = clock->NowMicros();
+    Status s = db_->VerifyChecksum(read_options, verify_threads_);
+    const double seconds =
+        std::max(clock->NowMicros() - start_micros, uint64_t{1}) / 1000000.0;
+    if (s.ok()) {
+      fprintf(stdout,
+              "Verified %" PRIu64 " bytes of table files in %.3f seconds, "
+              "%.1f MB/s\n",
+              live_sst_size, seconds, live_sst_size / 1048576.0 / seconds);
+    } else {
+      exec_state_ = LDBCommandExecuteResult::Failed(s.ToString());
+    }
+  }
   if (exec_state_.IsSucceed() || exec_state_.IsNotStarted()) {
     fprintf(stdout, "OK\n");
   }
@@ -639,6 +639,12 @@ class CheckConsistencyCommand : public LDBCommand {
   bool NoDBOpen() override { return true; }
 
   static void Help(std::string& ret);
+
+ private:
+  // Number of files whose block checksums are verified at a time, if any
+  int verify_threads_ = 0;
+
+  static const std::string ARG_VERIFY_THREADS;
 };
 
 class CheckPointCommand : public LDBCommand {
@@ -0,0 +1,80 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Serves the compaction job queue of a RemoteCompactionService. The DBs of
+// the jobs must use the built-in comparator and table factory; DBs that need
+// other objects, like a merge operator or a compaction filter, need a worker
+// built with them, passing them to RemoteCompactionWorker through
+// CompactionServiceOptionsOverride.
+
+#include <cstdio>
+
+#ifndef GFLAGS
+int main() {
+  fprintf(stderr, "Please install gflags to run rocksdb tools\n");
+  return 1;
+}
+#else
+
+#include <atomic>
+#include <csignal>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+#include "rocksdb/utilities/remote_compaction_service.h"
+#include "util/gflags_compat.h"
+
+using GFLAGS_NAMESPACE::ParseCommandLineFlags;
+using GFLAGS_NAMESPACE::SetUsageMessage;
+
+DEFINE_string(queue_dir, "", "Job queue directory of the compaction service");
+DEFINE_int32(num_workers, 1, "Number of jobs to run at the same time");
+DEFINE_uint64(poll_interval_micros, 100 * 1000,
+              "How often to look for new jobs when the queue is empty");
+
+namespace {
+std::atomic<bool> stop{false};
+
+void HandleSignal(int /*signal*/) { stop.store(true); }
+}  // namespace
+
+int main(int argc, char** argv) {
+  SetUsageMessage(std::string("\nUSAGE:\n") + std::string(argv[0]) +
+                  " --queue_dir=<dir> [OPTIONS]...");
+  ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_queue_dir.empty() || FLAGS_num_workers < 1) {
+    fprintf(stderr, "--queue_dir and a positive --num_workers are required\n");
+    return 1;
+  }
+
+  ROCKSDB_NAMESPACE::RemoteCompactionServiceOptions options;
+  options.queue_dir = FLAGS_queue_dir;
+  options.poll_interval_micros = FLAGS_poll_interval_micros;
+  ROCKSDB_NAMESPACE::CompactionServiceOptionsOverride options_override;
+  options_override.table_factory.reset(
+      ROCKSDB_NAMESPACE::NewBlockBasedTableFactory());
+
+  // Jobs being run on exit are reported as failed, to be scheduled again
+  std::signal(SIGINT, HandleSignal);
+  std::signal(SIGTERM, HandleSignal);
+
+  std::vector<ROCKSDB_NAMESPACE::port::Thread> threads;
+  for (int i = 0; i < FLAGS_num_workers; i++) {
+    threads.emplace_back([&]() {
+      ROCKSDB_NAMESPACE::RemoteCompactionWorker(options, options_override)
+          .Run(&stop);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return 0;
+}
+
+#endif  // GFLAGS
@@ -397,6 +397,39 @@ TEST_F(SSTDumpToolTest, ReadaheadSize) {
   }
 }
 
+TEST_F(SSTDumpToolTest, ParallelVerify) {
+  Options opts;
+  opts.env = env();
+  std::string dir = MakeFilePath("parallel_verify");
+  ASSERT_OK(opts.env->CreateDirIfMissing(dir));
+  std::vector<std::string> file_paths = {dir + "/rocksdb_sst_test1.sst",
+                                         dir + "/rocksdb_sst_test2.sst"};
+  for (const auto& file_path : file_paths) {
+    createSST(opts, file_path);
+  }
+
+  char* usage[5];
+  PopulateCommandArgs(dir, "--command=verify", usage);
+  snprintf(usage[3], kOptLength, "--verify_threads=2");
+  snprintf(usage[4], kOptLength, "--async_io");
+
+  SSTDumpTool tool;
+  // With and without async_io
+  ASSERT_TRUE(!tool.Run(5, usage, opts));
+  ASSERT_TRUE(!tool.Run(4, usage, opts));
+
+  snprintf(usage[3], kOptLength, "--verify_threads=0");
+  ASSERT_TRUE(tool.Run(4, usage, opts));
+
+  for (const auto& file_path : file_paths) {
+    cleanup(opts, file_path);
+  }
+  ASSERT_OK(opts.env->DeleteDir(dir));
+  for (int i = 0; i < 5; i++) {
+    delete[] usage[i];
+  }
+}
+
 TEST_F(SSTDumpToolTest, NoSstFile) {
   Options opts;
   opts.env = env();
@@ -6,12 +6,16 @@
 
 #include "rocksdb/sst_dump_tool.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <iostream>
+#include <mutex>
 
 #include "options/options_helper.h"
 #include "port/port.h"
 #include "rocksdb/convenience.h"
+#include "rocksdb/system_clock.h"
 #include "rocksdb/utilities/ldb_cmd.h"
 #include "table/sst_file_dumper.h"
 
@@ -86,6 +90,18 @@ void print_help(bool to_stderr) {
     --verify_checksum
       Verify file checksum when executing check|scan
 
+    --verify_threads=<num>
+      Number of files verified at a time when executing verify. With more than
+      one thread, the progress and the throughput of the verification are
+      reported
+
+    --async_io
+      Read the rest of the readahead of a file asynchronously while its blocks
+      read before are verified when executing verify
+
+    --readahead_size=<num>
+      Readahead size in bytes of the files when executing check|scan|verify
+
     --input_key_hex
       Can be combined with --from and --to to indicate that these values are encoded in Hex
 
@@ -148,6 +164,81 @@ bool ParseIntArg(const char* arg, const std::string arg_name,
   }
   return false;
 }
+
+// Verifies the block checksums of the SST files `filenames` with
+// `num_threads` threads, each verifying one file at a time, and prints the
+// progress at most every second and the throughput of the verification.
+// Adds the valid SST files to `valid_sst_files`.
+void VerifyFilesInParallel(const Options& options,
+                           const std::vector<std::string>& filenames,
+                           size_t readahead_size, bool async_io,
+                           int num_threads,
+                           std::vector<std::string>* valid_sst_files) {
+  SystemClock* clock = options.env->GetSystemClock().get();
+  const uint64_t start_micros = clock->NowMicros();
+  std::atomic<size_t> next_file{0};
+  // Protects the outputs and the progress below
+  std::mutex mutex;
+  size_t num_verified = 0;
+  uint64_t bytes_verified = 0;
+  uint64_t last_report_micros = start_micros;
+  auto verify_files = [&]() {
+    for (size_t i = next_file.fetch_add(1); i < filenames.size();
+         i = next_file.fetch_add(1)) {
+      const std::string& filename = filenames[i];
+      SstFileDumper dumper(options, filename, Temperature::kUnknown,
+                           readahead_size, true /* verify_checksum */,
+                           false /* output_hex */,
+                           false /* decode_blob_index */);
+      Status s = dumper.getStatus();
+      uint64_t file_size = 0;
+      if (s.ok()) {
+        s = dumper.VerifyChecksum(async_io);
+        options.env->GetFileSize(filename, &file_size).PermitUncheckedError();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!dumper.getStatus().ok()) {
+        // Not a valid SST
+        fprintf(stderr, "%s: %s\n", filename.c_str(), s.ToString().c_str());
+        continue;
+      }
+      valid_sst_files->push_back(filename);
+      if (!s.ok()) {
+        fprintf(stderr, "%s is corrupted: %s\n", filename.c_str(),
+                s.ToString().c_str());
+      } else {
+        fprintf(stdout, "%s is ok\n", filename.c_str());
+      }
+      num_verified++;
+      bytes_verified += file_size;
+      const uint64_t now_micros = clock->NowMicros();
+      if (now_micros - last_report_micros >= 1000000) {
+        last_report_micros = now_micros;
+        fprintf(stdout, "Verified %zu of %zu files, %.1f MB/s\n",
+                num_verified, filenames.size(),
+                bytes_verified / 1048576.0 /
+                    ((now_micros - start_micros) / 1000000.0));
+      }
+    }
+  };
+
+  const int max_threads =
+      std::min(num_threads, static_cast<int>(filenames.size()));
+  std::vector<port::Thread> threads;
+  for (int i = 1; i < max_threads; i++) {
+    threads.emplace_back(verify_files);
+  }
+  verify_files();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double seconds =
+      std::max(clock->NowMicros() - start_micros, uint64_t{1}) / 1000000.0;
+  fprintf(stdout,
+          "Verified %zu files, %" PRIu64 " bytes in %.3f seconds, %.1f MB/s\n",
+          num_verified, bytes_verified, seconds,
+          bytes_verified / 1048576.0 / seconds);
+}
 }  // namespace
 
 int SSTDumpTool::Run(int argc, char const* const* argv, Options options) {
@@ -159,6 +250,8 @@ int SSTDumpTool::Run(int argc, char const* const* argv, Options options) {
   char junk;
   uint64_t n;
   bool verify_checksum = false;
+  int verify_threads = 1;
+  bool async_io = false;
   bool output_hex = false;
   bool decode_blob_index = false;
   bool input_key_hex = false;
@@ -215,6 +308,16 @@ int SSTDumpTool::Run(int argc, char const* const* argv, Options options) {
       read_num = n;
     } else if (strcmp(argv[i], "--verify_checksum") == 0) {
       verify_checksum = true;
+    } else if (ParseIntArg(argv[i], "--verify_threads=",
+                           "verify_threads must be numeric", &tmp_val)) {
+      if (tmp_val < 1) {
+        fprintf(stderr, "verify_threads must be positive: '%s'\n", argv[i]);
+        print_help(/*to_stderr*/ true);
+        return 1;
+      }
+      verify_threads = static_cast<int>(tmp_val);
+    } else if (strcmp(argv[i], "--async_io") == 0) {
+      async_io = true;
     } else if (strncmp(argv[i], "--command=", 10) == 0) {
       command = argv[i] + 10;
     } else if (strncmp(argv[i], "--from=", 7) == 0) {
@@ -409,6 +512,20 @@ int SSTDumpTool::Run(int argc, char const* const* argv, Options options) {
   uint64_t total_read = 0;
   // List of RocksDB SST file without corruption
   std::vector<std::string> valid_sst_files;
+  if (command == "verify" && verify_threads > 1) {
+    std::vector<std::string> sst_files;
+    for (const auto& filename : filenames) {
+      if (filename.length() > 4 &&
+          filename.rfind(".sst") == filename.length() - 4) {
+        sst_files.push_back(dir ? std::string(dir_or_file) + "/" + filename
+                                : filename);
+      }
+    }
+    VerifyFilesInParallel(options, sst_files, readahead_size, async_io,
+                          verify_threads, &valid_sst_files);
+    // The files are verified
+    filenames.clear();
+  }
   for (size_t i = 0; i < filenames.size(); i++) {
     std::string filename = filenames.at(i);
     if (filename.length() <= 4 ||
@@ -491,7 +608,7 @@ int SSTDumpTool::Run(int argc, char const* const* argv, Options options) {
     }
 
     if (command == "verify") {
-      st = dumper.VerifyChecksum();
+      st = dumper.VerifyChecksum(async_io);
       if (!st.ok()) {
         fprintf(stderr, "%s is corrupted: %s\n", filename.c_str(),
                 st.ToString().c_str());
@@ -912,6 +912,30 @@ TEST_F(TraceAnalyzerTest, MultiGet) {
   */
 }
 
+// Test fitting the mix_graph workload of db_bench
+TEST_F(TraceAnalyzerTest, MixgraphConfig) {
+  std::string trace_path = test_path_ + "/trace";
+  std::string output_path = test_path_ + "/mixgraph";
+  std::string file_path;
+  std::vector<std::string> paras = {
+      "-analyze_get=true",           "-analyze_put=true",
+      "-analyze_delete=false",       "-analyze_single_delete=false",
+      "-analyze_range_delete=false", "-analyze_iterator=true",
+      "-analyze_multiget=false",     "-output_mixgraph_config"};
+  paras.push_back("-output_dir=" + output_path);
+  paras.push_back("-trace_path=" + trace_path);
+  paras.push_back("-key_space_dir=" + test_path_);
+  AnalyzeTrace(paras, output_path, trace_path);
+
+  // Two Gets, one Put, one Seek and one SeekForPrev of the keys "a", "b" and
+  // "g", with 3 accesses of "a"
+  std::vector<std::string> config = {
+      "-mix_get_ratio=0.4", "-mix_put_ratio=0.2", "-mix_seek_ratio=0.4",
+      "-num=3", "-key_size=1"};
+  file_path = output_path + "/test-mixgraph_config.txt";
+  CheckFileContent(config, file_path, true);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
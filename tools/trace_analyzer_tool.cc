@@ -163,6 +163,15 @@ DEFINE_int32(value_interval, 8,
 DEFINE_double(sample_ratio, 1.0,
               "If the trace size is extremely huge or user want to sample "
               "the trace when analyzing, sample ratio can be set (0, 1.0]");
+DEFINE_bool(output_mixgraph_config, false,
+            "Fit the mix_graph workload of db_bench to the analyzed Get, Put "
+            "and Seek queries: the query ratios, the key and key-range "
+            "hotness, the value size distribution and the QPS periodicity.\n"
+            "File name: <prefix>-mixgraph_config.txt, to be used as "
+            "db_bench -benchmarks=mixgraph -flagfile=<the file>");
+DEFINE_int32(mixgraph_keyrange_num, 1,
+             "The number of key ranges of the fitted mix_graph workload. With "
+             "more than one, the key-range hotness is fitted as well.");
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -202,6 +211,27 @@ uint64_t MultiplyCheckOverflow(uint64_t op1, uint64_t op2) {
   return (op1 * op2);
 }
 
+// Fits y = slope * x + intercept to the points by least squares. Returns false
+// if there are not enough points.
+bool FitLine(const std::vector<std::pair<double, double>>& points,
+             double* slope, double* intercept) {
+  const double n = static_cast<double>(points.size());
+  double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+  for (const auto& point : points) {
+    sum_x += point.first;
+    sum_y += point.second;
+    sum_xx += point.first * point.first;
+    sum_xy += point.first * point.second;
+  }
+  const double denominator = n * sum_xx - sum_x * sum_x;
+  if (points.size() < 2 || denominator <= 0) {
+    return false;
+  }
+  *slope = (n * sum_xy - sum_x * sum_y) / denominator;
+  *intercept = (sum_y - *slope * sum_x) / n;
+  return true;
+}
+
 }  // namespace
 
 // The default constructor of AnalyzerOptions
@@ -1158,6 +1188,9 @@ Status TraceAnalyzer::EndProcessing() {
   if (trace_sequence_f_) {
     s = trace_sequence_f_->Close();
   }
+  if (s.ok() && FLAGS_output_mixgraph_config) {
+    s = OutputMixgraphConfig();
+  }
   if (FLAGS_no_print) {
     return s;
   }
@@ -1168,6 +1201,246 @@ Status TraceAnalyzer::EndProcessing() {
   return s;
 }
 
+// Fit the parameters of the mix_graph workload of db_bench to the analyzed
+// Get, Put and Seek queries, and output them as db_bench flags
+Status TraceAnalyzer::OutputMixgraphConfig() {
+  // The queries of mix_graph and the accesses of each key by them
+  uint64_t get_count = 0;
+  uint64_t put_count = 0;
+  uint64_t seek_count = 0;
+  uint64_t key_size_sum = 0;
+  std::map<std::string, uint64_t> key_access;
+  std::map<uint32_t, uint64_t> qps;
+  for (int type = 0; type < kTaTypeNum; type++) {
+    uint64_t* count;
+    if (type == kGet || type == kMultiGet) {
+      count = &get_count;
+    } else if (type == kPut) {
+      count = &put_count;
+    } else if (type == kIteratorSeek || type == kIteratorSeekForPrev) {
+      count = &seek_count;
+    } else {
+      continue;
+    }
+    if (!ta_[type].enabled) {
+      continue;
+    }
+    for (auto& stat : ta_[type].stats) {
+      *count += stat.second.a_count;
+      key_size_sum += stat.second.a_key_size_sum;
+      for (auto& record : stat.second.a_key_stats) {
+        key_access[record.first] += record.second.access_count;
+      }
+      for (auto& record : stat.second.a_qps_stats) {
+        qps[record.first] += record.second;
+      }
+    }
+  }
+  const uint64_t total_count = get_count + put_count + seek_count;
+  if (total_count == 0) {
+    fprintf(stderr, "No Get, Put or Seek is analyzed to fit mix_graph to\n");
+    return Status::OK();
+  }
+
+  // Key-range and key hotness. The accessed keys are split into key ranges
+  // of consecutive keys. The key hotness f(x)=a*x^b is the fraction of the
+  // accesses to a key range that go to its x hottest keys, and the key-range
+  // hotness f(x)=a*exp(b*x)+c*exp(d*x) is the fraction of all the accesses
+  // that go to the x-th hottest key range.
+  const size_t keyrange_num = std::max<size_t>(
+      1, std::min<size_t>(FLAGS_mixgraph_keyrange_num, key_access.size()));
+  const size_t keyrange_size =
+      (key_access.size() + keyrange_num - 1) / keyrange_num;
+  std::vector<double> keyrange_access;
+  std::vector<std::pair<double, double>> key_points;
+  std::vector<uint64_t> counts;
+  for (auto it = key_access.begin(); it != key_access.end();) {
+    counts.clear();
+    uint64_t keyrange_count = 0;
+    for (size_t i = 0; i < keyrange_size && it != key_access.end();
+         i++, ++it) {
+      counts.push_back(it->second);
+      keyrange_count += it->second;
+    }
+    std::sort(counts.begin(), counts.end(), std::greater<uint64_t>());
+    keyrange_access.push_back(static_cast<double>(keyrange_count) /
+                              static_cast<double>(total_count));
+    // Sample the ranks geometrically to weigh the hot and the cold keys alike
+    uint64_t cumulative_count = 0;
+    size_t next_rank = 1;
+    for (size_t rank = 1; rank <= counts.size(); rank++) {
+      cumulative_count += counts[rank - 1];
+      if (rank == next_rank || rank == counts.size()) {
+        key_points.emplace_back(std::log(static_cast<double>(rank)),
+                                std::log(static_cast<double>(cumulative_count) /
+                                         static_cast<double>(keyrange_count)));
+        next_rank *= 2;
+      }
+    }
+  }
+  double key_dist_a = 0, key_dist_b = 0, log_a = 0;
+  if (!FitLine(key_points, &key_dist_b, &log_a) || key_dist_b <= 0) {
+    // The accesses are uniform
+    key_dist_b = 0;
+  } else {
+    key_dist_a = std::exp(log_a);
+  }
+
+  // Fit the cold key ranges with the second term first, then the hot key
+  // ranges with the first term on what is left
+  double keyrange_dist[4] = {0, 0, 0, 0};
+  std::sort(keyrange_access.begin(), keyrange_access.end(),
+            std::greater<double>());
+  const size_t num_keyranges = keyrange_access.size();
+  std::vector<std::pair<double, double>> keyrange_points;
+  for (size_t rank = num_keyranges / 2 + 1; rank <= num_keyranges; rank++) {
+    if (keyrange_access[rank - 1] > 0) {
+      keyrange_points.emplace_back(static_cast<double>(rank),
+                                   std::log(keyrange_access[rank - 1]));
+    }
+  }
+  if (FitLine(keyrange_points, &keyrange_dist[3], &log_a)) {
+    keyrange_dist[2] = std::exp(log_a);
+  }
+  keyrange_points.clear();
+  for (size_t rank = 1; rank <= num_keyranges / 2; rank++) {
+    const double x = static_cast<double>(rank);
+    const double left = keyrange_access[rank - 1] -
+                        keyrange_dist[2] * std::exp(keyrange_dist[3] * x);
+    if (left > 0) {
+      keyrange_points.emplace_back(static_cast<double>(rank), std::log(left));
+    }
+  }
+  if (FitLine(keyrange_points, &keyrange_dist[1], &log_a)) {
+    keyrange_dist[0] = std::exp(log_a);
+  }
+
+  // Value sizes of the Puts, with the generalized Pareto distribution of the
+  // same mean and variance, from 0
+  uint64_t value_count = 0;
+  double value_size_sum = 0, value_size_sqsum = 0;
+  uint64_t max_value_size = 0;
+  if (ta_[kPut].enabled) {
+    for (auto& stat : ta_[kPut].stats) {
+      value_count += stat.second.a_count;
+      value_size_sum += static_cast<double>(stat.second.a_value_size_sum);
+      value_size_sqsum += static_cast<double>(stat.second.a_value_size_sqsum);
+      if (!stat.second.a_value_size_stats.empty()) {
+        max_value_size = std::max(
+            max_value_size,
+            (stat.second.a_value_size_stats.rbegin()->first + 1) *
+                static_cast<uint64_t>(FLAGS_value_interval));
+      }
+    }
+  }
+  double value_theta = 0, value_k = 0, value_sigma = 0;
+  if (value_count > 0) {
+    const double mean = value_size_sum / static_cast<double>(value_count);
+    const double variance =
+        value_size_sqsum / static_cast<double>(value_count) - mean * mean;
+    if (variance <= 0) {
+      // All the values have the same size
+      value_theta = mean;
+    } else {
+      const double ratio = mean * mean / variance;
+      value_k = (1 - ratio) / 2;
+      value_sigma = mean * (1 + ratio) / 2;
+    }
+  }
+
+  // QPS f(x)=A*sin(B*x+C)+D, x in seconds, with the period of the largest
+  // component of the discrete Fourier transform of the QPS of each interval,
+  // whose number is bounded to keep the transform cheap
+  const size_t duration = qps.empty() ? 1 : qps.rbegin()->first + 1;
+  const size_t kMaxIntervals = 4096;
+  const size_t interval = (duration + kMaxIntervals - 1) / kMaxIntervals;
+  const size_t num_intervals = (duration + interval - 1) / interval;
+  std::vector<double> interval_qps(num_intervals, 0);
+  for (const auto& record : qps) {
+    interval_qps[record.first / interval] += static_cast<double>(record.second);
+  }
+  for (size_t i = 0; i < num_intervals; i++) {
+    interval_qps[i] /= static_cast<double>(
+        std::min(interval, duration - i * interval));
+  }
+  double sine_a = 0, sine_b = 0, sine_c = 0;
+  const double sine_d =
+      static_cast<double>(total_count) / static_cast<double>(duration);
+  const double kPi = 3.14159265358979323846;
+  double max_magnitude = 0;
+  for (size_t k = 1; k <= num_intervals / 2 && num_intervals >= 4; k++) {
+    double re = 0, im = 0;
+    for (size_t j = 0; j < num_intervals; j++) {
+      const double angle = 2 * kPi * static_cast<double>(k * j) /
+                           static_cast<double>(num_intervals);
+      re += (interval_qps[j] - sine_d) * std::cos(angle);
+      im -= (interval_qps[j] - sine_d) * std::sin(angle);
+    }
+    const double magnitude = std::sqrt(re * re + im * im);
+    if (magnitude > max_magnitude) {
+      max_magnitude = magnitude;
+      sine_a = 2 * magnitude / static_cast<double>(num_intervals);
+      sine_b = 2 * kPi * static_cast<double>(k) /
+               static_cast<double>(num_intervals * interval);
+      // A*cos(B*x+phase) is A*sin(B*x+phase+pi/2)
+      sine_c = std::atan2(im, re) + kPi / 2;
+    }
+  }
+
+  std::unique_ptr<WritableFile> config_f;
+  std::string config_name =
+      output_path_ + "/" + FLAGS_output_prefix + "-mixgraph_config.txt";
+  Status s = env_->NewWritableFile(config_name, &config_f, env_options_);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<std::string> flags;
+  auto add_int_flag = [&](const char* name, uint64_t value) {
+    snprintf(buffer_, sizeof(buffer_), "-%s=%" PRIu64 "\n", name, value);
+    flags.emplace_back(buffer_);
+  };
+  auto add_double_flag = [&](const char* name, double value) {
+    snprintf(buffer_, sizeof(buffer_), "-%s=%.10g\n", name, value);
+    flags.emplace_back(buffer_);
+  };
+  add_double_flag("mix_get_ratio",
+                  static_cast<double>(get_count) / total_count);
+  add_double_flag("mix_put_ratio",
+                  static_cast<double>(put_count) / total_count);
+  add_double_flag("mix_seek_ratio",
+                  static_cast<double>(seek_count) / total_count);
+  add_int_flag("num", key_access.size());
+  add_int_flag("key_size",
+               std::max<uint64_t>(1, (key_size_sum + total_count / 2) /
+                                         total_count));
+  add_double_flag("key_dist_a", key_dist_a);
+  add_double_flag("key_dist_b", key_dist_b);
+  add_int_flag("keyrange_num", num_keyranges);
+  add_double_flag("keyrange_dist_a", keyrange_dist[0]);
+  add_double_flag("keyrange_dist_b", keyrange_dist[1]);
+  add_double_flag("keyrange_dist_c", keyrange_dist[2]);
+  add_double_flag("keyrange_dist_d", keyrange_dist[3]);
+  // Keep the defaults of db_bench without Puts to fit to
+  if (value_count > 0) {
+    add_double_flag("value_theta", value_theta);
+    add_double_flag("value_k", value_k);
+    add_double_flag("value_sigma", value_sigma);
+    add_int_flag("mix_max_value_size", max_value_size);
+  }
+  flags.emplace_back("-sine_mix_rate=true\n");
+  add_double_flag("sine_a", sine_a);
+  add_double_flag("sine_b", sine_b);
+  add_double_flag("sine_c", sine_c);
+  add_double_flag("sine_d", sine_d);
+  for (const auto& flag : flags) {
+    s = config_f->Append(flag);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return config_f->Close();
+}
+
 // Insert the corresponding key statistics to the correct type
 // and correct CF, output the time-series file if needed
 Status TraceAnalyzer::KeyStatsInsertion(const uint32_t& type,
@@ -0,0 +1,177 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/advanced_compression.h"
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/system_clock.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+
+// Compresses each block with the candidate picked on the latest sample. The
+// choice is shared by the threads compressing blocks of the same file, as a
+// heuristic that tolerates their races.
+class AdaptiveCompressor : public Compressor {
+ public:
+  AdaptiveCompressor(std::vector<std::unique_ptr<Compressor>>&& candidates,
+                     uint32_t sample_interval, uint64_t max_nanos_per_kb)
+      : candidates_(std::move(candidates)),
+        sample_interval_(std::max(sample_interval, uint32_t{1})),
+        max_nanos_per_kb_(max_nanos_per_kb) {
+    assert(!candidates_.empty());
+  }
+
+  // One working area for each candidate
+  struct AdaptiveWorkingArea : public WorkingArea {
+    std::vector<ManagedWorkingArea> candidate_areas;
+  };
+
+  ManagedWorkingArea ObtainWorkingArea() override {
+    auto wa = new AdaptiveWorkingArea();
+    for (auto& candidate : candidates_) {
+      wa->candidate_areas.push_back(candidate->ObtainWorkingArea());
+    }
+    return ManagedWorkingArea(wa, this);
+  }
+
+  Status CompressBlock(Slice uncompressed_data, std::string* compressed_output,
+                       CompressionType* out_compression_type,
+                       ManagedWorkingArea* working_area) override {
+    AdaptiveWorkingArea* wa = nullptr;
+    if (working_area != nullptr && working_area->owner() == this) {
+      wa = static_cast<AdaptiveWorkingArea*>(working_area->get());
+    }
+    auto CandidateArea = [wa](size_t i) -> ManagedWorkingArea* {
+      return wa != nullptr ? &wa->candidate_areas[i] : nullptr;
+    };
+
+    if (num_blocks_.FetchAddRelaxed(1) % sample_interval_ != 0) {
+      const size_t i = chosen_.LoadRelaxed();
+      return candidates_[i]->CompressBlock(uncompressed_data,
+                                           compressed_output,
+                                           out_compression_type,
+                                           CandidateArea(i));
+    }
+
+    // Sample: try all candidates, keeping the output of the best one
+    SystemClock* clock = SystemClock::Default().get();
+    const uint64_t input_kb =
+        std::max(uncompressed_data.size() / 1024, size_t{1});
+    size_t best = 0;
+    size_t best_size = 0;
+    uint64_t best_nanos_per_kb = 0;
+    std::string output;
+    for (size_t i = 0; i < candidates_.size(); i++) {
+      output.clear();
+      CompressionType type = kNoCompression;
+      const uint64_t start = clock->NowNanos();
+      Status s = candidates_[i]->CompressBlock(uncompressed_data, &output,
+                                               &type, CandidateArea(i));
+      if (!s.ok()) {
+        return s;
+      }
+      const uint64_t nanos_per_kb = (clock->NowNanos() - start) / input_kb;
+      const size_t size = type == kNoCompression ? uncompressed_data.size()
+                                                 : output.size();
+      const bool within_budget = nanos_per_kb <= max_nanos_per_kb_;
+      const bool best_within_budget = best_nanos_per_kb <= max_nanos_per_kb_;
+      bool better;
+      if (i == 0) {
+        better = true;
+      } else if (within_budget != best_within_budget) {
+        better = within_budget;
+      } else if (within_budget) {
+        better = size < best_size;
+      } else {
+        better = nanos_per_kb < best_nanos_per_kb;
+      }
+      if (better) {
+        best = i;
+        best_size = size;
+        best_nanos_per_kb = nanos_per_kb;
+        compressed_output->swap(output);
+        *out_compression_type = type;
+      }
+    }
+    chosen_.StoreRelaxed(best);
+    return Status::OK();
+  }
+
+ protected:
+  void ReleaseWorkingArea(WorkingArea* wa) override {
+    delete static_cast<AdaptiveWorkingArea*>(wa);
+  }
+
+ private:
+  const std::vector<std::unique_ptr<Compressor>> candidates_;
+  const uint32_t sample_interval_;
+  const uint64_t max_nanos_per_kb_;
+  RelaxedAtomic<uint64_t> num_blocks_{0};
+  RelaxedAtomic<size_t> chosen_{0};
+};
+
+class AdaptiveCompressionManager : public CompressionManagerWrapper {
+ public:
+  AdaptiveCompressionManager(const AdaptiveCompressionOptions& options,
+                             std::shared_ptr<CompressionManager> base)
+      : CompressionManagerWrapper(std::move(base)), options_(options) {}
+
+  const char* Name() const override { return "AdaptiveCompressionManager"; }
+
+  std::unique_ptr<Compressor> GetCompressorForSST(
+      const FilterBuildingContext& context, const CompressionOptions& opts,
+      CompressionType preferred) override {
+    if (preferred == kNoCompression) {
+      return wrapped_->GetCompressorForSST(context, opts, preferred);
+    }
+    std::vector<std::unique_ptr<Compressor>> candidates;
+    for (const auto& candidate : options_.candidates) {
+      CompressionOptions candidate_opts = opts;
+      candidate_opts.level = candidate.level;
+      candidate_opts.max_dict_bytes = 0;
+      candidate_opts.zstd_max_train_bytes = 0;
+      auto compressor = wrapped_->GetCompressor(candidate_opts, candidate.type);
+      if (compressor != nullptr) {
+        candidates.push_back(std::move(compressor));
+      }
+    }
+    if (candidates.empty()) {
+      return wrapped_->GetCompressorForSST(context, opts, preferred);
+    }
+
+    uint64_t max_nanos_per_kb = std::numeric_limits<uint64_t>::max();
+    const auto& budgets = options_.max_nanos_per_kb;
+    if (!budgets.empty()) {
+      const size_t level =
+          static_cast<size_t>(std::max(context.level_at_creation, 0));
+      max_nanos_per_kb = budgets[std::min(level, budgets.size() - 1)];
+    }
+    return std::make_unique<AdaptiveCompressor>(
+        std::move(candidates), options_.sample_interval, max_nanos_per_kb);
+  }
+
+ private:
+  const AdaptiveCompressionOptions options_;
+};
+
+}  // namespace
+
+std::shared_ptr<CompressionManager> NewAdaptiveCompressionManager(
+    const AdaptiveCompressionOptions& options,
+    std::shared_ptr<CompressionManager> base) {
+  if (base == nullptr) {
+    base = GetDefaultBuiltinCompressionManager();
+  }
+  return std::make_shared<AdaptiveCompressionManager>(options, std::move(base));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -10,9 +10,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <vector>
 
+#include "port/lang.h"
 #include "port/port.h"
 #include "rocksdb/file_system.h"
+#include "util/mutexlock.h"
 namespace ROCKSDB_NAMESPACE {
 
 // This file contains utilities to handle the alignment of pages and buffers.
@@ -40,6 +43,79 @@ inline size_t Roundup(size_t x, size_t y) { return ((x + y - 1) / y) * y; }
 //   Rounddown(201, 16) => 192
 inline size_t Rounddown(size_t x, size_t y) { return (x / y) * y; }
 
+// AlignedBufferPool keeps the buffers of short-lived AlignedBuffers, like the
+// ones of unaligned direct I/O reads, for reuse after they are freed. Buffers
+// are kept by power-of-two size class, from kMinClassSize to kMaxClassSize,
+// and the start of each is aligned to kMaxAlignment so that it can be handed
+// out for any alignment up to it.
+class AlignedBufferPool {
+ public:
+  static constexpr size_t kMinClassSize = 4096;
+  static constexpr size_t kNumClasses = 9;
+  static constexpr size_t kMaxClassSize = kMinClassSize << (kNumClasses - 1);
+  static constexpr size_t kMaxAlignment = 4096;
+  // Free buffers kept for each size class
+  static constexpr size_t kMaxFreeBuffers = 16;
+
+  static AlignedBufferPool* Default() {
+    STATIC_AVOID_DESTRUCTION(AlignedBufferPool, pool);
+    return &pool;
+  }
+
+  // Returns the size class for a capacity of `capacity` bytes, or kNumClasses
+  // if it is too large to be pooled.
+  static size_t SizeClass(size_t capacity) {
+    size_t cls = 0;
+    while (cls < kNumClasses && ClassSize(cls) < capacity) {
+      cls++;
+    }
+    return cls;
+  }
+
+  static size_t ClassSize(size_t cls) { return kMinClassSize << cls; }
+
+  // Returns an allocation of ClassSize(cls) + kMaxAlignment bytes
+  char* Allocate(size_t cls) {
+    assert(cls < kNumClasses);
+    {
+      std::lock_guard<SpinMutex> l(free_[cls].mutex);
+      auto& buffers = free_[cls].buffers;
+      if (!buffers.empty()) {
+        char* buf = buffers.back();
+        buffers.pop_back();
+        return buf;
+      }
+    }
+    return new char[ClassSize(cls) + kMaxAlignment];
+  }
+
+  // Takes back an allocation of Allocate(cls)
+  void Free(size_t cls, char* buf) {
+    assert(cls < kNumClasses);
+    {
+      std::lock_guard<SpinMutex> l(free_[cls].mutex);
+      auto& buffers = free_[cls].buffers;
+      if (buffers.size() < kMaxFreeBuffers) {
+        buffers.push_back(buf);
+        return;
+      }
+    }
+    delete[] buf;
+  }
+
+  size_t TEST_NumFreeBuffers(size_t cls) {
+    std::lock_guard<SpinMutex> l(free_[cls].mutex);
+    return free_[cls].buffers.size();
+  }
+
+ private:
+  struct FreeBuffers {
+    SpinMutex mutex;
+    std::vector<char*> buffers;
+  };
+  FreeBuffers free_[kNumClasses];
+};
+
 // AlignedBuffer manages a buffer by taking alignment into consideration, and
 // aligns the buffer start and end positions. It is mainly used for direct I/O,
 // though it can be used other purposes as well.
@@ -178,6 +254,33 @@ class AlignedBuffer {
         [](void* p) { delete[] static_cast<char*>(p); });
   }
 
+  // Like AllocateNewBuffer(requested_capacity), but takes the buffer from
+  // AlignedBufferPool::Default(), and gives it back to it once freed, if it
+  // is small enough. Meant for buffers that are freed soon after.
+  void AllocateNewPooledBuffer(size_t requested_capacity) {
+    assert(alignment_ > 0);
+    assert((alignment_ & (alignment_ - 1)) == 0);
+
+    size_t new_capacity = Roundup(requested_capacity, alignment_);
+    const size_t cls = AlignedBufferPool::SizeClass(new_capacity);
+    if (alignment_ > AlignedBufferPool::kMaxAlignment ||
+        cls == AlignedBufferPool::kNumClasses) {
+      AllocateNewBuffer(requested_capacity);
+      return;
+    }
+    char* new_buf = AlignedBufferPool::Default()->Allocate(cls);
+    bufstart_ = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(new_buf) +
+         (AlignedBufferPool::kMaxAlignment - 1)) &
+        ~static_cast<uintptr_t>(AlignedBufferPool::kMaxAlignment - 1));
+    cursize_ = 0;
+    capacity_ = Rounddown(AlignedBufferPool::ClassSize(cls), alignment_);
+    buf_ = std::unique_ptr<void, std::function<void(void*)>>(
+        static_cast<void*>(new_buf), [cls](void* p) {
+          AlignedBufferPool::Default()->Free(cls, static_cast<char*>(p));
+        });
+  }
+
   // Append to the buffer.
   //
   // src         : source to copy the data from.
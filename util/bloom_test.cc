@@ -289,6 +289,34 @@ TEST_P(FullBloomTest, FullSmall) {
   ASSERT_TRUE(!Matches("foo"));
 }
 
+TEST_P(FullBloomTest, HashesMayMatch) {
+  char buffer[sizeof(int)];
+  for (int i = 0; i < 1000; i++) {
+    Add(Key(i, buffer));
+  }
+  Build();
+
+  // Half of the keys were added
+  std::array<std::string, 32> keys;
+  std::array<uint64_t, 32> hashes;
+  std::array<bool, 32> may_match;
+  for (int batch = 0; batch < 100; batch++) {
+    for (int i = 0; i < 32; i++) {
+      const int k = (batch * 16 + i / 2) % 1000;
+      keys[i] = Key(k + (i % 2) * 1000, buffer).ToString();
+      hashes[i] = GetSliceHash64(keys[i]);
+    }
+    if (!bits_reader_->HashesMayMatch(32, hashes.data(), may_match.data())) {
+      // Not based on GetSliceHash64()
+      ASSERT_EQ(GetParam(), kLegacyBloom);
+      return;
+    }
+    for (int i = 0; i < 32; i++) {
+      ASSERT_EQ(may_match[i], bits_reader_->MayMatch(keys[i])) << keys[i];
+    }
+  }
+}
+
 TEST_P(FullBloomTest, FullVaryingLengths) {
   // Match how this test was originally built
   table_options_.optimize_filters_for_memory = false;
@@ -53,6 +53,9 @@ void CompactionJobStats::Reset() {
 
   num_single_del_fallthru = 0;
   num_single_del_mismatch = 0;
+
+  num_warmup_output_files = 0;
+  total_warmup_output_bytes = 0;
 }
 
 void CompactionJobStats::Add(const CompactionJobStats& stats) {
@@ -96,6 +99,9 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
 
+  num_warmup_output_files += stats.num_warmup_output_files;
+  total_warmup_output_bytes += stats.total_warmup_output_bytes;
+
   is_remote_compaction |= stats.is_remote_compaction;
 }
 
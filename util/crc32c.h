@@ -34,6 +34,12 @@ uint32_t Crc32cCombine(uint32_t crc1, uint32_t crc2, size_t crc2len);
 // Return the crc32c of data[0,n-1]
 inline uint32_t Value(const char* data, size_t n) { return Extend(0, data, n); }
 
+// Sets crcs[i] to the crc32c of data[i][0,n[i]-1] for each i < count. Faster
+// than a Value() call per buffer for small buffers on CPUs with crc32c
+// instructions, as the computations of several buffers are interleaved.
+void ValueBatch(size_t count, const char* const* data, const size_t* n,
+                uint32_t* crcs);
+
 static const uint32_t kMaskDelta = 0xa282ead8ul;
 
 // Return a masked representation of crc.
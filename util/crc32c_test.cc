@@ -169,6 +169,27 @@ TEST(CRC, Crc32cCombineBigSizeTest) {
   ASSERT_EQ(crc1_2, crc1_2_combine);
 }
 
+TEST(CRC, ValueBatch) {
+  Random rnd(test::RandomSeed());
+  std::vector<std::string> buffers;
+  for (int i = 0; i < 20; i++) {
+    buffers.push_back(rnd.RandomBinaryString(rnd.Uniform(i < 10 ? 64 : 8192)));
+  }
+  for (size_t count = 0; count <= buffers.size(); count++) {
+    std::vector<const char*> data;
+    std::vector<size_t> n;
+    for (size_t i = 0; i < count; i++) {
+      data.push_back(buffers[i].data());
+      n.push_back(buffers[i].size());
+    }
+    std::vector<uint32_t> crcs(count);
+    ValueBatch(count, data.data(), n.data(), crcs.data());
+    for (size_t i = 0; i < count; i++) {
+      ASSERT_EQ(Value(data[i], n[i]), crcs[i]);
+    }
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE::crc32c
 
 // copied from folly
@@ -228,6 +228,83 @@ TEST_F(WritableFileWriterTest, IncrementalBuffer) {
   }
 }
 
+TEST_F(WritableFileWriterTest, AppendV) {
+  class FakeWF : public FSWritableFile {
+   public:
+    explicit FakeWF(std::string* _file_data) : file_data_(_file_data) {}
+    ~FakeWF() override = default;
+
+    using FSWritableFile::Append;
+    IOStatus Append(const Slice& data, const IOOptions& /*options*/,
+                    IODebugContext* /*dbg*/) override {
+      file_data_->append(data.data(), data.size());
+      appends_++;
+      return IOStatus::OK();
+    }
+    IOStatus AppendV(const Slice* data, size_t n,
+                     const IOOptions& /*options*/,
+                     IODebugContext* /*dbg*/) override {
+      for (size_t i = 0; i < n; i++) {
+        file_data_->append(data[i].data(), data[i].size());
+      }
+      vectored_appends_++;
+      return IOStatus::OK();
+    }
+    IOStatus Close(const IOOptions& /*options*/,
+                   IODebugContext* /*dbg*/) override {
+      return IOStatus::OK();
+    }
+    IOStatus Flush(const IOOptions& /*options*/,
+                   IODebugContext* /*dbg*/) override {
+      return IOStatus::OK();
+    }
+    IOStatus Sync(const IOOptions& /*options*/,
+                  IODebugContext* /*dbg*/) override {
+      return IOStatus::OK();
+    }
+    uint64_t GetFileSize(const IOOptions& /*options*/,
+                         IODebugContext* /*dbg*/) override {
+      return file_data_->size();
+    }
+
+    std::string* file_data_;
+    int appends_ = 0;
+    int vectored_appends_ = 0;
+  };
+
+  Random r(301);
+  EnvOptions env_options;
+  env_options.writable_file_max_buffer_size = 64 * 1024;
+  std::string actual;
+  FakeWF* wf = new FakeWF(&actual);
+  std::unique_ptr<WritableFileWriter> writer(new WritableFileWriter(
+      std::unique_ptr<FSWritableFile>(wf), "" /* don't care */, env_options));
+
+  // Small slices are buffered
+  std::string target = r.RandomString(100);
+  ASSERT_OK(writer->Append(IOOptions(), target));
+  std::vector<std::string> pieces = {r.RandomString(10), r.RandomString(20)};
+  ASSERT_OK(writer->AppendV(IOOptions(), {pieces[0], pieces[1]}));
+  target += pieces[0] + pieces[1];
+  ASSERT_TRUE(actual.empty());
+
+  // Large ones are written with the buffered data in a single AppendV()
+  pieces = {r.RandomString(40000), r.RandomString(7), r.RandomString(50000)};
+  ASSERT_OK(writer->AppendV(IOOptions(), {pieces[0], pieces[1], pieces[2]}));
+  target += pieces[0] + pieces[1] + pieces[2];
+  ASSERT_EQ(1, wf->vectored_appends_);
+  ASSERT_EQ(0, wf->appends_);
+  ASSERT_EQ(target, actual);
+  ASSERT_EQ(target.size(), writer->GetFileSize());
+  ASSERT_EQ(target.size(), writer->GetFlushedSize());
+
+  ASSERT_OK(writer->Append(IOOptions(), pieces[1]));
+  target += pieces[1];
+  ASSERT_OK(writer->Flush(IOOptions()));
+  ASSERT_OK(writer->Close(IOOptions()));
+  ASSERT_EQ(target, actual);
+}
+
 TEST_F(WritableFileWriterTest, AlignedBufferedWrites) {
   class FakeWF : public FSWritableFile {
    public:
@@ -334,6 +411,51 @@ TEST_F(WritableFileWriterTest, BufferWithZeroCapacityDirectIO) {
   }
 }
 
+TEST_F(WritableFileWriterTest, BackgroundWrites) {
+  const std::string fname = test::PerThreadDBPath("background_writes");
+  FileOptions file_options;
+  file_options.writable_file_max_buffer_size = 64 * 1024;
+  file_options.use_background_writes = true;
+  std::unique_ptr<WritableFileWriter> writer;
+  ASSERT_OK(WritableFileWriter::Create(FileSystem::Default(), fname,
+                                       file_options, &writer,
+                                       /*dbg=*/nullptr));
+
+  // The first write only starts once the next buffer is being filled
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"WritableFileWriterTest::BackgroundWrites:Appended",
+        "WritableFileWriter::BackgroundWriteLoop:BeforeWrite"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random r(301);
+  std::string target;
+  for (size_t size : {1000, 64 * 1024, 1000}) {
+    const std::string data = r.RandomString(static_cast<int>(size));
+    ASSERT_OK(writer->Append(IOOptions(), data));
+    target.append(data);
+  }
+  ASSERT_EQ(writer->GetFlushedSize(), 0u);
+  TEST_SYNC_POINT("WritableFileWriterTest::BackgroundWrites:Appended");
+
+  for (int i = 0; i < 200; i++) {
+    const std::string data = r.RandomString(static_cast<int>(r.Uniform(4000)));
+    ASSERT_OK(writer->Append(IOOptions(), data));
+    target.append(data);
+    if (i % 50 == 0) {
+      ASSERT_OK(writer->Flush(IOOptions()));
+      ASSERT_EQ(writer->GetFlushedSize(), target.size());
+    }
+  }
+  ASSERT_OK(writer->Close(IOOptions()));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::string actual;
+  ASSERT_OK(ReadFileToString(FileSystem::Default().get(), fname, &actual));
+  ASSERT_EQ(target, actual);
+  ASSERT_OK(FileSystem::Default()->DeleteFile(fname, IOOptions(), nullptr));
+}
+
 class DBWritableFileWriterTest : public DBTestBase {
  public:
   DBWritableFileWriterTest()
@@ -799,6 +921,37 @@ std::string GenerateLine(int n) {
 }
 }  // namespace
 
+TEST(AlignedBufferTest, PooledBufferReuse) {
+  AlignedBufferPool* pool = AlignedBufferPool::Default();
+  const size_t cls = AlignedBufferPool::SizeClass(5000);
+  ASSERT_EQ(AlignedBufferPool::ClassSize(cls), 8192u);
+  const size_t num_free = pool->TEST_NumFreeBuffers(cls);
+
+  AlignedBuffer buf;
+  buf.Alignment(512);
+  buf.AllocateNewPooledBuffer(5000);
+  ASSERT_TRUE(AlignedBuffer::isAligned(buf.BufferStart(), 512));
+  ASSERT_GE(buf.Capacity(), 5000u);
+  ASSERT_EQ(buf.Append(std::string(5000, 'a').data(), 5000), 5000u);
+  const char* start = buf.BufferStart();
+  buf.Release().reset();
+  ASSERT_EQ(pool->TEST_NumFreeBuffers(cls), num_free + 1);
+
+  // The freed buffer is handed out again
+  AlignedBuffer buf2;
+  buf2.Alignment(4096);
+  buf2.AllocateNewPooledBuffer(8192);
+  ASSERT_EQ(buf2.BufferStart(), start);
+  ASSERT_EQ(buf2.Capacity(), 8192u);
+  ASSERT_EQ(pool->TEST_NumFreeBuffers(cls), num_free);
+
+  // Too large to be pooled
+  AlignedBuffer buf3;
+  buf3.Alignment(4096);
+  buf3.AllocateNewPooledBuffer(AlignedBufferPool::kMaxClassSize + 1);
+  ASSERT_GE(buf3.Capacity(), AlignedBufferPool::kMaxClassSize + 1);
+}
+
 TEST(LineFileReaderTest, LineFileReaderTest) {
   const int nlines = 1000;
 
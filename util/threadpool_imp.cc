@@ -31,6 +31,7 @@
 #include "monitoring/thread_status_util.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
+#include "util/mutexlock.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -59,6 +60,8 @@ struct ThreadPoolImpl::Impl {
 
   void LowerCPUPriority(CpuPriority pri);
 
+  void SetCpuAffinity(const std::vector<int>& cpus);
+
   void WakeUpAllThreads() { bgsignal_.notify_all(); }
 
   void BGThread(size_t thread_id);
@@ -125,6 +128,10 @@ struct ThreadPoolImpl::Impl {
 
   bool low_io_priority_;
   CpuPriority cpu_priority_;
+  // CPUs of the threads, and the number of times they were set, so that each
+  // thread knows whether it is up to date
+  std::vector<int> cpu_affinity_;
+  uint64_t cpu_affinity_version_;
   Env::Priority priority_;
   Env* env_;
 
@@ -161,6 +168,7 @@ struct ThreadPoolImpl::Impl {
 inline ThreadPoolImpl::Impl::Impl()
     : low_io_priority_(false),
       cpu_priority_(CpuPriority::kNormal),
+      cpu_affinity_version_(0),
       priority_(Env::LOW),
       env_(nullptr),
       total_threads_limit_(0),
@@ -198,6 +206,9 @@ void ThreadPoolImpl::Impl::JoinThreads(bool wait_for_jobs_to_complete) {
 
   bgthreads_.clear();
 
+  // The threads woken up above decreased it below zero. Submit() relies on
+  // it to tell whether a thread is waiting once the pool is used again.
+  num_waiting_threads_ = 0;
   exit_all_threads_ = false;
   wait_for_jobs_to_complete_ = false;
 }
@@ -212,9 +223,16 @@ inline void ThreadPoolImpl::Impl::LowerCPUPriority(CpuPriority pri) {
   cpu_priority_ = pri;
 }
 
+inline void ThreadPoolImpl::Impl::SetCpuAffinity(const std::vector<int>& cpus) {
+  std::lock_guard<std::mutex> lock(mu_);
+  cpu_affinity_ = cpus;
+  cpu_affinity_version_++;
+}
+
 void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
   bool low_io_priority = false;
   CpuPriority current_cpu_priority = CpuPriority::kNormal;
+  uint64_t current_cpu_affinity_version = 0;
 
   while (true) {
     // Wait until there is an item that is ready to run
@@ -270,6 +288,13 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
 
     bool decrease_io_priority = (low_io_priority != low_io_priority_);
     CpuPriority cpu_priority = cpu_priority_;
+    bool set_cpu_affinity = false;
+    std::vector<int> cpu_affinity;
+    if (current_cpu_affinity_version != cpu_affinity_version_) {
+      set_cpu_affinity = true;
+      cpu_affinity = cpu_affinity_;
+      current_cpu_affinity_version = cpu_affinity_version_;
+    }
     lock.unlock();
 
     if (cpu_priority < current_cpu_priority) {
@@ -282,6 +307,13 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
                                &current_cpu_priority);
     }
 
+    if (set_cpu_affinity) {
+      // 0 means current thread.
+      bool ok = port::SetCpuAffinity(0, cpu_affinity);
+      TEST_SYNC_POINT_CALLBACK("ThreadPoolImpl::BGThread::AfterSetCpuAffinity",
+                               &ok);
+    }
+
 #ifdef OS_LINUX
     if (decrease_io_priority) {
 #define IOPRIO_CLASS_SHIFT (13)
@@ -401,7 +433,7 @@ void ThreadPoolImpl::Impl::StartBGThreads() {
 void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
                                   std::function<void()>&& unschedule,
                                   void* tag) {
-  std::lock_guard<std::mutex> lock(mu_);
+  std::unique_lock<std::mutex> lock(mu_);
 
   if (exit_all_threads_) {
     return;
@@ -420,13 +452,17 @@ void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
   queue_len_.store(static_cast<unsigned int>(queue_.size()),
                    std::memory_order_relaxed);
 
-  if (!HasExcessiveThread()) {
-    // Wake up at least one waiting thread.
-    bgsignal_.notify_one();
-  } else {
+  if (HasExcessiveThread()) {
     // Need to wake up all threads to make sure the one woken
     // up is not the one to terminate.
     WakeUpAllThreads();
+  } else if (num_waiting_threads_ > 0) {
+    // Wake up at least one waiting thread. It is done after unlocking so
+    // that the thread woken up does not block on the mutex right away. When
+    // no thread is waiting there is none to wake up: the busy threads check
+    // the queue under the mutex before they wait again.
+    lock.unlock();
+    bgsignal_.notify_one();
   }
 }
 
@@ -490,6 +526,10 @@ void ThreadPoolImpl::LowerCPUPriority(CpuPriority pri) {
   impl_->LowerCPUPriority(pri);
 }
 
+void ThreadPoolImpl::SetCpuAffinity(const std::vector<int>& cpus) {
+  impl_->SetCpuAffinity(cpus);
+}
+
 void ThreadPoolImpl::IncBackgroundThreadsIfNeeded(int num) {
   impl_->SetBackgroundThreadsInternal(num, false);
 }
@@ -541,6 +581,44 @@ int ThreadPoolImpl::ReleaseThreads(int threads_to_be_released) {
   return impl_->ReleaseThreads(threads_to_be_released);
 }
 
+void ParallelFor(ThreadPool* pool, size_t n,
+                 const std::function<void(size_t)>& fn) {
+  struct State {
+    const std::function<void(size_t)>* fn;
+    std::atomic<size_t> next{0};
+    port::Mutex mutex;
+    port::CondVar cv{&mutex};
+    size_t num_done = 0;
+  };
+  auto state = std::make_shared<State>();
+  state->fn = &fn;
+  auto work = [state, n]() {
+    size_t num_done = 0;
+    for (size_t i = state->next.fetch_add(1, std::memory_order_relaxed); i < n;
+         i = state->next.fetch_add(1, std::memory_order_relaxed)) {
+      (*state->fn)(i);
+      num_done++;
+    }
+    if (num_done > 0) {
+      MutexLock l(&state->mutex);
+      state->num_done += num_done;
+      if (state->num_done == n) {
+        state->cv.SignalAll();
+      }
+    }
+  };
+  const size_t num_jobs = std::min(
+      n - 1, static_cast<size_t>(std::max(pool->GetBackgroundThreads(), 0)));
+  for (size_t i = 0; i < num_jobs; i++) {
+    pool->SubmitJob(work);
+  }
+  work();
+  MutexLock l(&state->mutex);
+  while (state->num_done < n) {
+    state->cv.Wait();
+  }
+}
+
 ThreadPool* NewThreadPool(int num_threads) {
   ThreadPoolImpl* thread_pool = new ThreadPoolImpl();
   thread_pool->SetBackgroundThreads(num_threads);
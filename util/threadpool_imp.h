@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "rocksdb/env.h"
 #include "rocksdb/threadpool.h"
@@ -53,6 +54,11 @@ class ThreadPoolImpl : public ThreadPool {
   // Currently only has effect on Linux
   void LowerCPUPriority(CpuPriority pri);
 
+  // Restrict threads to run on the given CPUs, or on any CPU when `cpus` is
+  // empty. Each thread applies it before the next job it runs.
+  // Currently only has effect on Linux
+  void SetCpuAffinity(const std::vector<int>& cpus);
+
   // Ensure there is at aleast num threads in the pool
   // but do not kill threads if there are more
   void IncBackgroundThreadsIfNeeded(int num);
@@ -117,4 +123,10 @@ class ThreadPoolImpl : public ThreadPool {
   std::unique_ptr<Impl> impl_;
 };
 
+// Runs fn(0) to fn(n - 1) on the calling thread and up to n - 1 jobs of the
+// pool, and returns once all of them are done. Jobs that only start after
+// that find nothing left to do, and no longer touch the caller's state.
+void ParallelFor(ThreadPool* pool, size_t n,
+                 const std::function<void(size_t)>& fn);
+
 }  // namespace ROCKSDB_NAMESPACE
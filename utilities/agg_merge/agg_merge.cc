@@ -5,8 +5,11 @@
 
 #include "rocksdb/utilities/agg_merge.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <deque>
+#include <limits>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -36,6 +39,82 @@ Status AddAggregator(const std::string& function_name,
   return Status::OK();
 }
 
+namespace {
+class Int64Aggregator : public Aggregator {
+ public:
+  explicit Int64Aggregator(Int64AggregationType type) : type_(type) {}
+
+  bool Aggregate(const std::vector<Slice>& values,
+                 std::string& result) const override {
+    // The operands are scattered, so they are decoded into a contiguous
+    // batch that Fold() can go through with vector instructions.
+    constexpr size_t kBatchSize = 64;
+    uint64_t batch[kBatchSize];
+    uint64_t acc = Identity();
+    for (size_t start = 0; start < values.size(); start += kBatchSize) {
+      const size_t n = std::min(kBatchSize, values.size() - start);
+      for (size_t i = 0; i < n; i++) {
+        const Slice& value = values[start + i];
+        if (value.size() == sizeof(uint64_t)) {
+          batch[i] = DecodeFixed64(value.data());
+        } else if (type_ == Int64AggregationType::kCount && value.empty()) {
+          batch[i] = 1;
+        } else {
+          return false;
+        }
+      }
+      acc = Fold(acc, batch, n);
+    }
+    result.clear();
+    PutFixed64(&result, acc);
+    return true;
+  }
+
+ private:
+  uint64_t Identity() const {
+    switch (type_) {
+      case Int64AggregationType::kMin:
+        return static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+      case Int64AggregationType::kMax:
+        return static_cast<uint64_t>(std::numeric_limits<int64_t>::min());
+      default:
+        return 0;
+    }
+  }
+
+  uint64_t Fold(uint64_t acc, const uint64_t* batch, size_t n) const {
+    switch (type_) {
+      case Int64AggregationType::kMin: {
+        int64_t min = static_cast<int64_t>(acc);
+        for (size_t i = 0; i < n; i++) {
+          min = std::min(min, static_cast<int64_t>(batch[i]));
+        }
+        return static_cast<uint64_t>(min);
+      }
+      case Int64AggregationType::kMax: {
+        int64_t max = static_cast<int64_t>(acc);
+        for (size_t i = 0; i < n; i++) {
+          max = std::max(max, static_cast<int64_t>(batch[i]));
+        }
+        return static_cast<uint64_t>(max);
+      }
+      default:
+        // Unsigned, so that overflows wrap around
+        for (size_t i = 0; i < n; i++) {
+          acc += batch[i];
+        }
+        return acc;
+    }
+  }
+
+  const Int64AggregationType type_;
+};
+}  // namespace
+
+std::unique_ptr<Aggregator> NewInt64Aggregator(Int64AggregationType type) {
+  return std::make_unique<Int64Aggregator>(type);
+}
+
 AggMergeOperator::AggMergeOperator() = default;
 
 std::string EncodeAggFuncAndPayloadNoCheck(const Slice& function_name,
@@ -90,8 +169,8 @@ class AggMergeOperator::Accumulator {
 
     // Determine whether we need to do partial merge.
     if (is_partial_aggregation && !my_func.empty()) {
-      auto f = func_map.find(my_func.ToString());
-      if (f == func_map.end() || !f->second->DoPartialAggregate()) {
+      const Aggregator* f = FindAggregator(my_func);
+      if (f == nullptr || !f->DoPartialAggregate()) {
         return false;
       }
     }
@@ -112,10 +191,8 @@ class AggMergeOperator::Accumulator {
         return false;
       }
 
-      // We could consider stashing an iterator into the hash of aggregators
-      // to avoid repeated lookups when the aggregator doesn't change.
-      auto f = func_map.find(func_.ToString());
-      if (f == func_map.end() || !f->second->Aggregate(values_, scratch_)) {
+      const Aggregator* f = FindAggregator(func_);
+      if (f == nullptr || !f->Aggregate(values_, scratch_)) {
         func_valid_ = false;
         ignore_operands_ = true;
         return true;
@@ -135,11 +212,11 @@ class AggMergeOperator::Accumulator {
     if (!func_valid_) {
       return false;
     }
-    auto f = func_map.find(func_.ToString());
-    if (f == func_map.end()) {
+    const Aggregator* f = FindAggregator(func_);
+    if (f == nullptr) {
       return false;
     }
-    if (!f->second->Aggregate(values_, scratch_)) {
+    if (!f->Aggregate(values_, scratch_)) {
       return false;
     }
     result = EncodeAggFuncAndPayloadNoCheck(func_, scratch_);
@@ -153,15 +230,35 @@ class AggMergeOperator::Accumulator {
     scratch_.clear();
     ignore_operands_ = false;
     func_valid_ = false;
+    last_found_func_.clear();
+    last_found_ = nullptr;
   }
 
  private:
+  // Looks up the aggregator registered as `func`, or returns nullptr. The
+  // operands of a key mostly share one function, so the last one found is
+  // remembered rather than looked up again for each operand.
+  const Aggregator* FindAggregator(const Slice& func) {
+    if (last_found_ != nullptr && func == last_found_func_) {
+      return last_found_;
+    }
+    auto f = func_map.find(func.ToString());
+    if (f == func_map.end()) {
+      return nullptr;
+    }
+    last_found_func_ = func;
+    last_found_ = f->second.get();
+    return last_found_;
+  }
+
   Slice func_;
   std::vector<Slice> values_;
   std::string aggregated_;
   std::string scratch_;
   bool ignore_operands_ = false;
   bool func_valid_ = false;
+  Slice last_found_func_;
+  const Aggregator* last_found_ = nullptr;
 };
 
 // Creating and using a new Accumulator might invoke multiple malloc and is
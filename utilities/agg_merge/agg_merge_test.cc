@@ -126,6 +126,75 @@ TEST_F(AggMergeTest, TestUsingMergeOperator) {
   ASSERT_EQ(v, decoded_list[0]);
   ASSERT_EQ(v1, decoded_list[1]);
 }
+
+TEST_F(AggMergeTest, Int64Aggregators) {
+  ASSERT_OK(AddAggregator("int64_sum",
+                          NewInt64Aggregator(Int64AggregationType::kSum)));
+  ASSERT_OK(AddAggregator("int64_min",
+                          NewInt64Aggregator(Int64AggregationType::kMin)));
+  ASSERT_OK(AddAggregator("int64_max",
+                          NewInt64Aggregator(Int64AggregationType::kMax)));
+  ASSERT_OK(AddAggregator("int64_count",
+                          NewInt64Aggregator(Int64AggregationType::kCount)));
+
+  Options options = CurrentOptions();
+  options.merge_operator = GetAggMergeOperator();
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  auto encode = [](const std::string& func, int64_t value) {
+    std::string payload;
+    PutFixed64(&payload, static_cast<uint64_t>(value));
+    std::string result;
+    EXPECT_OK(EncodeAggFuncAndPayload(func, payload, result));
+    return result;
+  };
+
+  // More operands than a batch of the aggregators
+  const int kNumOperands = 200;
+  for (int i = 1; i <= kNumOperands; i++) {
+    const int64_t value = (i % 2 == 0) ? i : -i;
+    ASSERT_OK(Merge("sum", encode("int64_sum", value)));
+    ASSERT_OK(Merge("min", encode("int64_min", value)));
+    ASSERT_OK(Merge("max", encode("int64_max", value)));
+    std::string count;
+    ASSERT_OK(EncodeAggFuncAndPayload("int64_count", "", count));
+    ASSERT_OK(Merge("count", count));
+    if (i == kNumOperands / 2) {
+      ASSERT_OK(Flush());
+    }
+  }
+  ASSERT_EQ(encode("int64_sum", kNumOperands / 2), Get("sum"));
+  ASSERT_EQ(encode("int64_min", -(kNumOperands - 1)), Get("min"));
+  ASSERT_EQ(encode("int64_max", kNumOperands), Get("max"));
+  ASSERT_EQ(encode("int64_count", kNumOperands), Get("count"));
+
+  // Flushes and compactions partially merge the operands into one
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (const char* key : {"sum", "min", "max", "count"}) {
+    std::vector<PinnableSlice> operands(kNumOperands);
+    GetMergeOperandsOptions merge_operands_options;
+    merge_operands_options.expected_max_number_of_operands = kNumOperands;
+    int num_operands = 0;
+    ASSERT_OK(db_->GetMergeOperands(ReadOptions(), db_->DefaultColumnFamily(),
+                                    key, operands.data(),
+                                    &merge_operands_options, &num_operands));
+    ASSERT_EQ(1, num_operands);
+  }
+  ASSERT_EQ(encode("int64_sum", kNumOperands / 2), Get("sum"));
+  ASSERT_EQ(encode("int64_count", kNumOperands), Get("count"));
+
+  // Payloads of the wrong width fail the aggregation
+  std::string bad;
+  ASSERT_OK(EncodeAggFuncAndPayload("int64_sum", "abc", bad));
+  ASSERT_OK(Merge("bad", bad));
+  ASSERT_OK(Merge("bad", encode("int64_sum", 1)));
+  Slice func, payload;
+  std::string aggregated_value = Get("bad");
+  ASSERT_TRUE(ExtractAggFuncAndValue(aggregated_value, func, payload));
+  EXPECT_EQ(kErrorFuncName, func);
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -0,0 +1,77 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/async_get_queue.h"
+
+#include <string>
+#include <vector>
+
+namespace ROCKSDB_NAMESPACE {
+
+struct AsyncGetQueue::Rep {
+  struct Lookup {
+    ColumnFamilyHandle* column_family;
+    std::string key;
+    Callback callback;
+  };
+
+  Rep(DB* _db, const ReadOptions& _read_options,
+      const AsyncGetQueueOptions& _options)
+      : db(_db), read_options(_read_options), options(_options) {}
+
+  DB* const db;
+  const ReadOptions read_options;
+  const AsyncGetQueueOptions options;
+  std::vector<Lookup> pending;
+};
+
+AsyncGetQueue::AsyncGetQueue(DB* db, const ReadOptions& read_options,
+                             const AsyncGetQueueOptions& options)
+    : rep_(new Rep(db, read_options, options)) {}
+
+AsyncGetQueue::~AsyncGetQueue() {
+  // Lookups queued by the callbacks are run as well
+  while (Poll() > 0) {
+  }
+}
+
+void AsyncGetQueue::Get(ColumnFamilyHandle* column_family, const Slice& key,
+                        Callback callback) {
+  rep_->pending.push_back(
+      Rep::Lookup{column_family, key.ToString(), std::move(callback)});
+  if (rep_->pending.size() >= rep_->options.max_batch_size) {
+    Poll();
+  }
+}
+
+size_t AsyncGetQueue::Poll() {
+  // Leave the queue to the lookups that the callbacks make
+  std::vector<Rep::Lookup> lookups;
+  lookups.swap(rep_->pending);
+  const size_t num_keys = lookups.size();
+  if (num_keys == 0) {
+    return 0;
+  }
+
+  std::vector<ColumnFamilyHandle*> column_families(num_keys);
+  std::vector<Slice> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    column_families[i] = lookups[i].column_family;
+    keys[i] = lookups[i].key;
+  }
+  std::vector<PinnableSlice> values(num_keys);
+  std::vector<Status> statuses(num_keys);
+  rep_->db->MultiGet(rep_->read_options, num_keys, column_families.data(),
+                     keys.data(), values.data(), statuses.data());
+  for (size_t i = 0; i < num_keys; i++) {
+    lookups[i].callback(statuses[i], &values[i]);
+  }
+  return num_keys;
+}
+
+size_t AsyncGetQueue::NumPending() const { return rep_->pending.size(); }
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,94 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/async_get_queue.h"
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class AsyncGetQueueTest : public DBTestBase {
+ public:
+  AsyncGetQueueTest()
+      : DBTestBase("async_get_queue_test", /*env_do_fsync=*/false) {}
+};
+
+TEST_F(AsyncGetQueueTest, Basic) {
+  Options options = CurrentOptions();
+  CreateAndReopenWithCF({"pikachu"}, options);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put(0, Key(i), "v" + std::to_string(i)));
+    ASSERT_OK(Put(1, Key(i), "w" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush(0));
+  ASSERT_OK(Flush(1));
+
+  AsyncGetQueueOptions queue_options;
+  queue_options.max_batch_size = 16;
+  AsyncGetQueue queue(db_, ReadOptions(), queue_options);
+  std::vector<std::string> found(200);
+  int num_not_found = 0;
+  for (int i = 0; i < 100; i++) {
+    for (int cf = 0; cf < 2; cf++) {
+      std::string* result = &found[cf * 100 + i];
+      queue.Get(handles_[cf], Key(i),
+                [result](const Status& s, PinnableSlice* value) {
+                  ASSERT_OK(s);
+                  *result = value->ToString();
+                });
+    }
+  }
+  queue.Get(handles_[0], "missing", [&](const Status& s, PinnableSlice*) {
+    ASSERT_TRUE(s.IsNotFound());
+    num_not_found++;
+  });
+  // The full batches have run already
+  ASSERT_EQ(201u % 16, queue.NumPending());
+  ASSERT_EQ(201u % 16, queue.Poll());
+  ASSERT_EQ(0u, queue.NumPending());
+  ASSERT_EQ(0u, queue.Poll());
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ("v" + std::to_string(i), found[i]);
+    ASSERT_EQ("w" + std::to_string(i), found[100 + i]);
+  }
+  ASSERT_EQ(1, num_not_found);
+}
+
+TEST_F(AsyncGetQueueTest, GetFromCallback) {
+  ASSERT_OK(Put("a", "b"));
+  ASSERT_OK(Put("b", "c"));
+  ASSERT_OK(Put("c", "end"));
+
+  std::string last;
+  {
+    AsyncGetQueue queue(db_, ReadOptions());
+    std::function<void(const Status&, PinnableSlice*)> follow =
+        [&](const Status& s, PinnableSlice* value) {
+          ASSERT_OK(s);
+          last = value->ToString();
+          if (last != "end") {
+            queue.Get(db_->DefaultColumnFamily(), last, follow);
+          }
+        };
+    queue.Get(db_->DefaultColumnFamily(), "a", follow);
+    // One more step of the chain each time
+    ASSERT_EQ(1u, queue.Poll());
+    ASSERT_EQ("b", last);
+    ASSERT_EQ(1u, queue.NumPending());
+    // The rest of the chain is run on destruction
+  }
+  ASSERT_EQ("end", last);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/batched_get_db.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/system_clock.h"
+#include "test_util/sync_point.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// Whether Gets with these options return the same as when run together
+bool SameBatchOptions(const ReadOptions& a, const ReadOptions& b) {
+  return a.snapshot == b.snapshot && a.read_tier == b.read_tier &&
+         a.rate_limiter_priority == b.rate_limiter_priority &&
+         a.merge_operand_count_threshold == b.merge_operand_count_threshold &&
+         a.verify_checksums == b.verify_checksums &&
+         a.fill_cache == b.fill_cache &&
+         a.ignore_range_deletions == b.ignore_range_deletions &&
+         a.async_io == b.async_io &&
+         a.optimize_multiget_for_io == b.optimize_multiget_for_io &&
+         a.multiget_decompression_thread_pool ==
+             b.multiget_decompression_thread_pool &&
+         a.column_projection == b.column_projection &&
+         a.deadline == b.deadline && a.io_timeout == b.io_timeout &&
+         a.io_activity == b.io_activity && a.request_id == b.request_id;
+}
+}  // namespace
+
+struct BatchedGetDB::Rep {
+  struct Batch {
+    Batch(ColumnFamilyHandle* _column_family, const ReadOptions& _options)
+        : column_family(_column_family), options(_options) {}
+
+    ColumnFamilyHandle* const column_family;
+    const ReadOptions options;
+    // Owned by the waiting callers
+    std::vector<Slice> keys;
+    std::vector<PinnableSlice*> values;
+    std::vector<Status*> statuses;
+    bool done = false;
+  };
+
+  explicit Rep(const BatchedGetOptions& _options)
+      : options(_options), cv(&mutex) {}
+
+  const BatchedGetOptions options;
+  port::Mutex mutex;
+  // Signaled when a batch fills up or is done
+  port::CondVar cv;
+  // The batches that Gets can still join
+  std::vector<std::shared_ptr<Batch>> open_batches;
+};
+
+BatchedGetDB::BatchedGetDB(DB* db, const BatchedGetOptions& options)
+    : StackableDB(db), rep_(new Rep(options)) {}
+
+BatchedGetDB::~BatchedGetDB() = default;
+
+Status BatchedGetDB::Get(const ReadOptions& options,
+                         ColumnFamilyHandle* column_family, const Slice& key,
+                         PinnableSlice* value, std::string* timestamp) {
+  // MultiGet would apply value_size_soft_limit to the whole batch
+  if (timestamp != nullptr || options.timestamp != nullptr ||
+      options.value_size_soft_limit != std::numeric_limits<uint64_t>::max() ||
+      rep_->options.max_batch_size <= 1) {
+    return StackableDB::Get(options, column_family, key, value, timestamp);
+  }
+
+  Status status;
+  std::shared_ptr<Rep::Batch> batch;
+  bool leader = false;
+  MutexLock l(&rep_->mutex);
+  for (const auto& open_batch : rep_->open_batches) {
+    if (open_batch->column_family == column_family &&
+        SameBatchOptions(open_batch->options, options)) {
+      batch = open_batch;
+      break;
+    }
+  }
+  if (batch == nullptr) {
+    batch = std::make_shared<Rep::Batch>(column_family, options);
+    rep_->open_batches.push_back(batch);
+    leader = true;
+  }
+  batch->keys.push_back(key);
+  batch->values.push_back(value);
+  batch->statuses.push_back(&status);
+  const bool full = batch->keys.size() >= rep_->options.max_batch_size;
+  if (full) {
+    // No more Gets can join
+    rep_->open_batches.erase(std::find(rep_->open_batches.begin(),
+                                       rep_->open_batches.end(), batch));
+    if (!leader) {
+      rep_->cv.SignalAll();
+    }
+  }
+
+  if (!leader) {
+    while (!batch->done) {
+      rep_->cv.Wait();
+    }
+    return status;
+  }
+
+  TEST_SYNC_POINT("BatchedGetDB::Get:Leader");
+  const uint64_t deadline =
+      SystemClock::Default()->NowMicros() + rep_->options.window_micros;
+  while (batch->keys.size() < rep_->options.max_batch_size &&
+         !rep_->cv.TimedWait(deadline)) {
+  }
+  if (batch->keys.size() < rep_->options.max_batch_size) {
+    rep_->open_batches.erase(std::find(rep_->open_batches.begin(),
+                                       rep_->open_batches.end(), batch));
+  }
+
+  // The batch is closed, so it can be used without the mutex
+  rep_->mutex.Unlock();
+  const size_t num_keys = batch->keys.size();
+  std::vector<ColumnFamilyHandle*> column_families(num_keys, column_family);
+  std::vector<PinnableSlice> values(num_keys);
+  std::vector<Status> statuses(num_keys);
+  StackableDB::MultiGet(options, num_keys, column_families.data(),
+                        batch->keys.data(), values.data(), statuses.data());
+  for (size_t i = 0; i < num_keys; i++) {
+    if (values[i].IsPinned()) {
+      *batch->values[i] = std::move(values[i]);
+    } else {
+      // Into the buffer of the caller, which can be its std::string
+      batch->values[i]->Reset();
+      batch->values[i]->PinSelf(values[i]);
+    }
+    *batch->statuses[i] = statuses[i];
+  }
+  rep_->mutex.Lock();
+
+  batch->done = true;
+  rep_->cv.SignalAll();
+  return status;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
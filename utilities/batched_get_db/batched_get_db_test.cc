@@ -0,0 +1,90 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/batched_get_db.h"
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class BatchedGetDBTest : public DBTestBase {
+ public:
+  BatchedGetDBTest()
+      : DBTestBase("batched_get_db_test", /*env_do_fsync=*/false) {}
+
+ protected:
+  void ReopenWithBatching(const BatchedGetOptions& batched_options) {
+    options_ = CurrentOptions();
+    options_.statistics = CreateDBStatistics();
+    DestroyAndReopen(options_);
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+    // The wrapper owns the DB from now on
+    db_ = new BatchedGetDB(db_, batched_options);
+  }
+
+  Options options_;
+};
+
+TEST_F(BatchedGetDBTest, ConcurrentGetsShareMultiGet) {
+  BatchedGetOptions batched_options;
+  // Batches only run once full
+  batched_options.window_micros = 60 * 1000 * 1000;
+  batched_options.max_batch_size = 4;
+  ReopenWithBatching(batched_options);
+
+  std::vector<port::Thread> threads;
+  std::atomic<int> num_ok{0};
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&, t]() {
+      std::string value;
+      Status s = db_->Get(ReadOptions(), Key(t * 10), &value);
+      if (s.ok() && value == "v" + std::to_string(t * 10)) {
+        num_ok++;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(8, num_ok.load());
+  ASSERT_EQ(2u, options_.statistics->getTickerCount(NUMBER_MULTIGET_CALLS));
+  ASSERT_EQ(8u,
+            options_.statistics->getTickerCount(NUMBER_MULTIGET_KEYS_READ));
+}
+
+TEST_F(BatchedGetDBTest, SingleGets) {
+  BatchedGetOptions batched_options;
+  batched_options.window_micros = 0;
+  ReopenWithBatching(batched_options);
+
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put(Key(1), "new"));
+  ASSERT_OK(Delete(Key(2)));
+  ASSERT_EQ("new", Get(Key(1)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(2)));
+  ASSERT_EQ("v3", Get(Key(3)));
+  ASSERT_EQ("v1", Get(Key(1), snapshot));
+  ASSERT_EQ("v2", Get(Key(2), snapshot));
+  db_->ReleaseSnapshot(snapshot);
+
+  PinnableSlice value;
+  ASSERT_OK(db_->Get(ReadOptions(), db_->DefaultColumnFamily(), Key(4),
+                     &value));
+  ASSERT_EQ("v4", value.ToString());
+  ASSERT_EQ(5u, options_.statistics->getTickerCount(NUMBER_MULTIGET_CALLS));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,491 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/bulk_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/env.h"
+#include "rocksdb/sst_file_reader.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/table.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+using Buffer = std::vector<std::pair<std::string, std::string>>;
+
+// Memory taken by an entry of a buffer besides its key and value
+constexpr size_t kEntryOverhead = sizeof(Buffer::value_type);
+// Keys sampled from each run to pick the boundaries of the key ranges
+constexpr size_t kSamplesPerRun = 64;
+// Key ranges merged per thread, so that uneven ranges balance out
+constexpr size_t kRangesPerThread = 4;
+
+// Sorts the buffer, keeping the last value added of each key, and returns
+// samples of its keys
+std::vector<std::string> SortBuffer(const Comparator* ucmp, Buffer* buffer) {
+  std::stable_sort(buffer->begin(), buffer->end(),
+                   [ucmp](const Buffer::value_type& a,
+                          const Buffer::value_type& b) {
+                     return ucmp->Compare(a.first, b.first) < 0;
+                   });
+  size_t n = 0;
+  for (size_t i = 0; i < buffer->size(); i++) {
+    if (i + 1 < buffer->size() &&
+        ucmp->Compare((*buffer)[i].first, (*buffer)[i + 1].first) == 0) {
+      continue;
+    }
+    if (n != i) {
+      (*buffer)[n] = std::move((*buffer)[i]);
+    }
+    n++;
+  }
+  buffer->resize(n);
+
+  std::vector<std::string> samples;
+  const size_t step = std::max<size_t>(n / kSamplesPerRun, 1);
+  for (size_t i = step; i < n; i += step) {
+    samples.push_back((*buffer)[i].first);
+  }
+  return samples;
+}
+
+}  // namespace
+
+struct BulkLoader::Rep {
+  // A sorted run, spilled to a file or, for the last one, in memory
+  struct Run {
+    std::string fname;
+    Status status;
+    std::vector<std::string> samples;
+    std::unique_ptr<SstFileReader> reader;
+    Buffer buffer;
+  };
+
+  // The position of a key range merge in a run
+  struct Cursor {
+    std::unique_ptr<Iterator> iter;
+    const Buffer* buffer = nullptr;
+    size_t pos = 0;
+
+    bool Valid() const {
+      return buffer != nullptr ? pos < buffer->size() : iter->Valid();
+    }
+    Slice key() const {
+      return buffer != nullptr ? Slice((*buffer)[pos].first) : iter->key();
+    }
+    Slice value() const {
+      return buffer != nullptr ? Slice((*buffer)[pos].second) : iter->value();
+    }
+    void Next() {
+      if (buffer != nullptr) {
+        pos++;
+      } else {
+        iter->Next();
+      }
+    }
+    // Seeks to the first key at or after `target`, or to the first key
+    // without a target
+    void Seek(const Comparator* ucmp, const std::string* target) {
+      if (buffer == nullptr) {
+        if (target == nullptr) {
+          iter->SeekToFirst();
+        } else {
+          iter->Seek(*target);
+        }
+        return;
+      }
+      if (target == nullptr) {
+        pos = 0;
+        return;
+      }
+      pos = std::lower_bound(buffer->begin(), buffer->end(), *target,
+                             [ucmp](const Buffer::value_type& e,
+                                    const std::string& t) {
+                               return ucmp->Compare(e.first, t) < 0;
+                             }) -
+            buffer->begin();
+    }
+    Status status() const {
+      return buffer != nullptr ? Status::OK() : iter->status();
+    }
+  };
+
+  Rep(DB* db, ColumnFamilyHandle* cfh, const BulkLoaderOptions& opts)
+      : db(db),
+        cfh(cfh != nullptr ? cfh : db->DefaultColumnFamily()),
+        options(opts) {}
+
+  Status Init();
+  Status Add(const Slice& key, const Slice& value);
+  Status SpillBuffer();
+  void SortAndSpill(Run* run, Buffer* buf);
+  Status WaitForOldestSpill();
+  Status Finish();
+  Status WriteRange(const std::vector<std::string>& boundaries, size_t range,
+                    std::vector<std::string>* files);
+  Status WriteOutputFiles(std::vector<std::string>* files);
+  Status WarmHotRange();
+  void RemoveTempFiles();
+
+  DB* const db;
+  ColumnFamilyHandle* const cfh;
+  const BulkLoaderOptions options;
+  Env* env = nullptr;
+  Options db_options;
+  // Of the run files, which are only read once
+  Options run_options;
+  const Comparator* ucmp = nullptr;
+  std::string temp_dir;
+  size_t num_threads = 1;
+  size_t buffer_limit = 0;
+  Status init_status;
+  bool finished = false;
+
+  Buffer buffer;
+  size_t buffer_bytes = 0;
+  std::vector<std::unique_ptr<Run>> runs;
+  // The spills in flight, oldest first
+  std::deque<std::pair<port::Thread, Run*>> spills;
+  std::vector<std::string> output_files;
+  size_t num_files_ingested = 0;
+};
+
+Status BulkLoader::Rep::Init() {
+  env = db->GetEnv();
+  db_options = db->GetOptions(cfh);
+  ucmp = db_options.comparator;
+  if (ucmp->timestamp_size() > 0) {
+    return Status::NotSupported("BulkLoader does not support timestamps");
+  }
+  if (options.num_threads < 1) {
+    return Status::InvalidArgument("num_threads must be at least 1");
+  }
+  num_threads = static_cast<size_t>(options.num_threads);
+  // The buffer being filled and one being spilled per thread
+  buffer_limit = std::max<size_t>(options.memory_budget / (num_threads + 1), 1);
+
+  run_options = db_options;
+  run_options.compression = kNoCompression;
+  run_options.bottommost_compression = kDisableCompressionOption;
+  run_options.compression_per_level.clear();
+  BlockBasedTableOptions run_table_options;
+  run_table_options.no_block_cache = true;
+  run_options.table_factory.reset(NewBlockBasedTableFactory(run_table_options));
+
+  temp_dir = options.temp_dir.empty() ? db->GetName() + "/bulk_loader"
+                                      : options.temp_dir;
+  return env->CreateDirIfMissing(temp_dir);
+}
+
+Status BulkLoader::Rep::Add(const Slice& key, const Slice& value) {
+  if (!init_status.ok()) {
+    return init_status;
+  }
+  if (finished) {
+    return Status::InvalidArgument("BulkLoader is finished");
+  }
+  buffer.emplace_back(key.ToString(), value.ToString());
+  buffer_bytes += key.size() + value.size() + kEntryOverhead;
+  if (buffer_bytes < buffer_limit) {
+    return Status::OK();
+  }
+  return SpillBuffer();
+}
+
+Status BulkLoader::Rep::SpillBuffer() {
+  if (spills.size() >= num_threads) {
+    Status s = WaitForOldestSpill();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  runs.emplace_back(new Run());
+  Run* run = runs.back().get();
+  run->fname = temp_dir + "/run_" + std::to_string(runs.size()) + ".sst";
+  spills.emplace_back(
+      port::Thread([this, run, buf = std::move(buffer)]() mutable {
+        SortAndSpill(run, &buf);
+      }),
+      run);
+  buffer = Buffer();
+  buffer_bytes = 0;
+  return Status::OK();
+}
+
+void BulkLoader::Rep::SortAndSpill(Run* run, Buffer* buf) {
+  run->samples = SortBuffer(ucmp, buf);
+  SstFileWriter writer(EnvOptions(run_options), run_options);
+  Status s = writer.Open(run->fname);
+  for (auto it = buf->begin(); s.ok() && it != buf->end(); ++it) {
+    s = writer.Put(it->first, it->second);
+  }
+  if (s.ok()) {
+    s = writer.Finish();
+  }
+  // Free the buffer before the next one is spilled in its place
+  Buffer().swap(*buf);
+  run->status = s;
+}
+
+Status BulkLoader::Rep::WaitForOldestSpill() {
+  spills.front().first.join();
+  Status s = spills.front().second->status;
+  spills.pop_front();
+  return s;
+}
+
+Status BulkLoader::Rep::Finish() {
+  if (finished) {
+    return Status::InvalidArgument("BulkLoader is finished");
+  }
+  finished = true;
+  Status s = init_status;
+  while (!spills.empty()) {
+    Status spill_status = WaitForOldestSpill();
+    if (s.ok()) {
+      s = spill_status;
+    }
+  }
+  if (s.ok() && !buffer.empty()) {
+    // The last run is merged from memory
+    runs.emplace_back(new Run());
+    Run* run = runs.back().get();
+    run->buffer = std::move(buffer);
+    run->samples = SortBuffer(ucmp, &run->buffer);
+  }
+  for (auto& run : runs) {
+    if (!s.ok()) {
+      break;
+    }
+    if (run->fname.empty()) {
+      continue;
+    }
+    run->reader.reset(new SstFileReader(run_options));
+    s = run->reader->Open(run->fname);
+  }
+  if (s.ok()) {
+    s = WriteOutputFiles(&output_files);
+  }
+  if (s.ok() && !output_files.empty()) {
+    s = db->IngestExternalFile(cfh, output_files, options.ingest_options);
+    if (s.ok()) {
+      num_files_ingested = output_files.size();
+    }
+  }
+  RemoveTempFiles();
+  if (s.ok() && !options.hot_end.empty()) {
+    s = WarmHotRange();
+  }
+  return s;
+}
+
+Status BulkLoader::Rep::WriteRange(const std::vector<std::string>& boundaries,
+                                   size_t range,
+                                   std::vector<std::string>* files) {
+  const std::string* lower = range > 0 ? &boundaries[range - 1] : nullptr;
+  const std::string* upper =
+      range < boundaries.size() ? &boundaries[range] : nullptr;
+
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  std::vector<Cursor> cursors(runs.size());
+  // Run indexes ordered by the next key of the run, the newest run first on
+  // equal keys
+  std::vector<size_t> heap;
+  auto after = [&](size_t a, size_t b) {
+    const int cmp = ucmp->Compare(cursors[a].key(), cursors[b].key());
+    return cmp > 0 || (cmp == 0 && a < b);
+  };
+  for (size_t i = 0; i < runs.size(); i++) {
+    if (runs[i]->reader != nullptr) {
+      cursors[i].iter.reset(runs[i]->reader->NewIterator(read_options));
+    } else {
+      cursors[i].buffer = &runs[i]->buffer;
+    }
+    cursors[i].Seek(ucmp, lower);
+    if (cursors[i].Valid()) {
+      heap.push_back(i);
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), after);
+
+  const uint64_t target_file_size = options.target_file_size > 0
+                                        ? options.target_file_size
+                                        : db_options.target_file_size_base;
+  std::unique_ptr<SstFileWriter> writer;
+  std::string last_key;
+  Status s;
+  while (s.ok() && !heap.empty()) {
+    Cursor& top = cursors[heap.front()];
+    if (upper != nullptr && ucmp->Compare(top.key(), *upper) >= 0) {
+      break;
+    }
+    if (writer == nullptr) {
+      files->push_back(temp_dir + "/out_" + std::to_string(range) + "_" +
+                       std::to_string(files->size()) + ".sst");
+      writer.reset(new SstFileWriter(EnvOptions(db_options), db_options, cfh));
+      s = writer->Open(files->back());
+      if (!s.ok()) {
+        break;
+      }
+    }
+    s = writer->Put(top.key(), top.value());
+    if (s.ok() && writer->FileSize() >= target_file_size) {
+      s = writer->Finish();
+      writer.reset();
+    }
+    // Skip the older values of the key
+    last_key.assign(top.key().data(), top.key().size());
+    do {
+      std::pop_heap(heap.begin(), heap.end(), after);
+      Cursor& cursor = cursors[heap.back()];
+      cursor.Next();
+      if (cursor.Valid()) {
+        std::push_heap(heap.begin(), heap.end(), after);
+      } else {
+        if (!cursor.status().ok() && s.ok()) {
+          s = cursor.status();
+        }
+        heap.pop_back();
+      }
+    } while (!heap.empty() &&
+             ucmp->Compare(cursors[heap.front()].key(), last_key) == 0);
+  }
+  for (auto& cursor : cursors) {
+    if (s.ok()) {
+      s = cursor.status();
+    }
+  }
+  if (s.ok() && writer != nullptr) {
+    s = writer->Finish();
+  }
+  return s;
+}
+
+Status BulkLoader::Rep::WriteOutputFiles(std::vector<std::string>* files) {
+  std::vector<std::string> samples;
+  for (auto& run : runs) {
+    samples.insert(samples.end(), run->samples.begin(), run->samples.end());
+  }
+  std::sort(samples.begin(), samples.end(),
+            [this](const std::string& a, const std::string& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  // Evenly spaced samples split the key space into ranges of about the same
+  // number of keys
+  const size_t num_ranges =
+      std::min(num_threads * kRangesPerThread, samples.size() + 1);
+  std::vector<std::string> boundaries;
+  for (size_t i = 1; i < num_ranges; i++) {
+    const std::string& key = samples[i * samples.size() / num_ranges];
+    if (boundaries.empty() || ucmp->Compare(boundaries.back(), key) < 0) {
+      boundaries.push_back(key);
+    }
+  }
+
+  std::vector<std::vector<std::string>> range_files(boundaries.size() + 1);
+  std::vector<Status> range_status(range_files.size());
+  std::atomic<size_t> next_range{0};
+  std::atomic<bool> failed{false};
+  auto worker = [&]() {
+    for (size_t range = next_range.fetch_add(1);
+         range < range_files.size() && !failed.load();
+         range = next_range.fetch_add(1)) {
+      range_status[range] = WriteRange(boundaries, range, &range_files[range]);
+      if (!range_status[range].ok()) {
+        failed.store(true);
+      }
+    }
+  };
+  std::vector<port::Thread> threads;
+  for (size_t i = 1; i < std::min(num_threads, range_files.size()); i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Keep all of the files, even of failed ranges, so that they are removed
+  for (size_t i = 0; i < range_files.size(); i++) {
+    files->insert(files->end(), range_files[i].begin(), range_files[i].end());
+  }
+  for (auto& s : range_status) {
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+Status BulkLoader::Rep::WarmHotRange() {
+  ReadOptions read_options;
+  Slice upper(options.hot_end);
+  read_options.iterate_upper_bound = &upper;
+  read_options.adaptive_readahead = true;
+  std::unique_ptr<Iterator> iter(db->NewIterator(read_options, cfh));
+  for (iter->Seek(options.hot_begin); iter->Valid(); iter->Next()) {
+    // Reading the values loads their blocks, with those of the keys
+    iter->value();
+  }
+  return iter->status();
+}
+
+void BulkLoader::Rep::RemoveTempFiles() {
+  for (auto& run : runs) {
+    run->reader.reset();
+    if (!run->fname.empty()) {
+      env->DeleteFile(run->fname).PermitUncheckedError();
+    }
+  }
+  runs.clear();
+  // Output files that were not moved into the DB
+  for (const auto& fname : output_files) {
+    if (env->FileExists(fname).ok()) {
+      env->DeleteFile(fname).PermitUncheckedError();
+    }
+  }
+  output_files.clear();
+  if (options.temp_dir.empty()) {
+    env->DeleteDir(temp_dir).PermitUncheckedError();
+  }
+}
+
+BulkLoader::BulkLoader(DB* db, ColumnFamilyHandle* column_family,
+                       const BulkLoaderOptions& options)
+    : rep_(new Rep(db, column_family, options)) {
+  rep_->init_status = rep_->Init();
+}
+
+BulkLoader::~BulkLoader() {
+  while (!rep_->spills.empty()) {
+    rep_->WaitForOldestSpill().PermitUncheckedError();
+  }
+  if (!rep_->finished && rep_->env != nullptr) {
+    rep_->RemoveTempFiles();
+  }
+}
+
+Status BulkLoader::Add(const Slice& key, const Slice& value) {
+  return rep_->Add(key, value);
+}
+
+Status BulkLoader::Finish() { return rep_->Finish(); }
+
+size_t BulkLoader::GetNumFilesIngested() const {
+  return rep_->num_files_ingested;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
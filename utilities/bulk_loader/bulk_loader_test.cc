@@ -0,0 +1,142 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/bulk_loader.h"
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class BulkLoaderTest : public DBTestBase {
+ public:
+  BulkLoaderTest() : DBTestBase("bulk_loader_test", /*env_do_fsync=*/false) {}
+
+ protected:
+  // Adds the keys of [0, num_keys) in a random order, and then the keys
+  // divisible by 10 again with their final values
+  void AddShuffled(BulkLoader* loader, int num_keys) {
+    std::vector<int> keys(num_keys);
+    for (int i = 0; i < num_keys; i++) {
+      keys[i] = i;
+    }
+    RandomShuffle(keys.begin(), keys.end(), 301);
+    for (int i : keys) {
+      const std::string prefix = i % 10 == 0 ? "old" : "v";
+      ASSERT_OK(loader->Add(Key(i), prefix + std::to_string(i)));
+    }
+    for (int i : keys) {
+      if (i % 10 == 0) {
+        ASSERT_OK(loader->Add(Key(i), "v" + std::to_string(i)));
+      }
+    }
+  }
+};
+
+TEST_F(BulkLoaderTest, LoadUnsortedKeys) {
+  Options options = CurrentOptions();
+  options.num_levels = 7;
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 20000;
+  BulkLoaderOptions bulk_options;
+  // Spills many runs
+  bulk_options.memory_budget = 64 << 10;
+  bulk_options.num_threads = 3;
+  bulk_options.target_file_size = 32 << 10;
+  {
+    BulkLoader loader(db_, nullptr, bulk_options);
+    AddShuffled(&loader, kNumKeys);
+    ASSERT_OK(loader.Finish());
+    ASSERT_GT(loader.GetNumFilesIngested(), 1u);
+    ASSERT_TRUE(loader.Add("x", "y").IsInvalidArgument());
+  }
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumKeys, count);
+
+  // All of the files are ingested into the bottommost level
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1u);
+  for (const auto& file : files) {
+    ASSERT_EQ(6, file.level);
+  }
+
+  // The temporary files are gone
+  ASSERT_TRUE(env_->FileExists(dbname_ + "/bulk_loader").IsNotFound());
+}
+
+TEST_F(BulkLoaderTest, InMemoryLoad) {
+  DestroyAndReopen(CurrentOptions());
+  BulkLoaderOptions bulk_options;
+  bulk_options.num_threads = 1;
+  BulkLoader loader(db_, db_->DefaultColumnFamily(), bulk_options);
+  AddShuffled(&loader, 1000);
+  ASSERT_OK(loader.Finish());
+  ASSERT_EQ(1u, loader.GetNumFilesIngested());
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+}
+
+TEST_F(BulkLoaderTest, NothingToLoad) {
+  DestroyAndReopen(CurrentOptions());
+  BulkLoader loader(db_, nullptr, BulkLoaderOptions());
+  ASSERT_OK(loader.Finish());
+  ASSERT_EQ(0u, loader.GetNumFilesIngested());
+  ASSERT_TRUE(loader.Finish().IsInvalidArgument());
+}
+
+TEST_F(BulkLoaderTest, WarmHotRange) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  BulkLoaderOptions bulk_options;
+  bulk_options.memory_budget = 64 << 10;
+  bulk_options.hot_begin = Key(1000);
+  bulk_options.hot_end = Key(2000);
+  BulkLoader loader(db_, nullptr, bulk_options);
+  AddShuffled(&loader, 10000);
+  ASSERT_OK(loader.Finish());
+
+  const uint64_t misses = TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  ASSERT_GT(misses, 0u);
+  for (int i = 1000; i < 2000; i++) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+  ASSERT_EQ(misses, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+}
+
+TEST_F(BulkLoaderTest, InvalidOptions) {
+  BulkLoaderOptions bulk_options;
+  bulk_options.num_threads = 0;
+  BulkLoader loader(db_, nullptr, bulk_options);
+  ASSERT_TRUE(loader.Add("a", "b").IsInvalidArgument());
+  ASSERT_TRUE(loader.Finish().IsInvalidArgument());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
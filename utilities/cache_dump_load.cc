@@ -9,7 +9,9 @@
 #include "port/lang.h"
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
+#include "rocksdb/trace_reader_writer.h"
 #include "table/format.h"
+#include "trace_replay/block_cache_tracer.h"
 #include "util/crc32c.h"
 #include "utilities/cache_dump_load_impl.h"
 
@@ -43,6 +45,27 @@ IOStatus NewFromFileCacheDumpReader(const std::shared_ptr<FileSystem>& fs,
   return io_s;
 }
 
+Status CountCacheEntryAccesses(Env* env, const std::string& trace_file,
+                               CacheEntryAccessCounts* counts) {
+  std::unique_ptr<TraceReader> trace_reader;
+  Status s = NewFileTraceReader(env, EnvOptions(), trace_file, &trace_reader);
+  if (!s.ok()) {
+    return s;
+  }
+  BlockCacheTraceReader reader(std::move(trace_reader));
+  BlockCacheTraceHeader header;
+  s = reader.ReadHeader(&header);
+  while (s.ok()) {
+    BlockCacheTraceRecord record;
+    s = reader.ReadAccess(&record);
+    if (s.ok() && !record.block_key.empty()) {
+      (*counts)[record.block_key]++;
+    }
+  }
+  // The end of the trace
+  return s.IsIncomplete() ? Status::OK() : s;
+}
+
 Status NewDefaultCacheDumper(const CacheDumpOptions& dump_options,
                              const std::shared_ptr<Cache>& cache,
                              std::unique_ptr<CacheDumpWriter>&& writer,
@@ -5,6 +5,8 @@
 
 #include "utilities/cache_dump_load_impl.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "cache/cache_entry_roles.h"
@@ -35,32 +37,42 @@ Status CacheDumperImpl::SetDumpFilter(std::vector<DB*> db_list) {
     if (!s.ok()) {
       return s;
     }
-    for (auto id = ptc.begin(); id != ptc.end(); id++) {
-      OffsetableCacheKey base;
-      // We only want to save cache entries that are portable to another
-      // DB::Open, so only save entries with stable keys.
-      bool is_stable;
-      BlockBasedTable::SetupBaseCacheKey(id->second.get(),
-                                         /*cur_db_session_id*/ "",
-                                         /*cur_file_num*/ 0, &base, &is_stable);
-      if (is_stable) {
-        Slice prefix_slice = base.CommonPrefixSlice();
-        assert(prefix_slice.size() == OffsetableCacheKey::kCommonPrefixSize);
-        prefix_filter_.insert(prefix_slice.ToString());
-      }
-    }
+    AddToDumpFilter(ptc);
   }
   return s;
 }
 
+void CacheDumperImpl::AddToDumpFilter(const TablePropertiesCollection& props) {
+  dump_all_keys_ = false;
+  for (auto id = props.begin(); id != props.end(); id++) {
+    OffsetableCacheKey base;
+    // We only want to save cache entries that are portable to another
+    // DB::Open, so only save entries with stable keys.
+    bool is_stable;
+    BlockBasedTable::SetupBaseCacheKey(id->second.get(),
+                                       /*cur_db_session_id*/ "",
+                                       /*cur_file_num*/ 0, &base, &is_stable);
+    if (is_stable) {
+      Slice prefix_slice = base.CommonPrefixSlice();
+      assert(prefix_slice.size() == OffsetableCacheKey::kCommonPrefixSize);
+      prefix_filter_.insert(prefix_slice.ToString());
+    }
+  }
+}
+
 // This is the main function to dump out the cache block entries to the writer.
 // The writer may create a file or write to other systems. Currently, we will
 // iterate the whole block cache, get the blocks, and write them to the writer
 IOStatus CacheDumperImpl::DumpCacheEntriesToWriter() {
   // Prepare stage, check the parameters.
-  if (cache_ == nullptr) {
+  if (caches_.empty()) {
     return IOStatus::InvalidArgument("Cache is null");
   }
+  for (const auto& cache : caches_) {
+    if (cache == nullptr) {
+      return IOStatus::InvalidArgument("Cache is null");
+    }
+  }
   if (writer_ == nullptr) {
     return IOStatus::InvalidArgument("CacheDumpWriter is null");
   }
@@ -72,6 +84,19 @@ IOStatus CacheDumperImpl::DumpCacheEntriesToWriter() {
 
   deadline_ = options_.deadline;
 
+  if (!(options_.hot_entries_ratio >= 0.0 &&
+        options_.hot_entries_ratio <= 1.0)) {
+    return IOStatus::InvalidArgument("hot_entries_ratio must be in [0, 1]");
+  }
+  only_hot_entries_ = options_.hot_entries_ratio < 1.0;
+  if (only_hot_entries_) {
+    if (options_.access_counts == nullptr) {
+      return IOStatus::InvalidArgument(
+          "hot_entries_ratio less than 1 requires access_counts");
+    }
+    SetMinAccessCount();
+  }
+
   // Set the sequence number
   sequence_num_ = 0;
 
@@ -82,9 +107,14 @@ IOStatus CacheDumperImpl::DumpCacheEntriesToWriter() {
   }
 
   // Then, we iterate the block cache and dump out the blocks that are not
-  // filtered out.
+  // filtered out. Index and filter blocks go first, for the loader to have
+  // them in the cache before the data blocks they lead to.
   std::string buf;
-  cache_->ApplyToAllEntries(DumpOneBlockCallBack(buf), {});
+  for (bool data_blocks : {false, true}) {
+    for (const auto& cache : caches_) {
+      cache->ApplyToAllEntries(DumpOneBlockCallBack(buf, data_blocks), {});
+    }
+  }
 
   // Finally, write the footer
   io_s = WriteFooter();
@@ -106,19 +136,99 @@ bool CacheDumperImpl::ShouldFilterOut(const Slice& key) {
   return prefix_filter_.find(prefix) == prefix_filter_.end();
 }
 
+// Returns the type under which the entry is dumped, or kBlockTypeMax if it
+// is not to be dumped because it cannot be saved, is not a block of a table
+// or is filtered out.
+CacheDumpUnitType CacheDumperImpl::GetDumpUnitType(
+    const Slice& key, const Cache::CacheItemHelper* helper) {
+  if (helper == nullptr || helper->size_cb == nullptr ||
+      helper->saveto_cb == nullptr) {
+    // Not compatible with dumping. Skip this entry.
+    return CacheDumpUnitType::kBlockTypeMax;
+  }
+
+  CacheDumpUnitType type = CacheDumpUnitType::kBlockTypeMax;
+  switch (helper->role) {
+    case CacheEntryRole::kDataBlock:
+      type = CacheDumpUnitType::kData;
+      break;
+    case CacheEntryRole::kFilterBlock:
+      type = CacheDumpUnitType::kFilter;
+      break;
+    case CacheEntryRole::kFilterMetaBlock:
+      type = CacheDumpUnitType::kFilterMetaBlock;
+      break;
+    case CacheEntryRole::kIndexBlock:
+      type = CacheDumpUnitType::kIndex;
+      break;
+    default:
+      // Filter out other entries
+      // FIXME? Do we need the CacheDumpUnitTypes? UncompressionDict?
+      return CacheDumpUnitType::kBlockTypeMax;
+  }
+
+  // based on the key prefix, check if the block should be filter out.
+  if (!dump_all_keys_ && ShouldFilterOut(key)) {
+    return CacheDumpUnitType::kBlockTypeMax;
+  }
+  return type;
+}
+
+uint64_t CacheDumperImpl::GetAccessCount(const Slice& key) const {
+  auto it = options_.access_counts->find(key.ToString());
+  return it == options_.access_counts->end() ? 0 : it->second;
+}
+
+// Finds the access count the entries need to be among the
+// `hot_entries_ratio` most accessed ones, by counting the accesses of all the
+// entries to dump first.
+void CacheDumperImpl::SetMinAccessCount() {
+  std::vector<uint64_t> counts;
+  for (const auto& cache : caches_) {
+    cache->ApplyToAllEntries(
+        [&](const Slice& key, Cache::ObjectPtr /*value*/, size_t /*charge*/,
+            const Cache::CacheItemHelper* helper) {
+          if (GetDumpUnitType(key, helper) !=
+              CacheDumpUnitType::kBlockTypeMax) {
+            counts.push_back(GetAccessCount(key));
+          }
+        },
+        {});
+  }
+  const size_t num_hot = static_cast<size_t>(
+      std::ceil(static_cast<double>(counts.size()) *
+                options_.hot_entries_ratio));
+  if (num_hot == 0) {
+    min_access_count_ = std::numeric_limits<uint64_t>::max();
+    num_min_access_count_left_ = 0;
+    return;
+  }
+  std::nth_element(counts.begin(), counts.begin() + (num_hot - 1),
+                   counts.end(), std::greater<uint64_t>());
+  min_access_count_ = counts[num_hot - 1];
+  // Only as many of the entries accessed exactly `min_access_count_` times
+  // are dumped as fit in `num_hot`.
+  num_min_access_count_left_ =
+      num_hot - std::count_if(counts.begin(), counts.end(), [&](uint64_t n) {
+        return n > min_access_count_;
+      });
+}
+
 // This is the callback function which will be applied to
 // Cache::ApplyToAllEntries. In this callback function, we will get the block
 // type, decide if the block needs to be dumped based on the filter, and write
 // the block through the provided writer. `buf` is passed in for efficiennt
-// reuse.
+// reuse. Only data blocks are written if `data_blocks`, only the others
+// otherwise.
 std::function<void(const Slice&, Cache::ObjectPtr, size_t,
                    const Cache::CacheItemHelper*)>
-CacheDumperImpl::DumpOneBlockCallBack(std::string& buf) {
-  return [&](const Slice& key, Cache::ObjectPtr value, size_t /*charge*/,
-             const Cache::CacheItemHelper* helper) {
-    if (helper == nullptr || helper->size_cb == nullptr ||
-        helper->saveto_cb == nullptr) {
-      // Not compatible with dumping. Skip this entry.
+CacheDumperImpl::DumpOneBlockCallBack(std::string& buf, bool data_blocks) {
+  return [&buf, data_blocks, this](const Slice& key, Cache::ObjectPtr value,
+                                   size_t /*charge*/,
+                                   const Cache::CacheItemHelper* helper) {
+    const CacheDumpUnitType type = GetDumpUnitType(key, helper);
+    if (type == CacheDumpUnitType::kBlockTypeMax ||
+        (type == CacheDumpUnitType::kData) != data_blocks) {
       return;
     }
 
@@ -135,31 +245,17 @@ CacheDumperImpl::DumpOneBlockCallBack(std::string& buf) {
       }
     }
 
-    CacheEntryRole role = helper->role;
-    CacheDumpUnitType type = CacheDumpUnitType::kBlockTypeMax;
-
-    switch (role) {
-      case CacheEntryRole::kDataBlock:
-        type = CacheDumpUnitType::kData;
-        break;
-      case CacheEntryRole::kFilterBlock:
-        type = CacheDumpUnitType::kFilter;
-        break;
-      case CacheEntryRole::kFilterMetaBlock:
-        type = CacheDumpUnitType::kFilterMetaBlock;
-        break;
-      case CacheEntryRole::kIndexBlock:
-        type = CacheDumpUnitType::kIndex;
-        break;
-      default:
-        // Filter out other entries
-        // FIXME? Do we need the CacheDumpUnitTypes? UncompressionDict?
+    if (only_hot_entries_) {
+      const uint64_t count = GetAccessCount(key);
+      if (count < min_access_count_) {
         return;
-    }
-
-    // based on the key prefix, check if the block should be filter out.
-    if (!dump_all_keys_ && ShouldFilterOut(key)) {
-      return;
+      }
+      if (count == min_access_count_) {
+        if (num_min_access_count_left_ == 0) {
+          return;
+        }
+        num_min_access_count_left_--;
+      }
     }
 
     assert(type != CacheDumpUnitType::kBlockTypeMax);
@@ -254,12 +350,20 @@ IOStatus CacheDumperImpl::WriteFooter() {
 // First, we check if all the arguments are valid. Then, we read the block
 // sequentially from the reader and insert them to the secondary cache.
 IOStatus CacheDumpedLoaderImpl::RestoreCacheEntriesToSecondaryCache() {
-  // TODO: remove this line when options are used in the loader
-  (void)options_;
-  // Step 1: we check if all the arguments are valid
   if (secondary_cache_ == nullptr) {
     return IOStatus::InvalidArgument("Secondary Cache is null");
   }
+  return RestoreCacheEntries([this](const Slice& key, CacheEntryRole /*role*/,
+                                    const Slice& saved) {
+    return secondary_cache_->InsertSaved(key, saved);
+  });
+}
+
+IOStatus CacheDumpedLoaderImpl::RestoreCacheEntries(
+    const RestoreCallback& restore) {
+  // TODO: remove this line when options are used in the loader
+  (void)options_;
+  // Step 1: we check if all the arguments are valid
   if (reader_ == nullptr) {
     return IOStatus::InvalidArgument("CacheDumpReader is null");
   }
@@ -288,11 +392,30 @@ IOStatus CacheDumpedLoaderImpl::RestoreCacheEntriesToSecondaryCache() {
     if (dump_unit.type == CacheDumpUnitType::kFooter) {
       break;
     }
+    CacheEntryRole role;
+    switch (dump_unit.type) {
+      case CacheDumpUnitType::kData:
+        role = CacheEntryRole::kDataBlock;
+        break;
+      case CacheDumpUnitType::kFilter:
+        role = CacheEntryRole::kFilterBlock;
+        break;
+      case CacheDumpUnitType::kFilterMetaBlock:
+        role = CacheEntryRole::kFilterMetaBlock;
+        break;
+      case CacheDumpUnitType::kIndex:
+        role = CacheEntryRole::kIndexBlock;
+        break;
+      default:
+        // Not written by CacheDumperImpl
+        role = CacheEntryRole::kMisc;
+        break;
+    }
     // Create the uncompressed_block based on the information in the dump_unit
     // (There is no block trailer here compatible with block-based SST file.)
     Slice content =
         Slice(static_cast<char*>(dump_unit.value), dump_unit.value_len);
-    Status s = secondary_cache_->InsertSaved(dump_unit.key, content);
+    Status s = restore(dump_unit.key, role, content);
     if (!s.ok()) {
       io_s = status_to_io_status(std::move(s));
     }
@@ -96,11 +96,23 @@ class CacheDumperImpl : public CacheDumper {
   CacheDumperImpl(const CacheDumpOptions& dump_options,
                   const std::shared_ptr<Cache>& cache,
                   std::unique_ptr<CacheDumpWriter>&& writer)
-      : options_(dump_options), cache_(cache), writer_(std::move(writer)) {
+      : CacheDumperImpl(dump_options,
+                        std::vector<std::shared_ptr<Cache>>{cache},
+                        std::move(writer)) {}
+  // Dumps the entries of all the `caches`, in order, as a single dump.
+  CacheDumperImpl(const CacheDumpOptions& dump_options,
+                  std::vector<std::shared_ptr<Cache>> caches,
+                  std::unique_ptr<CacheDumpWriter>&& writer)
+      : options_(dump_options),
+        caches_(std::move(caches)),
+        writer_(std::move(writer)) {
     dumped_size_bytes_ = 0;
   }
   ~CacheDumperImpl() { writer_.reset(); }
   Status SetDumpFilter(std::vector<DB*> db_list) override;
+  // Like SetDumpFilter(), for the tables of `props`. Can be called more than
+  // once to dump the blocks of several sets of tables.
+  void AddToDumpFilter(const TablePropertiesCollection& props);
   IOStatus DumpCacheEntriesToWriter() override;
 
  private:
@@ -109,12 +121,16 @@ class CacheDumperImpl : public CacheDumper {
   IOStatus WriteHeader();
   IOStatus WriteFooter();
   bool ShouldFilterOut(const Slice& key);
+  CacheDumpUnitType GetDumpUnitType(const Slice& key,
+                                    const Cache::CacheItemHelper* helper);
+  uint64_t GetAccessCount(const Slice& key) const;
+  void SetMinAccessCount();
   std::function<void(const Slice&, Cache::ObjectPtr, size_t,
                      const Cache::CacheItemHelper*)>
-  DumpOneBlockCallBack(std::string& buf);
+  DumpOneBlockCallBack(std::string& buf, bool data_blocks);
 
   CacheDumpOptions options_;
-  std::shared_ptr<Cache> cache_;
+  std::vector<std::shared_ptr<Cache>> caches_;
   std::unique_ptr<CacheDumpWriter> writer_;
   SystemClock* clock_;
   uint32_t sequence_num_;
@@ -128,6 +144,12 @@ class CacheDumperImpl : public CacheDumper {
   uint64_t dumped_size_bytes_;
   // dump all keys of cache if user doesn't call SetDumpFilter
   bool dump_all_keys_ = true;
+  // Only the entries accessed at least `min_access_count_` times are dumped
+  // if CacheDumpOptions::hot_entries_ratio is less than 1, and no more than
+  // `num_min_access_count_left_` of those accessed exactly that many times.
+  bool only_hot_entries_ = false;
+  uint64_t min_access_count_ = 0;
+  size_t num_min_access_count_left_ = 0;
 };
 
 // The default implementation of CacheDumpedLoader
@@ -143,6 +165,16 @@ class CacheDumpedLoaderImpl : public CacheDumpedLoader {
   ~CacheDumpedLoaderImpl() {}
   IOStatus RestoreCacheEntriesToSecondaryCache() override;
 
+  // Called for each dumped block with its cache key, the role it had in the
+  // cache and its saved (persistable) data. A non-OK status stops the
+  // restore and is returned by RestoreCacheEntries().
+  using RestoreCallback = std::function<Status(
+      const Slice& key, CacheEntryRole role, const Slice& saved)>;
+
+  // Reads the dumped blocks in order and passes them to `restore`, which
+  // decides where to insert them. Needs no secondary cache.
+  IOStatus RestoreCacheEntries(const RestoreCallback& restore);
+
  private:
   IOStatus ReadDumpUnitMeta(std::string* data, DumpUnitMeta* unit_meta);
   IOStatus ReadDumpUnit(size_t len, std::string* data, DumpUnit* unit);
@@ -10,15 +10,18 @@
 #include "utilities/checkpoint/checkpoint_impl.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "db/wal_manager.h"
 #include "file/file_util.h"
 #include "file/filename.h"
+#include "file/writable_file_writer.h"
 #include "logging/logging.h"
 #include "port/port.h"
 #include "rocksdb/db.h"
@@ -31,6 +34,7 @@
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 #include "util/file_checksum_helper.h"
+#include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -45,6 +49,117 @@ Status Checkpoint::CreateCheckpoint(const std::string& /*checkpoint_dir*/,
   return Status::NotSupported("");
 }
 
+Status Checkpoint::CreateIncrementalCheckpoint(
+    const std::string& /*checkpoint_dir*/,
+    const IncrementalCheckpointOptions& /*options*/,
+    uint64_t* /*sequence_number_ptr*/) {
+  return Status::NotSupported("");
+}
+
+namespace {
+// The file of an incremental checkpoint that lists its SST and blob files, one
+// per line with the name, size, hex checksum and checksum function name of the
+// file separated by tabs.
+const std::string kCheckpointFilesName = "CHECKPOINT_FILES";
+
+struct CheckpointFileInfo {
+  uint64_t size = 0;
+  std::string checksum;
+  std::string checksum_func_name;
+};
+
+void AppendCheckpointFile(const std::string& fname,
+                          const CheckpointFileInfo& info,
+                          std::string* contents) {
+  contents->append(fname + "\t" + std::to_string(info.size) + "\t" +
+                   Slice(info.checksum).ToString(true /* hex */) + "\t" +
+                   info.checksum_func_name + "\n");
+}
+
+Status ParseCheckpointFiles(
+    const std::string& contents,
+    std::unordered_map<std::string, CheckpointFileInfo>* files) {
+  for (const auto& line : StringSplit(contents, '\n')) {
+    std::vector<std::string> fields = StringSplit(line, '\t');
+    CheckpointFileInfo info;
+    bool valid = fields.size() == 4;
+    if (valid) {
+      Slice size(fields[1]);
+      valid = ConsumeDecimalNumber(&size, &info.size) && size.empty() &&
+              Slice(fields[2]).DecodeHex(&info.checksum);
+    }
+    if (!valid) {
+      return Status::Corruption("Invalid line in " + kCheckpointFilesName,
+                                line);
+    }
+    info.checksum_func_name = fields[3];
+    (*files)[fields[0]] = std::move(info);
+  }
+  return Status::OK();
+}
+
+struct CheckpointFileCopy {
+  std::string src_path;
+  std::string fname;
+  uint64_t size;
+  Temperature temperature;
+};
+
+// Copies the files into `dst_dir` with up to `num_threads` threads, and with
+// the writes limited by `rate_limiter` if not nullptr.
+IOStatus CopyCheckpointFiles(FileSystem* fs,
+                             const std::vector<CheckpointFileCopy>& copies,
+                             const std::string& dst_dir, int num_threads,
+                             RateLimiter* rate_limiter, bool use_fsync) {
+  std::vector<IOStatus> statuses(copies.size());
+  std::atomic<size_t> next_copy{0};
+  auto copy_files = [&]() {
+    for (size_t i = next_copy.fetch_add(1); i < copies.size();
+         i = next_copy.fetch_add(1)) {
+      const CheckpointFileCopy& copy = copies[i];
+      const std::string dst_path = dst_dir + "/" + copy.fname;
+      FileOptions file_options;
+      file_options.temperature = copy.temperature;
+      file_options.rate_limiter = rate_limiter;
+      std::unique_ptr<FSWritableFile> file;
+      statuses[i] =
+          fs->NewWritableFile(dst_path, file_options, &file, nullptr);
+      if (!statuses[i].ok()) {
+        continue;
+      }
+      std::unique_ptr<WritableFileWriter> writer(
+          new WritableFileWriter(std::move(file), dst_path, file_options));
+      IOOptions write_options;
+      write_options.rate_limiter_priority = Env::IO_LOW;
+      statuses[i] =
+          CopyFile(fs, copy.src_path, copy.temperature, writer, copy.size,
+                   use_fsync, nullptr /* io_tracer */,
+                   4096 /* max_read_buffer_size */, {} /* readIOOptions */,
+                   write_options);
+      if (statuses[i].ok()) {
+        statuses[i] = writer->Close(write_options);
+      }
+    }
+  };
+  std::vector<port::Thread> threads;
+  for (size_t i = 1; i < static_cast<size_t>(std::max(num_threads, 1)) &&
+                     i < copies.size();
+       i++) {
+    threads.emplace_back(copy_files);
+  }
+  copy_files();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& io_s : statuses) {
+    if (!io_s.ok()) {
+      return io_s;
+    }
+  }
+  return IOStatus::OK();
+}
+}  // namespace
+
 Status CheckpointImpl::CleanStagingDirectory(
     const std::string& full_private_path, Logger* info_log) {
   std::vector<std::string> subchildren;
@@ -88,10 +203,11 @@ Status Checkpoint::ExportColumnFamily(
   return Status::NotSupported("");
 }
 
-// Builds an openable snapshot of RocksDB
-Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
-                                        uint64_t log_size_for_flush,
-                                        uint64_t* sequence_number_ptr) {
+Status CheckpointImpl::CreateCheckpointWithStaging(
+    const std::string& checkpoint_dir,
+    const std::function<Status(const std::string& staging_dir,
+                               uint64_t* sequence_number)>& create_files,
+    uint64_t* sequence_number_ptr) {
   DBOptions db_options = db_->GetDBOptions();
 
   Status file_exists_s = db_->GetEnv()->FileExists(checkpoint_dir);
@@ -142,33 +258,7 @@ Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
     const bool disabled_file_deletions = s.ok();
 
     if (s.ok() || s.IsNotSupported()) {
-      s = CreateCustomCheckpoint(
-          [&](const std::string& src_dirname, const std::string& fname,
-              FileType) {
-            ROCKS_LOG_INFO(db_options.info_log, "Hard Linking %s",
-                           fname.c_str());
-            return db_->GetFileSystem()->LinkFile(
-                src_dirname + "/" + fname, full_private_path + "/" + fname,
-                IOOptions(), nullptr);
-          } /* link_file_cb */,
-          [&](const std::string& src_dirname, const std::string& fname,
-              uint64_t size_limit_bytes, FileType,
-              const std::string& /* checksum_func_name */,
-              const std::string& /* checksum_val */,
-              const Temperature temperature) {
-            ROCKS_LOG_INFO(db_options.info_log, "Copying %s", fname.c_str());
-            return CopyFile(db_->GetFileSystem(), src_dirname + "/" + fname,
-                            temperature, full_private_path + "/" + fname,
-                            temperature, size_limit_bytes, db_options.use_fsync,
-                            nullptr);
-          } /* copy_file_cb */,
-          [&](const std::string& fname, const std::string& contents, FileType) {
-            ROCKS_LOG_INFO(db_options.info_log, "Creating %s", fname.c_str());
-            return CreateFile(db_->GetFileSystem(),
-                              full_private_path + "/" + fname, contents,
-                              db_options.use_fsync);
-          } /* create_file_cb */,
-          &sequence_number, log_size_for_flush);
+      s = create_files(full_private_path, &sequence_number);
 
       // we copied all the files, enable file deletions
       if (disabled_file_deletions) {
@@ -216,6 +306,157 @@ Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
   return s;
 }
 
+// Builds an openable snapshot of RocksDB
+Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
+                                        uint64_t log_size_for_flush,
+                                        uint64_t* sequence_number_ptr) {
+  DBOptions db_options = db_->GetDBOptions();
+  return CreateCheckpointWithStaging(
+      checkpoint_dir,
+      [&](const std::string& full_private_path, uint64_t* sequence_number) {
+        return CreateCustomCheckpoint(
+            [&](const std::string& src_dirname, const std::string& fname,
+                FileType) {
+              ROCKS_LOG_INFO(db_options.info_log, "Hard Linking %s",
+                             fname.c_str());
+              return db_->GetFileSystem()->LinkFile(
+                  src_dirname + "/" + fname, full_private_path + "/" + fname,
+                  IOOptions(), nullptr);
+            } /* link_file_cb */,
+            [&](const std::string& src_dirname, const std::string& fname,
+                uint64_t size_limit_bytes, FileType,
+                const std::string& /* checksum_func_name */,
+                const std::string& /* checksum_val */,
+                const Temperature temperature) {
+              ROCKS_LOG_INFO(db_options.info_log, "Copying %s", fname.c_str());
+              return CopyFile(db_->GetFileSystem(), src_dirname + "/" + fname,
+                              temperature, full_private_path + "/" + fname,
+                              temperature, size_limit_bytes,
+                              db_options.use_fsync, nullptr);
+            } /* copy_file_cb */,
+            [&](const std::string& fname, const std::string& contents,
+                FileType) {
+              ROCKS_LOG_INFO(db_options.info_log, "Creating %s",
+                             fname.c_str());
+              return CreateFile(db_->GetFileSystem(),
+                                full_private_path + "/" + fname, contents,
+                                db_options.use_fsync);
+            } /* create_file_cb */,
+            sequence_number, log_size_for_flush);
+      },
+      sequence_number_ptr);
+}
+
+Status CheckpointImpl::CreateIncrementalCheckpoint(
+    const std::string& checkpoint_dir,
+    const IncrementalCheckpointOptions& options,
+    uint64_t* sequence_number_ptr) {
+  DBOptions db_options = db_->GetDBOptions();
+  FileSystem* fs = db_->GetFileSystem();
+  std::unordered_map<std::string, CheckpointFileInfo> base_files;
+  if (!options.base_checkpoint_dir.empty()) {
+    std::string contents;
+    Status s = ReadFileToString(
+        fs, options.base_checkpoint_dir + "/" + kCheckpointFilesName,
+        &contents);
+    if (s.ok()) {
+      s = ParseCheckpointFiles(contents, &base_files);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  return CreateCheckpointWithStaging(
+      checkpoint_dir,
+      [&](const std::string& full_private_path, uint64_t* sequence_number) {
+        // The files are linked from the DB or the base checkpoint when
+        // possible, and the rest are copied once all the files are known.
+        std::vector<CheckpointFileCopy> copies;
+        std::string checkpoint_files;
+        bool same_fs = true;
+        Status s = CreateCustomCheckpoint(
+            [](const std::string&, const std::string&, FileType) {
+              // Linked by copy_file_cb, which knows the checksums to record
+              return Status::NotSupported();
+            } /* link_file_cb */,
+            [&](const std::string& src_dirname, const std::string& fname,
+                uint64_t size_limit_bytes, FileType type,
+                const std::string& checksum_func_name,
+                const std::string& checksum_val,
+                const Temperature temperature) {
+              const std::string dst_path = full_private_path + "/" + fname;
+              if (type == kTableFile || type == kBlobFile) {
+                CheckpointFileInfo info;
+                info.size = size_limit_bytes;
+                info.checksum = checksum_val;
+                info.checksum_func_name = checksum_func_name;
+                AppendCheckpointFile(fname, info, &checkpoint_files);
+                Status link_s;
+                if (same_fs) {
+                  link_s = fs->LinkFile(src_dirname + "/" + fname, dst_path,
+                                        IOOptions(), nullptr);
+                  TEST_SYNC_POINT_CALLBACK(
+                      "CheckpointImpl::CreateIncrementalCheckpoint:LinkFile",
+                      &link_s);
+                  if (link_s.ok() || !link_s.IsNotSupported()) {
+                    return link_s;
+                  }
+                  same_fs = false;
+                }
+                auto base_file = base_files.find(fname);
+                if (base_file != base_files.end() &&
+                    base_file->second.size == info.size &&
+                    base_file->second.checksum == info.checksum &&
+                    base_file->second.checksum_func_name ==
+                        info.checksum_func_name) {
+                  ROCKS_LOG_INFO(db_options.info_log,
+                                 "Hard Linking %s from %s", fname.c_str(),
+                                 options.base_checkpoint_dir.c_str());
+                  link_s = fs->LinkFile(
+                      options.base_checkpoint_dir + "/" + fname, dst_path,
+                      IOOptions(), nullptr);
+                  if (link_s.ok()) {
+                    return link_s;
+                  }
+                  ROCKS_LOG_WARN(db_options.info_log,
+                                 "Failed to hard link %s from %s: %s",
+                                 fname.c_str(),
+                                 options.base_checkpoint_dir.c_str(),
+                                 link_s.ToString().c_str());
+                }
+              }
+              TEST_SYNC_POINT_CALLBACK(
+                  "CheckpointImpl::CreateIncrementalCheckpoint:CopyFile",
+                  const_cast<std::string*>(&fname));
+              copies.push_back({src_dirname + "/" + fname, fname,
+                                size_limit_bytes, temperature});
+              return Status::OK();
+            } /* copy_file_cb */,
+            [&](const std::string& fname, const std::string& contents,
+                FileType) {
+              return CreateFile(fs, full_private_path + "/" + fname, contents,
+                                db_options.use_fsync);
+            } /* create_file_cb */,
+            sequence_number, options.log_size_for_flush,
+            true /* get_live_table_checksum */);
+        if (s.ok()) {
+          ROCKS_LOG_INFO(db_options.info_log,
+                         "Copying %" ROCKSDB_PRIszt " files", copies.size());
+          s = CopyCheckpointFiles(fs, copies, full_private_path,
+                                  options.max_background_copies,
+                                  options.rate_limiter.get(),
+                                  db_options.use_fsync);
+        }
+        if (s.ok()) {
+          s = CreateFile(fs, full_private_path + "/" + kCheckpointFilesName,
+                         checkpoint_files, db_options.use_fsync);
+        }
+        return s;
+      },
+      sequence_number_ptr);
+}
+
 Status CheckpointImpl::CreateCustomCheckpoint(
     std::function<Status(const std::string& src_dirname,
                          const std::string& src_fname, FileType type)>
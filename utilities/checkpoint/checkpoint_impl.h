@@ -21,6 +21,11 @@ class CheckpointImpl : public Checkpoint {
                           uint64_t log_size_for_flush,
                           uint64_t* sequence_number_ptr) override;
 
+  Status CreateIncrementalCheckpoint(
+      const std::string& checkpoint_dir,
+      const IncrementalCheckpointOptions& options,
+      uint64_t* sequence_number_ptr) override;
+
   Status ExportColumnFamily(ColumnFamilyHandle* handle,
                             const std::string& export_dir,
                             ExportImportFilesMetaData** metadata) override;
@@ -46,6 +51,15 @@ class CheckpointImpl : public Checkpoint {
  private:
   Status CleanStagingDirectory(const std::string& path, Logger* info_log);
 
+  // Creates the checkpoint files in a staging directory with `create_files`,
+  // with the file deletions disabled, and then renames the staging directory
+  // to checkpoint_dir.
+  Status CreateCheckpointWithStaging(
+      const std::string& checkpoint_dir,
+      const std::function<Status(const std::string& staging_dir,
+                                 uint64_t* sequence_number)>& create_files,
+      uint64_t* sequence_number_ptr);
+
   // Export logic customization by providing callbacks for link or copy.
   Status ExportFilesInMetaData(
       const DBOptions& db_options, const ColumnFamilyMetaData& metadata,
@@ -24,6 +24,7 @@
 #include "port/stack_trace.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/file_checksum.h"
 #include "rocksdb/rocksdb_namespace.h"
 #include "rocksdb/sst_file_manager.h"
 #include "rocksdb/utilities/transaction_db.h"
@@ -372,6 +373,72 @@ TEST_F(CheckpointTest, CheckpointWithBlob) {
   ASSERT_EQ(value, blob);
 }
 
+TEST_F(CheckpointTest, IncrementalCheckpoint) {
+  Options options = CurrentOptions();
+  options.file_checksum_gen_factory = GetFileChecksumGenCrc32cFactory();
+  Reopen(options);
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(Flush());
+
+  // Copy the files as if the checkpoints were on another file system than
+  // the DB
+  std::atomic<int> num_copied_ssts{0};
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "CheckpointImpl::CreateIncrementalCheckpoint:LinkFile", [&](void* arg) {
+        *static_cast<Status*>(arg) = Status::NotSupported();
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "CheckpointImpl::CreateIncrementalCheckpoint:CopyFile", [&](void* arg) {
+        auto file_name = *static_cast<std::string*>(arg);
+        if (file_name.size() >= 4 &&
+            file_name.compare(file_name.size() - 4, 4, ".sst") == 0) {
+          num_copied_ssts.fetch_add(1);
+        }
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  Checkpoint* checkpoint = nullptr;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+  std::unique_ptr<Checkpoint> checkpoint_guard(checkpoint);
+  const std::string base_dir = snapshot_name_ + "_base";
+  DestroyDir(env_, base_dir).PermitUncheckedError();
+  IncrementalCheckpointOptions checkpoint_options;
+  checkpoint_options.max_background_copies = 2;
+  ASSERT_OK(
+      checkpoint->CreateIncrementalCheckpoint(base_dir, checkpoint_options));
+  ASSERT_EQ(1, num_copied_ssts.load());
+
+  // Only the new SST file is copied
+  ASSERT_OK(Put("bar", "v2"));
+  ASSERT_OK(Flush());
+  num_copied_ssts = 0;
+  checkpoint_options.base_checkpoint_dir = base_dir;
+  ASSERT_OK(checkpoint->CreateIncrementalCheckpoint(snapshot_name_,
+                                                    checkpoint_options));
+  ASSERT_EQ(1, num_copied_ssts.load());
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+
+  // A base checkpoint created by CreateCheckpoint() cannot be used
+  const std::string other_dir = snapshot_name_ + "_other";
+  DestroyDir(env_, other_dir).PermitUncheckedError();
+  checkpoint_options.base_checkpoint_dir = dbname_;
+  ASSERT_TRUE(
+      checkpoint->CreateIncrementalCheckpoint(other_dir, checkpoint_options)
+          .IsPathNotFound());
+
+  options.create_if_missing = false;
+  DB* checkpoint_db = nullptr;
+  ASSERT_OK(DB::Open(options, snapshot_name_, &checkpoint_db));
+  std::string value;
+  ASSERT_OK(checkpoint_db->Get(ReadOptions(), "foo", &value));
+  ASSERT_EQ("v1", value);
+  ASSERT_OK(checkpoint_db->Get(ReadOptions(), "bar", &value));
+  ASSERT_EQ("v2", value);
+  delete checkpoint_db;
+  ASSERT_OK(DestroyDir(env_, snapshot_name_));
+  ASSERT_OK(DestroyDir(env_, base_dir));
+}
+
 TEST_F(CheckpointTest, ExportColumnFamilyWithLinks) {
   // Create a database
   auto options = CurrentOptions();
@@ -0,0 +1,276 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/io_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "port/port.h"
+#include "rocksdb/system_clock.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+enum class IOClass { kForeground, kBackground, kUnscheduled };
+
+IOClass Classify(const IOOptions& options) {
+  switch (options.io_activity) {
+    case Env::IOActivity::kGet:
+    case Env::IOActivity::kMultiGet:
+    case Env::IOActivity::kDBIterator:
+    case Env::IOActivity::kGetEntity:
+    case Env::IOActivity::kMultiGetEntity:
+      return IOClass::kForeground;
+    case Env::IOActivity::kFlush:
+    case Env::IOActivity::kCompaction:
+      return IOClass::kBackground;
+    default:
+      break;
+  }
+  switch (options.rate_limiter_priority) {
+    case Env::IO_USER:
+      return IOClass::kForeground;
+    case Env::IO_LOW:
+    case Env::IO_MID:
+    case Env::IO_HIGH:
+      return IOClass::kBackground;
+    default:
+      return IOClass::kUnscheduled;
+  }
+}
+
+class IOScheduler {
+ public:
+  explicit IOScheduler(const IOSchedulerOptions& options)
+      : options_(options), cv_(&mutex_) {}
+
+  void Begin(IOClass io_class) {
+    if (io_class == IOClass::kForeground) {
+      foreground_ios_.fetch_add(1);
+    } else if (io_class == IOClass::kBackground) {
+      BeginBackground();
+    }
+  }
+
+  void End(IOClass io_class) {
+    if (io_class == IOClass::kForeground) {
+      // The last foreground I/O lifts the tighter limit
+      if (foreground_ios_.fetch_sub(1) == 1 && waiting_ios_.load() > 0) {
+        MutexLock l(&mutex_);
+        cv_.SignalAll();
+      }
+    } else if (io_class == IOClass::kBackground) {
+      MutexLock l(&mutex_);
+      background_ios_--;
+      if (waiting_ios_.load() > 0) {
+        cv_.Signal();
+      }
+    }
+  }
+
+ private:
+  bool CanStartBackground() const {
+    if (foreground_ios_.load() > 0) {
+      return background_ios_ < options_.max_background_ios_with_foreground;
+    }
+    return options_.max_background_ios <= 0 ||
+           background_ios_ < options_.max_background_ios;
+  }
+
+  void BeginBackground() {
+    MutexLock l(&mutex_);
+    if (!CanStartBackground()) {
+      SystemClock* clock = SystemClock::Default().get();
+      const uint64_t deadline =
+          clock->NowMicros() + options_.max_background_wait_micros;
+      waiting_ios_.fetch_add(1);
+      while (!CanStartBackground()) {
+        if (clock->NowMicros() >= deadline) {
+          break;
+        }
+        // Also wakes up when foreground I/Os end without a signal, having
+        // seen no waiter
+        cv_.TimedWait(std::min(deadline, clock->NowMicros() + 1000));
+      }
+      waiting_ios_.fetch_sub(1);
+    }
+    background_ios_++;
+  }
+
+  const IOSchedulerOptions options_;
+  std::atomic<int> foreground_ios_{0};
+  // Background I/Os waiting to start
+  std::atomic<int> waiting_ios_{0};
+  port::Mutex mutex_;
+  port::CondVar cv_;
+  // Background I/Os in flight
+  int background_ios_ = 0;
+};
+
+// Registers an I/O with the scheduler for its lifetime
+class ScheduledIO {
+ public:
+  ScheduledIO(IOScheduler* scheduler, const IOOptions& options)
+      : scheduler_(scheduler), io_class_(Classify(options)) {
+    scheduler_->Begin(io_class_);
+  }
+  ~ScheduledIO() { scheduler_->End(io_class_); }
+
+ private:
+  IOScheduler* const scheduler_;
+  const IOClass io_class_;
+};
+
+class ScheduledRandomAccessFile : public FSRandomAccessFileOwnerWrapper {
+ public:
+  ScheduledRandomAccessFile(std::unique_ptr<FSRandomAccessFile>&& f,
+                            IOScheduler* scheduler)
+      : FSRandomAccessFileOwnerWrapper(std::move(f)), scheduler_(scheduler) {}
+
+  IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                Slice* result, char* scratch,
+                IODebugContext* dbg) const override {
+    ScheduledIO io(scheduler_, options);
+    return target()->Read(offset, n, options, result, scratch, dbg);
+  }
+
+  IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
+                     const IOOptions& options, IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->MultiRead(reqs, num_reqs, options, dbg);
+  }
+
+ private:
+  IOScheduler* const scheduler_;
+};
+
+class ScheduledWritableFile : public FSWritableFileOwnerWrapper {
+ public:
+  ScheduledWritableFile(std::unique_ptr<FSWritableFile>&& f,
+                        IOScheduler* scheduler)
+      : FSWritableFileOwnerWrapper(std::move(f)), scheduler_(scheduler) {}
+
+  IOStatus Append(const Slice& data, const IOOptions& options,
+                  IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->Append(data, options, dbg);
+  }
+
+  IOStatus Append(const Slice& data, const IOOptions& options,
+                  const DataVerificationInfo& verification_info,
+                  IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->Append(data, options, verification_info, dbg);
+  }
+
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& options,
+                            IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->PositionedAppend(data, offset, options, dbg);
+  }
+
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& options,
+                            const DataVerificationInfo& verification_info,
+                            IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->PositionedAppend(data, offset, options, verification_info,
+                                      dbg);
+  }
+
+  IOStatus Sync(const IOOptions& options, IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->Sync(options, dbg);
+  }
+
+  IOStatus Fsync(const IOOptions& options, IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->Fsync(options, dbg);
+  }
+
+  IOStatus RangeSync(uint64_t offset, uint64_t nbytes, const IOOptions& options,
+                     IODebugContext* dbg) override {
+    ScheduledIO io(scheduler_, options);
+    return target()->RangeSync(offset, nbytes, options, dbg);
+  }
+
+ private:
+  IOScheduler* const scheduler_;
+};
+
+class IOSchedulerFileSystem : public FileSystemWrapper {
+ public:
+  IOSchedulerFileSystem(const std::shared_ptr<FileSystem>& base,
+                        const IOSchedulerOptions& options)
+      : FileSystemWrapper(base), scheduler_(options) {}
+
+  static const char* kClassName() { return "IOSchedulerFileSystem"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& options,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    std::unique_ptr<FSRandomAccessFile> base;
+    IOStatus s = target()->NewRandomAccessFile(fname, options, &base, dbg);
+    if (s.ok()) {
+      result->reset(
+          new ScheduledRandomAccessFile(std::move(base), &scheduler_));
+    }
+    return s;
+  }
+
+  IOStatus NewWritableFile(const std::string& fname, const FileOptions& options,
+                           std::unique_ptr<FSWritableFile>* result,
+                           IODebugContext* dbg) override {
+    std::unique_ptr<FSWritableFile> base;
+    IOStatus s = target()->NewWritableFile(fname, options, &base, dbg);
+    if (s.ok()) {
+      result->reset(new ScheduledWritableFile(std::move(base), &scheduler_));
+    }
+    return s;
+  }
+
+  IOStatus ReopenWritableFile(const std::string& fname,
+                              const FileOptions& options,
+                              std::unique_ptr<FSWritableFile>* result,
+                              IODebugContext* dbg) override {
+    std::unique_ptr<FSWritableFile> base;
+    IOStatus s = target()->ReopenWritableFile(fname, options, &base, dbg);
+    if (s.ok()) {
+      result->reset(new ScheduledWritableFile(std::move(base), &scheduler_));
+    }
+    return s;
+  }
+
+  IOStatus ReuseWritableFile(const std::string& fname,
+                             const std::string& old_fname,
+                             const FileOptions& options,
+                             std::unique_ptr<FSWritableFile>* result,
+                             IODebugContext* dbg) override {
+    std::unique_ptr<FSWritableFile> base;
+    IOStatus s =
+        target()->ReuseWritableFile(fname, old_fname, options, &base, dbg);
+    if (s.ok()) {
+      result->reset(new ScheduledWritableFile(std::move(base), &scheduler_));
+    }
+    return s;
+  }
+
+ private:
+  IOScheduler scheduler_;
+};
+}  // namespace
+
+std::shared_ptr<FileSystem> NewIOSchedulerFileSystem(
+    const std::shared_ptr<FileSystem>& base,
+    const IOSchedulerOptions& options) {
+  return std::make_shared<IOSchedulerFileSystem>(base, options);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,191 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/io_scheduler.h"
+
+#include <atomic>
+#include <vector>
+
+#include "file/file_util.h"
+#include "port/port.h"
+#include "port/stack_trace.h"
+#include "rocksdb/env.h"
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// Tracks the reads in flight, each of which takes as long as `blocked`
+struct ReadTracker {
+  std::atomic<int> background_reads{0};
+  std::atomic<int> max_background_reads{0};
+  std::atomic<int> num_background_reads{0};
+  std::atomic<bool> blocked{false};
+};
+
+class TrackedRandomAccessFile : public FSRandomAccessFileOwnerWrapper {
+ public:
+  TrackedRandomAccessFile(std::unique_ptr<FSRandomAccessFile>&& f,
+                          ReadTracker* tracker)
+      : FSRandomAccessFileOwnerWrapper(std::move(f)), tracker_(tracker) {}
+
+  IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                Slice* result, char* scratch,
+                IODebugContext* dbg) const override {
+    const bool background =
+        options.io_activity == Env::IOActivity::kCompaction;
+    if (background) {
+      tracker_->num_background_reads++;
+      const int reads = ++tracker_->background_reads;
+      int max_reads = tracker_->max_background_reads.load();
+      while (reads > max_reads &&
+             !tracker_->max_background_reads.compare_exchange_weak(max_reads,
+                                                                   reads)) {
+      }
+    }
+    Env::Default()->SleepForMicroseconds(1000);
+    while (!background && tracker_->blocked.load()) {
+      Env::Default()->SleepForMicroseconds(1000);
+    }
+    IOStatus s = target()->Read(offset, n, options, result, scratch, dbg);
+    if (background) {
+      tracker_->background_reads--;
+    }
+    return s;
+  }
+
+ private:
+  ReadTracker* const tracker_;
+};
+
+class TrackedFileSystem : public FileSystemWrapper {
+ public:
+  TrackedFileSystem(const std::shared_ptr<FileSystem>& base,
+                    ReadTracker* tracker)
+      : FileSystemWrapper(base), tracker_(tracker) {}
+
+  const char* Name() const override { return "TrackedFileSystem"; }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& options,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    std::unique_ptr<FSRandomAccessFile> base;
+    IOStatus s = target()->NewRandomAccessFile(fname, options, &base, dbg);
+    if (s.ok()) {
+      result->reset(new TrackedRandomAccessFile(std::move(base), tracker_));
+    }
+    return s;
+  }
+
+ private:
+  ReadTracker* const tracker_;
+};
+}  // namespace
+
+class IOSchedulerTest : public testing::Test {
+ public:
+  IOSchedulerTest() {
+    fname_ = test::PerThreadDBPath("io_scheduler_test");
+    EXPECT_OK(WriteStringToFile(Env::Default(), std::string(4096, 'x'),
+                                fname_));
+  }
+
+  ~IOSchedulerTest() override {
+    EXPECT_OK(Env::Default()->DeleteFile(fname_));
+  }
+
+ protected:
+  std::unique_ptr<FSRandomAccessFile> OpenFile(
+      const IOSchedulerOptions& options) {
+    fs_ = NewIOSchedulerFileSystem(
+        std::make_shared<TrackedFileSystem>(FileSystem::Default(), &tracker_),
+        options);
+    std::unique_ptr<FSRandomAccessFile> file;
+    EXPECT_OK(fs_->NewRandomAccessFile(fname_, FileOptions(), &file, nullptr));
+    return file;
+  }
+
+  static IOStatus ReadOnce(FSRandomAccessFile* file, Env::IOActivity activity) {
+    IOOptions io_options;
+    io_options.io_activity = activity;
+    char scratch[100];
+    Slice result;
+    return file->Read(0, sizeof(scratch), io_options, &result, scratch,
+                      nullptr);
+  }
+
+  std::string fname_;
+  ReadTracker tracker_;
+  std::shared_ptr<FileSystem> fs_;
+};
+
+TEST_F(IOSchedulerTest, CapBackgroundReads) {
+  IOSchedulerOptions options;
+  options.max_background_ios = 2;
+  options.max_background_wait_micros = 60 * 1000 * 1000;
+  std::unique_ptr<FSRandomAccessFile> file = OpenFile(options);
+
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 5; i++) {
+        ASSERT_OK(ReadOnce(file.get(), Env::IOActivity::kCompaction));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(40, tracker_.num_background_reads.load());
+  ASSERT_LE(tracker_.max_background_reads.load(), 2);
+}
+
+TEST_F(IOSchedulerTest, HoldBackgroundReadsBehindForeground) {
+  IOSchedulerOptions options;
+  options.max_background_ios_with_foreground = 0;
+  options.max_background_wait_micros = 60 * 1000 * 1000;
+  std::unique_ptr<FSRandomAccessFile> file = OpenFile(options);
+
+  tracker_.blocked = true;
+  port::Thread foreground(
+      [&]() { ASSERT_OK(ReadOnce(file.get(), Env::IOActivity::kGet)); });
+  // Let the foreground read start
+  Env::Default()->SleepForMicroseconds(10 * 1000);
+  port::Thread background([&]() {
+    ASSERT_OK(ReadOnce(file.get(), Env::IOActivity::kCompaction));
+  });
+  Env::Default()->SleepForMicroseconds(20 * 1000);
+  ASSERT_EQ(0, tracker_.num_background_reads.load());
+
+  tracker_.blocked = false;
+  foreground.join();
+  background.join();
+  ASSERT_EQ(1, tracker_.num_background_reads.load());
+}
+
+TEST_F(IOSchedulerTest, BackgroundReadsNotStarved) {
+  IOSchedulerOptions options;
+  options.max_background_ios_with_foreground = 0;
+  options.max_background_wait_micros = 1000;
+  std::unique_ptr<FSRandomAccessFile> file = OpenFile(options);
+
+  tracker_.blocked = true;
+  port::Thread foreground(
+      [&]() { ASSERT_OK(ReadOnce(file.get(), Env::IOActivity::kGet)); });
+  Env::Default()->SleepForMicroseconds(10 * 1000);
+  // Goes ahead once out of time
+  ASSERT_OK(ReadOnce(file.get(), Env::IOActivity::kCompaction));
+  tracker_.blocked = false;
+  foreground.join();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,6 +14,7 @@
 #include <thread>
 
 #include "file/file_util.h"
+#include "rocksdb/secondary_cache.h"
 #include "utilities/persistent_cache/block_cache_tier.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -281,6 +282,88 @@ TEST_F(PersistentCacheTierTest, FactoryTest) {
   }
 }
 
+namespace {
+size_t StringSizeCallback(Cache::ObjectPtr obj) {
+  return static_cast<std::string*>(obj)->size();
+}
+
+Status StringSaveToCallback(Cache::ObjectPtr from_obj, size_t from_offset,
+                            size_t length, char* out_buf) {
+  memcpy(out_buf, static_cast<std::string*>(from_obj)->data() + from_offset,
+         length);
+  return Status::OK();
+}
+
+void StringDeleteCallback(Cache::ObjectPtr obj, MemoryAllocator* /*alloc*/) {
+  delete static_cast<std::string*>(obj);
+}
+
+// Marks the strings created from compressed data with a trailing '*'
+Status StringCreateCallback(const Slice& data, CompressionType type,
+                            CacheTier /*source*/,
+                            Cache::CreateContext* /*context*/,
+                            MemoryAllocator* /*allocator*/,
+                            Cache::ObjectPtr* out_obj, size_t* out_charge) {
+  auto* str = new std::string(data.ToString());
+  if (type != kNoCompression) {
+    str->push_back('*');
+  }
+  *out_obj = str;
+  *out_charge = str->size();
+  return Status::OK();
+}
+
+const Cache::CacheItemHelper kStringHelperNoSecondary{CacheEntryRole::kMisc,
+                                                      &StringDeleteCallback};
+const Cache::CacheItemHelper kStringHelper{
+    CacheEntryRole::kMisc, &StringDeleteCallback, &StringSizeCallback,
+    &StringSaveToCallback, &StringCreateCallback, &kStringHelperNoSecondary};
+
+std::string LookupString(SecondaryCache* sec_cache, const Slice& key) {
+  bool kept_in_sec_cache = false;
+  auto handle = sec_cache->Lookup(key, &kStringHelper, nullptr, /*wait=*/true,
+                                  /*advise_erase=*/false, nullptr,
+                                  kept_in_sec_cache);
+  if (!handle) {
+    return "NOT_FOUND";
+  }
+  EXPECT_TRUE(handle->IsReady());
+  EXPECT_TRUE(kept_in_sec_cache);
+  auto* str = static_cast<std::string*>(handle->Value());
+  std::string result = *str;
+  EXPECT_EQ(str->size(), handle->Size());
+  delete str;
+  return result;
+}
+}  // namespace
+
+TEST_F(PersistentCacheTierTest, SecondaryCache) {
+  auto sec_cache = NewPersistentSecondaryCache(
+      std::make_shared<VolatileCacheTier>(/*is_compressed=*/false));
+
+  std::string value1 = "value1";
+  std::string value2 = "value2";
+
+  // Unforced insertions are admitted the second time only
+  ASSERT_OK(sec_cache->Insert("key1", &value1, &kStringHelper,
+                              /*force_insert=*/false));
+  ASSERT_EQ("NOT_FOUND", LookupString(sec_cache.get(), "key1"));
+  ASSERT_OK(sec_cache->Insert("key1", &value1, &kStringHelper,
+                              /*force_insert=*/false));
+  ASSERT_EQ("value1", LookupString(sec_cache.get(), "key1"));
+
+  ASSERT_OK(sec_cache->Insert("key2", &value2, &kStringHelper,
+                              /*force_insert=*/true));
+  ASSERT_EQ("value2", LookupString(sec_cache.get(), "key2"));
+
+  // The compression type of the saved data is kept
+  ASSERT_OK(sec_cache->InsertSaved("key3", "value3", kSnappyCompression,
+                                   CacheTier::kVolatileCompressedTier));
+  ASSERT_EQ("value3*", LookupString(sec_cache.get(), "key3"));
+
+  ASSERT_EQ("NOT_FOUND", LookupString(sec_cache.get(), "key4"));
+}
+
 PersistentCacheDBTest::PersistentCacheDBTest()
     : DBTestBase("cache_test", /*env_do_fsync=*/true) {
 #ifdef OS_LINUX
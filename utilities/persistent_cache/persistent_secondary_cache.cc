@@ -0,0 +1,153 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "port/port.h"
+#include "rocksdb/persistent_cache.h"
+#include "rocksdb/secondary_cache.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+// The entries are stored in the persistent cache with a header of the
+// compression type and the source tier of the data, followed by the data.
+constexpr size_t kHeaderSize = 2;
+
+// Number of the unforced insertions remembered, so that a block is admitted
+// when it is evicted from the primary cache a second time
+constexpr size_t kMaxAdmissionHistory = 1 << 20;
+
+class PersistentSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
+ public:
+  PersistentSecondaryCacheResultHandle(Cache::ObjectPtr value, size_t size)
+      : value_(value), size_(size) {}
+
+  bool IsReady() override { return true; }
+
+  void Wait() override {}
+
+  Cache::ObjectPtr Value() override { return value_; }
+
+  size_t Size() override { return size_; }
+
+ private:
+  Cache::ObjectPtr value_;
+  size_t size_;
+};
+
+class PersistentSecondaryCache : public SecondaryCache {
+ public:
+  explicit PersistentSecondaryCache(std::shared_ptr<PersistentCache> cache)
+      : cache_(std::move(cache)) {}
+
+  const char* Name() const override { return "PersistentSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr obj,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override {
+    if (!helper->IsSecondaryCacheCompatible()) {
+      return Status::OK();
+    }
+    if (!force_insert && !Admit(key)) {
+      return Status::OK();
+    }
+
+    const size_t size = helper->size_cb(obj);
+    std::unique_ptr<char[]> buf(new char[kHeaderSize + size]);
+    buf[0] = static_cast<char>(kNoCompression);
+    buf[1] = static_cast<char>(CacheTier::kVolatileTier);
+    Status s = helper->saveto_cb(obj, 0, size, buf.get() + kHeaderSize);
+    if (!s.ok()) {
+      return s;
+    }
+    return cache_->Insert(key, buf.get(), kHeaderSize + size);
+  }
+
+  Status InsertSaved(const Slice& key, const Slice& saved,
+                     CompressionType type, CacheTier source) override {
+    std::unique_ptr<char[]> buf(new char[kHeaderSize + saved.size()]);
+    buf[0] = static_cast<char>(type);
+    buf[1] = static_cast<char>(source);
+    memcpy(buf.get() + kHeaderSize, saved.data(), saved.size());
+    return cache_->Insert(key, buf.get(), kHeaderSize + saved.size());
+  }
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool /*wait*/,
+      bool /*advise_erase*/, Statistics* /*stats*/,
+      bool& kept_in_sec_cache) override {
+    kept_in_sec_cache = false;
+    if (!helper->IsSecondaryCacheCompatible()) {
+      return nullptr;
+    }
+
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+    if (!cache_->Lookup(key, &data, &size).ok() || size < kHeaderSize) {
+      return nullptr;
+    }
+
+    const auto type = static_cast<CompressionType>(data[0]);
+    const auto source = static_cast<CacheTier>(data[1]);
+    Cache::ObjectPtr value = nullptr;
+    size_t charge = 0;
+    Status s = helper->create_cb(
+        Slice(data.get() + kHeaderSize, size - kHeaderSize), type, source,
+        create_context, /*allocator=*/nullptr, &value, &charge);
+    if (!s.ok()) {
+      return nullptr;
+    }
+    kept_in_sec_cache = true;
+    return std::make_unique<PersistentSecondaryCacheResultHandle>(value,
+                                                                  charge);
+  }
+
+  bool SupportForceErase() const override { return false; }
+
+  void Erase(const Slice& /*key*/) override {}
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> /*handles*/) override {
+  }
+
+  std::string GetPrintableOptions() const override {
+    return cache_->GetPrintableOptions();
+  }
+
+ private:
+  // Returns whether an unforced insertion of `key` was seen recently, and
+  // remembers it otherwise
+  bool Admit(const Slice& key) {
+    const uint64_t hash = GetSliceNPHash64(key);
+    MutexLock l(&mutex_);
+    if (admission_history_.erase(hash) > 0) {
+      return true;
+    }
+    if (admission_history_.size() >= kMaxAdmissionHistory) {
+      admission_history_.clear();
+    }
+    admission_history_.insert(hash);
+    return false;
+  }
+
+  std::shared_ptr<PersistentCache> cache_;
+  port::Mutex mutex_;
+  std::unordered_set<uint64_t> admission_history_;
+};
+
+}  // namespace
+
+std::shared_ptr<SecondaryCache> NewPersistentSecondaryCache(
+    std::shared_ptr<PersistentCache> cache) {
+  return std::make_shared<PersistentSecondaryCache>(std::move(cache));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
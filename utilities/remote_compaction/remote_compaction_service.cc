@@ -0,0 +1,321 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/remote_compaction_service.h"
+
+#include <unordered_map>
+#include <vector>
+
+#include "file/file_util.h"
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+const std::string kJobSuffix = ".job";
+const std::string kClaimedSuffix = ".claimed";
+const std::string kResultSuffix = ".result";
+const std::string kCancelSuffix = ".cancel";
+
+// First byte of a result file
+const char kJobSucceeded = 'S';
+const char kJobFailed = 'F';
+
+std::string QueueFileName(const RemoteCompactionServiceOptions& options,
+                          const std::string& job, const std::string& suffix) {
+  return options.queue_dir + "/" + job + suffix;
+}
+
+// Writes through a temporary file, so that `fname` appears complete.
+Status WriteFileAtomically(Env* env, const Slice& data,
+                           const std::string& fname) {
+  const std::string tmp = fname + ".tmp";
+  Status s = WriteStringToFile(env, data, tmp, /*should_sync=*/true);
+  if (s.ok()) {
+    s = env->RenameFile(tmp, fname);
+  }
+  if (!s.ok()) {
+    env->DeleteFile(tmp).PermitUncheckedError();
+  }
+  return s;
+}
+}  // namespace
+
+struct RemoteCompactionService::Rep {
+  struct Job {
+    std::string db_name;
+    std::string input;
+    int attempt = 0;
+    uint64_t attempt_start_micros = 0;
+
+    std::string AttemptName(const std::string& id) const {
+      return id + "-" + std::to_string(attempt);
+    }
+  };
+
+  explicit Rep(const RemoteCompactionServiceOptions& _options)
+      : options(_options) {}
+
+  // Queues the next attempt at the job.
+  Status Submit(const std::string& id, Job* job) {
+    job->attempt++;
+    job->attempt_start_micros = options.env->NowMicros();
+    const std::string name = job->AttemptName(id);
+    std::string contents;
+    PutLengthPrefixedSlice(&contents, job->db_name);
+    PutLengthPrefixedSlice(&contents, job->db_name + "/" + name);
+    PutLengthPrefixedSlice(&contents, job->input);
+    return WriteFileAtomically(options.env, contents,
+                               QueueFileName(options, name, kJobSuffix));
+  }
+
+  // Asks the worker of an attempt, if any, to stop and clean up after it.
+  void Abandon(const std::string& name) {
+    if (options.env->DeleteFile(QueueFileName(options, name, kJobSuffix))
+            .ok()) {
+      // Never claimed
+      return;
+    }
+    WriteFileAtomically(options.env, Slice(),
+                        QueueFileName(options, name, kCancelSuffix))
+        .PermitUncheckedError();
+  }
+
+  const RemoteCompactionServiceOptions options;
+  std::atomic<bool> canceled{false};
+
+  port::Mutex mutex;
+  // Scheduled jobs that are not waited for yet
+  std::unordered_map<std::string, Job> jobs;
+  // Output directories of the jobs that completed, until their installation
+  std::unordered_map<std::string, std::string> output_dirs;
+};
+
+RemoteCompactionService::RemoteCompactionService(
+    const RemoteCompactionServiceOptions& options)
+    : rep_(new Rep(options)) {}
+
+RemoteCompactionService::~RemoteCompactionService() = default;
+
+CompactionServiceScheduleResponse RemoteCompactionService::Schedule(
+    const CompactionServiceJobInfo& info,
+    const std::string& compaction_service_input) {
+  if (rep_->canceled.load(std::memory_order_acquire)) {
+    return CompactionServiceScheduleResponse(
+        CompactionServiceJobStatus::kAborted);
+  }
+  const std::string id = rep_->options.env->GenerateUniqueId();
+  Rep::Job job;
+  job.db_name = info.db_name;
+  job.input = compaction_service_input;
+  if (!rep_->Submit(id, &job).ok()) {
+    // The queue is not reachable, so no worker would be either
+    return CompactionServiceScheduleResponse(
+        CompactionServiceJobStatus::kUseLocal);
+  }
+  {
+    MutexLock l(&rep_->mutex);
+    rep_->jobs.emplace(id, std::move(job));
+  }
+  return CompactionServiceScheduleResponse(
+      id, CompactionServiceJobStatus::kSuccess);
+}
+
+CompactionServiceJobStatus RemoteCompactionService::Wait(
+    const std::string& scheduled_job_id, std::string* result) {
+  const RemoteCompactionServiceOptions& options = rep_->options;
+  Env* const env = options.env;
+  Rep::Job job;
+  {
+    MutexLock l(&rep_->mutex);
+    auto it = rep_->jobs.find(scheduled_job_id);
+    if (it == rep_->jobs.end()) {
+      return CompactionServiceJobStatus::kFailure;
+    }
+    job = std::move(it->second);
+    rep_->jobs.erase(it);
+  }
+
+  while (true) {
+    const std::string name = job.AttemptName(scheduled_job_id);
+    if (rep_->canceled.load(std::memory_order_acquire)) {
+      rep_->Abandon(name);
+      return CompactionServiceJobStatus::kAborted;
+    }
+
+    const std::string result_file = QueueFileName(options, name, kResultSuffix);
+    if (env->FileExists(result_file).ok()) {
+      std::string contents;
+      Status s = ReadFileToString(env, result_file, &contents);
+      env->DeleteFile(result_file).PermitUncheckedError();
+      env->DeleteFile(QueueFileName(options, name, kClaimedSuffix))
+          .PermitUncheckedError();
+      if (s.ok() && !contents.empty() && contents[0] == kJobSucceeded) {
+        result->assign(contents, 1, std::string::npos);
+        MutexLock l(&rep_->mutex);
+        rep_->output_dirs[scheduled_job_id] = job.db_name + "/" + name;
+        return CompactionServiceJobStatus::kSuccess;
+      }
+      TEST_SYNC_POINT("RemoteCompactionService::Wait:AttemptFailed");
+      if (job.attempt < options.max_attempts &&
+          rep_->Submit(scheduled_job_id, &job).ok()) {
+        continue;
+      }
+      if (!contents.empty()) {
+        result->assign(contents, 1, std::string::npos);
+      }
+      return CompactionServiceJobStatus::kFailure;
+    }
+
+    const uint64_t elapsed = env->NowMicros() - job.attempt_start_micros;
+    const std::string job_file = QueueFileName(options, name, kJobSuffix);
+    if (env->FileExists(job_file).ok()) {
+      // Deleting fails if a worker claims the job in the meantime
+      if (elapsed >= options.claim_timeout_micros &&
+          env->DeleteFile(job_file).ok()) {
+        return CompactionServiceJobStatus::kUseLocal;
+      }
+    } else if (options.run_timeout_micros > 0 &&
+               elapsed >= options.run_timeout_micros) {
+      TEST_SYNC_POINT("RemoteCompactionService::Wait:AttemptTimedOut");
+      rep_->Abandon(name);
+      if (job.attempt >= options.max_attempts ||
+          !rep_->Submit(scheduled_job_id, &job).ok()) {
+        return CompactionServiceJobStatus::kUseLocal;
+      }
+      continue;
+    }
+    env->SleepForMicroseconds(static_cast<int>(options.poll_interval_micros));
+  }
+}
+
+void RemoteCompactionService::CancelAwaitingJobs() {
+  rep_->canceled.store(true, std::memory_order_release);
+}
+
+void RemoteCompactionService::OnInstallation(
+    const std::string& scheduled_job_id,
+    CompactionServiceJobStatus /*status*/) {
+  std::string output_dir;
+  {
+    MutexLock l(&rep_->mutex);
+    auto it = rep_->output_dirs.find(scheduled_job_id);
+    if (it == rep_->output_dirs.end()) {
+      return;
+    }
+    output_dir = std::move(it->second);
+    rep_->output_dirs.erase(it);
+  }
+  // Only the files that failed to install are left
+  DestroyDir(rep_->options.env, output_dir).PermitUncheckedError();
+}
+
+RemoteCompactionWorker::RemoteCompactionWorker(
+    const RemoteCompactionServiceOptions& options,
+    const CompactionServiceOptionsOverride& options_override)
+    : options_(options), options_override_(options_override) {}
+
+Status RemoteCompactionWorker::RunOnce() { return RunNextJob(nullptr); }
+
+void RemoteCompactionWorker::Run(const std::atomic<bool>* stop) {
+  while (!stop->load(std::memory_order_acquire)) {
+    Status s = RunNextJob(stop);
+    if (s.IsNotFound()) {
+      options_.env->SleepForMicroseconds(
+          static_cast<int>(options_.poll_interval_micros));
+    }
+  }
+}
+
+Status RemoteCompactionWorker::RunNextJob(const std::atomic<bool>* stop) {
+  Env* const env = options_.env;
+  std::vector<std::string> children;
+  Status s = env->GetChildren(options_.queue_dir, &children);
+  if (!s.ok()) {
+    return s;
+  }
+  std::string name;
+  for (const auto& child : children) {
+    if (!EndsWith(child, kJobSuffix)) {
+      continue;
+    }
+    std::string candidate = child.substr(0, child.size() - kJobSuffix.size());
+    // Only one of the workers racing for the job can rename it
+    if (env->RenameFile(options_.queue_dir + "/" + child,
+                        QueueFileName(options_, candidate, kClaimedSuffix))
+            .ok()) {
+      name = std::move(candidate);
+      break;
+    }
+  }
+  if (name.empty()) {
+    return Status::NotFound("No compaction job in " + options_.queue_dir);
+  }
+
+  const std::string claimed_file =
+      QueueFileName(options_, name, kClaimedSuffix);
+  const std::string cancel_file = QueueFileName(options_, name, kCancelSuffix);
+  std::string contents;
+  s = ReadFileToString(env, claimed_file, &contents);
+  Slice in(contents);
+  Slice db_name;
+  Slice output_dir;
+  Slice input;
+  if (s.ok() && !(GetLengthPrefixedSlice(&in, &db_name) &&
+                  GetLengthPrefixedSlice(&in, &output_dir) &&
+                  GetLengthPrefixedSlice(&in, &input))) {
+    s = Status::Corruption("Malformed compaction job " + claimed_file);
+  }
+
+  std::string result;
+  bool abandoned = false;
+  if (s.ok()) {
+    std::atomic<bool> canceled{false};
+    std::atomic<bool> done{false};
+    port::Thread watcher([&]() {
+      while (!done.load(std::memory_order_acquire)) {
+        if (env->FileExists(cancel_file).ok()) {
+          abandoned = true;
+          canceled.store(true, std::memory_order_release);
+          return;
+        }
+        if (stop != nullptr && stop->load(std::memory_order_acquire)) {
+          canceled.store(true, std::memory_order_release);
+          return;
+        }
+        env->SleepForMicroseconds(
+            static_cast<int>(options_.poll_interval_micros));
+      }
+    });
+    OpenAndCompactOptions open_and_compact_options;
+    open_and_compact_options.canceled = &canceled;
+    s = DB::OpenAndCompact(open_and_compact_options, db_name.ToString(),
+                           output_dir.ToString(), input.ToString(), &result,
+                           options_override_);
+    done.store(true, std::memory_order_release);
+    watcher.join();
+  }
+
+  if ((!s.ok() || abandoned) && !output_dir.empty()) {
+    DestroyDir(env, output_dir.ToString()).PermitUncheckedError();
+  }
+  if (abandoned) {
+    // Nobody waits for the result
+    env->DeleteFile(claimed_file).PermitUncheckedError();
+    env->DeleteFile(cancel_file).PermitUncheckedError();
+    return Status::Aborted("Compaction job " + name + " was canceled");
+  }
+  std::string outcome(1, s.ok() ? kJobSucceeded : kJobFailed);
+  outcome.append(result);
+  return WriteFileAtomically(env, outcome,
+                             QueueFileName(options_, name, kResultSuffix));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,197 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/remote_compaction_service.h"
+
+#include "db/db_test_util.h"
+#include "file/file_util.h"
+#include "port/stack_trace.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class RemoteCompactionServiceTest : public DBTestBase {
+ public:
+  RemoteCompactionServiceTest()
+      : DBTestBase("remote_compaction_service_test", /*env_do_fsync=*/true) {
+    service_options_.queue_dir = dbname_ + "_queue";
+    service_options_.env = env_;
+    service_options_.poll_interval_micros = 1000;
+    EXPECT_OK(DestroyDir(env_, service_options_.queue_dir));
+    EXPECT_OK(env_->CreateDirIfMissing(service_options_.queue_dir));
+  }
+
+  ~RemoteCompactionServiceTest() override {
+    StopWorkers();
+    Close();
+    EXPECT_OK(DestroyDir(env_, service_options_.queue_dir));
+  }
+
+ protected:
+  void ReopenWithService() {
+    options_ = CurrentOptions();
+    options_.env = env_;
+    options_.disable_auto_compactions = true;
+    options_.statistics = CreateDBStatistics();
+    service_ = std::make_shared<RemoteCompactionService>(service_options_);
+    options_.compaction_service = service_;
+    DestroyAndReopen(options_);
+  }
+
+  void StartWorkers(int num_workers) {
+    CompactionServiceOptionsOverride options_override;
+    options_override.env = env_;
+    options_override.comparator = options_.comparator;
+    options_override.table_factory = options_.table_factory;
+    stop_workers_ = false;
+    for (int i = 0; i < num_workers; i++) {
+      workers_.emplace_back([this, options_override]() {
+        RemoteCompactionWorker(service_options_, options_override)
+            .Run(&stop_workers_);
+      });
+    }
+  }
+
+  void StopWorkers() {
+    stop_workers_ = true;
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+    workers_.clear();
+  }
+
+  void GenerateTestData() {
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 100; j++) {
+        ASSERT_OK(Put(Key(j), "value" + std::to_string(i * 100 + j)));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_EQ(4, NumTableFilesAtLevel(0));
+  }
+
+  void VerifyTestData() {
+    for (int j = 0; j < 100; j++) {
+      ASSERT_EQ("value" + std::to_string(300 + j), Get(Key(j)));
+    }
+  }
+
+  bool HasQueuedJob() {
+    for (const auto& child : QueueFiles()) {
+      if (EndsWith(child, ".job")) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<std::string> QueueFiles() {
+    std::vector<std::string> children;
+    EXPECT_OK(env_->GetChildren(service_options_.queue_dir, &children));
+    return children;
+  }
+
+  RemoteCompactionServiceOptions service_options_;
+  Options options_;
+  std::shared_ptr<RemoteCompactionService> service_;
+  std::atomic<bool> stop_workers_{false};
+  std::vector<port::Thread> workers_;
+};
+
+TEST_F(RemoteCompactionServiceTest, RunOnWorkers) {
+  ReopenWithService();
+  StartWorkers(2);
+  GenerateTestData();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  VerifyTestData();
+
+  ASSERT_GT(options_.statistics->getTickerCount(REMOTE_COMPACT_WRITE_BYTES),
+            0);
+  ASSERT_TRUE(QueueFiles().empty());
+  // The output directory is gone once the files are installed
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(dbname_, &children));
+  for (const auto& child : children) {
+    bool is_dir = false;
+    ASSERT_OK(env_->IsDirectory(dbname_ + "/" + child, &is_dir));
+    ASSERT_FALSE(is_dir) << child;
+  }
+}
+
+TEST_F(RemoteCompactionServiceTest, FallBackToLocalWithoutWorkers) {
+  service_options_.claim_timeout_micros = 10 * 1000;
+  ReopenWithService();
+  GenerateTestData();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  VerifyTestData();
+
+  ASSERT_EQ(options_.statistics->getTickerCount(REMOTE_COMPACT_WRITE_BYTES),
+            0);
+  ASSERT_TRUE(QueueFiles().empty());
+}
+
+TEST_F(RemoteCompactionServiceTest, RetryFailedAttempt) {
+  ReopenWithService();
+  GenerateTestData();
+
+  std::atomic<int> injected{0};
+  std::atomic<int> failed_attempts{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::FinishCompactionOutputFile()::AfterFinish",
+      [&](void* arg) {
+        if (injected.fetch_add(1) == 0) {
+          *static_cast<Status*>(arg) = Status::IOError("Injected IOError!");
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "RemoteCompactionService::Wait:AttemptFailed",
+      [&](void* /*arg*/) { failed_attempts++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  StartWorkers(1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(1, failed_attempts.load());
+  ASSERT_EQ("0,1", FilesPerLevel());
+  VerifyTestData();
+  ASSERT_GT(options_.statistics->getTickerCount(REMOTE_COMPACT_WRITE_BYTES),
+            0);
+  ASSERT_TRUE(QueueFiles().empty());
+}
+
+TEST_F(RemoteCompactionServiceTest, CancelAwaitingJobs) {
+  ReopenWithService();
+  GenerateTestData();
+
+  Status compact_status;
+  port::Thread compact_thread([&]() {
+    compact_status =
+        db_->CompactRange(CompactRangeOptions(), nullptr, nullptr);
+  });
+  // Without workers, the job stays in the queue
+  while (!HasQueuedJob()) {
+    env_->SleepForMicroseconds(1000);
+  }
+  service_->CancelAwaitingJobs();
+  compact_thread.join();
+
+  ASSERT_TRUE(compact_status.IsAborted());
+  ASSERT_EQ(4, NumTableFilesAtLevel(0));
+  // The unclaimed job was withdrawn
+  ASSERT_TRUE(QueueFiles().empty());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,309 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/result_cache_db.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "cache/typed_cache.h"
+#include "port/port.h"
+#include "rocksdb/write_batch.h"
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+std::string CacheKey(uint32_t column_family_id, const Slice& key) {
+  std::string cache_key;
+  cache_key.reserve(sizeof(uint32_t) + key.size());
+  PutFixed32(&cache_key, column_family_id);
+  cache_key.append(key.data(), key.size());
+  return cache_key;
+}
+
+// Collects the cache keys of the entries that a write batch updates
+class CacheKeyCollector : public WriteBatch::Handler {
+ public:
+  Status PutCF(uint32_t column_family_id, const Slice& key,
+               const Slice& /*value*/) override {
+    return Add(column_family_id, key);
+  }
+
+  Status TimedPutCF(uint32_t column_family_id, const Slice& key,
+                    const Slice& /*value*/, uint64_t /*write_time*/) override {
+    return Add(column_family_id, key);
+  }
+
+  Status PutEntityCF(uint32_t column_family_id, const Slice& key,
+                     const Slice& /*entity*/) override {
+    return Add(column_family_id, key);
+  }
+
+  Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Add(column_family_id, key);
+  }
+
+  Status SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Add(column_family_id, key);
+  }
+
+  Status DeleteRangeCF(uint32_t /*column_family_id*/,
+                       const Slice& /*begin_key*/,
+                       const Slice& /*end_key*/) override {
+    all = true;
+    return Status::OK();
+  }
+
+  Status MergeCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& /*value*/) override {
+    return Add(column_family_id, key);
+  }
+
+  Status PutBlobIndexCF(uint32_t column_family_id, const Slice& key,
+                        const Slice& /*value*/) override {
+    return Add(column_family_id, key);
+  }
+
+  std::vector<std::string> cache_keys;
+  // Whether the batch may update any entry
+  bool all = false;
+
+ private:
+  Status Add(uint32_t column_family_id, const Slice& key) {
+    cache_keys.push_back(CacheKey(column_family_id, key));
+    return Status::OK();
+  }
+};
+}  // namespace
+
+struct ResultCacheDB::Rep {
+  struct Result {
+    Result(bool _found, const Slice& _value, uint64_t _generation)
+        : found(_found), value(_value.ToString()), generation(_generation) {}
+
+    const bool found;
+    const std::string value;
+    // Value of Rep::generation when the result was read
+    const uint64_t generation;
+  };
+  using CacheInterface =
+      BasicTypedCacheInterface<Result, CacheEntryRole::kMisc>;
+
+  struct Stripe {
+    port::Mutex mutex;
+    // Writes to keys of the stripe that are under way
+    std::atomic<uint32_t> writes{0};
+    // Latest sequence number of the DB after a write to a key of the stripe
+    SequenceNumber written_seq = 0;
+  };
+  static constexpr size_t kNumStripes = 256;
+
+  explicit Rep(const ResultCacheOptions& _options)
+      : options(_options), cache(options.cache.get()) {
+    assert(options.cache != nullptr);
+  }
+
+  Stripe& GetStripe(const std::string& cache_key) {
+    return stripes[GetSliceHash(cache_key) % kNumStripes];
+  }
+
+  // Runs `write`, removing the entries of `cache_keys`, or all of them if
+  // `all`, once it is done.
+  Status RunWrite(DB* db, const std::vector<std::string>& cache_keys, bool all,
+                  const std::function<Status()>& write) {
+    if (all) {
+      range_writes.fetch_add(1);
+    }
+    for (const auto& cache_key : cache_keys) {
+      GetStripe(cache_key).writes.fetch_add(1);
+    }
+    Status s = write();
+    // The write is visible to the Gets that start from now on
+    const SequenceNumber seq = db->GetLatestSequenceNumber();
+    if (all) {
+      generation.fetch_add(1);
+      range_writes.fetch_sub(1);
+    }
+    for (const auto& cache_key : cache_keys) {
+      Stripe& stripe = GetStripe(cache_key);
+      MutexLock l(&stripe.mutex);
+      cache.get()->Erase(cache_key);
+      stripe.written_seq = std::max(stripe.written_seq, seq);
+      stripe.writes.fetch_sub(1);
+    }
+    return s;
+  }
+
+  const ResultCacheOptions options;
+  CacheInterface cache;
+  Stripe stripes[kNumStripes];
+  // Writes of whole ranges that are under way
+  std::atomic<uint32_t> range_writes{0};
+  // Incremented by each write of whole ranges, invalidating the entries read
+  // before it
+  std::atomic<uint64_t> generation{0};
+};
+
+ResultCacheDB::ResultCacheDB(DB* db, const ResultCacheOptions& options)
+    : StackableDB(db), rep_(new Rep(options)) {}
+
+ResultCacheDB::~ResultCacheDB() = default;
+
+Status ResultCacheDB::Get(const ReadOptions& options,
+                          ColumnFamilyHandle* column_family, const Slice& key,
+                          PinnableSlice* value, std::string* timestamp) {
+  if (options.snapshot != nullptr || options.timestamp != nullptr ||
+      timestamp != nullptr || options.read_tier != kReadAllTier ||
+      options.ignore_range_deletions) {
+    return db_->Get(options, column_family, key, value, timestamp);
+  }
+  const std::string cache_key = CacheKey(column_family->GetID(), key);
+  Rep::Stripe& stripe = rep_->GetStripe(cache_key);
+
+  // The result of a write under way is not known
+  if (rep_->range_writes.load() == 0 && stripe.writes.load() == 0) {
+    auto handle = rep_->cache.Lookup(cache_key);
+    if (handle != nullptr) {
+      const Rep::Result* result = rep_->cache.Value(handle);
+      if (result->generation == rep_->generation.load()) {
+        if (!result->found) {
+          rep_->cache.Release(handle);
+          return Status::NotFound();
+        }
+        value->Reset();
+        value->PinSlice(result->value, nullptr);
+        rep_->cache.RegisterReleaseAsCleanup(handle, *value);
+        return Status::OK();
+      }
+      rep_->cache.Release(handle);
+    }
+  }
+
+  const uint64_t generation = rep_->generation.load();
+  const SequenceNumber seq = db_->GetLatestSequenceNumber();
+  Status s = db_->Get(options, column_family, key, value, timestamp);
+  if (!s.ok() && !s.IsNotFound()) {
+    return s;
+  }
+  TEST_SYNC_POINT("ResultCacheDB::Get:AfterRead");
+  auto result = new Rep::Result(s.ok(), s.ok() ? Slice(*value) : Slice(),
+                                generation);
+  const size_t charge =
+      sizeof(Rep::Result) + cache_key.size() + result->value.size();
+  Status cs;
+  {
+    MutexLock l(&stripe.mutex);
+    // No write to a key of the stripe since the Get started
+    if (stripe.writes.load() == 0 && stripe.written_seq <= seq &&
+        rep_->range_writes.load() == 0 &&
+        rep_->generation.load() == generation) {
+      cs = rep_->cache.Insert(cache_key, result, charge);
+    } else {
+      cs = Status::Aborted();
+    }
+  }
+  if (!cs.ok()) {
+    delete result;
+  }
+  return s;
+}
+
+Status ResultCacheDB::Put(const WriteOptions& options,
+                          ColumnFamilyHandle* column_family, const Slice& key,
+                          const Slice& val) {
+  return rep_->RunWrite(db_, {CacheKey(column_family->GetID(), key)},
+                        false /* all */, [&]() {
+                          return db_->Put(options, column_family, key, val);
+                        });
+}
+
+Status ResultCacheDB::PutEntity(const WriteOptions& options,
+                                ColumnFamilyHandle* column_family,
+                                const Slice& key, const WideColumns& columns) {
+  return rep_->RunWrite(
+      db_, {CacheKey(column_family->GetID(), key)}, false /* all */, [&]() {
+        return db_->PutEntity(options, column_family, key, columns);
+      });
+}
+
+Status ResultCacheDB::PutEntity(const WriteOptions& options, const Slice& key,
+                                const AttributeGroups& attribute_groups) {
+  std::vector<std::string> cache_keys;
+  for (const auto& attribute_group : attribute_groups) {
+    cache_keys.push_back(
+        CacheKey(attribute_group.column_family()->GetID(), key));
+  }
+  return rep_->RunWrite(db_, cache_keys, false /* all */, [&]() {
+    return db_->PutEntity(options, key, attribute_groups);
+  });
+}
+
+Status ResultCacheDB::Delete(const WriteOptions& options,
+                             ColumnFamilyHandle* column_family,
+                             const Slice& key) {
+  return rep_->RunWrite(db_, {CacheKey(column_family->GetID(), key)},
+                        false /* all */, [&]() {
+                          return db_->Delete(options, column_family, key);
+                        });
+}
+
+Status ResultCacheDB::SingleDelete(const WriteOptions& options,
+                                   ColumnFamilyHandle* column_family,
+                                   const Slice& key) {
+  return rep_->RunWrite(db_, {CacheKey(column_family->GetID(), key)},
+                        false /* all */, [&]() {
+                          return db_->SingleDelete(options, column_family, key);
+                        });
+}
+
+Status ResultCacheDB::DeleteRange(const WriteOptions& options,
+                                  ColumnFamilyHandle* column_family,
+                                  const Slice& start_key,
+                                  const Slice& end_key) {
+  return rep_->RunWrite(db_, {}, true /* all */, [&]() {
+    return db_->DeleteRange(options, column_family, start_key, end_key);
+  });
+}
+
+Status ResultCacheDB::Merge(const WriteOptions& options,
+                            ColumnFamilyHandle* column_family, const Slice& key,
+                            const Slice& value) {
+  return rep_->RunWrite(db_, {CacheKey(column_family->GetID(), key)},
+                        false /* all */, [&]() {
+                          return db_->Merge(options, column_family, key, value);
+                        });
+}
+
+Status ResultCacheDB::Write(const WriteOptions& options, WriteBatch* updates) {
+  CacheKeyCollector collector;
+  if (updates == nullptr || !updates->Iterate(&collector).ok()) {
+    collector.all = true;
+  }
+  return rep_->RunWrite(db_, collector.cache_keys, collector.all,
+                        [&]() { return db_->Write(options, updates); });
+}
+
+Status ResultCacheDB::IngestExternalFile(
+    ColumnFamilyHandle* column_family,
+    const std::vector<std::string>& external_files,
+    const IngestExternalFileOptions& options) {
+  return rep_->RunWrite(db_, {}, true /* all */, [&]() {
+    return db_->IngestExternalFile(column_family, external_files, options);
+  });
+}
+
+Status ResultCacheDB::IngestExternalFiles(
+    const std::vector<IngestExternalFileArg>& args) {
+  return rep_->RunWrite(db_, {}, true /* all */,
+                        [&]() { return db_->IngestExternalFiles(args); });
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,126 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/result_cache_db.h"
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ResultCacheDBTest : public DBTestBase {
+ public:
+  ResultCacheDBTest()
+      : DBTestBase("result_cache_db_test", /*env_do_fsync=*/false) {}
+
+ protected:
+  void ReopenWithResultCache() {
+    options_ = CurrentOptions();
+    options_.statistics = CreateDBStatistics();
+    DestroyAndReopen(options_);
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+    result_cache_options_.cache = NewLRUCache(1 << 20);
+    // The wrapper owns the DB from now on
+    db_ = new ResultCacheDB(db_, result_cache_options_);
+  }
+
+  // Number of Gets that reached the DB
+  uint64_t NumKeysRead() {
+    return options_.statistics->getTickerCount(NUMBER_KEYS_READ);
+  }
+
+  Options options_;
+  ResultCacheOptions result_cache_options_;
+};
+
+TEST_F(ResultCacheDBTest, CacheResults) {
+  ReopenWithResultCache();
+  ASSERT_EQ("v1", Get(Key(1)));
+  ASSERT_EQ("NOT_FOUND", Get("missing"));
+  const uint64_t keys_read = NumKeysRead();
+  ASSERT_EQ(2u, keys_read);
+
+  ASSERT_EQ("v1", Get(Key(1)));
+  ASSERT_EQ("NOT_FOUND", Get("missing"));
+  PinnableSlice value;
+  ASSERT_OK(db_->Get(ReadOptions(), db_->DefaultColumnFamily(), Key(1),
+                     &value));
+  ASSERT_EQ("v1", value);
+  ASSERT_TRUE(value.IsPinned());
+  value.Reset();
+  ASSERT_EQ(keys_read, NumKeysRead());
+
+  // The entries are not tied to the files
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("v1", Get(Key(1)));
+  ASSERT_EQ(keys_read, NumKeysRead());
+
+  // Gets of a snapshot are not cached
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_EQ("v1", Get(Key(1), snapshot));
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_EQ(keys_read + 1, NumKeysRead());
+}
+
+TEST_F(ResultCacheDBTest, WritesInvalidateResults) {
+  ReopenWithResultCache();
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+  ASSERT_EQ("NOT_FOUND", Get("missing"));
+
+  ASSERT_OK(Put(Key(0), "new0"));
+  ASSERT_OK(Delete(Key(1)));
+  WriteBatch batch;
+  ASSERT_OK(batch.Put(Key(2), "new2"));
+  ASSERT_OK(batch.Put("missing", "found"));
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ("new0", Get(Key(0)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(1)));
+  ASSERT_EQ("new2", Get(Key(2)));
+  ASSERT_EQ("found", Get("missing"));
+  // Untouched
+  const uint64_t keys_read = NumKeysRead();
+  ASSERT_EQ("v3", Get(Key(3)));
+  ASSERT_EQ(keys_read, NumKeysRead());
+
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(50)));
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+  }
+}
+
+TEST_F(ResultCacheDBTest, GetRacingWithWrite) {
+  ReopenWithResultCache();
+  bool written = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "ResultCacheDB::Get:AfterRead", [&](void* /*arg*/) {
+        if (!written) {
+          written = true;
+          ASSERT_OK(Put(Key(1), "new1"));
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  // Read before the write, so not cached
+  ASSERT_EQ("v1", Get(Key(1)));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_TRUE(written);
+
+  ASSERT_EQ("new1", Get(Key(1)));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,9 +3,11 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 
 #include "faiss/IndexIVF.h"
@@ -33,11 +35,23 @@ faiss::idx_t DeserializeLabel(Slice label_slice) {
   return label;
 }
 
+// The entries of an inverted list read ahead of a batched search. The codes
+// are stored back to back.
+struct CachedList {
+  std::vector<faiss::idx_t> ids;
+  std::string codes;
+};
+
+using CachedLists = std::unordered_map<faiss::idx_t, CachedList>;
+
 }  // namespace
 
 struct FaissIVFIndex::KNNContext {
   SecondaryIndexIterator* it;
   autovector<std::string> keys;
+  // Set for batched searches, which only read the lists cached here, so that
+  // the targets can be searched on several threads at once
+  const CachedLists* lists = nullptr;
 };
 
 class FaissIVFIndex::Adapter : public faiss::InvertedLists {
@@ -71,6 +85,14 @@ class FaissIVFIndex::Adapter : public faiss::InvertedLists {
         static_cast<KNNContext*>(inverted_list_context);
     assert(knn_context);
 
+    if (knn_context->lists) {
+      const auto it = knn_context->lists->find(list_no);
+      const CachedList* const list =
+          it != knn_context->lists->end() ? &it->second : nullptr;
+
+      return new CachedListIteratorAdapter(list, code_size);
+    }
+
     return new IteratorAdapter(knn_context, list_no, code_size);
   }
 
@@ -173,6 +195,31 @@ class FaissIVFIndex::Adapter : public faiss::InvertedLists {
     size_t code_size_;
     std::optional<std::pair<faiss::idx_t, const uint8_t*>> id_and_codes_;
   };
+
+  class CachedListIteratorAdapter : public faiss::InvertedListsIterator {
+   public:
+    CachedListIteratorAdapter(const CachedList* list, size_t code_size)
+        : list_(list), code_size_(code_size) {}
+
+    bool is_available() const override {
+      return list_ && pos_ < list_->ids.size();
+    }
+
+    void next() override { ++pos_; }
+
+    std::pair<faiss::idx_t, const uint8_t*> get_id_and_codes() override {
+      assert(is_available());
+
+      return {list_->ids[pos_],
+              reinterpret_cast<const uint8_t*>(list_->codes.data()) +
+                  pos_ * code_size_};
+    }
+
+   private:
+    const CachedList* list_;
+    size_t code_size_;
+    size_t pos_ = 0;
+  };
 };
 
 FaissIVFIndex::FaissIVFIndex(std::unique_ptr<faiss::IndexIVF>&& index,
@@ -362,4 +409,138 @@ Status FaissIVFIndex::FindKNearestNeighbors(
   return Status::OK();
 }
 
+Status FaissIVFIndex::FindKNearestNeighborsBatch(
+    SecondaryIndexIterator* it, const std::vector<Slice>& targets,
+    size_t neighbors, size_t probes,
+    std::vector<std::vector<std::pair<std::string, float>>>* results) const {
+  if (!it) {
+    return Status::InvalidArgument("Secondary index iterator must be provided");
+  }
+
+  if (!neighbors) {
+    return Status::InvalidArgument("Invalid number of neighbors");
+  }
+
+  if (!probes) {
+    return Status::InvalidArgument("Invalid number of probes");
+  }
+
+  if (!results) {
+    return Status::InvalidArgument("Results parameter must be provided");
+  }
+
+  results->clear();
+
+  const size_t dim = index_->d;
+  const faiss::idx_t n = static_cast<faiss::idx_t>(targets.size());
+
+  std::vector<float> embeddings;
+  embeddings.reserve(targets.size() * dim);
+
+  for (const Slice& target : targets) {
+    const float* const embedding = ConvertSliceToFloats(target, dim);
+    if (!embedding) {
+      return Status::InvalidArgument(
+          "Incorrectly sized vector passed to FaissIVFIndex");
+    }
+
+    embeddings.insert(embeddings.end(), embedding, embedding + dim);
+  }
+
+  if (targets.empty()) {
+    return Status::OK();
+  }
+
+  // Find the lists probed by the targets, and read each of them once
+  const size_t num_probes = std::min(probes, index_->nlist);
+
+  std::vector<float> coarse_distances(targets.size() * num_probes);
+  std::vector<faiss::idx_t> coarse_labels(targets.size() * num_probes, -1);
+
+  try {
+    index_->quantizer->search(n, embeddings.data(), num_probes,
+                              coarse_distances.data(), coarse_labels.data());
+  } catch (const std::exception& e) {
+    return Status::Corruption(e.what());
+  }
+
+  std::vector<faiss::idx_t> labels;
+  labels.reserve(coarse_labels.size());
+
+  for (faiss::idx_t label : coarse_labels) {
+    if (label >= 0) {
+      labels.push_back(label);
+    }
+  }
+
+  std::sort(labels.begin(), labels.end());
+  labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+  KNNContext knn_context{it, {}};
+  CachedLists lists;
+
+  for (faiss::idx_t label : labels) {
+    CachedList& list = lists[label];
+
+    for (it->Seek(SerializeLabel(label)); it->Valid(); it->Next()) {
+      if (!it->PrepareValue()) {
+        break;
+      }
+
+      const Slice value = it->value();
+      if (value.size() != index_->code_size) {
+        return Status::Corruption(
+            "Code with unexpected size encountered during iteration in "
+            "FaissIVFIndex");
+      }
+
+      list.ids.push_back(static_cast<faiss::idx_t>(knn_context.keys.size()));
+      list.codes.append(value.data(), value.size());
+      knn_context.keys.emplace_back(it->key().ToString());
+    }
+
+    if (!it->status().ok()) {
+      return it->status();
+    }
+  }
+
+  knn_context.lists = &lists;
+
+  std::vector<float> distances(targets.size() * neighbors, 0.0f);
+  std::vector<faiss::idx_t> ids(targets.size() * neighbors, -1);
+
+  faiss::SearchParametersIVF params;
+  params.nprobe = probes;
+  params.inverted_list_context = &knn_context;
+
+  try {
+    index_->search(n, embeddings.data(), neighbors, distances.data(),
+                   ids.data(), &params);
+  } catch (const std::exception& e) {
+    return Status::Corruption(e.what());
+  }
+
+  results->resize(targets.size());
+
+  for (size_t q = 0; q < targets.size(); ++q) {
+    auto& result = (*results)[q];
+    result.reserve(neighbors);
+
+    for (size_t i = q * neighbors; i < (q + 1) * neighbors; ++i) {
+      if (ids[i] < 0) {
+        break;
+      }
+
+      if (static_cast<size_t>(ids[i]) >= knn_context.keys.size()) {
+        results->clear();
+        return Status::Corruption("Unexpected id returned by FAISS");
+      }
+
+      result.emplace_back(knn_context.keys[ids[i]], distances[i]);
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
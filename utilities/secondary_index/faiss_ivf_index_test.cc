@@ -358,6 +358,51 @@ TEST(FaissIVFIndexTest, Compare) {
         }
       }
     }
+
+    // The batched search returns the same results
+    std::vector<Slice> targets;
+    for (faiss::idx_t i = 0; i < num_query; ++i) {
+      targets.emplace_back(
+          ConvertFloatsToSlice(embeddings_query.data() + i * dim, dim));
+    }
+
+    for (size_t neighbors : {1, 4}) {
+      for (size_t probes : {1, 4}) {
+        std::vector<float> distances(num_query * neighbors, 0.0f);
+        std::vector<faiss::idx_t> ids(num_query * neighbors, -1);
+
+        faiss::SearchParametersIVF params;
+        params.nprobe = probes;
+
+        index_cmp->search(num_query, embeddings_query.data(), neighbors,
+                          distances.data(), ids.data(), &params);
+
+        std::vector<std::vector<std::pair<std::string, float>>> results;
+        ASSERT_OK(faiss_ivf_index->FindKNearestNeighborsBatch(
+            secondary_it.get(), targets, neighbors, probes, &results));
+        ASSERT_EQ(results.size(), static_cast<size_t>(num_query));
+
+        for (faiss::idx_t i = 0; i < num_query; ++i) {
+          const auto& result = results[i];
+          ASSERT_LE(result.size(), neighbors);
+
+          for (size_t j = 0; j < result.size(); ++j) {
+            const size_t k = i * neighbors + j;
+            ASSERT_EQ(get_id(result[j].first), ids[k]);
+            ASSERT_EQ(result[j].second, distances[k]);
+          }
+
+          if (result.size() < neighbors) {
+            ASSERT_LT(ids[i * neighbors + result.size()], 0);
+          }
+        }
+      }
+    }
+
+    std::vector<std::vector<std::pair<std::string, float>>> results;
+    ASSERT_OK(faiss_ivf_index->FindKNearestNeighborsBatch(
+        secondary_it.get(), {}, 4, 4, &results));
+    ASSERT_TRUE(results.empty());
   }
 }
 
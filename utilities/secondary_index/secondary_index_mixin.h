@@ -6,14 +6,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include "db/db_impl/db_impl.h"
+#include "db/wide/wide_column_serialization.h"
 #include "db/wide/wide_columns_helper.h"
 #include "rocksdb/options.h"
+#include "rocksdb/write_batch.h"
 #include "rocksdb/utilities/secondary_index.h"
 #include "rocksdb/wide_columns.h"
 #include "util/autovector.h"
@@ -165,7 +170,249 @@ class SecondaryIndexMixin : public Txn {
     });
   }
 
+  // Applies the operations of the batch like the base class, except that the
+  // existing entries of the keys in the primary column families are looked up
+  // with one MultiGetEntity per column family up front, rather than with one
+  // GetEntityForUpdate per operation.
+  Status RebuildFromWriteBatch(WriteBatch* src_batch) override {
+    assert(src_batch);
+
+    std::vector<BatchOperation> operations;
+    bool has_timestamps = false;
+
+    {
+      BatchOperationCollector collector(Txn::dbimpl_, &operations,
+                                        &has_timestamps);
+      const Status s = src_batch->Iterate(&collector);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    if (has_timestamps) {
+      return Txn::RebuildFromWriteBatch(src_batch);
+    }
+
+    std::vector<std::unique_ptr<PrefetchedEntry>> prefetched(
+        operations.size());
+
+    {
+      const Status s = PrefetchPrimaryEntries(operations, prefetched);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    for (size_t i = 0; i < operations.size(); ++i) {
+      const Status s = ApplyBatchOperation(operations[i], prefetched[i].get());
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    return Status::OK();
+  }
+
  private:
+  struct BatchOperation {
+    ValueType type;
+    ColumnFamilyHandle* column_family;
+    Slice key;
+    Slice value;
+  };
+
+  // The existing primary entry of a key, looked up ahead of the operation
+  struct PrefetchedEntry {
+    Status status;
+    PinnableWideColumns columns;
+  };
+
+  class BatchOperationCollector : public WriteBatch::Handler {
+   public:
+    BatchOperationCollector(DBImpl* db, std::vector<BatchOperation>* operations,
+                            bool* has_timestamps)
+        : db_(db), operations_(operations), has_timestamps_(has_timestamps) {
+      assert(db_);
+      assert(operations_);
+      assert(has_timestamps_);
+    }
+
+    Status PutCF(uint32_t cf, const Slice& key, const Slice& value) override {
+      return Add(kTypeValue, cf, key, value);
+    }
+
+    Status PutEntityCF(uint32_t cf, const Slice& key,
+                       const Slice& entity) override {
+      return Add(kTypeWideColumnEntity, cf, key, entity);
+    }
+
+    Status DeleteCF(uint32_t cf, const Slice& key) override {
+      return Add(kTypeDeletion, cf, key, Slice());
+    }
+
+    Status SingleDeleteCF(uint32_t cf, const Slice& key) override {
+      return Add(kTypeSingleDeletion, cf, key, Slice());
+    }
+
+    Status MergeCF(uint32_t /* cf */, const Slice& /* key */,
+                   const Slice& /* value */) override {
+      return Status::NotSupported(
+          "Merge with secondary indices not yet supported");
+    }
+
+   private:
+    Status Add(ValueType type, uint32_t cf, const Slice& key,
+               const Slice& value) {
+      ColumnFamilyHandle* const column_family =
+          db_->GetColumnFamilyHandle(cf);
+      if (!column_family) {
+        return Status::InvalidArgument("Invalid column family in batch");
+      }
+
+      if (column_family->GetComparator()->timestamp_size() > 0) {
+        *has_timestamps_ = true;
+      }
+
+      operations_->push_back(BatchOperation{type, column_family, key, value});
+
+      return Status::OK();
+    }
+
+    DBImpl* db_;
+    std::vector<BatchOperation>* operations_;
+    bool* has_timestamps_;
+  };
+
+  // Whether the existing entries of the column family can be looked up before
+  // any operation of the batch is applied. This is not the case when the
+  // column family also holds secondary entries, since those are written by
+  // the operations of other keys.
+  bool CanPrefetchPrimaryEntries(ColumnFamilyHandle* column_family) const {
+    bool is_primary = false;
+
+    for (const auto& secondary_index : *secondary_indices_) {
+      assert(secondary_index);
+
+      if (secondary_index->GetSecondaryColumnFamily() == column_family) {
+        return false;
+      }
+
+      if (secondary_index->GetPrimaryColumnFamily() == column_family) {
+        is_primary = true;
+      }
+    }
+
+    return is_primary;
+  }
+
+  // Locks the keys of the primary column families like GetEntityForUpdate,
+  // and reads their existing entries with one MultiGetEntity per column
+  // family. Only the first operation on a key is prefetched; later ones
+  // read what the earlier operations of the batch wrote.
+  Status PrefetchPrimaryEntries(
+      const std::vector<BatchOperation>& operations,
+      std::vector<std::unique_ptr<PrefetchedEntry>>& prefetched) {
+    assert(prefetched.size() == operations.size());
+
+    autovector<ColumnFamilyHandle*> column_families;
+    std::unordered_set<std::string> seen_keys;
+
+    for (const auto& operation : operations) {
+      if (std::find(column_families.begin(), column_families.end(),
+                    operation.column_family) == column_families.end() &&
+          CanPrefetchPrimaryEntries(operation.column_family)) {
+        column_families.push_back(operation.column_family);
+      }
+    }
+
+    for (ColumnFamilyHandle* column_family : column_families) {
+      std::vector<size_t> indices;
+      std::vector<Slice> keys;
+
+      seen_keys.clear();
+
+      for (size_t i = 0; i < operations.size(); ++i) {
+        const auto& operation = operations[i];
+        if (operation.column_family != column_family ||
+            !seen_keys.insert(operation.key.ToString()).second) {
+          continue;
+        }
+
+        constexpr bool read_only = true;
+        constexpr bool exclusive = true;
+        constexpr bool do_validate = true;
+
+        const Status s = Txn::TryLock(column_family, operation.key, read_only,
+                                      exclusive, do_validate);
+        if (!s.ok()) {
+          return s;
+        }
+
+        indices.push_back(i);
+        keys.push_back(operation.key);
+      }
+
+      std::vector<PinnableWideColumns> results(keys.size());
+      std::vector<Status> statuses(keys.size());
+
+      Txn::MultiGetEntity(ReadOptions(), column_family, keys.size(),
+                          keys.data(), results.data(), statuses.data());
+
+      for (size_t j = 0; j < indices.size(); ++j) {
+        auto& entry = prefetched[indices[j]];
+        entry.reset(new PrefetchedEntry);
+        entry->status = std::move(statuses[j]);
+        entry->columns = std::move(results[j]);
+      }
+    }
+
+    return Status::OK();
+  }
+
+  Status ApplyBatchOperation(const BatchOperation& operation,
+                             PrefetchedEntry* prefetched) {
+    constexpr bool do_validate = true;
+
+    switch (operation.type) {
+      case kTypeValue:
+        return PerformWithSavePoint([&]() {
+          return PutWithSecondaryIndicesImpl(operation.column_family,
+                                             operation.key, operation.value,
+                                             do_validate, prefetched);
+        });
+      case kTypeWideColumnEntity: {
+        Slice entity = operation.value;
+        WideColumns columns;
+
+        const Status s = WideColumnSerialization::Deserialize(entity, columns);
+        if (!s.ok()) {
+          return s;
+        }
+
+        return PerformWithSavePoint([&]() {
+          return PutWithSecondaryIndicesImpl(operation.column_family,
+                                             operation.key, columns,
+                                             do_validate, prefetched);
+        });
+      }
+      case kTypeDeletion:
+        return PerformWithSavePoint([&]() {
+          return DeleteWithSecondaryIndices(operation.column_family,
+                                            operation.key, do_validate,
+                                            prefetched);
+        });
+      case kTypeSingleDeletion:
+        return PerformWithSavePoint([&]() {
+          return SingleDeleteWithSecondaryIndices(operation.column_family,
+                                                  operation.key, do_validate,
+                                                  prefetched);
+        });
+      default:
+        assert(false);
+        return Status::InvalidArgument("Unexpected operation in batch");
+    }
+  }
+
   class IndexData {
    public:
     IndexData(const SecondaryIndex* index, const Slice& previous_column_value)
@@ -214,10 +461,16 @@ class SecondaryIndexMixin : public Txn {
   Status GetPrimaryEntryForUpdate(ColumnFamilyHandle* column_family,
                                   const Slice& primary_key,
                                   PinnableWideColumns* existing_primary_columns,
-                                  bool do_validate) {
+                                  bool do_validate,
+                                  PrefetchedEntry* prefetched) {
     assert(column_family);
     assert(existing_primary_columns);
 
+    if (prefetched) {
+      *existing_primary_columns = std::move(prefetched->columns);
+      return prefetched->status;
+    }
+
     constexpr bool exclusive = true;
 
     return Txn::GetEntityForUpdate(ReadOptions(), column_family, primary_key,
@@ -459,7 +712,8 @@ class SecondaryIndexMixin : public Txn {
   Status PutWithSecondaryIndicesImpl(ColumnFamilyHandle* column_family,
                                      const Slice& key,
                                      const Value& value_or_columns,
-                                     bool do_validate) {
+                                     bool do_validate,
+                                     PrefetchedEntry* prefetched = nullptr) {
     // TODO: we could avoid removing and recreating secondary entries for
     // which neither the secondary key prefix nor the value has changed
 
@@ -472,8 +726,10 @@ class SecondaryIndexMixin : public Txn {
     {
       PinnableWideColumns existing_primary_columns;
 
-      const Status s = GetPrimaryEntryForUpdate(
-          column_family, primary_key, &existing_primary_columns, do_validate);
+      const Status s =
+          GetPrimaryEntryForUpdate(column_family, primary_key,
+                                   &existing_primary_columns, do_validate,
+                                   prefetched);
       if (!s.ok()) {
         if (!s.IsNotFound()) {
           return s;
@@ -534,6 +790,7 @@ class SecondaryIndexMixin : public Txn {
   template <typename Operation>
   Status DeleteWithSecondaryIndicesImpl(ColumnFamilyHandle* column_family,
                                         const Slice& key, bool do_validate,
+                                        PrefetchedEntry* prefetched,
                                         Operation&& operation) {
     if (!column_family) {
       column_family = Txn::DefaultColumnFamily();
@@ -542,8 +799,10 @@ class SecondaryIndexMixin : public Txn {
     {
       PinnableWideColumns existing_primary_columns;
 
-      const Status s = GetPrimaryEntryForUpdate(
-          column_family, key, &existing_primary_columns, do_validate);
+      const Status s =
+          GetPrimaryEntryForUpdate(column_family, key,
+                                   &existing_primary_columns, do_validate,
+                                   prefetched);
       if (!s.ok()) {
         if (!s.IsNotFound()) {
           return s;
@@ -570,9 +829,10 @@ class SecondaryIndexMixin : public Txn {
   }
 
   Status DeleteWithSecondaryIndices(ColumnFamilyHandle* column_family,
-                                    const Slice& key, bool do_validate) {
+                                    const Slice& key, bool do_validate,
+                                    PrefetchedEntry* prefetched = nullptr) {
     return DeleteWithSecondaryIndicesImpl(
-        column_family, key, do_validate,
+        column_family, key, do_validate, prefetched,
         [&](ColumnFamilyHandle* cfh, const Slice& primary_key) {
           assert(cfh);
 
@@ -582,10 +842,11 @@ class SecondaryIndexMixin : public Txn {
         });
   }
 
-  Status SingleDeleteWithSecondaryIndices(ColumnFamilyHandle* column_family,
-                                          const Slice& key, bool do_validate) {
+  Status SingleDeleteWithSecondaryIndices(
+      ColumnFamilyHandle* column_family, const Slice& key, bool do_validate,
+      PrefetchedEntry* prefetched = nullptr) {
     return DeleteWithSecondaryIndicesImpl(
-        column_family, key, do_validate,
+        column_family, key, do_validate, prefetched,
         [&](ColumnFamilyHandle* cfh, const Slice& primary_key) {
           assert(cfh);
 
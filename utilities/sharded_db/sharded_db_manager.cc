@@ -0,0 +1,121 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/sharded_db_manager.h"
+
+#include <map>
+
+#include "port/port.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct ShardedDBManager::Rep {
+  ColumnFamilyOptions shard_options;
+  std::unique_ptr<DB> db;
+  // Protects `shards`
+  mutable port::Mutex mutex;
+  std::map<std::string, ColumnFamilyHandle*> shards;
+  ColumnFamilyHandle* default_handle = nullptr;
+};
+
+Status ShardedDBManager::Open(const ShardedDBManagerOptions& options,
+                              const std::string& path,
+                              std::unique_ptr<ShardedDBManager>* manager) {
+  std::vector<std::string> names;
+  Status s = DB::ListColumnFamilies(options.db_options, path, &names);
+  if (!s.ok()) {
+    // A new DB, or an error for DB::Open() to report
+    names = {kDefaultColumnFamilyName};
+  }
+  std::vector<ColumnFamilyDescriptor> descriptors;
+  for (const auto& name : names) {
+    descriptors.emplace_back(name, options.shard_options);
+  }
+  std::vector<ColumnFamilyHandle*> handles;
+  DB* db = nullptr;
+  s = DB::Open(options.db_options, path, descriptors, &handles, &db);
+  if (!s.ok()) {
+    return s;
+  }
+  std::unique_ptr<Rep> rep(new Rep());
+  rep->shard_options = options.shard_options;
+  rep->db.reset(db);
+  for (auto* handle : handles) {
+    if (handle->GetName() == kDefaultColumnFamilyName) {
+      rep->default_handle = handle;
+    } else {
+      rep->shards[handle->GetName()] = handle;
+    }
+  }
+  manager->reset(new ShardedDBManager(std::move(rep)));
+  return Status::OK();
+}
+
+ShardedDBManager::ShardedDBManager(std::unique_ptr<Rep>&& rep)
+    : rep_(std::move(rep)) {}
+
+ShardedDBManager::~ShardedDBManager() {
+  for (auto& shard : rep_->shards) {
+    rep_->db->DestroyColumnFamilyHandle(shard.second).PermitUncheckedError();
+  }
+  rep_->db->DestroyColumnFamilyHandle(rep_->default_handle)
+      .PermitUncheckedError();
+  rep_->db->Close().PermitUncheckedError();
+}
+
+Status ShardedDBManager::CreateShard(const std::string& name,
+                                     ColumnFamilyHandle** handle) {
+  if (name == kDefaultColumnFamilyName) {
+    return Status::InvalidArgument("Reserved shard name", name);
+  }
+  MutexLock l(&rep_->mutex);
+  if (rep_->shards.count(name) > 0) {
+    return Status::InvalidArgument("Shard already exists", name);
+  }
+  ColumnFamilyHandle* new_handle = nullptr;
+  Status s =
+      rep_->db->CreateColumnFamily(rep_->shard_options, name, &new_handle);
+  if (s.ok()) {
+    rep_->shards[name] = new_handle;
+    *handle = new_handle;
+  }
+  return s;
+}
+
+Status ShardedDBManager::DropShard(const std::string& name) {
+  MutexLock l(&rep_->mutex);
+  auto it = rep_->shards.find(name);
+  if (it == rep_->shards.end()) {
+    return Status::NotFound("No such shard", name);
+  }
+  Status s = rep_->db->DropColumnFamily(it->second);
+  if (s.ok()) {
+    s = rep_->db->DestroyColumnFamilyHandle(it->second);
+    rep_->shards.erase(it);
+  }
+  return s;
+}
+
+ColumnFamilyHandle* ShardedDBManager::GetShard(const std::string& name) const {
+  MutexLock l(&rep_->mutex);
+  auto it = rep_->shards.find(name);
+  return it == rep_->shards.end() ? nullptr : it->second;
+}
+
+std::vector<std::string> ShardedDBManager::GetShardNames() const {
+  MutexLock l(&rep_->mutex);
+  std::vector<std::string> names;
+  names.reserve(rep_->shards.size());
+  for (const auto& shard : rep_->shards) {
+    names.push_back(shard.first);
+  }
+  return names;
+}
+
+DB* ShardedDBManager::db() const { return rep_->db.get(); }
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,90 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/sharded_db_manager.h"
+
+#include "port/stack_trace.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/table.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ShardedDBManagerTest : public testing::Test {
+ public:
+  ShardedDBManagerTest()
+      : path_(test::PerThreadDBPath("sharded_db_manager_test")) {
+    options_.db_options.create_if_missing = true;
+    BlockBasedTableOptions bbto;
+    bbto.block_cache = NewLRUCache(1 << 20);
+    options_.shard_options.table_factory.reset(
+        NewBlockBasedTableFactory(bbto));
+    EXPECT_OK(DestroyDB(path_, Options()));
+  }
+
+  ~ShardedDBManagerTest() override {
+    manager_.reset();
+    EXPECT_OK(DestroyDB(path_, Options()));
+  }
+
+ protected:
+  std::string Get(const std::string& shard, const std::string& key) {
+    std::string value;
+    Status s = manager_->db()->Get(ReadOptions(), manager_->GetShard(shard),
+                                   key, &value);
+    return s.IsNotFound() ? "NOT_FOUND" : s.ok() ? value : s.ToString();
+  }
+
+  const std::string path_;
+  ShardedDBManagerOptions options_;
+  std::unique_ptr<ShardedDBManager> manager_;
+};
+
+TEST_F(ShardedDBManagerTest, Shards) {
+  ASSERT_OK(ShardedDBManager::Open(options_, path_, &manager_));
+  ASSERT_TRUE(manager_->GetShardNames().empty());
+
+  for (const char* name : {"tenant1", "tenant2", "tenant3"}) {
+    ColumnFamilyHandle* handle = nullptr;
+    ASSERT_OK(manager_->CreateShard(name, &handle));
+    ASSERT_EQ(handle, manager_->GetShard(name));
+    ASSERT_OK(manager_->db()->Put(WriteOptions(), handle, "key",
+                                  std::string("value of ") + name));
+  }
+  ColumnFamilyHandle* handle = nullptr;
+  ASSERT_TRUE(manager_->CreateShard("tenant1", &handle).IsInvalidArgument());
+  ASSERT_TRUE(manager_->CreateShard(kDefaultColumnFamilyName, &handle)
+                  .IsInvalidArgument());
+  ASSERT_EQ(nullptr, manager_->GetShard("tenant4"));
+
+  ASSERT_EQ("value of tenant1", Get("tenant1", "key"));
+  ASSERT_EQ("value of tenant2", Get("tenant2", "key"));
+  // The writes to all the shards went to one WAL
+  VectorWalPtr wal_files;
+  ASSERT_OK(manager_->db()->GetSortedWalFiles(wal_files));
+  ASSERT_EQ(1U, wal_files.size());
+
+  ASSERT_OK(manager_->DropShard("tenant2"));
+  ASSERT_TRUE(manager_->DropShard("tenant2").IsNotFound());
+  ASSERT_EQ(nullptr, manager_->GetShard("tenant2"));
+
+  // The shards and their data, recovered from the WAL, survive a reopen
+  manager_.reset();
+  ASSERT_OK(ShardedDBManager::Open(options_, path_, &manager_));
+  ASSERT_EQ(std::vector<std::string>({"tenant1", "tenant3"}),
+            manager_->GetShardNames());
+  ASSERT_EQ("value of tenant1", Get("tenant1", "key"));
+  ASSERT_EQ("value of tenant3", Get("tenant3", "key"));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,6 +14,29 @@ namespace ROCKSDB_NAMESPACE {
 
 namespace {
 const std::string kGhostCachePrefix = "ghost_";
+const std::string kWarmupCachePrefix = "lru_warmup_";
+
+bool IsMetaBlock(TraceType block_type) {
+  return block_type == TraceType::kBlockTraceFilterBlock ||
+         block_type == TraceType::kBlockTraceIndexBlock ||
+         block_type == TraceType::kBlockTraceUncompressionDictBlock;
+}
+
+bool ParseCompactionWarmupSimPolicy(const std::string& name,
+                                    CompactionWarmupSimPolicy* policy) {
+  if (name == "none") {
+    *policy = CompactionWarmupSimPolicy::kNoWarmup;
+  } else if (name == "outputs") {
+    *policy = CompactionWarmupSimPolicy::kWarmOutputs;
+  } else if (name == "hot") {
+    *policy = CompactionWarmupSimPolicy::kHotnessAwareWarmup;
+  } else if (name == "prepopulate") {
+    *policy = CompactionWarmupSimPolicy::kPrepopulateOnCompaction;
+  } else {
+    return false;
+  }
+  return true;
+}
 }  // namespace
 
 GhostCache::GhostCache(std::shared_ptr<Cache> sim_cache)
@@ -83,9 +106,7 @@ void MissRatioStats::UpdateMetrics(uint64_t timestamp_in_ms,
 
 Cache::Priority PrioritizedCacheSimulator::ComputeBlockPriority(
     const BlockCacheTraceRecord& access) const {
-  if (access.block_type == TraceType::kBlockTraceFilterBlock ||
-      access.block_type == TraceType::kBlockTraceIndexBlock ||
-      access.block_type == TraceType::kBlockTraceUncompressionDictBlock) {
+  if (IsMetaBlock(access.block_type)) {
     return Cache::Priority::HIGH;
   }
   return Cache::Priority::LOW;
@@ -202,6 +223,135 @@ void HybridRowBlockCacheSimulator::Access(const BlockCacheTraceRecord& access) {
                &is_cache_miss, &admitted, /*update_metrics=*/true);
 }
 
+void TraceFileBlocks::Add(const BlockCacheTraceRecord& access) {
+  auto it = block_index_.find(access.block_key);
+  if (it == block_index_.end()) {
+    std::vector<TraceFileBlock>& blocks = file_blocks_[access.sst_fd_number];
+    it = block_index_
+             .emplace(access.block_key,
+                      std::make_pair(access.sst_fd_number, blocks.size()))
+             .first;
+    blocks.emplace_back();
+    blocks.back().block_key = access.block_key;
+    blocks.back().block_type = access.block_type;
+  }
+  TraceFileBlock& block = file_blocks_[it->second.first][it->second.second];
+  block.block_size = std::max(block.block_size, access.block_size);
+  if (!BlockCacheTraceHelper::IsGetOrMultiGetOnDataBlock(access.block_type,
+                                                         access.caller) ||
+      access.referenced_key.size() < kNumInternalBytes) {
+    return;
+  }
+  const Slice user_key = ExtractUserKey(access.referenced_key);
+  if (block.smallest_user_key.empty() ||
+      user_key.compare(block.smallest_user_key) < 0) {
+    block.smallest_user_key = user_key.ToString();
+  }
+  if (user_key.compare(block.largest_user_key) > 0) {
+    block.largest_user_key = user_key.ToString();
+  }
+}
+
+const std::vector<TraceFileBlock>* TraceFileBlocks::GetBlocks(
+    uint64_t file_number) const {
+  auto it = file_blocks_.find(file_number);
+  return it != file_blocks_.end() ? &it->second : nullptr;
+}
+
+void CompactionWarmupSimulator::Access(const BlockCacheTraceRecord& access) {
+  const std::vector<CompactionEvent>& events =
+      warmup_options_->compaction_events;
+  while (next_event_ < events.size() &&
+         events[next_event_].timestamp <= access.access_timestamp) {
+    WarmUp(events[next_event_]);
+    next_event_++;
+  }
+  if (access.block_type == TraceType::kBlockTraceDataBlock &&
+      BlockCacheTraceHelper::IsUserAccess(access.caller)) {
+    data_block_accesses_[access.block_key]++;
+  }
+  PrioritizedCacheSimulator::Access(access);
+}
+
+void CompactionWarmupSimulator::WarmUp(const CompactionEvent& event) {
+  if (policy_ == CompactionWarmupSimPolicy::kNoWarmup) {
+    return;
+  }
+  // The disjoint key ranges of the hot data blocks of the inputs, sorted.
+  std::vector<std::pair<std::string, std::string>> hot_ranges;
+  if (policy_ == CompactionWarmupSimPolicy::kHotnessAwareWarmup) {
+    for (uint64_t file_number : event.input_file_numbers) {
+      const std::vector<TraceFileBlock>* blocks =
+          file_blocks_->GetBlocks(file_number);
+      if (blocks == nullptr) {
+        continue;
+      }
+      for (const TraceFileBlock& block : *blocks) {
+        auto it = data_block_accesses_.find(block.block_key);
+        if (it != data_block_accesses_.end() &&
+            it->second >= warmup_options_->min_data_block_hits &&
+            !block.smallest_user_key.empty()) {
+          hot_ranges.emplace_back(block.smallest_user_key,
+                                  block.largest_user_key);
+        }
+      }
+    }
+    std::sort(hot_ranges.begin(), hot_ranges.end());
+    size_t num_ranges = 0;
+    for (auto& range : hot_ranges) {
+      if (num_ranges > 0 && range.first <= hot_ranges[num_ranges - 1].second) {
+        hot_ranges[num_ranges - 1].second =
+            std::max(hot_ranges[num_ranges - 1].second, range.second);
+      } else {
+        hot_ranges[num_ranges++] = std::move(range);
+      }
+    }
+    hot_ranges.resize(num_ranges);
+  }
+
+  uint64_t bytes = 0;
+  for (uint64_t file_number : event.output_file_numbers) {
+    if (warmup_options_->max_bytes_per_compaction > 0 &&
+        bytes >= warmup_options_->max_bytes_per_compaction) {
+      break;
+    }
+    const std::vector<TraceFileBlock>* blocks =
+        file_blocks_->GetBlocks(file_number);
+    if (blocks == nullptr) {
+      continue;
+    }
+    for (const TraceFileBlock& block : *blocks) {
+      Cache::Priority priority = Cache::Priority::BOTTOM;
+      if (policy_ == CompactionWarmupSimPolicy::kPrepopulateOnCompaction) {
+        priority = IsMetaBlock(block.block_type) ? Cache::Priority::HIGH
+                                                 : Cache::Priority::LOW;
+      } else if (block.block_type != TraceType::kBlockTraceDataBlock) {
+        continue;
+      }
+      if (policy_ == CompactionWarmupSimPolicy::kHotnessAwareWarmup) {
+        // The first hot range that does not end before the block.
+        auto it = std::lower_bound(
+            hot_ranges.begin(), hot_ranges.end(), block.smallest_user_key,
+            [](const std::pair<std::string, std::string>& range,
+               const std::string& key) { return range.second < key; });
+        if (block.smallest_user_key.empty() || it == hot_ranges.end() ||
+            it->first > block.largest_user_key) {
+          continue;
+        }
+      }
+      if (block.block_size == 0) {
+        continue;
+      }
+      auto s = sim_cache_->Insert(block.block_key, /*obj=*/nullptr,
+                                  &kNoopCacheItemHelper, block.block_size,
+                                  /*handle=*/nullptr, priority);
+      s.PermitUncheckedError();
+      bytes += block.block_size;
+    }
+  }
+  warmed_bytes_ += bytes;
+}
+
 BlockCacheTraceSimulator::BlockCacheTraceSimulator(
     uint64_t warmup_seconds, uint32_t downsample_ratio,
     const std::vector<CacheConfiguration>& cache_configurations)
@@ -209,6 +359,12 @@ BlockCacheTraceSimulator::BlockCacheTraceSimulator(
       downsample_ratio_(downsample_ratio),
       cache_configurations_(cache_configurations) {}
 
+void BlockCacheTraceSimulator::SetCompactionWarmupOptions(
+    CompactionWarmupSimOptions&& options) {
+  warmup_options_ =
+      std::make_shared<CompactionWarmupSimOptions>(std::move(options));
+}
+
 Status BlockCacheTraceSimulator::InitializeCaches() {
   for (auto const& config : cache_configurations_) {
     for (auto cache_capacity : config.cache_capacities) {
@@ -251,6 +407,28 @@ Status BlockCacheTraceSimulator::InitializeCaches() {
                         /*strict_capacity_limit=*/false,
                         /*high_pri_pool_ratio=*/0.5),
             /*insert_blocks_upon_row_kvpair_miss=*/false);
+      } else if (cache_name.compare(0, kWarmupCachePrefix.size(),
+                                    kWarmupCachePrefix) == 0) {
+        CompactionWarmupSimPolicy policy;
+        if (!ParseCompactionWarmupSimPolicy(
+                cache_name.substr(kWarmupCachePrefix.size()), &policy)) {
+          return Status::InvalidArgument("Unknown cache name " +
+                                         config.cache_name);
+        }
+        if (warmup_options_ == nullptr) {
+          return Status::InvalidArgument("No compaction events for cache " +
+                                         config.cache_name);
+        }
+        // Reads go to the low-pri pool, so that what is warmed up at
+        // Cache::Priority::BOTTOM is evicted first.
+        LRUCacheOptions cache_options(simulate_cache_capacity,
+                                      config.num_shard_bits,
+                                      /*_strict_capacity_limit=*/false,
+                                      /*_high_pri_pool_ratio=*/0.5);
+        cache_options.low_pri_pool_ratio = 0.5;
+        sim_cache = std::make_shared<CompactionWarmupSimulator>(
+            std::move(ghost_cache), cache_options.MakeSharedCache(), policy,
+            warmup_options_, trace_file_blocks_);
       } else {
         // Not supported.
         return Status::InvalidArgument("Unknown cache name " +
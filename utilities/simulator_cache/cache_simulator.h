@@ -191,6 +191,103 @@ class HybridRowBlockCacheSimulator : public PrioritizedCacheSimulator {
   bool insert_blocks_upon_row_kvpair_miss_;
 };
 
+// A compaction that ran while the block cache trace was recorded, e.g. as
+// reported by EventListener::OnCompactionCompleted().
+struct CompactionEvent {
+  // When the compaction completed, in microseconds like the access timestamps
+  // of the trace.
+  uint64_t timestamp = 0;
+  std::vector<uint64_t> input_file_numbers;
+  std::vector<uint64_t> output_file_numbers;
+};
+
+// A block of an SST file, as seen in the block cache trace.
+struct TraceFileBlock {
+  std::string block_key;
+  TraceType block_type = TraceType::kTraceMax;
+  uint64_t block_size = 0;
+  // The range of the user keys that Get/MultiGet looked up in the block. Empty
+  // if none did.
+  std::string smallest_user_key;
+  std::string largest_user_key;
+};
+
+// The blocks of each SST file that a block cache trace accessed. The output
+// files of a compaction are only accessed after it completes, so they are
+// collected by a first pass over the trace for the simulation of their
+// warmup.
+class TraceFileBlocks {
+ public:
+  void Add(const BlockCacheTraceRecord& access);
+
+  // Returns the blocks of the file in the order of their first access, or
+  // nullptr if the trace does not access the file.
+  const std::vector<TraceFileBlock>* GetBlocks(uint64_t file_number) const;
+
+ private:
+  std::unordered_map<uint64_t, std::vector<TraceFileBlock>> file_blocks_;
+  // The file number and the index in its blocks of each block.
+  std::unordered_map<std::string, std::pair<uint64_t, size_t>> block_index_;
+};
+
+// The ways of warming up the block cache after a compaction that
+// CompactionWarmupSimulator compares.
+enum class CompactionWarmupSimPolicy : char {
+  // The blocks of the output files are only read on a cache miss.
+  kNoWarmup,
+  // The data blocks of the output files are inserted at Cache::Priority::BOTTOM
+  // once the compaction completes, as with CompactionWarmupMode::kOutputFiles.
+  kWarmOutputs,
+  // Only the data blocks of the output files overlapping the key ranges of
+  // the hot data blocks of the inputs are inserted, as with
+  // CompactionWarmupMode::kHotKeyRanges.
+  kHotnessAwareWarmup,
+  // All the blocks of the output files are inserted with the priority of a
+  // read, as with PrepopulateBlockCache::kFlushAndCompaction.
+  kPrepopulateOnCompaction,
+};
+
+// The compactions of a trace and the parameters of the warmup of their output
+// files.
+struct CompactionWarmupSimOptions {
+  // Sorted by timestamp.
+  std::vector<CompactionEvent> compaction_events;
+  // Like CompactionWarmupPolicy::max_bytes_per_compaction. 0 means no limit.
+  uint64_t max_bytes_per_compaction = 0;
+  // The number of accesses after which a data block of an input file is hot.
+  uint64_t min_data_block_hits = 1;
+};
+
+// A prioritized cache simulator that also warms up the output files of the
+// compactions of the trace with the given policy when they complete.
+class CompactionWarmupSimulator : public PrioritizedCacheSimulator {
+ public:
+  CompactionWarmupSimulator(
+      std::unique_ptr<GhostCache>&& ghost_cache,
+      std::shared_ptr<Cache> sim_cache, CompactionWarmupSimPolicy policy,
+      std::shared_ptr<const CompactionWarmupSimOptions> warmup_options,
+      std::shared_ptr<const TraceFileBlocks> file_blocks)
+      : PrioritizedCacheSimulator(std::move(ghost_cache), sim_cache),
+        policy_(policy),
+        warmup_options_(std::move(warmup_options)),
+        file_blocks_(std::move(file_blocks)) {}
+  void Access(const BlockCacheTraceRecord& access) override;
+
+  uint64_t warmed_bytes() const { return warmed_bytes_; }
+
+ private:
+  void WarmUp(const CompactionEvent& event);
+
+  const CompactionWarmupSimPolicy policy_;
+  const std::shared_ptr<const CompactionWarmupSimOptions> warmup_options_;
+  const std::shared_ptr<const TraceFileBlocks> file_blocks_;
+  // The next compaction to warm up.
+  size_t next_event_ = 0;
+  uint64_t warmed_bytes_ = 0;
+  // The number of accesses of each data block so far.
+  std::unordered_map<std::string, uint64_t> data_block_accesses_;
+};
+
 // A block cache simulator that reports miss ratio curves given a set of cache
 // configurations.
 class BlockCacheTraceSimulator {
@@ -207,6 +304,18 @@ class BlockCacheTraceSimulator {
   BlockCacheTraceSimulator(BlockCacheTraceSimulator&&) = delete;
   BlockCacheTraceSimulator& operator=(BlockCacheTraceSimulator&&) = delete;
 
+  // Sets the compactions that the caches named "lru_warmup_*" warm up. Must
+  // be called before InitializeCaches().
+  void SetCompactionWarmupOptions(CompactionWarmupSimOptions&& options);
+
+  // Whether the blocks of the trace must be passed to AddTraceFileBlock()
+  // before the first Access().
+  bool NeedsTraceFileBlocks() const { return warmup_options_ != nullptr; }
+
+  void AddTraceFileBlock(const BlockCacheTraceRecord& access) {
+    trace_file_blocks_->Add(access);
+  }
+
   Status InitializeCaches();
 
   void Access(const BlockCacheTraceRecord& access);
@@ -226,6 +335,9 @@ class BlockCacheTraceSimulator {
   std::map<CacheConfiguration, std::vector<std::shared_ptr<CacheSimulator>>>
       sim_caches_;
   uint64_t trace_start_time_ = 0;
+  std::shared_ptr<const CompactionWarmupSimOptions> warmup_options_;
+  std::shared_ptr<TraceFileBlocks> trace_file_blocks_ =
+      std::make_shared<TraceFileBlocks>();
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -488,6 +488,84 @@ TEST_F(CacheSimulatorTest, GhostHybridRowBlockCacheSimulator) {
                     cache_simulator->miss_ratio_stats().user_miss_ratio()));
 }
 
+TEST_F(CacheSimulatorTest, CompactionWarmupSimulator) {
+  uint64_t timestamp = 1;
+  auto make_record = [&](uint64_t file_number, const std::string& block,
+                         TraceType block_type, const std::string& key) {
+    BlockCacheTraceRecord record = GenerateGetRecord(kGetId);
+    record.access_timestamp = timestamp++;
+    record.sst_fd_number = file_number;
+    record.block_key = kBlockKeyPrefix + block;
+    record.block_type = block_type;
+    record.referenced_key = key + kRefKeySequenceNumber;
+    return record;
+  };
+  // File 1 is compacted into file 2. Only block a of file 1 is hot, and only
+  // block c of file 2 overlaps it.
+  std::vector<BlockCacheTraceRecord> trace;
+  trace.push_back(make_record(1, "a", TraceType::kBlockTraceDataBlock, "k1"));
+  trace.push_back(make_record(1, "a", TraceType::kBlockTraceDataBlock, "k1"));
+  trace.push_back(make_record(1, "b", TraceType::kBlockTraceDataBlock, "k5"));
+  CompactionEvent event;
+  event.timestamp = timestamp++;
+  event.input_file_numbers = {1};
+  event.output_file_numbers = {2};
+  trace.push_back(make_record(2, "i", TraceType::kBlockTraceIndexBlock, "k1"));
+  trace.push_back(make_record(2, "c", TraceType::kBlockTraceDataBlock, "k1"));
+  trace.push_back(make_record(2, "d", TraceType::kBlockTraceDataBlock, "k5"));
+
+  const std::vector<std::string> cache_names = {
+      "lru_warmup_none", "lru_warmup_outputs", "lru_warmup_hot",
+      "lru_warmup_prepopulate"};
+  std::vector<CacheConfiguration> configs;
+  for (const auto& cache_name : cache_names) {
+    CacheConfiguration config;
+    config.cache_name = cache_name;
+    config.num_shard_bits = 1;
+    config.ghost_cache_capacity = 0;
+    config.cache_capacities = {kCacheSize};
+    configs.push_back(config);
+  }
+  BlockCacheTraceSimulator simulator(/*warmup_seconds=*/0,
+                                     /*downsample_ratio=*/1, configs);
+  ASSERT_TRUE(simulator.InitializeCaches().IsInvalidArgument());
+
+  BlockCacheTraceSimulator warmup_simulator(/*warmup_seconds=*/0,
+                                            /*downsample_ratio=*/1, configs);
+  CompactionWarmupSimOptions warmup_options;
+  warmup_options.compaction_events = {event};
+  warmup_options.min_data_block_hits = 2;
+  warmup_simulator.SetCompactionWarmupOptions(std::move(warmup_options));
+  ASSERT_OK(warmup_simulator.InitializeCaches());
+  ASSERT_TRUE(warmup_simulator.NeedsTraceFileBlocks());
+  for (const auto& access : trace) {
+    warmup_simulator.AddTraceFileBlock(access);
+  }
+  for (const auto& access : trace) {
+    warmup_simulator.Access(access);
+  }
+
+  // The misses on a, b and on what is not warmed up of file 2.
+  const std::vector<uint64_t> expected_misses = {5, 3, 4, 2};
+  const std::vector<uint64_t> expected_warmed_bytes = {0, 2 * 4096, 4096,
+                                                       3 * 4096};
+  for (size_t i = 0; i < configs.size(); i++) {
+    auto it = warmup_simulator.sim_caches().find(configs[i]);
+    ASSERT_NE(warmup_simulator.sim_caches().end(), it);
+    ASSERT_EQ(1, it->second.size());
+    auto* cache_simulator =
+        static_cast<CompactionWarmupSimulator*>(it->second[0].get());
+    ASSERT_EQ(trace.size(),
+              cache_simulator->miss_ratio_stats().total_accesses())
+        << cache_names[i];
+    ASSERT_EQ(expected_misses[i],
+              cache_simulator->miss_ratio_stats().total_misses())
+        << cache_names[i];
+    ASSERT_EQ(expected_warmed_bytes[i], cache_simulator->warmed_bytes())
+        << cache_names[i];
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -13,6 +13,7 @@
 #include "port/port.h"
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
+#include "util/hash.h"
 #include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -351,6 +352,171 @@ class SimCacheImpl : public SimCache {
   }
 };
 
+// Estimates the hit ratio curve of the wrapped cache with miniature
+// simulations: each capacity ratio is simulated by a key-only LRU cache
+// scaled down by the sampling rate, which only sees the lookups and inserts
+// of the sampled keys.
+class MissRatioCurveCacheImpl : public MissRatioCurveCache {
+ public:
+  MissRatioCurveCacheImpl(std::shared_ptr<Cache> cache,
+                          const MissRatioCurveOptions& options)
+      : MissRatioCurveCache(std::move(cache)),
+        sampling_rate_(options.sampling_rate),
+        sampling_threshold_(
+            static_cast<uint64_t>(options.sampling_rate * kSamplingModulus)) {
+    for (double ratio : options.capacity_ratios) {
+      LRUCacheOptions co;
+      co.capacity = SimCapacity(ratio, target_->GetCapacity());
+      co.num_shard_bits = 0;
+      co.metadata_charge_policy = kDontChargeCacheMetadata;
+      sims_.emplace_back(new MiniSimulation(ratio, NewLRUCache(co)));
+    }
+  }
+
+  const char* Name() const override { return kClassName(); }
+
+  void SetCapacity(size_t capacity) override {
+    target_->SetCapacity(capacity);
+    for (auto& sim : sims_) {
+      sim->cache->SetCapacity(SimCapacity(sim->capacity_ratio, capacity));
+    }
+  }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const CacheItemHelper* helper, size_t charge, Handle** handle,
+                Priority priority, const Slice& compressed = {},
+                CompressionType type = kNoCompression) override {
+    if (IsSampled(key)) {
+      for (auto& sim : sims_) {
+        Handle* h = sim->cache->Lookup(key);
+        if (h == nullptr) {
+          sim->cache
+              ->Insert(key, nullptr, &kNoopCacheItemHelper, charge, nullptr,
+                       priority)
+              .PermitUncheckedError();
+        } else {
+          sim->cache->Release(h);
+        }
+      }
+    }
+    return target_->Insert(key, value, helper, charge, handle, priority,
+                           compressed, type);
+  }
+
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
+                 CreateContext* create_context,
+                 Priority priority = Priority::LOW,
+                 Statistics* stats = nullptr) override {
+    HandleLookup(key);
+    return target_->Lookup(key, helper, create_context, priority, stats);
+  }
+
+  void StartAsyncLookup(AsyncLookupHandle& async_handle) override {
+    HandleLookup(async_handle.key);
+    target_->StartAsyncLookup(async_handle);
+  }
+
+  void Erase(const Slice& key) override {
+    target_->Erase(key);
+    if (IsSampled(key)) {
+      for (auto& sim : sims_) {
+        sim->cache->Erase(key);
+      }
+    }
+  }
+
+  void EraseUnRefEntries() override {
+    target_->EraseUnRefEntries();
+    for (auto& sim : sims_) {
+      sim->cache->EraseUnRefEntries();
+    }
+  }
+
+  void DisownData() override {
+    target_->DisownData();
+    for (auto& sim : sims_) {
+      sim->cache->DisownData();
+    }
+  }
+
+  void GetHitRatioCurve(std::map<double, double>* curve) const override {
+    curve->clear();
+    for (const auto& sim : sims_) {
+      const uint64_t lookups = sim->lookups.load(std::memory_order_relaxed);
+      const uint64_t hits = sim->hits.load(std::memory_order_relaxed);
+      (*curve)[sim->capacity_ratio] =
+          lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+    }
+  }
+
+  uint64_t GetNumSampledLookups() const override {
+    return sims_.empty() ? 0
+                         : sims_[0]->lookups.load(std::memory_order_relaxed);
+  }
+
+  void ResetCurve() override {
+    for (auto& sim : sims_) {
+      sim->lookups.store(0, std::memory_order_relaxed);
+      sim->hits.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::string GetPrintableOptions() const override {
+    std::ostringstream oss;
+    oss << "    cache_options:" << std::endl;
+    oss << target_->GetPrintableOptions();
+    oss << "    miss_ratio_curve_options:" << std::endl;
+    oss << "    sampling_rate: " << sampling_rate_ << std::endl;
+    oss << "    capacity_ratios:";
+    for (const auto& sim : sims_) {
+      oss << " " << sim->capacity_ratio;
+    }
+    oss << std::endl;
+    return oss.str();
+  }
+
+ private:
+  static constexpr uint64_t kSamplingModulus = uint64_t{1} << 24;
+
+  struct MiniSimulation {
+    MiniSimulation(double _capacity_ratio, std::shared_ptr<Cache> _cache)
+        : capacity_ratio(_capacity_ratio), cache(std::move(_cache)) {}
+
+    const double capacity_ratio;
+    std::shared_ptr<Cache> cache;
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> hits{0};
+  };
+
+  size_t SimCapacity(double capacity_ratio, size_t capacity) const {
+    return static_cast<size_t>(capacity_ratio * sampling_rate_ *
+                               static_cast<double>(capacity));
+  }
+
+  bool IsSampled(const Slice& key) const {
+    return (GetSliceNPHash64(key) & (kSamplingModulus - 1)) <
+           sampling_threshold_;
+  }
+
+  void HandleLookup(const Slice& key) {
+    if (!IsSampled(key)) {
+      return;
+    }
+    for (auto& sim : sims_) {
+      Handle* h = sim->cache->Lookup(key);
+      if (h != nullptr) {
+        sim->cache->Release(h);
+        sim->hits.fetch_add(1, std::memory_order_relaxed);
+      }
+      sim->lookups.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  const double sampling_rate_;
+  const uint64_t sampling_threshold_;
+  std::vector<std::unique_ptr<MiniSimulation>> sims_;
+};
+
 }  // end anonymous namespace
 
 // For instrumentation purpose, use NewSimCache instead
@@ -372,4 +538,18 @@ std::shared_ptr<SimCache> NewSimCache(std::shared_ptr<Cache> sim_cache,
   return std::make_shared<SimCacheImpl>(sim_cache, cache);
 }
 
+std::shared_ptr<MissRatioCurveCache> NewMissRatioCurveCache(
+    std::shared_ptr<Cache> cache, const MissRatioCurveOptions& options) {
+  if (cache == nullptr || !(options.sampling_rate > 0) ||
+      options.sampling_rate > 1) {
+    return nullptr;
+  }
+  for (double ratio : options.capacity_ratios) {
+    if (!(ratio > 0)) {
+      return nullptr;
+    }
+  }
+  return std::make_shared<MissRatioCurveCacheImpl>(std::move(cache), options);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
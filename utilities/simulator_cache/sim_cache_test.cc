@@ -217,6 +217,87 @@ TEST_F(SimCacheTest, SimCacheLogging) {
   ASSERT_GT(fsize, max_size - 100);
 }
 
+TEST_F(SimCacheTest, MissRatioCurveCache) {
+  LRUCacheOptions co;
+  co.capacity = 10;
+  co.num_shard_bits = 0;
+  co.metadata_charge_policy = kDontChargeCacheMetadata;
+  MissRatioCurveOptions mrc_options;
+  mrc_options.sampling_rate = 1.0;
+  mrc_options.capacity_ratios = {0.5, 1, 2};
+  std::shared_ptr<MissRatioCurveCache> cache =
+      NewMissRatioCurveCache(NewLRUCache(co), mrc_options);
+  ASSERT_NE(cache, nullptr);
+  Cache* base = cache.get();
+
+  // Cycle through 15 keys of charge 1 with lookups and inserts on misses,
+  // which only hit in an LRU cache that holds all of them
+  const int kNumKeys = 15;
+  for (int it = 0; it < 10; it++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      std::string key = Key(i);
+      Cache::Handle* h = base->Lookup(key);
+      if (h != nullptr) {
+        base->Release(h);
+      } else {
+        ASSERT_OK(base->Insert(key, nullptr, &kNoopCacheItemHelper, 1));
+      }
+    }
+  }
+  ASSERT_EQ(cache->GetNumSampledLookups(), 10U * kNumKeys);
+  std::map<double, double> curve;
+  cache->GetHitRatioCurve(&curve);
+  ASSERT_EQ(curve.size(), 3U);
+  ASSERT_EQ(curve[0.5], 0.0);
+  ASSERT_EQ(curve[1], 0.0);
+  // All but the first cycle hit
+  ASSERT_DOUBLE_EQ(curve[2], 0.9);
+
+  cache->ResetCurve();
+  ASSERT_EQ(cache->GetNumSampledLookups(), 0U);
+
+  // Invalid options
+  mrc_options.sampling_rate = 0;
+  ASSERT_EQ(NewMissRatioCurveCache(NewLRUCache(co), mrc_options), nullptr);
+  mrc_options.sampling_rate = 0.5;
+  mrc_options.capacity_ratios = {-1};
+  ASSERT_EQ(NewMissRatioCurveCache(NewLRUCache(co), mrc_options), nullptr);
+}
+
+TEST_F(SimCacheTest, MissRatioCurveCacheProperty) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  InitTable(options);
+  ASSERT_OK(Flush());
+
+  std::map<std::string, std::string> values;
+  ASSERT_FALSE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheHitRatioCurve, &values));
+
+  MissRatioCurveOptions mrc_options;
+  mrc_options.sampling_rate = 1.0;
+  table_options.block_cache =
+      NewMissRatioCurveCache(NewLRUCache(1024 * 1024), mrc_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  for (size_t i = 0; i < kNumBlocks * 2; i++) {
+    ASSERT_EQ(Get(std::to_string(i)), std::string(kValueSize, 'a'));
+  }
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheHitRatioCurve, &values));
+  ASSERT_EQ(values.size(), 5U);
+  for (const char* ratio : {"0.5x", "1x", "2x", "4x"}) {
+    ASSERT_EQ(values.count(ratio), 1U);
+  }
+  ASSERT_GT(std::stoull(values["sampled_lookups"]), 0U);
+
+  std::string value;
+  ASSERT_TRUE(
+      db_->GetProperty(DB::Properties::kBlockCacheHitRatioCurve, &value));
+  ASSERT_NE(value.find("1x: "), std::string::npos);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
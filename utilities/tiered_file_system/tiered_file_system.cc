@@ -0,0 +1,500 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/tiered_file_system.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "env/fs_remap.h"
+#include "file/file_util.h"
+#include "port/port.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// Location of the files that are not in a temperature directory
+constexpr Temperature kBaseLocation = Temperature::kUnknown;
+
+std::string ParentDir(const std::string& path) {
+  const size_t pos = path.find_last_of('/');
+  return pos == std::string::npos ? std::string() : path.substr(0, pos);
+}
+
+std::string BaseName(const std::string& path) {
+  const size_t pos = path.find_last_of('/');
+  return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+// Syncs a directory along with its copies in the temperature directories
+class TieredDirectory : public FSDirectory {
+ public:
+  explicit TieredDirectory(std::vector<std::unique_ptr<FSDirectory>>&& dirs)
+      : dirs_(std::move(dirs)) {
+    assert(!dirs_.empty());
+  }
+
+  IOStatus Fsync(const IOOptions& options, IODebugContext* dbg) override {
+    for (auto& dir : dirs_) {
+      IOStatus s = dir->Fsync(options, dbg);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return IOStatus::OK();
+  }
+
+  IOStatus FsyncWithDirOptions(
+      const IOOptions& options, IODebugContext* dbg,
+      const DirFsyncOptions& dir_fsync_options) override {
+    for (auto& dir : dirs_) {
+      IOStatus s = dir->FsyncWithDirOptions(options, dbg, dir_fsync_options);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return IOStatus::OK();
+  }
+
+  IOStatus Close(const IOOptions& options, IODebugContext* dbg) override {
+    IOStatus s;
+    for (auto& dir : dirs_) {
+      IOStatus close_s = dir->Close(options, dbg);
+      if (s.ok()) {
+        s = close_s;
+      } else {
+        close_s.PermitUncheckedError();
+      }
+    }
+    return s;
+  }
+
+  size_t GetUniqueId(char* id, size_t max_size) const override {
+    return dirs_[0]->GetUniqueId(id, max_size);
+  }
+
+ private:
+  std::vector<std::unique_ptr<FSDirectory>> dirs_;
+};
+
+class TieredFileSystem : public RemapFileSystem {
+ public:
+  TieredFileSystem(const std::shared_ptr<FileSystem>& base,
+                   const TieredFileSystemOptions& options)
+      : RemapFileSystem(base), options_(options) {
+    options_.temperature_dirs.erase(kBaseLocation);
+  }
+
+  static const char* kClassName() { return "TieredFileSystem"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewWritableFile(const std::string& fname, const FileOptions& options,
+                           std::unique_ptr<FSWritableFile>* result,
+                           IODebugContext* dbg) override {
+    const Temperature location = LocationOf(options.temperature);
+    IOStatus s = PrepareNewFile(fname, location, options.io_options, dbg);
+    if (s.ok()) {
+      s = target()->NewWritableFile(Path(location, fname), options, result,
+                                    dbg);
+    }
+    if (s.ok()) {
+      SetLocation(fname, location);
+    }
+    return s;
+  }
+
+  IOStatus ReuseWritableFile(const std::string& fname,
+                             const std::string& old_fname,
+                             const FileOptions& options,
+                             std::unique_ptr<FSWritableFile>* result,
+                             IODebugContext* dbg) override {
+    const Temperature location = FindLocation(old_fname);
+    IOStatus s = PrepareNewFile(fname, location, options.io_options, dbg);
+    if (s.ok()) {
+      s = target()->ReuseWritableFile(Path(location, fname),
+                                      Path(location, old_fname), options,
+                                      result, dbg);
+    }
+    if (s.ok()) {
+      SetLocation(old_fname, kBaseLocation);
+      SetLocation(fname, location);
+    }
+    return s;
+  }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& options,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    if (options_.migrate_on_open && options.temperature != kBaseLocation) {
+      // The file stays readable where it is if it cannot be moved
+      MaybeMigrate(fname, LocationOf(options.temperature), options.io_options,
+                   dbg)
+          .PermitUncheckedError();
+    }
+    return RemapFileSystem::NewRandomAccessFile(fname, options, result, dbg);
+  }
+
+  IOStatus NewDirectory(const std::string& dir, const IOOptions& options,
+                        std::unique_ptr<FSDirectory>* result,
+                        IODebugContext* dbg) override {
+    std::vector<std::unique_ptr<FSDirectory>> dirs(1);
+    IOStatus s = target()->NewDirectory(dir, options, &dirs[0], dbg);
+    for (const auto& tier : options_.temperature_dirs) {
+      if (!s.ok()) {
+        break;
+      }
+      // Created up front so that files created in the directory later on
+      // are covered when syncing it
+      s = CreateMirrorDirs(tier.first, dir, options, dbg);
+      if (s.ok()) {
+        dirs.emplace_back();
+        s = target()->NewDirectory(Path(tier.first, dir), options,
+                                   &dirs.back(), dbg);
+      }
+    }
+    if (s.ok()) {
+      result->reset(new TieredDirectory(std::move(dirs)));
+    }
+    return s;
+  }
+
+  IOStatus GetChildren(const std::string& dir, const IOOptions& options,
+                       std::vector<std::string>* result,
+                       IODebugContext* dbg) override {
+    IOStatus s = RemapFileSystem::GetChildren(dir, options, result, dbg);
+    if (!s.ok()) {
+      return s;
+    }
+    std::unordered_set<std::string> names(result->begin(), result->end());
+    MutexLock l(&mutex_);
+    for (const auto& file : GetDirFiles(dir, options, dbg)) {
+      if (names.insert(file.first).second) {
+        result->push_back(file.first);
+      }
+    }
+    return s;
+  }
+
+  IOStatus GetChildrenFileAttributes(const std::string& dir,
+                                     const IOOptions& options,
+                                     std::vector<FileAttributes>* result,
+                                     IODebugContext* dbg) override {
+    IOStatus s =
+        RemapFileSystem::GetChildrenFileAttributes(dir, options, result, dbg);
+    if (!s.ok()) {
+      return s;
+    }
+    std::unordered_set<std::string> names;
+    for (const auto& attributes : *result) {
+      names.insert(attributes.name);
+    }
+    std::unordered_map<std::string, Temperature> files;
+    {
+      MutexLock l(&mutex_);
+      files = GetDirFiles(dir, options, dbg);
+    }
+    for (const auto& file : files) {
+      if (!names.insert(file.first).second) {
+        continue;
+      }
+      FileAttributes attributes;
+      attributes.name = file.first;
+      s = target()->GetFileSize(Path(file.second, dir + "/" + file.first),
+                                options, &attributes.size_bytes, dbg);
+      if (s.IsNotFound()) {
+        // Deleted in the meantime
+        s = IOStatus::OK();
+        continue;
+      } else if (!s.ok()) {
+        return s;
+      }
+      result->push_back(attributes);
+    }
+    return s;
+  }
+
+  IOStatus DeleteFile(const std::string& fname, const IOOptions& options,
+                      IODebugContext* dbg) override {
+    IOStatus s = RemapFileSystem::DeleteFile(fname, options, dbg);
+    if (s.ok()) {
+      SetLocation(fname, kBaseLocation);
+    }
+    return s;
+  }
+
+  IOStatus DeleteDir(const std::string& dirname, const IOOptions& options,
+                     IODebugContext* dbg) override {
+    IOStatus s = RemapFileSystem::DeleteDir(dirname, options, dbg);
+    if (s.ok()) {
+      MutexLock l(&mutex_);
+      for (const auto& tier : options_.temperature_dirs) {
+        // Only the directories that the DB may have written to
+        target()
+            ->DeleteDir(Path(tier.first, dirname), options, dbg)
+            .PermitUncheckedError();
+        mirrored_dirs_.erase(Path(tier.first, dirname));
+      }
+      dirs_.erase(dirname);
+    }
+    return s;
+  }
+
+  IOStatus RenameFile(const std::string& src, const std::string& dest,
+                      const IOOptions& options, IODebugContext* dbg) override {
+    // Renaming across devices is not supported, so the file keeps its place
+    const Temperature location = FindLocation(src);
+    IOStatus s = PrepareNewFile(dest, location, options, dbg);
+    if (s.ok()) {
+      s = target()->RenameFile(Path(location, src), Path(location, dest),
+                               options, dbg);
+    }
+    if (s.ok()) {
+      SetLocation(src, kBaseLocation);
+      SetLocation(dest, location);
+    }
+    return s;
+  }
+
+  IOStatus LinkFile(const std::string& src, const std::string& dest,
+                    const IOOptions& options, IODebugContext* dbg) override {
+    const Temperature location = FindLocation(src);
+    IOStatus s = PrepareNewFile(dest, location, options, dbg);
+    if (s.ok()) {
+      s = target()->LinkFile(Path(location, src), Path(location, dest), options,
+                             dbg);
+    }
+    if (s.ok()) {
+      SetLocation(dest, location);
+    }
+    return s;
+  }
+
+  IOStatus NumFileLinks(const std::string& fname, const IOOptions& options,
+                        uint64_t* count, IODebugContext* dbg) override {
+    return target()->NumFileLinks(Path(FindLocation(fname), fname), options,
+                                  count, dbg);
+  }
+
+  IOStatus AreFilesSame(const std::string& first, const std::string& second,
+                        const IOOptions& options, bool* res,
+                        IODebugContext* dbg) override {
+    return target()->AreFilesSame(Path(FindLocation(first), first),
+                                  Path(FindLocation(second), second), options,
+                                  res, dbg);
+  }
+
+  IOStatus Truncate(const std::string& fname, size_t size,
+                    const IOOptions& options, IODebugContext* dbg) override {
+    return target()->Truncate(Path(FindLocation(fname), fname), size, options,
+                              dbg);
+  }
+
+ protected:
+  std::pair<IOStatus, std::string> EncodePath(
+      const std::string& path) override {
+    return {IOStatus::OK(), Path(FindLocation(path), path)};
+  }
+
+ private:
+  // Suffix of the file that a file is copied to while it is moved
+  static constexpr const char* kMigrationSuffix = ".migrating";
+  static constexpr uint64_t kCopyBufferSize = 1 << 20;
+
+  // Returns the location of the files of `temperature`
+  Temperature LocationOf(Temperature temperature) const {
+    return options_.temperature_dirs.count(temperature) > 0 ? temperature
+                                                            : kBaseLocation;
+  }
+
+  // Returns the path of `path` in the base FileSystem for `location`
+  std::string Path(Temperature location, const std::string& path) const {
+    if (location == kBaseLocation) {
+      return path;
+    }
+    const std::string& dir = options_.temperature_dirs.at(location);
+    return !path.empty() && path[0] == '/' ? dir + path : dir + "/" + path;
+  }
+
+  // Returns the files of `dir` that are in a temperature directory, looking
+  // them up the first time.
+  // REQUIRES: mutex_ held
+  std::unordered_map<std::string, Temperature>& GetDirFiles(
+      const std::string& path, const IOOptions& options, IODebugContext* dbg) {
+    std::string dir = path;
+    while (dir.size() > 1 && dir.back() == '/') {
+      dir.pop_back();
+    }
+    auto it = dirs_.find(dir);
+    if (it != dirs_.end()) {
+      return it->second;
+    }
+    std::unordered_map<std::string, Temperature>& files = dirs_[dir];
+    for (const auto& tier : options_.temperature_dirs) {
+      const std::string mirror_dir = Path(tier.first, dir);
+      std::vector<std::string> children;
+      if (!target()->GetChildren(mirror_dir, options, &children, dbg).ok()) {
+        continue;
+      }
+      for (const auto& child : children) {
+        bool is_dir = false;
+        if (child == "." || child == ".." ||
+            !target()
+                 ->IsDirectory(mirror_dir + "/" + child, options, &is_dir, dbg)
+                 .ok() ||
+            is_dir) {
+          continue;
+        }
+        files.emplace(child, tier.first);
+      }
+    }
+    return files;
+  }
+
+  Temperature FindLocation(const std::string& fname) {
+    MutexLock l(&mutex_);
+    const auto& files = GetDirFiles(ParentDir(fname), IOOptions(), nullptr);
+    auto it = files.find(BaseName(fname));
+    return it == files.end() ? kBaseLocation : it->second;
+  }
+
+  void SetLocation(const std::string& fname, Temperature location) {
+    MutexLock l(&mutex_);
+    auto& files = GetDirFiles(ParentDir(fname), IOOptions(), nullptr);
+    if (location == kBaseLocation) {
+      files.erase(BaseName(fname));
+    } else {
+      files[BaseName(fname)] = location;
+    }
+  }
+
+  // Creates the copy of `dir` in the temperature directory of `location`,
+  // along with its parents
+  IOStatus CreateMirrorDirs(Temperature location, const std::string& dir,
+                            const IOOptions& options, IODebugContext* dbg) {
+    if (location == kBaseLocation) {
+      return IOStatus::OK();
+    }
+    {
+      MutexLock l(&mutex_);
+      if (mirrored_dirs_.count(Path(location, dir)) > 0) {
+        return IOStatus::OK();
+      }
+    }
+    std::string path = options_.temperature_dirs.at(location);
+    size_t start = 0;
+    while (start < dir.size()) {
+      size_t end = dir.find('/', start);
+      if (end == std::string::npos) {
+        end = dir.size();
+      }
+      if (end > start) {
+        const std::string parent = path;
+        path += "/" + dir.substr(start, end - start);
+        IOStatus s = target()->FileExists(path, options, dbg);
+        if (s.IsNotFound()) {
+          s = target()->CreateDirIfMissing(path, options, dbg);
+          // Persist the new directory along with the files to be placed in it
+          std::unique_ptr<FSDirectory> parent_dir;
+          if (s.ok()) {
+            s = target()->NewDirectory(parent, options, &parent_dir, dbg);
+          }
+          if (s.ok()) {
+            s = parent_dir->Fsync(options, dbg);
+          }
+        }
+        if (!s.ok()) {
+          return s;
+        }
+      }
+      start = end + 1;
+    }
+    MutexLock l(&mutex_);
+    mirrored_dirs_.insert(Path(location, dir));
+    return IOStatus::OK();
+  }
+
+  // Gets ready to place `fname` at `location`, removing the file of the same
+  // name at another location
+  IOStatus PrepareNewFile(const std::string& fname, Temperature location,
+                          const IOOptions& options, IODebugContext* dbg) {
+    IOStatus s = CreateMirrorDirs(location, ParentDir(fname), options, dbg);
+    if (!s.ok()) {
+      return s;
+    }
+    const Temperature old_location = FindLocation(fname);
+    if (old_location != location) {
+      s = target()->DeleteFile(Path(old_location, fname), options, dbg);
+      if (s.IsNotFound()) {
+        s = IOStatus::OK();
+      }
+    }
+    return s;
+  }
+
+  // Moves `fname` to `location` if it is elsewhere
+  IOStatus MaybeMigrate(const std::string& fname, Temperature location,
+                        const IOOptions& options, IODebugContext* dbg) {
+    if (FindLocation(fname) == location) {
+      return IOStatus::OK();
+    }
+    MutexLock l(&migrate_mutex_);
+    const Temperature old_location = FindLocation(fname);
+    if (old_location == location) {
+      return IOStatus::OK();
+    }
+    const std::string src = Path(old_location, fname);
+    const std::string dest = Path(location, fname);
+    const std::string tmp = dest + kMigrationSuffix;
+    uint64_t size = 0;
+    IOStatus s = target()->GetFileSize(src, options, &size, dbg);
+    if (s.ok()) {
+      s = CreateMirrorDirs(location, ParentDir(fname), options, dbg);
+    }
+    if (s.ok()) {
+      s = CopyFile(target(), src, Temperature::kUnknown, tmp,
+                   Temperature::kUnknown, size, true /* use_fsync */,
+                   nullptr /* io_tracer */, kCopyBufferSize);
+    }
+    if (s.ok()) {
+      s = target()->RenameFile(tmp, dest, options, dbg);
+    }
+    std::unique_ptr<FSDirectory> dest_dir;
+    if (s.ok()) {
+      s = target()->NewDirectory(ParentDir(dest), options, &dest_dir, dbg);
+    }
+    if (s.ok()) {
+      s = dest_dir->Fsync(options, dbg);
+    }
+    if (!s.ok()) {
+      target()->DeleteFile(tmp, options, dbg).PermitUncheckedError();
+      return s;
+    }
+    SetLocation(fname, location);
+    return target()->DeleteFile(src, options, dbg);
+  }
+
+  TieredFileSystemOptions options_;
+  port::Mutex mutex_;
+  // The files in temperature directories, by directory then name, for the
+  // directories looked up so far
+  std::unordered_map<std::string, std::unordered_map<std::string, Temperature>>
+      dirs_;
+  // Copies of directories known to exist in temperature directories
+  std::unordered_set<std::string> mirrored_dirs_;
+  // Held while moving a file
+  port::Mutex migrate_mutex_;
+};
+}  // namespace
+
+std::shared_ptr<FileSystem> NewTieredFileSystem(
+    const std::shared_ptr<FileSystem>& base,
+    const TieredFileSystemOptions& options) {
+  return std::make_shared<TieredFileSystem>(base, options);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,232 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/tiered_file_system.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "file/file_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/db.h"
+#include "rocksdb/env.h"
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TieredFileSystemTest : public testing::Test {
+ public:
+  TieredFileSystemTest() {
+    dir_ = test::PerThreadDBPath("tiered_file_system_test");
+    cold_dir_ = dir_ + "_cold";
+    warm_dir_ = dir_ + "_warm";
+    for (const auto& dir : {dir_, cold_dir_, warm_dir_}) {
+      EXPECT_OK(DestroyDir(Env::Default(), dir));
+      EXPECT_OK(Env::Default()->CreateDir(dir));
+    }
+    options_.temperature_dirs[Temperature::kCold] = cold_dir_;
+    options_.temperature_dirs[Temperature::kWarm] = warm_dir_;
+  }
+
+  ~TieredFileSystemTest() override {
+    for (const auto& dir : {dir_, cold_dir_, warm_dir_}) {
+      EXPECT_OK(DestroyDir(Env::Default(), dir));
+    }
+  }
+
+ protected:
+  std::shared_ptr<FileSystem> NewFileSystem() {
+    return NewTieredFileSystem(FileSystem::Default(), options_);
+  }
+
+  static IOStatus WriteFile(FileSystem* fs, const std::string& fname,
+                            Temperature temperature, const std::string& data) {
+    FileOptions file_options;
+    file_options.temperature = temperature;
+    return WriteStringToFile(fs, data, fname, false /* should_sync */,
+                             IOOptions(), file_options);
+  }
+
+  static bool Exists(const std::string& path) {
+    return Env::Default()->FileExists(path).ok();
+  }
+
+  std::vector<std::string> GetChildren(FileSystem* fs) {
+    std::vector<std::string> children;
+    EXPECT_OK(fs->GetChildren(dir_, IOOptions(), &children, nullptr));
+    children.erase(std::remove_if(children.begin(), children.end(),
+                                  [](const std::string& child) {
+                                    return child == "." || child == "..";
+                                  }),
+                   children.end());
+    std::sort(children.begin(), children.end());
+    return children;
+  }
+
+  std::string dir_;
+  std::string cold_dir_;
+  std::string warm_dir_;
+  TieredFileSystemOptions options_;
+};
+
+TEST_F(TieredFileSystemTest, PlaceFilesByTemperature) {
+  auto fs = NewFileSystem();
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/cold", Temperature::kCold, "c"));
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/hot", Temperature::kHot, "h"));
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/plain", Temperature::kUnknown, "p"));
+
+  // Only the temperatures with a directory are placed elsewhere
+  ASSERT_TRUE(Exists(cold_dir_ + dir_ + "/cold"));
+  ASSERT_FALSE(Exists(dir_ + "/cold"));
+  ASSERT_TRUE(Exists(dir_ + "/hot"));
+  ASSERT_TRUE(Exists(dir_ + "/plain"));
+
+  std::string data;
+  ASSERT_OK(ReadFileToString(fs.get(), dir_ + "/cold", &data));
+  ASSERT_EQ("c", data);
+  uint64_t size = 0;
+  ASSERT_OK(fs->GetFileSize(dir_ + "/cold", IOOptions(), &size, nullptr));
+  ASSERT_EQ(1u, size);
+  ASSERT_EQ((std::vector<std::string>{"cold", "hot", "plain"}),
+            GetChildren(fs.get()));
+
+  std::vector<FileAttributes> attributes;
+  ASSERT_OK(fs->GetChildrenFileAttributes(dir_, IOOptions(), &attributes,
+                                          nullptr));
+  bool found = false;
+  for (const auto& file : attributes) {
+    if (file.name == "cold") {
+      found = true;
+      ASSERT_EQ(1u, file.size_bytes);
+    }
+  }
+  ASSERT_TRUE(found);
+
+  // Rewriting a file with another temperature moves it
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/plain", Temperature::kCold, "pp"));
+  ASSERT_TRUE(Exists(cold_dir_ + dir_ + "/plain"));
+  ASSERT_FALSE(Exists(dir_ + "/plain"));
+
+  ASSERT_OK(fs->DeleteFile(dir_ + "/cold", IOOptions(), nullptr));
+  ASSERT_FALSE(Exists(cold_dir_ + dir_ + "/cold"));
+  ASSERT_TRUE(fs->FileExists(dir_ + "/cold", IOOptions(), nullptr)
+                  .IsNotFound());
+  ASSERT_EQ((std::vector<std::string>{"hot", "plain"}), GetChildren(fs.get()));
+}
+
+TEST_F(TieredFileSystemTest, KeepPlaceThroughRenameAndLink) {
+  auto fs = NewFileSystem();
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/a", Temperature::kCold, "a"));
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/b", Temperature::kUnknown, "b"));
+
+  // Replaces "b" from the other device
+  ASSERT_OK(fs->RenameFile(dir_ + "/a", dir_ + "/b", IOOptions(), nullptr));
+  ASSERT_TRUE(Exists(cold_dir_ + dir_ + "/b"));
+  ASSERT_FALSE(Exists(cold_dir_ + dir_ + "/a"));
+  ASSERT_FALSE(Exists(dir_ + "/b"));
+  std::string data;
+  ASSERT_OK(ReadFileToString(fs.get(), dir_ + "/b", &data));
+  ASSERT_EQ("a", data);
+
+  ASSERT_OK(fs->LinkFile(dir_ + "/b", dir_ + "/c", IOOptions(), nullptr));
+  ASSERT_TRUE(Exists(cold_dir_ + dir_ + "/c"));
+  uint64_t links = 0;
+  ASSERT_OK(fs->NumFileLinks(dir_ + "/c", IOOptions(), &links, nullptr));
+  ASSERT_EQ(2u, links);
+  ASSERT_EQ((std::vector<std::string>{"b", "c"}), GetChildren(fs.get()));
+}
+
+TEST_F(TieredFileSystemTest, FindFilesAfterReopen) {
+  {
+    auto fs = NewFileSystem();
+    ASSERT_OK(WriteFile(fs.get(), dir_ + "/cold", Temperature::kCold, "c"));
+    ASSERT_OK(WriteFile(fs.get(), dir_ + "/warm", Temperature::kWarm, "w"));
+  }
+  auto fs = NewFileSystem();
+  ASSERT_OK(fs->FileExists(dir_ + "/cold", IOOptions(), nullptr));
+  std::string data;
+  ASSERT_OK(ReadFileToString(fs.get(), dir_ + "/warm", &data));
+  ASSERT_EQ("w", data);
+  ASSERT_EQ((std::vector<std::string>{"cold", "warm"}), GetChildren(fs.get()));
+}
+
+TEST_F(TieredFileSystemTest, MigrateOnOpen) {
+  auto fs = NewFileSystem();
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/f", Temperature::kUnknown, "data"));
+  ASSERT_OK(WriteFile(fs.get(), dir_ + "/g", Temperature::kWarm, "data"));
+
+  FileOptions file_options;
+  file_options.temperature = Temperature::kCold;
+  std::unique_ptr<FSRandomAccessFile> file;
+  ASSERT_OK(fs->NewRandomAccessFile(dir_ + "/f", file_options, &file, nullptr));
+  ASSERT_TRUE(Exists(cold_dir_ + dir_ + "/f"));
+  ASSERT_FALSE(Exists(dir_ + "/f"));
+  char scratch[10];
+  Slice result;
+  ASSERT_OK(file->Read(0, 4, IOOptions(), &result, scratch, nullptr));
+  ASSERT_EQ("data", result.ToString());
+  file.reset();
+
+  // Back under the DB directory, as kHot has no directory of its own
+  file_options.temperature = Temperature::kHot;
+  ASSERT_OK(fs->NewRandomAccessFile(dir_ + "/g", file_options, &file, nullptr));
+  ASSERT_TRUE(Exists(dir_ + "/g"));
+  ASSERT_FALSE(Exists(warm_dir_ + dir_ + "/g"));
+  file.reset();
+
+  // Not moved without a temperature to go by, or when disabled
+  ASSERT_OK(
+      fs->NewRandomAccessFile(dir_ + "/f", FileOptions(), &file, nullptr));
+  ASSERT_TRUE(Exists(cold_dir_ + dir_ + "/f"));
+  file.reset();
+  options_.migrate_on_open = false;
+  fs = NewFileSystem();
+  file_options.temperature = Temperature::kWarm;
+  ASSERT_OK(fs->NewRandomAccessFile(dir_ + "/f", file_options, &file, nullptr));
+  ASSERT_TRUE(Exists(cold_dir_ + dir_ + "/f"));
+  ASSERT_EQ((std::vector<std::string>{"f", "g"}), GetChildren(fs.get()));
+}
+
+TEST_F(TieredFileSystemTest, DBFiles) {
+  std::unique_ptr<Env> env = NewCompositeEnv(NewFileSystem());
+  Options options;
+  options.env = env.get();
+  options.create_if_missing = true;
+  options.default_write_temperature = Temperature::kCold;
+  std::unique_ptr<DB> db;
+  ASSERT_OK(DB::Open(options, dir_, &db));
+  ASSERT_OK(db->Put(WriteOptions(), "key", "value"));
+  ASSERT_OK(db->Flush(FlushOptions()));
+
+  std::vector<std::string> cold_files;
+  ASSERT_OK(Env::Default()->GetChildren(cold_dir_ + dir_, &cold_files));
+  int num_sst_files = 0;
+  for (const auto& f : cold_files) {
+    if (f.size() > 4 && f.substr(f.size() - 4) == ".sst") {
+      num_sst_files++;
+      ASSERT_FALSE(Exists(dir_ + "/" + f));
+    }
+  }
+  ASSERT_EQ(1, num_sst_files);
+
+  db.reset();
+  env = NewCompositeEnv(NewFileSystem());
+  options.env = env.get();
+  ASSERT_OK(DB::Open(options, dir_, &db));
+  std::string value;
+  ASSERT_OK(db->Get(ReadOptions(), "key", &value));
+  ASSERT_EQ("value", value);
+  db.reset();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -11,6 +11,8 @@
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/system_clock.h"
+#include "rocksdb/write_batch.h"
+#include "util/hash.h"
 #include "util/threadpool_imp.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -76,6 +78,77 @@ Status ReplayerImpl::Execute(const std::unique_ptr<TraceRecord>& record,
   return record->Accept(exec_handler_.get(), result);
 }
 
+namespace {
+// Captures the first key of a WriteBatch
+class FirstKeyHandler : public WriteBatch::Handler {
+ public:
+  Status PutCF(uint32_t, const Slice& key, const Slice&) override {
+    return Found(key);
+  }
+  Status PutEntityCF(uint32_t, const Slice& key, const Slice&) override {
+    return Found(key);
+  }
+  Status TimedPutCF(uint32_t, const Slice& key, const Slice&,
+                    uint64_t) override {
+    return Found(key);
+  }
+  Status DeleteCF(uint32_t, const Slice& key) override { return Found(key); }
+  Status SingleDeleteCF(uint32_t, const Slice& key) override {
+    return Found(key);
+  }
+  Status DeleteRangeCF(uint32_t, const Slice& begin_key,
+                       const Slice&) override {
+    return Found(begin_key);
+  }
+  Status MergeCF(uint32_t, const Slice& key, const Slice&) override {
+    return Found(key);
+  }
+  Status PutBlobIndexCF(uint32_t, const Slice& key, const Slice&) override {
+    return Found(key);
+  }
+  bool Continue() override { return key_.empty(); }
+
+  const std::string& key() const { return key_; }
+
+ private:
+  Status Found(const Slice& key) {
+    key_ = key.ToString();
+    return Status::OK();
+  }
+
+  std::string key_;
+};
+
+// The hash of the key that the replay of `record` must be ordered by
+uint64_t GetRecordKeyHash(const TraceRecord& record) {
+  switch (record.GetTraceType()) {
+    case kTraceWrite: {
+      WriteBatch batch(
+          static_cast<const WriteQueryTraceRecord&>(record)
+              .GetWriteBatchRep()
+              .ToString());
+      FirstKeyHandler handler;
+      batch.Iterate(&handler).PermitUncheckedError();
+      return GetSliceNPHash64(handler.key());
+    }
+    case kTraceGet:
+      return GetSliceNPHash64(
+          static_cast<const GetQueryTraceRecord&>(record).GetKey());
+    case kTraceIteratorSeek:
+    case kTraceIteratorSeekForPrev:
+      return GetSliceNPHash64(
+          static_cast<const IteratorSeekQueryTraceRecord&>(record).GetKey());
+    case kTraceMultiGet: {
+      std::vector<Slice> keys =
+          static_cast<const MultiGetQueryTraceRecord&>(record).GetKeys();
+      return keys.empty() ? 0 : GetSliceNPHash64(keys[0]);
+    }
+    default:
+      return 0;
+  }
+}
+}  // namespace
+
 Status ReplayerImpl::Replay(
     const ReplayOptions& options,
     const std::function<void(Status, std::unique_ptr<TraceRecordResult>&&)>&
@@ -146,10 +219,17 @@ Status ReplayerImpl::Replay(
       }
     }
   } else {
-    // Multi-threaded replay.
-    ThreadPoolImpl thread_pool;
-    thread_pool.SetHostEnv(env_);
-    thread_pool.SetBackgroundThreads(static_cast<int>(options.num_threads));
+    // Multi-threaded replay. With preserve_key_order, each thread has its own
+    // pool so that the records dispatched to it by key run in order.
+    std::vector<std::unique_ptr<ThreadPoolImpl>> thread_pools(
+        options.preserve_key_order ? options.num_threads : 1);
+    for (auto& thread_pool : thread_pools) {
+      thread_pool.reset(new ThreadPoolImpl());
+      thread_pool->SetHostEnv(env_);
+      thread_pool->SetBackgroundThreads(
+          options.preserve_key_order ? 1
+                                     : static_cast<int>(options.num_threads));
+    }
 
     std::mutex mtx;
     // Background decoding and execution status.
@@ -219,8 +299,17 @@ Status ReplayerImpl::Replay(
         ra->trace_file_version = trace_file_version_;
         ra->error_cb = error_cb;
         ra->result_cb = result_callback;
-        thread_pool.Schedule(&ReplayerImpl::BackgroundWork, ra.release(),
-                             nullptr, nullptr);
+        size_t pool_idx = 0;
+        if (thread_pools.size() > 1 &&
+            TracerHelper::DecodeTraceRecord(&ra->trace_entry,
+                                            trace_file_version_, &ra->record)
+                .ok()) {
+          // Otherwise BackgroundWork() reports the decoding error
+          pool_idx = static_cast<size_t>(GetRecordKeyHash(*ra->record) %
+                                         thread_pools.size());
+        }
+        thread_pools[pool_idx]->Schedule(&ReplayerImpl::BackgroundWork,
+                                         ra.release(), nullptr, nullptr);
       } else {
         // Skip unsupported traces.
         if (result_callback != nullptr) {
@@ -230,7 +319,9 @@ Status ReplayerImpl::Replay(
       }
     }
 
-    thread_pool.WaitForJobsAndJoinAllThreads();
+    for (auto& thread_pool : thread_pools) {
+      thread_pool->WaitForJobsAndJoinAllThreads();
+    }
     if (!bg_s.ok()) {
       s = bg_s;
     }
@@ -284,9 +375,12 @@ void ReplayerImpl::BackgroundWork(void* arg) {
   std::unique_ptr<ReplayerWorkerArg> ra(static_cast<ReplayerWorkerArg*>(arg));
   assert(ra != nullptr);
 
-  std::unique_ptr<TraceRecord> record;
-  Status s = TracerHelper::DecodeTraceRecord(&(ra->trace_entry),
-                                             ra->trace_file_version, &record);
+  std::unique_ptr<TraceRecord> record = std::move(ra->record);
+  Status s;
+  if (record == nullptr) {
+    s = TracerHelper::DecodeTraceRecord(&(ra->trace_entry),
+                                        ra->trace_file_version, &record);
+  }
   if (!s.ok()) {
     // Stop the replay
     if (ra->error_cb != nullptr) {
@@ -70,6 +70,8 @@ class ReplayerImpl : public Replayer {
 // Arguments passed to BackgroundWork() for replaying in a thread pool.
 struct ReplayerWorkerArg {
   Trace trace_entry;
+  // The record decoded from trace_entry, if already decoded
+  std::unique_ptr<TraceRecord> record;
   int trace_file_version;
   // Handler to execute TraceRecord.
   TraceRecord::Handler* handler;
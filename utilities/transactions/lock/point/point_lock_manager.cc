@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <deque>
 #include <mutex>
 
 #include "monitoring/perf_context_imp.h"
@@ -43,6 +44,14 @@ struct LockInfo {
   DECLARE_DEFAULT_MOVES(LockInfo);
 };
 
+// A transaction waiting for the lock on a key held by other transactions
+struct KeyLockWaiter {
+  TransactionID txn_id;
+  bool exclusive;
+  // Signaled when the waiter may be able to acquire the lock
+  std::shared_ptr<TransactionDBCondVar> cv;
+};
+
 struct LockMapStripe {
   explicit LockMapStripe(std::shared_ptr<TransactionDBMutexFactory> factory) {
     stripe_mutex = factory->AllocateMutex();
@@ -60,6 +69,50 @@ struct LockMapStripe {
   // Locked keys mapped to the info about the transactions that locked them.
   // TODO(agiardullo): Explore performance of other data structures.
   UnorderedMap<std::string, LockInfo> keys;
+
+  // Transactions waiting for the locks on keys of `keys`, in order of
+  // arrival, so that releasing a lock only wakes up the first one that can
+  // take it instead of every waiter of the stripe.
+  UnorderedMap<std::string, std::deque<KeyLockWaiter*>> waiters;
+
+  // Number of transactions waiting on stripe_cv for the number of locks to
+  // go below the limit
+  size_t num_lock_limit_waiters = 0;
+
+  // Wakes up the first transaction waiting for the lock on `key`, if it can
+  // acquire it now. Shared waiters wake up each other as they get the lock.
+  void NotifyKeyWaiter(const std::string& key) {
+    if (waiters.empty()) {
+      return;
+    }
+    auto waiters_iter = waiters.find(key);
+    if (waiters_iter == waiters.end()) {
+      return;
+    }
+    const KeyLockWaiter* waiter = waiters_iter->second.front();
+    auto keys_iter = keys.find(key);
+    if (keys_iter != keys.end()) {
+      const LockInfo& lock_info = keys_iter->second;
+      const bool held_by_waiter = lock_info.txn_ids.size() == 1 &&
+                                  lock_info.txn_ids[0] == waiter->txn_id;
+      if (!held_by_waiter && (lock_info.exclusive || waiter->exclusive)) {
+        return;
+      }
+    }
+    waiter->cv->Notify();
+  }
+
+  void RemoveKeyWaiter(const std::string& key, const KeyLockWaiter* waiter) {
+    auto waiters_iter = waiters.find(key);
+    assert(waiters_iter != waiters.end());
+    auto& queue = waiters_iter->second;
+    auto it = std::find(queue.begin(), queue.end(), waiter);
+    assert(it != queue.end());
+    queue.erase(it);
+    if (queue.empty()) {
+      waiters.erase(waiters_iter);
+    }
+  }
 };
 
 // Map of #num_stripes LockMapStripes
@@ -284,6 +337,9 @@ Status PointLockManager::AcquireWithTimeout(
     // as the timeout allows.
     bool timed_out = false;
     bool cv_wait_fail = false;
+    // Queued on the waiters of the key while it is held by others
+    KeyLockWaiter waiter{lock_info.txn_ids[0], lock_info.exclusive, nullptr};
+    bool queued = false;
     do {
       // Decide how long to wait
       int64_t cv_end_time = -1;
@@ -303,17 +359,38 @@ Status PointLockManager::AcquireWithTimeout(
           if (IncrementWaiters(txn, wait_ids, key, column_family_id,
                                lock_info.exclusive, env)) {
             result = Status::Busy(Status::SubCode::kDeadlock);
-            stripe->stripe_mutex->UnLock();
-            return result;
+            break;
           }
         }
         txn->SetWaitingTxn(wait_ids, column_family_id, &key);
       }
 
+      // Wait for the key to be released, or for any lock of the stripe to be
+      // released when over the limit on the number of locks.
+      std::shared_ptr<TransactionDBCondVar> cv;
+      if (wait_ids.size() != 0) {
+        if (!queued) {
+          if (waiter.cv == nullptr) {
+            waiter.cv = mutex_factory_->AllocateCondVar();
+          }
+          stripe->waiters[key].push_back(&waiter);
+          queued = true;
+        }
+        cv = waiter.cv;
+      } else {
+        if (queued) {
+          stripe->RemoveKeyWaiter(key, &waiter);
+          queued = false;
+          stripe->NotifyKeyWaiter(key);
+        }
+        cv = stripe->stripe_cv;
+        stripe->num_lock_limit_waiters++;
+      }
+
       TEST_SYNC_POINT("PointLockManager::AcquireWithTimeout:WaitingTxn");
       if (cv_end_time < 0) {
         // Wait indefinitely
-        result = stripe->stripe_cv->Wait(stripe->stripe_mutex);
+        result = cv->Wait(stripe->stripe_mutex);
         cv_wait_fail = !result.ok();
       } else {
         // FIXME: in this case, cv_end_time could be `expire_time_hint` from the
@@ -325,8 +402,7 @@ Status PointLockManager::AcquireWithTimeout(
           // This may be invoked multiple times since we divide
           // the time into smaller intervals.
           (void)ROCKSDB_THREAD_YIELD_CHECK_ABORT();
-          result = stripe->stripe_cv->WaitFor(stripe->stripe_mutex,
-                                              cv_end_time - now);
+          result = cv->WaitFor(stripe->stripe_mutex, cv_end_time - now);
           cv_wait_fail = !result.ok() && !result.IsTimedOut();
         } else {
           // now >= cv_end_time, we already timed out
@@ -339,6 +415,8 @@ Status PointLockManager::AcquireWithTimeout(
         if (txn->IsDeadlockDetect()) {
           DecrementWaiters(txn, wait_ids);
         }
+      } else {
+        stripe->num_lock_limit_waiters--;
       }
       if (cv_wait_fail) {
         break;
@@ -355,6 +433,13 @@ Status PointLockManager::AcquireWithTimeout(
       result = AcquireLocked(lock_map, stripe, key, env, lock_info,
                              &expire_time_hint, &wait_ids);
     } while (!result.ok() && !timed_out);
+
+    if (queued) {
+      // Let the next waiter have the lock if it can, now that we got it or
+      // gave up on it
+      stripe->RemoveKeyWaiter(key, &waiter);
+      stripe->NotifyKeyWaiter(key);
+    }
   }
 
   stripe->stripe_mutex->UnLock();
@@ -591,6 +676,7 @@ void PointLockManager::UnLockKey(PessimisticTransaction* txn,
         assert(lock_map->lock_cnt.load(std::memory_order_relaxed) > 0);
         lock_map->lock_cnt--;
       }
+      stripe->NotifyKeyWaiter(key);
     }
   } else {
     // This key is either not locked or locked by someone else.  This should
@@ -617,10 +703,14 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
 
   stripe->stripe_mutex->Lock().PermitUncheckedError();
   UnLockKey(txn, key, stripe, lock_map, env);
+  const bool notify_lock_limit_waiters = stripe->num_lock_limit_waiters > 0;
   stripe->stripe_mutex->UnLock();
 
-  // Signal waiting threads to retry locking
-  stripe->stripe_cv->NotifyAll();
+  // Signal the threads waiting for the number of locks to go down to retry
+  // locking. The waiters of the key were signaled by UnLockKey().
+  if (notify_lock_limit_waiters) {
+    stripe->stripe_cv->NotifyAll();
+  }
 }
 
 void PointLockManager::UnLock(PessimisticTransaction* txn,
@@ -662,11 +752,16 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
       for (const std::string* key : stripe_keys) {
         UnLockKey(txn, *key, stripe, lock_map, env);
       }
+      const bool notify_lock_limit_waiters =
+          stripe->num_lock_limit_waiters > 0;
 
       stripe->stripe_mutex->UnLock();
 
-      // Signal waiting threads to retry locking
-      stripe->stripe_cv->NotifyAll();
+      // Signal the threads waiting for the number of locks to go down to
+      // retry locking
+      if (notify_lock_limit_waiters) {
+        stripe->stripe_cv->NotifyAll();
+      }
     }
   }
 }
@@ -97,6 +97,82 @@ TEST_F(PointLockManagerTest, UnlockShared) {
   delete txn2;
 }
 
+TEST_F(PointLockManagerTest, ExclusiveWaitersGetLockInTurn) {
+  // Tests that the transactions waiting for a key are woken up one after
+  // the other as the lock is handed over.
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 10000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+  auto txn3 = NewTxn(txn_opt);
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, true));
+
+  std::atomic<int> num_locked(0);
+  port::Thread t1 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, true));
+    num_locked++;
+    locker_->UnLock(txn2, 1, "k", env_);
+  });
+  port::Thread t2 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn3, 1, "k", env_, true));
+    num_locked++;
+    locker_->UnLock(txn3, 1, "k", env_);
+  });
+
+  ASSERT_EQ(num_locked.load(), 0);
+  // Unlocking another key does not let anyone in
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k2", env_, true));
+  locker_->UnLock(txn1, 1, "k2", env_);
+  ASSERT_EQ(num_locked.load(), 0);
+
+  locker_->UnLock(txn1, 1, "k", env_);
+  t1.join();
+  t2.join();
+  ASSERT_EQ(num_locked.load(), 2);
+  ASSERT_TRUE(locker_->GetPointLockStatus().empty());
+
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
+TEST_F(PointLockManagerTest, SharedWaitersGetLockTogether) {
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 10000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+  auto txn3 = NewTxn(txn_opt);
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, true));
+
+  port::Thread t1 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, false));
+  });
+  port::Thread t2 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn3, 1, "k", env_, false));
+  });
+
+  locker_->UnLock(txn1, 1, "k", env_);
+  t1.join();
+  t2.join();
+
+  auto s = locker_->GetPointLockStatus();
+  ASSERT_EQ(s.size(), 1u);
+  ASSERT_FALSE(s.begin()->second.exclusive);
+  ASSERT_EQ(s.begin()->second.ids.size(), 2u);
+
+  // Cleanup
+  locker_->UnLock(txn2, 1, "k", env_);
+  locker_->UnLock(txn3, 1, "k", env_);
+
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
 // This test doesn't work with Range Lock Manager, because Range Lock Manager
 // doesn't support deadlock_detect_depth.
 
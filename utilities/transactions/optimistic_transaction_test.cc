@@ -136,6 +136,37 @@ TEST_P(OptimisticTransactionTest, WriteConflictTest) {
   delete txn;
 }
 
+TEST_P(OptimisticTransactionTest, WriteConflictManyKeys) {
+  // The keys of a transaction are checked for conflicts in a batch
+  WriteOptions write_options;
+  ReadOptions read_options;
+  std::string value;
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(txn_db->Put(write_options, std::to_string(i), "v"));
+  }
+
+  for (bool conflict : {false, true}) {
+    Transaction* txn = txn_db->BeginTransaction(write_options);
+    ASSERT_NE(txn, nullptr);
+    for (int i = 99; i >= 0; i--) {
+      ASSERT_OK(txn->GetForUpdate(read_options, std::to_string(i), &value));
+    }
+    ASSERT_OK(txn->Put("foo", "bar"));
+    if (conflict) {
+      ASSERT_OK(txn_db->Put(write_options, "42", "v2"));
+    }
+
+    Status s = txn->Commit();
+    if (conflict) {
+      ASSERT_TRUE(s.IsBusy());
+    } else {
+      ASSERT_OK(s);
+    }
+    delete txn;
+  }
+}
+
 TEST_P(OptimisticTransactionTest, WriteConflictTest2) {
   WriteOptions write_options;
   ReadOptions read_options;
@@ -8852,6 +8852,96 @@ TEST_P(TransactionTest, SecondaryIndexOnKey) {
   }
 }
 
+TEST_P(TransactionTest, SecondaryIndexRebuildFromWriteBatch) {
+  const TxnDBWritePolicy write_policy = std::get<2>(GetParam());
+  if (write_policy != TxnDBWritePolicy::WRITE_COMMITTED) {
+    ROCKSDB_GTEST_BYPASS("Test only WriteCommitted for now");
+    return;
+  }
+
+  txn_db_options.secondary_indices.emplace_back(
+      std::make_shared<SimpleSecondaryIndex>(
+          kDefaultWideColumnName.ToString()));
+
+  ASSERT_OK(ReOpen());
+
+  ColumnFamilyOptions cf1_opts;
+  ColumnFamilyHandle* cfh1 = nullptr;
+  ASSERT_OK(db->CreateColumnFamily(cf1_opts, "cf1", &cfh1));
+  std::unique_ptr<ColumnFamilyHandle> cfh1_guard(cfh1);
+
+  ColumnFamilyOptions cf2_opts;
+  ColumnFamilyHandle* cfh2 = nullptr;
+  ASSERT_OK(db->CreateColumnFamily(cf2_opts, "cf2", &cfh2));
+  std::unique_ptr<ColumnFamilyHandle> cfh2_guard(cfh2);
+
+  auto& index = txn_db_options.secondary_indices.back();
+  index->SetPrimaryColumnFamily(cfh1);
+  index->SetSecondaryColumnFamily(cfh2);
+
+  ASSERT_OK(db->Put(WriteOptions(), cfh1, "key2", "bar"));
+  ASSERT_OK(db->Put(WriteOptions(), cfh1, "key3", "baz"));
+
+  {
+    // The batch updates and deletes indexed keys, and writes "key1" twice,
+    // so that its second write has to see the first one
+    WriteBatch batch;
+    ASSERT_OK(batch.Put(db->DefaultColumnFamily(), "key0", "foo"));
+    ASSERT_OK(batch.Put(cfh1, "key1", "foo"));
+    ASSERT_OK(batch.Put(cfh1, "key2", "quux"));
+    ASSERT_OK(batch.Delete(cfh1, "key3"));
+    ASSERT_OK(batch.PutEntity(cfh1, "key4",
+                              {{kDefaultWideColumnName, "abc"}, {"a", "b"}}));
+    ASSERT_OK(batch.Put(cfh1, "key1", "qux"));
+
+    std::unique_ptr<Transaction> txn(db->BeginTransaction(WriteOptions()));
+    ASSERT_OK(txn->RebuildFromWriteBatch(&batch));
+    ASSERT_OK(txn->Commit());
+  }
+
+  {
+    std::string value;
+    ASSERT_OK(db->Get(ReadOptions(), db->DefaultColumnFamily(), "key0",
+                      &value));
+    ASSERT_EQ(value, "foo");
+    ASSERT_OK(db->Get(ReadOptions(), cfh1, "key1", &value));
+    ASSERT_EQ(value, "qux");
+    ASSERT_OK(db->Get(ReadOptions(), cfh1, "key2", &value));
+    ASSERT_EQ(value, "quux");
+    ASSERT_TRUE(db->Get(ReadOptions(), cfh1, "key3", &value).IsNotFound());
+  }
+
+  {
+    // Read the raw secondary index entries from CF2
+    std::unique_ptr<Iterator> it(db->NewIterator(ReadOptions(), cfh2));
+
+    it->SeekToFirst();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(it->key(), "\3abckey4");
+
+    it->Next();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(it->key(), "\3quxkey1");
+
+    it->Next();
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(it->key(), "\4quuxkey2");
+
+    it->Next();
+    ASSERT_FALSE(it->Valid());
+    ASSERT_OK(it->status());
+  }
+
+  {
+    // Merges are rejected like through the transaction
+    WriteBatch batch;
+    ASSERT_OK(batch.Merge(cfh1, "key1", "foo"));
+
+    std::unique_ptr<Transaction> txn(db->BeginTransaction(WriteOptions()));
+    ASSERT_TRUE(txn->RebuildFromWriteBatch(&batch).IsNotSupported());
+  }
+}
+
 TEST_F(TransactionDBTest, CollapseKey) {
   ASSERT_OK(ReOpen());
   ASSERT_OK(db->Put({}, "hello", "world"));
@@ -5,6 +5,7 @@
 
 #include "utilities/transactions/transaction_util.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <string>
 #include <vector>
@@ -61,49 +62,9 @@ Status TransactionUtil::CheckKey(DBImpl* db_impl, SuperVersion* sv,
   // So `snap_checker` must be provided.
   assert(min_uncommitted == kMaxSequenceNumber || snap_checker != nullptr);
 
-  Status result;
   bool need_to_read_sst = false;
-
-  // Since it would be too slow to check the SST files, we will only use
-  // the memtables to check whether there have been any recent writes
-  // to this key after it was accessed in this transaction.  But if the
-  // Memtables do not contain a long enough history, we must fail the
-  // transaction.
-  if (earliest_seq == kMaxSequenceNumber) {
-    // The age of this memtable is unknown.  Cannot rely on it to check
-    // for recent writes.  This error shouldn't happen often in practice as
-    // the Memtable should have a valid earliest sequence number except in some
-    // corner cases (such as error cases during recovery).
-    need_to_read_sst = true;
-
-    if (cache_only) {
-      result = Status::TryAgain(
-          "Transaction could not check for conflicts as the MemTable does not "
-          "contain a long enough history to check write at SequenceNumber: ",
-          std::to_string(snap_seq));
-    }
-  } else if (snap_seq < earliest_seq || min_uncommitted <= earliest_seq) {
-    // Use <= for min_uncommitted since earliest_seq is actually the largest sec
-    // before this memtable was created
-    need_to_read_sst = true;
-
-    if (cache_only) {
-      // The age of this memtable is too new to use to check for recent
-      // writes.
-      char msg[300];
-      snprintf(msg, sizeof(msg),
-               "Transaction could not check for conflicts for operation at "
-               "SequenceNumber %" PRIu64
-               " as the MemTable only contains changes newer than "
-               "SequenceNumber %" PRIu64
-               ".  Increasing the value of the "
-               "max_write_buffer_size_to_maintain option could reduce the "
-               "frequency "
-               "of this error.",
-               snap_seq, earliest_seq);
-      result = Status::TryAgain(msg);
-    }
-  }
+  Status result = CheckMemTableHistory(earliest_seq, snap_seq, min_uncommitted,
+                                       cache_only, &need_to_read_sst);
 
   if (result.ok()) {
     SequenceNumber seq = kMaxSequenceNumber;
@@ -151,6 +112,100 @@ Status TransactionUtil::CheckKey(DBImpl* db_impl, SuperVersion* sv,
   return result;
 }
 
+Status TransactionUtil::CheckMemTableHistory(SequenceNumber earliest_seq,
+                                             SequenceNumber snap_seq,
+                                             SequenceNumber min_uncommitted,
+                                             bool cache_only,
+                                             bool* need_to_read_sst) {
+  Status result;
+
+  // Since it would be too slow to check the SST files, we will only use
+  // the memtables to check whether there have been any recent writes
+  // to this key after it was accessed in this transaction.  But if the
+  // Memtables do not contain a long enough history, we must fail the
+  // transaction.
+  if (earliest_seq == kMaxSequenceNumber) {
+    // The age of this memtable is unknown.  Cannot rely on it to check
+    // for recent writes.  This error shouldn't happen often in practice as
+    // the Memtable should have a valid earliest sequence number except in some
+    // corner cases (such as error cases during recovery).
+    *need_to_read_sst = true;
+
+    if (cache_only) {
+      result = Status::TryAgain(
+          "Transaction could not check for conflicts as the MemTable does not "
+          "contain a long enough history to check write at SequenceNumber: ",
+          std::to_string(snap_seq));
+    }
+  } else if (snap_seq < earliest_seq || min_uncommitted <= earliest_seq) {
+    // Use <= for min_uncommitted since earliest_seq is actually the largest sec
+    // before this memtable was created
+    *need_to_read_sst = true;
+
+    if (cache_only) {
+      // The age of this memtable is too new to use to check for recent
+      // writes.
+      char msg[300];
+      snprintf(msg, sizeof(msg),
+               "Transaction could not check for conflicts for operation at "
+               "SequenceNumber %" PRIu64
+               " as the MemTable only contains changes newer than "
+               "SequenceNumber %" PRIu64
+               ".  Increasing the value of the "
+               "max_write_buffer_size_to_maintain option could reduce the "
+               "frequency "
+               "of this error.",
+               snap_seq, earliest_seq);
+      result = Status::TryAgain(msg);
+    }
+  }
+
+  return result;
+}
+
+Status TransactionUtil::CheckKeys(DBImpl* db_impl, SuperVersion* sv,
+                                  SequenceNumber earliest_seq,
+                                  const LockTracker& tracker,
+                                  ColumnFamilyId cf, bool cache_only) {
+  std::vector<DBImpl::LatestSequenceLookup> lookups;
+  std::unique_ptr<LockTracker::KeyIterator> key_it(tracker.GetKeyIterator(cf));
+  assert(key_it != nullptr);
+  while (key_it->HasNext()) {
+    const std::string& key = key_it->Next();
+    const SequenceNumber key_seq = tracker.GetPointLockStatus(cf, key).seq;
+
+    bool need_to_read_sst = false;
+    Status result = CheckMemTableHistory(earliest_seq, key_seq,
+                                         kMaxSequenceNumber, cache_only,
+                                         &need_to_read_sst);
+    if (!result.ok()) {
+      return result;
+    }
+    // Writes are committed in sequence number order, so only the ones after
+    // `key_seq` can conflict
+    lookups.emplace_back(key, !need_to_read_sst, key_seq);
+  }
+
+  const Comparator* const ucmp = sv->cfd->user_comparator();
+  std::sort(lookups.begin(), lookups.end(),
+            [ucmp](const DBImpl::LatestSequenceLookup& a,
+                   const DBImpl::LatestSequenceLookup& b) {
+              return ucmp->Compare(a.key, b.key) < 0;
+            });
+  db_impl->GetLatestSequenceForKeys(sv, &lookups);
+
+  for (const auto& lookup : lookups) {
+    if (!(lookup.s.ok() || lookup.s.IsNotFound() ||
+          lookup.s.IsMergeInProgress())) {
+      return lookup.s;
+    }
+    if (lookup.found_record_for_key && lookup.lower_bound_seq < lookup.seq) {
+      return Status::Busy();
+    }
+  }
+  return Status::OK();
+}
+
 Status TransactionUtil::CheckKeysForConflicts(DBImpl* db_impl,
                                               const LockTracker& tracker,
                                               bool cache_only) {
@@ -172,23 +227,27 @@ Status TransactionUtil::CheckKeysForConflicts(DBImpl* db_impl,
     SequenceNumber earliest_seq =
         db_impl->GetEarliestMemTableSequenceNumber(sv, true);
 
-    // For each of the keys in this transaction, check to see if someone has
-    // written to this key since the start of the transaction.
-    std::unique_ptr<LockTracker::KeyIterator> key_it(
-        tracker.GetKeyIterator(cf));
-    assert(key_it != nullptr);
-    while (key_it->HasNext()) {
-      const std::string& key = key_it->Next();
-      PointLockStatus status = tracker.GetPointLockStatus(cf, key);
-      const SequenceNumber key_seq = status.seq;
-
-      // TODO: support timestamp-based conflict checking.
-      // CheckKeysForConflicts() is currently used only by optimistic
-      // transactions.
-      result = CheckKey(db_impl, sv, earliest_seq, key_seq, key,
-                        /*read_ts=*/nullptr, cache_only);
-      if (!result.ok()) {
-        break;
+    if (sv->cfd->user_comparator()->timestamp_size() == 0) {
+      result = CheckKeys(db_impl, sv, earliest_seq, tracker, cf, cache_only);
+    } else {
+      // For each of the keys in this transaction, check to see if someone has
+      // written to this key since the start of the transaction.
+      std::unique_ptr<LockTracker::KeyIterator> key_it(
+          tracker.GetKeyIterator(cf));
+      assert(key_it != nullptr);
+      while (key_it->HasNext()) {
+        const std::string& key = key_it->Next();
+        PointLockStatus status = tracker.GetPointLockStatus(cf, key);
+        const SequenceNumber key_seq = status.seq;
+
+        // TODO: support timestamp-based conflict checking.
+        // CheckKeysForConflicts() is currently used only by optimistic
+        // transactions.
+        result = CheckKey(db_impl, sv, earliest_seq, key_seq, key,
+                          /*read_ts=*/nullptr, cache_only);
+        if (!result.ok()) {
+          break;
+        }
       }
     }
 
@@ -47,7 +47,9 @@ class TransactionUtil {
 
   // For each key,SequenceNumber pair tracked by the LockTracker, this function
   // will verify there have been no writes to the key in the db since that
-  // sequence number.
+  // sequence number. The keys of a column family are checked in a batch, in
+  // the order of the user comparator, and the ones not found in the memtables
+  // are looked up together in the SST files.
   //
   // Returns OK on success, BUSY if there is a conflicting write, or other error
   // status for any unexpected errors.
@@ -79,6 +81,22 @@ class TransactionUtil {
                          bool cache_only, ReadCallback* snap_checker = nullptr,
                          SequenceNumber min_uncommitted = kMaxSequenceNumber,
                          bool enable_udt_validation = true);
+
+  // The batched CheckKey() of CheckKeysForConflicts() for the keys tracked in
+  // column family `cf`, without timestamps
+  static Status CheckKeys(DBImpl* db_impl, SuperVersion* sv,
+                          SequenceNumber earliest_seq,
+                          const LockTracker& tracker, ColumnFamilyId cf,
+                          bool cache_only);
+
+  // Checks whether the memtables, whose history starts after `earliest_seq`,
+  // are enough to find the writes to a key after `snap_seq` or
+  // `min_uncommitted`. Sets `*need_to_read_sst` otherwise, and returns
+  // TryAgain if `cache_only`.
+  static Status CheckMemTableHistory(SequenceNumber earliest_seq,
+                                     SequenceNumber snap_seq,
+                                     SequenceNumber min_uncommitted,
+                                     bool cache_only, bool* need_to_read_sst);
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -1079,6 +1079,56 @@ TEST_P(WritePreparedTransactionTest, OldCommitMapGC) {
   }
 }
 
+// Test that the readers see the updates to old_commit_map_ made after they
+// have cached a copy of it
+TEST_P(WritePreparedTransactionTest, OldCommitMapReadCache) {
+  const size_t snapshot_cache_bits = 0;
+  const size_t commit_cache_bits = 0;
+  DBImpl* mock_db = new DBImpl(options, dbname);
+  UpdateTransactionDBOptions(snapshot_cache_bits, commit_cache_bits);
+  std::unique_ptr<WritePreparedTxnDBMock> wp_db(
+      new WritePreparedTxnDBMock(mock_db, txn_db_options));
+
+  SequenceNumber seq = 0;
+  auto prep_seq0 = ++seq;
+  wp_db->AddPrepared(prep_seq0);
+  wp_db->AddCommitted(prep_seq0, ++seq);
+  wp_db->RemovePrepared(prep_seq0);
+  auto prep_seq1 = ++seq;
+  wp_db->AddPrepared(prep_seq1);
+  auto prep_seq2 = ++seq;
+  wp_db->AddPrepared(prep_seq2);
+  auto snap_seq = seq;
+  wp_db->TakeSnapshot(snap_seq);
+  // Evict the commit entry of prep_seq1 via the commit of prep_seq2
+  wp_db->AddCommitted(prep_seq1, ++seq);
+  wp_db->RemovePrepared(prep_seq1);
+  wp_db->AddCommitted(prep_seq2, ++seq);
+  wp_db->RemovePrepared(prep_seq2);
+  ASSERT_LT(snap_seq, wp_db->max_evicted_seq_.load());
+  ASSERT_TRUE(wp_db->IsInSnapshot(prep_seq0, snap_seq));
+  ASSERT_FALSE(wp_db->IsInSnapshot(prep_seq1, snap_seq));
+  ASSERT_FALSE(wp_db->IsInSnapshot(prep_seq2, snap_seq));
+
+  // Evict the commit entry of prep_seq2, which must be seen by the thread that
+  // has already read the map
+  auto prep_seq3 = ++seq;
+  wp_db->AddPrepared(prep_seq3);
+  wp_db->AddCommitted(prep_seq3, ++seq);
+  wp_db->RemovePrepared(prep_seq3);
+  {
+    ReadLock rl(&wp_db->old_commit_map_mutex_);
+    ASSERT_EQ(2, UniqueCnt(wp_db->old_commit_map_[snap_seq]));
+  }
+  ASSERT_TRUE(wp_db->IsInSnapshot(prep_seq0, snap_seq));
+  ASSERT_FALSE(wp_db->IsInSnapshot(prep_seq1, snap_seq));
+  ASSERT_FALSE(wp_db->IsInSnapshot(prep_seq2, snap_seq));
+
+  // The entries are gone once the snapshot is released
+  wp_db->ReleaseSnapshotInternal(snap_seq);
+  ASSERT_EQ(0, wp_db->GetOldCommitMap()->size());
+}
+
 TEST_P(WritePreparedTransactionTest, CheckAgainstSnapshots) {
   std::vector<SequenceNumber> snapshots = {100l, 200l, 300l, 400l, 500l,
                                            600l, 700l, 800l, 900l};
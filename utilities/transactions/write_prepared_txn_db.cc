@@ -745,6 +745,7 @@ void WritePreparedTxnDB::AdvanceMaxEvictedSeq(const SequenceNumber& prev_max,
         // snapshots from the reads from committed values in valid snapshots.
         old_commit_map_[snap];
       }
+      PublishOldCommitMap();
       old_commit_map_empty_.store(false, std::memory_order_release);
     }
   }
@@ -878,6 +879,7 @@ void WritePreparedTxnDB::ReleaseSnapshotInternal(
                      snap_seq);
       WriteLock wl(&old_commit_map_mutex_);
       old_commit_map_.erase(snap_seq);
+      PublishOldCommitMap();
       old_commit_map_empty_.store(old_commit_map_.empty(),
                                   std::memory_order_release);
     }
@@ -1057,9 +1059,12 @@ bool WritePreparedTxnDB::MaybeUpdateOldCommitMap(
                    " commit entry: <%" PRIu64 ",%" PRIu64 ">",
                    snapshot_seq, prep_seq, commit_seq);
     WriteLock wl(&old_commit_map_mutex_);
-    old_commit_map_empty_.store(false, std::memory_order_release);
     auto& vec = old_commit_map_[snapshot_seq];
     vec.insert(std::upper_bound(vec.begin(), vec.end(), prep_seq), prep_seq);
+    PublishOldCommitMap();
+    // Set after the publish so that the readers that see it non-empty also see
+    // the new entry.
+    old_commit_map_empty_.store(false, std::memory_order_release);
     // We need to store it once for each overlapping snapshot. Returning true to
     // continue the search if there is more overlapping snapshot.
     return true;
@@ -1068,6 +1073,31 @@ bool WritePreparedTxnDB::MaybeUpdateOldCommitMap(
   return next_is_larger;
 }
 
+const WritePreparedTxnDB::OldCommitMap* WritePreparedTxnDB::GetOldCommitMap()
+    const {
+  auto cached = static_cast<CachedOldCommitMap*>(old_commit_map_cache_.Get());
+  if (cached != nullptr &&
+      cached->version ==
+          old_commit_map_version_.load(std::memory_order_acquire)) {
+    return cached->map.get();
+  }
+  if (cached == nullptr) {
+    cached = new CachedOldCommitMap();
+    old_commit_map_cache_.Reset(cached);
+  }
+  WPRecordTick(TXN_OLD_COMMIT_MAP_MUTEX_OVERHEAD);
+  ReadLock rl(&old_commit_map_mutex_);
+  cached->version = old_commit_map_version_.load(std::memory_order_relaxed);
+  cached->map = published_old_commit_map_;
+  return cached->map.get();
+}
+
+void WritePreparedTxnDB::PublishOldCommitMap() {
+  published_old_commit_map_ =
+      std::make_shared<const OldCommitMap>(old_commit_map_);
+  old_commit_map_version_.fetch_add(1, std::memory_order_release);
+}
+
 WritePreparedTxnDB::~WritePreparedTxnDB() {
   // At this point there could be running compaction/flush holding a
   // SnapshotChecker, which holds a pointer back to WritePreparedTxnDB.
@@ -6,6 +6,8 @@
 #pragma once
 
 #include <cinttypes>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <set>
@@ -25,6 +27,7 @@
 #include "util/cast_util.h"
 #include "util/set_comparator.h"
 #include "util/string_util.h"
+#include "util/thread_local.h"
 #include "utilities/transactions/pessimistic_transaction.h"
 #include "utilities/transactions/pessimistic_transaction_db.h"
 #include "utilities/transactions/write_prepared_txn.h"
@@ -297,13 +300,12 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
       return true;
     }
     {
-      // We should not normally reach here unless sapshot_seq is old. This is a
-      // rare case and it is ok to pay the cost of mutex ReadLock for such old,
-      // reading transactions.
-      WPRecordTick(TXN_OLD_COMMIT_MAP_MUTEX_OVERHEAD);
-      ReadLock rl(&old_commit_map_mutex_);
-      auto prep_set_entry = old_commit_map_.find(snapshot_seq);
-      bool found = prep_set_entry != old_commit_map_.end();
+      // We should not normally reach here unless sapshot_seq is old. The map is
+      // read from the copy cached by the thread, which takes the mutex only
+      // when the map has changed since the last read of the thread.
+      const OldCommitMap* old_commit_map = GetOldCommitMap();
+      auto prep_set_entry = old_commit_map->find(snapshot_seq);
+      bool found = prep_set_entry != old_commit_map->end();
       if (found) {
         auto& vec = prep_set_entry->second;
         found = std::binary_search(vec.begin(), vec.end(), prep_seq);
@@ -520,6 +522,7 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
       WritePreparedTransactionTest_NonAtomicUpdateOfDelayedPrepared_Test;
   friend class WritePreparedTransactionTest_NonAtomicUpdateOfMaxEvictedSeq_Test;
   friend class WritePreparedTransactionTest_OldCommitMapGC_Test;
+  friend class WritePreparedTransactionTest_OldCommitMapReadCache_Test;
   friend class WritePreparedTransactionTest_Rollback_Test;
   friend class WritePreparedTransactionTest_SmallestUnCommittedSeq_Test;
   friend class WriteUnpreparedTxn;
@@ -529,6 +532,22 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
 
   void Init(const TransactionDBOptions& txn_db_opts);
 
+  using OldCommitMap = std::map<SequenceNumber, std::vector<SequenceNumber>>;
+
+  // The copy of old_commit_map_ that a thread reads from
+  struct CachedOldCommitMap {
+    uint64_t version = 0;
+    std::shared_ptr<const OldCommitMap> map;
+  };
+
+  // Return the latest copy of old_commit_map_, which stays valid until the
+  // next call by the same thread.
+  const OldCommitMap* GetOldCommitMap() const;
+
+  // Publish a copy of old_commit_map_ to the readers. Must be called with
+  // old_commit_map_mutex_ write locked.
+  void PublishOldCommitMap();
+
   void WPRecordTick(uint32_t ticker_type) const {
     RecordTick(db_impl_->immutable_db_options_.statistics.get(), ticker_type);
   }
@@ -806,7 +825,18 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   // because it is no longer in the commit_cache_. The vector must be sorted
   // after each update.
   // Thread-safety is provided with old_commit_map_mutex_.
-  std::map<SequenceNumber, std::vector<SequenceNumber>> old_commit_map_;
+  OldCommitMap old_commit_map_;
+  // The immutable copy of old_commit_map_ for the readers, and the number of
+  // times it has been published. Both are updated with old_commit_map_mutex_
+  // write locked.
+  std::shared_ptr<const OldCommitMap> published_old_commit_map_ =
+      std::make_shared<const OldCommitMap>();
+  std::atomic<uint64_t> old_commit_map_version_ = {};
+  // The CachedOldCommitMap of each thread, so that the readers of old
+  // snapshots do not contend on old_commit_map_mutex_.
+  mutable ThreadLocalPtr old_commit_map_cache_{[](void* ptr) {
+    delete static_cast<CachedOldCommitMap*>(ptr);
+  }};
   // A set of long-running prepared transactions that are not finished by the
   // time max_evicted_seq_ advances their sequence number. This is expected to
   // be empty normally. Thread-safety is provided with prepared_mutex_.
@@ -5,6 +5,9 @@
 
 #include "utilities/ttl/db_ttl_impl.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "db/write_batch_internal.h"
 #include "file/filename.h"
 #include "logging/logging.h"
@@ -15,6 +18,7 @@
 #include "rocksdb/utilities/db_ttl.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
+#include "test_util/sync_point.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -169,6 +173,75 @@ void DBWithTTLImpl::SanitizeOptions(int32_t ttl, ColumnFamilyOptions* options,
     options->merge_operator.reset(
         new TtlMergeOperator(options->merge_operator, clock));
   }
+
+  bool has_ttl_collector = false;
+  for (const auto& factory : options->table_properties_collector_factories) {
+    if (factory &&
+        std::strcmp(factory->Name(),
+                    TtlPropertiesCollectorFactory::kClassName()) == 0) {
+      has_ttl_collector = true;
+    }
+  }
+  if (!has_ttl_collector) {
+    options->table_properties_collector_factories.emplace_back(
+        std::make_shared<TtlPropertiesCollectorFactory>());
+  }
+}
+
+namespace {
+class TtlPropertiesCollector : public TablePropertiesCollector {
+ public:
+  Status AddUserKey(const Slice& /*key*/, const Slice& value, EntryType type,
+                    SequenceNumber /*seq*/, uint64_t /*file_size*/) override {
+    if ((type == kEntryPut || type == kEntryMerge) &&
+        value.size() >= DBWithTTLImpl::kTSLength) {
+      const int32_t timestamp = static_cast<int32_t>(DecodeFixed32(
+          value.data() + value.size() - DBWithTTLImpl::kTSLength));
+      if (num_timestamps_++ == 0) {
+        min_timestamp_ = max_timestamp_ = timestamp;
+      } else {
+        min_timestamp_ = std::min(min_timestamp_, timestamp);
+        max_timestamp_ = std::max(max_timestamp_, timestamp);
+      }
+    }
+    return Status::OK();
+  }
+
+  Status Finish(UserCollectedProperties* properties) override {
+    if (num_timestamps_ > 0) {
+      std::string min_str, max_str;
+      PutFixed32(&min_str, static_cast<uint32_t>(min_timestamp_));
+      PutFixed32(&max_str, static_cast<uint32_t>(max_timestamp_));
+      properties->emplace(DBWithTTLImpl::kMinTimestampProperty, min_str);
+      properties->emplace(DBWithTTLImpl::kMaxTimestampProperty, max_str);
+    }
+    return Status::OK();
+  }
+
+  UserCollectedProperties GetReadableProperties() const override {
+    UserCollectedProperties readable;
+    if (num_timestamps_ > 0) {
+      readable.emplace(DBWithTTLImpl::kMinTimestampProperty,
+                       std::to_string(min_timestamp_));
+      readable.emplace(DBWithTTLImpl::kMaxTimestampProperty,
+                       std::to_string(max_timestamp_));
+    }
+    return readable;
+  }
+
+  const char* Name() const override { return "TtlPropertiesCollector"; }
+
+ private:
+  uint64_t num_timestamps_ = 0;
+  int32_t min_timestamp_ = 0;
+  int32_t max_timestamp_ = 0;
+};
+}  // namespace
+
+TablePropertiesCollector*
+TtlPropertiesCollectorFactory::CreateTablePropertiesCollector(
+    TablePropertiesCollectorFactory::Context /*context*/) {
+  return new TtlPropertiesCollector();
 }
 
 static std::unordered_map<std::string, OptionTypeInfo> ttl_type_info = {
@@ -187,11 +260,13 @@ static std::unordered_map<std::string, OptionTypeInfo> user_cf_type_info = {
 
 TtlCompactionFilter::TtlCompactionFilter(
     int32_t ttl, SystemClock* clock, const CompactionFilter* _user_comp_filter,
-    std::unique_ptr<const CompactionFilter> _user_comp_filter_from_factory)
+    std::unique_ptr<const CompactionFilter> _user_comp_filter_from_factory,
+    bool check_ttl)
     : LayeredCompactionFilterBase(_user_comp_filter,
                                   std::move(_user_comp_filter_from_factory)),
       ttl_(ttl),
-      clock_(clock) {
+      clock_(clock),
+      check_ttl_(check_ttl) {
   RegisterOptions("TTL", &ttl_, &ttl_type_info);
   RegisterOptions("UserFilter", &user_comp_filter_, &user_cf_type_info);
 }
@@ -199,7 +274,7 @@ TtlCompactionFilter::TtlCompactionFilter(
 bool TtlCompactionFilter::Filter(int level, const Slice& key,
                                  const Slice& old_val, std::string* new_val,
                                  bool* value_changed) const {
-  if (DBWithTTLImpl::IsStale(old_val, ttl_, clock_)) {
+  if (check_ttl_ && DBWithTTLImpl::IsStale(old_val, ttl_, clock_)) {
     return true;
   }
   if (user_comp_filter() == nullptr) {
@@ -256,8 +331,48 @@ TtlCompactionFilterFactory::CreateCompactionFilter(
         user_comp_filter_factory_->CreateCompactionFilter(context);
   }
 
-  return std::unique_ptr<TtlCompactionFilter>(new TtlCompactionFilter(
-      ttl_, clock_, nullptr, std::move(user_comp_filter_from_factory)));
+  bool check_ttl = MayHaveStaleInput(context);
+  TEST_SYNC_POINT_CALLBACK(
+      "TtlCompactionFilterFactory::CreateCompactionFilter:CheckTtl",
+      &check_ttl);
+  if (!check_ttl && user_comp_filter_from_factory == nullptr) {
+    // Nothing to filter
+    return nullptr;
+  }
+  return std::unique_ptr<TtlCompactionFilter>(
+      new TtlCompactionFilter(ttl_, clock_, nullptr,
+                              std::move(user_comp_filter_from_factory),
+                              check_ttl));
+}
+
+bool TtlCompactionFilterFactory::MayHaveStaleInput(
+    const CompactionFilter::Context& context) const {
+  const int32_t ttl = ttl_;
+  if (ttl <= 0) {
+    return false;
+  }
+  int64_t curtime;
+  if (context.input_table_properties.empty() || clock_ == nullptr ||
+      !clock_->GetCurrentTime(&curtime).ok()) {
+    return true;
+  }
+  for (const auto& file_and_props : context.input_table_properties) {
+    if (file_and_props.second == nullptr) {
+      return true;
+    }
+    const auto& user_props = file_and_props.second->user_collected_properties;
+    auto it = user_props.find(DBWithTTLImpl::kMinTimestampProperty);
+    // A file without the property was written before it was recorded, or
+    // has no value, which is not worth telling apart
+    if (it == user_props.end() || it->second.size() != sizeof(uint32_t) ||
+        static_cast<int64_t>(static_cast<int32_t>(
+            DecodeFixed32(it->second.data()))) +
+                ttl <
+            curtime) {
+      return true;
+    }
+  }
+  return false;
 }
 
 Status TtlCompactionFilterFactory::PrepareOptions(
@@ -14,6 +14,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/system_clock.h"
+#include "rocksdb/table_properties.h"
 #include "rocksdb/utilities/db_ttl.h"
 #include "utilities/compaction_filters/layered_compaction_filter_base.h"
 
@@ -96,6 +97,11 @@ class DBWithTTLImpl : public DBWithTTL {
 
   static const int32_t kMaxTimestamp = 2147483647;  // 01/18/2038:7:14PM GMT-8
 
+  // Table properties of the earliest and the latest timestamps of the values
+  // and merge operands in a table file, as fixed32
+  static constexpr const char* kMinTimestampProperty = "rocksdb.ttl.min.time";
+  static constexpr const char* kMaxTimestampProperty = "rocksdb.ttl.max.time";
+
   void SetTtl(int32_t ttl) override { SetTtl(DefaultColumnFamily(), ttl); }
 
   void SetTtl(ColumnFamilyHandle* h, int32_t ttl) override;
@@ -148,10 +154,13 @@ class TtlIterator : public Iterator {
 
 class TtlCompactionFilter : public LayeredCompactionFilterBase {
  public:
+  // Without `check_ttl`, the values are passed to the user filter without
+  // checking whether they are stale, when none of them can be.
   TtlCompactionFilter(int32_t ttl, SystemClock* clock,
                       const CompactionFilter* _user_comp_filter,
                       std::unique_ptr<const CompactionFilter>
-                          _user_comp_filter_from_factory = nullptr);
+                          _user_comp_filter_from_factory = nullptr,
+                      bool check_ttl = true);
 
   bool Filter(int level, const Slice& key, const Slice& old_val,
               std::string* new_val, bool* value_changed) const override;
@@ -173,6 +182,7 @@ class TtlCompactionFilter : public LayeredCompactionFilterBase {
  private:
   int32_t ttl_;
   SystemClock* clock_;
+  bool check_ttl_;
 };
 
 class TtlCompactionFilterFactory : public CompactionFilterFactory {
@@ -195,11 +205,26 @@ class TtlCompactionFilterFactory : public CompactionFilterFactory {
   }
 
  private:
+  // Whether some of the input of a compaction may be stale, by the
+  // timestamps recorded in the table properties of the files
+  bool MayHaveStaleInput(const CompactionFilter::Context& context) const;
+
   int32_t ttl_;
   SystemClock* clock_;
   std::shared_ptr<CompactionFilterFactory> user_comp_filter_factory_;
 };
 
+// Records the earliest and the latest timestamps of the values and merge
+// operands of each table file in its table properties.
+class TtlPropertiesCollectorFactory : public TablePropertiesCollectorFactory {
+ public:
+  TablePropertiesCollector* CreateTablePropertiesCollector(
+      TablePropertiesCollectorFactory::Context context) override;
+
+  static const char* kClassName() { return "TtlPropertiesCollectorFactory"; }
+  const char* Name() const override { return kClassName(); }
+};
+
 class TtlMergeOperator : public MergeOperator {
  public:
   explicit TtlMergeOperator(const std::shared_ptr<MergeOperator>& merge_op,
@@ -3,6 +3,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <atomic>
 #include <map>
 #include <memory>
 
@@ -11,7 +12,9 @@
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/utilities/db_ttl.h"
 #include "rocksdb/utilities/object_registry.h"
+#include "test_util/sync_point.h"
 #include "test_util/testharness.h"
+#include "util/coding.h"
 #include "util/string_util.h"
 #include "utilities/merge_operators/bytesxor.h"
 #include "utilities/ttl/db_ttl_impl.h"
@@ -791,6 +794,51 @@ static int RegisterTestObjects(ObjectLibrary& library,
   return 2;
 }
 
+// The TTL check is skipped in compactions of files that are all fresh by
+// their table properties
+TEST_F(TtlTest, SkipTtlCheckOfFreshFiles) {
+  std::atomic<int> num_checked{0};
+  std::atomic<int> num_skipped{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "TtlCompactionFilterFactory::CreateCompactionFilter:CheckTtl",
+      [&](void* arg) {
+        (*static_cast<bool*>(arg) ? num_checked : num_skipped)++;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  MakeKVMap(kSampleSize_);
+  OpenTtl(3);
+  int64_t now;
+  ASSERT_OK(env_->GetCurrentTime(&now));
+  PutValues(0, kSampleSize_);  // T=0: Insert Set1. Delete at t=3
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db_ttl_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1U, props.size());
+  for (const auto& file_and_props : props) {
+    const auto& user_props = file_and_props.second->user_collected_properties;
+    for (const char* name : {DBWithTTLImpl::kMinTimestampProperty,
+                             DBWithTTLImpl::kMaxTimestampProperty}) {
+      auto it = user_props.find(name);
+      ASSERT_NE(it, user_props.end());
+      ASSERT_EQ(4U, it->second.size());
+      ASSERT_EQ(now, static_cast<int32_t>(DecodeFixed32(it->second.data())));
+    }
+  }
+
+  SleepCompactCheck(2, 0, kSampleSize_, true);  // T=2: Set1 still there
+  ASSERT_EQ(0, num_checked.load());
+  ASSERT_GT(num_skipped.load(), 0);
+
+  num_skipped = 0;
+  SleepCompactCheck(2, 0, kSampleSize_, false);  // T=4: Set1 is gone
+  ASSERT_GT(num_checked.load(), 0);
+
+  CloseTtl();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 class TtlOptionsTest : public testing::Test {
  public:
   TtlOptionsTest() {
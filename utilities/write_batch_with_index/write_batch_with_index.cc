@@ -5,8 +5,10 @@
 
 #include "rocksdb/utilities/write_batch_with_index.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
+#include <vector>
 
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
@@ -25,14 +27,15 @@ namespace ROCKSDB_NAMESPACE {
 struct WriteBatchWithIndex::Rep {
   explicit Rep(const Comparator* index_comparator, size_t reserved_bytes = 0,
                size_t max_bytes = 0, bool _overwrite_key = false,
-               size_t protection_bytes_per_key = 0)
+               size_t protection_bytes_per_key = 0, bool _lazy_index = false)
       : write_batch(reserved_bytes, max_bytes, protection_bytes_per_key,
                     index_comparator ? index_comparator->timestamp_size() : 0),
         comparator(index_comparator, &write_batch),
         skip_list(comparator, &arena),
         last_sub_batch_offset(0),
         sub_batch_cnt(1),
-        overwrite_key(_overwrite_key) {}
+        overwrite_key(_overwrite_key),
+        lazy_index(_lazy_index) {}
   ReadableWriteBatch write_batch;
   WriteBatchEntryComparator comparator;
   Arena arena;
@@ -45,6 +48,18 @@ struct WriteBatchWithIndex::Rep {
   size_t sub_batch_cnt;
 
   const bool overwrite_key;
+
+  // An entry of the write batch not indexed yet with `lazy_index`
+  struct PendingEntry {
+    size_t offset;
+    uint32_t column_family_id;
+    WriteType type;
+  };
+  const bool lazy_index;
+  // The entries written since the index was last built, in the order of the
+  // write batch
+  std::vector<PendingEntry> pending_entries;
+
   // Tracks ids of CFs that have updates in this WBWI, number of updates and
   // number of overwritten single deletions per cf. Useful for WBWIMemTable
   // when this WBWI is ingested into a DB.
@@ -88,7 +103,23 @@ struct WriteBatchWithIndex::Rep {
   // initialize the update count of the new index entry.
   void AddNewEntry(uint32_t column_family_id, WriteType type,
                    size_t last_entry_offset,
-                   uint32_t most_recent_entry_update_count);
+                   uint32_t most_recent_entry_update_count) {
+    skip_list.Insert(NewEntry(column_family_id, type, last_entry_offset,
+                              most_recent_entry_update_count));
+  }
+
+  // Allocate the index entry of AddNewEntry() without inserting it
+  WriteBatchIndexEntry* NewEntry(uint32_t column_family_id, WriteType type,
+                                 size_t last_entry_offset,
+                                 uint32_t update_count);
+
+  // The user key, without timestamp, of the entry at `entry_offset` in the
+  // write batch
+  Slice GetEntryKey(uint32_t column_family_id, size_t entry_offset) const;
+
+  // Index the pending entries of `lazy_index`. Must be called before using
+  // the index.
+  void BuildPendingIndex();
 
   // Clear all updates buffered in this batch.
   void Clear();
@@ -154,6 +185,13 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
 void WriteBatchWithIndex::Rep::AddOrUpdateIndexWithCfId(
     uint32_t cf_id, const Slice& key, WriteType type, size_t last_entry_offset,
     const Comparator* cf_cmp) {
+  if (lazy_index) {
+    if (cf_cmp) {
+      comparator.SetComparatorForCF(cf_id, cf_cmp);
+    }
+    pending_entries.push_back({last_entry_offset, cf_id, type});
+    return;
+  }
   uint32_t update_count = 0;
   if (!UpdateExistingEntryWithCfId(cf_id, key, type, last_entry_offset,
                                    &update_count)) {
@@ -164,13 +202,11 @@ void WriteBatchWithIndex::Rep::AddOrUpdateIndexWithCfId(
   }
 }
 
-void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id,
-                                           WriteType type,
-                                           size_t last_entry_offset,
-                                           uint32_t update_count) {
+Slice WriteBatchWithIndex::Rep::GetEntryKey(uint32_t column_family_id,
+                                            size_t entry_offset) const {
   const std::string& wb_data = write_batch.Data();
-  Slice entry_ptr = Slice(wb_data.data() + last_entry_offset,
-                          wb_data.size() - last_entry_offset);
+  Slice entry_ptr =
+      Slice(wb_data.data() + entry_offset, wb_data.size() - entry_offset);
   // Extract key
   Slice key;
   bool success =
@@ -186,17 +222,62 @@ void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id,
   if (ts_sz > 0) {
     key.remove_suffix(ts_sz);
   }
+  return key;
+}
+
+WriteBatchIndexEntry* WriteBatchWithIndex::Rep::NewEntry(
+    uint32_t column_family_id, WriteType type, size_t last_entry_offset,
+    uint32_t update_count) {
+  const Slice key = GetEntryKey(column_family_id, last_entry_offset);
 
   auto* mem = arena.Allocate(sizeof(WriteBatchIndexEntry));
   auto* index_entry = new (mem) WriteBatchIndexEntry(
-      last_entry_offset, column_family_id, key.data() - wb_data.data(),
-      key.size(), update_count);
-  skip_list.Insert(index_entry);
+      last_entry_offset, column_family_id,
+      key.data() - write_batch.Data().data(), key.size(), update_count);
 
   if (type == kSingleDeleteRecord) {
     index_entry->has_single_del = true;
   }
   cf_id_to_stat[column_family_id].entry_count++;
+  return index_entry;
+}
+
+void WriteBatchWithIndex::Rep::BuildPendingIndex() {
+  if (pending_entries.empty()) {
+    return;
+  }
+  if (overwrite_key) {
+    // The updates of a key depend on the ones before, and so do the
+    // sub-batches, so the entries are indexed in the order they were written.
+    for (const auto& entry : pending_entries) {
+      uint32_t update_count = 0;
+      if (!UpdateExistingEntryWithCfId(
+              entry.column_family_id,
+              GetEntryKey(entry.column_family_id, entry.offset), entry.type,
+              entry.offset, &update_count)) {
+        AddNewEntry(entry.column_family_id, entry.type, entry.offset,
+                    update_count + 1);
+      }
+    }
+  } else {
+    // Sort the new entries, which are then inserted into the skip list one
+    // after the other, mostly taking its fast path for sequential inserts
+    std::vector<WriteBatchIndexEntry*> entries;
+    entries.reserve(pending_entries.size());
+    for (const auto& entry : pending_entries) {
+      entries.push_back(NewEntry(entry.column_family_id, entry.type,
+                                 entry.offset, /*update_count=*/1));
+    }
+    std::sort(entries.begin(), entries.end(),
+              [this](const WriteBatchIndexEntry* a,
+                     const WriteBatchIndexEntry* b) {
+                return comparator(a, b) < 0;
+              });
+    for (WriteBatchIndexEntry* entry : entries) {
+      skip_list.Insert(entry);
+    }
+  }
+  pending_entries.clear();
 }
 
 void WriteBatchWithIndex::Rep::Clear() {
@@ -210,6 +291,7 @@ void WriteBatchWithIndex::Rep::ClearIndex() {
   arena.~Arena();
   new (&arena) Arena();
   new (&skip_list) WriteBatchEntrySkipList(comparator, &arena);
+  pending_entries.clear();
   last_sub_batch_offset = 0;
   sub_batch_cnt = 1;
 }
@@ -309,9 +391,10 @@ Status WriteBatchWithIndex::Rep::ReBuildIndex() {
 
 WriteBatchWithIndex::WriteBatchWithIndex(
     const Comparator* default_index_comparator, size_t reserved_bytes,
-    bool overwrite_key, size_t max_bytes, size_t protection_bytes_per_key)
+    bool overwrite_key, size_t max_bytes, size_t protection_bytes_per_key,
+    bool lazy_index)
     : rep(new Rep(default_index_comparator, reserved_bytes, max_bytes,
-                  overwrite_key, protection_bytes_per_key)) {}
+                  overwrite_key, protection_bytes_per_key, lazy_index)) {}
 
 WriteBatchWithIndex::~WriteBatchWithIndex() = default;
 
@@ -322,21 +405,27 @@ WriteBatchWithIndex& WriteBatchWithIndex::operator=(WriteBatchWithIndex&&) =
 
 WriteBatch* WriteBatchWithIndex::GetWriteBatch() { return &rep->write_batch; }
 
-size_t WriteBatchWithIndex::SubBatchCnt() { return rep->sub_batch_cnt; }
+size_t WriteBatchWithIndex::SubBatchCnt() {
+  rep->BuildPendingIndex();
+  return rep->sub_batch_cnt;
+}
 
 WBWIIterator* WriteBatchWithIndex::NewIterator() {
+  rep->BuildPendingIndex();
   return new WBWIIteratorImpl(0, &(rep->skip_list), &rep->write_batch,
                               &(rep->comparator));
 }
 
 WBWIIterator* WriteBatchWithIndex::NewIterator(
     ColumnFamilyHandle* column_family) {
+  rep->BuildPendingIndex();
   return new WBWIIteratorImpl(GetColumnFamilyID(column_family),
                               &(rep->skip_list), &rep->write_batch,
                               &(rep->comparator));
 }
 
 WBWIIterator* WriteBatchWithIndex::NewIterator(uint32_t cf_id) const {
+  rep->BuildPendingIndex();
   return new WBWIIteratorImpl(cf_id, &(rep->skip_list), &rep->write_batch,
                               &(rep->comparator));
 }
@@ -344,6 +433,7 @@ WBWIIterator* WriteBatchWithIndex::NewIterator(uint32_t cf_id) const {
 Iterator* WriteBatchWithIndex::NewIteratorWithBase(
     ColumnFamilyHandle* column_family, Iterator* base_iterator,
     const ReadOptions* read_options) {
+  rep->BuildPendingIndex();
   WBWIIteratorImpl* wbwiii;
   if (read_options != nullptr) {
     wbwiii = new WBWIIteratorImpl(
@@ -363,6 +453,7 @@ Iterator* WriteBatchWithIndex::NewIteratorWithBase(
 
 Iterator* WriteBatchWithIndex::NewIteratorWithBase(
     Iterator* base_iterator, const ReadOptions* read_options) {
+  rep->BuildPendingIndex();
   WBWIIteratorImpl* wbwiii;
   // default column family's comparator
   if (read_options != nullptr) {
@@ -1170,6 +1261,7 @@ const Comparator* WriteBatchWithIndexInternal::GetUserComparator(
 
 const std::unordered_map<uint32_t, WriteBatchWithIndex::CFStat>&
 WriteBatchWithIndex::GetCFStats() const {
+  rep->BuildPendingIndex();
   return rep->cf_id_to_stat;
 }
 
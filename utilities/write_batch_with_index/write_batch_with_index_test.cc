@@ -731,6 +731,70 @@ TEST_P(WriteBatchWithIndexTest, TestValueAsSecondaryIndex) {
   TestValueAsSecondaryIndexHelper(entries_list, batch_.get(), GetParam());
 }
 
+TEST_P(WriteBatchWithIndexTest, LazyIndex) {
+  // A batch with a lazy index ends up with the same index as one indexing
+  // each write
+  const bool overwrite = GetParam();
+  WriteBatchWithIndex lazy_batch(BytewiseComparator(), 20, overwrite,
+                                 /*max_bytes=*/0,
+                                 /*protection_bytes_per_key=*/0,
+                                 /*lazy_index=*/true);
+  ColumnFamilyHandleImplDummy cf1(6, BytewiseComparator());
+
+  auto verify = [&]() {
+    ASSERT_EQ(batch_->GetCFStats().size(), lazy_batch.GetCFStats().size());
+    for (ColumnFamilyHandle* cf :
+         {static_cast<ColumnFamilyHandle*>(nullptr),
+          static_cast<ColumnFamilyHandle*>(&cf1)}) {
+      std::unique_ptr<WBWIIterator> iter(batch_->NewIterator(cf));
+      std::unique_ptr<WBWIIterator> lazy_iter(lazy_batch.NewIterator(cf));
+      iter->SeekToFirst();
+      lazy_iter->SeekToFirst();
+      for (; iter->Valid(); iter->Next(), lazy_iter->Next()) {
+        ASSERT_TRUE(lazy_iter->Valid());
+        ASSERT_EQ(iter->Entry().type, lazy_iter->Entry().type);
+        ASSERT_EQ(iter->Entry().key, lazy_iter->Entry().key);
+        ASSERT_EQ(iter->Entry().value, lazy_iter->Entry().value);
+        ASSERT_EQ(iter->GetUpdateCount(), lazy_iter->GetUpdateCount());
+        ASSERT_EQ(iter->HasOverWrittenSingleDel(),
+                  lazy_iter->HasOverWrittenSingleDel());
+      }
+      ASSERT_FALSE(lazy_iter->Valid());
+    }
+  };
+
+  Random rnd(301);
+  for (int i = 0; i < 1000; i++) {
+    ColumnFamilyHandle* cf = rnd.OneIn(2) ? nullptr : &cf1;
+    const std::string key = "key" + std::to_string(rnd.Uniform(100));
+    const std::string value = "value" + std::to_string(i);
+    switch (rnd.Uniform(3)) {
+      case 0:
+        ASSERT_OK(batch_->Put(cf, key, value));
+        ASSERT_OK(lazy_batch.Put(cf, key, value));
+        break;
+      case 1:
+        ASSERT_OK(batch_->Merge(cf, key, value));
+        ASSERT_OK(lazy_batch.Merge(cf, key, value));
+        break;
+      default:
+        ASSERT_OK(batch_->Delete(cf, key));
+        ASSERT_OK(lazy_batch.Delete(cf, key));
+        break;
+    }
+    if (i % 300 == 0) {
+      verify();
+    }
+  }
+  verify();
+
+  // The lookups index the pending writes too
+  ASSERT_OK(lazy_batch.Put("new_key", "v"));
+  std::string value;
+  ASSERT_OK(lazy_batch.GetFromBatch(options_, "new_key", &value));
+  ASSERT_EQ("v", value);
+}
+
 TEST_P(WriteBatchWithIndexTest, WBWIIteratorImpl) {
   // Tests methods of WBWIIteratorImpl, with some overwrites and merges.
   ASSERT_OK(batch_->Merge("k0", "k0m0"));